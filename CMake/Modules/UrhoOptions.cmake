@@ -112,6 +112,7 @@ set_property(CACHE URHO3D_NETFX PROPERTY STRINGS net46 net461 net462 net47 net47
 _option2(URHO3D_FILEWATCHER       "Watch filesystem for resource changes"                 ${URHO3D_ENABLE_ALL} "URHO3D_THREADING"              OFF)
 _option(URHO3D_SPHERICAL_HARMONICS "Use spherical harmonics for ambient lighting"         ON)
 _option(URHO3D_HASH_DEBUG         "Enable StringHash name debugging"                      ${URHO3D_ENABLE_ALL}                                    )
+_option(URHO3D_MEMORY_TRACKING    "Track engine heap allocations by memory tag"          OFF                                                     )
 _option(URHO3D_MONOLITHIC_HEADER  "Create Urho3DAll.h which includes all engine headers." OFF                                                     )
 _option2(URHO3D_MINIDUMPS         "Enable writing minidumps on crash"                     ${URHO3D_ENABLE_ALL} "MSVC"                          OFF)
 _option2(URHO3D_PLUGINS           "Enable plugins"                                        ${URHO3D_ENABLE_ALL} "NOT WEB"                       OFF)
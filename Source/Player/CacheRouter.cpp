@@ -56,14 +56,14 @@ bool CacheRouter::AddPackage(PackageFile* packageFile)
         return false;
     }
 
-    JSONFile jsonFile(context_);
-    if (!jsonFile.BeginLoad(file))
+    // Parse the mapping straight from the package, without building a JSONFile
+    JSONStreamInputArchive archive(context_, file);
+    if (archive.HasError())
     {
         URHO3D_LOGERROR("Failed to load {} in package {}", cacheInfo, packageFile->GetName());
         return false;
     }
 
-    JSONInputArchive archive(&jsonFile);
     ea::unordered_map<ea::string, ea::string> mapping;
     if (!SerializeStringMap(archive, "cacheInfo", "map", mapping))
     {
@@ -126,14 +126,14 @@ void Player::Setup()
             continue;
         }
 
-        JSONFile jsonFile(context_);
-        if (!jsonFile.BeginLoad(*file))
+        // Parse the settings straight from the package, without building a JSONFile
+        JSONStreamInputArchive archive(context_, *file);
+        if (archive.HasError())
         {
             URHO3D_LOGERROR("Unable to load Settings.json in {}", pakFile);
             continue;
         }
 
-        JSONInputArchive archive(&jsonFile);
         if (!settings_.Serialize(archive))
         {
             URHO3D_LOGERROR("Unable to deserialize Settings.json in {}", pakFile);
@@ -204,11 +204,24 @@ struct dtCrowdAgentDebugInfo
 /// Type for the update callback.
 typedef void (*dtUpdateCallback)(bool positionUpdate, dtCrowdAgent* agent, float* pos, float dt);
 
+// Urho3D: Add parallel update support
+/// Type for the function processing a range of agents on a thread.
+typedef void (*dtParallelForFunc)(void* context, int begin, int end, int threadIndex);
+/// Type for the callback that calls the function over [0, count) in chunks, possibly in parallel, and returns when all chunks are done.
+/// The thread index passed to the function must be less than the thread count given to dtCrowd::setParallelFor.
+typedef void (*dtParallelForCallback)(void* userData, int count, dtParallelForFunc func, void* context);
+
 /// Provides local steering behaviors for a group of agents. 
 /// @ingroup crowd
 class dtCrowd
 {
     dtUpdateCallback m_updateCallback; // Urho3D
+	dtParallelForCallback m_parallelFor; // Urho3D
+	void* m_parallelForUserData; // Urho3D
+	int m_numThreads; // Urho3D
+	dtNavMeshQuery** m_threadNavQueries; // Urho3D
+	dtObstacleAvoidanceQuery** m_threadObstacleQueries; // Urho3D
+	int* m_threadVelocitySampleCounts; // Urho3D
 	int m_maxAgents;
 	dtCrowdAgent* m_agents;
 	dtCrowdAgent** m_activeAgents;
@@ -243,6 +256,10 @@ class dtCrowd
 	bool requestMoveTargetReplan(const int idx, dtPolyRef ref, const float* pos);
 
 	void purge();
+	void purgeThreads(); // Urho3D
+
+	// Urho3D: Add parallel update support
+	template <class T> void parallelFor(const int count, T& func);
 	
 public:
 	dtCrowd();
@@ -256,6 +273,14 @@ public:
 	///  @param[in]		cb				The update callback.
 	/// @return True if the initialization succeeded.
 	bool init(const int maxAgents, const float maxAgentRadius, dtNavMesh* nav, dtUpdateCallback cb = 0);
+
+	// Urho3D: Add parallel update support
+	/// Sets the callback used to run the per-agent phases of the update in parallel. Must be called after init().
+	///  @param[in]		callback	The parallel for callback, or null to update on the calling thread.
+	///  @param[in]		userData	User data passed to the callback.
+	///  @param[in]		numThreads	The number of threads the callback may use, including the calling thread. [Limit: >= 1]
+	/// @return True if the per-thread queries were allocated.
+	bool setParallelFor(dtParallelForCallback callback, void* userData, const int numThreads);
 	
 	/// Sets the shared avoidance configuration for the specified index.
 	///  @param[in]		idx		The index. [Limits: 0 <= value < #DT_CROWD_MAX_OBSTAVOIDANCE_PARAMS]
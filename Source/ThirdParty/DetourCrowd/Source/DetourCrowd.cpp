@@ -194,7 +194,7 @@ static int getNeighbours(const float* pos, const float height, const float range
 	int n = 0;
 	
 	static const int MAX_NEIS = 32;
-	unsigned short ids[MAX_NEIS];
+	unsigned int ids[MAX_NEIS]; // Urho3D: use 32-bit indices to support more than 16k agents
 	int nids = grid->queryItems(pos[0]-range, pos[2]-range,
 								pos[0]+range, pos[2]+range,
 								ids, MAX_NEIS);
@@ -333,6 +333,12 @@ Notes:
 
 dtCrowd::dtCrowd() :
 	m_updateCallback(0), // Urho3D: Add update callback support
+	m_parallelFor(0), // Urho3D: Add parallel update support
+	m_parallelForUserData(0),
+	m_numThreads(1),
+	m_threadNavQueries(0),
+	m_threadObstacleQueries(0),
+	m_threadVelocitySampleCounts(0),
 	m_maxAgents(0),
 	m_agents(0),
 	m_activeAgents(0),
@@ -357,6 +363,8 @@ dtCrowd::~dtCrowd()
 
 void dtCrowd::purge()
 {
+	purgeThreads(); // Urho3D
+
 	for (int i = 0; i < m_maxAgents; ++i)
 		m_agents[i].~dtCrowdAgent();
 	dtFree(m_agents);
@@ -382,6 +390,88 @@ void dtCrowd::purge()
 	m_navquery = 0;
 }
 
+// Urho3D: Add parallel update support
+void dtCrowd::purgeThreads()
+{
+	// Thread 0 uses the crowd's own queries, which are owned elsewhere.
+	for (int i = 1; i < m_numThreads; ++i)
+	{
+		if (m_threadNavQueries)
+			dtFreeNavMeshQuery(m_threadNavQueries[i]);
+		if (m_threadObstacleQueries)
+			dtFreeObstacleAvoidanceQuery(m_threadObstacleQueries[i]);
+	}
+	dtFree(m_threadNavQueries);
+	m_threadNavQueries = 0;
+	dtFree(m_threadObstacleQueries);
+	m_threadObstacleQueries = 0;
+	dtFree(m_threadVelocitySampleCounts);
+	m_threadVelocitySampleCounts = 0;
+
+	m_numThreads = 1;
+	m_parallelFor = 0;
+	m_parallelForUserData = 0;
+}
+
+// Urho3D: Add parallel update support
+bool dtCrowd::setParallelFor(dtParallelForCallback callback, void* userData, const int numThreads)
+{
+	purgeThreads();
+
+	if (!callback || numThreads < 2 || !m_navquery || !m_obstacleQuery)
+		return true;
+
+	m_threadNavQueries = (dtNavMeshQuery**)dtAlloc(sizeof(dtNavMeshQuery*)*numThreads, DT_ALLOC_PERM);
+	m_threadObstacleQueries = (dtObstacleAvoidanceQuery**)dtAlloc(sizeof(dtObstacleAvoidanceQuery*)*numThreads, DT_ALLOC_PERM);
+	m_threadVelocitySampleCounts = (int*)dtAlloc(sizeof(int)*numThreads, DT_ALLOC_PERM);
+	if (!m_threadNavQueries || !m_threadObstacleQueries || !m_threadVelocitySampleCounts)
+	{
+		purgeThreads();
+		return false;
+	}
+	memset(m_threadNavQueries, 0, sizeof(dtNavMeshQuery*)*numThreads);
+	memset(m_threadObstacleQueries, 0, sizeof(dtObstacleAvoidanceQuery*)*numThreads);
+	m_numThreads = numThreads;
+
+	m_threadNavQueries[0] = m_navquery;
+	m_threadObstacleQueries[0] = m_obstacleQuery;
+	for (int i = 1; i < numThreads; ++i)
+	{
+		m_threadNavQueries[i] = dtAllocNavMeshQuery();
+		m_threadObstacleQueries[i] = dtAllocObstacleAvoidanceQuery();
+		if (!m_threadNavQueries[i] || !m_threadObstacleQueries[i] ||
+			dtStatusFailed(m_threadNavQueries[i]->init(m_navquery->getAttachedNavMesh(), MAX_COMMON_NODES)) ||
+			!m_threadObstacleQueries[i]->init(6, 8))
+		{
+			purgeThreads();
+			return false;
+		}
+	}
+
+	m_parallelFor = callback;
+	m_parallelForUserData = userData;
+	return true;
+}
+
+// Urho3D: Add parallel update support
+template <class T> void dtCrowd::parallelFor(const int count, T& func)
+{
+	if (!m_parallelFor || count < 2)
+	{
+		func(0, count, 0);
+		return;
+	}
+
+	struct Thunk
+	{
+		static void run(void* context, int begin, int end, int threadIndex)
+		{
+			(*static_cast<T*>(context))(begin, end, threadIndex);
+		}
+	};
+	m_parallelFor(m_parallelForUserData, count, &Thunk::run, &func);
+}
+
 // Urho3D: Add update callback support
 /// @par
 ///
@@ -1080,71 +1170,86 @@ void dtCrowd::update(const float dt, dtCrowdAgentDebugInfo* debug)
 		dtCrowdAgent* ag = agents[i];
 		const float* p = ag->npos;
 		const float r = ag->params.radius;
-		m_grid->addItem((unsigned short)i, p[0]-r, p[2]-r, p[0]+r, p[2]+r);
+		m_grid->addItem((unsigned int)i, p[0]-r, p[2]-r, p[0]+r, p[2]+r);
 	}
 	
+	// Urho3D: The per-agent phases below only write to the agent itself and read other agents' state
+	// that is not modified within the same phase, so they may be processed in parallel.
+	dtNavMeshQuery** threadNavQueries = m_threadNavQueries ? m_threadNavQueries : &m_navquery;
+	dtObstacleAvoidanceQuery** threadObstacleQueries = m_threadObstacleQueries ? m_threadObstacleQueries : &m_obstacleQuery;
+
 	// Get nearby navmesh segments and agents to collide with.
-	for (int i = 0; i < nagents; ++i)
+	auto updateNeighbours = [&](int begin, int end, int threadIndex)
 	{
-		dtCrowdAgent* ag = agents[i];
-		if (ag->state != DT_CROWDAGENT_STATE_WALKING)
-			continue;
-
-		// Update the collision boundary after certain distance has been passed or
-		// if it has become invalid.
-		const float updateThr = ag->params.collisionQueryRange*0.25f;
-		if (dtVdist2DSqr(ag->npos, ag->boundary.getCenter()) > dtSqr(updateThr) ||
-			!ag->boundary.isValid(m_navquery, &m_filters[ag->params.queryFilterType]))
+		dtNavMeshQuery* navquery = threadNavQueries[threadIndex];
+		for (int i = begin; i < end; ++i)
 		{
-			ag->boundary.update(ag->corridor.getFirstPoly(), ag->npos, ag->params.collisionQueryRange,
-								m_navquery, &m_filters[ag->params.queryFilterType]);
+			dtCrowdAgent* ag = agents[i];
+			if (ag->state != DT_CROWDAGENT_STATE_WALKING)
+				continue;
+
+			// Update the collision boundary after certain distance has been passed or
+			// if it has become invalid.
+			const float updateThr = ag->params.collisionQueryRange*0.25f;
+			if (dtVdist2DSqr(ag->npos, ag->boundary.getCenter()) > dtSqr(updateThr) ||
+				!ag->boundary.isValid(navquery, &m_filters[ag->params.queryFilterType]))
+			{
+				ag->boundary.update(ag->corridor.getFirstPoly(), ag->npos, ag->params.collisionQueryRange,
+									navquery, &m_filters[ag->params.queryFilterType]);
+			}
+			// Query neighbour agents
+			ag->nneis = getNeighbours(ag->npos, ag->params.height, ag->params.collisionQueryRange,
+									  ag, ag->neis, DT_CROWDAGENT_MAX_NEIGHBOURS,
+									  agents, nagents, m_grid);
+			for (int j = 0; j < ag->nneis; j++)
+				ag->neis[j].idx = getAgentIndex(agents[ag->neis[j].idx]);
 		}
-		// Query neighbour agents
-		ag->nneis = getNeighbours(ag->npos, ag->params.height, ag->params.collisionQueryRange,
-								  ag, ag->neis, DT_CROWDAGENT_MAX_NEIGHBOURS,
-								  agents, nagents, m_grid);
-		for (int j = 0; j < ag->nneis; j++)
-			ag->neis[j].idx = getAgentIndex(agents[ag->neis[j].idx]);
-	}
+	};
+	parallelFor(nagents, updateNeighbours);
 	
 	// Find next corner to steer to.
-	for (int i = 0; i < nagents; ++i)
+	auto updateCorners = [&](int begin, int end, int threadIndex)
 	{
-		dtCrowdAgent* ag = agents[i];
-		
-		if (ag->state != DT_CROWDAGENT_STATE_WALKING)
-			continue;
-		if (ag->targetState == DT_CROWDAGENT_TARGET_NONE || ag->targetState == DT_CROWDAGENT_TARGET_VELOCITY)
-			continue;
-		
-		// Find corners for steering
-		ag->ncorners = ag->corridor.findCorners(ag->cornerVerts, ag->cornerFlags, ag->cornerPolys,
-												DT_CROWDAGENT_MAX_CORNERS, m_navquery, &m_filters[ag->params.queryFilterType]);
-		
-		// Check to see if the corner after the next corner is directly visible,
-		// and short cut to there.
-		if ((ag->params.updateFlags & DT_CROWD_OPTIMIZE_VIS) && ag->ncorners > 0)
+		dtNavMeshQuery* navquery = threadNavQueries[threadIndex];
+		for (int i = begin; i < end; ++i)
 		{
-			const float* target = &ag->cornerVerts[dtMin(1,ag->ncorners-1)*3];
-			ag->corridor.optimizePathVisibility(target, ag->params.pathOptimizationRange, m_navquery, &m_filters[ag->params.queryFilterType]);
+			dtCrowdAgent* ag = agents[i];
 			
-			// Copy data for debug purposes.
-			if (debugIdx == i)
+			if (ag->state != DT_CROWDAGENT_STATE_WALKING)
+				continue;
+			if (ag->targetState == DT_CROWDAGENT_TARGET_NONE || ag->targetState == DT_CROWDAGENT_TARGET_VELOCITY)
+				continue;
+			
+			// Find corners for steering
+			ag->ncorners = ag->corridor.findCorners(ag->cornerVerts, ag->cornerFlags, ag->cornerPolys,
+													DT_CROWDAGENT_MAX_CORNERS, navquery, &m_filters[ag->params.queryFilterType]);
+			
+			// Check to see if the corner after the next corner is directly visible,
+			// and short cut to there.
+			if ((ag->params.updateFlags & DT_CROWD_OPTIMIZE_VIS) && ag->ncorners > 0)
 			{
-				dtVcopy(debug->optStart, ag->corridor.getPos());
-				dtVcopy(debug->optEnd, target);
+				const float* target = &ag->cornerVerts[dtMin(1,ag->ncorners-1)*3];
+				ag->corridor.optimizePathVisibility(target, ag->params.pathOptimizationRange, navquery, &m_filters[ag->params.queryFilterType]);
+				
+				// Copy data for debug purposes.
+				if (debugIdx == i)
+				{
+					dtVcopy(debug->optStart, ag->corridor.getPos());
+					dtVcopy(debug->optEnd, target);
+				}
 			}
-		}
-		else
-		{
-			// Copy data for debug purposes.
-			if (debugIdx == i)
+			else
 			{
-				dtVset(debug->optStart, 0,0,0);
-				dtVset(debug->optEnd, 0,0,0);
+				// Copy data for debug purposes.
+				if (debugIdx == i)
+				{
+					dtVset(debug->optStart, 0,0,0);
+					dtVset(debug->optEnd, 0,0,0);
+				}
 			}
 		}
-	}
+	};
+	parallelFor(nagents, updateCorners);
 	
 	// Trigger off-mesh connections (depends on corners).
 	for (int i = 0; i < nagents; ++i)
@@ -1271,77 +1376,97 @@ void dtCrowd::update(const float dt, dtCrowdAgentDebugInfo* debug)
 	}
 
 	// Velocity planning.
-	for (int i = 0; i < nagents; ++i)
+	int* threadVelocitySampleCounts = m_threadVelocitySampleCounts ? m_threadVelocitySampleCounts : &m_velocitySampleCount;
+	for (int i = 0; i < m_numThreads; ++i)
+		threadVelocitySampleCounts[i] = 0;
+
+	auto planVelocities = [&](int begin, int end, int threadIndex)
 	{
-		dtCrowdAgent* ag = agents[i];
-		
-		if (ag->state != DT_CROWDAGENT_STATE_WALKING)
-			continue;
-		
-		if (ag->params.updateFlags & DT_CROWD_OBSTACLE_AVOIDANCE)
+		dtObstacleAvoidanceQuery* obstacleQuery = threadObstacleQueries[threadIndex];
+		for (int i = begin; i < end; ++i)
 		{
-			m_obstacleQuery->reset();
+			dtCrowdAgent* ag = agents[i];
 			
-			// Add neighbours as obstacles.
-			for (int j = 0; j < ag->nneis; ++j)
-			{
-				const dtCrowdAgent* nei = &m_agents[ag->neis[j].idx];
-				m_obstacleQuery->addCircle(nei->npos, nei->params.radius, nei->vel, nei->dvel);
-			}
-
-			// Append neighbour segments as obstacles.
-			for (int j = 0; j < ag->boundary.getSegmentCount(); ++j)
+			if (ag->state != DT_CROWDAGENT_STATE_WALKING)
+				continue;
+			
+			if (ag->params.updateFlags & DT_CROWD_OBSTACLE_AVOIDANCE)
 			{
-				const float* s = ag->boundary.getSegment(j);
-				if (dtTriArea2D(ag->npos, s, s+3) < 0.0f)
-					continue;
-				m_obstacleQuery->addSegment(s, s+3);
-			}
+				obstacleQuery->reset();
+				
+				// Add neighbours as obstacles.
+				for (int j = 0; j < ag->nneis; ++j)
+				{
+					const dtCrowdAgent* nei = &m_agents[ag->neis[j].idx];
+					obstacleQuery->addCircle(nei->npos, nei->params.radius, nei->vel, nei->dvel);
+				}
 
-			dtObstacleAvoidanceDebugData* vod = 0;
-			if (debugIdx == i) 
-				vod = debug->vod;
-			
-			// Sample new safe velocity.
-			bool adaptive = true;
-			int ns = 0;
+				// Append neighbour segments as obstacles.
+				for (int j = 0; j < ag->boundary.getSegmentCount(); ++j)
+				{
+					const float* s = ag->boundary.getSegment(j);
+					if (dtTriArea2D(ag->npos, s, s+3) < 0.0f)
+						continue;
+					obstacleQuery->addSegment(s, s+3);
+				}
 
-			const dtObstacleAvoidanceParams* params = &m_obstacleQueryParams[ag->params.obstacleAvoidanceType];
+				dtObstacleAvoidanceDebugData* vod = 0;
+				if (debugIdx == i) 
+					vod = debug->vod;
 				
-			if (adaptive)
-			{
-				ns = m_obstacleQuery->sampleVelocityAdaptive(ag->npos, ag->params.radius, ag->desiredSpeed,
-															 ag->vel, ag->dvel, ag->nvel, params, vod);
+				// Sample new safe velocity.
+				bool adaptive = true;
+				int ns = 0;
+
+				const dtObstacleAvoidanceParams* params = &m_obstacleQueryParams[ag->params.obstacleAvoidanceType];
+					
+				if (adaptive)
+				{
+					ns = obstacleQuery->sampleVelocityAdaptive(ag->npos, ag->params.radius, ag->desiredSpeed,
+															   ag->vel, ag->dvel, ag->nvel, params, vod);
+				}
+				else
+				{
+					ns = obstacleQuery->sampleVelocityGrid(ag->npos, ag->params.radius, ag->desiredSpeed,
+														   ag->vel, ag->dvel, ag->nvel, params, vod);
+				}
+				threadVelocitySampleCounts[threadIndex] += ns;
 			}
 			else
 			{
-				ns = m_obstacleQuery->sampleVelocityGrid(ag->npos, ag->params.radius, ag->desiredSpeed,
-														 ag->vel, ag->dvel, ag->nvel, params, vod);
+				// If not using velocity planning, new velocity is directly the desired velocity.
+				dtVcopy(ag->nvel, ag->dvel);
 			}
-			m_velocitySampleCount += ns;
-		}
-		else
-		{
-			// If not using velocity planning, new velocity is directly the desired velocity.
-			dtVcopy(ag->nvel, ag->dvel);
 		}
+	};
+	parallelFor(nagents, planVelocities);
+
+	if (m_threadVelocitySampleCounts)
+	{
+		m_velocitySampleCount = 0;
+		for (int i = 0; i < m_numThreads; ++i)
+			m_velocitySampleCount += m_threadVelocitySampleCounts[i];
 	}
 
 	// Integrate.
-	for (int i = 0; i < nagents; ++i)
+	auto integrateAgents = [&](int begin, int end, int /*threadIndex*/)
 	{
-		dtCrowdAgent* ag = agents[i];
-		if (ag->state != DT_CROWDAGENT_STATE_WALKING)
-			continue;
-		integrate(ag, dt);
-	}
+		for (int i = begin; i < end; ++i)
+		{
+			dtCrowdAgent* ag = agents[i];
+			if (ag->state != DT_CROWDAGENT_STATE_WALKING)
+				continue;
+			integrate(ag, dt);
+		}
+	};
+	parallelFor(nagents, integrateAgents);
 	
 	// Handle collisions.
 	static const float COLLISION_RESOLVE_FACTOR = 0.7f;
 	
-	for (int iter = 0; iter < 4; ++iter)
+	auto calcCollisionDisplacements = [&](int begin, int end, int /*threadIndex*/)
 	{
-		for (int i = 0; i < nagents; ++i)
+		for (int i = begin; i < end; ++i)
 		{
 			dtCrowdAgent* ag = agents[i];
 			const int idx0 = getAgentIndex(ag);
@@ -1396,8 +1521,11 @@ void dtCrowd::update(const float dt, dtCrowdAgentDebugInfo* debug)
 				dtVscale(ag->disp, ag->disp, iw);
 			}
 		}
-		
-		for (int i = 0; i < nagents; ++i)
+	};
+
+	auto applyCollisionDisplacements = [&](int begin, int end, int /*threadIndex*/)
+	{
+		for (int i = begin; i < end; ++i)
 		{
 			dtCrowdAgent* ag = agents[i];
 			if (ag->state != DT_CROWDAGENT_STATE_WALKING)
@@ -1405,29 +1533,48 @@ void dtCrowd::update(const float dt, dtCrowdAgentDebugInfo* debug)
 			
 			dtVadd(ag->npos, ag->npos, ag->disp);
 		}
+	};
+
+	for (int iter = 0; iter < 4; ++iter)
+	{
+		parallelFor(nagents, calcCollisionDisplacements);
+		parallelFor(nagents, applyCollisionDisplacements);
 	}
 	
-	for (int i = 0; i < nagents; ++i)
+	auto moveAgents = [&](int begin, int end, int threadIndex)
 	{
-		dtCrowdAgent* ag = agents[i];
-		if (ag->state != DT_CROWDAGENT_STATE_WALKING)
-			continue;
-		
-		// Move along navmesh.
-		ag->corridor.movePosition(ag->npos, m_navquery, &m_filters[ag->params.queryFilterType]);
-		// Get valid constrained position back.
-		dtVcopy(ag->npos, ag->corridor.getPos());
-
-		// If not using path, truncate the corridor to just one poly.
-		if (ag->targetState == DT_CROWDAGENT_TARGET_NONE || ag->targetState == DT_CROWDAGENT_TARGET_VELOCITY)
+		dtNavMeshQuery* navquery = threadNavQueries[threadIndex];
+		for (int i = begin; i < end; ++i)
 		{
-			ag->corridor.reset(ag->corridor.getFirstPoly(), ag->npos);
-			ag->partial = false;
+			dtCrowdAgent* ag = agents[i];
+			if (ag->state != DT_CROWDAGENT_STATE_WALKING)
+				continue;
+			
+			// Move along navmesh.
+			ag->corridor.movePosition(ag->npos, navquery, &m_filters[ag->params.queryFilterType]);
+			// Get valid constrained position back.
+			dtVcopy(ag->npos, ag->corridor.getPos());
+
+			// If not using path, truncate the corridor to just one poly.
+			if (ag->targetState == DT_CROWDAGENT_TARGET_NONE || ag->targetState == DT_CROWDAGENT_TARGET_VELOCITY)
+			{
+				ag->corridor.reset(ag->corridor.getFirstPoly(), ag->npos);
+				ag->partial = false;
+			}
 		}
+	};
+	parallelFor(nagents, moveAgents);
 
-		// Urho3D: Update position callback support
-		if (m_updateCallback)
+	// Urho3D: Update position callback support. Called on the updating thread as the callback may access the scene.
+	if (m_updateCallback)
+	{
+		for (int i = 0; i < nagents; ++i)
+		{
+			dtCrowdAgent* ag = agents[i];
+			if (ag->state != DT_CROWDAGENT_STATE_WALKING)
+				continue;
 			m_updateCallback(true, ag, ag->npos, dt);
+		}
 	}
 
 	// Update agents using off-mesh connection.
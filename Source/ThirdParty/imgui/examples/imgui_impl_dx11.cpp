@@ -233,6 +233,7 @@ void ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data)
     // (Because we merged all buffers into a single one, we maintain our own offset into them)
     int global_idx_offset = 0;
     int global_vtx_offset = 0;
+    ID3D11ShaderResourceView* last_texture_srv = NULL;
     ImVec2 clip_off = draw_data->DisplayPos;
     for (int n = 0; n < draw_data->CmdListsCount; n++)
     {
@@ -248,6 +249,8 @@ void ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data)
                     ImGui_ImplDX11_SetupRenderState(draw_data, ctx);
                 else
                     pcmd->UserCallback(cmd_list, pcmd);
+                // Callbacks may change texture bindings.
+                last_texture_srv = NULL;
             }
             else
             {
@@ -255,9 +258,13 @@ void ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data)
                 const D3D11_RECT r = { (LONG)(pcmd->ClipRect.x - clip_off.x), (LONG)(pcmd->ClipRect.y - clip_off.y), (LONG)(pcmd->ClipRect.z - clip_off.x), (LONG)(pcmd->ClipRect.w - clip_off.y) };
                 ctx->RSSetScissorRects(1, &r);
 
-                // Bind texture, Draw
+                // Bind texture unless consecutive commands share it, Draw
                 ID3D11ShaderResourceView* texture_srv = (ID3D11ShaderResourceView*)pcmd->TextureId;
-                ctx->PSSetShaderResources(0, 1, &texture_srv);
+                if (texture_srv != last_texture_srv)
+                {
+                    ctx->PSSetShaderResources(0, 1, &texture_srv);
+                    last_texture_srv = texture_srv;
+                }
                 ctx->DrawIndexed(pcmd->ElemCount, pcmd->IdxOffset + global_idx_offset, pcmd->VtxOffset + global_vtx_offset);
             }
         }
@@ -32,6 +32,7 @@
 #include <Urho3D/Graphics/IndexBuffer.h>
 #include <Urho3D/Graphics/Light.h>
 #include <Urho3D/Graphics/Material.h>
+#include <Urho3D/Graphics/MeshOptimizer.h>
 #include <Urho3D/Graphics/Octree.h>
 #include <Urho3D/Graphics/VertexBuffer.h>
 #include <Urho3D/Graphics/Zone.h>
@@ -39,6 +40,7 @@
 #include <Urho3D/IO/FileSystem.h>
 #ifdef URHO3D_PHYSICS
 #include <Urho3D/Physics/PhysicsWorld.h>
+#include <Urho3D/Physics/TriangleMeshBvh.h>
 #endif
 #include <Urho3D/Resource/ResourceCache.h>
 #include <Urho3D/Resource/XMLFile.h>
@@ -75,6 +77,25 @@ struct OutModel
     unsigned totalIndices_{};
 };
 
+/// Geometry of an output model. Vertex and index data is written on worker threads.
+struct OutGeometry
+{
+    aiMesh* mesh_{};
+    VertexBuffer* vertexBuffer_{};
+    IndexBuffer* indexBuffer_{};
+    unsigned geometryIndex_{};
+    unsigned startVertexOffset_{};
+    unsigned startIndexOffset_{};
+    unsigned validFaces_{};
+    bool largeIndices_{};
+    Matrix3x4 vertexTransform_;
+    Matrix3 normalTransform_;
+    ea::vector<ea::vector<unsigned char> > blendIndices_;
+    ea::vector<ea::vector<float> > blendWeights_;
+    BoundingBox box_;
+    Vector3 center_;
+};
+
 struct OutScene
 {
     ea::string outName_;
@@ -164,7 +185,17 @@ bool noOverwriteTexture_ = false;
 bool noOverwriteNewerTexture_ = false;
 bool checkUniqueModel_ = true;
 bool moveToBindPose_ = false;
+bool cookCollisionBvh_ = false;
 unsigned maxBones_ = 64;
+unsigned numLods_ = 1;
+float lodTriangleRatio_ = 0.5f;
+float lodDistanceStep_ = 20.0f;
+float lodMaxError_ = 0.05f;
+bool lodLockBorders_ = true;
+bool quantizeVertices_ = false;
+bool compressStreams_ = false;
+bool optimizeVertexCache_ = false;
+unsigned numThreads_ = M_MAX_UNSIGNED;
 ea::vector<ea::string> nonSkinningBoneIncludes_;
 ea::vector<ea::string> nonSkinningBoneExcludes_;
 
@@ -172,6 +203,8 @@ ea::hash_set<aiAnimation*> allAnimations_;
 ea::vector<aiAnimation*> sceneAnimations_;
 
 float defaultTicksPerSecond_ = 4800.0f;
+// Animation keyframe reduction error, 0 = keep all keyframes
+float keyFrameError_ = 0.0f;
 // For subset animation import usage
 float importStartTime_ = 0.0f;
 float importEndTime_ = 0.0f;
@@ -189,8 +222,12 @@ void CollectBonesFinal(ea::vector<aiNode*>& dest, const ea::hash_set<aiNode*>& n
 void MoveToBindPose(OutModel& model, aiNode* current);
 void CollectAnimations(OutModel* model = nullptr);
 void BuildBoneCollisionInfo(OutModel& model);
+ModelVertexFormat QuantizeVertexFormat(const ModelVertexFormat& vertexFormat);
 void BuildAndSaveModel(OutModel& model);
+void BuildGeometry(OutGeometry& geometry, bool isSkinned);
 void BuildAndSaveAnimations(OutModel* model = nullptr);
+SharedPtr<Animation> BuildAnimation(OutModel* model, aiAnimation* anim, unsigned index, ea::string& animOutName,
+    ea::vector<ea::string>& messages);
 
 void ExportScene(const ea::string& outName, bool asPrefab);
 void CollectSceneModels(OutScene& scene, aiNode* node);
@@ -292,6 +329,8 @@ void Run(const ea::vector<ea::string>& arguments)
             "-pp <path>  Prepend path to resources. Default is empty\n"
             "-r <name>   Use the named scene node as root node\n"
             "-f <freq>   Animation tick frequency to use if unspecified. Default 4800\n"
+            "-ak <error> Remove animation keyframes that interpolation reproduces within the\n"
+            "            error (position and scale units, rotation radians). Default 0 (off)\n"
             "-o          Optimize redundant submeshes. Loses scene hierarchy and animations\n"
             "-s <filter> Include non-skinning bones in the model's skeleton. Can be given a\n"
             "            case-insensitive semicolon separated filter list. Bone is included\n"
@@ -305,6 +344,17 @@ void Run(const ea::vector<ea::string>& arguments)
             "-ctn        Check and do not overwrite if texture has newer timestamp\n"
             "-am         Export all meshes even if identical (scene mode only)\n"
             "-bp         Move bones to bind pose before saving model\n"
+            "-cb         Cook triangle mesh collision BVH of the model into a .bvh file\n"
+            "-lods <n>   Generate simplified LOD levels up to n levels total (static models only)\n"
+            "-lr <ratio> Ratio of triangles kept by each generated LOD level. Default 0.5\n"
+            "-ld <dist>  Distance step between generated LOD levels. Default 20\n"
+            "-le <error> Max simplification error relative to model size. Default 0.05\n"
+            "-lb         Allow simplification to move open mesh border vertices\n"
+            "-q          Quantize normals, tangents and UVs to 16 bits (static models only)\n"
+            "-cs         Compress vertex and index data in the model file\n"
+            "-vc         Reorder triangles for post-transform vertex cache efficiency\n"
+            "-mt <n>     Number of worker threads for geometry and animation conversion.\n"
+            "            Default is number of logical CPUs minus one\n"
             "-split <start> <end> (animation model only)\n"
             "            Split animation, will only import from start frame to end frame\n"
             "-np         Do not suppress $fbx pivot nodes (FBX files only)\n"
@@ -434,6 +484,11 @@ void Run(const ea::vector<ea::string>& arguments)
                 defaultTicksPerSecond_ = ToFloat(value);
                 ++i;
             }
+            else if (argument == "ak" && !value.empty())
+            {
+                keyFrameError_ = Max(ToFloat(value), 0.0f);
+                ++i;
+            }
             else if (argument == "s")
             {
                 includeNonSkinningBones_ = true;
@@ -463,6 +518,41 @@ void Run(const ea::vector<ea::string>& arguments)
                 checkUniqueModel_ = false;
             else if (argument == "bp")
                 moveToBindPose_ = true;
+            else if (argument == "cb")
+                cookCollisionBvh_ = true;
+            else if (argument == "lods" && !value.empty())
+            {
+                numLods_ = Max(ToUInt(value), 1u);
+                ++i;
+            }
+            else if (argument == "lr" && !value.empty())
+            {
+                lodTriangleRatio_ = Clamp(ToFloat(value), 0.0f, 1.0f);
+                ++i;
+            }
+            else if (argument == "ld" && !value.empty())
+            {
+                lodDistanceStep_ = Max(ToFloat(value), 0.0f);
+                ++i;
+            }
+            else if (argument == "le" && !value.empty())
+            {
+                lodMaxError_ = Max(ToFloat(value), 0.0f);
+                ++i;
+            }
+            else if (argument == "lb")
+                lodLockBorders_ = false;
+            else if (argument == "q")
+                quantizeVertices_ = true;
+            else if (argument == "cs")
+                compressStreams_ = true;
+            else if (argument == "vc")
+                optimizeVertexCache_ = true;
+            else if (argument == "mt" && !value.empty())
+            {
+                numThreads_ = ToUInt(value);
+                ++i;
+            }
             else if (argument == "split")
             {
                 ea::string value2 = i + 2 < arguments.size() ? arguments[i + 2] : EMPTY_STRING;
@@ -475,6 +565,9 @@ void Run(const ea::vector<ea::string>& arguments)
         }
     }
 
+    context_->GetSubsystem<WorkQueue>()->CreateThreads(
+        numThreads_ != M_MAX_UNSIGNED ? numThreads_ : Max(GetNumLogicalCPUs(), 1u) - 1);
+
     if (command == "model" || command == "scene" || command == "anim" || command == "node" || command == "dump")
     {
         ea::string inFile = arguments[1];
@@ -991,6 +1084,23 @@ void BuildBoneCollisionInfo(OutModel& model)
     }
 }
 
+ModelVertexFormat QuantizeVertexFormat(const ModelVertexFormat& vertexFormat)
+{
+    ModelVertexFormat result = vertexFormat;
+    if (result.normal_ != ModelVertexFormat::Undefined)
+        result.normal_ = TYPE_SHORT4_NORM;
+    if (result.tangent_ != ModelVertexFormat::Undefined)
+        result.tangent_ = TYPE_SHORT4_NORM;
+    if (result.binormal_ != ModelVertexFormat::Undefined)
+        result.binormal_ = TYPE_SHORT4_NORM;
+    for (VertexElementType& uv : result.uv_)
+    {
+        if (uv == TYPE_VECTOR2)
+            uv = TYPE_HALF2;
+    }
+    return result;
+}
+
 void BuildAndSaveModel(OutModel& model)
 {
     if (!model.rootNode_)
@@ -1047,6 +1157,7 @@ void BuildAndSaveModel(OutModel& model)
     SharedPtr<VertexBuffer> vb;
     ea::vector<SharedPtr<VertexBuffer> > vbVector;
     ea::vector<SharedPtr<IndexBuffer> > ibVector;
+    ea::vector<OutGeometry> geometries;
     unsigned startVertexOffset = 0;
     unsigned startIndexOffset = 0;
     unsigned destGeomIndex = 0;
@@ -1054,6 +1165,7 @@ void BuildAndSaveModel(OutModel& model)
 
     outModel->SetNumGeometries(numValidGeometries);
 
+    // Lay out the buffers and gather skinning data first, then write the geometries in parallel
     for (unsigned i = 0; i < model.meshes_.size(); ++i)
     {
         aiMesh* mesh = model.meshes_[i];
@@ -1091,14 +1203,22 @@ void BuildAndSaveModel(OutModel& model)
             startIndexOffset = 0;
         }
 
+        OutGeometry& outGeometry = geometries.emplace_back();
+        outGeometry.mesh_ = mesh;
+        outGeometry.vertexBuffer_ = vb;
+        outGeometry.indexBuffer_ = ib;
+        outGeometry.geometryIndex_ = destGeomIndex;
+        outGeometry.startVertexOffset_ = startVertexOffset;
+        outGeometry.startIndexOffset_ = startIndexOffset;
+        outGeometry.validFaces_ = validFaces;
+        outGeometry.largeIndices_ = largeIndices;
+
         // Get the world transform of the mesh for baking into the vertices
-        Matrix3x4 vertexTransform;
-        Matrix3 normalTransform;
         Vector3 pos, scale;
         Quaternion rot;
         GetPosRotScale(GetMeshBakingTransform(model.meshNodes_[i], model.rootNode_), pos, rot, scale);
-        vertexTransform = Matrix3x4(pos, rot, scale);
-        normalTransform = rot.RotationMatrix();
+        outGeometry.vertexTransform_ = Matrix3x4(pos, rot, scale);
+        outGeometry.normalTransform_ = rot.RotationMatrix();
 
         SharedPtr<Geometry> geom(new Geometry(context_));
 
@@ -1108,50 +1228,12 @@ void BuildAndSaveModel(OutModel& model)
         if (model.bones_.size() > 0 && !mesh->HasBones())
             PrintLine("Warning: model has bones but geometry " + ea::to_string(i) + " has no skinning information");
 
-        unsigned char* vertexData = vb->GetShadowData();
-        unsigned char* indexData = ib->GetShadowData();
-
-        // Build the index data
-        if (!largeIndices)
-        {
-            unsigned short* dest = (unsigned short*)indexData + startIndexOffset;
-            for (unsigned j = 0; j < mesh->mNumFaces; ++j)
-                WriteShortIndices(dest, mesh, j, startVertexOffset);
-        }
-        else
-        {
-            unsigned* dest = (unsigned*)indexData + startIndexOffset;
-            for (unsigned j = 0; j < mesh->mNumFaces; ++j)
-                WriteLargeIndices(dest, mesh, j, startVertexOffset);
-        }
-
-        // Build the vertex data
         // If there are bones, get blend data
-        ea::vector<ea::vector<unsigned char> > blendIndices;
-        ea::vector<ea::vector<float> > blendWeights;
         ea::vector<unsigned> boneMappings;
         if (model.bones_.size())
-            GetBlendData(model, mesh, model.meshNodes_[i], boneMappings, blendIndices, blendWeights);
-
-        auto* dest = (float*)((unsigned char*)vertexData + startVertexOffset * vb->GetVertexSize());
-        for (unsigned j = 0; j < mesh->mNumVertices; ++j)
-            WriteVertex(dest, mesh, j, isSkinned, box, vertexTransform, normalTransform, blendIndices, blendWeights);
-
-        // Calculate the geometry center
-        Vector3 center = Vector3::ZERO;
-        if (validFaces)
         {
-            for (unsigned j = 0; j < mesh->mNumFaces; ++j)
-            {
-                if (mesh->mFaces[j].mNumIndices == 3)
-                {
-                    center += vertexTransform * ToVector3(mesh->mVertices[mesh->mFaces[j].mIndices[0]]);
-                    center += vertexTransform * ToVector3(mesh->mVertices[mesh->mFaces[j].mIndices[1]]);
-                    center += vertexTransform * ToVector3(mesh->mVertices[mesh->mFaces[j].mIndices[2]]);
-                }
-            }
-
-            center /= (float)validFaces * 3;
+            GetBlendData(model, mesh, model.meshNodes_[i], boneMappings, outGeometry.blendIndices_,
+                outGeometry.blendWeights_);
         }
 
         // Define the geometry
@@ -1160,7 +1242,6 @@ void BuildAndSaveModel(OutModel& model)
         geom->SetDrawRange(TRIANGLE_LIST, startIndexOffset, validFaces * 3, true);
         outModel->SetNumGeometryLodLevels(destGeomIndex, 1);
         outModel->SetGeometry(destGeomIndex, 0, geom);
-        outModel->SetGeometryCenter(destGeomIndex, center);
         if (model.bones_.size() > maxBones_)
             allBoneMappings.push_back(boneMappings);
 
@@ -1169,6 +1250,21 @@ void BuildAndSaveModel(OutModel& model)
         ++destGeomIndex;
     }
 
+    // Geometries occupy disjoint buffer ranges, so they can be written concurrently
+    auto* workQueue = context_->GetSubsystem<WorkQueue>();
+    workQueue->ParallelFor(geometries.size(), 1, [&](unsigned begin, unsigned end, unsigned)
+    {
+        for (unsigned i = begin; i < end; ++i)
+            BuildGeometry(geometries[i], isSkinned);
+    });
+    workQueue->Complete(M_MAX_UNSIGNED);
+
+    for (const OutGeometry& outGeometry : geometries)
+    {
+        box.Merge(outGeometry.box_);
+        outModel->SetGeometryCenter(outGeometry.geometryIndex_, outGeometry.center_);
+    }
+
     // Define the model buffers and bounding box
     ea::vector<unsigned> emptyMorphRange;
     outModel->SetVertexBuffers(vbVector, emptyMorphRange, emptyMorphRange);
@@ -1227,11 +1323,51 @@ void BuildAndSaveModel(OutModel& model)
             outModel->SetGeometryBoneMappings(allBoneMappings);
     }
 
+    // Generate simplified LOD levels and quantize vertex format
+    if (numLods_ > 1 || quantizeVertices_)
+    {
+        auto modelView = MakeShared<ModelView>(context_);
+        if (outModel->GetSkeleton().GetNumBones() > 0 || !modelView->ImportModel(outModel))
+            PrintLine("Warning: LOD generation and vertex quantization are supported for static models only, skipping");
+        else
+        {
+            if (quantizeVertices_)
+                modelView->SetVertexFormat(QuantizeVertexFormat(modelView->GetVertexFormat()));
+
+            ModelLodGenerationParams params;
+            params.numLods_ = numLods_;
+            params.lodDistanceStep_ = lodDistanceStep_;
+            params.simplification_.targetRatio_ = lodTriangleRatio_;
+            params.simplification_.maxError_ = lodMaxError_;
+            params.simplification_.lockBorders_ = lodLockBorders_;
+
+            if (numLods_ > 1)
+            {
+                const unsigned numGeneratedLods = GenerateModelLods(*modelView, params);
+                PrintLine("Generated " + ea::to_string(numGeneratedLods) + " LOD levels");
+            }
+            outModel = modelView->ExportModel();
+        }
+    }
+    outModel->SetCompressedStreams(compressStreams_);
+
     File outFile(context_);
     if (!outFile.Open(model.outName_, FILE_WRITE))
         ErrorExit("Could not open output file " + model.outName_);
     outModel->Save(outFile);
 
+#ifdef URHO3D_PHYSICS
+    // Cook the collision hierarchy next to the model, where CollisionShape looks for it
+    if (cookCollisionBvh_)
+    {
+        SharedPtr<TriangleMeshBvh> bvh(new TriangleMeshBvh(context_));
+        const ea::string bvhName = TriangleMeshBvh::GetCookedName(model.outName_, 0);
+        PrintLine("Writing collision BVH " + bvhName);
+        if (!bvh->Cook(outModel, 0) || !bvh->SaveFile(bvhName))
+            ErrorExit("Could not write collision BVH " + bvhName);
+    }
+#endif
+
     // If exporting materials, also save material list for use by the editor
     if (!noMaterials_ && saveMaterialList_)
     {
@@ -1247,6 +1383,75 @@ void BuildAndSaveModel(OutModel& model)
     }
 }
 
+void BuildGeometry(OutGeometry& geometry, bool isSkinned)
+{
+    aiMesh* mesh = geometry.mesh_;
+    const unsigned startVertexOffset = geometry.startVertexOffset_;
+    unsigned char* vertexData = geometry.vertexBuffer_->GetShadowData();
+    unsigned char* indexData = geometry.indexBuffer_->GetShadowData();
+
+    // Build the index data
+    if (optimizeVertexCache_)
+    {
+        ea::vector<unsigned> indices;
+        indices.reserve(geometry.validFaces_ * 3);
+        for (unsigned j = 0; j < mesh->mNumFaces; ++j)
+        {
+            const aiFace& face = mesh->mFaces[j];
+            if (face.mNumIndices == 3)
+                indices.insert(indices.end(), face.mIndices, face.mIndices + 3);
+        }
+
+        OptimizeVertexCache(indices, mesh->mNumVertices);
+
+        if (!geometry.largeIndices_)
+        {
+            unsigned short* dest = (unsigned short*)indexData + geometry.startIndexOffset_;
+            for (unsigned index : indices)
+                *dest++ = index + startVertexOffset;
+        }
+        else
+        {
+            unsigned* dest = (unsigned*)indexData + geometry.startIndexOffset_;
+            for (unsigned index : indices)
+                *dest++ = index + startVertexOffset;
+        }
+    }
+    else if (!geometry.largeIndices_)
+    {
+        unsigned short* dest = (unsigned short*)indexData + geometry.startIndexOffset_;
+        for (unsigned j = 0; j < mesh->mNumFaces; ++j)
+            WriteShortIndices(dest, mesh, j, startVertexOffset);
+    }
+    else
+    {
+        unsigned* dest = (unsigned*)indexData + geometry.startIndexOffset_;
+        for (unsigned j = 0; j < mesh->mNumFaces; ++j)
+            WriteLargeIndices(dest, mesh, j, startVertexOffset);
+    }
+
+    // Build the vertex data
+    auto* dest = (float*)((unsigned char*)vertexData + startVertexOffset * geometry.vertexBuffer_->GetVertexSize());
+    for (unsigned j = 0; j < mesh->mNumVertices; ++j)
+    {
+        WriteVertex(dest, mesh, j, isSkinned, geometry.box_, geometry.vertexTransform_, geometry.normalTransform_,
+            geometry.blendIndices_, geometry.blendWeights_);
+    }
+
+    // Calculate the geometry center
+    Vector3 center = Vector3::ZERO;
+    for (unsigned j = 0; j < mesh->mNumFaces; ++j)
+    {
+        if (mesh->mFaces[j].mNumIndices == 3)
+        {
+            center += geometry.vertexTransform_ * ToVector3(mesh->mVertices[mesh->mFaces[j].mIndices[0]]);
+            center += geometry.vertexTransform_ * ToVector3(mesh->mVertices[mesh->mFaces[j].mIndices[1]]);
+            center += geometry.vertexTransform_ * ToVector3(mesh->mVertices[mesh->mFaces[j].mIndices[2]]);
+        }
+    }
+    geometry.center_ = center / ((float)geometry.validFaces_ * 3);
+}
+
 void BuildAndSaveAnimations(OutModel* model)
 {
     // extrapolate anim
@@ -1255,252 +1460,274 @@ void BuildAndSaveAnimations(OutModel* model)
     // build and save anim
     const ea::vector<aiAnimation*>& animations = model ? model->animations_ : sceneAnimations_;
 
+    // Animations do not depend on each other: build them in parallel, then report and save in order
+    ea::vector<SharedPtr<Animation> > outAnims(animations.size());
+    ea::vector<ea::string> animOutNames(animations.size());
+    ea::vector<ea::vector<ea::string> > messages(animations.size());
+
+    auto* workQueue = context_->GetSubsystem<WorkQueue>();
+    workQueue->ParallelFor(animations.size(), 1, [&](unsigned begin, unsigned end, unsigned)
+    {
+        for (unsigned i = begin; i < end; ++i)
+            outAnims[i] = BuildAnimation(model, animations[i], i, animOutNames[i], messages[i]);
+    });
+    workQueue->Complete(M_MAX_UNSIGNED);
+
     for (unsigned i = 0; i < animations.size(); ++i)
     {
-        aiAnimation* anim = animations[i];
+        for (const ea::string& message : messages[i])
+            PrintLine(message);
 
-        auto duration = (float)anim->mDuration;
-        ea::string animName = FromAIString(anim->mName);
-        ea::string animOutName;
+        File outFile(context_);
+        if (!outFile.Open(animOutNames[i], FILE_WRITE))
+            ErrorExit("Could not open output file " + animOutNames[i]);
+        outAnims[i]->Save(outFile);
+    }
+}
 
-        float thisImportEndTime = importEndTime_;
-        float thisImportStartTime = importStartTime_;
+SharedPtr<Animation> BuildAnimation(OutModel* model, aiAnimation* anim, unsigned index, ea::string& animOutName,
+    ea::vector<ea::string>& messages)
+{
+    auto duration = (float)anim->mDuration;
+    ea::string animName = FromAIString(anim->mName);
 
-        // If no animation split specified, set the end time to duration
-        if (thisImportEndTime == 0.0f)
-            thisImportEndTime = duration;
+    float thisImportEndTime = importEndTime_;
+    float thisImportStartTime = importStartTime_;
 
-        if (animName.empty())
-            animName = "Anim" + ea::to_string(i + 1);
+    // If no animation split specified, set the end time to duration
+    if (thisImportEndTime == 0.0f)
+        thisImportEndTime = duration;
 
-        ea::string outName = model ? model->outName_ : outName_;
+    if (animName.empty())
+        animName = "Anim" + ea::to_string(index + 1);
 
-        if (context_->GetFileSystem()->DirExists(outName))
-        {
-            animName = SanitateAssetName(animName);
-            outName = AddTrailingSlash(outName);
-        }
-        else
-            animName = GetFileName(outName) + "_" + SanitateAssetName(animName);
+    ea::string outName = model ? model->outName_ : outName_;
 
-        animOutName = GetPath(outName) + animName + ".ani";
+    if (context_->GetFileSystem()->DirExists(outName))
+    {
+        animName = SanitateAssetName(animName);
+        outName = AddTrailingSlash(outName);
+    }
+    else
+        animName = GetFileName(outName) + "_" + SanitateAssetName(animName);
 
-        auto ticksPerSecond = (float)anim->mTicksPerSecond;
-        // If ticks per second not specified, it's probably a .X file. In this case use the default tick rate
-        if (ticksPerSecond < M_EPSILON)
-            ticksPerSecond = defaultTicksPerSecond_;
-        float tickConversion = 1.0f / ticksPerSecond;
+    animOutName = GetPath(outName) + animName + ".ani";
 
-        // Find out the start time of animation from each channel's first keyframe for adjusting the keyframe times
-        // to start from zero
-        float startTime = duration;
-        for (unsigned j = 0; j < anim->mNumChannels; ++j)
-        {
-            aiNodeAnim* channel = anim->mChannels[j];
-            if (channel->mNumPositionKeys > 0)
-                startTime = Min(startTime, (float)channel->mPositionKeys[0].mTime);
-            if (channel->mNumRotationKeys > 0)
-                startTime = Min(startTime, (float)channel->mRotationKeys[0].mTime);
-            if (channel->mNumScalingKeys > 0)
-                startTime = Min(startTime, (float)channel->mScalingKeys[0].mTime);
-        }
-        if (startTime > thisImportStartTime)
-            thisImportStartTime = startTime;
-        duration = thisImportEndTime - thisImportStartTime;
+    auto ticksPerSecond = (float)anim->mTicksPerSecond;
+    // If ticks per second not specified, it's probably a .X file. In this case use the default tick rate
+    if (ticksPerSecond < M_EPSILON)
+        ticksPerSecond = defaultTicksPerSecond_;
+    float tickConversion = 1.0f / ticksPerSecond;
 
-        SharedPtr<Animation> outAnim(new Animation(context_));
-        outAnim->SetAnimationName(animName);
-        outAnim->SetLength(duration * tickConversion);
+    // Find out the start time of animation from each channel's first keyframe for adjusting the keyframe times
+    // to start from zero
+    float startTime = duration;
+    for (unsigned j = 0; j < anim->mNumChannels; ++j)
+    {
+        aiNodeAnim* channel = anim->mChannels[j];
+        if (channel->mNumPositionKeys > 0)
+            startTime = Min(startTime, (float)channel->mPositionKeys[0].mTime);
+        if (channel->mNumRotationKeys > 0)
+            startTime = Min(startTime, (float)channel->mRotationKeys[0].mTime);
+        if (channel->mNumScalingKeys > 0)
+            startTime = Min(startTime, (float)channel->mScalingKeys[0].mTime);
+    }
+    if (startTime > thisImportStartTime)
+        thisImportStartTime = startTime;
+    duration = thisImportEndTime - thisImportStartTime;
 
-        PrintLine("Writing animation " + animName + " length " + ea::to_string(outAnim->GetLength()));
-        for (unsigned j = 0; j < anim->mNumChannels; ++j)
+    SharedPtr<Animation> outAnim(new Animation(context_));
+    outAnim->SetAnimationName(animName);
+    outAnim->SetLength(duration * tickConversion);
+
+    messages.push_back("Writing animation " + animName + " length " + ea::to_string(outAnim->GetLength()));
+    for (unsigned j = 0; j < anim->mNumChannels; ++j)
+    {
+        aiNodeAnim* channel = anim->mChannels[j];
+        ea::string channelName = FromAIString(channel->mNodeName);
+        aiNode* boneNode = nullptr;
+
+        if (model)
         {
-            aiNodeAnim* channel = anim->mChannels[j];
-            ea::string channelName = FromAIString(channel->mNodeName);
-            aiNode* boneNode = nullptr;
+            unsigned boneIndex;
+            unsigned pos = channelName.find("_$AssimpFbx$");
 
-            if (model)
+            if (!suppressFbxPivotNodes_ || pos == ea::string::npos)
             {
-                unsigned boneIndex;
-                unsigned pos = channelName.find("_$AssimpFbx$");
-
-                if (!suppressFbxPivotNodes_ || pos == ea::string::npos)
+                boneIndex = GetBoneIndex(*model, channelName);
+                if (boneIndex == M_MAX_UNSIGNED)
                 {
-                    boneIndex = GetBoneIndex(*model, channelName);
-                    if (boneIndex == M_MAX_UNSIGNED)
-                    {
-                        PrintLine("Warning: skipping animation track " + channelName + " not found in model skeleton");
-                        outAnim->RemoveTrack(channelName);
-                        continue;
-                    }
-                    boneNode = model->bones_[boneIndex];
-                }
-                else
-                {
-                    channelName = channelName.substr(0, pos);
-
-                    // every first $fbx animation channel for a bone will consolidate other $fbx animation to a single channel
-                    // skip subsequent $fbx animation channel for the same bone
-                    if (outAnim->GetTrack(channelName) != nullptr)
-                        continue;
-
-                    boneIndex = GetPivotlessBoneIndex(*model, channelName);
-                    if (boneIndex == M_MAX_UNSIGNED)
-                    {
-                        PrintLine("Warning: skipping animation track " + channelName + " not found in model skeleton");
-                        outAnim->RemoveTrack(channelName);
-                        continue;
-                    }
-
-                    boneNode = model->pivotlessBones_[boneIndex];
+                    messages.push_back("Warning: skipping animation track " + channelName + " not found in model skeleton");
+                    outAnim->RemoveTrack(channelName);
+                    continue;
                 }
+                boneNode = model->bones_[boneIndex];
             }
             else
             {
-                boneNode = GetNode(channelName, scene_->mRootNode);
-                if (!boneNode)
+                channelName = channelName.substr(0, pos);
+
+                // every first $fbx animation channel for a bone will consolidate other $fbx animation to a single channel
+                // skip subsequent $fbx animation channel for the same bone
+                if (outAnim->GetTrack(channelName) != nullptr)
+                    continue;
+
+                boneIndex = GetPivotlessBoneIndex(*model, channelName);
+                if (boneIndex == M_MAX_UNSIGNED)
                 {
-                    PrintLine("Warning: skipping animation track " + channelName + " whose scene node was not found");
+                    messages.push_back("Warning: skipping animation track " + channelName + " not found in model skeleton");
                     outAnim->RemoveTrack(channelName);
                     continue;
                 }
-            }
 
-            // To export single frame animation, check if first key frame is identical to bone transformation
-            aiVector3D bonePos, boneScale;
-            aiQuaternion boneRot;
-            boneNode->mTransformation.Decompose(boneScale, boneRot, bonePos);
-
-            bool posEqual = true;
-            bool scaleEqual = true;
-            bool rotEqual = true;
-
-            if (channel->mNumPositionKeys > 0 && !ToVector3(bonePos).Equals(ToVector3(channel->mPositionKeys[0].mValue)))
-                posEqual = false;
-            if (channel->mNumScalingKeys > 0 && !ToVector3(boneScale).Equals(ToVector3(channel->mScalingKeys[0].mValue)))
-                scaleEqual = false;
-            if (channel->mNumRotationKeys > 0 && !ToQuaternion(boneRot).Equals(ToQuaternion(channel->mRotationKeys[0].mValue)))
-                rotEqual = false;
-
-            AnimationTrack* track = outAnim->CreateTrack(channelName);
-
-            // Check which channels are used
-            track->channelMask_ = CHANNEL_NONE;
-            if (channel->mNumPositionKeys > 1 || !posEqual)
-                track->channelMask_ |= CHANNEL_POSITION;
-            if (channel->mNumRotationKeys > 1 || !rotEqual)
-                track->channelMask_ |= CHANNEL_ROTATION;
-            if (channel->mNumScalingKeys > 1 || !scaleEqual)
-                track->channelMask_ |= CHANNEL_SCALE;
-            // Check for redundant identity scale in all keyframes and remove in that case
-            if (track->channelMask_ & CHANNEL_SCALE)
-            {
-                bool redundantScale = true;
-                for (unsigned k = 0; k < channel->mNumScalingKeys; ++k)
-                {
-                    float SCALE_EPSILON = 0.000001f;
-                    Vector3 scaleVec = ToVector3(channel->mScalingKeys[k].mValue);
-                    if (fabsf(scaleVec.x_ - 1.0f) >= SCALE_EPSILON || fabsf(scaleVec.y_ - 1.0f) >= SCALE_EPSILON ||
-                        fabsf(scaleVec.z_ - 1.0f) >= SCALE_EPSILON)
-                    {
-                        redundantScale = false;
-                        break;
-                    }
-                }
-                if (redundantScale)
-                    track->channelMask_ &= ~CHANNEL_SCALE;
+                boneNode = model->pivotlessBones_[boneIndex];
             }
-
-            if (!track->channelMask_)
+        }
+        else
+        {
+            boneNode = GetNode(channelName, scene_->mRootNode);
+            if (!boneNode)
             {
-                PrintLine("Warning: skipping animation track " + channelName + " with no keyframes");
+                messages.push_back("Warning: skipping animation track " + channelName + " whose scene node was not found");
                 outAnim->RemoveTrack(channelName);
                 continue;
             }
+        }
 
-            // Currently only same amount of keyframes is supported
-            // Note: should also check the times of individual keyframes for match
-            if ((channel->mNumPositionKeys > 1 && channel->mNumRotationKeys > 1 && channel->mNumPositionKeys != channel->mNumRotationKeys) ||
-                (channel->mNumPositionKeys > 1 && channel->mNumScalingKeys > 1 && channel->mNumPositionKeys != channel->mNumScalingKeys) ||
-                (channel->mNumRotationKeys > 1 && channel->mNumScalingKeys > 1 && channel->mNumRotationKeys != channel->mNumScalingKeys))
+        // To export single frame animation, check if first key frame is identical to bone transformation
+        aiVector3D bonePos, boneScale;
+        aiQuaternion boneRot;
+        boneNode->mTransformation.Decompose(boneScale, boneRot, bonePos);
+
+        bool posEqual = true;
+        bool scaleEqual = true;
+        bool rotEqual = true;
+
+        if (channel->mNumPositionKeys > 0 && !ToVector3(bonePos).Equals(ToVector3(channel->mPositionKeys[0].mValue)))
+            posEqual = false;
+        if (channel->mNumScalingKeys > 0 && !ToVector3(boneScale).Equals(ToVector3(channel->mScalingKeys[0].mValue)))
+            scaleEqual = false;
+        if (channel->mNumRotationKeys > 0 && !ToQuaternion(boneRot).Equals(ToQuaternion(channel->mRotationKeys[0].mValue)))
+            rotEqual = false;
+
+        AnimationTrack* track = outAnim->CreateTrack(channelName);
+
+        // Check which channels are used
+        track->channelMask_ = CHANNEL_NONE;
+        if (channel->mNumPositionKeys > 1 || !posEqual)
+            track->channelMask_ |= CHANNEL_POSITION;
+        if (channel->mNumRotationKeys > 1 || !rotEqual)
+            track->channelMask_ |= CHANNEL_ROTATION;
+        if (channel->mNumScalingKeys > 1 || !scaleEqual)
+            track->channelMask_ |= CHANNEL_SCALE;
+        // Check for redundant identity scale in all keyframes and remove in that case
+        if (track->channelMask_ & CHANNEL_SCALE)
+        {
+            bool redundantScale = true;
+            for (unsigned k = 0; k < channel->mNumScalingKeys; ++k)
             {
-                PrintLine("Warning: differing amounts of channel keyframes, skipping animation track " + channelName);
-                outAnim->RemoveTrack(channelName);
-                continue;
+                float SCALE_EPSILON = 0.000001f;
+                Vector3 scaleVec = ToVector3(channel->mScalingKeys[k].mValue);
+                if (fabsf(scaleVec.x_ - 1.0f) >= SCALE_EPSILON || fabsf(scaleVec.y_ - 1.0f) >= SCALE_EPSILON ||
+                    fabsf(scaleVec.z_ - 1.0f) >= SCALE_EPSILON)
+                {
+                    redundantScale = false;
+                    break;
+                }
             }
+            if (redundantScale)
+                track->channelMask_ &= ~CHANNEL_SCALE;
+        }
 
-            unsigned keyFrames = channel->mNumPositionKeys;
-            if (channel->mNumRotationKeys > keyFrames)
-                keyFrames = channel->mNumRotationKeys;
-            if (channel->mNumScalingKeys > keyFrames)
-                keyFrames = channel->mNumScalingKeys;
+        if (!track->channelMask_)
+        {
+            messages.push_back("Warning: skipping animation track " + channelName + " with no keyframes");
+            outAnim->RemoveTrack(channelName);
+            continue;
+        }
 
-            for (unsigned k = 0; k < keyFrames; ++k)
+        // Currently only same amount of keyframes is supported
+        // Note: should also check the times of individual keyframes for match
+        if ((channel->mNumPositionKeys > 1 && channel->mNumRotationKeys > 1 && channel->mNumPositionKeys != channel->mNumRotationKeys) ||
+            (channel->mNumPositionKeys > 1 && channel->mNumScalingKeys > 1 && channel->mNumPositionKeys != channel->mNumScalingKeys) ||
+            (channel->mNumRotationKeys > 1 && channel->mNumScalingKeys > 1 && channel->mNumRotationKeys != channel->mNumScalingKeys))
+        {
+            messages.push_back("Warning: differing amounts of channel keyframes, skipping animation track " + channelName);
+            outAnim->RemoveTrack(channelName);
+            continue;
+        }
+
+        unsigned keyFrames = channel->mNumPositionKeys;
+        if (channel->mNumRotationKeys > keyFrames)
+            keyFrames = channel->mNumRotationKeys;
+        if (channel->mNumScalingKeys > keyFrames)
+            keyFrames = channel->mNumScalingKeys;
+
+        for (unsigned k = 0; k < keyFrames; ++k)
+        {
+            AnimationKeyFrame kf;
+            kf.time_ = 0.0f;
+            kf.position_ = Vector3::ZERO;
+            kf.rotation_ = Quaternion::IDENTITY;
+            kf.scale_ = Vector3::ONE;
+
+            // Get time for the keyframe. Adjust with animation's start time
+            if (track->channelMask_ & CHANNEL_POSITION && k < channel->mNumPositionKeys)
+                kf.time_ = ((float)channel->mPositionKeys[k].mTime - startTime);
+            else if (track->channelMask_ & CHANNEL_ROTATION && k < channel->mNumRotationKeys)
+                kf.time_ = ((float)channel->mRotationKeys[k].mTime - startTime);
+            else if (track->channelMask_ & CHANNEL_SCALE && k < channel->mNumScalingKeys)
+                kf.time_ = ((float)channel->mScalingKeys[k].mTime - startTime);
+
+            // Make sure time stays positive
+            kf.time_ = Max(kf.time_, 0.0f);
+
+            // Start with the bone's base transform
+            aiMatrix4x4 boneTransform = boneNode->mTransformation;
+            aiVector3D pos, scale;
+            aiQuaternion rot;
+            boneTransform.Decompose(scale, rot, pos);
+            // Then apply the active channels
+            if (track->channelMask_ & CHANNEL_POSITION && k < channel->mNumPositionKeys)
+                pos = channel->mPositionKeys[k].mValue;
+            if (track->channelMask_ & CHANNEL_ROTATION && k < channel->mNumRotationKeys)
+                rot = channel->mRotationKeys[k].mValue;
+            if (track->channelMask_ & CHANNEL_SCALE && k < channel->mNumScalingKeys)
+                scale = channel->mScalingKeys[k].mValue;
+
+            // If root bone, transform with nodes in between model root node (if any)
+            if (model && boneNode == model->rootBone_)
             {
-                AnimationKeyFrame kf;
-                kf.time_ = 0.0f;
-                kf.position_ = Vector3::ZERO;
-                kf.rotation_ = Quaternion::IDENTITY;
-                kf.scale_ = Vector3::ONE;
-
-                // Get time for the keyframe. Adjust with animation's start time
-                if (track->channelMask_ & CHANNEL_POSITION && k < channel->mNumPositionKeys)
-                    kf.time_ = ((float)channel->mPositionKeys[k].mTime - startTime);
-                else if (track->channelMask_ & CHANNEL_ROTATION && k < channel->mNumRotationKeys)
-                    kf.time_ = ((float)channel->mRotationKeys[k].mTime - startTime);
-                else if (track->channelMask_ & CHANNEL_SCALE && k < channel->mNumScalingKeys)
-                    kf.time_ = ((float)channel->mScalingKeys[k].mTime - startTime);
-
-                // Make sure time stays positive
-                kf.time_ = Max(kf.time_, 0.0f);
-
-                // Start with the bone's base transform
-                aiMatrix4x4 boneTransform = boneNode->mTransformation;
-                aiVector3D pos, scale;
-                aiQuaternion rot;
-                boneTransform.Decompose(scale, rot, pos);
-                // Then apply the active channels
-                if (track->channelMask_ & CHANNEL_POSITION && k < channel->mNumPositionKeys)
-                    pos = channel->mPositionKeys[k].mValue;
-                if (track->channelMask_ & CHANNEL_ROTATION && k < channel->mNumRotationKeys)
-                    rot = channel->mRotationKeys[k].mValue;
-                if (track->channelMask_ & CHANNEL_SCALE && k < channel->mNumScalingKeys)
-                    scale = channel->mScalingKeys[k].mValue;
-
-                // If root bone, transform with nodes in between model root node (if any)
-                if (model && boneNode == model->rootBone_)
-                {
-                    aiMatrix4x4 transMat, scaleMat, rotMat;
-                    aiMatrix4x4::Translation(pos, transMat);
-                    aiMatrix4x4::Scaling(scale, scaleMat);
-                    rotMat = aiMatrix4x4(rot.GetMatrix());
-                    aiMatrix4x4 tform = transMat * rotMat * scaleMat;
-                    aiMatrix4x4 tformOld = tform;
-                    tform = GetDerivedTransform(tform, boneNode, model->rootNode_, false);
-                    // Do not decompose if did not actually change
-                    if (tform != tformOld)
-                        tform.Decompose(scale, rot, pos);
-                }
+                aiMatrix4x4 transMat, scaleMat, rotMat;
+                aiMatrix4x4::Translation(pos, transMat);
+                aiMatrix4x4::Scaling(scale, scaleMat);
+                rotMat = aiMatrix4x4(rot.GetMatrix());
+                aiMatrix4x4 tform = transMat * rotMat * scaleMat;
+                aiMatrix4x4 tformOld = tform;
+                tform = GetDerivedTransform(tform, boneNode, model->rootNode_, false);
+                // Do not decompose if did not actually change
+                if (tform != tformOld)
+                    tform.Decompose(scale, rot, pos);
+            }
 
-                if (track->channelMask_ & CHANNEL_POSITION)
-                    kf.position_ = ToVector3(pos);
-                if (track->channelMask_ & CHANNEL_ROTATION)
-                    kf.rotation_ = ToQuaternion(rot);
-                if (track->channelMask_ & CHANNEL_SCALE)
-                    kf.scale_ = ToVector3(scale);
-                if (kf.time_ >= thisImportStartTime && kf.time_ <= thisImportEndTime)
-                {
-                    kf.time_ = (kf.time_ - thisImportStartTime) * tickConversion;
-                    track->keyFrames_.push_back(kf);
-                }
+            if (track->channelMask_ & CHANNEL_POSITION)
+                kf.position_ = ToVector3(pos);
+            if (track->channelMask_ & CHANNEL_ROTATION)
+                kf.rotation_ = ToQuaternion(rot);
+            if (track->channelMask_ & CHANNEL_SCALE)
+                kf.scale_ = ToVector3(scale);
+            if (kf.time_ >= thisImportStartTime && kf.time_ <= thisImportEndTime)
+            {
+                kf.time_ = (kf.time_ - thisImportStartTime) * tickConversion;
+                track->keyFrames_.push_back(kf);
             }
         }
-
-        File outFile(context_);
-        if (!outFile.Open(animOutName, FILE_WRITE))
-            ErrorExit("Could not open output file " + animOutName);
-        outAnim->Save(outFile);
     }
+
+    if (keyFrameError_ > 0.0f)
+        outAnim->RemoveRedundantKeyFrames(keyFrameError_, keyFrameError_, keyFrameError_);
+
+    return outAnim;
 }
 
 void ExportScene(const ea::string& outName, bool asPrefab)
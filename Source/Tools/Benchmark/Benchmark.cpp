@@ -0,0 +1,567 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Core/CommandLine.h>
+#include <Urho3D/Core/CoreEvents.h>
+#include <Urho3D/Core/FrameStatistics.h>
+#include <Urho3D/Engine/Application.h>
+#include <Urho3D/Engine/Engine.h>
+#include <Urho3D/Engine/EngineDefs.h>
+#include <Urho3D/Graphics/Camera.h>
+#include <Urho3D/Graphics/GPUProfiler.h>
+#include <Urho3D/Graphics/Light.h>
+#include <Urho3D/Graphics/Material.h>
+#include <Urho3D/Graphics/Model.h>
+#include <Urho3D/Graphics/Octree.h>
+#include <Urho3D/Graphics/Renderer.h>
+#include <Urho3D/Graphics/RenderPath.h>
+#include <Urho3D/Graphics/StaticModel.h>
+#include <Urho3D/Graphics/Viewport.h>
+#include <Urho3D/Graphics/Zone.h>
+#include <Urho3D/IO/File.h>
+#include <Urho3D/IO/Log.h>
+#include <Urho3D/Resource/JSONFile.h>
+#include <Urho3D/Resource/ResourceCache.h>
+#include <Urho3D/Resource/XMLFile.h>
+#include <Urho3D/Scene/Scene.h>
+#if URHO3D_PHYSICS
+#include <Urho3D/Physics/CollisionShape.h>
+#include <Urho3D/Physics/PhysicsWorld.h>
+#include <Urho3D/Physics/RigidBody.h>
+#endif
+
+#include <EASTL/sort.h>
+
+
+using namespace Urho3D;
+
+/// Camera keyframe of a benchmark path.
+struct CameraKeyframe
+{
+    /// Camera position.
+    Vector3 position_;
+    /// Point the camera looks at.
+    Vector3 target_;
+};
+
+/// Return keyframes of a closed orbit around the center.
+static ea::vector<CameraKeyframe> MakeOrbitPath(const Vector3& center, float radius, float height, unsigned numKeyframes = 17)
+{
+    ea::vector<CameraKeyframe> path(numKeyframes);
+    for (unsigned i = 0; i < numKeyframes; ++i)
+    {
+        const float angle = 360.0f * i / (numKeyframes - 1);
+        path[i].position_ = center + Vector3(Sin(angle) * radius, height, -Cos(angle) * radius);
+        path[i].target_ = center;
+    }
+    return path;
+}
+
+/// Return percentiles of the values. Sorts the values.
+static FrameStatisticsPercentiles GetPercentiles(ea::vector<float>& values)
+{
+    FrameStatisticsPercentiles percentiles;
+    if (values.empty())
+        return percentiles;
+
+    ea::sort(values.begin(), values.end());
+    const unsigned numValues = values.size();
+    const auto percentile = [&](float fraction) { return values[Min(static_cast<unsigned>(fraction * numValues), numValues - 1)]; };
+    percentiles.p50_ = percentile(0.50f);
+    percentiles.p95_ = percentile(0.95f);
+    percentiles.p99_ = percentile(0.99f);
+    percentiles.max_ = values.back();
+    return percentiles;
+}
+
+/// Convert percentiles to JSON.
+static JSONValue PercentilesToJSON(const FrameStatisticsPercentiles& percentiles)
+{
+    JSONValue value;
+    value.Set("p50", percentiles.p50_);
+    value.Set("p95", percentiles.p95_);
+    value.Set("p99", percentiles.p99_);
+    value.Set("max", percentiles.max_);
+    return value;
+}
+
+/// Plays scripted camera paths through benchmark scenes modelled after the samples at a fixed time step, records CPU
+/// stage and GPU timings, saves them as JSON and compares them against a baseline.
+class BenchmarkApplication : public Application
+{
+    URHO3D_OBJECT(BenchmarkApplication, Application);
+public:
+    /// Scene content builder. Fills the scene and the camera path.
+    using SceneBuilder = void(BenchmarkApplication::*)(Scene* scene, ea::vector<CameraKeyframe>& path);
+
+    /// Benchmark scene description.
+    struct BenchmarkScene
+    {
+        /// Name used in the results.
+        const char* name_;
+        /// Content builder.
+        SceneBuilder builder_;
+        /// Whether to render in HDR.
+        bool hdr_;
+    };
+
+    explicit BenchmarkApplication(Context* context) : Application(context)
+    {
+    }
+
+    void Setup() override
+    {
+        engineParameters_[EP_WINDOW_TITLE] = GetTypeName();
+        engineParameters_[EP_WINDOW_WIDTH] = 1280;
+        engineParameters_[EP_WINDOW_HEIGHT] = 720;
+        engineParameters_[EP_FULL_SCREEN] = false;
+        engineParameters_[EP_SOUND] = false;
+        engineParameters_[EP_VSYNC] = false;
+        engineParameters_[EP_FRAME_LIMITER] = false;
+        engineParameters_[EP_RESOURCE_PATHS] = "Data;CoreData";
+        engineParameters_[EP_RESOURCE_PREFIX_PATHS] = ";..;../..";
+
+        auto& app = GetCommandLineParser();
+        app.add_option("--scenes", sceneNames_, "Comma-separated benchmark scenes to run. Runs all scenes when empty.");
+        app.add_option("--frames", numFrames_, "Number of measured frames per scene.");
+        app.add_option("--warmup", numWarmupFrames_, "Number of frames per scene rendered before measuring.");
+        app.add_option("--time-step", timeStep_, "Fixed time step of every frame in seconds.");
+        app.add_option("--output", outputFile_, "JSON file the results are saved to.");
+        app.add_option("--baseline", baselineFile_, "JSON results of an earlier run to compare against. Regressions fail the run.");
+        app.add_option("--tolerance", tolerance_, "Relative increase of a median time over the baseline reported as regression.");
+        app.add_option("--min-delta", minDelta_, "Absolute increase of a median time in milliseconds below which no regression is reported.");
+    }
+
+    void Start() override
+    {
+        static const BenchmarkScene allScenes[] = {
+            { "HugeObjectCount", &BenchmarkApplication::CreateHugeObjectCount, false },
+#if URHO3D_PHYSICS
+            { "PhysicsStressTest", &BenchmarkApplication::CreatePhysicsStressTest, false },
+#endif
+            { "PBRMaterials", &BenchmarkApplication::CreatePBRMaterials, true },
+            { "BakedLighting", &BenchmarkApplication::CreateBakedLighting, false },
+        };
+
+        const ea::vector<ea::string> requested = sceneNames_.split(',');
+        for (const BenchmarkScene& scene : allScenes)
+        {
+            if (requested.empty() || ea::find(requested.begin(), requested.end(), scene.name_) != requested.end())
+                scenes_.push_back(scene);
+        }
+        if (scenes_.empty())
+        {
+            ErrorExit(Format("No benchmark scenes match '{}'", sceneNames_));
+            return;
+        }
+        if (numFrames_ == 0 || timeStep_ <= 0.0f)
+        {
+            ErrorExit("Number of frames and time step must be positive");
+            return;
+        }
+
+        auto* renderer = GetSubsystem<Renderer>();
+        if (!renderer)
+        {
+            ErrorExit("Benchmark requires rendering, headless mode is not supported");
+            return;
+        }
+        renderer->SetGPUProfiling(true);
+        if (!renderer->GetGPUProfiler()->IsSupported())
+            URHO3D_LOGWARNING("GPU timestamp queries are not supported, GPU times are not recorded");
+
+        GetSubsystem<FrameStatistics>()->SetEnabled(true);
+        GetSubsystem<FrameStatistics>()->SetCapacity(numFrames_);
+
+        results_.Set("timeStep", timeStep_);
+        results_.Set("frames", numFrames_);
+        results_.Set("scenes", JSONValue(JSON_OBJECT));
+
+        SubscribeToEvent(E_UPDATE, [this](StringHash, VariantMap&) { UpdateCamera(); });
+        SubscribeToEvent(E_ENDFRAME, [this](StringHash, VariantMap&) { EndFrame(); });
+
+        StartScene(0);
+        engine_->SetNextTimeStep(timeStep_);
+    }
+
+    void Stop() override
+    {
+        scene_ = nullptr;
+    }
+
+private:
+    /// Create a grid of boxes like the HugeObjectCount sample.
+    void CreateHugeObjectCount(Scene* scene, ea::vector<CameraKeyframe>& path)
+    {
+        auto* cache = GetSubsystem<ResourceCache>();
+        scene->CreateComponent<Octree>();
+
+        auto* zone = scene->CreateChild("Zone")->CreateComponent<Zone>();
+        zone->SetBoundingBox(BoundingBox(-1000.0f, 1000.0f));
+        zone->SetFogColor(Color(0.2f, 0.2f, 0.2f));
+        zone->SetFogStart(200.0f);
+        zone->SetFogEnd(300.0f);
+
+        Node* lightNode = scene->CreateChild("DirectionalLight");
+        lightNode->SetDirection(Vector3(-0.6f, -1.0f, -0.8f));
+        auto* light = lightNode->CreateComponent<Light>();
+        light->SetLightType(LIGHT_DIRECTIONAL);
+
+        Model* boxModel = cache->GetResource<Model>("Models/Box.mdl");
+        for (int y = -125; y < 125; ++y)
+        {
+            for (int x = -125; x < 125; ++x)
+            {
+                Node* boxNode = scene->CreateChild("Box");
+                boxNode->SetPosition(Vector3(x * 0.3f, 0.0f, y * 0.3f));
+                boxNode->SetScale(0.25f);
+                boxNode->CreateComponent<StaticModel>()->SetModel(boxModel);
+            }
+        }
+
+        path = MakeOrbitPath(Vector3::ZERO, 60.0f, 20.0f);
+    }
+
+#if URHO3D_PHYSICS
+    /// Create falling boxes and static mushrooms like the PhysicsStressTest sample.
+    void CreatePhysicsStressTest(Scene* scene, ea::vector<CameraKeyframe>& path)
+    {
+        auto* cache = GetSubsystem<ResourceCache>();
+        scene->CreateComponent<Octree>();
+        scene->CreateComponent<PhysicsWorld>();
+
+        auto* zone = scene->CreateChild("Zone")->CreateComponent<Zone>();
+        zone->SetBoundingBox(BoundingBox(-1000.0f, 1000.0f));
+        zone->SetAmbientColor(Color(0.15f, 0.15f, 0.15f));
+        zone->SetFogColor(Color(0.5f, 0.5f, 0.7f));
+        zone->SetFogStart(100.0f);
+        zone->SetFogEnd(300.0f);
+
+        Node* lightNode = scene->CreateChild("DirectionalLight");
+        lightNode->SetDirection(Vector3(0.6f, -1.0f, 0.8f));
+        auto* light = lightNode->CreateComponent<Light>();
+        light->SetLightType(LIGHT_DIRECTIONAL);
+        light->SetCastShadows(true);
+        light->SetShadowBias(BiasParameters(0.00025f, 0.5f));
+        light->SetShadowCascade(CascadeParameters(10.0f, 50.0f, 200.0f, 0.0f, 0.8f));
+
+        Node* floorNode = scene->CreateChild("Floor");
+        floorNode->SetPosition(Vector3(0.0f, -0.5f, 0.0f));
+        floorNode->SetScale(Vector3(500.0f, 1.0f, 500.0f));
+        auto* floorObject = floorNode->CreateComponent<StaticModel>();
+        floorObject->SetModel(cache->GetResource<Model>("Models/Box.mdl"));
+        floorObject->SetMaterial(cache->GetResource<Material>("Materials/StoneTiled.xml"));
+        floorNode->CreateComponent<RigidBody>();
+        floorNode->CreateComponent<CollisionShape>()->SetBox(Vector3::ONE);
+
+        // Fixed seed so that every run simulates the same scene
+        SetRandomSeed(1);
+        for (unsigned i = 0; i < 50; ++i)
+        {
+            Node* mushroomNode = scene->CreateChild("Mushroom");
+            mushroomNode->SetPosition(Vector3(Random(400.0f) - 200.0f, 0.0f, Random(400.0f) - 200.0f));
+            mushroomNode->SetRotation(Quaternion(0.0f, Random(360.0f), 0.0f));
+            mushroomNode->SetScale(5.0f + Random(5.0f));
+            auto* mushroomObject = mushroomNode->CreateComponent<StaticModel>();
+            mushroomObject->SetModel(cache->GetResource<Model>("Models/Mushroom.mdl"));
+            mushroomObject->SetMaterial(cache->GetResource<Material>("Materials/Mushroom.xml"));
+            mushroomObject->SetCastShadows(true);
+            mushroomNode->CreateComponent<RigidBody>();
+            mushroomNode->CreateComponent<CollisionShape>()->SetTriangleMesh(mushroomObject->GetModel());
+        }
+
+        for (unsigned i = 0; i < 1000; ++i)
+        {
+            Node* boxNode = scene->CreateChild("Box");
+            boxNode->SetPosition(Vector3(0.0f, i * 2.0f + 100.0f, 0.0f));
+            auto* boxObject = boxNode->CreateComponent<StaticModel>();
+            boxObject->SetModel(cache->GetResource<Model>("Models/Box.mdl"));
+            boxObject->SetMaterial(cache->GetResource<Material>("Materials/StoneSmall.xml"));
+            boxObject->SetCastShadows(true);
+            auto* body = boxNode->CreateComponent<RigidBody>();
+            body->SetMass(1.0f);
+            body->SetFriction(1.0f);
+            body->SetCollisionEventMode(COLLISION_NEVER);
+            boxNode->CreateComponent<CollisionShape>()->SetBox(Vector3::ONE);
+        }
+
+        path = MakeOrbitPath(Vector3::ZERO, 40.0f, 15.0f);
+    }
+#endif
+
+    /// Load the scene of the PBRMaterials sample.
+    void CreatePBRMaterials(Scene* scene, ea::vector<CameraKeyframe>& path)
+    {
+        LoadScene(scene, "Scenes/PBRExample.xml");
+
+        Node* sphereNode = scene->GetChild("SphereWithDynamicMat");
+        const Vector3 center = sphereNode ? sphereNode->GetWorldPosition() : Vector3::ZERO;
+        path = MakeOrbitPath(center, 6.0f, 2.0f);
+    }
+
+    /// Load the scene of the BakedLighting sample.
+    void CreateBakedLighting(Scene* scene, ea::vector<CameraKeyframe>& path)
+    {
+        LoadScene(scene, "Scenes/BakedLightingExample.xml");
+
+        // Orbit around the point the scene camera looks at, starting from the scene camera
+        if (auto* camera = scene->GetComponent<Camera>(true))
+        {
+            Node* cameraNode = camera->GetNode();
+            const Vector3 position = cameraNode->GetWorldPosition();
+            const Vector3 target = position + cameraNode->GetWorldDirection() * 8.0f;
+            const Vector3 offset = position - target;
+            path = MakeOrbitPath(target, Vector3(offset.x_, 0.0f, offset.z_).Length(), offset.y_);
+        }
+        else
+            path = MakeOrbitPath(Vector3::ZERO, 10.0f, 4.0f);
+    }
+
+    /// Load scene content from XML resource.
+    void LoadScene(Scene* scene, const ea::string& fileName)
+    {
+        auto* cache = GetSubsystem<ResourceCache>();
+        SharedPtr<File> file = cache->GetFile(fileName);
+        if (!file || !scene->LoadXML(*file))
+            URHO3D_LOGERROR("Failed to load benchmark scene {}", fileName);
+    }
+
+    /// Create the scene with given index and reset the recorded frames.
+    void StartScene(unsigned index)
+    {
+        const BenchmarkScene& desc = scenes_[index];
+        URHO3D_LOGINFO("Running benchmark scene {}", desc.name_);
+
+        sceneIndex_ = index;
+        frame_ = 0;
+        gpuTimes_.clear();
+        gpuBlockTimes_.clear();
+        path_.clear();
+
+        scene_ = MakeShared<Scene>(context_);
+        (this->*desc.builder_)(scene_, path_);
+        if (path_.empty())
+            path_.push_back({ Vector3::BACK * 10.0f, Vector3::ZERO });
+
+        // Camera is created last because loading replaces the scene content
+        cameraNode_ = scene_->CreateChild("BenchmarkCamera");
+        auto* camera = cameraNode_->CreateComponent<Camera>();
+        camera->SetFarClip(500.0f);
+
+        auto* renderer = GetSubsystem<Renderer>();
+        renderer->SetHDRRendering(desc.hdr_);
+        renderer->SetViewport(0, MakeShared<Viewport>(context_, scene_, camera));
+        UpdateCamera();
+    }
+
+    /// Place the camera on the path according to the current frame.
+    void UpdateCamera()
+    {
+        if (!cameraNode_)
+            return;
+
+        const unsigned measuredFrame = frame_ > numWarmupFrames_ ? frame_ - numWarmupFrames_ : 0;
+        const float t = Min(static_cast<float>(measuredFrame) / numFrames_, 1.0f) * (path_.size() - 1);
+        const unsigned first = Min(FloorToInt(t), static_cast<int>(path_.size()) - 1);
+        const unsigned second = Min(first + 1, path_.size() - 1);
+        const float factor = t - first;
+
+        const Vector3 position = path_[first].position_.Lerp(path_[second].position_, factor);
+        const Vector3 target = path_[first].target_.Lerp(path_[second].target_, factor);
+        cameraNode_->SetWorldPosition(position);
+        cameraNode_->LookAt(target);
+    }
+
+    /// Advance the benchmark at the end of a frame.
+    void EndFrame()
+    {
+        ++frame_;
+        // Applies to the next frame, the engine computes the measured time step before the end of frame event
+        engine_->SetNextTimeStep(timeStep_);
+
+        auto* profiler = GetSubsystem<Renderer>()->GetGPUProfiler();
+        if (frame_ == numWarmupFrames_)
+        {
+            GetSubsystem<FrameStatistics>()->Clear();
+            gpuTimes_.clear();
+            gpuBlockTimes_.clear();
+        }
+        else if (frame_ > numWarmupFrames_ && profiler && profiler->GetNumResolvedFrames() != lastResolvedFrame_)
+        {
+            gpuTimes_.push_back(profiler->GetFrameTime());
+            for (const GPUProfilerBlock& block : profiler->GetBlocks())
+                gpuBlockTimes_[block.name_].push_back(block.time_);
+        }
+        if (profiler)
+            lastResolvedFrame_ = profiler->GetNumResolvedFrames();
+
+        if (frame_ < numWarmupFrames_ + numFrames_)
+            return;
+
+        FinishScene();
+        if (sceneIndex_ + 1 < scenes_.size())
+            StartScene(sceneIndex_ + 1);
+        else
+            FinishBenchmark();
+    }
+
+    /// Store the results of the current scene.
+    void FinishScene()
+    {
+        auto* statistics = GetSubsystem<FrameStatistics>();
+        URHO3D_LOGINFO("{}", statistics->PrintSummary());
+
+        JSONValue sceneResults;
+        sceneResults.Set("Frame", PercentilesToJSON(statistics->GetFrameTimePercentiles()));
+        for (unsigned i = 0; i < MAX_FRAME_STAGES; ++i)
+        {
+            const auto stage = static_cast<FrameStage>(i);
+            sceneResults.Set(FrameStatistics::GetStageName(stage), PercentilesToJSON(statistics->GetStageTimePercentiles(stage)));
+        }
+        if (!gpuTimes_.empty())
+            sceneResults.Set("GPU", PercentilesToJSON(GetPercentiles(gpuTimes_)));
+
+        JSONValue gpuBlocks(JSON_OBJECT);
+        for (auto& [name, times] : gpuBlockTimes_)
+            gpuBlocks.Set(name, PercentilesToJSON(GetPercentiles(times)));
+        sceneResults.Set("GPUBlocks", gpuBlocks);
+
+        // Counters are averaged, they are expected to be stable for a fixed camera path
+        JSONValue counters(JSON_OBJECT);
+        const unsigned numSamples = statistics->GetNumSamples();
+        for (unsigned i = 0; i < MAX_FRAME_COUNTERS; ++i)
+        {
+            double sum = 0.0;
+            for (unsigned j = 0; j < numSamples; ++j)
+                sum += statistics->GetSample(j).counters_[i];
+            counters.Set(FrameStatistics::GetCounterName(static_cast<FrameCounter>(i)), numSamples ? sum / numSamples : 0.0);
+        }
+        sceneResults.Set("Counters", counters);
+
+        results_["scenes"].Set(scenes_[sceneIndex_].name_, sceneResults);
+
+        scene_ = nullptr;
+        cameraNode_ = nullptr;
+    }
+
+    /// Save the results, compare them against the baseline and exit.
+    void FinishBenchmark()
+    {
+        if (!outputFile_.empty())
+        {
+            JSONFile outputFile(context_);
+            outputFile.GetRoot() = results_;
+            if (outputFile.SaveFile(outputFile_))
+                URHO3D_LOGINFO("Benchmark results saved to {}", outputFile_);
+            else
+                URHO3D_LOGERROR("Failed to save benchmark results to {}", outputFile_);
+        }
+
+        if (!baselineFile_.empty())
+        {
+            JSONFile baseline(context_);
+            if (!baseline.LoadFile(baselineFile_))
+                ErrorExit(Format("Failed to load benchmark baseline {}", baselineFile_));
+            else if (CompareToBaseline(baseline.GetRoot()) > 0)
+                ErrorExit("Benchmark regressed against the baseline");
+        }
+
+        engine_->Exit();
+    }
+
+    /// Compare median times of every scene and timing against the baseline. Return number of regressions.
+    unsigned CompareToBaseline(const JSONValue& baseline)
+    {
+        unsigned numRegressions = 0;
+        const JSONValue& baselineScenes = baseline["scenes"];
+        for (const auto& [sceneName, sceneResults] : results_["scenes"].GetObject())
+        {
+            if (!baselineScenes.Contains(sceneName))
+            {
+                URHO3D_LOGWARNING("Benchmark scene {} is missing in the baseline", sceneName);
+                continue;
+            }
+
+            const JSONValue& baselineScene = baselineScenes[sceneName];
+            for (const auto& [timingName, timing] : sceneResults.GetObject())
+            {
+                if (!timing.Contains("p50") || !baselineScene.Contains(timingName))
+                    continue;
+                const JSONValue& baselineTiming = baselineScene[timingName];
+                if (!baselineTiming.Contains("p50"))
+                    continue;
+
+                const float current = timing["p50"].GetFloat();
+                const float previous = baselineTiming["p50"].GetFloat();
+                if (current > previous * (1.0f + tolerance_) && current - previous > minDelta_)
+                {
+                    URHO3D_LOGERROR("{} {}: median {:.3f} ms, baseline {:.3f} ms", sceneName, timingName, current, previous);
+                    ++numRegressions;
+                }
+            }
+        }
+
+        if (numRegressions == 0)
+            URHO3D_LOGINFO("No regressions against the baseline");
+        return numRegressions;
+    }
+
+    /// Comma-separated names of the scenes to run.
+    ea::string sceneNames_;
+    /// Number of measured frames per scene.
+    unsigned numFrames_{600};
+    /// Number of frames per scene before measuring.
+    unsigned numWarmupFrames_{60};
+    /// Fixed time step in seconds.
+    float timeStep_{1.0f / 60.0f};
+    /// Output file name.
+    ea::string outputFile_{"Benchmark.json"};
+    /// Baseline file name.
+    ea::string baselineFile_;
+    /// Relative tolerance of regressions.
+    float tolerance_{0.1f};
+    /// Absolute tolerance of regressions in milliseconds.
+    float minDelta_{0.05f};
+
+    /// Scenes to run.
+    ea::vector<BenchmarkScene> scenes_;
+    /// Index of the current scene.
+    unsigned sceneIndex_{};
+    /// Frame number within the current scene.
+    unsigned frame_{};
+    /// Current scene.
+    SharedPtr<Scene> scene_;
+    /// Camera node of the current scene.
+    WeakPtr<Node> cameraNode_;
+    /// Camera path of the current scene.
+    ea::vector<CameraKeyframe> path_;
+    /// GPU frame times of the current scene.
+    ea::vector<float> gpuTimes_;
+    /// GPU block times of the current scene.
+    ea::unordered_map<ea::string, ea::vector<float>> gpuBlockTimes_;
+    /// Number of GPU profiler frames resolved at the previous frame.
+    unsigned lastResolvedFrame_{};
+    /// Results of all finished scenes.
+    JSONValue results_{JSON_OBJECT};
+};
+
+URHO3D_DEFINE_APPLICATION_MAIN(BenchmarkApplication);
@@ -37,6 +37,7 @@ URHO3D_EVENT(E_EDITORRESOURCESAVED, EditorResourceSaved)
 /// Event sent right before reloading user components.
 URHO3D_EVENT(E_EDITORUSERCODERELOADSTART, EditorUserCodeReloadStart)
 {
+    URHO3D_PARAM(P_TYPES, Types);                       // VariantVector of StringHash, types provided by plugins that are about to be unloaded
 }
 
 /// Event sent right after reloading user components.
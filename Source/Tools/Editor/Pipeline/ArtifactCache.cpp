@@ -0,0 +1,295 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include <Urho3D/Core/Thread.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/IO/File.h>
+#include <Urho3D/IO/FileSystem.h>
+#include <Urho3D/IO/Log.h>
+#include <Urho3D/IO/MemoryBuffer.h>
+#include <Urho3D/IO/VectorBuffer.h>
+#if URHO3D_NETWORK
+#include <Urho3D/Network/HttpRequest.h>
+#endif
+
+#include "Project.h"
+#include "Pipeline/ArtifactCache.h"
+#include "Pipeline/Asset.h"
+#include "Pipeline/Flavor.h"
+#include "Pipeline/Importers/AssetImporter.h"
+
+namespace Urho3D
+{
+
+/// Artifact file identifier.
+static const char* ARTIFACT_FILE_ID = "UART";
+/// Maximum time to wait for remote cache to respond.
+static const unsigned REMOTE_TIMEOUT_MS = 10000;
+
+/// Hash data with 64-bit FNV-1a.
+static unsigned long long HashData(const void* data, unsigned size, unsigned long long hash = 14695981039346656037ull)
+{
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (unsigned i = 0; i < size; ++i)
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    return hash;
+}
+
+/// Hash string with 64-bit FNV-1a, including terminator so that adjacent strings do not alias.
+static unsigned long long HashString(const ea::string& value, unsigned long long hash)
+{
+    return HashData(value.c_str(), value.length() + 1, hash);
+}
+
+ArtifactCache::ArtifactCache(Context* context)
+    : Object(context)
+{
+}
+
+void ArtifactCache::SetLocalPath(const ea::string& path)
+{
+    localPath_ = path.empty() ? EMPTY_STRING : AddTrailingSlash(path);
+}
+
+void ArtifactCache::SetRemoteUrl(const ea::string& url)
+{
+    remoteUrl_ = url.empty() || url.ends_with("/") ? url : url + "/";
+}
+
+unsigned long long ArtifactCache::GetKey(const AssetImporter* importer) const
+{
+    Asset* asset = importer->asset_;
+    Flavor* flavor = importer->flavor_;
+    if (asset == nullptr || flavor == nullptr)
+        return 0;
+
+    File file(context_);
+    if (!file.Open(asset->GetResourcePath()))
+        return 0;
+
+    unsigned long long hash = 14695981039346656037ull;
+    unsigned char buffer[16384];
+    while (!file.IsEof())
+    {
+        const unsigned size = file.Read(buffer, sizeof(buffer));
+        if (size == 0)
+            break;
+        hash = HashData(buffer, size, hash);
+    }
+
+    // Resource name is a part of the key because byproduct names are derived from it.
+    hash = HashString(asset->GetName(), hash);
+    hash = HashString(importer->GetTypeName(), hash);
+    hash = HashString(flavor->GetName(), hash);
+
+    const unsigned settingsHash = importer->HashEffectiveAttributeValues();
+    const unsigned version = importer->GetVersion();
+    hash = HashData(&settingsHash, sizeof(settingsHash), hash);
+    hash = HashData(&version, sizeof(version), hash);
+
+    // Zero is reserved for invalid key.
+    return hash != 0 ? hash : 1;
+}
+
+bool ArtifactCache::Restore(AssetImporter* importer, unsigned long long key)
+{
+    if (key == 0 || !IsEnabled())
+        return false;
+
+    ea::vector<ArtifactFile> files;
+    bool found = false;
+    if (!localPath_.empty())
+    {
+        File file(context_);
+        if (file.Open(localPath_ + GetArtifactName(key)) && ReadArtifact(file, files))
+        {
+            found = true;
+            ++numLocalHits_;
+        }
+    }
+
+    if (!found && FetchRemote(key, files))
+    {
+        found = true;
+        ++numRemoteHits_;
+        // Keep a local copy so that remote cache is not queried again.
+        if (!localPath_.empty())
+            WriteArtifact(key, files);
+    }
+
+    if (!found)
+    {
+        ++numMisses_;
+        return false;
+    }
+
+    auto* fs = context_->GetFileSystem();
+    auto* project = GetSubsystem<Project>();
+
+    importer->ClearByproducts();
+    for (const ArtifactFile& artifactFile : files)
+    {
+        const ea::string path = project->GetCachePath() + artifactFile.name_;
+        fs->CreateDirsRecursive(GetPath(path));
+
+        File file(context_);
+        if (!file.Open(path, FILE_WRITE) || file.Write(artifactFile.data_.data(), artifactFile.data_.size()) != artifactFile.data_.size())
+        {
+            URHO3D_LOGERROR("Failed to restore cached artifact '{}'.", path);
+            importer->ClearByproducts();
+            return false;
+        }
+        importer->byproducts_.push_back(artifactFile.name_);
+    }
+    importer->lastAttributeHash_ = importer->HashEffectiveAttributeValues();
+    return true;
+}
+
+bool ArtifactCache::Store(const AssetImporter* importer, unsigned long long key)
+{
+    if (key == 0 || localPath_.empty())
+        return false;
+
+    auto* project = GetSubsystem<Project>();
+
+    ea::vector<ArtifactFile> files;
+    for (const ea::string& byproduct : importer->GetByproducts())
+    {
+        File file(context_);
+        if (!file.Open(project->GetCachePath() + byproduct))
+            return false;
+
+        ArtifactFile& artifactFile = files.push_back();
+        artifactFile.name_ = byproduct;
+        artifactFile.data_.resize(file.GetSize());
+        if (file.Read(artifactFile.data_.data(), artifactFile.data_.size()) != artifactFile.data_.size())
+            return false;
+    }
+
+    return WriteArtifact(key, files);
+}
+
+ea::string ArtifactCache::GetArtifactName(unsigned long long key)
+{
+    const ea::string name = Format("{:016x}", key);
+    // Split artifacts into subdirectories to keep directory sizes reasonable.
+    return Format("{}/{}.artifact", name.substr(0, 2), name);
+}
+
+bool ArtifactCache::ReadArtifact(Deserializer& source, ea::vector<ArtifactFile>& files)
+{
+    if (source.ReadFileID() != ARTIFACT_FILE_ID)
+        return false;
+
+    const unsigned numFiles = source.ReadVLE();
+    files.resize(numFiles);
+    for (ArtifactFile& file : files)
+    {
+        file.name_ = source.ReadString();
+        file.data_ = source.ReadBuffer();
+        // Names are relative to the cache directory, do not let corrupted artifact write outside of it.
+        if (file.name_.empty() || IsAbsolutePath(file.name_) || file.name_.contains(".."))
+            return false;
+    }
+    return true;
+}
+
+bool ArtifactCache::WriteArtifact(unsigned long long key, const ea::vector<ArtifactFile>& files)
+{
+    auto* fs = context_->GetFileSystem();
+
+    const ea::string path = localPath_ + GetArtifactName(key);
+    if (fs->FileExists(path))
+        return true;
+
+    if (!fs->CreateDirsRecursive(GetPath(path)))
+        return false;
+
+    // Write to a temporary file first, other workers or editor instances may be reading the cache at the same time.
+    const ea::string tempPath = Format("{}.{}.tmp", path, tempCounter_++);
+    {
+        File file(context_);
+        if (!file.Open(tempPath, FILE_WRITE))
+            return false;
+
+        bool written = file.WriteFileID(ARTIFACT_FILE_ID) && file.WriteVLE(files.size());
+        for (const ArtifactFile& artifactFile : files)
+            written = written && file.WriteString(artifactFile.name_) && file.WriteBuffer(artifactFile.data_);
+
+        if (!written)
+        {
+            file.Close();
+            fs->Delete(tempPath);
+            return false;
+        }
+    }
+
+    if (!fs->Rename(tempPath, path))
+    {
+        // Another writer won the race, artifact contents are identical.
+        fs->Delete(tempPath);
+        return fs->FileExists(path);
+    }
+    return true;
+}
+
+bool ArtifactCache::FetchRemote(unsigned long long key, ea::vector<ArtifactFile>& files) const
+{
+#if URHO3D_NETWORK
+    if (remoteUrl_.empty())
+        return false;
+
+    SharedPtr<HttpRequest> request(new HttpRequest(remoteUrl_ + GetArtifactName(key), "GET", {}, EMPTY_STRING));
+
+    Timer timer;
+    while (request->GetState() == HTTP_INITIALIZING && timer.GetMSec(false) < REMOTE_TIMEOUT_MS)
+        Time::Sleep(1);
+
+    if (!request->IsOpen())
+        return false;
+
+    VectorBuffer buffer;
+    unsigned char chunk[16384];
+    while (!request->IsEof() && timer.GetMSec(false) < REMOTE_TIMEOUT_MS)
+    {
+        // Read only what is available, reading more would block until timeout can not be checked.
+        const unsigned available = Min<unsigned>(request->GetAvailableSize(), sizeof(chunk));
+        if (available == 0)
+        {
+            Time::Sleep(1);
+            continue;
+        }
+        buffer.Write(chunk, request->Read(chunk, available));
+    }
+
+    if (!request->IsEof())
+        return false;
+
+    MemoryBuffer source(buffer.GetBuffer());
+    return ReadArtifact(source, files);
+#else
+    return false;
+#endif
+}
+
+}
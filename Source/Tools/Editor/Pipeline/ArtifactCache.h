@@ -0,0 +1,102 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include <atomic>
+
+#include <Urho3D/Container/ByteVector.h>
+#include <Urho3D/Core/Object.h>
+
+namespace Urho3D
+{
+
+class AssetImporter;
+
+/// Content-addressed storage of importer byproducts. Artifacts are keyed by a hash of source file contents, importer
+/// settings, flavor and importer version, so they may be shared between machines. Artifacts are looked up in a local
+/// directory first and in an optional remote HTTP cache second. Remote cache is read-only, it is expected to serve a
+/// copy of local cache directory populated by a build machine.
+class ArtifactCache : public Object
+{
+    URHO3D_OBJECT(ArtifactCache, Object);
+public:
+    /// Construct.
+    explicit ArtifactCache(Context* context);
+    /// Set local cache directory. Empty path disables local cache.
+    void SetLocalPath(const ea::string& path);
+    /// Returns local cache directory.
+    const ea::string& GetLocalPath() const { return localPath_; }
+    /// Set URL of remote cache. Empty URL disables remote cache.
+    void SetRemoteUrl(const ea::string& url);
+    /// Returns URL of remote cache.
+    const ea::string& GetRemoteUrl() const { return remoteUrl_; }
+    /// Returns true when local or remote cache is configured.
+    bool IsEnabled() const { return !localPath_.empty() || !remoteUrl_.empty(); }
+    /// Returns artifact key of importer for it's current asset, settings and flavor. Returns 0 if source file can not be read. May be called from non-main thread.
+    unsigned long long GetKey(const AssetImporter* importer) const;
+    /// Restore byproducts of importer from the cache. Returns true on cache hit. May be called from non-main thread.
+    bool Restore(AssetImporter* importer, unsigned long long key);
+    /// Store byproducts of importer in local cache. May be called from non-main thread.
+    bool Store(const AssetImporter* importer, unsigned long long key);
+    /// Returns number of artifacts restored from local cache.
+    unsigned GetNumLocalHits() const { return numLocalHits_; }
+    /// Returns number of artifacts restored from remote cache.
+    unsigned GetNumRemoteHits() const { return numRemoteHits_; }
+    /// Returns number of artifacts that were not found in the cache.
+    unsigned GetNumMisses() const { return numMisses_; }
+
+protected:
+    /// A single cached file.
+    struct ArtifactFile
+    {
+        /// Resource name relative to project cache directory.
+        ea::string name_;
+        /// File contents.
+        ByteVector data_;
+    };
+
+    /// Returns path of artifact relative to cache root.
+    static ea::string GetArtifactName(unsigned long long key);
+    /// Read artifact files from a stream. Returns false if stream does not contain a valid artifact.
+    static bool ReadArtifact(Deserializer& source, ea::vector<ArtifactFile>& files);
+    /// Write artifact files to local cache.
+    bool WriteArtifact(unsigned long long key, const ea::vector<ArtifactFile>& files);
+    /// Download artifact from remote cache.
+    bool FetchRemote(unsigned long long key, ea::vector<ArtifactFile>& files) const;
+
+    /// Local cache directory.
+    ea::string localPath_;
+    /// Remote cache URL.
+    ea::string remoteUrl_;
+    /// Number of artifacts restored from local cache.
+    std::atomic<unsigned> numLocalHits_{0};
+    /// Number of artifacts restored from remote cache.
+    std::atomic<unsigned> numRemoteHits_{0};
+    /// Number of artifacts that were not found in the cache.
+    std::atomic<unsigned> numMisses_{0};
+    /// Counter used for naming temporary files.
+    std::atomic<unsigned> tempCounter_{0};
+};
+
+}
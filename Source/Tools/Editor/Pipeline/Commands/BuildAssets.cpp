@@ -21,6 +21,7 @@
 //
 
 #include <Urho3D/Engine/EngineDefs.h>
+#include <Urho3D/IO/Log.h>
 #include "Project.h"
 #include "Editor.h"
 #include "Pipeline/Commands/BuildAssets.h"
@@ -45,6 +46,8 @@ void BuildAssets::RegisterCommandLine(CLI::App& cli)
         GetSubsystem<Editor>()->GetEngineParameters()[EP_HEADLESS] = true;
     });
     cli.add_flag("--full", full_, "Disable out-of-date checks and rebuild cache completely.");
+    cli.add_option("--artifact-cache-url", artifactCacheUrl_, "URL of remote artifact cache to fetch imported assets from.");
+    cli.add_option("-j,--jobs", maxConcurrentImports_, "Number of assets imported concurrently. Defaults to number of worker threads.");
     cli.add_option("flavor", flavor_, "Flavor to build.");
 }
 
@@ -62,8 +65,19 @@ void BuildAssets::Execute()
         flags |= PipelineBuildFlag::SKIP_UP_TO_DATE;
 
     auto* pipeline = GetSubsystem<Pipeline>();
+    ArtifactCache* artifactCache = pipeline->GetArtifactCache();
+    if (!artifactCacheUrl_.empty())
+        artifactCache->SetRemoteUrl(artifactCacheUrl_);
+    pipeline->SetMaxConcurrentImports(maxConcurrentImports_);
+
     pipeline->BuildCache(pipeline->GetFlavor(flavor_), flags);
     pipeline->WaitForCompletion();
+
+    if (artifactCache->IsEnabled())
+    {
+        URHO3D_LOGINFO("Artifact cache: {} local hits, {} remote hits, {} misses.", artifactCache->GetNumLocalHits(),
+            artifactCache->GetNumRemoteHits(), artifactCache->GetNumMisses());
+    }
 }
 
 }
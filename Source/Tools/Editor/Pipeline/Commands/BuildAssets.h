@@ -47,6 +47,10 @@ protected:
     int full_ = 0;
     ///
     ea::string flavor_{Flavor::DEFAULT};
+    /// Overrides URL of remote artifact cache when not empty.
+    ea::string artifactCacheUrl_{};
+    /// Number of imports that may run concurrently. 0 means number of worker threads.
+    unsigned maxConcurrentImports_ = 0;
 };
 
 }
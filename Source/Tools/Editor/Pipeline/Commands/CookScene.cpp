@@ -21,11 +21,17 @@
 //
 
 #include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/Core/WorkQueue.h>
 #include <Urho3D/Engine/EngineDefs.h>
 #include <Urho3D/IO/FileSystem.h>
 #include <Urho3D/IO/Log.h>
+#include <Urho3D/IO/VectorBuffer.h>
 #include <Toolbox/IO/ContentUtilities.h>
+#include <Urho3D/Resource/ResourceCache.h>
+#include <Urho3D/Resource/XMLFile.h>
 #include <Urho3D/Scene/Scene.h>
+#include <Urho3D/Scene/SceneChunkIndex.h>
 #include <Urho3D/IO/File.h>
 #include "Tabs/Scene/EditorSceneSettings.h"
 #include "Editor.h"
@@ -36,6 +42,86 @@
 namespace Urho3D
 {
 
+namespace
+{
+
+/// State of one scene being cooked.
+struct CookedScene
+{
+    /// Source XML file.
+    SharedPtr<XMLFile> xml_;
+    /// Scene loaded from XML.
+    SharedPtr<Scene> scene_;
+    /// Error message, empty on success.
+    ea::string error_;
+    /// Number of nodes in the scene.
+    unsigned numNodes_ = 0;
+    /// Number of components in the scene.
+    unsigned numComponents_ = 0;
+    /// Number of chunks written, zero for plain binary scene.
+    unsigned numChunks_ = 0;
+    /// Total size of written files.
+    unsigned outputSize_ = 0;
+    /// Time spent parsing and instantiating the scene.
+    long long loadTime_ = 0;
+    /// Time spent serializing and writing the scene.
+    long long saveTime_ = 0;
+};
+
+/// Queue background loading of resources referenced by the scene XML, so that they are loaded on background loader
+/// threads while scenes are being instantiated. Resources are shared between all scenes through the resource cache.
+void QueueSceneResources(Context* context, const XMLElement& element)
+{
+    auto* cache = context->GetCache();
+    for (XMLElement compElem = element.GetChild("component"); compElem; compElem = compElem.GetNext("component"))
+    {
+        const ea::vector<AttributeInfo>* attributes = context->GetAttributes(StringHash(compElem.GetAttribute("type")));
+        if (attributes == nullptr)
+            continue;
+
+        for (XMLElement attrElem = compElem.GetChild("attribute"); attrElem; attrElem = attrElem.GetNext("attribute"))
+        {
+            const ea::string name = attrElem.GetAttribute("name");
+            for (const AttributeInfo& attr : *attributes)
+            {
+                if (!(attr.mode_ & AM_FILE) || attr.name_ != name)
+                    continue;
+
+                if (attr.type_ == VAR_RESOURCEREF)
+                {
+                    const ResourceRef ref = attrElem.GetVariantValue(attr.type_).GetResourceRef();
+                    if (!ref.name_.empty())
+                        cache->BackgroundLoadResource(ref.type_, cache->SanitateResourceName(ref.name_), false);
+                }
+                else if (attr.type_ == VAR_RESOURCEREFLIST)
+                {
+                    const ResourceRefList refList = attrElem.GetVariantValue(attr.type_).GetResourceRefList();
+                    for (const ea::string& refName : refList.names_)
+                    {
+                        if (!refName.empty())
+                            cache->BackgroundLoadResource(refList.type_, cache->SanitateResourceName(refName), false);
+                    }
+                }
+                break;
+            }
+        }
+    }
+
+    for (XMLElement childElem = element.GetChild("node"); childElem; childElem = childElem.GetNext("node"))
+        QueueSceneResources(context, childElem);
+}
+
+/// Write buffer to a file and return true if successful.
+bool WriteFile(Context* context, const ea::string& fileName, const VectorBuffer& buffer)
+{
+    File file(context);
+    if (!file.Open(fileName, FILE_WRITE))
+        return false;
+    return file.Write(buffer.GetData(), buffer.GetSize()) == buffer.GetSize();
+}
+
+}
+
 CookScene::CookScene(Context* context)
     : SubCommand(context)
 {
@@ -48,8 +134,21 @@ void CookScene::RegisterObject(Context* context)
 
 void CookScene::RegisterCommandLine(CLI::App& cli)
 {
-    cli.add_option("--input", input_, "XML scene file.")->required();
-    cli.add_option("--output", output_, "Resulting binary scene file.");
+    auto addFileList = [&cli](const char* name, StringVector& files, const char* description) {
+        CLI::callback_t fun = [&files](CLI::results_t results) {
+            files.clear();
+            for (const std::string& result : results)
+                files.push_back(result.c_str());
+            return !files.empty();
+        };
+        CLI::Option* option = cli.add_option(name, fun, description);
+        option->set_custom_option("TEXT", -1);
+        return option;
+    };
+    addFileList("--input", inputs_, "XML scene files.")->required();
+    addFileList("--output", outputs_, "Resulting binary scene files, one per input.");
+    cli.add_option("--chunk-size", chunkSize_, "Size of cubic grid cell. When set, each scene is cooked into a chunk index "
+        "and a binary prefab per cell, stored in '<output>_Chunks' directory.");
     cli.set_callback([this]() {
         GetSubsystem<Editor>()->GetEngineParameters()[EP_HEADLESS] = true;
     });
@@ -60,6 +159,7 @@ void CookScene::Execute()
     auto* project = GetSubsystem<Project>();
     auto* editor = GetSubsystem<Editor>();
     auto* fs = context_->GetFileSystem();
+    auto* workQueue = context_->GetWorkQueue();
 
     if (project == nullptr)
     {
@@ -67,37 +167,159 @@ void CookScene::Execute()
         return;
     }
 
-    Scene scene(context_);
-    File file(context_);
-    if (file.Open(input_, FILE_READ))
+    if (inputs_.size() != outputs_.size())
+    {
+        editor->ErrorExit(Format("CookScene got {} input scenes but {} output files.", inputs_.size(), outputs_.size()));
+        return;
+    }
+
+    const ea::string& cachePath = project->GetCachePath();
+    for (const ea::string& output : outputs_)
+    {
+        fs->CreateDirsRecursive(GetPath(output));
+        if (chunkSize_ > 0.0f)
+        {
+            if (!output.starts_with(cachePath))
+            {
+                editor->ErrorExit(Format("Chunked scene '{}' must be cooked into the cache directory.", output));
+                return;
+            }
+            fs->CreateDirsRecursive(output + "_Chunks");
+        }
+    }
+
+    // Read and parse XML files in parallel. This does not touch any engine state and scenes are fully independent.
+    HiresTimer totalTimer;
+    ea::vector<CookedScene> scenes(inputs_.size());
+    for (CookedScene& cooked : scenes)
+        cooked.xml_ = MakeShared<XMLFile>(context_);
+
+    workQueue->ParallelFor(scenes.size(), 1, [&](unsigned begin, unsigned end, unsigned)
+    {
+        for (unsigned i = begin; i < end; ++i)
+        {
+            HiresTimer timer;
+            File file(context_);
+            if (!file.Open(inputs_[i], FILE_READ))
+                scenes[i].error_ = Format("Could not open '{}' for reading.", inputs_[i]);
+            else if (!scenes[i].xml_->Load(file))
+                scenes[i].error_ = Format("Could not parse scene '{}'.", inputs_[i]);
+            scenes[i].loadTime_ += timer.GetUSec(false);
+        }
+    });
+    workQueue->Complete(M_MAX_UNSIGNED);
+
+    // Start loading resources of all scenes at once. Each resource is requested only once and scene instantiation
+    // below picks it up from the cache or waits for the background loader to finish it.
+    for (CookedScene& cooked : scenes)
+    {
+        if (cooked.error_.empty())
+            QueueSceneResources(context_, cooked.xml_->GetRoot());
+    }
+
+    // Scene instantiation sends events and requests resources, therefore it stays on the main thread. Every scene gets
+    // its own Scene instance.
+    for (unsigned i = 0; i < scenes.size(); ++i)
+    {
+        CookedScene& cooked = scenes[i];
+        if (!cooked.error_.empty())
+            continue;
+
+        HiresTimer timer;
+        cooked.scene_ = MakeShared<Scene>(context_);
+        if (!cooked.scene_->LoadXML(cooked.xml_->GetRoot()))
+        {
+            cooked.error_ = Format("Could not open load scene '{}'.", inputs_[i]);
+            continue;
+        }
+
+        // Remove components that should not be shipped in the final product
+        if (auto* component = cooked.scene_->GetComponent<EditorSceneSettings>())
+            component->Remove();
+
+        ea::vector<Node*> nodes;
+        cooked.scene_->GetChildren(nodes, true);
+        cooked.numNodes_ = nodes.size() + 1;
+        cooked.numComponents_ = cooked.scene_->GetNumComponents();
+        for (Node* node : nodes)
+            cooked.numComponents_ += node->GetNumComponents();
+
+        cooked.xml_.Reset();
+        cooked.loadTime_ += timer.GetUSec(false);
+    }
+
+    // Serializing scenes only reads them, so independent scenes are saved in parallel.
+    workQueue->ParallelFor(scenes.size(), 1, [&](unsigned begin, unsigned end, unsigned)
     {
-        if (scene.LoadXML(file))
+        for (unsigned i = begin; i < end; ++i)
         {
-            // Remove components that should not be shipped in the final product
-            if (auto* component = scene.GetComponent<EditorSceneSettings>())
-                component->Remove();
+            CookedScene& cooked = scenes[i];
+            if (!cooked.error_.empty())
+                continue;
+
+            HiresTimer timer;
+            VectorBuffer buffer;
+            if (chunkSize_ > 0.0f)
+            {
+                const ea::string chunkDirectory = outputs_[i] + "_Chunks";
+                ea::vector<Node*> nodes;
+                for (Node* node : cooked.scene_->GetChildren())
+                    nodes.push_back(node);
 
-            // Cook scene
-            assert(input_.starts_with(project->GetResourcePath()));
-            auto resourceName = input_.substr(project->GetResourcePath().length());
-            fs->CreateDirsRecursive(GetPath(output_));
+                SceneChunkIndex index(context_);
+                if (!index.Build(nodes, Vector3::ONE * chunkSize_, chunkDirectory, chunkDirectory.substr(cachePath.length())) ||
+                    !index.Save(buffer))
+                {
+                    cooked.error_ = Format("Could not convert '{}' to chunked version.", inputs_[i]);
+                    continue;
+                }
+
+                cooked.numChunks_ = index.GetChunks().size();
+                for (const SceneChunkDesc& chunk : index.GetChunks())
+                {
+                    File chunkFile(context_, AddTrailingSlash(chunkDirectory) + GetFileNameAndExtension(chunk.resourceName_));
+                    cooked.outputSize_ += chunkFile.GetSize();
+                }
+            }
+            else if (!cooked.scene_->Save(buffer))
+            {
+                cooked.error_ = Format("Could not convert '{}' to binary version.", inputs_[i]);
+                continue;
+            }
 
-            File output(context_);
-            if (output.Open(output_, FILE_WRITE))
+            if (!WriteFile(context_, outputs_[i], buffer))
             {
-                if (!scene.Save(output))
-                    editor->ErrorExit(Format("Could not convert '{}' to binary version.", input_));
-                else
-                    fs->SetLastModifiedTime(output_, fs->GetLastModifiedTime(input_));
+                cooked.error_ = Format("Could not open '{}' for writing.", outputs_[i]);
+                continue;
             }
-            else
-                editor->ErrorExit(Format("Could not open '{}' for writing.", output_));
+            fs->SetLastModifiedTime(outputs_[i], fs->GetLastModifiedTime(inputs_[i]));
+            cooked.outputSize_ += buffer.GetSize();
+            cooked.saveTime_ = timer.GetUSec(false);
         }
-        else
-            editor->ErrorExit(Format("Could not open load scene '{}'.", input_));
+    });
+    workQueue->Complete(M_MAX_UNSIGNED);
+
+    unsigned numFailed = 0;
+    for (unsigned i = 0; i < scenes.size(); ++i)
+    {
+        const CookedScene& cooked = scenes[i];
+        if (!cooked.error_.empty())
+        {
+            URHO3D_LOGERROR(cooked.error_);
+            ++numFailed;
+            continue;
+        }
+
+        URHO3D_LOGINFO("Cooked '{}': {} nodes, {} components, {} chunks, {} bytes, load {:.1f} ms, save {:.1f} ms.",
+            inputs_[i], cooked.numNodes_, cooked.numComponents_, cooked.numChunks_, cooked.outputSize_,
+            cooked.loadTime_ / 1000.0f, cooked.saveTime_ / 1000.0f);
     }
-    else
-        editor->ErrorExit(Format("Could not open open '{}' for reading.", input_));
+
+    URHO3D_LOGINFO("Cooked {} of {} scenes in {:.1f} ms.", scenes.size() - numFailed, scenes.size(),
+        totalTimer.GetUSec(false) / 1000.0f);
+
+    if (numFailed > 0)
+        editor->ErrorExit(Format("Failed cooking {} of {} scenes.", numFailed, scenes.size()));
 }
 
 }
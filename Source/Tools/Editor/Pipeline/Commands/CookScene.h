@@ -42,10 +42,12 @@ public:
     void Execute() override;
 
 protected:
-    ///
-    ea::string input_;
-    ///
-    ea::string output_;
+    /// XML scene files.
+    StringVector inputs_;
+    /// Resulting binary scene files, one per input.
+    StringVector outputs_;
+    /// Size of grid cell when chunked scene is produced. Plain binary scene is produced when zero.
+    float chunkSize_ = 0.0f;
 };
 
 }
@@ -67,12 +67,18 @@ public:
     void OnGetAttribute(const AttributeInfo& attr, Variant& dest) const override;
     ///
     void OnSetAttribute(const AttributeInfo& attr, const Variant& src) override;
+    /// Attribute access is tracked in OnGetAttribute and OnSetAttribute, so typed access is disabled.
+    bool HasDirectAttributeAccess(const AttributeInfo& attr) const override { return false; }
     /// Returns a list of known byproduct resource names.
     const StringVector& GetByproducts() const { return byproducts_; }
     /// Implements inheritance of default importer settings.
     Variant GetInstanceDefault(const ea::string& name) const override;
     /// Returns flavor this importer belongs to.
     Flavor* GetFlavor() const { return flavor_; }
+    /// Returns version of importer output. Must be incremented when importer starts producing different byproducts from same input, so that cached artifacts are invalidated.
+    virtual unsigned GetVersion() const { return 1; }
+    /// Returns relative cost of running this importer, measured in worker threads it keeps busy. Pipeline limits total weight of concurrently running imports.
+    virtual unsigned GetWeight() const { return 1; }
 
 protected:
     /// Sets needed asset information. Called after creating every importer.
@@ -109,6 +115,7 @@ protected:
     unsigned lastAttributeHash_ = 0;
 
     friend class Asset;
+    friend class ArtifactCache;
 };
 
 }
@@ -40,6 +40,13 @@ static const char* MODEL_IMPORTER_MAX_BONES = "Max number of bones";
 static const char* MODEL_IMPORTER_ANIM_TICK = "Animation tick frequency";
 static const char* MODEL_IMPORTER_EMISSIVE_AO = "Emissive is ambient occlusion";
 static const char* MODEL_IMPORTER_FBX_PIVOT = "Suppress $fbx pivot nodes";
+static const char* MODEL_IMPORTER_LODS = "Generated LOD levels";
+static const char* MODEL_IMPORTER_LOD_RATIO = "LOD triangle ratio";
+static const char* MODEL_IMPORTER_LOD_DISTANCE = "LOD distance step";
+static const char* MODEL_IMPORTER_LOD_ERROR = "LOD max error";
+static const char* MODEL_IMPORTER_LOD_LOCK_BORDERS = "LOD lock borders";
+static const char* MODEL_IMPORTER_QUANTIZE = "Quantize vertices";
+static const char* MODEL_IMPORTER_COMPRESS = "Compress geometry data";
 
 ModelImporter::ModelImporter(Context* context)
     : AssetImporter(context)
@@ -59,6 +66,13 @@ void ModelImporter::RegisterObject(Context* context)
     URHO3D_ATTRIBUTE(MODEL_IMPORTER_ANIM_TICK, int, animationTick_, 4800, AM_DEFAULT);
     URHO3D_ATTRIBUTE(MODEL_IMPORTER_EMISSIVE_AO, bool, emissiveIsAmbientOcclusion_, false, AM_DEFAULT);
     URHO3D_ATTRIBUTE(MODEL_IMPORTER_FBX_PIVOT, bool, noFbxPivot_, false, AM_DEFAULT);
+    URHO3D_ATTRIBUTE(MODEL_IMPORTER_LODS, int, numLods_, 1, AM_DEFAULT);
+    URHO3D_ATTRIBUTE(MODEL_IMPORTER_LOD_RATIO, float, lodTriangleRatio_, 0.5f, AM_DEFAULT);
+    URHO3D_ATTRIBUTE(MODEL_IMPORTER_LOD_DISTANCE, float, lodDistanceStep_, 20.0f, AM_DEFAULT);
+    URHO3D_ATTRIBUTE(MODEL_IMPORTER_LOD_ERROR, float, lodMaxError_, 0.05f, AM_DEFAULT);
+    URHO3D_ATTRIBUTE(MODEL_IMPORTER_LOD_LOCK_BORDERS, bool, lodLockBorders_, true, AM_DEFAULT);
+    URHO3D_ATTRIBUTE(MODEL_IMPORTER_QUANTIZE, bool, quantizeVertices_, false, AM_DEFAULT);
+    URHO3D_ATTRIBUTE(MODEL_IMPORTER_COMPRESS, bool, compressStreams_, false, AM_DEFAULT);
 }
 
 bool ModelImporter::Execute(Urho3D::Asset* input, const ea::string& outputPath)
@@ -111,6 +125,31 @@ bool ModelImporter::Execute(Urho3D::Asset* input, const ea::string& outputPath)
     if (!GetAttribute(MODEL_IMPORTER_FBX_PIVOT).GetBool())
         args.emplace_back("-np");
 
+    const int numLods = GetAttribute(MODEL_IMPORTER_LODS).GetInt();
+    if (numLods > 1)
+    {
+        args.emplace_back("-lods");
+        args.emplace_back(ea::to_string(numLods));
+
+        args.emplace_back("-lr");
+        args.emplace_back(ea::to_string(GetAttribute(MODEL_IMPORTER_LOD_RATIO).GetFloat()));
+
+        args.emplace_back("-ld");
+        args.emplace_back(ea::to_string(GetAttribute(MODEL_IMPORTER_LOD_DISTANCE).GetFloat()));
+
+        args.emplace_back("-le");
+        args.emplace_back(ea::to_string(GetAttribute(MODEL_IMPORTER_LOD_ERROR).GetFloat()));
+
+        if (!GetAttribute(MODEL_IMPORTER_LOD_LOCK_BORDERS).GetBool())
+            args.emplace_back("-lb");
+    }
+
+    if (GetAttribute(MODEL_IMPORTER_QUANTIZE).GetBool())
+        args.emplace_back("-q");
+
+    if (GetAttribute(MODEL_IMPORTER_COMPRESS).GetBool())
+        args.emplace_back("-cs");
+
     int result = fs->SystemRun(fs->GetProgramDir() + "AssetImporter", args);
 
     if (result != 0)
@@ -38,6 +38,8 @@ public:
     bool Accepts(const ea::string& path) const override;
     ///
     bool Execute(Urho3D::Asset* input, const ea::string& outputPath) override;
+    /// AssetImporter process loads whole scene with all of it's meshes and textures into memory.
+    unsigned GetWeight() const override { return 2; }
 
 protected:
     ///
@@ -58,6 +60,20 @@ protected:
     bool emissiveIsAmbientOcclusion_ = false;
     ///
     bool noFbxPivot_ = false;
+    ///
+    int numLods_ = 1;
+    ///
+    float lodTriangleRatio_ = 0.5f;
+    ///
+    float lodDistanceStep_ = 20.0f;
+    ///
+    float lodMaxError_ = 0.05f;
+    ///
+    bool lodLockBorders_ = true;
+    ///
+    bool quantizeVertices_ = false;
+    ///
+    bool compressStreams_ = false;
 };
 
 }
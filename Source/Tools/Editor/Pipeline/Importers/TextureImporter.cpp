@@ -20,8 +20,13 @@
 // THE SOFTWARE.
 //
 
+#include <Urho3D/IO/File.h>
 #include <Urho3D/IO/FileSystem.h>
 #include <Urho3D/IO/Log.h>
+#include <Urho3D/Resource/Image.h>
+
+#include <crnlib.h>
+
 #include "Pipeline/Asset.h"
 #include "Pipeline/Importers/TextureImporter.h"
 
@@ -141,6 +146,140 @@ bool TextureImporter::Execute(Urho3D::Asset* input, const ea::string& outputPath
     else
         context_->GetFileSystem()->CreateDirsRecursive(outputDirectory);
 
+    bool succeeded = false;
+    if (!CompressInProcess(input, outputFile, succeeded))
+        succeeded = CompressWithCrunch(input, outputFile);
+
+    if (!succeeded)
+        return false;
+
+    AddByproduct(outputFile);
+    return true;
+}
+
+bool TextureImporter::CompressInProcess(Asset* input, const ea::string& outputFile, bool& succeeded)
+{
+    const auto pixelFormat = static_cast<PixelFormat>(GetAttribute("Pixel Format").GetInt());
+    const auto compressor = static_cast<Compressor>(GetAttribute("Compressor").GetInt());
+
+    crn_comp_params compParams;
+    switch (pixelFormat)
+    {
+    case PixelFormat::DXT1: compParams.m_format = cCRNFmtDXT1; break;
+    case PixelFormat::DXT1A:
+        compParams.m_format = cCRNFmtDXT1;
+        compParams.set_flag(cCRNCompFlagDXT1AForTransparency, true);
+        break;
+    case PixelFormat::DXT3: compParams.m_format = cCRNFmtDXT3; break;
+    case PixelFormat::DXT5: compParams.m_format = cCRNFmtDXT5; break;
+    case PixelFormat::_3DC: compParams.m_format = cCRNFmtDXN_YX; break;
+    case PixelFormat::DXN: compParams.m_format = cCRNFmtDXN_XY; break;
+    case PixelFormat::DXT5A: compParams.m_format = cCRNFmtDXT5A; break;
+    case PixelFormat::DXT5_CCxY: compParams.m_format = cCRNFmtDXT5_CCxY; break;
+    case PixelFormat::DXT5_xGxR: compParams.m_format = cCRNFmtDXT5_xGxR; break;
+    case PixelFormat::DXT5_xGBR: compParams.m_format = cCRNFmtDXT5_xGBR; break;
+    case PixelFormat::DXT5_AGBR: compParams.m_format = cCRNFmtDXT5_AGBR; break;
+    case PixelFormat::ETC1: compParams.m_format = cCRNFmtETC1; break;
+    case PixelFormat::ETC2: compParams.m_format = cCRNFmtETC2; break;
+    case PixelFormat::ETC2A: compParams.m_format = cCRNFmtETC2A; break;
+    default:
+        // Premultiplied and uncompressed formats are only handled by crunch executable.
+        return false;
+    }
+
+    switch (compressor)
+    {
+    case Compressor::CRN: compParams.m_dxt_compressor_type = cCRNDXTCompressorCRN; break;
+    case Compressor::CRNF: compParams.m_dxt_compressor_type = cCRNDXTCompressorCRNF; break;
+    case Compressor::RYG: compParams.m_dxt_compressor_type = cCRNDXTCompressorRYG; break;
+    default:
+        return false;
+    }
+
+    // Decode source image once, in this thread.
+    auto image = MakeShared<Image>(context_);
+    File file(context_);
+    if (!file.Open(input->GetResourcePath()) || !image->Load(file))
+    {
+        logger_.Error("Failed to load 'res://{}'.", input->GetName());
+        succeeded = false;
+        return true;
+    }
+
+    // crnlib limits level resolution, larger images are handled by crunch executable.
+    if (image->GetWidth() > cCRNMaxLevelResolution || image->GetHeight() > cCRNMaxLevelResolution || image->GetDepth() > 1)
+        return false;
+
+    if (image->GetComponents() != 4)
+        image = image->ConvertToRGBA();
+    if (!image)
+    {
+        logger_.Error("Failed to convert 'res://{}' to RGBA.", input->GetName());
+        succeeded = false;
+        return true;
+    }
+
+    // Source image is PNG, it does not carry orientation, therefore "Un-flip" has nothing to do.
+    if (GetAttribute("Y-flip").GetBool())
+        image->FlipVertical();
+
+    compParams.m_file_type = cCRNFileTypeDDS;
+    compParams.m_width = image->GetWidth();
+    compParams.m_height = image->GetHeight();
+    compParams.m_pImages[0][0] = reinterpret_cast<const crn_uint32*>(image->GetData());
+    compParams.m_quality_level = GetAttribute("Quality").GetInt();
+    compParams.m_target_bitrate = static_cast<float>(GetAttribute("Bitrate").GetInt());
+    compParams.m_dxt1a_alpha_threshold = GetAttribute("Alpha Threshold").GetInt();
+    compParams.m_dxt_quality = static_cast<crn_dxt_quality>(GetAttribute("DXT Quality").GetInt());
+    compParams.m_num_helper_threads = Min<unsigned>(GetWeight() - 1, cCRNMaxHelperThreads);
+    compParams.set_flag(cCRNCompFlagPerceptual, !GetAttribute("Uniform Metircs").GetBool());
+    compParams.set_flag(cCRNCompFlagHierarchical, GetAttribute("Adaptive Blocks").GetBool());
+    compParams.set_flag(cCRNCompFlagDisableEndpointCaching, GetAttribute("No Endpoint Caching").GetBool());
+    compParams.set_flag(cCRNCompFlagGrayscaleSampling, GetAttribute("Greyscale Sampling").GetBool());
+    compParams.set_flag(cCRNCompFlagUseBothBlockTypes, !GetAttribute("Force Primary Encoding").GetBool());
+    compParams.set_flag(cCRNCompFlagUseTransparentIndicesForBlack, GetAttribute("Use Transparent Indices For Black").GetBool());
+
+    crn_mipmap_params mipParams;
+    switch (static_cast<MipMode>(GetAttribute("Mip Mode").GetInt()))
+    {
+    case MipMode::None: mipParams.m_mode = cCRNMipModeNoMips; break;
+    case MipMode::Generate: mipParams.m_mode = cCRNMipModeGenerateMips; break;
+    case MipMode::UseSourceOrGenerate: mipParams.m_mode = cCRNMipModeUseSourceOrGenerateMips; break;
+    case MipMode::UseSource: mipParams.m_mode = cCRNMipModeUseSourceMips; break;
+    }
+    mipParams.m_filter = static_cast<crn_mip_filter>(GetAttribute("Mip Filter").GetInt());
+    mipParams.m_gamma = GetAttribute("Gamma").GetFloat();
+    mipParams.m_blurriness = GetAttribute("Blur").GetFloat();
+    mipParams.m_tiled = GetAttribute("Wrap").GetBool();
+    mipParams.m_renormalize = GetAttribute("Renormalize").GetBool();
+    mipParams.m_max_levels = GetAttribute("Max Mips").GetInt();
+    mipParams.m_min_mip_size = GetAttribute("Min Mip Size").GetInt();
+
+    if (!compParams.check())
+        return false;
+
+    crn_uint32 compressedSize = 0;
+    void* compressed = crn_compress(compParams, mipParams, compressedSize);
+    if (compressed == nullptr)
+    {
+        logger_.Error("Error {}-compressing 'res://{}' to '{}' failed.", pixelFormatNames[(int)pixelFormat], input->GetName(), outputFile);
+        succeeded = false;
+        return true;
+    }
+
+    File outputFileStream(context_);
+    succeeded = outputFileStream.Open(outputFile, FILE_WRITE) && outputFileStream.Write(compressed, compressedSize) == compressedSize;
+    crn_free_block(compressed);
+
+    if (!succeeded)
+        logger_.Error("Failed to write '{}'.", outputFile);
+    return true;
+}
+
+bool TextureImporter::CompressWithCrunch(Asset* input, const ea::string& outputFile)
+{
+    const int pixelFormatValue = GetAttribute("Pixel Format").GetInt();
+
     ea::string output;
     StringVector arguments{
         "-fileformat", "dds", "-noprogress", "-nostats", "-quality", ea::to_string(GetAttribute("Quality").GetInt()),
@@ -215,7 +354,6 @@ bool TextureImporter::Execute(Urho3D::Asset* input, const ea::string& outputPath
         return false;
     }
 
-    AddByproduct(outputFile);
     return true;
 }
 
@@ -109,8 +109,16 @@ public:
     bool Accepts(const ea::string& path) const override;
     ///
     bool Execute(Urho3D::Asset* input, const ea::string& outputPath) override;
+    /// crnlib compresses texture using a helper thread.
+    unsigned GetWeight() const override { return 2; }
+    /// Output of in-process compression is not byte-identical to crunch executable output.
+    unsigned GetVersion() const override { return 2; }
 
 protected:
+    /// Compress texture using crnlib linked into the editor. Returns false if settings are not supported by crnlib directly, `succeeded` is set to the result of compression otherwise.
+    bool CompressInProcess(Asset* input, const ea::string& outputFile, bool& succeeded);
+    /// Compress texture by running crunch executable.
+    bool CompressWithCrunch(Asset* input, const ea::string& outputFile);
     ///
     void ApplyBlurLimit();
     ///
@@ -41,7 +41,9 @@ namespace Urho3D
 Packager::Packager(Context* context)
     : Object(context)
     , output_(context)
+    , previousPackageFile_(context)
 {
+    buffer_.resize(blockSize_);
     compressBuffer_.resize(LZ4_compressBound(blockSize_));
 }
 
@@ -59,7 +61,20 @@ bool Packager::OpenPackage(const ea::string& path, Flavor* flavor, bool compress
     flavor_ = WeakPtr(flavor);
     compress_ = compress;
 
-    if (output_.Open(path, FILE_WRITE))
+    // Compressed data of unchanged files is copied from the previous package, which is replaced when packaging completes.
+    previousPackage_ = nullptr;
+    previousPackageFile_.Close();
+    ea::string writePath = path;
+    if (compress_ && context_->GetFileSystem()->FileExists(path))
+    {
+        previousPackage_ = MakeShared<PackageFile>(context_);
+        if (previousPackage_->Open(path) && previousPackage_->IsCompressed() && previousPackageFile_.Open(path))
+            writePath = path + ".tmp";
+        else
+            previousPackage_ = nullptr;
+    }
+
+    if (output_.Open(writePath, FILE_WRITE))
     {
         WriteHeaders();
         return true;
@@ -159,6 +174,19 @@ void Packager::WritePackage()
 
     WriteHeaders();
 
+    if (previousPackage_)
+    {
+        auto* fs = context_->GetFileSystem();
+        const ea::string tempPath = output_.GetName();
+        output_.Close();
+        previousPackageFile_.Close();
+        previousPackage_ = nullptr;
+
+        fs->Delete(outputPath_);
+        if (!fs->Rename(tempPath, outputPath_))
+            logger_.Error("Could not replace '{}' with '{}'.", outputPath_, tempPath);
+    }
+
     logger_.Info("Packaging completed.");
 }
 
@@ -208,51 +236,53 @@ bool Packager::AddFile(const ea::string& root, const ea::string& path)
         return false;
     }
 
-    unsigned dataSize = entry.size_;
-    buffer_.resize(dataSize);
-
-    if (srcFile.Read(&buffer_[0], dataSize) != dataSize)
+    if (compress_ && ReuseCompressedData(srcFile, entry))
     {
-        logger_.Error("Could not read file {}. Skipped!", fileFullPath);
-        return false;
-    }
-    srcFile.Close();
-
-    for (unsigned j = 0; j < dataSize; ++j)
-    {
-        checksum_ = SDBMHash(checksum_, buffer_[j]);
-        entry.checksum_ = SDBMHash(entry.checksum_, buffer_[j]);
+        entries_.push_back(entry);
+        logger_.Info("{} reused from previous package.", entry.name_);
+        return true;
     }
 
-    entries_.push_back(entry);
-    if (!compress_)
+    // Data is streamed in blocks, file is never held in memory as a whole.
+    const unsigned dataSize = entry.size_;
+    unsigned pos = 0;
+    while (pos < dataSize)
     {
-        logger_.Info("Added {} size {}", entry.name_, dataSize);
-        output_.Write(&buffer_[0], entry.size_);
-    }
-    else
-    {
-        unsigned pos = 0;
+        const unsigned unpackedSize = Min<unsigned>(blockSize_, dataSize - pos);
+        if (srcFile.Read(buffer_.data(), unpackedSize) != unpackedSize)
+        {
+            logger_.Error("Could not read file {}. Package is corrupted!", fileFullPath);
+            return false;
+        }
 
-        // TODO: This could be parallelized.
-        while (pos < dataSize)
+        for (unsigned j = 0; j < unpackedSize; ++j)
         {
-            int unpackedSize = blockSize_;
-            if (pos + unpackedSize > dataSize)
-                unpackedSize = static_cast<int>(dataSize) - pos;
+            checksum_ = SDBMHash(checksum_, buffer_[j]);
+            entry.checksum_ = SDBMHash(entry.checksum_, buffer_[j]);
+        }
 
-            auto packedSize = (unsigned) LZ4_compress_HC((const char*) &buffer_[pos], (char*) compressBuffer_.data(), unpackedSize,
-                LZ4_compressBound(unpackedSize), 0);
+        if (!compress_)
+            output_.Write(buffer_.data(), unpackedSize);
+        else
+        {
+            auto packedSize = (unsigned) LZ4_compress_HC((const char*) buffer_.data(), (char*) compressBuffer_.data(), unpackedSize,
+                compressBuffer_.size(), 0);
             if (!packedSize)
                 logger_.Error("LZ4 compression failed for file {} at offset {}.", entry.name_, pos);
 
             output_.WriteUShort((unsigned short) unpackedSize);
             output_.WriteUShort((unsigned short) packedSize);
             output_.Write(compressBuffer_.data(), packedSize);
-
-            pos += unpackedSize;
         }
 
+        pos += unpackedSize;
+    }
+
+    entries_.push_back(entry);
+    if (!compress_)
+        logger_.Info("Added {} size {}", entry.name_, dataSize);
+    else
+    {
         unsigned totalPackedBytes = output_.GetSize() - lastOffset;
         logger_.Info("{} in: {} out: {} ratio: {}", entry.name_, dataSize, totalPackedBytes,
             totalPackedBytes ? 1.f * dataSize / totalPackedBytes : 0.f);
@@ -260,4 +290,69 @@ bool Packager::AddFile(const ea::string& root, const ea::string& path)
     return true;
 }
 
+bool Packager::ReuseCompressedData(File& srcFile, FileEntry& entry)
+{
+    if (!previousPackage_)
+        return false;
+
+    const PackageEntry* previous = previousPackage_->GetEntry(entry.name_);
+    if (previous == nullptr || previous->size_ != entry.size_)
+        return false;
+
+    // Checksums have to be calculated anyway, they also tell whether file contents changed.
+    unsigned fileChecksum = 0;
+    unsigned packageChecksum = checksum_;
+    unsigned pos = 0;
+    while (pos < entry.size_)
+    {
+        const unsigned size = Min<unsigned>(blockSize_, entry.size_ - pos);
+        if (srcFile.Read(buffer_.data(), size) != size)
+            return false;
+
+        for (unsigned j = 0; j < size; ++j)
+        {
+            packageChecksum = SDBMHash(packageChecksum, buffer_[j]);
+            fileChecksum = SDBMHash(fileChecksum, buffer_[j]);
+        }
+        pos += size;
+    }
+
+    srcFile.Seek(0);
+    if (fileChecksum != previous->checksum_)
+        return false;
+
+    // Validate block headers before writing anything, so that a corrupted previous package falls back to compression.
+    unsigned unpackedTotal = 0;
+    unsigned packedTotal = 0;
+    previousPackageFile_.Seek(previous->offset_);
+    while (unpackedTotal < entry.size_)
+    {
+        const unsigned unpackedSize = previousPackageFile_.ReadUShort();
+        const unsigned packedSize = previousPackageFile_.ReadUShort();
+        const unsigned nextBlock = previousPackageFile_.GetPosition() + packedSize;
+        if (unpackedSize == 0 || unpackedSize > (unsigned)blockSize_ || packedSize > compressBuffer_.size()
+            || previousPackageFile_.Seek(nextBlock) != nextBlock)
+            return false;
+        unpackedTotal += unpackedSize;
+        packedTotal += packedSize + 2 * sizeof(unsigned short);
+    }
+    if (unpackedTotal != entry.size_)
+        return false;
+
+    // Copy compressed blocks verbatim.
+    previousPackageFile_.Seek(previous->offset_);
+    while (packedTotal > 0)
+    {
+        const unsigned size = Min<unsigned>(packedTotal, compressBuffer_.size());
+        if (previousPackageFile_.Read(compressBuffer_.data(), size) != size)
+            return false;
+        output_.Write(compressBuffer_.data(), size);
+        packedTotal -= size;
+    }
+
+    checksum_ = packageChecksum;
+    entry.checksum_ = fileChecksum;
+    return true;
+}
+
 }
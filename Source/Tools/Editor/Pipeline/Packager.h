@@ -25,6 +25,7 @@
 
 #include <Urho3D/Core/Object.h>
 #include <Urho3D/IO/File.h>
+#include <Urho3D/IO/PackageFile.h>
 
 
 namespace Urho3D
@@ -79,6 +80,8 @@ protected:
     void WriteHeaders();
     /// A worker running in another thread that will handle writing the package.
     void WritePackage();
+    /// Copy compressed data of the file from previous package if file did not change. Returns false if data can not be reused.
+    bool ReuseCompressedData(File& srcFile, FileEntry& entry);
 
     /// Per-package logger.
     Logger logger_{};
@@ -86,6 +89,10 @@ protected:
     ea::string outputPath_{};
     /// Package file.
     File output_;
+    /// Previous version of package. Compressed data of unchanged files is reused from it.
+    SharedPtr<PackageFile> previousPackage_;
+    /// File of previous package version.
+    File previousPackageFile_;
     /// List of files that will be present in the package.
     ea::vector<FileEntry> entries_{};
     /// Flavor that is being compressed.
@@ -100,7 +107,7 @@ protected:
     int64_t entriesOffset_ = 0;
     /// LZ4 block size for data compression.
     const int blockSize_ = 32768;
-    /// Buffer that holds data that was read from file. It will be written to package or used in compression.
+    /// Buffer that holds a block of data that was read from file. It will be written to package or used in compression.
     ea::vector<uint8_t> buffer_{};
     /// Buffer that holds compressed file data.
     ea::vector<uint8_t> compressBuffer_{};
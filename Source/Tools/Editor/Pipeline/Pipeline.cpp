@@ -56,6 +56,7 @@ namespace Urho3D
 Pipeline::Pipeline(Context* context)
     : Object(context)
     , watcher_(context)
+    , artifactCache_(MakeShared<ArtifactCache>(context))
 {
     if (context_->GetEngine()->IsHeadless())
         return;
@@ -138,6 +139,13 @@ void Pipeline::OnEndFrame(StringHash, VariantMap&)
             ScheduleImport(asset);
     }
 
+    // Jobs that became ready on worker threads are dispatched from here.
+    {
+        MutexLock lock(importMutex_);
+        if (!holdImportDispatch_)
+            DispatchImportJobs();
+    }
+
     if (!dirtyAssets_.empty())
     {
         auto* inspector = GetSubsystem<InspectorTab>();
@@ -271,30 +279,181 @@ bool Pipeline::RenameFlavor(const ea::string& oldName, const ea::string& newName
     return true;
 }
 
-SharedPtr<WorkItem> Pipeline::ScheduleImport(Asset* asset, Flavor* flavor, PipelineBuildFlags flags)
+bool Pipeline::ScheduleImport(Asset* asset, Flavor* flavor, PipelineBuildFlags flags)
 {
     assert(asset != nullptr);
     if (asset->importing_)
-        return {};
+        return false;
 
     if (flavor == nullptr)
         flavor = GetDefaultFlavor();
 
     if (flags & PipelineBuildFlag::SKIP_UP_TO_DATE && !asset->IsOutOfDate(flavor))
-        return {};
+        return false;
+
+    MutexLock lock(importMutex_);
+    if (!CreateImportJob(asset, flavor, flags))
+        return false;
+
+    if (!holdImportDispatch_)
+        DispatchImportJobs();
+    return true;
+}
+
+Pipeline::ImportJob* Pipeline::CreateImportJob(Asset* asset, Flavor* flavor, PipelineBuildFlags flags)
+{
+    if (importJobs_.contains(asset->GetName()))
+        return nullptr;
+
+    SharedPtr<ImportJob> job(new ImportJob());
+    job->asset_ = asset;
+    job->flavor_ = flavor;
+    job->flags_ = flags;
+    for (AssetImporter* importer : asset->GetImporters(flavor))
+        job->weight_ = Max(job->weight_, importer->GetWeight());
+
+    // Byproducts of previous import tell which assets this asset produces. Those must be imported after this asset,
+    // otherwise they would be imported twice and concurrently with their producer.
+    for (AssetImporter* importer : asset->GetImporters(flavor))
+    {
+        for (const ea::string& byproduct : importer->GetByproducts())
+        {
+            auto it = importJobs_.find(byproduct);
+            if (it == importJobs_.end() || it->second->dispatched_)
+                continue;
+
+            ImportJob* dependant = it->second;
+            if (dependant->dependants_.contains(job) || job->dependants_.contains(SharedPtr(dependant)))
+                continue;
+            job->dependants_.push_back(SharedPtr(dependant));
+            if (dependant->numPendingDependencies_++ == 0)
+                readyImportJobs_.erase_first(SharedPtr(dependant));
+        }
+    }
+
+    // This asset is a byproduct of an asset that is still being imported.
+    for (const auto& pair : importJobs_)
+    {
+        ImportJob* producer = pair.second;
+        for (AssetImporter* importer : producer->asset_->GetImporters(producer->flavor_))
+        {
+            if (importer->GetByproducts().contains(asset->GetName()) && !producer->dependants_.contains(job))
+            {
+                producer->dependants_.push_back(job);
+                ++job->numPendingDependencies_;
+            }
+        }
+    }
 
-    asset->AddRef();
     asset->importing_ = true;
-    return context_->GetWorkQueue()->AddWorkItem([this, asset, flavor, flags]()
+    importJobs_[asset->GetName()] = job;
+    if (job->numPendingDependencies_ == 0)
+        readyImportJobs_.push_back(job);
+    return job;
+}
+
+void Pipeline::DispatchImportJobs()
+{
+    // WorkQueue may only be fed from the main thread. Each work item keeps taking ready jobs until none fit the budget.
+    while (ImportJob* job = TakeImportJob())
+    {
+        SharedPtr<ImportJob> jobRef(job);
+        context_->GetWorkQueue()->AddWorkItem([this, jobRef]()
+        {
+            for (SharedPtr<ImportJob> next = jobRef; next;)
+            {
+                RunImportJob(next);
+
+                MutexLock lock(importMutex_);
+                next = TakeImportJob();
+            }
+        }, 0);  // Lowest possible priority.
+    }
+}
+
+Pipeline::ImportJob* Pipeline::TakeImportJob()
+{
+    // Dependency cycle, dispatch remaining jobs in any order rather than never completing them.
+    if (readyImportJobs_.empty() && numRunningImports_ == 0 && !importJobs_.empty())
     {
-        if (ExecuteImport(asset, flavor, flags))
+        logger_.Warning("Import dependency cycle detected, importing {} remaining assets in arbitrary order.", importJobs_.size());
+        for (const auto& pair : importJobs_)
         {
-            MutexLock lock(mutex_);
-            dirtyAssets_.push_back(SharedPtr(asset));
+            if (!pair.second->dispatched_)
+            {
+                pair.second->numPendingDependencies_ = 0;
+                readyImportJobs_.push_back(pair.second);
+            }
         }
-        asset->importing_ = false;
-        asset->ReleaseRef();            // TODO: Chance to free asset on non-main thread.
-    }, 0);                              // Lowest possible priority.
+    }
+
+    const unsigned numThreads = Max(1u, context_->GetWorkQueue()->GetNumThreads());
+    const unsigned maxWeight = maxImportWeight_ ? maxImportWeight_ : numThreads;
+    const unsigned maxImports = maxConcurrentImports_ ? maxConcurrentImports_ : numThreads;
+
+    if (numRunningImports_ >= maxImports)
+        return nullptr;
+
+    for (auto it = readyImportJobs_.begin(); it != readyImportJobs_.end(); ++it)
+    {
+        // Job heavier than entire budget still runs, but only alone.
+        SharedPtr<ImportJob> job = *it;
+        if (numRunningImports_ > 0 && runningImportWeight_ + job->weight_ > maxWeight)
+            continue;
+
+        job->dispatched_ = true;
+        runningImportWeight_ += job->weight_;
+        ++numRunningImports_;
+        readyImportJobs_.erase(it);
+        // Graph keeps job alive until it completes.
+        return job;
+    }
+    return nullptr;
+}
+
+void Pipeline::RunImportJob(ImportJob* job)
+{
+    Asset* asset = job->asset_;
+    Flavor* flavor = job->flavor_;
+
+    if (ExecuteImport(asset, flavor, job->flags_))
+    {
+        MutexLock lock(mutex_);
+        dirtyAssets_.push_back(SharedPtr(asset));
+    }
+
+    // Byproducts produced by this import are imported unconditionally, like their producer was.
+    StringVector byproducts;
+    for (AssetImporter* importer : asset->GetImporters(flavor))
+        byproducts.append(importer->GetByproducts());
+
+    ea::vector<Asset*> byproductAssets;
+    for (const ea::string& byproduct : byproducts)
+    {
+        if (Asset* byproductAsset = GetAsset(byproduct))
+            byproductAssets.push_back(byproductAsset);
+    }
+
+    MutexLock lock(importMutex_);
+    runningImportWeight_ -= job->weight_;
+    --numRunningImports_;
+    asset->importing_ = false;
+
+    // Keep job alive until dependants are released.
+    SharedPtr<ImportJob> jobRef(job);
+    importJobs_.erase(asset->GetName());
+    for (ImportJob* dependant : job->dependants_)
+    {
+        if (--dependant->numPendingDependencies_ == 0 && !dependant->dispatched_)
+            readyImportJobs_.push_back(SharedPtr(dependant));
+    }
+    job->dependants_.clear();
+
+    for (Asset* byproductAsset : byproductAssets)
+    {
+        if (!byproductAsset->importing_)
+            CreateImportJob(byproductAsset, flavor, job->flags_ & ~PipelineBuildFlag::SKIP_UP_TO_DATE);
+    }
 }
 
 bool Pipeline::ExecuteImport(Asset* asset, Flavor* flavor, PipelineBuildFlags flags)
@@ -315,16 +474,18 @@ bool Pipeline::ExecuteImport(Asset* asset, Flavor* flavor, PipelineBuildFlags fl
         if (!importer->Accepts(asset->GetResourcePath()))
             continue;
 
-        if (importer->Execute(asset, outputPath))
+        const unsigned long long artifactKey = artifactCache_->IsEnabled() ? artifactCache_->GetKey(importer) : 0;
+        if (artifactCache_->Restore(importer, artifactKey))
+        {
+            logger_.Info("{} restored 'res://{}' from artifact cache.", importer->GetTypeName(), asset->GetName());
+            importedAnything = true;
+        }
+        else if (importer->Execute(asset, outputPath))
         {
             logger_.Info("{} imported 'res://{}'.", importer->GetTypeName(), asset->GetName());
+            artifactCache_->Store(importer, artifactKey);
 
             importedAnything = true;
-            for (const ea::string& byproduct : importer->GetByproducts())
-            {
-                if (Asset* byproductAsset = GetAsset(byproduct))
-                    ExecuteImport(byproductAsset, flavor, flags);
-            }
         }
     }
 
@@ -342,6 +503,12 @@ void Pipeline::BuildCache(Flavor* flavor, PipelineBuildFlags flags)
     StringVector results;
     fs->ScanDir(results, project->GetResourcePath(), "*.*", SCAN_FILES, true);
 
+    // Build complete dependency graph before starting any imports.
+    {
+        MutexLock lock(importMutex_);
+        holdImportDispatch_ = true;
+    }
+
     for (const ea::string& resourceName : results)
     {
         if (resourceName.ends_with(".asset"))
@@ -350,11 +517,24 @@ void Pipeline::BuildCache(Flavor* flavor, PipelineBuildFlags flags)
         if (Asset* asset = GetAsset(resourceName))
             ScheduleImport(asset, flavor, flags);
     }
+
+    MutexLock lock(importMutex_);
+    holdImportDispatch_ = false;
+    DispatchImportJobs();
 }
 
-void Pipeline::WaitForCompletion() const
+void Pipeline::WaitForCompletion()
 {
-    context_->GetWorkQueue()->Complete(0);
+    // Finished jobs schedule imports of their byproducts, keep going until import graph is exhausted.
+    for (;;)
+    {
+        context_->GetWorkQueue()->Complete(0);
+
+        MutexLock lock(importMutex_);
+        if (importJobs_.empty())
+            break;
+        DispatchImportJobs();
+    }
 }
 
 void Pipeline::CreatePaksAsync(Flavor* flavor)
@@ -419,6 +599,11 @@ void Pipeline::OnUpdate()
         StringVector results;
         fs->ScanDir(results, project->GetResourcePath(), "*.*", SCAN_FILES, true);
 
+        {
+            MutexLock lock(importMutex_);
+            holdImportDispatch_ = true;
+        }
+
         for (const ea::string& resourceName : results)
         {
             if (resourceName.ends_with(".asset"))
@@ -435,6 +620,12 @@ void Pipeline::OnUpdate()
                 packager_->AddAsset(asset);
             }
         }
+
+        {
+            MutexLock lock(importMutex_);
+            holdImportDispatch_ = false;
+            DispatchImportJobs();
+        }
         packager_->Start();
     }
 }
@@ -482,6 +673,21 @@ bool Pipeline::Serialize(Archive& archive)
 {
     if (auto block = archive.OpenUnorderedBlock("pipeline"))
     {
+        ea::string artifactCachePath = artifactCache_->GetLocalPath();
+        ea::string artifactCacheUrl = artifactCache_->GetRemoteUrl();
+        if (archive.IsInput())
+            artifactCachePath = GetSubsystem<Project>()->GetProjectPath() + "ArtifactCache/";
+
+        // Fine to not exist.
+        SerializeValue(archive, "artifactCachePath", artifactCachePath);
+        SerializeValue(archive, "artifactCacheUrl", artifactCacheUrl);
+
+        if (archive.IsInput())
+        {
+            artifactCache_->SetLocalPath(artifactCachePath);
+            artifactCache_->SetRemoteUrl(artifactCacheUrl);
+        }
+
         if (auto block = archive.OpenSequentialBlock("flavors"))
         {
             for (unsigned i = 0, num = archive.IsInput() ? block.GetSizeHint() : flavors_.size(); i < num; i++)
@@ -830,6 +1036,17 @@ void Pipeline::RenderSettingsUI()
     if (!canAdd)
         ui::PopStyleColor();
 
+    // Artifact cache
+    ea::string artifactCachePath = artifactCache_->GetLocalPath();
+    if (ui::InputText("Artifact Cache Path", &artifactCachePath, ImGuiInputTextFlags_EnterReturnsTrue))
+        artifactCache_->SetLocalPath(artifactCachePath);
+    ui::SetHelpTooltip("Directory where imported assets are cached by contents of source files. Empty value disables cache.", KEY_UNKNOWN);
+
+    ea::string artifactCacheUrl = artifactCache_->GetRemoteUrl();
+    if (ui::InputText("Remote Artifact Cache", &artifactCacheUrl, ImGuiInputTextFlags_EnterReturnsTrue))
+        artifactCache_->SetRemoteUrl(artifactCacheUrl);
+    ui::SetHelpTooltip("Optional HTTP URL serving a copy of artifact cache directory populated by a build machine.", KEY_UNKNOWN);
+
     // Flavor tabs
     if (ui::BeginTabBar("Flavors", ImGuiTabBarFlags_AutoSelectNewTabs))
     {
@@ -37,6 +37,7 @@
 #include "Pipeline/Importers/ModelImporter.h"
 #include "Pipeline/Importers/SceneConverter.h"
 #include "Pipeline/Importers/TextureImporter.h"
+#include "Pipeline/ArtifactCache.h"
 #include "Pipeline/Asset.h"
 #include "Pipeline/Packager.h"
 #include "Pipeline/Flavor.h"
@@ -77,14 +78,22 @@ public:
     bool RemoveFlavor(const ea::string& name);
     /// Rename a custom flavor.
     bool RenameFlavor(const ea::string& oldName, const ea::string& newName);
-    /// Schedules import task to run on worker thread.
-    SharedPtr <WorkItem> ScheduleImport(Asset* asset, Flavor* flavor=nullptr, PipelineBuildFlags flags=PipelineBuildFlag::DEFAULT);
-    /// Executes importers of specified asset asychronously.
+    /// Schedules import task to run on worker thread. Import runs after imports of assets that produced this asset as a byproduct. Returns true if import was scheduled.
+    bool ScheduleImport(Asset* asset, Flavor* flavor=nullptr, PipelineBuildFlags flags=PipelineBuildFlag::DEFAULT);
+    /// Executes importers of specified asset on calling thread. Byproducts are not imported.
     bool ExecuteImport(Asset* asset, Flavor* flavor, PipelineBuildFlags flags);
+    /// Set total weight of imports that may run concurrently. 0 means number of worker threads.
+    void SetMaxImportWeight(unsigned weight) { maxImportWeight_ = weight; }
+    /// Returns total weight of imports that may run concurrently. 0 means number of worker threads.
+    unsigned GetMaxImportWeight() const { return maxImportWeight_; }
+    /// Set number of imports (and external processes they spawn) that may run concurrently. 0 means number of worker threads.
+    void SetMaxConcurrentImports(unsigned count) { maxConcurrentImports_ = count; }
+    /// Returns number of imports that may run concurrently. 0 means number of worker threads.
+    unsigned GetMaxConcurrentImports() const { return maxConcurrentImports_; }
     /// Mass-schedule assets for importing.
     void BuildCache(Flavor* flavor=nullptr, PipelineBuildFlags flags=PipelineBuildFlag::DEFAULT);
     /// Blocks calling thread until all pipeline tasks complete.
-    void WaitForCompletion() const;
+    void WaitForCompletion();
     /// Queue packaging of resources for specified flavor. This function returns immediately, however user will be blocked from interacting with editor by modal window until process is done.
     void CreatePaksAsync(Flavor* flavor);
     /// Returns true if resource or any of it's parent directories have non-default flavor settings.
@@ -101,8 +110,37 @@ public:
     bool CookCacheInfo() const;
     /// Watch directory for changed assets and automatically convert them.
     void EnableWatcher();
+    /// Returns cache of importer byproducts shared between builds.
+    ArtifactCache* GetArtifactCache() const { return artifactCache_; }
 
 protected:
+    /// A scheduled import of a single asset. Node of import dependency graph.
+    struct ImportJob : public RefCounted
+    {
+        /// Asset to be imported.
+        SharedPtr<Asset> asset_;
+        /// Flavor to be imported.
+        SharedPtr<Flavor> flavor_;
+        /// Build flags.
+        PipelineBuildFlags flags_;
+        /// Weight of the heaviest importer that is going to run.
+        unsigned weight_ = 1;
+        /// Number of jobs that must complete before this job may start.
+        unsigned numPendingDependencies_ = 0;
+        /// Jobs that depend on this job.
+        ea::vector<SharedPtr<ImportJob>> dependants_;
+        /// Flag indicating that job is queued for execution or is being executed.
+        bool dispatched_ = false;
+    };
+
+    /// Create import job and link it into dependency graph. Must be called with import mutex locked.
+    ImportJob* CreateImportJob(Asset* asset, Flavor* flavor, PipelineBuildFlags flags);
+    /// Queue ready jobs for execution while within weight and concurrency limits. Must be called from main thread with import mutex locked.
+    void DispatchImportJobs();
+    /// Take a ready job that fits weight and concurrency limits and mark it running. Returns nullptr if there is none. Must be called with import mutex locked.
+    ImportJob* TakeImportJob();
+    /// Execute import job on worker thread.
+    void RunImportJob(ImportJob* job);
     /// Handles file watchers.
     void OnEndFrame(StringHash, VariantMap&);
     /// Handles modal dialogs.
@@ -118,6 +156,8 @@ protected:
     FileWatcher watcher_;
     /// List of pipeline flavors.
     ea::vector<SharedPtr<Flavor>> flavors_{};
+    /// Cache of importer byproducts keyed by contents of their inputs.
+    SharedPtr<ArtifactCache> artifactCache_;
     /// A list of loaded assets.
     ea::unordered_map<ea::string /*name*/, SharedPtr<Asset>> assets_{};
     /// A list of all available importers. When new importer is created it should be added here.
@@ -130,6 +170,22 @@ protected:
 
     ///
     Mutex mutex_;
+    /// Mutex protecting import dependency graph.
+    Mutex importMutex_;
+    /// Unfinished import jobs by asset name.
+    ea::unordered_map<ea::string, SharedPtr<ImportJob>> importJobs_;
+    /// Jobs with all dependencies completed, waiting for weight or concurrency budget.
+    ea::vector<SharedPtr<ImportJob>> readyImportJobs_;
+    /// Total weight of running import jobs.
+    unsigned runningImportWeight_ = 0;
+    /// Number of running import jobs.
+    unsigned numRunningImports_ = 0;
+    /// Flag indicating that jobs are being mass-scheduled and dispatching should be postponed until graph is complete.
+    bool holdImportDispatch_ = false;
+    /// Total weight of imports that may run concurrently. 0 means number of worker threads.
+    unsigned maxImportWeight_ = 0;
+    /// Number of imports that may run concurrently. 0 means number of worker threads.
+    unsigned maxConcurrentImports_ = 0;
     /// A list of assets that were modified in non-main thread and need to be saved on main thread.
     ea::vector<SharedPtr<Asset>> dirtyAssets_;
     /// A list of flavors that are yet to be packaged.
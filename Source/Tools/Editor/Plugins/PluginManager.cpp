@@ -109,26 +109,47 @@ void PluginManager::OnEndFrame()
     if (checkOutOfDatePlugins)
         updateCheckTimer_.Reset();
 
-    for (Plugin* plugin : plugins_)
+    // Find plugins that are going away this frame first, so that listeners learn about all affected types at once and
+    // only have to tear down objects provided by these plugins.
+    ea::vector<bool> outOfDate(plugins_.size(), false);
+    VariantVector unloadedTypes;
+    for (unsigned i = 0; i < plugins_.size(); ++i)
     {
+        Plugin* plugin = plugins_[i];
         if (plugin->application_.Null())
             continue;
 
-        bool pluginOutOfDate = false;
-
         // Plugin reloading is not used in headless executions.
         if (!context_->GetEngine()->IsHeadless())
         {
             // Check for modified plugins once in a while, do not hammer syscalls on every frame.
             if (checkOutOfDatePlugins)
-                pluginOutOfDate = checkOutOfDatePlugins && plugin->IsOutOfDate();
+                outOfDate[i] = plugin->IsOutOfDate();
+        }
+
+        if (plugin->unloading_ || outOfDate[i])
+        {
+            for (const auto& pair : plugin->application_->GetRegisteredTypes())
+                unloadedTypes.push_back(pair.first);
         }
+    }
+
+    for (unsigned i = 0; i < plugins_.size(); ++i)
+    {
+        Plugin* plugin = plugins_[i];
+        if (plugin->application_.Null())
+            continue;
+
+        bool pluginOutOfDate = outOfDate[i];
 
         if (plugin->unloading_ || pluginOutOfDate)
         {
             if (!eventSent)
             {
-                SendEvent(E_EDITORUSERCODERELOADSTART);
+                using namespace EditorUserCodeReloadStart;
+                VariantMap& args = GetEventDataMap();
+                args[P_TYPES] = unloadedTypes;
+                SendEvent(E_EDITORUSERCODERELOADSTART, args);
                 eventSent = true;
             }
 
@@ -21,7 +21,10 @@
 //
 
 #include <Urho3D/IO/Log.h>
+#include <Urho3D/Core/StringUtils.h>
+#include <Urho3D/Scene/Serializable.h>
 #include <Urho3D/SystemUI/SystemUI.h>
+#include <Toolbox/SystemUI/AttributeInspector.h>
 #include "EditorEvents.h"
 #include "InspectorTab.h"
 #include "Editor.h"
@@ -50,17 +53,50 @@ bool InspectorTab::RenderWindowContent()
     auto* editor = GetSubsystem<Editor>();
     InspectArgs args;
     args.filter_ = filter_;
-    for (const auto& pair : inspected_)
+    for (unsigned i = 0; i < inspected_.size();)
     {
-        args.object_ = pair.first;
-        args.eventSender_ = pair.second;
-        args.handledTimes_ = 0;
-        editor->onInspect_(this, args);
+        // Consecutive objects of the same type that share an event sender are edited together.
+        unsigned end = i + 1;
+        while (end < inspected_.size() && CanInspectTogether(inspected_[i], inspected_[end]))
+            ++end;
+
+        if (end - i > 1)
+        {
+            multipleInspected_.clear();
+            for (unsigned j = i; j < end; ++j)
+                multipleInspected_.push_back(static_cast<Serializable*>(inspected_[j].first.Get()));
+            RenderMultipleInspector(multipleInspected_, inspected_[i].second);
+        }
+        else
+        {
+            args.object_ = inspected_[i].first;
+            args.eventSender_ = inspected_[i].second;
+            args.handledTimes_ = 0;
+            editor->onInspect_(this, args);
+        }
+        i = end;
     }
 
     return true;
 }
 
+bool InspectorTab::CanInspectTogether(const InspectedObject& first, const InspectedObject& second) const
+{
+    if (first.first.Expired() || second.first.Expired() || first.second.Expired())
+        return false;
+    // Objects that send their own events are tracked separately.
+    if (first.second == first.first || second.second != first.second)
+        return false;
+    return first.first->GetType() == second.first->GetType() && first.first->Cast<Serializable>() != nullptr;
+}
+
+void InspectorTab::RenderMultipleInspector(const ea::vector<Serializable*>& objects, Object* eventSender)
+{
+    ui::IdScope idScope(objects.front());
+    if (ui::CollapsingHeader(Format("{} x {}", objects.size(), objects.front()->GetTypeName()).c_str(), ImGuiTreeNodeFlags_DefaultOpen))
+        RenderAttributes(objects, filter_, eventSender);
+}
+
 void InspectorTab::Clear()
 {
     inspected_.clear();
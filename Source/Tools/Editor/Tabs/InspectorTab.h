@@ -31,6 +31,8 @@
 namespace Urho3D
 {
 
+class Serializable;
+
 struct InspectArgs
 {
     /// In. Attribute filter string.
@@ -58,10 +60,20 @@ public:
     bool IsInspected(Object* object) const;
 
 protected:
+    /// Inspected object and the object that sends its modification events.
+    using InspectedObject = ea::pair<WeakPtr<Object>, WeakPtr<Object>>;
+
+    /// Returns true when both objects can be rendered by a single multi-object inspector.
+    bool CanInspectTogether(const InspectedObject& first, const InspectedObject& second) const;
+    /// Render attributes of objects of the same type, edits are applied to all of them.
+    void RenderMultipleInspector(const ea::vector<Serializable*>& objects, Object* eventSender);
+
     /// Inspector attribute filter string.
     ea::string filter_;
     /// All currently inspected objects.
-    ea::vector<ea::pair<WeakPtr<Object>, WeakPtr<Object>>> inspected_;
+    ea::vector<InspectedObject> inspected_;
+    /// Objects rendered by current multi-object inspector.
+    ea::vector<Serializable*> multipleInspected_;
 };
 
 }
@@ -29,6 +29,7 @@
 #include <Urho3D/Math/Rect.h>
 #include <Urho3D/Math/Color.h>
 #include <Urho3D/Input/Input.h>
+#include <Urho3D/IO/Log.h>
 #include <Urho3D/Resource/ResourceEvents.h>
 #include <Urho3D/Scene/CameraViewport.h>
 #include <Urho3D/Scene/Scene.h>
@@ -107,25 +108,97 @@ void PreviewTab::OnReloadFinished(StringHash type, VariantMap& args)
 
 void PreviewTab::OnEditorUserCodeReloadStart(StringHash type, VariantMap& args)
 {
-    // On plugin code reload all scene state is serialized, plugin library is reloaded and scene state is unserialized.
-    // This way scene recreates all plugin-provided components on reload and gets to use new versions of them.
+    // On plugin code reload only components provided by reloaded plugins are serialized and removed, plugin library is
+    // reloaded and these components are recreated. Rest of the scene is left intact. Components are stored as XML so
+    // that they survive attribute layout changes between plugin versions.
+    using namespace EditorUserCodeReloadStart;
+
     auto* tab = GetSubsystem<Editor>()->GetTab<SceneTab>();
     if (tab == nullptr || tab->GetScene() == nullptr)
         return;
 
+    const VariantVector& types = args[P_TYPES].GetVariantVector();
+    if (types.empty())
+        return;
+
     undo_->SetTrackingEnabled(false);
-    tab->SaveState(sceneReloadState_);
-    tab->GetScene()->RemoveAllChildren();
-    tab->GetScene()->RemoveAllComponents();
+
+    Scene* scene = tab->GetScene();
+    ea::vector<Node*> nodes;
+    scene->GetChildren(nodes, true);
+    nodes.push_back(scene);
+
+    reloadedComponents_ = context_->CreateObject<XMLFile>();
+    XMLElement root = reloadedComponents_->CreateRoot("components");
+    ea::vector<Component*> removedComponents;
+    for (Node* node : nodes)
+    {
+        const auto& components = node->GetComponents();
+        for (unsigned index = 0; index < components.size(); ++index)
+        {
+            Component* component = components[index];
+            bool pluginType = ea::any_of(types.begin(), types.end(),
+                [component](const Variant& type) { return component->IsInstanceOf(type.GetStringHash()); });
+            if (!pluginType)
+                continue;
+
+            removedComponents.push_back(component);
+            if (component->IsTemporary())
+                continue;
+
+            XMLElement element = root.CreateChild("component");
+            element.SetUInt("node", node->GetID());
+            element.SetUInt("index", index);
+            element.SetBool("selected", tab->IsSelected(component));
+            component->SaveXML(element);
+        }
+    }
+
+    for (Component* component : removedComponents)
+        component->Remove();
 }
 
 void PreviewTab::OnEditorUserCodeReloadEnd(StringHash type, VariantMap& args)
 {
     auto* tab = GetSubsystem<Editor>()->GetTab<SceneTab>();
-    if (tab == nullptr || tab->GetScene() == nullptr)
+    if (tab == nullptr || tab->GetScene() == nullptr || reloadedComponents_.Null())
         return;
 
-    tab->RestoreState(sceneReloadState_);
+    // Components were saved in order of their index within node, so restoring them in the same order puts every
+    // component back to its original spot. Types that are gone after reload are preserved as UnknownComponent.
+    Scene* scene = tab->GetScene();
+    ea::vector<Component*> restoredComponents;
+    ea::vector<Component*> selectedComponents;
+    for (XMLElement element = reloadedComponents_->GetRoot().GetChild("component"); element; element = element.GetNext("component"))
+    {
+        Node* node = scene->GetNode(element.GetUInt("node"));
+        if (node == nullptr)
+            continue;
+
+        ea::string typeName = element.GetAttribute("type");
+        unsigned id = element.GetUInt("id");
+        Component* component = node->SafeCreateComponent(typeName, StringHash(typeName), id < FIRST_LOCAL_ID ? REPLICATED : LOCAL, id);
+        if (component == nullptr)
+            continue;
+
+        if (!component->LoadXML(element))
+        {
+            URHO3D_LOGERROR("Failed to restore component '{}' of node {} after plugin reload.", typeName, node->GetID());
+            component->Remove();
+            continue;
+        }
+        node->ReorderComponent(component, element.GetUInt("index"));
+        restoredComponents.push_back(component);
+        if (element.GetBool("selected"))
+            selectedComponents.push_back(component);
+    }
+
+    for (Component* component : restoredComponents)
+        component->ApplyAttributes();
+    if (!selectedComponents.empty())
+        tab->Select(selectedComponents);
+
+    reloadedComponents_.Reset();
     undo_->SetTrackingEnabled(true);
 }
 
@@ -25,6 +25,7 @@
 
 #include <Urho3D/Input/Input.h>
 #include <Urho3D/Core/Object.h>
+#include <Urho3D/Resource/XMLFile.h>
 #include <Urho3D/Scene/Scene.h>
 #include "Tabs/Scene/SceneTab.h"
 
@@ -103,8 +104,8 @@ protected:
     SceneSimulationStatus simulationStatus_ = SCENE_SIMULATION_STOPPED;
     /// Temporary storage of scene data used in play/pause functionality.
     SceneState sceneState_;
-    /// Temporary storage of scene data used when plugins are being reloaded.
-    SceneState sceneReloadState_;
+    /// Temporary storage of plugin-provided components used when plugins are being reloaded.
+    SharedPtr<XMLFile> reloadedComponents_;
     /// Time since ESC was last pressed. Used for double-press ESC to exit scene simulation.
     unsigned lastEscPressTime_ = 0;
     /// Flag indicating game view assumed control of the input.
@@ -21,6 +21,10 @@
 //
 
 #include <IconFontCppHeaders/IconsFontAwesome5.h>
+#include <Urho3D/Core/MemoryTracker.h>
+#include <Urho3D/Core/StringUtils.h>
+#include <Urho3D/Graphics/Renderer.h>
+#include <Urho3D/Graphics/RenderStatistics.h>
 #include <Urho3D/SystemUI/SystemUI.h>
 #include <ImGui/imgui_stdlib.h>
 #if URHO3D_PROFILING
@@ -43,6 +47,8 @@ ProfilerTab::ProfilerTab(Context* context)
 bool ProfilerTab::RenderWindowContent()
 {
     ui::PushID("Profiler");
+    RenderRenderStatistics();
+    RenderMemoryStatistics();
 #if URHO3D_PROFILING
     if (view_)
     {
@@ -69,4 +75,85 @@ bool ProfilerTab::RenderWindowContent()
     return true;
 }
 
+void ProfilerTab::RenderRenderStatistics()
+{
+    auto* renderer = GetSubsystem<Renderer>();
+    if (!renderer || !ui::CollapsingHeader("Render Statistics"))
+        return;
+
+    bool enabled = renderer->GetRenderStatisticsEnabled();
+    if (ui::Checkbox("Collect", &enabled))
+        renderer->SetRenderStatistics(enabled);
+
+    RenderStatistics* statistics = renderer->GetRenderStatistics();
+    if (!statistics)
+        return;
+
+    static const char* groupNames[] = {"Passes", "Materials", "Drawable Types"};
+    static const char* columnNames[] = {"Name", "Batches", "Instanced", "Instances", "Primitives", "States", "Shaders", "Textures"};
+    for (unsigned group = 0; group < MAX_RENDER_STATISTICS_GROUPS; ++group)
+    {
+        if (!ui::TreeNodeEx(groupNames[group], ImGuiTreeNodeFlags_DefaultOpen))
+            continue;
+
+        ui::Columns(IM_ARRAYSIZE(columnNames), groupNames[group]);
+        for (const char* columnName : columnNames)
+        {
+            ui::TextUnformatted(columnName);
+            ui::NextColumn();
+        }
+        ui::Separator();
+
+        for (const RenderStatisticsEntry& entry : statistics->GetEntries(static_cast<RenderStatisticsGroup>(group)))
+        {
+            const RenderStatisticsCounters& counters = entry.counters_;
+            ui::TextUnformatted(entry.name_.c_str());
+            ui::NextColumn();
+            for (unsigned value : {counters.batches_, counters.instancedBatches_, counters.instances_, counters.primitives_,
+                counters.stateChanges_, counters.shaderChanges_, counters.textureChanges_})
+            {
+                ui::Text("%u", value);
+                ui::NextColumn();
+            }
+        }
+        ui::Columns(1);
+        ui::TreePop();
+    }
+}
+
+void ProfilerTab::RenderMemoryStatistics()
+{
+    if (!ui::CollapsingHeader("Memory"))
+        return;
+
+    if (!MemoryTracker::IsGlobalTrackingEnabled())
+        ui::TextUnformatted("Only tagged allocators are tracked, build with URHO3D_MEMORY_TRACKING to track all allocations.");
+    if (ui::Button("Reset Peaks"))
+        MemoryTracker::ResetPeaks();
+
+    static const char* columnNames[] = {"Tag", "Live", "Peak", "Allocations"};
+    ui::Columns(IM_ARRAYSIZE(columnNames), "Memory");
+    for (const char* columnName : columnNames)
+    {
+        ui::TextUnformatted(columnName);
+        ui::NextColumn();
+    }
+    ui::Separator();
+
+    for (unsigned i = 0; i < MAX_MEMORY_TAGS; ++i)
+    {
+        const auto tag = static_cast<MemoryTag>(i);
+        const MemoryTagStatistics statistics = MemoryTracker::GetStatistics(tag);
+        ui::TextUnformatted(MemoryTracker::GetTagName(tag));
+        ui::NextColumn();
+        ui::TextUnformatted(GetFileSizeString(Max(statistics.liveBytes_, 0ll)).c_str());
+        ui::NextColumn();
+        ui::TextUnformatted(GetFileSizeString(Max(statistics.peakBytes_, 0ll)).c_str());
+        ui::NextColumn();
+        ui::Text("%llu", statistics.numAllocations_);
+        ui::NextColumn();
+    }
+    ui::Columns(1);
+}
+
 }
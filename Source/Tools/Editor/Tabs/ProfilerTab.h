@@ -38,6 +38,10 @@ public:
     explicit ProfilerTab(Context* context);
 
     bool RenderWindowContent() override;
+    /// Render per pass, material and drawable type breakdown of the last frame.
+    void RenderRenderStatistics();
+    /// Render live and peak memory of each memory tag.
+    void RenderMemoryStatistics();
 #if URHO3D_PROFILING
     std::unique_ptr<tracy::View> view_;
 #endif
@@ -0,0 +1,265 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <EASTL/sort.h>
+
+#include <Urho3D/Scene/Component.h>
+#include <Urho3D/Scene/Node.h>
+#include <Urho3D/Scene/Scene.h>
+#include <Urho3D/Scene/SceneEvents.h>
+#include "SceneHierarchy.h"
+
+
+namespace Urho3D
+{
+
+/// Return lowercase name used for searching. Unnamed nodes are searched by the same text that hierarchy displays for them.
+static ea::string GetSearchName(Node* node)
+{
+    if (node->GetName().empty())
+        return ToString("%s %d", node->GetTypeName().c_str(), node->GetID()).to_lower();
+    return node->GetName().to_lower();
+}
+
+SceneHierarchy::SceneHierarchy(Context* context)
+    : Object(context)
+{
+}
+
+void SceneHierarchy::SetScene(Scene* scene)
+{
+    if (scene == scene_)
+        return;
+
+    if (scene_)
+        UnsubscribeFromAllEvents();
+
+    scene_ = scene;
+    expandedNodes_.clear();
+    searchIndex_.clear();
+    searchIndexValid_ = false;
+    rows_.clear();
+    rowsDirty_ = true;
+
+    if (scene)
+    {
+        expandedNodes_.insert(scene->GetID());
+        SubscribeToEvent(scene, E_NODEADDED, [this](StringHash, VariantMap& args) { OnNodeAdded(args); });
+        SubscribeToEvent(scene, E_NODEREMOVED, [this](StringHash, VariantMap& args) { OnNodeRemoved(args); });
+        SubscribeToEvent(scene, E_NODENAMECHANGED, [this](StringHash, VariantMap& args) { OnNodeNameChanged(args); });
+        SubscribeToEvent(scene, E_COMPONENTADDED, [this](StringHash, VariantMap& args) {
+            OnNodeChanged(static_cast<Node*>(args[ComponentAdded::P_NODE].GetPtr()));
+        });
+        SubscribeToEvent(scene, E_COMPONENTREMOVED, [this](StringHash, VariantMap& args) {
+            OnNodeChanged(static_cast<Node*>(args[ComponentRemoved::P_NODE].GetPtr()));
+        });
+        SubscribeToEvent(scene, E_TEMPORARYCHANGED, [this](StringHash, VariantMap&) { rowsDirty_ = true; });
+    }
+}
+
+void SceneHierarchy::SetFilter(const ea::string& filter)
+{
+    ea::string lowercaseFilter = filter.to_lower();
+    if (lowercaseFilter == filter_)
+        return;
+
+    filter_ = lowercaseFilter;
+    rowsDirty_ = true;
+}
+
+void SceneHierarchy::SetExpanded(Node* node, bool expanded)
+{
+    if (node == nullptr)
+        return;
+
+    if (expanded)
+    {
+        if (expandedNodes_.insert(node->GetID()).second && filter_.empty())
+            rowsDirty_ = true;
+    }
+    else
+    {
+        if (expandedNodes_.erase(node->GetID()) && filter_.empty())
+            rowsDirty_ = true;
+    }
+}
+
+void SceneHierarchy::ExpandTo(Node* node)
+{
+    if (node == nullptr)
+        return;
+
+    for (Node* parent = node->GetParent(); parent != nullptr; parent = parent->GetParent())
+        SetExpanded(parent, true);
+}
+
+bool SceneHierarchy::IsExpanded(Node* node) const
+{
+    return expandedNodes_.contains(node->GetID());
+}
+
+const ea::vector<SceneHierarchyRow>& SceneHierarchy::GetRows()
+{
+    if (!rowsDirty_)
+        return rows_;
+
+    rowsDirty_ = false;
+    rows_.clear();
+    if (!scene_)
+        return rows_;
+
+    if (filter_.empty())
+        BuildRows(scene_, 0);
+    else
+        BuildFilteredRows();
+    return rows_;
+}
+
+unsigned SceneHierarchy::FindRow(Node* node)
+{
+    const ea::vector<SceneHierarchyRow>& rows = GetRows();
+    for (unsigned i = 0; i < rows.size(); ++i)
+    {
+        if (rows[i].node_ == node && !rows[i].component_)
+            return i;
+    }
+    return M_MAX_UNSIGNED;
+}
+
+bool SceneHierarchy::IsHidden(Node* node)
+{
+    return node->IsTemporary() || node->HasTag("__EDITOR_OBJECT__");
+}
+
+void SceneHierarchy::OnNodeAdded(VariantMap& args)
+{
+    using namespace NodeAdded;
+    auto* node = static_cast<Node*>(args[P_NODE].GetPtr());
+    if (searchIndexValid_)
+        AddToIndex(node);
+    if (!filter_.empty())
+        rowsDirty_ = true;
+    OnNodeChanged(static_cast<Node*>(args[P_PARENT].GetPtr()));
+}
+
+void SceneHierarchy::OnNodeRemoved(VariantMap& args)
+{
+    using namespace NodeRemoved;
+    auto* node = static_cast<Node*>(args[P_NODE].GetPtr());
+    if (searchIndexValid_)
+        RemoveFromIndex(node);
+    if (!filter_.empty())
+        rowsDirty_ = true;
+    OnNodeChanged(static_cast<Node*>(args[P_PARENT].GetPtr()));
+}
+
+void SceneHierarchy::OnNodeNameChanged(VariantMap& args)
+{
+    using namespace NodeNameChanged;
+    auto* node = static_cast<Node*>(args[P_NODE].GetPtr());
+    if (searchIndexValid_)
+    {
+        auto it = searchIndex_.find(node->GetID());
+        if (it != searchIndex_.end())
+            it->second = GetSearchName(node);
+    }
+    if (!filter_.empty())
+        rowsDirty_ = true;
+}
+
+void SceneHierarchy::OnNodeChanged(Node* node)
+{
+    if (node != nullptr && filter_.empty() && IsDisplayed(node))
+        rowsDirty_ = true;
+}
+
+void SceneHierarchy::AddToIndex(Node* node)
+{
+    if (IsHidden(node))
+        return;
+
+    searchIndex_[node->GetID()] = GetSearchName(node);
+    for (Node* child : node->GetChildren())
+        AddToIndex(child);
+}
+
+void SceneHierarchy::RemoveFromIndex(Node* node)
+{
+    searchIndex_.erase(node->GetID());
+    for (Node* child : node->GetChildren())
+        RemoveFromIndex(child);
+}
+
+bool SceneHierarchy::IsDisplayed(Node* node) const
+{
+    for (; node != nullptr; node = node->GetParent())
+    {
+        if (!IsExpanded(node))
+            return false;
+    }
+    return true;
+}
+
+void SceneHierarchy::BuildRows(Node* node, unsigned depth)
+{
+    if (IsHidden(node))
+        return;
+
+    rows_.push_back({WeakPtr<Node>(node), nullptr, depth});
+    if (!IsExpanded(node))
+        return;
+
+    for (Component* component : node->GetComponents())
+    {
+        if (!component->IsTemporary())
+            rows_.push_back({WeakPtr<Node>(node), WeakPtr<Component>(component), depth + 1});
+    }
+
+    for (Node* child : node->GetChildren())
+        BuildRows(child, depth + 1);
+}
+
+void SceneHierarchy::BuildFilteredRows()
+{
+    if (!searchIndexValid_)
+    {
+        AddToIndex(scene_);
+        searchIndexValid_ = true;
+    }
+
+    ea::vector<unsigned> matches;
+    for (const auto& pair : searchIndex_)
+    {
+        if (pair.second.find(filter_) != ea::string::npos)
+            matches.push_back(pair.first);
+    }
+
+    // Display matches in creation order rather than in hash order.
+    ea::sort(matches.begin(), matches.end());
+    for (unsigned id : matches)
+    {
+        if (Node* node = scene_->GetNode(id))
+            rows_.push_back({WeakPtr<Node>(node), nullptr, 0});
+    }
+}
+
+}
@@ -0,0 +1,115 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+
+#include <EASTL/hash_set.h>
+#include <EASTL/unordered_map.h>
+#include <Urho3D/Core/Object.h>
+
+
+namespace Urho3D
+{
+
+class Component;
+class Node;
+class Scene;
+
+/// Row of the flattened scene hierarchy.
+struct SceneHierarchyRow
+{
+    /// Node displayed in the row, or owning the component displayed in the row.
+    WeakPtr<Node> node_;
+    /// Component displayed in the row. Null for node rows.
+    WeakPtr<Component> component_;
+    /// Nesting depth.
+    unsigned depth_ = 0;
+};
+
+/// Flat list of the visible scene hierarchy rows, so that only rows scrolled into view have to be rendered. The list covers
+/// expanded nodes only and is rebuilt lazily when scene events touch an expanded node. When a filter is set, the rows are the
+/// nodes whose names contain the filter, looked up from a search index that the scene events keep up to date.
+class SceneHierarchy : public Object
+{
+    URHO3D_OBJECT(SceneHierarchy, Object);
+public:
+    ///
+    explicit SceneHierarchy(Context* context);
+    /// Set displayed scene.
+    void SetScene(Scene* scene);
+    /// Set case-insensitive name filter. Empty filter displays the whole tree.
+    void SetFilter(const ea::string& filter);
+    /// Set whether node children are displayed.
+    void SetExpanded(Node* node, bool expanded);
+    /// Expand all parents of the node so that it is displayed.
+    void ExpandTo(Node* node);
+    /// Return whether node children are displayed.
+    bool IsExpanded(Node* node) const;
+    /// Return displayed scene.
+    Scene* GetScene() const { return scene_; }
+    /// Return name filter.
+    const ea::string& GetFilter() const { return filter_; }
+    /// Return rows, rebuilding them if necessary.
+    const ea::vector<SceneHierarchyRow>& GetRows();
+    /// Return index of the node row, or M_MAX_UNSIGNED if the node is not displayed.
+    unsigned FindRow(Node* node);
+    /// Return whether node belongs to the editor and is never displayed.
+    static bool IsHidden(Node* node);
+
+protected:
+    ///
+    void OnNodeAdded(VariantMap& args);
+    ///
+    void OnNodeRemoved(VariantMap& args);
+    ///
+    void OnNodeNameChanged(VariantMap& args);
+    /// Mark rows dirty if children of the node are displayed.
+    void OnNodeChanged(Node* node);
+    /// Add node and its children to the search index.
+    void AddToIndex(Node* node);
+    /// Remove node and its children from the search index.
+    void RemoveFromIndex(Node* node);
+    /// Return whether node and all its parents are expanded.
+    bool IsDisplayed(Node* node) const;
+    /// Append rows of the node and its expanded children.
+    void BuildRows(Node* node, unsigned depth);
+    /// Append rows of the nodes matching the filter.
+    void BuildFilteredRows();
+
+    /// Displayed scene.
+    WeakPtr<Scene> scene_;
+    /// Lowercase name filter.
+    ea::string filter_;
+    /// IDs of the expanded nodes.
+    ea::hash_set<unsigned> expandedNodes_;
+    /// Lowercase node names by node ID. Built on first use of the filter.
+    ea::unordered_map<unsigned, ea::string> searchIndex_;
+    /// Flag indicating that the search index has been built.
+    bool searchIndexValid_ = false;
+    /// Visible rows.
+    ea::vector<SceneHierarchyRow> rows_;
+    /// Flag indicating that rows have to be rebuilt.
+    bool rowsDirty_ = true;
+};
+
+}
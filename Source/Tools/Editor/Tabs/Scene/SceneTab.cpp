@@ -70,6 +70,8 @@ SceneTab::SceneTab(Context* context)
     , rect_({0, 0, 1024, 768})
     , gizmo_(context)
     , clipboard_(context)
+    , hierarchy_(context)
+    , picker_(context)
 {
     SetID("be1c7280-08e4-4b9f-b6ec-6d32bd9e3293");
     SetTitle("Scene");
@@ -227,78 +229,7 @@ bool SceneTab::RenderWindowContent()
     else
         windowFlags_ &= ~ImGuiWindowFlags_NoMove;
 
-    if (!gizmo_.IsActive() && (isClickedLeft_ || isClickedRight_) && context_->GetInput()->IsMouseVisible())
-    {
-        // Handle object selection.
-        ImGuiIO& io = ui::GetIO();
-        Ray cameraRay = GetCamera()->GetScreenRay(
-            (io.MousePos.x - viewportRect.Min.x) / viewportRect.GetWidth(),
-            (io.MousePos.y - viewportRect.Min.y) / viewportRect.GetHeight());
-        // Pick only geometry objects, not eg. zones or lights, only get the first (closest) hit
-        ea::vector<RayQueryResult> results;
-
-        RayOctreeQuery query(results, cameraRay, RAY_TRIANGLE, M_INFINITY, DRAWABLE_GEOMETRY);
-        GetScene()->GetComponent<Octree>()->RaycastSingle(query);
-
-        if (!results.size())
-        {
-            // When object geometry was not hit by a ray - query for object bounding box.
-            RayOctreeQuery query2(results, cameraRay, RAY_OBB, M_INFINITY, DRAWABLE_GEOMETRY);
-            GetScene()->GetComponent<Octree>()->RaycastSingle(query2);
-        }
-
-        if (results.size() && results[0].drawable_->GetNode() != nullptr)
-        {
-            StringHash componentType;
-            WeakPtr<Node> clickNode(results[0].drawable_->GetNode());
-
-            if (clickNode->HasTag("DebugIcon"))
-                componentType = clickNode->GetVar("ComponentType").GetStringHash();
-
-            while (!clickNode.Expired() && clickNode->HasTag("__EDITOR_OBJECT__"))
-                clickNode = clickNode->GetParent();
-
-            if (isClickedLeft_)
-            {
-                if (!context_->GetInput()->GetKeyDown(KEY_CTRL))
-                    ClearSelection();
-
-                if (clickNode == GetScene())
-                {
-                    if (componentType != StringHash::ZERO)
-                        ModifySelection({}, {clickNode->GetComponent(componentType)}, SelectionMode::Toggle);
-                }
-                else
-                    ToggleSelection(clickNode);
-            }
-            else if (isClickedRight_ && ImLengthSqr(ui::GetMouseDragDelta(MOUSEB_RIGHT)) == 0.0f)
-            {
-                if (clickNode == GetScene())
-                {
-                    if (componentType != StringHash::ZERO)
-                    {
-                        Component* component = clickNode->GetComponent(componentType);
-                        if (!IsSelected(component))
-                        {
-                            ClearSelection();
-                            ToggleSelection(component);
-                        }
-                    }
-                }
-                else if (!IsSelected(clickNode))
-                {
-                    ClearSelection();
-                    ToggleSelection(clickNode);
-                }
-                ui::OpenPopupEx(ui::GetID("Node context menu"));
-            }
-        }
-        else
-        {
-            ClearSelection();
-            OnNodeSelectionChanged();
-        }
-    }
+    UpdateViewportSelection(viewportRect);
 
     RenderNodeContextMenu();
 
@@ -419,6 +350,191 @@ bool SceneTab::SaveResource()
     return result;
 }
 
+void SceneTab::UpdateViewportSelection(const ImRect& viewportRect)
+{
+    ImGuiIO& io = ui::GetIO();
+    Input* input = GetSubsystem<Input>();
+
+    // Converts screen position to pixel of the viewport texture.
+    auto toTexture = [&](const ImVec2& pos) {
+        return IntVector2{
+            static_cast<int>((pos.x - viewportRect.Min.x) / viewportRect.GetWidth() * texture_->GetWidth()),
+            static_cast<int>((pos.y - viewportRect.Min.y) / viewportRect.GetHeight() * texture_->GetHeight())
+        };
+    };
+
+    if (!gizmo_.IsActive() && (isClickedLeft_ || isClickedRight_) && input->IsMouseVisible())
+    {
+        // Handle object selection.
+        const bool additive = input->GetKeyDown(KEY_CTRL);
+        const bool clickedRight = isClickedRight_ && ImLengthSqr(ui::GetMouseDragDelta(MOUSEB_RIGHT)) == 0.0f;
+        if (gpuPicking_)
+        {
+            IntVector2 pos = toTexture(io.MousePos);
+            picker_.Request(viewport_, {texture_->GetWidth(), texture_->GetHeight()}, IntRect(pos, pos + IntVector2::ONE));
+            pickLeft_ = isClickedLeft_;
+            pickRight_ = clickedRight;
+            pickAdditive_ = additive;
+            pickMarquee_ = false;
+        }
+        else
+        {
+            Ray cameraRay = GetCamera()->GetScreenRay(
+                (io.MousePos.x - viewportRect.Min.x) / viewportRect.GetWidth(),
+                (io.MousePos.y - viewportRect.Min.y) / viewportRect.GetHeight());
+            // Pick only geometry objects, not eg. zones or lights, only get the first (closest) hit
+            ea::vector<RayQueryResult> results;
+
+            RayOctreeQuery query(results, cameraRay, RAY_TRIANGLE, M_INFINITY, DRAWABLE_GEOMETRY);
+            GetScene()->GetComponent<Octree>()->RaycastSingle(query);
+
+            if (!results.size())
+            {
+                // When object geometry was not hit by a ray - query for object bounding box.
+                RayOctreeQuery query2(results, cameraRay, RAY_OBB, M_INFINITY, DRAWABLE_GEOMETRY);
+                GetScene()->GetComponent<Octree>()->RaycastSingle(query2);
+            }
+
+            SelectClickedDrawable(results.size() ? results[0].drawable_ : nullptr, isClickedLeft_, clickedRight, additive);
+        }
+
+        if (isClickedLeft_ && gpuPicking_)
+        {
+            isMarqueeActive_ = true;
+            marqueeStart_ = io.MousePos;
+        }
+    }
+
+    // Marquee selection is available only with object ID buffer.
+    if (isMarqueeActive_)
+    {
+        const bool dragged = ImLengthSqr(io.MousePos - marqueeStart_) > io.MouseDragThreshold * io.MouseDragThreshold;
+        if (gizmo_.IsActive() || !gpuPicking_)
+            isMarqueeActive_ = false;
+        else if (!ui::IsMouseDown(MOUSEB_LEFT))
+        {
+            isMarqueeActive_ = false;
+            if (dragged)
+            {
+                IntRect rect(toTexture(ImMin(marqueeStart_, io.MousePos)), toTexture(ImMax(marqueeStart_, io.MousePos)));
+                picker_.Request(viewport_, {texture_->GetWidth(), texture_->GetHeight()}, rect);
+                pickLeft_ = pickRight_ = false;
+                pickAdditive_ = input->GetKeyDown(KEY_CTRL);
+                pickMarquee_ = true;
+            }
+        }
+        else if (dragged)
+        {
+            ImDrawList* drawList = ui::GetWindowDrawList();
+            ImVec2 min = ImClamp(ImMin(marqueeStart_, io.MousePos), viewportRect.Min, viewportRect.Max);
+            ImVec2 max = ImClamp(ImMax(marqueeStart_, io.MousePos), viewportRect.Min, viewportRect.Max);
+            drawList->AddRectFilled(min, max, ui::GetColorU32(ImGuiCol_Header, 0.3f));
+            drawList->AddRect(min, max, ui::GetColorU32(ImGuiCol_Header));
+        }
+    }
+
+    ea::vector<Drawable*> picked;
+    if (!picker_.GetResult(picked))
+        return;
+
+    if (!pickMarquee_)
+    {
+        SelectClickedDrawable(picked.empty() ? nullptr : picked.front(), pickLeft_, pickRight_, pickAdditive_);
+        return;
+    }
+
+    ea::vector<Node*> nodes;
+    ea::vector<Component*> components;
+    for (Drawable* drawable : picked)
+    {
+        Node* node = drawable->GetNode();
+        if (node == nullptr)
+            continue;
+
+        StringHash componentType;
+        if (node->HasTag("DebugIcon"))
+            componentType = node->GetVar("ComponentType").GetStringHash();
+
+        while (node != nullptr && node->HasTag("__EDITOR_OBJECT__"))
+            node = node->GetParent();
+
+        if (node == nullptr)
+            continue;
+
+        if (node == GetScene())
+        {
+            Component* component = componentType != StringHash::ZERO ? node->GetComponent(componentType) : nullptr;
+            if (component != nullptr && !components.contains(component))
+                components.push_back(component);
+        }
+        else if (!nodes.contains(node))
+            nodes.push_back(node);
+    }
+
+    if (!pickAdditive_)
+        ClearSelection();
+
+    if (nodes.empty() && components.empty())
+        OnNodeSelectionChanged();
+    else
+        Select(nodes, components);
+}
+
+void SceneTab::SelectClickedDrawable(Drawable* drawable, bool left, bool right, bool additive)
+{
+    if (drawable != nullptr && drawable->GetNode() != nullptr)
+    {
+        StringHash componentType;
+        WeakPtr<Node> clickNode(drawable->GetNode());
+
+        if (clickNode->HasTag("DebugIcon"))
+            componentType = clickNode->GetVar("ComponentType").GetStringHash();
+
+        while (!clickNode.Expired() && clickNode->HasTag("__EDITOR_OBJECT__"))
+            clickNode = clickNode->GetParent();
+
+        if (left)
+        {
+            if (!additive)
+                ClearSelection();
+
+            if (clickNode == GetScene())
+            {
+                if (componentType != StringHash::ZERO)
+                    ModifySelection({}, {clickNode->GetComponent(componentType)}, SelectionMode::Toggle);
+            }
+            else
+                ToggleSelection(clickNode);
+        }
+        else if (right)
+        {
+            if (clickNode == GetScene())
+            {
+                if (componentType != StringHash::ZERO)
+                {
+                    Component* component = clickNode->GetComponent(componentType);
+                    if (!IsSelected(component))
+                    {
+                        ClearSelection();
+                        ToggleSelection(component);
+                    }
+                }
+            }
+            else if (!IsSelected(clickNode))
+            {
+                ClearSelection();
+                ToggleSelection(clickNode);
+            }
+            ui::OpenPopupEx(ui::GetID("Node context menu"));
+        }
+    }
+    else
+    {
+        ClearSelection();
+        OnNodeSelectionChanged();
+    }
+}
+
 void SceneTab::RenderToolbarButtons()
 {
     ui::SetCursorPos({4, 4});
@@ -467,6 +583,14 @@ void SceneTab::RenderToolbarButtons()
 
     ui::SameLine(0, 3.f);
 
+    if (ui::EditorToolbarButton(ICON_FA_MOUSE_POINTER, "Pick objects from object ID buffer. Enables marquee selection.", gpuPicking_))
+    {
+        gpuPicking_ ^= true;
+        picker_.Cancel();
+    }
+
+    ui::SameLine(0, 3.f);
+
     SendEvent(E_EDITORTOOLBARBUTTONS);
 
     ui::SameLine(0, 3.f);
@@ -527,61 +651,128 @@ void SceneTab::OnNodeSelectionChanged()
             inspector->Inspect(component, GetScene());
     }
 
+    // Ensure the tree is expanded to the selected node if there is one node selected.
+    if (selectedNodes_.size() == 1 && lastInspectedNode)
+        hierarchy_.ExpandTo(lastInspectedNode);
+
     editor->GetTab<HierarchyTab>()->SetProvider(this);
 }
 
 void SceneTab::RenderHierarchy()
 {
-    if (performRangeSelectionFrame_ != ui::GetFrameCount())
-        selectionRect_ = {ui::GetMousePos(), ui::GetMousePos()};
+    auto* scene = GetScene();
+    if (scene == nullptr)
+        return;
 
-    if (auto* scene = GetScene())
+    hierarchy_.SetScene(scene);
+
+    ui::PushItemWidth(-1);
+    if (ui::InputText("###Filter", &hierarchyFilter_))
+        hierarchy_.SetFilter(hierarchyFilter_);
+    ui::PopItemWidth();
+    if (ui::IsItemHovered())
+        ui::SetTooltip("Filter nodes by name.");
+
+    ui::BeginChild("Scene Hierarchy");
+    ui::PushStyleVar(ImGuiStyleVar_IndentSpacing, 10);
+
+    if (!scrollTo_.Expired())
     {
-        ui::PushStyleVar(ImGuiStyleVar_IndentSpacing, 10);
-        RenderNodeTree(scene);
-        ui::PopStyleVar();
+        hierarchy_.ExpandTo(scrollTo_);
+        unsigned index = hierarchy_.FindRow(scrollTo_);
+        if (index != M_MAX_UNSIGNED)
+            ui::SetScrollY(index * hierarchyRowHeight_ - ui::GetWindowHeight() * 0.5f);
+        scrollTo_ = nullptr;
+    }
+
+    // Only rows scrolled into view are rendered. Rows are not rebuilt while rendering them, scene modifications made by the
+    // rows are picked up on the next frame.
+    const ea::vector<SceneHierarchyRow>& rows = hierarchy_.GetRows();
+    bool openContextMenu = false;
+    ImGuiListClipper clipper(rows.size());
+    while (clipper.Step())
+    {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+            openContextMenu |= RenderHierarchyRow(rows[i], i);
     }
+    if (clipper.ItemsHeight > 0)
+        hierarchyRowHeight_ = clipper.ItemsHeight;
 
-    // Perform range selection on next frame. Only then we can have a rectangle covering selection ends
-    // which we need to do range selection.
-    if (ui::IsMouseClicked(MOUSEB_LEFT) && ui::IsKeyDown(SCANCODE_SHIFT) && !selectedNodes_.empty())
-        performRangeSelectionFrame_ = ui::GetFrameCount() + 1;
+    ui::PopStyleVar();
+
+    if (openContextMenu)
+        ui::OpenPopup("Node context menu");
+    RenderNodeContextMenu();
+
+    ui::EndChild();
 }
 
-void SceneTab::RenderNodeTree(Node* node)
+bool SceneTab::RenderHierarchyRow(const SceneHierarchyRow& row, unsigned index)
 {
+    Node* node = row.node_;
     if (node == nullptr)
-        return;
+    {
+        // Node was removed this frame, keep the row height for the clipper.
+        ui::NewLine();
+        return false;
+    }
 
-    ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_OpenOnArrow;
-    if (node->GetParent() == nullptr)
-        flags |= ImGuiTreeNodeFlags_DefaultOpen;
+    ui::SetCursorPosX(ui::GetCursorPosX() + row.depth_ * ui::GetStyle().IndentSpacing);
 
-    if (node->IsTemporary() || node->HasTag("__EDITOR_OBJECT__"))
-        return;
+    bool openContextMenu = false;
+    if (Component* component = row.component_)
+    {
+        ui::PushID(component);
 
-    if (node == scrollTo_.Get())
-        ui::SetScrollHereY();
+        ui::Image(component->GetTypeName());
+        ui::SameLine();
 
-    ea::string name = node->GetName().empty() ? ToString("%s %d", node->GetTypeName().c_str(), node->GetID()) : node->GetName();
+        bool selected = selectedComponents_.contains(row.component_);
+        ui::Selectable(component->GetTypeName().c_str(), selected);
+
+        if (ui::IsItemHovered(ImGuiHoveredFlags_AllowWhenBlockedByPopup))
+        {
+            if (ui::IsMouseClicked(MOUSEB_LEFT))
+            {
+                if (!ui::IsKeyDown(SCANCODE_CTRL))
+                    ClearSelection();
+                Select(component);
+            }
+            else if (ui::IsMouseReleased(MOUSEB_RIGHT) && ImLengthSqr(ui::GetMouseDragDelta(MOUSEB_RIGHT)) == 0.0f)
+            {
+                if (!IsSelected(component))
+                {
+                    ClearSelection();
+                    Select(component);
+                }
+                openContextMenu = true;
+            }
+        }
+
+        ui::PopID();
+        return openContextMenu;
+    }
+
+    ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_NoTreePushOnOpen;
+    // Filtered rows are a flat list of matches.
+    const bool isLeaf = !hierarchy_.GetFilter().empty() || (node->GetNumChildren() == 0 && node->GetNumComponents() == 0);
+    if (isLeaf)
+        flags |= ImGuiTreeNodeFlags_Leaf;
     if (IsSelected(node))
         flags |= ImGuiTreeNodeFlags_Selected;
 
+    ea::string name = node->GetName().empty() ? ToString("%s %d", node->GetTypeName().c_str(), node->GetID()) : node->GetName();
+
     ui::Image("Node");
     ui::SameLine();
     ui::PushID((void*)node);
-    auto opened = ui::TreeNodeEx(name.c_str(), flags);
-    ImRect treeNodeRect = {ui::GetItemRectMin(), ui::GetItemRectMax()};
-    auto it = openHierarchyNodes_.find(node);
-    if (it != openHierarchyNodes_.end())
-    {
-        if (!opened)
-        {
-            ui::OpenTreeNode(ui::GetCurrentWindow()->GetID(name.c_str()));
-            opened = true;
-        }
-        openHierarchyNodes_.erase(it);
-    }
+
+    const bool expanded = hierarchy_.IsExpanded(node);
+    if (!isLeaf)
+        ui::SetNextItemOpen(expanded);
+    bool opened = ui::TreeNodeEx(name.c_str(), flags);
+    if (!isLeaf && opened != expanded)
+        hierarchy_.SetExpanded(node, opened);
 
     if (ui::BeginDragDropSource())
     {
@@ -599,37 +790,42 @@ void SceneTab::RenderNodeTree(Node* node)
             if (child && child != node)
             {
                 node->AddChild(child);
-                if (!opened)
-                    openHierarchyNodes_.push_back(node);
+                hierarchy_.SetExpanded(node, true);
             }
         }
         ui::EndDragDropTarget();
     }
 
-    if (!opened)
-    {
-        // If TreeNode above is opened, it pushes it's label as an ID to the stack. However if it is not open then no
-        // ID is pushed. This creates a situation where context menu is not properly attached to said tree node due to
-        // missing ID on the stack. To correct this we ensure that ID is always pushed. This allows us to show context
-        // menus even for closed tree nodes.
-        ui::PushID(name.c_str());
-    }
-
-    // Popup may delete node. Weak reference will convey that information.
-    WeakPtr<Node> nodeRef(node);
-
     if (ui::IsItemHovered(ImGuiHoveredFlags_AllowWhenBlockedByPopup))
     {
         if (ui::IsMouseClicked(MOUSEB_LEFT))
         {
-            // Select single node.
-            if (!ui::IsKeyDown(SCANCODE_SHIFT) && !ui::IsKeyDown(SCANCODE_CTRL))
-                ClearSelection();
-
-            if (ui::IsKeyDown(SCANCODE_SHIFT))
-                Select(node);
+            // Range-select by shift-clicking an item.
+            unsigned anchorIndex = ui::IsKeyDown(SCANCODE_SHIFT) && !rangeSelectionAnchor_.Expired() ?
+                hierarchy_.FindRow(rangeSelectionAnchor_) : M_MAX_UNSIGNED;
+            if (anchorIndex != M_MAX_UNSIGNED)
+            {
+                const ea::vector<SceneHierarchyRow>& rows = hierarchy_.GetRows();
+                ea::vector<Node*> nodes;
+                for (unsigned i = Min(anchorIndex, index); i <= Max(anchorIndex, index) && i < rows.size(); ++i)
+                {
+                    if (!rows[i].component_ && rows[i].node_)
+                        nodes.push_back(rows[i].node_);
+                }
+                Select(nodes);
+            }
             else
-                ToggleSelection(node);
+            {
+                // Select single node.
+                if (!ui::IsKeyDown(SCANCODE_SHIFT) && !ui::IsKeyDown(SCANCODE_CTRL))
+                    ClearSelection();
+
+                if (ui::IsKeyDown(SCANCODE_SHIFT))
+                    Select(node);
+                else
+                    ToggleSelection(node);
+                rangeSelectionAnchor_ = node;
+            }
         }
         else if (ui::IsMouseReleased(MOUSEB_RIGHT) && ImLengthSqr(ui::GetMouseDragDelta(MOUSEB_RIGHT)) == 0.0f)
         {
@@ -638,95 +834,12 @@ void SceneTab::RenderNodeTree(Node* node)
                 ClearSelection();
                 ToggleSelection(node);
             }
-            ui::OpenPopupEx(ui::GetID("Node context menu"));
+            openContextMenu = true;
         }
     }
 
-    if (IsSelected(node))
-        selectionRect_.Add(treeNodeRect);
-
-    // Range-select by shift-clicking an item.
-    if (performRangeSelectionFrame_ == ui::GetFrameCount())
-    {
-        if (selectionRect_.Contains(treeNodeRect.Min))
-        {
-            Select(node);
-            selectionRect_.Add(treeNodeRect.Min);
-        }
-    }
-
-    RenderNodeContextMenu();
-
-    if (opened)
-    {
-        if (!nodeRef.Expired())
-        {
-            ea::vector<SharedPtr<Component>> components = node->GetComponents();
-            for (const auto& component: components)
-            {
-                if (component->IsTemporary())
-                    continue;
-
-                ui::PushID(component);
-
-                ui::Image(component->GetTypeName());
-                ui::SameLine();
-
-                bool selected = selectedComponents_.contains(component);
-                ui::Selectable(component->GetTypeName().c_str(), selected);
-
-                if (ui::IsItemHovered(ImGuiHoveredFlags_AllowWhenBlockedByPopup))
-                {
-                    if (ui::IsMouseClicked(MOUSEB_LEFT))
-                    {
-                        if (!ui::IsKeyDown(SCANCODE_CTRL))
-                            ClearSelection();
-                        Select(component);
-                    }
-                    else if (ui::IsMouseReleased(MOUSEB_RIGHT) && ImLengthSqr(ui::GetMouseDragDelta(MOUSEB_RIGHT)) == 0.0f)
-                    {
-                        if (!IsSelected(component))
-                        {
-                            ClearSelection();
-                            Select(component);
-                        }
-                        ui::OpenPopupEx(ui::GetID("Node context menu"));
-                    }
-                }
-
-
-                RenderNodeContextMenu();
-
-                ui::PopID();
-            }
-
-            // Do not use element->GetChildren() because child may be deleted during this loop.
-            ea::vector<Node*> children;
-            node->GetChildren(children);
-            for (Node* child : children)
-            {
-                // ensure the tree is expanded to the currently selected node if there is one node selected.
-                if (selectedNodes_.size() == 1)
-                {
-                    for (auto& selectedNode : selectedNodes_)
-                    {
-                        if (selectedNode.Expired())
-                            continue;
-
-                        if (selectedNode->IsChildOf(child))
-                            ui::SetNextItemOpen(true);
-                    }
-                }
-
-                //recursive call.
-                RenderNodeTree(child);
-            }
-        }
-        ui::TreePop();
-    }
-    else
-        ui::PopID();
     ui::PopID();
+    return openContextMenu;
 }
 
 void SceneTab::OnActiveUpdate()
@@ -925,8 +1038,7 @@ void SceneTab::RenderNodeContextMenu()
                     if (!selectedNode.Expired())
                     {
                         newNodes.push_back(selectedNode->CreateChild(EMPTY_STRING, alternative ? LOCAL : REPLICATED));
-                        openHierarchyNodes_.push_back(selectedNode);
-                        openHierarchyNodes_.push_back(newNodes.back());
+                        hierarchy_.SetExpanded(selectedNode, true);
                         scrollTo_ = newNodes.back();
                     }
                 }
@@ -964,7 +1076,7 @@ void SceneTab::RenderNodeContextMenu()
                                     {
                                         if (selectedNode->CreateComponent(StringHash(component), alternative ? LOCAL : REPLICATED))
                                         {
-                                            openHierarchyNodes_.push_back(selectedNode);
+                                            hierarchy_.SetExpanded(selectedNode, true);
                                             OnNodeSelectionChanged();
                                         }
                                     }
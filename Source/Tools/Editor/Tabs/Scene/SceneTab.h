@@ -27,9 +27,11 @@
 #include <Urho3D/Scene/SceneManager.h>
 #include <Toolbox/SystemUI/AttributeInspector.h>
 #include <Toolbox/SystemUI/Gizmo.h>
+#include <Toolbox/Graphics/GPUPicker.h>
 #include <Toolbox/Graphics/SceneView.h>
 #include "Tabs/BaseResourceTab.h"
 #include "Tabs/Scene/SceneClipboard.h"
+#include "Tabs/Scene/SceneHierarchy.h"
 #include "Tabs/UI/RootUIElement.h"
 
 
@@ -173,8 +175,8 @@ public:
     void Close() override;
 
 protected:
-    /// Render scene hierarchy window starting from specified node.
-    void RenderNodeTree(Node* node);
+    /// Render a row of scene hierarchy window. Returns true if context menu should be opened.
+    bool RenderHierarchyRow(const SceneHierarchyRow& row, unsigned index);
     /// Called when node selection changes.
     void OnNodeSelectionChanged();
     /// Render content of the tab window.
@@ -183,6 +185,10 @@ protected:
     void OnUpdate(VariantMap& args);
     /// Render context menu of a scene node.
     void RenderNodeContextMenu();
+    /// Handle object picking and marquee selection in scene viewport.
+    void UpdateViewportSelection(const ImRect& viewportRect);
+    /// Select drawable picked by mouse click in scene viewport.
+    void SelectClickedDrawable(Drawable* drawable, bool left, bool right, bool additive);
     /// Inserts extra editor objects for representing some components.
     void OnComponentAdded(VariantMap& args);
     /// Removes extra editor objects that were used for representing some components.
@@ -232,8 +238,30 @@ protected:
     bool isClickedLeft_ = false;
     /// Flag indicating that right mouse button was clicked on scene viewport.
     bool isClickedRight_ = false;
-    /// Nodes whose entries in hierarchy tree should be opened on next frame.
-    ea::vector<Node*> openHierarchyNodes_;
+    /// Renders object IDs of scene viewport for picking.
+    GPUPicker picker_;
+    /// Flag indicating that objects are picked from object ID buffer instead of raycasting octree.
+    bool gpuPicking_ = true;
+    /// Flag indicating that pending pick was requested by left mouse button click.
+    bool pickLeft_ = false;
+    /// Flag indicating that pending pick was requested by right mouse button click.
+    bool pickRight_ = false;
+    /// Flag indicating that pending pick adds to the current selection.
+    bool pickAdditive_ = false;
+    /// Flag indicating that pending pick selects everything in marquee rectangle.
+    bool pickMarquee_ = false;
+    /// Flag indicating that marquee selection is being dragged.
+    bool isMarqueeActive_ = false;
+    /// Screen position where marquee selection started.
+    ImVec2 marqueeStart_{};
+    /// Flattened scene hierarchy of the rows to display.
+    SceneHierarchy hierarchy_;
+    /// Scene hierarchy name filter.
+    ea::string hierarchyFilter_;
+    /// Height of a scene hierarchy row, measured when rendering.
+    float hierarchyRowHeight_ = 16.0f;
+    /// Node that was last clicked in scene hierarchy. Shift-clicking selects the rows between it and the clicked node.
+    WeakPtr<Node> rangeSelectionAnchor_;
     /// Node to scroll to on next frame.
     WeakPtr<Node> scrollTo_;
     /// Selected camera preview texture.
@@ -254,10 +282,6 @@ protected:
     SharedPtr<XMLFile> defaultStyle_;
     ///
     bool debugHudVisible_ = false;
-    /// Rectangle encompassing all selected nodes.
-    ImRect selectionRect_{};
-    /// Frame on which range selection will be performed.
-    int performRangeSelectionFrame_ = -1;
     /// We have to use our own because drawlist splitter may be used by other widgets.
     ImDrawListSplitter viewportSplitter_{};
     /// Distance from the camera that manipulator will rotate around.
@@ -0,0 +1,503 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Command line utility always uses console.
+#define URHO3D_WIN32_CONSOLE
+
+#include <Urho3D/Core/CommandLine.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/Core/Variant.h>
+#include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/Engine/Application.h>
+#include <Urho3D/Engine/EngineDefs.h>
+#include <Urho3D/IO/ArchiveSerialization.h>
+#include <Urho3D/IO/BinaryArchive.h>
+#include <Urho3D/IO/Log.h>
+#include <Urho3D/IO/MemoryBuffer.h>
+#include <Urho3D/IO/VectorBuffer.h>
+#include <Urho3D/Math/BoundingBox.h>
+#include <Urho3D/Math/Matrix3x4.h>
+#include <Urho3D/Math/StringHash.h>
+#include <Urho3D/Resource/JSONFile.h>
+
+#include <EASTL/sort.h>
+
+#include <atomic>
+#include <cstring>
+#include <cstdio>
+
+
+using namespace Urho3D;
+
+/// Number of timed repetitions of every case. The median is reported.
+static const unsigned NUM_REPETITIONS = 7;
+
+/// Prevents the compiler from optimizing away benchmarked computations.
+static volatile unsigned benchmarkSink = 0;
+
+/// Consume a value so that its computation is not optimized away.
+template <class T> static void Consume(const T& value)
+{
+    unsigned bits = 0;
+    memcpy(&bits, &value, Min<unsigned>(sizeof(bits), sizeof(value)));
+    benchmarkSink = benchmarkSink + bits;
+}
+
+/// Plain data serialized by the archive round trip case.
+struct ArchiveTestData
+{
+    /// Integer value.
+    int integer_{};
+    /// Float value.
+    float float_{};
+    /// Vector value.
+    Vector3 vector_;
+    /// String value.
+    ea::string string_;
+    /// Array of floats.
+    ea::vector<float> floats_;
+};
+
+/// Serialize test data.
+static bool SerializeValue(Archive& archive, const char* name, ArchiveTestData& value)
+{
+    if (ArchiveBlock block = archive.OpenUnorderedBlock(name))
+    {
+        SerializeValue(archive, "Integer", value.integer_);
+        SerializeValue(archive, "Float", value.float_);
+        SerializeValue(archive, "Vector", value.vector_);
+        SerializeValue(archive, "String", value.string_);
+        SerializeVector(archive, "Floats", "Float", value.floats_);
+        return true;
+    }
+    return false;
+}
+
+/// Result of one benchmark case.
+struct MicroBenchmarkResult
+{
+    /// Case name.
+    ea::string name_;
+    /// Median time of one operation in nanoseconds.
+    double nsPerOp_{};
+    /// Fastest repetition time of one operation in nanoseconds.
+    double minNsPerOp_{};
+    /// Number of operations per repetition.
+    unsigned iterations_{};
+};
+
+/// Runs microbenchmarks of hot engine primitives and prints the time per operation.
+class MicroBenchmarkApplication : public Application
+{
+    URHO3D_OBJECT(MicroBenchmarkApplication, Application);
+public:
+    /// Benchmark case body. Performs the operation the given number of times.
+    using CaseFunction = ea::function<void(unsigned iterations)>;
+
+    explicit MicroBenchmarkApplication(Context* context) : Application(context)
+    {
+    }
+
+    void Setup() override
+    {
+        engineParameters_[EP_ENGINE_CLI_PARAMETERS] = false;
+        engineParameters_[EP_HEADLESS] = true;
+        engineParameters_[EP_SOUND] = false;
+        engineParameters_[EP_LOG_LEVEL] = LOG_WARNING;
+        engineParameters_[EP_WORKER_THREADS] = true;
+
+        auto& app = GetCommandLineParser();
+        app.add_option("-f,--filter", filter_, "Run only cases whose name contains the filter.");
+        app.add_option("-t,--min-time", minTime_, "Minimum duration of one repetition in seconds.");
+        app.add_option("-o,--output", outputFile_, "Save results as JSON into the file.");
+    }
+
+    void Start() override
+    {
+        RegisterCases();
+
+        printf("%-40s %14s %14s %12s\n", "Case", "ns/op", "min ns/op", "iterations");
+        for (const auto& [name, function] : cases_)
+        {
+            if (!filter_.empty() && !name.contains(filter_))
+                continue;
+
+            const MicroBenchmarkResult result = RunCase(name, function);
+            printf("%-40s %14.2f %14.2f %12u\n", result.name_.c_str(), result.nsPerOp_, result.minNsPerOp_, result.iterations_);
+            fflush(stdout);
+            results_.push_back(result);
+        }
+
+        if (!outputFile_.empty() && !SaveResults())
+        {
+            ErrorExit(Format("Failed to save results to {}", outputFile_));
+            return;
+        }
+
+        engine_->Exit();
+    }
+
+private:
+    /// Add a benchmark case.
+    void AddCase(const ea::string& name, CaseFunction function) { cases_.emplace_back(name, ea::move(function)); }
+
+    /// Time the case. The number of iterations is doubled until a repetition takes at least the minimum time, which
+    /// keeps the timer resolution and the loop overhead negligible.
+    MicroBenchmarkResult RunCase(const ea::string& name, const CaseFunction& function)
+    {
+        const long long minUSec = static_cast<long long>(minTime_ * 1000000.0);
+        HiresTimer timer;
+
+        unsigned iterations = 1;
+        while (true)
+        {
+            timer.Reset();
+            function(iterations);
+            const long long elapsed = timer.GetUSec(false);
+            if (elapsed >= minUSec || iterations >= (1u << 30))
+                break;
+            // Jump close to the target when the measurement is meaningful, double otherwise
+            iterations = elapsed > 1000
+                ? static_cast<unsigned>(Min(iterations * 1.2 * minUSec / elapsed, double(1u << 30)))
+                : iterations * 2;
+        }
+
+        double times[NUM_REPETITIONS];
+        for (double& time : times)
+        {
+            timer.Reset();
+            function(iterations);
+            time = timer.GetUSec(false) * 1000.0 / iterations;
+        }
+        ea::sort(ea::begin(times), ea::end(times));
+
+        MicroBenchmarkResult result;
+        result.name_ = name;
+        result.nsPerOp_ = times[NUM_REPETITIONS / 2];
+        result.minNsPerOp_ = times[0];
+        result.iterations_ = iterations;
+        return result;
+    }
+
+    /// Save results as JSON.
+    bool SaveResults() const
+    {
+        JSONFile jsonFile(context_);
+        JSONValue cases(JSON_ARRAY);
+        for (const MicroBenchmarkResult& result : results_)
+        {
+            JSONValue value;
+            value.Set("name", result.name_);
+            value.Set("nsPerOp", result.nsPerOp_);
+            value.Set("minNsPerOp", result.minNsPerOp_);
+            value.Set("iterations", result.iterations_);
+            cases.Push(value);
+        }
+        jsonFile.GetRoot().Set("cases", cases);
+        return jsonFile.SaveFile(outputFile_);
+    }
+
+    /// Register all benchmark cases.
+    void RegisterCases()
+    {
+        RegisterVariantCases();
+        RegisterMathCases();
+        RegisterSerializationCases();
+        RegisterWorkQueueCases();
+    }
+
+    /// Register Variant, VariantMap and StringHash cases.
+    void RegisterVariantCases()
+    {
+        AddCase("Variant/CopyInt", [](unsigned iterations)
+        {
+            const Variant source(42);
+            Variant target;
+            for (unsigned i = 0; i < iterations; ++i)
+            {
+                target = source;
+                Consume(target.GetInt());
+            }
+        });
+
+        AddCase("Variant/CopyString", [](unsigned iterations)
+        {
+            const Variant source("A string long enough to not fit into small buffer");
+            Variant target;
+            for (unsigned i = 0; i < iterations; ++i)
+            {
+                target = source;
+                Consume(target.GetString().size());
+            }
+        });
+
+        AddCase("Variant/CopyMatrix3x4", [](unsigned iterations)
+        {
+            const Variant source(Matrix3x4::IDENTITY);
+            Variant target;
+            for (unsigned i = 0; i < iterations; ++i)
+            {
+                target = source;
+                Consume(target.GetMatrix3x4().m00_);
+            }
+        });
+
+        AddCase("Variant/CompareString", [](unsigned iterations)
+        {
+            const Variant first("A string long enough to not fit into small buffer");
+            const Variant second("A string long enough to not fit into small buffer");
+            for (unsigned i = 0; i < iterations; ++i)
+                Consume(first == second);
+        });
+
+        AddCase("Variant/CompareVector3", [](unsigned iterations)
+        {
+            const Variant first(Vector3(1.0f, 2.0f, 3.0f));
+            const Variant second(Vector3(1.0f, 2.0f, 3.0f));
+            for (unsigned i = 0; i < iterations; ++i)
+                Consume(first == second);
+        });
+
+        // Keys are hashed up front so that only the map is measured
+        auto keys = ea::make_shared<ea::vector<StringHash>>();
+        for (unsigned i = 0; i < 16; ++i)
+            keys->push_back(StringHash(Format("Parameter{}", i)));
+
+        AddCase("VariantMap/Insert16", [keys](unsigned iterations)
+        {
+            for (unsigned i = 0; i < iterations; ++i)
+            {
+                VariantMap map;
+                for (StringHash key : *keys)
+                    map[key] = static_cast<int>(i);
+                Consume(map.size());
+            }
+        });
+
+        AddCase("VariantMap/Find16", [keys](unsigned iterations)
+        {
+            VariantMap map;
+            for (StringHash key : *keys)
+                map[key] = 1;
+            for (unsigned i = 0; i < iterations; ++i)
+                Consume(map.find((*keys)[i % keys->size()])->second.GetInt());
+        });
+
+        // Strings are built at runtime so that hashing is not evaluated at compile time
+        auto names = ea::make_shared<ea::vector<ea::string>>();
+        for (unsigned i = 0; i < 16; ++i)
+            names->push_back(Format("SceneNode/Component/Attribute{}", i));
+
+        AddCase("StringHash/Construct", [names](unsigned iterations)
+        {
+            for (unsigned i = 0; i < iterations; ++i)
+                Consume(StringHash((*names)[i % names->size()]).Value());
+        });
+    }
+
+    /// Register Matrix3x4 and BoundingBox cases.
+    void RegisterMathCases()
+    {
+        AddCase("Matrix3x4/Multiply", [](unsigned iterations)
+        {
+            const Matrix3x4 transform(Vector3(1.0f, 2.0f, 3.0f), Quaternion(10.0f, 20.0f, 30.0f), 1.0f);
+            Matrix3x4 result = Matrix3x4::IDENTITY;
+            for (unsigned i = 0; i < iterations; ++i)
+            {
+                result = result * transform;
+                // Keep the values bounded
+                if ((i & 1023) == 1023)
+                    result = Matrix3x4::IDENTITY;
+            }
+            Consume(result.m03_);
+        });
+
+        AddCase("Matrix3x4/MultiplyVector3", [](unsigned iterations)
+        {
+            const Matrix3x4 transform(Vector3(1.0f, 2.0f, 3.0f), Quaternion(10.0f, 20.0f, 30.0f), 1.0f);
+            Vector3 point(1.0f, 1.0f, 1.0f);
+            for (unsigned i = 0; i < iterations; ++i)
+            {
+                point = transform * point;
+                if ((i & 1023) == 1023)
+                    point = Vector3::ONE;
+            }
+            Consume(point.x_);
+        });
+
+        AddCase("BoundingBox/MergePoint", [](unsigned iterations)
+        {
+            BoundingBox box;
+            for (unsigned i = 0; i < iterations; ++i)
+                box.Merge(Vector3(static_cast<float>(i & 255), static_cast<float>(i & 127), static_cast<float>(i & 63)));
+            Consume(box.max_.x_);
+        });
+
+        AddCase("BoundingBox/MergeBox", [](unsigned iterations)
+        {
+            BoundingBox box;
+            for (unsigned i = 0; i < iterations; ++i)
+            {
+                const Vector3 center(static_cast<float>(i & 255), 0.0f, static_cast<float>(i & 63));
+                box.Merge(BoundingBox(center - Vector3::ONE, center + Vector3::ONE));
+            }
+            Consume(box.max_.x_);
+        });
+
+        AddCase("BoundingBox/Transformed", [](unsigned iterations)
+        {
+            const Matrix3x4 transform(Vector3(1.0f, 2.0f, 3.0f), Quaternion(10.0f, 20.0f, 30.0f), 2.0f);
+            const BoundingBox box(-Vector3::ONE, Vector3::ONE);
+            for (unsigned i = 0; i < iterations; ++i)
+                Consume(box.Transformed(transform).max_.x_);
+        });
+    }
+
+    /// Register archive and buffer cases.
+    void RegisterSerializationCases()
+    {
+        Context* context = context_;
+
+        auto data = ea::make_shared<ArchiveTestData>();
+        data->integer_ = 42;
+        data->float_ = 0.5f;
+        data->vector_ = Vector3(1.0f, 2.0f, 3.0f);
+        data->string_ = "Serialized string";
+        data->floats_.resize(64, 1.0f);
+
+        AddCase("BinaryArchive/RoundTrip", [context, data](unsigned iterations)
+        {
+            VectorBuffer buffer;
+            ArchiveTestData result;
+            for (unsigned i = 0; i < iterations; ++i)
+            {
+                buffer.Clear();
+                BinaryOutputArchive outputArchive(context, buffer);
+                SerializeValue(outputArchive, "Data", *data);
+
+                buffer.Seek(0);
+                BinaryInputArchive inputArchive(context, buffer);
+                SerializeValue(inputArchive, "Data", result);
+            }
+            Consume(result.integer_);
+        });
+
+        auto bytes = ea::make_shared<ByteVector>();
+        {
+            VectorBuffer buffer;
+            for (unsigned i = 0; i < 1024; ++i)
+                buffer.WriteVector3(Vector3(static_cast<float>(i), 0.0f, 1.0f));
+            *bytes = buffer.GetBuffer();
+        }
+
+        AddCase("MemoryBuffer/ReadVector3", [bytes](unsigned iterations)
+        {
+            MemoryBuffer buffer(*bytes);
+            Vector3 sum;
+            for (unsigned i = 0; i < iterations; ++i)
+            {
+                if (buffer.IsEof())
+                    buffer.Seek(0);
+                sum += buffer.ReadVector3();
+            }
+            Consume(sum.x_);
+        });
+
+        AddCase("VectorBuffer/ReadVector3", [bytes](unsigned iterations)
+        {
+            VectorBuffer buffer(*bytes);
+            Vector3 sum;
+            for (unsigned i = 0; i < iterations; ++i)
+            {
+                if (buffer.IsEof())
+                    buffer.Seek(0);
+                sum += buffer.ReadVector3();
+            }
+            Consume(sum.x_);
+        });
+
+        AddCase("VectorBuffer/WriteVector3", [](unsigned iterations)
+        {
+            VectorBuffer buffer;
+            for (unsigned i = 0; i < iterations; ++i)
+            {
+                if ((i & 1023) == 0)
+                    buffer.Clear();
+                buffer.WriteVector3(Vector3(static_cast<float>(i), 0.0f, 1.0f));
+            }
+            Consume(buffer.GetSize());
+        });
+    }
+
+    /// Register WorkQueue cases.
+    void RegisterWorkQueueCases()
+    {
+        WorkQueue* workQueue = GetSubsystem<WorkQueue>();
+
+        AddCase("WorkQueue/SubmitComplete", [workQueue](unsigned iterations)
+        {
+            std::atomic<unsigned> counter{0};
+            for (unsigned i = 0; i < iterations; ++i)
+            {
+                workQueue->Submit([&counter](unsigned) { counter.fetch_add(1, std::memory_order_relaxed); });
+                workQueue->Complete(M_MAX_UNSIGNED);
+            }
+            Consume(counter.load());
+        });
+
+        AddCase("WorkQueue/Submit64Complete", [workQueue](unsigned iterations)
+        {
+            std::atomic<unsigned> counter{0};
+            for (unsigned i = 0; i < iterations; ++i)
+            {
+                for (unsigned j = 0; j < 64; ++j)
+                    workQueue->Submit([&counter](unsigned) { counter.fetch_add(1, std::memory_order_relaxed); });
+                workQueue->Complete(M_MAX_UNSIGNED);
+            }
+            Consume(counter.load());
+        });
+
+        AddCase("WorkQueue/AddWorkItemComplete", [workQueue](unsigned iterations)
+        {
+            std::atomic<unsigned> counter{0};
+            for (unsigned i = 0; i < iterations; ++i)
+            {
+                workQueue->AddWorkItem([&counter]() { counter.fetch_add(1, std::memory_order_relaxed); }, M_MAX_UNSIGNED);
+                workQueue->Complete(M_MAX_UNSIGNED);
+            }
+            Consume(counter.load());
+        });
+    }
+
+    /// Substring filter of case names.
+    ea::string filter_;
+    /// Minimum duration of one repetition in seconds.
+    double minTime_{0.05};
+    /// JSON output file name.
+    ea::string outputFile_;
+    /// Registered cases.
+    ea::vector<ea::pair<ea::string, CaseFunction>> cases_;
+    /// Results of executed cases.
+    ea::vector<MicroBenchmarkResult> results_;
+};
+
+URHO3D_DEFINE_APPLICATION_MAIN(MicroBenchmarkApplication);
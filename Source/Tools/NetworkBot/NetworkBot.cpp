@@ -0,0 +1,179 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "NetworkBot.h"
+
+#include <Urho3D/Core/CoreEvents.h>
+#include <Urho3D/Math/Random.h>
+#include <Urho3D/Network/Connection.h>
+#include <Urho3D/Network/Network.h>
+#include <Urho3D/Network/NetworkEvents.h>
+#include <Urho3D/Network/Protocol.h>
+#include <Urho3D/Scene/Scene.h>
+
+namespace Urho3D
+{
+
+/// Interval between round trip time and bandwidth samples in milliseconds.
+static const unsigned ROUND_TRIP_SAMPLE_MSEC = 1000;
+
+/// Return whether the message carries scene replication.
+static bool IsReplicationMessage(int msgID)
+{
+    return msgID >= MSG_CREATENODE && msgID <= MSG_REMOVECOMPONENT;
+}
+
+NetworkBot::NetworkBot(Context* context, unsigned index, Network* network) :
+    Object(context),
+    index_(index),
+    network_(network ? network : MakeShared<Network>(context).Get()),
+    scene_(MakeShared<Scene>(context))
+{
+    SubscribeToEvent(network_, E_SERVERCONNECTED, URHO3D_HANDLER(NetworkBot, HandleServerConnected));
+    SubscribeToEvent(network_, E_CONNECTFAILED, URHO3D_HANDLER(NetworkBot, HandleConnectFailed));
+    SubscribeToEvent(network_, E_SERVERDISCONNECTED, URHO3D_HANDLER(NetworkBot, HandleServerDisconnected));
+    SubscribeToEvent(network_, E_NETWORKUPDATE, URHO3D_HANDLER(NetworkBot, HandleNetworkUpdate));
+    SubscribeToEvent(E_UPDATE, URHO3D_HANDLER(NetworkBot, HandleUpdate));
+}
+
+NetworkBot::~NetworkBot()
+{
+    Disconnect();
+}
+
+bool NetworkBot::Connect(const ea::string& address, unsigned short port)
+{
+    VariantMap identity;
+    identity["BotIndex"] = index_;
+
+    connectTimer_.Reset();
+    active_ = network_->Connect(address, port, scene_, identity);
+    if (!active_)
+        stats_.connectFailed_ = true;
+    return active_;
+}
+
+void NetworkBot::Disconnect()
+{
+    if (active_)
+        network_->Disconnect();
+    active_ = false;
+}
+
+Connection* NetworkBot::GetConnection() const
+{
+    return active_ ? network_->GetServerConnection() : nullptr;
+}
+
+void NetworkBot::HandleServerConnected(StringHash eventType, VariantMap& eventData)
+{
+    stats_.connected_ = true;
+    stats_.connectTime_ = connectTimer_.GetUSec(false) / 1000.0f;
+    roundTripTimer_.Reset();
+    serverUpdateTimer_.Reset();
+}
+
+void NetworkBot::HandleConnectFailed(StringHash eventType, VariantMap& eventData)
+{
+    stats_.connectFailed_ = true;
+    active_ = false;
+}
+
+void NetworkBot::HandleServerDisconnected(StringHash eventType, VariantMap& eventData)
+{
+    if (stats_.connected_)
+        stats_.disconnected_ = true;
+    active_ = false;
+}
+
+void NetworkBot::HandleNetworkUpdate(StringHash eventType, VariantMap& eventData)
+{
+    Connection* connection = GetConnection();
+    if (!connection || !connection->IsSceneLoaded())
+        return;
+
+    UpdateControls(1.0f / network_->GetUpdateFps());
+    connection->SetControls(controls_);
+    ++stats_.controlsSent_;
+}
+
+void NetworkBot::HandleUpdate(StringHash eventType, VariantMap& eventData)
+{
+    Connection* connection = GetConnection();
+    if (!connection || !stats_.connected_)
+        return;
+
+    if (!stats_.sceneLoaded_ && connection->IsSceneLoaded())
+    {
+        stats_.sceneLoaded_ = true;
+        stats_.sceneLoadTime_ = connectTimer_.GetUSec(false) / 1000.0f;
+        serverUpdateTimer_.Reset();
+    }
+
+    // Network processes incoming messages at the beginning of the frame, so any growth of the replication message
+    // count since the previous frame means that a server update arrived
+    unsigned replicationMessages = 0;
+    stats_.messagesIn_ = 0;
+    stats_.bytesIn_ = 0;
+    for (const auto& [msgID, traffic] : connection->GetMessageStats())
+    {
+        stats_.messagesIn_ += traffic.messagesIn_;
+        stats_.bytesIn_ += traffic.bytesIn_;
+        if (IsReplicationMessage(msgID))
+            replicationMessages += traffic.messagesIn_;
+    }
+    if (replicationMessages != lastReplicationMessages_)
+    {
+        const float interval = serverUpdateTimer_.GetUSec(true) / 1000.0f;
+        // The first update only marks the start of replication
+        if (lastReplicationMessages_ != 0)
+        {
+            ++stats_.numServerUpdates_;
+            stats_.serverUpdateIntervalSum_ += interval;
+            stats_.maxServerUpdateInterval_ = Max(stats_.maxServerUpdateInterval_, interval);
+        }
+        lastReplicationMessages_ = replicationMessages;
+    }
+
+    if (roundTripTimer_.GetMSec(false) >= ROUND_TRIP_SAMPLE_MSEC)
+    {
+        stats_.roundTripTimes_.push_back(connection->GetRoundTripTime());
+        stats_.bytesInPerSec_.push_back(connection->GetBytesInPerSec());
+        stats_.bytesOutPerSec_.push_back(connection->GetBytesOutPerSec());
+        roundTripTimer_.Reset();
+    }
+}
+
+void NetworkBot::UpdateControls(float timeStep)
+{
+    inputTimer_ -= timeStep;
+    if (inputTimer_ <= 0.0f)
+    {
+        inputTimer_ += inputInterval_;
+        controls_.buttons_ = Rand() & buttonMask_;
+        yawRate_ = Random(-90.0f, 90.0f);
+    }
+
+    controls_.yaw_ += yawRate_ * timeStep;
+}
+
+}
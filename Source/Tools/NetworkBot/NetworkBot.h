@@ -0,0 +1,146 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include <Urho3D/Core/Object.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/Input/Controls.h>
+
+namespace Urho3D
+{
+
+class Connection;
+class Network;
+class Scene;
+
+/// Statistics collected by a network bot.
+struct NetworkBotStats
+{
+    /// Whether the connection has been established.
+    bool connected_{};
+    /// Whether the connection attempt failed.
+    bool connectFailed_{};
+    /// Whether the server dropped the connection after it was established.
+    bool disconnected_{};
+    /// Whether the replicated scene has been loaded.
+    bool sceneLoaded_{};
+    /// Time from the connection attempt to the connection in milliseconds.
+    float connectTime_{};
+    /// Time from the connection attempt to the loaded scene in milliseconds.
+    float sceneLoadTime_{};
+    /// Round trip times sampled once per second, in milliseconds.
+    ea::vector<float> roundTripTimes_;
+    /// Incoming bandwidth sampled once per second, in bytes per second.
+    ea::vector<float> bytesInPerSec_;
+    /// Outgoing bandwidth sampled once per second, in bytes per second.
+    ea::vector<float> bytesOutPerSec_;
+    /// Number of frames during which replication messages arrived, i.e. observed server network updates.
+    unsigned numServerUpdates_{};
+    /// Sum of intervals between observed server updates in milliseconds.
+    double serverUpdateIntervalSum_{};
+    /// Longest interval between observed server updates in milliseconds.
+    float maxServerUpdateInterval_{};
+    /// Number of received messages.
+    unsigned messagesIn_{};
+    /// Number of received bytes.
+    unsigned long long bytesIn_{};
+    /// Number of controls updates sent.
+    unsigned controlsSent_{};
+};
+
+/// Lightweight headless client for load testing a server. Owns a Network instance and a minimal scene that receives
+/// replication, and sends scripted controls. Many bots can share one context, which also shares the loaded resources.
+class NetworkBot : public Object
+{
+    URHO3D_OBJECT(NetworkBot, Object);
+
+public:
+    /// Construct. Uses the given Network instance, or creates a private one if null. Only one bot may use each Network.
+    NetworkBot(Context* context, unsigned index, Network* network = nullptr);
+    /// Destruct. Disconnect if connected.
+    ~NetworkBot() override;
+
+    /// Connect to the server. Return true if the attempt was started.
+    bool Connect(const ea::string& address, unsigned short port);
+    /// Disconnect from the server.
+    void Disconnect();
+
+    /// Set controls buttons the scripted input may press.
+    void SetButtonMask(unsigned mask) { buttonMask_ = mask; }
+    /// Set interval in seconds between changes of the scripted input.
+    void SetInputInterval(float interval) { inputInterval_ = interval; }
+
+    /// Return bot index.
+    unsigned GetIndex() const { return index_; }
+    /// Return the server connection, if any.
+    Connection* GetConnection() const;
+    /// Return the scene receiving replication.
+    Scene* GetScene() const { return scene_; }
+    /// Return statistics.
+    const NetworkBotStats& GetStats() const { return stats_; }
+
+private:
+    /// Handle connection established.
+    void HandleServerConnected(StringHash eventType, VariantMap& eventData);
+    /// Handle connection attempt failure.
+    void HandleConnectFailed(StringHash eventType, VariantMap& eventData);
+    /// Handle connection loss.
+    void HandleServerDisconnected(StringHash eventType, VariantMap& eventData);
+    /// Handle client network update: refresh the scripted controls.
+    void HandleNetworkUpdate(StringHash eventType, VariantMap& eventData);
+    /// Handle frame update: sample the connection after incoming messages have been processed.
+    void HandleUpdate(StringHash eventType, VariantMap& eventData);
+    /// Advance the scripted input.
+    void UpdateControls(float timeStep);
+
+    /// Bot index, also sent in the identity.
+    unsigned index_{};
+    /// Network instance.
+    SharedPtr<Network> network_;
+    /// Scene receiving replication.
+    SharedPtr<Scene> scene_;
+    /// Scripted controls.
+    Controls controls_;
+    /// Buttons the scripted input may press.
+    unsigned buttonMask_{0xf};
+    /// Interval between changes of the scripted input.
+    float inputInterval_{0.5f};
+    /// Time until the next change of the scripted input.
+    float inputTimer_{};
+    /// Yaw rate of the scripted input in degrees per second.
+    float yawRate_{};
+    /// Statistics.
+    NetworkBotStats stats_;
+    /// Timer since the connection attempt.
+    HiresTimer connectTimer_;
+    /// Timer since the previous observed server update.
+    HiresTimer serverUpdateTimer_;
+    /// Timer since the previous round trip time and bandwidth sample.
+    Timer roundTripTimer_;
+    /// Number of replication messages received at the previous frame.
+    unsigned lastReplicationMessages_{};
+    /// Whether the bot used the network.
+    bool active_{};
+};
+
+}
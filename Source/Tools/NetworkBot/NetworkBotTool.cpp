@@ -0,0 +1,337 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Command line utility always uses console.
+#define URHO3D_WIN32_CONSOLE
+
+#include "NetworkBot.h"
+
+#include <Urho3D/Core/CommandLine.h>
+#include <Urho3D/Core/CoreEvents.h>
+#include <Urho3D/Engine/Application.h>
+#include <Urho3D/Engine/Engine.h>
+#include <Urho3D/Engine/EngineDefs.h>
+#include <Urho3D/IO/Log.h>
+#include <Urho3D/Math/Random.h>
+#include <Urho3D/Network/Network.h>
+#include <Urho3D/Resource/JSONFile.h>
+
+#include <EASTL/sort.h>
+
+#include <cstdio>
+
+
+using namespace Urho3D;
+
+/// Return the value at the given fraction of sorted samples.
+static float GetPercentile(const ea::vector<float>& sortedSamples, float fraction)
+{
+    if (sortedSamples.empty())
+        return 0.0f;
+    const auto index = static_cast<unsigned>(fraction * (sortedSamples.size() - 1) + 0.5f);
+    return sortedSamples[Min(index, sortedSamples.size() - 1)];
+}
+
+/// Return the average of samples.
+static float GetAverage(const ea::vector<float>& samples)
+{
+    if (samples.empty())
+        return 0.0f;
+    double sum = 0.0;
+    for (float sample : samples)
+        sum += sample;
+    return static_cast<float>(sum / samples.size());
+}
+
+/// Aggregated statistics of all bots.
+struct NetworkBotSummary
+{
+    /// Number of spawned bots.
+    unsigned numBots_{};
+    /// Number of bots that connected.
+    unsigned numConnected_{};
+    /// Number of bots whose connection attempt failed.
+    unsigned numFailed_{};
+    /// Number of bots that were disconnected by the server.
+    unsigned numDisconnected_{};
+    /// Number of bots that loaded the scene.
+    unsigned numSceneLoaded_{};
+    /// Sorted connect times in milliseconds.
+    ea::vector<float> connectTimes_;
+    /// Sorted scene load times in milliseconds.
+    ea::vector<float> sceneLoadTimes_;
+    /// Sorted round trip times of all bots in milliseconds.
+    ea::vector<float> roundTripTimes_;
+    /// Average server update interval in milliseconds.
+    float serverUpdateInterval_{};
+    /// Longest server update interval in milliseconds.
+    float maxServerUpdateInterval_{};
+    /// Average incoming bandwidth per bot in bytes per second.
+    float bytesInPerSec_{};
+    /// Average outgoing bandwidth per bot in bytes per second.
+    float bytesOutPerSec_{};
+};
+
+/// Spawns many headless client bots in one process to load test a server.
+class NetworkBotApplication : public Application
+{
+    URHO3D_OBJECT(NetworkBotApplication, Application);
+public:
+    explicit NetworkBotApplication(Context* context) : Application(context)
+    {
+    }
+
+    void Setup() override
+    {
+        engineParameters_[EP_ENGINE_CLI_PARAMETERS] = false;
+        engineParameters_[EP_HEADLESS] = true;
+        engineParameters_[EP_SOUND] = false;
+        engineParameters_[EP_LOG_LEVEL] = LOG_WARNING;
+        engineParameters_[EP_RESOURCE_PATHS] = "Data;CoreData";
+        engineParameters_[EP_RESOURCE_PREFIX_PATHS] = ";..;../..";
+
+        auto& app = GetCommandLineParser();
+        app.add_option("-a,--address", address_, "Server address.");
+        app.add_option("-p,--port", port_, "Server port.");
+        app.add_option("-n,--bots", numBots_, "Number of bots.");
+        app.add_option("-r,--ramp", rampRate_, "Number of bots spawned per second. All at once if zero.");
+        app.add_option("-d,--duration", duration_, "Test duration in seconds after the last bot has been spawned.");
+        app.add_option("-o,--output", outputFile_, "Save results as JSON into the file.");
+        app.add_option("--button-mask", buttonMask_, "Controls buttons the bots may press.");
+        app.add_option("--input-interval", inputInterval_, "Interval in seconds between input changes of a bot.");
+        app.add_option("--seed", seed_, "Random seed of the scripted input.");
+        app.add_flag("-v,--verbose", verbose_, "Log connection events.");
+    }
+
+    void Start() override
+    {
+        if (verbose_)
+            GetSubsystem<Log>()->SetLevel(LOG_INFO);
+
+        SetRandomSeed(seed_);
+        bots_.reserve(numBots_);
+        SubscribeToEvent(E_UPDATE, URHO3D_HANDLER(NetworkBotApplication, HandleUpdate));
+    }
+
+    void Stop() override
+    {
+        bots_.clear();
+    }
+
+private:
+    /// Spawn bots according to the ramp, and finish the test once the duration has elapsed.
+    void HandleUpdate(StringHash eventType, VariantMap& eventData)
+    {
+        using namespace Update;
+        elapsedTime_ += eventData[P_TIMESTEP].GetFloat();
+
+        const unsigned targetBots = rampRate_ > 0.0f
+            ? Min(numBots_, static_cast<unsigned>(elapsedTime_ * rampRate_) + 1)
+            : numBots_;
+        while (bots_.size() < targetBots)
+            SpawnBot();
+
+        if (bots_.size() < numBots_)
+            return;
+        if (spawnEndTime_ < 0.0f)
+            spawnEndTime_ = elapsedTime_;
+        if (elapsedTime_ - spawnEndTime_ < duration_)
+            return;
+
+        UnsubscribeFromEvent(E_UPDATE);
+        const NetworkBotSummary summary = Summarize();
+        PrintSummary(summary);
+        if (!outputFile_.empty() && !SaveResults(summary))
+        {
+            ErrorExit(Format("Failed to save results to {}", outputFile_));
+            return;
+        }
+
+        engine_->Exit();
+    }
+
+    /// Create the next bot and start connecting it. The first bot uses the Network subsystem, which connections rely
+    /// on for the package cache and remote event filtering; the others create their own Network instances.
+    void SpawnBot()
+    {
+        const auto index = static_cast<unsigned>(bots_.size());
+        auto bot = MakeShared<NetworkBot>(context_, index, index == 0 ? GetSubsystem<Network>() : nullptr);
+        bot->SetButtonMask(buttonMask_);
+        bot->SetInputInterval(inputInterval_);
+        bot->Connect(address_, port_);
+        bots_.push_back(bot);
+    }
+
+    /// Aggregate statistics of all bots.
+    NetworkBotSummary Summarize() const
+    {
+        NetworkBotSummary summary;
+        summary.numBots_ = bots_.size();
+
+        unsigned numServerUpdates = 0;
+        double serverUpdateIntervalSum = 0.0;
+        ea::vector<float> bytesIn;
+        ea::vector<float> bytesOut;
+        for (const NetworkBot* bot : bots_)
+        {
+            const NetworkBotStats& stats = bot->GetStats();
+            if (stats.connected_)
+            {
+                ++summary.numConnected_;
+                summary.connectTimes_.push_back(stats.connectTime_);
+            }
+            if (stats.connectFailed_)
+                ++summary.numFailed_;
+            if (stats.disconnected_)
+                ++summary.numDisconnected_;
+            if (stats.sceneLoaded_)
+            {
+                ++summary.numSceneLoaded_;
+                summary.sceneLoadTimes_.push_back(stats.sceneLoadTime_);
+            }
+
+            summary.roundTripTimes_.insert(summary.roundTripTimes_.end(),
+                stats.roundTripTimes_.begin(), stats.roundTripTimes_.end());
+            if (!stats.bytesInPerSec_.empty())
+            {
+                bytesIn.push_back(GetAverage(stats.bytesInPerSec_));
+                bytesOut.push_back(GetAverage(stats.bytesOutPerSec_));
+            }
+
+            numServerUpdates += stats.numServerUpdates_;
+            serverUpdateIntervalSum += stats.serverUpdateIntervalSum_;
+            summary.maxServerUpdateInterval_ = Max(summary.maxServerUpdateInterval_, stats.maxServerUpdateInterval_);
+        }
+
+        ea::sort(summary.connectTimes_.begin(), summary.connectTimes_.end());
+        ea::sort(summary.sceneLoadTimes_.begin(), summary.sceneLoadTimes_.end());
+        ea::sort(summary.roundTripTimes_.begin(), summary.roundTripTimes_.end());
+        if (numServerUpdates > 0)
+            summary.serverUpdateInterval_ = static_cast<float>(serverUpdateIntervalSum / numServerUpdates);
+        summary.bytesInPerSec_ = GetAverage(bytesIn);
+        summary.bytesOutPerSec_ = GetAverage(bytesOut);
+        return summary;
+    }
+
+    /// Print aggregated statistics.
+    void PrintSummary(const NetworkBotSummary& summary) const
+    {
+        printf("Bots: %u spawned, %u connected, %u failed, %u disconnected, %u loaded scene\n", summary.numBots_,
+            summary.numConnected_, summary.numFailed_, summary.numDisconnected_, summary.numSceneLoaded_);
+        printf("%-24s %10s %10s %10s\n", "Metric (ms)", "p50", "p95", "max");
+        PrintPercentiles("Connect time", summary.connectTimes_);
+        PrintPercentiles("Scene load time", summary.sceneLoadTimes_);
+        PrintPercentiles("Round trip time", summary.roundTripTimes_);
+        printf("Server update interval: %.2f ms average, %.2f ms max\n", summary.serverUpdateInterval_,
+            summary.maxServerUpdateInterval_);
+        printf("Bandwidth per bot: %.0f B/s in, %.0f B/s out\n", summary.bytesInPerSec_, summary.bytesOutPerSec_);
+        fflush(stdout);
+    }
+
+    /// Print percentiles of sorted samples.
+    static void PrintPercentiles(const char* name, const ea::vector<float>& sortedSamples)
+    {
+        printf("%-24s %10.2f %10.2f %10.2f\n", name, GetPercentile(sortedSamples, 0.5f),
+            GetPercentile(sortedSamples, 0.95f), GetPercentile(sortedSamples, 1.0f));
+    }
+
+    /// Return percentiles of sorted samples as JSON.
+    static JSONValue GetPercentilesJSON(const ea::vector<float>& sortedSamples)
+    {
+        JSONValue value;
+        value.Set("p50", GetPercentile(sortedSamples, 0.5f));
+        value.Set("p95", GetPercentile(sortedSamples, 0.95f));
+        value.Set("max", GetPercentile(sortedSamples, 1.0f));
+        return value;
+    }
+
+    /// Save aggregated and per bot statistics as JSON.
+    bool SaveResults(const NetworkBotSummary& summary) const
+    {
+        JSONFile jsonFile(context_);
+        JSONValue& root = jsonFile.GetRoot();
+        root.Set("address", address_);
+        root.Set("port", port_);
+        root.Set("bots", summary.numBots_);
+        root.Set("connected", summary.numConnected_);
+        root.Set("failed", summary.numFailed_);
+        root.Set("disconnected", summary.numDisconnected_);
+        root.Set("sceneLoaded", summary.numSceneLoaded_);
+        root.Set("connectTime", GetPercentilesJSON(summary.connectTimes_));
+        root.Set("sceneLoadTime", GetPercentilesJSON(summary.sceneLoadTimes_));
+        root.Set("roundTripTime", GetPercentilesJSON(summary.roundTripTimes_));
+        root.Set("serverUpdateInterval", summary.serverUpdateInterval_);
+        root.Set("maxServerUpdateInterval", summary.maxServerUpdateInterval_);
+        root.Set("bytesInPerSec", summary.bytesInPerSec_);
+        root.Set("bytesOutPerSec", summary.bytesOutPerSec_);
+
+        JSONValue bots(JSON_ARRAY);
+        for (const NetworkBot* bot : bots_)
+        {
+            const NetworkBotStats& stats = bot->GetStats();
+            JSONValue value;
+            value.Set("index", bot->GetIndex());
+            value.Set("connected", stats.connected_);
+            value.Set("connectFailed", stats.connectFailed_);
+            value.Set("disconnected", stats.disconnected_);
+            value.Set("connectTime", stats.connectTime_);
+            value.Set("sceneLoadTime", stats.sceneLoadTime_);
+            value.Set("roundTripTime", GetAverage(stats.roundTripTimes_));
+            value.Set("serverUpdates", stats.numServerUpdates_);
+            value.Set("maxServerUpdateInterval", stats.maxServerUpdateInterval_);
+            value.Set("messagesIn", stats.messagesIn_);
+            value.Set("controlsSent", stats.controlsSent_);
+            bots.Push(value);
+        }
+        root.Set("perBot", bots);
+        return jsonFile.SaveFile(outputFile_);
+    }
+
+    /// Server address.
+    ea::string address_{"localhost"};
+    /// Server port.
+    unsigned short port_{2345};
+    /// Number of bots.
+    unsigned numBots_{16};
+    /// Bots spawned per second.
+    float rampRate_{4.0f};
+    /// Test duration after spawning in seconds.
+    float duration_{30.0f};
+    /// JSON output file name.
+    ea::string outputFile_;
+    /// Controls buttons the bots may press.
+    unsigned buttonMask_{0xf};
+    /// Interval between input changes of a bot.
+    float inputInterval_{0.5f};
+    /// Random seed.
+    unsigned seed_{1};
+    /// Whether to log connection events.
+    bool verbose_{};
+    /// Bots.
+    ea::vector<SharedPtr<NetworkBot>> bots_;
+    /// Time since start in seconds.
+    float elapsedTime_{};
+    /// Time when the last bot was spawned, or negative if not all bots have been spawned.
+    float spawnEndTime_{-1.0f};
+};
+
+URHO3D_DEFINE_APPLICATION_MAIN(NetworkBotApplication);
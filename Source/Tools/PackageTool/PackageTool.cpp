@@ -24,6 +24,8 @@
 
 #include <Urho3D/Core/Context.h>
 #include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/StringUtils.h>
+#include <Urho3D/Core/WorkQueue.h>
 #include <Urho3D/IO/File.h>
 #include <Urho3D/IO/FileSystem.h>
 #include <Urho3D/IO/PackageFile.h>
@@ -53,12 +55,21 @@ struct FileEntry
 
 Context* context_ = nullptr;
 FileSystem* fileSystem_ = nullptr;
+WorkQueue* workQueue_ = nullptr;
 ea::string basePath_;
 ea::vector<FileEntry> entries_;
 unsigned checksum_ = 0;
 bool compress_ = false;
 bool quiet_ = false;
 unsigned blockSize_ = COMPRESSED_BLOCK_SIZE;
+ea::string manifestName_;
+unsigned numThreads_ = M_MAX_UNSIGNED;
+bool reuse_ = false;
+SharedPtr<PackageFile> previousPackage_;
+File* previousPackageFile_ = nullptr;
+ea::vector<unsigned char> windowData_;
+ea::vector<unsigned char> packedData_;
+ea::vector<unsigned> packedSizes_;
 
 ea::string ignoreExtensions_[] = {
     ".bak",
@@ -67,9 +78,13 @@ ea::string ignoreExtensions_[] = {
 
 int main(int argc, char** argv);
 void Run(const ea::vector<ea::string>& arguments);
+void ApplyManifestOrder(ea::vector<ea::string>& fileNames);
 void ProcessFile(const ea::string& fileName, const ea::string& rootDir);
 void WritePackageFile(const ea::string& fileName, const ea::string& rootDir);
 void WriteHeader(File& dest);
+void WriteUncompressedData(File& dest, File& src, FileEntry& entry);
+void WriteCompressedData(File& dest, File& src, FileEntry& entry);
+bool ReuseCompressedData(File& dest, File& src, FileEntry& entry);
 
 int main(int argc, char** argv)
 {
@@ -98,6 +113,9 @@ void Run(const ea::vector<ea::string>& arguments)
             "Options:\n"
             "-c      Enable package file LZ4 compression\n"
             "-q      Enable quiet mode\n"
+            "-m      Store files listed in the following scene prefetch manifest first, in manifest order\n"
+            "-j      Number of compression threads in the following argument, default is number of CPU cores\n"
+            "-r      Reuse compressed data of unchanged files from existing package file\n"
             "\n"
             "Basepath is an optional prefix that will be added to the file entries.\n\n"
             "Alternative output usage: PackageTool <output option> <package name>\n"
@@ -128,6 +146,19 @@ void Run(const ea::vector<ea::string>& arguments)
                     case 'q':
                         quiet_ = true;
                         break;
+                    case 'm':
+                        if (i + 1 >= arguments.size())
+                            ErrorExit("Missing prefetch manifest name");
+                        manifestName_ = arguments[++i];
+                        break;
+                    case 'j':
+                        if (i + 1 >= arguments.size())
+                            ErrorExit("Missing number of threads");
+                        numThreads_ = ToUInt(arguments[++i]);
+                        break;
+                    case 'r':
+                        reuse_ = true;
+                        break;
                     default:
                         ErrorExit("Unrecognized option");
                     }
@@ -163,6 +194,8 @@ void Run(const ea::vector<ea::string>& arguments)
 
         // Ensure entries are sorted
         ea::quick_sort(fileNames.begin(), fileNames.end());
+        if (!manifestName_.empty())
+            ApplyManifestOrder(fileNames);
 
         // Check if up to date
         if (fileSystem_->Exists(packageName))
@@ -180,6 +213,8 @@ void Run(const ea::vector<ea::string>& arguments)
                         break;
                     }
                 }
+                if (!manifestName_.empty() && fileSystem_->GetLastModifiedTime(manifestName_) > packageTime)
+                    filesOutOfDate = true;
 
                 if (!filesOutOfDate)
                 {
@@ -192,7 +227,35 @@ void Run(const ea::vector<ea::string>& arguments)
         for (unsigned i = 0; i < fileNames.size(); ++i)
             ProcessFile(fileNames[i], dirName);
 
-        WritePackageFile(packageName, dirName);
+        // Main thread takes part in compression as well
+        SharedPtr<WorkQueue> workQueue(new WorkQueue(context_));
+        workQueue_ = workQueue;
+        workQueue->CreateThreads(numThreads_ != M_MAX_UNSIGNED ? numThreads_ : GetNumLogicalCPUs() - 1);
+
+        if (reuse_ && compress_ && fileSystem_->FileExists(packageName))
+        {
+            previousPackage_ = new PackageFile(context_);
+            if (!previousPackage_->Open(packageName) || !previousPackage_->IsCompressed())
+                previousPackage_ = nullptr;
+        }
+
+        if (previousPackage_)
+        {
+            // Previous package is read while the new one is written, write to a temporary file first
+            const ea::string tempName = packageName + ".tmp";
+            File previousPackageFile(context_, packageName);
+            previousPackageFile_ = &previousPackageFile;
+            WritePackageFile(tempName, dirName);
+            previousPackageFile.Close();
+            previousPackageFile_ = nullptr;
+            previousPackage_ = nullptr;
+
+            fileSystem_->Delete(packageName);
+            if (!fileSystem_->Rename(tempName, packageName))
+                ErrorExit("Could not rename " + tempName + " to " + packageName);
+        }
+        else
+            WritePackageFile(packageName, dirName);
     }
     else
     {
@@ -237,6 +300,43 @@ void Run(const ea::vector<ea::string>& arguments)
     }
 }
 
+void ApplyManifestOrder(ea::vector<ea::string>& fileNames)
+{
+    File manifestFile(context_, manifestName_);
+    if (!manifestFile.IsOpen())
+        ErrorExit("Could not open prefetch manifest " + manifestName_);
+
+    // Manifest lines are "Type;Name", where name includes the base path
+    ea::vector<ea::string> orderedNames;
+    while (!manifestFile.IsEof())
+    {
+        const ea::string line = manifestFile.ReadLine();
+        const unsigned separator = line.find(';');
+        if (separator == ea::string::npos)
+            continue;
+
+        ea::string name = line.substr(separator + 1);
+        if (!basePath_.empty())
+        {
+            if (!name.starts_with(basePath_))
+                continue;
+            name = name.substr(basePath_.length());
+        }
+
+        auto i = ea::find(fileNames.begin(), fileNames.end(), name);
+        if (i != fileNames.end())
+        {
+            orderedNames.push_back(name);
+            fileNames.erase(i);
+        }
+    }
+
+    if (!quiet_)
+        PrintLine("Ordered " + ea::to_string(orderedNames.size()) + " files by prefetch manifest");
+
+    fileNames.insert(fileNames.begin(), orderedNames.begin(), orderedNames.end());
+}
+
 void ProcessFile(const ea::string& fileName, const ea::string& rootDir)
 {
     ea::string fullPath = rootDir + "/" + fileName;
@@ -274,12 +374,12 @@ void WritePackageFile(const ea::string& fileName, const ea::string& rootDir)
     }
 
     unsigned totalDataSize = 0;
-    unsigned lastOffset;
+    unsigned numReused = 0;
 
     // Write file data, calculate checksums & correct offsets
     for (unsigned i = 0; i < entries_.size(); ++i)
     {
-        lastOffset = entries_[i].offset_ = dest.GetSize();
+        const unsigned lastOffset = entries_[i].offset_ = dest.GetSize();
         ea::string fileFullPath = rootDir + "/" + entries_[i].name_;
 
         File srcFile(context_, fileFullPath);
@@ -288,55 +388,26 @@ void WritePackageFile(const ea::string& fileName, const ea::string& rootDir)
 
         unsigned dataSize = entries_[i].size_;
         totalDataSize += dataSize;
-        ea::unique_ptr<unsigned char[]> buffer(new unsigned char[dataSize]);
-
-        if (srcFile.Read(&buffer[0], dataSize) != dataSize)
-            ErrorExit("Could not read file " + fileFullPath);
-        srcFile.Close();
 
-        for (unsigned j = 0; j < dataSize; ++j)
-        {
-            checksum_ = SDBMHash(checksum_, buffer[j]);
-            entries_[i].checksum_ = SDBMHash(entries_[i].checksum_, buffer[j]);
-        }
-
-        if (!compress_)
+        if (compress_ && previousPackage_ && ReuseCompressedData(dest, srcFile, entries_[i]))
+            ++numReused;
+        else if (!compress_)
         {
+            WriteUncompressedData(dest, srcFile, entries_[i]);
             if (!quiet_)
                 PrintLine(entries_[i].name_ + " size " + ea::to_string(dataSize));
-            dest.Write(&buffer[0], entries_[i].size_);
+            continue;
         }
         else
-        {
-            ea::unique_ptr<unsigned char[]> compressBuffer(new unsigned char[LZ4_compressBound(blockSize_)]);
+            WriteCompressedData(dest, srcFile, entries_[i]);
 
-            unsigned pos = 0;
-
-            while (pos < dataSize)
-            {
-                unsigned unpackedSize = blockSize_;
-                if (pos + unpackedSize > dataSize)
-                    unpackedSize = dataSize - pos;
-
-                auto packedSize = (unsigned)LZ4_compress_HC((const char*)&buffer[pos], (char*)compressBuffer.get(), unpackedSize, LZ4_compressBound(unpackedSize), 0);
-                if (!packedSize)
-                    ErrorExit("LZ4 compression failed for file " + entries_[i].name_ + " at offset " + ea::to_string(pos));
-
-                dest.WriteUShort((unsigned short)unpackedSize);
-                dest.WriteUShort((unsigned short)packedSize);
-                dest.Write(compressBuffer.get(), packedSize);
-
-                pos += unpackedSize;
-            }
-
-            if (!quiet_)
-            {
-                unsigned totalPackedBytes = dest.GetSize() - lastOffset;
-                ea::string fileEntry(entries_[i].name_);
-                fileEntry.append_sprintf("\tin: %u\tout: %u\tratio: %f", dataSize, totalPackedBytes,
-                    totalPackedBytes ? 1.f * dataSize / totalPackedBytes : 0.f);
-                PrintLine(fileEntry);
-            }
+        if (!quiet_)
+        {
+            unsigned totalPackedBytes = dest.GetSize() - lastOffset;
+            ea::string fileEntry(entries_[i].name_);
+            fileEntry.append_sprintf("\tin: %u\tout: %u\tratio: %f", dataSize, totalPackedBytes,
+                totalPackedBytes ? 1.f * dataSize / totalPackedBytes : 0.f);
+            PrintLine(fileEntry);
         }
     }
 
@@ -363,9 +434,136 @@ void WritePackageFile(const ea::string& fileName, const ea::string& rootDir)
         PrintLine("Package size: " + ea::to_string(dest.GetSize()));
         PrintLine("Checksum: " + ea::to_string(checksum_));
         PrintLine("Compressed: " + ea::string(compress_ ? "yes" : "no"));
+        if (previousPackage_)
+            PrintLine("Reused files: " + ea::to_string(numReused));
     }
 }
 
+void WriteUncompressedData(File& dest, File& src, FileEntry& entry)
+{
+    windowData_.resize(COMPRESSED_BLOCK_SIZE * 16);
+
+    unsigned pos = 0;
+    while (pos < entry.size_)
+    {
+        const unsigned chunkSize = Min<unsigned>(entry.size_ - pos, windowData_.size());
+        if (src.Read(windowData_.data(), chunkSize) != chunkSize)
+            ErrorExit("Could not read file " + entry.name_);
+
+        for (unsigned j = 0; j < chunkSize; ++j)
+        {
+            checksum_ = SDBMHash(checksum_, windowData_[j]);
+            entry.checksum_ = SDBMHash(entry.checksum_, windowData_[j]);
+        }
+
+        dest.Write(windowData_.data(), chunkSize);
+        pos += chunkSize;
+    }
+}
+
+void WriteCompressedData(File& dest, File& src, FileEntry& entry)
+{
+    // File is read and compressed in windows of several blocks per thread, blocks are written in order
+    const unsigned maxPackedSize = LZ4_compressBound(blockSize_);
+    const unsigned numWindowBlocks = (workQueue_->GetNumThreads() + 1) * 4;
+    windowData_.resize(numWindowBlocks * blockSize_);
+    packedData_.resize(numWindowBlocks * maxPackedSize);
+    packedSizes_.resize(numWindowBlocks);
+
+    unsigned pos = 0;
+    while (pos < entry.size_)
+    {
+        const unsigned windowSize = Min(entry.size_ - pos, numWindowBlocks * blockSize_);
+        if (src.Read(windowData_.data(), windowSize) != windowSize)
+            ErrorExit("Could not read file " + entry.name_);
+
+        for (unsigned j = 0; j < windowSize; ++j)
+        {
+            checksum_ = SDBMHash(checksum_, windowData_[j]);
+            entry.checksum_ = SDBMHash(entry.checksum_, windowData_[j]);
+        }
+
+        const unsigned numBlocks = (windowSize + blockSize_ - 1) / blockSize_;
+        workQueue_->ParallelFor(numBlocks, 1, [&](unsigned begin, unsigned end, unsigned)
+        {
+            for (unsigned block = begin; block < end; ++block)
+            {
+                const unsigned unpackedSize = Min(blockSize_, windowSize - block * blockSize_);
+                packedSizes_[block] = (unsigned)LZ4_compress_HC((const char*)&windowData_[block * blockSize_],
+                    (char*)&packedData_[block * maxPackedSize], unpackedSize, maxPackedSize, 0);
+            }
+        });
+        workQueue_->Complete(M_MAX_UNSIGNED);
+
+        for (unsigned block = 0; block < numBlocks; ++block)
+        {
+            if (!packedSizes_[block])
+                ErrorExit("LZ4 compression failed for file " + entry.name_ + " at offset " + ea::to_string(pos + block * blockSize_));
+
+            const unsigned unpackedSize = Min(blockSize_, windowSize - block * blockSize_);
+            dest.WriteUShort((unsigned short)unpackedSize);
+            dest.WriteUShort((unsigned short)packedSizes_[block]);
+            dest.Write(&packedData_[block * maxPackedSize], packedSizes_[block]);
+        }
+
+        pos += windowSize;
+    }
+}
+
+bool ReuseCompressedData(File& dest, File& src, FileEntry& entry)
+{
+    const PackageEntry* previous = previousPackage_->GetEntry(basePath_ + entry.name_);
+    if (!previous || previous->size_ != entry.size_)
+        return false;
+
+    // Checksums have to be calculated anyway, they also tell whether file contents changed
+    windowData_.resize(COMPRESSED_BLOCK_SIZE * 16);
+    unsigned fileChecksum = 0;
+    unsigned packageChecksum = checksum_;
+    unsigned pos = 0;
+    while (pos < entry.size_)
+    {
+        const unsigned chunkSize = Min<unsigned>(entry.size_ - pos, windowData_.size());
+        if (src.Read(windowData_.data(), chunkSize) != chunkSize)
+            ErrorExit("Could not read file " + entry.name_);
+
+        for (unsigned j = 0; j < chunkSize; ++j)
+        {
+            packageChecksum = SDBMHash(packageChecksum, windowData_[j]);
+            fileChecksum = SDBMHash(fileChecksum, windowData_[j]);
+        }
+        pos += chunkSize;
+    }
+
+    if (fileChecksum != previous->checksum_)
+    {
+        src.Seek(0);
+        return false;
+    }
+
+    // Copy compressed blocks verbatim
+    previousPackageFile_->Seek(previous->offset_);
+    packedData_.resize(LZ4_compressBound(blockSize_));
+    unsigned unpackedTotal = 0;
+    while (unpackedTotal < entry.size_)
+    {
+        const unsigned unpackedSize = previousPackageFile_->ReadUShort();
+        const unsigned packedSize = previousPackageFile_->ReadUShort();
+        if (!unpackedSize || packedSize > packedData_.size()
+            || previousPackageFile_->Read(packedData_.data(), packedSize) != packedSize)
+            ErrorExit("Corrupted data of file " + entry.name_ + " in previous package");
+
+        dest.WriteUShort((unsigned short)unpackedSize);
+        dest.WriteUShort((unsigned short)packedSize);
+        dest.Write(packedData_.data(), packedSize);
+        unpackedTotal += unpackedSize;
+    }
+
+    checksum_ = packageChecksum;
+    entry.checksum_ = fileChecksum;
+    return true;
+}
+
 void WriteHeader(File& dest)
 {
     if (!compress_)
@@ -0,0 +1,497 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Core/CommandLine.h>
+#include <Urho3D/Core/CoreEvents.h>
+#include <Urho3D/Core/MemoryTracker.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/Engine/Application.h>
+#include <Urho3D/Engine/Engine.h>
+#include <Urho3D/Engine/EngineDefs.h>
+#include <Urho3D/IO/File.h>
+#include <Urho3D/IO/FileSystem.h>
+#include <Urho3D/IO/Log.h>
+#include <Urho3D/Resource/JSONFile.h>
+#include <Urho3D/Resource/ResourceCache.h>
+#include <Urho3D/Resource/ResourceEvents.h>
+#include <Urho3D/Scene/Scene.h>
+#include <Urho3D/Scene/SceneEvents.h>
+
+#include <EASTL/map.h>
+#include <EASTL/sort.h>
+
+#include <cstdio>
+
+
+using namespace Urho3D;
+
+/// Trace lane of the load passes.
+static const unsigned PASS_LANE = 0;
+/// Trace lane of the main thread.
+static const unsigned MAIN_THREAD_LANE = 1;
+/// First trace lane of BeginLoad() calls.
+static const unsigned FIRST_LOAD_LANE = 100;
+/// First trace lane of file opens.
+static const unsigned FIRST_OPEN_LANE = 200;
+
+/// Load statistics of a resource type.
+struct ResourceTypeLoadStats
+{
+    /// Number of loaded resources.
+    unsigned count_{};
+    /// Bytes read from files.
+    unsigned long long bytes_{};
+    /// Total time spent in BeginLoad() in microseconds.
+    long long beginLoadTime_{};
+    /// Total time spent in EndLoad() on the main thread in microseconds.
+    long long endLoadTime_{};
+};
+
+/// Slice of the load timeline.
+struct TraceSlice
+{
+    /// Name.
+    ea::string name_;
+    /// Category.
+    ea::string category_;
+    /// First lane of the category. Overlapping slices of one category are spread over consecutive lanes.
+    unsigned lane_{};
+    /// Start timestamp in microseconds.
+    long long start_{};
+    /// Duration in microseconds.
+    long long duration_{};
+};
+
+/// Results of one scene load.
+struct LoadPass
+{
+    /// Name.
+    ea::string name_;
+    /// Whether the resource cache was emptied before the pass.
+    bool cold_{};
+    /// Start timestamp in microseconds.
+    long long startTime_{};
+    /// End timestamp in microseconds.
+    long long endTime_{};
+    /// Number of frames until the scene and all background loaded resources were finished.
+    unsigned numFrames_{};
+    /// Longest frame in microseconds.
+    long long maxFrameTime_{};
+    /// Time spent in the scene load call on the main thread in microseconds.
+    long long loadCallTime_{};
+    /// Number of opened resource files.
+    unsigned numFiles_{};
+    /// Bytes read from resource files.
+    unsigned long long bytesRead_{};
+    /// Number of resources that failed to load.
+    unsigned numFailed_{};
+    /// Statistics by resource type.
+    ea::map<ea::string, ResourceTypeLoadStats> types_;
+    /// Highest memory allocated under the resource memory tag.
+    long long peakResourceMemory_{};
+    /// Memory use of the resource cache after loading.
+    unsigned long long cacheMemory_{};
+};
+
+/// Loads a scene repeatedly through the asynchronous loading path and records a timeline of the resource loading.
+class SceneLoadBenchmarkApplication : public Application
+{
+    URHO3D_OBJECT(SceneLoadBenchmarkApplication, Application);
+public:
+    explicit SceneLoadBenchmarkApplication(Context* context) : Application(context)
+    {
+    }
+
+    void Setup() override
+    {
+        engineParameters_[EP_WINDOW_TITLE] = GetTypeName();
+        engineParameters_[EP_WINDOW_WIDTH] = 1280;
+        engineParameters_[EP_WINDOW_HEIGHT] = 720;
+        engineParameters_[EP_FULL_SCREEN] = false;
+        engineParameters_[EP_SOUND] = false;
+        engineParameters_[EP_VSYNC] = false;
+        engineParameters_[EP_FRAME_LIMITER] = false;
+        engineParameters_[EP_RESOURCE_PATHS] = "Data;CoreData";
+        engineParameters_[EP_RESOURCE_PREFIX_PATHS] = ";..;../..";
+
+        auto& app = GetCommandLineParser();
+        app.add_option("scene", sceneName_, "Scene resource name or file path. Binary, XML and JSON scenes are supported.")->required();
+        app.add_option("--packages", packageNames_, "Comma-separated package files added to the resource cache before loading.");
+        app.add_option("--cold", numColdPasses_, "Number of passes that start with an empty resource cache.");
+        app.add_option("--warm", numWarmPasses_, "Number of passes that reuse the resources of the previous pass.");
+        app.add_option("--threads", numLoadThreads_, "Number of background loading threads.");
+        app.add_option("--finish-ms", finishResourcesMs_, "Time budget per frame for finishing background loaded resources.");
+        app.add_option("--async-ms", asyncLoadingMs_, "Time budget per frame for loading scene nodes.");
+        app.add_flag("--resources-only", resourcesOnly_, "Only preload the resources of the scene without instantiating it.");
+        app.add_option("--trace", traceFile_, "Save the load timeline as Chrome trace JSON into the file.");
+        app.add_option("--output", outputFile_, "Save results as JSON into the file.");
+    }
+
+    void Start() override
+    {
+        auto* cache = GetSubsystem<ResourceCache>();
+        for (const ea::string& packageName : packageNames_.split(','))
+        {
+            if (!cache->AddPackageFile(packageName, 0))
+            {
+                ErrorExit(Format("Failed to add package {}", packageName));
+                return;
+            }
+        }
+        cache->SetNumBackgroundLoadThreads(numLoadThreads_);
+        cache->SetFinishBackgroundResourcesMs(finishResourcesMs_);
+
+        for (unsigned i = 0; i < numColdPasses_; ++i)
+            AddPass(Format("Cold {}", i + 1), true);
+        for (unsigned i = 0; i < numWarmPasses_; ++i)
+            AddPass(Format("Warm {}", i + 1), false);
+        if (passes_.empty())
+        {
+            ErrorExit("No load passes requested");
+            return;
+        }
+
+        scene_ = MakeShared<Scene>(context_);
+        scene_->SetAsyncLoadingMs(asyncLoadingMs_);
+        SubscribeToEvent(scene_, E_ASYNCLOADFINISHED, [this](StringHash, VariantMap&) { asyncLoadFinished_ = true; });
+        SubscribeToEvent(cache, E_RESOURCEBACKGROUNDLOADED, URHO3D_HANDLER(SceneLoadBenchmarkApplication, HandleResourceLoaded));
+        SubscribeToEvent(E_ENDFRAME, [this](StringHash, VariantMap&) { EndFrame(); });
+
+        traceOrigin_ = HiresTimer::GetTimestamp();
+        StartPass();
+    }
+
+    void Stop() override
+    {
+        scene_ = nullptr;
+    }
+
+private:
+    /// Add a load pass.
+    void AddPass(const ea::string& name, bool cold)
+    {
+        LoadPass& pass = passes_.emplace_back();
+        pass.name_ = name;
+        pass.cold_ = cold;
+    }
+
+    /// Start loading the scene for the current pass.
+    void StartPass()
+    {
+        LoadPass& pass = passes_[currentPass_];
+        auto* cache = GetSubsystem<ResourceCache>();
+
+        scene_->Clear();
+        if (pass.cold_)
+            cache->ReleaseAllResources(true);
+        MemoryTracker::ResetPeaks();
+
+        pass.startTime_ = HiresTimer::GetTimestamp();
+        frameStartTime_ = pass.startTime_;
+        asyncLoadFinished_ = false;
+
+        SharedPtr<File> file = cache->GetFile(sceneName_);
+        if (!file)
+        {
+            ErrorExit(Format("Failed to open scene {}", sceneName_));
+            return;
+        }
+
+        const LoadMode mode = resourcesOnly_ ? LOAD_RESOURCES_ONLY : LOAD_SCENE_AND_RESOURCES;
+        const ea::string extension = GetExtension(sceneName_);
+        bool success = false;
+        if (extension == ".xml")
+            success = scene_->LoadAsyncXML(file, mode);
+        else if (extension == ".json")
+            success = scene_->LoadAsyncJSON(file, mode);
+        else
+            success = scene_->LoadAsync(file, mode);
+
+        const long long loadCallEndTime = HiresTimer::GetTimestamp();
+        pass.loadCallTime_ = loadCallEndTime - pass.startTime_;
+        AddSlice("LoadAsync", "Scene", MAIN_THREAD_LANE, pass.startTime_, loadCallEndTime);
+
+        if (!success)
+            ErrorExit(Format("Failed to start loading scene {}", sceneName_));
+    }
+
+    /// Record the frame and finish the pass once the scene and all background loaded resources are done.
+    void EndFrame()
+    {
+        if (currentPass_ >= passes_.size())
+            return;
+
+        LoadPass& pass = passes_[currentPass_];
+        const long long frameEndTime = HiresTimer::GetTimestamp();
+        ++pass.numFrames_;
+        pass.maxFrameTime_ = Max(pass.maxFrameTime_, frameEndTime - frameStartTime_);
+        AddSlice(Format("Frame {}", pass.numFrames_), "Frame", MAIN_THREAD_LANE, frameStartTime_, frameEndTime);
+        frameStartTime_ = frameEndTime;
+
+        // Resources requested by the instantiated components may still be loading after the scene itself
+        auto* cache = GetSubsystem<ResourceCache>();
+        if (!asyncLoadFinished_ || cache->GetNumBackgroundLoadResources() > 0)
+            return;
+
+        pass.endTime_ = frameEndTime;
+        pass.peakResourceMemory_ = MemoryTracker::GetStatistics(MEMORY_TAG_RESOURCE).peakBytes_;
+        pass.cacheMemory_ = cache->GetTotalMemoryUse();
+        AddSlice(pass.name_, "Pass", PASS_LANE, pass.startTime_, pass.endTime_);
+        PrintPass(pass);
+
+        ++currentPass_;
+        if (currentPass_ < passes_.size())
+        {
+            StartPass();
+            return;
+        }
+
+        if (!traceFile_.empty() && !SaveTrace())
+        {
+            ErrorExit(Format("Failed to save trace to {}", traceFile_));
+            return;
+        }
+        if (!outputFile_.empty() && !SaveResults())
+        {
+            ErrorExit(Format("Failed to save results to {}", outputFile_));
+            return;
+        }
+
+        engine_->Exit();
+    }
+
+    /// Record the timing of a background loaded resource.
+    void HandleResourceLoaded(StringHash eventType, VariantMap& eventData)
+    {
+        using namespace ResourceBackgroundLoaded;
+
+        if (currentPass_ >= passes_.size())
+            return;
+
+        LoadPass& pass = passes_[currentPass_];
+        const ea::string& name = eventData[P_RESOURCENAME].GetString();
+        auto* resource = static_cast<Resource*>(eventData[P_RESOURCE].GetPtr());
+        const ea::string typeName = resource ? resource->GetTypeName() : "Unknown";
+        const unsigned fileSize = eventData[P_FILESIZE].GetUInt();
+        const long long openTime = eventData[P_OPENTIME].GetInt64();
+        const long long beginLoadTime = eventData[P_BEGINLOADTIME].GetInt64();
+        const long long beginLoadEndTime = eventData[P_BEGINLOADENDTIME].GetInt64();
+        const long long endLoadTime = eventData[P_ENDLOADTIME].GetInt64();
+        const long long finishTime = eventData[P_FINISHTIME].GetInt64();
+
+        ResourceTypeLoadStats& typeStats = pass.types_[typeName];
+        ++typeStats.count_;
+        typeStats.bytes_ += fileSize;
+        typeStats.beginLoadTime_ += beginLoadEndTime - beginLoadTime;
+        typeStats.endLoadTime_ += finishTime - endLoadTime;
+        if (fileSize > 0)
+        {
+            ++pass.numFiles_;
+            pass.bytesRead_ += fileSize;
+        }
+        if (!eventData[P_SUCCESS].GetBool())
+            ++pass.numFailed_;
+
+        // Prefetched files are opened well ahead of BeginLoad(), so the open slice covers the time the file waited
+        if (openTime > 0)
+            AddSlice(name, "Open", FIRST_OPEN_LANE, openTime, beginLoadTime);
+        AddSlice(name, "BeginLoad " + typeName, FIRST_LOAD_LANE, beginLoadTime, beginLoadEndTime);
+        AddSlice(name, "EndLoad " + typeName, MAIN_THREAD_LANE, endLoadTime, finishTime);
+    }
+
+    /// Add slice to the timeline.
+    void AddSlice(const ea::string& name, const ea::string& category, unsigned lane, long long start, long long end)
+    {
+        if (traceFile_.empty())
+            return;
+
+        TraceSlice& slice = slices_.emplace_back();
+        slice.name_ = name;
+        slice.category_ = category;
+        slice.lane_ = lane;
+        slice.start_ = start;
+        slice.duration_ = Max(end - start, 0LL);
+    }
+
+    /// Print results of a pass.
+    void PrintPass(const LoadPass& pass) const
+    {
+        printf("%s: %.2f ms, %u frames, max frame %.2f ms, load call %.2f ms\n", pass.name_.c_str(),
+            (pass.endTime_ - pass.startTime_) / 1000.0, pass.numFrames_, pass.maxFrameTime_ / 1000.0,
+            pass.loadCallTime_ / 1000.0);
+        printf("  %u files, %.2f MB read, %u failed, peak resource memory %.2f MB, cache memory %.2f MB\n",
+            pass.numFiles_, pass.bytesRead_ / 1048576.0, pass.numFailed_, pass.peakResourceMemory_ / 1048576.0,
+            pass.cacheMemory_ / 1048576.0);
+        if (pass.types_.empty())
+            return;
+
+        printf("  %-24s %8s %10s %14s %14s\n", "Type", "Count", "MB", "BeginLoad ms", "EndLoad ms");
+        for (const auto& [typeName, stats] : pass.types_)
+        {
+            printf("  %-24s %8u %10.2f %14.2f %14.2f\n", typeName.c_str(), stats.count_, stats.bytes_ / 1048576.0,
+                stats.beginLoadTime_ / 1000.0, stats.endLoadTime_ / 1000.0);
+        }
+        fflush(stdout);
+    }
+
+    /// Save the timeline in the Chrome trace event format, which chrome://tracing and Perfetto can open.
+    bool SaveTrace()
+    {
+        // Spread overlapping slices of background threads over lanes, reusing the first lane which is free again
+        ea::stable_sort(slices_.begin(), slices_.end(),
+            [](const TraceSlice& lhs, const TraceSlice& rhs) { return lhs.start_ < rhs.start_; });
+        ea::map<unsigned, ea::vector<long long>> laneEndTimes;
+        unsigned maxLane = MAIN_THREAD_LANE;
+
+        JSONValue events(JSON_ARRAY);
+        for (const TraceSlice& slice : slices_)
+        {
+            unsigned lane = slice.lane_;
+            if (lane >= FIRST_LOAD_LANE)
+            {
+                ea::vector<long long>& endTimes = laneEndTimes[slice.lane_];
+                unsigned index = 0;
+                while (index < endTimes.size() && endTimes[index] > slice.start_)
+                    ++index;
+                if (index == endTimes.size())
+                    endTimes.push_back(0);
+                endTimes[index] = slice.start_ + slice.duration_;
+                lane += index;
+            }
+            maxLane = Max(maxLane, lane);
+
+            JSONValue event;
+            event.Set("name", slice.name_);
+            event.Set("cat", slice.category_);
+            event.Set("ph", "X");
+            event.Set("ts", static_cast<double>(slice.start_ - traceOrigin_));
+            event.Set("dur", static_cast<double>(slice.duration_));
+            event.Set("pid", 1);
+            event.Set("tid", lane);
+            events.Push(event);
+        }
+
+        const auto addLaneName = [&events](unsigned lane, const ea::string& name)
+        {
+            JSONValue args;
+            args.Set("name", name);
+            JSONValue event;
+            event.Set("name", "thread_name");
+            event.Set("ph", "M");
+            event.Set("pid", 1);
+            event.Set("tid", lane);
+            event.Set("args", args);
+            events.Push(event);
+        };
+        addLaneName(PASS_LANE, "Passes");
+        addLaneName(MAIN_THREAD_LANE, "Main thread");
+        for (const auto& [firstLane, endTimes] : laneEndTimes)
+        {
+            const char* laneName = firstLane == FIRST_LOAD_LANE ? "Loader" : "File open";
+            for (unsigned i = 0; i < endTimes.size(); ++i)
+                addLaneName(firstLane + i, Format("{} {}", laneName, i + 1));
+        }
+
+        JSONFile jsonFile(context_);
+        jsonFile.GetRoot().Set("traceEvents", events);
+        jsonFile.GetRoot().Set("displayTimeUnit", "ms");
+        return jsonFile.SaveFile(traceFile_);
+    }
+
+    /// Save results of all passes as JSON.
+    bool SaveResults() const
+    {
+        JSONValue passes(JSON_ARRAY);
+        for (const LoadPass& pass : passes_)
+        {
+            JSONValue types;
+            for (const auto& [typeName, stats] : pass.types_)
+            {
+                JSONValue value;
+                value.Set("count", stats.count_);
+                value.Set("bytes", static_cast<double>(stats.bytes_));
+                value.Set("beginLoadMs", stats.beginLoadTime_ / 1000.0);
+                value.Set("endLoadMs", stats.endLoadTime_ / 1000.0);
+                types.Set(typeName, value);
+            }
+
+            JSONValue value;
+            value.Set("name", pass.name_);
+            value.Set("cold", pass.cold_);
+            value.Set("totalMs", (pass.endTime_ - pass.startTime_) / 1000.0);
+            value.Set("frames", pass.numFrames_);
+            value.Set("maxFrameMs", pass.maxFrameTime_ / 1000.0);
+            value.Set("loadCallMs", pass.loadCallTime_ / 1000.0);
+            value.Set("files", pass.numFiles_);
+            value.Set("bytesRead", static_cast<double>(pass.bytesRead_));
+            value.Set("failed", pass.numFailed_);
+            value.Set("peakResourceMemory", static_cast<double>(pass.peakResourceMemory_));
+            value.Set("cacheMemory", static_cast<double>(pass.cacheMemory_));
+            value.Set("types", types);
+            passes.Push(value);
+        }
+
+        JSONFile jsonFile(context_);
+        jsonFile.GetRoot().Set("scene", sceneName_);
+        jsonFile.GetRoot().Set("threads", numLoadThreads_);
+        jsonFile.GetRoot().Set("passes", passes);
+        return jsonFile.SaveFile(outputFile_);
+    }
+
+    /// Scene resource name or path.
+    ea::string sceneName_;
+    /// Comma-separated package files.
+    ea::string packageNames_;
+    /// Number of cold passes.
+    unsigned numColdPasses_{1};
+    /// Number of warm passes.
+    unsigned numWarmPasses_{1};
+    /// Number of background loading threads.
+    unsigned numLoadThreads_{1};
+    /// Time budget per frame for finishing background loaded resources.
+    int finishResourcesMs_{5};
+    /// Time budget per frame for loading scene nodes.
+    int asyncLoadingMs_{5};
+    /// Whether to only preload resources.
+    bool resourcesOnly_{};
+    /// Chrome trace output file name.
+    ea::string traceFile_;
+    /// JSON output file name.
+    ea::string outputFile_;
+
+    /// Scene being loaded.
+    SharedPtr<Scene> scene_;
+    /// Load passes.
+    ea::vector<LoadPass> passes_;
+    /// Index of the current pass.
+    unsigned currentPass_{};
+    /// Whether the scene of the current pass has finished loading.
+    bool asyncLoadFinished_{};
+    /// Start timestamp of the current frame.
+    long long frameStartTime_{};
+    /// Timestamp the trace timestamps are relative to.
+    long long traceOrigin_{};
+    /// Timeline slices.
+    ea::vector<TraceSlice> slices_;
+};
+
+URHO3D_DEFINE_APPLICATION_MAIN(SceneLoadBenchmarkApplication);
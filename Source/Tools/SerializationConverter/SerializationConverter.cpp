@@ -24,11 +24,14 @@
 #define URHO3D_WIN32_CONSOLE
 
 #include <Urho3D/Core/CommandLine.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/Core/WorkQueue.h>
 #include <Urho3D/Engine/Application.h>
 #include <Urho3D/Engine/EngineDefs.h>
 #include <Urho3D/IO/FileSystem.h>
 #include <Urho3D/IO/BinaryArchive.h>
 #include <Urho3D/IO/File.h>
+#include <Urho3D/IO/MemoryBuffer.h>
 #include <Urho3D/IO/Serializer.h>
 #include <Urho3D/IO/Deserializer.h>
 #include <Urho3D/Resource/XMLFile.h>
@@ -40,9 +43,48 @@
 #include <Urho3D/UI/UIElement.h>
 #include <Urho3D/UI/Font.h>
 
+#include <EASTL/sort.h>
+#include <EASTL/unordered_map.h>
+
 
 using namespace Urho3D;
 
+/// Single file conversion.
+struct ConversionJob
+{
+    /// Name of type that handles serialization.
+    ea::string type_;
+    /// Input file.
+    ea::string input_;
+    /// Output file.
+    ea::string output_;
+    /// Input file contents.
+    ByteVector data_;
+    /// Parsed input XML file.
+    SharedPtr<XMLFile> xmlFile_;
+    /// Parsed input JSON file.
+    SharedPtr<JSONFile> jsonFile_;
+    /// Hash of input contents and conversion parameters.
+    unsigned long long hash_{};
+    /// Whether the input was read and parsed.
+    bool read_{};
+    /// Whether the conversion is skipped because the input is unchanged.
+    bool skipped_{};
+    /// Time of reading and parsing in microseconds.
+    long long readTime_{};
+    /// Time of conversion in microseconds.
+    long long convertTime_{};
+};
+
+/// Compute 64-bit FNV-1a hash of the data.
+static unsigned long long HashData(const void* data, unsigned size, unsigned long long hash = 14695981039346656037ull)
+{
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (unsigned i = 0; i < size; ++i)
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    return hash;
+}
+
 class ConverterApplication : public Application
 {
     URHO3D_OBJECT(ConverterApplication, Application);
@@ -58,151 +100,362 @@ public:
         engineParameters_[EP_HEADLESS] = true;
 
         auto& app = GetCommandLineParser();
-        app.add_option("-t,--type", type_, "Name of type that handles serialization of specified files.")->required();
+        app.add_option("-t,--type", type_, "Name of type that handles serialization of specified files.");
         app.add_option("-i,--input-type", inputType_, "Serialization format of input file.")->set_default_str("old");
         app.add_option("-o,--output-type", outputType_, "Serialization format of output file.")-> set_default_str("new");
-        app.add_option("input", input_, "Input file (xml/json/binary).")->required();
-        app.add_option("output", output_, "Output file (xml/json/binary).")->required();
+        app.add_option("-m,--manifest", manifest_, "Batch mode: text file with 'type input output' line per conversion.");
+        app.add_option("--input-dir", inputDir_, "Batch mode: directory scanned recursively for input files of --type.");
+        app.add_option("--filter", filter_, "Batch mode: filter of input files in --input-dir.")->set_default_str("*.xml");
+        app.add_option("--output-dir", outputDir_, "Batch mode: directory of output files converted from --input-dir.");
+        app.add_option("--output-extension", outputExtension_, "Batch mode: extension of output files converted from --input-dir.")->set_default_str(".json");
+        app.add_option("--cache", cache_, "Batch mode: file with hashes of converted files. Unchanged files are skipped.");
+        app.add_option("input", input_, "Input file (xml/json/binary).");
+        app.add_option("output", output_, "Output file (xml/json/binary).");
     }
 
     void Start() override
     {
-        if (type_ == "Font")
+        const bool batchMode = !manifest_.empty() || !inputDir_.empty();
+        if (!batchMode && (type_.empty() || input_.empty() || output_.empty()))
         {
-            // Font::SaveXML requires point size parameter.
-            PrintLine("Conversions for 'Font' type are not supported.", true);
+            PrintLine("Type, input and output files are required unless --manifest or --input-dir is specified.", true);
+            exitCode_ = EXIT_FAILURE;
             engine_->Exit();
+            return;
         }
 
-        SharedPtr<Serializable> converter = StaticCast<Serializable>(context_->CreateObject(type_));
+        ea::vector<ConversionJob> jobs;
+        if (batchMode)
+            CollectBatchJobs(jobs);
+        else
+            jobs.push_back(ConversionJob{ type_, input_, output_ });
+
+        HiresTimer totalTimer;
+        ReadCache();
 
-        bool loaded = false, read = false, saved = false;
-        do
+        // Reading and parsing does not touch shared engine state, do it on all threads
+        auto* queue = GetSubsystem<WorkQueue>();
+        queue->ParallelFor(jobs.size(), 1, [this, &jobs](unsigned begin, unsigned end, unsigned)
         {
-            if (GetExtension(input_) == ".xml")
+            for (unsigned i = begin; i < end; ++i)
+                ReadJob(jobs[i]);
+        });
+        queue->Complete(M_MAX_UNSIGNED);
+
+        // Loading may request resources and create objects that subscribe to events, so it stays on the main thread
+        unsigned numConverted = 0;
+        unsigned numSkipped = 0;
+        unsigned numFailed = 0;
+        for (ConversionJob& job : jobs)
+        {
+            if (job.skipped_)
             {
-                XMLFile file(context_);
+                ++numSkipped;
+                if (batchMode)
+                    PrintLine(Format("Skipped unchanged '{}'.", job.input_));
+                continue;
+            }
 
-                if (!(read = file.LoadFile(input_)))
-                    break;
+            HiresTimer convertTimer;
+            const bool succeeded = ConvertJob(job);
+            job.convertTime_ = convertTimer.GetUSec(false);
 
-                if (inputType_ == "old")
-                    loaded = converter->LoadXML(file.GetRoot());
-                else if (inputType_ == "new")
-                {
-                    XMLInputArchive archive(&file);
-                    loaded = converter->Serialize(archive);
-                }
+            // Release parsed input as soon as possible, there may be many jobs
+            job.data_.clear();
+            job.xmlFile_.Reset();
+            job.jsonFile_.Reset();
+
+            if (!succeeded)
+            {
+                ++numFailed;
+                cacheEntries_.erase(GetCacheKey(job));
+                continue;
             }
-            else if (GetExtension(input_) == ".json")
+
+            ++numConverted;
+            cacheEntries_[GetCacheKey(job)] = job.hash_;
+            if (batchMode)
             {
-                JSONFile file(context_);
+                PrintLine(Format("Converted '{}' -> '{}': read {:.2f} ms, convert {:.2f} ms.", job.input_, job.output_,
+                    job.readTime_ / 1000.0, job.convertTime_ / 1000.0));
+            }
+        }
+
+        WriteCache();
+
+        if (batchMode)
+        {
+            PrintLine(Format("Converted {}, skipped {}, failed {} of {} files in {:.2f} s.", numConverted, numSkipped,
+                numFailed, jobs.size(), totalTimer.GetUSec(false) / 1000000.0));
+        }
+        else if (numFailed == 0)
+            PrintLine("Conversion succeeded.");
+
+        if (numFailed > 0)
+            exitCode_ = EXIT_FAILURE;
+        engine_->Exit();
+    }
+
+private:
+    /// Collect conversions from manifest and input directory.
+    void CollectBatchJobs(ea::vector<ConversionJob>& jobs)
+    {
+        if (!manifest_.empty())
+        {
+            File file(context_);
+            if (!file.Open(manifest_))
+                PrintLine(Format("Reading of manifest '{}' failed.", manifest_), true);
 
-                if (!(read = file.LoadFile(input_)))
-                    break;
+            while (file.IsOpen() && !file.IsEof())
+            {
+                const ea::string line = file.ReadLine().trimmed();
+                if (line.empty() || line.starts_with("#"))
+                    continue;
 
-                if (inputType_ == "old")
-                    loaded = converter->LoadJSON(file.GetRoot());
-                else if (inputType_ == "new")
+                const ea::vector<ea::string> parts = line.split(' ');
+                if (parts.size() != 3)
                 {
-                    JSONInputArchive archive(&file);
-                    loaded = converter->Serialize(archive);
+                    PrintLine(Format("Invalid manifest line '{}', expected 'type input output'.", line), true);
+                    continue;
                 }
+                jobs.push_back(ConversionJob{ parts[0], parts[1], parts[2] });
             }
-            else
+        }
+
+        if (!inputDir_.empty())
+        {
+            if (type_.empty() || outputDir_.empty())
             {
-                File file(context_);
+                PrintLine("Type and output directory are required with --input-dir.", true);
+                return;
+            }
 
-                if (!(read = file.Open(input_)))
-                    break;
+            ea::vector<ea::string> files;
+            GetSubsystem<FileSystem>()->ScanDir(files, AddTrailingSlash(inputDir_), filter_, SCAN_FILES, true);
+            ea::sort(files.begin(), files.end());
 
-                if (inputType_ == "old")
-                    loaded = converter->Load(file);
-                else if (inputType_ == "new")
-                {
-                    BinaryInputArchive archive(context_, file);
-                    loaded = converter->Serialize(archive);
-                }
+            auto* fileSystem = GetSubsystem<FileSystem>();
+            for (const ea::string& fileName : files)
+            {
+                const ea::string output = AddTrailingSlash(outputDir_) + ReplaceExtension(fileName, outputExtension_);
+                fileSystem->CreateDirsRecursive(GetPath(output));
+                jobs.push_back(ConversionJob{ type_, AddTrailingSlash(inputDir_) + fileName, output });
             }
+        }
+    }
+
+    /// Read, hash and parse the input file. Called from worker threads.
+    void ReadJob(ConversionJob& job) const
+    {
+        HiresTimer readTimer;
 
-            if (!loaded)
-                break;
+        File file(context_);
+        if (file.Open(job.input_))
+        {
+            job.data_.resize(file.GetSize());
+            job.read_ = file.Read(job.data_.data(), job.data_.size()) == job.data_.size();
+        }
 
-            if (GetExtension(output_) == ".xml")
+        if (job.read_)
+        {
+            // Conversion parameters affect the output as well as the contents
+            const ea::string parameters = Format("{}|{}|{}|{}", job.type_, inputType_, outputType_, job.output_);
+            job.hash_ = HashData(parameters.data(), parameters.size(), HashData(job.data_.data(), job.data_.size()));
+
+            const auto iter = cacheEntries_.find(GetCacheKey(job));
+            if (iter != cacheEntries_.end() && iter->second == job.hash_
+                && GetSubsystem<FileSystem>()->FileExists(job.output_))
             {
+                job.skipped_ = true;
+                job.data_.clear();
+                return;
+            }
 
-                if (outputType_ == "old")
-                {
-                    if (converter->GetTypeName() == "Scene")
-                    {
-                        File file(context_, output_, FILE_WRITE);
-                        saved = StaticCast<Scene>(converter)->SaveXML(file);
-                    }
-                    else if (converter->GetTypeName() == "Node")
-                    {
-                        File file(context_, output_, FILE_WRITE);
-                        saved = StaticCast<Node>(converter)->SaveXML(file);
-                    }
-                    else if (converter->GetTypeName() == "UIElement")
-                    {
-                        File file(context_, output_, FILE_WRITE);
-                        saved = StaticCast<UIElement>(converter)->SaveXML(file);
-                    }
-                    else
-                    {
-                        PrintLine("Root XML tag of output file may be invalid!");
-                        XMLFile file(context_);
-                        XMLElement root = file.GetOrCreateRoot("root");
-                        if ((saved = converter->SaveXML(root)))
-                            file.SaveFile(output_);
-                    }
-                }
-                else if (outputType_ == "new")
-                {
-                    XMLFile file(context_);
-                    XMLOutputArchive archive(&file);
-                    saved = converter->Serialize(archive);
-                }
+            MemoryBuffer buffer(job.data_);
+            const ea::string extension = GetExtension(job.input_);
+            if (extension == ".xml")
+            {
+                job.xmlFile_ = MakeShared<XMLFile>(context_);
+                job.read_ = job.xmlFile_->Load(buffer);
             }
-            else if (GetExtension(output_) == ".json")
+            else if (extension == ".json")
             {
-                JSONFile file(context_);
+                job.jsonFile_ = MakeShared<JSONFile>(context_);
+                job.read_ = job.jsonFile_->Load(buffer);
+            }
+        }
 
-                if (outputType_ == "old")
-                    saved = converter->SaveJSON(file.GetRoot());
-                else if (outputType_ == "new")
-                {
-                    JSONOutputArchive archive(&file);
-                    saved = converter->Serialize(archive);
-                }
+        job.readTime_ = readTimer.GetUSec(false);
+    }
 
-                if (saved)
-                    saved = file.SaveFile(output_);
+    /// Convert the input file. Return true if successful.
+    bool ConvertJob(ConversionJob& job)
+    {
+        if (job.type_ == "Font")
+        {
+            // Font::SaveXML requires point size parameter.
+            PrintLine("Conversions for 'Font' type are not supported.", true);
+            return false;
+        }
+
+        if (!job.read_)
+        {
+            PrintLine(Format("Reading of '{}' failed.", job.input_), true);
+            return false;
+        }
+
+        SharedPtr<Serializable> converter = DynamicCast<Serializable>(context_->CreateObject(job.type_));
+        if (!converter)
+        {
+            PrintLine(Format("Type '{}' is not a known serializable type.", job.type_), true);
+            return false;
+        }
+
+        bool loaded = false;
+        if (job.xmlFile_)
+        {
+            if (inputType_ == "old")
+                loaded = converter->LoadXML(job.xmlFile_->GetRoot());
+            else if (inputType_ == "new")
+            {
+                XMLInputArchive archive(job.xmlFile_);
+                loaded = converter->Serialize(archive);
             }
-            else
+        }
+        else if (job.jsonFile_)
+        {
+            if (inputType_ == "old")
+                loaded = converter->LoadJSON(job.jsonFile_->GetRoot());
+            else if (inputType_ == "new")
             {
-                File file(context_, output_, FILE_WRITE);
+                JSONInputArchive archive(job.jsonFile_);
+                loaded = converter->Serialize(archive);
+            }
+        }
+        else
+        {
+            MemoryBuffer buffer(job.data_);
 
-                if (outputType_ == "old")
-                    saved = converter->Save(file);
-                else if (outputType_ == "new")
+            if (inputType_ == "old")
+                loaded = converter->Load(buffer);
+            else if (inputType_ == "new")
+            {
+                BinaryInputArchive archive(context_, buffer);
+                loaded = converter->Serialize(archive);
+            }
+        }
+
+        if (!loaded)
+        {
+            PrintLine(Format("Loading of '{}' failed.", job.input_), true);
+            return false;
+        }
+
+        if (!SaveConverted(converter, job.output_))
+        {
+            PrintLine(Format("Saving of '{}' failed.", job.output_), true);
+            return false;
+        }
+        return true;
+    }
+
+    /// Save the converted object. Return true if successful.
+    bool SaveConverted(Serializable* converter, const ea::string& output)
+    {
+        bool saved = false;
+        if (GetExtension(output) == ".xml")
+        {
+
+            if (outputType_ == "old")
+            {
+                if (converter->GetTypeName() == "Scene")
                 {
-                    BinaryOutputArchive archive(context_, file);
-                    saved = converter->Serialize(archive);
+                    File file(context_, output, FILE_WRITE);
+                    saved = static_cast<Scene*>(converter)->SaveXML(file);
                 }
+                else if (converter->GetTypeName() == "Node")
+                {
+                    File file(context_, output, FILE_WRITE);
+                    saved = static_cast<Node*>(converter)->SaveXML(file);
+                }
+                else if (converter->GetTypeName() == "UIElement")
+                {
+                    File file(context_, output, FILE_WRITE);
+                    saved = static_cast<UIElement*>(converter)->SaveXML(file);
+                }
+                else
+                {
+                    PrintLine("Root XML tag of output file may be invalid!");
+                    XMLFile file(context_);
+                    XMLElement root = file.GetOrCreateRoot("root");
+                    if ((saved = converter->SaveXML(root)))
+                        file.SaveFile(output);
+                }
+            }
+            else if (outputType_ == "new")
+            {
+                XMLFile file(context_);
+                XMLOutputArchive archive(&file);
+                saved = converter->Serialize(archive);
+            }
+        }
+        else if (GetExtension(output) == ".json")
+        {
+            JSONFile file(context_);
+
+            if (outputType_ == "old")
+                saved = converter->SaveJSON(file.GetRoot());
+            else if (outputType_ == "new")
+            {
+                JSONOutputArchive archive(&file);
+                saved = converter->Serialize(archive);
             }
-        } while (false);
 
-        if (!read)
-            PrintLine(Format("Reading of '{}' failed.", input_), true);
-        else if (!loaded)
-            PrintLine(Format("Loading of '{}' failed.", input_), true);
-        else if (!saved)
-            PrintLine(Format("Saving of '{}' failed.", output_), true);
+            if (saved)
+                saved = file.SaveFile(output);
+        }
         else
-            PrintLine("Conversion succeeded.");
+        {
+            File file(context_, output, FILE_WRITE);
 
-        engine_->Exit();
+            if (outputType_ == "old")
+                saved = converter->Save(file);
+            else if (outputType_ == "new")
+            {
+                BinaryOutputArchive archive(context_, file);
+                saved = converter->Serialize(archive);
+            }
+        }
+        return saved;
+    }
+
+    /// Return key of the conversion in the cache.
+    static ea::string GetCacheKey(const ConversionJob& job) { return job.input_ + "|" + job.output_; }
+
+    /// Read hashes of converted files.
+    void ReadCache()
+    {
+        if (cache_.empty() || !GetSubsystem<FileSystem>()->FileExists(cache_))
+            return;
+
+        File file(context_, cache_);
+        while (!file.IsEof())
+        {
+            const ea::vector<ea::string> parts = file.ReadLine().split('\t');
+            if (parts.size() == 2)
+                cacheEntries_[parts[1]] = ToUInt64(parts[0], 16);
+        }
+    }
+
+    /// Write hashes of converted files.
+    void WriteCache() const
+    {
+        if (cache_.empty())
+            return;
+
+        File file(context_, cache_, FILE_WRITE);
+        for (const auto& [key, hash] : cacheEntries_)
+            file.WriteLine(Format("{:016x}\t{}", hash, key));
     }
 
     ea::string type_;
@@ -210,6 +463,14 @@ public:
     ea::string outputType_{"new"};
     ea::string input_;
     ea::string output_;
+    ea::string manifest_;
+    ea::string inputDir_;
+    ea::string filter_{"*.xml"};
+    ea::string outputDir_;
+    ea::string outputExtension_{".json"};
+    ea::string cache_;
+    /// Hashes of converted files by input and output file names.
+    ea::unordered_map<ea::string, unsigned long long> cacheEntries_;
 };
 
 URHO3D_DEFINE_APPLICATION_MAIN(ConverterApplication);
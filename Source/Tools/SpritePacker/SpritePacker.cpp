@@ -23,6 +23,7 @@
 #include <Urho3D/Core/Context.h>
 #include <Urho3D/Core/ProcessUtils.h>
 #include <Urho3D/Core/StringUtils.h>
+#include <Urho3D/Core/WorkQueue.h>
 #include <Urho3D/IO/File.h>
 #include <Urho3D/IO/FileSystem.h>
 #include <Urho3D/IO/Log.h>
@@ -30,22 +31,17 @@
 #include <Urho3D/Resource/XMLElement.h>
 #include <Urho3D/Resource/XMLFile.h>
 
+#include <EASTL/sort.h>
+
 #ifdef WIN32
 #include <windows.h>
 #endif
 
-#define STBRP_LARGE_RECTS
-#if !URHO3D_STATIC
-#   define STB_RECT_PACK_IMPLEMENTATION
-#endif
-#include <STB/stb_rect_pack.h>
-
 #include <Urho3D/DebugNew.h>
 
 using namespace Urho3D;
 
-// number of nodes allocated to each packer info.  since this packer is not suited for real time purposes we can over allocate.
-const int PACKER_NUM_NODES = 4096;
+const int MIN_TEXTURE_SIZE = 4;
 const int MAX_TEXTURE_SIZE = 2048;
 
 int main(int argc, char** argv);
@@ -56,6 +52,10 @@ class PackerInfo : public RefCounted
 public:
     ea::string path;
     ea::string name;
+    SharedPtr<Image> image;
+    ea::string error;
+    unsigned page{};
+    bool placed{};
     int x{};
     int y{};
     int offsetX{};
@@ -74,6 +74,119 @@ public:
     ~PackerInfo() override = default;
 };
 
+/// Bin packer that tracks the maximal free rectangles of a page and places each rectangle by best short side fit.
+class MaxRectsPacker
+{
+public:
+    MaxRectsPacker(int width, int height) :
+        width_(width),
+        height_(height)
+    {
+        freeRects_.push_back(IntRect(0, 0, width, height));
+    }
+
+    /// Find the best free position for a rectangle and occupy it. Return false if it does not fit.
+    bool Insert(int width, int height, IntVector2& position)
+    {
+        int bestShortSide = M_MAX_INT;
+        int bestLongSide = M_MAX_INT;
+        for (const IntRect& freeRect : freeRects_)
+        {
+            const int leftoverX = freeRect.Width() - width;
+            const int leftoverY = freeRect.Height() - height;
+            if (leftoverX < 0 || leftoverY < 0)
+                continue;
+
+            const int shortSide = Min(leftoverX, leftoverY);
+            const int longSide = Max(leftoverX, leftoverY);
+            if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide))
+            {
+                bestShortSide = shortSide;
+                bestLongSide = longSide;
+                position = IntVector2(freeRect.left_, freeRect.top_);
+            }
+        }
+
+        if (bestShortSide == M_MAX_INT)
+            return false;
+
+        return Occupy(IntRect(position.x_, position.y_, position.x_ + width, position.y_ + height));
+    }
+
+    /// Occupy a rectangle at a fixed position. Return false if it is out of bounds or overlaps an occupied rectangle.
+    bool Occupy(const IntRect& rect)
+    {
+        if (rect.left_ < 0 || rect.top_ < 0 || rect.right_ > width_ || rect.bottom_ > height_)
+            return false;
+        for (const IntRect& usedRect : usedRects_)
+        {
+            if (Overlaps(usedRect, rect))
+                return false;
+        }
+
+        usedRects_.push_back(rect);
+        SplitFreeRects(rect);
+        return true;
+    }
+
+private:
+    static bool Overlaps(const IntRect& a, const IntRect& b)
+    {
+        return a.left_ < b.right_ && b.left_ < a.right_ && a.top_ < b.bottom_ && b.top_ < a.bottom_;
+    }
+
+    static bool Contains(const IntRect& outer, const IntRect& inner)
+    {
+        return inner.left_ >= outer.left_ && inner.top_ >= outer.top_ && inner.right_ <= outer.right_ && inner.bottom_ <= outer.bottom_;
+    }
+
+    /// Replace free rectangles overlapped by the used rectangle with their maximal remainders.
+    void SplitFreeRects(const IntRect& used)
+    {
+        for (unsigned i = 0; i < freeRects_.size();)
+        {
+            const IntRect freeRect = freeRects_[i];
+            if (!Overlaps(freeRect, used))
+            {
+                ++i;
+                continue;
+            }
+
+            freeRects_.erase_at(i);
+            if (used.left_ > freeRect.left_)
+                freeRects_.push_back(IntRect(freeRect.left_, freeRect.top_, used.left_, freeRect.bottom_));
+            if (used.right_ < freeRect.right_)
+                freeRects_.push_back(IntRect(used.right_, freeRect.top_, freeRect.right_, freeRect.bottom_));
+            if (used.top_ > freeRect.top_)
+                freeRects_.push_back(IntRect(freeRect.left_, freeRect.top_, freeRect.right_, used.top_));
+            if (used.bottom_ < freeRect.bottom_)
+                freeRects_.push_back(IntRect(freeRect.left_, used.bottom_, freeRect.right_, freeRect.bottom_));
+        }
+
+        // Drop free rectangles contained in others
+        for (unsigned i = 0; i < freeRects_.size(); ++i)
+        {
+            for (unsigned j = i + 1; j < freeRects_.size();)
+            {
+                if (Contains(freeRects_[i], freeRects_[j]))
+                    freeRects_.erase_at(j);
+                else if (Contains(freeRects_[j], freeRects_[i]))
+                {
+                    freeRects_.erase_at(i);
+                    j = i + 1;
+                }
+                else
+                    ++j;
+            }
+        }
+    }
+
+    int width_;
+    int height_;
+    ea::vector<IntRect> freeRects_;
+    ea::vector<IntRect> usedRects_;
+};
+
 void Help()
 {
     ErrorExit("Usage: SpritePacker -options <input file> <input file> <output png file>\n"
@@ -88,6 +201,9 @@ void Help()
         "-frameWidth Sets a fixed width for image and centers within frame.\n"
         "-trim Trims excess transparent space from individual images offsets by frame size.\n"
         "-xml \'path\' Generates an SpriteSheet xml file at path.\n"
+        "-maxSize Sets the max sprite sheet texture size. Default 2048.\n"
+        "-multiPage Writes sprites that do not fit into additional pages named <output>_<page>.\n"
+        "-incremental Keeps placements of unchanged sprites from the existing sprite sheet.\n"
         "-debug Draws allocation boxes on sprite.\n");
 }
 
@@ -105,6 +221,217 @@ int main(int argc, char** argv)
     return 0;
 }
 
+/// Return file name of a sprite sheet page. The first page uses the file name as is.
+ea::string GetPageFileName(const ea::string& fileName, unsigned page)
+{
+    if (page == 0)
+        return fileName;
+    return GetPath(fileName) + GetFileName(fileName) + "_" + ea::to_string(page) + GetExtension(fileName, false);
+}
+
+/// Sort sprites for packing: larger sprites first, ties broken by name for deterministic output.
+void SortForPacking(ea::vector<PackerInfo*>& sprites)
+{
+    ea::sort(sprites.begin(), sprites.end(), [](const PackerInfo* lhs, const PackerInfo* rhs)
+    {
+        const int lhsSide = Max(lhs->width, lhs->height);
+        const int rhsSide = Max(rhs->width, rhs->height);
+        if (lhsSide != rhsSide)
+            return lhsSide > rhsSide;
+        if (lhs->width * lhs->height != rhs->width * rhs->height)
+            return lhs->width * lhs->height > rhs->width * rhs->height;
+        return lhs->name < rhs->name;
+    });
+}
+
+/// Place sprites into the packer in order. Sprites that do not fit get position (-1, -1).
+/// Return number of sprites placed. Stop at the first sprite that does not fit unless skipping is allowed.
+unsigned PackSprites(MaxRectsPacker& packer, const ea::vector<PackerInfo*>& sprites, const IntVector2& padding,
+    bool skipMisfits, ea::vector<IntVector2>& positions)
+{
+    unsigned numPlaced = 0;
+    positions.resize(sprites.size(), IntVector2(-1, -1));
+    for (unsigned i = 0; i < sprites.size(); ++i)
+    {
+        if (packer.Insert(sprites[i]->width + padding.x_, sprites[i]->height + padding.y_, positions[i]))
+            ++numPlaced;
+        else if (!skipMisfits)
+            break;
+        else
+            positions[i] = IntVector2(-1, -1);
+    }
+    return numPlaced;
+}
+
+/// Pack sprites into new pages of the smallest power of two size that holds them. Candidate sizes are tried in parallel.
+/// When even the largest page cannot hold all sprites, fill it and continue on another page if allowed.
+void PackNewPages(ea::vector<PackerInfo*> sprites, ea::vector<IntVector2>& pageSizes, int maxSize,
+    const IntVector2& padding, bool multiPage, WorkQueue* workQueue)
+{
+    ea::vector<IntVector2> tries;
+    for (int x = MIN_TEXTURE_SIZE; x <= maxSize; x *= 2)
+    {
+        for (int y = MIN_TEXTURE_SIZE; y <= maxSize; y *= 2)
+            tries.push_back(IntVector2(x, y));
+    }
+    ea::stable_sort(tries.begin(), tries.end(), [](const IntVector2& lhs, const IntVector2& rhs)
+    {
+        return lhs.x_ * lhs.y_ < rhs.x_ * rhs.y_;
+    });
+
+    SortForPacking(sprites);
+    while (!sprites.empty())
+    {
+        ea::vector<ea::vector<IntVector2>> positions(tries.size());
+        ea::vector<unsigned> numPlaced(tries.size());
+        workQueue->ParallelFor(tries.size(), 1, [&](unsigned begin, unsigned end, unsigned)
+        {
+            for (unsigned i = begin; i < end; ++i)
+            {
+                MaxRectsPacker packer(tries[i].x_, tries[i].y_);
+                numPlaced[i] = PackSprites(packer, sprites, padding, false, positions[i]);
+            }
+        });
+        workQueue->Complete(M_MAX_UNSIGNED);
+
+        const unsigned page = pageSizes.size();
+        const auto bestTry = ea::find(numPlaced.begin(), numPlaced.end(), sprites.size());
+        if (bestTry != numPlaced.end())
+        {
+            const unsigned index = bestTry - numPlaced.begin();
+            pageSizes.push_back(tries[index]);
+            for (unsigned i = 0; i < sprites.size(); ++i)
+            {
+                sprites[i]->page = page;
+                sprites[i]->x = positions[index][i].x_;
+                sprites[i]->y = positions[index][i].y_;
+                sprites[i]->placed = true;
+            }
+            return;
+        }
+
+        if (!multiPage)
+        {
+            ErrorExit("Could not allocate for all images.  The max sprite sheet texture size is " + ea::to_string(maxSize) +
+                "x" + ea::to_string(maxSize) + ".");
+        }
+
+        // Fill a page of the max size and carry the rest over to the next page
+        MaxRectsPacker packer(maxSize, maxSize);
+        ea::vector<IntVector2> pagePositions;
+        if (!PackSprites(packer, sprites, padding, true, pagePositions))
+        {
+            ErrorExit("Image " + sprites[0]->path + " does not fit into the max sprite sheet texture size " +
+                ea::to_string(maxSize) + "x" + ea::to_string(maxSize) + ".");
+        }
+
+        ea::vector<PackerInfo*> remaining;
+        pageSizes.push_back(IntVector2(maxSize, maxSize));
+        for (unsigned i = 0; i < sprites.size(); ++i)
+        {
+            if (pagePositions[i].x_ < 0)
+            {
+                remaining.push_back(sprites[i]);
+                continue;
+            }
+            sprites[i]->page = page;
+            sprites[i]->x = pagePositions[i].x_;
+            sprites[i]->y = pagePositions[i].y_;
+            sprites[i]->placed = true;
+        }
+        sprites = ea::move(remaining);
+    }
+}
+
+/// Keep placements of unchanged sprites from previously written sprite sheet pages and fit other sprites into the free
+/// space left on them. Return sprites that still need a place.
+ea::vector<PackerInfo*> ReusePreviousLayout(Context* context, const ea::string& spriteSheetFileName,
+    const ea::vector<SharedPtr<PackerInfo> >& packerInfos, const IntVector2& offset, const IntVector2& padding,
+    ea::vector<IntVector2>& pageSizes)
+{
+    auto* fileSystem = context->GetSubsystem<FileSystem>();
+
+    ea::unordered_map<ea::string, PackerInfo*> spritesByName;
+    for (PackerInfo* packerInfo : packerInfos)
+        spritesByName[packerInfo->name] = packerInfo;
+
+    ea::vector<MaxRectsPacker> packers;
+    unsigned numReused = 0;
+    for (unsigned page = 0; ; ++page)
+    {
+        const ea::string xmlFileName = GetPageFileName(spriteSheetFileName, page);
+        if (!fileSystem->FileExists(xmlFileName))
+            break;
+
+        XMLFile xml(context);
+        if (!xml.LoadFile(xmlFileName))
+            break;
+
+        // Page size is only recorded by sprite sheets written by this tool
+        XMLElement root = xml.GetRoot("TextureAtlas");
+        if (!root || !root.HasAttribute("width") || !root.HasAttribute("height"))
+        {
+            URHO3D_LOGINFO(xmlFileName + " does not record its texture size, its sprites are repacked.");
+            break;
+        }
+
+        pageSizes.push_back(IntVector2(root.GetInt("width"), root.GetInt("height")));
+        MaxRectsPacker& packer = packers.emplace_back(pageSizes.back().x_, pageSizes.back().y_);
+        for (XMLElement subTexture = root.GetChild("SubTexture"); subTexture; subTexture = subTexture.GetNext("SubTexture"))
+        {
+            auto iter = spritesByName.find(subTexture.GetAttribute("name"));
+            if (iter == spritesByName.end())
+                continue;
+
+            PackerInfo* packerInfo = iter->second;
+            if (packerInfo->placed || packerInfo->width != subTexture.GetInt("width") || packerInfo->height != subTexture.GetInt("height"))
+                continue;
+
+            const int x = subTexture.GetInt("x") - offset.x_;
+            const int y = subTexture.GetInt("y") - offset.y_;
+            if (!packer.Occupy(IntRect(x, y, x + packerInfo->width + padding.x_, y + packerInfo->height + padding.y_)))
+                continue;
+
+            packerInfo->page = page;
+            packerInfo->x = x;
+            packerInfo->y = y;
+            packerInfo->placed = true;
+            ++numReused;
+        }
+    }
+
+    URHO3D_LOGINFO("Kept placement of " + ea::to_string(numReused) + " unchanged sprites.");
+
+    // New and resized sprites go into the free space of the existing pages, first page first
+    ea::vector<PackerInfo*> remaining;
+    for (PackerInfo* packerInfo : packerInfos)
+    {
+        if (!packerInfo->placed)
+            remaining.push_back(packerInfo);
+    }
+    SortForPacking(remaining);
+
+    ea::vector<PackerInfo*> unplaced;
+    for (PackerInfo* packerInfo : remaining)
+    {
+        for (unsigned page = 0; page < packers.size(); ++page)
+        {
+            IntVector2 position;
+            if (packers[page].Insert(packerInfo->width + padding.x_, packerInfo->height + padding.y_, position))
+            {
+                packerInfo->page = page;
+                packerInfo->x = position.x_;
+                packerInfo->y = position.y_;
+                packerInfo->placed = true;
+                break;
+            }
+        }
+        if (!packerInfo->placed)
+            unplaced.push_back(packerInfo);
+    }
+    return unplaced;
+}
+
 void Run(ea::vector<ea::string>& arguments)
 {
     if (arguments.size() < 2)
@@ -113,7 +440,10 @@ void Run(ea::vector<ea::string>& arguments)
     SharedPtr<Context> context(new Context());
     context->RegisterSubsystem(new FileSystem(context));
     context->RegisterSubsystem(new Log(context));
+    context->RegisterSubsystem(new WorkQueue(context));
     auto* fileSystem = context->GetSubsystem<FileSystem>();
+    auto* workQueue = context->GetSubsystem<WorkQueue>();
+    workQueue->CreateThreads(Max(GetNumLogicalCPUs(), 1u) - 1);
 
     ea::vector<ea::string> inputFiles;
     ea::string outputFile;
@@ -125,8 +455,11 @@ void Run(ea::vector<ea::string>& arguments)
     unsigned offsetY = 0;
     unsigned frameWidth = 0;
     unsigned frameHeight = 0;
+    unsigned maxSize = MAX_TEXTURE_SIZE;
     bool help = false;
     bool trim = false;
+    bool multiPage = false;
+    bool incremental = false;
 
     while (arguments.size() > 0)
     {
@@ -150,7 +483,11 @@ void Run(ea::vector<ea::string>& arguments)
                 arguments.pop_front(); }
             else if (arg == "-frameHeight") { frameHeight = ToUInt(arguments[0]);
                 arguments.pop_front(); }
+            else if (arg == "-maxSize") { maxSize = ToUInt(arguments[0]);
+                arguments.pop_front(); }
             else if (arg == "-trim") { trim = true; }
+            else if (arg == "-multiPage") { multiPage = true; }
+            else if (arg == "-incremental") { incremental = true; }
             else if (arg == "-xml")  { spriteSheetFileName = arguments[0];
                 arguments.pop_front(); }
             else if (arg == "-h")  { help = true; break; }
@@ -169,6 +506,9 @@ void Run(ea::vector<ea::string>& arguments)
     if (frameWidth ^ frameHeight)
         ErrorExit("Both frameHeight and frameWidth must be omitted or specified.");
 
+    if (!IsPowerOfTwo(maxSize) || maxSize < MIN_TEXTURE_SIZE)
+        ErrorExit("maxSize must be a power of two of at least " + ea::to_string(MIN_TEXTURE_SIZE) + ".");
+
     // take last input file as output
     if (inputFiles.size() > 1)
     {
@@ -197,223 +537,224 @@ void Run(ea::vector<ea::string>& arguments)
     offsetY = Min((int)offsetY, (int)padY);
 
     ea::vector<SharedPtr<PackerInfo > > packerInfos;
-
     for (unsigned i = 0; i < inputFiles.size(); ++i)
     {
         ea::string path = inputFiles[i];
         ea::string name = ReplaceExtension(GetFileName(path), "");
-        File file(context, path);
-        Image image(context);
+        packerInfos.push_back(MakeShared<PackerInfo>(path, name));
+    }
 
-        if (!image.Load(file))
-            ErrorExit("Could not load image " + path + ".");
+    // Load and trim the images in parallel. The images are kept for transferring to the sprite sheet
+    workQueue->ParallelFor(packerInfos.size(), 1, [&](unsigned begin, unsigned end, unsigned)
+    {
+        for (unsigned i = begin; i < end; ++i)
+        {
+            PackerInfo* packerInfo = packerInfos[i];
+            File file(context, packerInfo->path);
+            auto image = MakeShared<Image>(context);
 
-        if (image.IsCompressed())
-            ErrorExit(path + " is compressed. Compressed images are not allowed.");
+            if (!image->Load(file))
+            {
+                packerInfo->error = "Could not load image " + packerInfo->path + ".";
+                continue;
+            }
 
-        SharedPtr<PackerInfo> packerInfo(new PackerInfo(path, name));
-        int imageWidth = image.GetWidth();
-        int imageHeight = image.GetHeight();
-        int trimOffsetX = 0;
-        int trimOffsetY = 0;
-        int adjustedWidth = imageWidth;
-        int adjustedHeight = imageHeight;
+            if (image->IsCompressed())
+            {
+                packerInfo->error = packerInfo->path + " is compressed. Compressed images are not allowed.";
+                continue;
+            }
 
-        if (trim)
-        {
-            int minX = imageWidth;
-            int minY = imageHeight;
-            int maxX = 0;
-            int maxY = 0;
+            int imageWidth = image->GetWidth();
+            int imageHeight = image->GetHeight();
+            int trimOffsetX = 0;
+            int trimOffsetY = 0;
+            int adjustedWidth = imageWidth;
+            int adjustedHeight = imageHeight;
 
-            for (int y = 0; y < imageHeight; ++y)
+            if (trim)
             {
-                for (int x = 0; x < imageWidth; ++x)
+                int minX = imageWidth;
+                int minY = imageHeight;
+                int maxX = 0;
+                int maxY = 0;
+
+                for (int y = 0; y < imageHeight; ++y)
                 {
-                    bool found = (image.GetPixelInt(x, y) & 0x000000ffu) != 0;
-                    if (found) {
-                        minX = Min(minX, x);
-                        minY = Min(minY, y);
-                        maxX = Max(maxX, x);
-                        maxY = Max(maxY, y);
+                    for (int x = 0; x < imageWidth; ++x)
+                    {
+                        bool found = (image->GetPixelInt(x, y) & 0x000000ffu) != 0;
+                        if (found) {
+                            minX = Min(minX, x);
+                            minY = Min(minY, y);
+                            maxX = Max(maxX, x);
+                            maxY = Max(maxY, y);
+                        }
                     }
                 }
+
+                trimOffsetX = minX;
+                trimOffsetY = minY;
+                adjustedWidth = maxX - minX + 1;
+                adjustedHeight = maxY - minY + 1;
             }
 
-            trimOffsetX = minX;
-            trimOffsetY = minY;
-            adjustedWidth = maxX - minX + 1;
-            adjustedHeight = maxY - minY + 1;
+            if (trim)
+            {
+                packerInfo->frameWidth = imageWidth;
+                packerInfo->frameHeight = imageHeight;
+            }
+            else if (frameWidth || frameHeight)
+            {
+                packerInfo->frameWidth = frameWidth;
+                packerInfo->frameHeight = frameHeight;
+            }
+            packerInfo->image = image;
+            packerInfo->width = adjustedWidth;
+            packerInfo->height = adjustedHeight;
+            packerInfo->offsetX -= trimOffsetX;
+            packerInfo->offsetY -= trimOffsetY;
         }
+    });
+    workQueue->Complete(M_MAX_UNSIGNED);
 
-        if (trim)
-        {
-            packerInfo->frameWidth = imageWidth;
-            packerInfo->frameHeight = imageHeight;
-        }
-        else if (frameWidth || frameHeight)
-        {
-            packerInfo->frameWidth = frameWidth;
-            packerInfo->frameHeight = frameHeight;
-        }
-        packerInfo->width = adjustedWidth;
-        packerInfo->height = adjustedHeight;
-        packerInfo->offsetX -= trimOffsetX;
-        packerInfo->offsetY -= trimOffsetY;
-        packerInfos.push_back(packerInfo);
+    for (PackerInfo* packerInfo : packerInfos)
+    {
+        if (!packerInfo->error.empty())
+            ErrorExit(packerInfo->error);
     }
 
-    int packedWidth = MAX_TEXTURE_SIZE;
-    int packedHeight = MAX_TEXTURE_SIZE;
+    const IntVector2 padding(padX, padY);
+    ea::vector<IntVector2> pageSizes;
+    ea::vector<PackerInfo*> unplaced;
+    if (incremental)
     {
-        // fill up an list of tries in increasing size and take the first win
-        ea::vector<IntVector2> tries;
-        for(unsigned x=2; x<11; ++x)
-        {
-            for(unsigned y=2; y<11; ++y)
-                tries.push_back(IntVector2((1u << x), (1u << y)));
-        }
+        unplaced = ReusePreviousLayout(context, spriteSheetFileName, packerInfos, IntVector2(offsetX, offsetY), padding, pageSizes);
 
-        // load rectangles
-        auto* packerRects = new stbrp_rect[packerInfos.size()];
-        for (unsigned i = 0; i < packerInfos.size(); ++i)
+        // Without extra pages the changed sprites can only get a place by repacking everything
+        if (!unplaced.empty() && !pageSizes.empty() && !multiPage)
         {
-            PackerInfo* packerInfo = packerInfos[i];
-            stbrp_rect* packerRect = &packerRects[i];
-            packerRect->id = i;
-            packerRect->h = packerInfo->height + padY;
-            packerRect->w = packerInfo->width + padX;
-        }
-
-        bool success = false;
-        while (tries.size() > 0)
-        {
-            IntVector2 size = tries[0];
-            tries.pop_front();
-            bool fit = true;
-            int textureHeight = size.y_;
-            int textureWidth = size.x_;
-            if (success && textureHeight * textureWidth > packedWidth * packedHeight)
-                continue;
-
-            stbrp_context packerContext;
-            stbrp_node packerMemory[PACKER_NUM_NODES];
-            stbrp_init_target(&packerContext, textureWidth, textureHeight, packerMemory, PACKER_NUM_NODES);
-            if (!stbrp_pack_rects(&packerContext, packerRects, packerInfos.size()))
+            URHO3D_LOGINFO("Changed sprites do not fit into the existing sprite sheet, repacking all sprites.");
+            pageSizes.clear();
+            unplaced.clear();
+            for (PackerInfo* packerInfo : packerInfos)
             {
-                // check to see if everything fit
-                fit = false;
-            }
-
-            if (fit)
-            {
-                success = true;
-                // distribute values to packer info
-                for (unsigned i = 0; i < packerInfos.size(); ++i)
-                {
-                    stbrp_rect* packerRect = &packerRects[i];
-                    PackerInfo* packerInfo = packerInfos[packerRect->id];
-                    packerInfo->x = packerRect->x;
-                    packerInfo->y = packerRect->y;
-                }
-                packedWidth = size.x_;
-                packedHeight = size.y_;
+                packerInfo->placed = false;
+                unplaced.push_back(packerInfo);
             }
         }
-        delete[] packerRects;
-        if (!success)
-            ErrorExit("Could not allocate for all images.  The max sprite sheet texture size is " + ea::to_string(MAX_TEXTURE_SIZE) + "x" + ea::to_string(MAX_TEXTURE_SIZE) + ".");
+    }
+    else
+    {
+        for (PackerInfo* packerInfo : packerInfos)
+            unplaced.push_back(packerInfo);
     }
 
-    // create image for spritesheet
-    Image spriteSheetImage(context);
-    spriteSheetImage.SetSize(packedWidth, packedHeight, 4);
-
-    // zero out image
-    spriteSheetImage.SetData(nullptr);
-
-    XMLFile xml(context);
-    XMLElement root = xml.CreateRoot("TextureAtlas");
-    root.SetAttribute("imagePath", GetFileNameAndExtension(outputFile));
+    PackNewPages(unplaced, pageSizes, maxSize, padding, multiPage, workQueue);
 
-    for (unsigned i = 0; i < packerInfos.size(); ++i)
+    // Pages are independent, so they are composed and saved in parallel
+    workQueue->ParallelFor(pageSizes.size(), 1, [&](unsigned begin, unsigned end, unsigned)
     {
-        SharedPtr<PackerInfo> packerInfo = packerInfos[i];
-        XMLElement subTexture = root.CreateChild("SubTexture");
-        subTexture.SetString("name", packerInfo->name);
-        subTexture.SetInt("x", packerInfo->x + offsetX);
-        subTexture.SetInt("y", packerInfo->y + offsetY);
-        subTexture.SetInt("width", packerInfo->width);
-        subTexture.SetInt("height", packerInfo->height);
-
-        if (packerInfo->frameWidth || packerInfo->frameHeight)
+        for (unsigned page = begin; page < end; ++page)
         {
-            subTexture.SetInt("frameWidth", packerInfo->frameWidth);
-            subTexture.SetInt("frameHeight", packerInfo->frameHeight);
-            subTexture.SetInt("offsetX", packerInfo->offsetX);
-            subTexture.SetInt("offsetY", packerInfo->offsetY);
-        }
+            const ea::string pageFileName = GetPageFileName(outputFile, page);
+            const ea::string pageSpriteSheetFileName = GetPageFileName(spriteSheetFileName, page);
 
-        URHO3D_LOGINFO("Transferring " + packerInfo->path + " to sprite sheet.");
+            // create image for spritesheet
+            Image spriteSheetImage(context);
+            spriteSheetImage.SetSize(pageSizes[page].x_, pageSizes[page].y_, 4);
 
-        File file(context, packerInfo->path);
-        Image image(context);
-        if (!image.Load(file))
-            ErrorExit("Could not load image " + packerInfo->path + ".");
+            // zero out image
+            spriteSheetImage.SetData(nullptr);
 
-        for (int y = 0; y < packerInfo->height; ++y)
-        {
-            for (int x = 0; x < packerInfo->width; ++x)
-            {
-                unsigned color = image.GetPixelInt(x - packerInfo->offsetX, y - packerInfo->offsetY);
-                spriteSheetImage.SetPixelInt(
-                    packerInfo->x + offsetX + x,
-                    packerInfo->y + offsetY + y, color);
-            }
-        }
-    }
+            XMLFile xml(context);
+            XMLElement root = xml.CreateRoot("TextureAtlas");
+            root.SetAttribute("imagePath", GetFileNameAndExtension(pageFileName));
+            root.SetInt("width", pageSizes[page].x_);
+            root.SetInt("height", pageSizes[page].y_);
 
-    if (debug)
-    {
-        unsigned OUTER_BOUNDS_DEBUG_COLOR = Color::BLUE.ToUInt();
-        unsigned INNER_BOUNDS_DEBUG_COLOR = Color::GREEN.ToUInt();
+            for (unsigned i = 0; i < packerInfos.size(); ++i)
+            {
+                SharedPtr<PackerInfo> packerInfo = packerInfos[i];
+                if (packerInfo->page != page)
+                    continue;
+
+                XMLElement subTexture = root.CreateChild("SubTexture");
+                subTexture.SetString("name", packerInfo->name);
+                subTexture.SetInt("x", packerInfo->x + offsetX);
+                subTexture.SetInt("y", packerInfo->y + offsetY);
+                subTexture.SetInt("width", packerInfo->width);
+                subTexture.SetInt("height", packerInfo->height);
+
+                if (packerInfo->frameWidth || packerInfo->frameHeight)
+                {
+                    subTexture.SetInt("frameWidth", packerInfo->frameWidth);
+                    subTexture.SetInt("frameHeight", packerInfo->frameHeight);
+                    subTexture.SetInt("offsetX", packerInfo->offsetX);
+                    subTexture.SetInt("offsetY", packerInfo->offsetY);
+                }
 
-        URHO3D_LOGINFO("Drawing debug information.");
-        for (unsigned i = 0; i < packerInfos.size(); ++i)
-        {
-            SharedPtr<PackerInfo> packerInfo = packerInfos[i];
+                URHO3D_LOGINFO("Transferring " + packerInfo->path + " to sprite sheet " + pageFileName + ".");
 
-            // Draw outer bounds
-            for (int x = 0; x < packerInfo->frameWidth; ++x)
-            {
-                spriteSheetImage.SetPixelInt(packerInfo->x + x, packerInfo->y, OUTER_BOUNDS_DEBUG_COLOR);
-                spriteSheetImage.SetPixelInt(packerInfo->x + x, packerInfo->y + packerInfo->frameHeight, OUTER_BOUNDS_DEBUG_COLOR);
-            }
-            for (int y = 0; y < packerInfo->frameHeight; ++y)
-            {
-                spriteSheetImage.SetPixelInt(packerInfo->x, packerInfo->y + y, OUTER_BOUNDS_DEBUG_COLOR);
-                spriteSheetImage.SetPixelInt(packerInfo->x + packerInfo->frameWidth, packerInfo->y + y, OUTER_BOUNDS_DEBUG_COLOR);
+                Image* image = packerInfo->image;
+                for (int y = 0; y < packerInfo->height; ++y)
+                {
+                    for (int x = 0; x < packerInfo->width; ++x)
+                    {
+                        unsigned color = image->GetPixelInt(x - packerInfo->offsetX, y - packerInfo->offsetY);
+                        spriteSheetImage.SetPixelInt(
+                            packerInfo->x + offsetX + x,
+                            packerInfo->y + offsetY + y, color);
+                    }
+                }
             }
 
-            // Draw inner bounds
-            for (int x = 0; x < packerInfo->width; ++x)
-            {
-                spriteSheetImage.SetPixelInt(packerInfo->x + offsetX + x, packerInfo->y + offsetY, INNER_BOUNDS_DEBUG_COLOR);
-                spriteSheetImage.SetPixelInt(packerInfo->x + offsetX + x, packerInfo->y + offsetY + packerInfo->height, INNER_BOUNDS_DEBUG_COLOR);
-            }
-            for (int y = 0; y < packerInfo->height; ++y)
+            if (debug)
             {
-                spriteSheetImage.SetPixelInt(packerInfo->x + offsetX, packerInfo->y + offsetY + y, INNER_BOUNDS_DEBUG_COLOR);
-                spriteSheetImage.SetPixelInt(packerInfo->x + offsetX + packerInfo->width, packerInfo->y + offsetY + y, INNER_BOUNDS_DEBUG_COLOR);
+                unsigned OUTER_BOUNDS_DEBUG_COLOR = Color::BLUE.ToUInt();
+                unsigned INNER_BOUNDS_DEBUG_COLOR = Color::GREEN.ToUInt();
+
+                URHO3D_LOGINFO("Drawing debug information.");
+                for (unsigned i = 0; i < packerInfos.size(); ++i)
+                {
+                    SharedPtr<PackerInfo> packerInfo = packerInfos[i];
+                    if (packerInfo->page != page)
+                        continue;
+
+                    // Draw outer bounds
+                    for (int x = 0; x < packerInfo->frameWidth; ++x)
+                    {
+                        spriteSheetImage.SetPixelInt(packerInfo->x + x, packerInfo->y, OUTER_BOUNDS_DEBUG_COLOR);
+                        spriteSheetImage.SetPixelInt(packerInfo->x + x, packerInfo->y + packerInfo->frameHeight, OUTER_BOUNDS_DEBUG_COLOR);
+                    }
+                    for (int y = 0; y < packerInfo->frameHeight; ++y)
+                    {
+                        spriteSheetImage.SetPixelInt(packerInfo->x, packerInfo->y + y, OUTER_BOUNDS_DEBUG_COLOR);
+                        spriteSheetImage.SetPixelInt(packerInfo->x + packerInfo->frameWidth, packerInfo->y + y, OUTER_BOUNDS_DEBUG_COLOR);
+                    }
+
+                    // Draw inner bounds
+                    for (int x = 0; x < packerInfo->width; ++x)
+                    {
+                        spriteSheetImage.SetPixelInt(packerInfo->x + offsetX + x, packerInfo->y + offsetY, INNER_BOUNDS_DEBUG_COLOR);
+                        spriteSheetImage.SetPixelInt(packerInfo->x + offsetX + x, packerInfo->y + offsetY + packerInfo->height, INNER_BOUNDS_DEBUG_COLOR);
+                    }
+                    for (int y = 0; y < packerInfo->height; ++y)
+                    {
+                        spriteSheetImage.SetPixelInt(packerInfo->x + offsetX, packerInfo->y + offsetY + y, INNER_BOUNDS_DEBUG_COLOR);
+                        spriteSheetImage.SetPixelInt(packerInfo->x + offsetX + packerInfo->width, packerInfo->y + offsetY + y, INNER_BOUNDS_DEBUG_COLOR);
+                    }
+                }
             }
-        }
-    }
 
-    URHO3D_LOGINFO("Saving output image.");
-    spriteSheetImage.SavePNG(outputFile);
+            URHO3D_LOGINFO("Saving output image " + pageFileName + ".");
+            spriteSheetImage.SavePNG(pageFileName);
 
-    URHO3D_LOGINFO("Saving SpriteSheet xml file.");
-    File spriteSheetFile(context);
-    spriteSheetFile.Open(spriteSheetFileName, FILE_WRITE);
-    xml.Save(spriteSheetFile);
+            URHO3D_LOGINFO("Saving SpriteSheet xml file " + pageSpriteSheetFileName + ".");
+            File spriteSheetFile(context);
+            spriteSheetFile.Open(pageSpriteSheetFileName, FILE_WRITE);
+            xml.Save(spriteSheetFile);
+        }
+    });
+    workQueue->Complete(M_MAX_UNSIGNED);
 }
@@ -165,6 +165,40 @@ void UndoStack::Connect(Object* inspector, Object* modified)
             SetModifiedObject(modifiedPtr);
         }
     });
+
+    SubscribeToEvent(inspector, E_ATTRIBUTEINSPECTVALUESMODIFIED, [this, modifiedPtr=WeakPtr(modified)](StringHash, VariantMap& args)
+    {
+        if (!trackingEnabled_)
+            return;
+        using namespace AttributeInspectorValuesModified;
+        const auto& items = *reinterpret_cast<const ea::vector<Serializable*>*>(args[P_SERIALIZABLES].GetVoidPtr());
+        const auto& oldValues = *reinterpret_cast<const ea::vector<Variant>*>(args[P_OLDVALUES].GetVoidPtr());
+        const unsigned index = args[P_ATTRIBUTEINDEX].GetUInt();
+        const auto& newValue = args[P_NEWVALUE];
+
+        // Record only objects that were actually changed.
+        ea::vector<Serializable*> targets;
+        ea::vector<Variant> targetOldValues;
+        for (unsigned i = 0; i < items.size() && i < oldValues.size(); ++i)
+        {
+            if (Node* node = dynamic_cast<Node*>(items[i]))
+            {
+                if (node->HasTag("__EDITOR_OBJECT__"))
+                    continue;
+            }
+            if (oldValues[i] != newValue)
+            {
+                targets.push_back(items[i]);
+                targetOldValues.push_back(oldValues[i]);
+            }
+        }
+
+        if (!targets.empty())
+        {
+            Add<UndoEditAttributes>(targets, index, targetOldValues, newValue);
+            SetModifiedObject(modifiedPtr);
+        }
+    });
 }
 
 void UndoStack::Connect(UIElement* root, Object* modified)
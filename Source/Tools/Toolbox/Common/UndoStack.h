@@ -553,6 +553,90 @@ public:
     }
 };
 
+/// Edit of one attribute on multiple objects of the same type, recorded as a single action. Targets are resolved by ID
+/// when they belong to a scene, so that they are found after being recreated by other undo actions.
+class URHO3D_TOOLBOX_API UndoEditAttributes : public UndoAction
+{
+    struct Target
+    {
+        /// Node or component ID, 0 for other objects.
+        unsigned id_ = 0;
+        /// Whether the target is a node.
+        bool isNode_ = false;
+        /// Target that is not owned by a scene.
+        WeakPtr<Serializable> object_;
+        /// Value before the edit.
+        Variant undoValue_;
+    };
+
+    unsigned attrIndex_;
+    Variant redoValue_;
+    WeakPtr<Scene> editorScene_;
+    ea::vector<Target> targets_;
+
+public:
+    UndoEditAttributes(const ea::vector<Serializable*>& targets, unsigned index, const ea::vector<Variant>& oldValues,
+        const Variant& newValue)
+        : attrIndex_(index)
+        , redoValue_(newValue)
+    {
+        targets_.reserve(targets.size());
+        for (unsigned i = 0; i < targets.size(); ++i)
+        {
+            Target target;
+            target.undoValue_ = oldValues[i];
+            if (auto* node = dynamic_cast<Node*>(targets[i]))
+            {
+                editorScene_ = node->GetScene();
+                target.id_ = node->GetID();
+                target.isNode_ = true;
+            }
+            else if (auto* component = dynamic_cast<Component*>(targets[i]))
+            {
+                editorScene_ = component->GetScene();
+                target.id_ = component->GetID();
+            }
+            if (target.id_ == 0)
+                target.object_ = targets[i];
+            targets_.push_back(target);
+        }
+    }
+
+    Serializable* GetTarget(const Target& target)
+    {
+        if (target.id_ == 0)
+            return target.object_.Get();
+        if (editorScene_.Expired())
+            return nullptr;
+        if (target.isNode_)
+            return editorScene_->GetNode(target.id_);
+        return editorScene_->GetComponent(target.id_);
+    }
+
+    /// Set attribute of all targets, then apply attributes once per target.
+    bool Apply(bool undo)
+    {
+        ea::vector<Serializable*> modified;
+        modified.reserve(targets_.size());
+        for (const Target& target : targets_)
+        {
+            if (Serializable* object = GetTarget(target))
+            {
+                object->SetAttribute(attrIndex_, undo ? target.undoValue_ : redoValue_);
+                modified.push_back(object);
+            }
+        }
+
+        for (Serializable* object : modified)
+            object->ApplyAttributes();
+        return !modified.empty();
+    }
+
+    bool Undo(Context* context) override { return Apply(true); }
+
+    bool Redo(Context* context) override { return Apply(false); }
+};
+
 class URHO3D_TOOLBOX_API UndoCreateUIElement : public UndoAction
 {
     UIElementPath elementPath_;
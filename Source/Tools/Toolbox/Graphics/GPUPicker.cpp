@@ -0,0 +1,122 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/Graphics/Batch.h>
+#include <Urho3D/Graphics/Camera.h>
+#include <Urho3D/Graphics/Drawable.h>
+#include <Urho3D/Graphics/Graphics.h>
+#include <Urho3D/Graphics/RenderPath.h>
+#include <Urho3D/Graphics/RenderSurface.h>
+#include <Urho3D/Graphics/Texture2D.h>
+#include <Urho3D/Graphics/Viewport.h>
+#include <Urho3D/IO/Log.h>
+#include <Urho3D/Resource/ResourceCache.h>
+#include <Urho3D/Resource/XMLFile.h>
+#include <Urho3D/Scene/Scene.h>
+
+#include "GPUPicker.h"
+
+namespace Urho3D
+{
+
+GPUPicker::GPUPicker(Context* context)
+    : context_(context)
+{
+    texture_ = MakeShared<Texture2D>(context);
+    viewport_ = MakeShared<Viewport>(context);
+    // Debug geometry would overwrite object IDs.
+    viewport_->SetDrawDebug(false);
+    viewport_->SetRenderPath(context->GetSubsystem<ResourceCache>()->GetResource<XMLFile>("RenderPaths/Pick.xml"));
+}
+
+void GPUPicker::Request(Viewport* viewport, const IntVector2& size, const IntRect& rect)
+{
+    pending_ = false;
+    if (viewport == nullptr || viewport->GetScene() == nullptr || viewport->GetCamera() == nullptr)
+        return;
+
+    if (size.x_ <= 0 || size.y_ <= 0)
+        return;
+
+    if (texture_->GetWidth() != size.x_ || texture_->GetHeight() != size.y_)
+    {
+        if (!texture_->SetSize(size.x_, size.y_, Graphics::GetRGBAFormat(), TEXTURE_RENDERTARGET))
+        {
+            URHO3D_LOGERROR("Failed to create object picking texture");
+            return;
+        }
+        texture_->GetRenderSurface()->SetUpdateMode(SURFACE_MANUALUPDATE);
+    }
+
+    viewport_->SetScene(viewport->GetScene());
+    viewport_->SetCamera(viewport->GetCamera());
+    viewport_->SetRect(IntRect::ZERO);
+    texture_->GetRenderSurface()->SetViewport(0, viewport_);
+    texture_->GetRenderSurface()->QueueUpdate();
+
+    scene_ = viewport->GetScene();
+    rect_ = rect;
+    rect_.Clip(IntRect(IntVector2::ZERO, size));
+    requestFrame_ = context_->GetSubsystem<Time>()->GetFrameNumber();
+    pending_ = rect_.Width() > 0 && rect_.Height() > 0;
+}
+
+bool GPUPicker::GetResult(ea::vector<Drawable*>& result)
+{
+    result.clear();
+    if (!pending_)
+        return false;
+
+    // ID buffer is rendered at the end of request frame, read it back on a later one.
+    if (context_->GetSubsystem<Time>()->GetFrameNumber() == requestFrame_)
+        return false;
+
+    pending_ = false;
+    if (scene_.Expired())
+        return true;
+
+    const int width = texture_->GetWidth();
+    buffer_.resize(static_cast<unsigned>(width * texture_->GetHeight() * 4));
+    if (!texture_->GetData(0, buffer_.data()))
+        return true;
+
+    ea::hash_set<unsigned> visited;
+    for (int y = rect_.top_; y < rect_.bottom_; ++y)
+    {
+        const unsigned char* pixel = &buffer_[(y * width + rect_.left_) * 4];
+        for (int x = rect_.left_; x < rect_.right_; ++x, pixel += 4)
+        {
+            const unsigned id = DecodePickId(pixel);
+            if (id == 0 || !visited.insert(id).second)
+                continue;
+
+            Component* component = scene_->GetComponent(id);
+            if (component != nullptr && component->IsInstanceOf<Drawable>())
+                result.push_back(static_cast<Drawable*>(component));
+        }
+    }
+    return true;
+}
+
+}
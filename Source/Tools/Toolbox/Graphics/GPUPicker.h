@@ -0,0 +1,80 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+
+#include "ToolboxAPI.h"
+#include <Urho3D/Core/Object.h>
+#include <Urho3D/Math/Rect.h>
+
+
+namespace Urho3D
+{
+
+class Context;
+class Drawable;
+class Scene;
+class Texture2D;
+class Viewport;
+
+/// Selects objects by rendering their IDs into an offscreen texture. Readback is deferred until the frame after the
+/// request, so the GPU is not stalled in the middle of rendering the ID buffer.
+class URHO3D_TOOLBOX_API GPUPicker
+{
+public:
+    /// Construct.
+    explicit GPUPicker(Context* context);
+    /// Destruct.
+    ~GPUPicker() = default;
+    /// Request drawables visible in a rectangle of the viewport. `size` is the size of texture viewport renders to
+    /// and `rect` is in pixels of that texture. Previous pending request is discarded.
+    void Request(Viewport* viewport, const IntVector2& size, const IntRect& rect);
+    /// Cancel pending request.
+    void Cancel() { pending_ = false; }
+    /// Return true if request is waiting to be rendered or read back.
+    bool IsPending() const { return pending_; }
+    /// Return true once result of pending request is available. Picked drawables are stored into `result` ordered by
+    /// their appearance in the rectangle, top to bottom.
+    bool GetResult(ea::vector<Drawable*>& result);
+
+protected:
+    /// Context.
+    Context* context_ = nullptr;
+    /// Texture to which object IDs are rendered.
+    SharedPtr<Texture2D> texture_;
+    /// Viewport which renders object IDs.
+    SharedPtr<Viewport> viewport_;
+    /// Scene of the pending request.
+    WeakPtr<Scene> scene_;
+    /// Requested rectangle in texture pixels.
+    IntRect rect_;
+    /// Frame number when the request was made.
+    unsigned requestFrame_ = 0;
+    /// Flag indicating that request is pending.
+    bool pending_ = false;
+    /// Buffer for texture readback.
+    ea::vector<unsigned char> buffer_;
+};
+
+}
@@ -823,4 +823,130 @@ bool RenderAttributes(Serializable* item, ea::string_view filter, Object* eventS
     return false;
 }
 
+/// Return whether attribute of the item is equal to the value, comparing through the typed accessor when possible.
+static bool AttributeEquals(Serializable* item, unsigned index, const AttributeInfo& info, const Variant& value)
+{
+    if (info.accessor_ && item->HasDirectAttributeAccess(info))
+        return info.accessor_->Equals(item, value);
+    return item->GetAttribute(index) == value;
+}
+
+bool RenderAttributes(const ea::vector<Serializable*>& items, ea::string_view filter, Object* eventSender)
+{
+    if (items.empty())
+        return false;
+
+    if (items.size() == 1)
+        return RenderAttributes(items.front(), filter, eventSender);
+
+    Serializable* first = items.front();
+    if (eventSender == nullptr)
+        eventSender = first;
+
+    const ea::vector<AttributeInfo>* attributes = first->GetAttributes();
+    if (attributes == nullptr)
+        return false;
+
+    ui::IdScope itemId(first);
+
+    bool applyAttributes = false;
+    bool finished = false;
+    for (unsigned index = 0; index < attributes->size() && !finished; ++index)
+    {
+        const AttributeInfo& info = attributes->at(index);
+        // Attribute is not meant to be edited in editor.
+        if (info.mode_ & AM_NOEDIT)
+            continue;
+        // Ignore attributes not matching user-provided filter.
+        if (!filter.empty() && !info.name_.contains(filter, false))
+            continue;
+        // Ignore not supported variant types.
+        if (info.type_ == VAR_BUFFER || info.type_ == VAR_VARIANTVECTOR || info.type_ == VAR_VOIDPTR || info.type_ == VAR_PTR)
+            continue;
+        ui::IdScope attributeNameId(info.name_.c_str());
+
+        auto& modification = ValueHistory<Variant>::Get(first->GetAttribute(index));
+        Variant& value = modification.current_;
+
+        // Values are displayed from the first item. Highlight attributes whose values differ between items.
+        bool mixed = false;
+        for (unsigned i = 1; i < items.size() && !mixed; ++i)
+            mixed = !AttributeEquals(items[i], index, info, value);
+
+        Color color = mixed ? Color::YELLOW : (value == info.defaultValue_ ? Color::GRAY : Color::WHITE);
+        const char* tooltip = mixed ? "Values differ between inspected objects." : "";
+
+        AttributeInspectorModified modifiedReason = AttributeInspectorModified::NO_CHANGE;
+        bool modified = RenderAttribute(info.name_, value, color, tooltip, &info, eventSender, 0);
+
+        if (ui::BeginPopup("Attribute Menu"))
+        {
+            if (!info.defaultValue_.IsEmpty() && ui::MenuItem("Reset to default"))
+            {
+                value = info.defaultValue_;
+                modified = true;
+                modifiedReason = AttributeInspectorModified::SET_DEFAULT;
+            }
+            ImGui::EndPopup();
+        }
+
+        // Values of all items before the edit began. Kept alive for as long as the edit continues.
+        ea::vector<Variant>* oldValues = nullptr;
+        if (modified || modification.modified_)
+            oldValues = ui::GetUIState<ea::vector<Variant>>();
+
+        if (modified)
+        {
+            if (modifiedReason == AttributeInspectorModified::NO_CHANGE)
+                modifiedReason = AttributeInspectorModified::SET_BY_USER;
+
+            // Discard temporary string buffer so input field clears.
+            if (value.GetType() == VAR_STRING)
+                ui::RemoveUIState<ea::string>();
+
+            if (!modification.modified_)
+            {
+                oldValues->clear();
+                for (Serializable* item : items)
+                    oldValues->push_back(item->GetAttribute(index));
+            }
+
+            modification.SetModified(true);
+            for (Serializable* item : items)
+            {
+                if (!AttributeEquals(item, index, info, value))
+                    item->SetAttribute(index, value);
+            }
+            applyAttributes = true;
+        }
+
+        if (modification.IsModified() || modifiedReason != AttributeInspectorModified::NO_CHANGE)
+        {
+            // Continuous attribute value modification has ended, report all items at once.
+            if (oldValues != nullptr && oldValues->size() == items.size())
+            {
+                using namespace AttributeInspectorValuesModified;
+                VariantMap& args = eventSender->GetEventDataMap();
+                args[P_SERIALIZABLES] = (void*)&items;
+                args[P_ATTRIBUTEINFO] = (void*)&info;
+                args[P_ATTRIBUTEINDEX] = index;
+                args[P_OLDVALUES] = (void*)oldValues;
+                args[P_NEWVALUE] = modification.current_;
+                args[P_REASON] = (unsigned)modifiedReason;
+                eventSender->SendEvent(E_ATTRIBUTEINSPECTVALUESMODIFIED, args);
+            }
+            ui::RemoveUIState<ea::vector<Variant>>();
+            finished = true;
+        }
+    }
+
+    // Edits of this frame are applied in one pass.
+    if (applyAttributes)
+    {
+        for (Serializable* item : items)
+            item->ApplyAttributes();
+    }
+    return finished;
+}
+
 }
@@ -125,5 +125,9 @@ struct ValueHistory
 /// If `eventSender` is not null then this object will be used to send events.
 URHO3D_TOOLBOX_API bool RenderAttribute(ea::string_view title, Variant& value, const Color& color=Color::WHITE, ea::string_view tooltip="", const AttributeInfo* info=nullptr, Object* eventSender=nullptr, float item_width=0);
 URHO3D_TOOLBOX_API bool RenderAttributes(Serializable* item, ea::string_view filter="", Object* eventSender=nullptr);
+/// Render attribute inspector of multiple `items` of the same type. Values of the first item are displayed and edits are
+/// applied to all items, followed by a single ApplyAttributes() call per item. Finished edits are reported with one
+/// E_ATTRIBUTEINSPECTVALUESMODIFIED event instead of an event per item.
+URHO3D_TOOLBOX_API bool RenderAttributes(const ea::vector<Serializable*>& items, ea::string_view filter="", Object* eventSender=nullptr);
 
 }
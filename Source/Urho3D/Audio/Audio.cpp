@@ -23,14 +23,22 @@
 #include "../Precompiled.h"
 
 #include "../Audio/Audio.h"
+#include "../Audio/AudioMixing.h"
+#include "../Audio/OggVorbisSoundStream.h"
 #include "../Audio/Sound.h"
+#include "../Audio/SoundDecoder.h"
 #include "../Audio/SoundListener.h"
 #include "../Audio/SoundSource3D.h"
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
 #include "../Core/ProcessUtils.h"
+#include "../Core/MemoryTracker.h"
 #include "../Core/Profiler.h"
+#include "../Engine/Engine.h"
 #include "../IO/Log.h"
+#include "../Resource/ResourceCache.h"
+
+#include <EASTL/sort.h>
 
 #include <SDL/SDL.h>
 
@@ -63,7 +71,8 @@ Audio::Audio(Context* context) :
     // Register Audio library object factories
     RegisterAudioLibrary(context_);
 
-    SubscribeToEvent(E_RENDERUPDATE, URHO3D_HANDLER(Audio, HandleRenderUpdate));
+    if (auto* engine = GetSubsystem<Engine>())
+        engine->onRenderUpdate_.Subscribe(this, &Audio::HandleRenderUpdate);
 }
 
 Audio::~Audio()
@@ -118,7 +127,8 @@ bool Audio::SetMode(int bufferLengthMSec, int mixRate, bool stereo, bool interpo
     fragmentSize_ = Min(NextPowerOfTwo((unsigned)mixRate >> 6u), (unsigned)obtained.samples);
     mixRate_ = obtained.freq;
     interpolation_ = interpolation;
-    clipBuffer_.reset(new int[stereo ? fragmentSize_ << 1u : fragmentSize_]);
+    clipBuffer_.reset(new float[stereo ? fragmentSize_ << 1u : fragmentSize_]);
+    sourceBuffer_.reset(new float[fragmentSize_ << 1u]);
 
     URHO3D_LOGINFO("Set audio mode " + ea::to_string(mixRate_) + " Hz " + (stereo_ ? "stereo" : "mono") + " " +
             (interpolation_ ? "interpolated" : ""));
@@ -128,6 +138,16 @@ bool Audio::SetMode(int bufferLengthMSec, int mixRate, bool stereo, bool interpo
 
 void Audio::Update(float timeStep)
 {
+    MemoryTagScope memoryTag(MEMORY_TAG_AUDIO);
+
+    FlushCommands();
+
+#ifdef URHO3D_THREADING
+    // Streams released by the flushed commands may be no longer in use
+    if (decoder_)
+        decoder_->Update();
+#endif
+
     if (!playing_)
         return;
 
@@ -169,24 +189,27 @@ void Audio::SetMasterGain(const ea::string& type, float gain)
 
 void Audio::PauseSoundType(const ea::string& type)
 {
-    MutexLock lock(audioMutex_);
     pausedSoundTypes_.insert(type);
+    for (SoundSource* source : soundSources_)
+        source->UpdateMixParams();
 }
 
 void Audio::ResumeSoundType(const ea::string& type)
 {
-    MutexLock lock(audioMutex_);
+    // Update sound sources before resuming playback to make sure 3D positions are up to date. Each source publishes
+    // its unpaused state together with the updated parameters, so nothing is mixed before it is ready
     pausedSoundTypes_.erase(type);
-    // Update sound sources before resuming playback to make sure 3D positions are up to date
-    // Done under mutex to ensure no mixing happens before we are ready
     UpdateInternal(0.0f);
+    for (SoundSource* source : soundSources_)
+        source->UpdateMixParams();
 }
 
 void Audio::ResumeAll()
 {
-    MutexLock lock(audioMutex_);
     pausedSoundTypes_.clear();
     UpdateInternal(0.0f);
+    for (SoundSource* source : soundSources_)
+        source->UpdateMixParams();
 }
 
 void Audio::SetListener(SoundListener* listener)
@@ -203,6 +226,43 @@ void Audio::StopSound(Sound* sound)
     }
 }
 
+void Audio::SetNumDecoderThreads(unsigned numThreads)
+{
+    numDecoderThreads_ = Max(numThreads, 1u);
+#ifdef URHO3D_THREADING
+    if (decoder_)
+        decoder_->SetNumThreads(numDecoderThreads_);
+#endif
+}
+
+void Audio::SetSoundCacheBudget(unsigned long long budget)
+{
+    if (auto* cache = GetSubsystem<ResourceCache>())
+        cache->SetMemoryBudget(Sound::GetTypeStatic(), budget);
+}
+
+void Audio::DecodeAhead(OggVorbisSoundStream* stream)
+{
+#ifdef URHO3D_THREADING
+    if (!stream || decodeAheadTime_ <= 0.0f)
+        return;
+
+    if (!decoder_)
+    {
+        decoder_ = new SoundDecoder();
+        decoder_->SetNumThreads(numDecoderThreads_);
+    }
+
+    decoder_->AddStream(stream, (unsigned)(stream->GetSampleSize() * stream->GetFrequency() * decodeAheadTime_));
+#endif
+}
+
+unsigned long long Audio::GetSoundCacheBudget() const
+{
+    auto* cache = GetSubsystem<ResourceCache>();
+    return cache ? cache->GetMemoryBudget(Sound::GetTypeStatic()) : 0;
+}
+
 float Audio::GetMasterGain(const ea::string& type) const
 {
     // By definition previously unknown types return full volume
@@ -225,8 +285,12 @@ SoundListener* Audio::GetListener() const
 
 void Audio::AddSoundSource(SoundSource* soundSource)
 {
-    MutexLock lock(audioMutex_);
     soundSources_.push_back(soundSource);
+
+    SoundCommand command;
+    command.type_ = SoundCommandType::ADD_VOICE;
+    command.voice_ = soundSource->GetVoice();
+    SendCommand(command);
 }
 
 void Audio::RemoveSoundSource(SoundSource* soundSource)
@@ -234,11 +298,98 @@ void Audio::RemoveSoundSource(SoundSource* soundSource)
     auto i = soundSources_.find(soundSource);
     if (i != soundSources_.end())
     {
-        MutexLock lock(audioMutex_);
         soundSources_.erase(i);
+
+        SoundCommand command;
+        command.type_ = SoundCommandType::REMOVE_VOICE;
+        command.voice_ = soundSource->GetVoice();
+        SendCommand(command);
+        RetireObject(nullptr, command.voice_);
     }
 }
 
+void Audio::SendCommand(const SoundCommand& command)
+{
+    // Without audio output there is no audio thread, execute right away
+    if (!deviceID_)
+    {
+        ExecuteCommand(command);
+        return;
+    }
+
+    // Keep the order of commands if some are already waiting for free space in the queue
+    ++numCommandsSent_;
+    if (!pendingCommands_.empty() || !commands_.Push(command))
+        pendingCommands_.push_back(command);
+}
+
+void Audio::RetireObject(RefCounted* object, SoundVoice* voice)
+{
+    const unsigned numExecuted = numCommandsExecuted_.load(std::memory_order_acquire);
+    if (!deviceID_ || numExecuted == numCommandsSent_)
+    {
+        // Audio thread has nothing that may refer to the object, release right away
+        SharedPtr<RefCounted> objectPtr(object);
+        delete voice;
+        return;
+    }
+
+    RetiredObject& retired = retiredObjects_.emplace_back();
+    retired.fence_ = numCommandsSent_;
+    retired.object_ = object;
+    retired.voice_ = voice;
+}
+
+void Audio::ExecuteCommands()
+{
+    SoundCommand command;
+    unsigned numExecuted = 0;
+    while (commands_.Pop(command))
+    {
+        ExecuteCommand(command);
+        ++numExecuted;
+    }
+
+    if (numExecuted)
+        numCommandsExecuted_.fetch_add(numExecuted, std::memory_order_release);
+}
+
+void Audio::ExecuteCommand(const SoundCommand& command)
+{
+    switch (command.type_)
+    {
+    case SoundCommandType::ADD_VOICE:
+        voices_.push_back(command.voice_);
+        break;
+
+    case SoundCommandType::REMOVE_VOICE:
+        voices_.erase_first_unsorted(command.voice_);
+        break;
+
+    default:
+        command.voice_->Execute(command);
+        break;
+    }
+}
+
+void Audio::FlushCommands()
+{
+    unsigned numPushed = 0;
+    while (numPushed < pendingCommands_.size() && commands_.Push(pendingCommands_[numPushed]))
+        ++numPushed;
+    pendingCommands_.erase(pendingCommands_.begin(), pendingCommands_.begin() + numPushed);
+
+    // Objects are retired in order, so stop at the first one that may still be in use
+    const unsigned numExecuted = numCommandsExecuted_.load(std::memory_order_acquire);
+    unsigned numReleased = 0;
+    while (numReleased < retiredObjects_.size() && (int)(numExecuted - retiredObjects_[numReleased].fence_) >= 0)
+    {
+        delete retiredObjects_[numReleased].voice_;
+        ++numReleased;
+    }
+    retiredObjects_.erase(retiredObjects_.begin(), retiredObjects_.begin() + numReleased);
+}
+
 float Audio::GetSoundSourceMasterGain(StringHash typeHash) const
 {
     auto masterIt = masterGain_.find(SOUND_MASTER_HASH);
@@ -257,14 +408,16 @@ float Audio::GetSoundSourceMasterGain(StringHash typeHash) const
 void SDLAudioCallback(void* userdata, Uint8* stream, int len)
 {
     auto* audio = static_cast<Audio*>(userdata);
-    {
-        MutexLock Lock(audio->GetMutex());
-        audio->MixOutput(stream, len / audio->GetSampleSize());
-    }
+    audio->MixOutput(stream, len / audio->GetSampleSize());
 }
 
 void Audio::MixOutput(void* dest, unsigned samples)
 {
+    MemoryTagScope memoryTag(MEMORY_TAG_AUDIO);
+
+    // Commands are executed even when output is stopped, so that the main thread may release retired objects
+    ExecuteCommands();
+
     if (!playing_ || !clipBuffer_)
     {
         memset(dest, 0, samples * (size_t)sampleSize_);
@@ -280,37 +433,22 @@ void Audio::MixOutput(void* dest, unsigned samples)
             clipSamples <<= 1;
 
         // Clear clip buffer
-        int* clipPtr = clipBuffer_.get();
-        memset(clipPtr, 0, clipSamples * sizeof(int));
+        float* clipPtr = clipBuffer_.get();
+        memset(clipPtr, 0, clipSamples * sizeof(float));
 
         // Mix samples to clip buffer
-        for (auto i = soundSources_.begin(); i != soundSources_.end(); ++i)
-        {
-            SoundSource* source = *i;
-
-            // Check for pause if necessary
-            if (!pausedSoundTypes_.empty())
-            {
-                if (pausedSoundTypes_.contains(source->GetSoundType()))
-                    continue;
-            }
-
-            source->Mix(clipPtr, workSamples, mixRate_, stereo_, interpolation_);
-        }
+        for (SoundVoice* voice : voices_)
+            voice->Mix(clipPtr, sourceBuffer_.get(), workSamples, mixRate_, stereo_, interpolation_);
         // Copy output from clip buffer to destination
-        auto* destPtr = (short*)dest;
-        while (clipSamples--)
-            *destPtr++ = (short)Clamp(*clipPtr++, -32768, 32767);
+        ConvertSamplesToShort(clipPtr, (short*)dest, clipSamples);
         samples -= workSamples;
         ((unsigned char*&)dest) += sampleSize_ * workSamples;
     }
 }
 
-void Audio::HandleRenderUpdate(StringHash eventType, VariantMap& eventData)
+void Audio::HandleRenderUpdate(UpdateEventArgs& args)
 {
-    using namespace RenderUpdate;
-
-    Update(eventData[P_TIMESTEP].GetFloat());
+    Update(args.timeStep_);
 }
 
 void Audio::Release()
@@ -322,6 +460,15 @@ void Audio::Release()
         SDL_CloseAudioDevice(deviceID_);
         deviceID_ = 0;
         clipBuffer_.reset();
+        sourceBuffer_.reset();
+
+        // Audio thread is gone, catch up with the commands it has not executed and release everything retired
+        ExecuteCommands();
+        for (const SoundCommand& command : pendingCommands_)
+            ExecuteCommand(command);
+        numCommandsExecuted_.fetch_add(pendingCommands_.size(), std::memory_order_relaxed);
+        pendingCommands_.clear();
+        FlushCommands();
     }
 }
 
@@ -343,6 +490,43 @@ void Audio::UpdateInternal(float timeStep)
 
         source->Update(timeStep);
     }
+
+    UpdateVoices();
+}
+
+void Audio::UpdateVoices()
+{
+    // Sources that are not audible or do not fit into the voice budget keep playing as virtual voices: their playback
+    // position advances on the audio thread but they are neither resampled nor mixed.
+    voiceCandidates_.clear();
+    numVirtualVoices_ = 0;
+    for (SoundSource* source : soundSources_)
+    {
+        if (!source->IsPlaying() || (!pausedSoundTypes_.empty() && pausedSoundTypes_.contains(source->GetSoundType())))
+            continue;
+
+        if (source->GetEffectiveGain() < INAUDIBLE_GAIN)
+        {
+            source->SetVirtual(true);
+            ++numVirtualVoices_;
+        }
+        else
+            voiceCandidates_.push_back(source);
+    }
+
+    if (maxVoices_ && voiceCandidates_.size() > maxVoices_)
+    {
+        ea::sort(voiceCandidates_.begin(), voiceCandidates_.end(), [](const SoundSource* lhs, const SoundSource* rhs)
+        {
+            if (lhs->GetPriority() != rhs->GetPriority())
+                return lhs->GetPriority() > rhs->GetPriority();
+            return lhs->GetEffectiveGain() > rhs->GetEffectiveGain();
+        });
+        numVirtualVoices_ += voiceCandidates_.size() - maxVoices_;
+    }
+
+    for (unsigned i = 0; i < voiceCandidates_.size(); ++i)
+        voiceCandidates_[i]->SetVirtual(maxVoices_ && i >= maxVoices_);
 }
 
 void RegisterAudioLibrary(Context* context)
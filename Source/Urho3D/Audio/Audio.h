@@ -26,16 +26,20 @@
 #include <EASTL/hash_set.h>
 
 #include "../Audio/AudioDefs.h"
-#include "../Core/Mutex.h"
+#include "../Audio/SoundVoice.h"
+#include "../Container/SPSCQueue.h"
 #include "../Core/Object.h"
 
 namespace Urho3D
 {
 
 class AudioImpl;
+class OggVorbisSoundStream;
 class Sound;
+class SoundDecoder;
 class SoundListener;
 class SoundSource;
+struct UpdateEventArgs;
 
 /// %Audio subsystem.
 class URHO3D_API Audio : public Object
@@ -68,6 +72,16 @@ public:
     void SetListener(SoundListener* listener);
     /// Stop any sound source playing a certain sound clip.
     void StopSound(Sound* sound);
+    /// Set maximum number of mixed voices. Playing sources beyond the limit are played as virtual voices, lowest priority and gain first. Zero means unlimited.
+    void SetMaxVoices(unsigned count) { maxVoices_ = count; }
+    /// Set how far ahead compressed sound streams are decoded, in seconds. Applies to streams started afterwards.
+    void SetDecodeAheadTime(float time) { decodeAheadTime_ = Max(time, 0.0f); }
+    /// Set number of threads decoding compressed sound streams ahead. Default 1.
+    void SetNumDecoderThreads(unsigned numThreads);
+    /// Set memory budget of the compressed and uncompressed sounds kept in the resource cache. Least recently used unused sounds are released first. Zero means unlimited.
+    void SetSoundCacheBudget(unsigned long long budget);
+    /// Decode compressed sound stream ahead on the decoder threads, so that the audio thread only copies decoded data. Called by Sound.
+    void DecodeAhead(OggVorbisSoundStream* stream);
 
     /// Return byte size of one sample.
     unsigned GetSampleSize() const { return sampleSize_; }
@@ -82,11 +96,26 @@ public:
     bool IsStereo() const { return stereo_; }
 
     /// Return whether audio is being output.
-    bool IsPlaying() const { return playing_; }
+    bool IsPlaying() const { return playing_.load(std::memory_order_relaxed); }
 
     /// Return whether an audio stream has been reserved.
     bool IsInitialized() const { return deviceID_ != 0; }
 
+    /// Return maximum number of mixed voices.
+    unsigned GetMaxVoices() const { return maxVoices_; }
+
+    /// Return number of playing sources that were played as virtual voices on last update.
+    unsigned GetNumVirtualVoices() const { return numVirtualVoices_; }
+
+    /// Return how far ahead compressed sound streams are decoded, in seconds.
+    float GetDecodeAheadTime() const { return decodeAheadTime_; }
+
+    /// Return number of threads decoding compressed sound streams ahead.
+    unsigned GetNumDecoderThreads() const { return numDecoderThreads_; }
+
+    /// Return memory budget of the sounds kept in the resource cache.
+    unsigned long long GetSoundCacheBudget() const;
+
     /// Return master gain for a specific sound source type. Unknown sound types will return full gain (1).
     float GetMasterGain(const ea::string& type) const;
 
@@ -107,8 +136,17 @@ public:
     /// Remove a sound source. Called by SoundSource.
     void RemoveSoundSource(SoundSource* soundSource);
 
-    /// Return audio thread mutex.
-    Mutex& GetMutex() { return audioMutex_; }
+    /// Send command to the audio thread. Executed immediately if there is no audio output. Called by SoundSource.
+    void SendCommand(const SoundCommand& command);
+    /// Release object once the audio thread has executed all commands sent so far. Called by SoundSource.
+    template <class T> void ReleaseWhenUnused(SharedPtr<T>& object)
+    {
+        if (object)
+        {
+            RetireObject(object.Get(), nullptr);
+            object.Reset();
+        }
+    }
 
     /// Return sound type specific gain multiplied by master gain.
     float GetSoundSourceMasterGain(StringHash typeHash) const;
@@ -117,17 +155,50 @@ public:
     void MixOutput(void* dest, unsigned samples);
 
 private:
-    /// Handle render update event.
-    void HandleRenderUpdate(StringHash eventType, VariantMap& eventData);
+    /// Handle render update signal.
+    void HandleRenderUpdate(UpdateEventArgs& args);
     /// Stop sound output and release the sound buffer.
     void Release();
     /// Actually update sound sources with the specific timestep. Called internally.
     void UpdateInternal(float timeStep);
-
-    /// Clipping buffer for mixing.
-    ea::unique_ptr<int[]> clipBuffer_;
-    /// Audio thread mutex.
-    Mutex audioMutex_;
+    /// Choose which playing sources are mixed and which are played as virtual voices. Called internally.
+    void UpdateVoices();
+    /// Release object and/or delete voice once the audio thread has executed all commands sent so far.
+    void RetireObject(RefCounted* object, SoundVoice* voice);
+    /// Execute commands sent by the main thread. Called by the thread that mixes.
+    void ExecuteCommands();
+    /// Execute one command. Called by the thread that mixes.
+    void ExecuteCommand(const SoundCommand& command);
+    /// Send commands that did not fit into the queue and release objects the audio thread no longer uses.
+    void FlushCommands();
+
+    /// Object waiting for the audio thread to execute the commands that were sent before it was released.
+    struct RetiredObject
+    {
+        /// Number of commands that must be executed before release.
+        unsigned fence_{};
+        /// Released object.
+        SharedPtr<RefCounted> object_;
+        /// Deleted voice.
+        SoundVoice* voice_{};
+    };
+
+    /// Float buffer for mixing.
+    ea::unique_ptr<float[]> clipBuffer_;
+    /// Float buffer for resampled data of one sound source.
+    ea::unique_ptr<float[]> sourceBuffer_;
+    /// Commands from the main thread to the audio thread.
+    SPSCQueue<SoundCommand> commands_{1024};
+    /// Commands that did not fit into the queue, sent on next update.
+    ea::vector<SoundCommand> pendingCommands_;
+    /// Number of commands sent by the main thread.
+    unsigned numCommandsSent_{};
+    /// Number of commands executed by the audio thread.
+    std::atomic<unsigned> numCommandsExecuted_{};
+    /// Voices mixed by the audio thread. Only accessed by the thread that mixes.
+    ea::vector<SoundVoice*> voices_;
+    /// Objects waiting for release.
+    ea::vector<RetiredObject> retiredObjects_;
     /// SDL audio device ID.
     unsigned deviceID_{};
     /// Sample size.
@@ -141,13 +212,25 @@ private:
     /// Stereo flag.
     bool stereo_{};
     /// Playing flag.
-    bool playing_{};
+    std::atomic<bool> playing_{};
     /// Master gain by sound source type.
     ea::unordered_map<StringHash, Variant> masterGain_;
     /// Paused sound types.
     ea::hash_set<StringHash> pausedSoundTypes_;
     /// Sound sources.
     ea::vector<SoundSource*> soundSources_;
+    /// Audible sound sources competing for voices. Kept to avoid allocation on every update.
+    ea::vector<SoundSource*> voiceCandidates_;
+    /// Maximum number of mixed voices, zero if unlimited.
+    unsigned maxVoices_{};
+    /// Number of virtual voices on last update.
+    unsigned numVirtualVoices_{};
+    /// Decode-ahead time of compressed sound streams in seconds. Zero disables decode-ahead.
+    float decodeAheadTime_{0.25f};
+    /// Number of decoder threads.
+    unsigned numDecoderThreads_{1};
+    /// Decoder of compressed sound streams, created on first use.
+    SharedPtr<SoundDecoder> decoder_;
     /// Sound listener.
     WeakPtr<SoundListener> listener_;
 };
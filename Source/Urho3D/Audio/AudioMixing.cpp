@@ -0,0 +1,205 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Audio/AudioMixing.h"
+#include "../Math/MathDefs.h"
+
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define URHO3D_AUDIO_NEON
+#endif
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+void ConvertSamplesToFloat(const short* src, float* dest, unsigned count)
+{
+    unsigned i = 0;
+#ifdef URHO3D_SSE
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        // Interleave with itself and shift down to sign extend
+        const __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+        const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+        _mm_storeu_ps(dest + i, _mm_cvtepi32_ps(low));
+        _mm_storeu_ps(dest + i + 4, _mm_cvtepi32_ps(high));
+    }
+#elif defined(URHO3D_AUDIO_NEON)
+    for (; i + 8 <= count; i += 8)
+    {
+        const int16x8_t samples = vld1q_s16(src + i);
+        vst1q_f32(dest + i, vcvtq_f32_s32(vmovl_s16(vget_low_s16(samples))));
+        vst1q_f32(dest + i + 4, vcvtq_f32_s32(vmovl_s16(vget_high_s16(samples))));
+    }
+#endif
+    for (; i < count; ++i)
+        dest[i] = (float)src[i];
+}
+
+void ConvertSamplesToFloat(const signed char* src, float* dest, unsigned count)
+{
+    for (unsigned i = 0; i < count; ++i)
+        dest[i] = (float)src[i] * 256.0f;
+}
+
+void ConvertSamplesToShort(const float* src, short* dest, unsigned count)
+{
+    unsigned i = 0;
+#ifdef URHO3D_SSE
+    // Clamp before conversion, out of range floats convert to INT_MIN
+    const __m128 minValue = _mm_set1_ps(-32768.0f);
+    const __m128 maxValue = _mm_set1_ps(32767.0f);
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m128 low = _mm_max_ps(_mm_min_ps(_mm_loadu_ps(src + i), maxValue), minValue);
+        const __m128 high = _mm_max_ps(_mm_min_ps(_mm_loadu_ps(src + i + 4), maxValue), minValue);
+        const __m128i samples = _mm_packs_epi32(_mm_cvtps_epi32(low), _mm_cvtps_epi32(high));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), samples);
+    }
+#elif defined(URHO3D_AUDIO_NEON)
+    // Round to nearest like the other paths, plain conversion truncates. Saturating narrowing does the clamping
+#if defined(__aarch64__)
+    for (; i + 4 <= count; i += 4)
+        vst1_s16(dest + i, vqmovn_s32(vcvtnq_s32_f32(vld1q_f32(src + i))));
+#else
+    const uint32x4_t signMask = vdupq_n_u32(0x80000000u);
+    const uint32x4_t half = vreinterpretq_u32_f32(vdupq_n_f32(0.5f));
+    for (; i + 4 <= count; i += 4)
+    {
+        // Add 0.5 with the sign of the sample, then truncate
+        const float32x4_t samples = vld1q_f32(src + i);
+        const uint32x4_t signedHalf = vorrq_u32(vandq_u32(vreinterpretq_u32_f32(samples), signMask), half);
+        vst1_s16(dest + i, vqmovn_s32(vcvtq_s32_f32(vaddq_f32(samples, vreinterpretq_f32_u32(signedHalf)))));
+    }
+#endif
+#endif
+    for (; i < count; ++i)
+        dest[i] = (short)RoundToInt(Clamp(src[i], -32768.0f, 32767.0f));
+}
+
+void MixSamplesMonoToMono(float* dest, const float* src, unsigned frames, float gain)
+{
+    unsigned i = 0;
+#ifdef URHO3D_SSE
+    const __m128 gains = _mm_set1_ps(gain);
+    for (; i + 4 <= frames; i += 4)
+        _mm_storeu_ps(dest + i, _mm_add_ps(_mm_loadu_ps(dest + i), _mm_mul_ps(_mm_loadu_ps(src + i), gains)));
+#elif defined(URHO3D_AUDIO_NEON)
+    const float32x4_t gains = vdupq_n_f32(gain);
+    for (; i + 4 <= frames; i += 4)
+        vst1q_f32(dest + i, vmlaq_f32(vld1q_f32(dest + i), vld1q_f32(src + i), gains));
+#endif
+    for (; i < frames; ++i)
+        dest[i] += src[i] * gain;
+}
+
+void MixSamplesMonoToStereo(float* dest, const float* src, unsigned frames, float leftGain, float rightGain)
+{
+    unsigned i = 0;
+#ifdef URHO3D_SSE
+    const __m128 gains = _mm_setr_ps(leftGain, rightGain, leftGain, rightGain);
+    for (; i + 4 <= frames; i += 4)
+    {
+        const __m128 samples = _mm_loadu_ps(src + i);
+        float* out = dest + i * 2;
+        _mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), _mm_mul_ps(_mm_unpacklo_ps(samples, samples), gains)));
+        _mm_storeu_ps(out + 4, _mm_add_ps(_mm_loadu_ps(out + 4), _mm_mul_ps(_mm_unpackhi_ps(samples, samples), gains)));
+    }
+#elif defined(URHO3D_AUDIO_NEON)
+    const float gainValues[4] = { leftGain, rightGain, leftGain, rightGain };
+    const float32x4_t gains = vld1q_f32(gainValues);
+    for (; i + 4 <= frames; i += 4)
+    {
+        const float32x4_t samples = vld1q_f32(src + i);
+        const float32x4x2_t pairs = vzipq_f32(samples, samples);
+        float* out = dest + i * 2;
+        vst1q_f32(out, vmlaq_f32(vld1q_f32(out), pairs.val[0], gains));
+        vst1q_f32(out + 4, vmlaq_f32(vld1q_f32(out + 4), pairs.val[1], gains));
+    }
+#endif
+    for (; i < frames; ++i)
+    {
+        dest[i * 2] += src[i] * leftGain;
+        dest[i * 2 + 1] += src[i] * rightGain;
+    }
+}
+
+void MixSamplesStereoToMono(float* dest, const float* src, unsigned frames, float gain)
+{
+    const float halfGain = gain * 0.5f;
+    unsigned i = 0;
+#ifdef URHO3D_SSE
+    const __m128 gains = _mm_set1_ps(halfGain);
+    for (; i + 4 <= frames; i += 4)
+    {
+        const __m128 first = _mm_loadu_ps(src + i * 2);
+        const __m128 second = _mm_loadu_ps(src + i * 2 + 4);
+        const __m128 left = _mm_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 right = _mm_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(dest + i, _mm_add_ps(_mm_loadu_ps(dest + i), _mm_mul_ps(_mm_add_ps(left, right), gains)));
+    }
+#elif defined(URHO3D_AUDIO_NEON)
+    const float32x4_t gains = vdupq_n_f32(halfGain);
+    for (; i + 4 <= frames; i += 4)
+    {
+        const float32x4x2_t channels = vuzpq_f32(vld1q_f32(src + i * 2), vld1q_f32(src + i * 2 + 4));
+        vst1q_f32(dest + i, vmlaq_f32(vld1q_f32(dest + i), vaddq_f32(channels.val[0], channels.val[1]), gains));
+    }
+#endif
+    for (; i < frames; ++i)
+        dest[i] += (src[i * 2] + src[i * 2 + 1]) * halfGain;
+}
+
+void MixSamplesStereoToStereo(float* dest, const float* src, unsigned frames, float leftGain, float rightGain)
+{
+    unsigned i = 0;
+#ifdef URHO3D_SSE
+    const __m128 gains = _mm_setr_ps(leftGain, rightGain, leftGain, rightGain);
+    for (; i + 2 <= frames; i += 2)
+    {
+        float* out = dest + i * 2;
+        _mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), _mm_mul_ps(_mm_loadu_ps(src + i * 2), gains)));
+    }
+#elif defined(URHO3D_AUDIO_NEON)
+    const float gainValues[4] = { leftGain, rightGain, leftGain, rightGain };
+    const float32x4_t gains = vld1q_f32(gainValues);
+    for (; i + 2 <= frames; i += 2)
+    {
+        float* out = dest + i * 2;
+        vst1q_f32(out, vmlaq_f32(vld1q_f32(out), vld1q_f32(src + i * 2), gains));
+    }
+#endif
+    for (; i < frames; ++i)
+    {
+        dest[i * 2] += src[i * 2] * leftGain;
+        dest[i * 2 + 1] += src[i * 2 + 1] * rightGain;
+    }
+}
+
+}
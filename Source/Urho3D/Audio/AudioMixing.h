@@ -0,0 +1,48 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include <Urho3D/Urho3D.h>
+
+namespace Urho3D
+{
+
+/// Convert 16-bit samples to float samples.
+URHO3D_API void ConvertSamplesToFloat(const short* src, float* dest, unsigned count);
+/// Convert 8-bit samples to float samples in 16-bit range.
+URHO3D_API void ConvertSamplesToFloat(const signed char* src, float* dest, unsigned count);
+/// Convert float samples to 16-bit samples with rounding and saturation.
+URHO3D_API void ConvertSamplesToShort(const float* src, short* dest, unsigned count);
+
+/// Mix mono samples with gain into mono buffer.
+URHO3D_API void MixSamplesMonoToMono(float* dest, const float* src, unsigned frames, float gain);
+/// Mix mono samples with left and right gain into stereo buffer.
+URHO3D_API void MixSamplesMonoToStereo(float* dest, const float* src, unsigned frames, float leftGain, float rightGain);
+/// Mix stereo samples with gain into mono buffer. Left and right channels are averaged.
+URHO3D_API void MixSamplesStereoToMono(float* dest, const float* src, unsigned frames, float gain);
+/// Mix stereo samples with left and right gain into stereo buffer.
+URHO3D_API void MixSamplesStereoToStereo(float* dest, const float* src, unsigned frames, float leftGain, float rightGain);
+
+}
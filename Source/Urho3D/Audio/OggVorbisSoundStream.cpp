@@ -64,6 +64,14 @@ bool OggVorbisSoundStream::Seek(unsigned sample_number)
     if (!decoder_)
         return false;
 
+    if (ringMask_)
+    {
+        // Decoder is owned by the decoding thread, so only request the seek. Silence is produced until it is done
+        seekSample_.store(sample_number, std::memory_order_relaxed);
+        numSeeksRequested_.fetch_add(1, std::memory_order_release);
+        return true;
+    }
+
     auto* vorbis = static_cast<stb_vorbis*>(decoder_);
 
     return stb_vorbis_seek(vorbis, sample_number) == 1;
@@ -74,6 +82,68 @@ unsigned OggVorbisSoundStream::GetData(signed char* dest, unsigned numBytes)
     if (!decoder_)
         return 0;
 
+    if (ringMask_)
+        return ReadAhead(dest, numBytes);
+
+    return Decode(dest, numBytes);
+}
+
+void OggVorbisSoundStream::SetDecodeAhead(unsigned numBytes)
+{
+    if (!decoder_)
+        return;
+
+    // Power of two size keeps the sample frames aligned when wrapping around
+    const unsigned size = NextPowerOfTwo(Max(numBytes, 4u));
+    ring_.reset(new signed char[size]);
+    ringMask_ = size - 1;
+}
+
+unsigned OggVorbisSoundStream::DecodeAhead(unsigned maxBytes)
+{
+    if (!ringMask_ || decoding_.exchange(true, std::memory_order_acquire))
+        return 0;
+
+    const unsigned numSeeksRequested = numSeeksRequested_.load(std::memory_order_acquire);
+    if (numSeeksRequested != numSeeksDone_.load(std::memory_order_relaxed))
+    {
+        stb_vorbis_seek(static_cast<stb_vorbis*>(decoder_), seekSample_.load(std::memory_order_relaxed));
+        ended_.store(false, std::memory_order_relaxed);
+        seekWritePosition_.store(writePosition_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        numSeeksDone_.store(numSeeksRequested, std::memory_order_release);
+    }
+
+    // Keep whole sample frames when limiting the amount
+    maxBytes &= ~3u;
+    const unsigned ringSize = ringMask_ + 1;
+    unsigned writePosition = writePosition_.load(std::memory_order_relaxed);
+    unsigned numDecoded = 0;
+    while (numDecoded < maxBytes && !ended_.load(std::memory_order_relaxed))
+    {
+        // Decode into the contiguous free space up to the end of the ring buffer
+        const unsigned freeSize = ringSize - (writePosition - readPosition_.load(std::memory_order_acquire));
+        const unsigned offset = writePosition & ringMask_;
+        const unsigned numBytes = Min(Min(freeSize, ringSize - offset), maxBytes - numDecoded);
+        if (!numBytes)
+            break;
+
+        const unsigned outBytes = Decode(ring_.get() + offset, numBytes);
+        writePosition += outBytes;
+        numDecoded += outBytes;
+        writePosition_.store(writePosition, std::memory_order_release);
+
+        if (!outBytes)
+            ended_.store(true, std::memory_order_release);
+        else if (outBytes < numBytes)
+            break;
+    }
+
+    decoding_.store(false, std::memory_order_release);
+    return numDecoded;
+}
+
+unsigned OggVorbisSoundStream::Decode(signed char* dest, unsigned numBytes)
+{
     auto* vorbis = static_cast<stb_vorbis*>(decoder_);
 
     unsigned channels = stereo_ ? 2 : 1;
@@ -93,4 +163,42 @@ unsigned OggVorbisSoundStream::GetData(signed char* dest, unsigned numBytes)
     return outBytes;
 }
 
+unsigned OggVorbisSoundStream::ReadAhead(signed char* dest, unsigned numBytes)
+{
+    // While a seek is pending, the buffered data is stale
+    const unsigned numSeeksDone = numSeeksDone_.load(std::memory_order_acquire);
+    if (numSeeksDone != numSeeksRequested_.load(std::memory_order_relaxed))
+    {
+        memset(dest, 0, numBytes);
+        return numBytes;
+    }
+
+    unsigned readPosition = readPosition_.load(std::memory_order_relaxed);
+    if (numSeeksDone != numSeeksApplied_)
+    {
+        numSeeksApplied_ = numSeeksDone;
+        readPosition = seekWritePosition_.load(std::memory_order_relaxed);
+    }
+
+    // End flag must be observed before the write position, so that no data written before it is missed
+    const bool ended = ended_.load(std::memory_order_acquire);
+    const unsigned writePosition = writePosition_.load(std::memory_order_acquire);
+
+    const unsigned copySize = Min(writePosition - readPosition, numBytes);
+    const unsigned offset = readPosition & ringMask_;
+    const unsigned firstPart = Min(copySize, ringMask_ + 1 - offset);
+    memcpy(dest, ring_.get() + offset, firstPart);
+    memcpy(dest + firstPart, ring_.get(), copySize - firstPart);
+    readPosition_.store(readPosition + copySize, std::memory_order_release);
+
+    if (copySize < numBytes && !ended)
+    {
+        // Decoder fell behind, produce silence instead of ending the playback
+        memset(dest + copySize, 0, numBytes - copySize);
+        return numBytes;
+    }
+
+    return copySize;
+}
+
 }
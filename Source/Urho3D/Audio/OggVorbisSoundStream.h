@@ -23,15 +23,20 @@
 #pragma once
 
 #include <EASTL/shared_array.h>
+#include <EASTL/unique_ptr.h>
 
 #include "../Audio/SoundStream.h"
+#include "../Math/MathDefs.h"
+
+#include <atomic>
 
 namespace Urho3D
 {
 
 class Sound;
 
-/// Ogg Vorbis sound stream.
+/// Ogg Vorbis sound stream. Decodes in the mixing thread by default. When decode-ahead is enabled, a SoundDecoder worker
+/// decodes into a ring buffer and the mixing thread only copies from it.
 class URHO3D_API OggVorbisSoundStream : public SoundStream
 {
 public:
@@ -46,13 +51,49 @@ public:
     /// Produce sound data into destination. Return number of bytes produced. Called by SoundSource from the mixing thread.
     unsigned GetData(signed char* dest, unsigned numBytes) override;
 
+    /// Enable decode-ahead into a ring buffer of at least the specified size in bytes. Must be called before playback.
+    void SetDecodeAhead(unsigned numBytes);
+    /// Decode ahead until the ring buffer is full, the stream ends or at most maxBytes are decoded. Return number of bytes decoded. Safe to call from any thread, concurrent calls return zero.
+    unsigned DecodeAhead(unsigned maxBytes = M_MAX_UNSIGNED);
+
+    /// Return whether decode-ahead is enabled.
+    bool IsDecodedAhead() const { return ringMask_ != 0; }
+
 protected:
+    /// Decode samples directly from the decoder. Rewind if looping. Return number of bytes produced.
+    unsigned Decode(signed char* dest, unsigned numBytes);
+    /// Copy decoded data from the ring buffer. Called from the mixing thread.
+    unsigned ReadAhead(signed char* dest, unsigned numBytes);
+
     /// Decoder state.
     void* decoder_;
     /// Compressed sound data.
     ea::shared_array<signed char> data_;
     /// Compressed sound data size in bytes.
     unsigned dataSize_;
+
+    /// Ring buffer of decoded data.
+    ea::unique_ptr<signed char[]> ring_;
+    /// Ring buffer index mask, zero if decode-ahead is disabled.
+    unsigned ringMask_{};
+    /// Bytes read from the ring buffer. Written by the mixing thread.
+    alignas(64) std::atomic<unsigned> readPosition_{};
+    /// Bytes written to the ring buffer. Written by the decoding thread.
+    alignas(64) std::atomic<unsigned> writePosition_{};
+    /// Whether the decoder has reached the end of a non-looping stream.
+    std::atomic<bool> ended_{};
+    /// Whether a thread is decoding.
+    std::atomic<bool> decoding_{};
+    /// Sample number of the last seek request.
+    std::atomic<unsigned> seekSample_{};
+    /// Number of seek requests. Written by the mixing thread.
+    std::atomic<unsigned> numSeeksRequested_{};
+    /// Number of seek requests performed by the decoding thread.
+    std::atomic<unsigned> numSeeksDone_{};
+    /// Ring buffer write position when the last seek was performed. Data before it is stale.
+    std::atomic<unsigned> seekWritePosition_{};
+    /// Number of performed seeks already observed by the mixing thread.
+    unsigned numSeeksApplied_{};
 };
 
 }
@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Audio/Audio.h"
 #include "../Audio/OggVorbisSoundStream.h"
 #include "../Audio/Sound.h"
 #include "../Core/Context.h"
@@ -312,7 +313,14 @@ void Sound::FixInterpolation()
 
 SharedPtr<SoundStream> Sound::GetDecoderStream() const
 {
-    return compressed_ ? SharedPtr<SoundStream>(new OggVorbisSoundStream(this)) : SharedPtr<SoundStream>();
+    if (!compressed_)
+        return SharedPtr<SoundStream>();
+
+    SharedPtr<OggVorbisSoundStream> stream(new OggVorbisSoundStream(this));
+    // Keep Vorbis decoding out of the audio thread when possible
+    if (auto* audio = GetSubsystem<Audio>())
+        audio->DecodeAhead(stream);
+    return stream;
 }
 
 float Sound::GetLength() const
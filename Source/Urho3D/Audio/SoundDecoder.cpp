@@ -0,0 +1,170 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifdef URHO3D_THREADING
+
+#include "../Precompiled.h"
+
+#include "../Audio/OggVorbisSoundStream.h"
+#include "../Audio/SoundDecoder.h"
+#include "../Core/MemoryTracker.h"
+#include "../Core/Timer.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+/// Length of data decoded right away when stream is added, so that playback does not start with silence.
+static const unsigned PRIME_LENGTH_MS = 50;
+/// Sleep time of decoding threads when there is nothing to decode.
+static const unsigned IDLE_SLEEP_MS = 2;
+
+SoundDecoderWorker::SoundDecoderWorker(SoundDecoder* decoder, unsigned index) :
+    Thread("SoundDecoder"),
+    decoder_(decoder),
+    index_(index)
+{
+}
+
+void SoundDecoderWorker::ThreadFunction()
+{
+    MemoryTagScope memoryTag(MEMORY_TAG_AUDIO);
+
+    while (shouldRun_)
+    {
+        decoder_->GetStreams(streams_);
+
+        // Start from different streams on each thread, streams that are already being decoded are skipped
+        unsigned numDecoded = 0;
+        const unsigned numStreams = streams_.size();
+        for (unsigned i = 0; i < numStreams; ++i)
+            numDecoded += streams_[(i + index_) % numStreams]->DecodeAhead();
+
+        streams_.clear();
+        numIterations_.fetch_add(1, std::memory_order_release);
+        if (!numDecoded)
+            Time::Sleep(IDLE_SLEEP_MS);
+    }
+}
+
+SoundDecoder::~SoundDecoder()
+{
+    numThreads_ = 0;
+    UpdateThreads();
+}
+
+void SoundDecoder::AddStream(OggVorbisSoundStream* stream, unsigned bufferSize)
+{
+    stream->SetDecodeAhead(bufferSize);
+    if (!stream->IsDecodedAhead())
+        return;
+
+    stream->DecodeAhead(stream->GetSampleSize() * stream->GetIntFrequency() * PRIME_LENGTH_MS / 1000);
+
+    streams_.emplace_back(stream);
+    {
+        MutexLock lock(streamsMutex_);
+        decodedStreams_.push_back(stream);
+    }
+
+    if (workers_.empty())
+        UpdateThreads();
+}
+
+void SoundDecoder::SetNumThreads(unsigned numThreads)
+{
+    numThreads_ = Max(numThreads, 1u);
+    if (!workers_.empty())
+        UpdateThreads();
+}
+
+void SoundDecoder::Update()
+{
+    // Release retired streams once every decoding thread has finished the iteration it may have taken them on
+    if (!retiredStreams_.empty())
+    {
+        for (unsigned i = 0; i < retiredIterations_.size(); ++i)
+        {
+            if (workers_[i]->GetNumIterations() == retiredIterations_[i])
+                return;
+        }
+        retiredStreams_.clear();
+    }
+
+    // Streams referenced only by the decoder are no longer played
+    for (unsigned i = streams_.size() - 1; i < streams_.size(); --i)
+    {
+        if (streams_[i]->Refs() == 1)
+        {
+            retiredStreams_.push_back(ea::move(streams_[i]));
+            streams_.erase_unsorted(streams_.begin() + i);
+        }
+    }
+
+    if (retiredStreams_.empty())
+        return;
+
+    {
+        MutexLock lock(streamsMutex_);
+        decodedStreams_.assign(streams_.begin(), streams_.end());
+    }
+
+    retiredIterations_.resize(workers_.size());
+    for (unsigned i = 0; i < workers_.size(); ++i)
+        retiredIterations_[i] = workers_[i]->GetNumIterations();
+}
+
+void SoundDecoder::GetStreams(ea::vector<OggVorbisSoundStream*>& streams)
+{
+    MutexLock lock(streamsMutex_);
+    streams.assign(decodedStreams_.begin(), decodedStreams_.end());
+}
+
+unsigned SoundDecoder::GetNumStreams() const
+{
+    return streams_.size();
+}
+
+void SoundDecoder::UpdateThreads()
+{
+    while (workers_.size() > numThreads_)
+    {
+        workers_.back()->Stop();
+        workers_.pop_back();
+    }
+
+    // Stopped threads no longer access the retired streams
+    if (retiredIterations_.size() > workers_.size())
+        retiredIterations_.resize(workers_.size());
+
+    while (workers_.size() < numThreads_)
+    {
+        auto worker = ea::make_unique<SoundDecoderWorker>(this, workers_.size());
+        worker->Run();
+        workers_.push_back(ea::move(worker));
+    }
+}
+
+}
+
+#endif
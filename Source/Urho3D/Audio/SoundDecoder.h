@@ -0,0 +1,110 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include "../Container/Ptr.h"
+#include "../Core/Mutex.h"
+#include "../Core/Thread.h"
+
+#include <EASTL/unique_ptr.h>
+#include <EASTL/vector.h>
+
+#include <atomic>
+
+namespace Urho3D
+{
+
+class OggVorbisSoundStream;
+class SoundDecoder;
+
+/// Thread of the sound decoder.
+class URHO3D_API SoundDecoderWorker : public Thread
+{
+public:
+    /// Construct.
+    SoundDecoderWorker(SoundDecoder* decoder, unsigned index);
+
+    /// Stream decoding loop.
+    void ThreadFunction() override;
+    /// Return number of finished decoding iterations. Streams taken on an iteration are not accessed after it.
+    unsigned GetNumIterations() const { return numIterations_.load(std::memory_order_acquire); }
+
+private:
+    /// Sound decoder.
+    SoundDecoder* decoder_;
+    /// Worker index, used to spread the workers over the streams.
+    unsigned index_;
+    /// Streams to decode on current iteration.
+    ea::vector<OggVorbisSoundStream*> streams_;
+    /// Number of finished decoding iterations.
+    std::atomic<unsigned> numIterations_{};
+};
+
+/// Pool of threads that decode compressed sound streams ahead of playback, so that the mixing thread only copies
+/// decoded data. Owned by Audio. Stream references are held and released only by the main thread, the decoding
+/// threads use plain pointers.
+class URHO3D_API SoundDecoder : public RefCounted
+{
+public:
+    /// Construct.
+    SoundDecoder() = default;
+    /// Destruct. Stop the decoding threads.
+    ~SoundDecoder() override;
+
+    /// Enable decode-ahead on the stream with the ring buffer of specified size and decode it while it is in use.
+    void AddStream(OggVorbisSoundStream* stream, unsigned bufferSize);
+    /// Set number of decoding threads. Default 1.
+    void SetNumThreads(unsigned numThreads);
+    /// Stop decoding streams that are no longer in use and release them once the decoding threads are done with them. Called by Audio from the main thread.
+    void Update();
+    /// Copy the decoded streams to the vector. Called by the decoding threads.
+    void GetStreams(ea::vector<OggVorbisSoundStream*>& streams);
+
+    /// Return number of decoding threads.
+    unsigned GetNumThreads() const { return numThreads_; }
+    /// Return number of decoded streams. Called from the main thread.
+    unsigned GetNumStreams() const;
+
+private:
+    /// Start or stop threads to match the requested number.
+    void UpdateThreads();
+
+    /// Mutex for the decoded stream list.
+    mutable Mutex streamsMutex_;
+    /// Streams in use. Accessed only by the main thread.
+    ea::vector<SharedPtr<OggVorbisSoundStream>> streams_;
+    /// Decoded streams taken by the decoding threads, same as streams_.
+    ea::vector<OggVorbisSoundStream*> decodedStreams_;
+    /// Streams no longer in use, kept alive until the decoding threads have finished the iterations that may have taken them.
+    ea::vector<SharedPtr<OggVorbisSoundStream>> retiredStreams_;
+    /// Number of finished iterations of each decoding thread when the streams were retired.
+    ea::vector<unsigned> retiredIterations_;
+    /// Number of decoding threads.
+    unsigned numThreads_{1};
+    /// Decoding threads, started when the first stream is added.
+    ea::vector<ea::unique_ptr<SoundDecoderWorker>> workers_;
+};
+
+}
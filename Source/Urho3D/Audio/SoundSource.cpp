@@ -19,7 +19,6 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 //
-
 #include "../Precompiled.h"
 
 #include "../Audio/Audio.h"
@@ -27,6 +26,7 @@
 #include "../Audio/Sound.h"
 #include "../Audio/SoundSource.h"
 #include "../Audio/SoundStream.h"
+#include "../Audio/SoundVoice.h"
 #include "../Core/Context.h"
 #include "../IO/Log.h"
 #include "../Resource/ResourceCache.h"
@@ -38,64 +38,6 @@
 namespace Urho3D
 {
 
-#define INC_POS_LOOPED() \
-    pos += intAdd; \
-    fractPos += fractAdd; \
-    if (fractPos > 65535) \
-    { \
-        fractPos &= 65535; \
-        ++pos; \
-    } \
-    while (pos >= end) \
-        pos -= (end - repeat); \
-
-#define INC_POS_ONESHOT() \
-    pos += intAdd; \
-    fractPos += fractAdd; \
-    if (fractPos > 65535) \
-    { \
-        fractPos &= 65535; \
-        ++pos; \
-    } \
-    if (pos >= end) \
-    { \
-        pos = 0; \
-        break; \
-    } \
-
-#define INC_POS_STEREO_LOOPED() \
-    pos += ((unsigned)intAdd << 1u); \
-    fractPos += fractAdd; \
-    if (fractPos > 65535) \
-    { \
-        fractPos &= 65535; \
-        pos += 2; \
-    } \
-    while (pos >= end) \
-        pos -= (end - repeat); \
-
-#define INC_POS_STEREO_ONESHOT() \
-    pos += ((unsigned)intAdd << 1u); \
-    fractPos += fractAdd; \
-    if (fractPos > 65535) \
-    { \
-        fractPos &= 65535; \
-        pos += 2; \
-    } \
-    if (pos >= end) \
-    { \
-        pos = 0; \
-        break; \
-    } \
-
-#define GET_IP_SAMPLE() (((((int)pos[1] - (int)pos[0]) * fractPos) / 65536) + (int)pos[0])
-
-#define GET_IP_SAMPLE_LEFT() (((((int)pos[2] - (int)pos[0]) * fractPos) / 65536) + (int)pos[0])
-
-#define GET_IP_SAMPLE_RIGHT() (((((int)pos[3] - (int)pos[1]) * fractPos) / 65536) + (int)pos[1])
-
-static const int STREAM_SAFETY_SAMPLES = 4;
-
 extern const char* AUDIO_CATEGORY;
 
 extern const char* autoRemoveModeNames[];
@@ -108,16 +50,15 @@ SoundSource::SoundSource(Context* context) :
     attenuation_(1.0f),
     panning_(0.0f),
     sendFinishedEvent_(false),
-    autoRemove_(REMOVE_DISABLED),
-    position_(nullptr),
-    fractPosition_(0),
-    timePosition_(0.0f),
-    unusedStreamSize_(0)
+    autoRemove_(REMOVE_DISABLED)
 {
     audio_ = GetSubsystem<Audio>();
 
     if (audio_)
+    {
+        voice_ = new SoundVoice();
         audio_->AddSoundSource(this);
+    }
 
     UpdateMasterGain();
 }
@@ -125,7 +66,15 @@ SoundSource::SoundSource(Context* context) :
 SoundSource::~SoundSource()
 {
     if (audio_)
+    {
+        // Audio thread may still be mixing, so the voice and the resources it uses are released once it lets go of them
         audio_->RemoveSoundSource(this);
+        audio_->ReleaseWhenUnused(sound_);
+        audio_->ReleaseWhenUnused(soundStream_);
+        audio_->ReleaseWhenUnused(streamBuffer_);
+    }
+    else
+        delete voice_;
 }
 
 void SoundSource::RegisterObject(Context* context)
@@ -142,6 +91,7 @@ void SoundSource::RegisterObject(Context* context)
     URHO3D_ACCESSOR_ATTRIBUTE("Is Playing", IsPlaying, SetPlayingAttr, bool, false, AM_DEFAULT);
     URHO3D_ENUM_ATTRIBUTE("Autoremove Mode", autoRemove_, autoRemoveModeNames, REMOVE_DISABLED, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Play Position", GetPositionAttr, SetPositionAttr, int, 0, AM_FILE);
+    URHO3D_ATTRIBUTE("Priority", int, priority_, 0, AM_DEFAULT);
 }
 
 void SoundSource::Seek(float seekTime)
@@ -160,11 +110,12 @@ void SoundSource::Seek(float seekTime)
     }
     else
     {
-        // Ogg format
-        if (soundStream_->Seek((unsigned)(seekTime * soundStream_->GetFrequency())))
-        {
-            timePosition_ = seekTime;
-        }
+        // Ogg format. The stream is decoded by the audio thread, so it is seeked there
+        SoundCommand command;
+        command.type_ = SoundCommandType::SEEK;
+        command.voice_ = voice_;
+        command.timePosition_ = seekTime;
+        audio_->SendCommand(command);
     }
 }
 
@@ -177,14 +128,7 @@ void SoundSource::Play(Sound* sound)
     if (frequency_ == 0.0f && sound)
         SetFrequency(sound->GetFrequency());
 
-    // If sound source is currently playing, have to lock the audio mutex
-    if (position_)
-    {
-        MutexLock lock(audio_->GetMutex());
-        PlayLockless(sound);
-    }
-    else
-        PlayLockless(sound);
+    PlayInternal(sound);
 
     // Forget the Sound & Is Playing attribute previous values so that they will be sent again, triggering
     // the sound correctly on network clients even after the initial playback
@@ -233,21 +177,11 @@ void SoundSource::Play(SoundStream* stream)
     if (frequency_ == 0.0f && stream)
         SetFrequency(stream->GetFrequency());
 
+    // When stream playback is explicitly requested, clear the existing sound if any
     SharedPtr<SoundStream> streamPtr(stream);
-
-    // If sound source is currently playing, have to lock the audio mutex. When stream playback is explicitly
-    // requested, clear the existing sound if any
-    if (position_)
-    {
-        MutexLock lock(audio_->GetMutex());
-        sound_.Reset();
-        PlayLockless(streamPtr);
-    }
-    else
-    {
-        sound_.Reset();
-        PlayLockless(streamPtr);
-    }
+    SharedPtr<Sound> oldSound = ea::move(sound_);
+    PlayInternal(streamPtr);
+    audio_->ReleaseWhenUnused(oldSound);
 
     // Stream playback is not supported for network replication, no need to mark network dirty
 }
@@ -257,14 +191,7 @@ void SoundSource::Stop()
     if (!audio_)
         return;
 
-    // If sound source is currently playing, have to lock the audio mutex
-    if (position_)
-    {
-        MutexLock lock(audio_->GetMutex());
-        StopLockless();
-    }
-    else
-        StopLockless();
+    StopInternal();
 
     MarkNetworkUpdate();
 }
@@ -284,24 +211,34 @@ void SoundSource::SetSoundType(const ea::string& type)
 void SoundSource::SetFrequency(float frequency)
 {
     frequency_ = Clamp(frequency, 0.0f, 535232.0f);
+    UpdateMixParams();
     MarkNetworkUpdate();
 }
 
 void SoundSource::SetGain(float gain)
 {
     gain_ = Max(gain, 0.0f);
+    UpdateMixParams();
     MarkNetworkUpdate();
 }
 
 void SoundSource::SetAttenuation(float attenuation)
 {
     attenuation_ = Clamp(attenuation, 0.0f, 1.0f);
+    UpdateMixParams();
     MarkNetworkUpdate();
 }
 
 void SoundSource::SetPanning(float panning)
 {
     panning_ = Clamp(panning, -1.0f, 1.0f);
+    UpdateMixParams();
+    MarkNetworkUpdate();
+}
+
+void SoundSource::SetPriority(int priority)
+{
+    priority_ = priority;
     MarkNetworkUpdate();
 }
 
@@ -313,7 +250,26 @@ void SoundSource::SetAutoRemoveMode(AutoRemoveMode mode)
 
 bool SoundSource::IsPlaying() const
 {
-    return (sound_ || soundStream_) && position_ != nullptr;
+    return playing_ && voice_ && voice_->GetFinishedPlayId() != playId_;
+}
+
+volatile signed char* SoundSource::GetPlayPosition() const
+{
+    if (!IsPlaying())
+        return nullptr;
+    // Report requested position until the audio thread starts the playback
+    if (voice_->GetStartedPlayId() != playId_)
+        return startPosition_;
+    return voice_->GetPosition();
+}
+
+float SoundSource::GetTimePosition() const
+{
+    if (!voice_)
+        return 0.0f;
+    if (voice_->GetStartedPlayId() != playId_)
+        return startTimePosition_;
+    return voice_->GetTimePosition();
 }
 
 void SoundSource::SetPlayPosition(signed char* pos)
@@ -322,22 +278,36 @@ void SoundSource::SetPlayPosition(signed char* pos)
     if (!audio_ || !sound_ || soundStream_)
         return;
 
-    MutexLock lock(audio_->GetMutex());
-    SetPlayPositionLockless(pos);
+    signed char* start = sound_->GetStart();
+    signed char* end = sound_->GetEnd();
+    if (pos < start)
+        pos = start;
+    if (sound_->IsSixteenBit() && (pos - start) & 1u)
+        ++pos;
+    if (pos > end)
+        pos = end;
+
+    // Playback restarts from the new position
+    playing_ = true;
+    SendPlayCommand(pos, ((float)(int)(size_t)(pos - start)) / (sound_->GetSampleSize() * sound_->GetFrequency()));
 }
 
 void SoundSource::Update(float timeStep)
 {
+    // Attributes may have been changed directly, bypassing the setters
+    UpdateMixParams();
+
     if (!audio_ || (!IsEnabledEffective() && node_ != nullptr))
         return;
 
-    // If there is no actual audio output, perform fake mixing into a nonexistent buffer to check stopping/looping
+    // If there is no actual audio output, the voice is owned by the main thread. Perform fake mixing to check
+    // stopping/looping
     if (!audio_->IsInitialized())
-        MixNull(timeStep);
+        voice_->MixNull(timeStep);
 
     // Free the stream if playback has stopped
-    if (soundStream_ && !position_)
-        StopLockless();
+    if (soundStream_ && !IsPlaying())
+        ReleaseStream();
 
     bool playing = IsPlaying();
 
@@ -363,104 +333,32 @@ void SoundSource::Update(float timeStep)
     }
 }
 
-void SoundSource::Mix(int dest[], unsigned samples, int mixRate, bool stereo, bool interpolation)
+void SoundSource::UpdateMasterGain()
 {
-    if (!position_ || (!sound_ && !soundStream_) || (!IsEnabledEffective() && node_ != nullptr))
-        return;
-
-    int streamFilledSize, outBytes;
-
-    if (soundStream_ && streamBuffer_)
-    {
-        int streamBufferSize = streamBuffer_->GetDataSize();
-        // Calculate how many bytes of stream sound data is needed
-        auto neededSize = (int)((float)samples * frequency_ / (float)mixRate);
-        // Add a little safety buffer. Subtract previous unused data
-        neededSize += STREAM_SAFETY_SAMPLES;
-        neededSize *= soundStream_->GetSampleSize();
-        neededSize -= unusedStreamSize_;
-        neededSize = Clamp(neededSize, 0, streamBufferSize - unusedStreamSize_);
-
-        // Always start play position at the beginning of the stream buffer
-        position_ = streamBuffer_->GetStart();
-
-        // Request new data from the stream
-        signed char* destination = streamBuffer_->GetStart() + unusedStreamSize_;
-        outBytes = neededSize ? soundStream_->GetData(destination, (unsigned)neededSize) : 0;
-        destination += outBytes;
-        // Zero-fill rest if stream did not produce enough data
-        if (outBytes < neededSize)
-            memset(destination, 0, (size_t)(neededSize - outBytes));
-
-        // Calculate amount of total bytes of data in stream buffer now, to know how much went unused after mixing
-        streamFilledSize = neededSize + unusedStreamSize_;
-    }
-
-    // If streaming, play the stream buffer. Otherwise play the original sound
-    Sound* sound = soundStream_ ? streamBuffer_ : sound_;
-    if (!sound)
-        return;
-
-    // Choose the correct mixing routine
-    if (!sound->IsStereo())
-    {
-        if (interpolation)
-        {
-            if (stereo)
-                MixMonoToStereoIP(sound, dest, samples, mixRate);
-            else
-                MixMonoToMonoIP(sound, dest, samples, mixRate);
-        }
-        else
-        {
-            if (stereo)
-                MixMonoToStereo(sound, dest, samples, mixRate);
-            else
-                MixMonoToMono(sound, dest, samples, mixRate);
-        }
-    }
-    else
-    {
-        if (interpolation)
-        {
-            if (stereo)
-                MixStereoToStereoIP(sound, dest, samples, mixRate);
-            else
-                MixStereoToMonoIP(sound, dest, samples, mixRate);
-        }
-        else
-        {
-            if (stereo)
-                MixStereoToStereo(sound, dest, samples, mixRate);
-            else
-                MixStereoToMono(sound, dest, samples, mixRate);
-        }
-    }
-
-    // Update the time position. In stream mode, copy unused data back to the beginning of the stream buffer
-    if (soundStream_)
-    {
-        timePosition_ += ((float)samples / (float)mixRate) * frequency_ / soundStream_->GetFrequency();
-
-        unusedStreamSize_ = Max(streamFilledSize - (int)(size_t)(position_ - streamBuffer_->GetStart()), 0);
-        if (unusedStreamSize_)
-            memcpy(streamBuffer_->GetStart(), (const void*)position_, (size_t)unusedStreamSize_);
+    if (audio_)
+        masterGain_ = audio_->GetSoundSourceMasterGain(soundType_);
+    UpdateMixParams();
+}
 
-        // If stream did not produce any data, stop if applicable
-        if (!outBytes && soundStream_->GetStopAtEnd())
-        {
-            position_ = nullptr;
-            return;
-        }
-    }
-    else if (sound_)
-        timePosition_ = ((float)(int)(size_t)(position_ - sound_->GetStart())) / (sound_->GetSampleSize() * sound_->GetFrequency());
+void SoundSource::SetVirtual(bool enable)
+{
+    virtual_ = enable;
+    UpdateMixParams();
 }
 
-void SoundSource::UpdateMasterGain()
+void SoundSource::UpdateMixParams()
 {
-    if (audio_)
-        masterGain_ = audio_->GetSoundSourceMasterGain(soundType_);
+    if (!voice_)
+        return;
+
+    SoundVoiceParams params;
+    params.frequency_ = frequency_;
+    params.gain_ = GetEffectiveGain();
+    params.panning_ = panning_;
+    params.virtual_ = virtual_;
+    params.paused_ = audio_ && audio_->IsSoundTypePaused(soundType_);
+    params.enabled_ = IsEnabledEffective() || node_ == nullptr;
+    voice_->SetParams(params);
 }
 
 void SoundSource::SetSoundAttr(const ResourceRef& value)
@@ -472,8 +370,9 @@ void SoundSource::SetSoundAttr(const ResourceRef& value)
     else
     {
         // When changing the sound and not playing, free previous sound stream and stream buffer (if any)
-        soundStream_.Reset();
-        streamBuffer_.Reset();
+        ReleaseStream();
+        if (audio_)
+            audio_->ReleaseWhenUnused(sound_);
         sound_ = newSound;
     }
 }
@@ -502,17 +401,15 @@ ResourceRef SoundSource::GetSoundAttr() const
 
 int SoundSource::GetPositionAttr() const
 {
-    if (sound_ && position_)
-        return (int)(GetPlayPosition() - sound_->GetStart());
+    volatile signed char* position = GetPlayPosition();
+    if (sound_ && position && !soundStream_)
+        return (int)(position - sound_->GetStart());
     else
         return 0;
 }
 
-void SoundSource::PlayLockless(Sound* sound)
+void SoundSource::PlayInternal(Sound* sound)
 {
-    // Reset the time position in any case
-    timePosition_ = 0.0f;
-
     if (sound)
     {
         if (!sound->IsCompressed())
@@ -521,37 +418,48 @@ void SoundSource::PlayLockless(Sound* sound)
             signed char* start = sound->GetStart();
             if (start)
             {
-                // Free existing stream & stream buffer if any
-                soundStream_.Reset();
-                streamBuffer_.Reset();
+                // Previous sound, stream & stream buffer are released once the audio thread starts the new playback
+                SharedPtr<Sound> oldSound = ea::move(sound_);
+                SharedPtr<SoundStream> oldStream = ea::move(soundStream_);
+                SharedPtr<Sound> oldStreamBuffer = ea::move(streamBuffer_);
+
                 sound_ = sound;
-                position_ = start;
-                fractPosition_ = 0;
+                playing_ = true;
                 sendFinishedEvent_ = true;
+                // Start audible, voice budget is applied on next audio update
+                SetVirtual(false);
+                SendPlayCommand(start, 0.0f);
+
+                audio_->ReleaseWhenUnused(oldSound);
+                audio_->ReleaseWhenUnused(oldStream);
+                audio_->ReleaseWhenUnused(oldStreamBuffer);
                 return;
             }
         }
         else
         {
             // Compressed sound start
-            PlayLockless(sound->GetDecoderStream());
+            SharedPtr<Sound> oldSound(sound_);
             sound_ = sound;
+            PlayInternal(sound->GetDecoderStream());
+            audio_->ReleaseWhenUnused(oldSound);
             return;
         }
     }
 
     // If sound pointer is null or if sound has no data, stop playback
-    StopLockless();
-    sound_.Reset();
+    StopInternal();
+    audio_->ReleaseWhenUnused(sound_);
 }
 
-void SoundSource::PlayLockless(const SharedPtr<SoundStream>& stream)
+void SoundSource::PlayInternal(const SharedPtr<SoundStream>& stream)
 {
-    // Reset the time position in any case
-    timePosition_ = 0.0f;
-
     if (stream)
     {
+        // Previous stream & stream buffer are released once the audio thread starts the new playback
+        SharedPtr<SoundStream> oldStream = ea::move(soundStream_);
+        SharedPtr<Sound> oldStreamBuffer = ea::move(streamBuffer_);
+
         // Setup the stream buffer
         unsigned sampleSize = stream->GetSampleSize();
         unsigned streamBufferSize = sampleSize * stream->GetIntFrequency() * STREAM_BUFFER_LENGTH / 1000;
@@ -562,725 +470,66 @@ void SoundSource::PlayLockless(const SharedPtr<SoundStream>& stream)
         streamBuffer_->SetLooped(true);
 
         soundStream_ = stream;
-        unusedStreamSize_ = 0;
-        position_ = streamBuffer_->GetStart();
-        fractPosition_ = 0;
+        playing_ = true;
         sendFinishedEvent_ = true;
-        return;
-    }
-
-    // If stream pointer is null, stop playback
-    StopLockless();
-}
+        SetVirtual(false);
+        SendPlayCommand(streamBuffer_->GetStart(), 0.0f);
 
-void SoundSource::StopLockless()
-{
-    position_ = nullptr;
-    timePosition_ = 0.0f;
-
-    // Free the sound stream and decode buffer if a stream was playing
-    soundStream_.Reset();
-    streamBuffer_.Reset();
-}
-
-void SoundSource::SetPlayPositionLockless(signed char* pos)
-{
-    // Setting position on a stream is not supported
-    if (!sound_ || soundStream_)
+        audio_->ReleaseWhenUnused(oldStream);
+        audio_->ReleaseWhenUnused(oldStreamBuffer);
         return;
-
-    signed char* start = sound_->GetStart();
-    signed char* end = sound_->GetEnd();
-    if (pos < start)
-        pos = start;
-    if (sound_->IsSixteenBit() && (pos - start) & 1u)
-        ++pos;
-    if (pos > end)
-        pos = end;
-
-    position_ = pos;
-    timePosition_ = ((float)(int)(size_t)(pos - sound_->GetStart())) / (sound_->GetSampleSize() * sound_->GetFrequency());
-}
-
-void SoundSource::MixMonoToMono(Sound* sound, int dest[], unsigned samples, int mixRate)
-{
-    float totalGain = masterGain_ * attenuation_ * gain_;
-    auto vol = RoundToInt(256.0f * totalGain);
-    if (!vol)
-    {
-        MixZeroVolume(sound, samples, mixRate);
-        return;
-    }
-
-    float add = frequency_ / (float)mixRate;
-    auto intAdd = (int)add;
-    auto fractAdd = (int)((add - floorf(add)) * 65536.0f);
-    int fractPos = fractPosition_;
-
-    if (sound->IsSixteenBit())
-    {
-        auto* pos = (short*)position_;
-        auto* end = (short*)sound->GetEnd();
-        auto* repeat = (short*)sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                *dest = *dest + (*pos * vol) / 256;
-                ++dest;
-                INC_POS_LOOPED();
-            }
-            position_ = (signed char*)pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                *dest = *dest + (*pos * vol) / 256;
-                ++dest;
-                INC_POS_ONESHOT();
-            }
-            position_ = (signed char*)pos;
-        }
-    }
-    else
-    {
-        auto* pos = (signed char*)position_;
-        signed char* end = sound->GetEnd();
-        signed char* repeat = sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                *dest = *dest + *pos * vol;
-                ++dest;
-                INC_POS_LOOPED();
-            }
-            position_ = pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                *dest = *dest + *pos * vol;
-                ++dest;
-                INC_POS_ONESHOT();
-            }
-            position_ = pos;
-        }
-    }
-    fractPosition_ = fractPos;
-}
-
-void SoundSource::MixMonoToStereo(Sound* sound, int dest[], unsigned samples, int mixRate)
-{
-    float totalGain = masterGain_ * attenuation_ * gain_;
-    auto leftVol = (int)((-panning_ + 1.0f) * (256.0f * totalGain + 0.5f));
-    auto rightVol = (int)((panning_ + 1.0f) * (256.0f * totalGain + 0.5f));
-    if (!leftVol && !rightVol)
-    {
-        MixZeroVolume(sound, samples, mixRate);
-        return;
-    }
-
-    float add = frequency_ / (float)mixRate;
-    auto intAdd = (int)add;
-    auto fractAdd = (int)((add - floorf(add)) * 65536.0f);
-    int fractPos = fractPosition_;
-
-    if (sound->IsSixteenBit())
-    {
-        auto* pos = (short*)position_;
-        auto* end = (short*)sound->GetEnd();
-        auto* repeat = (short*)sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                *dest = *dest + (*pos * leftVol) / 256;
-                ++dest;
-                *dest = *dest + (*pos * rightVol) / 256;
-                ++dest;
-                INC_POS_LOOPED();
-            }
-            position_ = (signed char*)pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                *dest = *dest + (*pos * leftVol) / 256;
-                ++dest;
-                *dest = *dest + (*pos * rightVol) / 256;
-                ++dest;
-                INC_POS_ONESHOT();
-            }
-            position_ = (signed char*)pos;
-        }
     }
-    else
-    {
-        auto* pos = (signed char*)position_;
-        signed char* end = sound->GetEnd();
-        signed char* repeat = sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                *dest = *dest + *pos * leftVol;
-                ++dest;
-                *dest = *dest + *pos * rightVol;
-                ++dest;
-                INC_POS_LOOPED();
-            }
-            position_ = pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                *dest = *dest + *pos * leftVol;
-                ++dest;
-                *dest = *dest + *pos * rightVol;
-                ++dest;
-                INC_POS_ONESHOT();
-            }
-            position_ = pos;
-        }
-    }
-
-    fractPosition_ = fractPos;
-}
-
-void SoundSource::MixMonoToMonoIP(Sound* sound, int dest[], unsigned samples, int mixRate)
-{
-    float totalGain = masterGain_ * attenuation_ * gain_;
-    auto vol = RoundToInt(256.0f * totalGain);
-    if (!vol)
-    {
-        MixZeroVolume(sound, samples, mixRate);
-        return;
-    }
-
-    float add = frequency_ / (float)mixRate;
-    auto intAdd = (int)add;
-    auto fractAdd = (int)((add - floorf(add)) * 65536.0f);
-    int fractPos = fractPosition_;
-
-    if (sound->IsSixteenBit())
-    {
-        auto* pos = (short*)position_;
-        auto* end = (short*)sound->GetEnd();
-        auto* repeat = (short*)sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                *dest = *dest + (GET_IP_SAMPLE() * vol) / 256;
-                ++dest;
-                INC_POS_LOOPED();
-            }
-            position_ = (signed char*)pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                *dest = *dest + (GET_IP_SAMPLE() * vol) / 256;
-                ++dest;
-                INC_POS_ONESHOT();
-            }
-            position_ = (signed char*)pos;
-        }
-    }
-    else
-    {
-        auto* pos = (signed char*)position_;
-        signed char* end = sound->GetEnd();
-        signed char* repeat = sound->GetRepeat();
 
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                *dest = *dest + GET_IP_SAMPLE() * vol;
-                ++dest;
-                INC_POS_LOOPED();
-            }
-            position_ = pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                *dest = *dest + GET_IP_SAMPLE() * vol;
-                ++dest;
-                INC_POS_ONESHOT();
-            }
-            position_ = pos;
-        }
-    }
-
-    fractPosition_ = fractPos;
-}
-
-void SoundSource::MixMonoToStereoIP(Sound* sound, int dest[], unsigned samples, int mixRate)
-{
-    float totalGain = masterGain_ * attenuation_ * gain_;
-    auto leftVol = (int)((-panning_ + 1.0f) * (256.0f * totalGain + 0.5f));
-    auto rightVol = (int)((panning_ + 1.0f) * (256.0f * totalGain + 0.5f));
-    if (!leftVol && !rightVol)
-    {
-        MixZeroVolume(sound, samples, mixRate);
-        return;
-    }
-
-    float add = frequency_ / (float)mixRate;
-    auto intAdd = (int)add;
-    auto fractAdd = (int)((add - floorf(add)) * 65536.0f);
-    int fractPos = fractPosition_;
-
-    if (sound->IsSixteenBit())
-    {
-        auto* pos = (short*)position_;
-        auto* end = (short*)sound->GetEnd();
-        auto* repeat = (short*)sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                int s = GET_IP_SAMPLE();
-                *dest = *dest + (s * leftVol) / 256;
-                ++dest;
-                *dest = *dest + (s * rightVol) / 256;
-                ++dest;
-                INC_POS_LOOPED();
-            }
-            position_ = (signed char*)pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                int s = GET_IP_SAMPLE();
-                *dest = *dest + (s * leftVol) / 256;
-                ++dest;
-                *dest = *dest + (s * rightVol) / 256;
-                ++dest;
-                INC_POS_ONESHOT();
-            }
-            position_ = (signed char*)pos;
-        }
-    }
-    else
-    {
-        auto* pos = (signed char*)position_;
-        signed char* end = sound->GetEnd();
-        signed char* repeat = sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                int s = GET_IP_SAMPLE();
-                *dest = *dest + s * leftVol;
-                ++dest;
-                *dest = *dest + s * rightVol;
-                ++dest;
-                INC_POS_LOOPED();
-            }
-            position_ = pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                int s = GET_IP_SAMPLE();
-                *dest = *dest + s * leftVol;
-                ++dest;
-                *dest = *dest + s * rightVol;
-                ++dest;
-                INC_POS_ONESHOT();
-            }
-            position_ = pos;
-        }
-    }
-
-    fractPosition_ = fractPos;
-}
-
-void SoundSource::MixStereoToMono(Sound* sound, int dest[], unsigned samples, int mixRate)
-{
-    float totalGain = masterGain_ * attenuation_ * gain_;
-    auto vol = RoundToInt(256.0f * totalGain);
-    if (!vol)
-    {
-        MixZeroVolume(sound, samples, mixRate);
-        return;
-    }
-
-    float add = frequency_ / (float)mixRate;
-    auto intAdd = (int)add;
-    auto fractAdd = (int)((add - floorf(add)) * 65536.0f);
-    int fractPos = fractPosition_;
-
-    if (sound->IsSixteenBit())
-    {
-        auto* pos = (short*)position_;
-        auto* end = (short*)sound->GetEnd();
-        auto* repeat = (short*)sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                int s = ((int)pos[0] + (int)pos[1]) / 2;
-                *dest = *dest + (s * vol) / 256;
-                ++dest;
-                INC_POS_STEREO_LOOPED();
-            }
-            position_ = (signed char*)pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                int s = ((int)pos[0] + (int)pos[1]) / 2;
-                *dest = *dest + (s * vol) / 256;
-                ++dest;
-                INC_POS_STEREO_ONESHOT();
-            }
-            position_ = (signed char*)pos;
-        }
-    }
-    else
-    {
-        auto* pos = (signed char*)position_;
-        signed char* end = sound->GetEnd();
-        signed char* repeat = sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                int s = ((int)pos[0] + (int)pos[1]) / 2;
-                *dest = *dest + s * vol;
-                ++dest;
-                INC_POS_STEREO_LOOPED();
-            }
-            position_ = pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                int s = ((int)pos[0] + (int)pos[1]) / 2;
-                *dest = *dest + s * vol;
-                ++dest;
-                INC_POS_STEREO_ONESHOT();
-            }
-            position_ = pos;
-        }
-    }
-
-    fractPosition_ = fractPos;
-}
-
-void SoundSource::MixStereoToStereo(Sound* sound, int dest[], unsigned samples, int mixRate)
-{
-    float totalGain = masterGain_ * attenuation_ * gain_;
-    auto vol = RoundToInt(256.0f * totalGain);
-    if (!vol)
-    {
-        MixZeroVolume(sound, samples, mixRate);
-        return;
-    }
-
-    float add = frequency_ / (float)mixRate;
-    auto intAdd = (int)add;
-    auto fractAdd = (int)((add - floorf(add)) * 65536.0f);
-    int fractPos = fractPosition_;
-
-    if (sound->IsSixteenBit())
-    {
-        auto* pos = (short*)position_;
-        auto* end = (short*)sound->GetEnd();
-        auto* repeat = (short*)sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                *dest = *dest + (pos[0] * vol) / 256;
-                ++dest;
-                *dest = *dest + (pos[1] * vol) / 256;
-                ++dest;
-                INC_POS_STEREO_LOOPED();
-            }
-            position_ = (signed char*)pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                *dest = *dest + (pos[0] * vol) / 256;
-                ++dest;
-                *dest = *dest + (pos[1] * vol) / 256;
-                ++dest;
-                INC_POS_STEREO_ONESHOT();
-            }
-            position_ = (signed char*)pos;
-        }
-    }
-    else
-    {
-        auto* pos = (signed char*)position_;
-        signed char* end = sound->GetEnd();
-        signed char* repeat = sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                *dest = *dest + pos[0] * vol;
-                ++dest;
-                *dest = *dest + pos[1] * vol;
-                ++dest;
-                INC_POS_STEREO_LOOPED();
-            }
-            position_ = pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                *dest = *dest + pos[0] * vol;
-                ++dest;
-                *dest = *dest + pos[1] * vol;
-                ++dest;
-                INC_POS_STEREO_ONESHOT();
-            }
-            position_ = pos;
-        }
-    }
-
-    fractPosition_ = fractPos;
-}
-
-void SoundSource::MixStereoToMonoIP(Sound* sound, int dest[], unsigned samples, int mixRate)
-{
-    float totalGain = masterGain_ * attenuation_ * gain_;
-    auto vol = RoundToInt(256.0f * totalGain);
-    if (!vol)
-    {
-        MixZeroVolume(sound, samples, mixRate);
-        return;
-    }
-
-    float add = frequency_ / (float)mixRate;
-    auto intAdd = (int)add;
-    auto fractAdd = (int)((add - floorf(add)) * 65536.0f);
-    int fractPos = fractPosition_;
-
-    if (sound->IsSixteenBit())
-    {
-        auto* pos = (short*)position_;
-        auto* end = (short*)sound->GetEnd();
-        auto* repeat = (short*)sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                int s = (GET_IP_SAMPLE_LEFT() + GET_IP_SAMPLE_RIGHT()) / 2;
-                *dest = *dest + (s * vol) / 256;
-                ++dest;
-                INC_POS_STEREO_LOOPED();
-            }
-            position_ = (signed char*)pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                int s = (GET_IP_SAMPLE_LEFT() + GET_IP_SAMPLE_RIGHT()) / 2;
-                *dest = *dest + (s * vol) / 256;
-                ++dest;
-                INC_POS_STEREO_ONESHOT();
-            }
-            position_ = (signed char*)pos;
-        }
-    }
-    else
-    {
-        auto* pos = (signed char*)position_;
-        signed char* end = sound->GetEnd();
-        signed char* repeat = sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                int s = (GET_IP_SAMPLE_LEFT() + GET_IP_SAMPLE_RIGHT()) / 2;
-                *dest = *dest + s * vol;
-                ++dest;
-                INC_POS_STEREO_LOOPED();
-            }
-            position_ = pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                int s = (GET_IP_SAMPLE_LEFT() + GET_IP_SAMPLE_RIGHT()) / 2;
-                *dest = *dest + s * vol;
-                ++dest;
-                INC_POS_STEREO_ONESHOT();
-            }
-            position_ = pos;
-        }
-    }
-
-    fractPosition_ = fractPos;
+    // If stream pointer is null, stop playback
+    StopInternal();
 }
 
-void SoundSource::MixStereoToStereoIP(Sound* sound, int dest[], unsigned samples, int mixRate)
+void SoundSource::StopInternal()
 {
-    float totalGain = masterGain_ * attenuation_ * gain_;
-    auto vol = RoundToInt(256.0f * totalGain);
-    if (!vol)
-    {
-        MixZeroVolume(sound, samples, mixRate);
-        return;
-    }
+    playing_ = false;
+    ++playId_;
+    startPosition_ = nullptr;
+    startTimePosition_ = 0.0f;
 
-    float add = frequency_ / (float)mixRate;
-    auto intAdd = (int)add;
-    auto fractAdd = (int)((add - floorf(add)) * 65536.0f);
-    int fractPos = fractPosition_;
+    SoundCommand command;
+    command.type_ = SoundCommandType::STOP;
+    command.voice_ = voice_;
+    command.playId_ = playId_;
+    audio_->SendCommand(command);
 
-    if (sound->IsSixteenBit())
-    {
-        auto* pos = (short*)position_;
-        auto* end = (short*)sound->GetEnd();
-        auto* repeat = (short*)sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                *dest = *dest + (GET_IP_SAMPLE_LEFT() * vol) / 256;
-                ++dest;
-                *dest = *dest + (GET_IP_SAMPLE_RIGHT() * vol) / 256;
-                ++dest;
-                INC_POS_STEREO_LOOPED();
-            }
-            position_ = (signed char*)pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                *dest = *dest + (GET_IP_SAMPLE_LEFT() * vol) / 256;
-                ++dest;
-                *dest = *dest + (GET_IP_SAMPLE_RIGHT() * vol) / 256;
-                ++dest;
-                INC_POS_STEREO_ONESHOT();
-            }
-            position_ = (signed char*)pos;
-        }
-    }
-    else
-    {
-        auto* pos = (signed char*)position_;
-        signed char* end = sound->GetEnd();
-        signed char* repeat = sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                *dest = *dest + GET_IP_SAMPLE_LEFT() * vol;
-                ++dest;
-                *dest = *dest + GET_IP_SAMPLE_RIGHT() * vol;
-                ++dest;
-                INC_POS_STEREO_LOOPED();
-            }
-            position_ = pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                *dest = *dest + GET_IP_SAMPLE_LEFT() * vol;
-                ++dest;
-                *dest = *dest + GET_IP_SAMPLE_RIGHT() * vol;
-                ++dest;
-                INC_POS_STEREO_ONESHOT();
-            }
-            position_ = pos;
-        }
-    }
-
-    fractPosition_ = fractPos;
+    // Free the sound stream and decode buffer if a stream was playing
+    ReleaseStream();
 }
 
-void SoundSource::MixZeroVolume(Sound* sound, unsigned samples, int mixRate)
+void SoundSource::SendPlayCommand(signed char* position, float timePosition)
 {
-    float add = frequency_ * (float)samples / (float)mixRate;
-    auto intAdd = (int)add;
-    auto fractAdd = (int)((add - floorf(add)) * 65536.0f);
-    unsigned sampleSize = sound->GetSampleSize();
+    ++playId_;
+    startPosition_ = position;
+    startTimePosition_ = timePosition;
 
-    fractPosition_ += fractAdd;
-    if (fractPosition_ > 65535)
-    {
-        fractPosition_ &= 65535;
-        position_ += sampleSize;
-    }
-    position_ += intAdd * sampleSize;
-
-    if (position_ > sound->GetEnd())
-    {
-        if (sound->IsLooped())
-        {
-            while (position_ >= sound->GetEnd())
-            {
-                position_ -= (sound->GetEnd() - sound->GetRepeat());
-            }
-        }
-        else
-            position_ = nullptr;
-    }
+    SoundCommand command;
+    command.type_ = SoundCommandType::PLAY;
+    command.voice_ = voice_;
+    command.sound_ = sound_;
+    command.buffer_ = soundStream_ ? streamBuffer_.Get() : sound_.Get();
+    command.stream_ = soundStream_;
+    command.position_ = position;
+    command.timePosition_ = timePosition;
+    command.playId_ = playId_;
+    audio_->SendCommand(command);
 }
 
-void SoundSource::MixNull(float timeStep)
+void SoundSource::ReleaseStream()
 {
-    if (!position_ || !sound_ || !IsEnabledEffective())
-        return;
-
-    // Advance only the time position
-    timePosition_ += timeStep * frequency_ / sound_->GetFrequency();
-
-    if (sound_->IsLooped())
+    if (audio_)
     {
-        // For simulated playback, simply reset the time position to zero when the sound loops
-        if (timePosition_ >= sound_->GetLength())
-            timePosition_ -= sound_->GetLength();
+        audio_->ReleaseWhenUnused(soundStream_);
+        audio_->ReleaseWhenUnused(streamBuffer_);
     }
     else
     {
-        if (timePosition_ >= sound_->GetLength())
-        {
-            position_ = nullptr;
-            timePosition_ = 0.0f;
-        }
+        soundStream_.Reset();
+        streamBuffer_.Reset();
     }
 }
 
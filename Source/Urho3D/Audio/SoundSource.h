@@ -31,9 +31,12 @@ namespace Urho3D
 class Audio;
 class Sound;
 class SoundStream;
+class SoundVoice;
 
 /// Compressed audio decode buffer length in milliseconds.
 static const int STREAM_BUFFER_LENGTH = 100;
+/// Gain below which sound source is not audible and is played as a virtual voice.
+static const float INAUDIBLE_GAIN = 1.0f / 512.0f;
 
 /// %Sound source component with stereo position. A sound source needs to be created to a node to be considered "enabled" and be able to play, however that node does not need to belong to a scene.
 class URHO3D_API SoundSource : public Component
@@ -76,18 +79,20 @@ public:
     void SetAutoRemoveMode(AutoRemoveMode mode);
     /// Set new playback position.
     void SetPlayPosition(signed char* pos);
+    /// Set voice priority. When the audio subsystem runs out of voices, sources with lower priority become virtual first.
+    void SetPriority(int priority);
 
     /// Return sound.
     Sound* GetSound() const { return sound_; }
 
     /// Return playback position.
-    volatile signed char* GetPlayPosition() const { return position_; }
+    volatile signed char* GetPlayPosition() const;
 
     /// Return sound type, determines the master gain group.
     ea::string GetSoundType() const { return soundType_; }
 
     /// Return playback time position.
-    float GetTimePosition() const { return timePosition_; }
+    float GetTimePosition() const;
 
     /// Return frequency.
     float GetFrequency() const { return frequency_; }
@@ -104,15 +109,28 @@ public:
     /// Return automatic removal mode on sound playback completion.
     AutoRemoveMode GetAutoRemoveMode() const { return autoRemove_; }
 
+    /// Return voice priority.
+    int GetPriority() const { return priority_; }
+
+    /// Return gain including master gain and attenuation.
+    float GetEffectiveGain() const { return masterGain_ * attenuation_ * gain_; }
+
+    /// Return whether is played as a virtual voice: playback position advances but nothing is mixed.
+    bool IsVirtual() const { return virtual_; }
+
     /// Return whether is playing.
     bool IsPlaying() const;
 
     /// Update the sound source. Perform subclass specific operations. Called by Audio.
     virtual void Update(float timeStep);
-    /// Mix sound source output to a 32-bit clipping buffer. Called by Audio.
-    void Mix(int dest[], unsigned samples, int mixRate, bool stereo, bool interpolation);
     /// Update the effective master gain. Called internally and by Audio when the master gain changes.
     void UpdateMasterGain();
+    /// Set whether is played as a virtual voice. Called by Audio.
+    void SetVirtual(bool enable);
+    /// Publish mixing parameters to the audio thread. Called internally and by Audio.
+    void UpdateMixParams();
+    /// Return playback state mixed by the audio thread. Called by Audio.
+    SoundVoice* GetVoice() const { return voice_; }
 
     /// Set sound attribute.
     void SetSoundAttr(const ResourceRef& value);
@@ -146,51 +164,39 @@ protected:
     bool sendFinishedEvent_;
     /// Automatic removal mode.
     AutoRemoveMode autoRemove_;
+    /// Voice priority.
+    int priority_{};
+    /// Whether is played as a virtual voice.
+    bool virtual_{};
 
 private:
-    /// Play a sound without locking the audio mutex. Called internally.
-    void PlayLockless(Sound* sound);
-    /// Play a sound stream without locking the audio mutex. Called internally.
-    void PlayLockless(const SharedPtr<SoundStream>& stream);
-    /// Stop sound without locking the audio mutex. Called internally.
-    void StopLockless();
-    /// Set new playback position without locking the audio mutex. Called internally.
-    void SetPlayPositionLockless(signed char* pos);
-    /// Mix mono sample to mono buffer.
-    void MixMonoToMono(Sound* sound, int dest[], unsigned samples, int mixRate);
-    /// Mix mono sample to stereo buffer.
-    void MixMonoToStereo(Sound* sound, int dest[], unsigned samples, int mixRate);
-    /// Mix mono sample to mono buffer interpolated.
-    void MixMonoToMonoIP(Sound* sound, int dest[], unsigned samples, int mixRate);
-    /// Mix mono sample to stereo buffer interpolated.
-    void MixMonoToStereoIP(Sound* sound, int dest[], unsigned samples, int mixRate);
-    /// Mix stereo sample to mono buffer.
-    void MixStereoToMono(Sound* sound, int dest[], unsigned samples, int mixRate);
-    /// Mix stereo sample to stereo buffer.
-    void MixStereoToStereo(Sound* sound, int dest[], unsigned samples, int mixRate);
-    /// Mix stereo sample to mono buffer interpolated.
-    void MixStereoToMonoIP(Sound* sound, int dest[], unsigned samples, int mixRate);
-    /// Mix stereo sample to stereo buffer interpolated.
-    void MixStereoToStereoIP(Sound* sound, int dest[], unsigned samples, int mixRate);
-    /// Advance playback pointer without producing audible output.
-    void MixZeroVolume(Sound* sound, unsigned samples, int mixRate);
-    /// Advance playback pointer to simulate audio playback in headless mode.
-    void MixNull(float timeStep);
+    /// Play a sound. Called internally.
+    void PlayInternal(Sound* sound);
+    /// Play a sound stream. Called internally.
+    void PlayInternal(const SharedPtr<SoundStream>& stream);
+    /// Stop playback. Called internally.
+    void StopInternal();
+    /// Send playback start command to the audio thread.
+    void SendPlayCommand(signed char* position, float timePosition);
+    /// Release sound stream and decode buffer once the audio thread no longer uses them.
+    void ReleaseStream();
 
     /// Sound that is being played.
     SharedPtr<Sound> sound_;
     /// Sound stream that is being played.
     SharedPtr<SoundStream> soundStream_;
-    /// Playback position.
-    volatile signed char* position_;
-    /// Playback fractional position.
-    volatile int fractPosition_;
-    /// Playback time position.
-    volatile float timePosition_;
     /// Decode buffer.
     SharedPtr<Sound> streamBuffer_;
-    /// Unused stream bytes from previous frame.
-    int unusedStreamSize_;
+    /// Playback state mixed by the audio thread. Deleted by Audio once the audio thread no longer uses it.
+    SoundVoice* voice_{};
+    /// Identifier of the last playback command.
+    unsigned playId_{};
+    /// Whether playback was requested and not stopped.
+    bool playing_{};
+    /// Position of the last playback command, reported until the audio thread picks it up.
+    signed char* startPosition_{};
+    /// Time position of the last playback command, reported until the audio thread picks it up.
+    float startTimePosition_{};
 };
 
 }
@@ -0,0 +1,372 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Audio/AudioMixing.h"
+#include "../Audio/Sound.h"
+#include "../Audio/SoundSource.h"
+#include "../Audio/SoundStream.h"
+#include "../Audio/SoundVoice.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Resample sound data of given sample type and channel count into float frames in 16-bit range. Advance position
+/// using 16.16 fixed point step. Position becomes null when a non-looped sound ends. Return number of frames produced.
+template <class T, unsigned Channels, bool Interpolate>
+unsigned ResampleSamples(const T*& pos, int& fractPos, const T* end, const T* repeat, bool looped, int intAdd, int fractAdd,
+    float* dest, unsigned frames)
+{
+    const float scale = sizeof(T) == 1 ? 256.0f : 1.0f;
+    unsigned i = 0;
+
+    // Source and output rate match: copy contiguous runs of samples with vectorized conversion
+    if (intAdd == 1 && fractAdd == 0 && fractPos == 0)
+    {
+        while (i < frames)
+        {
+            const unsigned run = Min(frames - i, (unsigned)(end - pos) / Channels);
+            if (!run)
+                break;
+
+            ConvertSamplesToFloat(pos, dest + i * Channels, run * Channels);
+            i += run;
+            pos += run * Channels;
+            if (pos >= end)
+            {
+                if (!looped)
+                {
+                    pos = nullptr;
+                    return i;
+                }
+                while (pos >= end)
+                    pos -= (end - repeat);
+            }
+        }
+    }
+
+    for (; i < frames; ++i)
+    {
+        const float fraction = (float)fractPos * (1.0f / 65536.0f);
+        for (unsigned channel = 0; channel < Channels; ++channel)
+        {
+            const auto sample = (float)pos[channel];
+            if (Interpolate)
+                dest[i * Channels + channel] = (sample + ((float)pos[channel + Channels] - sample) * fraction) * scale;
+            else
+                dest[i * Channels + channel] = sample * scale;
+        }
+
+        pos += intAdd * Channels;
+        fractPos += fractAdd;
+        if (fractPos > 65535)
+        {
+            fractPos &= 65535;
+            pos += Channels;
+        }
+        if (pos >= end)
+        {
+            if (!looped)
+            {
+                pos = nullptr;
+                return i + 1;
+            }
+            while (pos >= end)
+                pos -= (end - repeat);
+        }
+    }
+    return frames;
+}
+
+/// Resample sound data of given sample type.
+template <class T>
+unsigned ResampleSound(Sound* sound, signed char*& position, int& fractPos, int intAdd, int fractAdd,
+    bool interpolation, float* dest, unsigned frames)
+{
+    auto* pos = (const T*)position;
+    auto* end = (const T*)sound->GetEnd();
+    auto* repeat = (const T*)sound->GetRepeat();
+    const bool looped = sound->IsLooped();
+
+    unsigned result;
+    if (sound->IsStereo())
+    {
+        result = interpolation
+            ? ResampleSamples<T, 2, true>(pos, fractPos, end, repeat, looped, intAdd, fractAdd, dest, frames)
+            : ResampleSamples<T, 2, false>(pos, fractPos, end, repeat, looped, intAdd, fractAdd, dest, frames);
+    }
+    else
+    {
+        result = interpolation
+            ? ResampleSamples<T, 1, true>(pos, fractPos, end, repeat, looped, intAdd, fractAdd, dest, frames)
+            : ResampleSamples<T, 1, false>(pos, fractPos, end, repeat, looped, intAdd, fractAdd, dest, frames);
+    }
+
+    position = (signed char*)pos;
+    return result;
+}
+
+}
+
+static const int STREAM_SAFETY_SAMPLES = 4;
+
+void SoundVoice::SetParams(const SoundVoiceParams& params)
+{
+    // Single writer sequence lock: readers retry while the counter is odd or has changed
+    const unsigned sequence = paramsSequence_.load(std::memory_order_relaxed);
+    paramsSequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    params_ = params;
+
+    paramsSequence_.store(sequence + 2, std::memory_order_release);
+}
+
+SoundVoiceParams SoundVoice::GetParams() const
+{
+    SoundVoiceParams params;
+    unsigned before, after;
+    do
+    {
+        before = paramsSequence_.load(std::memory_order_acquire);
+        params = params_;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = paramsSequence_.load(std::memory_order_relaxed);
+    } while ((before & 1u) || before != after);
+    return params;
+}
+
+void SoundVoice::Execute(const SoundCommand& command)
+{
+    switch (command.type_)
+    {
+    case SoundCommandType::PLAY:
+        sound_ = command.sound_;
+        buffer_ = command.buffer_;
+        stream_ = command.stream_;
+        position_ = command.position_;
+        fractPosition_ = 0;
+        unusedStreamSize_ = 0;
+        playId_ = command.playId_;
+        timePosition_.store(command.timePosition_, std::memory_order_relaxed);
+        publishedPosition_.store(position_, std::memory_order_release);
+        startedPlayId_.store(playId_, std::memory_order_release);
+        if (!position_)
+            Finish();
+        break;
+
+    case SoundCommandType::STOP:
+        position_ = nullptr;
+        playId_ = command.playId_;
+        timePosition_.store(0.0f, std::memory_order_relaxed);
+        startedPlayId_.store(playId_, std::memory_order_release);
+        Finish();
+        break;
+
+    case SoundCommandType::SEEK:
+        // Stream is only decoded by the thread that mixes, so seeking has to happen here as well
+        if (stream_ && stream_->Seek((unsigned)(command.timePosition_ * stream_->GetFrequency())))
+            timePosition_.store(command.timePosition_, std::memory_order_relaxed);
+        break;
+
+    default:
+        break;
+    }
+}
+
+void SoundVoice::Finish()
+{
+    // Resources may be released by the main thread as soon as it observes the finished playback
+    position_ = nullptr;
+    sound_ = nullptr;
+    buffer_ = nullptr;
+    stream_ = nullptr;
+    publishedPosition_.store(nullptr, std::memory_order_release);
+    finishedPlayId_.store(playId_, std::memory_order_release);
+}
+
+void SoundVoice::Mix(float dest[], float scratch[], unsigned samples, int mixRate, bool stereo, bool interpolation)
+{
+    if (!position_ || !buffer_)
+        return;
+
+    const SoundVoiceParams params = GetParams();
+    if (params.paused_ || !params.enabled_)
+        return;
+
+    int streamFilledSize, outBytes;
+
+    if (stream_)
+    {
+        int streamBufferSize = buffer_->GetDataSize();
+        // Calculate how many bytes of stream sound data is needed
+        auto neededSize = (int)((float)samples * params.frequency_ / (float)mixRate);
+        // Add a little safety buffer. Subtract previous unused data
+        neededSize += STREAM_SAFETY_SAMPLES;
+        neededSize *= stream_->GetSampleSize();
+        neededSize -= unusedStreamSize_;
+        neededSize = Clamp(neededSize, 0, streamBufferSize - unusedStreamSize_);
+
+        // Always start play position at the beginning of the stream buffer
+        position_ = buffer_->GetStart();
+
+        // Request new data from the stream
+        signed char* destination = buffer_->GetStart() + unusedStreamSize_;
+        outBytes = neededSize ? stream_->GetData(destination, (unsigned)neededSize) : 0;
+        destination += outBytes;
+        // Zero-fill rest if stream did not produce enough data
+        if (outBytes < neededSize)
+            memset(destination, 0, (size_t)(neededSize - outBytes));
+
+        // Calculate amount of total bytes of data in stream buffer now, to know how much went unused after mixing
+        streamFilledSize = neededSize + unusedStreamSize_;
+    }
+
+    // Virtual and inaudible voices only advance the playback position
+    if (params.virtual_ || params.gain_ < INAUDIBLE_GAIN)
+        MixZeroVolume(buffer_, samples, mixRate, params.frequency_);
+    else
+    {
+        const unsigned frames = Resample(buffer_, scratch, samples, mixRate, params.frequency_, interpolation);
+        if (!buffer_->IsStereo())
+        {
+            if (stereo)
+            {
+                MixSamplesMonoToStereo(dest, scratch, frames, (1.0f - params.panning_) * params.gain_,
+                    (1.0f + params.panning_) * params.gain_);
+            }
+            else
+                MixSamplesMonoToMono(dest, scratch, frames, params.gain_);
+        }
+        else
+        {
+            if (stereo)
+                MixSamplesStereoToStereo(dest, scratch, frames, params.gain_, params.gain_);
+            else
+                MixSamplesStereoToMono(dest, scratch, frames, params.gain_);
+        }
+    }
+
+    // Update the time position. In stream mode, copy unused data back to the beginning of the stream buffer
+    if (stream_)
+    {
+        timePosition_.store(timePosition_.load(std::memory_order_relaxed) +
+            ((float)samples / (float)mixRate) * params.frequency_ / stream_->GetFrequency(), std::memory_order_relaxed);
+
+        unusedStreamSize_ = Max(streamFilledSize - (int)(size_t)(position_ - buffer_->GetStart()), 0);
+        if (unusedStreamSize_)
+            memcpy(buffer_->GetStart(), (const void*)position_, (size_t)unusedStreamSize_);
+
+        // If stream did not produce any data, stop if applicable
+        if (!outBytes && stream_->GetStopAtEnd())
+        {
+            Finish();
+            return;
+        }
+    }
+    else if (position_)
+    {
+        timePosition_.store(((float)(int)(size_t)(position_ - buffer_->GetStart())) /
+            (buffer_->GetSampleSize() * buffer_->GetFrequency()), std::memory_order_relaxed);
+    }
+
+    if (position_)
+        publishedPosition_.store(position_, std::memory_order_release);
+    else
+        Finish();
+}
+
+void SoundVoice::MixNull(float timeStep)
+{
+    if (!position_ || !sound_)
+        return;
+
+    const SoundVoiceParams params = GetParams();
+    if (params.paused_ || !params.enabled_)
+        return;
+
+    // Advance only the time position
+    float timePosition = GetTimePosition() + timeStep * params.frequency_ / sound_->GetFrequency();
+
+    if (sound_->IsLooped())
+    {
+        // For simulated playback, simply reset the time position to zero when the sound loops
+        if (timePosition >= sound_->GetLength())
+            timePosition -= sound_->GetLength();
+    }
+    else if (timePosition >= sound_->GetLength())
+    {
+        timePosition = 0.0f;
+        Finish();
+    }
+
+    timePosition_.store(timePosition, std::memory_order_relaxed);
+}
+
+unsigned SoundVoice::Resample(Sound* sound, float dest[], unsigned samples, int mixRate, float frequency, bool interpolation)
+{
+    float add = frequency / (float)mixRate;
+    auto intAdd = (int)add;
+    auto fractAdd = (int)((add - floorf(add)) * 65536.0f);
+
+    if (sound->IsSixteenBit())
+        return ResampleSound<short>(sound, position_, fractPosition_, intAdd, fractAdd, interpolation, dest, samples);
+    else
+        return ResampleSound<signed char>(sound, position_, fractPosition_, intAdd, fractAdd, interpolation, dest, samples);
+}
+
+void SoundVoice::MixZeroVolume(Sound* sound, unsigned samples, int mixRate, float frequency)
+{
+    float add = frequency * (float)samples / (float)mixRate;
+    auto intAdd = (int)add;
+    auto fractAdd = (int)((add - floorf(add)) * 65536.0f);
+    unsigned sampleSize = sound->GetSampleSize();
+
+    fractPosition_ += fractAdd;
+    if (fractPosition_ > 65535)
+    {
+        fractPosition_ &= 65535;
+        position_ += sampleSize;
+    }
+    position_ += intAdd * sampleSize;
+
+    if (position_ > sound->GetEnd())
+    {
+        if (sound->IsLooped())
+        {
+            while (position_ >= sound->GetEnd())
+            {
+                position_ -= (sound->GetEnd() - sound->GetRepeat());
+            }
+        }
+        else
+            position_ = nullptr;
+    }
+}
+
+}
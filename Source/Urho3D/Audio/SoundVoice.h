@@ -0,0 +1,155 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include <Urho3D/Urho3D.h>
+
+#include <atomic>
+
+namespace Urho3D
+{
+
+class Sound;
+class SoundStream;
+class SoundVoice;
+
+/// Type of command sent from the main thread to the audio thread.
+enum class SoundCommandType
+{
+    /// Start mixing the voice.
+    ADD_VOICE,
+    /// Stop mixing the voice. The voice is deleted by the main thread afterwards.
+    REMOVE_VOICE,
+    /// Start playback.
+    PLAY,
+    /// Stop playback.
+    STOP,
+    /// Seek the sound stream to a time position.
+    SEEK
+};
+
+/// Command sent from the main thread to the audio thread. Referenced resources are kept alive by the main thread.
+struct SoundCommand
+{
+    /// Command type.
+    SoundCommandType type_{};
+    /// Target voice.
+    SoundVoice* voice_{};
+    /// Sound being played, null when playing a sound stream directly.
+    Sound* sound_{};
+    /// Sound data that is mixed. Either the sound itself or the stream decode buffer.
+    Sound* buffer_{};
+    /// Sound stream, null when playing an uncompressed sound.
+    SoundStream* stream_{};
+    /// Playback start position within the mixed data.
+    signed char* position_{};
+    /// Playback time position at start, or seek target.
+    float timePosition_{};
+    /// Identifier of the playback.
+    unsigned playId_{};
+};
+
+/// Sound source parameters used for mixing.
+struct SoundVoiceParams
+{
+    /// Frequency.
+    float frequency_{};
+    /// Gain including master gain and attenuation.
+    float gain_{};
+    /// Stereo panning.
+    float panning_{};
+    /// Whether is played as a virtual voice: playback position advances but nothing is mixed.
+    bool virtual_{};
+    /// Whether sound type is paused.
+    bool paused_{};
+    /// Whether sound source is enabled.
+    bool enabled_{true};
+};
+
+/// Playback state of a sound source. Commands and mixing are executed by the audio thread while audio output is
+/// active and by the main thread otherwise. Parameters and playback progress are exchanged without locking.
+class URHO3D_API SoundVoice
+{
+public:
+    /// Publish mixing parameters. Called from the main thread.
+    void SetParams(const SoundVoiceParams& params);
+    /// Return last published mixing parameters.
+    SoundVoiceParams GetParams() const;
+
+    /// Execute playback command.
+    void Execute(const SoundCommand& command);
+    /// Mix voice output to a float buffer. Scratch buffer must hold samples stereo frames.
+    void Mix(float dest[], float scratch[], unsigned samples, int mixRate, bool stereo, bool interpolation);
+    /// Advance time position to simulate playback when there is no audio output.
+    void MixNull(float timeStep);
+
+    /// Return identifier of the last playback started by a command.
+    unsigned GetStartedPlayId() const { return startedPlayId_.load(std::memory_order_acquire); }
+    /// Return identifier of the last playback that has finished or was stopped.
+    unsigned GetFinishedPlayId() const { return finishedPlayId_.load(std::memory_order_acquire); }
+    /// Return current playback position within the mixed data.
+    signed char* GetPosition() const { return publishedPosition_.load(std::memory_order_acquire); }
+    /// Return playback time position.
+    float GetTimePosition() const { return timePosition_.load(std::memory_order_relaxed); }
+
+private:
+    /// Resample sound data into float frames and advance playback position. Return number of frames produced.
+    unsigned Resample(Sound* sound, float dest[], unsigned samples, int mixRate, float frequency, bool interpolation);
+    /// Advance playback position without producing audible output.
+    void MixZeroVolume(Sound* sound, unsigned samples, int mixRate, float frequency);
+    /// Mark current playback finished.
+    void Finish();
+
+    /// Sound being played.
+    Sound* sound_{};
+    /// Sound data that is mixed.
+    Sound* buffer_{};
+    /// Sound stream that is being played.
+    SoundStream* stream_{};
+    /// Playback position, null when not playing.
+    signed char* position_{};
+    /// Playback fractional position.
+    int fractPosition_{};
+    /// Unused stream bytes from previous mix.
+    int unusedStreamSize_{};
+    /// Identifier of current playback.
+    unsigned playId_{};
+
+    /// Playback time position.
+    std::atomic<float> timePosition_{};
+    /// Playback position visible to the main thread.
+    std::atomic<signed char*> publishedPosition_{};
+    /// Identifier of the last started playback.
+    std::atomic<unsigned> startedPlayId_{};
+    /// Identifier of the last finished playback.
+    std::atomic<unsigned> finishedPlayId_{};
+
+    /// Mixing parameters. Written by the main thread under the sequence counter.
+    SoundVoiceParams params_;
+    /// Sequence counter of mixing parameters. Odd while parameters are being written.
+    std::atomic<unsigned> paramsSequence_{};
+};
+
+}
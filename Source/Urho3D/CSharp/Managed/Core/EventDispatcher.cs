@@ -0,0 +1,260 @@
+﻿//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+using System;
+using System.Collections.Generic;
+using System.Runtime.InteropServices;
+using System.Text;
+
+namespace Urho3DNet
+{
+    /// <summary>
+    /// Read-only view of native event data. Parameters are read in place without marshalling the VariantMap. Valid
+    /// only while the event is being dispatched.
+    /// </summary>
+    public readonly struct EventData
+    {
+        [DllImport("Urho3D", EntryPoint = "Urho3D_EventData_GetInt")]
+        private static extern int Urho3D_EventData_GetInt(IntPtr eventData, uint key);
+        [DllImport("Urho3D", EntryPoint = "Urho3D_EventData_GetUInt")]
+        private static extern uint Urho3D_EventData_GetUInt(IntPtr eventData, uint key);
+        [DllImport("Urho3D", EntryPoint = "Urho3D_EventData_GetFloat")]
+        private static extern float Urho3D_EventData_GetFloat(IntPtr eventData, uint key);
+        [DllImport("Urho3D", EntryPoint = "Urho3D_EventData_GetBool")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        private static extern bool Urho3D_EventData_GetBool(IntPtr eventData, uint key);
+        [DllImport("Urho3D", EntryPoint = "Urho3D_EventData_GetString")]
+        private static extern IntPtr Urho3D_EventData_GetString(IntPtr eventData, uint key, out int length);
+        [DllImport("Urho3D", EntryPoint = "Urho3D_EventData_GetStringHash")]
+        private static extern uint Urho3D_EventData_GetStringHash(IntPtr eventData, uint key);
+        [DllImport("Urho3D", EntryPoint = "Urho3D_EventData_GetVector3")]
+        private static extern void Urho3D_EventData_GetVector3(IntPtr eventData, uint key, out Vector3 value);
+        [DllImport("Urho3D", EntryPoint = "Urho3D_EventData_GetIntVector2")]
+        private static extern void Urho3D_EventData_GetIntVector2(IntPtr eventData, uint key, out IntVector2 value);
+        [DllImport("Urho3D", EntryPoint = "Urho3D_EventData_GetPtr")]
+        private static extern IntPtr Urho3D_EventData_GetPtr(IntPtr eventData, uint key);
+
+        private readonly IntPtr _eventData;
+
+        internal EventData(IntPtr eventData)
+        {
+            _eventData = eventData;
+        }
+
+        public int GetInt(StringHash key) => Urho3D_EventData_GetInt(_eventData, key.Hash);
+        public uint GetUInt(StringHash key) => Urho3D_EventData_GetUInt(_eventData, key.Hash);
+        public float GetFloat(StringHash key) => Urho3D_EventData_GetFloat(_eventData, key.Hash);
+        public bool GetBool(StringHash key) => Urho3D_EventData_GetBool(_eventData, key.Hash);
+        public StringHash GetStringHash(StringHash key) => new StringHash(Urho3D_EventData_GetStringHash(_eventData, key.Hash));
+
+        public string GetString(StringHash key)
+        {
+            var value = Urho3D_EventData_GetString(_eventData, key.Hash, out var length);
+            if (length == 0)
+                return string.Empty;
+            unsafe
+            {
+                return Encoding.UTF8.GetString((byte*)value, length);
+            }
+        }
+
+        public Vector3 GetVector3(StringHash key)
+        {
+            Urho3D_EventData_GetVector3(_eventData, key.Hash, out var value);
+            return value;
+        }
+
+        public IntVector2 GetIntVector2(StringHash key)
+        {
+            Urho3D_EventData_GetIntVector2(_eventData, key.Hash, out var value);
+            return value;
+        }
+
+        /// <summary>
+        /// Return native pointer stored in a parameter. Wrap it with the wrapper type of the parameter.
+        /// </summary>
+        public IntPtr GetPtr(StringHash key) => Urho3D_EventData_GetPtr(_eventData, key.Hash);
+
+        /// <summary>
+        /// Return event data as a VariantMap wrapper for parameters without typed accessors.
+        /// </summary>
+        public VariantMap ToVariantMap() => VariantMap.wrap(_eventData, false);
+    }
+
+    /// <summary>
+    /// Typed event arguments. Implementations are generated for every event in E, for example E.UpdateArgs.
+    /// </summary>
+    public interface IEventArgs
+    {
+        void Bind(in EventData data);
+    }
+
+    public delegate void EventDataHandler(StringHash eventType, in EventData eventData);
+
+    public delegate void TypedEventHandler<TArgs>(in TArgs args) where TArgs : struct, IEventArgs;
+
+    /// <summary>
+    /// Dispatches engine events to many managed handlers through a single native subscription per event type.
+    /// Each event crosses the native-to-managed boundary once no matter how many handlers are subscribed to it, and
+    /// handlers receive typed arguments instead of a marshalled VariantMap. Must be disposed on the main thread.
+    /// </summary>
+    public sealed class EventDispatcher : IDisposable
+    {
+        [DllImport("Urho3D", EntryPoint = "Urho3D_EventDispatcher_Create")]
+        private static extern IntPtr Urho3D_EventDispatcher_Create(HandleRef context);
+        [DllImport("Urho3D", EntryPoint = "Urho3D_EventDispatcher_Destroy")]
+        private static extern void Urho3D_EventDispatcher_Destroy(IntPtr dispatcher);
+        [DllImport("Urho3D", EntryPoint = "Urho3D_EventDispatcher_Unsubscribe")]
+        private static extern void Urho3D_EventDispatcher_Unsubscribe(IntPtr dispatcher, uint eventType);
+        [DllImport("Urho3D", EntryPoint = "Urho3D_Object_SubscribeToEvent")]
+        private static extern void Urho3D_Object_SubscribeToEvent(IntPtr receiver, IntPtr sender, uint eventType,
+            IntPtr callback, IntPtr callbackHandle);
+
+        private delegate void EventCallbackDelegate(IntPtr callbackHandle, uint eventHash, IntPtr eventData);
+
+        private static readonly EventCallbackDelegate EventCallback = HandleEventCallback;
+        private static readonly IntPtr EventCallbackPtr = Marshal.GetFunctionPointerForDelegate(EventCallback);
+
+        /// <summary>
+        /// Handlers of one event type. Handler array is replaced on every change, so handlers may subscribe and
+        /// unsubscribe during dispatch and dispatch itself never allocates.
+        /// </summary>
+        private sealed class EventSlot
+        {
+            public EventDataHandler[] Handlers = new EventDataHandler[0];
+
+            public void Dispatch(StringHash eventType, IntPtr eventData)
+            {
+                var data = new EventData(eventData);
+                var handlers = Handlers;
+                for (var i = 0; i < handlers.Length; ++i)
+                    handlers[i](eventType, in data);
+            }
+        }
+
+        private sealed class Subscription : IDisposable
+        {
+            private EventDispatcher _dispatcher;
+            private readonly StringHash _eventType;
+            private readonly EventDataHandler _handler;
+
+            public Subscription(EventDispatcher dispatcher, StringHash eventType, EventDataHandler handler)
+            {
+                _dispatcher = dispatcher;
+                _eventType = eventType;
+                _handler = handler;
+            }
+
+            public void Dispose()
+            {
+                _dispatcher?.Unsubscribe(_eventType, _handler);
+                _dispatcher = null;
+            }
+        }
+
+        private static void HandleEventCallback(IntPtr callbackHandle, uint eventHash, IntPtr eventData)
+        {
+            var slot = (EventSlot)GCHandle.FromIntPtr(callbackHandle).Target;
+            slot.Dispatch(new StringHash(eventHash), eventData);
+        }
+
+        private IntPtr _dispatcher;
+        private readonly Dictionary<uint, EventSlot> _slots = new Dictionary<uint, EventSlot>();
+
+        public EventDispatcher(Context context)
+        {
+            _dispatcher = Urho3D_EventDispatcher_Create(Context.getCPtr(context));
+        }
+
+        /// <summary>
+        /// Subscribe to an event sent by any sender. Dispose returned object to unsubscribe.
+        /// </summary>
+        public IDisposable Subscribe(StringHash eventType, EventDataHandler handler)
+        {
+            if (_dispatcher == IntPtr.Zero)
+                throw new ObjectDisposedException(nameof(EventDispatcher));
+
+            if (!_slots.TryGetValue(eventType.Hash, out var slot))
+            {
+                slot = new EventSlot();
+                _slots[eventType.Hash] = slot;
+                // Native event handler owns and frees the handle when unsubscribed.
+                var handle = GCHandle.ToIntPtr(GCHandle.Alloc(slot));
+                Urho3D_Object_SubscribeToEvent(_dispatcher, IntPtr.Zero, eventType.Hash, EventCallbackPtr, handle);
+            }
+
+            var handlers = new EventDataHandler[slot.Handlers.Length + 1];
+            slot.Handlers.CopyTo(handlers, 0);
+            handlers[handlers.Length - 1] = handler;
+            slot.Handlers = handlers;
+            return new Subscription(this, eventType, handler);
+        }
+
+        /// <summary>
+        /// Subscribe to an event with typed arguments, for example E.UpdateArgs for E.Update.
+        /// </summary>
+        public IDisposable Subscribe<TArgs>(StringHash eventType, TypedEventHandler<TArgs> handler) where TArgs : struct, IEventArgs
+        {
+            return Subscribe(eventType, (StringHash type, in EventData data) =>
+            {
+                var args = default(TArgs);
+                args.Bind(in data);
+                handler(in args);
+            });
+        }
+
+        private void Unsubscribe(StringHash eventType, EventDataHandler handler)
+        {
+            if (!_slots.TryGetValue(eventType.Hash, out var slot))
+                return;
+
+            var index = Array.IndexOf(slot.Handlers, handler);
+            if (index < 0)
+                return;
+
+            if (slot.Handlers.Length == 1)
+            {
+                // Last handler is gone, stop receiving the event natively.
+                slot.Handlers = new EventDataHandler[0];
+                _slots.Remove(eventType.Hash);
+                if (_dispatcher != IntPtr.Zero)
+                    Urho3D_EventDispatcher_Unsubscribe(_dispatcher, eventType.Hash);
+                return;
+            }
+
+            var handlers = new EventDataHandler[slot.Handlers.Length - 1];
+            Array.Copy(slot.Handlers, 0, handlers, 0, index);
+            Array.Copy(slot.Handlers, index + 1, handlers, index, handlers.Length - index);
+            slot.Handlers = handlers;
+        }
+
+        public void Dispose()
+        {
+            if (_dispatcher == IntPtr.Zero)
+                return;
+
+            _slots.Clear();
+            Urho3D_EventDispatcher_Destroy(_dispatcher);
+            _dispatcher = IntPtr.Zero;
+        }
+    }
+}
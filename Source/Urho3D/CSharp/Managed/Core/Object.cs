@@ -31,17 +31,25 @@ namespace Urho3DNet
         private static extern void Urho3D_Object_SubscribeToEvent(HandleRef receiver, HandleRef sender, uint eventType,
             IntPtr callback, IntPtr callbackHandle);
 
-        private delegate void EventCallbackDelegate(uint eventHash, IntPtr argMap);
+        private delegate void EventCallbackDelegate(IntPtr callbackHandle, uint eventHash, IntPtr argMap);
+
+        /// <summary>
+        /// Single native-to-managed entry point for all event handlers. Kept alive for the lifetime of the process, so
+        /// subscribing does not allocate a delegate and a native thunk per handler.
+        /// </summary>
+        private static readonly EventCallbackDelegate EventCallback = HandleEventCallback;
+        private static readonly IntPtr EventCallbackPtr = Marshal.GetFunctionPointerForDelegate(EventCallback);
+
+        private static void HandleEventCallback(IntPtr callbackHandle, uint eventHash, IntPtr argMap)
+        {
+            var eventHandler = (Action<StringHash, VariantMap>)GCHandle.FromIntPtr(callbackHandle).Target;
+            eventHandler(new StringHash(eventHash), VariantMap.wrap(argMap, false));
+        }
 
         public void SubscribeToEvent(StringHash e, Object sender, Action<StringHash, VariantMap> eventHandler)
         {
-            var eventCallback = new EventCallbackDelegate((eventHash, argMap) =>
-                {
-                    eventHandler(new StringHash(eventHash), VariantMap.wrap(argMap, false));
-                });
-            var handle = GCHandle.ToIntPtr(GCHandle.Alloc(eventCallback));
-            var callback = Marshal.GetFunctionPointerForDelegate(eventCallback);
-            Urho3D_Object_SubscribeToEvent(swigCPtr, getCPtr(sender), e.Hash, callback, handle);
+            var handle = GCHandle.ToIntPtr(GCHandle.Alloc(eventHandler));
+            Urho3D_Object_SubscribeToEvent(swigCPtr, getCPtr(sender), e.Hash, EventCallbackPtr, handle);
         }
 
         public void SubscribeToEvent(StringHash e, Object sender, Action<VariantMap> eventHandler)
@@ -20,6 +20,10 @@
 // THE SOFTWARE.
 //
 
+using System;
+using System.Collections.Generic;
+using System.Runtime.InteropServices;
+
 namespace Urho3DNet
 {
     public partial class Node
@@ -55,5 +59,57 @@ namespace Urho3DNet
             GetComponents(componentList, typeof(T).Name, recursive);
             return componentList;
         }
+
+        [DllImport("Urho3D", EntryPoint = "Urho3D_Node_GetTransforms")]
+        private static extern void Urho3D_Node_GetTransforms(IntPtr[] nodes, int count, [MarshalAs(UnmanagedType.I1)] bool world,
+            [Out] Vector3[] positions, [Out] Quaternion[] rotations, [Out] Vector3[] scales);
+
+        [DllImport("Urho3D", EntryPoint = "Urho3D_Node_SetTransforms")]
+        private static extern void Urho3D_Node_SetTransforms(IntPtr[] nodes, int count, [MarshalAs(UnmanagedType.I1)] bool world,
+            [In] Vector3[] positions, [In] Quaternion[] rotations, [In] Vector3[] scales);
+
+        [ThreadStatic]
+        private static IntPtr[] _nodePointers;
+
+        private static IntPtr[] GetNodePointers(IReadOnlyList<Node> nodes)
+        {
+            if (_nodePointers == null || _nodePointers.Length < nodes.Count)
+                _nodePointers = new IntPtr[Math.Max(nodes.Count, 64)];
+            for (var i = 0; i < nodes.Count; ++i)
+                _nodePointers[i] = getCPtr(nodes[i]).Handle;
+            return _nodePointers;
+        }
+
+        private static void CheckTransformArray<T>(T[] values, int count, string name)
+        {
+            if (values != null && values.Length < count)
+                throw new ArgumentException("Array is shorter than the list of nodes.", name);
+        }
+
+        /// <summary>
+        /// Get transforms of many nodes with a single native call. Pass null for components that are not needed.
+        /// </summary>
+        public static void GetTransforms(IReadOnlyList<Node> nodes, bool world, Vector3[] positions,
+            Quaternion[] rotations = null, Vector3[] scales = null)
+        {
+            CheckTransformArray(positions, nodes.Count, nameof(positions));
+            CheckTransformArray(rotations, nodes.Count, nameof(rotations));
+            CheckTransformArray(scales, nodes.Count, nameof(scales));
+            Urho3D_Node_GetTransforms(GetNodePointers(nodes), nodes.Count, world, positions, rotations, scales);
+            GC.KeepAlive(nodes);
+        }
+
+        /// <summary>
+        /// Set transforms of many nodes with a single native call. Components passed as null keep their current value.
+        /// </summary>
+        public static void SetTransforms(IReadOnlyList<Node> nodes, bool world, Vector3[] positions,
+            Quaternion[] rotations = null, Vector3[] scales = null)
+        {
+            CheckTransformArray(positions, nodes.Count, nameof(positions));
+            CheckTransformArray(rotations, nodes.Count, nameof(rotations));
+            CheckTransformArray(scales, nodes.Count, nameof(scales));
+            Urho3D_Node_SetTransforms(GetNodePointers(nodes), nodes.Count, world, positions, rotations, scales);
+            GC.KeepAlive(nodes);
+        }
     }
 }
@@ -0,0 +1,68 @@
+﻿//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+using System;
+using System.Collections.Concurrent;
+using System.Linq.Expressions;
+using System.Reflection;
+
+namespace Urho3DNet
+{
+    /// <summary>
+    /// Creates wrapper objects of polymorphic types through compiled constructor delegates. Constructors are looked up
+    /// once per type, so wrapping a native pointer does not pay for reflection each time.
+    /// </summary>
+    internal static class WrapperFactory
+    {
+        private static readonly ConcurrentDictionary<Type, Func<IntPtr, bool, object>> Constructors =
+            new ConcurrentDictionary<Type, Func<IntPtr, bool, object>>();
+
+        /// <summary>
+        /// Create wrapper object of specified type for a native pointer.
+        /// </summary>
+        internal static object Create(Type type, IntPtr cPtr, bool cMemoryOwn)
+        {
+            return Constructors.GetOrAdd(type, CreateConstructor)(cPtr, cMemoryOwn);
+        }
+
+        private static Func<IntPtr, bool, object> CreateConstructor(Type type)
+        {
+            var constructor = type.GetConstructor(BindingFlags.Instance | BindingFlags.NonPublic | BindingFlags.Public,
+                null, new[] {typeof(IntPtr), typeof(bool)}, null);
+            if (constructor == null)
+                throw new MissingMethodException(type.FullName, ".ctor(IntPtr, bool)");
+
+            try
+            {
+                var cPtr = Expression.Parameter(typeof(IntPtr));
+                var cMemoryOwn = Expression.Parameter(typeof(bool));
+                return Expression.Lambda<Func<IntPtr, bool, object>>(
+                    Expression.Convert(Expression.New(constructor, cPtr, cMemoryOwn), typeof(object)), cPtr, cMemoryOwn).Compile();
+            }
+            catch (PlatformNotSupportedException)
+            {
+                // No code generation on AOT platforms, invoke cached constructor instead.
+                return (ptr, own) => constructor.Invoke(new object[] {ptr, own});
+            }
+        }
+    }
+}
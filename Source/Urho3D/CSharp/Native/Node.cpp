@@ -0,0 +1,98 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Scene/Node.h>
+#include <Urho3D/Script/Script.h>
+
+namespace Urho3D
+{
+
+extern "C"
+{
+
+// Batch transform accessors let managed code move many nodes with one native call instead of several calls per node.
+// Null position, rotation or scale arrays are skipped.
+
+URHO3D_EXPORT_API void SWIGSTDCALL Urho3D_Node_GetTransforms(Node** nodes, int count, bool world, Vector3* positions,
+    Quaternion* rotations, Vector3* scales)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        Node* node = nodes[i];
+        if (node == nullptr)
+            continue;
+
+        if (world)
+        {
+            if (positions)
+                positions[i] = node->GetWorldPosition();
+            if (rotations)
+                rotations[i] = node->GetWorldRotation();
+            if (scales)
+                scales[i] = node->GetWorldScale();
+        }
+        else
+        {
+            if (positions)
+                positions[i] = node->GetPosition();
+            if (rotations)
+                rotations[i] = node->GetRotation();
+            if (scales)
+                scales[i] = node->GetScale();
+        }
+    }
+}
+
+URHO3D_EXPORT_API void SWIGSTDCALL Urho3D_Node_SetTransforms(Node** nodes, int count, bool world, const Vector3* positions,
+    const Quaternion* rotations, const Vector3* scales)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        Node* node = nodes[i];
+        if (node == nullptr)
+            continue;
+
+        if (world)
+        {
+            // Set all components at once so that the world transform is decomposed only once
+            const Vector3 position = positions ? positions[i] : node->GetWorldPosition();
+            const Quaternion rotation = rotations ? rotations[i] : node->GetWorldRotation();
+            if (scales)
+                node->SetWorldTransform(position, rotation, scales[i]);
+            else
+                node->SetWorldTransform(position, rotation);
+        }
+        else
+        {
+            const Vector3 position = positions ? positions[i] : node->GetPosition();
+            const Quaternion rotation = rotations ? rotations[i] : node->GetRotation();
+            if (scales)
+                node->SetTransform(position, rotation, scales[i]);
+            else
+                node->SetTransform(position, rotation);
+        }
+    }
+}
+
+}   // extern "C"
+
+}   // namespace Urho3D
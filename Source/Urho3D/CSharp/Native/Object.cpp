@@ -26,7 +26,8 @@
 namespace Urho3D
 {
 
-typedef void(SWIGSTDCALL*EventHandlerCallback)(unsigned, VariantMap*);
+/// Callback shared by all managed event handlers. Receives handle of managed handler delegate.
+typedef void(SWIGSTDCALL*EventHandlerCallback)(void*, unsigned, VariantMap*);
 
 class ManagedEventHandler : public EventHandler
 {
@@ -46,7 +47,7 @@ public:
 
     void Invoke(VariantMap& eventData) override
     {
-        callback_(eventType_.Value(), &eventData);
+        callback_(callbackHandle_, eventType_.Value(), &eventData);
     }
 
     EventHandler* Clone() const override
@@ -61,6 +62,21 @@ protected:
     void* callbackHandle_ = nullptr;
 };
 
+/// Native receiver of managed EventDispatcher. Holds a single subscription per event type, managed side fans it out.
+class ManagedEventDispatcher : public Object
+{
+    URHO3D_OBJECT(ManagedEventDispatcher, Object);
+public:
+    explicit ManagedEventDispatcher(Context* context) : Object(context) { }
+};
+
+/// Return event parameter or empty variant if it is missing.
+static const Variant& GetEventParam(const VariantMap* eventData, unsigned key)
+{
+    auto it = eventData->find(StringHash(key));
+    return it != eventData->end() ? it->second : Variant::EMPTY;
+}
+
 extern "C"
 {
 
@@ -77,6 +93,72 @@ URHO3D_EXPORT_API void SWIGSTDCALL Urho3D_Object_SubscribeToEvent(Object* receiv
         receiver->SubscribeToEvent(sender, event, new ManagedEventHandler(receiver, callback, callbackHandle));
 }
 
+URHO3D_EXPORT_API Object* SWIGSTDCALL Urho3D_EventDispatcher_Create(Context* context)
+{
+    auto* dispatcher = new ManagedEventDispatcher(context);
+    dispatcher->AddRef();
+    return dispatcher;
+}
+
+URHO3D_EXPORT_API void SWIGSTDCALL Urho3D_EventDispatcher_Destroy(Object* dispatcher)
+{
+    dispatcher->ReleaseRef();
+}
+
+URHO3D_EXPORT_API void SWIGSTDCALL Urho3D_EventDispatcher_Unsubscribe(Object* dispatcher, unsigned eventType)
+{
+    dispatcher->UnsubscribeFromEvent(StringHash(eventType));
+}
+
+// Typed accessors of event parameters. They read values in place, without wrapping the VariantMap or its Variants.
+
+URHO3D_EXPORT_API int SWIGSTDCALL Urho3D_EventData_GetInt(const VariantMap* eventData, unsigned key)
+{
+    return GetEventParam(eventData, key).GetInt();
+}
+
+URHO3D_EXPORT_API unsigned SWIGSTDCALL Urho3D_EventData_GetUInt(const VariantMap* eventData, unsigned key)
+{
+    return GetEventParam(eventData, key).GetUInt();
+}
+
+URHO3D_EXPORT_API float SWIGSTDCALL Urho3D_EventData_GetFloat(const VariantMap* eventData, unsigned key)
+{
+    return GetEventParam(eventData, key).GetFloat();
+}
+
+URHO3D_EXPORT_API bool SWIGSTDCALL Urho3D_EventData_GetBool(const VariantMap* eventData, unsigned key)
+{
+    return GetEventParam(eventData, key).GetBool();
+}
+
+URHO3D_EXPORT_API const char* SWIGSTDCALL Urho3D_EventData_GetString(const VariantMap* eventData, unsigned key, int* length)
+{
+    const ea::string& value = GetEventParam(eventData, key).GetString();
+    *length = static_cast<int>(value.length());
+    return value.c_str();
+}
+
+URHO3D_EXPORT_API unsigned SWIGSTDCALL Urho3D_EventData_GetStringHash(const VariantMap* eventData, unsigned key)
+{
+    return GetEventParam(eventData, key).GetStringHash().Value();
+}
+
+URHO3D_EXPORT_API void SWIGSTDCALL Urho3D_EventData_GetVector3(const VariantMap* eventData, unsigned key, Vector3* value)
+{
+    *value = GetEventParam(eventData, key).GetVector3();
+}
+
+URHO3D_EXPORT_API void SWIGSTDCALL Urho3D_EventData_GetIntVector2(const VariantMap* eventData, unsigned key, IntVector2* value)
+{
+    *value = GetEventParam(eventData, key).GetIntVector2();
+}
+
+URHO3D_EXPORT_API RefCounted* SWIGSTDCALL Urho3D_EventData_GetPtr(const VariantMap* eventData, unsigned key)
+{
+    return GetEventParam(eventData, key).GetPtr();
+}
+
 }
 
 }
@@ -17,7 +17,7 @@
         type = typeof($csclassname);
       if (type == typeof($csclassname))
         return new $csclassname(cPtr, cMemoryOwn);
-      return ($csclassname)global::System.Activator.CreateInstance(type, global::System.Reflection.BindingFlags.Instance|global::System.Reflection.BindingFlags.NonPublic|global::System.Reflection.BindingFlags.Public, null, new object[]{cPtr, cMemoryOwn}, null);
+      return ($csclassname)global::Urho3DNet.WrapperFactory.Create(type, cPtr, cMemoryOwn);
     });
   }
 
@@ -50,7 +50,7 @@
         type = typeof($csclassname);
       if (type == typeof($csclassname))
         return new $csclassname(cPtr, cMemoryOwn);
-      return ($csclassname)global::System.Activator.CreateInstance(type, global::System.Reflection.BindingFlags.Instance|global::System.Reflection.BindingFlags.NonPublic|global::System.Reflection.BindingFlags.Public, null, new object[]{cPtr, cMemoryOwn}, null);
+      return ($csclassname)global::Urho3DNet.WrapperFactory.Create(type, cPtr, cMemoryOwn);
     });
   }
 
@@ -29,11 +29,11 @@
         if (!$imclassname.SWIGTypeRegistry.TryGetValue($imclassname.$csclazznameSWIGTypeId(cPtr), out type))
           type = typeof($csclassname);
         if (type == typeof($csclassname))
-          // A fast path when type is not polymorphic. Using activator is not exactly cheap.
+          // A fast path when type is not polymorphic.
           result = new $csclassname(cPtr, cMemoryOwn);
         else
-          // Type is polymorphic. Use activator to construct object from opaque Type object.
-          result = ($csclassname)global::System.Activator.CreateInstance(type, global::System.Reflection.BindingFlags.Instance|global::System.Reflection.BindingFlags.NonPublic|global::System.Reflection.BindingFlags.Public, null, new object[]{cPtr, cMemoryOwn}, null);
+          // Type is polymorphic. Construct object from opaque Type object through a cached constructor delegate.
+          result = ($csclassname)global::Urho3DNet.WrapperFactory.Create(type, cPtr, cMemoryOwn);
         return result;
       }
 
@@ -83,11 +83,11 @@
         if (!$imclassname.SWIGTypeRegistry.TryGetValue($imclassname.$csclazznameSWIGTypeId(cPtr), out type))
           type = typeof($csclassname);
         if (type == typeof($csclassname))
-          // A fast path when type is not polymorphic. Using activator is not exactly cheap.
+          // A fast path when type is not polymorphic.
           result = new $csclassname(cPtr, cMemoryOwn);
         else
-          // Type is polymorphic. Use activator to construct object from opaque Type object.
-          result = ($csclassname)global::System.Activator.CreateInstance(type, global::System.Reflection.BindingFlags.Instance|global::System.Reflection.BindingFlags.NonPublic|global::System.Reflection.BindingFlags.Public, null, new object[]{cPtr, cMemoryOwn}, null);
+          // Type is polymorphic. Construct object from opaque Type object through a cached constructor delegate.
+          result = ($csclassname)global::Urho3DNet.WrapperFactory.Create(type, cPtr, cMemoryOwn);
         return result;
       }
 
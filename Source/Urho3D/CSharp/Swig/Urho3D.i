@@ -233,6 +233,10 @@ AddEqualityOperators(Urho3D::Variant);
 %ignore Urho3D::ConstantBuffer::OnDeviceLost;
 %ignore Urho3D::ConstantBuffer::OnDeviceReset;
 %ignore Urho3D::ConstantBuffer::Release;
+%ignore Urho3D::OcclusionQuery::OnDeviceLost;
+%ignore Urho3D::OcclusionQuery::Release;
+%ignore Urho3D::GPUProfiler::OnDeviceLost;
+%ignore Urho3D::GPUProfiler::Release;
 %ignore Urho3D::ShaderVariation::OnDeviceLost;
 %ignore Urho3D::ShaderVariation::OnDeviceReset;
 %ignore Urho3D::ShaderVariation::Release;
@@ -299,6 +303,10 @@ namespace SDL
 // --------------------------------------- Engine ---------------------------------------
 %include "_properties_engine.i"
 %ignore Urho3D::Engine::DefineParameters;
+%ignore Urho3D::Engine::onUpdate_;
+%ignore Urho3D::Engine::onPostUpdate_;
+%ignore Urho3D::Engine::onRenderUpdate_;
+%ignore Urho3D::Engine::onPostRenderUpdate_;
 
 %include "Urho3D/Engine/EngineDefs.h"
 %include "Urho3D/Engine/Engine.h"
@@ -441,6 +449,8 @@ public:
 %ignore Urho3D::Node::SetEntity;
 %ignore Urho3D::Scene::GetRegistry;
 %ignore Urho3D::Scene::GetComponentIndex;
+%ignore Urho3D::Scene::onSceneUpdate_;
+%ignore Urho3D::Scene::onScenePostUpdate_;
 
 %include "Urho3D/Scene/AnimationDefs.h"
 %include "Urho3D/Scene/ValueAnimationInfo.h"
@@ -463,6 +473,11 @@ public:
 %ignore Urho3D::BufferedSoundStream::AddData(const ea::shared_array<signed char>& data, unsigned numBytes);
 %ignore Urho3D::BufferedSoundStream::AddData(const ea::shared_array<signed short>& data, unsigned numBytes);
 %ignore Urho3D::Sound::GetData;
+// Audio thread internals.
+%ignore Urho3D::Audio::SendCommand;
+%ignore Urho3D::Audio::ReleaseWhenUnused;
+%ignore Urho3D::Audio::DecodeAhead;
+%ignore Urho3D::SoundSource::GetVoice;
 
 %include "Urho3D/Audio/AudioDefs.h"
 %include "Urho3D/Audio/Audio.h"
@@ -483,6 +498,7 @@ public:
 %include "Urho3D/IK/IKEffector.h"
 %include "Urho3D/IK/IK.h"
 %include "Urho3D/IK/IKSolver.h"
+%include "Urho3D/IK/IKWorld.h"
 #endif
 // --------------------------------------- Graphics ---------------------------------------
 %include "_properties_graphics.i"
@@ -491,16 +507,17 @@ public:
 %ignore Urho3D::AllContentOctreeQuery::TestDrawables;
 %ignore Urho3D::PointOctreeQuery::TestDrawables;
 %ignore Urho3D::BoxOctreeQuery::TestDrawables;
+%ignore Urho3D::MultiFrustumOctreeQuery::TestDrawables;
+%ignore Urho3D::MultiFrustumOctreeQuery::FrustumEntry;
+%ignore Urho3D::MultiFrustumOctreeQuery::frustums_;
 %ignore Urho3D::OctreeQuery::TestDrawables;
-%ignore Urho3D::UpdateDrawablesWork;
-%ignore Urho3D::ProcessLightWork;
 %ignore Urho3D::CheckVisibilityWork;
-%ignore Urho3D::CheckDrawableVisibilityWork;
 %ignore Urho3D::ELEMENT_TYPESIZES;
 %ignore Urho3D::ScratchBuffer;
 %ignore Urho3D::Drawable::GetBatches;
 %ignore Urho3D::Light::SetLightQueue;
 %ignore Urho3D::Light::GetLightQueue;
+%ignore Urho3D::Light::GetVolumeDrawables;
 %ignore Urho3D::Renderer::SetShadowMapFilter;
 %ignore Urho3D::Renderer::SetBatchShaders;
 %ignore Urho3D::Renderer::SetLightVolumeBatchShaders;
@@ -529,7 +546,18 @@ public:
 %ignore Urho3D::OcclusionBufferData::dataWithSafety_;
 %ignore Urho3D::ScenePassInfo::batchQueue_;
 %ignore Urho3D::LightQueryResult;
+%ignore Urho3D::DrawableOcclusionQuery;
+%ignore Urho3D::ZoneIndex;
 %ignore Urho3D::View::GetLightQueues;
+%ignore Urho3D::View::AddToSharedCulling;
+%ignore Urho3D::DebugShapeBatch;
+%ignore Urho3D::PersistentDebugGeometry;
+%ignore Urho3D::DebugRenderer::AddLines;
+%ignore Urho3D::DebugRenderer::AddTriangles;
+%ignore Urho3D::DebugRenderer::AddBoxes;
+%ignore Urho3D::DebugRenderer::AddSpheres;
+%ignore Urho3D::DebugRenderer::AddPersistentLines;
+%ignore Urho3D::DebugRenderer::AddPersistentTriangles;
 %rename(DrawableFlags) Urho3D::DrawableFlag;
 
 %apply void* VOID_INT_PTR {
@@ -569,6 +597,9 @@ public:
 %include "Urho3D/Graphics/DecalSet.h"
 %include "Urho3D/Graphics/Light.h"
 %include "Urho3D/Graphics/ConstantBuffer.h"
+%include "Urho3D/Graphics/OcclusionQuery.h"
+%include "Urho3D/Graphics/GPUProfiler.h"
+%include "Urho3D/Graphics/RenderStatistics.h"
 %include "Urho3D/Graphics/ShaderVariation.h"
 %include "Urho3D/Graphics/ShaderPrecache.h"
 #if defined(URHO3D_OPENGL)
@@ -588,6 +619,8 @@ public:
 %include "Urho3D/Graphics/RibbonTrail.h"
 %include "Urho3D/Graphics/Technique.h"
 %include "Urho3D/Graphics/ParticleEmitter.h"
+%include "Urho3D/Graphics/GPUParticleEmitter.h"
+%include "Urho3D/Graphics/ProjectedDecal.h"
 %include "Urho3D/Graphics/Shader.h"
 %include "Urho3D/Graphics/Skybox.h"
 %include "Urho3D/Graphics/TerrainPatch.h"
@@ -633,6 +666,7 @@ public:
 #if defined(URHO3D_NETWORK)
 %include "_properties_network.i"
 %ignore Urho3D::Network::MakeHttpRequest;
+%ignore Urho3D::Network::GetHttpClient;
 %ignore Urho3D::PackageDownload;
 %ignore Urho3D::PackageUpload;
 
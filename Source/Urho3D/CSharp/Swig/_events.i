@@ -11,6 +11,12 @@ public static class E
         public static implicit operator StringHash(SoundFinishedEvent e) { return e._event; }
     }
     public static SoundFinishedEvent SoundFinished = new SoundFinishedEvent();
+    public struct SoundFinishedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node Node => Node.wrap(_data.GetPtr(E.SoundFinished.Node), false);
+    }
 
     public class BeginFrameEvent {
         private StringHash _event = new StringHash("BeginFrame");
@@ -21,6 +27,13 @@ public static class E
         public static implicit operator StringHash(BeginFrameEvent e) { return e._event; }
     }
     public static BeginFrameEvent BeginFrame = new BeginFrameEvent();
+    public struct BeginFrameArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public uint FrameNumber => _data.GetUInt(E.BeginFrame.FrameNumber);
+        public float TimeStep => _data.GetFloat(E.BeginFrame.TimeStep);
+    }
 
     public class UpdateEvent {
         private StringHash _event = new StringHash("Update");
@@ -30,6 +43,12 @@ public static class E
         public static implicit operator StringHash(UpdateEvent e) { return e._event; }
     }
     public static UpdateEvent Update = new UpdateEvent();
+    public struct UpdateArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public float TimeStep => _data.GetFloat(E.Update.TimeStep);
+    }
 
     public class PostUpdateEvent {
         private StringHash _event = new StringHash("PostUpdate");
@@ -39,6 +58,12 @@ public static class E
         public static implicit operator StringHash(PostUpdateEvent e) { return e._event; }
     }
     public static PostUpdateEvent PostUpdate = new PostUpdateEvent();
+    public struct PostUpdateArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public float TimeStep => _data.GetFloat(E.PostUpdate.TimeStep);
+    }
 
     public class RenderUpdateEvent {
         private StringHash _event = new StringHash("RenderUpdate");
@@ -48,6 +73,12 @@ public static class E
         public static implicit operator StringHash(RenderUpdateEvent e) { return e._event; }
     }
     public static RenderUpdateEvent RenderUpdate = new RenderUpdateEvent();
+    public struct RenderUpdateArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public float TimeStep => _data.GetFloat(E.RenderUpdate.TimeStep);
+    }
 
     public class PostRenderUpdateEvent {
         private StringHash _event = new StringHash("PostRenderUpdate");
@@ -57,6 +88,12 @@ public static class E
         public static implicit operator StringHash(PostRenderUpdateEvent e) { return e._event; }
     }
     public static PostRenderUpdateEvent PostRenderUpdate = new PostRenderUpdateEvent();
+    public struct PostRenderUpdateArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public float TimeStep => _data.GetFloat(E.PostRenderUpdate.TimeStep);
+    }
 
     public class EndFrameEvent {
         private StringHash _event = new StringHash("EndFrame");
@@ -65,6 +102,11 @@ public static class E
         public static implicit operator StringHash(EndFrameEvent e) { return e._event; }
     }
     public static EndFrameEvent EndFrame = new EndFrameEvent();
+    public struct EndFrameArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class WorkItemCompletedEvent {
         private StringHash _event = new StringHash("WorkItemCompleted");
@@ -74,6 +116,11 @@ public static class E
         public static implicit operator StringHash(WorkItemCompletedEvent e) { return e._event; }
     }
     public static WorkItemCompletedEvent WorkItemCompleted = new WorkItemCompletedEvent();
+    public struct WorkItemCompletedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class ConsoleCommandEvent {
         private StringHash _event = new StringHash("ConsoleCommand");
@@ -84,6 +131,13 @@ public static class E
         public static implicit operator StringHash(ConsoleCommandEvent e) { return e._event; }
     }
     public static ConsoleCommandEvent ConsoleCommand = new ConsoleCommandEvent();
+    public struct ConsoleCommandArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public string Command => _data.GetString(E.ConsoleCommand.Command);
+        public string Id => _data.GetString(E.ConsoleCommand.Id);
+    }
 
     public class ConsoleUriClickEvent {
         private StringHash _event = new StringHash("ConsoleUriClick");
@@ -94,6 +148,13 @@ public static class E
         public static implicit operator StringHash(ConsoleUriClickEvent e) { return e._event; }
     }
     public static ConsoleUriClickEvent ConsoleUriClick = new ConsoleUriClickEvent();
+    public struct ConsoleUriClickArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public string Address => _data.GetString(E.ConsoleUriClick.Address);
+        public string Protocol => _data.GetString(E.ConsoleUriClick.Protocol);
+    }
 
     public class EngineInitializedEvent {
         private StringHash _event = new StringHash("EngineInitialized");
@@ -102,6 +163,11 @@ public static class E
         public static implicit operator StringHash(EngineInitializedEvent e) { return e._event; }
     }
     public static EngineInitializedEvent EngineInitialized = new EngineInitializedEvent();
+    public struct EngineInitializedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class ApplicationStartedEvent {
         private StringHash _event = new StringHash("ApplicationStarted");
@@ -110,6 +176,11 @@ public static class E
         public static implicit operator StringHash(ApplicationStartedEvent e) { return e._event; }
     }
     public static ApplicationStartedEvent ApplicationStarted = new ApplicationStartedEvent();
+    public struct ApplicationStartedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class PluginLoadEvent {
         private StringHash _event = new StringHash("PluginLoad");
@@ -118,6 +189,11 @@ public static class E
         public static implicit operator StringHash(PluginLoadEvent e) { return e._event; }
     }
     public static PluginLoadEvent PluginLoad = new PluginLoadEvent();
+    public struct PluginLoadArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class PluginUnloadEvent {
         private StringHash _event = new StringHash("PluginUnload");
@@ -126,6 +202,11 @@ public static class E
         public static implicit operator StringHash(PluginUnloadEvent e) { return e._event; }
     }
     public static PluginUnloadEvent PluginUnload = new PluginUnloadEvent();
+    public struct PluginUnloadArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class PluginStartEvent {
         private StringHash _event = new StringHash("PluginStart");
@@ -134,6 +215,11 @@ public static class E
         public static implicit operator StringHash(PluginStartEvent e) { return e._event; }
     }
     public static PluginStartEvent PluginStart = new PluginStartEvent();
+    public struct PluginStartArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class PluginStopEvent {
         private StringHash _event = new StringHash("PluginStop");
@@ -142,6 +228,11 @@ public static class E
         public static implicit operator StringHash(PluginStopEvent e) { return e._event; }
     }
     public static PluginStopEvent PluginStop = new PluginStopEvent();
+    public struct PluginStopArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class RegisterStaticPluginsEvent {
         private StringHash _event = new StringHash("RegisterStaticPlugins");
@@ -150,6 +241,11 @@ public static class E
         public static implicit operator StringHash(RegisterStaticPluginsEvent e) { return e._event; }
     }
     public static RegisterStaticPluginsEvent RegisterStaticPlugins = new RegisterStaticPluginsEvent();
+    public struct RegisterStaticPluginsArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class BoneHierarchyCreatedEvent {
         private StringHash _event = new StringHash("BoneHierarchyCreated");
@@ -159,6 +255,12 @@ public static class E
         public static implicit operator StringHash(BoneHierarchyCreatedEvent e) { return e._event; }
     }
     public static BoneHierarchyCreatedEvent BoneHierarchyCreated = new BoneHierarchyCreatedEvent();
+    public struct BoneHierarchyCreatedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node Node => Node.wrap(_data.GetPtr(E.BoneHierarchyCreated.Node), false);
+    }
 
     public class AnimationTriggerEvent {
         private StringHash _event = new StringHash("AnimationTrigger");
@@ -172,6 +274,14 @@ public static class E
         public static implicit operator StringHash(AnimationTriggerEvent e) { return e._event; }
     }
     public static AnimationTriggerEvent AnimationTrigger = new AnimationTriggerEvent();
+    public struct AnimationTriggerArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node Node => Node.wrap(_data.GetPtr(E.AnimationTrigger.Node), false);
+        public string Name => _data.GetString(E.AnimationTrigger.Name);
+        public float Time => _data.GetFloat(E.AnimationTrigger.Time);
+    }
 
     public class AnimationFinishedEvent {
         private StringHash _event = new StringHash("AnimationFinished");
@@ -184,6 +294,13 @@ public static class E
         public static implicit operator StringHash(AnimationFinishedEvent e) { return e._event; }
     }
     public static AnimationFinishedEvent AnimationFinished = new AnimationFinishedEvent();
+    public struct AnimationFinishedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node Node => Node.wrap(_data.GetPtr(E.AnimationFinished.Node), false);
+        public string Name => _data.GetString(E.AnimationFinished.Name);
+    }
 
     public class ParticleEffectFinishedEvent {
         private StringHash _event = new StringHash("ParticleEffectFinished");
@@ -194,6 +311,12 @@ public static class E
         public static implicit operator StringHash(ParticleEffectFinishedEvent e) { return e._event; }
     }
     public static ParticleEffectFinishedEvent ParticleEffectFinished = new ParticleEffectFinishedEvent();
+    public struct ParticleEffectFinishedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node Node => Node.wrap(_data.GetPtr(E.ParticleEffectFinished.Node), false);
+    }
 
     public class TerrainCreatedEvent {
         private StringHash _event = new StringHash("TerrainCreated");
@@ -203,6 +326,12 @@ public static class E
         public static implicit operator StringHash(TerrainCreatedEvent e) { return e._event; }
     }
     public static TerrainCreatedEvent TerrainCreated = new TerrainCreatedEvent();
+    public struct TerrainCreatedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node Node => Node.wrap(_data.GetPtr(E.TerrainCreated.Node), false);
+    }
 
     public class ScreenModeEvent {
         private StringHash _event = new StringHash("ScreenMode");
@@ -219,6 +348,19 @@ public static class E
         public static implicit operator StringHash(ScreenModeEvent e) { return e._event; }
     }
     public static ScreenModeEvent ScreenMode = new ScreenModeEvent();
+    public struct ScreenModeArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public int Width => _data.GetInt(E.ScreenMode.Width);
+        public int Height => _data.GetInt(E.ScreenMode.Height);
+        public bool Fullscreen => _data.GetBool(E.ScreenMode.Fullscreen);
+        public bool Borderless => _data.GetBool(E.ScreenMode.Borderless);
+        public bool Resizable => _data.GetBool(E.ScreenMode.Resizable);
+        public bool HighDPI => _data.GetBool(E.ScreenMode.HighDPI);
+        public int Monitor => _data.GetInt(E.ScreenMode.Monitor);
+        public int RefreshRate => _data.GetInt(E.ScreenMode.RefreshRate);
+    }
 
     public class WindowPosEvent {
         private StringHash _event = new StringHash("WindowPos");
@@ -229,6 +371,13 @@ public static class E
         public static implicit operator StringHash(WindowPosEvent e) { return e._event; }
     }
     public static WindowPosEvent WindowPos = new WindowPosEvent();
+    public struct WindowPosArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public int X => _data.GetInt(E.WindowPos.X);
+        public int Y => _data.GetInt(E.WindowPos.Y);
+    }
 
     public class RenderSurfaceUpdateEvent {
         private StringHash _event = new StringHash("RenderSurfaceUpdate");
@@ -237,6 +386,11 @@ public static class E
         public static implicit operator StringHash(RenderSurfaceUpdateEvent e) { return e._event; }
     }
     public static RenderSurfaceUpdateEvent RenderSurfaceUpdate = new RenderSurfaceUpdateEvent();
+    public struct RenderSurfaceUpdateArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class BeginRenderingEvent {
         private StringHash _event = new StringHash("BeginRendering");
@@ -245,6 +399,11 @@ public static class E
         public static implicit operator StringHash(BeginRenderingEvent e) { return e._event; }
     }
     public static BeginRenderingEvent BeginRendering = new BeginRenderingEvent();
+    public struct BeginRenderingArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class EndRenderingEvent {
         private StringHash _event = new StringHash("EndRendering");
@@ -253,6 +412,11 @@ public static class E
         public static implicit operator StringHash(EndRenderingEvent e) { return e._event; }
     }
     public static EndRenderingEvent EndRendering = new EndRenderingEvent();
+    public struct EndRenderingArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class BeginViewUpdateEvent {
         private StringHash _event = new StringHash("BeginViewUpdate");
@@ -266,6 +430,13 @@ public static class E
         public static implicit operator StringHash(BeginViewUpdateEvent e) { return e._event; }
     }
     public static BeginViewUpdateEvent BeginViewUpdate = new BeginViewUpdateEvent();
+    public struct BeginViewUpdateArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Scene Scene => Scene.wrap(_data.GetPtr(E.BeginViewUpdate.Scene), false);
+        public Camera Camera => Camera.wrap(_data.GetPtr(E.BeginViewUpdate.Camera), false);
+    }
 
     public class EndViewUpdateEvent {
         private StringHash _event = new StringHash("EndViewUpdate");
@@ -279,6 +450,13 @@ public static class E
         public static implicit operator StringHash(EndViewUpdateEvent e) { return e._event; }
     }
     public static EndViewUpdateEvent EndViewUpdate = new EndViewUpdateEvent();
+    public struct EndViewUpdateArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Scene Scene => Scene.wrap(_data.GetPtr(E.EndViewUpdate.Scene), false);
+        public Camera Camera => Camera.wrap(_data.GetPtr(E.EndViewUpdate.Camera), false);
+    }
 
     public class BeginViewRenderEvent {
         private StringHash _event = new StringHash("BeginViewRender");
@@ -292,6 +470,13 @@ public static class E
         public static implicit operator StringHash(BeginViewRenderEvent e) { return e._event; }
     }
     public static BeginViewRenderEvent BeginViewRender = new BeginViewRenderEvent();
+    public struct BeginViewRenderArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Scene Scene => Scene.wrap(_data.GetPtr(E.BeginViewRender.Scene), false);
+        public Camera Camera => Camera.wrap(_data.GetPtr(E.BeginViewRender.Camera), false);
+    }
 
     public class ViewBuffersReadyEvent {
         private StringHash _event = new StringHash("ViewBuffersReady");
@@ -305,6 +490,13 @@ public static class E
         public static implicit operator StringHash(ViewBuffersReadyEvent e) { return e._event; }
     }
     public static ViewBuffersReadyEvent ViewBuffersReady = new ViewBuffersReadyEvent();
+    public struct ViewBuffersReadyArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Scene Scene => Scene.wrap(_data.GetPtr(E.ViewBuffersReady.Scene), false);
+        public Camera Camera => Camera.wrap(_data.GetPtr(E.ViewBuffersReady.Camera), false);
+    }
 
     public class ViewGlobalShaderParametersEvent {
         private StringHash _event = new StringHash("ViewGlobalShaderParameters");
@@ -318,6 +510,13 @@ public static class E
         public static implicit operator StringHash(ViewGlobalShaderParametersEvent e) { return e._event; }
     }
     public static ViewGlobalShaderParametersEvent ViewGlobalShaderParameters = new ViewGlobalShaderParametersEvent();
+    public struct ViewGlobalShaderParametersArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Scene Scene => Scene.wrap(_data.GetPtr(E.ViewGlobalShaderParameters.Scene), false);
+        public Camera Camera => Camera.wrap(_data.GetPtr(E.ViewGlobalShaderParameters.Camera), false);
+    }
 
     public class EndViewRenderEvent {
         private StringHash _event = new StringHash("EndViewRender");
@@ -331,6 +530,13 @@ public static class E
         public static implicit operator StringHash(EndViewRenderEvent e) { return e._event; }
     }
     public static EndViewRenderEvent EndViewRender = new EndViewRenderEvent();
+    public struct EndViewRenderArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Scene Scene => Scene.wrap(_data.GetPtr(E.EndViewRender.Scene), false);
+        public Camera Camera => Camera.wrap(_data.GetPtr(E.EndViewRender.Camera), false);
+    }
 
     public class EndAllViewsRenderEvent {
         private StringHash _event = new StringHash("EndAllViewsRender");
@@ -339,6 +545,11 @@ public static class E
         public static implicit operator StringHash(EndAllViewsRenderEvent e) { return e._event; }
     }
     public static EndAllViewsRenderEvent EndAllViewsRender = new EndAllViewsRenderEvent();
+    public struct EndAllViewsRenderArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class RenderPathEventEvent {
         private StringHash _event = new StringHash("RenderPathEvent");
@@ -348,6 +559,12 @@ public static class E
         public static implicit operator StringHash(RenderPathEventEvent e) { return e._event; }
     }
     public static RenderPathEventEvent RenderPathEvent = new RenderPathEventEvent();
+    public struct RenderPathEventArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public string Name => _data.GetString(E.RenderPathEvent.Name);
+    }
 
     public class DeviceLostEvent {
         private StringHash _event = new StringHash("DeviceLost");
@@ -356,6 +573,11 @@ public static class E
         public static implicit operator StringHash(DeviceLostEvent e) { return e._event; }
     }
     public static DeviceLostEvent DeviceLost = new DeviceLostEvent();
+    public struct DeviceLostArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class DeviceResetEvent {
         private StringHash _event = new StringHash("DeviceReset");
@@ -364,6 +586,11 @@ public static class E
         public static implicit operator StringHash(DeviceResetEvent e) { return e._event; }
     }
     public static DeviceResetEvent DeviceReset = new DeviceResetEvent();
+    public struct DeviceResetArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class IKEffectorTargetChangedEvent {
         private StringHash _event = new StringHash("IKEffectorTargetChanged");
@@ -374,6 +601,11 @@ public static class E
         public static implicit operator StringHash(IKEffectorTargetChangedEvent e) { return e._event; }
     }
     public static IKEffectorTargetChangedEvent IKEffectorTargetChanged = new IKEffectorTargetChangedEvent();
+    public struct IKEffectorTargetChangedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class LogMessageEvent {
         private StringHash _event = new StringHash("LogMessage");
@@ -386,6 +618,15 @@ public static class E
         public static implicit operator StringHash(LogMessageEvent e) { return e._event; }
     }
     public static LogMessageEvent LogMessage = new LogMessageEvent();
+    public struct LogMessageArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public string Message => _data.GetString(E.LogMessage.Message);
+        public string Logger => _data.GetString(E.LogMessage.Logger);
+        public int Level => _data.GetInt(E.LogMessage.Level);
+        public uint Time => _data.GetUInt(E.LogMessage.Time);
+    }
 
     public class AsyncExecFinishedEvent {
         private StringHash _event = new StringHash("AsyncExecFinished");
@@ -396,6 +637,13 @@ public static class E
         public static implicit operator StringHash(AsyncExecFinishedEvent e) { return e._event; }
     }
     public static AsyncExecFinishedEvent AsyncExecFinished = new AsyncExecFinishedEvent();
+    public struct AsyncExecFinishedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public uint RequestID => _data.GetUInt(E.AsyncExecFinished.RequestID);
+        public int ExitCode => _data.GetInt(E.AsyncExecFinished.ExitCode);
+    }
 
     public class MouseButtonDownEvent {
         private StringHash _event = new StringHash("MouseButtonDown");
@@ -407,6 +655,14 @@ public static class E
         public static implicit operator StringHash(MouseButtonDownEvent e) { return e._event; }
     }
     public static MouseButtonDownEvent MouseButtonDown = new MouseButtonDownEvent();
+    public struct MouseButtonDownArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public int Button => _data.GetInt(E.MouseButtonDown.Button);
+        public int Buttons => _data.GetInt(E.MouseButtonDown.Buttons);
+        public int Qualifiers => _data.GetInt(E.MouseButtonDown.Qualifiers);
+    }
 
     public class MouseButtonUpEvent {
         private StringHash _event = new StringHash("MouseButtonUp");
@@ -418,6 +674,14 @@ public static class E
         public static implicit operator StringHash(MouseButtonUpEvent e) { return e._event; }
     }
     public static MouseButtonUpEvent MouseButtonUp = new MouseButtonUpEvent();
+    public struct MouseButtonUpArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public int Button => _data.GetInt(E.MouseButtonUp.Button);
+        public int Buttons => _data.GetInt(E.MouseButtonUp.Buttons);
+        public int Qualifiers => _data.GetInt(E.MouseButtonUp.Qualifiers);
+    }
 
     public class MouseMoveEvent {
         private StringHash _event = new StringHash("MouseMove");
@@ -432,6 +696,15 @@ public static class E
         public static implicit operator StringHash(MouseMoveEvent e) { return e._event; }
     }
     public static MouseMoveEvent MouseMove = new MouseMoveEvent();
+    public struct MouseMoveArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public int Dx => _data.GetInt(E.MouseMove.Dx);
+        public int Dy => _data.GetInt(E.MouseMove.Dy);
+        public int Buttons => _data.GetInt(E.MouseMove.Buttons);
+        public int Qualifiers => _data.GetInt(E.MouseMove.Qualifiers);
+    }
 
     public class MouseWheelEvent {
         private StringHash _event = new StringHash("MouseWheel");
@@ -443,6 +716,14 @@ public static class E
         public static implicit operator StringHash(MouseWheelEvent e) { return e._event; }
     }
     public static MouseWheelEvent MouseWheel = new MouseWheelEvent();
+    public struct MouseWheelArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public int Wheel => _data.GetInt(E.MouseWheel.Wheel);
+        public int Buttons => _data.GetInt(E.MouseWheel.Buttons);
+        public int Qualifiers => _data.GetInt(E.MouseWheel.Qualifiers);
+    }
 
     public class KeyDownEvent {
         private StringHash _event = new StringHash("KeyDown");
@@ -456,6 +737,16 @@ public static class E
         public static implicit operator StringHash(KeyDownEvent e) { return e._event; }
     }
     public static KeyDownEvent KeyDown = new KeyDownEvent();
+    public struct KeyDownArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public int Key => _data.GetInt(E.KeyDown.Key);
+        public int Scancode => _data.GetInt(E.KeyDown.Scancode);
+        public int Buttons => _data.GetInt(E.KeyDown.Buttons);
+        public int Qualifiers => _data.GetInt(E.KeyDown.Qualifiers);
+        public bool Repeat => _data.GetBool(E.KeyDown.Repeat);
+    }
 
     public class KeyUpEvent {
         private StringHash _event = new StringHash("KeyUp");
@@ -468,6 +759,15 @@ public static class E
         public static implicit operator StringHash(KeyUpEvent e) { return e._event; }
     }
     public static KeyUpEvent KeyUp = new KeyUpEvent();
+    public struct KeyUpArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public int Key => _data.GetInt(E.KeyUp.Key);
+        public int Scancode => _data.GetInt(E.KeyUp.Scancode);
+        public int Buttons => _data.GetInt(E.KeyUp.Buttons);
+        public int Qualifiers => _data.GetInt(E.KeyUp.Qualifiers);
+    }
 
     public class TextInputEvent {
         private StringHash _event = new StringHash("TextInput");
@@ -477,6 +777,12 @@ public static class E
         public static implicit operator StringHash(TextInputEvent e) { return e._event; }
     }
     public static TextInputEvent TextInput = new TextInputEvent();
+    public struct TextInputArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public string Text => _data.GetString(E.TextInput.Text);
+    }
 
     public class TextEditingEvent {
         private StringHash _event = new StringHash("TextEditing");
@@ -488,6 +794,14 @@ public static class E
         public static implicit operator StringHash(TextEditingEvent e) { return e._event; }
     }
     public static TextEditingEvent TextEditing = new TextEditingEvent();
+    public struct TextEditingArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public string Composition => _data.GetString(E.TextEditing.Composition);
+        public int Cursor => _data.GetInt(E.TextEditing.Cursor);
+        public int SelectionLength => _data.GetInt(E.TextEditing.SelectionLength);
+    }
 
     public class JoystickConnectedEvent {
         private StringHash _event = new StringHash("JoystickConnected");
@@ -497,6 +811,12 @@ public static class E
         public static implicit operator StringHash(JoystickConnectedEvent e) { return e._event; }
     }
     public static JoystickConnectedEvent JoystickConnected = new JoystickConnectedEvent();
+    public struct JoystickConnectedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public int JoystickID => _data.GetInt(E.JoystickConnected.JoystickID);
+    }
 
     public class JoystickDisconnectedEvent {
         private StringHash _event = new StringHash("JoystickDisconnected");
@@ -506,6 +826,12 @@ public static class E
         public static implicit operator StringHash(JoystickDisconnectedEvent e) { return e._event; }
     }
     public static JoystickDisconnectedEvent JoystickDisconnected = new JoystickDisconnectedEvent();
+    public struct JoystickDisconnectedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public int JoystickID => _data.GetInt(E.JoystickDisconnected.JoystickID);
+    }
 
     public class JoystickButtonDownEvent {
         private StringHash _event = new StringHash("JoystickButtonDown");
@@ -516,6 +842,13 @@ public static class E
         public static implicit operator StringHash(JoystickButtonDownEvent e) { return e._event; }
     }
     public static JoystickButtonDownEvent JoystickButtonDown = new JoystickButtonDownEvent();
+    public struct JoystickButtonDownArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public int JoystickID => _data.GetInt(E.JoystickButtonDown.JoystickID);
+        public int Button => _data.GetInt(E.JoystickButtonDown.Button);
+    }
 
     public class JoystickButtonUpEvent {
         private StringHash _event = new StringHash("JoystickButtonUp");
@@ -526,6 +859,13 @@ public static class E
         public static implicit operator StringHash(JoystickButtonUpEvent e) { return e._event; }
     }
     public static JoystickButtonUpEvent JoystickButtonUp = new JoystickButtonUpEvent();
+    public struct JoystickButtonUpArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public int JoystickID => _data.GetInt(E.JoystickButtonUp.JoystickID);
+        public int Button => _data.GetInt(E.JoystickButtonUp.Button);
+    }
 
     public class JoystickAxisMoveEvent {
         private StringHash _event = new StringHash("JoystickAxisMove");
@@ -537,6 +877,14 @@ public static class E
         public static implicit operator StringHash(JoystickAxisMoveEvent e) { return e._event; }
     }
     public static JoystickAxisMoveEvent JoystickAxisMove = new JoystickAxisMoveEvent();
+    public struct JoystickAxisMoveArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public int JoystickID => _data.GetInt(E.JoystickAxisMove.JoystickID);
+        public int Button => _data.GetInt(E.JoystickAxisMove.Button);
+        public float Position => _data.GetFloat(E.JoystickAxisMove.Position);
+    }
 
     public class JoystickHatMoveEvent {
         private StringHash _event = new StringHash("JoystickHatMove");
@@ -548,6 +896,14 @@ public static class E
         public static implicit operator StringHash(JoystickHatMoveEvent e) { return e._event; }
     }
     public static JoystickHatMoveEvent JoystickHatMove = new JoystickHatMoveEvent();
+    public struct JoystickHatMoveArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public int JoystickID => _data.GetInt(E.JoystickHatMove.JoystickID);
+        public int Button => _data.GetInt(E.JoystickHatMove.Button);
+        public int Position => _data.GetInt(E.JoystickHatMove.Position);
+    }
 
     public class TouchBeginEvent {
         private StringHash _event = new StringHash("TouchBegin");
@@ -560,6 +916,15 @@ public static class E
         public static implicit operator StringHash(TouchBeginEvent e) { return e._event; }
     }
     public static TouchBeginEvent TouchBegin = new TouchBeginEvent();
+    public struct TouchBeginArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public int TouchID => _data.GetInt(E.TouchBegin.TouchID);
+        public int X => _data.GetInt(E.TouchBegin.X);
+        public int Y => _data.GetInt(E.TouchBegin.Y);
+        public float Pressure => _data.GetFloat(E.TouchBegin.Pressure);
+    }
 
     public class TouchEndEvent {
         private StringHash _event = new StringHash("TouchEnd");
@@ -571,6 +936,14 @@ public static class E
         public static implicit operator StringHash(TouchEndEvent e) { return e._event; }
     }
     public static TouchEndEvent TouchEnd = new TouchEndEvent();
+    public struct TouchEndArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public int TouchID => _data.GetInt(E.TouchEnd.TouchID);
+        public int X => _data.GetInt(E.TouchEnd.X);
+        public int Y => _data.GetInt(E.TouchEnd.Y);
+    }
 
     public class TouchMoveEvent {
         private StringHash _event = new StringHash("TouchMove");
@@ -585,6 +958,17 @@ public static class E
         public static implicit operator StringHash(TouchMoveEvent e) { return e._event; }
     }
     public static TouchMoveEvent TouchMove = new TouchMoveEvent();
+    public struct TouchMoveArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public int TouchID => _data.GetInt(E.TouchMove.TouchID);
+        public int X => _data.GetInt(E.TouchMove.X);
+        public int Y => _data.GetInt(E.TouchMove.Y);
+        public int Dx => _data.GetInt(E.TouchMove.Dx);
+        public int Dy => _data.GetInt(E.TouchMove.Dy);
+        public float Pressure => _data.GetFloat(E.TouchMove.Pressure);
+    }
 
     public class GestureRecordedEvent {
         private StringHash _event = new StringHash("GestureRecorded");
@@ -594,6 +978,12 @@ public static class E
         public static implicit operator StringHash(GestureRecordedEvent e) { return e._event; }
     }
     public static GestureRecordedEvent GestureRecorded = new GestureRecordedEvent();
+    public struct GestureRecordedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public uint GestureID => _data.GetUInt(E.GestureRecorded.GestureID);
+    }
 
     public class GestureInputEvent {
         private StringHash _event = new StringHash("GestureInput");
@@ -607,6 +997,16 @@ public static class E
         public static implicit operator StringHash(GestureInputEvent e) { return e._event; }
     }
     public static GestureInputEvent GestureInput = new GestureInputEvent();
+    public struct GestureInputArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public uint GestureID => _data.GetUInt(E.GestureInput.GestureID);
+        public int CenterX => _data.GetInt(E.GestureInput.CenterX);
+        public int CenterY => _data.GetInt(E.GestureInput.CenterY);
+        public int NumFingers => _data.GetInt(E.GestureInput.NumFingers);
+        public float Error => _data.GetFloat(E.GestureInput.Error);
+    }
 
     public class MultiGestureEvent {
         private StringHash _event = new StringHash("MultiGesture");
@@ -620,6 +1020,15 @@ public static class E
         public static implicit operator StringHash(MultiGestureEvent e) { return e._event; }
     }
     public static MultiGestureEvent MultiGesture = new MultiGestureEvent();
+    public struct MultiGestureArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public int CenterX => _data.GetInt(E.MultiGesture.CenterX);
+        public int CenterY => _data.GetInt(E.MultiGesture.CenterY);
+        public int NumFingers => _data.GetInt(E.MultiGesture.NumFingers);
+        public float DDist => _data.GetFloat(E.MultiGesture.DDist);
+    }
 
     public class DropFileEvent {
         private StringHash _event = new StringHash("DropFile");
@@ -629,6 +1038,12 @@ public static class E
         public static implicit operator StringHash(DropFileEvent e) { return e._event; }
     }
     public static DropFileEvent DropFile = new DropFileEvent();
+    public struct DropFileArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public string FileName => _data.GetString(E.DropFile.FileName);
+    }
 
     public class InputFocusEvent {
         private StringHash _event = new StringHash("InputFocus");
@@ -639,6 +1054,13 @@ public static class E
         public static implicit operator StringHash(InputFocusEvent e) { return e._event; }
     }
     public static InputFocusEvent InputFocus = new InputFocusEvent();
+    public struct InputFocusArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public bool Focus => _data.GetBool(E.InputFocus.Focus);
+        public bool Minimized => _data.GetBool(E.InputFocus.Minimized);
+    }
 
     public class MouseVisibleChangedEvent {
         private StringHash _event = new StringHash("MouseVisibleChanged");
@@ -648,6 +1070,12 @@ public static class E
         public static implicit operator StringHash(MouseVisibleChangedEvent e) { return e._event; }
     }
     public static MouseVisibleChangedEvent MouseVisibleChanged = new MouseVisibleChangedEvent();
+    public struct MouseVisibleChangedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public bool Visible => _data.GetBool(E.MouseVisibleChanged.Visible);
+    }
 
     public class MouseModeChangedEvent {
         private StringHash _event = new StringHash("MouseModeChanged");
@@ -658,6 +1086,12 @@ public static class E
         public static implicit operator StringHash(MouseModeChangedEvent e) { return e._event; }
     }
     public static MouseModeChangedEvent MouseModeChanged = new MouseModeChangedEvent();
+    public struct MouseModeChangedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public bool MouseLocked => _data.GetBool(E.MouseModeChanged.MouseLocked);
+    }
 
     public class ExitRequestedEvent {
         private StringHash _event = new StringHash("ExitRequested");
@@ -666,6 +1100,11 @@ public static class E
         public static implicit operator StringHash(ExitRequestedEvent e) { return e._event; }
     }
     public static ExitRequestedEvent ExitRequested = new ExitRequestedEvent();
+    public struct ExitRequestedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class SDLRawInputEvent {
         private StringHash _event = new StringHash("SDLRawInput");
@@ -676,6 +1115,12 @@ public static class E
         public static implicit operator StringHash(SDLRawInputEvent e) { return e._event; }
     }
     public static SDLRawInputEvent SDLRawInput = new SDLRawInputEvent();
+    public struct SDLRawInputArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public bool Consumed => _data.GetBool(E.SDLRawInput.Consumed);
+    }
 
     public class InputBeginEvent {
         private StringHash _event = new StringHash("InputBegin");
@@ -684,6 +1129,11 @@ public static class E
         public static implicit operator StringHash(InputBeginEvent e) { return e._event; }
     }
     public static InputBeginEvent InputBegin = new InputBeginEvent();
+    public struct InputBeginArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class InputEndEvent {
         private StringHash _event = new StringHash("InputEnd");
@@ -692,6 +1142,11 @@ public static class E
         public static implicit operator StringHash(InputEndEvent e) { return e._event; }
     }
     public static InputEndEvent InputEnd = new InputEndEvent();
+    public struct InputEndArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class NavigationMeshRebuiltEvent {
         private StringHash _event = new StringHash("NavigationMeshRebuilt");
@@ -702,6 +1157,12 @@ public static class E
         public static implicit operator StringHash(NavigationMeshRebuiltEvent e) { return e._event; }
     }
     public static NavigationMeshRebuiltEvent NavigationMeshRebuilt = new NavigationMeshRebuiltEvent();
+    public struct NavigationMeshRebuiltArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node Node => Node.wrap(_data.GetPtr(E.NavigationMeshRebuilt.Node), false);
+    }
 
     public class NavigationAreaRebuiltEvent {
         private StringHash _event = new StringHash("NavigationAreaRebuilt");
@@ -714,6 +1175,14 @@ public static class E
         public static implicit operator StringHash(NavigationAreaRebuiltEvent e) { return e._event; }
     }
     public static NavigationAreaRebuiltEvent NavigationAreaRebuilt = new NavigationAreaRebuiltEvent();
+    public struct NavigationAreaRebuiltArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node Node => Node.wrap(_data.GetPtr(E.NavigationAreaRebuilt.Node), false);
+        public Vector3 BoundsMin => _data.GetVector3(E.NavigationAreaRebuilt.BoundsMin);
+        public Vector3 BoundsMax => _data.GetVector3(E.NavigationAreaRebuilt.BoundsMax);
+    }
 
     public class NavigationTileAddedEvent {
         private StringHash _event = new StringHash("NavigationTileAdded");
@@ -725,6 +1194,13 @@ public static class E
         public static implicit operator StringHash(NavigationTileAddedEvent e) { return e._event; }
     }
     public static NavigationTileAddedEvent NavigationTileAdded = new NavigationTileAddedEvent();
+    public struct NavigationTileAddedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node Node => Node.wrap(_data.GetPtr(E.NavigationTileAdded.Node), false);
+        public IntVector2 Tile => _data.GetIntVector2(E.NavigationTileAdded.Tile);
+    }
 
     public class NavigationTileRemovedEvent {
         private StringHash _event = new StringHash("NavigationTileRemoved");
@@ -736,6 +1212,13 @@ public static class E
         public static implicit operator StringHash(NavigationTileRemovedEvent e) { return e._event; }
     }
     public static NavigationTileRemovedEvent NavigationTileRemoved = new NavigationTileRemovedEvent();
+    public struct NavigationTileRemovedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node Node => Node.wrap(_data.GetPtr(E.NavigationTileRemoved.Node), false);
+        public IntVector2 Tile => _data.GetIntVector2(E.NavigationTileRemoved.Tile);
+    }
 
     public class NavigationAllTilesRemovedEvent {
         private StringHash _event = new StringHash("NavigationAllTilesRemoved");
@@ -746,6 +1229,12 @@ public static class E
         public static implicit operator StringHash(NavigationAllTilesRemovedEvent e) { return e._event; }
     }
     public static NavigationAllTilesRemovedEvent NavigationAllTilesRemoved = new NavigationAllTilesRemovedEvent();
+    public struct NavigationAllTilesRemovedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node Node => Node.wrap(_data.GetPtr(E.NavigationAllTilesRemoved.Node), false);
+    }
 
     public class CrowdAgentFormationEvent {
         private StringHash _event = new StringHash("CrowdAgentFormation");
@@ -759,6 +1248,14 @@ public static class E
         public static implicit operator StringHash(CrowdAgentFormationEvent e) { return e._event; }
     }
     public static CrowdAgentFormationEvent CrowdAgentFormation = new CrowdAgentFormationEvent();
+    public struct CrowdAgentFormationArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node Node => Node.wrap(_data.GetPtr(E.CrowdAgentFormation.Node), false);
+        public uint Index => _data.GetUInt(E.CrowdAgentFormation.Index);
+        public uint Size => _data.GetUInt(E.CrowdAgentFormation.Size);
+    }
 
     public class CrowdAgentNodeFormationEvent {
         private StringHash _event = new StringHash("CrowdAgentNodeFormation");
@@ -772,6 +1269,14 @@ public static class E
         public static implicit operator StringHash(CrowdAgentNodeFormationEvent e) { return e._event; }
     }
     public static CrowdAgentNodeFormationEvent CrowdAgentNodeFormation = new CrowdAgentNodeFormationEvent();
+    public struct CrowdAgentNodeFormationArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node Node => Node.wrap(_data.GetPtr(E.CrowdAgentNodeFormation.Node), false);
+        public uint Index => _data.GetUInt(E.CrowdAgentNodeFormation.Index);
+        public uint Size => _data.GetUInt(E.CrowdAgentNodeFormation.Size);
+    }
 
     public class CrowdAgentRepositionEvent {
         private StringHash _event = new StringHash("CrowdAgentReposition");
@@ -786,6 +1291,16 @@ public static class E
         public static implicit operator StringHash(CrowdAgentRepositionEvent e) { return e._event; }
     }
     public static CrowdAgentRepositionEvent CrowdAgentReposition = new CrowdAgentRepositionEvent();
+    public struct CrowdAgentRepositionArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node Node => Node.wrap(_data.GetPtr(E.CrowdAgentReposition.Node), false);
+        public Vector3 Position => _data.GetVector3(E.CrowdAgentReposition.Position);
+        public Vector3 Velocity => _data.GetVector3(E.CrowdAgentReposition.Velocity);
+        public bool Arrived => _data.GetBool(E.CrowdAgentReposition.Arrived);
+        public float TimeStep => _data.GetFloat(E.CrowdAgentReposition.TimeStep);
+    }
 
     public class CrowdAgentNodeRepositionEvent {
         private StringHash _event = new StringHash("CrowdAgentNodeReposition");
@@ -800,6 +1315,16 @@ public static class E
         public static implicit operator StringHash(CrowdAgentNodeRepositionEvent e) { return e._event; }
     }
     public static CrowdAgentNodeRepositionEvent CrowdAgentNodeReposition = new CrowdAgentNodeRepositionEvent();
+    public struct CrowdAgentNodeRepositionArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node Node => Node.wrap(_data.GetPtr(E.CrowdAgentNodeReposition.Node), false);
+        public Vector3 Position => _data.GetVector3(E.CrowdAgentNodeReposition.Position);
+        public Vector3 Velocity => _data.GetVector3(E.CrowdAgentNodeReposition.Velocity);
+        public bool Arrived => _data.GetBool(E.CrowdAgentNodeReposition.Arrived);
+        public float TimeStep => _data.GetFloat(E.CrowdAgentNodeReposition.TimeStep);
+    }
 
     public class CrowdAgentFailureEvent {
         private StringHash _event = new StringHash("CrowdAgentFailure");
@@ -814,6 +1339,16 @@ public static class E
         public static implicit operator StringHash(CrowdAgentFailureEvent e) { return e._event; }
     }
     public static CrowdAgentFailureEvent CrowdAgentFailure = new CrowdAgentFailureEvent();
+    public struct CrowdAgentFailureArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node Node => Node.wrap(_data.GetPtr(E.CrowdAgentFailure.Node), false);
+        public Vector3 Position => _data.GetVector3(E.CrowdAgentFailure.Position);
+        public Vector3 Velocity => _data.GetVector3(E.CrowdAgentFailure.Velocity);
+        public int CrowdAgentState => _data.GetInt(E.CrowdAgentFailure.CrowdAgentState);
+        public int CrowdTargetState => _data.GetInt(E.CrowdAgentFailure.CrowdTargetState);
+    }
 
     public class CrowdAgentNodeFailureEvent {
         private StringHash _event = new StringHash("CrowdAgentNodeFailure");
@@ -828,6 +1363,16 @@ public static class E
         public static implicit operator StringHash(CrowdAgentNodeFailureEvent e) { return e._event; }
     }
     public static CrowdAgentNodeFailureEvent CrowdAgentNodeFailure = new CrowdAgentNodeFailureEvent();
+    public struct CrowdAgentNodeFailureArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node Node => Node.wrap(_data.GetPtr(E.CrowdAgentNodeFailure.Node), false);
+        public Vector3 Position => _data.GetVector3(E.CrowdAgentNodeFailure.Position);
+        public Vector3 Velocity => _data.GetVector3(E.CrowdAgentNodeFailure.Velocity);
+        public int CrowdAgentState => _data.GetInt(E.CrowdAgentNodeFailure.CrowdAgentState);
+        public int CrowdTargetState => _data.GetInt(E.CrowdAgentNodeFailure.CrowdTargetState);
+    }
 
     public class CrowdAgentStateChangedEvent {
         private StringHash _event = new StringHash("CrowdAgentStateChanged");
@@ -842,6 +1387,16 @@ public static class E
         public static implicit operator StringHash(CrowdAgentStateChangedEvent e) { return e._event; }
     }
     public static CrowdAgentStateChangedEvent CrowdAgentStateChanged = new CrowdAgentStateChangedEvent();
+    public struct CrowdAgentStateChangedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node Node => Node.wrap(_data.GetPtr(E.CrowdAgentStateChanged.Node), false);
+        public Vector3 Position => _data.GetVector3(E.CrowdAgentStateChanged.Position);
+        public Vector3 Velocity => _data.GetVector3(E.CrowdAgentStateChanged.Velocity);
+        public int CrowdAgentState => _data.GetInt(E.CrowdAgentStateChanged.CrowdAgentState);
+        public int CrowdTargetState => _data.GetInt(E.CrowdAgentStateChanged.CrowdTargetState);
+    }
 
     public class CrowdAgentNodeStateChangedEvent {
         private StringHash _event = new StringHash("CrowdAgentNodeStateChanged");
@@ -856,6 +1411,16 @@ public static class E
         public static implicit operator StringHash(CrowdAgentNodeStateChangedEvent e) { return e._event; }
     }
     public static CrowdAgentNodeStateChangedEvent CrowdAgentNodeStateChanged = new CrowdAgentNodeStateChangedEvent();
+    public struct CrowdAgentNodeStateChangedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node Node => Node.wrap(_data.GetPtr(E.CrowdAgentNodeStateChanged.Node), false);
+        public Vector3 Position => _data.GetVector3(E.CrowdAgentNodeStateChanged.Position);
+        public Vector3 Velocity => _data.GetVector3(E.CrowdAgentNodeStateChanged.Velocity);
+        public int CrowdAgentState => _data.GetInt(E.CrowdAgentNodeStateChanged.CrowdAgentState);
+        public int CrowdTargetState => _data.GetInt(E.CrowdAgentNodeStateChanged.CrowdTargetState);
+    }
 
     public class NavigationObstacleAddedEvent {
         private StringHash _event = new StringHash("NavigationObstacleAdded");
@@ -869,6 +1434,15 @@ public static class E
         public static implicit operator StringHash(NavigationObstacleAddedEvent e) { return e._event; }
     }
     public static NavigationObstacleAddedEvent NavigationObstacleAdded = new NavigationObstacleAddedEvent();
+    public struct NavigationObstacleAddedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node Node => Node.wrap(_data.GetPtr(E.NavigationObstacleAdded.Node), false);
+        public Vector3 Position => _data.GetVector3(E.NavigationObstacleAdded.Position);
+        public float Radius => _data.GetFloat(E.NavigationObstacleAdded.Radius);
+        public float Height => _data.GetFloat(E.NavigationObstacleAdded.Height);
+    }
 
     public class NavigationObstacleRemovedEvent {
         private StringHash _event = new StringHash("NavigationObstacleRemoved");
@@ -882,6 +1456,15 @@ public static class E
         public static implicit operator StringHash(NavigationObstacleRemovedEvent e) { return e._event; }
     }
     public static NavigationObstacleRemovedEvent NavigationObstacleRemoved = new NavigationObstacleRemovedEvent();
+    public struct NavigationObstacleRemovedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node Node => Node.wrap(_data.GetPtr(E.NavigationObstacleRemoved.Node), false);
+        public Vector3 Position => _data.GetVector3(E.NavigationObstacleRemoved.Position);
+        public float Radius => _data.GetFloat(E.NavigationObstacleRemoved.Radius);
+        public float Height => _data.GetFloat(E.NavigationObstacleRemoved.Height);
+    }
 
     public class ServerConnectedEvent {
         private StringHash _event = new StringHash("ServerConnected");
@@ -890,6 +1473,11 @@ public static class E
         public static implicit operator StringHash(ServerConnectedEvent e) { return e._event; }
     }
     public static ServerConnectedEvent ServerConnected = new ServerConnectedEvent();
+    public struct ServerConnectedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class ServerDisconnectedEvent {
         private StringHash _event = new StringHash("ServerDisconnected");
@@ -898,6 +1486,11 @@ public static class E
         public static implicit operator StringHash(ServerDisconnectedEvent e) { return e._event; }
     }
     public static ServerDisconnectedEvent ServerDisconnected = new ServerDisconnectedEvent();
+    public struct ServerDisconnectedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class ConnectFailedEvent {
         private StringHash _event = new StringHash("ConnectFailed");
@@ -906,6 +1499,11 @@ public static class E
         public static implicit operator StringHash(ConnectFailedEvent e) { return e._event; }
     }
     public static ConnectFailedEvent ConnectFailed = new ConnectFailedEvent();
+    public struct ConnectFailedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class ConnectionInProgressEvent {
         private StringHash _event = new StringHash("ConnectionInProgress");
@@ -914,6 +1512,11 @@ public static class E
         public static implicit operator StringHash(ConnectionInProgressEvent e) { return e._event; }
     }
     public static ConnectionInProgressEvent ConnectionInProgress = new ConnectionInProgressEvent();
+    public struct ConnectionInProgressArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class ClientConnectedEvent {
         private StringHash _event = new StringHash("ClientConnected");
@@ -923,6 +1526,11 @@ public static class E
         public static implicit operator StringHash(ClientConnectedEvent e) { return e._event; }
     }
     public static ClientConnectedEvent ClientConnected = new ClientConnectedEvent();
+    public struct ClientConnectedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class ClientDisconnectedEvent {
         private StringHash _event = new StringHash("ClientDisconnected");
@@ -932,6 +1540,11 @@ public static class E
         public static implicit operator StringHash(ClientDisconnectedEvent e) { return e._event; }
     }
     public static ClientDisconnectedEvent ClientDisconnected = new ClientDisconnectedEvent();
+    public struct ClientDisconnectedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class ClientIdentityEvent {
         private StringHash _event = new StringHash("ClientIdentity");
@@ -942,6 +1555,12 @@ public static class E
         public static implicit operator StringHash(ClientIdentityEvent e) { return e._event; }
     }
     public static ClientIdentityEvent ClientIdentity = new ClientIdentityEvent();
+    public struct ClientIdentityArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public bool Allow => _data.GetBool(E.ClientIdentity.Allow);
+    }
 
     public class ClientSceneLoadedEvent {
         private StringHash _event = new StringHash("ClientSceneLoaded");
@@ -951,6 +1570,11 @@ public static class E
         public static implicit operator StringHash(ClientSceneLoadedEvent e) { return e._event; }
     }
     public static ClientSceneLoadedEvent ClientSceneLoaded = new ClientSceneLoadedEvent();
+    public struct ClientSceneLoadedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class NetworkMessageEvent {
         private StringHash _event = new StringHash("NetworkMessage");
@@ -962,6 +1586,12 @@ public static class E
         public static implicit operator StringHash(NetworkMessageEvent e) { return e._event; }
     }
     public static NetworkMessageEvent NetworkMessage = new NetworkMessageEvent();
+    public struct NetworkMessageArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public int MessageID => _data.GetInt(E.NetworkMessage.MessageID);
+    }
 
     public class NetworkUpdateEvent {
         private StringHash _event = new StringHash("NetworkUpdate");
@@ -970,6 +1600,11 @@ public static class E
         public static implicit operator StringHash(NetworkUpdateEvent e) { return e._event; }
     }
     public static NetworkUpdateEvent NetworkUpdate = new NetworkUpdateEvent();
+    public struct NetworkUpdateArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class NetworkUpdateSentEvent {
         private StringHash _event = new StringHash("NetworkUpdateSent");
@@ -978,6 +1613,11 @@ public static class E
         public static implicit operator StringHash(NetworkUpdateSentEvent e) { return e._event; }
     }
     public static NetworkUpdateSentEvent NetworkUpdateSent = new NetworkUpdateSentEvent();
+    public struct NetworkUpdateSentArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class NetworkSceneLoadFailedEvent {
         private StringHash _event = new StringHash("NetworkSceneLoadFailed");
@@ -987,6 +1627,11 @@ public static class E
         public static implicit operator StringHash(NetworkSceneLoadFailedEvent e) { return e._event; }
     }
     public static NetworkSceneLoadFailedEvent NetworkSceneLoadFailed = new NetworkSceneLoadFailedEvent();
+    public struct NetworkSceneLoadFailedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class RemoteEventDataEvent {
         private StringHash _event = new StringHash("RemoteEventData");
@@ -996,6 +1641,11 @@ public static class E
         public static implicit operator StringHash(RemoteEventDataEvent e) { return e._event; }
     }
     public static RemoteEventDataEvent RemoteEventData = new RemoteEventDataEvent();
+    public struct RemoteEventDataArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class NetworkBannedEvent {
         private StringHash _event = new StringHash("NetworkBanned");
@@ -1004,6 +1654,11 @@ public static class E
         public static implicit operator StringHash(NetworkBannedEvent e) { return e._event; }
     }
     public static NetworkBannedEvent NetworkBanned = new NetworkBannedEvent();
+    public struct NetworkBannedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class NetworkInvalidPasswordEvent {
         private StringHash _event = new StringHash("NetworkInvalidPassword");
@@ -1012,6 +1667,11 @@ public static class E
         public static implicit operator StringHash(NetworkInvalidPasswordEvent e) { return e._event; }
     }
     public static NetworkInvalidPasswordEvent NetworkInvalidPassword = new NetworkInvalidPasswordEvent();
+    public struct NetworkInvalidPasswordArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class NetworkHostDiscoveredEvent {
         private StringHash _event = new StringHash("NetworkHostDiscovered");
@@ -1023,6 +1683,13 @@ public static class E
         public static implicit operator StringHash(NetworkHostDiscoveredEvent e) { return e._event; }
     }
     public static NetworkHostDiscoveredEvent NetworkHostDiscovered = new NetworkHostDiscoveredEvent();
+    public struct NetworkHostDiscoveredArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public string Address => _data.GetString(E.NetworkHostDiscovered.Address);
+        public int Port => _data.GetInt(E.NetworkHostDiscovered.Port);
+    }
 
     public class NetworkNatPunchtroughSucceededEvent {
         private StringHash _event = new StringHash("NetworkNatPunchtroughSucceeded");
@@ -1033,6 +1700,13 @@ public static class E
         public static implicit operator StringHash(NetworkNatPunchtroughSucceededEvent e) { return e._event; }
     }
     public static NetworkNatPunchtroughSucceededEvent NetworkNatPunchtroughSucceeded = new NetworkNatPunchtroughSucceededEvent();
+    public struct NetworkNatPunchtroughSucceededArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public string Address => _data.GetString(E.NetworkNatPunchtroughSucceeded.Address);
+        public int Port => _data.GetInt(E.NetworkNatPunchtroughSucceeded.Port);
+    }
 
     public class NetworkNatPunchtroughFailedEvent {
         private StringHash _event = new StringHash("NetworkNatPunchtroughFailed");
@@ -1043,6 +1717,13 @@ public static class E
         public static implicit operator StringHash(NetworkNatPunchtroughFailedEvent e) { return e._event; }
     }
     public static NetworkNatPunchtroughFailedEvent NetworkNatPunchtroughFailed = new NetworkNatPunchtroughFailedEvent();
+    public struct NetworkNatPunchtroughFailedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public string Address => _data.GetString(E.NetworkNatPunchtroughFailed.Address);
+        public int Port => _data.GetInt(E.NetworkNatPunchtroughFailed.Port);
+    }
 
     public class PhysicsPreStepEvent {
         private StringHash _event = new StringHash("PhysicsPreStep");
@@ -1053,6 +1734,12 @@ public static class E
         public static implicit operator StringHash(PhysicsPreStepEvent e) { return e._event; }
     }
     public static PhysicsPreStepEvent PhysicsPreStep = new PhysicsPreStepEvent();
+    public struct PhysicsPreStepArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public float TimeStep => _data.GetFloat(E.PhysicsPreStep.TimeStep);
+    }
 
     public class PhysicsPostStepEvent {
         private StringHash _event = new StringHash("PhysicsPostStep");
@@ -1063,6 +1750,12 @@ public static class E
         public static implicit operator StringHash(PhysicsPostStepEvent e) { return e._event; }
     }
     public static PhysicsPostStepEvent PhysicsPostStep = new PhysicsPostStepEvent();
+    public struct PhysicsPostStepArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public float TimeStep => _data.GetFloat(E.PhysicsPostStep.TimeStep);
+    }
 
     public class PhysicsCollisionStartEvent {
         private StringHash _event = new StringHash("PhysicsCollisionStart");
@@ -1078,6 +1771,14 @@ public static class E
         public static implicit operator StringHash(PhysicsCollisionStartEvent e) { return e._event; }
     }
     public static PhysicsCollisionStartEvent PhysicsCollisionStart = new PhysicsCollisionStartEvent();
+    public struct PhysicsCollisionStartArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node NodeA => Node.wrap(_data.GetPtr(E.PhysicsCollisionStart.NodeA), false);
+        public Node NodeB => Node.wrap(_data.GetPtr(E.PhysicsCollisionStart.NodeB), false);
+        public bool Trigger => _data.GetBool(E.PhysicsCollisionStart.Trigger);
+    }
 
     public class PhysicsCollisionEvent {
         private StringHash _event = new StringHash("PhysicsCollision");
@@ -1093,6 +1794,14 @@ public static class E
         public static implicit operator StringHash(PhysicsCollisionEvent e) { return e._event; }
     }
     public static PhysicsCollisionEvent PhysicsCollision = new PhysicsCollisionEvent();
+    public struct PhysicsCollisionArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node NodeA => Node.wrap(_data.GetPtr(E.PhysicsCollision.NodeA), false);
+        public Node NodeB => Node.wrap(_data.GetPtr(E.PhysicsCollision.NodeB), false);
+        public bool Trigger => _data.GetBool(E.PhysicsCollision.Trigger);
+    }
 
     public class PhysicsCollisionEndEvent {
         private StringHash _event = new StringHash("PhysicsCollisionEnd");
@@ -1107,6 +1816,14 @@ public static class E
         public static implicit operator StringHash(PhysicsCollisionEndEvent e) { return e._event; }
     }
     public static PhysicsCollisionEndEvent PhysicsCollisionEnd = new PhysicsCollisionEndEvent();
+    public struct PhysicsCollisionEndArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node NodeA => Node.wrap(_data.GetPtr(E.PhysicsCollisionEnd.NodeA), false);
+        public Node NodeB => Node.wrap(_data.GetPtr(E.PhysicsCollisionEnd.NodeB), false);
+        public bool Trigger => _data.GetBool(E.PhysicsCollisionEnd.Trigger);
+    }
 
     public class NodeCollisionStartEvent {
         private StringHash _event = new StringHash("NodeCollisionStart");
@@ -1120,6 +1837,13 @@ public static class E
         public static implicit operator StringHash(NodeCollisionStartEvent e) { return e._event; }
     }
     public static NodeCollisionStartEvent NodeCollisionStart = new NodeCollisionStartEvent();
+    public struct NodeCollisionStartArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node OtherNode => Node.wrap(_data.GetPtr(E.NodeCollisionStart.OtherNode), false);
+        public bool Trigger => _data.GetBool(E.NodeCollisionStart.Trigger);
+    }
 
     public class NodeCollisionEvent {
         private StringHash _event = new StringHash("NodeCollision");
@@ -1133,6 +1857,13 @@ public static class E
         public static implicit operator StringHash(NodeCollisionEvent e) { return e._event; }
     }
     public static NodeCollisionEvent NodeCollision = new NodeCollisionEvent();
+    public struct NodeCollisionArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node OtherNode => Node.wrap(_data.GetPtr(E.NodeCollision.OtherNode), false);
+        public bool Trigger => _data.GetBool(E.NodeCollision.Trigger);
+    }
 
     public class NodeCollisionEndEvent {
         private StringHash _event = new StringHash("NodeCollisionEnd");
@@ -1145,6 +1876,13 @@ public static class E
         public static implicit operator StringHash(NodeCollisionEndEvent e) { return e._event; }
     }
     public static NodeCollisionEndEvent NodeCollisionEnd = new NodeCollisionEndEvent();
+    public struct NodeCollisionEndArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node OtherNode => Node.wrap(_data.GetPtr(E.NodeCollisionEnd.OtherNode), false);
+        public bool Trigger => _data.GetBool(E.NodeCollisionEnd.Trigger);
+    }
 
     public class ReloadStartedEvent {
         private StringHash _event = new StringHash("ReloadStarted");
@@ -1153,6 +1891,11 @@ public static class E
         public static implicit operator StringHash(ReloadStartedEvent e) { return e._event; }
     }
     public static ReloadStartedEvent ReloadStarted = new ReloadStartedEvent();
+    public struct ReloadStartedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class ReloadFinishedEvent {
         private StringHash _event = new StringHash("ReloadFinished");
@@ -1161,6 +1904,11 @@ public static class E
         public static implicit operator StringHash(ReloadFinishedEvent e) { return e._event; }
     }
     public static ReloadFinishedEvent ReloadFinished = new ReloadFinishedEvent();
+    public struct ReloadFinishedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class ReloadFailedEvent {
         private StringHash _event = new StringHash("ReloadFailed");
@@ -1169,6 +1917,11 @@ public static class E
         public static implicit operator StringHash(ReloadFailedEvent e) { return e._event; }
     }
     public static ReloadFailedEvent ReloadFailed = new ReloadFailedEvent();
+    public struct ReloadFailedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class FileChangedEvent {
         private StringHash _event = new StringHash("FileChanged");
@@ -1179,6 +1932,13 @@ public static class E
         public static implicit operator StringHash(FileChangedEvent e) { return e._event; }
     }
     public static FileChangedEvent FileChanged = new FileChangedEvent();
+    public struct FileChangedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public string FileName => _data.GetString(E.FileChanged.FileName);
+        public string ResourceName => _data.GetString(E.FileChanged.ResourceName);
+    }
 
     public class LoadFailedEvent {
         private StringHash _event = new StringHash("LoadFailed");
@@ -1188,6 +1948,12 @@ public static class E
         public static implicit operator StringHash(LoadFailedEvent e) { return e._event; }
     }
     public static LoadFailedEvent LoadFailed = new LoadFailedEvent();
+    public struct LoadFailedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public string ResourceName => _data.GetString(E.LoadFailed.ResourceName);
+    }
 
     public class ResourceNotFoundEvent {
         private StringHash _event = new StringHash("ResourceNotFound");
@@ -1197,6 +1963,12 @@ public static class E
         public static implicit operator StringHash(ResourceNotFoundEvent e) { return e._event; }
     }
     public static ResourceNotFoundEvent ResourceNotFound = new ResourceNotFoundEvent();
+    public struct ResourceNotFoundArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public string ResourceName => _data.GetString(E.ResourceNotFound.ResourceName);
+    }
 
     public class UnknownResourceTypeEvent {
         private StringHash _event = new StringHash("UnknownResourceType");
@@ -1206,6 +1978,12 @@ public static class E
         public static implicit operator StringHash(UnknownResourceTypeEvent e) { return e._event; }
     }
     public static UnknownResourceTypeEvent UnknownResourceType = new UnknownResourceTypeEvent();
+    public struct UnknownResourceTypeArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public StringHash ResourceType => _data.GetStringHash(E.UnknownResourceType.ResourceType);
+    }
 
     public class ResourceBackgroundLoadedEvent {
         private StringHash _event = new StringHash("ResourceBackgroundLoaded");
@@ -1217,6 +1995,14 @@ public static class E
         public static implicit operator StringHash(ResourceBackgroundLoadedEvent e) { return e._event; }
     }
     public static ResourceBackgroundLoadedEvent ResourceBackgroundLoaded = new ResourceBackgroundLoadedEvent();
+    public struct ResourceBackgroundLoadedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public string ResourceName => _data.GetString(E.ResourceBackgroundLoaded.ResourceName);
+        public bool Success => _data.GetBool(E.ResourceBackgroundLoaded.Success);
+        public Resource Resource => Resource.wrap(_data.GetPtr(E.ResourceBackgroundLoaded.Resource), false);
+    }
 
     public class ChangeLanguageEvent {
         private StringHash _event = new StringHash("ChangeLanguage");
@@ -1225,6 +2011,11 @@ public static class E
         public static implicit operator StringHash(ChangeLanguageEvent e) { return e._event; }
     }
     public static ChangeLanguageEvent ChangeLanguage = new ChangeLanguageEvent();
+    public struct ChangeLanguageArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class ResourceRenamedEvent {
         private StringHash _event = new StringHash("ResourceRenamed");
@@ -1235,6 +2026,13 @@ public static class E
         public static implicit operator StringHash(ResourceRenamedEvent e) { return e._event; }
     }
     public static ResourceRenamedEvent ResourceRenamed = new ResourceRenamedEvent();
+    public struct ResourceRenamedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public string From => _data.GetString(E.ResourceRenamed.From);
+        public string To => _data.GetString(E.ResourceRenamed.To);
+    }
 
     public class CameraViewportResizedEvent {
         private StringHash _event = new StringHash("CameraViewportResized");
@@ -1247,6 +2045,12 @@ public static class E
         public static implicit operator StringHash(CameraViewportResizedEvent e) { return e._event; }
     }
     public static CameraViewportResizedEvent CameraViewportResized = new CameraViewportResizedEvent();
+    public struct CameraViewportResizedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Camera Camera => Camera.wrap(_data.GetPtr(E.CameraViewportResized.Camera), false);
+    }
 
     public class SceneUpdateEvent {
         private StringHash _event = new StringHash("SceneUpdate");
@@ -1257,6 +2061,13 @@ public static class E
         public static implicit operator StringHash(SceneUpdateEvent e) { return e._event; }
     }
     public static SceneUpdateEvent SceneUpdate = new SceneUpdateEvent();
+    public struct SceneUpdateArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Scene Scene => Scene.wrap(_data.GetPtr(E.SceneUpdate.Scene), false);
+        public float TimeStep => _data.GetFloat(E.SceneUpdate.TimeStep);
+    }
 
     public class SceneSubsystemUpdateEvent {
         private StringHash _event = new StringHash("SceneSubsystemUpdate");
@@ -1267,6 +2078,13 @@ public static class E
         public static implicit operator StringHash(SceneSubsystemUpdateEvent e) { return e._event; }
     }
     public static SceneSubsystemUpdateEvent SceneSubsystemUpdate = new SceneSubsystemUpdateEvent();
+    public struct SceneSubsystemUpdateArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Scene Scene => Scene.wrap(_data.GetPtr(E.SceneSubsystemUpdate.Scene), false);
+        public float TimeStep => _data.GetFloat(E.SceneSubsystemUpdate.TimeStep);
+    }
 
     public class UpdateSmoothingEvent {
         private StringHash _event = new StringHash("UpdateSmoothing");
@@ -1277,6 +2095,13 @@ public static class E
         public static implicit operator StringHash(UpdateSmoothingEvent e) { return e._event; }
     }
     public static UpdateSmoothingEvent UpdateSmoothing = new UpdateSmoothingEvent();
+    public struct UpdateSmoothingArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public float Constant => _data.GetFloat(E.UpdateSmoothing.Constant);
+        public float SquaredSnapThreshold => _data.GetFloat(E.UpdateSmoothing.SquaredSnapThreshold);
+    }
 
     public class SceneDrawableUpdateFinishedEvent {
         private StringHash _event = new StringHash("SceneDrawableUpdateFinished");
@@ -1287,6 +2112,13 @@ public static class E
         public static implicit operator StringHash(SceneDrawableUpdateFinishedEvent e) { return e._event; }
     }
     public static SceneDrawableUpdateFinishedEvent SceneDrawableUpdateFinished = new SceneDrawableUpdateFinishedEvent();
+    public struct SceneDrawableUpdateFinishedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Scene Scene => Scene.wrap(_data.GetPtr(E.SceneDrawableUpdateFinished.Scene), false);
+        public float TimeStep => _data.GetFloat(E.SceneDrawableUpdateFinished.TimeStep);
+    }
 
     public class AttributeAnimationUpdateEvent {
         private StringHash _event = new StringHash("AttributeAnimationUpdate");
@@ -1297,6 +2129,13 @@ public static class E
         public static implicit operator StringHash(AttributeAnimationUpdateEvent e) { return e._event; }
     }
     public static AttributeAnimationUpdateEvent AttributeAnimationUpdate = new AttributeAnimationUpdateEvent();
+    public struct AttributeAnimationUpdateArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Scene Scene => Scene.wrap(_data.GetPtr(E.AttributeAnimationUpdate.Scene), false);
+        public float TimeStep => _data.GetFloat(E.AttributeAnimationUpdate.TimeStep);
+    }
 
     public class AttributeAnimationAddedEvent {
         private StringHash _event = new StringHash("AttributeAnimationAdded");
@@ -1307,6 +2146,12 @@ public static class E
         public static implicit operator StringHash(AttributeAnimationAddedEvent e) { return e._event; }
     }
     public static AttributeAnimationAddedEvent AttributeAnimationAdded = new AttributeAnimationAddedEvent();
+    public struct AttributeAnimationAddedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public string AttributeAnimationName => _data.GetString(E.AttributeAnimationAdded.AttributeAnimationName);
+    }
 
     public class AttributeAnimationRemovedEvent {
         private StringHash _event = new StringHash("AttributeAnimationRemoved");
@@ -1317,6 +2162,12 @@ public static class E
         public static implicit operator StringHash(AttributeAnimationRemovedEvent e) { return e._event; }
     }
     public static AttributeAnimationRemovedEvent AttributeAnimationRemoved = new AttributeAnimationRemovedEvent();
+    public struct AttributeAnimationRemovedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public string AttributeAnimationName => _data.GetString(E.AttributeAnimationRemoved.AttributeAnimationName);
+    }
 
     public class ScenePostUpdateEvent {
         private StringHash _event = new StringHash("ScenePostUpdate");
@@ -1327,6 +2178,13 @@ public static class E
         public static implicit operator StringHash(ScenePostUpdateEvent e) { return e._event; }
     }
     public static ScenePostUpdateEvent ScenePostUpdate = new ScenePostUpdateEvent();
+    public struct ScenePostUpdateArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Scene Scene => Scene.wrap(_data.GetPtr(E.ScenePostUpdate.Scene), false);
+        public float TimeStep => _data.GetFloat(E.ScenePostUpdate.TimeStep);
+    }
 
     public class AsyncLoadProgressEvent {
         private StringHash _event = new StringHash("AsyncLoadProgress");
@@ -1341,6 +2199,17 @@ public static class E
         public static implicit operator StringHash(AsyncLoadProgressEvent e) { return e._event; }
     }
     public static AsyncLoadProgressEvent AsyncLoadProgress = new AsyncLoadProgressEvent();
+    public struct AsyncLoadProgressArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Scene Scene => Scene.wrap(_data.GetPtr(E.AsyncLoadProgress.Scene), false);
+        public float Progress => _data.GetFloat(E.AsyncLoadProgress.Progress);
+        public int LoadedNodes => _data.GetInt(E.AsyncLoadProgress.LoadedNodes);
+        public int TotalNodes => _data.GetInt(E.AsyncLoadProgress.TotalNodes);
+        public int LoadedResources => _data.GetInt(E.AsyncLoadProgress.LoadedResources);
+        public int TotalResources => _data.GetInt(E.AsyncLoadProgress.TotalResources);
+    }
 
     public class AsyncLoadFinishedEvent {
         private StringHash _event = new StringHash("AsyncLoadFinished");
@@ -1350,6 +2219,12 @@ public static class E
         public static implicit operator StringHash(AsyncLoadFinishedEvent e) { return e._event; }
     }
     public static AsyncLoadFinishedEvent AsyncLoadFinished = new AsyncLoadFinishedEvent();
+    public struct AsyncLoadFinishedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Scene Scene => Scene.wrap(_data.GetPtr(E.AsyncLoadFinished.Scene), false);
+    }
 
     public class NodeAddedEvent {
         private StringHash _event = new StringHash("NodeAdded");
@@ -1361,6 +2236,14 @@ public static class E
         public static implicit operator StringHash(NodeAddedEvent e) { return e._event; }
     }
     public static NodeAddedEvent NodeAdded = new NodeAddedEvent();
+    public struct NodeAddedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Scene Scene => Scene.wrap(_data.GetPtr(E.NodeAdded.Scene), false);
+        public Node Parent => Node.wrap(_data.GetPtr(E.NodeAdded.Parent), false);
+        public Node Node => Node.wrap(_data.GetPtr(E.NodeAdded.Node), false);
+    }
 
     public class NodeRemovedEvent {
         private StringHash _event = new StringHash("NodeRemoved");
@@ -1372,6 +2255,14 @@ public static class E
         public static implicit operator StringHash(NodeRemovedEvent e) { return e._event; }
     }
     public static NodeRemovedEvent NodeRemoved = new NodeRemovedEvent();
+    public struct NodeRemovedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Scene Scene => Scene.wrap(_data.GetPtr(E.NodeRemoved.Scene), false);
+        public Node Parent => Node.wrap(_data.GetPtr(E.NodeRemoved.Parent), false);
+        public Node Node => Node.wrap(_data.GetPtr(E.NodeRemoved.Node), false);
+    }
 
     public class ComponentAddedEvent {
         private StringHash _event = new StringHash("ComponentAdded");
@@ -1383,6 +2274,14 @@ public static class E
         public static implicit operator StringHash(ComponentAddedEvent e) { return e._event; }
     }
     public static ComponentAddedEvent ComponentAdded = new ComponentAddedEvent();
+    public struct ComponentAddedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Scene Scene => Scene.wrap(_data.GetPtr(E.ComponentAdded.Scene), false);
+        public Node Node => Node.wrap(_data.GetPtr(E.ComponentAdded.Node), false);
+        public Component Component => Component.wrap(_data.GetPtr(E.ComponentAdded.Component), false);
+    }
 
     public class ComponentRemovedEvent {
         private StringHash _event = new StringHash("ComponentRemoved");
@@ -1394,6 +2293,14 @@ public static class E
         public static implicit operator StringHash(ComponentRemovedEvent e) { return e._event; }
     }
     public static ComponentRemovedEvent ComponentRemoved = new ComponentRemovedEvent();
+    public struct ComponentRemovedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Scene Scene => Scene.wrap(_data.GetPtr(E.ComponentRemoved.Scene), false);
+        public Node Node => Node.wrap(_data.GetPtr(E.ComponentRemoved.Node), false);
+        public Component Component => Component.wrap(_data.GetPtr(E.ComponentRemoved.Component), false);
+    }
 
     public class NodeNameChangedEvent {
         private StringHash _event = new StringHash("NodeNameChanged");
@@ -1404,6 +2311,13 @@ public static class E
         public static implicit operator StringHash(NodeNameChangedEvent e) { return e._event; }
     }
     public static NodeNameChangedEvent NodeNameChanged = new NodeNameChangedEvent();
+    public struct NodeNameChangedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Scene Scene => Scene.wrap(_data.GetPtr(E.NodeNameChanged.Scene), false);
+        public Node Node => Node.wrap(_data.GetPtr(E.NodeNameChanged.Node), false);
+    }
 
     public class NodeEnabledChangedEvent {
         private StringHash _event = new StringHash("NodeEnabledChanged");
@@ -1414,6 +2328,13 @@ public static class E
         public static implicit operator StringHash(NodeEnabledChangedEvent e) { return e._event; }
     }
     public static NodeEnabledChangedEvent NodeEnabledChanged = new NodeEnabledChangedEvent();
+    public struct NodeEnabledChangedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Scene Scene => Scene.wrap(_data.GetPtr(E.NodeEnabledChanged.Scene), false);
+        public Node Node => Node.wrap(_data.GetPtr(E.NodeEnabledChanged.Node), false);
+    }
 
     public class NodeTagAddedEvent {
         private StringHash _event = new StringHash("NodeTagAdded");
@@ -1425,6 +2346,13 @@ public static class E
         public static implicit operator StringHash(NodeTagAddedEvent e) { return e._event; }
     }
     public static NodeTagAddedEvent NodeTagAdded = new NodeTagAddedEvent();
+    public struct NodeTagAddedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Scene Scene => Scene.wrap(_data.GetPtr(E.NodeTagAdded.Scene), false);
+        public Node Node => Node.wrap(_data.GetPtr(E.NodeTagAdded.Node), false);
+    }
 
     public class NodeTagRemovedEvent {
         private StringHash _event = new StringHash("NodeTagRemoved");
@@ -1436,6 +2364,13 @@ public static class E
         public static implicit operator StringHash(NodeTagRemovedEvent e) { return e._event; }
     }
     public static NodeTagRemovedEvent NodeTagRemoved = new NodeTagRemovedEvent();
+    public struct NodeTagRemovedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Scene Scene => Scene.wrap(_data.GetPtr(E.NodeTagRemoved.Scene), false);
+        public Node Node => Node.wrap(_data.GetPtr(E.NodeTagRemoved.Node), false);
+    }
 
     public class ComponentEnabledChangedEvent {
         private StringHash _event = new StringHash("ComponentEnabledChanged");
@@ -1447,6 +2382,14 @@ public static class E
         public static implicit operator StringHash(ComponentEnabledChangedEvent e) { return e._event; }
     }
     public static ComponentEnabledChangedEvent ComponentEnabledChanged = new ComponentEnabledChangedEvent();
+    public struct ComponentEnabledChangedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Scene Scene => Scene.wrap(_data.GetPtr(E.ComponentEnabledChanged.Scene), false);
+        public Node Node => Node.wrap(_data.GetPtr(E.ComponentEnabledChanged.Node), false);
+        public Component Component => Component.wrap(_data.GetPtr(E.ComponentEnabledChanged.Component), false);
+    }
 
     public class TemporaryChangedEvent {
         private StringHash _event = new StringHash("TemporaryChanged");
@@ -1456,6 +2399,12 @@ public static class E
         public static implicit operator StringHash(TemporaryChangedEvent e) { return e._event; }
     }
     public static TemporaryChangedEvent TemporaryChanged = new TemporaryChangedEvent();
+    public struct TemporaryChangedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Serializable Serializable => Serializable.wrap(_data.GetPtr(E.TemporaryChanged.Serializable), false);
+    }
 
     public class NodeClonedEvent {
         private StringHash _event = new StringHash("NodeCloned");
@@ -1467,6 +2416,14 @@ public static class E
         public static implicit operator StringHash(NodeClonedEvent e) { return e._event; }
     }
     public static NodeClonedEvent NodeCloned = new NodeClonedEvent();
+    public struct NodeClonedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Scene Scene => Scene.wrap(_data.GetPtr(E.NodeCloned.Scene), false);
+        public Node Node => Node.wrap(_data.GetPtr(E.NodeCloned.Node), false);
+        public Node CloneNode => Node.wrap(_data.GetPtr(E.NodeCloned.CloneNode), false);
+    }
 
     public class ComponentClonedEvent {
         private StringHash _event = new StringHash("ComponentCloned");
@@ -1478,6 +2435,14 @@ public static class E
         public static implicit operator StringHash(ComponentClonedEvent e) { return e._event; }
     }
     public static ComponentClonedEvent ComponentCloned = new ComponentClonedEvent();
+    public struct ComponentClonedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Scene Scene => Scene.wrap(_data.GetPtr(E.ComponentCloned.Scene), false);
+        public Component Component => Component.wrap(_data.GetPtr(E.ComponentCloned.Component), false);
+        public Component CloneComponent => Component.wrap(_data.GetPtr(E.ComponentCloned.CloneComponent), false);
+    }
 
     public class InterceptNetworkUpdateEvent {
         private StringHash _event = new StringHash("InterceptNetworkUpdate");
@@ -1491,6 +2456,14 @@ public static class E
         public static implicit operator StringHash(InterceptNetworkUpdateEvent e) { return e._event; }
     }
     public static InterceptNetworkUpdateEvent InterceptNetworkUpdate = new InterceptNetworkUpdateEvent();
+    public struct InterceptNetworkUpdateArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Serializable Serializable => Serializable.wrap(_data.GetPtr(E.InterceptNetworkUpdate.Serializable), false);
+        public uint Index => _data.GetUInt(E.InterceptNetworkUpdate.Index);
+        public string Name => _data.GetString(E.InterceptNetworkUpdate.Name);
+    }
 
     public class SceneActivatedEvent {
         private StringHash _event = new StringHash("SceneActivated");
@@ -1501,6 +2474,13 @@ public static class E
         public static implicit operator StringHash(SceneActivatedEvent e) { return e._event; }
     }
     public static SceneActivatedEvent SceneActivated = new SceneActivatedEvent();
+    public struct SceneActivatedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Scene OldScene => Scene.wrap(_data.GetPtr(E.SceneActivated.OldScene), false);
+        public Scene NewScene => Scene.wrap(_data.GetPtr(E.SceneActivated.NewScene), false);
+    }
 
     public class EndRenderingSystemUIEvent {
         private StringHash _event = new StringHash("EndRenderingSystemUI");
@@ -1509,6 +2489,11 @@ public static class E
         public static implicit operator StringHash(EndRenderingSystemUIEvent e) { return e._event; }
     }
     public static EndRenderingSystemUIEvent EndRenderingSystemUI = new EndRenderingSystemUIEvent();
+    public struct EndRenderingSystemUIArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class ConsoleClosedEvent {
         private StringHash _event = new StringHash("ConsoleClosed");
@@ -1517,6 +2502,11 @@ public static class E
         public static implicit operator StringHash(ConsoleClosedEvent e) { return e._event; }
     }
     public static ConsoleClosedEvent ConsoleClosed = new ConsoleClosedEvent();
+    public struct ConsoleClosedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class AttributeInspectorMenuEvent {
         private StringHash _event = new StringHash("AttributeInspectorMenu");
@@ -1527,6 +2517,12 @@ public static class E
         public static implicit operator StringHash(AttributeInspectorMenuEvent e) { return e._event; }
     }
     public static AttributeInspectorMenuEvent AttributeInspectorMenu = new AttributeInspectorMenuEvent();
+    public struct AttributeInspectorMenuArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Serializable Serializable => Serializable.wrap(_data.GetPtr(E.AttributeInspectorMenu.Serializable), false);
+    }
 
     public class GizmoNodeModifiedEvent {
         private StringHash _event = new StringHash("GizmoNodeModified");
@@ -1538,6 +2534,12 @@ public static class E
         public static implicit operator StringHash(GizmoNodeModifiedEvent e) { return e._event; }
     }
     public static GizmoNodeModifiedEvent GizmoNodeModified = new GizmoNodeModifiedEvent();
+    public struct GizmoNodeModifiedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node Node => Node.wrap(_data.GetPtr(E.GizmoNodeModified.Node), false);
+    }
 
     public class GizmoSelectionChangedEvent {
         private StringHash _event = new StringHash("GizmoSelectionChanged");
@@ -1546,6 +2548,11 @@ public static class E
         public static implicit operator StringHash(GizmoSelectionChangedEvent e) { return e._event; }
     }
     public static GizmoSelectionChangedEvent GizmoSelectionChanged = new GizmoSelectionChangedEvent();
+    public struct GizmoSelectionChangedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+    }
 
     public class UIMouseClickEvent {
         private StringHash _event = new StringHash("UIMouseClick");
@@ -1560,6 +2567,17 @@ public static class E
         public static implicit operator StringHash(UIMouseClickEvent e) { return e._event; }
     }
     public static UIMouseClickEvent UIMouseClick = new UIMouseClickEvent();
+    public struct UIMouseClickArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.UIMouseClick.Element), false);
+        public int X => _data.GetInt(E.UIMouseClick.X);
+        public int Y => _data.GetInt(E.UIMouseClick.Y);
+        public int Button => _data.GetInt(E.UIMouseClick.Button);
+        public int Buttons => _data.GetInt(E.UIMouseClick.Buttons);
+        public int Qualifiers => _data.GetInt(E.UIMouseClick.Qualifiers);
+    }
 
     public class UIMouseClickEndEvent {
         private StringHash _event = new StringHash("UIMouseClickEnd");
@@ -1575,6 +2593,18 @@ public static class E
         public static implicit operator StringHash(UIMouseClickEndEvent e) { return e._event; }
     }
     public static UIMouseClickEndEvent UIMouseClickEnd = new UIMouseClickEndEvent();
+    public struct UIMouseClickEndArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.UIMouseClickEnd.Element), false);
+        public UIElement BeginElement => UIElement.wrap(_data.GetPtr(E.UIMouseClickEnd.BeginElement), false);
+        public int X => _data.GetInt(E.UIMouseClickEnd.X);
+        public int Y => _data.GetInt(E.UIMouseClickEnd.Y);
+        public int Button => _data.GetInt(E.UIMouseClickEnd.Button);
+        public int Buttons => _data.GetInt(E.UIMouseClickEnd.Buttons);
+        public int Qualifiers => _data.GetInt(E.UIMouseClickEnd.Qualifiers);
+    }
 
     public class UIMouseDoubleClickEvent {
         private StringHash _event = new StringHash("UIMouseDoubleClick");
@@ -1591,6 +2621,19 @@ public static class E
         public static implicit operator StringHash(UIMouseDoubleClickEvent e) { return e._event; }
     }
     public static UIMouseDoubleClickEvent UIMouseDoubleClick = new UIMouseDoubleClickEvent();
+    public struct UIMouseDoubleClickArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.UIMouseDoubleClick.Element), false);
+        public int X => _data.GetInt(E.UIMouseDoubleClick.X);
+        public int Y => _data.GetInt(E.UIMouseDoubleClick.Y);
+        public int XBegin => _data.GetInt(E.UIMouseDoubleClick.XBegin);
+        public int YBegin => _data.GetInt(E.UIMouseDoubleClick.YBegin);
+        public int Button => _data.GetInt(E.UIMouseDoubleClick.Button);
+        public int Buttons => _data.GetInt(E.UIMouseDoubleClick.Buttons);
+        public int Qualifiers => _data.GetInt(E.UIMouseDoubleClick.Qualifiers);
+    }
 
     public class ClickEvent {
         private StringHash _event = new StringHash("Click");
@@ -1605,6 +2648,17 @@ public static class E
         public static implicit operator StringHash(ClickEvent e) { return e._event; }
     }
     public static ClickEvent Click = new ClickEvent();
+    public struct ClickArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.Click.Element), false);
+        public int X => _data.GetInt(E.Click.X);
+        public int Y => _data.GetInt(E.Click.Y);
+        public int Button => _data.GetInt(E.Click.Button);
+        public int Buttons => _data.GetInt(E.Click.Buttons);
+        public int Qualifiers => _data.GetInt(E.Click.Qualifiers);
+    }
 
     public class ClickEndEvent {
         private StringHash _event = new StringHash("ClickEnd");
@@ -1620,6 +2674,18 @@ public static class E
         public static implicit operator StringHash(ClickEndEvent e) { return e._event; }
     }
     public static ClickEndEvent ClickEnd = new ClickEndEvent();
+    public struct ClickEndArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.ClickEnd.Element), false);
+        public UIElement BeginElement => UIElement.wrap(_data.GetPtr(E.ClickEnd.BeginElement), false);
+        public int X => _data.GetInt(E.ClickEnd.X);
+        public int Y => _data.GetInt(E.ClickEnd.Y);
+        public int Button => _data.GetInt(E.ClickEnd.Button);
+        public int Buttons => _data.GetInt(E.ClickEnd.Buttons);
+        public int Qualifiers => _data.GetInt(E.ClickEnd.Qualifiers);
+    }
 
     public class DoubleClickEvent {
         private StringHash _event = new StringHash("DoubleClick");
@@ -1636,6 +2702,19 @@ public static class E
         public static implicit operator StringHash(DoubleClickEvent e) { return e._event; }
     }
     public static DoubleClickEvent DoubleClick = new DoubleClickEvent();
+    public struct DoubleClickArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.DoubleClick.Element), false);
+        public int X => _data.GetInt(E.DoubleClick.X);
+        public int Y => _data.GetInt(E.DoubleClick.Y);
+        public int XBegin => _data.GetInt(E.DoubleClick.XBegin);
+        public int YBegin => _data.GetInt(E.DoubleClick.YBegin);
+        public int Button => _data.GetInt(E.DoubleClick.Button);
+        public int Buttons => _data.GetInt(E.DoubleClick.Buttons);
+        public int Qualifiers => _data.GetInt(E.DoubleClick.Qualifiers);
+    }
 
     public class DragDropTestEvent {
         private StringHash _event = new StringHash("DragDropTest");
@@ -1647,6 +2726,14 @@ public static class E
         public static implicit operator StringHash(DragDropTestEvent e) { return e._event; }
     }
     public static DragDropTestEvent DragDropTest = new DragDropTestEvent();
+    public struct DragDropTestArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Source => UIElement.wrap(_data.GetPtr(E.DragDropTest.Source), false);
+        public UIElement Target => UIElement.wrap(_data.GetPtr(E.DragDropTest.Target), false);
+        public bool Accept => _data.GetBool(E.DragDropTest.Accept);
+    }
 
     public class DragDropFinishEvent {
         private StringHash _event = new StringHash("DragDropFinish");
@@ -1658,6 +2745,14 @@ public static class E
         public static implicit operator StringHash(DragDropFinishEvent e) { return e._event; }
     }
     public static DragDropFinishEvent DragDropFinish = new DragDropFinishEvent();
+    public struct DragDropFinishArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Source => UIElement.wrap(_data.GetPtr(E.DragDropFinish.Source), false);
+        public UIElement Target => UIElement.wrap(_data.GetPtr(E.DragDropFinish.Target), false);
+        public bool Accept => _data.GetBool(E.DragDropFinish.Accept);
+    }
 
     public class FocusChangedEvent {
         private StringHash _event = new StringHash("FocusChanged");
@@ -1668,6 +2763,13 @@ public static class E
         public static implicit operator StringHash(FocusChangedEvent e) { return e._event; }
     }
     public static FocusChangedEvent FocusChanged = new FocusChangedEvent();
+    public struct FocusChangedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.FocusChanged.Element), false);
+        public UIElement ClickedElement => UIElement.wrap(_data.GetPtr(E.FocusChanged.ClickedElement), false);
+    }
 
     public class NameChangedEvent {
         private StringHash _event = new StringHash("NameChanged");
@@ -1677,6 +2779,12 @@ public static class E
         public static implicit operator StringHash(NameChangedEvent e) { return e._event; }
     }
     public static NameChangedEvent NameChanged = new NameChangedEvent();
+    public struct NameChangedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.NameChanged.Element), false);
+    }
 
     public class ResizedEvent {
         private StringHash _event = new StringHash("Resized");
@@ -1690,6 +2798,16 @@ public static class E
         public static implicit operator StringHash(ResizedEvent e) { return e._event; }
     }
     public static ResizedEvent Resized = new ResizedEvent();
+    public struct ResizedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.Resized.Element), false);
+        public int Width => _data.GetInt(E.Resized.Width);
+        public int Height => _data.GetInt(E.Resized.Height);
+        public int Dx => _data.GetInt(E.Resized.Dx);
+        public int Dy => _data.GetInt(E.Resized.Dy);
+    }
 
     public class PositionedEvent {
         private StringHash _event = new StringHash("Positioned");
@@ -1701,6 +2819,14 @@ public static class E
         public static implicit operator StringHash(PositionedEvent e) { return e._event; }
     }
     public static PositionedEvent Positioned = new PositionedEvent();
+    public struct PositionedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.Positioned.Element), false);
+        public int X => _data.GetInt(E.Positioned.X);
+        public int Y => _data.GetInt(E.Positioned.Y);
+    }
 
     public class VisibleChangedEvent {
         private StringHash _event = new StringHash("VisibleChanged");
@@ -1711,6 +2837,13 @@ public static class E
         public static implicit operator StringHash(VisibleChangedEvent e) { return e._event; }
     }
     public static VisibleChangedEvent VisibleChanged = new VisibleChangedEvent();
+    public struct VisibleChangedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.VisibleChanged.Element), false);
+        public bool Visible => _data.GetBool(E.VisibleChanged.Visible);
+    }
 
     public class FocusedEvent {
         private StringHash _event = new StringHash("Focused");
@@ -1721,6 +2854,13 @@ public static class E
         public static implicit operator StringHash(FocusedEvent e) { return e._event; }
     }
     public static FocusedEvent Focused = new FocusedEvent();
+    public struct FocusedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.Focused.Element), false);
+        public bool ByKey => _data.GetBool(E.Focused.ByKey);
+    }
 
     public class DefocusedEvent {
         private StringHash _event = new StringHash("Defocused");
@@ -1730,6 +2870,12 @@ public static class E
         public static implicit operator StringHash(DefocusedEvent e) { return e._event; }
     }
     public static DefocusedEvent Defocused = new DefocusedEvent();
+    public struct DefocusedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.Defocused.Element), false);
+    }
 
     public class LayoutUpdatedEvent {
         private StringHash _event = new StringHash("LayoutUpdated");
@@ -1739,6 +2885,12 @@ public static class E
         public static implicit operator StringHash(LayoutUpdatedEvent e) { return e._event; }
     }
     public static LayoutUpdatedEvent LayoutUpdated = new LayoutUpdatedEvent();
+    public struct LayoutUpdatedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.LayoutUpdated.Element), false);
+    }
 
     public class PressedEvent {
         private StringHash _event = new StringHash("Pressed");
@@ -1748,6 +2900,12 @@ public static class E
         public static implicit operator StringHash(PressedEvent e) { return e._event; }
     }
     public static PressedEvent Pressed = new PressedEvent();
+    public struct PressedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.Pressed.Element), false);
+    }
 
     public class ReleasedEvent {
         private StringHash _event = new StringHash("Released");
@@ -1757,6 +2915,12 @@ public static class E
         public static implicit operator StringHash(ReleasedEvent e) { return e._event; }
     }
     public static ReleasedEvent Released = new ReleasedEvent();
+    public struct ReleasedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.Released.Element), false);
+    }
 
     public class ToggledEvent {
         private StringHash _event = new StringHash("Toggled");
@@ -1767,6 +2931,13 @@ public static class E
         public static implicit operator StringHash(ToggledEvent e) { return e._event; }
     }
     public static ToggledEvent Toggled = new ToggledEvent();
+    public struct ToggledArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.Toggled.Element), false);
+        public bool State => _data.GetBool(E.Toggled.State);
+    }
 
     public class SliderChangedEvent {
         private StringHash _event = new StringHash("SliderChanged");
@@ -1777,6 +2948,13 @@ public static class E
         public static implicit operator StringHash(SliderChangedEvent e) { return e._event; }
     }
     public static SliderChangedEvent SliderChanged = new SliderChangedEvent();
+    public struct SliderChangedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.SliderChanged.Element), false);
+        public float Value => _data.GetFloat(E.SliderChanged.Value);
+    }
 
     public class SliderPagedEvent {
         private StringHash _event = new StringHash("SliderPaged");
@@ -1788,6 +2966,14 @@ public static class E
         public static implicit operator StringHash(SliderPagedEvent e) { return e._event; }
     }
     public static SliderPagedEvent SliderPaged = new SliderPagedEvent();
+    public struct SliderPagedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.SliderPaged.Element), false);
+        public int Offset => _data.GetInt(E.SliderPaged.Offset);
+        public bool Pressed => _data.GetBool(E.SliderPaged.Pressed);
+    }
 
     public class ProgressBarChangedEvent {
         private StringHash _event = new StringHash("ProgressBarChanged");
@@ -1798,6 +2984,13 @@ public static class E
         public static implicit operator StringHash(ProgressBarChangedEvent e) { return e._event; }
     }
     public static ProgressBarChangedEvent ProgressBarChanged = new ProgressBarChangedEvent();
+    public struct ProgressBarChangedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.ProgressBarChanged.Element), false);
+        public float Value => _data.GetFloat(E.ProgressBarChanged.Value);
+    }
 
     public class ScrollBarChangedEvent {
         private StringHash _event = new StringHash("ScrollBarChanged");
@@ -1808,6 +3001,13 @@ public static class E
         public static implicit operator StringHash(ScrollBarChangedEvent e) { return e._event; }
     }
     public static ScrollBarChangedEvent ScrollBarChanged = new ScrollBarChangedEvent();
+    public struct ScrollBarChangedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.ScrollBarChanged.Element), false);
+        public float Value => _data.GetFloat(E.ScrollBarChanged.Value);
+    }
 
     public class ViewChangedEvent {
         private StringHash _event = new StringHash("ViewChanged");
@@ -1819,6 +3019,14 @@ public static class E
         public static implicit operator StringHash(ViewChangedEvent e) { return e._event; }
     }
     public static ViewChangedEvent ViewChanged = new ViewChangedEvent();
+    public struct ViewChangedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.ViewChanged.Element), false);
+        public int X => _data.GetInt(E.ViewChanged.X);
+        public int Y => _data.GetInt(E.ViewChanged.Y);
+    }
 
     public class ModalChangedEvent {
         private StringHash _event = new StringHash("ModalChanged");
@@ -1829,6 +3037,13 @@ public static class E
         public static implicit operator StringHash(ModalChangedEvent e) { return e._event; }
     }
     public static ModalChangedEvent ModalChanged = new ModalChangedEvent();
+    public struct ModalChangedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.ModalChanged.Element), false);
+        public bool Modal => _data.GetBool(E.ModalChanged.Modal);
+    }
 
     public class TextEntryEvent {
         private StringHash _event = new StringHash("TextEntry");
@@ -1839,6 +3054,12 @@ public static class E
         public static implicit operator StringHash(TextEntryEvent e) { return e._event; }
     }
     public static TextEntryEvent TextEntry = new TextEntryEvent();
+    public struct TextEntryArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.TextEntry.Element), false);
+    }
 
     public class TextChangedEvent {
         private StringHash _event = new StringHash("TextChanged");
@@ -1849,6 +3070,13 @@ public static class E
         public static implicit operator StringHash(TextChangedEvent e) { return e._event; }
     }
     public static TextChangedEvent TextChanged = new TextChangedEvent();
+    public struct TextChangedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.TextChanged.Element), false);
+        public string Text => _data.GetString(E.TextChanged.Text);
+    }
 
     public class TextFinishedEvent {
         private StringHash _event = new StringHash("TextFinished");
@@ -1860,6 +3088,14 @@ public static class E
         public static implicit operator StringHash(TextFinishedEvent e) { return e._event; }
     }
     public static TextFinishedEvent TextFinished = new TextFinishedEvent();
+    public struct TextFinishedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.TextFinished.Element), false);
+        public string Text => _data.GetString(E.TextFinished.Text);
+        public float Value => _data.GetFloat(E.TextFinished.Value);
+    }
 
     public class MenuSelectedEvent {
         private StringHash _event = new StringHash("MenuSelected");
@@ -1869,6 +3105,12 @@ public static class E
         public static implicit operator StringHash(MenuSelectedEvent e) { return e._event; }
     }
     public static MenuSelectedEvent MenuSelected = new MenuSelectedEvent();
+    public struct MenuSelectedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.MenuSelected.Element), false);
+    }
 
     public class ItemSelectedEvent {
         private StringHash _event = new StringHash("ItemSelected");
@@ -1879,6 +3121,13 @@ public static class E
         public static implicit operator StringHash(ItemSelectedEvent e) { return e._event; }
     }
     public static ItemSelectedEvent ItemSelected = new ItemSelectedEvent();
+    public struct ItemSelectedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.ItemSelected.Element), false);
+        public int Selection => _data.GetInt(E.ItemSelected.Selection);
+    }
 
     public class ItemDeselectedEvent {
         private StringHash _event = new StringHash("ItemDeselected");
@@ -1889,6 +3138,13 @@ public static class E
         public static implicit operator StringHash(ItemDeselectedEvent e) { return e._event; }
     }
     public static ItemDeselectedEvent ItemDeselected = new ItemDeselectedEvent();
+    public struct ItemDeselectedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.ItemDeselected.Element), false);
+        public int Selection => _data.GetInt(E.ItemDeselected.Selection);
+    }
 
     public class SelectionChangedEvent {
         private StringHash _event = new StringHash("SelectionChanged");
@@ -1898,6 +3154,12 @@ public static class E
         public static implicit operator StringHash(SelectionChangedEvent e) { return e._event; }
     }
     public static SelectionChangedEvent SelectionChanged = new SelectionChangedEvent();
+    public struct SelectionChangedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.SelectionChanged.Element), false);
+    }
 
     public class ItemClickedEvent {
         private StringHash _event = new StringHash("ItemClicked");
@@ -1912,6 +3174,17 @@ public static class E
         public static implicit operator StringHash(ItemClickedEvent e) { return e._event; }
     }
     public static ItemClickedEvent ItemClicked = new ItemClickedEvent();
+    public struct ItemClickedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.ItemClicked.Element), false);
+        public UIElement Item => UIElement.wrap(_data.GetPtr(E.ItemClicked.Item), false);
+        public int Selection => _data.GetInt(E.ItemClicked.Selection);
+        public int Button => _data.GetInt(E.ItemClicked.Button);
+        public int Buttons => _data.GetInt(E.ItemClicked.Buttons);
+        public int Qualifiers => _data.GetInt(E.ItemClicked.Qualifiers);
+    }
 
     public class ItemDoubleClickedEvent {
         private StringHash _event = new StringHash("ItemDoubleClicked");
@@ -1926,6 +3199,17 @@ public static class E
         public static implicit operator StringHash(ItemDoubleClickedEvent e) { return e._event; }
     }
     public static ItemDoubleClickedEvent ItemDoubleClicked = new ItemDoubleClickedEvent();
+    public struct ItemDoubleClickedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.ItemDoubleClicked.Element), false);
+        public UIElement Item => UIElement.wrap(_data.GetPtr(E.ItemDoubleClicked.Item), false);
+        public int Selection => _data.GetInt(E.ItemDoubleClicked.Selection);
+        public int Button => _data.GetInt(E.ItemDoubleClicked.Button);
+        public int Buttons => _data.GetInt(E.ItemDoubleClicked.Buttons);
+        public int Qualifiers => _data.GetInt(E.ItemDoubleClicked.Qualifiers);
+    }
 
     public class UnhandledKeyEvent {
         private StringHash _event = new StringHash("UnhandledKey");
@@ -1938,6 +3222,15 @@ public static class E
         public static implicit operator StringHash(UnhandledKeyEvent e) { return e._event; }
     }
     public static UnhandledKeyEvent UnhandledKey = new UnhandledKeyEvent();
+    public struct UnhandledKeyArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.UnhandledKey.Element), false);
+        public int Key => _data.GetInt(E.UnhandledKey.Key);
+        public int Buttons => _data.GetInt(E.UnhandledKey.Buttons);
+        public int Qualifiers => _data.GetInt(E.UnhandledKey.Qualifiers);
+    }
 
     public class FileSelectedEvent {
         private StringHash _event = new StringHash("FileSelected");
@@ -1949,6 +3242,14 @@ public static class E
         public static implicit operator StringHash(FileSelectedEvent e) { return e._event; }
     }
     public static FileSelectedEvent FileSelected = new FileSelectedEvent();
+    public struct FileSelectedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public string FileName => _data.GetString(E.FileSelected.FileName);
+        public string Filter => _data.GetString(E.FileSelected.Filter);
+        public bool Ok => _data.GetBool(E.FileSelected.Ok);
+    }
 
     public class MessageACKEvent {
         private StringHash _event = new StringHash("MessageACK");
@@ -1958,6 +3259,12 @@ public static class E
         public static implicit operator StringHash(MessageACKEvent e) { return e._event; }
     }
     public static MessageACKEvent MessageACK = new MessageACKEvent();
+    public struct MessageACKArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public bool Ok => _data.GetBool(E.MessageACK.Ok);
+    }
 
     public class ElementAddedEvent {
         private StringHash _event = new StringHash("ElementAdded");
@@ -1969,6 +3276,14 @@ public static class E
         public static implicit operator StringHash(ElementAddedEvent e) { return e._event; }
     }
     public static ElementAddedEvent ElementAdded = new ElementAddedEvent();
+    public struct ElementAddedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Root => UIElement.wrap(_data.GetPtr(E.ElementAdded.Root), false);
+        public UIElement Parent => UIElement.wrap(_data.GetPtr(E.ElementAdded.Parent), false);
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.ElementAdded.Element), false);
+    }
 
     public class ElementRemovedEvent {
         private StringHash _event = new StringHash("ElementRemoved");
@@ -1980,6 +3295,14 @@ public static class E
         public static implicit operator StringHash(ElementRemovedEvent e) { return e._event; }
     }
     public static ElementRemovedEvent ElementRemoved = new ElementRemovedEvent();
+    public struct ElementRemovedArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Root => UIElement.wrap(_data.GetPtr(E.ElementRemoved.Root), false);
+        public UIElement Parent => UIElement.wrap(_data.GetPtr(E.ElementRemoved.Parent), false);
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.ElementRemoved.Element), false);
+    }
 
     public class HoverBeginEvent {
         private StringHash _event = new StringHash("HoverBegin");
@@ -1993,6 +3316,16 @@ public static class E
         public static implicit operator StringHash(HoverBeginEvent e) { return e._event; }
     }
     public static HoverBeginEvent HoverBegin = new HoverBeginEvent();
+    public struct HoverBeginArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.HoverBegin.Element), false);
+        public int X => _data.GetInt(E.HoverBegin.X);
+        public int Y => _data.GetInt(E.HoverBegin.Y);
+        public int ElementX => _data.GetInt(E.HoverBegin.ElementX);
+        public int ElementY => _data.GetInt(E.HoverBegin.ElementY);
+    }
 
     public class HoverEndEvent {
         private StringHash _event = new StringHash("HoverEnd");
@@ -2002,6 +3335,12 @@ public static class E
         public static implicit operator StringHash(HoverEndEvent e) { return e._event; }
     }
     public static HoverEndEvent HoverEnd = new HoverEndEvent();
+    public struct HoverEndArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.HoverEnd.Element), false);
+    }
 
     public class DragBeginEvent {
         private StringHash _event = new StringHash("DragBegin");
@@ -2017,6 +3356,18 @@ public static class E
         public static implicit operator StringHash(DragBeginEvent e) { return e._event; }
     }
     public static DragBeginEvent DragBegin = new DragBeginEvent();
+    public struct DragBeginArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.DragBegin.Element), false);
+        public int X => _data.GetInt(E.DragBegin.X);
+        public int Y => _data.GetInt(E.DragBegin.Y);
+        public int ElementX => _data.GetInt(E.DragBegin.ElementX);
+        public int ElementY => _data.GetInt(E.DragBegin.ElementY);
+        public int Buttons => _data.GetInt(E.DragBegin.Buttons);
+        public int NumButtons => _data.GetInt(E.DragBegin.NumButtons);
+    }
 
     public class DragMoveEvent {
         private StringHash _event = new StringHash("DragMove");
@@ -2034,6 +3385,20 @@ public static class E
         public static implicit operator StringHash(DragMoveEvent e) { return e._event; }
     }
     public static DragMoveEvent DragMove = new DragMoveEvent();
+    public struct DragMoveArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.DragMove.Element), false);
+        public int X => _data.GetInt(E.DragMove.X);
+        public int Y => _data.GetInt(E.DragMove.Y);
+        public int Dx => _data.GetInt(E.DragMove.Dx);
+        public int Dy => _data.GetInt(E.DragMove.Dy);
+        public int ElementX => _data.GetInt(E.DragMove.ElementX);
+        public int ElementY => _data.GetInt(E.DragMove.ElementY);
+        public int Buttons => _data.GetInt(E.DragMove.Buttons);
+        public int NumButtons => _data.GetInt(E.DragMove.NumButtons);
+    }
 
     public class DragEndEvent {
         private StringHash _event = new StringHash("DragEnd");
@@ -2049,6 +3414,18 @@ public static class E
         public static implicit operator StringHash(DragEndEvent e) { return e._event; }
     }
     public static DragEndEvent DragEnd = new DragEndEvent();
+    public struct DragEndArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.DragEnd.Element), false);
+        public int X => _data.GetInt(E.DragEnd.X);
+        public int Y => _data.GetInt(E.DragEnd.Y);
+        public int ElementX => _data.GetInt(E.DragEnd.ElementX);
+        public int ElementY => _data.GetInt(E.DragEnd.ElementY);
+        public int Buttons => _data.GetInt(E.DragEnd.Buttons);
+        public int NumButtons => _data.GetInt(E.DragEnd.NumButtons);
+    }
 
     public class DragCancelEvent {
         private StringHash _event = new StringHash("DragCancel");
@@ -2064,6 +3441,18 @@ public static class E
         public static implicit operator StringHash(DragCancelEvent e) { return e._event; }
     }
     public static DragCancelEvent DragCancel = new DragCancelEvent();
+    public struct DragCancelArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.DragCancel.Element), false);
+        public int X => _data.GetInt(E.DragCancel.X);
+        public int Y => _data.GetInt(E.DragCancel.Y);
+        public int ElementX => _data.GetInt(E.DragCancel.ElementX);
+        public int ElementY => _data.GetInt(E.DragCancel.ElementY);
+        public int Buttons => _data.GetInt(E.DragCancel.Buttons);
+        public int NumButtons => _data.GetInt(E.DragCancel.NumButtons);
+    }
 
     public class UIDropFileEvent {
         private StringHash _event = new StringHash("UIDropFile");
@@ -2078,6 +3467,15 @@ public static class E
         public static implicit operator StringHash(UIDropFileEvent e) { return e._event; }
     }
     public static UIDropFileEvent UIDropFile = new UIDropFileEvent();
+    public struct UIDropFileArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public string FileName => _data.GetString(E.UIDropFile.FileName);
+        public UIElement Element => UIElement.wrap(_data.GetPtr(E.UIDropFile.Element), false);
+        public int X => _data.GetInt(E.UIDropFile.X);
+        public int Y => _data.GetInt(E.UIDropFile.Y);
+    }
 
     public class PhysicsUpdateContact2DEvent {
         private StringHash _event = new StringHash("PhysicsUpdateContact2D");
@@ -2095,6 +3493,13 @@ public static class E
         public static implicit operator StringHash(PhysicsUpdateContact2DEvent e) { return e._event; }
     }
     public static PhysicsUpdateContact2DEvent PhysicsUpdateContact2D = new PhysicsUpdateContact2DEvent();
+    public struct PhysicsUpdateContact2DArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node NodeA => Node.wrap(_data.GetPtr(E.PhysicsUpdateContact2D.NodeA), false);
+        public Node NodeB => Node.wrap(_data.GetPtr(E.PhysicsUpdateContact2D.NodeB), false);
+    }
 
     public class PhysicsBeginContact2DEvent {
         private StringHash _event = new StringHash("PhysicsBeginContact2D");
@@ -2111,6 +3516,13 @@ public static class E
         public static implicit operator StringHash(PhysicsBeginContact2DEvent e) { return e._event; }
     }
     public static PhysicsBeginContact2DEvent PhysicsBeginContact2D = new PhysicsBeginContact2DEvent();
+    public struct PhysicsBeginContact2DArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node NodeA => Node.wrap(_data.GetPtr(E.PhysicsBeginContact2D.NodeA), false);
+        public Node NodeB => Node.wrap(_data.GetPtr(E.PhysicsBeginContact2D.NodeB), false);
+    }
 
     public class PhysicsEndContact2DEvent {
         private StringHash _event = new StringHash("PhysicsEndContact2D");
@@ -2127,6 +3539,13 @@ public static class E
         public static implicit operator StringHash(PhysicsEndContact2DEvent e) { return e._event; }
     }
     public static PhysicsEndContact2DEvent PhysicsEndContact2D = new PhysicsEndContact2DEvent();
+    public struct PhysicsEndContact2DArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node NodeA => Node.wrap(_data.GetPtr(E.PhysicsEndContact2D.NodeA), false);
+        public Node NodeB => Node.wrap(_data.GetPtr(E.PhysicsEndContact2D.NodeB), false);
+    }
 
     public class NodeUpdateContact2DEvent {
         private StringHash _event = new StringHash("NodeUpdateContact2D");
@@ -2142,6 +3561,12 @@ public static class E
         public static implicit operator StringHash(NodeUpdateContact2DEvent e) { return e._event; }
     }
     public static NodeUpdateContact2DEvent NodeUpdateContact2D = new NodeUpdateContact2DEvent();
+    public struct NodeUpdateContact2DArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node OtherNode => Node.wrap(_data.GetPtr(E.NodeUpdateContact2D.OtherNode), false);
+    }
 
     public class NodeBeginContact2DEvent {
         private StringHash _event = new StringHash("NodeBeginContact2D");
@@ -2156,6 +3581,12 @@ public static class E
         public static implicit operator StringHash(NodeBeginContact2DEvent e) { return e._event; }
     }
     public static NodeBeginContact2DEvent NodeBeginContact2D = new NodeBeginContact2DEvent();
+    public struct NodeBeginContact2DArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node OtherNode => Node.wrap(_data.GetPtr(E.NodeBeginContact2D.OtherNode), false);
+    }
 
     public class NodeEndContact2DEvent {
         private StringHash _event = new StringHash("NodeEndContact2D");
@@ -2170,6 +3601,12 @@ public static class E
         public static implicit operator StringHash(NodeEndContact2DEvent e) { return e._event; }
     }
     public static NodeEndContact2DEvent NodeEndContact2D = new NodeEndContact2DEvent();
+    public struct NodeEndContact2DArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node OtherNode => Node.wrap(_data.GetPtr(E.NodeEndContact2D.OtherNode), false);
+    }
 
     public class ParticlesEndEvent {
         private StringHash _event = new StringHash("ParticlesEnd");
@@ -2180,6 +3617,12 @@ public static class E
         public static implicit operator StringHash(ParticlesEndEvent e) { return e._event; }
     }
     public static ParticlesEndEvent ParticlesEnd = new ParticlesEndEvent();
+    public struct ParticlesEndArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node Node => Node.wrap(_data.GetPtr(E.ParticlesEnd.Node), false);
+    }
 
     public class ParticlesDurationEvent {
         private StringHash _event = new StringHash("ParticlesDuration");
@@ -2190,6 +3633,12 @@ public static class E
         public static implicit operator StringHash(ParticlesDurationEvent e) { return e._event; }
     }
     public static ParticlesDurationEvent ParticlesDuration = new ParticlesDurationEvent();
+    public struct ParticlesDurationArgs : IEventArgs {
+        private EventData _data;
+        public void Bind(in EventData data) { _data = data; }
+        public EventData Data => _data;
+        public Node Node => Node.wrap(_data.GetPtr(E.ParticlesDuration.Node), false);
+    }
 
 }
 %}
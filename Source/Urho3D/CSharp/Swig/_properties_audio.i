@@ -15,9 +15,6 @@
   public $typemap(cstype, const eastl::vector<Urho3D::SoundSource *> &) SoundSources {
     get { return GetSoundSources(); }
   }
-  public $typemap(cstype, Urho3D::Mutex &) Mutex {
-    get { return GetMutex(); }
-  }
 %}
 %csmethodmodifiers Urho3D::Audio::GetSampleSize "private";
 %csmethodmodifiers Urho3D::Audio::GetMixRate "private";
@@ -25,7 +22,6 @@
 %csmethodmodifiers Urho3D::Audio::GetListener "private";
 %csmethodmodifiers Urho3D::Audio::SetListener "private";
 %csmethodmodifiers Urho3D::Audio::GetSoundSources "private";
-%csmethodmodifiers Urho3D::Audio::GetMutex "private";
 %typemap(cscode) Urho3D::BufferedSoundStream %{
   public $typemap(cstype, unsigned int) BufferNumBytes {
     get { return GetBufferNumBytes(); }
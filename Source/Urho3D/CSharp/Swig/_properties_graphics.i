@@ -1774,6 +1774,28 @@
     get { return GetReuseShadowMaps(); }
     set { SetReuseShadowMaps(value); }
   }
+  public $typemap(cstype, bool) DynamicResolution {
+    get { return GetDynamicResolution(); }
+    set { SetDynamicResolution(value); }
+  }
+  public $typemap(cstype, float) DynamicResolutionTargetTime {
+    get { return GetDynamicResolutionTargetTime(); }
+    set { SetDynamicResolutionTargetTime(value); }
+  }
+  public $typemap(cstype, float) MinResolutionScale {
+    get { return GetMinResolutionScale(); }
+  }
+  public $typemap(cstype, float) MaxResolutionScale {
+    get { return GetMaxResolutionScale(); }
+  }
+  public $typemap(cstype, float) ResolutionScale {
+    get { return GetResolutionScale(); }
+    set { SetResolutionScale(value); }
+  }
+  public $typemap(cstype, float) UpscaleSharpness {
+    get { return GetUpscaleSharpness(); }
+    set { SetUpscaleSharpness(value); }
+  }
   public $typemap(cstype, int) MaxShadowMaps {
     get { return GetMaxShadowMaps(); }
     set { SetMaxShadowMaps(value); }
@@ -1893,6 +1915,16 @@
 %csmethodmodifiers Urho3D::Renderer::SetVSMMultiSample "private";
 %csmethodmodifiers Urho3D::Renderer::GetReuseShadowMaps "private";
 %csmethodmodifiers Urho3D::Renderer::SetReuseShadowMaps "private";
+%csmethodmodifiers Urho3D::Renderer::GetDynamicResolution "private";
+%csmethodmodifiers Urho3D::Renderer::SetDynamicResolution "private";
+%csmethodmodifiers Urho3D::Renderer::GetDynamicResolutionTargetTime "private";
+%csmethodmodifiers Urho3D::Renderer::SetDynamicResolutionTargetTime "private";
+%csmethodmodifiers Urho3D::Renderer::GetMinResolutionScale "private";
+%csmethodmodifiers Urho3D::Renderer::GetMaxResolutionScale "private";
+%csmethodmodifiers Urho3D::Renderer::GetResolutionScale "private";
+%csmethodmodifiers Urho3D::Renderer::SetResolutionScale "private";
+%csmethodmodifiers Urho3D::Renderer::GetUpscaleSharpness "private";
+%csmethodmodifiers Urho3D::Renderer::SetUpscaleSharpness "private";
 %csmethodmodifiers Urho3D::Renderer::GetMaxShadowMaps "private";
 %csmethodmodifiers Urho3D::Renderer::SetMaxShadowMaps "private";
 %csmethodmodifiers Urho3D::Renderer::GetDynamicInstancing "private";
@@ -198,6 +198,13 @@
     get { return GetFinishBackgroundResourcesMs(); }
     set { SetFinishBackgroundResourcesMs(value); }
   }
+  public $typemap(cstype, int) AutoReloadResourcesMs {
+    get { return GetAutoReloadResourcesMs(); }
+    set { SetAutoReloadResourcesMs(value); }
+  }
+  public $typemap(cstype, unsigned int) NumPendingFileChanges {
+    get { return GetNumPendingFileChanges(); }
+  }
   public $typemap(cstype, unsigned int) NumResourceDirs {
     get { return GetNumResourceDirs(); }
   }
@@ -215,6 +222,9 @@
 %csmethodmodifiers Urho3D::ResourceCache::SetSearchPackagesFirst "private";
 %csmethodmodifiers Urho3D::ResourceCache::GetFinishBackgroundResourcesMs "private";
 %csmethodmodifiers Urho3D::ResourceCache::SetFinishBackgroundResourcesMs "private";
+%csmethodmodifiers Urho3D::ResourceCache::GetAutoReloadResourcesMs "private";
+%csmethodmodifiers Urho3D::ResourceCache::SetAutoReloadResourcesMs "private";
+%csmethodmodifiers Urho3D::ResourceCache::GetNumPendingFileChanges "private";
 %csmethodmodifiers Urho3D::ResourceCache::GetNumResourceDirs "private";
 %typemap(cscode) Urho3D::XMLAttributeReference %{
   public $typemap(cstype, Urho3D::XMLElement) Element {
@@ -67,6 +67,7 @@ URHO3D_REFCOUNTED(Urho3D::Zone);
 URHO3D_REFCOUNTED(Urho3D::IKConstraint);
 URHO3D_REFCOUNTED(Urho3D::IKEffector);
 URHO3D_REFCOUNTED(Urho3D::IKSolver);
+URHO3D_REFCOUNTED(Urho3D::IKWorld);
 URHO3D_REFCOUNTED(Urho3D::File);
 URHO3D_REFCOUNTED(Urho3D::FileSystem);
 URHO3D_REFCOUNTED(Urho3D::FileWatcher);
@@ -0,0 +1,110 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include "../Container/LinearAllocator.h"
+
+#include <EASTL/allocator.h>
+
+namespace Urho3D
+{
+
+/// Double-buffered frame arena. Memory allocated during a frame stays valid until the end of the next frame, so data built
+/// in one frame may still be read while the next one is prepared. Not thread-safe.
+class URHO3D_API FrameAllocator : private NonCopyable
+{
+public:
+    /// Construct with block size of each buffer.
+    explicit FrameAllocator(unsigned blockSize = 64 * 1024);
+
+    /// Allocate uninitialized memory for the current frame.
+    void* Allocate(unsigned size, unsigned alignment = alignof(std::max_align_t)) { return buffers_[currentBuffer_].Allocate(size, alignment); }
+    /// Begin new frame. Memory allocated during the frame before the previous one is reused.
+    void BeginFrame();
+
+    /// Return number of bytes allocated during the current frame.
+    unsigned GetAllocatedSize() const { return buffers_[currentBuffer_].GetAllocatedSize(); }
+    /// Return total capacity of both buffers.
+    unsigned GetCapacity() const { return buffers_[0].GetCapacity() + buffers_[1].GetCapacity(); }
+
+private:
+    /// Buffers of the current and the previous frame.
+    LinearAllocator buffers_[2];
+    /// Index of the buffer of the current frame.
+    unsigned currentBuffer_{};
+};
+
+/// EASTL allocator which takes memory from a frame arena. Deallocation is a no-op, memory is reclaimed when the arena is
+/// reused. Containers must therefore be emptied with clear(true) before the arena is reset. Without an arena the default
+/// heap allocator is used.
+class FrameAllocatorAdapter
+{
+public:
+    /// Construct without an arena.
+    FrameAllocatorAdapter() = default;
+    /// Construct without an arena. Used by EASTL containers.
+    explicit FrameAllocatorAdapter(const char* /*name*/) { }
+    /// Construct with an arena.
+    explicit FrameAllocatorAdapter(FrameAllocator* allocator) : allocator_(allocator) { }
+    /// Construct from another allocator.
+    FrameAllocatorAdapter(const FrameAllocatorAdapter& other, const char* /*name*/) : allocator_(other.allocator_) { }
+
+    /// Allocate memory.
+    void* allocate(size_t n, int flags = 0)
+    {
+        return allocator_ ? allocator_->Allocate(static_cast<unsigned>(n)) : EASTLAllocatorType().allocate(n, flags);
+    }
+    /// Allocate aligned memory.
+    void* allocate(size_t n, size_t alignment, size_t offset, int flags = 0)
+    {
+        return allocator_ ? allocator_->Allocate(static_cast<unsigned>(n), static_cast<unsigned>(alignment))
+            : EASTLAllocatorType().allocate(n, alignment, offset, flags);
+    }
+    /// Free memory. Does nothing for arena memory.
+    void deallocate(void* p, size_t n)
+    {
+        if (!allocator_)
+            EASTLAllocatorType().deallocate(p, n);
+    }
+
+    /// Return name.
+    const char* get_name() const { return "FrameAllocator"; }
+    /// Set name. Ignored.
+    void set_name(const char* /*name*/) { }
+
+    /// Return arena or null if using the heap.
+    FrameAllocator* GetFrameAllocator() const { return allocator_; }
+
+private:
+    /// Arena.
+    FrameAllocator* allocator_{};
+};
+
+/// Compare frame allocators. Memory is interchangeable only between allocators of the same arena.
+inline bool operator ==(const FrameAllocatorAdapter& lhs, const FrameAllocatorAdapter& rhs) { return lhs.GetFrameAllocator() == rhs.GetFrameAllocator(); }
+/// Compare frame allocators. Memory is interchangeable only between allocators of the same arena.
+inline bool operator !=(const FrameAllocatorAdapter& lhs, const FrameAllocatorAdapter& rhs) { return !(lhs == rhs); }
+
+}
@@ -0,0 +1,85 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Container/LinearAllocator.h"
+
+#include <cassert>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+LinearAllocator::LinearAllocator(unsigned blockSize)
+    : blockSize_(blockSize)
+{
+}
+
+void* LinearAllocator::Allocate(unsigned size, unsigned alignment)
+{
+    assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+    while (currentBlock_ < blocks_.size())
+    {
+        Block& block = blocks_[currentBlock_];
+        const uintptr_t base = reinterpret_cast<uintptr_t>(block.data_.get());
+        const uintptr_t alignedAddress = (base + currentOffset_ + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+        const unsigned alignedOffset = static_cast<unsigned>(alignedAddress - base);
+        if (alignedOffset + size <= block.size_)
+        {
+            currentOffset_ = alignedOffset + size;
+            allocatedSize_ += size;
+            return block.data_.get() + alignedOffset;
+        }
+
+        // Try next block
+        ++currentBlock_;
+        currentOffset_ = 0;
+    }
+
+    // Allocate new block big enough for this allocation
+    Block& block = blocks_.emplace_back();
+    block.size_ = ea::max(blockSize_, size + alignment);
+    block.data_ = ea::make_unique<unsigned char[]>(block.size_);
+    currentBlock_ = blocks_.size() - 1;
+    currentOffset_ = 0;
+    return Allocate(size, alignment);
+}
+
+void LinearAllocator::Reset()
+{
+    currentBlock_ = 0;
+    currentOffset_ = 0;
+    allocatedSize_ = 0;
+}
+
+unsigned LinearAllocator::GetCapacity() const
+{
+    unsigned capacity = 0;
+    for (const Block& block : blocks_)
+        capacity += block.size_;
+    return capacity;
+}
+
+}
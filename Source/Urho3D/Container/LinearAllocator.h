@@ -0,0 +1,85 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include "../Core/NonCopyable.h"
+
+#include <Urho3D/Urho3D.h>
+
+#include <EASTL/unique_ptr.h>
+#include <EASTL/utility.h>
+#include <EASTL/vector.h>
+
+#include <cstddef>
+
+namespace Urho3D
+{
+
+/// Linear (bump pointer) allocator. Memory is allocated from large blocks and released all at once by Reset().
+/// Blocks are kept between resets, so steady-state allocation is a pointer increment. Not thread-safe.
+class URHO3D_API LinearAllocator : private NonCopyable
+{
+public:
+    /// Construct with block size.
+    explicit LinearAllocator(unsigned blockSize = 64 * 1024);
+
+    /// Allocate uninitialized memory with given alignment.
+    void* Allocate(unsigned size, unsigned alignment = alignof(std::max_align_t));
+    /// Allocate and construct an object. Destructor is not called on reset.
+    template <class T, class... Args> T* New(Args&&... args)
+    {
+        return new(Allocate(sizeof(T), alignof(T))) T(ea::forward<Args>(args)...);
+    }
+    /// Release all allocations. Previously allocated blocks are reused.
+    void Reset();
+
+    /// Return total number of bytes allocated since last reset.
+    unsigned GetAllocatedSize() const { return allocatedSize_; }
+    /// Return total capacity of all blocks.
+    unsigned GetCapacity() const;
+
+private:
+    /// Memory block.
+    struct Block
+    {
+        /// Block data.
+        ea::unique_ptr<unsigned char[]> data_;
+        /// Block size.
+        unsigned size_{};
+    };
+
+    /// Default block size.
+    unsigned blockSize_{};
+    /// Memory blocks.
+    ea::vector<Block> blocks_;
+    /// Index of current block.
+    unsigned currentBlock_{};
+    /// Offset in current block.
+    unsigned currentOffset_{};
+    /// Number of bytes allocated since last reset.
+    unsigned allocatedSize_{};
+};
+
+}
@@ -0,0 +1,92 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include "../Math/MathDefs.h"
+
+#include <EASTL/vector.h>
+
+#include <atomic>
+
+namespace Urho3D
+{
+
+/// Bounded lock-free queue for exactly one producer thread and one consumer thread. Neither side ever waits: Push()
+/// fails when the queue is full and Pop() fails when it is empty.
+template <class T> class SPSCQueue
+{
+public:
+    /// Construct with capacity rounded up to power of two.
+    explicit SPSCQueue(unsigned capacity = 256) { SetCapacity(capacity); }
+
+    /// Set capacity rounded up to power of two and discard queued items. Not thread safe.
+    void SetCapacity(unsigned capacity)
+    {
+        slots_.clear();
+        slots_.resize(NextPowerOfTwo(Max(capacity, 2u)));
+        mask_ = slots_.size() - 1;
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+    }
+
+    /// Add item to the queue. Return false if the queue is full. Called by the producer thread.
+    bool Push(const T& item)
+    {
+        const unsigned tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) > mask_)
+            return false;
+
+        slots_[tail & mask_] = item;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Remove oldest item from the queue. Return false if the queue is empty. Called by the consumer thread.
+    bool Pop(T& item)
+    {
+        const unsigned head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire))
+            return false;
+
+        item = ea::move(slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Return capacity.
+    unsigned GetCapacity() const { return slots_.size(); }
+
+private:
+    /// Item storage.
+    ea::vector<T> slots_;
+    /// Index mask.
+    unsigned mask_{};
+    /// Position of the next item to pop. Written by the consumer.
+    alignas(64) std::atomic<unsigned> head_{};
+    /// Position of the next item to push. Written by the producer.
+    alignas(64) std::atomic<unsigned> tail_{};
+};
+
+}
@@ -0,0 +1,224 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Container/SlabAllocator.h"
+#include "../Core/Mutex.h"
+
+#include <EASTL/vector.h>
+
+#include <atomic>
+#include <new>
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Size of the header in front of each object. Keeps the default new alignment.
+const unsigned SLAB_HEADER_SIZE = alignof(std::max_align_t) > 16 ? alignof(std::max_align_t) : 16;
+/// Granularity of size classes.
+const unsigned SLAB_SIZE_GRANULARITY = 16;
+/// Number of size classes.
+const unsigned NUM_SLAB_SIZE_CLASSES = (MAX_SLAB_OBJECT_SIZE + SLAB_HEADER_SIZE) / SLAB_SIZE_GRANULARITY;
+/// Size class index stored in the header of objects allocated from the heap.
+const unsigned HEAP_SIZE_CLASS = NUM_SLAB_SIZE_CLASSES;
+/// Target size of a slab in bytes.
+const unsigned TARGET_SLAB_SIZE = 64 * 1024;
+
+/// Header in front of each object.
+struct SlabHeader
+{
+    /// Size class index, or HEAP_SIZE_CLASS.
+    unsigned sizeClass_;
+    /// Arena index.
+    unsigned arena_;
+};
+
+/// Free block in a pool.
+struct FreeBlock
+{
+    /// Next free block.
+    FreeBlock* next_;
+};
+
+/// Pool of equally sized blocks.
+class SlabPool
+{
+public:
+    /// Construct.
+    explicit SlabPool(unsigned blockSize)
+        : blockSize_(blockSize)
+        , blocksPerSlab_(blockSize < TARGET_SLAB_SIZE / 16 ? TARGET_SLAB_SIZE / blockSize : 16)
+    {
+    }
+
+    /// Allocate block.
+    void* Allocate()
+    {
+        MutexLock<Mutex> lock(lock_);
+        if (!freeList_)
+            AllocateSlab();
+
+        FreeBlock* block = freeList_;
+        freeList_ = block->next_;
+        ++numUsedBlocks_;
+        return block;
+    }
+
+    /// Free block.
+    void Free(void* ptr)
+    {
+        MutexLock<Mutex> lock(lock_);
+        auto* block = static_cast<FreeBlock*>(ptr);
+        block->next_ = freeList_;
+        freeList_ = block;
+        --numUsedBlocks_;
+    }
+
+    /// Return number of used blocks.
+    unsigned GetNumUsedBlocks() const { return numUsedBlocks_; }
+    /// Return number of blocks.
+    unsigned GetNumBlocks() const { return numBlocks_; }
+
+private:
+    /// Allocate new slab and add its blocks to the free list.
+    void AllocateSlab()
+    {
+        auto* slab = static_cast<unsigned char*>(::operator new(static_cast<size_t>(blockSize_) * blocksPerSlab_));
+        slabs_.push_back(slab);
+        for (unsigned i = blocksPerSlab_; i-- > 0;)
+        {
+            auto* block = reinterpret_cast<FreeBlock*>(slab + static_cast<size_t>(i) * blockSize_);
+            block->next_ = freeList_;
+            freeList_ = block;
+        }
+        numBlocks_ += blocksPerSlab_;
+    }
+
+    /// Block size.
+    const unsigned blockSize_;
+    /// Number of blocks per slab.
+    const unsigned blocksPerSlab_;
+    /// Slabs.
+    ea::vector<unsigned char*> slabs_;
+    /// First free block.
+    FreeBlock* freeList_{};
+    /// Number of used blocks.
+    std::atomic<unsigned> numUsedBlocks_{};
+    /// Number of blocks.
+    std::atomic<unsigned> numBlocks_{};
+    /// Lock.
+    Mutex lock_;
+};
+
+/// Pools by arena and size class. Created on first use and deliberately never destroyed, because objects may outlive
+/// static destruction order.
+std::atomic<SlabPool*> slabPools[MAX_SLAB_ARENAS][NUM_SLAB_SIZE_CLASSES];
+/// Number of created arenas, including the shared one.
+std::atomic<unsigned> numSlabArenas{ 1 };
+
+SlabPool* GetSlabPool(unsigned arena, unsigned sizeClass)
+{
+    std::atomic<SlabPool*>& poolSlot = slabPools[arena][sizeClass];
+    SlabPool* pool = poolSlot.load(std::memory_order_acquire);
+    if (pool)
+        return pool;
+
+    auto* newPool = new SlabPool((sizeClass + 1) * SLAB_SIZE_GRANULARITY);
+    if (poolSlot.compare_exchange_strong(pool, newPool, std::memory_order_acq_rel))
+        return newPool;
+
+    // Another thread was faster
+    delete newPool;
+    return pool;
+}
+
+}
+
+unsigned SlabAllocator::CreateArena()
+{
+    unsigned arena = numSlabArenas.load(std::memory_order_relaxed);
+    while (arena < MAX_SLAB_ARENAS)
+    {
+        if (numSlabArenas.compare_exchange_weak(arena, arena + 1, std::memory_order_relaxed))
+            return arena;
+    }
+    return 0;
+}
+
+void* SlabAllocator::Allocate(size_t size, unsigned arena)
+{
+    const size_t totalSize = size + SLAB_HEADER_SIZE;
+    const unsigned sizeClass = totalSize <= NUM_SLAB_SIZE_CLASSES * SLAB_SIZE_GRANULARITY
+        ? static_cast<unsigned>((totalSize + SLAB_SIZE_GRANULARITY - 1) / SLAB_SIZE_GRANULARITY) - 1 : HEAP_SIZE_CLASS;
+
+    void* memory = sizeClass != HEAP_SIZE_CLASS ? GetSlabPool(arena, sizeClass)->Allocate() : ::operator new(totalSize);
+    static_cast<SlabHeader*>(memory)->sizeClass_ = sizeClass;
+    static_cast<SlabHeader*>(memory)->arena_ = arena;
+    return static_cast<unsigned char*>(memory) + SLAB_HEADER_SIZE;
+}
+
+void SlabAllocator::Free(void* ptr)
+{
+    if (!ptr)
+        return;
+
+    void* memory = static_cast<unsigned char*>(ptr) - SLAB_HEADER_SIZE;
+    const unsigned sizeClass = static_cast<SlabHeader*>(memory)->sizeClass_;
+    if (sizeClass != HEAP_SIZE_CLASS)
+        slabPools[static_cast<SlabHeader*>(memory)->arena_][sizeClass].load(std::memory_order_acquire)->Free(memory);
+    else
+        ::operator delete(memory);
+}
+
+unsigned SlabAllocator::GetNumUsedBlocks()
+{
+    unsigned numUsedBlocks = 0;
+    for (const auto& arenaPools : slabPools)
+    {
+        for (const auto& pool : arenaPools)
+        {
+            if (const SlabPool* poolPtr = pool.load(std::memory_order_acquire))
+                numUsedBlocks += poolPtr->GetNumUsedBlocks();
+        }
+    }
+    return numUsedBlocks;
+}
+
+unsigned SlabAllocator::GetNumBlocks()
+{
+    unsigned numBlocks = 0;
+    for (const auto& arenaPools : slabPools)
+    {
+        for (const auto& pool : arenaPools)
+        {
+            if (const SlabPool* poolPtr = pool.load(std::memory_order_acquire))
+                numBlocks += poolPtr->GetNumBlocks();
+        }
+    }
+    return numBlocks;
+}
+
+}
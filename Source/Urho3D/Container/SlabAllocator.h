@@ -0,0 +1,96 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include <Urho3D/Urho3D.h>
+
+#include <cstddef>
+
+namespace Urho3D
+{
+
+/// Maximum object size served from slabs. Larger objects are allocated from the heap.
+static const unsigned MAX_SLAB_OBJECT_SIZE = 2048;
+/// Maximum number of slab arenas, including the shared one.
+static const unsigned MAX_SLAB_ARENAS = 32;
+
+/// Thread-safe allocator of small objects that are created and destroyed at a high rate, such as scene nodes and
+/// components. Objects are grouped into size classes, each backed by slabs of equally sized blocks and a free list.
+/// Freed blocks are reused by the next allocation of the same size class and slabs are never returned to the system.
+/// Types that are iterated in tight loops may use a separate arena, so their objects are not interleaved with others.
+class URHO3D_API SlabAllocator
+{
+public:
+    /// Allocate memory for an object from the shared arena.
+    static void* Allocate(size_t size) { return Allocate(size, 0); }
+    /// Allocate memory for an object from the arena.
+    static void* Allocate(size_t size, unsigned arena);
+    /// Create separate arena. Return shared arena 0 if the limit of arenas is reached.
+    static unsigned CreateArena();
+    /// Free memory allocated by Allocate.
+    static void Free(void* ptr);
+
+    /// Return number of blocks currently in use in all size classes.
+    static unsigned GetNumUsedBlocks();
+    /// Return number of blocks allocated in all slabs.
+    static unsigned GetNumBlocks();
+};
+
+/// Declare class-specific allocation functions which serve the class and its subclasses from the slab allocator.
+#if defined(_MSC_VER) && defined(_DEBUG)
+#define URHO3D_SLAB_ALLOCATED \
+    static void* operator new(size_t size) { return Urho3D::SlabAllocator::Allocate(size); } \
+    static void* operator new(size_t size, int, const char*, int) { return Urho3D::SlabAllocator::Allocate(size); } \
+    static void operator delete(void* ptr) { Urho3D::SlabAllocator::Free(ptr); } \
+    static void operator delete(void* ptr, int, const char*, int) { Urho3D::SlabAllocator::Free(ptr); }
+#else
+#define URHO3D_SLAB_ALLOCATED \
+    static void* operator new(size_t size) { return Urho3D::SlabAllocator::Allocate(size); } \
+    static void operator delete(void* ptr) { Urho3D::SlabAllocator::Free(ptr); }
+#endif
+
+/// Declare class-specific allocation functions which serve the class and its subclasses from a separate slab arena.
+/// Use URHO3D_SLAB_ALLOCATED_SEPARATELY_IMPL in the source file of the class to define them.
+#if defined(_MSC_VER) && defined(_DEBUG)
+#define URHO3D_SLAB_ALLOCATED_SEPARATELY \
+    static void* operator new(size_t size); \
+    static void* operator new(size_t size, int, const char*, int) { return operator new(size); } \
+    static void operator delete(void* ptr) { Urho3D::SlabAllocator::Free(ptr); } \
+    static void operator delete(void* ptr, int, const char*, int) { Urho3D::SlabAllocator::Free(ptr); }
+#else
+#define URHO3D_SLAB_ALLOCATED_SEPARATELY \
+    static void* operator new(size_t size); \
+    static void operator delete(void* ptr) { Urho3D::SlabAllocator::Free(ptr); }
+#endif
+
+/// Define allocation functions declared by URHO3D_SLAB_ALLOCATED_SEPARATELY.
+#define URHO3D_SLAB_ALLOCATED_SEPARATELY_IMPL(className) \
+    void* className::operator new(size_t size) \
+    { \
+        static const unsigned arena = Urho3D::SlabAllocator::CreateArena(); \
+        return Urho3D::SlabAllocator::Allocate(size, arena); \
+    }
+
+}
@@ -56,6 +56,7 @@ enum AttributeMode
 };
 URHO3D_FLAGSET(AttributeMode, AttributeModeFlags);
 
+class Archive;
 class Serializable;
 
 /// Abstract base class for invoking attribute accessors.
@@ -68,6 +69,17 @@ public:
     virtual void Get(const Serializable* ptr, Variant& dest) const = 0;
     /// Set the attribute.
     virtual void Set(Serializable* ptr, const Variant& src) = 0;
+    /// Return whether the attribute can be serialized and compared directly, without conversion to Variant.
+    virtual bool IsTyped() const { return false; }
+    /// Serialize the attribute directly from/to archive. Supported only if IsTyped(). Return true if successful.
+    virtual bool Serialize(Serializable* /*ptr*/, Archive& /*archive*/, const char* /*name*/) { return false; }
+    /// Return whether the attribute is equal to the value. Typed accessors compare without conversion to Variant.
+    virtual bool Equals(const Serializable* ptr, const Variant& value) const
+    {
+        Variant attributeValue;
+        Get(ptr, attributeValue);
+        return attributeValue == value;
+    }
 };
 
 /// Description of an automatically serializable variable.
@@ -22,6 +22,8 @@
 
 #include "../Precompiled.h"
 
+#include <EASTL/sort.h>
+
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
 #include "../IO/Log.h"
@@ -174,6 +176,15 @@ Context::~Context()
     for (auto i = eventDataMaps_.begin(); i != eventDataMaps_.end(); ++i)
         delete *i;
     eventDataMaps_.clear();
+
+    // Delete undelivered posted events
+    PostedEventNode* node = postedEvents_.exchange(nullptr);
+    while (node)
+    {
+        PostedEventNode* next = node->next_;
+        delete node;
+        node = next;
+    }
 }
 
 SharedPtr<Object> Context::CreateObject(StringHash objectType)
@@ -185,6 +196,13 @@ SharedPtr<Object> Context::CreateObject(StringHash objectType)
         return SharedPtr<Object>();
 }
 
+SharedPtr<Object> Context::CreateObject(const TypeInfo* typeInfo)
+{
+    if (const TypeRegistration* registration = GetTypeRegistration(typeInfo))
+        return registration->factory_ ? registration->factory_->CreateObject() : SharedPtr<Object>();
+    return CreateObject(typeInfo->GetType());
+}
+
 void Context::RegisterFactory(ObjectFactory* factory)
 {
     if (!factory)
@@ -199,6 +217,7 @@ void Context::RegisterFactory(ObjectFactory* factory)
         return;
     }
     factories_[factory->GetType()] = factory;
+    RegisterTypeInfo(factory->GetTypeInfo());
 }
 
 void Context::RegisterFactory(ObjectFactory* factory, const char* category)
@@ -214,6 +233,7 @@ void Context::RegisterFactory(ObjectFactory* factory, const char* category)
 void Context::RemoveFactory(StringHash type)
 {
     factories_.erase(type);
+    UpdateTypeRegistration(type);
 }
 
 void Context::RemoveFactory(StringHash type, const char* category)
@@ -282,6 +302,7 @@ AttributeHandle Context::RegisterAttribute(StringHash objectType, const Attribut
         objectNetworkAttributes.push_back(attr);
         handle.networkAttributeInfo_ = &objectNetworkAttributes.back();
     }
+    UpdateTypeRegistration(objectType);
     return handle;
 }
 
@@ -289,12 +310,14 @@ void Context::RemoveAttribute(StringHash objectType, const char* name)
 {
     RemoveNamedAttribute(attributes_, objectType, name);
     RemoveNamedAttribute(networkAttributes_, objectType, name);
+    UpdateTypeRegistration(objectType);
 }
 
 void Context::RemoveAllAttributes(StringHash objectType)
 {
     attributes_.erase(objectType);
     networkAttributes_.erase(objectType);
+    UpdateTypeRegistration(objectType);
 }
 
 void Context::UpdateAttributeDefaultValue(StringHash objectType, const char* name, const Variant& defaultValue)
@@ -315,6 +338,87 @@ VariantMap& Context::GetEventDataMap()
     return ret;
 }
 
+void Context::PostEvent(Object* sender, StringHash eventType, const VariantMap& eventData)
+{
+    auto* node = new PostedEventNode{PostedEvent{SharedPtr<Object>(sender), eventType, eventData}, nullptr};
+    node->next_ = postedEvents_.load(std::memory_order_relaxed);
+    while (!postedEvents_.compare_exchange_weak(node->next_, node, std::memory_order_release, std::memory_order_relaxed))
+        ;
+}
+
+void Context::SendPostedEvents()
+{
+    PostedEventNode* node = postedEvents_.exchange(nullptr, std::memory_order_acquire);
+    if (!node)
+        return;
+
+    URHO3D_PROFILE("SendPostedEvents");
+
+    // The list is newest first, so reverse it into posting order. Events posted during delivery wait for the next call
+    postedEventBatch_.clear();
+    while (node)
+    {
+        PostedEventNode* next = node->next_;
+        postedEventBatch_.push_back(ea::move(node->event_));
+        delete node;
+        node = next;
+    }
+    ea::reverse(postedEventBatch_.begin(), postedEventBatch_.end());
+
+    for (PostedEvent& event : postedEventBatch_)
+        event.sender_->SendEvent(event.eventType_, event.eventData_);
+
+    if (!eventBatchReceivers_.empty())
+    {
+        // Group the events by type, keeping the posting order within each type
+        ea::stable_sort(postedEventBatch_.begin(), postedEventBatch_.end(),
+            [](const PostedEvent& lhs, const PostedEvent& rhs) { return lhs.eventType_ < rhs.eventType_; });
+
+        for (unsigned begin = 0; begin < postedEventBatch_.size();)
+        {
+            const StringHash eventType = postedEventBatch_[begin].eventType_;
+            unsigned end = begin + 1;
+            while (end < postedEventBatch_.size() && postedEventBatch_[end].eventType_ == eventType)
+                ++end;
+
+            auto i = eventBatchReceivers_.find(eventType);
+            if (i != eventBatchReceivers_.end())
+            {
+                // Copy the receivers, as handlers may subscribe or unsubscribe
+                const auto receivers = i->second;
+                const ea::span<PostedEvent> batch(postedEventBatch_.data() + begin, end - begin);
+                for (const auto& receiver : receivers)
+                {
+                    if (!receiver.first.Expired())
+                        receiver.second(batch);
+                }
+            }
+            begin = end;
+        }
+    }
+
+    postedEventBatch_.clear();
+}
+
+void Context::SubscribeToEventBatch(Object* receiver, StringHash eventType, const PostedEventBatchHandler& handler)
+{
+    UnsubscribeFromEventBatch(receiver, eventType);
+    eventBatchReceivers_[eventType].emplace_back(WeakPtr<Object>(receiver), handler);
+}
+
+void Context::UnsubscribeFromEventBatch(Object* receiver, StringHash eventType)
+{
+    auto i = eventBatchReceivers_.find(eventType);
+    if (i == eventBatchReceivers_.end())
+        return;
+
+    auto& receivers = i->second;
+    receivers.erase(ea::remove_if(receivers.begin(), receivers.end(),
+        [receiver](const auto& item) { return item.first.Expired() || item.first == receiver; }), receivers.end());
+    if (receivers.empty())
+        eventBatchReceivers_.erase(i);
+}
+
 #ifndef MINI_URHO
 bool Context::RequireSDL(unsigned int sdlFlags)
 {
@@ -415,6 +519,46 @@ void Context::CopyBaseAttributes(StringHash baseType, StringHash derivedType)
                 networkAttributes_[derivedType].push_back(attr);
         }
     }
+    UpdateTypeRegistration(derivedType);
+}
+
+void Context::RegisterTypeInfo(const TypeInfo* typeInfo)
+{
+    if (GetTypeRegistration(typeInfo))
+        return;
+
+    const unsigned typeId = typeInfo->GetTypeId();
+    if (typeId >= typeRegistry_.size())
+        typeRegistry_.resize(typeId + 1);
+
+    // Only one type info per type hash is kept up to date, drop the previous one
+    unsigned& registeredTypeId = typeIds_.insert(ea::make_pair(typeInfo->GetType(), typeId)).first->second;
+    if (registeredTypeId != typeId)
+    {
+        typeRegistry_[registeredTypeId] = TypeRegistration{};
+        registeredTypeId = typeId;
+    }
+
+    typeRegistry_[typeId].typeInfo_ = typeInfo;
+    UpdateTypeRegistration(typeInfo->GetType());
+}
+
+void Context::UpdateTypeRegistration(StringHash type)
+{
+    auto typeIdIter = typeIds_.find(type);
+    if (typeIdIter == typeIds_.end())
+        return;
+
+    TypeRegistration& registration = typeRegistry_[typeIdIter->second];
+
+    auto factoryIter = factories_.find(type);
+    registration.factory_ = factoryIter != factories_.end() ? factoryIter->second.Get() : nullptr;
+
+    auto attributesIter = attributes_.find(type);
+    registration.attributes_ = attributesIter != attributes_.end() ? &attributesIter->second : nullptr;
+
+    auto networkAttributesIter = networkAttributes_.find(type);
+    registration.networkAttributes_ = networkAttributesIter != networkAttributes_.end() ? &networkAttributesIter->second : nullptr;
 }
 
 Object* Context::GetSubsystem(StringHash type) const
@@ -22,15 +22,32 @@
 
 #pragma once
 
+#include <EASTL/span.h>
 #include <EASTL/unique_ptr.h>
 
 #include "../Container/Ptr.h"
 #include "../Core/Attribute.h"
 #include "../Core/Object.h"
 
+#include <atomic>
+
 namespace Urho3D
 {
 
+/// Event posted from any thread, delivered on the main thread by Context::SendPostedEvents().
+struct PostedEvent
+{
+    /// Sender. Kept alive until the event has been delivered.
+    SharedPtr<Object> sender_;
+    /// Event type.
+    StringHash eventType_;
+    /// Event data.
+    VariantMap eventData_;
+};
+
+/// Handler for a batch of posted events of the same type, in posting order.
+using PostedEventBatchHandler = std::function<void(ea::span<PostedEvent>)>;
+
 /// Tracking structure for event receivers.
 class URHO3D_API EventReceiverGroup : public RefCounted
 {
@@ -78,10 +95,12 @@ public:
     /// Create an object by type. Return pointer to it or null if no factory found.
     template <class T> inline SharedPtr<T> CreateObject()
     {
-        return StaticCast<T>(CreateObject(T::GetTypeStatic()));
+        return StaticCast<T>(CreateObject(T::GetTypeInfoStatic()));
     }
     /// Create an object by type hash. Return pointer to it or null if no factory found.
     SharedPtr<Object> CreateObject(StringHash objectType);
+    /// Create an object by type info. Avoids the hash lookup for types registered with their type info. Return pointer to it or null if no factory found.
+    SharedPtr<Object> CreateObject(const TypeInfo* typeInfo);
     /// Register a factory for an object type.
     void RegisterFactory(ObjectFactory* factory);
     /// Register a factory for an object type and specify the object category.
@@ -106,6 +125,14 @@ public:
     void UpdateAttributeDefaultValue(StringHash objectType, const char* name, const Variant& defaultValue);
     /// Return a preallocated map for event data. Used for optimization to avoid constant re-allocation of event data maps.
     VariantMap& GetEventDataMap();
+    /// Post an event for delivery on the main thread by SendPostedEvents(). Can be called from any thread and does not lock.
+    void PostEvent(Object* sender, StringHash eventType, const VariantMap& eventData);
+    /// Deliver the events posted since the previous call, in posting order, first to event receivers and then as batches to batch receivers. Called by the engine during the frame update. Main thread only.
+    void SendPostedEvents();
+    /// Subscribe to batches of a posted event type. The receiver is called once per SendPostedEvents() with all the posted events of the type.
+    void SubscribeToEventBatch(Object* receiver, StringHash eventType, const PostedEventBatchHandler& handler);
+    /// Unsubscribe from batches of a posted event type.
+    void UnsubscribeFromEventBatch(Object* receiver, StringHash eventType);
     /// Initialises the specified SDL systems, if not already. Returns true if successful. This call must be matched with ReleaseSDL() when SDL functions are no longer required, even if this call fails.
     bool RequireSDL(unsigned int sdlFlags);
     /// Indicate that you are done with using SDL. Must be called after using RequireSDL().
@@ -192,6 +219,20 @@ public:
         return i != networkAttributes_.end() ? &i->second : nullptr;
     }
 
+    /// Return attribute descriptions for an object type by type info, or null if none defined. Indexes the type table directly when possible.
+    const ea::vector<AttributeInfo>* GetAttributes(const TypeInfo* typeInfo) const
+    {
+        const TypeRegistration* registration = GetTypeRegistration(typeInfo);
+        return registration ? registration->attributes_ : GetAttributes(typeInfo->GetType());
+    }
+
+    /// Return network replication attribute descriptions for an object type by type info, or null if none defined.
+    const ea::vector<AttributeInfo>* GetNetworkAttributes(const TypeInfo* typeInfo) const
+    {
+        const TypeRegistration* registration = GetTypeRegistration(typeInfo);
+        return registration ? registration->networkAttributes_ : GetNetworkAttributes(typeInfo->GetType());
+    }
+
     /// Return all registered attributes.
     const ea::unordered_map<StringHash, ea::vector<AttributeInfo> >& GetAllAttributes() const { return attributes_; }
 
@@ -288,6 +329,29 @@ public:
     void RegisterSubsystem(Renderer* subsystem);
 
 private:
+    /// Factory and attributes of an object type, indexed by dense type ID.
+    struct TypeRegistration
+    {
+        /// Type info. Null if the slot is unused.
+        const TypeInfo* typeInfo_{};
+        /// Object factory.
+        ObjectFactory* factory_{};
+        /// Attribute descriptions.
+        const ea::vector<AttributeInfo>* attributes_{};
+        /// Network replication attribute descriptions.
+        const ea::vector<AttributeInfo>* networkAttributes_{};
+    };
+
+    /// Return type table entry, or null if the type info is not registered.
+    const TypeRegistration* GetTypeRegistration(const TypeInfo* typeInfo) const
+    {
+        const unsigned typeId = typeInfo->GetTypeId();
+        return typeId < typeRegistry_.size() && typeRegistry_[typeId].typeInfo_ == typeInfo ? &typeRegistry_[typeId] : nullptr;
+    }
+    /// Add type info to the type table.
+    void RegisterTypeInfo(const TypeInfo* typeInfo);
+    /// Refresh type table entry after the factory or attributes of a type changed.
+    void UpdateTypeRegistration(StringHash type);
     /// Add event receiver.
     void AddEventReceiver(Object* receiver, StringHash eventType);
     /// Add event receiver for specific event.
@@ -314,6 +378,10 @@ private:
     ea::unordered_map<StringHash, ea::vector<AttributeInfo> > attributes_;
     /// Network replication attribute descriptions per object type.
     ea::unordered_map<StringHash, ea::vector<AttributeInfo> > networkAttributes_;
+    /// Type table indexed by dense type ID. Points into the factory and attribute maps.
+    ea::vector<TypeRegistration> typeRegistry_;
+    /// Dense type IDs of the types in the type table.
+    ea::unordered_map<StringHash, unsigned> typeIds_;
     /// Event receivers for non-specific events.
     ea::unordered_map<StringHash, SharedPtr<EventReceiverGroup> > eventReceivers_;
     /// Event receivers for specific senders' events.
@@ -322,6 +390,20 @@ private:
     ea::vector<Object*> eventSenders_;
     /// Event data stack.
     ea::vector<VariantMap*> eventDataMaps_;
+    /// Node of the posted event list.
+    struct PostedEventNode
+    {
+        /// Posted event.
+        PostedEvent event_;
+        /// Previously posted event.
+        PostedEventNode* next_;
+    };
+    /// Most recently posted event. Posting pushes to the list head with compare-and-swap, delivery takes the whole list.
+    std::atomic<PostedEventNode*> postedEvents_{};
+    /// Posted events being delivered. Reused between deliveries.
+    ea::vector<PostedEvent> postedEventBatch_;
+    /// Receivers of posted event batches by event type.
+    ea::unordered_map<StringHash, ea::vector<ea::pair<WeakPtr<Object>, PostedEventBatchHandler> > > eventBatchReceivers_;
     /// Active event handler. Not stored in a stack for performance reasons; is needed only in esoteric cases.
     EventHandler* eventHandler_;
     /// Object categories.
@@ -405,13 +487,21 @@ template <class T> T* Context::RegisterSubsystem()
 
 template <class T> void Context::RemoveSubsystem() { RemoveSubsystem(T::GetTypeStatic()); }
 
-template <class T> AttributeHandle Context::RegisterAttribute(const AttributeInfo& attr) { return RegisterAttribute(T::GetTypeStatic(), attr); }
+template <class T> AttributeHandle Context::RegisterAttribute(const AttributeInfo& attr)
+{
+    RegisterTypeInfo(T::GetTypeInfoStatic());
+    return RegisterAttribute(T::GetTypeStatic(), attr);
+}
 
 template <class T> void Context::RemoveAttribute(const char* name) { RemoveAttribute(T::GetTypeStatic(), name); }
 
 template <class T> void Context::RemoveAllAttributes() { RemoveAllAttributes(T::GetTypeStatic()); }
 
-template <class T, class U> void Context::CopyBaseAttributes() { CopyBaseAttributes(T::GetTypeStatic(), U::GetTypeStatic()); }
+template <class T, class U> void Context::CopyBaseAttributes()
+{
+    RegisterTypeInfo(U::GetTypeInfoStatic());
+    CopyBaseAttributes(T::GetTypeStatic(), U::GetTypeStatic());
+}
 
 template <class T> T* Context::GetSubsystem() const { return static_cast<T*>(GetSubsystem(T::GetTypeStatic())); }
 
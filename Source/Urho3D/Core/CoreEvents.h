@@ -27,6 +27,13 @@
 namespace Urho3D
 {
 
+/// Arguments of the typed update signals, which are invoked before the corresponding update events without packing a VariantMap.
+struct UpdateEventArgs
+{
+    /// Timestep in seconds.
+    float timeStep_;
+};
+
 /// Frame begin event.
 URHO3D_EVENT(E_BEGINFRAME, BeginFrame)
 {
@@ -63,4 +70,13 @@ URHO3D_EVENT(E_ENDFRAME, EndFrame)
 {
 }
 
+/// Frame hitch detected by FrameStatistics and its report saved.
+URHO3D_EVENT(E_FRAMEHITCH, FrameHitch)
+{
+    URHO3D_PARAM(P_FRAMENUMBER, FrameNumber);      // unsigned
+    URHO3D_PARAM(P_FRAMETIME, FrameTime);          // float, milliseconds
+    URHO3D_PARAM(P_MEDIANFRAMETIME, MedianFrameTime); // float, milliseconds
+    URHO3D_PARAM(P_FILENAME, FileName);            // String, saved report
+}
+
 }
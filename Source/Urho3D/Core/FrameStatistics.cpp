@@ -0,0 +1,482 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Core/CoreEvents.h"
+#include "../Core/FrameStatistics.h"
+#include "../Core/MemoryTracker.h"
+#include "../Engine/EngineEvents.h"
+#include "../IO/File.h"
+#include "../IO/FileSystem.h"
+#include "../IO/Log.h"
+#include "../Resource/JSONFile.h"
+
+#include <EASTL/sort.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+static const char* frameStageNames[] =
+{
+    "Update",
+    "ViewCulling",
+    "Batches",
+    "Render",
+    "Physics",
+    "Network",
+    nullptr
+};
+static_assert(URHO3D_ARRAYSIZE(frameStageNames) == MAX_FRAME_STAGES + 1, "Inconsistent number of frame stages and names.");
+
+static const char* frameCounterNames[] =
+{
+    "DrawCalls",
+    "Primitives",
+    "Batches",
+    "VisibleDrawables",
+    "ResourceLoads",
+    "ShaderCompiles",
+    "Allocations",
+    nullptr
+};
+static_assert(URHO3D_ARRAYSIZE(frameCounterNames) == MAX_FRAME_COUNTERS + 1, "Inconsistent number of frame counters and names.");
+
+static const char* frameMarkerTypeNames[] =
+{
+    "ResourceLoad",
+    "ShaderCompile",
+    nullptr
+};
+static_assert(URHO3D_ARRAYSIZE(frameMarkerTypeNames) == MAX_FRAME_MARKER_TYPES + 1, "Inconsistent number of frame marker types and names.");
+
+/// Convert percentiles to JSON.
+static JSONValue PercentilesToJSON(const FrameStatisticsPercentiles& percentiles)
+{
+    JSONValue value;
+    value.Set("p50", percentiles.p50_);
+    value.Set("p95", percentiles.p95_);
+    value.Set("p99", percentiles.p99_);
+    value.Set("max", percentiles.max_);
+    return value;
+}
+
+/// Convert frame sample to JSON.
+static JSONValue SampleToJSON(const FrameStatisticsSample& sample)
+{
+    JSONValue frame;
+    frame.Set("Frame", sample.frameNumber_);
+    frame.Set("FrameTime", sample.frameTime_);
+    for (unsigned i = 0; i < MAX_FRAME_STAGES; ++i)
+        frame.Set(frameStageNames[i], sample.stageTimes_[i]);
+    for (unsigned i = 0; i < MAX_FRAME_COUNTERS; ++i)
+        frame.Set(frameCounterNames[i], sample.counters_[i]);
+    return frame;
+}
+
+/// Return total number of tracked allocations.
+static unsigned long long GetTotalNumAllocations()
+{
+    unsigned long long numAllocations = 0;
+    for (unsigned i = 0; i < MAX_MEMORY_TAGS; ++i)
+        numAllocations += MemoryTracker::GetStatistics(static_cast<MemoryTag>(i)).numAllocations_;
+    return numAllocations;
+}
+
+FrameStatistics::FrameStatistics(Context* context) :
+    Object(context)
+{
+    SetCapacity(DEFAULT_FRAME_STATISTICS_CAPACITY);
+    markers_.resize(FRAME_STATISTICS_MARKER_CAPACITY);
+    lastNumAllocations_ = GetTotalNumAllocations();
+
+    SubscribeToEvent(E_BEGINFRAME, URHO3D_HANDLER(FrameStatistics, HandleBeginFrame));
+    SubscribeToEvent(E_ENDFRAME, URHO3D_HANDLER(FrameStatistics, HandleEndFrame));
+    SubscribeToEvent(E_CONSOLECOMMAND, URHO3D_HANDLER(FrameStatistics, HandleConsoleCommand));
+}
+
+FrameStatistics::~FrameStatistics() = default;
+
+void FrameStatistics::SetEnabled(bool enable)
+{
+    enabled_ = enable;
+}
+
+void FrameStatistics::SetCapacity(unsigned numFrames)
+{
+    samples_.clear();
+    samples_.resize(Max(numFrames, 1u));
+    Clear();
+}
+
+void FrameStatistics::SetHitchDump(float threshold, const ea::string& pathName, float cooldown)
+{
+    hitchThreshold_ = Max(threshold, 0.0f);
+    hitchPath_ = pathName.empty() ? EMPTY_STRING : AddTrailingSlash(pathName);
+    hitchCooldown_ = Max(cooldown, 0.0f);
+}
+
+void FrameStatistics::Clear()
+{
+    nextSample_ = 0;
+    numSamples_ = 0;
+
+    MutexLock lock(markerMutex_);
+    nextMarker_ = 0;
+    numMarkers_ = 0;
+}
+
+void FrameStatistics::AddMarker(FrameMarkerType type, const ea::string& name)
+{
+    if (!enabled_)
+        return;
+
+    MutexLock lock(markerMutex_);
+    FrameStatisticsMarker& marker = markers_[nextMarker_];
+    marker.frameNumber_ = frameNumber_;
+    marker.type_ = type;
+    marker.name_ = name;
+    nextMarker_ = (nextMarker_ + 1) % markers_.size();
+    numMarkers_ = Min(numMarkers_ + 1, markers_.size());
+}
+
+const FrameStatisticsSample& FrameStatistics::GetSample(unsigned index) const
+{
+    assert(index < numSamples_);
+    const unsigned capacity = samples_.size();
+    return samples_[(nextSample_ + capacity - numSamples_ + index) % capacity];
+}
+
+float FrameStatistics::GetRecentMedianFrameTime(unsigned numFrames) const
+{
+    numFrames = Min(Min(numFrames, HITCH_MEDIAN_FRAMES), numSamples_);
+    if (!numFrames)
+        return 0.0f;
+
+    float values[HITCH_MEDIAN_FRAMES];
+    for (unsigned i = 0; i < numFrames; ++i)
+        values[i] = GetSample(numSamples_ - numFrames + i).frameTime_;
+    ea::nth_element(values, values + numFrames / 2, values + numFrames);
+    return values[numFrames / 2];
+}
+
+ea::vector<FrameStatisticsMarker> FrameStatistics::GetMarkers(unsigned firstFrameNumber) const
+{
+    MutexLock lock(markerMutex_);
+
+    ea::vector<FrameStatisticsMarker> result;
+    const unsigned capacity = markers_.size();
+    for (unsigned i = 0; i < numMarkers_; ++i)
+    {
+        const FrameStatisticsMarker& marker = markers_[(nextMarker_ + capacity - numMarkers_ + i) % capacity];
+        if (marker.frameNumber_ >= firstFrameNumber)
+            result.push_back(marker);
+    }
+    return result;
+}
+
+template <class T> FrameStatisticsPercentiles FrameStatistics::GetPercentiles(T getValue) const
+{
+    FrameStatisticsPercentiles percentiles;
+    if (!numSamples_)
+        return percentiles;
+
+    ea::vector<float> values(numSamples_);
+    for (unsigned i = 0; i < numSamples_; ++i)
+        values[i] = getValue(GetSample(i));
+    ea::sort(values.begin(), values.end());
+
+    const auto percentile = [&](float fraction) { return values[Min(static_cast<unsigned>(fraction * numSamples_), numSamples_ - 1)]; };
+    percentiles.p50_ = percentile(0.50f);
+    percentiles.p95_ = percentile(0.95f);
+    percentiles.p99_ = percentile(0.99f);
+    percentiles.max_ = values.back();
+    return percentiles;
+}
+
+FrameStatisticsPercentiles FrameStatistics::GetFrameTimePercentiles() const
+{
+    return GetPercentiles([](const FrameStatisticsSample& sample) { return sample.frameTime_; });
+}
+
+FrameStatisticsPercentiles FrameStatistics::GetStageTimePercentiles(FrameStage stage) const
+{
+    return GetPercentiles([stage](const FrameStatisticsSample& sample) { return sample.stageTimes_[stage]; });
+}
+
+ea::string FrameStatistics::PrintSummary() const
+{
+    ea::string output = Format("Frame statistics over {} frames (ms): p50 / p95 / p99 / max\n", numSamples_);
+
+    const auto printPercentiles = [&](const char* name, const FrameStatisticsPercentiles& percentiles)
+    {
+        output += Format("{:<16} {:8.3f} {:8.3f} {:8.3f} {:8.3f}\n", name,
+            percentiles.p50_, percentiles.p95_, percentiles.p99_, percentiles.max_);
+    };
+
+    printPercentiles("Frame", GetFrameTimePercentiles());
+    for (unsigned i = 0; i < MAX_FRAME_STAGES; ++i)
+        printPercentiles(frameStageNames[i], GetStageTimePercentiles(static_cast<FrameStage>(i)));
+
+    return output;
+}
+
+bool FrameStatistics::SaveCSV(const ea::string& fileName) const
+{
+    File file(context_);
+    if (!file.Open(fileName, FILE_WRITE))
+        return false;
+
+    ea::string header = "Frame,FrameTime";
+    for (unsigned i = 0; i < MAX_FRAME_STAGES; ++i)
+        header += Format(",{}", frameStageNames[i]);
+    for (unsigned i = 0; i < MAX_FRAME_COUNTERS; ++i)
+        header += Format(",{}", frameCounterNames[i]);
+    file.WriteLine(header);
+
+    ea::string line;
+    for (unsigned i = 0; i < numSamples_; ++i)
+    {
+        const FrameStatisticsSample& sample = GetSample(i);
+        line = Format("{},{:.3f}", sample.frameNumber_, sample.frameTime_);
+        for (float stageTime : sample.stageTimes_)
+            line += Format(",{:.3f}", stageTime);
+        for (unsigned counter : sample.counters_)
+            line += Format(",{}", counter);
+        file.WriteLine(line);
+    }
+
+    return true;
+}
+
+bool FrameStatistics::SaveJSON(const ea::string& fileName) const
+{
+    JSONFile jsonFile(context_);
+    JSONValue& root = jsonFile.GetRoot();
+
+    JSONValue summary;
+    summary.Set("Frame", PercentilesToJSON(GetFrameTimePercentiles()));
+    for (unsigned i = 0; i < MAX_FRAME_STAGES; ++i)
+        summary.Set(frameStageNames[i], PercentilesToJSON(GetStageTimePercentiles(static_cast<FrameStage>(i))));
+    root.Set("summary", summary);
+
+    JSONValue frames(JSON_ARRAY);
+    for (unsigned i = 0; i < numSamples_; ++i)
+        frames.Push(SampleToJSON(GetSample(i)));
+    root.Set("frames", frames);
+
+    return jsonFile.SaveFile(fileName);
+}
+
+bool FrameStatistics::SaveHitchReport(const ea::string& fileName, float threshold, float medianFrameTime) const
+{
+    if (!numSamples_)
+        return false;
+
+    JSONFile jsonFile(context_);
+    JSONValue& root = jsonFile.GetRoot();
+
+    const FrameStatisticsSample& hitch = GetSample(numSamples_ - 1);
+    root.Set("Frame", hitch.frameNumber_);
+    root.Set("FrameTime", hitch.frameTime_);
+    root.Set("MedianFrameTime", medianFrameTime);
+    root.Set("Threshold", threshold);
+
+    const unsigned numFrames = Min(hitchReportFrames_, numSamples_);
+    JSONValue frames(JSON_ARRAY);
+    for (unsigned i = numSamples_ - numFrames; i < numSamples_; ++i)
+        frames.Push(SampleToJSON(GetSample(i)));
+    root.Set("Frames", frames);
+
+    JSONValue markers(JSON_ARRAY);
+    for (const FrameStatisticsMarker& marker : GetMarkers(GetSample(numSamples_ - numFrames).frameNumber_))
+    {
+        JSONValue value;
+        value.Set("Frame", marker.frameNumber_);
+        value.Set("Type", frameMarkerTypeNames[marker.type_]);
+        value.Set("Name", marker.name_);
+        markers.Push(value);
+    }
+    root.Set("Markers", markers);
+
+    JSONValue memory(JSON_OBJECT);
+    for (unsigned i = 0; i < MAX_MEMORY_TAGS; ++i)
+    {
+        const MemoryTagStatistics statistics = MemoryTracker::GetStatistics(static_cast<MemoryTag>(i));
+        if (!statistics.numAllocations_)
+            continue;
+
+        JSONValue value;
+        value.Set("LiveBytes", static_cast<double>(statistics.liveBytes_));
+        value.Set("PeakBytes", static_cast<double>(statistics.peakBytes_));
+        memory.Set(MemoryTracker::GetTagName(static_cast<MemoryTag>(i)), value);
+    }
+    root.Set("Memory", memory);
+
+    return jsonFile.SaveFile(fileName);
+}
+
+bool FrameStatistics::Save(const ea::string& fileName) const
+{
+    if (GetExtension(fileName) == ".json")
+        return SaveJSON(fileName);
+    return SaveCSV(fileName);
+}
+
+const char* FrameStatistics::GetStageName(FrameStage stage)
+{
+    return stage < MAX_FRAME_STAGES ? frameStageNames[stage] : nullptr;
+}
+
+const char* FrameStatistics::GetCounterName(FrameCounter counter)
+{
+    return counter < MAX_FRAME_COUNTERS ? frameCounterNames[counter] : nullptr;
+}
+
+const char* FrameStatistics::GetMarkerTypeName(FrameMarkerType type)
+{
+    return type < MAX_FRAME_MARKER_TYPES ? frameMarkerTypeNames[type] : nullptr;
+}
+
+void FrameStatistics::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
+{
+    using namespace BeginFrame;
+
+    {
+        MutexLock lock(markerMutex_);
+        frameNumber_ = eventData[P_FRAMENUMBER].GetUInt();
+    }
+    frameTimer_.Reset();
+    for (auto& stageTime : stageTimes_)
+        stageTime.store(0, std::memory_order_relaxed);
+    for (auto& counter : counters_)
+        counter.store(0, std::memory_order_relaxed);
+}
+
+void FrameStatistics::HandleEndFrame(StringHash eventType, VariantMap& eventData)
+{
+    if (!enabled_)
+        return;
+
+    const unsigned long long numAllocations = GetTotalNumAllocations();
+    counters_[FC_ALLOCATIONS].store(static_cast<unsigned>(numAllocations - lastNumAllocations_), std::memory_order_relaxed);
+    lastNumAllocations_ = numAllocations;
+
+    FrameStatisticsSample& sample = samples_[nextSample_];
+    sample.frameNumber_ = frameNumber_;
+    sample.frameTime_ = frameTimer_.GetUSec(false) / 1000.0f;
+    for (unsigned i = 0; i < MAX_FRAME_STAGES; ++i)
+        sample.stageTimes_[i] = stageTimes_[i].load(std::memory_order_relaxed) / 1000.0f;
+    for (unsigned i = 0; i < MAX_FRAME_COUNTERS; ++i)
+        sample.counters_[i] = counters_[i].load(std::memory_order_relaxed);
+
+    // The median of the preceding frames, so that the hitch itself does not raise the threshold
+    const float medianFrameTime = hitchMedianFactor_ > 0.0f ? GetRecentMedianFrameTime() : 0.0f;
+
+    nextSample_ = (nextSample_ + 1) % samples_.size();
+    numSamples_ = Min(numSamples_ + 1, samples_.size());
+
+    if (hitchThreshold_ > 0.0f || hitchMedianFactor_ > 0.0f)
+        DetectHitch(sample, medianFrameTime);
+}
+
+void FrameStatistics::DetectHitch(const FrameStatisticsSample& sample, float medianFrameTime)
+{
+    // Relative detection needs enough history for a meaningful median
+    if (hitchMedianFactor_ > 0.0f && numSamples_ <= HITCH_MEDIAN_FRAMES)
+        return;
+
+    const float threshold = Max(hitchThreshold_, medianFrameTime * hitchMedianFactor_);
+    if (sample.frameTime_ <= threshold)
+        return;
+
+    // Report the frames leading up to the hitch, but not more often than the cooldown allows
+    if (hitchDumped_ && hitchTimer_.GetMSec(false) < hitchCooldown_ * 1000.0f)
+        return;
+    hitchTimer_.Reset();
+    hitchDumped_ = true;
+
+    if (!hitchPath_.empty())
+        GetSubsystem<FileSystem>()->CreateDirsRecursive(hitchPath_);
+
+    const ea::string fileName = Format("{}FrameHitch_{}.json", hitchPath_, sample.frameNumber_);
+    if (!SaveHitchReport(fileName, threshold, medianFrameTime))
+    {
+        URHO3D_LOGERROR("Could not save frame hitch report to " + fileName);
+        return;
+    }
+    URHO3D_LOGWARNING("Frame {} took {:.3f} ms (median {:.3f} ms), hitch report saved to {}", sample.frameNumber_,
+        sample.frameTime_, medianFrameTime, fileName);
+
+    using namespace FrameHitch;
+
+    VariantMap& eventData = GetEventDataMap();
+    eventData[P_FRAMENUMBER] = sample.frameNumber_;
+    eventData[P_FRAMETIME] = sample.frameTime_;
+    eventData[P_MEDIANFRAMETIME] = medianFrameTime;
+    eventData[P_FILENAME] = fileName;
+    SendEvent(E_FRAMEHITCH, eventData);
+}
+
+void FrameStatistics::HandleConsoleCommand(StringHash eventType, VariantMap& eventData)
+{
+    using namespace ConsoleCommand;
+    if (eventData[P_ID].GetString() != GetTypeName())
+        return;
+
+    const ea::string command = eventData[P_COMMAND].GetString().trimmed();
+    if (command == "summary")
+        URHO3D_LOGINFO(PrintSummary());
+    else if (command.starts_with("dump"))
+    {
+        ea::string fileName = command.substr(4).trimmed();
+        if (fileName.empty())
+            fileName = Format("FrameStatistics_{}.csv", frameNumber_);
+
+        if (Save(fileName))
+            URHO3D_LOGINFO("Frame statistics saved to " + fileName);
+        else
+            URHO3D_LOGERROR("Could not save frame statistics to " + fileName);
+    }
+    else
+        URHO3D_LOGINFO("Frame statistics commands: summary, dump [file.csv|file.json]");
+}
+
+FrameStageTimer::FrameStageTimer(Context* context, FrameStage stage) :
+    statistics_(context->GetSubsystem<FrameStatistics>()),
+    stage_(stage)
+{
+    if (statistics_ && !statistics_->IsEnabled())
+        statistics_ = nullptr;
+}
+
+FrameStageTimer::~FrameStageTimer()
+{
+    if (statistics_)
+        statistics_->AddStageTime(stage_, timer_.GetUSec(false));
+}
+
+}
@@ -0,0 +1,286 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+/// \file
+
+#pragma once
+
+#include "../Core/Mutex.h"
+#include "../Core/Object.h"
+#include "../Core/Timer.h"
+
+#include <EASTL/vector.h>
+
+#include <atomic>
+
+namespace Urho3D
+{
+
+/// Engine stage timed by the frame statistics.
+enum FrameStage
+{
+    /// Logic update, including the update events.
+    FS_UPDATE = 0,
+    /// View culling.
+    FS_VIEW_CULLING,
+    /// View batch collection.
+    FS_BATCHES,
+    /// Rendering, including UI.
+    FS_RENDER,
+    /// Physics simulation.
+    FS_PHYSICS,
+    /// Network update.
+    FS_NETWORK,
+    /// Number of stages.
+    MAX_FRAME_STAGES
+};
+
+/// Counter recorded by the frame statistics.
+enum FrameCounter
+{
+    /// Draw calls issued by Graphics.
+    FC_DRAW_CALLS = 0,
+    /// Primitives rendered by Graphics.
+    FC_PRIMITIVES,
+    /// Batches collected by Renderer views.
+    FC_BATCHES,
+    /// Visible drawables in all views.
+    FC_VISIBLE_DRAWABLES,
+    /// Resources loaded by ResourceCache.
+    FC_RESOURCE_LOADS,
+    /// Shaders compiled by Graphics.
+    FC_SHADER_COMPILES,
+    /// Allocations tracked by MemoryTracker.
+    FC_ALLOCATIONS,
+    /// Number of counters.
+    MAX_FRAME_COUNTERS
+};
+
+/// Type of a frame statistics marker.
+enum FrameMarkerType
+{
+    /// Resource load.
+    FM_RESOURCE_LOAD = 0,
+    /// Shader compile.
+    FM_SHADER_COMPILE,
+    /// Number of marker types.
+    MAX_FRAME_MARKER_TYPES
+};
+
+/// Default number of frames kept by the frame statistics.
+static const unsigned DEFAULT_FRAME_STATISTICS_CAPACITY = 1024;
+/// Number of markers kept by the frame statistics.
+static const unsigned FRAME_STATISTICS_MARKER_CAPACITY = 256;
+/// Number of preceding frames whose median frame time the relative hitch threshold is based on.
+static const unsigned HITCH_MEDIAN_FRAMES = 64;
+/// Default number of frames saved into a hitch report.
+static const unsigned DEFAULT_HITCH_REPORT_FRAMES = 30;
+
+/// Statistics of one frame.
+struct FrameStatisticsSample
+{
+    /// Frame number.
+    unsigned frameNumber_{};
+    /// Frame duration in milliseconds.
+    float frameTime_{};
+    /// Stage durations in milliseconds.
+    float stageTimes_[MAX_FRAME_STAGES]{};
+    /// Counter values.
+    unsigned counters_[MAX_FRAME_COUNTERS]{};
+};
+
+/// Named event of a frame, such as a resource load or shader compile.
+struct FrameStatisticsMarker
+{
+    /// Frame number.
+    unsigned frameNumber_{};
+    /// Type.
+    FrameMarkerType type_{};
+    /// Name of the loaded resource or compiled shader.
+    ea::string name_;
+};
+
+/// Percentiles of a frame statistics value over the recorded frames.
+struct FrameStatisticsPercentiles
+{
+    /// Median.
+    float p50_{};
+    /// 95th percentile.
+    float p95_{};
+    /// 99th percentile.
+    float p99_{};
+    /// Maximum.
+    float max_{};
+};
+
+/// Always-on recorder of per-frame timings, counters and markers in fixed-size rings. Can export to CSV or JSON on request, or save a compact report of the frames leading up to a hitch.
+class URHO3D_API FrameStatistics : public Object
+{
+    URHO3D_OBJECT(FrameStatistics, Object);
+
+public:
+    /// Construct.
+    explicit FrameStatistics(Context* context);
+    /// Destruct.
+    ~FrameStatistics() override;
+
+    /// Enable or disable recording.
+    void SetEnabled(bool enable);
+    /// Set number of recorded frames. Clears the recorded frames.
+    void SetCapacity(unsigned numFrames);
+    /// Set hitch detection. When a frame takes longer than the threshold in milliseconds, a hitch report is saved as JSON into the directory and E_FRAMEHITCH is sent. Zero threshold and zero median factor disable.
+    void SetHitchDump(float threshold, const ea::string& pathName, float cooldown = 10.0f);
+    /// Set hitch threshold relative to the median frame time of the preceding frames. The absolute threshold, if any, acts as the minimum. Zero disables.
+    void SetHitchMedianFactor(float factor) { hitchMedianFactor_ = Max(factor, 0.0f); }
+    /// Set number of preceding frames saved into a hitch report.
+    void SetHitchReportFrames(unsigned numFrames) { hitchReportFrames_ = Max(numFrames, 1u); }
+    /// Clear the recorded frames.
+    void Clear();
+
+    /// Add time in microseconds to a stage of the current frame. Can be called from any thread.
+    void AddStageTime(FrameStage stage, long long usec)
+    {
+        if (enabled_)
+            stageTimes_[stage].fetch_add(usec, std::memory_order_relaxed);
+    }
+    /// Increment a counter of the current frame. Can be called from any thread.
+    void IncrementCounter(FrameCounter counter, unsigned delta = 1)
+    {
+        if (enabled_)
+            counters_[counter].fetch_add(delta, std::memory_order_relaxed);
+    }
+    /// Set a counter of the current frame.
+    void SetCounter(FrameCounter counter, unsigned value)
+    {
+        if (enabled_)
+            counters_[counter].store(value, std::memory_order_relaxed);
+    }
+    /// Add a named marker to the current frame. Can be called from any thread.
+    void AddMarker(FrameMarkerType type, const ea::string& name);
+
+    /// Return whether recording is enabled.
+    bool IsEnabled() const { return enabled_; }
+    /// Return number of recorded frames.
+    unsigned GetNumSamples() const { return numSamples_; }
+    /// Return recorded frame by index, zero being the oldest.
+    const FrameStatisticsSample& GetSample(unsigned index) const;
+    /// Return median frame time of the most recent frames.
+    float GetRecentMedianFrameTime(unsigned numFrames = HITCH_MEDIAN_FRAMES) const;
+    /// Return markers of the given and later frames, oldest first.
+    ea::vector<FrameStatisticsMarker> GetMarkers(unsigned firstFrameNumber) const;
+    /// Return percentiles of frame time over the recorded frames.
+    FrameStatisticsPercentiles GetFrameTimePercentiles() const;
+    /// Return percentiles of a stage time over the recorded frames.
+    FrameStatisticsPercentiles GetStageTimePercentiles(FrameStage stage) const;
+    /// Return summary of the recorded frames as text.
+    ea::string PrintSummary() const;
+
+    /// Save recorded frames as CSV. Return true if successful.
+    bool SaveCSV(const ea::string& fileName) const;
+    /// Save recorded frames and percentile summary as JSON. Return true if successful.
+    bool SaveJSON(const ea::string& fileName) const;
+    /// Save recorded frames, as JSON if the file name has .json extension and as CSV otherwise. Return true if successful.
+    bool Save(const ea::string& fileName) const;
+    /// Save a compact JSON report of the most recent frames with their markers and the memory statistics. Return true if successful.
+    bool SaveHitchReport(const ea::string& fileName, float threshold, float medianFrameTime) const;
+
+    /// Return name of a stage.
+    static const char* GetStageName(FrameStage stage);
+    /// Return name of a counter.
+    static const char* GetCounterName(FrameCounter counter);
+    /// Return name of a marker type.
+    static const char* GetMarkerTypeName(FrameMarkerType type);
+
+private:
+    /// Handle frame begin.
+    void HandleBeginFrame(StringHash eventType, VariantMap& eventData);
+    /// Handle frame end. Commit the current frame into the ring.
+    void HandleEndFrame(StringHash eventType, VariantMap& eventData);
+    /// Detect a hitch of the just recorded frame and save its report.
+    void DetectHitch(const FrameStatisticsSample& sample, float medianFrameTime);
+    /// Handle console command. Supports "dump <file>" and "summary".
+    void HandleConsoleCommand(StringHash eventType, VariantMap& eventData);
+    /// Return percentiles of a value over the recorded frames.
+    template <class T> FrameStatisticsPercentiles GetPercentiles(T getValue) const;
+
+    /// Recorded frames.
+    ea::vector<FrameStatisticsSample> samples_;
+    /// Index of the next frame in the ring.
+    unsigned nextSample_{};
+    /// Number of recorded frames.
+    unsigned numSamples_{};
+    /// Stage times of the current frame in microseconds.
+    std::atomic<long long> stageTimes_[MAX_FRAME_STAGES]{};
+    /// Counters of the current frame.
+    std::atomic<unsigned> counters_[MAX_FRAME_COUNTERS]{};
+    /// Recorded markers.
+    ea::vector<FrameStatisticsMarker> markers_;
+    /// Index of the next marker in the ring.
+    unsigned nextMarker_{};
+    /// Number of recorded markers.
+    unsigned numMarkers_{};
+    /// Mutex for markers and the current frame number.
+    mutable Mutex markerMutex_;
+    /// Current frame number.
+    unsigned frameNumber_{};
+    /// Total number of tracked allocations at the previous frame end.
+    unsigned long long lastNumAllocations_{};
+    /// Frame timer.
+    HiresTimer frameTimer_;
+    /// Hitch threshold in milliseconds.
+    float hitchThreshold_{};
+    /// Hitch threshold relative to the median frame time.
+    float hitchMedianFactor_{};
+    /// Number of frames in a hitch report.
+    unsigned hitchReportFrames_{DEFAULT_HITCH_REPORT_FRAMES};
+    /// Minimum time between hitch dumps in seconds.
+    float hitchCooldown_{};
+    /// Directory for hitch dumps.
+    ea::string hitchPath_;
+    /// Timer since the previous hitch dump.
+    Timer hitchTimer_;
+    /// Whether a hitch dump has been written.
+    bool hitchDumped_{};
+    /// Recording enabled flag.
+    bool enabled_{true};
+};
+
+/// Measure the scope duration into a frame statistics stage. Does nothing if the frame statistics subsystem does not exist.
+class URHO3D_API FrameStageTimer
+{
+public:
+    /// Construct and start timing.
+    FrameStageTimer(Context* context, FrameStage stage);
+    /// Destruct and add the elapsed time.
+    ~FrameStageTimer();
+
+private:
+    /// Frame statistics subsystem.
+    FrameStatistics* statistics_;
+    /// Timed stage.
+    FrameStage stage_;
+    /// Timer.
+    HiresTimer timer_;
+};
+
+}
@@ -0,0 +1,260 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Core/MemoryTracker.h"
+#include "../Core/Profiler.h"
+#include "../Core/StringUtils.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// Global operator new can only be replaced for the whole program in static builds on Windows
+#if URHO3D_MEMORY_TRACKING && (URHO3D_STATIC || !defined(_WIN32))
+#define URHO3D_GLOBAL_MEMORY_TRACKING 1
+#else
+#define URHO3D_GLOBAL_MEMORY_TRACKING 0
+#endif
+
+namespace Urho3D
+{
+
+static const char* memoryTagNames[] =
+{
+    "Default",
+    "Animation",
+    "Audio",
+    "Graphics",
+    "Navigation",
+    "Network",
+    "Physics",
+    "Resource",
+    "Scene",
+    "UI",
+    nullptr
+};
+static_assert(sizeof(memoryTagNames) / sizeof(memoryTagNames[0]) == MAX_MEMORY_TAGS + 1, "Inconsistent number of memory tags and names.");
+
+/// Maximum depth of nested memory tag scopes.
+static const unsigned MAX_MEMORY_TAG_DEPTH = 32;
+
+/// Stack of memory tags of a thread. Trivially constructible so it is usable from operator new at any time.
+struct MemoryTagStack
+{
+    /// Tags.
+    MemoryTag tags_[MAX_MEMORY_TAG_DEPTH];
+    /// Number of pushed tags. Tags beyond the maximum depth are counted but not stored.
+    unsigned depth_;
+};
+
+static thread_local MemoryTagStack tagStack;
+
+static std::atomic<long long> liveBytes[MAX_MEMORY_TAGS];
+static std::atomic<long long> peakBytes[MAX_MEMORY_TAGS];
+static std::atomic<unsigned long long> numAllocations[MAX_MEMORY_TAGS];
+
+void* MemoryTracker::Allocate(MemoryTag tag, size_t size, size_t alignment)
+{
+    alignment = alignment > sizeof(void*) ? alignment : sizeof(void*);
+#ifdef _WIN32
+    void* ptr = _aligned_malloc(size ? size : 1, alignment);
+#else
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, alignment, size ? size : 1) != 0)
+        ptr = nullptr;
+#endif
+    if (!ptr)
+        throw std::bad_alloc();
+
+    OnAllocate(tag, size);
+#if URHO3D_PROFILING
+    TracyAlloc(ptr, size);
+#endif
+    return ptr;
+}
+
+void MemoryTracker::Free(MemoryTag tag, void* ptr, size_t size)
+{
+    if (!ptr)
+        return;
+
+#if URHO3D_PROFILING
+    TracyFree(ptr);
+#endif
+    OnFree(tag, size);
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+void MemoryTracker::OnAllocate(MemoryTag tag, size_t size)
+{
+    const long long live = liveBytes[tag].fetch_add(static_cast<long long>(size), std::memory_order_relaxed) + static_cast<long long>(size);
+    numAllocations[tag].fetch_add(1, std::memory_order_relaxed);
+
+    long long peak = peakBytes[tag].load(std::memory_order_relaxed);
+    while (live > peak && !peakBytes[tag].compare_exchange_weak(peak, live, std::memory_order_relaxed))
+        ;
+}
+
+void MemoryTracker::OnFree(MemoryTag tag, size_t size)
+{
+    liveBytes[tag].fetch_sub(static_cast<long long>(size), std::memory_order_relaxed);
+}
+
+void MemoryTracker::PushTag(MemoryTag tag)
+{
+    if (tagStack.depth_ < MAX_MEMORY_TAG_DEPTH)
+        tagStack.tags_[tagStack.depth_] = tag;
+    ++tagStack.depth_;
+}
+
+void MemoryTracker::PopTag()
+{
+    assert(tagStack.depth_ > 0);
+    --tagStack.depth_;
+}
+
+MemoryTag MemoryTracker::GetCurrentTag()
+{
+    const unsigned depth = tagStack.depth_;
+    if (!depth)
+        return MEMORY_TAG_DEFAULT;
+    return tagStack.tags_[(depth < MAX_MEMORY_TAG_DEPTH ? depth : MAX_MEMORY_TAG_DEPTH) - 1];
+}
+
+MemoryTagStatistics MemoryTracker::GetStatistics(MemoryTag tag)
+{
+    MemoryTagStatistics statistics;
+    if (tag < MAX_MEMORY_TAGS)
+    {
+        statistics.liveBytes_ = liveBytes[tag].load(std::memory_order_relaxed);
+        statistics.peakBytes_ = peakBytes[tag].load(std::memory_order_relaxed);
+        statistics.numAllocations_ = numAllocations[tag].load(std::memory_order_relaxed);
+    }
+    return statistics;
+}
+
+void MemoryTracker::ResetPeaks()
+{
+    for (unsigned i = 0; i < MAX_MEMORY_TAGS; ++i)
+        peakBytes[i].store(liveBytes[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+const char* MemoryTracker::GetTagName(MemoryTag tag)
+{
+    return tag < MAX_MEMORY_TAGS ? memoryTagNames[tag] : nullptr;
+}
+
+bool MemoryTracker::IsGlobalTrackingEnabled()
+{
+    return URHO3D_GLOBAL_MEMORY_TRACKING != 0;
+}
+
+ea::string MemoryTracker::PrintStatistics()
+{
+    ea::string output = "Memory by tag: live / peak KB, allocations\n";
+    for (unsigned i = 0; i < MAX_MEMORY_TAGS; ++i)
+    {
+        const MemoryTagStatistics statistics = GetStatistics(static_cast<MemoryTag>(i));
+        if (!statistics.numAllocations_)
+            continue;
+
+        output += Format("{:<12} {:10.1f} {:10.1f} {:12}\n", memoryTagNames[i],
+            statistics.liveBytes_ / 1024.0, statistics.peakBytes_ / 1024.0, statistics.numAllocations_);
+    }
+    return output;
+}
+
+}
+
+#if URHO3D_GLOBAL_MEMORY_TRACKING
+
+namespace
+{
+
+/// Header in front of each tracked allocation. Padded to keep the default new alignment.
+struct alignas(std::max_align_t) TrackedAllocationHeader
+{
+    /// Requested size.
+    size_t size_;
+    /// Tag at the time of allocation.
+    Urho3D::MemoryTag tag_;
+};
+
+void* TrackedAllocate(size_t size)
+{
+    void* ptr = malloc(sizeof(TrackedAllocationHeader) + size);
+    if (!ptr)
+        return nullptr;
+
+    auto* header = static_cast<TrackedAllocationHeader*>(ptr);
+    header->size_ = size;
+    header->tag_ = Urho3D::MemoryTracker::GetCurrentTag();
+    Urho3D::MemoryTracker::OnAllocate(header->tag_, size);
+    return header + 1;
+}
+
+void TrackedFree(void* ptr)
+{
+    if (!ptr)
+        return;
+
+    auto* header = static_cast<TrackedAllocationHeader*>(ptr) - 1;
+    Urho3D::MemoryTracker::OnFree(header->tag_, header->size_);
+    free(header);
+}
+
+}
+
+void* operator new(size_t size)
+{
+    if (void* ptr = TrackedAllocate(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    if (void* ptr = TrackedAllocate(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return TrackedAllocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return TrackedAllocate(size); }
+void operator delete(void* ptr) noexcept { TrackedFree(ptr); }
+void operator delete[](void* ptr) noexcept { TrackedFree(ptr); }
+void operator delete(void* ptr, size_t) noexcept { TrackedFree(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { TrackedFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { TrackedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { TrackedFree(ptr); }
+
+#endif
@@ -0,0 +1,148 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+/// \file
+
+#pragma once
+
+#include "../Container/Str.h"
+
+#include <cstddef>
+
+namespace Urho3D
+{
+
+/// Engine memory tag. Allocations are attributed to the tag active on the allocating thread.
+enum MemoryTag : unsigned char
+{
+    /// Untagged allocations.
+    MEMORY_TAG_DEFAULT = 0,
+    /// Animation playback.
+    MEMORY_TAG_ANIMATION,
+    /// Audio mixing.
+    MEMORY_TAG_AUDIO,
+    /// Rendering.
+    MEMORY_TAG_GRAPHICS,
+    /// Navigation mesh building and crowds.
+    MEMORY_TAG_NAVIGATION,
+    /// Networking and replication.
+    MEMORY_TAG_NETWORK,
+    /// Physics simulation.
+    MEMORY_TAG_PHYSICS,
+    /// Resource loading.
+    MEMORY_TAG_RESOURCE,
+    /// Scene update.
+    MEMORY_TAG_SCENE,
+    /// User interface.
+    MEMORY_TAG_UI,
+    /// Number of tags.
+    MAX_MEMORY_TAGS
+};
+
+/// Memory statistics of a tag.
+struct MemoryTagStatistics
+{
+    /// Currently allocated bytes.
+    long long liveBytes_{};
+    /// Highest number of allocated bytes.
+    long long peakBytes_{};
+    /// Total number of allocations.
+    unsigned long long numAllocations_{};
+};
+
+/// Tracker of engine memory by tag. Tagged allocators are always tracked. All other allocations through global operator new are tracked only when the engine is built with URHO3D_MEMORY_TRACKING.
+class URHO3D_API MemoryTracker
+{
+public:
+    /// Allocate memory attributed to the tag.
+    static void* Allocate(MemoryTag tag, size_t size, size_t alignment = alignof(std::max_align_t));
+    /// Free memory allocated by Allocate.
+    static void Free(MemoryTag tag, void* ptr, size_t size);
+    /// Record an allocation made elsewhere.
+    static void OnAllocate(MemoryTag tag, size_t size);
+    /// Record freeing of an allocation made elsewhere.
+    static void OnFree(MemoryTag tag, size_t size);
+
+    /// Push tag for allocations on the current thread.
+    static void PushTag(MemoryTag tag);
+    /// Pop tag for allocations on the current thread.
+    static void PopTag();
+    /// Return active tag of the current thread.
+    static MemoryTag GetCurrentTag();
+
+    /// Return statistics of a tag.
+    static MemoryTagStatistics GetStatistics(MemoryTag tag);
+    /// Reset high-water marks to the current live sizes.
+    static void ResetPeaks();
+    /// Return name of a tag.
+    static const char* GetTagName(MemoryTag tag);
+    /// Return whether allocations through global operator new are tracked.
+    static bool IsGlobalTrackingEnabled();
+    /// Return statistics of all tags as text.
+    static ea::string PrintStatistics();
+};
+
+/// Scope in which allocations on the current thread are attributed to a tag.
+class MemoryTagScope
+{
+public:
+    /// Construct and push the tag.
+    explicit MemoryTagScope(MemoryTag tag) { MemoryTracker::PushTag(tag); }
+    /// Destruct and pop the tag.
+    ~MemoryTagScope() { MemoryTracker::PopTag(); }
+
+    /// Non-copyable.
+    MemoryTagScope(const MemoryTagScope&) = delete;
+    /// Non-copyable.
+    MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+};
+
+/// EASTL allocator that attributes its allocations to a fixed tag, e.g. `ea::vector<T, TaggedAllocator<MEMORY_TAG_UI>>`.
+template <MemoryTag Tag>
+class TaggedAllocator
+{
+public:
+    /// Construct.
+    explicit TaggedAllocator(const char* /*name*/ = nullptr) { }
+    /// Construct from another allocator.
+    TaggedAllocator(const TaggedAllocator& /*other*/, const char* /*name*/) { }
+
+    /// Allocate memory.
+    void* allocate(size_t n, int /*flags*/ = 0) { return MemoryTracker::Allocate(Tag, n); }
+    /// Allocate aligned memory.
+    void* allocate(size_t n, size_t alignment, size_t /*offset*/, int /*flags*/ = 0) { return MemoryTracker::Allocate(Tag, n, alignment); }
+    /// Free memory.
+    void deallocate(void* p, size_t n) { MemoryTracker::Free(Tag, p, n); }
+
+    /// Return name.
+    const char* get_name() const { return MemoryTracker::GetTagName(Tag); }
+    /// Set name. Ignored.
+    void set_name(const char* /*name*/) { }
+};
+
+/// All tagged allocators of the same tag are interchangeable.
+template <MemoryTag Tag> inline bool operator ==(const TaggedAllocator<Tag>&, const TaggedAllocator<Tag>&) { return true; }
+/// All tagged allocators of the same tag are interchangeable.
+template <MemoryTag Tag> inline bool operator !=(const TaggedAllocator<Tag>&, const TaggedAllocator<Tag>&) { return false; }
+
+}
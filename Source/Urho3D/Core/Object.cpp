@@ -28,16 +28,22 @@
 #include "../Core/Profiler.h"
 #include "../IO/Log.h"
 
+#include <atomic>
+
 #include "../DebugNew.h"
 
 
 namespace Urho3D
 {
 
+/// Next dense type index.
+static std::atomic<unsigned> nextTypeId{};
+
 TypeInfo::TypeInfo(const char* typeName, const TypeInfo* baseTypeInfo) :
     type_(typeName),
     typeName_(typeName),
-    baseTypeInfo_(baseTypeInfo)
+    baseTypeInfo_(baseTypeInfo),
+    typeId_(nextTypeId.fetch_add(1, std::memory_order_relaxed))
 {
 }
 
@@ -305,6 +311,11 @@ void Object::UnsubscribeFromAllEventsExcept(const ea::vector<Object*>& exception
     }
 }
 
+void Object::PostEvent(StringHash eventType, const VariantMap& eventData)
+{
+    context_->PostEvent(this, eventType, eventData);
+}
+
 void Object::SendEvent(StringHash eventType)
 {
     VariantMap noEventData;
@@ -87,6 +87,8 @@ public:
     const ea::string& GetTypeName() const { return typeName_;}
     /// Return base type info.
     const TypeInfo* GetBaseTypeInfo() const { return baseTypeInfo_; }
+    /// Return dense process-wide type index, assigned on construction. Used to index type tables of the context.
+    unsigned GetTypeId() const { return typeId_; }
 
 private:
     /// Type.
@@ -95,6 +97,8 @@ private:
     ea::string typeName_;
     /// Base class type info.
     const TypeInfo* baseTypeInfo_;
+    /// Dense type index.
+    unsigned typeId_;
 };
 
 #define URHO3D_OBJECT(typeName, baseTypeName) \
@@ -174,6 +178,8 @@ public:
     void SendEvent(StringHash eventType);
     /// Send event with parameters to all subscribers.
     void SendEvent(StringHash eventType, VariantMap& eventData);
+    /// Post event from any thread. It is sent to the subscribers on the main thread during the next frame update.
+    void PostEvent(StringHash eventType, const VariantMap& eventData = Variant::emptyVariantMap);
     /// Return a preallocated map for event data. Used for optimization to avoid constant re-allocation of event data maps.
     VariantMap& GetEventDataMap() const;
     /// Send event with variadic parameter pairs to all subscribers. The parameter pairs is a list of paramID and paramValue separated by comma, one pair after another.
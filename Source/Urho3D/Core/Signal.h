@@ -26,6 +26,7 @@
 #include "../Container/RefCounted.h"
 #include "../Core/Function.h"
 
+#include <EASTL/algorithm.h>
 #include <EASTL/utility.h>
 #include <EASTL/vector.h>
 
@@ -33,8 +34,88 @@
 namespace Urho3D
 {
 
+/// Handler storage of a signal. Handlers may subscribe and unsubscribe while the signal is being invoked.
+template<typename Handler>
+class SignalBase
+{
+public:
+    /// Unsubscribe all handlers of specified receiver from this events.
+    void Unsubscribe(RefCounted* receiver)
+    {
+        if (invokeDepth_)
+        {
+            // Handlers being invoked must stay in place, so only expire them. They are removed after the invocation
+            for (auto& pair : handlers_)
+            {
+                if (pair.first == receiver)
+                    pair.first.Reset();
+            }
+            RemoveHandlers(pendingHandlers_, receiver);
+        }
+        else
+            RemoveHandlers(handlers_, receiver);
+    }
+
+    /// Returns true when event has at least one subscriber.
+    bool HasSubscribers() const { return !handlers_.empty() || !pendingHandlers_.empty(); }
+
+protected:
+    /// Handler with its receiver.
+    using HandlerPair = ea::pair<WeakPtr<RefCounted>, Handler>;
+
+    /// Add handler. Handlers added during invocation are deferred until it finishes.
+    template<typename T>
+    void AddHandler(RefCounted* receiver, T&& handler)
+    {
+        (invokeDepth_ ? pendingHandlers_ : handlers_).emplace_back(WeakPtr<RefCounted>(receiver), ea::forward<T>(handler));
+    }
+
+    /// Call invoker for each live handler. Handlers for which the invoker returns false are unsubscribed.
+    template<typename Invoker>
+    void Invoke(const Invoker& invoker)
+    {
+        ++invokeDepth_;
+        // Handlers are not added or removed during invocation, so the vector is never reallocated here
+        for (unsigned i = 0; i < handlers_.size(); ++i)
+        {
+            HandlerPair& pair = handlers_[i];
+            if (RefCounted* receiver = pair.first.Get())
+            {
+                if (!invoker(pair.second, receiver))
+                    pair.first.Reset();
+            }
+        }
+
+        if (--invokeDepth_ == 0)
+        {
+            RemoveHandlers(handlers_, nullptr);
+            if (!pendingHandlers_.empty())
+            {
+                for (HandlerPair& pair : pendingHandlers_)
+                    handlers_.push_back(ea::move(pair));
+                pendingHandlers_.clear();
+            }
+        }
+    }
+
+    /// A collection of event handlers.
+    ea::vector<HandlerPair> handlers_;
+    /// Handlers added during invocation.
+    ea::vector<HandlerPair> pendingHandlers_;
+    /// Nesting depth of ongoing invocations.
+    unsigned invokeDepth_{};
+
+private:
+    /// Remove handlers of receiver and expired handlers.
+    static void RemoveHandlers(ea::vector<HandlerPair>& handlers, RefCounted* receiver)
+    {
+        handlers.erase(ea::remove_if(handlers.begin(), handlers.end(),
+            [receiver](const HandlerPair& pair) { return pair.first.Expired() || pair.first == receiver; }), handlers.end());
+    }
+};
+
 template<typename T, typename Sender=RefCounted>
-class Signal
+class Signal : public SignalBase<Function<bool(RefCounted*, Sender*, T&)>>
 {
 public:
     /// Signal handler type.
@@ -44,7 +125,7 @@ public:
     template<typename Receiver>
     void Subscribe(Receiver* receiver, void(Receiver::*handler)(Sender*, T&))
     {
-        handlers_.emplace_back(WeakPtr<RefCounted>(static_cast<RefCounted*>(receiver)),
+        this->AddHandler(static_cast<RefCounted*>(receiver),
             [handler](RefCounted* receiver, Sender* sender, T& args)
             {
                 (static_cast<Receiver*>(receiver)->*handler)(sender, args);
@@ -57,7 +138,7 @@ public:
     template<typename Receiver>
     void Subscribe(Receiver* receiver, bool(Receiver::*handler)(RefCounted*, T&))
     {
-        handlers_.emplace_back(WeakPtr<RefCounted>(static_cast<RefCounted*>(receiver)),
+        this->AddHandler(static_cast<RefCounted*>(receiver),
             [handler](RefCounted* receiver, Sender* sender, T& args)
             {
                 return (static_cast<Receiver*>(receiver)->*handler)(sender, args);
@@ -69,7 +150,7 @@ public:
     template<typename Receiver>
     void Subscribe(Receiver* receiver, void(Receiver::*handler)(T&))
     {
-        handlers_.emplace_back(WeakPtr<RefCounted>(static_cast<RefCounted*>(receiver)),
+        this->AddHandler(static_cast<RefCounted*>(receiver),
             [handler](RefCounted* receiver, Sender* sender, T& args)
             {
                 (static_cast<Receiver*>(receiver)->*handler)(args);
@@ -82,7 +163,7 @@ public:
     template<typename Receiver>
     void Subscribe(Receiver* receiver, bool(Receiver::*handler)(T&))
     {
-        handlers_.emplace_back(WeakPtr<RefCounted>(static_cast<RefCounted*>(receiver)),
+        this->AddHandler(static_cast<RefCounted*>(receiver),
             [handler](RefCounted* receiver, Sender* sender, T& args)
             {
                 return (static_cast<Receiver*>(receiver)->*handler)(args);
@@ -90,47 +171,15 @@ public:
         );
     }
 
-    /// Unsubscribe all handlers of specified receiver from this events.
-    void Unsubscribe(RefCounted* receiver)
-    {
-        for (auto it = handlers_.begin(); it != handlers_.end();)
-        {
-            ea::pair<WeakPtr<RefCounted>, Handler>& pair = *it;
-            if (pair.first.Expired() || pair.first == receiver)
-                it = handlers_.erase(it);
-            else
-                ++it;
-        }
-    }
-
     /// Invoke event.
     void operator()(Sender* sender, T& args)
     {
-        for (auto it = handlers_.begin(); it != handlers_.end();)
-        {
-            ea::pair<WeakPtr<RefCounted>, Handler>& pair = *it;
-            if (RefCounted* receiver = pair.first.Get())
-            {
-                if (pair.second(receiver, sender, args))
-                    ++it;
-                else
-                    it = handlers_.erase(it);
-            }
-            else
-                it = handlers_.erase(it);
-        }
+        this->Invoke([sender, &args](Handler& handler, RefCounted* receiver) { return handler(receiver, sender, args); });
     }
-
-    /// Returns true when event has at least one subscriber.
-    bool HasSubscribers() const { return !handlers_.empty(); }
-
-protected:
-    /// A collection of event handlers.
-    ea::vector<ea::pair<WeakPtr<RefCounted>, Handler>> handlers_;
 };
 
 template<typename Sender>
-class Signal<void, Sender>
+class Signal<void, Sender> : public SignalBase<Function<bool(RefCounted*, Sender*)>>
 {
 public:
     /// Signal handler type.
@@ -140,7 +189,7 @@ public:
     template<typename Receiver>
     void Subscribe(Receiver* receiver, void(Receiver::*handler)(Sender*))
     {
-        handlers_.emplace_back(WeakPtr<RefCounted>(static_cast<RefCounted*>(receiver)),
+        this->AddHandler(static_cast<RefCounted*>(receiver),
             [handler](RefCounted* receiver, Sender* sender)
             {
                 (static_cast<Receiver*>(receiver)->*handler)(sender);
@@ -153,7 +202,7 @@ public:
     template<typename Receiver>
     void Subscribe(Receiver* receiver, bool(Receiver::*handler)(RefCounted*))
     {
-        handlers_.emplace_back(WeakPtr<RefCounted>(static_cast<RefCounted*>(receiver)),
+        this->AddHandler(static_cast<RefCounted*>(receiver),
             [handler](RefCounted* receiver, Sender* sender)
             {
                 return (static_cast<Receiver*>(receiver)->*handler)(sender);
@@ -165,7 +214,7 @@ public:
     template<typename Receiver>
     void Subscribe(Receiver* receiver, void(Receiver::*handler)())
     {
-        handlers_.emplace_back(WeakPtr<RefCounted>(static_cast<RefCounted*>(receiver)),
+        this->AddHandler(static_cast<RefCounted*>(receiver),
             [handler](RefCounted* receiver, Sender* sender)
             {
                 (static_cast<Receiver*>(receiver)->*handler)();
@@ -178,7 +227,7 @@ public:
     template<typename Receiver>
     void Subscribe(Receiver* receiver, bool(Receiver::*handler)())
     {
-        handlers_.emplace_back(WeakPtr<RefCounted>(static_cast<RefCounted*>(receiver)),
+        this->AddHandler(static_cast<RefCounted*>(receiver),
             [handler](RefCounted* receiver, Sender* sender)
             {
                 return (static_cast<Receiver*>(receiver)->*handler)();
@@ -186,43 +235,11 @@ public:
         );
     }
 
-    /// Unsubscribe all handlers of specified receiver from this events.
-    void Unsubscribe(RefCounted* receiver)
-    {
-        for (auto it = handlers_.begin(); it != handlers_.end();)
-        {
-            ea::pair<WeakPtr<RefCounted>, Handler>& pair = *it;
-            if (pair.first.Expired() || pair.first == receiver)
-                it = handlers_.erase(it);
-            else
-                ++it;
-        }
-    }
-
     /// Invoke event.
     void operator()(Sender* sender)
     {
-        for (auto it = handlers_.begin(); it != handlers_.end();)
-        {
-            ea::pair<WeakPtr<RefCounted>, Handler>& pair = *it;
-            if (RefCounted* receiver = pair.first.Get())
-            {
-                if (pair.second(receiver, sender))
-                    ++it;
-                else
-                    it = handlers_.erase(it);
-            }
-            else
-                it = handlers_.erase(it);
-        }
+        this->Invoke([sender](Handler& handler, RefCounted* receiver) { return handler(receiver, sender); });
     }
-
-    /// Returns true when event has at least one subscriber.
-    bool HasSubscribers() const { return !handlers_.empty(); }
-
-protected:
-    /// A collection of event handlers.
-    ea::vector<ea::pair<WeakPtr<RefCounted>, Handler>> handlers_;
 };
 
 }
@@ -72,28 +72,7 @@ Variant Spline::GetPoint(float f) const
     case LINEAR_CURVE:
         return LinearInterpolation(knots_, f);
     case CATMULL_ROM_FULL_CURVE:
-        {
-            /// \todo Do not allocate a new vector each time
-            ea::vector<Variant> fullKnots;
-            if (knots_.size() > 1)
-            {
-                // Non-cyclic case: duplicate start and end
-                if (knots_.front() != knots_.back())
-                {
-                    fullKnots.push_back(knots_.front());
-                    fullKnots.push_back(knots_);
-                    fullKnots.push_back(knots_.back());
-                }
-                // Cyclic case: smooth the tangents
-                else
-                {
-                    fullKnots.push_back(knots_[knots_.size() - 2]);
-                    fullKnots.push_back(knots_);
-                    fullKnots.push_back(knots_[1]);
-                }
-            }
-            return CatmullRomInterpolation(fullKnots, f);
-        }
+        return CatmullRomFullInterpolation(f);
 
     default:
         URHO3D_LOGERROR("Unsupported interpolation mode");
@@ -142,43 +121,30 @@ void Spline::AddKnot(const Variant& knot, unsigned index)
 
 Variant Spline::BezierInterpolation(const ea::vector<Variant>& knots, float t) const
 {
-    if (knots.size() == 2)
+    switch (knots[0].GetType())
     {
-        switch (knots[0].GetType())
-        {
-        case VAR_FLOAT:
-        case VAR_VECTOR2:
-        case VAR_VECTOR3:
-        case VAR_VECTOR4:
-        case VAR_COLOR:
-        case VAR_DOUBLE:
-            return LinearInterpolation(knots[0], knots[1], t);
-        default:
-            return Variant::EMPTY;
-        }
+    case VAR_FLOAT:
+    case VAR_VECTOR2:
+    case VAR_VECTOR3:
+    case VAR_VECTOR4:
+    case VAR_COLOR:
+    case VAR_DOUBLE:
+        break;
+    default:
+        return Variant::EMPTY;
     }
-    else
+
+    if (knots.size() == 2)
+        return LinearInterpolation(knots[0], knots[1], t);
+
+    // De Casteljau's algorithm, collapsing the control polygon in place instead of allocating a vector per level
+    ea::vector<Variant> interpolatedKnots(knots);
+    for (unsigned level = knots.size() - 1; level > 0; --level)
     {
-        /// \todo Do not allocate a new vector each time
-        ea::vector<Variant> interpolatedKnots;
-        for (unsigned i = 1; i < knots.size(); i++)
-        {
-            switch (knots[0].GetType())
-            {
-            case VAR_FLOAT:
-            case VAR_VECTOR2:
-            case VAR_VECTOR3:
-            case VAR_VECTOR4:
-            case VAR_COLOR:
-            case VAR_DOUBLE:
-                interpolatedKnots.push_back(LinearInterpolation(knots[i - 1], knots[i], t));
-                break;
-            default:
-                return Variant::EMPTY;
-            }
-        }
-        return BezierInterpolation(interpolatedKnots, t);
+        for (unsigned i = 0; i < level; ++i)
+            interpolatedKnots[i] = LinearInterpolation(interpolatedKnots[i], interpolatedKnots[i + 1], t);
     }
+    return interpolatedKnots[0];
 }
 
 template <typename T> Variant CalculateCatmullRom(const T& p0, const T& p1, const T& p2, const T& p3, float t, float t2, float t3)
@@ -199,32 +165,57 @@ Variant Spline::CatmullRomInterpolation(const ea::vector<Variant>& knots, float
 
         auto originIndex = static_cast<int>(t * (knots.size() - 3));
         t = fmodf(t * (knots.size() - 3), 1.f);
-        float t2 = t * t;
-        float t3 = t2 * t;
+        return CatmullRomInterpolation(knots[originIndex], knots[originIndex + 1], knots[originIndex + 2],
+            knots[originIndex + 3], t);
+    }
+}
 
-        switch (knots[originIndex].GetType())
-        {
-        case VAR_FLOAT:
-            return CalculateCatmullRom(knots[originIndex].GetFloat(), knots[originIndex + 1].GetFloat(),
-                knots[originIndex + 2].GetFloat(), knots[originIndex + 3].GetFloat(), t, t2, t3);
-        case VAR_VECTOR2:
-            return CalculateCatmullRom(knots[originIndex].GetVector2(), knots[originIndex + 1].GetVector2(),
-                knots[originIndex + 2].GetVector2(), knots[originIndex + 3].GetVector2(), t, t2, t3);
-        case VAR_VECTOR3:
-            return CalculateCatmullRom(knots[originIndex].GetVector3(), knots[originIndex + 1].GetVector3(),
-                knots[originIndex + 2].GetVector3(), knots[originIndex + 3].GetVector3(), t, t2, t3);
-        case VAR_VECTOR4:
-            return CalculateCatmullRom(knots[originIndex].GetVector4(), knots[originIndex + 1].GetVector4(),
-                knots[originIndex + 2].GetVector4(), knots[originIndex + 3].GetVector4(), t, t2, t3);
-        case VAR_COLOR:
-            return CalculateCatmullRom(knots[originIndex].GetColor(), knots[originIndex + 1].GetColor(),
-                knots[originIndex + 2].GetColor(), knots[originIndex + 3].GetColor(), t, t2, t3);
-        case VAR_DOUBLE:
-            return CalculateCatmullRom(knots[originIndex].GetDouble(), knots[originIndex + 1].GetDouble(),
-                knots[originIndex + 2].GetDouble(), knots[originIndex + 3].GetDouble(), t, t2, t3);
-        default:
-            return Variant::EMPTY;
-        }
+Variant Spline::CatmullRomFullInterpolation(float t) const
+{
+    // Address the knots as if the start and end were padded, without building the padded vector
+    const unsigned numKnots = knots_.size();
+    const bool cyclic = knots_.front() == knots_.back();
+    const auto getKnot = [&](unsigned index) -> const Variant&
+    {
+        if (index == 0)
+            return cyclic ? knots_[numKnots - 2] : knots_.front();
+        else if (index > numKnots)
+            return cyclic ? knots_[1] : knots_.back();
+        else
+            return knots_[index - 1];
+    };
+
+    if (t >= 1.f)
+        return knots_.back();
+
+    auto originIndex = static_cast<unsigned>(t * (numKnots - 1));
+    t = fmodf(t * (numKnots - 1), 1.f);
+    return CatmullRomInterpolation(getKnot(originIndex), getKnot(originIndex + 1), getKnot(originIndex + 2),
+        getKnot(originIndex + 3), t);
+}
+
+Variant Spline::CatmullRomInterpolation(const Variant& p0, const Variant& p1, const Variant& p2, const Variant& p3,
+    float t) const
+{
+    float t2 = t * t;
+    float t3 = t2 * t;
+
+    switch (p0.GetType())
+    {
+    case VAR_FLOAT:
+        return CalculateCatmullRom(p0.GetFloat(), p1.GetFloat(), p2.GetFloat(), p3.GetFloat(), t, t2, t3);
+    case VAR_VECTOR2:
+        return CalculateCatmullRom(p0.GetVector2(), p1.GetVector2(), p2.GetVector2(), p3.GetVector2(), t, t2, t3);
+    case VAR_VECTOR3:
+        return CalculateCatmullRom(p0.GetVector3(), p1.GetVector3(), p2.GetVector3(), p3.GetVector3(), t, t2, t3);
+    case VAR_VECTOR4:
+        return CalculateCatmullRom(p0.GetVector4(), p1.GetVector4(), p2.GetVector4(), p3.GetVector4(), t, t2, t3);
+    case VAR_COLOR:
+        return CalculateCatmullRom(p0.GetColor(), p1.GetColor(), p2.GetColor(), p3.GetColor(), t, t2, t3);
+    case VAR_DOUBLE:
+        return CalculateCatmullRom(p0.GetDouble(), p1.GetDouble(), p2.GetDouble(), p3.GetDouble(), t, t2, t3);
+    default:
+        return Variant::EMPTY;
     }
 }
 
@@ -112,6 +112,10 @@ private:
     Variant BezierInterpolation(const ea::vector<Variant>& knots, float t) const;
     /// Perform Spline interpolation on the spline.
     Variant CatmullRomInterpolation(const ea::vector<Variant>& knots, float t) const;
+    /// Perform Spline interpolation on the spline with duplicated or looped start and end knots.
+    Variant CatmullRomFullInterpolation(float t) const;
+    /// Perform Spline interpolation on a single segment defined by four knots.
+    Variant CatmullRomInterpolation(const Variant& p0, const Variant& p1, const Variant& p2, const Variant& p3, float t) const;
     /// Perform linear interpolation on the spline.
     Variant LinearInterpolation(const ea::vector<Variant>& knots, float t) const;
     /// Linear interpolation between two Variants based on underlying type.
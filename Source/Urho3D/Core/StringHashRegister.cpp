@@ -33,10 +33,29 @@
 namespace Urho3D
 {
 
+namespace
+{
+
+/// Initial capacity of the interned string table.
+static const unsigned INITIAL_TABLE_CAPACITY = 256;
+
+}
+
+StringHashRegister::Table::Table(unsigned capacity) :
+    mask_(capacity - 1),
+    slots_(new std::atomic<Entry*>[capacity])
+{
+    for (unsigned i = 0; i < capacity; ++i)
+        slots_[i].store(nullptr, std::memory_order_relaxed);
+}
+
 StringHashRegister::StringHashRegister(bool threadSafe)
 {
     if (threadSafe)
         mutex_ = ea::make_unique<Mutex>();
+
+    tables_.push_back(ea::make_unique<Table>(INITIAL_TABLE_CAPACITY));
+    table_.store(tables_.back().get(), std::memory_order_release);
 }
 
 
@@ -45,20 +64,58 @@ StringHashRegister::~StringHashRegister()       // NOLINT(hicpp-use-equals-defau
     // Keep destructor here to let mutex_ destruct
 }
 
+const StringHashRegister::Entry* StringHashRegister::Find(const StringHash& hash) const
+{
+    const Table* table = table_.load(std::memory_order_acquire);
+    for (unsigned index = hash.Value() & table->mask_;; index = (index + 1) & table->mask_)
+    {
+        const Entry* entry = table->slots_[index].load(std::memory_order_acquire);
+        if (!entry || entry->hash_ == hash)
+            return entry;
+    }
+}
+
+void StringHashRegister::Insert(Table& table, Entry* entry)
+{
+    unsigned index = entry->hash_.Value() & table.mask_;
+    while (table.slots_[index].load(std::memory_order_relaxed))
+        index = (index + 1) & table.mask_;
+    table.slots_[index].store(entry, std::memory_order_release);
+}
+
 StringHash StringHashRegister::RegisterString(const StringHash& hash, ea::string_view string)
 {
+    // Fast path for strings already registered
+    if (const Entry* entry = Find(hash))
+    {
+        if (ea::string_view(entry->string_) != string)
+        {
+            URHO3D_LOGWARNINGF("StringHash collision detected! Both \"%s\" and \"%s\" have hash #%s",
+                string, entry->string_.c_str(), hash.ToString().c_str());
+        }
+        return hash;
+    }
+
     if (mutex_)
         mutex_->Acquire();
 
-    auto iter = map_.find(hash);
-    if (iter == map_.end())
+    // Check again, another thread may have registered the string meanwhile
+    if (!Find(hash))
     {
-        map_.populate(hash, ea::string(string));
-    }
-    else if (ea::string_view(iter->second) != string)
-    {
-        URHO3D_LOGWARNINGF("StringHash collision detected! Both \"%s\" and \"%s\" have hash #%s",
-            string, iter->second.c_str(), hash.ToString().c_str());
+        Table* table = table_.load(std::memory_order_relaxed);
+        if ((entries_.size() + 1) * 2 > table->mask_ + 1)
+        {
+            // Grow and publish the new table only when it is complete
+            tables_.push_back(ea::make_unique<Table>((table->mask_ + 1) * 2));
+            table = tables_.back().get();
+            for (const auto& entry : entries_)
+                Insert(*table, entry.get());
+            table_.store(table, std::memory_order_release);
+        }
+
+        entries_.push_back(ea::make_unique<Entry>(Entry{hash, ea::string(string)}));
+        Insert(*table, entries_.back().get());
+        map_.populate(hash, entries_.back()->string_);
     }
 
     if (mutex_)
@@ -75,34 +132,18 @@ StringHash StringHashRegister::RegisterString(ea::string_view string)
 
 ea::string StringHashRegister::GetStringCopy(const StringHash& hash) const
 {
-    if (mutex_)
-        mutex_->Acquire();
-
-    const ea::string copy = GetString(hash);
-
-    if (mutex_)
-        mutex_->Release();
-
-    return copy;
+    return GetString(hash);
 }
 
 bool StringHashRegister::Contains(const StringHash& hash) const
 {
-    if (mutex_)
-        mutex_->Acquire();
-
-    const bool contains = map_.contains(hash);
-
-    if (mutex_)
-        mutex_->Release();
-
-    return contains;
+    return Find(hash) != nullptr;
 }
 
 const ea::string& StringHashRegister::GetString(const StringHash& hash) const
 {
-    auto iter = map_.find(hash);
-    return iter == map_.end() ? EMPTY_STRING : iter->second;
+    const Entry* entry = Find(hash);
+    return entry ? entry->string_ : EMPTY_STRING;
 }
 
 }
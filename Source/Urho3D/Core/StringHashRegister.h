@@ -23,6 +23,9 @@
 #pragma once
 
 #include <EASTL/unique_ptr.h>
+#include <EASTL/vector.h>
+
+#include <atomic>
 
 #include "../Container/Str.h"
 #include "../Core/Variant.h"
@@ -34,7 +37,8 @@ namespace Urho3D
 class Mutex;
 class StringHash;
 
-/// Helper class used for StringHash reversing.
+/// Helper class used for StringHash reversing. Registered strings are interned for the lifetime of the register.
+/// Lookups are lock-free, only registering a new string takes the lock.
 class URHO3D_API StringHashRegister
 {
 public:
@@ -52,12 +56,43 @@ public:
     /// Return whether the string in contained in the register.
     bool Contains(const StringHash& hash) const;
 
-    /// Return String for given StringHash. Return value is unsafe to use if RegisterString is called from other threads.
+    /// Return String for given StringHash. Return empty string if not found. Returned string stays valid as long as the register.
     const ea::string& GetString(const StringHash& hash) const;
     /// Return map of hashes. Return value is unsafe to use if RegisterString is called from other threads.
     const StringMap& GetInternalMap() const { return map_; }
 
 private:
+    /// Interned string.
+    struct Entry
+    {
+        /// Hash of the string.
+        StringHash hash_;
+        /// String.
+        ea::string string_;
+    };
+    /// Open addressing hash table of interned strings. Slots are only ever filled, never cleared.
+    struct Table
+    {
+        /// Construct with capacity, must be power of two.
+        explicit Table(unsigned capacity);
+
+        /// Capacity minus one.
+        unsigned mask_;
+        /// Slots.
+        ea::unique_ptr<std::atomic<Entry*>[]> slots_;
+    };
+
+    /// Find interned string without locking. Return null if not found.
+    const Entry* Find(const StringHash& hash) const;
+    /// Insert interned string into the table. Must be called with the lock held.
+    static void Insert(Table& table, Entry* entry);
+
+    /// Current table. Replaced with a bigger one when filled more than half.
+    std::atomic<Table*> table_;
+    /// All tables ever used. Retired tables are kept alive because lock-free readers may still access them.
+    ea::vector<ea::unique_ptr<Table> > tables_;
+    /// Interned strings.
+    ea::vector<ea::unique_ptr<Entry> > entries_;
     /// Hash to string map.
     StringMap map_;
     /// Mutex.
@@ -0,0 +1,156 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/TaskGraph.h"
+
+#include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
+
+namespace Urho3D
+{
+
+TaskGraph::TaskGraph(WorkQueue* workQueue)
+    : workQueue_(workQueue)
+{
+}
+
+TaskGraph::~TaskGraph()
+{
+    assert(!running_ || IsCompleted());
+}
+
+unsigned TaskGraph::AddTask(const ea::string& name, std::function<void(unsigned)> work)
+{
+    assert(!running_);
+
+    TaskGraphTask& task = tasks_.emplace_back();
+    task.name_ = name;
+    task.work_ = ea::move(work);
+    return tasks_.size() - 1;
+}
+
+void TaskGraph::AddDependency(unsigned task, unsigned predecessor)
+{
+    assert(!running_);
+    assert(task < tasks_.size() && predecessor < tasks_.size() && task != predecessor);
+
+    tasks_[predecessor].successors_.push_back(task);
+    ++tasks_[task].numPredecessors_;
+}
+
+void TaskGraph::SetContinuation(unsigned task, std::function<void()> continuation)
+{
+    assert(!running_);
+    tasks_[task].continuation_ = ea::move(continuation);
+}
+
+void TaskGraph::Clear()
+{
+    assert(!running_ || IsCompleted());
+
+    tasks_.clear();
+    taskItems_.clear();
+    numCompleted_ = 0;
+    running_ = false;
+}
+
+void TaskGraph::Run(unsigned priority)
+{
+    assert(!running_ || IsCompleted());
+
+    const unsigned numTasks = tasks_.size();
+    running_ = true;
+    numCompleted_ = 0;
+    if (numTasks == 0)
+        return;
+
+    // Reset dependency counters. All tasks are registered with the work queue up front so that Complete() waits for them,
+    // but only root tasks are queued for execution now
+    pendingPredecessors_ = ea::make_unique<std::atomic<unsigned>[]>(numTasks);
+    taskItems_.resize(numTasks);
+    bool hasRootTask = false;
+    for (unsigned i = 0; i < numTasks; ++i)
+    {
+        pendingPredecessors_[i] = tasks_[i].numPredecessors_;
+        hasRootTask |= tasks_[i].numPredecessors_ == 0;
+
+        SharedPtr<WorkItem> item = workQueue_->GetFreeItem();
+        item->priority_ = priority;
+        item->aux_ = this;
+        item->start_ = reinterpret_cast<void*>(static_cast<uintptr_t>(i));
+        item->workFunction_ = [](const WorkItem* item, unsigned threadIndex)
+        {
+            const auto task = static_cast<unsigned>(reinterpret_cast<uintptr_t>(item->start_));
+            static_cast<TaskGraph*>(item->aux_)->ExecuteTask(task, threadIndex);
+        };
+        taskItems_[i] = item;
+    }
+
+    if (!hasRootTask)
+    {
+        assert(0 && "Task graph has no root tasks");
+        taskItems_.clear();
+        return;
+    }
+
+    for (unsigned i = 0; i < numTasks; ++i)
+        workQueue_->AddPendingWorkItem(taskItems_[i]);
+    for (unsigned i = 0; i < numTasks; ++i)
+    {
+        if (tasks_[i].numPredecessors_ == 0)
+            workQueue_->QueuePendingWorkItem(taskItems_[i], 0);
+    }
+}
+
+void TaskGraph::RunAndComplete(unsigned priority)
+{
+    Run(priority);
+    workQueue_->Complete(priority);
+    running_ = false;
+}
+
+void TaskGraph::ExecuteTask(unsigned taskIndex, unsigned threadIndex)
+{
+    TaskGraphTask& task = tasks_[taskIndex];
+    {
+        URHO3D_PROFILE("TaskGraphTask");
+        URHO3D_PROFILE_ZONENAME(task.name_.c_str(), task.name_.length());
+
+        if (task.work_)
+            task.work_(threadIndex);
+        if (task.continuation_)
+            task.continuation_();
+    }
+
+    ++numCompleted_;
+
+    // Queue successors whose last predecessor was this task
+    for (unsigned successor : task.successors_)
+    {
+        if (--pendingPredecessors_[successor] == 0)
+            workQueue_->QueuePendingWorkItem(taskItems_[successor], threadIndex);
+    }
+}
+
+}
@@ -0,0 +1,107 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include "../Container/Ptr.h"
+#include "../Core/NonCopyable.h"
+
+#include <EASTL/string.h>
+#include <EASTL/unique_ptr.h>
+#include <EASTL/vector.h>
+
+#include <atomic>
+#include <functional>
+
+namespace Urho3D
+{
+
+class WorkQueue;
+struct WorkItem;
+
+/// Task graph node.
+struct URHO3D_API TaskGraphTask
+{
+    /// Task name. Used as profiler zone name.
+    ea::string name_;
+    /// Work function. Called with the thread index (0 = main thread) as parameter.
+    std::function<void(unsigned)> work_;
+    /// Optional continuation. Called on the same thread right after the work function, before successors are released.
+    std::function<void()> continuation_;
+    /// Indices of tasks depending on this task.
+    ea::vector<unsigned> successors_;
+    /// Number of tasks this task depends on.
+    unsigned numPredecessors_{};
+};
+
+/// Acyclic graph of tasks with dependencies executed on the work queue. Each task is a work item that is queued by its last completed predecessor, without global barriers between stages.
+/// Task functions must not call WorkQueue::Complete().
+class URHO3D_API TaskGraph : private NonCopyable
+{
+public:
+    /// Construct.
+    explicit TaskGraph(WorkQueue* workQueue);
+    /// Destruct. Graph must not be running.
+    ~TaskGraph();
+
+    /// Add task. Return task index.
+    unsigned AddTask(const ea::string& name, std::function<void(unsigned)> work);
+    /// Add dependency. Task will not start until predecessor is completed.
+    void AddDependency(unsigned task, unsigned predecessor);
+    /// Set continuation for task.
+    void SetContinuation(unsigned task, std::function<void()> continuation);
+    /// Remove all tasks. Graph must not be running.
+    void Clear();
+
+    /// Submit graph to the work queue. Call WorkQueue::Complete() with the same or lower priority to wait for completion.
+    void Run(unsigned priority);
+    /// Submit graph to the work queue and wait for completion.
+    void RunAndComplete(unsigned priority);
+
+    /// Return number of tasks.
+    unsigned GetNumTasks() const { return tasks_.size(); }
+    /// Return task.
+    const TaskGraphTask& GetTask(unsigned task) const { return tasks_[task]; }
+    /// Return whether all tasks are completed.
+    bool IsCompleted() const { return numCompleted_ == tasks_.size(); }
+
+private:
+    /// Execute task and queue its successors. Called by the work items.
+    void ExecuteTask(unsigned task, unsigned threadIndex);
+
+    /// Work queue.
+    WorkQueue* workQueue_{};
+    /// Tasks.
+    ea::vector<TaskGraphTask> tasks_;
+    /// Number of not yet completed predecessors per task. Valid while running.
+    ea::unique_ptr<std::atomic<unsigned>[]> pendingPredecessors_;
+    /// Work items per task. Valid while running.
+    ea::vector<SharedPtr<WorkItem>> taskItems_;
+    /// Number of completed tasks.
+    std::atomic<unsigned> numCompleted_{};
+    /// Whether the graph is running.
+    bool running_{};
+};
+
+}
@@ -247,4 +247,11 @@ void HiresTimer::Reset()
     startTime_ = HiresTick();
 }
 
+long long HiresTimer::GetTimestamp()
+{
+    // Split the conversion to avoid overflow of large tick values
+    const long long currentTime = HiresTick();
+    return currentTime / frequency * 1000000LL + currentTime % frequency * 1000000LL / frequency;
+}
+
 }
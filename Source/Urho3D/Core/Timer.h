@@ -65,6 +65,8 @@ public:
 
     /// Return high-resolution timer frequency if supported.
     static long long GetFrequency() { return frequency; }
+    /// Return current high-resolution clock value in microseconds. Comparable between threads, but has an arbitrary origin.
+    static long long GetTimestamp();
 
 private:
     /// Starting clock value in CPU ticks.
@@ -120,11 +120,11 @@ Variant& Variant::operator =(const Variant& rhs)
         break;
 
     case VAR_MATRIX3:
-        *value_.matrix3_ = *rhs.value_.matrix3_;
+        value_.matrix3_ = rhs.value_.matrix3_;
         break;
 
     case VAR_MATRIX3X4:
-        *value_.matrix3x4_ = *rhs.value_.matrix3x4_;
+        value_.matrix3x4_ = rhs.value_.matrix3x4_;
         break;
 
     case VAR_MATRIX4:
@@ -215,10 +215,10 @@ bool Variant::operator ==(const Variant& rhs) const
         return value_.intVector3_ == rhs.value_.intVector3_;
 
     case VAR_MATRIX3:
-        return *value_.matrix3_ == *rhs.value_.matrix3_;
+        return value_.matrix3_ == rhs.value_.matrix3_;
 
     case VAR_MATRIX3X4:
-        return *value_.matrix3x4_ == *rhs.value_.matrix3x4_;
+        return value_.matrix3x4_ == rhs.value_.matrix3x4_;
 
     case VAR_MATRIX4:
         return *value_.matrix4_ == *rhs.value_.matrix4_;
@@ -587,10 +587,10 @@ ea::string Variant::ToString() const
         return value_.intVector3_.ToString();
 
     case VAR_MATRIX3:
-        return value_.matrix3_->ToString();
+        return value_.matrix3_.ToString();
 
     case VAR_MATRIX3X4:
-        return value_.matrix3x4_->ToString();
+        return value_.matrix3x4_.ToString();
 
     case VAR_MATRIX4:
         return value_.matrix4_->ToString();
@@ -689,10 +689,10 @@ bool Variant::IsZero() const
         return value_.weakPtr_ == nullptr;
 
     case VAR_MATRIX3:
-        return *value_.matrix3_ == Matrix3::IDENTITY;
+        return value_.matrix3_ == Matrix3::IDENTITY;
 
     case VAR_MATRIX3X4:
-        return *value_.matrix3x4_ == Matrix3x4::IDENTITY;
+        return value_.matrix3x4_ == Matrix3x4::IDENTITY;
 
     case VAR_MATRIX4:
         return *value_.matrix4_ == Matrix4::IDENTITY;
@@ -750,14 +750,6 @@ void Variant::SetType(VariantType newType)
         value_.weakPtr_.~WeakPtr<RefCounted>();
         break;
 
-    case VAR_MATRIX3:
-        delete value_.matrix3_;
-        break;
-
-    case VAR_MATRIX3X4:
-        delete value_.matrix3x4_;
-        break;
-
     case VAR_MATRIX4:
         delete value_.matrix4_;
         break;
@@ -807,11 +799,11 @@ void Variant::SetType(VariantType newType)
         break;
 
     case VAR_MATRIX3:
-        value_.matrix3_ = new Matrix3();
+        new(&value_.matrix3_) Matrix3();
         break;
 
     case VAR_MATRIX3X4:
-        value_.matrix3x4_ = new Matrix3x4();
+        new(&value_.matrix3x4_) Matrix3x4();
         break;
 
     case VAR_MATRIX4:
@@ -368,8 +368,8 @@ private:
     T value_;
 };
 
-/// Size of variant value. 16 bytes on 32-bit platform, 32 bytes on 64-bit platform.
-static const unsigned VARIANT_VALUE_SIZE = sizeof(void*) * 4;
+/// Size of variant value. Large enough to store a Matrix3x4 inline, or four pointers if larger.
+static const unsigned VARIANT_VALUE_SIZE = sizeof(Matrix3x4) > sizeof(void*) * 4 ? sizeof(Matrix3x4) : sizeof(void*) * 4;
 
 /// Checks whether the custom variant type could be stored on stack.
 template <class T> constexpr bool IsCustomTypeOnStack() { return sizeof(CustomVariantValueImpl<T>) <= VARIANT_VALUE_SIZE; }
@@ -392,8 +392,8 @@ union VariantValue
     IntVector2 intVector2_;
     IntVector3 intVector3_;
     IntRect intRect_;
-    Matrix3* matrix3_;
-    Matrix3x4* matrix3x4_;
+    Matrix3 matrix3_;
+    Matrix3x4 matrix3x4_;
     Matrix4* matrix4_;
     Quaternion quaternion_;
     Color color_;
@@ -885,7 +885,7 @@ public:
     Variant& operator =(const Matrix3& rhs)
     {
         SetType(VAR_MATRIX3);
-        *value_.matrix3_ = rhs;
+        value_.matrix3_ = rhs;
         return *this;
     }
 
@@ -893,7 +893,7 @@ public:
     Variant& operator =(const Matrix3x4& rhs)
     {
         SetType(VAR_MATRIX3X4);
-        *value_.matrix3x4_ = rhs;
+        value_.matrix3x4_ = rhs;
         return *this;
     }
 
@@ -1052,13 +1052,13 @@ public:
     /// Test for equality with a Matrix3. To return true, both the type and value must match.
     bool operator ==(const Matrix3& rhs) const
     {
-        return type_ == VAR_MATRIX3 ? *value_.matrix3_ == rhs : false;
+        return type_ == VAR_MATRIX3 ? value_.matrix3_ == rhs : false;
     }
 
     /// Test for equality with a Matrix3x4. To return true, both the type and value must match.
     bool operator ==(const Matrix3x4& rhs) const
     {
-        return type_ == VAR_MATRIX3X4 ? *value_.matrix3x4_ == rhs : false;
+        return type_ == VAR_MATRIX3X4 ? value_.matrix3x4_ == rhs : false;
     }
 
     /// Test for equality with a Matrix4. To return true, both the type and value must match.
@@ -1379,13 +1379,13 @@ public:
     /// Return a Matrix3 or identity on type mismatch.
     const Matrix3& GetMatrix3() const
     {
-        return type_ == VAR_MATRIX3 ? *value_.matrix3_ : Matrix3::IDENTITY;
+        return type_ == VAR_MATRIX3 ? value_.matrix3_ : Matrix3::IDENTITY;
     }
 
     /// Return a Matrix3x4 or identity on type mismatch.
     const Matrix3x4& GetMatrix3x4() const
     {
-        return type_ == VAR_MATRIX3X4 ? *value_.matrix3x4_ : Matrix3x4::IDENTITY;
+        return type_ == VAR_MATRIX3X4 ? value_.matrix3x4_ : Matrix3x4::IDENTITY;
     }
 
     /// Return a Matrix4 or identity on type mismatch.
@@ -30,6 +30,8 @@
 #include "../Core/WorkQueue.h"
 #include "../IO/Log.h"
 
+#include <thread>
+
 namespace Urho3D
 {
 
@@ -63,16 +65,59 @@ private:
     unsigned index_;
 };
 
+void WorkItemDeque::Push(WorkItem* item)
+{
+    MutexLock lock(mutex_);
+
+    // Find position for new item
+    auto i = items_.begin();
+    while (i != items_.end() && (*i)->priority_ > item->priority_)
+        ++i;
+    items_.insert(i, item);
+    ++size_;
+}
+
+WorkItem* WorkItemDeque::Pop(unsigned minPriority)
+{
+    // Fast check without locking
+    if (!size_)
+        return nullptr;
+
+    MutexLock lock(mutex_);
+    if (items_.empty() || items_.front()->priority_ < minPriority)
+        return nullptr;
+
+    WorkItem* item = items_.front();
+    items_.pop_front();
+    --size_;
+    return item;
+}
+
+bool WorkItemDeque::Remove(WorkItem* item)
+{
+    MutexLock lock(mutex_);
+    auto i = ea::find(items_.begin(), items_.end(), item);
+    if (i == items_.end())
+        return false;
+
+    items_.erase(i);
+    --size_;
+    return true;
+}
+
 WorkQueue::WorkQueue(Context* context) :
     Object(context),
+    numQueued_(0),
+    nextQueue_(0),
     shutDown_(false),
-    pausing_(false),
     paused_(false),
     completing_(false),
     tolerance_(10),
     lastSize_(0),
     maxNonThreadedWorkMs_(5)
 {
+    // Main thread queue always exists
+    queues_.emplace_back(ea::make_unique<WorkItemDeque>());
     SubscribeToEvent(E_BEGINFRAME, URHO3D_HANDLER(WorkQueue, HandleBeginFrame));
 }
 
@@ -97,6 +142,10 @@ void WorkQueue::CreateThreads(unsigned numThreads)
     // Start threads in paused mode
     Pause();
 
+    // Create queues before running the threads, as worker threads may steal from any queue
+    for (unsigned i = 0; i < numThreads; ++i)
+        queues_.emplace_back(ea::make_unique<WorkItemDeque>());
+
     for (unsigned i = 0; i < numThreads; ++i)
     {
         SharedPtr<WorkerThread> thread(new WorkerThread(this, i + 1));
@@ -113,7 +162,7 @@ SharedPtr<WorkItem> WorkQueue::GetFreeItem()
 {
     if (!poolItems_.empty())
     {
-        SharedPtr<WorkItem> item = poolItems_.front();
+        SharedPtr<WorkItem> item = ea::move(poolItems_.front());
         poolItems_.pop_front();
         return item;
     }
@@ -142,36 +191,61 @@ void WorkQueue::AddWorkItem(const SharedPtr<WorkItem>& item)
     workItems_.push_back(item);
     item->completed_ = false;
 
-    // Make sure worker threads' list is safe to modify
-    if (threads_.size() && !paused_)
-        queueMutex_.Acquire();
+    QueueItem(item.Get());
+}
 
-    // Find position for new item
-    if (queue_.empty())
-        queue_.push_back(item.Get());
-    else
-    {
-        bool inserted = false;
+void WorkQueue::AddPendingWorkItem(const SharedPtr<WorkItem>& item)
+{
+    assert(ea::find(workItems_.begin(), workItems_.end(), item) == workItems_.end());
 
-        for (auto i = queue_.begin(); i != queue_.end(); ++i)
-        {
-            if ((*i)->priority_ <= item->priority_)
-            {
-                queue_.insert(i, item.Get());
-                inserted = true;
-                break;
-            }
-        }
+    workItems_.push_back(item);
+    item->completed_ = false;
+}
 
-        if (!inserted)
-            queue_.push_back(item.Get());
-    }
+void WorkQueue::QueuePendingWorkItem(WorkItem* item, unsigned threadIndex)
+{
+    // Queue to the calling thread, as the shared queue index is only accessed by the main thread
+    queues_[threadIndex]->Push(item);
+    ++numQueued_;
 
-    if (threads_.size())
+    // Paused threads are resumed by the main thread only, which at the latest happens in Complete()
+    if (threadIndex == 0 && threads_.size())
+        Resume();
+}
+
+void WorkQueue::AddArenaWorkItem(void (*workFunction)(const WorkItem*, unsigned), void* data, unsigned priority)
+{
+    if (poolItems_.empty())
     {
-        queueMutex_.Release();
-        paused_ = false;
+        SharedPtr<WorkItem> item(new WorkItem());
+        item->pooled_ = true;
+        poolItems_.push_back(ea::move(item));
     }
+
+    // Move the list node between the pool and the work item list to avoid both allocation and reference counting
+    workItems_.splice(workItems_.end(), poolItems_, poolItems_.begin());
+
+    WorkItem* item = workItems_.back();
+    item->workFunction_ = workFunction;
+    item->aux_ = data;
+    item->priority_ = priority;
+    item->arena_ = true;
+    item->completed_ = false;
+    ++numArenaItems_;
+
+    QueueItem(item);
+}
+
+void WorkQueue::QueueItem(WorkItem* item)
+{
+    // Distribute items between the queues, idle threads will steal the rest
+    WorkItemDeque& queue = *queues_[nextQueue_];
+    nextQueue_ = (nextQueue_ + 1) % queues_.size();
+    queue.Push(item);
+    ++numQueued_;
+
+    if (threads_.size())
+        Resume();
 }
 
 SharedPtr<WorkItem> WorkQueue::AddWorkItem(std::function<void()> workFunction, unsigned priority)
@@ -189,16 +263,16 @@ bool WorkQueue::RemoveWorkItem(SharedPtr<WorkItem> item)
     if (!item)
         return false;
 
-    MutexLock lock(queueMutex_);
-
     // Can only remove successfully if the item was not yet taken by threads for execution
-    auto i = ea::find(queue_.begin(), queue_.end(), item.Get());
-    if (i != queue_.end())
+    auto j = ea::find(workItems_.begin(), workItems_.end(), item);
+    if (j == workItems_.end())
+        return false;
+
+    for (const auto& queue : queues_)
     {
-        auto j = ea::find(workItems_.begin(), workItems_.end(), item);
-        if (j != workItems_.end())
+        if (queue->Remove(item.Get()))
         {
-            queue_.erase(i);
+            --numQueued_;
             ReturnToPool(item);
             workItems_.erase(j);
             return true;
@@ -210,23 +284,12 @@ bool WorkQueue::RemoveWorkItem(SharedPtr<WorkItem> item)
 
 unsigned WorkQueue::RemoveWorkItems(const ea::vector<SharedPtr<WorkItem> >& items)
 {
-    MutexLock lock(queueMutex_);
     unsigned removed = 0;
 
     for (auto i = items.begin(); i != items.end(); ++i)
     {
-        auto j = ea::find(queue_.begin(), queue_.end(), i->Get());
-        if (j != queue_.end())
-        {
-            auto k = ea::find(workItems_.begin(), workItems_.end(), *i);
-            if (k != workItems_.end())
-            {
-                queue_.erase(j);
-                ReturnToPool(*k);
-                workItems_.erase(k);
-                ++removed;
-            }
-        }
+        if (RemoveWorkItem(*i))
+            ++removed;
     }
 
     return removed;
@@ -236,12 +299,8 @@ void WorkQueue::Pause()
 {
     if (!paused_)
     {
-        pausing_ = true;
-
-        queueMutex_.Acquire();
+        pauseMutex_.Acquire();
         paused_ = true;
-
-        pausing_ = false;
     }
 }
 
@@ -249,8 +308,8 @@ void WorkQueue::Resume()
 {
     if (paused_)
     {
-        queueMutex_.Release();
         paused_ = false;
+        pauseMutex_.Release();
     }
 }
 
@@ -263,24 +322,9 @@ void WorkQueue::Complete(unsigned priority)
     {
         Resume();
 
-        // Take work items also in the main thread until queue empty or no high-priority items anymore
-        while (!queue_.empty())
-        {
-            queueMutex_.Acquire();
-            if (!queue_.empty() && queue_.front()->priority_ >= priority)
-            {
-                WorkItem* item = queue_.front();
-                queue_.pop_front();
-                queueMutex_.Release();
-                item->workFunction_(item, 0);
-                item->completed_ = true;
-            }
-            else
-            {
-                queueMutex_.Release();
-                break;
-            }
-        }
+        // Take work items also in the main thread until no high-priority items anymore
+        while (WorkItem* item = TakeItem(0, priority))
+            ExecuteItem(item, 0);
 
         // Wait for threaded work to complete
         while (!IsCompleted(priority))
@@ -288,25 +332,41 @@ void WorkQueue::Complete(unsigned priority)
         }
 
         // If no work at all remaining, pause worker threads by leaving the mutex locked
-        if (queue_.empty())
+        if (!numQueued_)
             Pause();
     }
     else
     {
         // No worker threads: ensure all high-priority items are completed in the main thread
-        while (!queue_.empty() && queue_.front()->priority_ >= priority)
-        {
-            WorkItem* item = queue_.front();
-            queue_.pop_front();
-            item->workFunction_(item, 0);
-            item->completed_ = true;
-        }
+        while (WorkItem* item = TakeItem(0, priority))
+            ExecuteItem(item, 0);
     }
 
     PurgeCompleted(priority);
     completing_ = false;
 }
 
+void WorkQueue::CompleteItem(WorkItem* item)
+{
+    if (!item || item->completed_)
+        return;
+
+    // Execute the item in the main thread if it is still queued
+    for (const auto& queue : queues_)
+    {
+        if (queue->Remove(item))
+        {
+            --numQueued_;
+            ExecuteItem(item, 0);
+            return;
+        }
+    }
+
+    // A worker thread is executing the item
+    while (!item->completed_)
+        std::this_thread::yield();
+}
+
 unsigned WorkQueue::GetNumIncomplete(unsigned priority) const
 {
     unsigned incomplete = 0;
@@ -332,37 +392,47 @@ bool WorkQueue::IsCompleted(unsigned priority) const
 
 void WorkQueue::ProcessItems(unsigned threadIndex)
 {
-    bool wasActive = false;
-
     for (;;)
     {
         if (shutDown_)
             return;
 
-        if (pausing_ && !wasActive)
-            Time::Sleep(0);
-        else
+        if (paused_)
         {
-            queueMutex_.Acquire();
-            if (!queue_.empty())
-            {
-                wasActive = true;
+            // Block until the main thread resumes the queue
+            pauseMutex_.Acquire();
+            pauseMutex_.Release();
+        }
+        else if (WorkItem* item = TakeItem(threadIndex, 0))
+            ExecuteItem(item, threadIndex);
+        else
+            Time::Sleep(0);
+    }
+}
 
-                WorkItem* item = queue_.front();
-                queue_.pop_front();
-                queueMutex_.Release();
-                item->workFunction_(item, threadIndex);
-                item->completed_ = true;
-            }
-            else
-            {
-                wasActive = false;
+WorkItem* WorkQueue::TakeItem(unsigned threadIndex, unsigned minPriority)
+{
+    if (!numQueued_)
+        return nullptr;
 
-                queueMutex_.Release();
-                Time::Sleep(0);
-            }
+    // Own queue first, then steal from the other threads starting from the next one
+    const unsigned numQueues = queues_.size();
+    for (unsigned i = 0; i < numQueues; ++i)
+    {
+        if (WorkItem* item = queues_[(threadIndex + i) % numQueues]->Pop(minPriority))
+        {
+            --numQueued_;
+            return item;
         }
     }
+
+    return nullptr;
+}
+
+void WorkQueue::ExecuteItem(WorkItem* item, unsigned threadIndex)
+{
+    item->workFunction_(item, threadIndex);
+    item->completed_ = true;
 }
 
 void WorkQueue::PurgeCompleted(unsigned priority)
@@ -383,12 +453,26 @@ void WorkQueue::PurgeCompleted(unsigned priority)
                 SendEvent(E_WORKITEMCOMPLETED, eventData);
             }
 
-            ReturnToPool(*i);
-            i = workItems_.erase(i);
+            if ((*i)->arena_)
+                --numArenaItems_;
+
+            auto next = ea::next(i);
+            if ((*i)->pooled_)
+            {
+                ResetItem(*i);
+                poolItems_.splice(poolItems_.end(), workItems_, i);
+            }
+            else
+                workItems_.erase(i);
+            i = next;
         }
         else
             ++i;
     }
+
+    // Callbacks of the completed items are not referenced anymore
+    if (!numArenaItems_)
+        arena_.Reset();
 }
 
 void WorkQueue::PurgePool()
@@ -408,37 +492,42 @@ void WorkQueue::ReturnToPool(SharedPtr<WorkItem>& item)
     // Check if this was a pooled item and set it to usable
     if (item->pooled_)
     {
-        // Reset the values to their defaults. This should
-        // be safe to do here as the completed event has
-        // already been handled and this is part of the
-        // internal pool.
-        item->start_ = nullptr;
-        item->end_ = nullptr;
-        item->aux_ = nullptr;
-        item->workFunction_ = nullptr;
-        item->priority_ = M_MAX_UNSIGNED;
-        item->sendEvent_ = false;
-        item->completed_ = false;
-
+        ResetItem(item);
         poolItems_.push_back(item);
     }
 }
 
+void WorkQueue::ResetItem(WorkItem* item)
+{
+    // Reset the values to their defaults. This should
+    // be safe to do here as the completed event has
+    // already been handled and this is part of the
+    // internal pool.
+    item->start_ = nullptr;
+    item->end_ = nullptr;
+    item->aux_ = nullptr;
+    item->workFunction_ = nullptr;
+    item->priority_ = M_MAX_UNSIGNED;
+    item->sendEvent_ = false;
+    item->completed_ = false;
+    item->arena_ = false;
+}
+
 void WorkQueue::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
 {
     // If no worker threads, complete low-priority work here
-    if (threads_.empty() && !queue_.empty())
+    if (threads_.empty() && numQueued_)
     {
         URHO3D_PROFILE("CompleteWorkNonthreaded");
 
         HiresTimer timer;
 
-        while (!queue_.empty() && timer.GetUSec(false) < maxNonThreadedWorkMs_ * 1000LL)
+        while (timer.GetUSec(false) < maxNonThreadedWorkMs_ * 1000LL)
         {
-            WorkItem* item = queue_.front();
-            queue_.pop_front();
-            item->workFunction_(item, 0);
-            item->completed_ = true;
+            WorkItem* item = TakeItem(0, 0);
+            if (!item)
+                break;
+            ExecuteItem(item, 0);
         }
     }
 
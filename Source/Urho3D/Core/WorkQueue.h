@@ -22,9 +22,11 @@
 
 #pragma once
 
+#include <EASTL/deque.h>
 #include <EASTL/list.h>
-#include <atomic>
+#include <EASTL/unique_ptr.h>
 
+#include "../Container/LinearAllocator.h"
 #include "../Core/Mutex.h"
 #include "../Core/Object.h"
 
@@ -64,10 +66,30 @@ public:
 
 private:
     bool pooled_{};
+    /// Whether the item data is stored in the transient arena of the work queue.
+    bool arena_{};
     /// Work function. Called without any parameters.
     std::function<void()> workLambda_;
 };
 
+/// Per-thread queue of work items used by the work-stealing scheduler. Items are kept sorted by descending priority.
+struct WorkItemDeque
+{
+    /// Insert item according to its priority.
+    void Push(WorkItem* item);
+    /// Pop the first item if it has at least the specified priority. Return null if no such item.
+    WorkItem* Pop(unsigned minPriority);
+    /// Remove specific item. Return true if it was found.
+    bool Remove(WorkItem* item);
+
+    /// Deque mutex.
+    Mutex mutex_;
+    /// Queued items.
+    ea::deque<WorkItem*> items_;
+    /// Number of queued items. May be read without locking the mutex.
+    std::atomic<unsigned> size_{};
+};
+
 /// Work queue subsystem for multithreading.
 class URHO3D_API WorkQueue : public Object
 {
@@ -89,6 +111,15 @@ public:
     void AddWorkItem(const SharedPtr<WorkItem>& item);
     /// Add a work item and resume worker threads.
     SharedPtr<WorkItem> AddWorkItem(std::function<void()> workFunction, unsigned priority = 0);
+    /// Add a work item without queueing it for execution. It counts as incomplete until queued with QueuePendingWorkItem() and executed.
+    void AddPendingWorkItem(const SharedPtr<WorkItem>& item);
+    /// Queue a work item added with AddPendingWorkItem() for execution. May also be called from work items, with the index of the calling thread (0 = main thread).
+    void QueuePendingWorkItem(WorkItem* item, unsigned threadIndex);
+    /// Add a work item that calls the callback with the thread index as parameter. The callback is stored in the transient arena, so submission performs no heap allocation.
+    template <class T> void Submit(T callback, unsigned priority = M_MAX_UNSIGNED);
+    /// Process elements [0, count) on all threads, including the main thread, by chunks of at most grainSize elements.
+    /// Callback is called with (begin, end, threadIndex) parameters. Call Complete() with the same priority to wait for completion.
+    template <class T> void ParallelFor(unsigned count, unsigned grainSize, T callback, unsigned priority = M_MAX_UNSIGNED);
     /// Remove a work item before it has started executing. Return true if successfully removed.
     bool RemoveWorkItem(SharedPtr<WorkItem> item);
     /// Remove a number of work items before they have started executing. Return the number of items successfully removed.
@@ -99,6 +130,8 @@ public:
     void Resume();
     /// Finish all queued work which has at least the specified priority. Main thread will also execute priority work. Pause worker threads if no more work remains.
     void Complete(unsigned priority);
+    /// Finish a single work item. If no worker thread has taken it yet, it is executed in the main thread, otherwise the main thread yields until the item is completed. Call only from the main thread.
+    void CompleteItem(WorkItem* item);
 
     /// Set the pool telerance before it starts deleting pool items.
     void SetTolerance(int tolerance) { tolerance_ = tolerance; }
@@ -125,12 +158,22 @@ public:
 private:
     /// Process work items until shut down. Called by the worker threads.
     void ProcessItems(unsigned threadIndex);
+    /// Take work item with at least the specified priority from the own queue of the thread, or steal from the other queues. Return null if nothing to do.
+    WorkItem* TakeItem(unsigned threadIndex, unsigned minPriority);
+    /// Execute work item and mark it as completed.
+    void ExecuteItem(WorkItem* item, unsigned threadIndex);
+    /// Put work item into the thread queues and resume worker threads.
+    void QueueItem(WorkItem* item);
+    /// Add pooled work item with data stored in the transient arena.
+    void AddArenaWorkItem(void (*workFunction)(const WorkItem*, unsigned), void* data, unsigned priority);
     /// Purge completed work items which have at least the specified priority, and send completion events as necessary.
     void PurgeCompleted(unsigned priority);
     /// Purge the pool to reduce allocation where its unneeded.
     void PurgePool();
     /// Return a work item to the pool.
     void ReturnToPool(SharedPtr<WorkItem>& item);
+    /// Reset pooled work item to default values.
+    static void ResetItem(WorkItem* item);
     /// Handle frame start event. Purge completed work from the main thread queue, and perform work if no threads at all.
     void HandleBeginFrame(StringHash eventType, VariantMap& eventData);
 
@@ -140,16 +183,18 @@ private:
     ea::list<SharedPtr<WorkItem> > poolItems_;
     /// Work item collection. Accessed only by the main thread.
     ea::list<SharedPtr<WorkItem> > workItems_;
-    /// Work item prioritized queue for worker threads. Pointers are guaranteed to be valid (point to workItems).
-    ea::list<WorkItem*> queue_;
-    /// Worker queue mutex.
-    Mutex queueMutex_;
+    /// Per-thread prioritized queues. Index 0 belongs to the main thread, the rest to the worker threads. Pointers are guaranteed to be valid (point to workItems).
+    ea::vector<ea::unique_ptr<WorkItemDeque> > queues_;
+    /// Total number of queued items in all queues.
+    std::atomic<unsigned> numQueued_;
+    /// Index of the queue to receive the next submitted item.
+    unsigned nextQueue_;
+    /// Pause mutex. Locked by the main thread while the worker threads are paused.
+    Mutex pauseMutex_;
     /// Shutting down flag.
     std::atomic<bool> shutDown_;
-    /// Pausing flag. Indicates the worker threads should not contend for the queue mutex.
-    std::atomic<bool> pausing_;
-    /// Paused flag. Indicates the queue mutex being locked to prevent worker threads using up CPU time.
-    bool paused_;
+    /// Paused flag. Indicates the pause mutex being locked to prevent worker threads using up CPU time.
+    std::atomic<bool> paused_;
     /// Completing work in the main thread flag.
     bool completing_;
     /// Tolerance for the shared pool before it begins to deallocate.
@@ -158,6 +203,83 @@ private:
     unsigned lastSize_;
     /// Maximum milliseconds per frame to spend on low-priority work, when there are no worker threads.
     int maxNonThreadedWorkMs_;
+    /// Transient storage for callbacks of Submit() and ParallelFor(). Reset when all arena items are purged.
+    LinearAllocator arena_;
+    /// Number of not yet purged work items referencing the arena.
+    unsigned numArenaItems_{};
+};
+
+namespace Detail
+{
+
+/// Shared state of ParallelFor() work items.
+template <class T> struct ParallelForTask
+{
+    /// Construct.
+    ParallelForTask(T&& callback, unsigned count, unsigned grainSize, unsigned numWorkItems)
+        : callback_(ea::move(callback))
+        , count_(count)
+        , grainSize_(grainSize)
+        , nextIndex_(0)
+        , numActiveWorkItems_(numWorkItems)
+    {
+    }
+
+    /// Callback.
+    T callback_;
+    /// Number of elements.
+    unsigned count_;
+    /// Max number of elements per chunk.
+    unsigned grainSize_;
+    /// Index of next element to process.
+    std::atomic<unsigned> nextIndex_;
+    /// Number of work items not finished yet.
+    std::atomic<unsigned> numActiveWorkItems_;
 };
 
 }
+
+template <class T> void WorkQueue::Submit(T callback, unsigned priority)
+{
+    T* storedCallback = arena_.New<T>(ea::move(callback));
+    AddArenaWorkItem([](const WorkItem* item, unsigned threadIndex)
+    {
+        T* callback = static_cast<T*>(item->aux_);
+        (*callback)(threadIndex);
+        callback->~T();
+    }, storedCallback, priority);
+}
+
+template <class T> void WorkQueue::ParallelFor(unsigned count, unsigned grainSize, T callback, unsigned priority)
+{
+    if (count == 0)
+        return;
+
+    // Submit one work item per thread at most. Items grab chunks dynamically, which balances uneven workloads
+    grainSize = Max(grainSize, 1u);
+    const unsigned numChunks = (count + grainSize - 1) / grainSize;
+    const unsigned numWorkItems = Min(numChunks, GetNumThreads() + 1);
+
+    using TaskType = Detail::ParallelForTask<T>;
+    auto* task = arena_.New<TaskType>(ea::move(callback), count, grainSize, numWorkItems);
+    for (unsigned i = 0; i < numWorkItems; ++i)
+    {
+        AddArenaWorkItem([](const WorkItem* item, unsigned threadIndex)
+        {
+            auto* task = static_cast<TaskType*>(item->aux_);
+            for (;;)
+            {
+                const unsigned begin = task->nextIndex_.fetch_add(task->grainSize_);
+                if (begin >= task->count_)
+                    break;
+                const unsigned end = Min(begin + task->grainSize_, task->count_);
+                task->callback_(begin, end, threadIndex);
+            }
+
+            if (--task->numActiveWorkItems_ == 0)
+                task->~TaskType();
+        }, task, priority);
+    }
+}
+
+}
@@ -25,6 +25,7 @@
 #include "../Audio/Audio.h"
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
+#include "../Core/FrameStatistics.h"
 #include "../Core/Profiler.h"
 #include "../Core/ProcessUtils.h"
 #include "../Core/Thread.h"
@@ -99,6 +100,57 @@ namespace Urho3D
 
 extern const char* logLevelNames[];
 
+/// Number of tick work time histogram buckets within the tick duration.
+static const unsigned NUM_TICK_TIME_BUCKETS = 10;
+/// Remaining time before a tick is due, in microseconds, below which the tick loop yields instead of sleeping.
+static const long long TICK_YIELD_THRESHOLD_USEC = 1000;
+
+/// Resource dir or package resolved from the engine parameters.
+struct ResourceMount
+{
+    /// Path name of the dir or package.
+    ea::string path_;
+    /// Whether is a package.
+    bool isPackage_{};
+    /// Resource cache priority.
+    unsigned priority_{};
+    /// Opened package. Null if failed to open.
+    SharedPtr<PackageFile> package_{};
+};
+
+/// Open the packages of resource mounts, reading their file tables in parallel on the work queue.
+static void OpenPackageFiles(Context* context, ea::vector<ResourceMount>& mounts)
+{
+    URHO3D_PROFILE("OpenPackageFiles");
+
+    ea::vector<ResourceMount*> packageMounts;
+    for (ResourceMount& mount : mounts)
+    {
+        if (mount.isPackage_)
+            packageMounts.push_back(&mount);
+    }
+
+    const auto openPackages = [context, &packageMounts](unsigned begin, unsigned end)
+    {
+        for (unsigned i = begin; i < end; ++i)
+        {
+            SharedPtr<PackageFile> package(new PackageFile(context));
+            if (package->Open(packageMounts[i]->path_))
+                packageMounts[i]->package_ = package;
+        }
+    };
+
+    // Worker threads are already running at this point. Each package is opened by one thread only
+    auto* queue = context->GetSubsystem<WorkQueue>();
+    if (queue && queue->GetNumThreads() && packageMounts.size() > 1)
+    {
+        queue->ParallelFor(packageMounts.size(), 1, [&openPackages](unsigned begin, unsigned end, unsigned) { openPackages(begin, end); });
+        queue->Complete(M_MAX_UNSIGNED);
+    }
+    else
+        openPackages(0, packageMounts.size());
+}
+
 Engine::Engine(Context* context) :
     Object(context),
     timeStep_(0.0f),
@@ -127,6 +179,7 @@ Engine::Engine(Context* context) :
 
     // Create subsystems which do not depend on engine initialization or startup parameters
     context_->RegisterSubsystem(new Time(context_));
+    context_->RegisterSubsystem(new FrameStatistics(context_));
     context_->RegisterSubsystem(new WorkQueue(context_));
     context_->RegisterSubsystem(new FileSystem(context_));
 #ifdef URHO3D_LOGGING
@@ -167,7 +220,10 @@ Engine::Engine(Context* context) :
     SubscribeToEvent(E_ENDFRAME, URHO3D_HANDLER(Engine, HandleEndFrame));
 }
 
-Engine::~Engine() = default;
+Engine::~Engine()
+{
+    CompletePipelinedUpdate();
+}
 
 bool Engine::Initialize(const VariantMap& parameters)
 {
@@ -176,6 +232,10 @@ bool Engine::Initialize(const VariantMap& parameters)
 
     URHO3D_PROFILE("InitEngine");
 
+    // Time the startup stages, so that slow startup can be diagnosed from the log
+    HiresTimer startupTimer;
+    HiresTimer stageTimer;
+
     // Start logging
     auto* log = GetSubsystem<Log>();
     if (log)
@@ -184,29 +244,37 @@ bool Engine::Initialize(const VariantMap& parameters)
             log->SetLevel(static_cast<LogLevel>(GetParameter(parameters, EP_LOG_LEVEL).GetInt()));
         log->SetQuiet(GetParameter(parameters, EP_LOG_QUIET, false).GetBool());
         log->Open(GetParameter(parameters, EP_LOG_NAME, "Urho3D.log").GetString());
+        if (GetParameter(parameters, EP_LOG_ASYNC, false).GetBool())
+            log->SetAsync(true);
     }
 
     // Set headless mode
     headless_ = GetParameter(parameters, EP_HEADLESS, false).GetBool();
+    SetTickRate(GetParameter(parameters, EP_TICK_RATE, 0).GetUInt());
+    SetPipelinedUpdate(GetParameter(parameters, EP_PIPELINED_UPDATE, false).GetBool());
 
-    // Register the rest of the subsystems
-    context_->RegisterSubsystem(new Input(context_));
-    context_->RegisterSubsystem(new Audio(context_));
-    if (!headless_)
-    {
-        context_->RegisterSubsystem(new Graphics(context_));
-        context_->RegisterSubsystem(new Renderer(context_));
-    }
-    else
+    // Register the rest of the subsystems. A headless dedicated server has no use for audio
     {
-        // Register graphics library objects explicitly in headless mode to allow them to work without using actual GPU resources
-        RegisterGraphicsLibrary(context_);
-    }
+        URHO3D_PROFILE("CreateSubsystems");
+        context_->RegisterSubsystem(new Input(context_));
+        if (!headless_ || !tickRate_)
+            context_->RegisterSubsystem(new Audio(context_));
+        if (!headless_)
+        {
+            context_->RegisterSubsystem(new Graphics(context_));
+            context_->RegisterSubsystem(new Renderer(context_));
+        }
+        else
+        {
+            // Register graphics library objects explicitly in headless mode to allow them to work without using actual GPU resources
+            RegisterGraphicsLibrary(context_);
+        }
 
 #ifdef URHO3D_URHO2D
-    // 2D graphics library is dependent on 3D graphics library
-    RegisterUrho2DLibrary(context_);
+        // 2D graphics library is dependent on 3D graphics library
+        RegisterUrho2DLibrary(context_);
 #endif
+    }
 
     // Set maximally accurate low res timer
     GetSubsystem<Time>()->SetTimerPeriod(1);
@@ -227,9 +295,27 @@ bool Engine::Initialize(const VariantMap& parameters)
     }
 #endif
 
+    // Save a report of the frames leading up to a hitch. By default a hitch is a frame three times slower than usual,
+    // but at least 10 ms so that the jitter of very fast frames is not reported
+    if (HasParameter(parameters, EP_HITCH_REPORT_PATH))
+    {
+        auto* statistics = GetSubsystem<FrameStatistics>();
+        statistics->SetHitchDump(GetParameter(parameters, EP_HITCH_THRESHOLD, 10.0f).GetFloat(),
+            GetParameter(parameters, EP_HITCH_REPORT_PATH).GetString());
+        statistics->SetHitchMedianFactor(GetParameter(parameters, EP_HITCH_MEDIAN_FACTOR, 3.0f).GetFloat());
+    }
+
+    const long long subsystemsTime = stageTimer.GetUSec(true);
+
     // Add resource paths
-    if (!InitializeResourceCache(parameters, false))
-        return false;
+    {
+        URHO3D_PROFILE("InitResourceCache");
+        if (!InitializeResourceCache(parameters, false))
+            return false;
+    }
+    const long long resourceCacheTime = stageTimer.GetUSec(true);
+    long long graphicsTime = 0;
+    long long audioTime = 0;
 
     auto* cache = GetSubsystem<ResourceCache>();
     auto* fileSystem = GetSubsystem<FileSystem>();
@@ -237,60 +323,65 @@ bool Engine::Initialize(const VariantMap& parameters)
     // Initialize graphics & audio output
     if (!headless_)
     {
-        auto* graphics = GetSubsystem<Graphics>();
-        auto* renderer = GetSubsystem<Renderer>();
+        {
+            URHO3D_PROFILE("InitGraphics");
+            auto* graphics = GetSubsystem<Graphics>();
+            auto* renderer = GetSubsystem<Renderer>();
 
-        if (HasParameter(parameters, EP_EXTERNAL_WINDOW))
-            graphics->SetExternalWindow(GetParameter(parameters, EP_EXTERNAL_WINDOW).GetVoidPtr());
-        graphics->SetWindowTitle(GetParameter(parameters, EP_WINDOW_TITLE, "Urho3D").GetString());
-        graphics->SetWindowIcon(cache->GetResource<Image>(GetParameter(parameters, EP_WINDOW_ICON, EMPTY_STRING).GetString()));
-        graphics->SetFlushGPU(GetParameter(parameters, EP_FLUSH_GPU, false).GetBool());
-        graphics->SetOrientations(GetParameter(parameters, EP_ORIENTATIONS, "LandscapeLeft LandscapeRight").GetString());
+            if (HasParameter(parameters, EP_EXTERNAL_WINDOW))
+                graphics->SetExternalWindow(GetParameter(parameters, EP_EXTERNAL_WINDOW).GetVoidPtr());
+            graphics->SetWindowTitle(GetParameter(parameters, EP_WINDOW_TITLE, "Urho3D").GetString());
+            graphics->SetWindowIcon(cache->GetResource<Image>(GetParameter(parameters, EP_WINDOW_ICON, EMPTY_STRING).GetString()));
+            graphics->SetFlushGPU(GetParameter(parameters, EP_FLUSH_GPU, false).GetBool());
+            graphics->SetOrientations(GetParameter(parameters, EP_ORIENTATIONS, "LandscapeLeft LandscapeRight").GetString());
 
 #ifdef URHO3D_OPENGL
-        if (HasParameter(parameters, EP_FORCE_GL2))
-            graphics->SetForceGL2(GetParameter(parameters, EP_FORCE_GL2).GetBool());
+            if (HasParameter(parameters, EP_FORCE_GL2))
+                graphics->SetForceGL2(GetParameter(parameters, EP_FORCE_GL2).GetBool());
 #endif
 
-        if (!graphics->SetMode(
-            GetParameter(parameters, EP_WINDOW_WIDTH, 0).GetInt(),
-            GetParameter(parameters, EP_WINDOW_HEIGHT, 0).GetInt(),
-            GetParameter(parameters, EP_FULL_SCREEN, true).GetBool(),
-            GetParameter(parameters, EP_BORDERLESS, false).GetBool(),
-            GetParameter(parameters, EP_WINDOW_RESIZABLE, false).GetBool(),
-            GetParameter(parameters, EP_HIGH_DPI, true).GetBool(),
-            GetParameter(parameters, EP_VSYNC, false).GetBool(),
-            GetParameter(parameters, EP_TRIPLE_BUFFER, false).GetBool(),
-            GetParameter(parameters, EP_MULTI_SAMPLE, 1).GetInt(),
-            GetParameter(parameters, EP_MONITOR, 0).GetInt(),
-            GetParameter(parameters, EP_REFRESH_RATE, 0).GetInt()
-        ))
-            return false;
+            if (!graphics->SetMode(
+                GetParameter(parameters, EP_WINDOW_WIDTH, 0).GetInt(),
+                GetParameter(parameters, EP_WINDOW_HEIGHT, 0).GetInt(),
+                GetParameter(parameters, EP_FULL_SCREEN, true).GetBool(),
+                GetParameter(parameters, EP_BORDERLESS, false).GetBool(),
+                GetParameter(parameters, EP_WINDOW_RESIZABLE, false).GetBool(),
+                GetParameter(parameters, EP_HIGH_DPI, true).GetBool(),
+                GetParameter(parameters, EP_VSYNC, false).GetBool(),
+                GetParameter(parameters, EP_TRIPLE_BUFFER, false).GetBool(),
+                GetParameter(parameters, EP_MULTI_SAMPLE, 1).GetInt(),
+                GetParameter(parameters, EP_MONITOR, 0).GetInt(),
+                GetParameter(parameters, EP_REFRESH_RATE, 0).GetInt()
+            ))
+                return false;
 
-        if (HasParameter(parameters, EP_WINDOW_POSITION_X) && HasParameter(parameters, EP_WINDOW_POSITION_Y))
-            graphics->SetWindowPosition(GetParameter(parameters, EP_WINDOW_POSITION_X).GetInt(),
-                GetParameter(parameters, EP_WINDOW_POSITION_Y).GetInt());
+            if (HasParameter(parameters, EP_WINDOW_POSITION_X) && HasParameter(parameters, EP_WINDOW_POSITION_Y))
+                graphics->SetWindowPosition(GetParameter(parameters, EP_WINDOW_POSITION_X).GetInt(),
+                    GetParameter(parameters, EP_WINDOW_POSITION_Y).GetInt());
 
-        if (HasParameter(parameters, EP_WINDOW_MAXIMIZE) && GetParameter(parameters, EP_WINDOW_MAXIMIZE).GetBool())
-            graphics->Maximize();
+            if (HasParameter(parameters, EP_WINDOW_MAXIMIZE) && GetParameter(parameters, EP_WINDOW_MAXIMIZE).GetBool())
+                graphics->Maximize();
 
-        graphics->SetShaderCacheDir(GetParameter(parameters, EP_SHADER_CACHE_DIR, appPreferencesDir_).GetString() + "shadercache/");
+            graphics->SetShaderCacheDir(GetParameter(parameters, EP_SHADER_CACHE_DIR, appPreferencesDir_).GetString() + "shadercache/");
 
-        if (HasParameter(parameters, EP_DUMP_SHADERS))
-            graphics->BeginDumpShaders(GetParameter(parameters, EP_DUMP_SHADERS, EMPTY_STRING).GetString());
-        if (HasParameter(parameters, EP_RENDER_PATH))
-            renderer->SetDefaultRenderPath(cache->GetResource<XMLFile>(GetParameter(parameters, EP_RENDER_PATH).GetString()));
+            if (HasParameter(parameters, EP_DUMP_SHADERS))
+                graphics->BeginDumpShaders(GetParameter(parameters, EP_DUMP_SHADERS, EMPTY_STRING).GetString());
+            if (HasParameter(parameters, EP_RENDER_PATH))
+                renderer->SetDefaultRenderPath(cache->GetResource<XMLFile>(GetParameter(parameters, EP_RENDER_PATH).GetString()));
 
-        renderer->SetDrawShadows(GetParameter(parameters, EP_SHADOWS, true).GetBool());
-        if (renderer->GetDrawShadows() && GetParameter(parameters, EP_LOW_QUALITY_SHADOWS, false).GetBool())
-            renderer->SetShadowQuality(SHADOWQUALITY_SIMPLE_16BIT);
-        renderer->SetMaterialQuality((MaterialQuality)GetParameter(parameters, EP_MATERIAL_QUALITY, QUALITY_HIGH).GetInt());
-        renderer->SetTextureQuality((MaterialQuality)GetParameter(parameters, EP_TEXTURE_QUALITY, QUALITY_HIGH).GetInt());
-        renderer->SetTextureFilterMode((TextureFilterMode)GetParameter(parameters, EP_TEXTURE_FILTER_MODE, FILTER_TRILINEAR).GetInt());
-        renderer->SetTextureAnisotropy(GetParameter(parameters, EP_TEXTURE_ANISOTROPY, 4).GetInt());
+            renderer->SetDrawShadows(GetParameter(parameters, EP_SHADOWS, true).GetBool());
+            if (renderer->GetDrawShadows() && GetParameter(parameters, EP_LOW_QUALITY_SHADOWS, false).GetBool())
+                renderer->SetShadowQuality(SHADOWQUALITY_SIMPLE_16BIT);
+            renderer->SetMaterialQuality((MaterialQuality)GetParameter(parameters, EP_MATERIAL_QUALITY, QUALITY_HIGH).GetInt());
+            renderer->SetTextureQuality((MaterialQuality)GetParameter(parameters, EP_TEXTURE_QUALITY, QUALITY_HIGH).GetInt());
+            renderer->SetTextureFilterMode((TextureFilterMode)GetParameter(parameters, EP_TEXTURE_FILTER_MODE, FILTER_TRILINEAR).GetInt());
+            renderer->SetTextureAnisotropy(GetParameter(parameters, EP_TEXTURE_ANISOTROPY, 4).GetInt());
+        }
+        graphicsTime = stageTimer.GetUSec(true);
 
         if (GetParameter(parameters, EP_SOUND, true).GetBool())
         {
+            URHO3D_PROFILE("InitAudio");
             GetSubsystem<Audio>()->SetMode(
                 GetParameter(parameters, EP_SOUND_BUFFER, 100).GetInt(),
                 GetParameter(parameters, EP_SOUND_MIX_RATE, 44100).GetInt(),
@@ -298,6 +389,7 @@ bool Engine::Initialize(const VariantMap& parameters)
                 GetParameter(parameters, EP_SOUND_INTERPOLATION, true).GetBool()
             );
         }
+        audioTime = stageTimer.GetUSec(true);
     }
 
     // Init FPU state of main thread
@@ -311,6 +403,9 @@ bool Engine::Initialize(const VariantMap& parameters)
 #ifdef URHO3D_NETWORK
     if (HasParameter(parameters, EP_PACKAGE_CACHE_DIR))
         GetSubsystem<Network>()->SetPackageCacheDir(GetParameter(parameters, EP_PACKAGE_CACHE_DIR).GetString());
+    // Send network updates on every tick
+    if (tickRate_)
+        GetSubsystem<Network>()->SetUpdateFps(tickRate_);
 #endif
 
 #ifdef URHO3D_TESTING
@@ -326,7 +421,9 @@ bool Engine::Initialize(const VariantMap& parameters)
     }
     frameTimer_.Reset();
 
-    URHO3D_LOGINFO("Initialized engine");
+    URHO3D_LOGINFOF("Initialized engine in %.1f ms (subsystems %.1f ms, resource cache %.1f ms, graphics %.1f ms, audio %.1f ms)",
+        startupTimer.GetUSec(false) / 1000.0, subsystemsTime / 1000.0, resourceCacheTime / 1000.0, graphicsTime / 1000.0,
+        audioTime / 1000.0);
     initialized_ = true;
     SendEvent(E_ENGINEINITIALIZED);
     return true;
@@ -364,6 +461,9 @@ bool Engine::InitializeResourceCache(const VariantMap& parameters, bool removeOl
     ea::vector<ea::string> resourcePackages = GetParameter(parameters, EP_RESOURCE_PACKAGES).GetString().split(';');
     ea::vector<ea::string> autoLoadPaths = GetParameter(parameters, EP_AUTOLOAD_PATHS, "Autoload").GetString().split(';');
 
+    // Resolve resource dirs and packages first, so that package file tables can be read in parallel
+    ea::vector<ResourceMount> mounts;
+
     for (unsigned i = 0; i < resourcePaths.size(); ++i)
     {
         // If path is not absolute, prefer to add it as a package if possible
@@ -375,18 +475,14 @@ bool Engine::InitializeResourceCache(const VariantMap& parameters, bool removeOl
                 ea::string packageName = resourcePrefixPaths[j] + resourcePaths[i] + ".pak";
                 if (fileSystem->FileExists(packageName))
                 {
-                    if (cache->AddPackageFile(packageName))
-                        break;
-                    else
-                        return false;   // The root cause of the error should have already been logged
+                    mounts.push_back({ packageName, true, PRIORITY_LAST });
+                    break;
                 }
                 ea::string pathName = resourcePrefixPaths[j] + resourcePaths[i];
                 if (fileSystem->DirExists(pathName))
                 {
-                    if (cache->AddResourceDir(pathName))
-                        break;
-                    else
-                        return false;
+                    mounts.push_back({ pathName, false, PRIORITY_LAST });
+                    break;
                 }
             }
             if (j == resourcePrefixPaths.size() && !headless_)
@@ -401,8 +497,7 @@ bool Engine::InitializeResourceCache(const VariantMap& parameters, bool removeOl
         {
             ea::string pathName = resourcePaths[i];
             if (fileSystem->DirExists(pathName))
-                if (!cache->AddResourceDir(pathName))
-                    return false;
+                mounts.push_back({ pathName, false, PRIORITY_LAST });
         }
     }
 
@@ -415,10 +510,8 @@ bool Engine::InitializeResourceCache(const VariantMap& parameters, bool removeOl
             ea::string packageName = resourcePrefixPaths[j] + resourcePackages[i];
             if (fileSystem->FileExists(packageName))
             {
-                if (cache->AddPackageFile(packageName))
-                    break;
-                else
-                    return false;
+                mounts.push_back({ packageName, true, PRIORITY_LAST });
+                break;
             }
         }
         if (j == resourcePrefixPaths.size() && !headless_)
@@ -454,9 +547,7 @@ bool Engine::InitializeResourceCache(const VariantMap& parameters, bool removeOl
                     if (dir.starts_with("."))
                         continue;
 
-                    ea::string autoResourceDir = AddTrailingSlash(autoLoadPath) + dir;
-                    if (!cache->AddResourceDir(autoResourceDir, 0))
-                        return false;
+                    mounts.push_back({ AddTrailingSlash(autoLoadPath) + dir, false, 0 });
                 }
 
                 // Add all the found package files (non-recursive)
@@ -468,9 +559,7 @@ bool Engine::InitializeResourceCache(const VariantMap& parameters, bool removeOl
                     if (pak.starts_with("."))
                         continue;
 
-                    ea::string autoPackageName = autoLoadPath + "/" + pak;
-                    if (!cache->AddPackageFile(autoPackageName, 0))
-                        return false;
+                    mounts.push_back({ autoLoadPath + "/" + pak, true, 0 });
                 }
             }
         }
@@ -486,6 +575,21 @@ bool Engine::InitializeResourceCache(const VariantMap& parameters, bool removeOl
                 autoLoadPaths[i].c_str());
     }
 
+    OpenPackageFiles(context_, mounts);
+
+    // Mount in the resolved order, so that priorities match the order of the parameters
+    for (const ResourceMount& mount : mounts)
+    {
+        if (mount.isPackage_)
+        {
+            // The root cause of the error should have already been logged
+            if (!mount.package_ || !cache->AddPackageFile(mount.package_, mount.priority_))
+                return false;
+        }
+        else if (!cache->AddResourceDir(mount.path_, mount.priority_))
+            return false;
+    }
+
     return true;
 }
 
@@ -516,7 +620,7 @@ void Engine::RunFrame()
         // If pause when minimized -mode is in use, stop updates and audio as necessary
         if (pauseMinimized_ && input->IsMinimized())
         {
-            if (audio->IsPlaying())
+            if (audio && audio->IsPlaying())
             {
                 audio->Stop();
                 audioPaused_ = true;
@@ -531,12 +635,20 @@ void Engine::RunFrame()
                 audioPaused_ = false;
             }
 
+            // Results of the previous pipelined update are consumed by this update
+            CompletePipelinedUpdate();
             Update();
+
+            // The pipelined update overlaps rendering and frame limiting
+            StartPipelinedUpdate();
         }
 
         Render();
     }
-    ApplyFrameLimit();
+    if (tickRate_)
+        ApplyTickLimit();
+    else
+        ApplyFrameLimit();
 
     time->EndFrame();
 
@@ -622,6 +734,103 @@ void Engine::SetNextTimeStep(float seconds)
     timeStep_ = Max(seconds, 0.0f);
 }
 
+void Engine::SetTickRate(unsigned tickRate)
+{
+    if (tickRate == tickRate_)
+        return;
+
+    tickRate_ = tickRate;
+    ResetTickStatistics();
+}
+
+void Engine::ResetTickStatistics()
+{
+    tickTimeHistogram_.clear();
+    if (tickRate_)
+        tickTimeHistogram_.resize(NUM_TICK_TIME_BUCKETS + 1);
+    maxTickTime_ = 0;
+    numDroppedTicks_ = 0;
+    tickTimer_.Reset();
+    nextTickTime_ = 0;
+}
+
+void Engine::SetPipelinedUpdate(bool enable)
+{
+    CompletePipelinedUpdate();
+    pipelinedUpdate_ = enable;
+}
+
+void Engine::CompletePipelinedUpdate()
+{
+    if (!pipelinedUpdateItem_)
+        return;
+
+    URHO3D_PROFILE("CompletePipelinedUpdate");
+
+    // If the update has not been started yet, it is taken from the queue and run here. Otherwise wait for it
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    if (workQueue)
+        workQueue->CompleteItem(pipelinedUpdateItem_);
+    else
+        pipelinedUpdateItem_->workFunction_(pipelinedUpdateItem_, 0);
+    pipelinedUpdateItem_ = nullptr;
+}
+
+void Engine::StartPipelinedUpdate()
+{
+    if (!onPipelinedUpdate_.HasSubscribers())
+        return;
+
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    if (!pipelinedUpdate_ || !workQueue || !workQueue->GetNumThreads())
+    {
+        URHO3D_PROFILE("PipelinedUpdate");
+        UpdateEventArgs args{timeStep_};
+        onPipelinedUpdate_(this, args);
+        return;
+    }
+
+    // Use a private item, so that a pooled item can not be recycled before it is waited for
+    pipelinedTimeStep_ = timeStep_;
+    pipelinedUpdateItem_ = MakeShared<WorkItem>();
+    pipelinedUpdateItem_->aux_ = this;
+    pipelinedUpdateItem_->priority_ = 0;
+    pipelinedUpdateItem_->workFunction_ = [](const WorkItem* item, unsigned)
+    {
+        URHO3D_PROFILE("PipelinedUpdate");
+        auto* engine = static_cast<Engine*>(item->aux_);
+        UpdateEventArgs args{engine->pipelinedTimeStep_};
+        engine->onPipelinedUpdate_(engine, args);
+    };
+    workQueue->AddWorkItem(pipelinedUpdateItem_);
+}
+
+ea::string Engine::PrintTickStatistics() const
+{
+    if (!tickRate_)
+        return EMPTY_STRING;
+
+    unsigned numTicks = 0;
+    for (unsigned count : tickTimeHistogram_)
+        numTicks += count;
+
+    const long long tickDuration = 1000000LL / tickRate_;
+    ea::string output = Format("Tick rate {} Hz, {} ticks, max {:.3f} ms, {} dropped\n", tickRate_, numTicks,
+        maxTickTime_ / 1000.0f, numDroppedTicks_);
+    for (unsigned i = 0; i < tickTimeHistogram_.size(); ++i)
+    {
+        const float percentage = numTicks ? 100.0f * tickTimeHistogram_[i] / numTicks : 0.0f;
+        if (i < NUM_TICK_TIME_BUCKETS)
+        {
+            output += Format("{:6.2f}-{:6.2f} ms {:10} {:6.2f}%\n", tickDuration * i / NUM_TICK_TIME_BUCKETS / 1000.0f,
+                tickDuration * (i + 1) / NUM_TICK_TIME_BUCKETS / 1000.0f, tickTimeHistogram_[i], percentage);
+        }
+        else
+            output += Format("   overrun      {:10} {:6.2f}%\n", tickTimeHistogram_[i], percentage);
+    }
+    return output;
+}
+
 void Engine::Exit()
 {
 #if defined(IOS) || defined(TVOS)
@@ -637,7 +846,8 @@ void Engine::DumpProfiler()
     if (!Thread::IsMainThread())
         return;
 
-    // TODO: Put something here or remove API
+    if (tickRate_)
+        URHO3D_LOGINFO(PrintTickStatistics());
 #endif
 }
 
@@ -712,21 +922,33 @@ void Engine::DumpMemory()
 void Engine::Update()
 {
     URHO3D_PROFILE("Update");
+    FrameStageTimer stageTimer(context_, FS_UPDATE);
 
-    // Logic update event
+    // Deliver events posted from worker threads during the previous frame's rendering
+    context_->SendPostedEvents();
+
+    // Logic update event. Engine subsystems receive the typed signals, which run before the events
     using namespace Update;
 
+    UpdateEventArgs args{timeStep_};
     VariantMap& eventData = GetEventDataMap();
     eventData[P_TIMESTEP] = timeStep_;
+    onUpdate_(this, args);
     SendEvent(E_UPDATE, eventData);
 
     // Logic post-update event
+    onPostUpdate_(this, args);
     SendEvent(E_POSTUPDATE, eventData);
 
+    // Deliver events posted during the logic update, for example from physics and threaded scene updates
+    context_->SendPostedEvents();
+
     // Rendering update event
+    onRenderUpdate_(this, args);
     SendEvent(E_RENDERUPDATE, eventData);
 
     // Post-render update event
+    onPostRenderUpdate_(this, args);
     SendEvent(E_POSTRENDERUPDATE, eventData);
 }
 
@@ -736,13 +958,15 @@ void Engine::Render()
         return;
 
     URHO3D_PROFILE("Render");
+    FrameStageTimer stageTimer(context_, FS_RENDER);
 
     // If device is lost, BeginFrame will fail and we skip rendering
     auto* graphics = GetSubsystem<Graphics>();
     if (!graphics->BeginFrame())
         return;
 
-    GetSubsystem<Renderer>()->Render();
+    auto* renderer = GetSubsystem<Renderer>();
+    renderer->Render();
 
     // Render UI after scene is rendered, but only do so if user has not rendered it manually
     // anywhere (for example using renderpath or to a texture).
@@ -754,6 +978,14 @@ void Engine::Render()
     }
 
     graphics->EndFrame();
+
+    if (auto* statistics = GetSubsystem<FrameStatistics>())
+    {
+        statistics->SetCounter(FC_DRAW_CALLS, graphics->GetNumBatches());
+        statistics->SetCounter(FC_PRIMITIVES, graphics->GetNumPrimitives());
+        statistics->SetCounter(FC_BATCHES, renderer->GetNumBatches());
+        statistics->SetCounter(FC_VISIBLE_DRAWABLES, renderer->GetNumGeometries(true));
+    }
 }
 
 void Engine::ApplyFrameLimit()
@@ -831,6 +1063,56 @@ void Engine::ApplyFrameLimit()
         timeStep_ = lastTimeSteps_.back();
 }
 
+void Engine::ApplyTickLimit()
+{
+    if (!initialized_)
+        return;
+
+    URHO3D_PROFILE("ApplyTickLimit");
+
+    // Record the work time of the tick that just finished
+    const long long tickDuration = 1000000LL / tickRate_;
+    const long long workTime = frameTimer_.GetUSec(false);
+    const unsigned bucket = (unsigned)Min(workTime * NUM_TICK_TIME_BUCKETS / tickDuration, (long long)NUM_TICK_TIME_BUCKETS);
+    ++tickTimeHistogram_[bucket];
+    maxTickTime_ = Max(maxTickTime_, workTime);
+    URHO3D_PROFILE_VALUE("TickTime", workTime / 1000.0);
+
+    // Schedule ticks at absolute times so that the rate does not drift. If the loop has fallen more than a tick
+    // behind, drop the backlog instead of running ticks back to back
+    long long now = tickTimer_.GetUSec(false);
+    if (!nextTickTime_)
+        nextTickTime_ = now;
+    nextTickTime_ += tickDuration;
+    if (now - nextTickTime_ > tickDuration)
+    {
+        numDroppedTicks_ += (unsigned)((now - nextTickTime_) / tickDuration);
+        nextTickTime_ = now;
+    }
+
+    // Sleep most of the remaining time to leave the CPU to other server instances, and yield for the last part
+    // as sleep granularity is coarse
+    while (now < nextTickTime_)
+    {
+        const long long remaining = nextTickTime_ - now;
+        Time::Sleep(remaining > TICK_YIELD_THRESHOLD_USEC ? (unsigned)((remaining - TICK_YIELD_THRESHOLD_USEC) / 1000LL) : 0);
+        now = tickTimer_.GetUSec(false);
+    }
+
+    frameTimer_.Reset();
+#ifdef URHO3D_TESTING
+    if (timeOut_ > 0)
+    {
+        timeOut_ -= tickDuration;
+        if (timeOut_ <= 0)
+            Exit();
+    }
+#endif
+
+    // Every tick advances the simulation by exactly the tick duration
+    timeStep_ = 1.0f / tickRate_;
+}
+
 void Engine::DefineParameters(CLI::App& commandLine, VariantMap& engineParameters)
 {
     auto addFlagInternal = [&](const char* name, const char* description, CLI::callback_t fun) {
@@ -899,6 +1181,7 @@ void Engine::DefineParameters(CLI::App& commandLine, VariantMap& engineParameter
 
     addFlag("--headless", EP_HEADLESS, true, "Do not initialize graphics subsystem");
     addFlag("--nolimit", EP_FRAME_LIMITER, false, "Disable frame limiter");
+    addOptionInt("--tick-rate", EP_TICK_RATE, "Run at a fixed tick rate, for dedicated servers together with --headless");
     addFlag("--flushgpu", EP_FLUSH_GPU, true, "Enable GPU flushing");
     addFlag("--gl2", EP_FORCE_GL2, true, "Force OpenGL2");
     addOptionPrependString("--landscape", EP_ORIENTATIONS, "LandscapeLeft LandscapeRight ", "Force landscape orientation");
@@ -931,6 +1214,8 @@ void Engine::DefineParameters(CLI::App& commandLine, VariantMap& engineParameter
         return true;
     })->set_custom_option(createOptions("string in {%s}", logLevelNames).c_str());
     addOptionString("--log-file", EP_LOG_NAME, "Log output file");
+    addFlag("--log-async", EP_LOG_ASYNC, true, "Write log output on a separate thread");
+    addOptionString("--hitch-reports", EP_HITCH_REPORT_PATH, "Save reports of frame hitches into the directory");
     addOptionInt("-x,--width", EP_WINDOW_WIDTH, "Window width");
     addOptionInt("-y,--height", EP_WINDOW_HEIGHT, "Window height");
     addOptionInt("--monitor", EP_MONITOR, "Create window on the specified monitor");
@@ -1014,10 +1299,15 @@ void Engine::HandleEndFrame(StringHash eventType, VariantMap& eventData)
 
 void Engine::DoExit()
 {
+    CompletePipelinedUpdate();
+
     auto* graphics = GetSubsystem<Graphics>();
     if (graphics)
         graphics->Close();
 
+    // Headless engine has no window whose closing would end the main loop
+    exiting_ = true;
+
 #if defined(__EMSCRIPTEN__) && defined(URHO3D_TESTING)
     emscripten_force_exit(EXIT_SUCCESS);    // Some how this is required to signal emrun to stop
 #endif
@@ -22,7 +22,9 @@
 
 #pragma once
 
+#include "../Core/CoreEvents.h"
 #include "../Core/Object.h"
+#include "../Core/Signal.h"
 #include "../Core/Timer.h"
 
 namespace CLI
@@ -37,6 +39,7 @@ namespace Urho3D
 
 class Console;
 class DebugHud;
+struct WorkItem;
 
 /// Urho3D engine. Creates the other subsystems.
 class URHO3D_API Engine : public Object
@@ -73,6 +76,14 @@ public:
     void SetAutoExit(bool enable);
     /// Override timestep of the next frame. Should be called in between RunFrame() calls.
     void SetNextTimeStep(float seconds);
+    /// Set fixed tick rate for running as a dedicated server. Each frame then advances exactly one tick, and the engine sleeps until the next tick is due instead of applying the frame limiter. Zero disables.
+    void SetTickRate(unsigned tickRate);
+    /// Reset tick time statistics.
+    void ResetTickStatistics();
+    /// Set whether the pipelined update signal runs on a worker thread while the frame is rendered.
+    void SetPipelinedUpdate(bool enable);
+    /// Wait until the pipelined update of the previous frame finishes. Called automatically before the frame update.
+    void CompletePipelinedUpdate();
     /// Close the graphics window and set the exit flag. No-op on iOS/tvOS, as an iOS/tvOS application can not legally exit.
     void Exit();
     /// Dump profiling information to the log.
@@ -115,6 +126,24 @@ public:
     /// Return whether the engine has been created in headless mode.
     bool IsHeadless() const { return headless_; }
 
+    /// Return fixed tick rate, or zero if not used.
+    unsigned GetTickRate() const { return tickRate_; }
+
+    /// Return whether the pipelined update signal runs on a worker thread while the frame is rendered.
+    bool GetPipelinedUpdate() const { return pipelinedUpdate_; }
+
+    /// Return histogram of tick work times in buckets of a tenth of the tick duration. The last bucket counts ticks which overran.
+    const ea::vector<unsigned>& GetTickTimeHistogram() const { return tickTimeHistogram_; }
+
+    /// Return longest tick work time in microseconds.
+    long long GetMaxTickTime() const { return maxTickTime_; }
+
+    /// Return number of ticks dropped because the loop fell more than a tick behind.
+    unsigned GetNumDroppedTicks() const { return numDroppedTicks_; }
+
+    /// Return a formatted string of tick time statistics.
+    ea::string PrintTickStatistics() const;
+
     /// Send frame update events.
     void Update();
     /// Render after frame update.
@@ -130,6 +159,17 @@ public:
     static const Variant
         & GetParameter(const VariantMap& parameters, const ea::string& parameter, const Variant& defaultValue = Variant::EMPTY);
 
+    /// Typed logic update signal, invoked before E_UPDATE. Its handlers, such as scene updates, therefore run before all E_UPDATE subscribers regardless of the subscription order.
+    Signal<UpdateEventArgs, Engine> onUpdate_;
+    /// Typed logic post-update signal, invoked before E_POSTUPDATE and all its subscribers.
+    Signal<UpdateEventArgs, Engine> onPostUpdate_;
+    /// Typed render update signal, invoked before E_RENDERUPDATE and all its subscribers.
+    Signal<UpdateEventArgs, Engine> onRenderUpdate_;
+    /// Typed post-render update signal, invoked before E_POSTRENDERUPDATE and all its subscribers.
+    Signal<UpdateEventArgs, Engine> onPostRenderUpdate_;
+    /// Typed pipelined update signal, invoked after E_POSTRENDERUPDATE. When pipelined update is enabled, handlers run on a worker thread while the frame is rendered and finish before the next frame update. They must not touch the scene or other state used by rendering, and must not subscribe or unsubscribe signals.
+    Signal<UpdateEventArgs, Engine> onPipelinedUpdate_;
+
 private:
     /// Set flag indicating that exit request has to be handled.
     void HandleExitRequested(StringHash eventType, VariantMap& eventData);
@@ -137,11 +177,33 @@ private:
     void HandleEndFrame(StringHash eventType, VariantMap& eventData);
     /// Actually perform the exit actions.
     void DoExit();
+    /// Record the tick work time and wait until the next tick is due.
+    void ApplyTickLimit();
+    /// Invoke the pipelined update signal, on a worker thread if enabled.
+    void StartPipelinedUpdate();
 
     /// App preference directory.
     ea::string appPreferencesDir_;
     /// Frame update timer.
     HiresTimer frameTimer_;
+    /// Fixed tick schedule timer.
+    HiresTimer tickTimer_;
+    /// Time when the next tick is due in microseconds, measured by the tick timer.
+    long long nextTickTime_{};
+    /// Tick work time histogram.
+    ea::vector<unsigned> tickTimeHistogram_;
+    /// Longest tick work time in microseconds.
+    long long maxTickTime_{};
+    /// Number of dropped ticks.
+    unsigned numDroppedTicks_{};
+    /// Fixed tick rate.
+    unsigned tickRate_{};
+    /// Work item of the running pipelined update.
+    SharedPtr<WorkItem> pipelinedUpdateItem_;
+    /// Timestep of the running pipelined update.
+    float pipelinedTimeStep_{};
+    /// Pipelined update flag.
+    bool pipelinedUpdate_{};
     /// Previous timesteps for smoothing.
     ea::vector<float> lastTimeSteps_;
     /// Next frame timestep in seconds.
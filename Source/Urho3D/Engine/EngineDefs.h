@@ -40,6 +40,10 @@ static const ea::string EP_FRAME_LIMITER = "FrameLimiter";
 static const ea::string EP_FULL_SCREEN = "FullScreen";
 static const ea::string EP_HEADLESS = "Headless";
 static const ea::string EP_HIGH_DPI = "HighDPI";
+static const ea::string EP_HITCH_MEDIAN_FACTOR = "HitchMedianFactor";
+static const ea::string EP_HITCH_REPORT_PATH = "HitchReportPath";
+static const ea::string EP_HITCH_THRESHOLD = "HitchThreshold";
+static const ea::string EP_LOG_ASYNC = "LogAsync";
 static const ea::string EP_LOG_LEVEL = "LogLevel";
 static const ea::string EP_LOG_NAME = "LogName";
 static const ea::string EP_LOG_QUIET = "LogQuiet";
@@ -51,6 +55,7 @@ static const ea::string EP_ORGANIZATION_NAME = "OrganizationName";
 static const ea::string EP_APPLICATION_NAME = "ApplicationName";
 static const ea::string EP_ORIENTATIONS = "Orientations";
 static const ea::string EP_PACKAGE_CACHE_DIR = "PackageCacheDir";
+static const ea::string EP_PIPELINED_UPDATE = "PipelinedUpdate";
 static const ea::string EP_RENDER_PATH = "RenderPath";
 static const ea::string EP_REFRESH_RATE = "RefreshRate";
 static const ea::string EP_RESOURCE_PACKAGES = "ResourcePackages";
@@ -66,6 +71,7 @@ static const ea::string EP_SOUND_STEREO = "SoundStereo";
 static const ea::string EP_TEXTURE_ANISOTROPY = "TextureAnisotropy";
 static const ea::string EP_TEXTURE_FILTER_MODE = "TextureFilterMode";
 static const ea::string EP_TEXTURE_QUALITY = "TextureQuality";
+static const ea::string EP_TICK_RATE = "TickRate";
 static const ea::string EP_TIME_OUT = "TimeOut";
 static const ea::string EP_TOUCH_EMULATION = "TouchEmulation";
 static const ea::string EP_TRIPLE_BUFFER = "TripleBuffer";
@@ -24,9 +24,37 @@
 
 #include "../Glow/BakedLightCache.h"
 
+#include "../IO/File.h"
+#include "../IO/FileSystem.h"
+#include "../IO/Log.h"
+
 namespace Urho3D
 {
 
+namespace
+{
+
+/// Write vector of trivially copyable elements.
+template <class T> void WriteVector(Serializer& dest, const ea::vector<T>& data)
+{
+    dest.WriteUInt(data.size());
+    dest.Write(data.data(), data.size() * sizeof(T));
+}
+
+/// Read vector of trivially copyable elements.
+template <class T> bool ReadVector(Deserializer& source, ea::vector<T>& data)
+{
+    const unsigned size = source.ReadUInt();
+    const unsigned numBytes = size * sizeof(T);
+    if (numBytes > source.GetSize() - source.GetPosition())
+        return false;
+
+    data.resize(size);
+    return source.Read(data.data(), numBytes) == numBytes;
+}
+
+}
+
 BakedLightCache::~BakedLightCache() = default;
 
 void BakedLightMemoryCache::StoreBakedChunk(const IntVector3& chunk, BakedSceneChunk bakedChunk)
@@ -62,4 +90,104 @@ ea::shared_ptr<const BakedLightmap> BakedLightMemoryCache::LoadLightmap(unsigned
     return iter != lightmapCache_.end() ? iter->second : nullptr;
 }
 
+BakedLightPersistentCache::BakedLightPersistentCache(Context* context, const ea::string& directory)
+    : context_(context)
+    , directory_(AddTrailingSlash(directory))
+{
+}
+
+void BakedLightPersistentCache::StoreDirectLight(unsigned lightmapIndex, unsigned key,
+    const LightmapChartBakedDirect& bakedDirect)
+{
+    File file(context_);
+    if (!BeginStore(file, Format("Direct-{}.bin", lightmapIndex), key))
+        return;
+
+    file.WriteUInt(bakedDirect.lightmapSize_);
+    WriteVector(file, bakedDirect.directLight_);
+    WriteVector(file, bakedDirect.surfaceLight_);
+    WriteVector(file, bakedDirect.albedo_);
+}
+
+bool BakedLightPersistentCache::LoadDirectLight(unsigned lightmapIndex, unsigned key,
+    LightmapChartBakedDirect& bakedDirect)
+{
+    File file(context_);
+    if (!BeginLoad(file, Format("Direct-{}.bin", lightmapIndex), key))
+        return false;
+
+    bakedDirect.lightmapSize_ = file.ReadUInt();
+    bakedDirect.realLightmapSize_ = static_cast<float>(bakedDirect.lightmapSize_);
+    const unsigned numTexels = bakedDirect.lightmapSize_ * bakedDirect.lightmapSize_;
+    return ReadVector(file, bakedDirect.directLight_) && bakedDirect.directLight_.size() == numTexels
+        && ReadVector(file, bakedDirect.surfaceLight_) && bakedDirect.surfaceLight_.size() == numTexels
+        && ReadVector(file, bakedDirect.albedo_) && bakedDirect.albedo_.size() == numTexels;
+}
+
+void BakedLightPersistentCache::StoreLightmap(unsigned lightmapIndex, unsigned key, const BakedLightmap& bakedLightmap)
+{
+    File file(context_);
+    if (!BeginStore(file, Format("Lightmap-{}.bin", lightmapIndex), key))
+        return;
+
+    file.WriteUInt(bakedLightmap.lightmapSize_);
+    WriteVector(file, bakedLightmap.lightmap_);
+}
+
+bool BakedLightPersistentCache::LoadLightmap(unsigned lightmapIndex, unsigned key, BakedLightmap& bakedLightmap)
+{
+    File file(context_);
+    if (!BeginLoad(file, Format("Lightmap-{}.bin", lightmapIndex), key))
+        return false;
+
+    bakedLightmap.lightmapSize_ = file.ReadUInt();
+    return ReadVector(file, bakedLightmap.lightmap_)
+        && bakedLightmap.lightmap_.size() == bakedLightmap.lightmapSize_ * bakedLightmap.lightmapSize_;
+}
+
+void BakedLightPersistentCache::StoreLightProbes(const IntVector3& chunk, unsigned key,
+    const LightProbeCollectionBakedData& bakedData)
+{
+    File file(context_);
+    if (!BeginStore(file, Format("LightProbes-{}-{}-{}.bin", chunk.x_, chunk.y_, chunk.z_), key))
+        return;
+
+    WriteVector(file, bakedData.sphericalHarmonics_);
+    WriteVector(file, bakedData.ambient_);
+}
+
+bool BakedLightPersistentCache::LoadLightProbes(const IntVector3& chunk, unsigned key,
+    LightProbeCollectionBakedData& bakedData)
+{
+    File file(context_);
+    if (!BeginLoad(file, Format("LightProbes-{}-{}-{}.bin", chunk.x_, chunk.y_, chunk.z_), key))
+        return false;
+
+    return ReadVector(file, bakedData.sphericalHarmonics_) && ReadVector(file, bakedData.ambient_)
+        && bakedData.sphericalHarmonics_.size() == bakedData.ambient_.size();
+}
+
+bool BakedLightPersistentCache::BeginStore(File& file, const ea::string& fileName, unsigned key)
+{
+    FileSystem* fs = context_->GetFileSystem();
+    if (!fs->CreateDirsRecursive(directory_) || !file.Open(directory_ + fileName, FILE_WRITE))
+    {
+        URHO3D_LOGERROR("Cannot write baked light cache file \"{}\"", directory_ + fileName);
+        return false;
+    }
+
+    file.WriteFileID("BLCF");
+    file.WriteUInt(key);
+    return true;
+}
+
+bool BakedLightPersistentCache::BeginLoad(File& file, const ea::string& fileName, unsigned key)
+{
+    const ea::string filePath = directory_ + fileName;
+    if (!context_->GetFileSystem()->FileExists(filePath) || !file.Open(filePath, FILE_READ))
+        return false;
+
+    return file.ReadFileID() == "BLCF" && file.ReadUInt() == key;
+}
+
 }
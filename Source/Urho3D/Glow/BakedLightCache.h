@@ -37,6 +37,8 @@
 namespace Urho3D
 {
 
+class File;
+
 /// Baked lightmap data.
 struct BakedLightmap
 {
@@ -105,4 +107,39 @@ private:
     ea::unordered_map<unsigned, ea::shared_ptr<const BakedLightmap>> lightmapCache_;
 };
 
+/// Persistent on-disk cache of baked light. Entries are keyed by hash of baking inputs and survive between bakes.
+/// Only the latest entry is kept for each lightmap or chunk, load fails if stored key doesn't match.
+class URHO3D_API BakedLightPersistentCache
+{
+public:
+    /// Construct.
+    BakedLightPersistentCache(Context* context, const ea::string& directory);
+
+    /// Store direct light for the lightmap chart.
+    void StoreDirectLight(unsigned lightmapIndex, unsigned key, const LightmapChartBakedDirect& bakedDirect);
+    /// Load direct light for the lightmap chart. Return false if not cached with given key.
+    bool LoadDirectLight(unsigned lightmapIndex, unsigned key, LightmapChartBakedDirect& bakedDirect);
+
+    /// Store baked lightmap.
+    void StoreLightmap(unsigned lightmapIndex, unsigned key, const BakedLightmap& bakedLightmap);
+    /// Load baked lightmap. Return false if not cached with given key.
+    bool LoadLightmap(unsigned lightmapIndex, unsigned key, BakedLightmap& bakedLightmap);
+
+    /// Store baked light probes of the chunk.
+    void StoreLightProbes(const IntVector3& chunk, unsigned key, const LightProbeCollectionBakedData& bakedData);
+    /// Load baked light probes of the chunk. Return false if not cached with given key.
+    bool LoadLightProbes(const IntVector3& chunk, unsigned key, LightProbeCollectionBakedData& bakedData);
+
+private:
+    /// Open cache file for writing and write header.
+    bool BeginStore(File& file, const ea::string& fileName, unsigned key);
+    /// Open cache file for reading and check header.
+    bool BeginLoad(File& file, const ea::string& fileName, unsigned key);
+
+    /// Context.
+    Context* context_{};
+    /// Cache directory.
+    ea::string directory_;
+};
+
 }
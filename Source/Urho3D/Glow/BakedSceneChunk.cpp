@@ -24,8 +24,11 @@
 
 #include "../Glow/BakedSceneChunk.h"
 
+#include "../Container/Hash.h"
 #include "../Glow/LightTracer.h"
+#include "../Graphics/Light.h"
 #include "../IO/Log.h"
+#include "../Scene/Node.h"
 
 #include <EASTL/sort.h>
 
@@ -186,6 +189,68 @@ ea::vector<unsigned> CollectLightmapsInChunk(const LightmapChartGeometryBufferVe
     return lightmapsInChunk;
 }
 
+/// Hash contents of vector by raw 32-bit words.
+template <class T> void HashRawData(unsigned& hash, const ea::vector<T>& data)
+{
+    static_assert(sizeof(T) % sizeof(unsigned) == 0, "Element size must be multiple of 32 bits");
+
+    const unsigned numWords = data.size() * sizeof(T) / sizeof(unsigned);
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data.data());
+    for (unsigned i = 0; i < numWords; ++i)
+    {
+        unsigned word;
+        memcpy(&word, bytes + i * sizeof(unsigned), sizeof(unsigned));
+        CombineHash(hash, word);
+    }
+}
+
+/// Hash scene component: type, world transform and attributes.
+void HashComponent(unsigned& hash, Component* component)
+{
+    CombineHash(hash, component->GetType().Value());
+    CombineHash(hash, component->GetNode()->GetWorldTransform().ToHash());
+    for (unsigned i = 0; i < component->GetNumAttributes(); ++i)
+        CombineHash(hash, component->GetAttribute(i).ToHash());
+}
+
+/// Calculate hash of all chunk inputs.
+unsigned CalculateChunkInputHash(const LightmapChartGeometryBufferVector& geometryBuffers,
+    const ea::vector<Component*>& geometriesInChunk, const ea::vector<Light*>& lightsInChunk,
+    const LightProbeCollection& lightProbesCollection, const RaytracingBackground& raytracingBackground)
+{
+    unsigned hash = 0;
+
+    // Geometry buffers contain exact geometry and material data of lightmap receivers
+    for (const LightmapChartGeometryBuffer& geometryBuffer : geometryBuffers)
+    {
+        CombineHash(hash, geometryBuffer.index_);
+        CombineHash(hash, geometryBuffer.lightmapSize_);
+        HashRawData(hash, geometryBuffer.positions_);
+        HashRawData(hash, geometryBuffer.smoothNormals_);
+        HashRawData(hash, geometryBuffer.faceNormals_);
+        HashRawData(hash, geometryBuffer.geometryIds_);
+        HashRawData(hash, geometryBuffer.texelRadiuses_);
+        HashRawData(hash, geometryBuffer.albedo_);
+        HashRawData(hash, geometryBuffer.emission_);
+    }
+
+    // Shadow casters and indirect light sources are identified by attributes
+    for (Component* geometry : geometriesInChunk)
+        HashComponent(hash, geometry);
+
+    for (Light* light : lightsInChunk)
+        HashComponent(hash, light);
+
+    HashRawData(hash, lightProbesCollection.worldPositions_);
+
+    CombineHash(hash, raytracingBackground.lightIntensity_.ToHash());
+    CombineHash(hash, FloatToRawIntBits(raytracingBackground.backgroundImageBrightness_));
+    if (raytracingBackground.backgroundImage_)
+        CombineHash(hash, raytracingBackground.backgroundImage_->GetNameHash().Value());
+
+    return hash;
+}
+
 /// Collect direct lightmaps required for chunk.
 ea::vector<unsigned> CollectLightmapsRequiredForChunk(const ea::vector<RaytracerGeometry>& raytracerGeometries)
 {
@@ -257,6 +322,8 @@ BakedSceneChunk CreateBakedSceneChunk(Context* context,
     bakedChunk.bakedLights_ = CreateBakedLights(lightsInChunk);
     bakedChunk.lightProbesCollection_ = ea::move(lightProbesCollection);
     bakedChunk.numUniqueLightProbes_ = uniqueLightProbeGroups.size();
+    bakedChunk.inputHash_ = CalculateChunkInputHash(bakedChunk.geometryBuffers_, geometriesInChunk,
+        lightsInChunk, bakedChunk.lightProbesCollection_, raytracingBackground);
 
     return bakedChunk;
 }
@@ -52,6 +52,8 @@ struct BakedSceneChunk
     LightProbeCollection lightProbesCollection_;
     /// Number of unique light probe groups. Used for saving results.
     unsigned numUniqueLightProbes_{};
+    /// Hash of all inputs affecting baked light of this chunk: geometries, materials, lights and light probes.
+    unsigned inputHash_{};
 };
 
 /// Create baked scene chunk.
@@ -24,6 +24,7 @@
 
 #include "../Glow/IncrementalLightBaker.h"
 
+#include "../Container/Hash.h"
 #include "../Core/Context.h"
 #include "../Glow/BakedSceneChunk.h"
 #include "../Glow/LightmapCharter.h"
@@ -93,6 +94,51 @@ unsigned long long Swizzle(const IntVector3& vec, const IntVector3& base = IntVe
     return result;
 }
 
+/// Calculate hash of baking settings that affect baked light.
+unsigned CalculateSettingsHash(const LightBakingSettings& settings)
+{
+    const unsigned values[] = {
+        settings.charting_.lightmapSize_,
+        settings.geometryBufferBaking_.uvChannel_,
+        FloatToRawIntBits(settings.geometryBufferPreprocessing_.constPositionBackfaceBias_),
+        FloatToRawIntBits(settings.geometryBufferPreprocessing_.scaledPositionBackfaceBias_),
+        settings.directChartTracing_.maxSamples_,
+        settings.directProbesTracing_.maxSamples_,
+        settings.indirectChartTracing_.maxSamples_,
+        settings.indirectChartTracing_.maxBounces_,
+        FloatToRawIntBits(settings.indirectChartTracing_.scaledPositionBounceBias_),
+        FloatToRawIntBits(settings.indirectChartTracing_.constPositionBounceBias_),
+        FloatToRawIntBits(settings.indirectChartTracing_.maxRelativeError_),
+        settings.indirectChartTracing_.minAdaptiveSamples_,
+        settings.indirectProbesTracing_.maxSamples_,
+        settings.indirectProbesTracing_.maxBounces_,
+        FloatToRawIntBits(settings.indirectProbesTracing_.scaledPositionBounceBias_),
+        FloatToRawIntBits(settings.indirectProbesTracing_.constPositionBounceBias_),
+        static_cast<unsigned>(settings.directFilter_.kernelRadius_),
+        static_cast<unsigned>(settings.directFilter_.upscale_),
+        FloatToRawIntBits(settings.directFilter_.luminanceSigma_),
+        FloatToRawIntBits(settings.directFilter_.normalPower_),
+        FloatToRawIntBits(settings.directFilter_.positionSigma_),
+        settings.directFilter_.atrous_,
+        settings.directFilter_.numPasses_,
+        static_cast<unsigned>(settings.indirectFilter_.kernelRadius_),
+        static_cast<unsigned>(settings.indirectFilter_.upscale_),
+        FloatToRawIntBits(settings.indirectFilter_.luminanceSigma_),
+        FloatToRawIntBits(settings.indirectFilter_.normalPower_),
+        FloatToRawIntBits(settings.indirectFilter_.positionSigma_),
+        settings.indirectFilter_.atrous_,
+        settings.indirectFilter_.numPasses_,
+        FloatToRawIntBits(settings.properties_.emissionBrightness_),
+        FloatToRawIntBits(settings.incremental_.indirectPadding_),
+        FloatToRawIntBits(settings.incremental_.directionalLightShadowDistance_),
+    };
+
+    unsigned hash = 0;
+    for (unsigned value : values)
+        CombineHash(hash, value);
+    return hash;
+}
+
 }
 
 /// Incremental light baker implementation.
@@ -138,6 +184,12 @@ struct IncrementalLightBaker::Impl
 
         settings_.incremental_.outputDirectory_ = AddTrailingSlash(settings_.incremental_.outputDirectory_);
 
+        if (settings_.incremental_.persistentCache_)
+        {
+            persistentCache_ = ea::make_unique<BakedLightPersistentCache>(context_,
+                settings_.incremental_.outputDirectory_ + settings_.incremental_.persistentCacheDirectory_);
+        }
+
         FileSystem* fs = context_->GetFileSystem();
         if (!fs->CreateDir(settings_.incremental_.outputDirectory_))
         {
@@ -233,11 +285,43 @@ struct IncrementalLightBaker::Impl
     /// Generate baking chunks.
     void GenerateBakingChunks()
     {
+        const unsigned settingsHash = CalculateSettingsHash(settings_);
+        ea::vector<unsigned> lightmapKeys(numLightmapCharts_);
+        directKeys_.clear();
+        indirectKeys_.clear();
+
         for (const IntVector3& chunk : chunks_)
         {
             BakedSceneChunk bakedChunk = CreateBakedSceneChunk(context_, *collector_, chunk, settings_);
+
+            // Direct light depends only on chunk inputs
+            unsigned directKey = bakedChunk.inputHash_;
+            CombineHash(directKey, settingsHash);
+            directKeys_[chunk] = directKey;
+            for (unsigned lightmapIndex : bakedChunk.lightmaps_)
+            {
+                if (lightmapIndex < lightmapKeys.size())
+                    lightmapKeys[lightmapIndex] = directKey;
+            }
+
             cache_->StoreBakedChunk(chunk, ea::move(bakedChunk));
         }
+
+        // Indirect light also depends on direct light of all neighbour lightmaps within indirect padding
+        for (const IntVector3& chunk : chunks_)
+        {
+            const ea::shared_ptr<const BakedSceneChunk> bakedChunk = cache_->LoadBakedChunk(chunk);
+            ea::vector<unsigned> requiredDirectLightmaps = bakedChunk->requiredDirectLightmaps_;
+            ea::sort(requiredDirectLightmaps.begin(), requiredDirectLightmaps.end());
+
+            unsigned indirectKey = directKeys_[chunk];
+            for (unsigned lightmapIndex : requiredDirectLightmaps)
+            {
+                CombineHash(indirectKey, lightmapIndex);
+                CombineHash(indirectKey, lightmapIndex < lightmapKeys.size() ? lightmapKeys[lightmapIndex] : 0);
+            }
+            indirectKeys_[chunk] = indirectKey;
+        }
     }
 
     /// Step direct light for charts.
@@ -246,6 +330,7 @@ struct IncrementalLightBaker::Impl
         for (const IntVector3 chunk : chunks_)
         {
             const ea::shared_ptr<const BakedSceneChunk> bakedChunk = cache_->LoadBakedChunk(chunk);
+            const unsigned directKey = directKeys_[chunk];
 
             // Bake direct lighting
             for (unsigned i = 0; i < bakedChunk->lightmaps_.size(); ++i)
@@ -255,17 +340,26 @@ struct IncrementalLightBaker::Impl
 
                 const unsigned lightmapIndex = bakedChunk->lightmaps_[i];
                 const LightmapChartGeometryBuffer& geometryBuffer = bakedChunk->geometryBuffers_[i];
-                LightmapChartBakedDirect bakedDirect{ geometryBuffer.lightmapSize_ };
-
-                // Bake emission
-                BakeEmissionLight(bakedDirect, geometryBuffer,
-                    settings_.emissionTracing_, settings_.properties_.emissionBrightness_);
 
-                // Bake direct lights for charts
-                for (const BakedLight& bakedLight : bakedChunk->bakedLights_)
+                // Reuse persistent cache if chunk inputs are not changed
+                LightmapChartBakedDirect bakedDirect;
+                if (!persistentCache_ || !persistentCache_->LoadDirectLight(lightmapIndex, directKey, bakedDirect))
                 {
-                    BakeDirectLightForCharts(bakedDirect, geometryBuffer, *bakedChunk->raytracerScene_,
-                        bakedChunk->geometryBufferToRaytracer_, bakedLight, settings_.directChartTracing_);
+                    bakedDirect = LightmapChartBakedDirect{ geometryBuffer.lightmapSize_ };
+
+                    // Bake emission
+                    BakeEmissionLight(bakedDirect, geometryBuffer,
+                        settings_.emissionTracing_, settings_.properties_.emissionBrightness_);
+
+                    // Bake direct lights for charts
+                    for (const BakedLight& bakedLight : bakedChunk->bakedLights_)
+                    {
+                        BakeDirectLightForCharts(bakedDirect, geometryBuffer, *bakedChunk->raytracerScene_,
+                            bakedChunk->geometryBufferToRaytracer_, bakedLight, settings_.directChartTracing_);
+                    }
+
+                    if (persistentCache_)
+                        persistentCache_->StoreDirectLight(lightmapIndex, directKey, bakedDirect);
                 }
 
                 // Store direct light
@@ -291,6 +385,14 @@ struct IncrementalLightBaker::Impl
                 return false;
 
             const ea::shared_ptr<const BakedSceneChunk> bakedChunk = cache_->LoadBakedChunk(chunk);
+            const unsigned indirectKey = indirectKeys_[chunk];
+
+            // Reuse persistent cache if neither chunk inputs nor direct light of neighbour lightmaps are changed
+            if (persistentCache_ && LoadCachedChunk(chunk, *bakedChunk, indirectKey, lightProbesBakedData))
+            {
+                SaveLightProbes(chunk, *bakedChunk, lightProbesBakedData);
+                continue;
+            }
 
             // Collect required direct lightmaps
             ea::vector<ea::shared_ptr<const LightmapChartBakedDirect>> bakedDirectLightmapsRefs(numLightmapCharts_);
@@ -356,6 +458,8 @@ struct IncrementalLightBaker::Impl
                 }
 
                 // Store lightmap
+                if (persistentCache_)
+                    persistentCache_->StoreLightmap(lightmapIndex, indirectKey, bakedLightmap);
                 cache_->StoreLightmap(lightmapIndex, ea::move(bakedLightmap));
             }
 
@@ -368,17 +472,9 @@ struct IncrementalLightBaker::Impl
             }
 
             // Save light probes
-            for (unsigned groupIndex = 0; groupIndex < bakedChunk->numUniqueLightProbes_; ++groupIndex)
-            {
-                if (!LightProbeGroup::SaveLightProbesBakedData(context_,
-                    bakedChunk->lightProbesCollection_, lightProbesBakedData, groupIndex))
-                {
-                    const ea::string groupName = groupIndex < bakedChunk->lightProbesCollection_.GetNumGroups()
-                        ? bakedChunk->lightProbesCollection_.names_[groupIndex] : "";
-                    URHO3D_LOGERROR("Cannot save light probes for group '{}' in chunk {}",
-                        groupName, chunk.ToString());
-                }
-            }
+            if (persistentCache_)
+                persistentCache_->StoreLightProbes(chunk, indirectKey, lightProbesBakedData);
+            SaveLightProbes(chunk, *bakedChunk, lightProbesBakedData);
         }
         return true;
     }
@@ -442,18 +538,65 @@ struct IncrementalLightBaker::Impl
                 // Save image to destination folder
                 const ea::string fileName = GetLightmapFileName(lightmapIndex);
                 context_->GetFileSystem()->CreateDirsRecursive(GetPath(fileName));
-                lightmapImage->SaveFile(fileName);
+                if (settings_.incremental_.compressLightmaps_)
+                {
+                    SharedPtr<Image> compressedImage = lightmapImage->GetCompressedImage(CF_DXT1);
+                    if (!compressedImage || !compressedImage->SaveDDS(fileName))
+                        URHO3D_LOGERROR("Cannot save compressed lightmap \"{}\"", fileName);
+                }
+                else
+                    lightmapImage->SaveFile(fileName);
             }
         }
     }
 
 private:
+    /// Load baked lightmaps and light probes of the chunk from persistent cache. Return false if any is missing.
+    bool LoadCachedChunk(const IntVector3& chunk, const BakedSceneChunk& bakedChunk, unsigned key,
+        LightProbeCollectionBakedData& lightProbesBakedData)
+    {
+        if (!persistentCache_->LoadLightProbes(chunk, key, lightProbesBakedData)
+            || lightProbesBakedData.Size() != bakedChunk.lightProbesCollection_.GetNumProbes())
+            return false;
+
+        ea::vector<BakedLightmap> bakedLightmaps(bakedChunk.lightmaps_.size());
+        for (unsigned i = 0; i < bakedChunk.lightmaps_.size(); ++i)
+        {
+            if (!persistentCache_->LoadLightmap(bakedChunk.lightmaps_[i], key, bakedLightmaps[i])
+                || bakedLightmaps[i].lightmapSize_ != settings_.charting_.lightmapSize_)
+                return false;
+        }
+
+        for (unsigned i = 0; i < bakedChunk.lightmaps_.size(); ++i)
+            cache_->StoreLightmap(bakedChunk.lightmaps_[i], ea::move(bakedLightmaps[i]));
+        return true;
+    }
+
+    /// Save baked data of unique light probe groups of the chunk.
+    void SaveLightProbes(const IntVector3& chunk, const BakedSceneChunk& bakedChunk,
+        const LightProbeCollectionBakedData& lightProbesBakedData)
+    {
+        for (unsigned groupIndex = 0; groupIndex < bakedChunk.numUniqueLightProbes_; ++groupIndex)
+        {
+            if (!LightProbeGroup::SaveLightProbesBakedData(context_,
+                bakedChunk.lightProbesCollection_, lightProbesBakedData, groupIndex))
+            {
+                const ea::string groupName = groupIndex < bakedChunk.lightProbesCollection_.GetNumGroups()
+                    ? bakedChunk.lightProbesCollection_.names_[groupIndex] : "";
+                URHO3D_LOGERROR("Cannot save light probes for group '{}' in chunk {}",
+                    groupName, chunk.ToString());
+            }
+        }
+    }
+
     /// Return lightmap file name.
     ea::string GetLightmapFileName(unsigned lightmapIndex)
     {
         ea::string fileName;
         fileName += settings_.incremental_.outputDirectory_;
         fileName += Format(settings_.incremental_.lightmapNameFormat_, lightmapIndex);
+        if (settings_.incremental_.compressLightmaps_)
+            fileName = ReplaceExtension(fileName, ".dds");
         return fileName;
     }
 
@@ -477,6 +620,12 @@ private:
     BakedSceneCollector* collector_{};
     /// Lightmap cache.
     BakedLightCache* cache_{};
+    /// Persistent lightmap cache, if enabled.
+    ea::unique_ptr<BakedLightPersistentCache> persistentCache_;
+    /// Persistent cache keys of direct light per chunk.
+    ea::unordered_map<IntVector3, unsigned> directKeys_;
+    /// Persistent cache keys of indirect light and light probes per chunk.
+    ea::unordered_map<IntVector3, unsigned> indirectKeys_;
     /// List of all chunks.
     ea::vector<IntVector3> chunks_;
     /// Number of lightmap charts.
@@ -40,6 +40,9 @@ namespace Urho3D
 namespace
 {
 
+/// Number of rays traced together in one packet for direct light.
+static const unsigned DirectLightRayPacketSize = 8;
+
 /// Calculate bias scale based on position.
 float CalculateBiasScale(const Vector3& position)
 {
@@ -206,7 +209,7 @@ void GeometryBufferPreprocessFilter(const RTCFilterFunctionNArguments* args)
 /// Base context for direct light tracing.
 struct DirectTracingContextBase : public RTCIntersectContext
 {
-    /// Incoming light accumulator.
+    /// Incoming light accumulators, indexed by ray ID.
     Vector3* incomingLight_{};
 };
 
@@ -223,21 +226,25 @@ struct DirectTracingContextForCharts : public DirectTracingContextBase
 void TracingFilterForChartsDirect(const RTCFilterFunctionNArguments* args)
 {
     const auto& ctx = *static_cast<const DirectTracingContextForCharts*>(args->context);
-    auto& hit = *reinterpret_cast<RTCHit*>(args->hit);
-    assert(args->N == 1);
 
-    // Ignore invalid
-    if (args->valid[0] == 0)
-        return;
+    for (unsigned i = 0; i < args->N; ++i)
+    {
+        // Ignore invalid
+        if (args->valid[i] == 0)
+            continue;
 
-    // Ignore if unwanted LOD
-    const RaytracerGeometry& hitGeometry = (*ctx.geometryIndex_)[hit.geomID];
-    if (IsUnwantedLod(*ctx.currentGeometry_, hitGeometry))
-        args->valid[0] = 0;
+        const RTCHit hit = rtcGetHitFromHitN(args->hit, args->N, i);
+        Vector3& incomingLight = ctx.incomingLight_[RTCRayN_id(args->ray, args->N, i)];
 
-    // Accumulate and ignore if transparent
-    if (IsTransparedForDirect(hitGeometry, hit, *ctx.incomingLight_))
-        args->valid[0] = 0;
+        // Ignore if unwanted LOD
+        const RaytracerGeometry& hitGeometry = (*ctx.geometryIndex_)[hit.geomID];
+        if (IsUnwantedLod(*ctx.currentGeometry_, hitGeometry))
+            args->valid[i] = 0;
+
+        // Accumulate and ignore if transparent
+        if (IsTransparedForDirect(hitGeometry, hit, incomingLight))
+            args->valid[i] = 0;
+    }
 }
 
 /// Ray tracing context for direct light baking for light probes.
@@ -251,21 +258,25 @@ struct DirectTracingContextForLightProbes : public DirectTracingContextBase
 void TracingFilterForLightProbesDirect(const RTCFilterFunctionNArguments* args)
 {
     const auto& ctx = *static_cast<const DirectTracingContextForLightProbes*>(args->context);
-    auto& hit = *reinterpret_cast<RTCHit*>(args->hit);
-    assert(args->N == 1);
 
-    // Ignore invalid
-    if (args->valid[0] == 0)
-        return;
+    for (unsigned i = 0; i < args->N; ++i)
+    {
+        // Ignore invalid
+        if (args->valid[i] == 0)
+            continue;
 
-    // Ignore if LOD
-    const RaytracerGeometry& hitGeometry = (*ctx.geometryIndex_)[hit.geomID];
-    if (hitGeometry.lodIndex_ != 0)
-        args->valid[0] = 0;
+        const RTCHit hit = rtcGetHitFromHitN(args->hit, args->N, i);
+        Vector3& incomingLight = ctx.incomingLight_[RTCRayN_id(args->ray, args->N, i)];
 
-    // Accumulate and ignore if transparent
-    if (IsTransparedForDirect(hitGeometry, hit, *ctx.incomingLight_))
-        args->valid[0] = 0;
+        // Ignore if LOD
+        const RaytracerGeometry& hitGeometry = (*ctx.geometryIndex_)[hit.geomID];
+        if (hitGeometry.lodIndex_ != 0)
+            args->valid[i] = 0;
+
+        // Accumulate and ignore if transparent
+        if (IsTransparedForDirect(hitGeometry, hit, incomingLight))
+            args->valid[i] = 0;
+    }
 }
 
 /// Ray generator for directional light.
@@ -551,17 +562,24 @@ void TraceDirectLight(T sharedKernel, U sharedGenerator,
         auto kernel = sharedKernel;
         auto generator = sharedGenerator;
 
+        // All samples of an element end at the same position, so rays of the packet are coherent
         auto rayContext = sharedKernel.GetRayContext();
+        rayContext.flags = RTC_INTERSECT_CONTEXT_FLAG_COHERENT;
 
-        Vector3 incomingLightIntensity;
-        rayContext.incomingLight_ = &incomingLightIntensity;
+        Vector3 incomingLightIntensity[DirectLightRayPacketSize];
+        Vector3 incomingLightDirection[DirectLightRayPacketSize];
+        rayContext.incomingLight_ = incomingLightIntensity;
 
-        RTCRayHit rayHit;
-        rayHit.ray.mask = sharedKernel.GetGeometryMask();
-        rayHit.ray.tnear = 0.0f;
-        rayHit.ray.time = 0.0f;
-        rayHit.ray.id = 0;
-        rayHit.ray.flags = 0;
+        alignas(32) int valid[DirectLightRayPacketSize];
+        RTCRayHit8 rayHit;
+        for (unsigned lane = 0; lane < DirectLightRayPacketSize; ++lane)
+        {
+            rayHit.ray.mask[lane] = sharedKernel.GetGeometryMask();
+            rayHit.ray.tnear[lane] = 0.0f;
+            rayHit.ray.time[lane] = 0.0f;
+            rayHit.ray.id[lane] = lane;
+            rayHit.ray.flags[lane] = 0;
+        }
 
         for (unsigned elementIndex = fromIndex; elementIndex < toIndex; ++elementIndex)
         {
@@ -569,28 +587,49 @@ void TraceDirectLight(T sharedKernel, U sharedGenerator,
             if (!kernel.BeginElement(elementIndex, rayContext, position))
                 continue;
 
-            for (unsigned sampleIndex = 0; sampleIndex < kernel.GetNumSamples(); ++sampleIndex)
+            const unsigned numSamples = kernel.GetNumSamples();
+            for (unsigned packetBegin = 0; packetBegin < numSamples; packetBegin += DirectLightRayPacketSize)
             {
-                kernel.BeginSample(sampleIndex);
+                const unsigned packetSize = ea::min(numSamples - packetBegin, DirectLightRayPacketSize);
+
+                // Generate rays, disable lanes of empty samples
+                bool anyValid = false;
+                for (unsigned lane = 0; lane < DirectLightRayPacketSize; ++lane)
+                {
+                    valid[lane] = 0;
+                    if (lane >= packetSize)
+                        continue;
+
+                    kernel.BeginSample(packetBegin + lane);
+
+                    Vector3 rayOffset;
+                    if (!generator.Generate(position, rayOffset, incomingLightIntensity[lane], incomingLightDirection[lane]))
+                        continue;
+
+                    valid[lane] = -1;
+                    anyValid = true;
+
+                    rayHit.ray.dir_x[lane] = rayOffset.x_;
+                    rayHit.ray.dir_y[lane] = rayOffset.y_;
+                    rayHit.ray.dir_z[lane] = rayOffset.z_;
+                    rayHit.ray.org_x[lane] = position.x_ - rayOffset.x_;
+                    rayHit.ray.org_y[lane] = position.y_ - rayOffset.y_;
+                    rayHit.ray.org_z[lane] = position.z_ - rayOffset.z_;
+                    rayHit.ray.tfar[lane] = 1.0f;
+                    rayHit.hit.geomID[lane] = RTC_INVALID_GEOMETRY_ID;
+                }
 
-                Vector3 rayOffset;
-                Vector3 incomingLightDirection;
-                if (!generator.Generate(position, rayOffset, incomingLightIntensity, incomingLightDirection))
+                if (!anyValid)
                     continue;
 
-                // Cast direct ray
-                rayHit.ray.dir_x = rayOffset.x_;
-                rayHit.ray.dir_y = rayOffset.y_;
-                rayHit.ray.dir_z = rayOffset.z_;
-                rayHit.ray.org_x = position.x_ - rayOffset.x_;
-                rayHit.ray.org_y = position.y_ - rayOffset.y_;
-                rayHit.ray.org_z = position.z_ - rayOffset.z_;
-                rayHit.ray.tfar = 1.0f;
-                rayHit.hit.geomID = RTC_INVALID_GEOMETRY_ID;
-                rtcIntersect1(scene, &rayContext, &rayHit);
+                // Cast direct rays
+                rtcIntersect8(valid, scene, &rayContext, &rayHit);
 
-                if (rayHit.hit.geomID == RTC_INVALID_GEOMETRY_ID)
-                    kernel.EndSample(incomingLightIntensity, incomingLightDirection);
+                for (unsigned lane = 0; lane < packetSize; ++lane)
+                {
+                    if (valid[lane] && rayHit.hit.geomID[lane] == RTC_INVALID_GEOMETRY_ID)
+                        kernel.EndSample(incomingLightIntensity[lane], incomingLightDirection[lane]);
+                }
             }
 
             kernel.EndElement(elementIndex);
@@ -651,6 +690,10 @@ struct ChartIndirectTracingKernel
 
     /// Accumulated indirect light value.
     Vector4 accumulatedIndirectLight_;
+    /// Accumulated luminance of samples.
+    float accumulatedLuminance_{};
+    /// Accumulated squared luminance of samples.
+    float accumulatedSquaredLuminance_{};
 
     /// Last sampled tetrahedron.
     unsigned lightProbesMeshHint_{};
@@ -686,6 +729,8 @@ struct ChartIndirectTracingKernel
         }
 
         accumulatedIndirectLight_ = Vector4::ZERO;
+        accumulatedLuminance_ = 0.0f;
+        accumulatedSquaredLuminance_ = 0.0f;
 
         return true;
     };
@@ -705,9 +750,27 @@ struct ChartIndirectTracingKernel
     void EndSample(const Vector3& light)
     {
         accumulatedIndirectLight_ += Vector4(light, 1.0f);
+
+        const float luminance = Color(light).Luma();
+        accumulatedLuminance_ += luminance;
+        accumulatedSquaredLuminance_ += luminance * luminance;
     }
 
-    /// End tracing element.
+    /// Return whether the element estimate reached target error and sampling may stop.
+    bool IsConverged(unsigned numSamples) const
+    {
+        if (settings_->maxRelativeError_ <= 0.0f || numSamples < ea::max(settings_->minAdaptiveSamples_, 2u))
+            return false;
+
+        // Standard error of the mean luminance
+        const float invNumSamples = 1.0f / numSamples;
+        const float mean = accumulatedLuminance_ * invNumSamples;
+        const float variance = ea::max(0.0f, accumulatedSquaredLuminance_ * invNumSamples - mean * mean);
+        const float standardError = Sqrt(variance * invNumSamples);
+        return standardError <= settings_->maxRelativeError_ * ea::max(mean, M_LARGE_EPSILON);
+    }
+
+    /// End tracing element. Light is normalized later by the number of taken samples.
     void EndElement(unsigned elementIndex)
     {
         bakedIndirect_->light_[elementIndex] += accumulatedIndirectLight_;
@@ -767,6 +830,9 @@ struct LightProbeIndirectTracingKernel
         accumulatedLightSH_ += SphericalHarmonicsColor9(currentSampleDirection_, light);
     }
 
+    /// Return whether sampling may stop. Light probes are always sampled uniformly.
+    bool IsConverged(unsigned /*numSamples*/) const { return false; }
+
     /// End tracing element.
     void EndElement(unsigned elementIndex)
     {
@@ -906,6 +972,10 @@ void TraceIndirectLight(T sharedKernel, const ea::vector<const LightmapChartBake
                 }
 
                 kernel.EndSample(sampleIndirectLight);
+
+                // Stop early if estimate is good enough
+                if (kernel.IsConverged(sampleIndex + 1))
+                    break;
             }
             kernel.EndElement(elementIndex);
         }
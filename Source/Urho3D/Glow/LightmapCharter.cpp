@@ -85,11 +85,21 @@ LightmapChartRegion AllocateLightmapChartRegion(const LightmapChartingSettings&
     unsigned chartIndex = 0;
     for (LightmapChart& lightmapDesc : charts)
     {
+        // Allocator only gets fuller, so skip charts that already rejected smaller region
+        const IntVector2& rejectedSize = lightmapDesc.rejectedSize_;
+        const bool knownToFail = paddedSize.x_ >= rejectedSize.x_ && paddedSize.y_ >= rejectedSize.y_;
+
         IntVector2 paddedPosition;
-        if (lightmapDesc.allocator_.Allocate(paddedSize.x_, paddedSize.y_, paddedPosition.x_, paddedPosition.y_))
+        if (!knownToFail)
         {
-            const IntVector2 position = paddedPosition + padding * IntVector2::ONE;
-            return { chartIndex, position, size, settings.lightmapSize_ };
+            if (lightmapDesc.allocator_.Allocate(paddedSize.x_, paddedSize.y_, paddedPosition.x_, paddedPosition.y_))
+            {
+                const IntVector2 position = paddedPosition + padding * IntVector2::ONE;
+                return { chartIndex, position, size, settings.lightmapSize_ };
+            }
+
+            if (paddedSize.x_ <= rejectedSize.x_ && paddedSize.y_ <= rejectedSize.y_)
+                lightmapDesc.rejectedSize_ = paddedSize;
         }
         ++chartIndex;
     }
@@ -176,14 +186,19 @@ ea::vector<LightmapChart> GenerateLightmapCharts(
         requestedRegions.emplace_back(RequestedChartRegion{ objectIndex, adjustedRegionSize, component });
     }
 
-    // Sort regions by max dimensions
+    // Sort regions by max dimensions, then by area to pack equally long regions tighter.
+    // Keep the order stable so charting is deterministic.
     const auto compareDimensions = [](const RequestedChartRegion& lhs, const RequestedChartRegion& rhs)
     {
         const IntVector2& lhsRegion = lhs.adjustedRegionSize_;
         const IntVector2& rhsRegion = rhs.adjustedRegionSize_;
-        return ea::max(lhsRegion.x_, lhsRegion.y_) > ea::max(rhsRegion.x_, rhsRegion.y_);
+        const int lhsMaxDimension = ea::max(lhsRegion.x_, lhsRegion.y_);
+        const int rhsMaxDimension = ea::max(rhsRegion.x_, rhsRegion.y_);
+        if (lhsMaxDimension != rhsMaxDimension)
+            return lhsMaxDimension > rhsMaxDimension;
+        return lhsRegion.x_ * lhsRegion.y_ > rhsRegion.x_ * rhsRegion.y_;
     };
-    ea::sort(requestedRegions.begin(), requestedRegions.end(), compareDimensions);
+    ea::stable_sort(requestedRegions.begin(), requestedRegions.end(), compareDimensions);
 
     // Generate charts
     ea::vector<LightmapChart> charts;
@@ -93,6 +93,8 @@ struct LightmapChart
     AreaAllocator allocator_;
     /// Allocated elements.
     ea::vector<LightmapChartElement> elements_;
+    /// Smallest padded region size that was rejected by the allocator. Any region at least this large won't fit either.
+    IntVector2 rejectedSize_{ M_MAX_INT, M_MAX_INT };
 
     /// Construct default.
     LightmapChart() = default;
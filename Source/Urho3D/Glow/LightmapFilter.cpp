@@ -56,6 +56,22 @@ ea::span<const float> GetKernel(int radius)
     }
 }
 
+/// A-trous wavelet kernel: B3 spline weights for offsets 0, 1 and 2.
+static const float atrousKernel[] = { 3.0f / 8.0f, 1.0f / 4.0f, 1.0f / 16.0f };
+
+/// Return number of a-trous passes to use.
+unsigned GetNumAtrousPasses(const EdgeStoppingGaussFilterParameters& params)
+{
+    if (params.numPasses_ > 0)
+        return params.numPasses_;
+
+    // Kernel of N passes covers 2 * (2^N - 1) texels in each direction
+    unsigned numPasses = 1;
+    while (2 * ((1 << numPasses) - 1) < params.kernelRadius_)
+        ++numPasses;
+    return numPasses;
+}
+
 /// Get luminance of given color value (for 3D and 4D vectors).
 template <class T>
 float GetLuminance(const T& color)
@@ -78,7 +94,7 @@ float CalculateEdgeWeight(
 
 /// Apply Gauss filter edge stopping function to array.
 template <class T>
-void FilterArray(const ea::vector<T>& input, ea::vector<T>& output,
+void FilterArrayGauss(const ea::vector<T>& input, ea::vector<T>& output,
     const LightmapChartGeometryBuffer& geometryBuffer,
     const EdgeStoppingGaussFilterParameters& params, unsigned numTasks)
 {
@@ -139,6 +155,100 @@ void FilterArray(const ea::vector<T>& input, ea::vector<T>& output,
     });
 }
 
+/// Apply single a-trous pass of edge stopping filter to array. Pass N samples 5x5 texels with step 2^N.
+template <class T>
+void FilterArrayAtrousPass(const ea::vector<T>& input, ea::vector<T>& output,
+    const LightmapChartGeometryBuffer& geometryBuffer,
+    const EdgeStoppingGaussFilterParameters& params, unsigned passIndex, unsigned numTasks)
+{
+    const int step = (1 << passIndex) * params.upscale_;
+    const float tapScale = static_cast<float>(1 << passIndex);
+    ParallelFor(input.size(), numTasks,
+        [&](unsigned fromIndex, unsigned toIndex)
+    {
+        for (unsigned index = fromIndex; index < toIndex; ++index)
+        {
+            const unsigned geometryId = geometryBuffer.geometryIds_[index];
+            if (!geometryId)
+            {
+                output[index] = {};
+                continue;
+            }
+
+            const IntVector2 centerLocation = geometryBuffer.IndexToLocation(index);
+
+            const T centerColor = input[index];
+            const float centerLuminance = GetLuminance(centerColor);
+            const Vector3 centerPosition = geometryBuffer.positions_[index];
+            const Vector3 centerNormal = geometryBuffer.smoothNormals_[index];
+
+            float colorWeight = atrousKernel[0] * atrousKernel[0];
+            T colorSum = centerColor * colorWeight;
+            for (int dy = -2; dy <= 2; ++dy)
+            {
+                const int otherY = centerLocation.y_ + dy * step;
+                if (otherY < 0 || otherY >= static_cast<int>(geometryBuffer.lightmapSize_))
+                    continue;
+
+                for (int dx = -2; dx <= 2; ++dx)
+                {
+                    if (dx == 0 && dy == 0)
+                        continue;
+
+                    const int otherX = centerLocation.x_ + dx * step;
+                    if (otherX < 0 || otherX >= static_cast<int>(geometryBuffer.lightmapSize_))
+                        continue;
+
+                    const unsigned otherIndex = geometryBuffer.LocationToIndex({ otherX, otherY });
+                    const unsigned otherGeometryId = geometryBuffer.geometryIds_[otherIndex];
+                    if (!otherGeometryId)
+                        continue;
+
+                    const float dxdy = Vector2{ static_cast<float>(dx), static_cast<float>(dy) }.Length() * tapScale;
+                    const float kernel = atrousKernel[Abs(dx)] * atrousKernel[Abs(dy)];
+
+                    const T otherColor = input[otherIndex];
+                    const float weight = CalculateEdgeWeight(centerLuminance, GetLuminance(otherColor), params.luminanceSigma_,
+                        centerPosition, geometryBuffer.positions_[otherIndex], dxdy * params.positionSigma_,
+                        centerNormal, geometryBuffer.smoothNormals_[otherIndex], params.normalPower_);
+
+                    colorSum += otherColor * weight * kernel;
+                    colorWeight += weight * kernel;
+                }
+            }
+
+            output[index] = colorSum / ea::max(M_EPSILON, colorWeight);
+        }
+    });
+}
+
+/// Apply edge stopping filter to array.
+template <class T>
+void FilterArray(const ea::vector<T>& input, ea::vector<T>& output,
+    const LightmapChartGeometryBuffer& geometryBuffer,
+    const EdgeStoppingGaussFilterParameters& params, unsigned numTasks)
+{
+    if (!params.atrous_)
+    {
+        FilterArrayGauss(input, output, geometryBuffer, params, numTasks);
+        return;
+    }
+
+    const unsigned numPasses = GetNumAtrousPasses(params);
+    ea::vector<T> tempBuffer;
+    if (numPasses > 1)
+        tempBuffer.resize(input.size());
+
+    // Ping-pong between buffers so that the last pass writes to output
+    const ea::vector<T>* source = &input;
+    for (unsigned passIndex = 0; passIndex < numPasses; ++passIndex)
+    {
+        ea::vector<T>& destination = (numPasses - 1 - passIndex) % 2 == 0 ? output : tempBuffer;
+        FilterArrayAtrousPass(*source, destination, geometryBuffer, params, passIndex, numTasks);
+        source = &destination;
+    }
+}
+
 }
 
 void FilterDirectLight(const LightmapChartBakedDirect& bakedDirect, ea::vector<Vector3>& outputBuffer,
@@ -68,6 +68,8 @@ static bool CompareAnimationOrder(const SharedPtr<AnimationState>& lhs, const Sh
 }
 
 static const unsigned MAX_ANIMATION_STATES = 256;
+/// Maximum incremental morph updates before rebuilding the morph vertex buffers, to bound accumulated floating point error.
+static const unsigned MAX_INCREMENTAL_MORPH_UPDATES = 64;
 
 AnimatedModel::AnimatedModel(Context* context) :
     StaticModel(context),
@@ -154,6 +156,15 @@ bool AnimatedModel::LoadJSON(const JSONValue& source)
     return success;
 }
 
+bool AnimatedModel::LoadDecoded(const DecodedAttributes& source)
+{
+    loading_ = true;
+    bool success = Component::LoadDecoded(source);
+    loading_ = false;
+
+    return success;
+}
+
 void AnimatedModel::ApplyAttributes()
 {
     if (assignBonesPending_)
@@ -930,7 +941,7 @@ void AnimatedModel::UpdateBoneBoundingBox()
     }
 
     boneBoundingBoxDirty_ = false;
-    worldBoundingBoxDirty_ = true;
+    MarkWorldBoundingBoxDirty();
 }
 
 void AnimatedModel::OnNodeSet(Node* node)
@@ -1131,6 +1142,11 @@ void AnimatedModel::CloneGeometries()
             morphVertexBuffers_[i].Reset();
     }
 
+    // The cloned buffers contain the original vertex data, ie. no morphs applied
+    appliedMorphWeights_.clear();
+    appliedMorphWeights_.resize(morphs_.size(), 0.0f);
+    numIncrementalMorphUpdates_ = 0;
+
     // Geometries will always be cloned fully. They contain only references to buffer, so they are relatively light
     for (unsigned i = 0; i < geometries_.size(); ++i)
     {
@@ -1256,6 +1272,16 @@ void AnimatedModel::SetGeometryBoneMappings()
 
 void AnimatedModel::UpdateAnimation(const FrameInfo& frame)
 {
+    // An update deferred by the bone budget is performed on the next frame regardless, so that no model starves
+    if (animationBudgetDeferred_)
+    {
+        animationBudgetDeferred_ = false;
+        if (isMaster_ && octant_)
+            octant_->GetRoot()->ReserveAnimationBones(skeleton_.GetNumBones());
+        ApplyAnimation();
+        return;
+    }
+
     // If using animation LOD, accumulate time and see if it is time to update
     if (animationLodBias_ > 0.0f && animationLodDistance_ > 0.0f)
     {
@@ -1272,6 +1298,13 @@ void AnimatedModel::UpdateAnimation(const FrameInfo& frame)
             animationLodTimer_ = 0.0f;
     }
 
+    // Only the master model applies the animations, so only it counts against the bone budget
+    if (isMaster_ && octant_ && !octant_->GetRoot()->ReserveAnimationBones(skeleton_.GetNumBones()))
+    {
+        animationBudgetDeferred_ = true;
+        return;
+    }
+
     ApplyAnimation();
 }
 
@@ -1350,7 +1383,19 @@ void AnimatedModel::UpdateMorphs()
 
     if (morphs_.size())
     {
-        // Reset the morph data range from all morphable vertex buffers, then apply morphs
+        // If the morph vertex buffers hold the previous weights, only add the weight differences of the changed morphs.
+        // Otherwise, or if all morphs are being reset to zero, rebuild from the original vertex data
+        bool incremental = appliedMorphWeights_.size() == morphs_.size() && numIncrementalMorphUpdates_ < MAX_INCREMENTAL_MORPH_UPDATES;
+        bool allZero = true;
+        for (unsigned i = 0; i < morphs_.size(); ++i)
+        {
+            if (morphs_[i].weight_ != 0.0f)
+                allZero = false;
+        }
+        if (allZero)
+            incremental = false;
+        bool allLocked = true;
+
         for (unsigned i = 0; i < morphVertexBuffers_.size(); ++i)
         {
             VertexBuffer* buffer = morphVertexBuffers_[i];
@@ -1359,28 +1404,47 @@ void AnimatedModel::UpdateMorphs()
                 VertexBuffer* originalBuffer = model_->GetVertexBuffers()[i];
                 unsigned morphStart = model_->GetMorphRangeStart(i);
                 unsigned morphCount = model_->GetMorphRangeCount(i);
+                // Previous vertex data can only be read back from a shadowed buffer
+                const bool incrementalBuffer = incremental && buffer->IsShadowed();
 
                 void* dest = buffer->Lock(morphStart, morphCount);
                 if (dest)
                 {
                     // Reset morph range by copying data from the original vertex buffer
-                    CopyMorphVertices(dest, originalBuffer->GetShadowData() + morphStart * originalBuffer->GetVertexSize(),
-                        morphCount, buffer, originalBuffer);
+                    if (!incrementalBuffer)
+                    {
+                        CopyMorphVertices(dest, originalBuffer->GetShadowData() + morphStart * originalBuffer->GetVertexSize(),
+                            morphCount, buffer, originalBuffer);
+                    }
 
                     for (unsigned j = 0; j < morphs_.size(); ++j)
                     {
-                        if (morphs_[j].weight_ != 0.0f)
+                        const float weight = incrementalBuffer ? morphs_[j].weight_ - appliedMorphWeights_[j] : morphs_[j].weight_;
+                        if (weight != 0.0f)
                         {
                             auto k = morphs_[j].buffers_.find(i);
                             if (k != morphs_[j].buffers_.end())
-                                ApplyMorph(buffer, dest, morphStart, k->second, morphs_[j].weight_);
+                                ApplyMorph(buffer, dest, morphStart, k->second, weight);
                         }
                     }
 
                     buffer->Unlock();
                 }
+                else
+                    allLocked = false;
             }
         }
+
+        // If a buffer could not be updated, its contents are unknown, so rebuild all of them next time
+        if (allLocked)
+        {
+            appliedMorphWeights_.resize(morphs_.size());
+            for (unsigned i = 0; i < morphs_.size(); ++i)
+                appliedMorphWeights_[i] = morphs_[i].weight_;
+            numIncrementalMorphUpdates_ = incremental ? numIncrementalMorphUpdates_ + 1 : 0;
+        }
+        else
+            appliedMorphWeights_.clear();
     }
 
     morphsDirty_ = false;
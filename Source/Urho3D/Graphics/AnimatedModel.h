@@ -53,6 +53,8 @@ public:
     bool LoadXML(const XMLElement& source) override;
     /// Load from JSON data. Return true if successful.
     bool LoadJSON(const JSONValue& source) override;
+    /// Load from attribute values decoded in advance. Return true if successful.
+    bool LoadDecoded(const DecodedAttributes& source) override;
     /// Apply attribute changes that can not be applied immediately. Called after scene load or a network update.
     void ApplyAttributes() override;
     /// Process octree raycast. May be called from a worker thread.
@@ -215,6 +217,10 @@ private:
     ea::vector<SharedPtr<VertexBuffer> > morphVertexBuffers_;
     /// Vertex morphs.
     ea::vector<ModelMorph> morphs_;
+    /// Morph weights currently applied to the morph vertex buffers.
+    ea::vector<float> appliedMorphWeights_;
+    /// Number of incremental morph updates since the morph vertex buffers were last rebuilt from the original data.
+    unsigned numIncrementalMorphUpdates_{};
     /// Animation states.
     ea::vector<SharedPtr<AnimationState> > animationStates_;
     /// Skinning matrices.
@@ -259,6 +265,8 @@ private:
     bool assignBonesPending_;
     /// Force animation update after becoming visible flag.
     bool forceAnimationUpdate_;
+    /// Animation update deferred by the octree's bone budget flag.
+    bool animationBudgetDeferred_{};
 };
 
 }
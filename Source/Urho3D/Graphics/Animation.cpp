@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include <EASTL/algorithm.h>
 #include <EASTL/sort.h>
 
 #include "../Core/Context.h"
@@ -30,6 +31,7 @@
 #include "../IO/Deserializer.h"
 #include "../IO/FileSystem.h"
 #include "../IO/Log.h"
+#include "../IO/MemoryBuffer.h"
 #include "../IO/Serializer.h"
 #include "../Resource/ResourceCache.h"
 #include "../Resource/XMLFile.h"
@@ -40,6 +42,38 @@
 namespace Urho3D
 {
 
+/// Number of keyframes to step through before searching for the keyframe index.
+static const unsigned KEYFRAME_LINEAR_SEARCH_STEPS = 4;
+
+/// Return whether a keyframe is reproduced by interpolating between two other keyframes within the given errors.
+static bool IsKeyFrameInterpolated(const AnimationKeyFrame& keyFrame, const AnimationKeyFrame& prev, const AnimationKeyFrame& next,
+    AnimationChannelFlags channelMask, float positionError, float rotationError, float scaleError)
+{
+    const float timeInterval = next.time_ - prev.time_;
+    const float t = timeInterval > 0.0f ? (keyFrame.time_ - prev.time_) / timeInterval : 1.0f;
+
+    // Interpolate the same way as AnimationState does when sampling
+    if (channelMask & CHANNEL_POSITION)
+    {
+        if ((prev.position_.Lerp(next.position_, t) - keyFrame.position_).Length() > positionError)
+            return false;
+    }
+    if (channelMask & CHANNEL_ROTATION)
+    {
+        const Quaternion rotation = prev.rotation_.Nlerp(next.rotation_, t, true);
+        const float cosHalfAngle = Min(Abs(rotation.DotProduct(keyFrame.rotation_)), 1.0f);
+        if (2.0f * acosf(cosHalfAngle) > rotationError)
+            return false;
+    }
+    if (channelMask & CHANNEL_SCALE)
+    {
+        if ((prev.scale_.Lerp(next.scale_, t) - keyFrame.scale_).Length() > scaleError)
+            return false;
+    }
+
+    return true;
+}
+
 inline bool CompareTriggers(const AnimationTriggerPoint& lhs, const AnimationTriggerPoint& rhs)
 {
     return lhs.time_ < rhs.time_;
@@ -85,6 +119,47 @@ void AnimationTrack::RemoveAllKeyFrames()
     keyFrames_.clear();
 }
 
+void AnimationTrack::RemoveRedundantKeyFrames(float positionError, float rotationError, float scaleError)
+{
+    if (keyFrames_.size() < 2)
+        return;
+
+    // Greedily extend the span from the last kept keyframe as long as every keyframe inside it is reproduced by
+    // interpolating across the span
+    ea::vector<AnimationKeyFrame> keptKeyFrames;
+    keptKeyFrames.push_back(keyFrames_.front());
+    unsigned spanStart = 0;
+
+    for (unsigned i = 2; i < keyFrames_.size(); ++i)
+    {
+        bool spanValid = true;
+        for (unsigned j = spanStart + 1; j < i; ++j)
+        {
+            if (!IsKeyFrameInterpolated(keyFrames_[j], keyFrames_[spanStart], keyFrames_[i], channelMask_,
+                positionError, rotationError, scaleError))
+            {
+                spanValid = false;
+                break;
+            }
+        }
+
+        if (!spanValid)
+        {
+            spanStart = i - 1;
+            keptKeyFrames.push_back(keyFrames_[spanStart]);
+        }
+    }
+
+    keptKeyFrames.push_back(keyFrames_.back());
+
+    // Constant track: a single keyframe is enough
+    if (keptKeyFrames.size() == 2 && IsKeyFrameInterpolated(keptKeyFrames[1], keptKeyFrames[0], keptKeyFrames[0],
+        channelMask_, positionError, rotationError, scaleError))
+        keptKeyFrames.pop_back();
+
+    keyFrames_.swap(keptKeyFrames);
+}
+
 AnimationKeyFrame* AnimationTrack::GetKeyFrame(unsigned index)
 {
     return index < keyFrames_.size() ? &keyFrames_[index] : nullptr;
@@ -98,16 +173,24 @@ bool AnimationTrack::GetKeyFrameIndex(float time, unsigned& index) const
     if (time < 0.0f)
         time = 0.0f;
 
-    if (index >= keyFrames_.size())
-        index = keyFrames_.size() - 1;
-
-    // Check for being too far ahead
-    while (index && time < keyFrames_[index].time_)
-        --index;
+    const unsigned numKeyFrames = keyFrames_.size();
+    if (index >= numKeyFrames)
+        index = numKeyFrames - 1;
 
-    // Check for being too far behind
-    while (index < keyFrames_.size() - 1 && time >= keyFrames_[index + 1].time_)
-        ++index;
+    // Usually time has advanced by at most a few keyframes since the previous index. If it went backwards or jumped
+    // further, binary search for the last keyframe at or before the time instead of stepping there one by one
+    const unsigned searchLimit = index + KEYFRAME_LINEAR_SEARCH_STEPS;
+    if (time < keyFrames_[index].time_ || (searchLimit < numKeyFrames && time >= keyFrames_[searchLimit].time_))
+    {
+        auto next = ea::upper_bound(keyFrames_.begin(), keyFrames_.end(), time,
+            [](float lhs, const AnimationKeyFrame& rhs) { return lhs < rhs.time_; });
+        index = next != keyFrames_.begin() ? (unsigned)(next - keyFrames_.begin()) - 1 : 0;
+    }
+    else
+    {
+        while (index < numKeyFrames - 1 && time >= keyFrames_[index + 1].time_)
+            ++index;
+    }
 
     return true;
 }
@@ -146,6 +229,7 @@ bool Animation::BeginLoad(Deserializer& source)
     memoryUse += tracks * sizeof(AnimationTrack);
 
     // Read tracks
+    ea::vector<unsigned char> keyFrameData;
     for (unsigned i = 0; i < tracks; ++i)
     {
         AnimationTrack* newTrack = CreateTrack(source.ReadString());
@@ -155,17 +239,33 @@ bool Animation::BeginLoad(Deserializer& source)
         newTrack->keyFrames_.resize(keyFrames);
         memoryUse += keyFrames * sizeof(AnimationKeyFrame);
 
-        // Read keyframes of the track
+        // Read keyframes of the track at once and unpack them from memory
+        unsigned keyFrameSize = sizeof(float);
+        if (newTrack->channelMask_ & CHANNEL_POSITION)
+            keyFrameSize += sizeof(Vector3);
+        if (newTrack->channelMask_ & CHANNEL_ROTATION)
+            keyFrameSize += sizeof(Quaternion);
+        if (newTrack->channelMask_ & CHANNEL_SCALE)
+            keyFrameSize += sizeof(Vector3);
+
+        keyFrameData.resize(keyFrames * keyFrameSize);
+        if (source.Read(keyFrameData.data(), keyFrameData.size()) != keyFrameData.size())
+        {
+            URHO3D_LOGERROR("Unexpected end of animation " + GetName());
+            return false;
+        }
+
+        MemoryBuffer keyFrameBuffer(keyFrameData);
         for (unsigned j = 0; j < keyFrames; ++j)
         {
             AnimationKeyFrame& newKeyFrame = newTrack->keyFrames_[j];
-            newKeyFrame.time_ = source.ReadFloat();
+            newKeyFrame.time_ = keyFrameBuffer.ReadFloat();
             if (newTrack->channelMask_ & CHANNEL_POSITION)
-                newKeyFrame.position_ = source.ReadVector3();
+                newKeyFrame.position_ = keyFrameBuffer.ReadVector3();
             if (newTrack->channelMask_ & CHANNEL_ROTATION)
-                newKeyFrame.rotation_ = source.ReadQuaternion();
+                newKeyFrame.rotation_ = keyFrameBuffer.ReadQuaternion();
             if (newTrack->channelMask_ & CHANNEL_SCALE)
-                newKeyFrame.scale_ = source.ReadVector3();
+                newKeyFrame.scale_ = keyFrameBuffer.ReadVector3();
         }
     }
 
@@ -421,6 +521,12 @@ AnimationTriggerPoint* Animation::GetTrigger(unsigned index)
     return index < triggers_.size() ? &triggers_[index] : nullptr;
 }
 
+void Animation::RemoveRedundantKeyFrames(float positionError, float rotationError, float scaleError)
+{
+    for (auto i = tracks_.begin(); i != tracks_.end(); ++i)
+        i->second.RemoveRedundantKeyFrames(positionError, rotationError, scaleError);
+}
+
 void Animation::SetTracks(const ea::vector<AnimationTrack>& tracks)
 {
     tracks_.clear();
@@ -92,6 +92,8 @@ struct URHO3D_API AnimationTrack
     void RemoveKeyFrame(unsigned index);
     /// Remove all keyframes.
     void RemoveAllKeyFrames();
+    /// Remove keyframes that interpolation between the remaining keyframes reproduces within the given errors. Rotation error is in radians. A track whose keyframes are all equal is reduced to one keyframe.
+    void RemoveRedundantKeyFrames(float positionError, float rotationError, float scaleError);
 
     /// Return keyframe at index, or null if not found.
     AnimationKeyFrame* GetKeyFrame(unsigned index);
@@ -226,6 +228,8 @@ public:
 
     /// Set all animation tracks.
     void SetTracks(const ea::vector<AnimationTrack>& tracks);
+    /// Remove redundant keyframes from all tracks. Rotation error is in radians. This is unsafe if the animation is currently used in playback.
+    void RemoveRedundantKeyFrames(float positionError, float rotationError, float scaleError);
 private:
     /// Animation name.
     ea::string animationName_;
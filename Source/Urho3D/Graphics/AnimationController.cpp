@@ -23,6 +23,7 @@
 #include "../Precompiled.h"
 
 #include "../Core/Context.h"
+#include "../Core/MemoryTracker.h"
 #include "../Core/Profiler.h"
 #include "../Graphics/AnimatedModel.h"
 #include "../Graphics/Animation.h"
@@ -87,6 +88,8 @@ void AnimationController::OnSetEnabled()
 
 void AnimationController::Update(float timeStep)
 {
+    MemoryTagScope memoryTag(MEMORY_TAG_ANIMATION);
+
     // Loop through animations
     for (unsigned i = 0; i < animations_.size();)
     {
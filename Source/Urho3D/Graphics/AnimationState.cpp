@@ -517,8 +517,9 @@ void AnimationState::ApplyTrack(AnimationStateTrack& stateTrack, float weight, b
 
         if (channelMask & CHANNEL_POSITION)
             newPosition = keyFrame->position_.Lerp(nextKeyFrame->position_, t);
+        // Adjacent keyframes are close in rotation, so normalized lerp is indistinguishable from slerp and much cheaper
         if (channelMask & CHANNEL_ROTATION)
-            newRotation = keyFrame->rotation_.Slerp(nextKeyFrame->rotation_, t);
+            newRotation = keyFrame->rotation_.Nlerp(nextKeyFrame->rotation_, t, true);
         if (channelMask & CHANNEL_SCALE)
             newScale = keyFrame->scale_.Lerp(nextKeyFrame->scale_, t);
     }
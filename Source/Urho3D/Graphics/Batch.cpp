@@ -31,6 +31,7 @@
 #include "../Graphics/GraphicsImpl.h"
 #include "../Graphics/Material.h"
 #include "../Graphics/Renderer.h"
+#include "../Graphics/RenderStatistics.h"
 #include "../Graphics/ShaderVariation.h"
 #include "../Graphics/Technique.h"
 #include "../Graphics/Texture2D.h"
@@ -43,44 +44,34 @@
 namespace Urho3D
 {
 
-inline bool CompareBatchesState(const Batch* lhs, const Batch* rhs)
+/// Return distance as an unsigned integer that sorts in the same order.
+inline unsigned GetDistanceKey(float distance)
 {
-    if (lhs->renderOrder_ != rhs->renderOrder_)
-        return lhs->renderOrder_ < rhs->renderOrder_;
-    else if (lhs->sortKey_ != rhs->sortKey_)
-        return lhs->sortKey_ < rhs->sortKey_;
-    else
-        return lhs->distance_ < rhs->distance_;
+    const unsigned bits = FloatToRawIntBits(distance);
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
 }
 
-inline bool CompareBatchesFrontToBack(const Batch* lhs, const Batch* rhs)
+/// Return key for sorting by render order, then front to back.
+inline unsigned long long GetFrontToBackKey(const Batch* batch)
 {
-    if (lhs->renderOrder_ != rhs->renderOrder_)
-        return lhs->renderOrder_ < rhs->renderOrder_;
-    else if (lhs->distance_ != rhs->distance_)
-        return lhs->distance_ < rhs->distance_;
-    else
-        return lhs->sortKey_ < rhs->sortKey_;
+    return (((unsigned long long)batch->renderOrder_) << 32u) | GetDistanceKey(batch->distance_);
 }
 
-inline bool CompareBatchesBackToFront(const Batch* lhs, const Batch* rhs)
+/// Return key for sorting by render order, then back to front.
+inline unsigned long long GetBackToFrontKey(const Batch* batch)
 {
-    if (lhs->renderOrder_ != rhs->renderOrder_)
-        return lhs->renderOrder_ < rhs->renderOrder_;
-    else if (lhs->distance_ != rhs->distance_)
-        return lhs->distance_ > rhs->distance_;
-    else
-        return lhs->sortKey_ < rhs->sortKey_;
+    return (((unsigned long long)batch->renderOrder_) << 32u) | ~GetDistanceKey(batch->distance_);
 }
 
-inline bool CompareInstancesFrontToBack(const InstanceData& lhs, const InstanceData& rhs)
+/// Return key for sorting by render order only.
+inline unsigned long long GetRenderOrderKey(const Batch* batch)
 {
-    return lhs.distance_ < rhs.distance_;
+    return batch->renderOrder_;
 }
 
-inline bool CompareBatchGroupOrder(const BatchGroup* lhs, const BatchGroup* rhs)
+inline bool CompareInstancesFrontToBack(const InstanceData& lhs, const InstanceData& rhs)
 {
-    return lhs->renderOrder_ < rhs->renderOrder_;
+    return lhs.distance_ < rhs.distance_;
 }
 
 void CalculateShadowMatrix(Matrix4& dest, LightBatchQueue* queue, unsigned split, Renderer* renderer)
@@ -219,26 +210,44 @@ void Batch::Prepare(View* view, Camera* camera, bool setModelTransform, bool all
             else if (blend == BLEND_ADDALPHA)
                 blend = BLEND_SUBTRACTALPHA;
         }
-        graphics->SetBlendMode(blend, pass_->GetAlphaToCoverage() || material_->GetAlphaToCoverage());
-        graphics->SetLineAntiAlias(material_->GetLineAntiAlias());
+        PipelineState state;
+        state.blendMode_ = blend;
+        state.alphaToCoverage_ = pass_->GetAlphaToCoverage() || material_->GetAlphaToCoverage();
+        state.lineAntiAlias_ = material_->GetLineAntiAlias();
 
         bool isShadowPass = pass_->GetIndex() == Technique::shadowPassIndex;
         CullMode effectiveCullMode = pass_->GetCullMode();
         // Get cull mode from material if pass doesn't override it
         if (effectiveCullMode == MAX_CULLMODES)
             effectiveCullMode = isShadowPass ? material_->GetShadowCullMode() : material_->GetCullMode();
+        // Reverse culling due to vertical flipping or reflection, as in Renderer::SetCullMode()
+        if (camera->GetReverseCulling())
+        {
+            if (effectiveCullMode == CULL_CW)
+                effectiveCullMode = CULL_CCW;
+            else if (effectiveCullMode == CULL_CCW)
+                effectiveCullMode = CULL_CW;
+        }
+        state.cullMode_ = effectiveCullMode;
 
-        renderer->SetCullMode(effectiveCullMode, camera);
+        // Shadow pass depth bias has already been set per light by the view
         if (!isShadowPass)
         {
             const BiasParameters& depthBias = material_->GetDepthBias();
-            graphics->SetDepthBias(depthBias.constantBias_, depthBias.slopeScaledBias_);
+            state.constantDepthBias_ = depthBias.constantBias_;
+            state.slopeScaledDepthBias_ = depthBias.slopeScaledBias_;
+        }
+        else
+        {
+            state.constantDepthBias_ = graphics->GetDepthConstantBias();
+            state.slopeScaledDepthBias_ = graphics->GetDepthSlopeScaledBias();
         }
 
         // Use the "least filled" fill mode combined from camera & material
-        graphics->SetFillMode((FillMode)(Max(camera->GetFillMode(), material_->GetFillMode())));
-        graphics->SetDepthTest(pass_->GetDepthTestMode());
-        graphics->SetDepthWrite(pass_->GetDepthWrite() && allowDepthWrite);
+        state.fillMode_ = (FillMode)(Max(camera->GetFillMode(), material_->GetFillMode()));
+        state.depthTestMode_ = pass_->GetDepthTestMode();
+        state.depthWrite_ = pass_->GetDepthWrite() && allowDepthWrite;
+        graphics->SetPipelineState(state);
     }
 
     // Set global (per-frame) shader parameters
@@ -348,26 +357,17 @@ void Batch::Prepare(View* view, Camera* camera, bool setModelTransform, bool all
                 {
                 case LIGHT_DIRECTIONAL:
                     {
-                        Matrix4 shadowMatrices[MAX_CASCADE_SPLITS];
-                        unsigned numSplits = Min(MAX_CASCADE_SPLITS, lightQueue_->shadowSplits_.size());
-
-                        for (unsigned i = 0; i < numSplits; ++i)
-                            CalculateShadowMatrix(shadowMatrices[i], lightQueue_, i, renderer);
-
-                        graphics->SetShaderParameter(VSP_LIGHTMATRICES, shadowMatrices[0].Data(), 16 * numSplits);
+                        graphics->SetShaderParameter(VSP_LIGHTMATRICES, lightQueue_->lightMatrices_[0].Data(),
+                            16 * lightQueue_->numLightMatrices_);
                     }
                     break;
 
                 case LIGHT_SPOT:
                     {
-                        Matrix4 shadowMatrices[2];
-
-                        CalculateSpotMatrix(shadowMatrices[0], light);
+                        // The shadow matrix is only present if it was calculated
                         bool isShadowed = shadowMap && graphics->HasTextureUnit(TU_SHADOWMAP);
-                        if (isShadowed)
-                            CalculateShadowMatrix(shadowMatrices[1], lightQueue_, 0, renderer);
-
-                        graphics->SetShaderParameter(VSP_LIGHTMATRICES, shadowMatrices[0].Data(), isShadowed ? 32 : 16);
+                        const unsigned numMatrices = isShadowed ? lightQueue_->numLightMatrices_ : Min(lightQueue_->numLightMatrices_, 1u);
+                        graphics->SetShaderParameter(VSP_LIGHTMATRICES, lightQueue_->lightMatrices_[0].Data(), 16 * numMatrices);
                     }
                     break;
 
@@ -408,26 +408,17 @@ void Batch::Prepare(View* view, Camera* camera, bool setModelTransform, bool all
                 {
                 case LIGHT_DIRECTIONAL:
                     {
-                        Matrix4 shadowMatrices[MAX_CASCADE_SPLITS];
-                        unsigned numSplits = Min(MAX_CASCADE_SPLITS, lightQueue_->shadowSplits_.size());
-
-                        for (unsigned i = 0; i < numSplits; ++i)
-                            CalculateShadowMatrix(shadowMatrices[i], lightQueue_, i, renderer);
-
-                        graphics->SetShaderParameter(PSP_LIGHTMATRICES, shadowMatrices[0].Data(), 16 * numSplits);
+                        graphics->SetShaderParameter(PSP_LIGHTMATRICES, lightQueue_->lightMatrices_[0].Data(),
+                            16 * lightQueue_->numLightMatrices_);
                     }
                     break;
 
                 case LIGHT_SPOT:
                     {
-                        Matrix4 shadowMatrices[2];
-
-                        CalculateSpotMatrix(shadowMatrices[0], light);
+                        // The shadow matrix is only present if it was calculated
                         bool isShadowed = lightQueue_->shadowMap_ != nullptr;
-                        if (isShadowed)
-                            CalculateShadowMatrix(shadowMatrices[1], lightQueue_, 0, renderer);
-
-                        graphics->SetShaderParameter(PSP_LIGHTMATRICES, shadowMatrices[0].Data(), isShadowed ? 32 : 16);
+                        const unsigned numMatrices = isShadowed ? lightQueue_->numLightMatrices_ : Min(lightQueue_->numLightMatrices_, 1u);
+                        graphics->SetShaderParameter(PSP_LIGHTMATRICES, lightQueue_->lightMatrices_[0].Data(), 16 * numMatrices);
                     }
                     break;
 
@@ -670,7 +661,26 @@ void Batch::Prepare(View* view, Camera* camera, bool setModelTransform, bool all
 
 void Batch::Draw(View* view, Camera* camera, bool allowDepthWrite) const
 {
-    if (!geometry_->IsEmpty())
+    if (geometry_->IsEmpty())
+        return;
+
+    if (instanceBuffer_ && geometryType_ == GEOM_INSTANCED)
+    {
+        Graphics* graphics = view->GetContext()->GetGraphics();
+        Prepare(view, camera, false, allowDepthWrite);
+
+        // Hack: use a const_cast to avoid dynamic allocation of new temp vectors
+        auto& vertexBuffers = const_cast<ea::vector<SharedPtr<VertexBuffer> >&>(geometry_->GetVertexBuffers());
+        vertexBuffers.push_back(SharedPtr<VertexBuffer>(instanceBuffer_));
+
+        graphics->SetIndexBuffer(geometry_->GetIndexBuffer());
+        graphics->SetVertexBuffers(vertexBuffers, 0);
+        graphics->DrawInstanced(geometry_->GetPrimitiveType(), geometry_->GetIndexStart(), geometry_->GetIndexCount(),
+            geometry_->GetVertexStart(), geometry_->GetVertexCount(), numWorldTransforms_);
+
+        vertexBuffers.pop_back();
+    }
+    else
     {
         Prepare(view, camera, true, allowDepthWrite);
         geometry_->Draw(view->GetContext()->GetGraphics());
@@ -756,17 +766,73 @@ void BatchGroup::Draw(View* view, Camera* camera, bool allowDepthWrite) const
     }
 }
 
+bool BatchGroup::CanMultiDraw(const BatchGroup& rhs) const
+{
+    // Each group must use its own range of the instancing buffer, and no per-batch lightmap parameters
+    if (geometryType_ != GEOM_INSTANCED || rhs.geometryType_ != GEOM_INSTANCED || startIndex_ == M_MAX_UNSIGNED ||
+        rhs.startIndex_ == M_MAX_UNSIGNED || lightmapScaleOffset_ || rhs.lightmapScaleOffset_)
+        return false;
+
+    if (vertexShader_ != rhs.vertexShader_ || pixelShader_ != rhs.pixelShader_ || pass_ != rhs.pass_ || material_ != rhs.material_ ||
+        zone_ != rhs.zone_ || lightQueue_ != rhs.lightQueue_ || lightMask_ != rhs.lightMask_)
+        return false;
+
+    // Geometries of the same model usually share their buffers, differing only by the index range
+    return !geometry_->IsEmpty() && !rhs.geometry_->IsEmpty() && geometry_->GetIndexBuffer() &&
+        geometry_->GetIndexBuffer() == rhs.geometry_->GetIndexBuffer() &&
+        geometry_->GetPrimitiveType() == rhs.geometry_->GetPrimitiveType() &&
+        geometry_->GetVertexBuffers() == rhs.geometry_->GetVertexBuffers();
+}
+
+void BatchGroup::DrawMultiple(View* view, Camera* camera, bool allowDepthWrite, BatchGroup* const* groups, unsigned numGroups)
+{
+    Graphics* graphics = view->GetContext()->GetGraphics();
+    Renderer* renderer = view->GetContext()->GetRenderer();
+    const BatchGroup& first = *groups[0];
+
+    // Note: this is not multi-instance safe
+    static ea::vector<IndexedDrawCommand> commands;
+    commands.clear();
+    for (unsigned i = 0; i < numGroups; ++i)
+    {
+        const BatchGroup& group = *groups[i];
+        if (!group.instances_.empty())
+        {
+            commands.push_back({ group.geometry_->GetIndexCount(), group.instances_.size(), group.geometry_->GetIndexStart(), 0,
+                group.startIndex_ });
+        }
+    }
+
+    if (commands.empty())
+        return;
+
+    first.Batch::Prepare(view, camera, false, allowDepthWrite);
+
+    // Instance data is found with the base instance of each command, so the instancing stream starts from zero
+    auto& vertexBuffers = const_cast<ea::vector<SharedPtr<VertexBuffer> >&>(first.geometry_->GetVertexBuffers());
+    vertexBuffers.push_back(SharedPtr<VertexBuffer>(renderer->GetInstancingBuffer()));
+
+    graphics->SetIndexBuffer(first.geometry_->GetIndexBuffer());
+    graphics->SetVertexBuffers(vertexBuffers, 0);
+    graphics->MultiDrawInstanced(first.geometry_->GetPrimitiveType(), commands.data(), commands.size());
+
+    vertexBuffers.pop_back();
+}
+
 unsigned BatchGroupKey::ToHash() const
 {
     return (unsigned)((size_t)zone_ / sizeof(Zone) + (size_t)lightQueue_ / sizeof(LightBatchQueue) + (size_t)pass_ / sizeof(Pass) +
                       (size_t)material_ / sizeof(Material) + (size_t)geometry_ / sizeof(Geometry)) + renderOrder_;
 }
 
-void BatchQueue::Clear(int maxSortedInstances)
+void BatchQueue::Clear(int maxSortedInstances, FrameAllocator* frameAllocator)
 {
     batches_.clear();
     sortedBatches_.clear();
-    batchGroups_.clear();
+    // Arena memory is dropped completely, including the buckets, as the arena may be reused after this
+    const bool keepBuckets = !frameAllocator && !batchGroups_.get_allocator().GetFrameAllocator();
+    batchGroups_.clear(!keepBuckets);
+    batchGroups_.set_allocator(FrameAllocatorAdapter(frameAllocator));
     maxSortedInstances_ = (unsigned)maxSortedInstances;
 }
 
@@ -777,7 +843,7 @@ void BatchQueue::SortBackToFront()
     for (unsigned i = 0; i < batches_.size(); ++i)
         sortedBatches_[i] = &batches_[i];
 
-    ea::quick_sort(sortedBatches_.begin(), sortedBatches_.end(), CompareBatchesBackToFront);
+    RadixSort(sortedBatches_, GetBackToFrontKey);
 
     sortedBatchGroups_.resize(batchGroups_.size());
 
@@ -785,7 +851,7 @@ void BatchQueue::SortBackToFront()
     for (auto i = batchGroups_.begin(); i != batchGroups_.end(); ++i)
         sortedBatchGroups_[index++] = &i->second;
 
-    ea::quick_sort(sortedBatchGroups_.begin(), sortedBatchGroups_.end(), CompareBatchGroupOrder);
+    RadixSort(sortedBatchGroups_, GetRenderOrderKey);
 }
 
 void BatchQueue::SortFrontToBack()
@@ -831,10 +897,13 @@ template <class T> void BatchQueue::SortFrontToBack2Pass(ea::vector<T>& batches)
     // Mobile devices likely use a tiled deferred approach, with which front-to-back sorting is irrelevant. The 2-pass
     // method is also time consuming, so just sort with state having priority
 #ifdef GL_ES_VERSION_2_0
-    ea::quick_sort(batches.begin(), batches.end(), CompareBatchesState);
+    // The sort is stable, so sort by the least significant key first
+    RadixSort(batches, [](const Batch* batch) { return (unsigned long long)GetDistanceKey(batch->distance_); });
+    RadixSort(batches, [](const Batch* batch) { return batch->sortKey_; });
+    RadixSort(batches, GetRenderOrderKey);
 #else
     // For desktop, first sort by distance and remap shader/material/geometry IDs in the sort key
-    ea::quick_sort(batches.begin(), batches.end(), CompareBatchesFrontToBack);
+    RadixSort(batches, GetFrontToBackKey);
 
     unsigned freeShaderID = 0;
     unsigned short freeMaterialID = 0;
@@ -881,11 +950,67 @@ template <class T> void BatchQueue::SortFrontToBack2Pass(ea::vector<T>& batches)
     materialRemapping_.clear();
     geometryRemapping_.clear();
 
-    // Finally sort again with the rewritten ID's
-    ea::quick_sort(batches.begin(), batches.end(), CompareBatchesState);
+    // Finally sort again with the rewritten ID's. Pack render order, base flag and 15 bits of the shader ID above
+    // material and geometry IDs, batches with equal keys stay in distance order
+    RadixSort(batches, [](const Batch* batch)
+    {
+        const auto shaderID = (unsigned)(batch->sortKey_ >> 32u);
+        const unsigned packedShaderID = ((shaderID & 0x80000000u) >> 16u) | (shaderID & 0x7fffu);
+        return (((unsigned long long)batch->renderOrder_) << 48u) | (((unsigned long long)packedShaderID) << 32u) |
+            (batch->sortKey_ & 0xffffffffu);
+    });
 #endif
 }
 
+template <class T, class U> void BatchQueue::RadixSort(ea::vector<T>& batches, U getKey)
+{
+    const unsigned count = batches.size();
+    if (count < 2)
+        return;
+
+    sortKeys_.resize(count);
+    sortKeysTemp_.resize(count);
+
+    unsigned long long allBits = ~0ull;
+    unsigned long long anyBits = 0;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        const unsigned long long key = getKey(batches[i]);
+        sortKeys_[i].key_ = key;
+        sortKeys_[i].batch_ = batches[i];
+        allBits &= key;
+        anyBits |= key;
+    }
+
+    // Least significant digit first, 8 bits at a time. Skip digits that are the same for all keys
+    const unsigned long long varyingBits = allBits ^ anyBits;
+    for (unsigned shift = 0; shift < 64; shift += 8)
+    {
+        if (((varyingBits >> shift) & 0xffu) == 0)
+            continue;
+
+        unsigned offsets[256]{};
+        for (unsigned i = 0; i < count; ++i)
+            ++offsets[(sortKeys_[i].key_ >> shift) & 0xffu];
+
+        unsigned total = 0;
+        for (unsigned& offset : offsets)
+        {
+            const unsigned digitCount = offset;
+            offset = total;
+            total += digitCount;
+        }
+
+        for (unsigned i = 0; i < count; ++i)
+            sortKeysTemp_[offsets[(sortKeys_[i].key_ >> shift) & 0xffu]++] = sortKeys_[i];
+
+        ea::swap(sortKeys_, sortKeysTemp_);
+    }
+
+    for (unsigned i = 0; i < count; ++i)
+        batches[i] = static_cast<T>(sortKeys_[i].batch_);
+}
+
 void BatchQueue::SetInstancingData(void* lockedData, unsigned stride, unsigned& freeIndex)
 {
     for (auto i = batchGroups_.begin(); i != batchGroups_.end(); ++i)
@@ -896,6 +1021,7 @@ void BatchQueue::Draw(View* view, Camera* camera, bool markToStencil, bool using
 {
     Graphics* graphics = view->GetContext()->GetGraphics();
     Renderer* renderer = view->GetContext()->GetRenderer();
+    RenderStatistics* statistics = renderer->GetRenderStatistics();
 
     // If View has set up its own light optimizations, do not disturb the stencil/scissor test settings
     if (!usingLightOptimization)
@@ -907,14 +1033,38 @@ void BatchQueue::Draw(View* view, Camera* camera, bool markToStencil, bool using
             graphics->SetStencilTest(false);
     }
 
-    // Instanced
-    for (auto i = sortedBatchGroups_.begin(); i != sortedBatchGroups_.end(); ++i)
+    // Instanced. Consecutive groups that differ only by geometry range are submitted together if possible
+    const bool multiDraw = graphics->GetMultiDrawSupport() && renderer->GetInstancingBuffer();
+    for (unsigned i = 0; i < sortedBatchGroups_.size();)
     {
-        BatchGroup* group = *i;
+        BatchGroup* group = sortedBatchGroups_[i];
         if (markToStencil)
             graphics->SetStencilTest(true, CMP_ALWAYS, OP_REF, OP_KEEP, OP_KEEP, group->lightMask_);
 
-        group->Draw(view, camera, allowDepthWrite);
+        unsigned end = i + 1;
+        if (multiDraw)
+        {
+            while (end < sortedBatchGroups_.size() && group->CanMultiDraw(*sortedBatchGroups_[end]))
+                ++end;
+        }
+
+        if (statistics)
+            statistics->BeginBatch();
+
+        if (end - i > 1)
+            BatchGroup::DrawMultiple(view, camera, allowDepthWrite, &sortedBatchGroups_[i], end - i);
+        else
+            group->Draw(view, camera, allowDepthWrite);
+
+        // Groups submitted together are attributed to the first one
+        if (statistics)
+        {
+            unsigned numInstances = 0;
+            for (unsigned j = i; j < end; ++j)
+                numInstances += sortedBatchGroups_[j]->instances_.size();
+            statistics->EndBatch(*group, numInstances);
+        }
+        i = end;
     }
     // Non-instanced
     for (auto i = sortedBatches_.begin(); i != sortedBatches_.end(); ++i)
@@ -931,7 +1081,13 @@ void BatchQueue::Draw(View* view, Camera* camera, bool markToStencil, bool using
                 graphics->SetScissorTest(false);
         }
 
+        if (statistics)
+            statistics->BeginBatch();
+
         batch->Draw(view, camera, allowDepthWrite);
+
+        if (statistics)
+            statistics->EndBatch(*batch, 0);
     }
 }
 
@@ -949,4 +1105,33 @@ unsigned BatchQueue::GetNumInstances() const
     return total;
 }
 
+void LightBatchQueue::CalculateLightMatrices(Renderer* renderer)
+{
+    numLightMatrices_ = 0;
+    if (!light_)
+        return;
+
+    switch (light_->GetLightType())
+    {
+    case LIGHT_DIRECTIONAL:
+        numLightMatrices_ = Min(MAX_CASCADE_SPLITS, shadowSplits_.size());
+        for (unsigned i = 0; i < numLightMatrices_; ++i)
+            CalculateShadowMatrix(lightMatrices_[i], this, i, renderer);
+        break;
+
+    case LIGHT_SPOT:
+        CalculateSpotMatrix(lightMatrices_[0], light_);
+        numLightMatrices_ = 1;
+        if (shadowMap_ && !shadowSplits_.empty())
+        {
+            CalculateShadowMatrix(lightMatrices_[1], this, 0, renderer);
+            numLightMatrices_ = 2;
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
 }
@@ -22,8 +22,10 @@
 
 #pragma once
 
+#include "../Container/FrameAllocator.h"
 #include "../Container/Ptr.h"
 #include "../Graphics/Drawable.h"
+#include "../Graphics/Light.h"
 #include "../Graphics/Material.h"
 #include "../Math/MathDefs.h"
 #include "../Math/Matrix3x4.h"
@@ -62,6 +64,22 @@ struct InstanceShaderParameters
 #endif
 };
 
+/// Encode object ID into the color written by the pick pass. ID is passed to the shader in place of instance ambient.
+inline Vector4 EncodePickId(unsigned id)
+{
+    return Vector4(
+        static_cast<float>(id & 0xffu) / 255.0f,
+        static_cast<float>((id >> 8u) & 0xffu) / 255.0f,
+        static_cast<float>((id >> 16u) & 0xffu) / 255.0f,
+        static_cast<float>((id >> 24u) & 0xffu) / 255.0f);
+}
+
+/// Decode object ID from RGBA8 pixel of the pick pass output. Zero means no object.
+inline unsigned DecodePickId(const unsigned char* rgba)
+{
+    return rgba[0] | (rgba[1] << 8u) | (rgba[2] << 16u) | (static_cast<unsigned>(rgba[3]) << 24u);
+}
+
 /// Queued 3D geometry draw call.
 struct Batch
 {
@@ -81,7 +99,8 @@ struct Batch
         lightQueue_(nullptr),
         geometryType_(rhs.geometryType_),
         lightmapScaleOffset_(rhs.lightmapScaleOffset_),
-        lightmapIndex_(rhs.lightmapIndex_)
+        lightmapIndex_(rhs.lightmapIndex_),
+        instanceBuffer_(rhs.instanceBuffer_)
     {
     }
 
@@ -130,6 +149,10 @@ struct Batch
     Vector4* lightmapScaleOffset_{};
     /// Lightmap index.
     unsigned lightmapIndex_{};
+    /// Persistent instancing vertex buffer of the source batch.
+    VertexBuffer* instanceBuffer_{};
+    /// Type of the drawable the batch originates from. Used for render statistics.
+    StringHash drawableType_{};
 };
 
 /// Data for one geometry instance.
@@ -196,6 +219,10 @@ struct BatchGroup : public Batch
     void SetInstancingData(void* lockedData, unsigned stride, unsigned& freeIndex);
     /// Prepare and draw.
     void Draw(View* view, Camera* camera, bool allowDepthWrite) const;
+    /// Return whether can be drawn in the same multi-draw submission with another group, which requires the same states and buffers.
+    bool CanMultiDraw(const BatchGroup& rhs) const;
+    /// Prepare and draw groups that can be multi-drawn with the first one in one submission.
+    static void DrawMultiple(View* view, Camera* camera, bool allowDepthWrite, BatchGroup* const* groups, unsigned numGroups);
 
     /// Instance data.
     ea::vector<InstanceData> instances_;
@@ -251,18 +278,29 @@ struct BatchGroupKey
     unsigned ToHash() const;
 };
 
+/// Batch and its packed sorting key, used for radix sorting.
+struct BatchSortKey
+{
+    /// Sorting key.
+    unsigned long long key_;
+    /// Batch.
+    Batch* batch_;
+};
+
 /// Queue that contains both instanced and non-instanced draw calls.
 struct BatchQueue
 {
 public:
     /// Clear for new frame by clearing all groups and batches.
-    void Clear(int maxSortedInstances);
+    void Clear(int maxSortedInstances, FrameAllocator* frameAllocator = nullptr);
     /// Sort non-instanced draw calls back to front.
     void SortBackToFront();
     /// Sort instanced and non-instanced draw calls front to back.
     void SortFrontToBack();
     /// Sort batches front to back while also maintaining state sorting.
     template <class T> void SortFrontToBack2Pass(ea::vector<T>& batches);
+    /// Stable sort of batches by a 64-bit key.
+    template <class T, class U> void RadixSort(ea::vector<T>& batches, U getKey);
     /// Pre-set instance data of all groups. The vertex buffer must be big enough to hold all data.
     void SetInstancingData(void* lockedData, unsigned stride, unsigned& freeIndex);
     /// Draw.
@@ -273,14 +311,18 @@ public:
     /// Return whether the batch group is empty.
     bool IsEmpty() const { return batches_.empty() && batchGroups_.empty(); }
 
-    /// Instanced draw calls.
-    ea::unordered_map<BatchGroupKey, BatchGroup> batchGroups_;
+    /// Instanced draw calls. Allocated from the frame allocator of the view, so groups must only be added on the main thread.
+    ea::unordered_map<BatchGroupKey, BatchGroup, ea::hash<BatchGroupKey>, ea::equal_to<BatchGroupKey>, FrameAllocatorAdapter> batchGroups_;
     /// Shader remapping table for 2-pass state and distance sort.
     ea::unordered_map<unsigned, unsigned> shaderRemapping_;
     /// Material remapping table for 2-pass state and distance sort.
     ea::unordered_map<unsigned short, unsigned short> materialRemapping_;
     /// Geometry remapping table for 2-pass state and distance sort.
     ea::unordered_map<unsigned short, unsigned short> geometryRemapping_;
+    /// Radix sort keys.
+    ea::vector<BatchSortKey> sortKeys_;
+    /// Radix sort temporary keys.
+    ea::vector<BatchSortKey> sortKeysTemp_;
 
     /// Unsorted non-instanced draw calls.
     ea::vector<Batch> batches_;
@@ -320,12 +362,17 @@ struct ShadowBatchQueue
 /// Queue for light related draw calls.
 struct LightBatchQueue
 {
+    /// Calculate light and shadow matrices ahead of rendering. Is thread-safe once shadow cameras have been set up.
+    void CalculateLightMatrices(Renderer* renderer);
+
     /// Per-pixel light.
     Light* light_;
     /// Light negative flag.
     bool negative_;
     /// Shadow map depth texture.
     Texture2D* shadowMap_;
+    /// Hash of the shadow cameras and casters for reusing a cached shadow map, or zero if the shadow map can not be cached.
+    unsigned shadowMapHash_{};
     /// Lit geometry draw calls, base (replace blend mode).
     BatchQueue litBaseBatches_;
     /// Lit geometry draw calls, non-base (additive).
@@ -336,6 +383,10 @@ struct LightBatchQueue
     ea::vector<Light*> vertexLights_;
     /// Light volume draw calls.
     ea::vector<Batch> volumeBatches_;
+    /// Precalculated light matrices: shadow split matrices for directional lights, spot and shadow matrix for spot lights.
+    Matrix4 lightMatrices_[MAX_CASCADE_SPLITS > 2 ? MAX_CASCADE_SPLITS : 2];
+    /// Number of valid precalculated light matrices.
+    unsigned numLightMatrices_{};
 };
 
 }
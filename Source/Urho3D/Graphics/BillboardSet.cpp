@@ -240,8 +240,10 @@ void BillboardSet::UpdateGeometry(const FrameInfo& frame)
     if (bufferSizeDirty_ || indexBuffer_->IsDataLost())
         UpdateBufferSize();
 
-    if (bufferDirty_ || sortThisFrame_ || vertexBuffer_->IsDataLost())
+    if (bufferDirty_ || vertexBuffer_->IsDataLost())
         UpdateVertexBuffer(frame);
+    else if (sortThisFrame_)
+        UpdateSortedIndices(frame);
 }
 
 UpdateGeometryType BillboardSet::GetUpdateGeometryType()
@@ -532,17 +534,24 @@ void BillboardSet::UpdateBufferSize()
     if (!numBillboards)
         return;
 
-    // Indices do not change for a given billboard capacity
+    // Indices do not change for a given billboard capacity unless sorted through the index buffer
+    FillIndexBuffer(numBillboards, nullptr);
+    indicesSorted_ = false;
+    indexBuffer_->ClearDataLost();
+}
+
+void BillboardSet::FillIndexBuffer(unsigned numBillboards, const unsigned* order)
+{
     void* destPtr = indexBuffer_->Lock(0, numBillboards * 6, true);
     if (!destPtr)
         return;
 
-    if (!largeIndices)
+    if (indexBuffer_->GetIndexSize() == sizeof(unsigned short))
     {
         auto* dest = (unsigned short*)destPtr;
-        unsigned short vertexIndex = 0;
-        while (numBillboards--)
+        for (unsigned i = 0; i < numBillboards; ++i)
         {
+            auto vertexIndex = (unsigned short)((order ? order[i] : i) * 4);
             dest[0] = vertexIndex;
             dest[1] = vertexIndex + 1;
             dest[2] = vertexIndex + 2;
@@ -551,15 +560,14 @@ void BillboardSet::UpdateBufferSize()
             dest[5] = vertexIndex;
 
             dest += 6;
-            vertexIndex += 4;
         }
     }
     else
     {
         auto* dest = (unsigned*)destPtr;
-        unsigned vertexIndex = 0;
-        while (numBillboards--)
+        for (unsigned i = 0; i < numBillboards; ++i)
         {
+            unsigned vertexIndex = (order ? order[i] : i) * 4;
             dest[0] = vertexIndex;
             dest[1] = vertexIndex + 1;
             dest[2] = vertexIndex + 2;
@@ -568,12 +576,10 @@ void BillboardSet::UpdateBufferSize()
             dest[5] = vertexIndex;
 
             dest += 6;
-            vertexIndex += 4;
         }
     }
 
     indexBuffer_->Unlock();
-    indexBuffer_->ClearDataLost();
 }
 
 void BillboardSet::UpdateVertexBuffer(const FrameInfo& frame)
@@ -764,6 +770,41 @@ void BillboardSet::UpdateVertexBuffer(const FrameInfo& frame)
 
     vertexBuffer_->Unlock();
     vertexBuffer_->ClearDataLost();
+
+    // Vertices are now written in sorted order, so a previously sorted index buffer must be made sequential again
+    if (indicesSorted_)
+    {
+        FillIndexBuffer(enabledBillboards, nullptr);
+        indicesSorted_ = false;
+    }
+}
+
+void BillboardSet::UpdateSortedIndices(const FrameInfo& frame)
+{
+    const unsigned numSorted = sortedBillboards_.size();
+    if (!sorted_ || !numSorted)
+        return;
+
+    // Only the draw order changes when the camera moves, so permute the quads instead of rewriting their vertices
+    const Matrix3x4& worldTransform = node_->GetWorldTransform();
+    Matrix3x4 billboardTransform = relative_ ? worldTransform : Matrix3x4::IDENTITY;
+
+    sortOrder_.resize(numSorted);
+    for (unsigned i = 0; i < numSorted; ++i)
+    {
+        Billboard& billboard = *sortedBillboards_[i];
+        billboard.sortDistance_ = frame.camera_->GetDistanceSquared(billboardTransform * billboard.position_);
+        sortOrder_[i] = i;
+    }
+
+    ea::quick_sort(sortOrder_.begin(), sortOrder_.end(),
+        [this](unsigned lhs, unsigned rhs) { return CompareBillboards(sortedBillboards_[lhs], sortedBillboards_[rhs]); });
+
+    FillIndexBuffer(numSorted, sortOrder_.data());
+    indicesSorted_ = true;
+
+    Vector3 worldPos = node_->GetWorldPosition();
+    previousOffset_ = (worldPos - frame.camera_->GetNode()->GetWorldPosition());
 }
 
 void BillboardSet::MarkPositionsDirty()
@@ -812,7 +853,7 @@ void BillboardSet::CalculateFixedScreenSize(const FrameInfo& frame)
     {
         bufferDirty_ = true;
         forceUpdate_ = true;
-        worldBoundingBoxDirty_ = true;
+        MarkWorldBoundingBoxDirty();
     }
 }
 
@@ -188,6 +188,10 @@ private:
     void UpdateBufferSize();
     /// Rewrite billboard vertex buffer.
     void UpdateVertexBuffer(const FrameInfo& frame);
+    /// Re-sort the billboards by rewriting only the index buffer, leaving the vertices as they are.
+    void UpdateSortedIndices(const FrameInfo& frame);
+    /// Write quad indices for the billboards in the vertex slot order, or sequentially if no order is given.
+    void FillIndexBuffer(unsigned numBillboards, const unsigned* order);
     /// Calculate billboard scale factors in fixed screen size mode.
     void CalculateFixedScreenSize(const FrameInfo& frame);
 
@@ -207,7 +211,7 @@ private:
     bool forceUpdate_;
     /// Update billboard geometry type.
     bool geometryTypeUpdate_;
-    /// Sorting flag. Triggers a vertex buffer rewrite for each view this billboard set is rendered from.
+    /// Sorting flag. Triggers an index buffer rewrite for each view this billboard set is rendered from.
     bool sortThisFrame_;
     /// Whether was last rendered from an ortho camera.
     bool hasOrthoCamera_;
@@ -215,8 +219,12 @@ private:
     unsigned sortFrameNumber_;
     /// Previous offset to camera for determining whether sorting is necessary.
     Vector3 previousOffset_;
-    /// Billboard pointers for sorting.
+    /// Billboard pointers for sorting. Matches the vertex buffer order after a vertex buffer rewrite.
     ea::vector<Billboard*> sortedBillboards_;
+    /// Back to front order of the vertex slots when sorting through the index buffer.
+    ea::vector<unsigned> sortOrder_;
+    /// Whether the index buffer holds a sorted order instead of a sequential one.
+    bool indicesSorted_{};
     /// Attribute buffer for network replication.
     mutable VectorBuffer attrBuffer_;
 };
@@ -26,6 +26,7 @@
 #include "../Graphics/Camera.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/Drawable.h"
+#include "../IO/Log.h"
 #include "../Scene/Node.h"
 
 #include "../DebugNew.h"
@@ -265,6 +266,73 @@ void Camera::SetProjection(const Matrix4& projection)
     MarkNetworkUpdate();
 }
 
+bool Camera::SetStereoCullProjection(Camera* leftEye, Camera* rightEye)
+{
+    if (!node_ || !leftEye || !rightEye || !leftEye->GetNode() || !rightEye->GetNode())
+    {
+        URHO3D_LOGERROR("Stereo culling camera and eye cameras must be attached to nodes");
+        return false;
+    }
+
+    // Gather the edge slopes of the eye frustums and the bounds of the eye positions in the view space of this camera
+    const Matrix3x4& view = GetView();
+    float left = M_INFINITY, right = -M_INFINITY, bottom = M_INFINITY, top = -M_INFINITY;
+    float nearZ = M_INFINITY, farZ = -M_INFINITY;
+    Vector3 minPosition(M_INFINITY, M_INFINITY, M_INFINITY);
+    Vector3 maxPosition(-M_INFINITY, -M_INFINITY, -M_INFINITY);
+
+    for (Camera* eye : {leftEye, rightEye})
+    {
+        const Matrix4 projection = eye->GetProjection();
+        if (projection.m33_ != 0.0f || !eye->GetNode()->GetWorldRotation().Equals(node_->GetWorldRotation()))
+        {
+            URHO3D_LOGERROR("Stereo eye cameras must use perspective projection and have the same orientation as the culling camera");
+            return false;
+        }
+
+        left = Min(left, (-1.0f - projection.m02_) / projection.m00_);
+        right = Max(right, (1.0f - projection.m02_) / projection.m00_);
+        bottom = Min(bottom, (-1.0f - projection.m12_) / projection.m11_);
+        top = Max(top, (1.0f - projection.m12_) / projection.m11_);
+
+        const Vector3 position = view * eye->GetNode()->GetWorldPosition();
+        minPosition = VectorMin(minPosition, position);
+        maxPosition = VectorMax(maxPosition, position);
+        nearZ = Min(nearZ, position.z_ + eye->GetNearClip());
+        farZ = Max(farZ, position.z_ + eye->GetFarClip());
+    }
+
+    if (left >= 0.0f || right <= 0.0f || bottom >= 0.0f || top <= 0.0f)
+    {
+        URHO3D_LOGERROR("Stereo eye frustums must contain the view direction");
+        return false;
+    }
+
+    // Move the apex back until the combined frustum encloses the eye positions, and thus the frustums starting from them
+    const float apexDistance = Max((maxPosition.x_ - minPosition.x_) / (right - left),
+        (maxPosition.y_ - minPosition.y_) / (top - bottom));
+    const Vector3 apex(maxPosition.x_ - right * apexDistance, maxPosition.y_ - top * apexDistance,
+        minPosition.z_ - apexDistance);
+
+    const float apexNear = nearZ - apex.z_;
+    const float apexFar = farZ - apex.z_;
+    const float q = apexFar / (apexFar - apexNear);
+
+    const Matrix4 apexProjection(
+        2.0f / (right - left), 0.0f, -(right + left) / (right - left), 0.0f,
+        0.0f, 2.0f / (top - bottom), -(top + bottom) / (top - bottom), 0.0f,
+        0.0f, 0.0f, q, -q * apexNear,
+        0.0f, 0.0f, 1.0f, 0.0f);
+    const Matrix4 apexOffset(
+        1.0f, 0.0f, 0.0f, -apex.x_,
+        0.0f, 1.0f, 0.0f, -apex.y_,
+        0.0f, 0.0f, 1.0f, -apex.z_,
+        0.0f, 0.0f, 0.0f, 1.0f);
+
+    SetProjection(apexProjection * apexOffset);
+    return true;
+}
+
 float Camera::GetNearClip() const
 {
     if (projectionDirty_)
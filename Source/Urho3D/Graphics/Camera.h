@@ -105,6 +105,10 @@ public:
         Note that the custom projection is not serialized or replicated through the network.
      */
     void SetProjection(const Matrix4& projection);
+    /// Set custom projection enclosing the frustums of two eye cameras, for using this camera as the culling camera of both eye viewports. The eyes must use perspective projection and have the same orientation as this camera. Return true if successful.
+    /** Culling and batches are then prepared once and shared by both eye views. The projection needs to be set again whenever the eyes move relative to this camera or change their projection.
+     */
+    bool SetStereoCullProjection(Camera* leftEye, Camera* rightEye);
 
     /// Return far clip distance. If a custom projection matrix is in use, is calculated from it instead of the value assigned with SetFarClip().
     float GetFarClip() const;
@@ -67,11 +67,20 @@ public:
     /// Return whether has unapplied data.
     bool IsDirty() const { return dirty_; }
 
+    /// Return byte offset of the applied data within the GPU-side buffer. On OpenGL the buffer holds a ring of data versions, elsewhere the offset is always zero.
+    unsigned GetOffset() const { return offset_; }
+
 private:
     /// Shadow data.
     ea::unique_ptr<unsigned char[]> shadowData_;
     /// Buffer byte size.
     unsigned size_{};
+    /// Byte offset of the applied data within the GPU-side buffer. Used only on OpenGL.
+    unsigned offset_{};
+    /// Distance between data versions in the GPU-side buffer, a multiple of the uniform buffer offset alignment. Used only on OpenGL.
+    unsigned stride_{};
+    /// GPU-side buffer byte size. Used only on OpenGL.
+    unsigned capacity_{};
     /// Dirty flag.
     bool dirty_{};
 };
@@ -30,6 +30,7 @@
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Light.h"
+#include "../Graphics/Renderer.h"
 #include "../Graphics/ShaderVariation.h"
 #include "../Graphics/VertexBuffer.h"
 #include "../Graphics/IndexBuffer.h"
@@ -48,6 +49,19 @@ extern const char* SUBSYSTEM_CATEGORY;
 static const unsigned MAX_LINES = 1000000;
 // Cap the amount of triangles to prevent crash.
 static const unsigned MAX_TRIANGLES = 100000;
+// Cap the amount of instanced shapes.
+static const unsigned MAX_SHAPES = 100000;
+
+/// Append primitive vertices as position and packed color.
+static void WriteDebugVertex(ea::vector<float>& dest, const Vector3& position, unsigned color)
+{
+    float packedColor;
+    memcpy(&packedColor, &color, sizeof(unsigned));
+    dest.push_back(position.x_);
+    dest.push_back(position.y_);
+    dest.push_back(position.z_);
+    dest.push_back(packedColor);
+}
 
 DebugRenderer::DebugRenderer(Context* context) :
     Component(context),
@@ -538,106 +552,205 @@ void DebugRenderer::AddQuad(const Vector3& center, float width, float height, co
     AddLine(v3, v0, uintColor, depthTest);
 }
 
-void DebugRenderer::Render()
+void DebugRenderer::AddLines(ea::span<const DebugLine> lines, bool depthTest)
 {
-    if (!HasContent())
-        return;
+    const unsigned numLines = lines_.size() + noDepthLines_.size();
+    const unsigned count = Min(static_cast<unsigned>(lines.size()), MAX_LINES - Min(numLines, MAX_LINES));
 
-    auto* graphics = GetSubsystem<Graphics>();
-    // Engine does not render when window is closed or device is lost
-    assert(graphics && graphics->IsInitialized() && !graphics->IsDeviceLost());
+    ea::vector<DebugLine>& dest = depthTest ? lines_ : noDepthLines_;
+    dest.insert(dest.end(), lines.begin(), lines.begin() + count);
+}
 
-    URHO3D_PROFILE("RenderDebugGeometry");
+void DebugRenderer::AddTriangles(ea::span<const DebugTriangle> triangles, bool depthTest)
+{
+    const unsigned numTriangles = triangles_.size() + noDepthTriangles_.size();
+    const unsigned count = Min(static_cast<unsigned>(triangles.size()), MAX_TRIANGLES - Min(numTriangles, MAX_TRIANGLES));
 
-    ShaderVariation* vs = graphics->GetShader(VS, "Basic", "VERTEXCOLOR");
-    ShaderVariation* ps = graphics->GetShader(PS, "Basic", "VERTEXCOLOR");
+    ea::vector<DebugTriangle>& dest = depthTest ? triangles_ : noDepthTriangles_;
+    dest.insert(dest.end(), triangles.begin(), triangles.begin() + count);
+}
 
-    unsigned numVertices = (lines_.size() + noDepthLines_.size()) * 2 + (triangles_.size() + noDepthTriangles_.size()) * 3;
-    // Resize the vertex buffer if too small or much too large
-    if (vertexBuffer_->GetVertexCount() < numVertices || vertexBuffer_->GetVertexCount() > numVertices * 2)
-        vertexBuffer_->SetSize(numVertices, MASK_POSITION | MASK_COLOR, true);
+void DebugRenderer::AddBoxes(ea::span<const Matrix3x4> transforms, const Color& color, bool depthTest)
+{
+    const unsigned count = Min(static_cast<unsigned>(transforms.size()), MAX_SHAPES - Min(shapeTransforms_.size(), MAX_SHAPES));
+    if (!count)
+        return;
+
+    // Extend the previous batch if it draws the same shape, otherwise start a new one
+    DebugShapeBatch* batch = shapeBatches_.empty() ? nullptr : &shapeBatches_.back();
+    if (!batch || batch->shape_ != DEBUG_SHAPE_BOX || batch->color_ != color || batch->depthTest_ != depthTest)
+    {
+        batch = &shapeBatches_.push_back();
+        batch->shape_ = DEBUG_SHAPE_BOX;
+        batch->color_ = color;
+        batch->depthTest_ = depthTest;
+        batch->start_ = shapeTransforms_.size();
+        batch->count_ = 0;
+    }
 
-    auto* dest = (float*)vertexBuffer_->Lock(0, numVertices, true);
-    if (!dest)
+    shapeTransforms_.insert(shapeTransforms_.end(), transforms.begin(), transforms.begin() + count);
+    batch->count_ += count;
+}
+
+void DebugRenderer::AddSpheres(ea::span<const Sphere> spheres, const Color& color, bool depthTest)
+{
+    const unsigned count = Min(static_cast<unsigned>(spheres.size()), MAX_SHAPES - Min(shapeTransforms_.size(), MAX_SHAPES));
+    if (!count)
         return;
 
-    for (unsigned i = 0; i < lines_.size(); ++i)
+    DebugShapeBatch* batch = shapeBatches_.empty() ? nullptr : &shapeBatches_.back();
+    if (!batch || batch->shape_ != DEBUG_SHAPE_SPHERE || batch->color_ != color || batch->depthTest_ != depthTest)
     {
-        const DebugLine& line = lines_[i];
-
-        dest[0] = line.start_.x_;
-        dest[1] = line.start_.y_;
-        dest[2] = line.start_.z_;
-        ((unsigned&)dest[3]) = line.color_;
-        dest[4] = line.end_.x_;
-        dest[5] = line.end_.y_;
-        dest[6] = line.end_.z_;
-        ((unsigned&)dest[7]) = line.color_;
-
-        dest += 8;
+        batch = &shapeBatches_.push_back();
+        batch->shape_ = DEBUG_SHAPE_SPHERE;
+        batch->color_ = color;
+        batch->depthTest_ = depthTest;
+        batch->start_ = shapeTransforms_.size();
+        batch->count_ = 0;
     }
 
-    for (unsigned i = 0; i < noDepthLines_.size(); ++i)
+    for (unsigned i = 0; i < count; ++i)
+        shapeTransforms_.push_back(Matrix3x4(spheres[i].center_, Quaternion::IDENTITY, spheres[i].radius_));
+    batch->count_ += count;
+}
+
+unsigned DebugRenderer::AddPersistentLines(ea::span<const DebugLine> lines, bool depthTest)
+{
+    ea::vector<float> vertexData;
+    vertexData.reserve(lines.size() * 8);
+    for (const DebugLine& line : lines)
     {
-        const DebugLine& line = noDepthLines_[i];
-
-        dest[0] = line.start_.x_;
-        dest[1] = line.start_.y_;
-        dest[2] = line.start_.z_;
-        ((unsigned&)dest[3]) = line.color_;
-        dest[4] = line.end_.x_;
-        dest[5] = line.end_.y_;
-        dest[6] = line.end_.z_;
-        ((unsigned&)dest[7]) = line.color_;
-
-        dest += 8;
+        WriteDebugVertex(vertexData, line.start_, line.color_);
+        WriteDebugVertex(vertexData, line.end_, line.color_);
     }
 
-    for (unsigned i = 0; i < triangles_.size(); ++i)
+    return AddPersistentGeometry(vertexData, LINE_LIST, depthTest);
+}
+
+unsigned DebugRenderer::AddPersistentTriangles(ea::span<const DebugTriangle> triangles, bool depthTest)
+{
+    ea::vector<float> vertexData;
+    vertexData.reserve(triangles.size() * 12);
+    for (const DebugTriangle& triangle : triangles)
     {
-        const DebugTriangle& triangle = triangles_[i];
+        WriteDebugVertex(vertexData, triangle.v1_, triangle.color_);
+        WriteDebugVertex(vertexData, triangle.v2_, triangle.color_);
+        WriteDebugVertex(vertexData, triangle.v3_, triangle.color_);
+    }
 
-        dest[0] = triangle.v1_.x_;
-        dest[1] = triangle.v1_.y_;
-        dest[2] = triangle.v1_.z_;
-        ((unsigned&)dest[3]) = triangle.color_;
+    return AddPersistentGeometry(vertexData, TRIANGLE_LIST, depthTest);
+}
 
-        dest[4] = triangle.v2_.x_;
-        dest[5] = triangle.v2_.y_;
-        dest[6] = triangle.v2_.z_;
-        ((unsigned&)dest[7]) = triangle.color_;
+void DebugRenderer::RemovePersistentGeometry(unsigned handle)
+{
+    persistentGeometry_.erase(handle);
+}
 
-        dest[8] = triangle.v3_.x_;
-        dest[9] = triangle.v3_.y_;
-        dest[10] = triangle.v3_.z_;
-        ((unsigned&)dest[11]) = triangle.color_;
+void DebugRenderer::RemoveAllPersistentGeometry()
+{
+    persistentGeometry_.clear();
+}
 
-        dest += 12;
-    }
+void DebugRenderer::Render()
+{
+    if (!HasContent())
+        return;
+
+    auto* graphics = GetSubsystem<Graphics>();
+    // Engine does not render when window is closed or device is lost
+    assert(graphics && graphics->IsInitialized() && !graphics->IsDeviceLost());
+
+    URHO3D_PROFILE("RenderDebugGeometry");
 
-    for (unsigned i = 0; i < noDepthTriangles_.size(); ++i)
+    unsigned numVertices = (lines_.size() + noDepthLines_.size()) * 2 + (triangles_.size() + noDepthTriangles_.size()) * 3;
+    if (numVertices)
     {
-        const DebugTriangle& triangle = noDepthTriangles_[i];
+        // Resize the vertex buffer if too small or much too large
+        if (vertexBuffer_->GetVertexCount() < numVertices || vertexBuffer_->GetVertexCount() > numVertices * 2)
+            vertexBuffer_->SetSize(numVertices, MASK_POSITION | MASK_COLOR, true);
 
-        dest[0] = triangle.v1_.x_;
-        dest[1] = triangle.v1_.y_;
-        dest[2] = triangle.v1_.z_;
-        ((unsigned&)dest[3]) = triangle.color_;
+        auto* dest = (float*)vertexBuffer_->Lock(0, numVertices, true);
+        if (!dest)
+            return;
 
-        dest[4] = triangle.v2_.x_;
-        dest[5] = triangle.v2_.y_;
-        dest[6] = triangle.v2_.z_;
-        ((unsigned&)dest[7]) = triangle.color_;
+        for (unsigned i = 0; i < lines_.size(); ++i)
+        {
+            const DebugLine& line = lines_[i];
+
+            dest[0] = line.start_.x_;
+            dest[1] = line.start_.y_;
+            dest[2] = line.start_.z_;
+            ((unsigned&)dest[3]) = line.color_;
+            dest[4] = line.end_.x_;
+            dest[5] = line.end_.y_;
+            dest[6] = line.end_.z_;
+            ((unsigned&)dest[7]) = line.color_;
+
+            dest += 8;
+        }
 
-        dest[8] = triangle.v3_.x_;
-        dest[9] = triangle.v3_.y_;
-        dest[10] = triangle.v3_.z_;
-        ((unsigned&)dest[11]) = triangle.color_;
+        for (unsigned i = 0; i < noDepthLines_.size(); ++i)
+        {
+            const DebugLine& line = noDepthLines_[i];
+
+            dest[0] = line.start_.x_;
+            dest[1] = line.start_.y_;
+            dest[2] = line.start_.z_;
+            ((unsigned&)dest[3]) = line.color_;
+            dest[4] = line.end_.x_;
+            dest[5] = line.end_.y_;
+            dest[6] = line.end_.z_;
+            ((unsigned&)dest[7]) = line.color_;
+
+            dest += 8;
+        }
 
-        dest += 12;
-    }
+        for (unsigned i = 0; i < triangles_.size(); ++i)
+        {
+            const DebugTriangle& triangle = triangles_[i];
+
+            dest[0] = triangle.v1_.x_;
+            dest[1] = triangle.v1_.y_;
+            dest[2] = triangle.v1_.z_;
+            ((unsigned&)dest[3]) = triangle.color_;
 
-    vertexBuffer_->Unlock();
+            dest[4] = triangle.v2_.x_;
+            dest[5] = triangle.v2_.y_;
+            dest[6] = triangle.v2_.z_;
+            ((unsigned&)dest[7]) = triangle.color_;
+
+            dest[8] = triangle.v3_.x_;
+            dest[9] = triangle.v3_.y_;
+            dest[10] = triangle.v3_.z_;
+            ((unsigned&)dest[11]) = triangle.color_;
+
+            dest += 12;
+        }
+
+        for (unsigned i = 0; i < noDepthTriangles_.size(); ++i)
+        {
+            const DebugTriangle& triangle = noDepthTriangles_[i];
+
+            dest[0] = triangle.v1_.x_;
+            dest[1] = triangle.v1_.y_;
+            dest[2] = triangle.v1_.z_;
+            ((unsigned&)dest[3]) = triangle.color_;
+
+            dest[4] = triangle.v2_.x_;
+            dest[5] = triangle.v2_.y_;
+            dest[6] = triangle.v2_.z_;
+            ((unsigned&)dest[7]) = triangle.color_;
+
+            dest[8] = triangle.v3_.x_;
+            dest[9] = triangle.v3_.y_;
+            dest[10] = triangle.v3_.z_;
+            ((unsigned&)dest[11]) = triangle.color_;
+
+            dest += 12;
+        }
+
+        vertexBuffer_->Unlock();
+    }
 
     graphics->SetBlendMode(lineAntiAlias_ ? BLEND_ALPHA : BLEND_REPLACE);
     graphics->SetColorWrite(true);
@@ -646,12 +759,7 @@ void DebugRenderer::Render()
     graphics->SetLineAntiAlias(lineAntiAlias_);
     graphics->SetScissorTest(false);
     graphics->SetStencilTest(false);
-    graphics->SetShaders(vs, ps);
-    graphics->SetShaderParameter(VSP_MODEL, Matrix3x4::IDENTITY);
-    graphics->SetShaderParameter(VSP_VIEW, view_);
-    graphics->SetShaderParameter(VSP_VIEWINV, view_.Inverse());
-    graphics->SetShaderParameter(VSP_VIEWPROJ, gpuProjection_ * view_);
-    graphics->SetShaderParameter(PSP_MATDIFFCOLOR, Color(1.0f, 1.0f, 1.0f, 1.0f));
+    SetShaders(false);
     graphics->SetVertexBuffer(vertexBuffer_);
 
     unsigned start = 0;
@@ -671,8 +779,12 @@ void DebugRenderer::Render()
         start += count;
     }
 
+    RenderRetained(LINE_LIST);
+
     graphics->SetBlendMode(BLEND_ALPHA);
     graphics->SetDepthWrite(false);
+    SetShaders(false);
+    graphics->SetVertexBuffer(vertexBuffer_);
 
     if (triangles_.size())
     {
@@ -688,6 +800,8 @@ void DebugRenderer::Render()
         graphics->Draw(TRIANGLE_LIST, start, count);
     }
 
+    RenderRetained(TRIANGLE_LIST);
+
     graphics->SetLineAntiAlias(false);
 }
 
@@ -698,7 +812,178 @@ bool DebugRenderer::IsInside(const BoundingBox& box) const
 
 bool DebugRenderer::HasContent() const
 {
-    return !(lines_.empty() && noDepthLines_.empty() && triangles_.empty() && noDepthTriangles_.empty());
+    return !(lines_.empty() && noDepthLines_.empty() && triangles_.empty() && noDepthTriangles_.empty() &&
+        shapeBatches_.empty() && persistentGeometry_.empty());
+}
+
+unsigned DebugRenderer::AddPersistentGeometry(const ea::vector<float>& vertexData, PrimitiveType type, bool depthTest)
+{
+    const unsigned numVertices = vertexData.size() / 4;
+    if (!numVertices)
+        return 0;
+
+    // Shadowed so that the data survives device loss without the caller resubmitting it
+    auto vertexBuffer = MakeShared<VertexBuffer>(context_);
+    vertexBuffer->SetShadowed(true);
+    if (!vertexBuffer->SetSize(numVertices, MASK_POSITION | MASK_COLOR) || !vertexBuffer->SetData(vertexData.data()))
+        return 0;
+
+    const unsigned handle = nextPersistentHandle_++;
+    PersistentDebugGeometry& geometry = persistentGeometry_[handle];
+    geometry.vertexBuffer_ = vertexBuffer;
+    geometry.type_ = type;
+    geometry.depthTest_ = depthTest;
+    return handle;
+}
+
+void DebugRenderer::CreateShapeBuffers()
+{
+    const unsigned white = Color::WHITE.ToUInt();
+    ea::vector<float> vertexData;
+
+    // Unit cube edges
+    static const Vector3 cubeVertices[] = {
+        {-0.5f, -0.5f, -0.5f}, {0.5f, -0.5f, -0.5f}, {0.5f, 0.5f, -0.5f}, {-0.5f, 0.5f, -0.5f},
+        {-0.5f, -0.5f, 0.5f}, {0.5f, -0.5f, 0.5f}, {-0.5f, 0.5f, 0.5f}, {0.5f, 0.5f, 0.5f}
+    };
+    static const unsigned cubeEdges[] = { 0, 1, 1, 2, 2, 3, 3, 0, 4, 5, 5, 7, 7, 6, 6, 4, 0, 4, 1, 5, 2, 7, 3, 6 };
+    for (unsigned index : cubeEdges)
+        WriteDebugVertex(vertexData, cubeVertices[index], white);
+    shapeRanges_[DEBUG_SHAPE_BOX] = IntVector2(0, vertexData.size() / 4);
+
+    // Unit sphere with the same tessellation as AddSphere
+    const Sphere sphere(Vector3::ZERO, 1.0f);
+    for (auto j = 0; j < 180; j += 45)
+    {
+        for (auto i = 0; i < 360; i += 45)
+        {
+            Vector3 p1 = sphere.GetPoint(i, j);
+            Vector3 p2 = sphere.GetPoint(i + 45, j);
+            Vector3 p3 = sphere.GetPoint(i, j + 45);
+            Vector3 p4 = sphere.GetPoint(i + 45, j + 45);
+
+            WriteDebugVertex(vertexData, p1, white);
+            WriteDebugVertex(vertexData, p2, white);
+            WriteDebugVertex(vertexData, p3, white);
+            WriteDebugVertex(vertexData, p4, white);
+            WriteDebugVertex(vertexData, p1, white);
+            WriteDebugVertex(vertexData, p3, white);
+            WriteDebugVertex(vertexData, p2, white);
+            WriteDebugVertex(vertexData, p4, white);
+        }
+    }
+    const unsigned sphereStart = shapeRanges_[DEBUG_SHAPE_BOX].y_;
+    shapeRanges_[DEBUG_SHAPE_SPHERE] = IntVector2(sphereStart, vertexData.size() / 4 - sphereStart);
+
+    const unsigned numVertices = vertexData.size() / 4;
+    ea::vector<unsigned short> indexData(numVertices);
+    for (unsigned i = 0; i < numVertices; ++i)
+        indexData[i] = static_cast<unsigned short>(i);
+
+    shapeVertexBuffer_ = MakeShared<VertexBuffer>(context_);
+    shapeVertexBuffer_->SetShadowed(true);
+    shapeVertexBuffer_->SetSize(numVertices, MASK_POSITION | MASK_COLOR);
+    shapeVertexBuffer_->SetData(vertexData.data());
+
+    shapeIndexBuffer_ = MakeShared<IndexBuffer>(context_);
+    shapeIndexBuffer_->SetShadowed(true);
+    shapeIndexBuffer_->SetSize(numVertices, false);
+    shapeIndexBuffer_->SetData(indexData.data());
+}
+
+void DebugRenderer::RenderRetained(PrimitiveType type)
+{
+    auto* graphics = GetSubsystem<Graphics>();
+
+    // Persistent geometry is already on the GPU, only the draw calls are issued
+    bool shadersSet = false;
+    for (const auto& item : persistentGeometry_)
+    {
+        const PersistentDebugGeometry& geometry = item.second;
+        if (geometry.type_ != type)
+            continue;
+
+        if (!shadersSet)
+        {
+            SetShaders(false);
+            shadersSet = true;
+        }
+
+        graphics->SetDepthTest(geometry.depthTest_ ? CMP_LESSEQUAL : CMP_ALWAYS);
+        graphics->SetVertexBuffer(geometry.vertexBuffer_);
+        graphics->Draw(type, 0, geometry.vertexBuffer_->GetVertexCount());
+    }
+
+    // Shapes are wireframe only
+    if (type != LINE_LIST || shapeBatches_.empty())
+        return;
+
+    if (!shapeVertexBuffer_)
+        CreateShapeBuffers();
+
+    auto* renderer = GetSubsystem<Renderer>();
+    VertexBuffer* instanceBuffer = renderer && graphics->GetInstancingSupport() ? renderer->GetInstancingBuffer() : nullptr;
+
+    unsigned instanceStart = 0;
+    auto* dest = instanceBuffer ? static_cast<unsigned char*>(
+        renderer->LockInstancingBuffer(shapeTransforms_.size(), instanceStart)) : nullptr;
+    graphics->SetIndexBuffer(shapeIndexBuffer_);
+
+    if (dest)
+    {
+        // Only the instance transform is used by the basic shader, the rest of the instance data is left as is
+        const unsigned stride = instanceBuffer->GetVertexSize();
+        for (const Matrix3x4& transform : shapeTransforms_)
+        {
+            memcpy(dest, &transform, sizeof(Matrix3x4));
+            dest += stride;
+        }
+        renderer->UnlockInstancingBuffer();
+
+        SetShaders(true);
+        const ea::vector<VertexBuffer*> vertexBuffers{ shapeVertexBuffer_.Get(), instanceBuffer };
+        for (const DebugShapeBatch& batch : shapeBatches_)
+        {
+            const IntVector2& range = shapeRanges_[batch.shape_];
+            graphics->SetDepthTest(batch.depthTest_ ? CMP_LESSEQUAL : CMP_ALWAYS);
+            graphics->SetShaderParameter(PSP_MATDIFFCOLOR, batch.color_);
+            graphics->SetVertexBuffers(vertexBuffers, instanceStart + batch.start_);
+            graphics->DrawInstanced(LINE_LIST, range.x_, range.y_, 0, shapeVertexBuffer_->GetVertexCount(), batch.count_);
+        }
+    }
+    else
+    {
+        // Without instancing still avoid the upload, and draw each shape with its own transform
+        SetShaders(false);
+        graphics->SetVertexBuffer(shapeVertexBuffer_);
+        for (const DebugShapeBatch& batch : shapeBatches_)
+        {
+            const IntVector2& range = shapeRanges_[batch.shape_];
+            graphics->SetDepthTest(batch.depthTest_ ? CMP_LESSEQUAL : CMP_ALWAYS);
+            graphics->SetShaderParameter(PSP_MATDIFFCOLOR, batch.color_);
+            for (unsigned i = batch.start_; i < batch.start_ + batch.count_; ++i)
+            {
+                graphics->SetShaderParameter(VSP_MODEL, shapeTransforms_[i]);
+                graphics->Draw(LINE_LIST, range.x_, range.y_, 0, shapeVertexBuffer_->GetVertexCount());
+            }
+        }
+    }
+
+    graphics->SetIndexBuffer(nullptr);
+}
+
+void DebugRenderer::SetShaders(bool instanced)
+{
+    auto* graphics = GetSubsystem<Graphics>();
+    ShaderVariation* vs = graphics->GetShader(VS, "Basic", instanced ? "VERTEXCOLOR INSTANCED" : "VERTEXCOLOR");
+    ShaderVariation* ps = graphics->GetShader(PS, "Basic", "VERTEXCOLOR");
+
+    graphics->SetShaders(vs, ps);
+    graphics->SetShaderParameter(VSP_MODEL, Matrix3x4::IDENTITY);
+    graphics->SetShaderParameter(VSP_VIEW, view_);
+    graphics->SetShaderParameter(VSP_VIEWINV, view_.Inverse());
+    graphics->SetShaderParameter(VSP_VIEWPROJ, gpuProjection_ * view_);
+    graphics->SetShaderParameter(PSP_MATDIFFCOLOR, Color(1.0f, 1.0f, 1.0f, 1.0f));
 }
 
 void DebugRenderer::HandleEndFrame(StringHash eventType, VariantMap& eventData)
@@ -713,6 +998,8 @@ void DebugRenderer::HandleEndFrame(StringHash eventType, VariantMap& eventData)
     noDepthLines_.clear();
     triangles_.clear();
     noDepthTriangles_.clear();
+    shapeTransforms_.clear();
+    shapeBatches_.clear();
 
     if (lines_.capacity() > linesSize * 2)
         lines_.reserve(linesSize);
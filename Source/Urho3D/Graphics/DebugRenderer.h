@@ -22,10 +22,14 @@
 
 #pragma once
 
+#include "../Graphics/GraphicsDefs.h"
 #include "../Math/Color.h"
 #include "../Math/Frustum.h"
 #include "../Scene/Component.h"
 
+#include <EASTL/span.h>
+#include <EASTL/unordered_map.h>
+
 namespace Urho3D
 {
 
@@ -33,6 +37,7 @@ class BoundingBox;
 class Camera;
 class Polyhedron;
 class Drawable;
+class IndexBuffer;
 class Light;
 class Matrix3x4;
 class Renderer;
@@ -88,6 +93,40 @@ struct DebugTriangle
 };
 
 /// Debug geometry rendering component. Should be added only to the root scene node.
+/// Instanced debug shape.
+enum DebugShape
+{
+    DEBUG_SHAPE_BOX = 0,
+    DEBUG_SHAPE_SPHERE,
+    MAX_DEBUG_SHAPES
+};
+
+/// Range of instanced debug shapes sharing the shape, color and depth test.
+struct DebugShapeBatch
+{
+    /// Shape.
+    DebugShape shape_{};
+    /// Color.
+    Color color_;
+    /// Depth test flag.
+    bool depthTest_{};
+    /// Index of the first instance transform.
+    unsigned start_{};
+    /// Number of instances.
+    unsigned count_{};
+};
+
+/// Debug geometry uploaded once and redrawn every frame until removed.
+struct PersistentDebugGeometry
+{
+    /// Vertex buffer.
+    SharedPtr<VertexBuffer> vertexBuffer_;
+    /// Primitive type.
+    PrimitiveType type_{};
+    /// Depth test flag.
+    bool depthTest_{};
+};
+
 class URHO3D_API DebugRenderer : public Component
 {
     URHO3D_OBJECT(DebugRenderer, Component);
@@ -155,6 +194,23 @@ public:
     void AddCross(const Vector3& center, float size, const Color& color, bool depthTest = true);
     /// Add a quad on the XZ plane.
     void AddQuad(const Vector3& center, float width, float height, const Color& color, bool depthTest = true);
+    /// Add lines in bulk.
+    void AddLines(ea::span<const DebugLine> lines, bool depthTest = true);
+    /// Add solid triangles in bulk.
+    void AddTriangles(ea::span<const DebugTriangle> triangles, bool depthTest = true);
+    /// Add wireframe boxes as transforms of the unit cube centered at origin. Drawn with instancing when supported.
+    void AddBoxes(ea::span<const Matrix3x4> transforms, const Color& color, bool depthTest = true);
+    /// Add wireframe spheres. Drawn with instancing when supported.
+    void AddSpheres(ea::span<const Sphere> spheres, const Color& color, bool depthTest = true);
+
+    /// Add lines that stay until removed. Return handle of the persistent geometry, or 0 on failure.
+    unsigned AddPersistentLines(ea::span<const DebugLine> lines, bool depthTest = true);
+    /// Add solid triangles that stay until removed. Return handle of the persistent geometry, or 0 on failure.
+    unsigned AddPersistentTriangles(ea::span<const DebugTriangle> triangles, bool depthTest = true);
+    /// Remove persistent geometry by handle.
+    void RemovePersistentGeometry(unsigned handle);
+    /// Remove all persistent geometry.
+    void RemoveAllPersistentGeometry();
 
     /// Update vertex buffer and render all debug lines. The viewport and rendertarget should be set before.
     void Render();
@@ -175,8 +231,18 @@ public:
     bool IsInside(const BoundingBox& box) const;
     /// Return whether has something to render.
     bool HasContent() const;
+    /// Return whether persistent geometry with the handle exists.
+    bool HasPersistentGeometry(unsigned handle) const { return persistentGeometry_.find(handle) != persistentGeometry_.end(); }
 
 private:
+    /// Create the unit shape geometry for instanced drawing.
+    void CreateShapeBuffers();
+    /// Create a static vertex buffer for persistent geometry and return its handle.
+    unsigned AddPersistentGeometry(const ea::vector<float>& vertexData, PrimitiveType type, bool depthTest);
+    /// Draw instanced shapes and persistent geometry of the primitive type.
+    void RenderRetained(PrimitiveType type);
+    /// Set the basic vertex color shaders, optionally instanced, and the camera shader parameters.
+    void SetShaders(bool instanced);
     /// Handle end of frame. Clear debug geometry.
     void HandleEndFrame(StringHash eventType, VariantMap& eventData);
 
@@ -198,6 +264,20 @@ private:
     Frustum frustum_;
     /// Vertex buffer.
     SharedPtr<VertexBuffer> vertexBuffer_;
+    /// Instance transforms of the debug shapes.
+    ea::vector<Matrix3x4> shapeTransforms_;
+    /// Debug shape batches.
+    ea::vector<DebugShapeBatch> shapeBatches_;
+    /// Unit shape vertex buffer, all shapes packed one after another.
+    SharedPtr<VertexBuffer> shapeVertexBuffer_;
+    /// Unit shape index buffer, needed for instanced drawing.
+    SharedPtr<IndexBuffer> shapeIndexBuffer_;
+    /// Index start and count of each shape within the unit shape buffers.
+    IntVector2 shapeRanges_[MAX_DEBUG_SHAPES];
+    /// Persistent geometry by handle.
+    ea::unordered_map<unsigned, PersistentDebugGeometry> persistentGeometry_;
+    /// Next persistent geometry handle.
+    unsigned nextPersistentHandle_{1};
     /// Line antialiasing flag.
     bool lineAntiAlias_;
     /// Active camera.
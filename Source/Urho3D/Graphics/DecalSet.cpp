@@ -719,6 +719,7 @@ void DecalSet::GetFaces(ea::vector<ea::vector<DecalVertex> >& faces, Drawable* t
     }
 
     // For morphed models positions, normals and skinning may be in different buffers
+    ea::vector<Vector4> unpackedNormals;
     for (unsigned i = 0; i < geometry->GetNumVertexBuffers(); ++i)
     {
         VertexBuffer* vb = geometry->GetVertexBuffer(i);
@@ -737,8 +738,22 @@ void DecalSet::GetFaces(ea::vector<ea::vector<DecalVertex> >& faces, Drawable* t
         }
         if (elementMask & MASK_NORMAL)
         {
-            normalData = data + vb->GetElementOffset(SEM_NORMAL);
-            normalStride = vb->GetVertexSize();
+            const VertexElement* normalElement = vb->GetElement(SEM_NORMAL);
+            if (normalElement->type_ == TYPE_VECTOR3)
+            {
+                normalData = data + normalElement->offset_;
+                normalStride = vb->GetVertexSize();
+            }
+            else
+            {
+                // Faces read normals as Vector3, so unpack normals of other types. A Vector4 starts with the same layout
+                const unsigned vertexCount = vb->GetVertexCount();
+                unpackedNormals.resize(vertexCount);
+                VertexBuffer::UnpackVertexData(data, vb->GetVertexSize(), *normalElement, 0, vertexCount,
+                    unpackedNormals.data(), sizeof(Vector4));
+                normalData = reinterpret_cast<const unsigned char*>(unpackedNormals.data());
+                normalStride = sizeof(Vector4);
+            }
         }
         if (elementMask & MASK_BLENDWEIGHTS)
         {
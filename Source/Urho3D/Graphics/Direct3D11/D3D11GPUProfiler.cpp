@@ -0,0 +1,149 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../../Precompiled.h"
+
+#include "../../Graphics/Graphics.h"
+#include "../../Graphics/GraphicsImpl.h"
+#include "../../Graphics/GPUProfiler.h"
+#include "../../IO/Log.h"
+
+#include "../../DebugNew.h"
+
+namespace Urho3D
+{
+
+void GPUProfiler::OnDeviceLost()
+{
+    // No-op on Direct3D11
+}
+
+void GPUProfiler::Release()
+{
+    for (FrameQueries& frame : frames_)
+        ReleaseFrameQueries(frame);
+
+    inFrame_ = false;
+}
+
+bool GPUProfiler::IsSupported() const
+{
+    return graphics_ && graphics_->GetImpl()->GetDevice();
+}
+
+bool GPUProfiler::BeginFrameQueries(FrameQueries& frame)
+{
+    if (!frame.disjointQuery_.ptr_)
+    {
+        D3D11_QUERY_DESC queryDesc;
+        queryDesc.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
+        queryDesc.MiscFlags = 0;
+
+        HRESULT hr = graphics_->GetImpl()->GetDevice()->CreateQuery(&queryDesc, (ID3D11Query**)&frame.disjointQuery_.ptr_);
+        if (FAILED(hr))
+        {
+            URHO3D_SAFE_RELEASE(frame.disjointQuery_.ptr_);
+            URHO3D_LOGD3DERROR("Failed to create timestamp disjoint query", hr);
+            return false;
+        }
+    }
+
+    graphics_->GetImpl()->GetDeviceContext()->Begin((ID3D11Query*)frame.disjointQuery_.ptr_);
+    return IssueTimestamp(frame);
+}
+
+void GPUProfiler::EndFrameQueries(FrameQueries& frame)
+{
+    IssueTimestamp(frame);
+    graphics_->GetImpl()->GetDeviceContext()->End((ID3D11Query*)frame.disjointQuery_.ptr_);
+}
+
+bool GPUProfiler::IssueTimestamp(FrameQueries& frame)
+{
+    if (frame.numTimestamps_ == frame.timestampQueries_.size())
+    {
+        D3D11_QUERY_DESC queryDesc;
+        queryDesc.Query = D3D11_QUERY_TIMESTAMP;
+        queryDesc.MiscFlags = 0;
+
+        GPUObjectHandle query{};
+        HRESULT hr = graphics_->GetImpl()->GetDevice()->CreateQuery(&queryDesc, (ID3D11Query**)&query.ptr_);
+        if (FAILED(hr))
+        {
+            URHO3D_SAFE_RELEASE(query.ptr_);
+            URHO3D_LOGD3DERROR("Failed to create timestamp query", hr);
+            return false;
+        }
+        frame.timestampQueries_.push_back(query);
+    }
+
+    graphics_->GetImpl()->GetDeviceContext()->End((ID3D11Query*)frame.timestampQueries_[frame.numTimestamps_++].ptr_);
+    return true;
+}
+
+bool GPUProfiler::ReadTimestamps(FrameQueries& frame, ea::vector<double>& times)
+{
+    times.clear();
+
+    ID3D11DeviceContext* deviceContext = graphics_->GetImpl()->GetDeviceContext();
+    D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+    HRESULT hr = deviceContext->GetData((ID3D11Query*)frame.disjointQuery_.ptr_, &disjoint, sizeof disjoint,
+        D3D11_ASYNC_GETDATA_DONOTFLUSH);
+    if (hr == S_FALSE)
+        return false;
+    if (FAILED(hr) || disjoint.Disjoint || !disjoint.Frequency)
+        return true;
+
+    UINT64 first = 0;
+    for (unsigned i = 0; i < frame.numTimestamps_; ++i)
+    {
+        UINT64 timestamp = 0;
+        hr = deviceContext->GetData((ID3D11Query*)frame.timestampQueries_[i].ptr_, &timestamp, sizeof timestamp,
+            D3D11_ASYNC_GETDATA_DONOTFLUSH);
+        if (hr != S_OK)
+        {
+            times.clear();
+            return hr == S_FALSE ? false : true;
+        }
+
+        if (i == 0)
+            first = timestamp;
+        times.push_back(static_cast<double>(timestamp - first) * 1000.0 / static_cast<double>(disjoint.Frequency));
+    }
+
+    return true;
+}
+
+void GPUProfiler::ReleaseFrameQueries(FrameQueries& frame)
+{
+    for (GPUObjectHandle& query : frame.timestampQueries_)
+        URHO3D_SAFE_RELEASE(query.ptr_);
+    URHO3D_SAFE_RELEASE(frame.disjointQuery_.ptr_);
+
+    frame.timestampQueries_.clear();
+    frame.numTimestamps_ = 0;
+    frame.blocks_.clear();
+    frame.pending_ = false;
+}
+
+}
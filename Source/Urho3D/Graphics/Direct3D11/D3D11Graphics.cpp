@@ -23,6 +23,7 @@
 #include "../../Precompiled.h"
 
 #include "../../Core/Context.h"
+#include "../../Core/FrameStatistics.h"
 #include "../../Core/ProcessUtils.h"
 #include "../../Core/Profiler.h"
 #include "../../Graphics/ConstantBuffer.h"
@@ -470,6 +471,10 @@ bool Graphics::BeginFrame()
 
     numPrimitives_ = 0;
     numBatches_ = 0;
+    numStateChanges_ = 0;
+    numShaderChanges_ = 0;
+    numTextureChanges_ = 0;
+    textureUploadBytes_ = 0;
 
     SendEvent(E_BEGINRENDERING);
     return true;
@@ -794,6 +799,40 @@ void Graphics::DrawInstanced(PrimitiveType type, unsigned indexStart, unsigned i
     ++numBatches_;
 }
 
+void Graphics::MultiDrawInstanced(PrimitiveType type, const IndexedDrawCommand* commands, unsigned numCommands)
+{
+    if (!numCommands || !impl_->shaderProgram_)
+        return;
+
+    PrepareDraw();
+
+    if (fillMode_ == FILL_POINT)
+        type = POINT_LIST;
+
+    // The states are already set, so only the draw calls themselves remain per command
+    for (unsigned i = 0; i < numCommands; ++i)
+    {
+        const IndexedDrawCommand& command = commands[i];
+        if (!command.indexCount_ || !command.instanceCount_)
+            continue;
+
+        unsigned primitiveCount;
+        D3D_PRIMITIVE_TOPOLOGY d3dPrimitiveType;
+        GetD3DPrimitiveType(command.indexCount_, type, primitiveCount, d3dPrimitiveType);
+        if (d3dPrimitiveType != primitiveType_)
+        {
+            impl_->deviceContext_->IASetPrimitiveTopology(d3dPrimitiveType);
+            primitiveType_ = d3dPrimitiveType;
+        }
+        impl_->deviceContext_->DrawIndexedInstanced(command.indexCount_, command.instanceCount_, command.indexStart_,
+            command.baseVertexIndex_, command.baseInstance_);
+
+        numPrimitives_ += command.instanceCount_ * primitiveCount;
+    }
+
+    ++numBatches_;
+}
+
 void Graphics::SetVertexBuffer(VertexBuffer* buffer)
 {
     // Note: this is not multi-instance safe
@@ -897,6 +936,8 @@ void Graphics::SetShaders(ShaderVariation* vs, ShaderVariation* ps)
     if (vs == vertexShader_ && ps == pixelShader_)
         return;
 
+    ++numShaderChanges_;
+
     if (vs != vertexShader_)
     {
         // Create the shader now if not yet created. If already attempted, do not retry
@@ -907,6 +948,11 @@ void Graphics::SetShaders(ShaderVariation* vs, ShaderVariation* ps)
                 URHO3D_PROFILE("CompileVertexShader");
 
                 bool success = vs->Create();
+                if (auto* statistics = GetSubsystem<FrameStatistics>())
+                {
+                    statistics->IncrementCounter(FC_SHADER_COMPILES);
+                    statistics->AddMarker(FM_SHADER_COMPILE, vs->GetFullName());
+                }
                 if (!success)
                 {
                     URHO3D_LOGERROR("Failed to compile vertex shader " + vs->GetFullName() + ":\n" + vs->GetCompilerOutput());
@@ -931,6 +977,11 @@ void Graphics::SetShaders(ShaderVariation* vs, ShaderVariation* ps)
                 URHO3D_PROFILE("CompilePixelShader");
 
                 bool success = ps->Create();
+                if (auto* statistics = GetSubsystem<FrameStatistics>())
+                {
+                    statistics->IncrementCounter(FC_SHADER_COMPILES);
+                    statistics->AddMarker(FM_SHADER_COMPILE, ps->GetFullName());
+                }
                 if (!success)
                 {
                     URHO3D_LOGERROR("Failed to compile pixel shader " + ps->GetFullName() + ":\n" + ps->GetCompilerOutput());
@@ -1174,10 +1225,10 @@ void Graphics::SetTexture(unsigned index, Texture* texture)
     if (index >= MAX_TEXTURE_UNITS)
         return;
 
-    // Check if texture is currently bound as a rendertarget. In that case, use its backup texture, or blank if not defined
+    // Check if texture is currently bound as a rendertarget or still uploading. In that case, use its backup texture, or blank if not defined
     if (texture)
     {
-        if (renderTargets_[0] && renderTargets_[0]->GetParentTexture() == texture)
+        if ((renderTargets_[0] && renderTargets_[0]->GetParentTexture() == texture) || texture->IsUploadPending())
             texture = texture->GetBackupTexture();
         else
         {
@@ -1203,6 +1254,8 @@ void Graphics::SetTexture(unsigned index, Texture* texture)
 
     if (texture != textures_[index])
     {
+        ++numTextureChanges_;
+
         if (impl_->firstDirtyTexture_ == M_MAX_UNSIGNED)
             impl_->firstDirtyTexture_ = impl_->lastDirtyTexture_ = index;
         else
@@ -2268,6 +2321,7 @@ void Graphics::CheckFeatureSupport()
     deferredSupport_ = true;
     hardwareShadowSupport_ = true;
     instancingSupport_ = true;
+    multiDrawSupport_ = true;
     shadowMapFormat_ = DXGI_FORMAT_R16_TYPELESS;
     hiresShadowMapFormat_ = DXGI_FORMAT_R32_TYPELESS;
     dummyColorFormat_ = DXGI_FORMAT_UNKNOWN;
@@ -2467,6 +2521,7 @@ void Graphics::PrepareDraw()
 
             impl_->deviceContext_->OMSetBlendState(i->second, nullptr, M_MAX_UNSIGNED);
             impl_->blendStateHash_ = newBlendStateHash;
+            ++numStateChanges_;
         }
 
         impl_->blendStateDirty_ = false;
@@ -2515,6 +2570,7 @@ void Graphics::PrepareDraw()
 
             impl_->deviceContext_->OMSetDepthStencilState(i->second, stencilRef_);
             impl_->depthStateHash_ = newDepthStateHash;
+            ++numStateChanges_;
         }
 
         impl_->depthStateDirty_ = false;
@@ -2564,6 +2620,7 @@ void Graphics::PrepareDraw()
 
             impl_->deviceContext_->RSSetState(i->second);
             impl_->rasterizerStateHash_ = newRasterizerStateHash;
+            ++numStateChanges_;
         }
 
         impl_->rasterizerStateDirty_ = false;
@@ -274,12 +274,13 @@ void* IndexBuffer::MapBuffer(unsigned start, unsigned count, bool discard)
         mappedData.pData = nullptr;
 
         HRESULT hr = graphics_->GetImpl()->GetDeviceContext()->Map((ID3D11Buffer*)object_.ptr_, 0, discard ? D3D11_MAP_WRITE_DISCARD :
-            D3D11_MAP_WRITE, 0, &mappedData);
+            D3D11_MAP_WRITE_NO_OVERWRITE, 0, &mappedData);
         if (FAILED(hr) || !mappedData.pData)
             URHO3D_LOGD3DERROR("Failed to map index buffer", hr);
         else
         {
-            hwData = mappedData.pData;
+            // The whole buffer is always mapped, so offset to the requested range
+            hwData = static_cast<unsigned char*>(mappedData.pData) + start * indexSize_;
             lockState_ = LOCK_HARDWARE;
         }
     }
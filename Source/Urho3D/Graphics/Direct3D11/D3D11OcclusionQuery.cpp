@@ -0,0 +1,99 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../../Precompiled.h"
+
+#include "../../Graphics/Graphics.h"
+#include "../../Graphics/GraphicsImpl.h"
+#include "../../Graphics/OcclusionQuery.h"
+#include "../../IO/Log.h"
+
+#include "../../DebugNew.h"
+
+namespace Urho3D
+{
+
+void OcclusionQuery::OnDeviceLost()
+{
+    // No-op on Direct3D11
+}
+
+void OcclusionQuery::Release()
+{
+    URHO3D_SAFE_RELEASE(object_.ptr_);
+    pending_ = false;
+}
+
+bool OcclusionQuery::Create()
+{
+    if (!object_.ptr_ && graphics_)
+    {
+        D3D11_QUERY_DESC queryDesc;
+        queryDesc.Query = D3D11_QUERY_OCCLUSION_PREDICATE;
+        queryDesc.MiscFlags = 0;
+
+        HRESULT hr = graphics_->GetImpl()->GetDevice()->CreateQuery(&queryDesc, (ID3D11Query**)&object_.ptr_);
+        if (FAILED(hr))
+        {
+            URHO3D_SAFE_RELEASE(object_.ptr_);
+            URHO3D_LOGD3DERROR("Failed to create occlusion query", hr);
+        }
+    }
+
+    return object_.ptr_ != nullptr;
+}
+
+void OcclusionQuery::Begin()
+{
+    if (pending_ || !Create())
+        return;
+
+    graphics_->GetImpl()->GetDeviceContext()->Begin((ID3D11Query*)object_.ptr_);
+}
+
+void OcclusionQuery::End()
+{
+    if (pending_ || !object_.ptr_)
+        return;
+
+    graphics_->GetImpl()->GetDeviceContext()->End((ID3D11Query*)object_.ptr_);
+    pending_ = true;
+}
+
+bool OcclusionQuery::CheckResult()
+{
+    if (!pending_)
+        return true;
+
+    BOOL anySamplesPassed = TRUE;
+    HRESULT hr = graphics_->GetImpl()->GetDeviceContext()->GetData((ID3D11Query*)object_.ptr_, &anySamplesPassed,
+        sizeof anySamplesPassed, D3D11_ASYNC_GETDATA_DONOTFLUSH);
+    if (hr == S_FALSE)
+        return false;
+
+    visible_ = FAILED(hr) || anySamplesPassed;
+    pending_ = false;
+    return true;
+}
+
+}
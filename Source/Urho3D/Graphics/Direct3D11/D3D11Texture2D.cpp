@@ -24,6 +24,7 @@
 
 #include "../../Core/Context.h"
 #include "../../Core/Profiler.h"
+#include "../../Core/WorkQueue.h"
 #include "../../Graphics/Graphics.h"
 #include "../../Graphics/GraphicsEvents.h"
 #include "../../Graphics/GraphicsImpl.h"
@@ -51,6 +52,8 @@ void Texture2D::OnDeviceReset()
 
 void Texture2D::Release()
 {
+    CancelPendingUpload();
+
     if (graphics_ && object_.ptr_)
     {
         for (unsigned i = 0; i < MAX_TEXTURE_UNITS; ++i)
@@ -157,6 +160,63 @@ bool Texture2D::SetData(unsigned level, int x, int y, int width, int height, con
     return true;
 }
 
+bool Texture2D::UploadPendingLevel(const PendingLevel& level)
+{
+    const unsigned char* data = level.GetData();
+
+    // Compressed levels smaller than a block can not be created as a staging texture of their own
+    if (!object_.ptr_ || usage_ == TEXTURE_DYNAMIC || (IsCompressed() && (level.width_ < 4 || level.height_ < 4)))
+        return SetData(level.level_, 0, 0, level.width_, level.height_, data);
+
+    URHO3D_PROFILE("UploadTextureLevel");
+
+    D3D11_TEXTURE2D_DESC textureDesc;
+    memset(&textureDesc, 0, sizeof textureDesc);
+    textureDesc.Width = (UINT)level.width_;
+    textureDesc.Height = (UINT)level.height_;
+    textureDesc.MipLevels = 1;
+    textureDesc.ArraySize = 1;
+    textureDesc.Format = (DXGI_FORMAT)(sRGB_ ? GetSRGBFormat(format_) : format_);
+    textureDesc.SampleDesc.Count = 1;
+    textureDesc.SampleDesc.Quality = 0;
+    textureDesc.Usage = D3D11_USAGE_STAGING;
+    textureDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+    ID3D11Texture2D* stagingTexture = nullptr;
+    HRESULT hr = graphics_->GetImpl()->GetDevice()->CreateTexture2D(&textureDesc, nullptr, &stagingTexture);
+    if (FAILED(hr))
+    {
+        URHO3D_LOGD3DERROR("Failed to create staging texture for upload", hr);
+        URHO3D_SAFE_RELEASE(stagingTexture);
+        return SetData(level.level_, 0, 0, level.width_, level.height_, data);
+    }
+
+    D3D11_MAPPED_SUBRESOURCE mappedData;
+    mappedData.pData = nullptr;
+
+    hr = graphics_->GetImpl()->GetDeviceContext()->Map(stagingTexture, 0, D3D11_MAP_WRITE, 0, &mappedData);
+    if (FAILED(hr) || !mappedData.pData)
+    {
+        URHO3D_LOGD3DERROR("Failed to map staging texture for upload", hr);
+        URHO3D_SAFE_RELEASE(stagingTexture);
+        return SetData(level.level_, 0, 0, level.width_, level.height_, data);
+    }
+
+    unsigned rowSize = GetRowDataSize(level.width_);
+    int numRows = IsCompressed() ? (level.height_ + 3) >> 2 : level.height_;
+    for (int row = 0; row < numRows; ++row)
+        memcpy((unsigned char*)mappedData.pData + row * mappedData.RowPitch, data + row * rowSize, rowSize);
+    graphics_->GetImpl()->GetDeviceContext()->Unmap(stagingTexture, 0);
+
+    // The copy is queued on the GPU instead of being performed by the driver on this thread
+    unsigned destSubResource = D3D11CalcSubresource(level.level_, 0, levels_);
+    graphics_->GetImpl()->GetDeviceContext()->CopySubresourceRegion((ID3D11Resource*)object_.ptr_, destSubResource, 0, 0, 0,
+        stagingTexture, 0, nullptr);
+
+    URHO3D_SAFE_RELEASE(stagingTexture);
+    return true;
+}
+
 bool Texture2D::SetData(Image* image, bool useAlpha)
 {
     if (!image)
@@ -165,6 +225,9 @@ bool Texture2D::SetData(Image* image, bool useAlpha)
         return false;
     }
 
+    // New data supersedes any upload still in progress
+    CancelPendingUpload();
+
     // Use a shared ptr for managing the temporary mip images created during this function
     SharedPtr<Image> mipImage;
     unsigned memoryUse = sizeof(Texture2D);
@@ -191,9 +254,10 @@ bool Texture2D::SetData(Image* image, bool useAlpha)
         unsigned format = 0;
 
         // Discard unnecessary mip levels
-        for (unsigned i = 0; i < mipsToSkip_[quality]; ++i)
+        const unsigned mipsToSkip = mipsToSkip_[quality] + streamedMipsToSkip_;
+        for (unsigned i = 0; i < mipsToSkip && (levelWidth > 1 || levelHeight > 1); ++i)
         {
-            mipImage = image->GetNextLevel(); image = mipImage;
+            mipImage = image->GetNextLevel(sRGB_); image = mipImage;
             levelData = image->GetData();
             levelWidth = image->GetWidth();
             levelHeight = image->GetHeight();
@@ -220,12 +284,12 @@ bool Texture2D::SetData(Image* image, bool useAlpha)
 
         for (unsigned i = 0; i < levels_; ++i)
         {
-            SetData(i, 0, 0, levelWidth, levelHeight, levelData);
+            UploadLevel(i, levelWidth, levelHeight, levelData, image);
             memoryUse += levelWidth * levelHeight * components;
 
             if (i < levels_ - 1)
             {
-                mipImage = image->GetNextLevel(); image = mipImage;
+                mipImage = image->GetNextLevel(sRGB_); image = mipImage;
                 levelData = image->GetData();
                 levelWidth = image->GetWidth();
                 levelHeight = image->GetHeight();
@@ -246,7 +310,7 @@ bool Texture2D::SetData(Image* image, bool useAlpha)
             needDecompress = true;
         }
 
-        unsigned mipsToSkip = mipsToSkip_[quality];
+        unsigned mipsToSkip = mipsToSkip_[quality] + streamedMipsToSkip_;
         if (mipsToSkip >= levels)
             mipsToSkip = levels - 1;
         while (mipsToSkip && (width / (1 << mipsToSkip) < 4 || height / (1 << mipsToSkip) < 4))
@@ -263,14 +327,14 @@ bool Texture2D::SetData(Image* image, bool useAlpha)
             CompressedLevel level = image->GetCompressedLevel(i + mipsToSkip);
             if (!needDecompress)
             {
-                SetData(i, 0, 0, level.width_, level.height_, level.data_);
+                UploadLevel(i, level.width_, level.height_, level.data_, image);
                 memoryUse += level.rows_ * level.rowSize_;
             }
             else
             {
                 unsigned char* rgbaData = new unsigned char[level.width_ * level.height_ * 4];
-                level.Decompress(rgbaData);
-                SetData(i, 0, 0, level.width_, level.height_, rgbaData);
+                level.Decompress(rgbaData, GetSubsystem<WorkQueue>());
+                UploadLevel(i, level.width_, level.height_, rgbaData, nullptr);
                 memoryUse += level.width_ * level.height_ * 4;
                 delete[] rgbaData;
             }
@@ -0,0 +1,153 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../../Precompiled.h"
+
+#include "../../Graphics/Graphics.h"
+#include "../../Graphics/GraphicsImpl.h"
+#include "../../Graphics/GPUProfiler.h"
+#include "../../IO/Log.h"
+
+#include "../../DebugNew.h"
+
+namespace Urho3D
+{
+
+/// Create a Direct3D9 query. Return true on success.
+static bool CreateQuery(Graphics* graphics, D3DQUERYTYPE type, GPUObjectHandle& query)
+{
+    if (query.ptr_)
+        return true;
+
+    HRESULT hr = graphics->GetImpl()->GetDevice()->CreateQuery(type, (IDirect3DQuery9**)&query.ptr_);
+    if (FAILED(hr))
+    {
+        URHO3D_SAFE_RELEASE(query.ptr_);
+        URHO3D_LOGD3DERROR("Failed to create timestamp query", hr);
+        return false;
+    }
+    return true;
+}
+
+void GPUProfiler::OnDeviceLost()
+{
+    // Queries are in the default pool and need to be released on device loss
+    Release();
+}
+
+void GPUProfiler::Release()
+{
+    for (FrameQueries& frame : frames_)
+        ReleaseFrameQueries(frame);
+
+    inFrame_ = false;
+}
+
+bool GPUProfiler::IsSupported() const
+{
+    return graphics_ && graphics_->GetImpl()->GetDevice() &&
+        SUCCEEDED(graphics_->GetImpl()->GetDevice()->CreateQuery(D3DQUERYTYPE_TIMESTAMPDISJOINT, nullptr));
+}
+
+bool GPUProfiler::BeginFrameQueries(FrameQueries& frame)
+{
+    if (graphics_->IsDeviceLost() || !CreateQuery(graphics_, D3DQUERYTYPE_TIMESTAMPDISJOINT, frame.disjointQuery_) ||
+        !CreateQuery(graphics_, D3DQUERYTYPE_TIMESTAMPFREQ, frame.frequencyQuery_))
+        return false;
+
+    ((IDirect3DQuery9*)frame.disjointQuery_.ptr_)->Issue(D3DISSUE_BEGIN);
+    return IssueTimestamp(frame);
+}
+
+void GPUProfiler::EndFrameQueries(FrameQueries& frame)
+{
+    IssueTimestamp(frame);
+    ((IDirect3DQuery9*)frame.frequencyQuery_.ptr_)->Issue(D3DISSUE_END);
+    ((IDirect3DQuery9*)frame.disjointQuery_.ptr_)->Issue(D3DISSUE_END);
+}
+
+bool GPUProfiler::IssueTimestamp(FrameQueries& frame)
+{
+    if (frame.numTimestamps_ == frame.timestampQueries_.size())
+    {
+        GPUObjectHandle query{};
+        if (!CreateQuery(graphics_, D3DQUERYTYPE_TIMESTAMP, query))
+            return false;
+        frame.timestampQueries_.push_back(query);
+    }
+
+    ((IDirect3DQuery9*)frame.timestampQueries_[frame.numTimestamps_++].ptr_)->Issue(D3DISSUE_END);
+    return true;
+}
+
+bool GPUProfiler::ReadTimestamps(FrameQueries& frame, ea::vector<double>& times)
+{
+    times.clear();
+
+    BOOL disjoint = TRUE;
+    HRESULT hr = ((IDirect3DQuery9*)frame.disjointQuery_.ptr_)->GetData(&disjoint, sizeof disjoint, 0);
+    if (hr == S_FALSE)
+        return false;
+    if (FAILED(hr) || disjoint)
+        return true;
+
+    UINT64 frequency = 0;
+    hr = ((IDirect3DQuery9*)frame.frequencyQuery_.ptr_)->GetData(&frequency, sizeof frequency, 0);
+    if (hr == S_FALSE)
+        return false;
+    if (FAILED(hr) || !frequency)
+        return true;
+
+    UINT64 first = 0;
+    for (unsigned i = 0; i < frame.numTimestamps_; ++i)
+    {
+        UINT64 timestamp = 0;
+        hr = ((IDirect3DQuery9*)frame.timestampQueries_[i].ptr_)->GetData(&timestamp, sizeof timestamp, 0);
+        if (hr != S_OK)
+        {
+            times.clear();
+            return hr == S_FALSE ? false : true;
+        }
+
+        if (i == 0)
+            first = timestamp;
+        times.push_back(static_cast<double>(timestamp - first) * 1000.0 / static_cast<double>(frequency));
+    }
+
+    return true;
+}
+
+void GPUProfiler::ReleaseFrameQueries(FrameQueries& frame)
+{
+    for (GPUObjectHandle& query : frame.timestampQueries_)
+        URHO3D_SAFE_RELEASE(query.ptr_);
+    URHO3D_SAFE_RELEASE(frame.disjointQuery_.ptr_);
+    URHO3D_SAFE_RELEASE(frame.frequencyQuery_.ptr_);
+
+    frame.timestampQueries_.clear();
+    frame.numTimestamps_ = 0;
+    frame.blocks_.clear();
+    frame.pending_ = false;
+}
+
+}
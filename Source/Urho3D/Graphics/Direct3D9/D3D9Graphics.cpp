@@ -23,6 +23,7 @@
 #include "../../Precompiled.h"
 
 #include "../../Core/Context.h"
+#include "../../Core/FrameStatistics.h"
 #include "../../Core/ProcessUtils.h"
 #include "../../Core/Profiler.h"
 #include "../../Graphics/Graphics.h"
@@ -655,6 +656,10 @@ bool Graphics::BeginFrame()
 
     numPrimitives_ = 0;
     numBatches_ = 0;
+    numStateChanges_ = 0;
+    numShaderChanges_ = 0;
+    numTextureChanges_ = 0;
+    textureUploadBytes_ = 0;
 
     SendEvent(E_BEGINRENDERING);
 
@@ -957,6 +962,11 @@ void Graphics::DrawInstanced(PrimitiveType type, unsigned indexStart, unsigned i
     ++numBatches_;
 }
 
+void Graphics::MultiDrawInstanced(PrimitiveType type, const IndexedDrawCommand* commands, unsigned numCommands)
+{
+    // Direct3D9 can not offset the instance data per draw call, so multi-draw is not supported
+}
+
 void Graphics::SetVertexBuffer(VertexBuffer* buffer)
 {
     // Note: this is not multi-instance safe
@@ -1061,6 +1071,8 @@ void Graphics::SetShaders(ShaderVariation* vs, ShaderVariation* ps)
     if (vs == vertexShader_ && ps == pixelShader_)
         return;
 
+    ++numShaderChanges_;
+
     ClearParameterSources();
 
     if (vs != vertexShader_)
@@ -1073,6 +1085,11 @@ void Graphics::SetShaders(ShaderVariation* vs, ShaderVariation* ps)
                 URHO3D_PROFILE("CompileVertexShader");
 
                 bool success = vs->Create();
+                if (auto* statistics = GetSubsystem<FrameStatistics>())
+                {
+                    statistics->IncrementCounter(FC_SHADER_COMPILES);
+                    statistics->AddMarker(FM_SHADER_COMPILE, vs->GetFullName());
+                }
                 if (!success)
                 {
                     URHO3D_LOGERROR("Failed to compile vertex shader " + vs->GetFullName() + ":\n" + vs->GetCompilerOutput());
@@ -1103,6 +1120,11 @@ void Graphics::SetShaders(ShaderVariation* vs, ShaderVariation* ps)
                 URHO3D_PROFILE("CompilePixelShader");
 
                 bool success = ps->Create();
+                if (auto* statistics = GetSubsystem<FrameStatistics>())
+                {
+                    statistics->IncrementCounter(FC_SHADER_COMPILES);
+                    statistics->AddMarker(FM_SHADER_COMPILE, ps->GetFullName());
+                }
                 if (!success)
                 {
                     URHO3D_LOGERROR("Failed to compile pixel shader " + ps->GetFullName() + ":\n" + ps->GetCompilerOutput());
@@ -1349,8 +1371,8 @@ void Graphics::SetTexture(unsigned index, Texture* texture)
 
     if (texture)
     {
-        // Check if texture is currently bound as a rendertarget. In that case, use its backup texture, or blank if not defined
-        if (renderTargets_[0] && renderTargets_[0]->GetParentTexture() == texture)
+        // Check if texture is currently bound as a rendertarget or still uploading. In that case, use its backup texture, or blank if not defined
+        if ((renderTargets_[0] && renderTargets_[0]->GetParentTexture() == texture) || texture->IsUploadPending())
             texture = texture->GetBackupTexture();
         else
         {
@@ -1367,6 +1389,8 @@ void Graphics::SetTexture(unsigned index, Texture* texture)
 
     if (texture != textures_[index])
     {
+        ++numTextureChanges_;
+
         if (texture)
             impl_->device_->SetTexture(index, (IDirect3DBaseTexture9*)texture->GetGPUObject());
         else
@@ -1641,6 +1665,7 @@ void Graphics::SetBlendMode(BlendMode mode, bool /* alphaToCoverage */)
         }
 
         blendMode_ = mode;
+        ++numStateChanges_;
     }
 }
 
@@ -1652,6 +1677,7 @@ void Graphics::SetColorWrite(bool enable)
             enable ? D3DCOLORWRITEENABLE_RED | D3DCOLORWRITEENABLE_GREEN | D3DCOLORWRITEENABLE_BLUE | D3DCOLORWRITEENABLE_ALPHA :
                 0);
         colorWrite_ = enable;
+        ++numStateChanges_;
     }
 }
 
@@ -1661,6 +1687,7 @@ void Graphics::SetCullMode(CullMode mode)
     {
         impl_->device_->SetRenderState(D3DRS_CULLMODE, d3dCullMode[mode]);
         cullMode_ = mode;
+        ++numStateChanges_;
     }
 }
 
@@ -1670,11 +1697,13 @@ void Graphics::SetDepthBias(float constantBias, float slopeScaledBias)
     {
         impl_->device_->SetRenderState(D3DRS_DEPTHBIAS, *((DWORD*)&constantBias));
         constantDepthBias_ = constantBias;
+        ++numStateChanges_;
     }
     if (slopeScaledBias != slopeScaledDepthBias_)
     {
         impl_->device_->SetRenderState(D3DRS_SLOPESCALEDEPTHBIAS, *((DWORD*)&slopeScaledBias));
         slopeScaledDepthBias_ = slopeScaledBias;
+        ++numStateChanges_;
     }
 }
 
@@ -1684,6 +1713,7 @@ void Graphics::SetDepthTest(CompareMode mode)
     {
         impl_->device_->SetRenderState(D3DRS_ZFUNC, d3dCmpFunc[mode]);
         depthTestMode_ = mode;
+        ++numStateChanges_;
     }
 }
 
@@ -1693,6 +1723,7 @@ void Graphics::SetDepthWrite(bool enable)
     {
         impl_->device_->SetRenderState(D3DRS_ZWRITEENABLE, enable ? TRUE : FALSE);
         depthWrite_ = enable;
+        ++numStateChanges_;
     }
 }
 
@@ -1702,6 +1733,7 @@ void Graphics::SetFillMode(FillMode mode)
     {
         impl_->device_->SetRenderState(D3DRS_FILLMODE, d3dFillMode[mode]);
         fillMode_ = mode;
+        ++numStateChanges_;
     }
 }
 
@@ -1815,6 +1847,7 @@ void Graphics::SetStencilTest(bool enable, CompareMode mode, StencilOp pass, Ste
     {
         impl_->device_->SetRenderState(D3DRS_STENCILENABLE, enable ? TRUE : FALSE);
         stencilTest_ = enable;
+        ++numStateChanges_;
     }
 
     if (enable)
@@ -1823,36 +1856,43 @@ void Graphics::SetStencilTest(bool enable, CompareMode mode, StencilOp pass, Ste
         {
             impl_->device_->SetRenderState(D3DRS_STENCILFUNC, d3dCmpFunc[mode]);
             stencilTestMode_ = mode;
+            ++numStateChanges_;
         }
         if (pass != stencilPass_)
         {
             impl_->device_->SetRenderState(D3DRS_STENCILPASS, d3dStencilOp[pass]);
             stencilPass_ = pass;
+            ++numStateChanges_;
         }
         if (fail != stencilFail_)
         {
             impl_->device_->SetRenderState(D3DRS_STENCILFAIL, d3dStencilOp[fail]);
             stencilFail_ = fail;
+            ++numStateChanges_;
         }
         if (zFail != stencilZFail_)
         {
             impl_->device_->SetRenderState(D3DRS_STENCILZFAIL, d3dStencilOp[zFail]);
             stencilZFail_ = zFail;
+            ++numStateChanges_;
         }
         if (stencilRef != stencilRef_)
         {
             impl_->device_->SetRenderState(D3DRS_STENCILREF, stencilRef);
             stencilRef_ = stencilRef;
+            ++numStateChanges_;
         }
         if (compareMask != stencilCompareMask_)
         {
             impl_->device_->SetRenderState(D3DRS_STENCILMASK, compareMask);
             stencilCompareMask_ = compareMask;
+            ++numStateChanges_;
         }
         if (writeMask != stencilWriteMask_)
         {
             impl_->device_->SetRenderState(D3DRS_STENCILWRITEMASK, writeMask);
             stencilWriteMask_ = writeMask;
+            ++numStateChanges_;
         }
     }
 }
@@ -0,0 +1,95 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../../Precompiled.h"
+
+#include "../../Graphics/Graphics.h"
+#include "../../Graphics/GraphicsImpl.h"
+#include "../../Graphics/OcclusionQuery.h"
+#include "../../IO/Log.h"
+
+#include "../../DebugNew.h"
+
+namespace Urho3D
+{
+
+void OcclusionQuery::OnDeviceLost()
+{
+    // Queries are in the default pool and need to be released on device loss
+    Release();
+}
+
+void OcclusionQuery::Release()
+{
+    URHO3D_SAFE_RELEASE(object_.ptr_);
+    pending_ = false;
+}
+
+bool OcclusionQuery::Create()
+{
+    if (!object_.ptr_ && graphics_ && !graphics_->IsDeviceLost())
+    {
+        HRESULT hr = graphics_->GetImpl()->GetDevice()->CreateQuery(D3DQUERYTYPE_OCCLUSION, (IDirect3DQuery9**)&object_.ptr_);
+        if (FAILED(hr))
+        {
+            URHO3D_SAFE_RELEASE(object_.ptr_);
+            URHO3D_LOGD3DERROR("Failed to create occlusion query", hr);
+        }
+    }
+
+    return object_.ptr_ != nullptr;
+}
+
+void OcclusionQuery::Begin()
+{
+    if (pending_ || !Create())
+        return;
+
+    ((IDirect3DQuery9*)object_.ptr_)->Issue(D3DISSUE_BEGIN);
+}
+
+void OcclusionQuery::End()
+{
+    if (pending_ || !object_.ptr_)
+        return;
+
+    ((IDirect3DQuery9*)object_.ptr_)->Issue(D3DISSUE_END);
+    pending_ = true;
+}
+
+bool OcclusionQuery::CheckResult()
+{
+    if (!pending_)
+        return true;
+
+    DWORD samples = 1;
+    HRESULT hr = ((IDirect3DQuery9*)object_.ptr_)->GetData(&samples, sizeof samples, 0);
+    if (hr == S_FALSE)
+        return false;
+
+    visible_ = FAILED(hr) || samples > 0;
+    pending_ = false;
+    return true;
+}
+
+}
@@ -136,6 +136,18 @@ bool ShaderVariation::Create()
     return object_.ptr_ != nullptr;
 }
 
+bool ShaderVariation::IsCompilePending()
+{
+    // Shaders are always compiled synchronously on Direct3D
+    return false;
+}
+
+unsigned ShaderVariation::GetSourceHash() const
+{
+    // Direct3D caches the bytecode of individual shaders instead
+    return 0;
+}
+
 void ShaderVariation::Release()
 {
     if (object_.ptr_ && graphics_)
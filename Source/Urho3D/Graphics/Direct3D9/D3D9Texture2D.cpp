@@ -24,6 +24,7 @@
 
 #include "../../Core/Context.h"
 #include "../../Core/Profiler.h"
+#include "../../Core/WorkQueue.h"
 #include "../../Graphics/Graphics.h"
 #include "../../Graphics/GraphicsEvents.h"
 #include "../../Graphics/GraphicsImpl.h"
@@ -66,6 +67,8 @@ void Texture2D::OnDeviceReset()
 
 void Texture2D::Release()
 {
+    CancelPendingUpload();
+
     if (graphics_)
     {
         for (unsigned i = 0; i < MAX_TEXTURE_UNITS; ++i)
@@ -205,6 +208,12 @@ bool Texture2D::SetData(unsigned level, int x, int y, int width, int height, con
     return true;
 }
 
+bool Texture2D::UploadPendingLevel(const PendingLevel& level)
+{
+    // Direct3D9 has no staging path, upload the level directly
+    return SetData(level.level_, 0, 0, level.width_, level.height_, level.GetData());
+}
+
 bool Texture2D::SetData(Image* image, bool useAlpha)
 {
     if (!image)
@@ -213,6 +222,9 @@ bool Texture2D::SetData(Image* image, bool useAlpha)
         return false;
     }
 
+    // New data supersedes any upload still in progress
+    CancelPendingUpload();
+
     // Use a shared ptr for managing the temporary mip images created during this function
     SharedPtr<Image> mipImage;
     unsigned memoryUse = sizeof(Texture2D);
@@ -230,9 +242,10 @@ bool Texture2D::SetData(Image* image, bool useAlpha)
         unsigned format = 0;
 
         // Discard unnecessary mip levels
-        for (unsigned i = 0; i < mipsToSkip_[quality]; ++i)
+        const unsigned mipsToSkip = mipsToSkip_[quality] + streamedMipsToSkip_;
+        for (unsigned i = 0; i < mipsToSkip && (levelWidth > 1 || levelHeight > 1); ++i)
         {
-            mipImage = image->GetNextLevel(); image = mipImage;
+            mipImage = image->GetNextLevel(sRGB_); image = mipImage;
             levelData = image->GetData();
             levelWidth = image->GetWidth();
             levelHeight = image->GetHeight();
@@ -269,12 +282,12 @@ bool Texture2D::SetData(Image* image, bool useAlpha)
 
         for (unsigned i = 0; i < levels_; ++i)
         {
-            SetData(i, 0, 0, levelWidth, levelHeight, levelData);
+            UploadLevel(i, levelWidth, levelHeight, levelData, image);
             memoryUse += levelWidth * levelHeight * components;
 
             if (i < levels_ - 1)
             {
-                mipImage = image->GetNextLevel(); image = mipImage;
+                mipImage = image->GetNextLevel(sRGB_); image = mipImage;
                 levelData = image->GetData();
                 levelWidth = image->GetWidth();
                 levelHeight = image->GetHeight();
@@ -295,7 +308,7 @@ bool Texture2D::SetData(Image* image, bool useAlpha)
             needDecompress = true;
         }
 
-        unsigned mipsToSkip = mipsToSkip_[quality];
+        unsigned mipsToSkip = mipsToSkip_[quality] + streamedMipsToSkip_;
         if (mipsToSkip >= levels)
             mipsToSkip = levels - 1;
         while (mipsToSkip && (width / (1 << mipsToSkip) < 4 || height / (1 << mipsToSkip) < 4))
@@ -312,14 +325,14 @@ bool Texture2D::SetData(Image* image, bool useAlpha)
             CompressedLevel level = image->GetCompressedLevel(i + mipsToSkip);
             if (!needDecompress)
             {
-                SetData(i, 0, 0, level.width_, level.height_, level.data_);
+                UploadLevel(i, level.width_, level.height_, level.data_, image);
                 memoryUse += level.rows_ * level.rowSize_;
             }
             else
             {
                 unsigned char* rgbaData = new unsigned char[level.width_ * level.height_ * 4];
-                level.Decompress(rgbaData);
-                SetData(i, 0, 0, level.width_, level.height_, rgbaData);
+                level.Decompress(rgbaData, GetSubsystem<WorkQueue>());
+                UploadLevel(i, level.width_, level.height_, rgbaData, nullptr);
                 memoryUse += level.width_ * level.height_ * 4;
                 delete[] rgbaData;
             }
@@ -189,6 +189,7 @@ void Drawable::SetLodBias(float bias)
 void Drawable::SetViewMask(unsigned mask)
 {
     viewMask_ = mask;
+    MarkCullingDataDirty();
     MarkNetworkUpdate();
 }
 
@@ -221,12 +222,14 @@ void Drawable::SetMaxLights(unsigned num)
 void Drawable::SetCastShadows(bool enable)
 {
     castShadows_ = enable;
+    MarkCullingDataDirty();
     MarkNetworkUpdate();
 }
 
 void Drawable::SetOccluder(bool enable)
 {
     occluder_ = enable;
+    MarkCullingDataDirty();
     MarkNetworkUpdate();
 }
 
@@ -372,7 +375,7 @@ void Drawable::OnSceneSet(Scene* scene)
 
 void Drawable::OnMarkedDirty(Node* node)
 {
-    worldBoundingBoxDirty_ = true;
+    MarkWorldBoundingBoxDirty();
     if (!updateQueued_ && octant_)
         octant_->GetRoot()->QueueUpdate(this);
 
@@ -381,6 +384,31 @@ void Drawable::OnMarkedDirty(Node* node)
         zoneDirty_ = true;
 }
 
+void Drawable::OnSetAttribute(const AttributeInfo& attr, const Variant& src)
+{
+    Component::OnSetAttribute(attr, src);
+    // Attributes such as view mask and shadow casting are written directly to members
+    MarkCullingDataDirty();
+}
+
+void Drawable::OnDirectAttributeSet(const AttributeInfo& attr)
+{
+    Component::OnDirectAttributeSet(attr);
+    MarkCullingDataDirty();
+}
+
+void Drawable::MarkWorldBoundingBoxDirty()
+{
+    worldBoundingBoxDirty_ = true;
+    MarkCullingDataDirty();
+}
+
+void Drawable::MarkCullingDataDirty()
+{
+    if (octant_)
+        octant_->MarkCullingDataDirty();
+}
+
 void Drawable::AddToOctree()
 {
     // Do not add to octree when disabled
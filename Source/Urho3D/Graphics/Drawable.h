@@ -52,14 +52,16 @@ static const float ANIMATION_LOD_BASESCALE = 2500.0f;
 class Camera;
 class File;
 class Geometry;
+class HierarchicalLodGroup;
 class Light;
 class Material;
 class OcclusionBuffer;
 class Octant;
 class RayOctreeQuery;
+class Technique;
+class VertexBuffer;
 class Zone;
 struct RayQueryResult;
-struct WorkItem;
 
 /// Geometry update type.
 enum UpdateGeometryType
@@ -113,6 +115,19 @@ struct URHO3D_API SourceBatch
     Vector4* lightmapScaleOffset_{};
     /// Lightmap texture index.
     unsigned lightmapIndex_{};
+    /// Persistent instancing vertex buffer holding all world transforms, in the format of Renderer::GetInstancingBufferElements() with the extra elements of the renderer. When set, the instances are drawn from it without copying them each frame.
+    VertexBuffer* instanceBuffer_{};
+
+    /// Cached technique resolved by the view. Valid while the material's technique list version and quality match and the LOD distance stays within the cached range.
+    mutable Technique* cachedTechnique_{};
+    /// Material technique list version the cached technique was resolved for. Zero if not cached.
+    mutable unsigned cachedTechniquesVersion_{};
+    /// Material quality the cached technique was resolved for.
+    mutable int cachedMaterialQuality_{};
+    /// Inclusive lower bound of the LOD distance range the cached technique is valid for.
+    mutable float cachedLodDistanceMin_{};
+    /// Exclusive upper bound of the LOD distance range the cached technique is valid for.
+    mutable float cachedLodDistanceMax_{};
 
     /// Equality comparison operator.
     bool operator==(const SourceBatch& other) const
@@ -121,7 +136,8 @@ struct URHO3D_API SourceBatch
             return true;
         return distance_ == other.distance_ && geometry_ == other.geometry_ && material_ == other.material_ &&
             worldTransform_ == other.worldTransform_ && numWorldTransforms_ == other.numWorldTransforms_ &&
-            instancingData_ == other.instancingData_ && geometryType_ == other.geometryType_;
+            instancingData_ == other.instancingData_ && geometryType_ == other.geometryType_ &&
+            instanceBuffer_ == other.instanceBuffer_;
     }
 
     /// Inequality comparison operator.
@@ -138,7 +154,6 @@ class URHO3D_API Drawable : public Component
 
     friend class Octant;
     friend class Octree;
-    friend void UpdateDrawablesWork(const WorkItem* item, unsigned threadIndex);
 
 public:
     /// Construct.
@@ -240,6 +255,17 @@ public:
     /// Return occludee flag.
     bool IsOccludee() const { return occludee_; }
 
+    /// Set hierarchical LOD cluster. Called by HierarchicalLodGroup.
+    void SetHierarchicalLodGroup(HierarchicalLodGroup* group, bool isProxy)
+    {
+        hlodGroup_ = group;
+        hlodProxy_ = isProxy;
+    }
+    /// Return hierarchical LOD cluster.
+    HierarchicalLodGroup* GetHierarchicalLodGroup() const { return hlodGroup_; }
+    /// Return whether is the proxy of hierarchical LOD cluster.
+    bool IsHierarchicalLodProxy() const { return hlodProxy_; }
+
     /// Return whether is in view this frame from any viewport camera. Excludes shadow map cameras.
     bool IsInView() const;
     /// Return whether is in view of a specific camera this frame. Pass in a null camera to allow any camera, including shadow map cameras.
@@ -339,6 +365,14 @@ protected:
     void OnSceneSet(Scene* scene) override;
     /// Handle node transform being dirtied.
     void OnMarkedDirty(Node* node) override;
+    /// Handle attribute write access.
+    void OnSetAttribute(const AttributeInfo& attr, const Variant& src) override;
+    /// Handle attribute write through the typed accessor.
+    void OnDirectAttributeSet(const AttributeInfo& attr) override;
+    /// Mark world-space bounding box and octant culling data dirty.
+    void MarkWorldBoundingBoxDirty();
+    /// Mark octant culling data dirty after a change to culling-relevant state.
+    void MarkCullingDataDirty();
     /// Recalculate the world-space bounding box.
     virtual void OnWorldBoundingBoxUpdate() = 0;
 
@@ -417,6 +451,10 @@ protected:
     ea::vector<Light*> lights_;
     /// Per-vertex lights affecting this drawable.
     ea::vector<Light*> vertexLights_;
+    /// Hierarchical LOD cluster.
+    HierarchicalLodGroup* hlodGroup_{};
+    /// Hierarchical LOD proxy flag.
+    bool hlodProxy_{};
 };
 
 inline bool CompareDrawables(const Drawable* lhs, const Drawable* rhs)
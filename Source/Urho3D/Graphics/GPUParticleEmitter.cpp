@@ -0,0 +1,321 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Graphics/Geometry.h"
+#include "../Graphics/GPUParticleEmitter.h"
+#include "../Graphics/IndexBuffer.h"
+#include "../Graphics/Material.h"
+#include "../Graphics/ParticleEffect.h"
+#include "../Graphics/VertexBuffer.h"
+#include "../Resource/ResourceCache.h"
+#include "../Resource/ResourceEvents.h"
+#include "../Scene/Scene.h"
+#include "../Scene/SceneEvents.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+extern const char* GEOMETRY_CATEGORY;
+
+GPUParticleEmitter::GPUParticleEmitter(Context* context) :
+    Drawable(context, DRAWABLE_GEOMETRY),
+    geometry_(context->CreateObject<Geometry>()),
+    vertexBuffer_(context->CreateObject<VertexBuffer>()),
+    indexBuffer_(context->CreateObject<IndexBuffer>())
+{
+    geometry_->SetVertexBuffer(0, vertexBuffer_);
+    geometry_->SetIndexBuffer(indexBuffer_);
+
+    // Particles face the camera through the billboard rotation uniform, which is the camera rotation for a single transform
+    batches_.resize(1);
+    batches_[0].geometry_ = geometry_;
+    batches_[0].geometryType_ = GEOM_BILLBOARD;
+}
+
+GPUParticleEmitter::~GPUParticleEmitter() = default;
+
+void GPUParticleEmitter::RegisterObject(Context* context)
+{
+    context->RegisterFactory<GPUParticleEmitter>(GEOMETRY_CATEGORY);
+
+    URHO3D_ACCESSOR_ATTRIBUTE("Is Enabled", IsEnabled, SetEnabled, bool, true, AM_DEFAULT);
+    URHO3D_MIXED_ACCESSOR_ATTRIBUTE("Effect", GetEffectAttr, SetEffectAttr, ResourceRef, ResourceRef(ParticleEffect::GetTypeStatic()),
+        AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Is Emitting", IsEmitting, SetEmitting, bool, true, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Draw Distance", GetDrawDistance, SetDrawDistance, float, 0.0f, AM_DEFAULT);
+    URHO3D_COPY_BASE_ATTRIBUTES(Drawable);
+}
+
+void GPUParticleEmitter::OnSetEnabled()
+{
+    Drawable::OnSetEnabled();
+
+    Scene* scene = GetScene();
+    if (scene)
+    {
+        if (IsEnabledEffective())
+            SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(GPUParticleEmitter, HandleScenePostUpdate));
+        else
+            UnsubscribeFromEvent(scene, E_SCENEPOSTUPDATE);
+    }
+}
+
+void GPUParticleEmitter::UpdateGeometry(const FrameInfo& frame)
+{
+    if (bufferDirty_ || vertexBuffer_->IsDataLost() || indexBuffer_->IsDataLost())
+        UpdateBuffers();
+}
+
+UpdateGeometryType GPUParticleEmitter::GetUpdateGeometryType()
+{
+    if (bufferDirty_ || vertexBuffer_->IsDataLost() || indexBuffer_->IsDataLost())
+        return UPDATE_MAIN_THREAD;
+    else
+        return UPDATE_NONE;
+}
+
+void GPUParticleEmitter::SetEffect(ParticleEffect* effect)
+{
+    if (effect == effect_)
+        return;
+
+    // Unsubscribe from the reload event of previous effect (if any), then subscribe to the new
+    if (effect_)
+        UnsubscribeFromEvent(effect_, E_RELOADFINISHED);
+
+    effect_ = effect;
+
+    if (effect_)
+        SubscribeToEvent(effect_, E_RELOADFINISHED, URHO3D_HANDLER(GPUParticleEmitter, HandleEffectReloadFinished));
+
+    ApplyEffect();
+    Reset();
+    MarkNetworkUpdate();
+}
+
+void GPUParticleEmitter::SetEmitting(bool enable)
+{
+    if (enable == emitting_)
+        return;
+
+    emitting_ = enable;
+
+    if (emitting_)
+    {
+        // Particles spawned before the start of the window stay hidden, so emission ramps up like on the CPU emitter
+        const float activeTime = effect_ ? effect_->GetActiveTime() : 0.0f;
+        emitStartTime_ = time_;
+        emitStopTime_ = activeTime > 0.0f ? time_ + activeTime : M_LARGE_VALUE;
+    }
+    else
+        emitStopTime_ = Min(emitStopTime_, time_);
+
+    UpdateEmitParameters();
+    MarkNetworkUpdate();
+}
+
+void GPUParticleEmitter::Reset()
+{
+    time_ = 0.0f;
+    emitting_ = false;
+    emitStopTime_ = 0.0f;
+    SetEmitting(true);
+}
+
+void GPUParticleEmitter::ApplyEffect()
+{
+    const unsigned numParticles = effect_ ? effect_->GetNumParticles() : 0;
+    if (numParticles != numParticles_)
+    {
+        numParticles_ = numParticles;
+        bufferDirty_ = true;
+    }
+
+    Material* effectMaterial = effect_ ? effect_->GetMaterial() : nullptr;
+    material_ = effectMaterial ? effectMaterial->Clone() : nullptr;
+    batches_[0].material_ = material_;
+
+    if (!effect_)
+    {
+        particleBox_ = BoundingBox(Vector3::ZERO, Vector3::ZERO);
+        maxParticleSize_ = 0.0f;
+        Drawable::OnMarkedDirty(node_);
+        return;
+    }
+
+    const float minTimeToLive = Max(effect_->GetMinTimeToLive(), M_EPSILON);
+    const float maxTimeToLive = Max(effect_->GetMaxTimeToLive(), minTimeToLive);
+    const Vector2& minSize = effect_->GetMinParticleSize();
+    const Vector2& maxSize = effect_->GetMaxParticleSize();
+    const ea::vector<ColorFrame>& colorFrames = effect_->GetColorFrames();
+
+    if (material_)
+    {
+        material_->SetShaderParameter("ParticleLifetime", Vector2(minTimeToLive, maxTimeToLive));
+        material_->SetShaderParameter("ParticleVelocity", Vector2(effect_->GetMinVelocity(), effect_->GetMaxVelocity()));
+        material_->SetShaderParameter("ParticleDirMin", effect_->GetMinDirection());
+        material_->SetShaderParameter("ParticleDirMax", effect_->GetMaxDirection());
+        material_->SetShaderParameter("ParticleEmitter", Vector4(effect_->GetEmitterSize(), (float)effect_->GetEmitterType()));
+        material_->SetShaderParameter("ParticleForce", Vector4(effect_->GetConstantForce(), effect_->GetDampingForce()));
+        material_->SetShaderParameter("ParticleSize", Vector4(minSize.x_, minSize.y_, maxSize.x_, maxSize.y_));
+        material_->SetShaderParameter("ParticleSizeChange", Vector2(effect_->GetSizeAdd(), effect_->GetSizeMul()));
+        material_->SetShaderParameter("ParticleRotation", Vector4(effect_->GetMinRotation(), effect_->GetMaxRotation(),
+            effect_->GetMinRotationSpeed(), effect_->GetMaxRotationSpeed()));
+        material_->SetShaderParameter("ParticleColorStart", colorFrames.empty() ? Color::WHITE : colorFrames.front().color_);
+        material_->SetShaderParameter("ParticleColorEnd", colorFrames.empty() ? Color::WHITE : colorFrames.back().color_);
+    }
+
+    // Conservative bounds: the furthest a particle can travel within its lifetime, ignoring damping which only slows it
+    const float maxTravel = effect_->GetMaxVelocity() * maxTimeToLive +
+        0.5f * effect_->GetConstantForce().Length() * maxTimeToLive * maxTimeToLive;
+    const Vector3 halfExtent = effect_->GetEmitterSize() * 0.5f + Vector3::ONE * maxTravel;
+    particleBox_ = BoundingBox(-halfExtent, halfExtent);
+
+    // Size scaling is monotonic, so the largest scale is found at either end of the lifetime
+    const float sizeAdd = effect_->GetSizeAdd();
+    const float sizeRate = effect_->GetSizeMul() - 1.0f;
+    const float endScale = Abs(sizeRate) > 0.0001f ?
+        (1.0f + sizeAdd / sizeRate) * expf(sizeRate * maxTimeToLive) - sizeAdd / sizeRate : 1.0f + sizeAdd * maxTimeToLive;
+    maxParticleSize_ = VectorMax(minSize, maxSize).Length() * Max(endScale, 1.0f);
+
+    Drawable::OnMarkedDirty(node_);
+}
+
+ParticleEffect* GPUParticleEmitter::GetEffect() const
+{
+    return effect_;
+}
+
+void GPUParticleEmitter::SetEffectAttr(const ResourceRef& value)
+{
+    auto* cache = GetSubsystem<ResourceCache>();
+    SetEffect(cache->GetResource<ParticleEffect>(value.name_));
+}
+
+ResourceRef GPUParticleEmitter::GetEffectAttr() const
+{
+    return GetResourceRef(effect_, ParticleEffect::GetTypeStatic());
+}
+
+void GPUParticleEmitter::OnSceneSet(Scene* scene)
+{
+    Drawable::OnSceneSet(scene);
+
+    if (scene && IsEnabledEffective())
+        SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(GPUParticleEmitter, HandleScenePostUpdate));
+    else if (!scene)
+        UnsubscribeFromEvent(E_SCENEPOSTUPDATE);
+}
+
+void GPUParticleEmitter::OnWorldBoundingBoxUpdate()
+{
+    BoundingBox worldBox = particleBox_.Transformed(node_->GetWorldTransform());
+
+    // Billboard offsets are applied in world space after the transform
+    const Vector3 edge = Vector3::ONE * maxParticleSize_;
+    worldBoundingBox_ = BoundingBox(worldBox.min_ - edge, worldBox.max_ + edge);
+}
+
+void GPUParticleEmitter::UpdateBuffers()
+{
+    const unsigned numVertices = numParticles_ * 4;
+    const bool largeIndices = numVertices >= 65536;
+
+    // Each vertex stores the spawn phase of its particle, a random seed and the quad corner index
+    ea::vector<Vector3> vertices(numVertices);
+    for (unsigned i = 0; i < numParticles_; ++i)
+    {
+        const float phase = (float)i / (float)numParticles_;
+        const float seed = (float)(Fract(i * 0.6180339887) * 100.0);
+        for (unsigned j = 0; j < 4; ++j)
+            vertices[i * 4 + j] = Vector3(phase, seed, (float)j);
+    }
+
+    ea::vector<unsigned> indices(numParticles_ * 6);
+    for (unsigned i = 0; i < numParticles_; ++i)
+    {
+        const unsigned vertexIndex = i * 4;
+        unsigned* dest = &indices[i * 6];
+        dest[0] = vertexIndex;
+        dest[1] = vertexIndex + 1;
+        dest[2] = vertexIndex + 2;
+        dest[3] = vertexIndex + 2;
+        dest[4] = vertexIndex + 3;
+        dest[5] = vertexIndex;
+    }
+
+    vertexBuffer_->SetSize(numVertices, MASK_POSITION);
+    indexBuffer_->SetSize(indices.size(), largeIndices);
+    if (numParticles_)
+    {
+        vertexBuffer_->SetData(vertices.data());
+        if (largeIndices)
+            indexBuffer_->SetData(indices.data());
+        else
+        {
+            ea::vector<unsigned short> shortIndices(indices.begin(), indices.end());
+            indexBuffer_->SetData(shortIndices.data());
+        }
+    }
+
+    geometry_->SetDrawRange(TRIANGLE_LIST, 0, indices.size(), false);
+    vertexBuffer_->ClearDataLost();
+    indexBuffer_->ClearDataLost();
+    bufferDirty_ = false;
+}
+
+void GPUParticleEmitter::UpdateEmitParameters()
+{
+    if (!material_)
+        return;
+
+    material_->SetShaderParameter("ParticleTime", time_);
+    material_->SetShaderParameter("ParticleEmitWindow", Vector2(emitStartTime_, emitStopTime_));
+}
+
+void GPUParticleEmitter::HandleScenePostUpdate(StringHash eventType, VariantMap& eventData)
+{
+    // Use the scene's timestep instead of the global timestep, as time scale may be other than 1
+    using namespace ScenePostUpdate;
+
+    time_ += eventData[P_TIMESTEP].GetFloat();
+
+    // Emission ends by itself once the active time of the effect is over
+    if (emitting_ && time_ >= emitStopTime_)
+        emitting_ = false;
+
+    UpdateEmitParameters();
+}
+
+void GPUParticleEmitter::HandleEffectReloadFinished(StringHash eventType, VariantMap& eventData)
+{
+    // When particle effect file is live-edited, reapply the effect parameters and restart the emission
+    ApplyEffect();
+    Reset();
+}
+
+}
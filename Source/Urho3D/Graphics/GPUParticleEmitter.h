@@ -0,0 +1,128 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include "../Graphics/Drawable.h"
+
+namespace Urho3D
+{
+
+class Geometry;
+class IndexBuffer;
+class Material;
+class ParticleEffect;
+class VertexBuffer;
+
+/// Particle emitter component that simulates its particles on the GPU.
+/// Particles are evaluated statelessly in the vertex shader from their spawn phase, random seed and the emitter time,
+/// so there is no per-particle CPU work and the particle count only costs vertex throughput.
+/// Requires a material using the GPUParticle vertex shader, e.g. the DiffUnlitGPUParticle techniques.
+class URHO3D_API GPUParticleEmitter : public Drawable
+{
+    URHO3D_OBJECT(GPUParticleEmitter, Drawable);
+
+public:
+    /// Construct.
+    explicit GPUParticleEmitter(Context* context);
+    /// Destruct.
+    ~GPUParticleEmitter() override;
+    /// Register object factory.
+    static void RegisterObject(Context* context);
+
+    /// Handle enabled/disabled state change.
+    void OnSetEnabled() override;
+    /// Prepare geometry for rendering. Called from a worker thread if possible (no GPU update.)
+    void UpdateGeometry(const FrameInfo& frame) override;
+    /// Return whether a geometry update is necessary, and if it can happen in a worker thread.
+    UpdateGeometryType GetUpdateGeometryType() override;
+
+    /// Set particle effect.
+    void SetEffect(ParticleEffect* effect);
+    /// Set whether should be emitting. Particles already emitted finish their lifetime.
+    void SetEmitting(bool enable);
+    /// Restart the emitter. Removes current particles and starts emitting again.
+    void Reset();
+    /// Apply the particle effect parameters. Call this if you change the effect programmatically.
+    void ApplyEffect();
+
+    /// Return particle effect.
+    ParticleEffect* GetEffect() const;
+    /// Return number of particles.
+    unsigned GetNumParticles() const { return numParticles_; }
+    /// Return whether is currently emitting.
+    bool IsEmitting() const { return emitting_; }
+    /// Return emitter time in seconds.
+    float GetTime() const { return time_; }
+
+    /// Set particle effect attribute.
+    void SetEffectAttr(const ResourceRef& value);
+    /// Return particle effect attribute.
+    ResourceRef GetEffectAttr() const;
+
+protected:
+    /// Handle scene being assigned.
+    void OnSceneSet(Scene* scene) override;
+    /// Recalculate the world-space bounding box.
+    void OnWorldBoundingBoxUpdate() override;
+
+private:
+    /// Fill the vertex and index buffers with the static per-particle data.
+    void UpdateBuffers();
+    /// Update the time dependent material parameters.
+    void UpdateEmitParameters();
+    /// Handle scene post-update event.
+    void HandleScenePostUpdate(StringHash eventType, VariantMap& eventData);
+    /// Handle live reload of the particle effect.
+    void HandleEffectReloadFinished(StringHash eventType, VariantMap& eventData);
+
+    /// Geometry.
+    SharedPtr<Geometry> geometry_;
+    /// Vertex buffer.
+    SharedPtr<VertexBuffer> vertexBuffer_;
+    /// Index buffer.
+    SharedPtr<IndexBuffer> indexBuffer_;
+    /// Particle effect.
+    SharedPtr<ParticleEffect> effect_;
+    /// Private copy of the effect material holding the simulation parameters.
+    SharedPtr<Material> material_;
+    /// Local space bounding box of all particles over their lifetime.
+    BoundingBox particleBox_;
+    /// Largest particle half extent over the lifetime.
+    float maxParticleSize_{};
+    /// Number of particles.
+    unsigned numParticles_{};
+    /// Emitter time.
+    float time_{};
+    /// Time when emission started.
+    float emitStartTime_{};
+    /// Time when emission stops.
+    float emitStopTime_{M_LARGE_VALUE};
+    /// Currently emitting flag.
+    bool emitting_{true};
+    /// Buffers need refill flag.
+    bool bufferDirty_{true};
+};
+
+}
@@ -0,0 +1,165 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Core/Profiler.h"
+#include "../Core/StringUtils.h"
+#include "../Graphics/Graphics.h"
+#include "../Graphics/GraphicsEvents.h"
+#include "../Graphics/GPUProfiler.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+/// Maximum number of measured blocks per frame. Further blocks are ignored.
+static const unsigned MAX_GPU_PROFILER_BLOCKS = 256;
+
+GPUProfiler::GPUProfiler(Context* context) :
+    Object(context),
+    GPUObject(GetSubsystem<Graphics>())
+{
+    SubscribeToEvent(E_BEGINRENDERING, URHO3D_HANDLER(GPUProfiler, HandleBeginRendering));
+    SubscribeToEvent(E_ENDRENDERING, URHO3D_HANDLER(GPUProfiler, HandleEndRendering));
+}
+
+GPUProfiler::~GPUProfiler()
+{
+    Release();
+}
+
+void GPUProfiler::BeginBlock(ea::string_view name)
+{
+    FrameQueries& frame = frames_[currentFrame_];
+    if (!inFrame_ || frame.blocks_.size() >= MAX_GPU_PROFILER_BLOCKS || !IssueTimestamp(frame))
+    {
+        blockStack_.push_back(M_MAX_UNSIGNED);
+        return;
+    }
+
+    PendingBlock& block = frame.blocks_.emplace_back();
+    block.name_ = name;
+    block.depth_ = blockStack_.size();
+    block.begin_ = frame.numTimestamps_ - 1;
+    block.end_ = M_MAX_UNSIGNED;
+    blockStack_.push_back(frame.blocks_.size() - 1);
+}
+
+void GPUProfiler::EndBlock()
+{
+    if (blockStack_.empty())
+        return;
+
+    const unsigned index = blockStack_.back();
+    blockStack_.pop_back();
+
+    FrameQueries& frame = frames_[currentFrame_];
+    if (inFrame_ && index < frame.blocks_.size() && IssueTimestamp(frame))
+        frame.blocks_[index].end_ = frame.numTimestamps_ - 1;
+}
+
+ea::string GPUProfiler::PrintData() const
+{
+    ea::string output = Format("GPU frame {:.3f} ms\n", frameTime_);
+    for (const GPUProfilerBlock& block : blocks_)
+    {
+        output.append(block.depth_ * 2 + 2, ' ');
+        output += Format("{} {:.3f} ms\n", block.name_, block.time_);
+    }
+    return output;
+}
+
+void GPUProfiler::HandleBeginRendering(StringHash eventType, VariantMap& eventData)
+{
+    if (!IsSupported())
+        return;
+
+    // Read back the finished frames, oldest first, without waiting for the GPU
+    for (unsigned i = 1; i <= NUM_FRAMES; ++i)
+    {
+        FrameQueries& frame = frames_[(currentFrame_ + i) % NUM_FRAMES];
+        if (frame.pending_ && ResolveFrame(frame))
+            frame.pending_ = false;
+    }
+
+    // Reuse the oldest frame. If its results are still not available, they are dropped
+    currentFrame_ = (currentFrame_ + 1) % NUM_FRAMES;
+    FrameQueries& frame = frames_[currentFrame_];
+    frame.pending_ = false;
+    frame.numTimestamps_ = 0;
+    frame.blocks_.clear();
+    blockStack_.clear();
+
+    inFrame_ = BeginFrameQueries(frame);
+}
+
+void GPUProfiler::HandleEndRendering(StringHash eventType, VariantMap& eventData)
+{
+    if (!inFrame_)
+        return;
+
+    FrameQueries& frame = frames_[currentFrame_];
+    EndFrameQueries(frame);
+    frame.pending_ = true;
+    inFrame_ = false;
+}
+
+bool GPUProfiler::ResolveFrame(FrameQueries& frame)
+{
+    if (!ReadTimestamps(frame, times_))
+        return false;
+
+    // Keep the previous results if the timestamps were invalidated, e.g. by a GPU clock change
+    if (times_.size() < 2)
+        return true;
+
+    frameTime_ = static_cast<float>(times_.back() - times_.front());
+    ++numResolvedFrames_;
+    blocks_.clear();
+    for (const PendingBlock& pendingBlock : frame.blocks_)
+    {
+        if (pendingBlock.end_ >= times_.size())
+            continue;
+
+        GPUProfilerBlock& block = blocks_.emplace_back();
+        block.name_ = pendingBlock.name_;
+        block.depth_ = pendingBlock.depth_;
+        block.time_ = static_cast<float>(times_[pendingBlock.end_] - times_[pendingBlock.begin_]);
+    }
+
+#if URHO3D_PROFILING
+    URHO3D_PROFILE_VALUE("GPU frame", static_cast<double>(frameTime_));
+    for (const GPUProfilerBlock& block : blocks_)
+    {
+        const ea::string& plotName = *plotNames_.insert("GPU " + block.name_).first;
+        URHO3D_PROFILE_VALUE(plotName.c_str(), static_cast<double>(block.time_));
+    }
+#endif
+
+    return true;
+}
+
+}
@@ -0,0 +1,154 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Core/Object.h"
+#include "../Graphics/GPUObject.h"
+#include "../Graphics/GraphicsDefs.h"
+
+#include <EASTL/hash_set.h>
+
+namespace Urho3D
+{
+
+/// GPU time measured for a profiled block.
+struct GPUProfilerBlock
+{
+    /// Block name.
+    ea::string name_;
+    /// Nesting depth, 0 for outermost blocks.
+    unsigned depth_{};
+    /// GPU time in milliseconds.
+    float time_{};
+};
+
+/// Measures GPU time of render path commands and shadow map rendering with timestamp queries. Results are read back without stalling, typically a few frames after issuing.
+class URHO3D_API GPUProfiler : public Object, public GPUObject
+{
+    URHO3D_OBJECT(GPUProfiler, Object);
+
+    using GPUObject::GetGraphics;
+
+public:
+    /// Construct.
+    explicit GPUProfiler(Context* context);
+    /// Destruct.
+    ~GPUProfiler() override;
+
+    /// Mark the GPU resource destroyed on graphics context destruction.
+    void OnDeviceLost() override;
+    /// Release the queries.
+    void Release() override;
+
+    /// Begin a block. Blocks may be nested and must be ended in the same frame.
+    void BeginBlock(ea::string_view name);
+    /// End the innermost block.
+    void EndBlock();
+
+    /// Return whether timestamp queries are supported by the graphics API.
+    bool IsSupported() const;
+    /// Return blocks of the last frame whose results are available, in the order they were begun.
+    const ea::vector<GPUProfilerBlock>& GetBlocks() const { return blocks_; }
+    /// Return GPU time in milliseconds of the last frame whose results are available.
+    float GetFrameTime() const { return frameTime_; }
+    /// Return number of frames whose results have been read back so far. Changes when the frame time is updated.
+    unsigned GetNumResolvedFrames() const { return numResolvedFrames_; }
+    /// Return blocks and frame time as text.
+    ea::string PrintData() const;
+
+private:
+    /// Block waiting for its query results.
+    struct PendingBlock
+    {
+        /// Block name.
+        ea::string name_;
+        /// Nesting depth.
+        unsigned depth_{};
+        /// Index of the begin timestamp.
+        unsigned begin_{};
+        /// Index of the end timestamp.
+        unsigned end_{};
+    };
+
+    /// Queries of one frame.
+    struct FrameQueries
+    {
+        /// Disjoint query, if required by the graphics API.
+        GPUObjectHandle disjointQuery_{};
+        /// Timestamp frequency query, if required by the graphics API.
+        GPUObjectHandle frequencyQuery_{};
+        /// Timestamp queries. Created on demand and reused on later frames.
+        ea::vector<GPUObjectHandle> timestampQueries_;
+        /// Number of timestamps issued in the frame.
+        unsigned numTimestamps_{};
+        /// Blocks of the frame.
+        ea::vector<PendingBlock> blocks_;
+        /// Whether the frame has been issued and its results are not read yet.
+        bool pending_{};
+    };
+
+    /// Handle begin of rendering: read back finished frames and begin a new one.
+    void HandleBeginRendering(StringHash eventType, VariantMap& eventData);
+    /// Handle end of rendering: end the current frame.
+    void HandleEndRendering(StringHash eventType, VariantMap& eventData);
+    /// Read back the results of a frame into the blocks. Return false if they are not available yet.
+    bool ResolveFrame(FrameQueries& frame);
+
+    /// Begin the queries of a frame. Return true on success.
+    bool BeginFrameQueries(FrameQueries& frame);
+    /// End the queries of a frame.
+    void EndFrameQueries(FrameQueries& frame);
+    /// Issue the next timestamp query of a frame, creating it if necessary. Return true on success.
+    bool IssueTimestamp(FrameQueries& frame);
+    /// Read the timestamps of a frame as milliseconds relative to the first one. Return false if not available yet. Leave times empty if the timestamps are invalid.
+    bool ReadTimestamps(FrameQueries& frame, ea::vector<double>& times);
+    /// Release the queries of a frame.
+    void ReleaseFrameQueries(FrameQueries& frame);
+
+    /// Number of frames in flight.
+    static const unsigned NUM_FRAMES = 4;
+
+    /// Queries of the frames in flight.
+    FrameQueries frames_[NUM_FRAMES];
+    /// Index of the current frame.
+    unsigned currentFrame_{};
+    /// Whether a frame is being recorded.
+    bool inFrame_{};
+    /// Stack of open blocks, as indices to the blocks of the current frame. M_MAX_UNSIGNED for blocks that are not measured.
+    ea::vector<unsigned> blockStack_;
+    /// Blocks of the last resolved frame.
+    ea::vector<GPUProfilerBlock> blocks_;
+    /// GPU time of the last resolved frame.
+    float frameTime_{};
+    /// Number of resolved frames.
+    unsigned numResolvedFrames_{};
+    /// Scratch buffer for timestamps.
+    ea::vector<double> times_;
+#if URHO3D_PROFILING
+    /// Names of the profiler plots. Plot names must stay valid for the profiler.
+    ea::hash_set<ea::string> plotNames_;
+#endif
+};
+
+}
@@ -25,6 +25,7 @@
 #include "../Graphics/GlobalIllumination.h"
 
 #include "../Core/Context.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../IO/ArchiveSerialization.h"
 #include "../IO/BinaryArchive.h"
@@ -98,7 +99,7 @@ void GlobalIllumination::CompileLightProbes()
         return;
 
     // Add padding to avoid vertex collision
-    lightProbesMesh_.Define(collection.worldPositions_);
+    lightProbesMesh_.Define(collection.worldPositions_, GetSubsystem<WorkQueue>());
 
     // Store in file
     auto cache = context_->GetCache();
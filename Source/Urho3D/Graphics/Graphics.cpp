@@ -33,17 +33,22 @@
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/DecalSet.h"
 #include "../Graphics/GlobalIllumination.h"
+#include "../Graphics/GPUParticleEmitter.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/GraphicsEvents.h"
 #include "../Graphics/GraphicsImpl.h"
+#include "../Graphics/HierarchicalLodGroup.h"
 #include "../Graphics/IndexBuffer.h"
 #include "../Graphics/LightBaker.h"
 #include "../Graphics/LightProbeGroup.h"
 #include "../Graphics/Material.h"
 #include "../Graphics/OcclusionBuffer.h"
+#include "../Graphics/OcclusionQuery.h"
 #include "../Graphics/Octree.h"
 #include "../Graphics/ParticleEffect.h"
 #include "../Graphics/ParticleEmitter.h"
+#include "../Graphics/ProjectedDecal.h"
+#include "../Graphics/ReflectionProbe.h"
 #include "../Graphics/RibbonTrail.h"
 #include "../Graphics/Shader.h"
 #include "../Graphics/ShaderPrecache.h"
@@ -52,6 +57,7 @@
 #include "../Graphics/Technique.h"
 #include "../Graphics/Terrain.h"
 #include "../Graphics/TerrainPatch.h"
+#include "../Graphics/TerrainStreamer.h"
 #ifdef _WIN32
 #include "../Graphics/Texture2D.h"
 #endif
@@ -391,6 +397,46 @@ void Graphics::SetGlobalShaderDefines(const ea::string& globalShaderDefines)
     globalShaderDefinesHash_ = globalShaderDefines_;
 }
 
+void Graphics::SetPipelineState(const PipelineState& state)
+{
+    // Consecutive sorted batches mostly share their states, so compare once instead of going through each setter
+    if (state == GetPipelineState())
+        return;
+
+    SetBlendMode(state.blendMode_, state.alphaToCoverage_);
+    SetLineAntiAlias(state.lineAntiAlias_);
+    SetCullMode(state.cullMode_);
+    SetFillMode(state.fillMode_);
+    SetDepthTest(state.depthTestMode_);
+    SetDepthWrite(state.depthWrite_);
+    SetDepthBias(state.constantDepthBias_, state.slopeScaledDepthBias_);
+}
+
+PipelineState Graphics::GetPipelineState() const
+{
+    PipelineState state;
+    state.blendMode_ = blendMode_;
+    state.alphaToCoverage_ = alphaToCoverage_;
+    state.lineAntiAlias_ = lineAntiAlias_;
+    state.cullMode_ = cullMode_;
+    state.fillMode_ = fillMode_;
+    state.depthTestMode_ = depthTestMode_;
+    state.depthWrite_ = depthWrite_;
+    state.constantDepthBias_ = constantDepthBias_;
+    state.slopeScaledDepthBias_ = slopeScaledDepthBias_;
+    return state;
+}
+
+bool Graphics::ReserveTextureUpload(unsigned bytes)
+{
+    // Let the first upload of the frame through even if it exceeds the budget, so that large levels still make progress
+    if (textureUploadBytes_ && textureUploadBytes_ + bytes > textureUploadBudget_)
+        return false;
+
+    textureUploadBytes_ += bytes;
+    return true;
+}
+
 void Graphics::SetShaderCacheDir(const ea::string& path)
 {
     ea::string trimmedPath = path.trimmed();
@@ -629,6 +675,7 @@ void RegisterGraphicsLibrary(Context* context)
     Light::RegisterObject(context);
     LightBaker::RegisterObject(context);
     LightProbeGroup::RegisterObject(context);
+    HierarchicalLodGroup::RegisterObject(context);
     GlobalIllumination::RegisterObject(context);
     StaticModel::RegisterObject(context);
     StaticModelGroup::RegisterObject(context);
@@ -638,14 +685,18 @@ void RegisterGraphicsLibrary(Context* context)
     BillboardSet::RegisterObject(context);
     ParticleEffect::RegisterObject(context);
     ParticleEmitter::RegisterObject(context);
+    GPUParticleEmitter::RegisterObject(context);
     RibbonTrail::RegisterObject(context);
     CustomGeometry::RegisterObject(context);
     DecalSet::RegisterObject(context);
+    ProjectedDecal::RegisterObject(context);
     Terrain::RegisterObject(context);
     TerrainPatch::RegisterObject(context);
+    TerrainStreamer::RegisterObject(context);
     DebugRenderer::RegisterObject(context);
     Octree::RegisterObject(context);
     Zone::RegisterObject(context);
+    ReflectionProbe::RegisterObject(context);
     VertexBuffer::RegisterObject(context);
     IndexBuffer::RegisterObject(context);
     Geometry::RegisterObject(context);
@@ -653,6 +704,7 @@ void RegisterGraphicsLibrary(Context* context)
     View::RegisterObject(context);
     Viewport::RegisterObject(context);
     OcclusionBuffer::RegisterObject(context);
+    OcclusionQuery::RegisterObject(context);
 }
 
 
@@ -213,6 +213,8 @@ public:
     /// Draw indexed, instanced geometry with vertex index offset.
     void DrawInstanced(PrimitiveType type, unsigned indexStart, unsigned indexCount, unsigned baseVertexIndex, unsigned minVertex,
         unsigned vertexCount, unsigned instanceCount);
+    /// Draw several indexed, instanced geometry ranges from the current buffers. The instancing vertex buffer must be set with zero instance offset. Requires multi-draw support.
+    void MultiDrawInstanced(PrimitiveType type, const IndexedDrawCommand* commands, unsigned numCommands);
     /// Set vertex buffer.
     void SetVertexBuffer(VertexBuffer* buffer);
     /// Set multiple vertex buffers.
@@ -293,6 +295,8 @@ public:
     void SetCullMode(CullMode mode);
     /// Set depth bias.
     void SetDepthBias(float constantBias, float slopeScaledBias);
+    /// Set blend, cull, fill and depth states at once. Does nothing if they all match the current states.
+    void SetPipelineState(const PipelineState& state);
     /// Set depth compare.
     void SetDepthTest(CompareMode mode);
     /// Set depth write on/off.
@@ -318,10 +322,16 @@ public:
     void EndDumpShaders();
     /// Precache shader variations from an XML file generated with BeginDumpShaders().
     void PrecacheShaders(Deserializer& source);
-    /// Set shader cache directory, Direct3D only. This can either be an absolute path or a path within the resource system.
+    /// Set shader cache directory. This can either be an absolute path or a path within the resource system. On OpenGL, linked program binaries are cached there when the path is absolute and the driver supports ARB_get_program_binary.
     void SetShaderCacheDir(const ea::string& path);
+    /// Set whether shaders are compiled and linked in the background by the driver, OpenGL with ARB_parallel_shader_compile only. Batches are skipped until their shaders are ready.
+    void SetAsyncShaderCompilation(bool enable) { asyncShaderCompilation_ = enable; }
     /// Set global shader defines.
     void SetGlobalShaderDefines(const ea::string& globalShaderDefines);
+    /// Set maximum bytes of background loaded texture data uploaded per frame. Textures exceeding the budget are uploaded over several frames. Zero uploads immediately.
+    void SetTextureUploadBudget(unsigned bytes) { textureUploadBudget_ = bytes; }
+    /// Reserve texture upload bytes from the budget of the current frame. The first upload of a frame always succeeds. Return true if the upload may proceed.
+    bool ReserveTextureUpload(unsigned bytes);
 
     /// Return whether rendering initialized.
     bool IsInitialized() const;
@@ -407,6 +417,15 @@ public:
     /// Return number of batches drawn this frame.
     unsigned GetNumBatches() const { return numBatches_; }
 
+    /// Return number of render state changes applied this frame.
+    unsigned GetNumStateChanges() const { return numStateChanges_; }
+
+    /// Return number of shader program switches this frame.
+    unsigned GetNumShaderChanges() const { return numShaderChanges_; }
+
+    /// Return number of texture binds this frame.
+    unsigned GetNumTextureChanges() const { return numTextureChanges_; }
+
     /// Return dummy color texture format for shadow maps. Is "NULL" (consume no video memory) if supported.
     unsigned GetDummyColorFormat() const { return dummyColorFormat_; }
 
@@ -419,6 +438,18 @@ public:
     /// Return whether hardware instancing is supported.
     bool GetInstancingSupport() const { return instancingSupport_; }
 
+    /// Return whether MultiDrawInstanced() is supported. On OpenGL this requires indirect multi-draw with base instances.
+    bool GetMultiDrawSupport() const { return multiDrawSupport_; }
+
+    /// Return whether shaders can be compiled and linked in the background by the driver.
+    bool GetAsyncShaderCompilationSupport() const { return asyncShaderCompilationSupport_; }
+
+    /// Return whether shaders are compiled and linked in the background when supported.
+    bool GetAsyncShaderCompilation() const { return asyncShaderCompilation_; }
+
+    /// Return maximum bytes of background loaded texture data uploaded per frame.
+    unsigned GetTextureUploadBudget() const { return textureUploadBudget_; }
+
     /// Return whether light pre-pass rendering is supported.
     bool GetLightPrepassSupport() const { return lightPrepassSupport_; }
 
@@ -530,6 +561,9 @@ public:
     /// Return whether line antialiasing is enabled.
     bool GetLineAntiAlias() const { return lineAntiAlias_; }
 
+    /// Return current blend, cull, fill and depth states.
+    PipelineState GetPipelineState() const;
+
     /// Return whether stencil test is enabled.
     bool GetStencilTest() const { return stencilTest_; }
 
@@ -765,6 +799,16 @@ private:
     bool hardwareShadowSupport_{};
     /// Instancing support flag.
     bool instancingSupport_{};
+    /// Multi-draw with base instances support flag.
+    bool multiDrawSupport_{};
+    /// Background shader compile and link support flag.
+    bool asyncShaderCompilationSupport_{};
+    /// Background shader compile and link flag.
+    bool asyncShaderCompilation_{};
+    /// Texture upload budget in bytes per frame.
+    unsigned textureUploadBudget_{4 * 1024 * 1024};
+    /// Texture upload bytes this frame.
+    unsigned textureUploadBytes_{};
     /// sRGB conversion on read support flag.
     bool sRGBSupport_{};
     /// sRGB conversion on write support flag.
@@ -773,6 +817,12 @@ private:
     unsigned numPrimitives_{};
     /// Number of batches this frame.
     unsigned numBatches_{};
+    /// Number of render state changes this frame.
+    unsigned numStateChanges_{};
+    /// Number of shader program switches this frame.
+    unsigned numShaderChanges_{};
+    /// Number of texture binds this frame.
+    unsigned numTextureChanges_{};
     /// Largest scratch buffer request this frame.
     unsigned maxScratchBufferRequest_{};
     /// GPU objects.
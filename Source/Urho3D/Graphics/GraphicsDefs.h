@@ -121,6 +121,56 @@ enum StencilOp
     OP_DECR
 };
 
+/// Fixed-function render states of a draw call, applied at once with Graphics::SetPipelineState().
+struct URHO3D_API PipelineState
+{
+    /// Test for equality with another pipeline state.
+    bool operator ==(const PipelineState& rhs) const
+    {
+        return blendMode_ == rhs.blendMode_ && alphaToCoverage_ == rhs.alphaToCoverage_ && lineAntiAlias_ == rhs.lineAntiAlias_ &&
+            cullMode_ == rhs.cullMode_ && fillMode_ == rhs.fillMode_ && depthTestMode_ == rhs.depthTestMode_ &&
+            depthWrite_ == rhs.depthWrite_ && constantDepthBias_ == rhs.constantDepthBias_ &&
+            slopeScaledDepthBias_ == rhs.slopeScaledDepthBias_;
+    }
+
+    /// Test for inequality with another pipeline state.
+    bool operator !=(const PipelineState& rhs) const { return !(*this == rhs); }
+
+    /// Blend mode.
+    BlendMode blendMode_{ BLEND_REPLACE };
+    /// Alpha-to-coverage flag.
+    bool alphaToCoverage_{};
+    /// Line antialiasing flag.
+    bool lineAntiAlias_{};
+    /// Cull mode, already reversed for cameras with reverse culling.
+    CullMode cullMode_{ CULL_CCW };
+    /// Fill mode.
+    FillMode fillMode_{ FILL_SOLID };
+    /// Depth compare mode.
+    CompareMode depthTestMode_{ CMP_LESSEQUAL };
+    /// Depth write flag.
+    bool depthWrite_{ true };
+    /// Constant depth bias.
+    float constantDepthBias_{};
+    /// Slope-scaled depth bias.
+    float slopeScaledDepthBias_{};
+};
+
+/// Indexed, instanced draw call of Graphics::MultiDrawInstanced(). Laid out as the OpenGL indirect draw command.
+struct IndexedDrawCommand
+{
+    /// Number of indices.
+    unsigned indexCount_;
+    /// Number of instances.
+    unsigned instanceCount_;
+    /// First index.
+    unsigned indexStart_;
+    /// Value added to each index.
+    int baseVertexIndex_;
+    /// First instance in the instancing vertex buffer.
+    unsigned baseInstance_;
+};
+
 /// Vertex/index buffer lock state.
 enum LockState
 {
@@ -161,6 +211,10 @@ enum VertexElementType
     TYPE_VECTOR4,
     TYPE_UBYTE4,
     TYPE_UBYTE4_NORM,
+    TYPE_HALF2,
+    TYPE_HALF4,
+    TYPE_SHORT2_NORM,
+    TYPE_SHORT4_NORM,
     MAX_VERTEX_ELEMENT_TYPES
 };
 
@@ -0,0 +1,160 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Graphics/Camera.h"
+#include "../Graphics/DebugRenderer.h"
+#include "../Graphics/Drawable.h"
+#include "../Graphics/HierarchicalLodGroup.h"
+#include "../Scene/Node.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+extern const char* SCENE_CATEGORY;
+
+HierarchicalLodGroup::HierarchicalLodGroup(Context* context) :
+    Component(context)
+{
+}
+
+HierarchicalLodGroup::~HierarchicalLodGroup()
+{
+    ClearDrawables();
+}
+
+void HierarchicalLodGroup::RegisterObject(Context* context)
+{
+    context->RegisterFactory<HierarchicalLodGroup>(SCENE_CATEGORY);
+
+    URHO3D_ACCESSOR_ATTRIBUTE("Is Enabled", IsEnabled, SetEnabled, bool, true, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Switch Screen Size", GetSwitchScreenSize, SetSwitchScreenSize, float, DEFAULT_HLOD_SWITCH_SCREEN_SIZE, AM_DEFAULT);
+}
+
+void HierarchicalLodGroup::ApplyAttributes()
+{
+    Refresh();
+}
+
+void HierarchicalLodGroup::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
+{
+    if (debug && node_ && IsEnabledEffective())
+        debug->AddBoundingBox(localBoundingBox_, node_->GetWorldTransform(), Color::CYAN, depthTest);
+}
+
+void HierarchicalLodGroup::Refresh()
+{
+    ClearDrawables();
+    if (!node_)
+        return;
+
+    parentGroup_ = node_->GetParentComponent<HierarchicalLodGroup>(true);
+
+    BoundingBox worldBoundingBox;
+    CollectDrawables(node_, worldBoundingBox, true);
+    localBoundingBox_ = worldBoundingBox.Defined()
+        ? worldBoundingBox.Transformed(node_->GetWorldTransform().Inverse())
+        : BoundingBox(Vector3::ZERO, Vector3::ZERO);
+}
+
+void HierarchicalLodGroup::SetSwitchScreenSize(float size)
+{
+    switchScreenSize_ = Max(size, 0.0f);
+}
+
+BoundingBox HierarchicalLodGroup::GetWorldBoundingBox() const
+{
+    return node_ ? localBoundingBox_.Transformed(node_->GetWorldTransform()) : localBoundingBox_;
+}
+
+float HierarchicalLodGroup::GetScreenSize(Camera* camera) const
+{
+    const BoundingBox worldBoundingBox = GetWorldBoundingBox();
+    const float radius = worldBoundingBox.HalfSize().Length();
+    float halfViewSize = camera->GetHalfViewSize();
+    if (!camera->IsOrthographic())
+        halfViewSize *= camera->GetDistance(worldBoundingBox.Center());
+    return radius * camera->GetLodBias() / Max(halfViewSize, M_EPSILON);
+}
+
+bool HierarchicalLodGroup::IsProxyActive(Camera* camera) const
+{
+    return IsEnabledEffective() && GetScreenSize(camera) < switchScreenSize_;
+}
+
+bool HierarchicalLodGroup::IsDrawableVisible(Camera* camera, bool isProxy) const
+{
+    for (HierarchicalLodGroup* group = parentGroup_; group; group = group->parentGroup_)
+    {
+        if (group->IsProxyActive(camera))
+            return false;
+    }
+    return IsProxyActive(camera) == isProxy;
+}
+
+void HierarchicalLodGroup::OnNodeSet(Node* node)
+{
+    if (!node)
+        ClearDrawables();
+}
+
+void HierarchicalLodGroup::CollectDrawables(Node* node, BoundingBox& worldBoundingBox, bool assign)
+{
+    const bool isProxy = node == node_;
+    if (!isProxy && node->HasComponent<HierarchicalLodGroup>())
+        assign = false;
+
+    ea::vector<Drawable*> drawables;
+    node->GetDerivedComponents(drawables);
+    for (Drawable* drawable : drawables)
+    {
+        if (!(drawable->GetDrawableFlags() & DRAWABLE_GEOMETRY))
+            continue;
+
+        worldBoundingBox.Merge(drawable->GetWorldBoundingBox());
+        if (assign)
+        {
+            drawable->SetHierarchicalLodGroup(this, isProxy);
+            drawables_.emplace_back(drawable);
+        }
+    }
+
+    for (Node* child : node->GetChildren())
+        CollectDrawables(child, worldBoundingBox, assign);
+}
+
+void HierarchicalLodGroup::ClearDrawables()
+{
+    for (Drawable* drawable : drawables_)
+    {
+        if (drawable && drawable->GetHierarchicalLodGroup() == this)
+            drawable->SetHierarchicalLodGroup(nullptr, false);
+    }
+    drawables_.clear();
+}
+
+}
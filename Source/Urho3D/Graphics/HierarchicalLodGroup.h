@@ -0,0 +1,95 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+/// \file
+
+#pragma once
+
+#include "../Math/BoundingBox.h"
+#include "../Scene/Component.h"
+
+namespace Urho3D
+{
+
+class Camera;
+class Drawable;
+
+static const float DEFAULT_HLOD_SWITCH_SCREEN_SIZE = 0.1f;
+
+/// Hierarchical LOD cluster. Drawables in the cluster node are proxies that replace the drawables of all child nodes
+/// when the cluster becomes small on screen. Nested clusters are hidden together with their parent's children.
+/// The cluster is considered static: call Refresh() after adding, removing or moving member drawables.
+class URHO3D_API HierarchicalLodGroup : public Component
+{
+    URHO3D_OBJECT(HierarchicalLodGroup, Component);
+
+public:
+    /// Construct.
+    explicit HierarchicalLodGroup(Context* context);
+    /// Destruct.
+    ~HierarchicalLodGroup() override;
+    /// Register object factory. Drawable must be registered first.
+    static void RegisterObject(Context* context);
+    /// Apply attribute changes that can not be applied immediately.
+    void ApplyAttributes() override;
+    /// Visualize the component as debug geometry.
+    void DrawDebugGeometry(DebugRenderer* debug, bool depthTest) override;
+
+    /// Collect proxy and member drawables and recalculate cluster bounds.
+    void Refresh();
+
+    /// Set screen size (fraction of viewport height covered by cluster bounds) below which the proxy is drawn.
+    void SetSwitchScreenSize(float size);
+    /// Return switch screen size.
+    float GetSwitchScreenSize() const { return switchScreenSize_; }
+
+    /// Return cluster bounding box in world space.
+    BoundingBox GetWorldBoundingBox() const;
+    /// Return fraction of viewport height covered by cluster bounds when seen from camera.
+    float GetScreenSize(Camera* camera) const;
+    /// Return whether the proxy replaces member drawables for camera.
+    bool IsProxyActive(Camera* camera) const;
+    /// Return whether the drawable belonging to this cluster should be drawn for camera. Safe to call from worker threads.
+    bool IsDrawableVisible(Camera* camera, bool isProxy) const;
+
+protected:
+    /// Handle scene node being assigned at creation.
+    void OnNodeSet(Node* node) override;
+
+private:
+    /// Collect drawables of node and its children into bounds. Drawables of nested clusters are not assigned.
+    void CollectDrawables(Node* node, BoundingBox& worldBoundingBox, bool assign);
+    /// Detach from all drawables.
+    void ClearDrawables();
+
+    /// Screen size below which the proxy is drawn.
+    float switchScreenSize_{ DEFAULT_HLOD_SWITCH_SCREEN_SIZE };
+    /// Cluster bounding box in node space.
+    BoundingBox localBoundingBox_;
+    /// Proxy and member drawables.
+    ea::vector<WeakPtr<Drawable>> drawables_;
+    /// Enclosing cluster.
+    WeakPtr<HierarchicalLodGroup> parentGroup_;
+};
+
+}
@@ -28,6 +28,7 @@
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Light.h"
+#include "../Graphics/Octree.h"
 #include "../Graphics/OctreeQuery.h"
 #include "../Graphics/Texture2D.h"
 #include "../Graphics/TextureCube.h"
@@ -475,6 +476,31 @@ Frustum Light::GetViewSpaceFrustum(const Matrix3x4& view) const
     return ret;
 }
 
+const ea::vector<Drawable*>& Light::GetVolumeDrawables(Octree* octree, unsigned frameNumber, unsigned viewMask)
+{
+    if (octree != volumeDrawablesOctree_ || frameNumber != volumeDrawablesFrameNumber_ || viewMask != volumeDrawablesViewMask_)
+    {
+        volumeDrawablesOctree_ = octree;
+        volumeDrawablesFrameNumber_ = frameNumber;
+        volumeDrawablesViewMask_ = viewMask;
+
+        if (lightType_ == LIGHT_SPOT)
+        {
+            FrustumOctreeQuery query(volumeDrawables_, GetFrustum(), DRAWABLE_GEOMETRY, viewMask);
+            octree->GetDrawables(query);
+        }
+        else if (lightType_ == LIGHT_POINT)
+        {
+            SphereOctreeQuery query(volumeDrawables_, Sphere(node_->GetWorldPosition(), range_), DRAWABLE_GEOMETRY, viewMask);
+            octree->GetDrawables(query);
+        }
+        else
+            volumeDrawables_.clear();
+    }
+
+    return volumeDrawables_;
+}
+
 int Light::GetNumShadowSplits() const
 {
     unsigned ret = 1;
@@ -33,6 +33,7 @@ namespace Urho3D
 {
 
 class Camera;
+class Octree;
 struct LightBatchQueue;
 
 /// %Light baking mode.
@@ -353,6 +354,8 @@ public:
 
     /// Return light queue. Called by View.
     LightBatchQueue* GetLightQueue() const { return lightQueue_; }
+    /// Return geometries inside the spot or point light volume. The octree query is cached for the frame, so that views sharing a scene and view mask query each light only once. Called by View.
+    const ea::vector<Drawable*>& GetVolumeDrawables(Octree* octree, unsigned frameNumber, unsigned viewMask);
 
     /// Return a divisor value based on intensity for calculating the sort value.
     float GetIntensityDivisor(float attenuation = 1.0f) const
@@ -409,6 +412,14 @@ private:
     SharedPtr<Texture> shapeTexture_;
     /// Light queue.
     LightBatchQueue* lightQueue_;
+    /// Cached geometries inside the light volume.
+    ea::vector<Drawable*> volumeDrawables_;
+    /// Octree the light volume drawables were queried from.
+    Octree* volumeDrawablesOctree_{};
+    /// Frame number the light volume drawables were queried on.
+    unsigned volumeDrawablesFrameNumber_{M_MAX_UNSIGNED};
+    /// View mask the light volume drawables were queried with.
+    unsigned volumeDrawablesViewMask_{};
     /// Specular intensity.
     float specularIntensity_;
     /// Brightness multiplier.
@@ -113,12 +113,17 @@ void LightBaker::RegisterObject(Context* context)
     URHO3D_ATTRIBUTE("Direct Samples (Light Probes)", unsigned, settings_.directProbesTracing_.maxSamples_, defaultSettings.directProbesTracing_.maxSamples_, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Indirect Bounces", unsigned, settings_.indirectChartTracing_.maxBounces_, defaultSettings.indirectChartTracing_.maxBounces_, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Indirect Samples (Texture)", unsigned, settings_.indirectChartTracing_.maxSamples_, defaultSettings.indirectChartTracing_.maxSamples_, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Indirect Error Target (Texture)", float, settings_.indirectChartTracing_.maxRelativeError_, defaultSettings.indirectChartTracing_.maxRelativeError_, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Indirect Samples (Light Probes)", unsigned, settings_.indirectProbesTracing_.maxSamples_, defaultSettings.indirectProbesTracing_.maxSamples_, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Filter Radius (Direct)", unsigned, settings_.directFilter_.kernelRadius_, defaultSettings.directFilter_.kernelRadius_, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Filter Radius (Indirect)", unsigned, settings_.indirectFilter_.kernelRadius_, defaultSettings.indirectFilter_.kernelRadius_, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Filter Passes (Direct)", unsigned, settings_.directFilter_.numPasses_, defaultSettings.directFilter_.numPasses_, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Filter Passes (Indirect)", unsigned, settings_.indirectFilter_.numPasses_, defaultSettings.indirectFilter_.numPasses_, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Chunk Size", Vector3, settings_.incremental_.chunkSize_, defaultSettings.incremental_.chunkSize_, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Chunk Indirect Padding", float, settings_.incremental_.indirectPadding_, defaultSettings.incremental_.indirectPadding_, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Chunk Shadow Distance", float, settings_.incremental_.directionalLightShadowDistance_, defaultSettings.incremental_.directionalLightShadowDistance_, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Compress Lightmaps", bool, settings_.incremental_.compressLightmaps_, defaultSettings.incremental_.compressLightmaps_, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Persistent Cache", bool, settings_.incremental_.persistentCache_, defaultSettings.incremental_.persistentCache_, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Stitch Iterations", unsigned, settings_.stitching_.numIterations_, defaultSettings.stitching_.numIterations_, AM_DEFAULT);
 }
 
@@ -124,6 +124,11 @@ struct IndirectLightTracingSettings
     float scaledPositionBounceBias_{ 0.00002f };
     /// Constant position bias in direction of face normal after hit.
     float constPositionBounceBias_{ 0.0f };
+    /// Target relative standard error of the element light estimate. Element sampling stops once it's reached.
+    /// Zero disables adaptive sampling. Only lightmap charts are sampled adaptively.
+    float maxRelativeError_{};
+    /// Min number of samples per element before adaptive sampling may stop.
+    unsigned minAdaptiveSamples_{ 8 };
 };
 
 /// Parameters for indirect light filtering.
@@ -139,6 +144,10 @@ struct EdgeStoppingGaussFilterParameters
     float normalPower_{ 4.0f };
     /// Position weight. The lesser value is, the more color details are preserved on position edges.
     float positionSigma_{ 1.0f };
+    /// Whether to use multi-pass a-trous wavelet filter with sparse 5x5 kernel. Full Gauss kernel is used otherwise.
+    bool atrous_{ true };
+    /// Number of a-trous passes. Zero to pick the smallest number of passes covering kernel radius.
+    unsigned numPasses_{};
 };
 
 /// Lightmap stitching settings.
@@ -187,10 +196,16 @@ struct IncrementalLightBakerSettings
     /// Lightmap name format string.
     /// Placeholder 1: global lightmap index.
     ea::string lightmapNameFormat_{ "Textures/Lightmap-{}.png" };
+    /// Whether to save lightmaps as DXT1 compressed DDS images. File extension is replaced with ".dds".
+    bool compressLightmaps_{};
     /// Light probe group name format string.
     /// Placeholders 1-3: x, y and z components of chunk index.
     /// Placeholder 4: light probe group index within chunk.
     ea::string lightProbeGroupNameFormat_{ "Binary/LightProbeGroup-{}-{}-{}-{}.bin" };
+    /// Whether to keep baked light in persistent cache and re-bake only chunks whose inputs were changed.
+    bool persistentCache_{};
+    /// Persistent cache directory name, relative to output directory.
+    ea::string persistentCacheDirectory_{ "Cache/" };
 };
 
 /// Aggregated light baking settings.
@@ -223,6 +223,7 @@ void LightProbeGroup::ArrangeLightProbesInVolume()
 
     // Fill volume with probes
     const Vector3 gridStep = Vector3::ONE / static_cast<Vector3>(gridSize - IntVector3::ONE);
+    lightProbes_.reserve(gridSize.x_ * gridSize.y_ * gridSize.z_);
     IntVector3 index;
     for (index.z_ = 0; index.z_ < gridSize.z_; ++index.z_)
     {
@@ -24,6 +24,8 @@
 
 #include <EASTL/sort.h>
 
+#include <atomic>
+
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
 #include "../Core/Profiler.h"
@@ -53,6 +55,9 @@ namespace Urho3D
 
 extern const char* wrapModeNames[];
 
+/// Source of globally unique technique list versions. Zero is reserved to mean "no version".
+static std::atomic<unsigned> techniquesVersionCounter{0};
+
 TextureUnit ParseTextureUnitName(ea::string name)
 {
     name.make_lower();
@@ -160,6 +165,7 @@ void ShaderParameterAnimationInfo::ApplyValue(const Variant& newValue)
 Material::Material(Context* context) :
     Resource(context)
 {
+    UpdateTechniquesVersion();
     ResetToDefaults();
 }
 
@@ -377,6 +383,7 @@ bool Material::Load(const XMLElement& source)
 
     XMLElement techniqueElem = source.GetChild("technique");
     techniques_.clear();
+    UpdateTechniquesVersion();
 
     while (techniqueElem)
     {
@@ -530,6 +537,7 @@ bool Material::Load(const JSONValue& source)
     JSONArray techniquesArray = source.Get("techniques").GetArray();
     techniques_.clear();
     techniques_.reserve(techniquesArray.size());
+    UpdateTechniquesVersion();
 
     for (unsigned i = 0; i < techniquesArray.size(); i++)
     {
@@ -883,6 +891,7 @@ void Material::SetNumTechniques(unsigned num)
         return;
 
     techniques_.resize(num);
+    UpdateTechniquesVersion();
     RefreshMemoryUse();
 }
 
@@ -892,6 +901,7 @@ void Material::SetTechnique(unsigned index, Technique* tech, MaterialQuality qua
         return;
 
     techniques_[index] = TechniqueEntry(tech, qualityLevel, lodDistance);
+    UpdateTechniquesVersion();
     ApplyShaderDefines(index);
 }
 
@@ -1112,6 +1122,7 @@ SharedPtr<Material> Material::Clone(const ea::string& cloneName) const
 
     ret->SetName(cloneName);
     ret->techniques_ = techniques_;
+    ret->UpdateTechniquesVersion();
     ret->vertexShaderDefines_ = vertexShaderDefines_;
     ret->pixelShaderDefines_ = pixelShaderDefines_;
     ret->shaderParameters_ = shaderParameters_;
@@ -1134,6 +1145,7 @@ SharedPtr<Material> Material::Clone(const ea::string& cloneName) const
 void Material::SortTechniques()
 {
     ea::quick_sort(techniques_.begin(), techniques_.end(), CompareTechniqueEntries);
+    UpdateTechniquesVersion();
 }
 
 void Material::MarkForAuxView(unsigned frameNumber)
@@ -1309,6 +1321,9 @@ void Material::HandleAttributeAnimationUpdate(StringHash eventType, VariantMap&
     // Keep weak pointer to self to check for destruction caused by event handling
     WeakPtr<Object> self(this);
 
+    // Refresh parameter hash and memory use once for all animated parameters
+    batchedParameterUpdate_ = true;
+
     ea::vector<ea::string> finishedNames;
     for (auto i = shaderParameterAnimationInfos_.begin();
          i != shaderParameterAnimationInfos_.end(); ++i)
@@ -1322,6 +1337,10 @@ void Material::HandleAttributeAnimationUpdate(StringHash eventType, VariantMap&
             finishedNames.push_back(i->second->GetName());
     }
 
+    batchedParameterUpdate_ = false;
+    RefreshShaderParameterHash();
+    RefreshMemoryUse();
+
     // Remove finished animations
     for (unsigned i = 0; i < finishedNames.size(); ++i)
         SetShaderParameterAnimation(finishedNames[i], nullptr);
@@ -1343,6 +1362,15 @@ void Material::ApplyShaderDefines(unsigned index)
         techniques_[index].technique_ = techniques_[index].original_;
     else
         techniques_[index].technique_ = techniques_[index].original_->CloneWithDefines(vertexShaderDefines_, pixelShaderDefines_);
+    UpdateTechniquesVersion();
+}
+
+void Material::UpdateTechniquesVersion()
+{
+    techniquesVersion_ = ++techniquesVersionCounter;
+    // Skip the reserved zero value on wraparound
+    if (!techniquesVersion_)
+        techniquesVersion_ = ++techniquesVersionCounter;
 }
 
 }
@@ -239,6 +239,8 @@ public:
 
     /// Return all techniques.
     const ea::vector<TechniqueEntry>& GetTechniques() const { return techniques_; }
+    /// Return technique list version. Globally unique and changes whenever the technique list is modified; never zero.
+    unsigned GetTechniquesVersion() const { return techniquesVersion_; }
 
     /// Return technique entry by index.
     const TechniqueEntry& GetTechniqueEntry(unsigned index) const;
@@ -327,6 +329,8 @@ private:
     void RefreshMemoryUse();
     /// Reapply shader defines to technique index. By default reapply all.
     void ApplyShaderDefines(unsigned index = M_MAX_UNSIGNED);
+    /// Assign a new technique list version, invalidating per-batch technique caches.
+    void UpdateTechniquesVersion();
     /// Return shader parameter animation info.
     ShaderParameterAnimationInfo* GetShaderParameterAnimationInfo(const ea::string& name) const;
     /// Update whether should be subscribed to scene or global update events for shader parameter animation.
@@ -360,6 +364,8 @@ private:
     unsigned auxViewFrameNumber_{};
     /// Shader parameter hash value.
     unsigned shaderParameterHash_{};
+    /// Technique list version.
+    unsigned techniquesVersion_{};
     /// Alpha-to-coverage flag.
     bool alphaToCoverage_{};
     /// Line antialiasing flag.
@@ -0,0 +1,602 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Graphics/MeshOptimizer.h"
+
+#include <EASTL/sort.h>
+#include <EASTL/unordered_map.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Size of vertex cache used for triangle reordering.
+static const unsigned VertexCacheSize = 32;
+/// Size of simulated FIFO cache used to split triangles into clusters for overdraw optimization.
+static const unsigned OverdrawCacheSize = 16;
+
+/// Symmetric 4x4 error quadric.
+struct Quadric
+{
+    double a00_{}, a01_{}, a02_{}, a03_{};
+    double a11_{}, a12_{}, a13_{};
+    double a22_{}, a23_{};
+    double a33_{};
+
+    /// Construct from plane equation.
+    static Quadric FromPlane(const Vector3& normal, float d)
+    {
+        const double a = normal.x_;
+        const double b = normal.y_;
+        const double c = normal.z_;
+        Quadric q;
+        q.a00_ = a * a; q.a01_ = a * b; q.a02_ = a * c; q.a03_ = a * d;
+        q.a11_ = b * b; q.a12_ = b * c; q.a13_ = b * d;
+        q.a22_ = c * c; q.a23_ = c * d;
+        q.a33_ = static_cast<double>(d) * d;
+        return q;
+    }
+
+    /// Add quadric.
+    Quadric& operator +=(const Quadric& rhs)
+    {
+        a00_ += rhs.a00_; a01_ += rhs.a01_; a02_ += rhs.a02_; a03_ += rhs.a03_;
+        a11_ += rhs.a11_; a12_ += rhs.a12_; a13_ += rhs.a13_;
+        a22_ += rhs.a22_; a23_ += rhs.a23_;
+        a33_ += rhs.a33_;
+        return *this;
+    }
+
+    /// Return sum of squared distances from point to accumulated planes.
+    double Evaluate(const Vector3& point) const
+    {
+        const double x = point.x_;
+        const double y = point.y_;
+        const double z = point.z_;
+        return a00_ * x * x + 2.0 * a01_ * x * y + 2.0 * a02_ * x * z + 2.0 * a03_ * x
+            + a11_ * y * y + 2.0 * a12_ * y * z + 2.0 * a13_ * y
+            + a22_ * z * z + 2.0 * a23_ * z
+            + a33_;
+    }
+};
+
+/// Half-edge collapse candidate.
+struct EdgeCollapse
+{
+    /// Collapse error.
+    double cost_{};
+    /// Removed vertex.
+    unsigned from_{};
+    /// Vertex that replaces removed one.
+    unsigned to_{};
+
+    /// Compare by cost.
+    bool operator <(const EdgeCollapse& rhs) const { return cost_ < rhs.cost_; }
+};
+
+/// Return key of undirected edge.
+unsigned long long GetEdgeKey(unsigned a, unsigned b)
+{
+    return (static_cast<unsigned long long>(Min(a, b)) << 32u) | Max(a, b);
+}
+
+/// Return whether the triangle contains vertex.
+bool TriangleContains(const unsigned* triangle, unsigned vertex)
+{
+    return triangle[0] == vertex || triangle[1] == vertex || triangle[2] == vertex;
+}
+
+/// Return triangle normal scaled by double area.
+Vector3 GetTriangleNormal(const Vector3& p0, const Vector3& p1, const Vector3& p2)
+{
+    return (p1 - p0).CrossProduct(p2 - p0);
+}
+
+/// Return whether collapse keeps orientation of all remaining triangles.
+bool IsCollapseValid(const ea::vector<ModelVertex>& vertices, const ea::vector<unsigned>& indices,
+    const ea::vector<unsigned>& triangles, const ea::vector<bool>& removedTriangles, unsigned from, unsigned to)
+{
+    const Vector3 newPosition = vertices[to].GetPosition();
+    for (unsigned triangleIndex : triangles)
+    {
+        const unsigned* triangle = &indices[triangleIndex * 3];
+        if (removedTriangles[triangleIndex] || TriangleContains(triangle, to))
+            continue;
+
+        Vector3 positions[3];
+        for (unsigned k = 0; k < 3; ++k)
+            positions[k] = vertices[triangle[k]].GetPosition();
+        const Vector3 oldNormal = GetTriangleNormal(positions[0], positions[1], positions[2]);
+
+        for (unsigned k = 0; k < 3; ++k)
+        {
+            if (triangle[k] == from)
+                positions[k] = newPosition;
+        }
+        const Vector3 newNormal = GetTriangleNormal(positions[0], positions[1], positions[2]);
+
+        if (oldNormal.DotProduct(newNormal) <= 0.0f)
+            return false;
+    }
+    return true;
+}
+
+/// Return vertex score for triangle reordering.
+float GetVertexCacheScore(int cachePosition, unsigned numLiveTriangles)
+{
+    if (numLiveTriangles == 0)
+        return -1.0f;
+
+    float score = 0.0f;
+    if (cachePosition >= 0)
+    {
+        // Vertices of the last triangle are scored lower to avoid strip-like ordering
+        if (cachePosition < 3)
+            score = 0.75f;
+        else
+            score = powf(1.0f - (cachePosition - 3) / static_cast<float>(VertexCacheSize - 3), 1.5f);
+    }
+
+    // Prefer vertices with few remaining triangles
+    score += 2.0f / sqrtf(static_cast<float>(numLiveTriangles));
+    return score;
+}
+
+}
+
+GeometryLODView SimplifyGeometry(const GeometryLODView& source, const MeshSimplificationParams& params)
+{
+    const ea::vector<ModelVertex>& vertices = source.vertices_;
+    const unsigned numVertices = vertices.size();
+    const unsigned numTriangles = source.indices_.size() / 3;
+    const auto targetTriangles = static_cast<unsigned>(numTriangles * Clamp(params.targetRatio_, 0.0f, 1.0f));
+
+    GeometryLODView result;
+    result.lodDistance_ = source.lodDistance_;
+    result.vertices_ = vertices;
+    result.indices_.assign(source.indices_.begin(), source.indices_.begin() + numTriangles * 3);
+    ea::vector<unsigned>& indices = result.indices_;
+
+    // Weld vertices by position. Vertices with shared position are on attribute seams and are never removed
+    ea::vector<unsigned> positionIds(numVertices);
+    ea::vector<unsigned> positionCounts;
+    {
+        ea::unordered_map<Vector3, unsigned> positionMap;
+        for (unsigned i = 0; i < numVertices; ++i)
+        {
+            const auto insertResult = positionMap.emplace(vertices[i].GetPosition(), positionCounts.size());
+            if (insertResult.second)
+                positionCounts.push_back(0);
+            positionIds[i] = insertResult.first->second;
+            ++positionCounts[positionIds[i]];
+        }
+    }
+
+    ea::vector<bool> locked(numVertices);
+    for (unsigned i = 0; i < numVertices; ++i)
+        locked[i] = positionCounts[positionIds[i]] > 1;
+
+    // Lock vertices on non-manifold edges and optionally on open borders
+    ea::unordered_map<unsigned long long, unsigned> edgeCounts;
+    for (unsigned i = 0; i < numTriangles * 3; ++i)
+    {
+        const unsigned next = i - i % 3 + (i + 1) % 3;
+        ++edgeCounts[GetEdgeKey(positionIds[indices[i]], positionIds[indices[next]])];
+    }
+    for (unsigned i = 0; i < numTriangles * 3; ++i)
+    {
+        const unsigned next = i - i % 3 + (i + 1) % 3;
+        const unsigned count = edgeCounts[GetEdgeKey(positionIds[indices[i]], positionIds[indices[next]])];
+        if (count > 2 || (count == 1 && params.lockBorders_))
+        {
+            locked[indices[i]] = true;
+            locked[indices[next]] = true;
+        }
+    }
+
+    // Accumulate plane quadrics and vertex to triangle adjacency
+    ea::vector<Quadric> quadrics(numVertices);
+    ea::vector<ea::vector<unsigned>> vertexTriangles(numVertices);
+    BoundingBox boundingBox;
+    for (unsigned triangleIndex = 0; triangleIndex < numTriangles; ++triangleIndex)
+    {
+        const unsigned* triangle = &indices[triangleIndex * 3];
+        const Vector3 p0 = vertices[triangle[0]].GetPosition();
+        Vector3 normal = GetTriangleNormal(p0, vertices[triangle[1]].GetPosition(), vertices[triangle[2]].GetPosition());
+        const float length = normal.Length();
+        if (length > M_EPSILON)
+        {
+            normal /= length;
+            const Quadric quadric = Quadric::FromPlane(normal, -normal.DotProduct(p0));
+            for (unsigned k = 0; k < 3; ++k)
+                quadrics[triangle[k]] += quadric;
+        }
+
+        for (unsigned k = 0; k < 3; ++k)
+        {
+            vertexTriangles[triangle[k]].push_back(triangleIndex);
+            boundingBox.Merge(vertices[triangle[k]].GetPosition());
+        }
+    }
+
+    const double extentSquared = boundingBox.Defined() ? boundingBox.Size().LengthSquared() : 0.0f;
+    const double maxCost = params.maxError_ * params.maxError_ * extentSquared;
+    const double attributeScale = params.attributeWeight_ * extentSquared;
+
+    // Collapse edges in passes of cheapest non-overlapping collapses
+    ea::vector<bool> removedTriangles(numTriangles);
+    ea::vector<bool> touched(numVertices);
+    ea::vector<EdgeCollapse> collapses;
+    unsigned numLiveTriangles = numTriangles;
+    while (numLiveTriangles > targetTriangles)
+    {
+        collapses.clear();
+        for (unsigned i = 0; i < numTriangles * 3; ++i)
+        {
+            const unsigned from = indices[i];
+            if (removedTriangles[i / 3] || locked[from])
+                continue;
+
+            for (unsigned offset : { 1u, 2u })
+            {
+                const unsigned to = indices[i - i % 3 + (i + offset) % 3];
+
+                Quadric quadric = quadrics[from];
+                quadric += quadrics[to];
+                double cost = Max(quadric.Evaluate(vertices[to].GetPosition()), 0.0);
+
+                if (attributeScale > 0.0)
+                {
+                    const Vector4 normalDelta = vertices[to].normal_ - vertices[from].normal_;
+                    const Vector4 uvDelta = vertices[to].uv_[0] - vertices[from].uv_[0];
+                    cost += attributeScale * (normalDelta.DotProduct(normalDelta) + uvDelta.DotProduct(uvDelta));
+                }
+
+                collapses.push_back(EdgeCollapse{ cost, from, to });
+            }
+        }
+
+        ea::sort(collapses.begin(), collapses.end());
+        ea::fill(touched.begin(), touched.end(), false);
+
+        unsigned numCollapses = 0;
+        for (const EdgeCollapse& collapse : collapses)
+        {
+            if (collapse.cost_ > maxCost || numLiveTriangles <= targetTriangles)
+                break;
+
+            const unsigned from = collapse.from_;
+            const unsigned to = collapse.to_;
+            if (touched[from] || touched[to])
+                continue;
+
+            if (!IsCollapseValid(vertices, indices, vertexTriangles[from], removedTriangles, from, to))
+                continue;
+
+            // Neighbourhood is changed, postpone other collapses around it until the next pass
+            for (unsigned triangleIndex : vertexTriangles[from])
+            {
+                if (removedTriangles[triangleIndex])
+                    continue;
+
+                unsigned* triangle = &indices[triangleIndex * 3];
+                for (unsigned k = 0; k < 3; ++k)
+                    touched[triangle[k]] = true;
+
+                if (TriangleContains(triangle, to))
+                {
+                    removedTriangles[triangleIndex] = true;
+                    --numLiveTriangles;
+                }
+                else
+                {
+                    for (unsigned k = 0; k < 3; ++k)
+                    {
+                        if (triangle[k] == from)
+                            triangle[k] = to;
+                    }
+                    vertexTriangles[to].push_back(triangleIndex);
+                }
+            }
+
+            quadrics[to] += quadrics[from];
+            vertexTriangles[from].clear();
+            locked[from] = true;
+            ++numCollapses;
+        }
+
+        if (numCollapses == 0)
+            break;
+    }
+
+    // Remove collapsed triangles and unused vertices
+    unsigned numIndices = 0;
+    for (unsigned triangleIndex = 0; triangleIndex < numTriangles; ++triangleIndex)
+    {
+        if (removedTriangles[triangleIndex])
+            continue;
+        for (unsigned k = 0; k < 3; ++k)
+            indices[numIndices++] = indices[triangleIndex * 3 + k];
+    }
+    indices.resize(numIndices);
+    OptimizeVertexFetch(result);
+    return result;
+}
+
+void OptimizeVertexCache(ea::vector<unsigned>& indices, unsigned numVertices)
+{
+    const unsigned numTriangles = indices.size() / 3;
+    if (numTriangles == 0)
+        return;
+
+    // Build vertex to triangle adjacency. Live triangles of each vertex are kept at the front of its range
+    ea::vector<unsigned> numLiveTriangles(numVertices);
+    for (unsigned i = 0; i < numTriangles * 3; ++i)
+        ++numLiveTriangles[indices[i]];
+
+    ea::vector<unsigned> adjacencyOffsets(numVertices + 1);
+    for (unsigned vertex = 0; vertex < numVertices; ++vertex)
+        adjacencyOffsets[vertex + 1] = adjacencyOffsets[vertex] + numLiveTriangles[vertex];
+
+    ea::vector<unsigned> adjacency(numTriangles * 3);
+    {
+        ea::vector<unsigned> fillOffsets(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (unsigned i = 0; i < numTriangles * 3; ++i)
+            adjacency[fillOffsets[indices[i]]++] = i / 3;
+    }
+
+    ea::vector<int> cachePositions(numVertices, -1);
+    ea::vector<float> vertexScores(numVertices);
+    for (unsigned vertex = 0; vertex < numVertices; ++vertex)
+        vertexScores[vertex] = GetVertexCacheScore(-1, numLiveTriangles[vertex]);
+
+    ea::vector<float> triangleScores(numTriangles);
+    ea::vector<bool> emittedTriangles(numTriangles);
+    int bestTriangle = -1;
+    float bestScore = -1.0f;
+    for (unsigned triangleIndex = 0; triangleIndex < numTriangles; ++triangleIndex)
+    {
+        const unsigned* triangle = &indices[triangleIndex * 3];
+        triangleScores[triangleIndex] = vertexScores[triangle[0]] + vertexScores[triangle[1]] + vertexScores[triangle[2]];
+        if (triangleScores[triangleIndex] > bestScore)
+        {
+            bestScore = triangleScores[triangleIndex];
+            bestTriangle = static_cast<int>(triangleIndex);
+        }
+    }
+
+    ea::vector<unsigned> result;
+    result.reserve(numTriangles * 3);
+    ea::vector<unsigned> cache;
+    ea::vector<unsigned> newCache;
+    unsigned nextUnemittedTriangle = 0;
+    while (result.size() < numTriangles * 3)
+    {
+        // Fall back to the next unemitted triangle if cache holds no candidates
+        if (bestTriangle < 0)
+        {
+            while (emittedTriangles[nextUnemittedTriangle])
+                ++nextUnemittedTriangle;
+            bestTriangle = static_cast<int>(nextUnemittedTriangle);
+        }
+
+        const unsigned* triangle = &indices[bestTriangle * 3];
+        emittedTriangles[bestTriangle] = true;
+        newCache.clear();
+        for (unsigned k = 0; k < 3; ++k)
+        {
+            const unsigned vertex = triangle[k];
+            result.push_back(vertex);
+            newCache.push_back(vertex);
+
+            // Move emitted triangle out of live range
+            unsigned* begin = &adjacency[adjacencyOffsets[vertex]];
+            unsigned* end = begin + numLiveTriangles[vertex];
+            unsigned* iter = ea::find(begin, end, static_cast<unsigned>(bestTriangle));
+            if (iter != end)
+            {
+                ea::swap(*iter, *(end - 1));
+                --numLiveTriangles[vertex];
+            }
+        }
+
+        for (unsigned vertex : cache)
+        {
+            if (!TriangleContains(triangle, vertex))
+                newCache.push_back(vertex);
+        }
+
+        // Update scores of cached and evicted vertices
+        for (unsigned i = 0; i < newCache.size(); ++i)
+        {
+            const unsigned vertex = newCache[i];
+            cachePositions[vertex] = i < VertexCacheSize ? static_cast<int>(i) : -1;
+            vertexScores[vertex] = GetVertexCacheScore(cachePositions[vertex], numLiveTriangles[vertex]);
+        }
+
+        bestTriangle = -1;
+        bestScore = -1.0f;
+        for (unsigned vertex : newCache)
+        {
+            const unsigned begin = adjacencyOffsets[vertex];
+            for (unsigned i = begin; i < begin + numLiveTriangles[vertex]; ++i)
+            {
+                const unsigned triangleIndex = adjacency[i];
+                const unsigned* adjacentTriangle = &indices[triangleIndex * 3];
+                const float score = vertexScores[adjacentTriangle[0]] + vertexScores[adjacentTriangle[1]]
+                    + vertexScores[adjacentTriangle[2]];
+                triangleScores[triangleIndex] = score;
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    bestTriangle = static_cast<int>(triangleIndex);
+                }
+            }
+        }
+
+        if (newCache.size() > VertexCacheSize)
+            newCache.resize(VertexCacheSize);
+        ea::swap(cache, newCache);
+    }
+
+    indices = ea::move(result);
+}
+
+void OptimizeOverdraw(ea::vector<unsigned>& indices, const ea::vector<ModelVertex>& vertices)
+{
+    const unsigned numTriangles = indices.size() / 3;
+    if (numTriangles < 2)
+        return;
+
+    // Split triangles into clusters where all vertices miss the simulated cache
+    ea::vector<unsigned> clusterStarts;
+    ea::vector<unsigned> cacheTimestamps(vertices.size());
+    unsigned timestamp = OverdrawCacheSize + 1;
+    for (unsigned triangleIndex = 0; triangleIndex < numTriangles; ++triangleIndex)
+    {
+        unsigned numMisses = 0;
+        for (unsigned k = 0; k < 3; ++k)
+        {
+            const unsigned vertex = indices[triangleIndex * 3 + k];
+            if (timestamp - cacheTimestamps[vertex] > OverdrawCacheSize)
+            {
+                cacheTimestamps[vertex] = timestamp++;
+                ++numMisses;
+            }
+        }
+        if (triangleIndex == 0 || numMisses == 3)
+            clusterStarts.push_back(triangleIndex);
+    }
+
+    const unsigned numClusters = clusterStarts.size();
+    if (numClusters < 2)
+        return;
+    clusterStarts.push_back(numTriangles);
+
+    // Calculate mesh centroid and cluster sort keys
+    Vector3 meshCenter;
+    float meshArea = 0.0f;
+    ea::vector<Vector3> clusterCenters(numClusters);
+    ea::vector<Vector3> clusterNormals(numClusters);
+    for (unsigned clusterIndex = 0; clusterIndex < numClusters; ++clusterIndex)
+    {
+        float clusterArea = 0.0f;
+        for (unsigned triangleIndex = clusterStarts[clusterIndex]; triangleIndex < clusterStarts[clusterIndex + 1]; ++triangleIndex)
+        {
+            const Vector3 p0 = vertices[indices[triangleIndex * 3]].GetPosition();
+            const Vector3 p1 = vertices[indices[triangleIndex * 3 + 1]].GetPosition();
+            const Vector3 p2 = vertices[indices[triangleIndex * 3 + 2]].GetPosition();
+            const Vector3 normal = GetTriangleNormal(p0, p1, p2);
+            const float area = normal.Length();
+            const Vector3 center = (p0 + p1 + p2) / 3.0f;
+
+            clusterCenters[clusterIndex] += center * area;
+            clusterNormals[clusterIndex] += normal;
+            clusterArea += area;
+            meshCenter += center * area;
+            meshArea += area;
+        }
+        if (clusterArea > M_EPSILON)
+            clusterCenters[clusterIndex] /= clusterArea;
+    }
+    if (meshArea > M_EPSILON)
+        meshCenter /= meshArea;
+
+    ea::vector<ea::pair<float, unsigned>> clusterOrder(numClusters);
+    for (unsigned clusterIndex = 0; clusterIndex < numClusters; ++clusterIndex)
+    {
+        const float key = (clusterCenters[clusterIndex] - meshCenter).DotProduct(clusterNormals[clusterIndex].Normalized());
+        clusterOrder[clusterIndex] = { -key, clusterIndex };
+    }
+
+    // Draw outward-facing clusters first
+    ea::stable_sort(clusterOrder.begin(), clusterOrder.end(),
+        [](const ea::pair<float, unsigned>& lhs, const ea::pair<float, unsigned>& rhs) { return lhs.first < rhs.first; });
+
+    ea::vector<unsigned> result;
+    result.reserve(indices.size());
+    for (const auto& item : clusterOrder)
+    {
+        const unsigned clusterIndex = item.second;
+        result.insert(result.end(), indices.begin() + clusterStarts[clusterIndex] * 3,
+            indices.begin() + clusterStarts[clusterIndex + 1] * 3);
+    }
+    indices = ea::move(result);
+}
+
+void OptimizeVertexFetch(GeometryLODView& geometry)
+{
+    ea::vector<unsigned> remap(geometry.vertices_.size(), M_MAX_UNSIGNED);
+    ea::vector<ModelVertex> vertices;
+    vertices.reserve(geometry.vertices_.size());
+    for (unsigned& index : geometry.indices_)
+    {
+        if (remap[index] == M_MAX_UNSIGNED)
+        {
+            remap[index] = vertices.size();
+            vertices.push_back(geometry.vertices_[index]);
+        }
+        index = remap[index];
+    }
+    geometry.vertices_ = ea::move(vertices);
+}
+
+void OptimizeGeometry(GeometryLODView& geometry)
+{
+    OptimizeVertexCache(geometry.indices_, geometry.vertices_.size());
+    OptimizeOverdraw(geometry.indices_, geometry.vertices_);
+    OptimizeVertexFetch(geometry);
+}
+
+unsigned GenerateModelLods(ModelView& model, const ModelLodGenerationParams& params)
+{
+    unsigned numGeneratedLods = 0;
+    for (GeometryView& geometry : model.GetGeometries())
+    {
+        // Keep authored LODs
+        if (geometry.lods_.size() != 1)
+            continue;
+
+        OptimizeGeometry(geometry.lods_[0]);
+        for (unsigned lodIndex = 1; lodIndex < params.numLods_; ++lodIndex)
+        {
+            GeometryLODView lod = SimplifyGeometry(geometry.lods_.back(), params.simplification_);
+            if (lod.indices_.empty() || lod.indices_.size() >= geometry.lods_.back().indices_.size())
+                break;
+
+            OptimizeGeometry(lod);
+            lod.lodDistance_ = params.lodDistanceStep_ * lodIndex;
+            geometry.lods_.push_back(ea::move(lod));
+            ++numGeneratedLods;
+        }
+    }
+    return numGeneratedLods;
+}
+
+}
@@ -0,0 +1,70 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+/// \file
+
+#pragma once
+
+#include "../Graphics/ModelView.h"
+
+namespace Urho3D
+{
+
+/// Mesh simplification parameters.
+struct MeshSimplificationParams
+{
+    /// Ratio of triangles to keep.
+    float targetRatio_{ 0.5f };
+    /// Max collapse error relative to mesh extent. Simplification stops early when exceeded.
+    float maxError_{ 0.05f };
+    /// Weight of normal and UV deviation in collapse error. Zero to simplify by geometry only.
+    float attributeWeight_{ 1.0f };
+    /// Whether to keep vertices on open mesh borders in place.
+    bool lockBorders_{ true };
+};
+
+/// Automatic LOD generation parameters.
+struct ModelLodGenerationParams
+{
+    /// Total number of LOD levels including the original geometry.
+    unsigned numLods_{ 1 };
+    /// LOD distance of each generated level is its index multiplied by this value.
+    float lodDistanceStep_{ 20.0f };
+    /// Simplification applied between consecutive levels.
+    MeshSimplificationParams simplification_;
+};
+
+/// Simplify geometry using quadric error metrics. Vertices on UV and normal seams are never moved.
+URHO3D_API GeometryLODView SimplifyGeometry(const GeometryLODView& source, const MeshSimplificationParams& params);
+/// Reorder triangles for post-transform vertex cache efficiency.
+URHO3D_API void OptimizeVertexCache(ea::vector<unsigned>& indices, unsigned numVertices);
+/// Reorder clusters of cache-optimized triangles so outward-facing clusters are drawn first, reducing overdraw.
+URHO3D_API void OptimizeOverdraw(ea::vector<unsigned>& indices, const ea::vector<ModelVertex>& vertices);
+/// Reorder vertices in order of first use and remove unused vertices.
+URHO3D_API void OptimizeVertexFetch(GeometryLODView& geometry);
+/// Optimize geometry for vertex cache, overdraw and vertex fetch.
+URHO3D_API void OptimizeGeometry(GeometryLODView& geometry);
+/// Generate LOD levels for geometries that have only one level. Return number of generated levels.
+URHO3D_API unsigned GenerateModelLods(ModelView& model, const ModelLodGenerationParams& params);
+
+}
@@ -29,6 +29,7 @@
 #include "../Graphics/Model.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/VertexBuffer.h"
+#include "../IO/Compression.h"
 #include "../IO/Log.h"
 #include "../IO/File.h"
 #include "../IO/FileSystem.h"
@@ -60,6 +61,104 @@ unsigned LookupIndexBuffer(IndexBuffer* buffer, const ea::vector<SharedPtr<Index
     return 0;
 }
 
+/// Read index value of given size.
+unsigned ReadIndex(const unsigned char* data, unsigned indexSize)
+{
+    if (indexSize == sizeof(unsigned short))
+    {
+        unsigned short value;
+        memcpy(&value, data, sizeof(value));
+        return value;
+    }
+    unsigned value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+/// Write index value of given size.
+void WriteIndex(unsigned char* data, unsigned indexSize, unsigned value)
+{
+    if (indexSize == sizeof(unsigned short))
+    {
+        const auto shortValue = static_cast<unsigned short>(value);
+        memcpy(data, &shortValue, sizeof(shortValue));
+    }
+    else
+        memcpy(data, &value, sizeof(value));
+}
+
+/// Write vertex or index data. Compressed data is delta-encoded against the previous element and split into byte
+/// planes before LZ4 compression, which makes similar neighbouring vertices and indices compress well.
+void WriteStreamData(Serializer& dest, const unsigned char* data, unsigned elementSize, unsigned count, bool isIndex, bool compressed)
+{
+    const unsigned dataSize = elementSize * count;
+    if (!compressed)
+    {
+        dest.Write(data, dataSize);
+        return;
+    }
+
+    ea::vector<unsigned char> encoded(dataSize);
+    for (unsigned i = 0; i < count; ++i)
+    {
+        const unsigned char* element = data + i * elementSize;
+        if (isIndex)
+        {
+            const unsigned previous = i > 0 ? ReadIndex(element - elementSize, elementSize) : 0;
+            unsigned char delta[sizeof(unsigned)];
+            WriteIndex(delta, elementSize, ReadIndex(element, elementSize) - previous);
+            for (unsigned j = 0; j < elementSize; ++j)
+                encoded[j * count + i] = delta[j];
+        }
+        else
+        {
+            for (unsigned j = 0; j < elementSize; ++j)
+                encoded[j * count + i] = element[j] - (i > 0 ? element[j - elementSize] : 0);
+        }
+    }
+
+    ea::vector<unsigned char> compressedData(EstimateCompressBound(dataSize));
+    const unsigned compressedSize = CompressData(compressedData.data(), encoded.data(), dataSize);
+    dest.WriteUInt(compressedSize);
+    dest.Write(compressedData.data(), compressedSize);
+}
+
+/// Read vertex or index data written by WriteStreamData().
+bool ReadStreamData(Deserializer& source, unsigned char* data, unsigned elementSize, unsigned count, bool isIndex, bool compressed)
+{
+    const unsigned dataSize = elementSize * count;
+    if (!compressed)
+        return source.Read(data, dataSize) == dataSize;
+
+    const unsigned compressedSize = source.ReadUInt();
+    ea::vector<unsigned char> compressedData(compressedSize);
+    if (source.Read(compressedData.data(), compressedSize) != compressedSize)
+        return false;
+
+    ea::vector<unsigned char> encoded(dataSize);
+    if (DecompressData(encoded.data(), compressedData.data(), compressedSize, dataSize) != dataSize)
+        return false;
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        unsigned char* element = data + i * elementSize;
+        if (isIndex)
+        {
+            unsigned char delta[sizeof(unsigned)];
+            for (unsigned j = 0; j < elementSize; ++j)
+                delta[j] = encoded[j * count + i];
+            const unsigned previous = i > 0 ? ReadIndex(element - elementSize, elementSize) : 0;
+            WriteIndex(element, elementSize, previous + ReadIndex(delta, elementSize));
+        }
+        else
+        {
+            for (unsigned j = 0; j < elementSize; ++j)
+                element[j] = encoded[j * count + i] + (i > 0 ? element[j - elementSize] : 0);
+        }
+    }
+    return true;
+}
+
 Model::Model(Context* context) :
     ResourceWithMetadata(context)
 {
@@ -76,13 +175,14 @@ bool Model::BeginLoad(Deserializer& source)
 {
     // Check ID
     ea::string fileID = source.ReadFileID();
-    if (fileID != "UMDL" && fileID != "UMD2")
+    if (fileID != "UMDL" && fileID != "UMD2" && fileID != "UMD3")
     {
         URHO3D_LOGERROR(source.GetName() + " is not a valid model file");
         return false;
     }
 
-    bool hasVertexDeclarations = (fileID == "UMD2");
+    bool hasVertexDeclarations = (fileID != "UMDL");
+    compressedStreams_ = (fileID == "UMD3");
 
     geometries_.clear();
     geometryBoneMappings_.clear();
@@ -135,7 +235,11 @@ bool Model::BeginLoad(Deserializer& source)
         if (async)
         {
             desc.data_ = new unsigned char[desc.dataSize_];
-            source.Read(desc.data_.get(), desc.dataSize_);
+            if (!ReadStreamData(source, desc.data_.get(), vertexSize, desc.vertexCount_, false, compressedStreams_))
+            {
+                URHO3D_LOGERROR("Failed to read vertex data of " + source.GetName());
+                return false;
+            }
         }
         else
         {
@@ -144,8 +248,14 @@ bool Model::BeginLoad(Deserializer& source)
             buffer->SetShadowed(true);
             buffer->SetSize(desc.vertexCount_, desc.vertexElements_);
             void* dest = buffer->Lock(0, desc.vertexCount_);
-            source.Read(dest, desc.vertexCount_ * vertexSize);
+            const bool success = ReadStreamData(source, static_cast<unsigned char*>(dest), vertexSize, desc.vertexCount_,
+                false, compressedStreams_);
             buffer->Unlock();
+            if (!success)
+            {
+                URHO3D_LOGERROR("Failed to read vertex data of " + source.GetName());
+                return false;
+            }
         }
 
         memoryUse += sizeof(VertexBuffer) + desc.vertexCount_ * vertexSize;
@@ -170,7 +280,11 @@ bool Model::BeginLoad(Deserializer& source)
             loadIBData_[i].indexSize_ = indexSize;
             loadIBData_[i].dataSize_ = indexCount * indexSize;
             loadIBData_[i].data_ = new unsigned char[loadIBData_[i].dataSize_];
-            source.Read(loadIBData_[i].data_.get(), loadIBData_[i].dataSize_);
+            if (!ReadStreamData(source, loadIBData_[i].data_.get(), indexSize, indexCount, true, compressedStreams_))
+            {
+                URHO3D_LOGERROR("Failed to read index data of " + source.GetName());
+                return false;
+            }
         }
         else
         {
@@ -179,8 +293,14 @@ bool Model::BeginLoad(Deserializer& source)
             buffer->SetShadowed(true);
             buffer->SetSize(indexCount, indexSize > sizeof(unsigned short));
             void* dest = buffer->Lock(0, indexCount);
-            source.Read(dest, indexCount * indexSize);
+            const bool success = ReadStreamData(source, static_cast<unsigned char*>(dest), indexSize, indexCount,
+                true, compressedStreams_);
             buffer->Unlock();
+            if (!success)
+            {
+                URHO3D_LOGERROR("Failed to read index data of " + source.GetName());
+                return false;
+            }
         }
 
         memoryUse += sizeof(IndexBuffer) + indexCount * indexSize;
@@ -368,7 +488,7 @@ bool Model::EndLoad()
 bool Model::Save(Serializer& dest) const
 {
     // Write ID
-    if (!dest.WriteFileID("UMD2"))
+    if (!dest.WriteFileID(compressedStreams_ ? "UMD3" : "UMD2"))
         return false;
 
     // Write vertex buffers
@@ -388,7 +508,7 @@ bool Model::Save(Serializer& dest) const
         }
         dest.WriteUInt(morphRangeStarts_[i]);
         dest.WriteUInt(morphRangeCounts_[i]);
-        dest.Write(buffer->GetShadowData(), buffer->GetVertexCount() * buffer->GetVertexSize());
+        WriteStreamData(dest, buffer->GetShadowData(), buffer->GetVertexSize(), buffer->GetVertexCount(), false, compressedStreams_);
     }
     // Write index buffers
     dest.WriteUInt(indexBuffers_.size());
@@ -397,7 +517,7 @@ bool Model::Save(Serializer& dest) const
         IndexBuffer* buffer = indexBuffers_[i];
         dest.WriteUInt(buffer->GetIndexCount());
         dest.WriteUInt(buffer->GetIndexSize());
-        dest.Write(buffer->GetShadowData(), buffer->GetIndexCount() * buffer->GetIndexSize());
+        WriteStreamData(dest, buffer->GetShadowData(), buffer->GetIndexSize(), buffer->GetIndexCount(), true, compressedStreams_);
     }
     // Write geometries
     dest.WriteUInt(geometries_.size());
@@ -620,6 +740,7 @@ SharedPtr<Model> Model::Clone(const ea::string& cloneName) const
 
     ret->SetName(cloneName);
     ret->boundingBox_ = boundingBox_;
+    ret->compressedStreams_ = compressedStreams_;
     ret->skeleton_ = skeleton_;
     ret->geometryBoneMappings_ = geometryBoneMappings_;
     ret->geometryCenters_ = geometryCenters_;
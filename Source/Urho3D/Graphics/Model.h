@@ -158,6 +158,8 @@ public:
     void SetGeometryBoneMappings(const ea::vector<ea::vector<unsigned> >& geometryBoneMappings);
     /// Set vertex morphs.
     void SetMorphs(const ea::vector<ModelMorph>& morphs);
+    /// Set whether to save vertex and index data compressed.
+    void SetCompressedStreams(bool enable) { compressedStreams_ = enable; }
     /// Clone the model. The geometry data is deep-copied and can be modified in the clone without affecting the original.
     SharedPtr<Model> Clone(const ea::string& cloneName = EMPTY_STRING) const;
 
@@ -197,6 +199,8 @@ public:
     /// Return geometery bone mappings.
     const ea::vector<ea::vector<unsigned> >& GetGeometryBoneMappings() const { return geometryBoneMappings_; }
 
+    /// Return whether vertex and index data is saved compressed.
+    bool GetCompressedStreams() const { return compressedStreams_; }
     /// Return vertex morphs.
     const ea::vector<ModelMorph>& GetMorphs() const { return morphs_; }
 
@@ -241,6 +245,8 @@ private:
     ea::vector<IndexBufferDesc> loadIBData_;
     /// Geometry definitions for asynchronous loading.
     ea::vector<ea::vector<GeometryDesc> > loadGeometries_;
+    /// Whether vertex and index data is saved compressed.
+    bool compressedStreams_{};
 };
 
 }
@@ -29,6 +29,10 @@
 #include "../Graphics/OcclusionBuffer.h"
 #include "../IO/Log.h"
 
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#endif
+
 #include "../DebugNew.h"
 
 namespace Urho3D
@@ -45,12 +49,54 @@ enum ClipMask : unsigned
 };
 URHO3D_FLAGSET(ClipMask, ClipMaskFlags);
 
-void DrawOcclusionBatchWork(const WorkItem* item, unsigned threadIndex)
+namespace
+{
+
+#ifdef URHO3D_SSE
+/// Return per-component minimum of signed integers. SSE2 has no direct instruction for it.
+inline __m128i MinInt(__m128i a, __m128i b)
+{
+    const __m128i mask = _mm_cmplt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+/// Return per-component maximum of signed integers.
+inline __m128i MaxInt(__m128i a, __m128i b)
+{
+    const __m128i mask = _mm_cmpgt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+#endif
+
+/// Write interpolated depth to a horizontal span of pixels where it is closer than existing depth.
+inline void DrawSpan(int* dest, int* end, int invZ, int dInvZdX)
 {
-    URHO3D_PROFILE("DrawOcclusionBatchWork");
-    auto* buffer = reinterpret_cast<OcclusionBuffer*>(item->aux_);
-    OcclusionBatch& batch = *reinterpret_cast<OcclusionBatch*>(item->start_);
-    buffer->DrawBatch(batch, threadIndex);
+#ifdef URHO3D_SSE
+    if (end - dest >= 4)
+    {
+        __m128i depth = _mm_set_epi32(invZ + 3 * dInvZdX, invZ + 2 * dInvZdX, invZ + dInvZdX, invZ);
+        const __m128i step4 = _mm_set1_epi32(dInvZdX * 4);
+
+        while (end - dest >= 4)
+        {
+            auto* ptr = reinterpret_cast<__m128i*>(dest);
+            _mm_storeu_si128(ptr, MinInt(depth, _mm_loadu_si128(ptr)));
+            depth = _mm_add_epi32(depth, step4);
+            invZ += dInvZdX * 4;
+            dest += 4;
+        }
+    }
+#endif
+
+    while (dest < end)
+    {
+        if (invZ < *dest)
+            *dest = invZ;
+        invZ += dInvZdX;
+        ++dest;
+    }
+}
+
 }
 
 OcclusionBuffer::OcclusionBuffer(Context* context) :
@@ -85,6 +131,7 @@ bool OcclusionBuffer::SetSize(int width, int height, bool threaded)
 
     width_ = width;
     height_ = height;
+    contentValid_ = false;
 
     // Build work buffers for threading
     unsigned numThreadBuffers = threaded ? GetSubsystem<WorkQueue>()->GetNumThreads() + 1 : 1;
@@ -166,6 +213,7 @@ void OcclusionBuffer::Clear()
         buffers_[i].used_ = false;
 
     depthHierarchyDirty_ = true;
+    contentValid_ = false;
 }
 
 bool OcclusionBuffer::AddTriangles(const Matrix3x4& model, const void* vertexData, unsigned vertexSize, unsigned vertexStart,
@@ -219,15 +267,12 @@ void OcclusionBuffer::DrawTriangles()
         // Threaded
         auto* queue = GetSubsystem<WorkQueue>();
 
-        for (auto i = batches_.begin(); i != batches_.end(); ++i)
+        queue->ParallelFor(batches_.size(), 1, [this](unsigned begin, unsigned end, unsigned threadIndex)
         {
-            SharedPtr<WorkItem> item = queue->GetFreeItem();
-            item->priority_ = M_MAX_UNSIGNED;
-            item->workFunction_ = DrawOcclusionBatchWork;
-            item->aux_ = this;
-            item->start_ = &(*i);
-            queue->AddWorkItem(item);
-        }
+            URHO3D_PROFILE("DrawOcclusionBatchWork");
+            for (unsigned i = begin; i < end; ++i)
+                DrawBatch(batches_[i], threadIndex);
+        });
 
         queue->Complete(M_MAX_UNSIGNED);
 
@@ -259,6 +304,25 @@ void OcclusionBuffer::BuildDepthHierarchy()
             if (y * 2 + 1 < height_)
             {
                 int* src2 = src + width_;
+#ifdef URHO3D_SSE
+                // Each 4 source pixels of both rows produce 2 destination min/max pairs
+                const __m128i evenMask = _mm_set_epi32(0, -1, 0, -1);
+                while (end - dest >= 2)
+                {
+                    const __m128i upper = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+                    const __m128i lower = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src2));
+                    __m128i minValue = MinInt(upper, lower);
+                    __m128i maxValue = MaxInt(upper, lower);
+                    minValue = MinInt(minValue, _mm_shuffle_epi32(minValue, _MM_SHUFFLE(2, 3, 0, 1)));
+                    maxValue = MaxInt(maxValue, _mm_shuffle_epi32(maxValue, _MM_SHUFFLE(2, 3, 0, 1)));
+                    const __m128i result = _mm_or_si128(_mm_and_si128(evenMask, minValue), _mm_andnot_si128(evenMask, maxValue));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), result);
+
+                    src += 4;
+                    src2 += 4;
+                    dest += 2;
+                }
+#endif
                 while (dest < end)
                 {
                     int minUpper = Min(src[0], src[1]);
@@ -304,6 +368,25 @@ void OcclusionBuffer::BuildDepthHierarchy()
             if (y * 2 + 1 < prevHeight)
             {
                 DepthValue* src2 = src + prevWidth;
+#ifdef URHO3D_SSE
+                // Source min/max pairs are merged vertically first, then the two horizontal neighbours
+                const __m128i evenMask = _mm_set_epi32(0, -1, 0, -1);
+                while (dest < end)
+                {
+                    const __m128i upper = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+                    const __m128i lower = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src2));
+                    __m128i minValue = MinInt(upper, lower);
+                    __m128i maxValue = MaxInt(upper, lower);
+                    minValue = MinInt(minValue, _mm_shuffle_epi32(minValue, _MM_SHUFFLE(1, 0, 3, 2)));
+                    maxValue = MaxInt(maxValue, _mm_shuffle_epi32(maxValue, _MM_SHUFFLE(1, 0, 3, 2)));
+                    const __m128i result = _mm_or_si128(_mm_and_si128(evenMask, minValue), _mm_andnot_si128(evenMask, maxValue));
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(dest), result);
+
+                    src += 2;
+                    src2 += 2;
+                    ++dest;
+                }
+#endif
                 while (dest < end)
                 {
                     int minUpper = Min(src[0].min_, src[1].min_);
@@ -340,6 +423,13 @@ void OcclusionBuffer::ResetUseTimer()
     useTimer_.Reset();
 }
 
+void OcclusionBuffer::SetContentHash(unsigned occludersHash)
+{
+    contentValid_ = true;
+    contentHash_ = occludersHash;
+    contentViewProj_ = viewProj_;
+}
+
 bool OcclusionBuffer::IsVisible(const BoundingBox& worldSpaceBox) const
 {
     if (buffers_.empty())
@@ -908,16 +998,7 @@ void OcclusionBuffer::DrawTriangle2D(const Vector3* vertices, bool clockwise, un
             int* endRow = bufferData + middleY * width_;
             while (row < endRow)
             {
-                int invZ = topToBottom.invZ_;
-                int* dest = row + (topToBottom.x_ >> 16u);
-                int* end = row + (topToMiddle.x_ >> 16u);
-                while (dest < end)
-                {
-                    if (invZ < *dest)
-                        *dest = invZ;
-                    invZ += gradients.dInvZdXInt_;
-                    ++dest;
-                }
+                DrawSpan(row + (topToBottom.x_ >> 16u), row + (topToMiddle.x_ >> 16u), topToBottom.invZ_, gradients.dInvZdXInt_);
 
                 topToBottom.x_ += topToBottom.xStep_;
                 topToBottom.invZ_ += topToBottom.invZStep_;
@@ -934,16 +1015,7 @@ void OcclusionBuffer::DrawTriangle2D(const Vector3* vertices, bool clockwise, un
             int* endRow = bufferData + bottomY * width_;
             while (row < endRow)
             {
-                int invZ = topToBottom.invZ_;
-                int* dest = row + (topToBottom.x_ >> 16u);
-                int* end = row + (middleToBottom.x_ >> 16u);
-                while (dest < end)
-                {
-                    if (invZ < *dest)
-                        *dest = invZ;
-                    invZ += gradients.dInvZdXInt_;
-                    ++dest;
-                }
+                DrawSpan(row + (topToBottom.x_ >> 16u), row + (middleToBottom.x_ >> 16u), topToBottom.invZ_, gradients.dInvZdXInt_);
 
                 topToBottom.x_ += topToBottom.xStep_;
                 topToBottom.invZ_ += topToBottom.invZStep_;
@@ -962,16 +1034,7 @@ void OcclusionBuffer::DrawTriangle2D(const Vector3* vertices, bool clockwise, un
             int* endRow = bufferData + middleY * width_;
             while (row < endRow)
             {
-                int invZ = topToMiddle.invZ_;
-                int* dest = row + (topToMiddle.x_ >> 16u);
-                int* end = row + (topToBottom.x_ >> 16u);
-                while (dest < end)
-                {
-                    if (invZ < *dest)
-                        *dest = invZ;
-                    invZ += gradients.dInvZdXInt_;
-                    ++dest;
-                }
+                DrawSpan(row + (topToMiddle.x_ >> 16u), row + (topToBottom.x_ >> 16u), topToMiddle.invZ_, gradients.dInvZdXInt_);
 
                 topToMiddle.x_ += topToMiddle.xStep_;
                 topToMiddle.invZ_ += topToMiddle.invZStep_;
@@ -988,16 +1051,7 @@ void OcclusionBuffer::DrawTriangle2D(const Vector3* vertices, bool clockwise, un
             int* endRow = bufferData + bottomY * width_;
             while (row < endRow)
             {
-                int invZ = middleToBottom.invZ_;
-                int* dest = row + (middleToBottom.x_ >> 16u);
-                int* end = row + (topToBottom.x_ >> 16u);
-                while (dest < end)
-                {
-                    if (invZ < *dest)
-                        *dest = invZ;
-                    invZ += gradients.dInvZdXInt_;
-                    ++dest;
-                }
+                DrawSpan(row + (middleToBottom.x_ >> 16u), row + (topToBottom.x_ >> 16u), middleToBottom.invZ_, gradients.dInvZdXInt_);
 
                 middleToBottom.x_ += middleToBottom.xStep_;
                 middleToBottom.invZ_ += middleToBottom.invZStep_;
@@ -1021,6 +1075,16 @@ void OcclusionBuffer::MergeBuffers()
         int* dest = buffers_[0].data_;
         int count = width_ * height_;
 
+#ifdef URHO3D_SSE
+        for (; count >= 4; count -= 4)
+        {
+            auto* destPtr = reinterpret_cast<__m128i*>(dest);
+            _mm_storeu_si128(destPtr, MinInt(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)), _mm_loadu_si128(destPtr)));
+            src += 4;
+            dest += 4;
+        }
+#endif
+
         while (count--)
         {
             // If thread buffer's depth value is closer, overwrite the original
@@ -1041,6 +1105,15 @@ void OcclusionBuffer::ClearBuffer(unsigned threadIndex)
     int count = width_ * height_;
     auto fillValue = (int)OCCLUSION_Z_SCALE;
 
+#ifdef URHO3D_SSE
+    const __m128i fillVector = _mm_set1_epi32(fillValue);
+    for (; count >= 4; count -= 4)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), fillVector);
+        dest += 4;
+    }
+#endif
+
     while (count--)
         *dest++ = fillValue;
 }
@@ -125,6 +125,8 @@ public:
     void BuildDepthHierarchy();
     /// Reset last used timer.
     void ResetUseTimer();
+    /// Mark buffer content as up to date for the current view and the given occluder state hash.
+    void SetContentHash(unsigned occludersHash);
 
     /// Return highest level depth values.
     int* GetBuffer() const { return buffers_.size() ? buffers_[0].data_ : nullptr; }
@@ -153,6 +155,14 @@ public:
     /// Return whether is using threads to speed up rendering.
     bool IsThreaded() const { return buffers_.size() > 1; }
 
+    /// Return whether buffer content was rendered from the current view with the given occluder state hash and can be reused.
+    bool IsContentValid(unsigned occludersHash) const
+    {
+        return contentValid_ && contentHash_ == occludersHash && contentViewProj_ == viewProj_;
+    }
+    /// Return view-projection matrix the buffer content was rendered with.
+    const Matrix4& GetContentViewProj() const { return contentViewProj_; }
+
     /// Test a bounding box for visibility. For best performance, build depth hierarchy first.
     bool IsVisible(const BoundingBox& worldSpaceBox) const;
     /// Return time since last use in milliseconds.
@@ -201,6 +211,12 @@ private:
     CullMode cullMode_{CULL_CCW};
     /// Depth hierarchy needs update flag.
     bool depthHierarchyDirty_{true};
+    /// Content up to date flag.
+    bool contentValid_{};
+    /// Occluder state hash of the content.
+    unsigned contentHash_{};
+    /// View-projection matrix of the content.
+    Matrix4 contentViewProj_;
     /// Culling reverse flag.
     bool reverseCulling_{};
     /// View transform matrix.
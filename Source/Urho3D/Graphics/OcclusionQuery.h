@@ -0,0 +1,76 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Core/Object.h"
+#include "../Graphics/GPUObject.h"
+#include "../Graphics/GraphicsDefs.h"
+
+namespace Urho3D
+{
+
+/// Hardware occlusion query. Results are read back without stalling, typically one or more frames after issuing the query.
+class URHO3D_API OcclusionQuery : public Object, public GPUObject
+{
+    URHO3D_OBJECT(OcclusionQuery, Object);
+
+    using GPUObject::GetGraphics;
+
+public:
+    /// Construct.
+    explicit OcclusionQuery(Context* context);
+    /// Destruct.
+    ~OcclusionQuery() override;
+
+    /// Register object with the engine.
+    static void RegisterObject(Context* context);
+
+    /// Mark the GPU resource destroyed on graphics context destruction.
+    void OnDeviceLost() override;
+    /// Release the query.
+    void Release() override;
+
+    /// Begin the query. Draw calls issued before End() are counted.
+    void Begin();
+    /// End the query.
+    void End();
+    /// Check whether the result of the last issued query has become available without waiting for it. Return true if the result is available.
+    bool CheckResult();
+
+    /// Return whether the query has been issued and its result is not known yet.
+    bool IsPending() const { return pending_; }
+    /// Return the last known result: whether any samples passed the depth test. True before the first result is available.
+    bool IsVisible() const { return visible_; }
+
+private:
+    /// Create the GPU-side query. Return true on success.
+    bool Create();
+
+    /// Pending flag.
+    bool pending_{};
+    /// Last result.
+    bool visible_{true};
+};
+
+}
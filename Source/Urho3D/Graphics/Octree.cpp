@@ -29,6 +29,7 @@
 #include "../Core/Profiler.h"
 #include "../Core/Thread.h"
 #include "../Core/WorkQueue.h"
+#include "../Engine/Engine.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Octree.h"
@@ -54,6 +55,9 @@ namespace
 /// Unused vector of drawables.
 static ea::vector<Drawable*> unusedDrawablesVector;
 
+/// Minimum number of drawables checked for reinsertion per work item.
+static const unsigned DRAWABLE_REINSERTION_GRAIN_SIZE = 64;
+
 /// %Frustum octree query for first zone.
 class ZoneOctreeQuery : public OctreeQuery
 {
@@ -150,21 +154,8 @@ static const int DEFAULT_OCTREE_LEVELS = 8;
 
 extern const char* SUBSYSTEM_CATEGORY;
 
-void UpdateDrawablesWork(const WorkItem* item, unsigned threadIndex)
-{
-    URHO3D_PROFILE("UpdateDrawablesWork");
-    const FrameInfo& frame = *(reinterpret_cast<FrameInfo*>(item->aux_));
-    auto** start = reinterpret_cast<Drawable**>(item->start_);
-    auto** end = reinterpret_cast<Drawable**>(item->end_);
-
-    while (start != end)
-    {
-        Drawable* drawable = *start;
-        if (drawable)
-            drawable->Update(frame);
-        ++start;
-    }
-}
+/// Number of drawables updated by one ParallelFor chunk.
+static const unsigned DRAWABLE_UPDATE_GRAIN_SIZE = 16;
 
 inline bool CompareRayQueryResults(const RayQueryResult& lhs, const RayQueryResult& rhs)
 {
@@ -191,6 +182,7 @@ Octant::~Octant()
             root_->drawables_.push_back(*i);
             root_->QueueUpdate(*i);
         }
+        root_->cullingDataDirty_ = true;
         drawables_.clear();
         numDrawables_ = 0;
     }
@@ -309,14 +301,25 @@ void Octant::ResetRoot()
 
 void Octant::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
 {
-    if (debug && debug->IsInside(worldBoundingBox_))
+    if (debug)
+    {
+        // Submit all octants as one instanced batch instead of individual lines
+        ea::vector<Matrix3x4> transforms;
+        CollectDebugBoxes(debug, transforms);
+        debug->AddBoxes(transforms, Color(0.25f, 0.25f, 0.25f), depthTest);
+    }
+}
+
+void Octant::CollectDebugBoxes(DebugRenderer* debug, ea::vector<Matrix3x4>& transforms) const
+{
+    if (debug->IsInside(worldBoundingBox_))
     {
-        debug->AddBoundingBox(worldBoundingBox_, Color(0.25f, 0.25f, 0.25f), depthTest);
+        transforms.push_back(Matrix3x4(center_, Quaternion::IDENTITY, 2.0f * halfSize_));
 
         for (auto& child : children_)
         {
             if (child)
-                child->DrawDebugGeometry(debug, depthTest);
+                child->CollectDebugBoxes(debug, transforms);
         }
     }
 }
@@ -345,9 +348,12 @@ void Octant::GetDrawablesInternal(OctreeQuery& query, bool inside) const
 
     if (drawables_.size())
     {
-        auto** start = const_cast<Drawable**>(&drawables_[0]);
-        Drawable** end = start + drawables_.size();
-        query.TestDrawables(start, end, inside);
+        if (cullingDataDirty_ || !query.TestPackedDrawables(cullingData_, drawables_.data(), inside))
+        {
+            auto** start = const_cast<Drawable**>(&drawables_[0]);
+            Drawable** end = start + drawables_.size();
+            query.TestDrawables(start, end, inside);
+        }
     }
 
     for (auto child : children_)
@@ -357,6 +363,24 @@ void Octant::GetDrawablesInternal(OctreeQuery& query, bool inside) const
     }
 }
 
+void Octant::UpdateCullingData()
+{
+    if (cullingDataDirty_)
+    {
+        const unsigned numDrawables = drawables_.size();
+        cullingData_.Resize(numDrawables);
+        for (unsigned i = 0; i < numDrawables; ++i)
+            cullingData_.SetDrawable(i, drawables_[i]);
+        cullingDataDirty_ = false;
+    }
+
+    for (auto child : children_)
+    {
+        if (child)
+            child->UpdateCullingData();
+    }
+}
+
 void Octant::GetDrawablesInternal(RayOctreeQuery& query) const
 {
     float octantDist = query.ray_.HitDistance(cullingBox_);
@@ -418,8 +442,9 @@ Octree::Octree(Context* context) :
 {
     // If the engine is running headless, subscribe to RenderUpdate events for manually updating the octree
     // to allow raycasts and animation update
-    if (!GetSubsystem<Graphics>())
-        SubscribeToEvent(E_RENDERUPDATE, URHO3D_HANDLER(Octree, HandleRenderUpdate));
+    auto* engine = GetSubsystem<Engine>();
+    if (engine && !GetSubsystem<Graphics>())
+        engine->onRenderUpdate_.Subscribe(this, &Octree::HandleRenderUpdate);
 }
 
 Octree::~Octree()
@@ -439,6 +464,8 @@ void Octree::RegisterObject(Context* context)
     URHO3D_ATTRIBUTE_EX("Bounding Box Min", Vector3, worldBoundingBox_.min_, UpdateOctreeSize, defaultBoundsMin, AM_DEFAULT);
     URHO3D_ATTRIBUTE_EX("Bounding Box Max", Vector3, worldBoundingBox_.max_, UpdateOctreeSize, defaultBoundsMax, AM_DEFAULT);
     URHO3D_ATTRIBUTE_EX("Number of Levels", int, numLevels_, UpdateOctreeSize, DEFAULT_OCTREE_LEVELS, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Loose Reinsertion", bool, looseReinsertion_, false, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Animation Bone Budget", int, animationBoneBudget_, 0, AM_DEFAULT);
 }
 
 void Octree::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
@@ -464,6 +491,14 @@ void Octree::SetSize(const BoundingBox& box, unsigned numLevels)
     numLevels_ = Max(numLevels, 1U);
 }
 
+bool Octree::ReserveAnimationBones(unsigned numBones)
+{
+    if (!animationBoneBudget_)
+        return true;
+
+    return animationBonesUsed_.fetch_add(numBones, std::memory_order_relaxed) + numBones <= animationBoneBudget_;
+}
+
 void Octree::Update(const FrameInfo& frame)
 {
     if (!Thread::IsMainThread())
@@ -482,29 +517,17 @@ void Octree::Update(const FrameInfo& frame)
         Scene* scene = GetScene();
         auto* queue = GetSubsystem<WorkQueue>();
         scene->BeginThreadedUpdate();
+        animationBonesUsed_ = 0;
 
-        int numWorkItems = queue->GetNumThreads() + 1; // Worker threads + main thread
-        int drawablesPerItem = Max((int)(drawableUpdates_.size() / numWorkItems), 1);
-
-        auto start = drawableUpdates_.begin();
-        // Create a work item for each thread
-        for (int i = 0; i < numWorkItems; ++i)
+        queue->ParallelFor(drawableUpdates_.size(), DRAWABLE_UPDATE_GRAIN_SIZE, [this, &frame](unsigned begin, unsigned end, unsigned)
         {
-            SharedPtr<WorkItem> item = queue->GetFreeItem();
-            item->priority_ = M_MAX_UNSIGNED;
-            item->workFunction_ = UpdateDrawablesWork;
-            item->aux_ = const_cast<FrameInfo*>(&frame);
-
-            auto end = drawableUpdates_.end();
-            if (i < numWorkItems - 1 && end - start > drawablesPerItem)
-                end = start + drawablesPerItem;
-
-            item->start_ = &(*start);
-            item->end_ = &(*end);
-            queue->AddWorkItem(item);
-
-            start = end;
-        }
+            URHO3D_PROFILE("UpdateDrawablesWork");
+            for (unsigned i = begin; i < end; ++i)
+            {
+                if (Drawable* drawable = drawableUpdates_[i])
+                    drawable->Update(frame);
+            }
+        });
 
         queue->Complete(M_MAX_UNSIGNED);
         scene->EndThreadedUpdate();
@@ -547,35 +570,71 @@ void Octree::Update(const FrameInfo& frame)
     {
         URHO3D_PROFILE("ReinsertToOctree");
 
-        for (auto i = drawableUpdates_.begin(); i != drawableUpdates_.end(); ++i)
+        // Find the drawables that left their octants in worker threads. The octree itself is not modified there
+        auto* queue = GetSubsystem<WorkQueue>();
+        drawableReinsertions_.resize(queue->GetNumThreads() + 1);
+
+        queue->ParallelFor(drawableUpdates_.size(), DRAWABLE_REINSERTION_GRAIN_SIZE,
+            [this](unsigned begin, unsigned end, unsigned threadIndex)
         {
-            Drawable* drawable = *i;
-            drawable->updateQueued_ = false;
-            Octant* octant = drawable->GetOctant();
-            const BoundingBox& box = drawable->GetWorldBoundingBox();
+            URHO3D_PROFILE("CheckReinsertionWork");
+            ea::vector<Drawable*>& reinsertions = drawableReinsertions_[threadIndex];
+            for (unsigned i = begin; i < end; ++i)
+            {
+                Drawable* drawable = drawableUpdates_[i];
+                drawable->updateQueued_ = false;
+                if (IsReinsertionNeeded(drawable))
+                    reinsertions.push_back(drawable);
+            }
+        });
 
-            // Skip if no octant or does not belong to this octree anymore
-            if (!octant || octant->GetRoot() != this)
-                continue;
-            // Skip if still fits the current octant
-            if (drawable->IsOccludee() && octant->GetCullingBox().IsInside(box) == INSIDE && octant->CheckDrawableFit(box))
-                continue;
+        queue->Complete(M_MAX_UNSIGNED);
 
-            InsertDrawable(drawable);
+        // Reinsert from the main thread
+        for (ea::vector<Drawable*>& reinsertions : drawableReinsertions_)
+        {
+            for (Drawable* drawable : reinsertions)
+            {
+                InsertDrawable(drawable);
 
 #ifdef _DEBUG
-            // Verify that the drawable will be culled correctly
-            octant = drawable->GetOctant();
-            if (octant != this && octant->GetCullingBox().IsInside(box) != INSIDE)
-            {
-                URHO3D_LOGERROR("Drawable is not fully inside its octant's culling bounds: drawable box " + box.ToString() +
-                         " octant box " + octant->GetCullingBox().ToString());
-            }
+                // Verify that the drawable will be culled correctly
+                const BoundingBox& box = drawable->GetWorldBoundingBox();
+                Octant* octant = drawable->GetOctant();
+                if (octant != this && octant->GetCullingBox().IsInside(box) != INSIDE)
+                {
+                    URHO3D_LOGERROR("Drawable is not fully inside its octant's culling bounds: drawable box " + box.ToString() +
+                             " octant box " + octant->GetCullingBox().ToString());
+                }
 #endif
+            }
+            reinsertions.clear();
         }
     }
 
     drawableUpdates_.clear();
+
+    {
+        URHO3D_PROFILE("UpdateCullingData");
+        UpdateCullingData();
+    }
+}
+
+bool Octree::IsReinsertionNeeded(Drawable* drawable) const
+{
+    Octant* octant = drawable->GetOctant();
+    const BoundingBox& box = drawable->GetWorldBoundingBox();
+
+    // Skip if no octant or does not belong to this octree anymore
+    if (!octant || octant->GetRoot() != this)
+        return false;
+    // Non-occludees must stay in the root, see Octant::InsertDrawable
+    if (!drawable->IsOccludee())
+        return octant != this;
+    // Skip if still fits the current octant. In loose mode, staying inside the octant culling box is enough
+    if (octant->GetCullingBox().IsInside(box) != INSIDE)
+        return true;
+    return !looseReinsertion_ && !octant->CheckDrawableFit(box);
 }
 
 void Octree::AddManualDrawable(Drawable* drawable)
@@ -694,18 +753,16 @@ void Octree::DrawDebugGeometry(bool depthTest)
     DrawDebugGeometry(debug, depthTest);
 }
 
-void Octree::HandleRenderUpdate(StringHash eventType, VariantMap& eventData)
+void Octree::HandleRenderUpdate(UpdateEventArgs& args)
 {
     // When running in headless mode, update the Octree manually during the RenderUpdate event
     Scene* scene = GetScene();
     if (!scene || !scene->IsUpdateEnabled())
         return;
 
-    using namespace RenderUpdate;
-
     FrameInfo frame;
     frame.frameNumber_ = GetSubsystem<Time>()->GetFrameNumber();
-    frame.timeStep_ = eventData[P_TIMESTEP].GetFloat();
+    frame.timeStep_ = args.timeStep_;
     frame.camera_ = nullptr;
 
     Update(frame);
@@ -26,12 +26,15 @@
 #include "../Graphics/Drawable.h"
 #include "../Graphics/OctreeQuery.h"
 
+#include <atomic>
+
 namespace Urho3D
 {
 
 class Octree;
 class Skybox;
 class Zone;
+struct UpdateEventArgs;
 
 static const int NUM_OCTANTS = 8;
 static const unsigned ROOT_INDEX = M_MAX_UNSIGNED;
@@ -59,6 +62,7 @@ public:
     {
         drawable->SetOctant(this);
         drawables_.push_back(drawable);
+        cullingDataDirty_ = true;
         IncDrawableCount();
     }
 
@@ -69,6 +73,7 @@ public:
         if (it != drawables_.end())
         {
             drawables_.erase(it);
+            cullingDataDirty_ = true;
             if (resetOctant)
                 drawable->SetOctant(nullptr);
             DecDrawableCount();
@@ -96,6 +101,13 @@ public:
     /// Return true if there are no drawable objects in this octant and child octants.
     bool IsEmpty() { return numDrawables_ == 0; }
 
+    /// Mark packed culling data as outdated. Queries fall back to testing the drawables directly until the data is updated. Safe to call from worker threads.
+    void MarkCullingDataDirty() { cullingDataDirty_ = true; }
+    /// Update outdated packed culling data recursively. Must not be called concurrently with queries.
+    void UpdateCullingData();
+    /// Return packed culling data.
+    const OctantCullingData& GetCullingData() const { return cullingData_; }
+
     /// Reset root pointer recursively. Called when the whole octree is being destroyed.
     void ResetRoot();
     /// Draw bounds to the debug graphics recursively.
@@ -106,6 +118,8 @@ protected:
     void Initialize(const BoundingBox& box);
     /// Return drawable objects by a query, called internally.
     void GetDrawablesInternal(OctreeQuery& query, bool inside) const;
+    /// Collect the unit cube transforms of visible octant bounds recursively.
+    void CollectDebugBoxes(DebugRenderer* debug, ea::vector<Matrix3x4>& transforms) const;
     /// Return drawable objects by a ray query, called internally.
     void GetDrawablesInternal(RayOctreeQuery& query) const;
     /// Return drawable objects only for a threaded ray query, called internally.
@@ -141,6 +155,10 @@ protected:
     BoundingBox cullingBox_;
     /// Drawable objects.
     ea::vector<Drawable*> drawables_;
+    /// Packed culling data of drawable objects.
+    OctantCullingData cullingData_;
+    /// Whether the packed culling data is outdated.
+    std::atomic<bool> cullingDataDirty_{ true };
     /// Child octants.
     Octant* children_[NUM_OCTANTS]{};
     /// World bounding box center.
@@ -196,8 +214,20 @@ public:
     /// Return active Skybox. Behavior is underfined if there are multiple active skyboxes.
     Skybox* GetSkybox(unsigned viewMask = DEFAULT_VIEWMASK) const;
 
+    /// Set loose reinsertion mode. When enabled, moved drawables that stay inside the culling box of their octant are not
+    /// reinserted even if a smaller octant would fit them better. This trades some culling efficiency for less reinsertion work.
+    void SetLooseReinsertion(bool enable) { looseReinsertion_ = enable; }
+    /// Set maximum number of skeleton bones animated models may update per frame. Models over the budget are deferred to the next frame. 0 = unlimited.
+    void SetAnimationBoneBudget(unsigned bones) { animationBoneBudget_ = bones; }
+
     /// Return subdivision levels.
     unsigned GetNumLevels() const { return numLevels_; }
+    /// Return whether loose reinsertion mode is enabled.
+    bool GetLooseReinsertion() const { return looseReinsertion_; }
+    /// Return maximum number of skeleton bones animated per frame.
+    unsigned GetAnimationBoneBudget() const { return animationBoneBudget_; }
+    /// Reserve bone updates from this frame's animation budget. Return true if within the budget. Is thread-safe.
+    bool ReserveAnimationBones(unsigned numBones);
 
     /// Mark drawable object as requiring an update and a reinsertion.
     void QueueUpdate(Drawable* drawable);
@@ -207,10 +237,12 @@ public:
     void DrawDebugGeometry(bool depthTest);
 
 private:
-    /// Handle render update in case of headless execution.
-    void HandleRenderUpdate(StringHash eventType, VariantMap& eventData);
+    /// Handle render update signal in case of headless execution.
+    void HandleRenderUpdate(UpdateEventArgs& args);
     /// Update octree size.
     void UpdateOctreeSize() { SetSize(worldBoundingBox_, numLevels_); }
+    /// Return whether the drawable must be reinserted into the octree.
+    bool IsReinsertionNeeded(Drawable* drawable) const;
 
     /// Drawable objects that require update.
     ea::vector<Drawable*> drawableUpdates_;
@@ -218,10 +250,18 @@ private:
     ea::vector<Drawable*> threadedDrawableUpdates_;
     /// Mutex for octree reinsertions.
     Mutex octreeMutex_;
+    /// Drawable objects that require reinsertion, per worker thread.
+    ea::vector<ea::vector<Drawable*>> drawableReinsertions_;
     /// Ray query temporary list of drawables.
     mutable ea::vector<Drawable*> rayQueryDrawables_;
     /// Subdivision level.
     unsigned numLevels_;
+    /// Loose reinsertion mode flag.
+    bool looseReinsertion_{};
+    /// Maximum skeleton bones animated per frame.
+    unsigned animationBoneBudget_{};
+    /// Skeleton bones animated during this frame.
+    std::atomic<unsigned> animationBonesUsed_{};
 };
 
 }
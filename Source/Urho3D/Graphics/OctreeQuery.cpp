@@ -24,11 +24,104 @@
 
 #include "../Graphics/OctreeQuery.h"
 
+#ifdef URHO3D_SSE
+#include <xmmintrin.h>
+#endif
+
 #include "../DebugNew.h"
 
 namespace Urho3D
 {
 
+void OctantCullingData::Resize(unsigned size)
+{
+    size_ = size;
+
+    // Pad to a multiple of 4 so that batch kernels may always load 4 elements
+    const unsigned paddedSize = (size + 3) & ~3u;
+    centerX_.resize(paddedSize);
+    centerY_.resize(paddedSize);
+    centerZ_.resize(paddedSize);
+    halfSizeX_.resize(paddedSize);
+    halfSizeY_.resize(paddedSize);
+    halfSizeZ_.resize(paddedSize);
+    viewMasks_.resize(paddedSize);
+    drawableFlags_.resize(paddedSize);
+    castShadows_.resize(paddedSize);
+    occluders_.resize(paddedSize);
+}
+
+void OctantCullingData::SetDrawable(unsigned index, Drawable* drawable)
+{
+    const BoundingBox& box = drawable->GetWorldBoundingBox();
+    const Vector3 center = box.Center();
+    const Vector3 halfSize = center - box.min_;
+
+    centerX_[index] = center.x_;
+    centerY_[index] = center.y_;
+    centerZ_[index] = center.z_;
+    halfSizeX_[index] = halfSize.x_;
+    halfSizeY_[index] = halfSize.y_;
+    halfSizeZ_[index] = halfSize.z_;
+    viewMasks_[index] = drawable->GetViewMask();
+    drawableFlags_[index] = drawable->GetDrawableFlags();
+    castShadows_[index] = drawable->GetCastShadows();
+    occluders_[index] = drawable->IsOccluder();
+}
+
+unsigned OctantCullingData::TestFrustum(const Frustum& frustum, unsigned index) const
+{
+#ifdef URHO3D_SSE
+    const __m128 centerX = _mm_loadu_ps(&centerX_[index]);
+    const __m128 centerY = _mm_loadu_ps(&centerY_[index]);
+    const __m128 centerZ = _mm_loadu_ps(&centerZ_[index]);
+    const __m128 halfSizeX = _mm_loadu_ps(&halfSizeX_[index]);
+    const __m128 halfSizeY = _mm_loadu_ps(&halfSizeY_[index]);
+    const __m128 halfSizeZ = _mm_loadu_ps(&halfSizeZ_[index]);
+
+    __m128 outside = _mm_setzero_ps();
+    for (const Plane& plane : frustum.planes_)
+    {
+        __m128 dist = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.normal_.x_), centerX),
+            _mm_mul_ps(_mm_set1_ps(plane.normal_.y_), centerY));
+        dist = _mm_add_ps(dist, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.normal_.z_), centerZ), _mm_set1_ps(plane.d_)));
+
+        __m128 absDist = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.absNormal_.x_), halfSizeX),
+            _mm_mul_ps(_mm_set1_ps(plane.absNormal_.y_), halfSizeY));
+        absDist = _mm_add_ps(absDist, _mm_mul_ps(_mm_set1_ps(plane.absNormal_.z_), halfSizeZ));
+
+        // Same as dist < -absDist
+        outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(dist, absDist), _mm_setzero_ps()));
+    }
+
+    return ~static_cast<unsigned>(_mm_movemask_ps(outside)) & 0xfu;
+#else
+    unsigned result = 0;
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        const unsigned j = index + i;
+        const Vector3 center{ centerX_[j], centerY_[j], centerZ_[j] };
+        const Vector3 halfSize{ halfSizeX_[j], halfSizeY_[j], halfSizeZ_[j] };
+
+        bool inside = true;
+        for (const Plane& plane : frustum.planes_)
+        {
+            const float dist = plane.normal_.DotProduct(center) + plane.d_;
+            const float absDist = plane.absNormal_.DotProduct(halfSize);
+            if (dist < -absDist)
+            {
+                inside = false;
+                break;
+            }
+        }
+
+        if (inside)
+            result |= 1u << i;
+    }
+    return result;
+#endif
+}
+
 Intersection PointOctreeQuery::TestOctant(const BoundingBox& box, bool inside)
 {
     if (inside)
@@ -117,6 +210,84 @@ void FrustumOctreeQuery::TestDrawables(Drawable** start, Drawable** end, bool in
     }
 }
 
+bool FrustumOctreeQuery::TestPackedDrawables(const OctantCullingData& data, Drawable* const* drawables, bool inside)
+{
+    for (unsigned i = 0; i < data.size_; i += 4)
+    {
+        const unsigned visibleMask = inside ? 0xfu : data.TestFrustum(frustum_, i);
+        const unsigned count = Min(4u, data.size_ - i);
+        for (unsigned j = 0; j < count; ++j)
+        {
+            const unsigned index = i + j;
+            if ((visibleMask & (1u << j)) && (data.drawableFlags_[index] & drawableFlags_) && (data.viewMasks_[index] & viewMask_))
+                result_.push_back(drawables[index]);
+        }
+    }
+    return true;
+}
+
+void MultiFrustumOctreeQuery::AddFrustum(const Frustum& frustum, unsigned viewMask, ea::vector<Drawable*>& result)
+{
+    result.clear();
+    frustums_.push_back(FrustumEntry{frustum, viewMask, &result});
+}
+
+Intersection MultiFrustumOctreeQuery::TestOctant(const BoundingBox& box, bool inside)
+{
+    if (inside)
+        return INSIDE;
+
+    // The octant is inside only if it is inside all frustums, as the inside flag skips the tests of all of them
+    bool anyVisible = false;
+    bool allInside = true;
+    for (const FrustumEntry& entry : frustums_)
+    {
+        const Intersection intersection = entry.frustum_.IsInside(box);
+        if (intersection != OUTSIDE)
+            anyVisible = true;
+        if (intersection != INSIDE)
+            allInside = false;
+    }
+
+    return !anyVisible ? OUTSIDE : allInside ? INSIDE : INTERSECTS;
+}
+
+void MultiFrustumOctreeQuery::TestDrawables(Drawable** start, Drawable** end, bool inside)
+{
+    while (start != end)
+    {
+        Drawable* drawable = *start++;
+        if (!(drawable->GetDrawableFlags() & drawableFlags_))
+            continue;
+
+        const unsigned viewMask = drawable->GetViewMask();
+        for (const FrustumEntry& entry : frustums_)
+        {
+            if ((viewMask & entry.viewMask_) && (inside || entry.frustum_.IsInsideFast(drawable->GetWorldBoundingBox())))
+                entry.result_->push_back(drawable);
+        }
+    }
+}
+
+bool MultiFrustumOctreeQuery::TestPackedDrawables(const OctantCullingData& data, Drawable* const* drawables, bool inside)
+{
+    for (const FrustumEntry& entry : frustums_)
+    {
+        for (unsigned i = 0; i < data.size_; i += 4)
+        {
+            const unsigned visibleMask = inside ? 0xfu : data.TestFrustum(entry.frustum_, i);
+            const unsigned count = Min(4u, data.size_ - i);
+            for (unsigned j = 0; j < count; ++j)
+            {
+                const unsigned index = i + j;
+                if ((visibleMask & (1u << j)) && (data.drawableFlags_[index] & drawableFlags_) &&
+                    (data.viewMasks_[index] & entry.viewMask_))
+                    entry.result_->push_back(drawables[index]);
+            }
+        }
+    }
+    return true;
+}
 
 Intersection AllContentOctreeQuery::TestOctant(const BoundingBox& box, bool inside)
 {
@@ -37,6 +37,41 @@ namespace Urho3D
 class Drawable;
 class Node;
 
+/// Packed culling data of the drawables in an octant, stored as structure of arrays for batch testing.
+/// Arrays are padded to a multiple of 4 elements.
+struct URHO3D_API OctantCullingData
+{
+    /// Resize arrays for the given number of drawables.
+    void Resize(unsigned size);
+    /// Store drawable data at index.
+    void SetDrawable(unsigned index, Drawable* drawable);
+    /// Return 4-bit mask of drawables in range [index, index + 4) whose bounding boxes are inside or intersect the frustum.
+    unsigned TestFrustum(const Frustum& frustum, unsigned index) const;
+
+    /// Number of drawables.
+    unsigned size_{};
+    /// Bounding box centers, X component.
+    ea::vector<float> centerX_;
+    /// Bounding box centers, Y component.
+    ea::vector<float> centerY_;
+    /// Bounding box centers, Z component.
+    ea::vector<float> centerZ_;
+    /// Bounding box half sizes, X component.
+    ea::vector<float> halfSizeX_;
+    /// Bounding box half sizes, Y component.
+    ea::vector<float> halfSizeY_;
+    /// Bounding box half sizes, Z component.
+    ea::vector<float> halfSizeZ_;
+    /// View masks.
+    ea::vector<unsigned> viewMasks_;
+    /// Drawable flags.
+    ea::vector<unsigned char> drawableFlags_;
+    /// Cast shadows flags.
+    ea::vector<bool> castShadows_;
+    /// Occluder flags.
+    ea::vector<bool> occluders_;
+};
+
 /// Base class for octree queries.
 class URHO3D_API OctreeQuery : private NonCopyable
 {
@@ -56,6 +91,9 @@ public:
     virtual Intersection TestOctant(const BoundingBox& box, bool inside) = 0;
     /// Intersection test for drawables.
     virtual void TestDrawables(Drawable** start, Drawable** end, bool inside) = 0;
+    /// Intersection test for drawables using packed culling data. Return false if not supported, TestDrawables is used then.
+    /// Queries that override TestDrawables of a class implementing this function must override this function as well.
+    virtual bool TestPackedDrawables(const OctantCullingData& data, Drawable* const* drawables, bool inside) { return false; }
 
     /// Result vector reference.
     ea::vector<Drawable*>& result_;
@@ -144,11 +182,49 @@ public:
     Intersection TestOctant(const BoundingBox& box, bool inside) override;
     /// Intersection test for drawables.
     void TestDrawables(Drawable** start, Drawable** end, bool inside) override;
+    /// Intersection test for drawables using packed culling data.
+    bool TestPackedDrawables(const OctantCullingData& data, Drawable* const* drawables, bool inside) override;
 
     /// Frustum.
     Frustum frustum_;
 };
 
+/// Octree query with several frustums at once, e.g. for the views of one scene. Drawables inside each frustum are collected to
+/// the result vector of that frustum in a single octree traversal. The common result vector is not used.
+class URHO3D_API MultiFrustumOctreeQuery : public OctreeQuery
+{
+public:
+    /// Construct with query parameters. Frustums are added with AddFrustum().
+    MultiFrustumOctreeQuery(ea::vector<Drawable*>& result, DrawableFlags drawableFlags = DRAWABLE_ANY) :
+        OctreeQuery(result, drawableFlags, DEFAULT_VIEWMASK)
+    {
+    }
+
+    /// Add a frustum with its view mask and result vector. The result vector is cleared.
+    void AddFrustum(const Frustum& frustum, unsigned viewMask, ea::vector<Drawable*>& result);
+
+    /// Intersection test for an octant.
+    Intersection TestOctant(const BoundingBox& box, bool inside) override;
+    /// Intersection test for drawables.
+    void TestDrawables(Drawable** start, Drawable** end, bool inside) override;
+    /// Intersection test for drawables using packed culling data.
+    bool TestPackedDrawables(const OctantCullingData& data, Drawable* const* drawables, bool inside) override;
+
+    /// Frustum with its view mask and result vector.
+    struct FrustumEntry
+    {
+        /// Frustum.
+        Frustum frustum_;
+        /// Drawable layers to include.
+        unsigned viewMask_;
+        /// Result vector.
+        ea::vector<Drawable*>* result_;
+    };
+
+    /// Frustums.
+    ea::vector<FrustumEntry> frustums_;
+};
+
 /// General octree query result. Used for Lua bindings only.
 struct URHO3D_API OctreeQueryResult
 {
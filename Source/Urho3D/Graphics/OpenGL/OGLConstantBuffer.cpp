@@ -32,6 +32,9 @@
 namespace Urho3D
 {
 
+/// Approximate byte size of the ring of data versions in each buffer. Writing a new version avoids re-specifying the whole buffer for each draw call.
+static const unsigned CONSTANT_BUFFER_RING_SIZE = 64 * 1024;
+
 void ConstantBuffer::Release()
 {
     if (object_.name_)
@@ -48,6 +51,9 @@ void ConstantBuffer::Release()
 
     shadowData_.reset();
     size_ = 0;
+    offset_ = 0;
+    stride_ = 0;
+    capacity_ = 0;
 }
 
 void ConstantBuffer::OnDeviceReset()
@@ -70,16 +76,24 @@ bool ConstantBuffer::SetSize(unsigned size)
 
     size_ = size;
     dirty_ = false;
+    offset_ = 0;
     shadowData_.reset(new unsigned char[size_]);
     memset(shadowData_.get(), 0, size_);
 
     if (graphics_)
     {
 #ifndef GL_ES_VERSION_2_0
+        int alignment = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        alignment = Max(alignment, 16);
+        stride_ = (size_ + alignment - 1) / alignment * alignment;
+        capacity_ = Max(CONSTANT_BUFFER_RING_SIZE / stride_, 1u) * stride_;
+
         if (!object_.name_)
             glGenBuffers(1, &object_.name_);
         graphics_->SetUBO(object_.name_);
-        glBufferData(GL_UNIFORM_BUFFER, size_, shadowData_.get(), GL_DYNAMIC_DRAW);
+        glBufferData(GL_UNIFORM_BUFFER, capacity_, nullptr, GL_DYNAMIC_DRAW);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, size_, shadowData_.get());
 #endif
     }
 
@@ -92,7 +106,15 @@ void ConstantBuffer::Apply()
     {
 #ifndef GL_ES_VERSION_2_0
         graphics_->SetUBO(object_.name_);
-        glBufferData(GL_UNIFORM_BUFFER, size_, shadowData_.get(), GL_DYNAMIC_DRAW);
+
+        // Write the next version after the one in use, orphaning the storage once the ring is full
+        offset_ += stride_;
+        if (offset_ + size_ > capacity_)
+        {
+            glBufferData(GL_UNIFORM_BUFFER, capacity_, nullptr, GL_DYNAMIC_DRAW);
+            offset_ = 0;
+        }
+        glBufferSubData(GL_UNIFORM_BUFFER, offset_, size_, shadowData_.get());
 #endif
         dirty_ = false;
     }
@@ -0,0 +1,138 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../../Precompiled.h"
+
+#include "../../Graphics/Graphics.h"
+#include "../../Graphics/GraphicsImpl.h"
+#include "../../Graphics/GPUProfiler.h"
+
+#include "../../DebugNew.h"
+
+namespace Urho3D
+{
+
+void GPUProfiler::OnDeviceLost()
+{
+    for (FrameQueries& frame : frames_)
+        ReleaseFrameQueries(frame);
+
+    GPUObject::OnDeviceLost();
+    inFrame_ = false;
+}
+
+void GPUProfiler::Release()
+{
+    for (FrameQueries& frame : frames_)
+        ReleaseFrameQueries(frame);
+
+    inFrame_ = false;
+}
+
+bool GPUProfiler::IsSupported() const
+{
+#ifndef GL_ES_VERSION_2_0
+    return graphics_ && (Graphics::GetGL3Support() || GLEW_ARB_timer_query);
+#else
+    return false;
+#endif
+}
+
+bool GPUProfiler::BeginFrameQueries(FrameQueries& frame)
+{
+    if (!graphics_ || graphics_->IsDeviceLost())
+        return false;
+
+    // OpenGL timestamps need no disjoint query, only the frame begin timestamp
+    return IssueTimestamp(frame);
+}
+
+void GPUProfiler::EndFrameQueries(FrameQueries& frame)
+{
+    IssueTimestamp(frame);
+}
+
+bool GPUProfiler::IssueTimestamp(FrameQueries& frame)
+{
+#ifndef GL_ES_VERSION_2_0
+    if (frame.numTimestamps_ == frame.timestampQueries_.size())
+    {
+        GPUObjectHandle query{};
+        glGenQueries(1, &query.name_);
+        if (!query.name_)
+            return false;
+        frame.timestampQueries_.push_back(query);
+    }
+
+    glQueryCounter(frame.timestampQueries_[frame.numTimestamps_++].name_, GL_TIMESTAMP);
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool GPUProfiler::ReadTimestamps(FrameQueries& frame, ea::vector<double>& times)
+{
+    times.clear();
+
+#ifndef GL_ES_VERSION_2_0
+    if (!frame.numTimestamps_)
+        return true;
+
+    // Queries complete in order, so the last one being available means all are
+    GLuint available = 0;
+    glGetQueryObjectuiv(frame.timestampQueries_[frame.numTimestamps_ - 1].name_, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+        return false;
+
+    GLuint64 first = 0;
+    for (unsigned i = 0; i < frame.numTimestamps_; ++i)
+    {
+        GLuint64 timestamp = 0;
+        glGetQueryObjectui64v(frame.timestampQueries_[i].name_, GL_QUERY_RESULT, &timestamp);
+        if (i == 0)
+            first = timestamp;
+        times.push_back(static_cast<double>(timestamp - first) / 1000000.0);
+    }
+#endif
+
+    return true;
+}
+
+void GPUProfiler::ReleaseFrameQueries(FrameQueries& frame)
+{
+#ifndef GL_ES_VERSION_2_0
+    if (graphics_ && !graphics_->IsDeviceLost())
+    {
+        for (const GPUObjectHandle& query : frame.timestampQueries_)
+            glDeleteQueries(1, &query.name_);
+    }
+#endif
+
+    frame.timestampQueries_.clear();
+    frame.numTimestamps_ = 0;
+    frame.blocks_.clear();
+    frame.pending_ = false;
+}
+
+}
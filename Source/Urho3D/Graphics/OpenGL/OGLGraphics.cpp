@@ -23,6 +23,7 @@
 #include "../../Precompiled.h"
 
 #include "../../Core/Context.h"
+#include "../../Core/FrameStatistics.h"
 #include "../../Core/Mutex.h"
 #include "../../Core/ProcessUtils.h"
 #include "../../Core/Profiler.h"
@@ -226,7 +227,16 @@ static const unsigned glElementTypes[] =
     GL_FLOAT,
     GL_FLOAT,
     GL_UNSIGNED_BYTE,
-    GL_UNSIGNED_BYTE
+    GL_UNSIGNED_BYTE,
+#ifndef GL_ES_VERSION_2_0
+    GL_HALF_FLOAT,
+    GL_HALF_FLOAT,
+#else
+    GL_HALF_FLOAT_OES,
+    GL_HALF_FLOAT_OES,
+#endif
+    GL_SHORT,
+    GL_SHORT
 };
 
 static const unsigned glElementComponents[] =
@@ -237,9 +247,28 @@ static const unsigned glElementComponents[] =
     3,
     4,
     4,
+    4,
+    2,
+    4,
+    2,
     4
 };
 
+static const bool glElementNormalized[] =
+{
+    false,
+    false,
+    false,
+    false,
+    false,
+    false,
+    true,
+    false,
+    false,
+    true,
+    true
+};
+
 #ifdef GL_ES_VERSION_2_0
 static unsigned glesDepthStencilFormat = GL_DEPTH_COMPONENT16;
 static unsigned glesReadableDepthFormat = GL_DEPTH_COMPONENT;
@@ -254,6 +283,22 @@ bool CheckExtension(const ea::string& name)
     return extensions.contains(name);
 }
 
+#ifndef GL_ES_VERSION_2_0
+/// Return whether a GL3 context reports an extension. GL_EXTENSIONS can not be queried as one string from a core context.
+static bool CheckExtensionGL3(const char* name)
+{
+    int numExtensions = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &numExtensions);
+    for (int i = 0; i < numExtensions; ++i)
+    {
+        const auto* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, (GLuint)i));
+        if (extension && !strcmp(extension, name))
+            return true;
+    }
+    return false;
+}
+#endif
+
 static void GetGLPrimitiveType(unsigned elementCount, PrimitiveType type, unsigned& primitiveCount, GLenum& glPrimitiveType)
 {
     switch (type)
@@ -624,6 +669,10 @@ bool Graphics::BeginFrame()
 
     numPrimitives_ = 0;
     numBatches_ = 0;
+    numStateChanges_ = 0;
+    numShaderChanges_ = 0;
+    numTextureChanges_ = 0;
+    textureUploadBytes_ = 0;
 
     SendEvent(E_BEGINRENDERING);
 
@@ -864,6 +913,10 @@ void Graphics::Draw(PrimitiveType type, unsigned vertexStart, unsigned vertexCou
     if (!vertexCount)
         return;
 
+    // Nothing can be drawn without a shader program, e.g. while shaders are still compiling
+    if (!impl_->shaderProgram_)
+        return;
+
     PrepareDraw();
 
     unsigned primitiveCount;
@@ -881,6 +934,9 @@ void Graphics::Draw(PrimitiveType type, unsigned indexStart, unsigned indexCount
     if (!indexCount || !indexBuffer_ || !indexBuffer_->GetGPUObjectName())
         return;
 
+    if (!impl_->shaderProgram_)
+        return;
+
     PrepareDraw();
 
     unsigned indexSize = indexBuffer_->GetIndexSize();
@@ -901,6 +957,9 @@ void Graphics::Draw(PrimitiveType type, unsigned indexStart, unsigned indexCount
     if (!gl3Support || !indexCount || !indexBuffer_ || !indexBuffer_->GetGPUObjectName())
         return;
 
+    if (!impl_->shaderProgram_)
+        return;
+
     PrepareDraw();
 
     unsigned indexSize = indexBuffer_->GetIndexSize();
@@ -923,6 +982,9 @@ void Graphics::DrawInstanced(PrimitiveType type, unsigned indexStart, unsigned i
     if (!indexCount || !indexBuffer_ || !indexBuffer_->GetGPUObjectName() || !instancingSupport_)
         return;
 
+    if (!impl_->shaderProgram_)
+        return;
+
     PrepareDraw();
 
     unsigned indexSize = indexBuffer_->GetIndexSize();
@@ -959,6 +1021,9 @@ void Graphics::DrawInstanced(PrimitiveType type, unsigned indexStart, unsigned i
     if (!gl3Support || !indexCount || !indexBuffer_ || !indexBuffer_->GetGPUObjectName() || !instancingSupport_)
         return;
 
+    if (!impl_->shaderProgram_)
+        return;
+
     PrepareDraw();
 
     unsigned indexSize = indexBuffer_->GetIndexSize();
@@ -976,6 +1041,40 @@ void Graphics::DrawInstanced(PrimitiveType type, unsigned indexStart, unsigned i
 #endif
 }
 
+void Graphics::MultiDrawInstanced(PrimitiveType type, const IndexedDrawCommand* commands, unsigned numCommands)
+{
+#ifndef GL_ES_VERSION_2_0
+    if (!multiDrawSupport_ || !numCommands || !indexBuffer_ || !indexBuffer_->GetGPUObjectName())
+        return;
+
+    if (!impl_->shaderProgram_)
+        return;
+
+    PrepareDraw();
+
+    // The commands are written for each submission, so let the driver orphan the previous contents
+    if (!impl_->drawIndirectBuffer_)
+        glGenBuffers(1, &impl_->drawIndirectBuffer_);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, impl_->drawIndirectBuffer_);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, numCommands * sizeof(IndexedDrawCommand), commands, GL_STREAM_DRAW);
+
+    unsigned primitiveCount = 0;
+    GLenum glPrimitiveType = GL_TRIANGLES;
+    for (unsigned i = 0; i < numCommands; ++i)
+    {
+        unsigned commandPrimitiveCount;
+        GetGLPrimitiveType(commands[i].indexCount_, type, commandPrimitiveCount, glPrimitiveType);
+        primitiveCount += commands[i].instanceCount_ * commandPrimitiveCount;
+    }
+
+    GLenum indexType = indexBuffer_->GetIndexSize() == sizeof(unsigned short) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    glMultiDrawElementsIndirect(glPrimitiveType, indexType, nullptr, (GLsizei)numCommands, 0);
+
+    numPrimitives_ += primitiveCount;
+    ++numBatches_;
+#endif
+}
+
 void Graphics::SetVertexBuffer(VertexBuffer* buffer)
 {
     // Note: this is not multi-instance safe
@@ -1036,14 +1135,41 @@ void Graphics::SetShaders(ShaderVariation* vs, ShaderVariation* ps)
     if (vs == vertexShader_ && ps == pixelShader_)
         return;
 
+    ++numShaderChanges_;
+
+    // Restore a new combination from the program binary cache if possible, in which case the shaders need not be compiled
+    bool programExists = false;
+    if (vs && ps && impl_->programBinarySupport_ && vs->GetCompilerOutput().empty() && ps->GetCompilerOutput().empty() &&
+        !vs->IsCompilePending() && !ps->IsCompilePending())
+    {
+        ea::pair<ShaderVariation*, ShaderVariation*> combination(vs, ps);
+        programExists = impl_->shaderPrograms_.find(combination) != impl_->shaderPrograms_.end();
+        if (!programExists)
+        {
+            URHO3D_PROFILE("LoadProgramBinary");
+
+            SharedPtr<ShaderProgram> newProgram(new ShaderProgram(this, vs, ps));
+            if (newProgram->LoadBinary())
+            {
+                impl_->shaderPrograms_[combination] = newProgram;
+                programExists = true;
+            }
+        }
+    }
+
     // Compile the shaders now if not yet compiled. If already attempted, do not retry
-    if (vs && !vs->GetGPUObjectName())
+    if (vs && !vs->GetGPUObjectName() && !programExists)
     {
         if (vs->GetCompilerOutput().empty())
         {
             URHO3D_PROFILE("CompileVertexShader");
 
             bool success = vs->Create();
+            if (auto* statistics = GetSubsystem<FrameStatistics>())
+            {
+                statistics->IncrementCounter(FC_SHADER_COMPILES);
+                statistics->AddMarker(FM_SHADER_COMPILE, vs->GetFullName());
+            }
             if (success)
                 URHO3D_LOGDEBUG("Compiled vertex shader " + vs->GetFullName());
             else
@@ -1056,13 +1182,18 @@ void Graphics::SetShaders(ShaderVariation* vs, ShaderVariation* ps)
             vs = nullptr;
     }
 
-    if (ps && !ps->GetGPUObjectName())
+    if (ps && !ps->GetGPUObjectName() && !programExists)
     {
         if (ps->GetCompilerOutput().empty())
         {
             URHO3D_PROFILE("CompilePixelShader");
 
             bool success = ps->Create();
+            if (auto* statistics = GetSubsystem<FrameStatistics>())
+            {
+                statistics->IncrementCounter(FC_SHADER_COMPILES);
+                statistics->AddMarker(FM_SHADER_COMPILE, ps->GetFullName());
+            }
             if (success)
                 URHO3D_LOGDEBUG("Compiled pixel shader " + ps->GetFullName());
             else
@@ -1075,6 +1206,15 @@ void Graphics::SetShaders(ShaderVariation* vs, ShaderVariation* ps)
             ps = nullptr;
     }
 
+    // Shaders compiling in the background can not be used yet, so batches using them are skipped until they are ready
+    if (!programExists)
+    {
+        if (vs && (vs->IsCompilePending() || !vs->GetGPUObjectName()))
+            vs = nullptr;
+        if (ps && (ps->IsCompilePending() || !ps->GetGPUObjectName()))
+            ps = nullptr;
+    }
+
     if (!vs || !ps)
     {
         glUseProgram(0);
@@ -1092,8 +1232,15 @@ void Graphics::SetShaders(ShaderVariation* vs, ShaderVariation* ps)
 
         if (i != impl_->shaderPrograms_.end())
         {
-            // Use the existing linked program
-            if (i->second->GetGPUObjectName())
+            // Use the existing linked program once any background link has finished
+            if (i->second->IsLinkPending())
+            {
+                glUseProgram(0);
+                vertexShader_ = nullptr;
+                pixelShader_ = nullptr;
+                impl_->shaderProgram_ = nullptr;
+            }
+            else if (i->second->GetGPUObjectName())
             {
                 glUseProgram(i->second->GetGPUObjectName());
                 impl_->shaderProgram_ = i->second;
@@ -1110,7 +1257,16 @@ void Graphics::SetShaders(ShaderVariation* vs, ShaderVariation* ps)
             URHO3D_PROFILE("LinkShaders");
 
             SharedPtr<ShaderProgram> newProgram(new ShaderProgram(this, vs, ps));
-            if (newProgram->Link())
+            const bool asyncLink = asyncShaderCompilation_ && asyncShaderCompilationSupport_;
+            if (asyncLink && newProgram->BeginLink())
+            {
+                // Forget the current shaders so that the next SetShaders() call checks the link again
+                glUseProgram(0);
+                vertexShader_ = nullptr;
+                pixelShader_ = nullptr;
+                impl_->shaderProgram_ = nullptr;
+            }
+            else if (!asyncLink && newProgram->Link())
             {
                 URHO3D_LOGDEBUG("Linked vertex shader " + vs->GetFullName() + " and pixel shader " + ps->GetFullName());
                 // Note: Link() calls glUseProgram() to set the texture sampler uniforms,
@@ -1140,8 +1296,14 @@ void Graphics::SetShaders(ShaderVariation* vs, ShaderVariation* ps)
             if (buffer != impl_->constantBuffers_[i])
             {
                 unsigned object = buffer ? buffer->GetGPUObjectName() : 0;
-                glBindBufferBase(GL_UNIFORM_BUFFER, i, object);
-                // Calling glBindBufferBase also affects the generic buffer binding point
+                if (buffer)
+                {
+                    glBindBufferRange(GL_UNIFORM_BUFFER, i, object, buffer->GetOffset(), buffer->GetSize());
+                    impl_->constantBufferOffsets_[i] = buffer->GetOffset();
+                }
+                else
+                    glBindBufferBase(GL_UNIFORM_BUFFER, i, 0);
+                // Binding a uniform buffer index also affects the generic buffer binding point
                 impl_->boundUBO_ = object;
                 impl_->constantBuffers_[i] = buffer;
                 ShaderProgram::ClearGlobalParameterSource((ShaderParameterGroup)(i % MAX_SHADER_PARAMETER_GROUPS));
@@ -1516,10 +1678,10 @@ void Graphics::SetTexture(unsigned index, Texture* texture)
     if (index >= MAX_TEXTURE_UNITS)
         return;
 
-    // Check if texture is currently bound as a rendertarget. In that case, use its backup texture, or blank if not defined
+    // Check if texture is currently bound as a rendertarget or still uploading. In that case, use its backup texture, or blank if not defined
     if (texture)
     {
-        if (renderTargets_[0] && renderTargets_[0]->GetParentTexture() == texture)
+        if ((renderTargets_[0] && renderTargets_[0]->GetParentTexture() == texture) || texture->IsUploadPending())
             texture = texture->GetBackupTexture();
         else
         {
@@ -1536,6 +1698,8 @@ void Graphics::SetTexture(unsigned index, Texture* texture)
 
     if (textures_[index] != texture)
     {
+        ++numTextureChanges_;
+
         if (impl_->activeTexture_ != index)
         {
             glActiveTexture(GL_TEXTURE0 + index);
@@ -1780,6 +1944,7 @@ void Graphics::SetBlendMode(BlendMode mode, bool alphaToCoverage)
         }
 
         blendMode_ = mode;
+        ++numStateChanges_;
     }
 
     if (alphaToCoverage != alphaToCoverage_)
@@ -1790,6 +1955,7 @@ void Graphics::SetBlendMode(BlendMode mode, bool alphaToCoverage)
             glDisable(GL_SAMPLE_ALPHA_TO_COVERAGE);
 
         alphaToCoverage_ = alphaToCoverage;
+        ++numStateChanges_;
     }
 }
 
@@ -1803,6 +1969,7 @@ void Graphics::SetColorWrite(bool enable)
             glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
 
         colorWrite_ = enable;
+        ++numStateChanges_;
     }
 }
 
@@ -1820,6 +1987,7 @@ void Graphics::SetCullMode(CullMode mode)
         }
 
         cullMode_ = mode;
+        ++numStateChanges_;
     }
 }
 
@@ -1840,6 +2008,7 @@ void Graphics::SetDepthBias(float constantBias, float slopeScaledBias)
 
         constantDepthBias_ = constantBias;
         slopeScaledDepthBias_ = slopeScaledBias;
+        ++numStateChanges_;
         // Force update of the projection matrix shader parameter
         ClearParameterSource(SP_CAMERA);
     }
@@ -1851,6 +2020,7 @@ void Graphics::SetDepthTest(CompareMode mode)
     {
         glDepthFunc(glCmpFunc[mode]);
         depthTestMode_ = mode;
+        ++numStateChanges_;
     }
 }
 
@@ -1860,6 +2030,7 @@ void Graphics::SetDepthWrite(bool enable)
     {
         glDepthMask(enable ? GL_TRUE : GL_FALSE);
         depthWrite_ = enable;
+        ++numStateChanges_;
     }
 }
 
@@ -1870,6 +2041,7 @@ void Graphics::SetFillMode(FillMode mode)
     {
         glPolygonMode(GL_FRONT_AND_BACK, glFillMode[mode]);
         fillMode_ = mode;
+        ++numStateChanges_;
     }
 #endif
 }
@@ -2020,6 +2192,7 @@ void Graphics::SetStencilTest(bool enable, CompareMode mode, StencilOp pass, Ste
         else
             glDisable(GL_STENCIL_TEST);
         stencilTest_ = enable;
+        ++numStateChanges_;
     }
 
     if (enable)
@@ -2030,11 +2203,13 @@ void Graphics::SetStencilTest(bool enable, CompareMode mode, StencilOp pass, Ste
             stencilTestMode_ = mode;
             stencilRef_ = stencilRef;
             stencilCompareMask_ = compareMask;
+            ++numStateChanges_;
         }
         if (writeMask != stencilWriteMask_)
         {
             glStencilMask(writeMask);
             stencilWriteMask_ = writeMask;
+            ++numStateChanges_;
         }
         if (pass != stencilPass_ || fail != stencilFail_ || zFail != stencilZFail_)
         {
@@ -2042,6 +2217,7 @@ void Graphics::SetStencilTest(bool enable, CompareMode mode, StencilOp pass, Ste
             stencilPass_ = pass;
             stencilFail_ = fail;
             stencilZFail_ = zFail;
+            ++numStateChanges_;
         }
     }
 #endif
@@ -2421,6 +2597,8 @@ void Graphics::Release(bool clearGPUObjects, bool closeWindow)
 
         SDL_GL_DeleteContext(impl_->context_);
         impl_->context_ = nullptr;
+        // Buffers owned by the graphics subsystem itself go away with the context
+        impl_->drawIndirectBuffer_ = 0;
     }
 
     if (closeWindow)
@@ -2812,6 +2990,8 @@ void Graphics::CheckFeatureSupport()
         anisotropySupport_ = true;
         sRGBSupport_ = true;
         sRGBWriteSupport_ = true;
+        asyncShaderCompilationSupport_ = glMaxShaderCompilerThreadsARB != nullptr &&
+            CheckExtensionGL3("GL_ARB_parallel_shader_compile");
 
         glGetIntegerv(GL_MAX_COLOR_ATTACHMENTS, &numSupportedRTs);
     }
@@ -2822,10 +3002,30 @@ void Graphics::CheckFeatureSupport()
         anisotropySupport_ = GLEW_EXT_texture_filter_anisotropic != 0;
         sRGBSupport_ = GLEW_EXT_texture_sRGB != 0;
         sRGBWriteSupport_ = GLEW_EXT_framebuffer_sRGB != 0;
+        asyncShaderCompilationSupport_ = GLEW_ARB_parallel_shader_compile != 0;
 
         glGetIntegerv(GL_MAX_COLOR_ATTACHMENTS_EXT, &numSupportedRTs);
     }
 
+    // Multi-draw needs base instances to read each command's instance data from the shared instancing buffer
+    multiDrawSupport_ = glMultiDrawElementsIndirect != nullptr && (GLEW_VERSION_4_3 || (gl3Support &&
+        CheckExtensionGL3("GL_ARB_multi_draw_indirect") && CheckExtensionGL3("GL_ARB_base_instance")));
+
+    // Let the driver use as many compiler threads as it likes
+    if (asyncShaderCompilationSupport_)
+        glMaxShaderCompilerThreadsARB(0xffffffffu);
+
+    // Program binaries must be supported in at least one format to be cached
+    int numProgramBinaryFormats = 0;
+    if (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary || (gl3Support && CheckExtensionGL3("GL_ARB_get_program_binary")))
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numProgramBinaryFormats);
+    impl_->programBinarySupport_ = numProgramBinaryFormats > 0 && glGetProgramBinary != nullptr && glProgramBinary != nullptr;
+    if (impl_->programBinarySupport_)
+    {
+        impl_->driverHash_ = StringHash(ea::string((const char*)glGetString(GL_VENDOR)) + (const char*)glGetString(GL_RENDERER) +
+            (const char*)glGetString(GL_VERSION)).Value();
+    }
+
     // Must support 2 rendertargets for light pre-pass, and 4 for deferred
     if (numSupportedRTs >= 2)
         lightPrepassSupport_ = true;
@@ -2894,12 +3094,24 @@ void Graphics::CheckFeatureSupport()
 void Graphics::PrepareDraw()
 {
 #ifndef GL_ES_VERSION_2_0
-    if (gl3Support)
+    if (gl3Support && !impl_->dirtyConstantBuffers_.empty())
     {
         for (auto i = impl_->dirtyConstantBuffers_.begin(); i !=
             impl_->dirtyConstantBuffers_.end(); ++i)
             (*i)->Apply();
         impl_->dirtyConstantBuffers_.clear();
+
+        // Applying writes a new data version within each buffer, so move the bound ranges to it
+        for (unsigned i = 0; i < MAX_SHADER_PARAMETER_GROUPS * 2; ++i)
+        {
+            ConstantBuffer* buffer = impl_->constantBuffers_[i];
+            if (buffer && buffer->GetOffset() != impl_->constantBufferOffsets_[i])
+            {
+                glBindBufferRange(GL_UNIFORM_BUFFER, i, buffer->GetGPUObjectName(), buffer->GetOffset(), buffer->GetSize());
+                impl_->boundUBO_ = buffer->GetGPUObjectName();
+                impl_->constantBufferOffsets_[i] = buffer->GetOffset();
+            }
+        }
     }
 #endif
 
@@ -3180,7 +3392,7 @@ void Graphics::PrepareDraw()
 
                     SetVBO(buffer->GetGPUObjectName());
                     glVertexAttribPointer(location, glElementComponents[element.type_], glElementTypes[element.type_],
-                        element.type_ == TYPE_UBYTE4_NORM ? GL_TRUE : GL_FALSE, (unsigned)buffer->GetVertexSize(),
+                        glElementNormalized[element.type_] ? GL_TRUE : GL_FALSE, (unsigned)buffer->GetVertexSize(),
                         (const void *)(size_t)dataStart);
                 }
             }
@@ -117,6 +117,10 @@ public:
 
     /// Return the GL Context.
     const SDL_GLContext& GetGLContext() { return context_; }
+    /// Return whether program binaries can be saved and loaded.
+    bool GetProgramBinarySupport() const { return programBinarySupport_; }
+    /// Return hash of the driver vendor, renderer and version.
+    unsigned GetDriverHash() const { return driverHash_; }
 
 private:
     /// SDL OpenGL context.
@@ -139,6 +143,8 @@ private:
     unsigned boundVBO_{};
     /// Currently bound uniform buffer object.
     unsigned boundUBO_{};
+    /// Indirect draw command buffer for multi-draw.
+    unsigned drawIndirectBuffer_{};
     /// Read frame buffer for multisampled texture resolves.
     unsigned resolveSrcFBO_{};
     /// Write frame buffer for multisampled texture resolves.
@@ -153,6 +159,8 @@ private:
     ConstantBufferMap allConstantBuffers_;
     /// Currently bound constant buffers.
     ConstantBuffer* constantBuffers_[MAX_SHADER_PARAMETER_GROUPS * 2]{};
+    /// Byte offsets of the currently bound constant buffer ranges.
+    unsigned constantBufferOffsets_[MAX_SHADER_PARAMETER_GROUPS * 2]{};
     /// Dirty constant buffers.
     ea::vector<ConstantBuffer*> dirtyConstantBuffers_;
     /// Last used instance data offset.
@@ -163,6 +171,10 @@ private:
     ShaderProgram* shaderProgram_{};
     /// Linked shader programs.
     ShaderProgramMap shaderPrograms_;
+    /// Hash of the driver vendor, renderer and version. Invalidates program binaries saved by another driver.
+    unsigned driverHash_{};
+    /// Program binary save & load support flag.
+    bool programBinarySupport_{};
     /// Need FBO commit flag.
     bool fboDirty_{};
     /// Need vertex attribute pointer update flag.
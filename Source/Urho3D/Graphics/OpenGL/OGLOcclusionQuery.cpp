@@ -0,0 +1,108 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../../Precompiled.h"
+
+#include "../../Graphics/Graphics.h"
+#include "../../Graphics/GraphicsImpl.h"
+#include "../../Graphics/OcclusionQuery.h"
+
+#include "../../DebugNew.h"
+
+namespace Urho3D
+{
+
+void OcclusionQuery::OnDeviceLost()
+{
+#ifndef GL_ES_VERSION_2_0
+    if (object_.name_ && !graphics_->IsDeviceLost())
+        glDeleteQueries(1, &object_.name_);
+#endif
+
+    GPUObject::OnDeviceLost();
+    pending_ = false;
+}
+
+void OcclusionQuery::Release()
+{
+#ifndef GL_ES_VERSION_2_0
+    if (object_.name_ && graphics_ && !graphics_->IsDeviceLost())
+        glDeleteQueries(1, &object_.name_);
+#endif
+
+    object_.name_ = 0;
+    pending_ = false;
+}
+
+bool OcclusionQuery::Create()
+{
+#ifndef GL_ES_VERSION_2_0
+    if (!object_.name_ && graphics_ && !graphics_->IsDeviceLost())
+        glGenQueries(1, &object_.name_);
+#endif
+
+    return object_.name_ != 0;
+}
+
+void OcclusionQuery::Begin()
+{
+    if (pending_ || !Create())
+        return;
+
+#ifndef GL_ES_VERSION_2_0
+    glBeginQuery(GL_SAMPLES_PASSED, object_.name_);
+#endif
+}
+
+void OcclusionQuery::End()
+{
+    if (pending_ || !object_.name_)
+        return;
+
+#ifndef GL_ES_VERSION_2_0
+    glEndQuery(GL_SAMPLES_PASSED);
+    pending_ = true;
+#endif
+}
+
+bool OcclusionQuery::CheckResult()
+{
+    if (!pending_)
+        return true;
+
+#ifndef GL_ES_VERSION_2_0
+    GLuint available = 0;
+    glGetQueryObjectuiv(object_.name_, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+        return false;
+
+    GLuint samples = 0;
+    glGetQueryObjectuiv(object_.name_, GL_QUERY_RESULT, &samples);
+    visible_ = samples > 0;
+#endif
+
+    pending_ = false;
+    return true;
+}
+
+}
@@ -27,6 +27,8 @@
 #include "../../Graphics/GraphicsImpl.h"
 #include "../../Graphics/ShaderProgram.h"
 #include "../../Graphics/ShaderVariation.h"
+#include "../../IO/File.h"
+#include "../../IO/FileSystem.h"
 #include "../../IO/Log.h"
 
 #include "../../DebugNew.h"
@@ -44,6 +46,18 @@ static const char* shaderParameterGroups[] = {
     "custom"
 };
 
+/// Program binary cache file version. Increment when the file layout changes.
+static const unsigned PROGRAM_BINARY_VERSION = 1;
+
+/// Return a checksum of program binary data using the SDBM hash algorithm.
+static unsigned GetBinaryChecksum(const ea::vector<unsigned char>& data)
+{
+    unsigned checksum = 0;
+    for (unsigned char value : data)
+        checksum = SDBMHash(checksum, value);
+    return checksum;
+}
+
 static unsigned NumberPostfix(const ea::string& str)
 {
     for (unsigned i = 0; i < str.length(); ++i)
@@ -111,9 +125,16 @@ void ShaderProgram::Release()
         for (unsigned i = 0; i < MAX_SHADER_PARAMETER_GROUPS; ++i)
             constantBuffers_[i].Reset();
     }
+
+    linkPending_ = false;
 }
 
 bool ShaderProgram::Link()
+{
+    return BeginLink() && EndLink(true);
+}
+
+bool ShaderProgram::BeginLink()
 {
     Release();
 
@@ -129,8 +150,175 @@ bool ShaderProgram::Link()
 
     glAttachShader(object_.name_, vertexShader_->GetGPUObjectName());
     glAttachShader(object_.name_, pixelShader_->GetGPUObjectName());
+#ifndef GL_ES_VERSION_2_0
+    if (!GetBinaryFileName().empty())
+        glProgramParameteri(object_.name_, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#endif
     glLinkProgram(object_.name_);
 
+    linkPending_ = true;
+    return true;
+}
+
+bool ShaderProgram::IsLinkPending()
+{
+    if (!linkPending_)
+        return false;
+
+#ifndef GL_ES_VERSION_2_0
+    int completed;
+    glGetProgramiv(object_.name_, GL_COMPLETION_STATUS_ARB, &completed);
+    if (!completed)
+        return true;
+#endif
+
+    const ea::string vsName = vertexShader_ ? vertexShader_->GetFullName() : EMPTY_STRING;
+    const ea::string psName = pixelShader_ ? pixelShader_->GetFullName() : EMPTY_STRING;
+    if (EndLink(true))
+        URHO3D_LOGDEBUG("Linked vertex shader " + vsName + " and pixel shader " + psName);
+    else
+        URHO3D_LOGERROR("Failed to link vertex shader " + vsName + " and pixel shader " + psName + ":\n" + linkerOutput_);
+
+    return false;
+}
+
+bool ShaderProgram::LoadBinary()
+{
+    Release();
+
+#ifndef GL_ES_VERSION_2_0
+    const ea::string& fileName = GetBinaryFileName();
+    auto* fileSystem = graphics_->GetSubsystem<FileSystem>();
+    if (fileName.empty() || !fileSystem->FileExists(fileName))
+        return false;
+
+    unsigned format = 0;
+    ea::vector<unsigned char> data;
+    {
+        SharedPtr<File> file(new File(graphics_->GetContext(), fileName, FILE_READ));
+        if (file->IsOpen() && file->ReadFileID() == "UPRG" && file->ReadUInt() == PROGRAM_BINARY_VERSION &&
+            file->ReadUInt() == graphics_->GetImpl()->GetDriverHash() && file->ReadUInt() == vertexSourceHash_ &&
+            file->ReadUInt() == pixelSourceHash_)
+        {
+            format = file->ReadUInt();
+            const unsigned size = file->ReadUInt();
+            const unsigned checksum = file->ReadUInt();
+            if (size && size == file->GetSize() - file->GetPosition())
+            {
+                data.resize(size);
+                if (file->Read(data.data(), size) != size || GetBinaryChecksum(data) != checksum)
+                    data.clear();
+            }
+        }
+    }
+
+    // Saved by another driver, or corrupted: remove so that the program gets saved again after linking
+    if (data.empty())
+    {
+        URHO3D_LOGDEBUG("Discarding stale program binary " + fileName);
+        fileSystem->Delete(fileName);
+        return false;
+    }
+
+    object_.name_ = glCreateProgram();
+    if (!object_.name_)
+        return false;
+
+    glProgramBinary(object_.name_, format, data.data(), (GLsizei)data.size());
+    if (!EndLink(false))
+    {
+        // The driver may also reject its own binaries, for example after an update that kept the version string
+        URHO3D_LOGDEBUG("Driver rejected program binary " + fileName);
+        fileSystem->Delete(fileName);
+        linkerOutput_.clear();
+        return false;
+    }
+
+    URHO3D_LOGDEBUG("Loaded program binary of vertex shader " + vertexShader_->GetFullName() + " and pixel shader " +
+        pixelShader_->GetFullName());
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ShaderProgram::SaveBinary()
+{
+#ifndef GL_ES_VERSION_2_0
+    const ea::string& fileName = GetBinaryFileName();
+    if (fileName.empty())
+        return;
+
+    int size = 0;
+    glGetProgramiv(object_.name_, GL_PROGRAM_BINARY_LENGTH, &size);
+    if (size <= 0)
+        return;
+
+    GLenum format = 0;
+    ea::vector<unsigned char> data((unsigned)size);
+    glGetProgramBinary(object_.name_, size, &size, &format, data.data());
+    if (size <= 0)
+        return;
+    data.resize((unsigned)size);
+
+    auto* fileSystem = graphics_->GetSubsystem<FileSystem>();
+    const ea::string path = GetPath(fileName);
+    if (!fileSystem->DirExists(path))
+        fileSystem->CreateDirsRecursive(path);
+
+    // Write to a temporary file first so that an interrupted save never leaves a truncated binary behind
+    const ea::string tempFileName = fileName + ".tmp";
+    {
+        SharedPtr<File> file(new File(graphics_->GetContext(), tempFileName, FILE_WRITE));
+        if (!file->IsOpen())
+            return;
+
+        file->WriteFileID("UPRG");
+        file->WriteUInt(PROGRAM_BINARY_VERSION);
+        file->WriteUInt(graphics_->GetImpl()->GetDriverHash());
+        file->WriteUInt(vertexSourceHash_);
+        file->WriteUInt(pixelSourceHash_);
+        file->WriteUInt(format);
+        file->WriteUInt(data.size());
+        file->WriteUInt(GetBinaryChecksum(data));
+        if (file->Write(data.data(), data.size()) != data.size())
+        {
+            file->Close();
+            fileSystem->Delete(tempFileName);
+            return;
+        }
+    }
+
+    if (fileSystem->FileExists(fileName))
+        fileSystem->Delete(fileName);
+    fileSystem->Rename(tempFileName, fileName);
+#endif
+}
+
+const ea::string& ShaderProgram::GetBinaryFileName()
+{
+    // Program binaries are stored outside the resource system, so a relative cache directory is not used
+    if (!graphics_->GetImpl()->GetProgramBinarySupport() || !IsAbsolutePath(graphics_->GetShaderCacheDir()) || !vertexShader_ ||
+        !pixelShader_)
+        return EMPTY_STRING;
+
+    if (binaryFileName_.empty())
+    {
+        vertexSourceHash_ = vertexShader_->GetSourceHash();
+        pixelSourceHash_ = pixelShader_->GetSourceHash();
+        binaryFileName_ = graphics_->GetShaderCacheDir() + "Programs/" + ToStringHex(vertexSourceHash_) + "_" +
+            ToStringHex(pixelSourceHash_) + ".bin";
+    }
+
+    return binaryFileName_;
+}
+
+bool ShaderProgram::EndLink(bool saveBinary)
+{
+    linkPending_ = false;
+    if (!object_.name_)
+        return false;
+
     int linked, length;
     glGetProgramiv(object_.name_, GL_LINK_STATUS, &linked);
     if (!linked)
@@ -317,6 +505,9 @@ bool ShaderProgram::Link()
     vertexAttributes_.rehash(Max(2, NextPowerOfTwo(vertexAttributes_.size())));
     shaderParameters_.rehash(Max(2, NextPowerOfTwo(shaderParameters_.size())));
 
+    if (saveBinary)
+        SaveBinary();
+
     return true;
 }
 
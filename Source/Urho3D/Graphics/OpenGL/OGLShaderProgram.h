@@ -51,6 +51,12 @@ public:
 
     /// Link the shaders and examine the uniforms and samplers used. Return true if successful.
     bool Link();
+    /// Start linking the shaders in the background. Return true if started. IsLinkPending() completes the link.
+    bool BeginLink();
+    /// Return whether the shaders are still linking in the background. Completes the link once the driver has finished it.
+    bool IsLinkPending();
+    /// Restore the program from the binary cache in the shader cache directory, without compiling the shaders. Return true if successful.
+    bool LoadBinary();
 
     /// Return the vertex shader.
     ShaderVariation* GetVertexShader() const;
@@ -88,6 +94,13 @@ public:
     static void ClearGlobalParameterSource(ShaderParameterGroup group);
 
 private:
+    /// Check the link result and examine the uniforms and samplers used. Optionally save the program binary. Return true if successful.
+    bool EndLink(bool saveBinary);
+    /// Save the linked program binary to the shader cache directory.
+    void SaveBinary();
+    /// Return the program binary cache file name, or empty if program binaries are not cached.
+    const ea::string& GetBinaryFileName();
+
     /// Vertex shader.
     WeakPtr<ShaderVariation> vertexShader_;
     /// Pixel shader.
@@ -108,6 +121,14 @@ private:
     ea::string linkerOutput_;
     /// Shader parameter source framenumber.
     unsigned frameNumber_{};
+    /// Background link in progress flag.
+    bool linkPending_{};
+    /// Program binary cache file name.
+    ea::string binaryFileName_;
+    /// Vertex shader source hash for the program binary cache.
+    unsigned vertexSourceHash_{};
+    /// Pixel shader source hash for the program binary cache.
+    unsigned pixelSourceHash_{};
 
     /// Global shader parameter source framenumber.
     static unsigned globalFrameNumber;
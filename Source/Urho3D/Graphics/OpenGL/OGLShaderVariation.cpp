@@ -34,77 +34,28 @@
 namespace Urho3D
 {
 
-const char* ShaderVariation::elementSemanticNames[] =
-{
-    "POS",
-    "NORMAL",
-    "BINORMAL",
-    "TANGENT",
-    "TEXCOORD",
-    "COLOR",
-    "BLENDWEIGHT",
-    "BLENDINDICES",
-    "OBJECTINDEX"
-};
-
-void ShaderVariation::OnDeviceLost()
-{
-    if (object_.name_ && !graphics_->IsDeviceLost())
-        glDeleteShader(object_.name_);
-
-    GPUObject::OnDeviceLost();
-
-    compilerOutput_.clear();
-}
-
-void ShaderVariation::Release()
+/// Check the compile status of a shader object. Return true if compiled, otherwise store the error in output.
+static bool CheckShaderCompileStatus(unsigned name, ea::string& output)
 {
-    if (object_.name_)
+    int compiled, length;
+    glGetShaderiv(name, GL_COMPILE_STATUS, &compiled);
+    if (compiled)
     {
-        if (!graphics_)
-            return;
-
-        if (!graphics_->IsDeviceLost())
-        {
-            if (type_ == VS)
-            {
-                if (graphics_->GetVertexShader() == this)
-                    graphics_->SetShaders(nullptr, nullptr);
-            }
-            else
-            {
-                if (graphics_->GetPixelShader() == this)
-                    graphics_->SetShaders(nullptr, nullptr);
-            }
-
-            glDeleteShader(object_.name_);
-        }
-
-        object_.name_ = 0;
-        graphics_->CleanupShaderPrograms(this);
+        output.clear();
+        return true;
     }
 
-    compilerOutput_.clear();
+    glGetShaderiv(name, GL_INFO_LOG_LENGTH, &length);
+    output.resize((unsigned) length);
+    int outLength;
+    glGetShaderInfoLog(name, length, &outLength, &output[0]);
+    return false;
 }
 
-bool ShaderVariation::Create()
+/// Build the final source code of a shader variation, with the version and defines prepended.
+static ea::string BuildShaderCode(const ShaderVariation& variation, bool checkDefines)
 {
-    Release();
-
-    if (!owner_)
-    {
-        compilerOutput_ = "Owner shader has expired";
-        return false;
-    }
-
-    object_.name_ = glCreateShader(type_ == VS ? GL_VERTEX_SHADER : GL_FRAGMENT_SHADER);
-    if (!object_.name_)
-    {
-        compilerOutput_ = "Could not create shader object";
-        return false;
-    }
-
-    const ea::string& originalShaderCode = owner_->GetSourceCode(type_);
+    const ea::string& originalShaderCode = variation.GetOwner()->GetSourceCode(variation.GetShaderType());
     ea::string shaderCode;
 
     // Check if the shader code contains a version define
@@ -143,13 +94,13 @@ bool ShaderVariation::Create()
 #endif
 
     // Distinguish between VS and PS compile in case the shader code wants to include/omit different things
-    shaderCode += type_ == VS ? "#define COMPILEVS\n" : "#define COMPILEPS\n";
+    shaderCode += variation.GetShaderType() == VS ? "#define COMPILEVS\n" : "#define COMPILEPS\n";
 
     // Add define for the maximum number of supported bones
     shaderCode += "#define MAXBONES " + ea::to_string(Graphics::GetMaxBones()) + "\n";
 
     // Prepend the defines to the shader code
-    ea::vector<ea::string> defineVec = defines_.split(' ');
+    ea::vector<ea::string> defineVec = variation.GetDefines().split(' ');
     for (unsigned i = 0; i < defineVec.size(); ++i)
     {
         // Add extra space for the checking code below
@@ -158,14 +109,17 @@ bool ShaderVariation::Create()
 
         // In debug mode, check that all defines are referenced by the shader code
 #ifdef _DEBUG
-        ea::string defineCheck = defineString.substr(8, defineString.find(' ', 8) - 8);
-        if (originalShaderCode.find(defineCheck) == ea::string::npos)
-            URHO3D_LOGWARNING("Shader " + GetFullName() + " does not use the define " + defineCheck);
+        if (checkDefines)
+        {
+            ea::string defineCheck = defineString.substr(8, defineString.find(' ', 8) - 8);
+            if (originalShaderCode.find(defineCheck) == ea::string::npos)
+                URHO3D_LOGWARNING("Shader " + variation.GetFullName() + " does not use the define " + defineCheck);
+        }
 #endif
     }
 
 #ifdef RPI
-    if (type_ == VS)
+    if (variation.GetShaderType() == VS)
         shaderCode += "#define RPI\n";
 #endif
 #ifdef __EMSCRIPTEN__
@@ -180,27 +134,134 @@ bool ShaderVariation::Create()
     else
         shaderCode += originalShaderCode;
 
+    return shaderCode;
+}
+
+const char* ShaderVariation::elementSemanticNames[] =
+{
+    "POS",
+    "NORMAL",
+    "BINORMAL",
+    "TANGENT",
+    "TEXCOORD",
+    "COLOR",
+    "BLENDWEIGHT",
+    "BLENDINDICES",
+    "OBJECTINDEX"
+};
+
+void ShaderVariation::OnDeviceLost()
+{
+    if (object_.name_ && !graphics_->IsDeviceLost())
+        glDeleteShader(object_.name_);
+
+    GPUObject::OnDeviceLost();
+
+    compilerOutput_.clear();
+    compilePending_ = false;
+}
+
+void ShaderVariation::Release()
+{
+    if (!graphics_)
+        return;
+
+    // Programs restored from the binary cache are in use without the shader itself being compiled
+    if (!graphics_->IsDeviceLost())
+    {
+        if (type_ == VS)
+        {
+            if (graphics_->GetVertexShader() == this)
+                graphics_->SetShaders(nullptr, nullptr);
+        }
+        else
+        {
+            if (graphics_->GetPixelShader() == this)
+                graphics_->SetShaders(nullptr, nullptr);
+        }
+
+        if (object_.name_)
+            glDeleteShader(object_.name_);
+    }
+
+    object_.name_ = 0;
+    graphics_->CleanupShaderPrograms(this);
+
+    compilerOutput_.clear();
+    compilePending_ = false;
+}
+
+bool ShaderVariation::Create()
+{
+    // Programs restored from the binary cache remain valid when the shader gets compiled for another combination
+    if (object_.name_)
+        Release();
+
+    if (!owner_)
+    {
+        compilerOutput_ = "Owner shader has expired";
+        return false;
+    }
+
+    object_.name_ = glCreateShader(type_ == VS ? GL_VERTEX_SHADER : GL_FRAGMENT_SHADER);
+    if (!object_.name_)
+    {
+        compilerOutput_ = "Could not create shader object";
+        return false;
+    }
+
+    const ea::string shaderCode = BuildShaderCode(*this, true);
     const char* shaderCStr = shaderCode.c_str();
     glShaderSource(object_.name_, 1, &shaderCStr, nullptr);
     glCompileShader(object_.name_);
 
-    int compiled, length;
-    glGetShaderiv(object_.name_, GL_COMPILE_STATUS, &compiled);
-    if (!compiled)
+    // Querying the status would wait for the compile, so leave it to IsCompilePending() when compiling in the background
+    if (graphics_->GetAsyncShaderCompilation() && graphics_->GetAsyncShaderCompilationSupport())
+    {
+        compilePending_ = true;
+        return true;
+    }
+
+    if (!CheckShaderCompileStatus(object_.name_, compilerOutput_))
     {
-        glGetShaderiv(object_.name_, GL_INFO_LOG_LENGTH, &length);
-        compilerOutput_.resize((unsigned) length);
-        int outLength;
-        glGetShaderInfoLog(object_.name_, length, &outLength, &compilerOutput_[0]);
         glDeleteShader(object_.name_);
         object_.name_ = 0;
     }
-    else
-        compilerOutput_.clear();
 
     return object_.name_ != 0;
 }
 
+bool ShaderVariation::IsCompilePending()
+{
+    if (!compilePending_)
+        return false;
+
+#ifndef GL_ES_VERSION_2_0
+    int completed;
+    glGetShaderiv(object_.name_, GL_COMPLETION_STATUS_ARB, &completed);
+    if (!completed)
+        return true;
+#endif
+
+    compilePending_ = false;
+    if (!CheckShaderCompileStatus(object_.name_, compilerOutput_))
+    {
+        URHO3D_LOGERROR("Failed to compile " + ea::string(type_ == VS ? "vertex" : "pixel") + " shader " + GetFullName() + ":\n" +
+            compilerOutput_);
+        glDeleteShader(object_.name_);
+        object_.name_ = 0;
+    }
+    else
+        URHO3D_LOGDEBUG("Compiled " + ea::string(type_ == VS ? "vertex" : "pixel") + " shader " + GetFullName());
+
+    return false;
+}
+
+unsigned ShaderVariation::GetSourceHash() const
+{
+    return owner_ ? StringHash(BuildShaderCode(*this, false)).Value() : 0;
+}
+
 void ShaderVariation::SetDefines(const ea::string& defines)
 {
     defines_ = defines;
@@ -25,6 +25,7 @@
 #include "../../Core/Context.h"
 #include "../../Core/Profiler.h"
 #include "../../Core/Macros.h"
+#include "../../Core/WorkQueue.h"
 #include "../../Graphics/Graphics.h"
 #include "../../Graphics/GraphicsEvents.h"
 #include "../../Graphics/GraphicsImpl.h"
@@ -42,6 +43,8 @@ namespace Urho3D
 
 void Texture2D::OnDeviceLost()
 {
+    CancelPendingUpload();
+
     if (object_.name_ && !graphics_->IsDeviceLost())
         glDeleteTextures(1, &object_.name_);
 
@@ -72,6 +75,8 @@ void Texture2D::OnDeviceReset()
 
 void Texture2D::Release()
 {
+    CancelPendingUpload();
+
     if (object_.name_)
     {
         if (!graphics_)
@@ -170,6 +175,43 @@ bool Texture2D::SetData(unsigned level, int x, int y, int width, int height, con
     return true;
 }
 
+bool Texture2D::UploadPendingLevel(const PendingLevel& level)
+{
+    const unsigned char* data = level.GetData();
+
+#ifndef GL_ES_VERSION_2_0
+    if (Graphics::GetGL3Support() && object_.name_ && !graphics_->IsDeviceLost())
+    {
+        URHO3D_PROFILE("UploadTextureLevel");
+
+        // Source the level from a pixel unpack buffer, so that the transfer to the texture does not block this thread.
+        // The buffer may be deleted right away, the driver keeps it alive until the transfer is done
+        GLuint buffer = 0;
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, level.dataSize_, data, GL_STREAM_DRAW);
+
+        graphics_->SetTextureForUpdate(this);
+
+        unsigned format = GetSRGB() ? GetSRGBFormat(format_) : format_;
+        if (!IsCompressed())
+        {
+            glTexImage2D(target_, level.level_, format, level.width_, level.height_, 0, GetExternalFormat(format_),
+                GetDataType(format_), nullptr);
+        }
+        else
+            glCompressedTexImage2D(target_, level.level_, format, level.width_, level.height_, 0, level.dataSize_, nullptr);
+
+        graphics_->SetTexture(0, nullptr);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glDeleteBuffers(1, &buffer);
+        return true;
+    }
+#endif
+
+    return SetData(level.level_, 0, 0, level.width_, level.height_, data);
+}
+
 bool Texture2D::SetData(Image* image, bool useAlpha)
 {
     if (!image)
@@ -178,6 +220,9 @@ bool Texture2D::SetData(Image* image, bool useAlpha)
         return false;
     }
 
+    // New data supersedes any upload still in progress
+    CancelPendingUpload();
+
     // Use a shared ptr for managing the temporary mip images created during this function
     SharedPtr<Image> mipImage;
     unsigned memoryUse = sizeof(Texture2D);
@@ -204,9 +249,10 @@ bool Texture2D::SetData(Image* image, bool useAlpha)
         unsigned format = 0;
 
         // Discard unnecessary mip levels
-        for (unsigned i = 0; i < mipsToSkip_[quality]; ++i)
+        const unsigned mipsToSkip = mipsToSkip_[quality] + streamedMipsToSkip_;
+        for (unsigned i = 0; i < mipsToSkip && (levelWidth > 1 || levelHeight > 1); ++i)
         {
-            mipImage = image->GetNextLevel(); image = mipImage;
+            mipImage = image->GetNextLevel(sRGB_); image = mipImage;
             levelData = image->GetData();
             levelWidth = image->GetWidth();
             levelHeight = image->GetHeight();
@@ -245,12 +291,12 @@ bool Texture2D::SetData(Image* image, bool useAlpha)
 
         for (unsigned i = 0; i < levels_; ++i)
         {
-            SetData(i, 0, 0, levelWidth, levelHeight, levelData);
+            UploadLevel(i, levelWidth, levelHeight, levelData, image);
             memoryUse += levelWidth * levelHeight * components;
 
             if (i < levels_ - 1)
             {
-                mipImage = image->GetNextLevel(); image = mipImage;
+                mipImage = image->GetNextLevel(sRGB_); image = mipImage;
                 levelData = image->GetData();
                 levelWidth = image->GetWidth();
                 levelHeight = image->GetHeight();
@@ -274,6 +320,7 @@ bool Texture2D::SetData(Image* image, bool useAlpha)
         unsigned mipsToSkip = 0;
         if (quality < URHO3D_ARRAYSIZE(mipsToSkip_))
             mipsToSkip = mipsToSkip_[quality];
+        mipsToSkip += streamedMipsToSkip_;
         if (mipsToSkip >= levels)
             mipsToSkip = levels - 1;
         while (mipsToSkip && (width / (1u << mipsToSkip) < 4 || height / (1u << mipsToSkip) < 4))
@@ -290,14 +337,14 @@ bool Texture2D::SetData(Image* image, bool useAlpha)
             CompressedLevel level = image->GetCompressedLevel(i + mipsToSkip);
             if (!needDecompress)
             {
-                SetData(i, 0, 0, level.width_, level.height_, level.data_);
+                UploadLevel(i, level.width_, level.height_, level.data_, image);
                 memoryUse += level.rows_ * level.rowSize_;
             }
             else
             {
                 auto* rgbaData = new unsigned char[level.width_ * level.height_ * 4];
-                level.Decompress(rgbaData);
-                SetData(i, 0, 0, level.width_, level.height_, rgbaData);
+                level.Decompress(rgbaData, GetSubsystem<WorkQueue>());
+                UploadLevel(i, level.width_, level.height_, rgbaData, nullptr);
                 memoryUse += level.width_ * level.height_ * 4;
                 delete[] rgbaData;
             }
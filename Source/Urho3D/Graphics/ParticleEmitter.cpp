@@ -172,6 +172,22 @@ void ParticleEmitter::Update(const FrameInfo& frame)
     if (scaled_ && !relative_)
         scaleVector = node_->GetWorldScale();
 
+    // Effect parameters are the same for all particles, so read them once
+    const Vector3& constantForce = effect_->GetConstantForce();
+    const Vector3 velocityAdd = lastTimeStep_ * (relative_ ? relativeConstantForce : constantForce);
+    const bool hasConstantForce = constantForce != Vector3::ZERO;
+    const float dampingForce = effect_->GetDampingForce();
+    const float dampingScale = 1.0f - lastTimeStep_ * dampingForce;
+    const float sizeAdd = effect_->GetSizeAdd();
+    const float sizeMul = effect_->GetSizeMul();
+    const bool hasSizeChange = sizeAdd != 0.0f || sizeMul != 1.0f;
+    const float scaleAdd = lastTimeStep_ * sizeAdd;
+    const float scaleMul = (lastTimeStep_ * (sizeMul - 1.0f)) + 1.0f;
+    const ea::vector<ColorFrame>& colorFrames_ = effect_->GetColorFrames();
+    const ea::vector<TextureFrame>& textureFrames_ = effect_->GetTextureFrames();
+    // Billboard direction is only used for rendering when facing the camera by direction
+    const bool needDirection = faceCameraMode_ == FC_DIRECTION;
+
     for (unsigned i = 0; i < particles_.size(); ++i)
     {
         Particle& particle = particles_[i];
@@ -190,43 +206,31 @@ void ParticleEmitter::Update(const FrameInfo& frame)
             particle.timer_ += lastTimeStep_;
 
             // Velocity & position
-            const Vector3& constantForce = effect_->GetConstantForce();
-            if (constantForce != Vector3::ZERO)
-            {
-                if (relative_)
-                    particle.velocity_ += lastTimeStep_ * relativeConstantForce;
-                else
-                    particle.velocity_ += lastTimeStep_ * constantForce;
-            }
+            if (hasConstantForce)
+                particle.velocity_ += velocityAdd;
 
-            float dampingForce = effect_->GetDampingForce();
             if (dampingForce != 0.0f)
-            {
-                Vector3 force = -dampingForce * particle.velocity_;
-                particle.velocity_ += lastTimeStep_ * force;
-            }
+                particle.velocity_ *= dampingScale;
             billboard.position_ += lastTimeStep_ * particle.velocity_ * scaleVector;
-            billboard.direction_ = particle.velocity_.Normalized();
+            if (needDirection)
+                billboard.direction_ = particle.velocity_.Normalized();
 
             // Rotation
             billboard.rotation_ += lastTimeStep_ * particle.rotationSpeed_;
 
             // Scaling
-            float sizeAdd = effect_->GetSizeAdd();
-            float sizeMul = effect_->GetSizeMul();
-            if (sizeAdd != 0.0f || sizeMul != 1.0f)
+            if (hasSizeChange)
             {
-                particle.scale_ += lastTimeStep_ * sizeAdd;
+                particle.scale_ += scaleAdd;
                 if (particle.scale_ < 0.0f)
                     particle.scale_ = 0.0f;
                 if (sizeMul != 1.0f)
-                    particle.scale_ *= (lastTimeStep_ * (sizeMul - 1.0f)) + 1.0f;
+                    particle.scale_ *= scaleMul;
                 billboard.size_ = particle.size_ * particle.scale_;
             }
 
             // Color interpolation
             unsigned& index = particle.colorIndex_;
-            const ea::vector<ColorFrame>& colorFrames_ = effect_->GetColorFrames();
             if (index < colorFrames_.size())
             {
                 if (index < colorFrames_.size() - 1)
@@ -242,7 +246,6 @@ void ParticleEmitter::Update(const FrameInfo& frame)
 
             // Texture animation
             unsigned& texIndex = particle.texIndex_;
-            const ea::vector<TextureFrame>& textureFrames_ = effect_->GetTextureFrames();
             if (textureFrames_.size() && texIndex < textureFrames_.size() - 1)
             {
                 if (particle.timer_ >= textureFrames_[texIndex + 1].time_)
@@ -0,0 +1,118 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Graphics/Camera.h"
+#include "../Graphics/Material.h"
+#include "../Graphics/ProjectedDecal.h"
+#include "../Graphics/Renderer.h"
+#include "../Resource/ResourceCache.h"
+#include "../Scene/Node.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+extern const char* GEOMETRY_CATEGORY;
+
+ProjectedDecal::ProjectedDecal(Context* context) :
+    Drawable(context, DRAWABLE_GEOMETRY)
+{
+    batches_.resize(1);
+    batches_[0].worldTransform_ = &decalTransform_;
+    if (auto* renderer = GetSubsystem<Renderer>())
+        batches_[0].geometry_ = renderer->GetBoxGeometry();
+}
+
+ProjectedDecal::~ProjectedDecal() = default;
+
+void ProjectedDecal::RegisterObject(Context* context)
+{
+    context->RegisterFactory<ProjectedDecal>(GEOMETRY_CATEGORY);
+
+    URHO3D_ACCESSOR_ATTRIBUTE("Is Enabled", IsEnabled, SetEnabled, bool, true, AM_DEFAULT);
+    URHO3D_MIXED_ACCESSOR_ATTRIBUTE("Material", GetMaterialAttr, SetMaterialAttr, ResourceRef, ResourceRef(Material::GetTypeStatic()),
+        AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Size", GetSize, SetSize, Vector3, Vector3::ONE, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Can Be Occluded", IsOccludee, SetOccludee, bool, true, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Draw Distance", GetDrawDistance, SetDrawDistance, float, 0.0f, AM_DEFAULT);
+    URHO3D_COPY_BASE_ATTRIBUTES(Drawable);
+}
+
+void ProjectedDecal::UpdateBatches(const FrameInfo& frame)
+{
+    // Shares the unit box geometry of the renderer so that decals with the same material are drawn instanced
+    decalTransform_ = node_->GetWorldTransform() * Matrix3x4(Vector3::ZERO, Quaternion::IDENTITY, size_);
+    distance_ = frame.camera_->GetDistance(GetWorldBoundingBox().Center());
+    batches_[0].distance_ = distance_;
+}
+
+void ProjectedDecal::SetMaterial(Material* material)
+{
+    batches_[0].material_ = material;
+    MarkNetworkUpdate();
+}
+
+void ProjectedDecal::SetSize(const Vector3& size)
+{
+    size_ = size;
+    OnMarkedDirty(node_);
+    MarkNetworkUpdate();
+}
+
+Material* ProjectedDecal::GetMaterial() const
+{
+    return batches_[0].material_;
+}
+
+void ProjectedDecal::SetMaterialAttr(const ResourceRef& value)
+{
+    auto* cache = GetSubsystem<ResourceCache>();
+    SetMaterial(cache->GetResource<Material>(value.name_));
+}
+
+ResourceRef ProjectedDecal::GetMaterialAttr() const
+{
+    return GetResourceRef(batches_[0].material_, Material::GetTypeStatic());
+}
+
+void ProjectedDecal::OnSceneSet(Scene* scene)
+{
+    Drawable::OnSceneSet(scene);
+
+    // Renderer may have been created after the component
+    if (scene && !batches_[0].geometry_)
+    {
+        if (auto* renderer = GetSubsystem<Renderer>())
+            batches_[0].geometry_ = renderer->GetBoxGeometry();
+    }
+}
+
+void ProjectedDecal::OnWorldBoundingBoxUpdate()
+{
+    worldBoundingBox_ = BoundingBox(-0.5f * size_, 0.5f * size_).Transformed(node_->GetWorldTransform());
+}
+
+}
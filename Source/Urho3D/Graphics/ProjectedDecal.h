@@ -0,0 +1,79 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include "../Graphics/Drawable.h"
+
+namespace Urho3D
+{
+
+/// Decal projected onto the scene depth buffer by the GPU. The decal box is the node transform applied to a box of the
+/// given size, the texture is projected along the local Z axis. Requires a render path with a readable depth texture and
+/// a "decal" scene pass, and a material using the DeferredDecal shaders such as the DiffDecal technique.
+/// Atlas cells are selected through the material UV transform.
+class URHO3D_API ProjectedDecal : public Drawable
+{
+    URHO3D_OBJECT(ProjectedDecal, Drawable);
+
+public:
+    /// Construct.
+    explicit ProjectedDecal(Context* context);
+    /// Destruct.
+    ~ProjectedDecal() override;
+    /// Register object factory. Drawable must be registered first.
+    static void RegisterObject(Context* context);
+
+    /// Calculate distance and prepare batches for rendering.
+    void UpdateBatches(const FrameInfo& frame) override;
+
+    /// Set material.
+    void SetMaterial(Material* material);
+    /// Set size of the decal box.
+    void SetSize(const Vector3& size);
+
+    /// Return material.
+    Material* GetMaterial() const;
+    /// Return size of the decal box.
+    const Vector3& GetSize() const { return size_; }
+
+    /// Set material attribute.
+    void SetMaterialAttr(const ResourceRef& value);
+    /// Return material attribute.
+    ResourceRef GetMaterialAttr() const;
+
+protected:
+    /// Handle scene being assigned.
+    void OnSceneSet(Scene* scene) override;
+    /// Recalculate the world-space bounding box.
+    void OnWorldBoundingBoxUpdate() override;
+
+private:
+    /// Size of the decal box.
+    Vector3 size_{Vector3::ONE};
+    /// World transform of the decal box including the size.
+    Matrix3x4 decalTransform_;
+};
+
+}
@@ -0,0 +1,329 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Graphics/Camera.h"
+#include "../Graphics/Graphics.h"
+#include "../Graphics/ReflectionProbe.h"
+#include "../Graphics/Renderer.h"
+#include "../Graphics/RenderSurface.h"
+#include "../Graphics/TextureCube.h"
+#include "../Graphics/Viewport.h"
+#include "../Graphics/Zone.h"
+#include "../Math/Sphere.h"
+#include "../Resource/ResourceCache.h"
+#include "../Resource/XMLFile.h"
+#include "../Scene/Node.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+extern const char* SCENE_CATEGORY;
+
+/// Priority multiplier of probes whose influence is outside all main camera frustums.
+static const float INVISIBLE_PRIORITY_SCALE = 0.25f;
+/// Priority multiplier of probes that have not completed their first capture.
+static const float INCOMPLETE_PRIORITY_SCALE = 16.0f;
+
+/// Return camera rotation of a cube map face.
+static Quaternion GetFaceRotation(CubeMapFace face)
+{
+    switch (face)
+    {
+    case FACE_POSITIVE_X: return Quaternion(0.0f, 90.0f, 0.0f);
+    case FACE_NEGATIVE_X: return Quaternion(0.0f, -90.0f, 0.0f);
+    case FACE_POSITIVE_Y: return Quaternion(-90.0f, 0.0f, 0.0f);
+    case FACE_NEGATIVE_Y: return Quaternion(90.0f, 0.0f, 0.0f);
+    case FACE_NEGATIVE_Z: return Quaternion(0.0f, 180.0f, 0.0f);
+    default: return Quaternion::IDENTITY;
+    }
+}
+
+ReflectionProbe::ReflectionProbe(Context* context) :
+    Component(context)
+{
+}
+
+ReflectionProbe::~ReflectionProbe()
+{
+    if (auto* renderer = GetSubsystem<Renderer>())
+        renderer->RemoveReflectionProbe(this);
+}
+
+void ReflectionProbe::RegisterObject(Context* context)
+{
+    context->RegisterFactory<ReflectionProbe>(SCENE_CATEGORY);
+
+    URHO3D_ACCESSOR_ATTRIBUTE("Is Enabled", IsEnabled, SetEnabled, bool, true, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Texture Size", GetTextureSize, SetTextureSize, int, 128, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Near Clip", GetNearClip, SetNearClip, float, 0.1f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Far Clip", GetFarClip, SetFarClip, float, 100.0f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("View Mask", GetViewMask, SetViewMask, unsigned, M_MAX_UNSIGNED, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("LOD Bias", GetLodBias, SetLodBias, float, 0.5f, AM_DEFAULT);
+    URHO3D_MIXED_ACCESSOR_ATTRIBUTE("Render Path", GetRenderPathAttr, SetRenderPathAttr, ResourceRef,
+        ResourceRef(XMLFile::GetTypeStatic()), AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Realtime", IsRealtime, SetRealtime, bool, true, AM_DEFAULT);
+}
+
+void ReflectionProbe::OnSetEnabled()
+{
+    // Disabled probes keep their last captured cube map
+    if (IsEnabledEffective() && !captured_)
+        facesRemaining_ = MAX_CUBEMAP_FACES;
+}
+
+void ReflectionProbe::SetTextureSize(int size)
+{
+    size = Max(size, 1);
+    if (size != textureSize_)
+    {
+        textureSize_ = size;
+        ReleaseTexture();
+    }
+}
+
+void ReflectionProbe::SetNearClip(float nearClip)
+{
+    nearClip_ = Max(nearClip, M_MIN_NEARCLIP);
+    UpdateCameras();
+}
+
+void ReflectionProbe::SetFarClip(float farClip)
+{
+    farClip_ = Max(farClip, M_MIN_NEARCLIP);
+    UpdateCameras();
+}
+
+void ReflectionProbe::SetViewMask(unsigned mask)
+{
+    viewMask_ = mask;
+    UpdateCameras();
+}
+
+void ReflectionProbe::SetLodBias(float bias)
+{
+    lodBias_ = Max(bias, M_EPSILON);
+    UpdateCameras();
+}
+
+void ReflectionProbe::SetRenderPath(XMLFile* renderPath)
+{
+    renderPath_ = renderPath;
+    for (Viewport* viewport : viewports_)
+    {
+        if (viewport)
+            ApplyRenderPath(viewport);
+    }
+}
+
+void ReflectionProbe::SetRealtime(bool enable)
+{
+    realtime_ = enable;
+    if (realtime_ && !facesRemaining_)
+        facesRemaining_ = MAX_CUBEMAP_FACES;
+}
+
+void ReflectionProbe::QueueCapture()
+{
+    facesRemaining_ = MAX_CUBEMAP_FACES;
+}
+
+XMLFile* ReflectionProbe::GetRenderPath() const
+{
+    return renderPath_;
+}
+
+float ReflectionProbe::GetUpdatePriority(const ea::vector<Camera*>& cameras, unsigned frameNumber) const
+{
+    if (!node_ || !facesRemaining_ || !IsEnabledEffective())
+        return 0.0f;
+
+    const Vector3 position = node_->GetWorldPosition();
+    const Sphere influence(position, farClip_);
+    float minDistance = M_INFINITY;
+    bool visible = false;
+    for (Camera* camera : cameras)
+    {
+        if (camera->GetScene() != GetScene())
+            continue;
+
+        minDistance = Min(minDistance, (camera->GetNode()->GetWorldPosition() - position).Length());
+        if (camera->GetFrustum().IsInsideFast(influence) != OUTSIDE)
+            visible = true;
+    }
+
+    // Not seen by any view this frame
+    if (minDistance == M_INFINITY)
+        return 0.0f;
+
+    // Probes that have waited longer and are closer to the cameras go first. Probes outside the view still age, so
+    // they are refreshed eventually
+    float priority = static_cast<float>(frameNumber - lastUpdateFrame_ + 1) / (1.0f + minDistance);
+    if (!visible)
+        priority *= INVISIBLE_PRIORITY_SCALE;
+    if (!captured_)
+        priority *= INCOMPLETE_PRIORITY_SCALE;
+    return priority;
+}
+
+void ReflectionProbe::QueueNextFace(unsigned frameNumber)
+{
+    if (!node_ || !facesRemaining_ || !CreateTexture())
+        return;
+
+    const auto face = static_cast<CubeMapFace>(nextFace_);
+    cameraNodes_[face]->SetPosition(node_->GetWorldPosition());
+    texture_->GetRenderSurface(face)->QueueUpdate();
+
+    nextFace_ = (nextFace_ + 1) % MAX_CUBEMAP_FACES;
+    lastUpdateFrame_ = frameNumber;
+
+    if (--facesRemaining_ == 0)
+    {
+        if (!captured_)
+        {
+            captured_ = true;
+            if (auto* zone = node_->GetComponent<Zone>())
+                zone->SetZoneTexture(texture_);
+        }
+
+        if (realtime_)
+            facesRemaining_ = MAX_CUBEMAP_FACES;
+    }
+}
+
+void ReflectionProbe::SetRenderPathAttr(const ResourceRef& value)
+{
+    auto* cache = GetSubsystem<ResourceCache>();
+    SetRenderPath(cache->GetResource<XMLFile>(value.name_));
+}
+
+ResourceRef ReflectionProbe::GetRenderPathAttr() const
+{
+    return GetResourceRef(renderPath_, XMLFile::GetTypeStatic());
+}
+
+void ReflectionProbe::OnSceneSet(Scene* scene)
+{
+    ReleaseTexture();
+
+    if (auto* renderer = GetSubsystem<Renderer>())
+    {
+        if (scene)
+            renderer->AddReflectionProbe(this);
+        else
+            renderer->RemoveReflectionProbe(this);
+    }
+}
+
+bool ReflectionProbe::CreateTexture()
+{
+    if (texture_)
+        return true;
+
+    if (!GetSubsystem<Graphics>() || !GetScene())
+        return false;
+
+    texture_ = MakeShared<TextureCube>(context_);
+    if (!texture_->SetSize(textureSize_, Graphics::GetRGBAFormat(), TEXTURE_RENDERTARGET))
+    {
+        texture_.Reset();
+        return false;
+    }
+
+    // Mip levels are regenerated on the GPU after each rendered face
+    texture_->SetFilterMode(FILTER_TRILINEAR);
+
+    for (unsigned i = 0; i < MAX_CUBEMAP_FACES; ++i)
+    {
+        const auto face = static_cast<CubeMapFace>(i);
+
+        cameraNodes_[i] = MakeShared<Node>(context_);
+        cameraNodes_[i]->SetRotation(GetFaceRotation(face));
+        auto* camera = cameraNodes_[i]->CreateComponent<Camera>();
+        camera->SetFov(90.0f);
+        camera->SetAspectRatio(1.0f);
+
+        viewports_[i] = MakeShared<Viewport>(context_, GetScene(), camera);
+        ApplyRenderPath(viewports_[i]);
+        viewports_[i]->SetDrawDebug(false);
+
+        RenderSurface* surface = texture_->GetRenderSurface(face);
+        surface->SetUpdateMode(SURFACE_MANUALUPDATE);
+        surface->SetViewport(0, viewports_[i]);
+    }
+
+    UpdateCameras();
+
+    nextFace_ = 0;
+    facesRemaining_ = MAX_CUBEMAP_FACES;
+    captured_ = false;
+    return true;
+}
+
+void ReflectionProbe::ReleaseTexture()
+{
+    if (texture_ && node_)
+    {
+        auto* zone = node_->GetComponent<Zone>();
+        if (zone && zone->GetZoneTexture() == texture_)
+            zone->SetZoneTexture(nullptr);
+    }
+
+    texture_.Reset();
+    for (unsigned i = 0; i < MAX_CUBEMAP_FACES; ++i)
+    {
+        viewports_[i].Reset();
+        cameraNodes_[i].Reset();
+    }
+
+    facesRemaining_ = MAX_CUBEMAP_FACES;
+    captured_ = false;
+}
+
+void ReflectionProbe::ApplyRenderPath(Viewport* viewport)
+{
+    if (!renderPath_ || !viewport->SetRenderPath(renderPath_.Get()))
+        viewport->SetRenderPath(static_cast<RenderPath*>(nullptr));
+}
+
+void ReflectionProbe::UpdateCameras()
+{
+    for (Node* cameraNode : cameraNodes_)
+    {
+        if (!cameraNode)
+            continue;
+
+        auto* camera = cameraNode->GetComponent<Camera>();
+        camera->SetNearClip(nearClip_);
+        camera->SetFarClip(farClip_);
+        camera->SetViewMask(viewMask_);
+        camera->SetLodBias(lodBias_);
+    }
+}
+
+}
@@ -0,0 +1,147 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+/// \file
+
+#pragma once
+
+#include "../Graphics/GraphicsDefs.h"
+#include "../Scene/Component.h"
+
+namespace Urho3D
+{
+
+class Camera;
+class TextureCube;
+class Viewport;
+class XMLFile;
+
+/// Component that captures the surroundings of its node into a cube map for reflections. Faces are rendered one at a
+/// time under the per-frame budget of the Renderer, prioritized by distance to and visibility from the main cameras.
+/// If the node has a Zone, the captured cube map is assigned as its zone texture once all faces have been rendered.
+class URHO3D_API ReflectionProbe : public Component
+{
+    URHO3D_OBJECT(ReflectionProbe, Component);
+
+public:
+    /// Construct.
+    explicit ReflectionProbe(Context* context);
+    /// Destruct.
+    ~ReflectionProbe() override;
+    /// Register object factory.
+    static void RegisterObject(Context* context);
+
+    /// Handle enabled/disabled state change.
+    void OnSetEnabled() override;
+
+    /// Set cube map face size in pixels.
+    void SetTextureSize(int size);
+    /// Set near clip distance of the capture.
+    void SetNearClip(float nearClip);
+    /// Set far clip distance of the capture.
+    void SetFarClip(float farClip);
+    /// Set view mask of the capture. Drawables that should not appear in reflections can be excluded with it.
+    void SetViewMask(unsigned mask);
+    /// Set LOD bias of the capture. Values below 1 render coarser LODs than the main view.
+    void SetLodBias(float bias);
+    /// Set render path of the capture. If null, the default render path is used.
+    void SetRenderPath(XMLFile* renderPath);
+    /// Set whether faces are rerendered continuously. If false, faces are rendered until the cube map is complete and then only on QueueCapture().
+    void SetRealtime(bool enable);
+    /// Queue rendering of all faces.
+    void QueueCapture();
+
+    /// Return cube map face size in pixels.
+    int GetTextureSize() const { return textureSize_; }
+    /// Return near clip distance of the capture.
+    float GetNearClip() const { return nearClip_; }
+    /// Return far clip distance of the capture.
+    float GetFarClip() const { return farClip_; }
+    /// Return view mask of the capture.
+    unsigned GetViewMask() const { return viewMask_; }
+    /// Return LOD bias of the capture.
+    float GetLodBias() const { return lodBias_; }
+    /// Return render path of the capture.
+    XMLFile* GetRenderPath() const;
+    /// Return whether faces are rerendered continuously.
+    bool IsRealtime() const { return realtime_; }
+    /// Return captured cube map, or null if not created yet.
+    TextureCube* GetTexture() const { return texture_; }
+    /// Return whether all faces have been rendered at least once.
+    bool IsCaptured() const { return captured_; }
+
+    /// Return update priority for the given cameras, or zero if the probe does not need an update. Called by Renderer.
+    float GetUpdatePriority(const ea::vector<Camera*>& cameras, unsigned frameNumber) const;
+    /// Queue the next face for rendering. Called by Renderer.
+    void QueueNextFace(unsigned frameNumber);
+
+    /// Set render path attribute.
+    void SetRenderPathAttr(const ResourceRef& value);
+    /// Return render path attribute.
+    ResourceRef GetRenderPathAttr() const;
+
+protected:
+    /// Handle scene being assigned.
+    void OnSceneSet(Scene* scene) override;
+
+private:
+    /// Create the cube map and face viewports if necessary. Return true if successful.
+    bool CreateTexture();
+    /// Release the cube map and face viewports.
+    void ReleaseTexture();
+    /// Apply the render path to a face viewport, falling back to the default render path.
+    void ApplyRenderPath(Viewport* viewport);
+    /// Apply capture settings to the face cameras.
+    void UpdateCameras();
+
+    /// Cube map face size.
+    int textureSize_{ 128 };
+    /// Near clip distance.
+    float nearClip_{ 0.1f };
+    /// Far clip distance.
+    float farClip_{ 100.0f };
+    /// View mask.
+    unsigned viewMask_{ M_MAX_UNSIGNED };
+    /// LOD bias.
+    float lodBias_{ 0.5f };
+    /// Render path.
+    SharedPtr<XMLFile> renderPath_;
+    /// Continuous update flag.
+    bool realtime_{ true };
+    /// Captured cube map.
+    SharedPtr<TextureCube> texture_;
+    /// Camera nodes of the faces. Not part of the scene.
+    SharedPtr<Node> cameraNodes_[MAX_CUBEMAP_FACES];
+    /// Viewports of the faces.
+    SharedPtr<Viewport> viewports_[MAX_CUBEMAP_FACES];
+    /// Next face to render.
+    unsigned nextFace_{};
+    /// Faces left to render in the current capture.
+    unsigned facesRemaining_{ MAX_CUBEMAP_FACES };
+    /// Frame number of the last rendered face.
+    unsigned lastUpdateFrame_{};
+    /// Whether all faces have been rendered at least once.
+    bool captured_{};
+};
+
+}
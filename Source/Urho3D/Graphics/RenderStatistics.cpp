@@ -0,0 +1,196 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Core/StringUtils.h"
+#include "../Graphics/Batch.h"
+#include "../Graphics/Graphics.h"
+#include "../Graphics/GraphicsEvents.h"
+#include "../Graphics/Material.h"
+#include "../Graphics/RenderStatistics.h"
+#include "../Graphics/Technique.h"
+
+#include <EASTL/sort.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+static const char* renderStatisticsGroupNames[] =
+{
+    "Pass",
+    "Material",
+    "Drawable",
+};
+
+/// Return difference of counters.
+static RenderStatisticsCounters SubtractCounters(const RenderStatisticsCounters& lhs, const RenderStatisticsCounters& rhs)
+{
+    RenderStatisticsCounters result;
+    result.batches_ = lhs.batches_ - rhs.batches_;
+    result.primitives_ = lhs.primitives_ - rhs.primitives_;
+    result.stateChanges_ = lhs.stateChanges_ - rhs.stateChanges_;
+    result.shaderChanges_ = lhs.shaderChanges_ - rhs.shaderChanges_;
+    result.textureChanges_ = lhs.textureChanges_ - rhs.textureChanges_;
+    return result;
+}
+
+/// Copy entries of a map into a vector sorted by number of draw calls.
+template <class T> static void SortEntries(const T& map, ea::vector<RenderStatisticsEntry>& entries)
+{
+    entries.clear();
+    for (const auto& item : map)
+        entries.push_back(item.second);
+
+    ea::sort(entries.begin(), entries.end(), [](const RenderStatisticsEntry& lhs, const RenderStatisticsEntry& rhs)
+    {
+        if (lhs.counters_.batches_ != rhs.counters_.batches_)
+            return lhs.counters_.batches_ > rhs.counters_.batches_;
+        return lhs.counters_.primitives_ > rhs.counters_.primitives_;
+    });
+}
+
+/// Format counters as text.
+static ea::string FormatCounters(const RenderStatisticsCounters& counters)
+{
+    return Format("{} batches ({} instanced, {} instances), {} primitives, {} states, {} shaders, {} textures",
+        counters.batches_, counters.instancedBatches_, counters.instances_, counters.primitives_, counters.stateChanges_,
+        counters.shaderChanges_, counters.textureChanges_);
+}
+
+RenderStatistics::RenderStatistics(Context* context) :
+    Object(context),
+    graphics_(GetSubsystem<Graphics>())
+{
+    SubscribeToEvent(E_BEGINRENDERING, URHO3D_HANDLER(RenderStatistics, HandleBeginRendering));
+    SubscribeToEvent(E_ENDRENDERING, URHO3D_HANDLER(RenderStatistics, HandleEndRendering));
+}
+
+RenderStatistics::~RenderStatistics() = default;
+
+void RenderStatistics::BeginBatch()
+{
+    batchBegin_ = GetGraphicsCounters();
+}
+
+void RenderStatistics::EndBatch(const Batch& batch, unsigned numInstances)
+{
+    RenderStatisticsCounters counters = SubtractCounters(GetGraphicsCounters(), batchBegin_);
+    if (numInstances)
+    {
+        counters.instancedBatches_ = counters.batches_;
+        counters.instances_ = numInstances;
+    }
+
+    currentSceneCounters_ += counters;
+
+    if (Pass* pass = batch.pass_)
+    {
+        RenderStatisticsEntry& entry = passes_[pass->GetIndex()];
+        if (entry.name_.empty())
+            entry.name_ = pass->GetName();
+        entry.counters_ += counters;
+    }
+
+    {
+        auto iter = materials_.find(batch.material_);
+        if (iter == materials_.end())
+        {
+            iter = materials_.emplace(batch.material_, RenderStatisticsEntry{}).first;
+            if (!batch.material_)
+                iter->second.name_ = "(default)";
+            else if (batch.material_->GetName().empty())
+                iter->second.name_ = "(unnamed)";
+            else
+                iter->second.name_ = batch.material_->GetName();
+        }
+        iter->second.counters_ += counters;
+    }
+
+    {
+        auto iter = drawableTypes_.find(batch.drawableType_);
+        if (iter == drawableTypes_.end())
+        {
+            iter = drawableTypes_.emplace(batch.drawableType_, RenderStatisticsEntry{}).first;
+            const ea::string& typeName = context_->GetTypeName(batch.drawableType_);
+            iter->second.name_ = !typeName.empty() ? typeName : batch.drawableType_.ToString();
+        }
+        iter->second.counters_ += counters;
+    }
+}
+
+ea::string RenderStatistics::PrintData(unsigned maxEntries) const
+{
+    ea::string output = Format("Frame: {}\nScene: {}\n", FormatCounters(frameCounters_), FormatCounters(sceneCounters_));
+    for (unsigned group = 0; group < MAX_RENDER_STATISTICS_GROUPS; ++group)
+    {
+        const ea::vector<RenderStatisticsEntry>& entries = entries_[group];
+        for (unsigned i = 0; i < entries.size() && i < maxEntries; ++i)
+        {
+            output += Format("  {} {}: {}\n", renderStatisticsGroupNames[group], entries[i].name_,
+                FormatCounters(entries[i].counters_));
+        }
+        if (entries.size() > maxEntries)
+            output += Format("  {} more {} entries\n", entries.size() - maxEntries, renderStatisticsGroupNames[group]);
+    }
+    return output;
+}
+
+void RenderStatistics::HandleBeginRendering(StringHash eventType, VariantMap& eventData)
+{
+    passes_.clear();
+    materials_.clear();
+    drawableTypes_.clear();
+    currentSceneCounters_ = RenderStatisticsCounters{};
+}
+
+void RenderStatistics::HandleEndRendering(StringHash eventType, VariantMap& eventData)
+{
+    SortEntries(passes_, entries_[RSG_PASS]);
+    SortEntries(materials_, entries_[RSG_MATERIAL]);
+    SortEntries(drawableTypes_, entries_[RSG_DRAWABLE_TYPE]);
+    sceneCounters_ = currentSceneCounters_;
+
+    frameCounters_ = GetGraphicsCounters();
+    frameCounters_.instancedBatches_ = sceneCounters_.instancedBatches_;
+    frameCounters_.instances_ = sceneCounters_.instances_;
+}
+
+RenderStatisticsCounters RenderStatistics::GetGraphicsCounters() const
+{
+    RenderStatisticsCounters counters;
+    if (graphics_)
+    {
+        counters.batches_ = graphics_->GetNumBatches();
+        counters.primitives_ = graphics_->GetNumPrimitives();
+        counters.stateChanges_ = graphics_->GetNumStateChanges();
+        counters.shaderChanges_ = graphics_->GetNumShaderChanges();
+        counters.textureChanges_ = graphics_->GetNumTextureChanges();
+    }
+    return counters;
+}
+
+}
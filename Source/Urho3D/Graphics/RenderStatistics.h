@@ -0,0 +1,141 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Core/Object.h"
+
+#include <EASTL/unordered_map.h>
+
+namespace Urho3D
+{
+
+class Graphics;
+class Material;
+class Pass;
+struct Batch;
+
+/// Grouping of render statistics.
+enum RenderStatisticsGroup
+{
+    RSG_PASS = 0,
+    RSG_MATERIAL,
+    RSG_DRAWABLE_TYPE,
+    MAX_RENDER_STATISTICS_GROUPS
+};
+
+/// Render statistics counters.
+struct RenderStatisticsCounters
+{
+    /// Add counters.
+    RenderStatisticsCounters& operator +=(const RenderStatisticsCounters& rhs)
+    {
+        batches_ += rhs.batches_;
+        instancedBatches_ += rhs.instancedBatches_;
+        instances_ += rhs.instances_;
+        primitives_ += rhs.primitives_;
+        stateChanges_ += rhs.stateChanges_;
+        shaderChanges_ += rhs.shaderChanges_;
+        textureChanges_ += rhs.textureChanges_;
+        return *this;
+    }
+
+    /// Number of draw calls.
+    unsigned batches_{};
+    /// Number of instanced draw calls.
+    unsigned instancedBatches_{};
+    /// Number of instances drawn by instanced draw calls.
+    unsigned instances_{};
+    /// Number of primitives.
+    unsigned primitives_{};
+    /// Number of render state changes.
+    unsigned stateChanges_{};
+    /// Number of shader program switches.
+    unsigned shaderChanges_{};
+    /// Number of texture binds.
+    unsigned textureChanges_{};
+};
+
+/// Render statistics of one pass, material or drawable type.
+struct RenderStatisticsEntry
+{
+    /// Pass, material or drawable type name.
+    ea::string name_;
+    /// Counters.
+    RenderStatisticsCounters counters_;
+};
+
+/// Attributes draw calls, primitives and state changes of scene batches to passes, materials and drawable types. Results are available for the last finished frame.
+class URHO3D_API RenderStatistics : public Object
+{
+    URHO3D_OBJECT(RenderStatistics, Object);
+
+public:
+    /// Construct.
+    explicit RenderStatistics(Context* context);
+    /// Destruct.
+    ~RenderStatistics() override;
+
+    /// Begin drawing a batch. Records the graphics counters.
+    void BeginBatch();
+    /// End drawing a batch and attribute the change of the graphics counters to it. Number of instances is zero for non-instanced batches.
+    void EndBatch(const Batch& batch, unsigned numInstances);
+
+    /// Return entries of a group in the last frame, sorted by number of draw calls.
+    const ea::vector<RenderStatisticsEntry>& GetEntries(RenderStatisticsGroup group) const { return entries_[group]; }
+    /// Return sum of the counters of all scene batches in the last frame.
+    const RenderStatisticsCounters& GetSceneCounters() const { return sceneCounters_; }
+    /// Return counters of all rendering in the last frame, including UI and debug geometry.
+    const RenderStatisticsCounters& GetFrameCounters() const { return frameCounters_; }
+    /// Return counters and the largest entries of each group as text.
+    ea::string PrintData(unsigned maxEntries = 8) const;
+
+private:
+    /// Handle begin of rendering: clear the current frame.
+    void HandleBeginRendering(StringHash eventType, VariantMap& eventData);
+    /// Handle end of rendering: publish the current frame.
+    void HandleEndRendering(StringHash eventType, VariantMap& eventData);
+    /// Return current graphics counters.
+    RenderStatisticsCounters GetGraphicsCounters() const;
+
+    /// Graphics subsystem.
+    WeakPtr<Graphics> graphics_;
+    /// Graphics counters at the beginning of the current batch.
+    RenderStatisticsCounters batchBegin_;
+    /// Current frame entries by pass index.
+    ea::unordered_map<unsigned, RenderStatisticsEntry> passes_;
+    /// Current frame entries by material.
+    ea::unordered_map<const Material*, RenderStatisticsEntry> materials_;
+    /// Current frame entries by drawable type.
+    ea::unordered_map<StringHash, RenderStatisticsEntry> drawableTypes_;
+    /// Sum of the scene batches in the current frame.
+    RenderStatisticsCounters currentSceneCounters_;
+    /// Sorted entries of the last frame.
+    ea::vector<RenderStatisticsEntry> entries_[MAX_RENDER_STATISTICS_GROUPS];
+    /// Sum of the scene batches in the last frame.
+    RenderStatisticsCounters sceneCounters_;
+    /// Counters of all rendering in the last frame.
+    RenderStatisticsCounters frameCounters_;
+};
+
+}
@@ -24,17 +24,22 @@
 
 #include "../Core/CoreEvents.h"
 #include "../Core/Context.h"
+#include "../Core/MemoryTracker.h"
 #include "../Core/Profiler.h"
+#include "../Engine/Engine.h"
 #include "../Graphics/Camera.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/Geometry.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/GraphicsEvents.h"
 #include "../Graphics/GraphicsImpl.h"
+#include "../Graphics/GPUProfiler.h"
+#include "../Graphics/RenderStatistics.h"
 #include "../Graphics/IndexBuffer.h"
 #include "../Graphics/Material.h"
 #include "../Graphics/OcclusionBuffer.h"
 #include "../Graphics/Octree.h"
+#include "../Graphics/ReflectionProbe.h"
 #include "../Graphics/Renderer.h"
 #include "../Graphics/RenderPath.h"
 #include "../Graphics/ShaderVariation.h"
@@ -50,6 +55,7 @@
 #include "../Scene/Scene.h"
 
 #include <EASTL/functional.h>
+#include <EASTL/sort.h>
 
 #include "../DebugNew.h"
 
@@ -178,6 +184,34 @@ static const unsigned short spotLightIndexData[] =
     7, 6, 5
 };
 
+static const float boxVertexData[] =
+{
+    -0.5f, -0.5f, -0.5f,
+    0.5f, -0.5f, -0.5f,
+    0.5f, 0.5f, -0.5f,
+    -0.5f, 0.5f, -0.5f,
+    -0.5f, -0.5f, 0.5f,
+    0.5f, -0.5f, 0.5f,
+    0.5f, 0.5f, 0.5f,
+    -0.5f, 0.5f, 0.5f,
+};
+
+static const unsigned short boxIndexData[] =
+{
+    0, 2, 1,
+    0, 3, 2,
+    4, 5, 6,
+    4, 6, 7,
+    0, 1, 5,
+    0, 5, 4,
+    3, 6, 2,
+    3, 7, 6,
+    0, 4, 7,
+    0, 7, 3,
+    1, 2, 6,
+    1, 6, 5
+};
+
 static const char* geometryVSVariations[] =
 {
     "",
@@ -257,21 +291,10 @@ static const unsigned MAX_BUFFER_AGE = 1000;
 
 static const int MAX_EXTRA_INSTANCING_BUFFER_ELEMENTS = 4;
 
-inline ea::vector<VertexElement> CreateInstancingBufferElements(unsigned numExtraElements)
-{
-    static const unsigned NUM_INSTANCEMATRIX_ELEMENTS = 3;
-#if URHO3D_SPHERICAL_HARMONICS
-    static const unsigned NUM_SHADERPARAMETER_ELEMENTS = 7;
-#else
-    static const unsigned NUM_SHADERPARAMETER_ELEMENTS = 1;
-#endif
-    static const unsigned FIRST_UNUSED_TEXCOORD = 4;
-
-    ea::vector<VertexElement> elements;
-    for (unsigned i = 0; i < NUM_INSTANCEMATRIX_ELEMENTS + NUM_SHADERPARAMETER_ELEMENTS + numExtraElements; ++i)
-        elements.push_back(VertexElement(TYPE_VECTOR4, SEM_TEXCOORD, FIRST_UNUSED_TEXCOORD + i, true));
-    return elements;
-}
+/// Dynamic resolution scale step. Screen buffers are pooled by size, so a coarse step keeps their number low.
+static const float RESOLUTION_SCALE_STEP = 0.05f;
+/// Rate at which the dynamic resolution scale follows the measured GPU time.
+static const float RESOLUTION_SCALE_RESPONSE = 0.1f;
 
 Renderer::Renderer(Context* context) :
     Object(context),
@@ -350,6 +373,11 @@ void Renderer::SetDefaultTechnique(Technique* technique)
     defaultTechnique_ = technique;
 }
 
+void Renderer::SetPickTechnique(Technique* technique)
+{
+    pickTechnique_ = technique;
+}
+
 void Renderer::SetHDRRendering(bool enable)
 {
     hdrRendering_ = enable;
@@ -485,6 +513,66 @@ void Renderer::SetReuseShadowMaps(bool enable)
     reuseShadowMaps_ = enable;
 }
 
+void Renderer::SetGPUProfiling(bool enable)
+{
+    if (enable == GetGPUProfiling())
+        return;
+
+    if (enable)
+    {
+        gpuProfiler_ = MakeShared<GPUProfiler>(context_);
+        if (!gpuProfiler_->IsSupported())
+            URHO3D_LOGWARNING("GPU timestamp queries are not supported, GPU profiling does not report results");
+    }
+    else
+        gpuProfiler_ = nullptr;
+}
+
+void Renderer::SetRenderStatistics(bool enable)
+{
+    if (enable == GetRenderStatisticsEnabled())
+        return;
+
+    renderStatistics_ = enable ? MakeShared<RenderStatistics>(context_) : nullptr;
+}
+
+void Renderer::SetDynamicResolution(bool enable)
+{
+    if (enable == GetDynamicResolution())
+        return;
+
+    if (enable)
+    {
+        dynamicResolutionProfiler_ = MakeShared<GPUProfiler>(context_);
+        dynamicResolutionFrames_ = 0;
+        if (!dynamicResolutionProfiler_->IsSupported())
+            URHO3D_LOGWARNING("GPU timestamp queries are not supported, dynamic resolution uses the frame time");
+    }
+    else
+    {
+        dynamicResolutionProfiler_ = nullptr;
+        resolutionScale_ = targetResolutionScale_ = 1.0f;
+    }
+}
+
+void Renderer::SetResolutionScaleRange(float minScale, float maxScale)
+{
+    maxResolutionScale_ = Clamp(maxScale, M_EPSILON, 1.0f);
+    minResolutionScale_ = Clamp(minScale, M_EPSILON, maxResolutionScale_);
+    if (dynamicResolutionProfiler_)
+    {
+        resolutionScale_ = Clamp(resolutionScale_, minResolutionScale_, maxResolutionScale_);
+        targetResolutionScale_ = Clamp(targetResolutionScale_, minResolutionScale_, maxResolutionScale_);
+    }
+}
+
+void Renderer::SetCacheShadowMaps(bool enable)
+{
+    cacheShadowMaps_ = enable;
+    if (!cacheShadowMaps_)
+        cachedShadowMaps_.clear();
+}
+
 void Renderer::SetMaxShadowMaps(int shadowMaps)
 {
     if (shadowMaps < 1)
@@ -531,6 +619,11 @@ void Renderer::SetMaxOccluderTriangles(int triangles)
     maxOccluderTriangles_ = Max(triangles, 0);
 }
 
+void Renderer::SetMaxPixelLights(int lights)
+{
+    maxPixelLights_ = Max(lights, 0);
+}
+
 void Renderer::SetOcclusionBufferSize(int size)
 {
     occlusionBufferSize_ = Max(size, 1);
@@ -621,6 +714,15 @@ Technique* Renderer::GetDefaultTechnique() const
     return defaultTechnique_;
 }
 
+Technique* Renderer::GetPickTechnique() const
+{
+    // Assign default when first asked if not assigned yet
+    if (!pickTechnique_)
+        const_cast<SharedPtr<Technique>& >(pickTechnique_) = GetSubsystem<ResourceCache>()->GetResource<Technique>("Techniques/Pick.xml");
+
+    return pickTechnique_;
+}
+
 unsigned Renderer::GetNumGeometries(bool allViews) const
 {
     unsigned numGeometries = 0;
@@ -698,6 +800,7 @@ unsigned Renderer::GetNumOccluders(bool allViews) const
 void Renderer::Update(float timeStep)
 {
     URHO3D_PROFILE("UpdateViews");
+    MemoryTagScope memoryTag(MEMORY_TAG_GRAPHICS);
 
     views_.clear();
     preparedViews_.clear();
@@ -719,6 +822,16 @@ void Renderer::Update(float timeStep)
     if (shadersDirty_)
         LoadShaders();
 
+    UpdateDynamicResolution(timeStep);
+
+    // Give back dropped texture mip levels once memory is available again. Check rarely, as each restore is a reload
+    streamedMipsRestoreTimer_ += timeStep;
+    if (streamedMipsRestoreTimer_ >= 1.0f)
+    {
+        streamedMipsRestoreTimer_ = 0.0f;
+        Texture2D::RestoreStreamedMips(GetSubsystem<ResourceCache>());
+    }
+
     // Queue update of the main viewports. Use reverse order, as rendering order is also reverse
     // to render auxiliary views before dependent main views
     for (unsigned i = viewports_.size() - 1; i < viewports_.size(); --i)
@@ -726,18 +839,26 @@ void Renderer::Update(float timeStep)
 
     // Update main viewports. This may queue further views
     unsigned numMainViewports = queuedViewports_.size();
-    for (unsigned i = 0; i < numMainViewports; ++i)
-        UpdateQueuedViewport(i);
+    UpdateQueuedViewports(0, numMainViewports);
+
+    // Queue reflection probe faces now that the main cameras are known
+    UpdateReflectionProbes();
 
     // Gather queued & autoupdated render surfaces
     SendEvent(E_RENDERSURFACEUPDATE);
 
-    // Update viewports that were added as result of the event above
-    for (unsigned i = numMainViewports; i < queuedViewports_.size(); ++i)
-        UpdateQueuedViewport(i);
+    // Update viewports that were added as result of the event above. Updating them may queue further views
+    for (unsigned begin = numMainViewports; begin < queuedViewports_.size();)
+    {
+        const unsigned end = queuedViewports_.size();
+        UpdateQueuedViewports(begin, end);
+        begin = end;
+    }
 
     queuedViewports_.clear();
     resetViews_ = false;
+
+    RemoveUnusedCachedShadowMaps();
 }
 
 void Renderer::Render()
@@ -746,6 +867,7 @@ void Renderer::Render()
     assert(graphics_ && graphics_->IsInitialized() && !graphics_->IsDeviceLost());
 
     URHO3D_PROFILE("RenderViews");
+    MemoryTagScope memoryTag(MEMORY_TAG_GRAPHICS);
 
     // If the indirection textures have lost content (OpenGL mode only), restore them now
     if (faceSelectCubeMap_ && faceSelectCubeMap_->IsDataLost())
@@ -887,6 +1009,11 @@ Geometry* Renderer::GetQuadGeometry()
     return dirLightGeometry_;
 }
 
+Geometry* Renderer::GetBoxGeometry()
+{
+    return boxGeometry_;
+}
+
 Texture2D* Renderer::GetShadowMap(Light* light, Camera* camera, unsigned viewWidth, unsigned viewHeight)
 {
     LightType type = light->GetLightType();
@@ -943,6 +1070,10 @@ Texture2D* Renderer::GetShadowMap(Light* light, Camera* camera, unsigned viewWid
         height *= 3;
     }
 
+    // Point and spot lights may keep their shadow map between frames
+    if (cacheShadowMaps_ && !reuseShadowMaps_ && type != LIGHT_DIRECTIONAL)
+        return GetCachedShadowMap(light, width, height);
+
     int searchKey = width << 16u | height;
     if (shadowMaps_.contains(searchKey))
     {
@@ -963,6 +1094,18 @@ Texture2D* Renderer::GetShadowMap(Light* light, Camera* camera, unsigned viewWid
         }
     }
 
+    SharedPtr<Texture2D> newShadowMap = CreateShadowMap(width, height);
+    shadowMaps_[searchKey].push_back(newShadowMap);
+    if (!reuseShadowMaps_)
+        shadowMapAllocations_[searchKey].push_back(light);
+
+    return newShadowMap;
+}
+
+SharedPtr<Texture2D> Renderer::CreateShadowMap(int width, int height)
+{
+    int searchKey = width << 16u | height;
+
     // Find format and usage of the shadow map
     unsigned shadowMapFormat = 0;
     TextureUsage shadowMapUsage = TEXTURE_DEPTHSTENCIL;
@@ -989,7 +1132,7 @@ Texture2D* Renderer::GetShadowMap(Light* light, Camera* camera, unsigned viewWid
     }
 
     if (!shadowMapFormat)
-        return nullptr;
+        return SharedPtr<Texture2D>();
 
     SharedPtr<Texture2D> newShadowMap(context_->CreateObject<Texture2D>());
     int retries = 3;
@@ -1036,17 +1179,67 @@ Texture2D* Renderer::GetShadowMap(Light* light, Camera* camera, unsigned viewWid
         }
     }
 
-    // If failed to set size, store a null pointer so that we will not retry
+    // If failed to set size, return a null pointer so that we will not retry
     if (!retries)
         newShadowMap.Reset();
 
-    shadowMaps_[searchKey].push_back(newShadowMap);
-    if (!reuseShadowMaps_)
-        shadowMapAllocations_[searchKey].push_back(light);
-
     return newShadowMap;
 }
 
+Texture2D* Renderer::GetCachedShadowMap(Light* light, int width, int height)
+{
+    CachedShadowMap& entry = cachedShadowMaps_[light];
+    // The light pointer may have been reused by a new light
+    if (entry.light_ != light)
+    {
+        entry = CachedShadowMap();
+        entry.light_ = light;
+    }
+
+    if (!entry.shadowMap_ || entry.size_ != IntVector2(width, height))
+    {
+        entry.shadowMap_ = CreateShadowMap(width, height);
+        entry.size_ = IntVector2(width, height);
+        entry.contentValid_ = false;
+    }
+
+    entry.lastFrame_ = frame_.frameNumber_;
+    return entry.shadowMap_;
+}
+
+bool Renderer::IsShadowMapContentValid(Light* light, unsigned contentHash) const
+{
+    auto i = cachedShadowMaps_.find(light);
+    if (i == cachedShadowMaps_.end() || !i->second.shadowMap_)
+        return false;
+
+    const CachedShadowMap& entry = i->second;
+    return contentHash && entry.contentValid_ && entry.contentHash_ == contentHash && !entry.shadowMap_->IsDataLost();
+}
+
+void Renderer::SetShadowMapContentHash(Light* light, unsigned contentHash)
+{
+    auto i = cachedShadowMaps_.find(light);
+    if (i == cachedShadowMaps_.end() || !i->second.shadowMap_)
+        return;
+
+    CachedShadowMap& entry = i->second;
+    entry.contentHash_ = contentHash;
+    entry.contentValid_ = contentHash != 0;
+    entry.shadowMap_->ClearDataLost();
+}
+
+void Renderer::RemoveUnusedCachedShadowMaps()
+{
+    for (auto i = cachedShadowMaps_.begin(); i != cachedShadowMaps_.end();)
+    {
+        if (i->second.light_.Expired() || i->second.lastFrame_ != frame_.frameNumber_)
+            i = cachedShadowMaps_.erase(i);
+        else
+            ++i;
+    }
+}
+
 Texture* Renderer::GetScreenBuffer(int width, int height, unsigned format, int multiSample, bool autoResolve, bool cubemap, bool filtered, bool srgb,
     unsigned persistentKey)
 {
@@ -1166,6 +1359,21 @@ OcclusionBuffer* Renderer::GetOcclusionBuffer(Camera* camera)
     int width = occlusionBufferSize_;
     auto height = RoundToInt(occlusionBufferSize_ / camera->GetAspectRatio());
 
+    // Prefer the buffer last rendered from the same view so that its content may be reused
+    if (reuseOcclusion_)
+    {
+        const Matrix4 viewProj = camera->GetProjection() * camera->GetView();
+        for (unsigned i = numOcclusionBuffers_; i < occlusionBuffers_.size(); ++i)
+        {
+            if (occlusionBuffers_[i]->GetContentViewProj() == viewProj)
+            {
+                if (i != numOcclusionBuffers_)
+                    ea::swap(occlusionBuffers_[numOcclusionBuffers_], occlusionBuffers_[i]);
+                break;
+            }
+        }
+    }
+
     OcclusionBuffer* buffer = occlusionBuffers_[numOcclusionBuffers_++];
     buffer->SetSize(width, height, threadedOcclusion_);
     buffer->SetView(camera);
@@ -1213,6 +1421,22 @@ View* Renderer::GetActualView(View* view)
         return view;
 }
 
+ea::vector<VertexElement> Renderer::GetInstancingBufferElements(unsigned numExtraElements)
+{
+    static const unsigned NUM_INSTANCEMATRIX_ELEMENTS = 3;
+#if URHO3D_SPHERICAL_HARMONICS
+    static const unsigned NUM_SHADERPARAMETER_ELEMENTS = 7;
+#else
+    static const unsigned NUM_SHADERPARAMETER_ELEMENTS = 1;
+#endif
+    static const unsigned FIRST_UNUSED_TEXCOORD = 4;
+
+    ea::vector<VertexElement> elements;
+    for (unsigned i = 0; i < NUM_INSTANCEMATRIX_ELEMENTS + NUM_SHADERPARAMETER_ELEMENTS + numExtraElements; ++i)
+        elements.push_back(VertexElement(TYPE_VECTOR4, SEM_TEXCOORD, FIRST_UNUSED_TEXCOORD + i, true));
+    return elements;
+}
+
 void Renderer::SetBatchShaders(Batch& batch, Technique* tech, bool allowShadows, const BatchQueue& queue)
 {
     Pass* pass = batch.pass_;
@@ -1410,7 +1634,7 @@ bool Renderer::ResizeInstancingBuffer(unsigned numInstances)
     while (newSize < numInstances)
         newSize <<= 1;
 
-    const ea::vector<VertexElement> instancingBufferElements = CreateInstancingBufferElements(numExtraInstancingBufferElements_);
+    const ea::vector<VertexElement> instancingBufferElements = GetInstancingBufferElements(numExtraInstancingBufferElements_);
     if (!instancingBuffer_->SetSize(newSize, instancingBufferElements, true))
     {
         URHO3D_LOGERROR("Failed to resize instancing buffer to " + ea::to_string(newSize));
@@ -1420,9 +1644,39 @@ bool Renderer::ResizeInstancingBuffer(unsigned numInstances)
     }
 
     URHO3D_LOGDEBUG("Resized instancing buffer to " + ea::to_string(newSize));
+    instancingBufferOffset_ = 0;
     return true;
 }
 
+void* Renderer::LockInstancingBuffer(unsigned numInstances, unsigned& startIndex)
+{
+    // Size the ring for several frames so that it is normally appended to without overwriting data still in use by the GPU
+    if (!numInstances || !ResizeInstancingBuffer(numInstances * INSTANCING_BUFFER_RING_FRAMES))
+        return nullptr;
+
+    // Discard and start from the beginning when the ring wraps around, otherwise append without overwrite
+    bool discard = false;
+    if (instancingBufferOffset_ + numInstances > instancingBuffer_->GetVertexCount())
+    {
+        instancingBufferOffset_ = 0;
+        discard = true;
+    }
+
+    void* dest = instancingBuffer_->Lock(instancingBufferOffset_, numInstances, discard);
+    if (!dest)
+        return nullptr;
+
+    startIndex = instancingBufferOffset_;
+    instancingBufferOffset_ += numInstances;
+    return dest;
+}
+
+void Renderer::UnlockInstancingBuffer()
+{
+    if (instancingBuffer_)
+        instancingBuffer_->Unlock();
+}
+
 void Renderer::OptimizeLightByScissor(Light* light, Camera* camera)
 {
     if (light && light->GetLightType() != LIGHT_DIRECTIONAL)
@@ -1526,14 +1780,98 @@ const Rect& Renderer::GetLightScissor(Light* light, Camera* camera)
     }
 }
 
-void Renderer::UpdateQueuedViewport(unsigned index)
+void Renderer::UpdateDynamicResolution(float timeStep)
+{
+    if (!dynamicResolutionProfiler_)
+        return;
+
+    // Use each GPU frame measurement once. Without timestamp query support, fall back to the whole frame time
+    float frameTime;
+    if (dynamicResolutionProfiler_->IsSupported())
+    {
+        const unsigned numFrames = dynamicResolutionProfiler_->GetNumResolvedFrames();
+        if (numFrames == dynamicResolutionFrames_)
+            return;
+        dynamicResolutionFrames_ = numFrames;
+        frameTime = dynamicResolutionProfiler_->GetFrameTime();
+    }
+    else
+        frameTime = timeStep * 1000.0f;
+
+    if (frameTime <= 0.0f)
+        return;
+
+    // The pixel cost is proportional to the square of the scale
+    const float desiredScale = resolutionScale_ * sqrtf(dynamicResolutionTargetTime_ / frameTime);
+    targetResolutionScale_ = Clamp(Lerp(targetResolutionScale_, desiredScale, RESOLUTION_SCALE_RESPONSE),
+        minResolutionScale_, maxResolutionScale_);
+
+    // Change the applied scale only when the target has moved a full step away from it to avoid oscillation
+    if (Abs(targetResolutionScale_ - resolutionScale_) >= RESOLUTION_SCALE_STEP || targetResolutionScale_ == maxResolutionScale_ ||
+        targetResolutionScale_ == minResolutionScale_)
+    {
+        resolutionScale_ = Clamp(Round(targetResolutionScale_ / RESOLUTION_SCALE_STEP) * RESOLUTION_SCALE_STEP,
+            minResolutionScale_, maxResolutionScale_);
+    }
+}
+
+void Renderer::AddReflectionProbe(ReflectionProbe* probe)
+{
+    if (probe && !reflectionProbes_.contains(WeakPtr<ReflectionProbe>(probe)))
+        reflectionProbes_.push_back(WeakPtr<ReflectionProbe>(probe));
+}
+
+void Renderer::RemoveReflectionProbe(ReflectionProbe* probe)
+{
+    reflectionProbes_.erase_first(WeakPtr<ReflectionProbe>(probe));
+}
+
+void Renderer::UpdateReflectionProbes()
+{
+    if (reflectionProbes_.empty() || !reflectionProbeFacesPerFrame_)
+        return;
+
+    URHO3D_PROFILE("UpdateReflectionProbes");
+
+    ea::vector<Camera*> cameras;
+    for (View* view : views_)
+    {
+        if (view && view->GetCamera())
+            cameras.push_back(view->GetCamera());
+    }
+
+    ea::vector<ea::pair<float, ReflectionProbe*> > candidates;
+    for (unsigned i = 0; i < reflectionProbes_.size();)
+    {
+        ReflectionProbe* probe = reflectionProbes_[i];
+        if (!probe)
+        {
+            reflectionProbes_.erase_at(i);
+            continue;
+        }
+
+        const float priority = probe->GetUpdatePriority(cameras, frame_.frameNumber_);
+        if (priority > 0.0f)
+            candidates.emplace_back(priority, probe);
+        ++i;
+    }
+
+    // At most one face per probe per frame, so that the budget is shared between the most important probes
+    const unsigned numFaces = Min(reflectionProbeFacesPerFrame_, candidates.size());
+    ea::partial_sort(candidates.begin(), candidates.begin() + numFaces, candidates.end(),
+        [](const ea::pair<float, ReflectionProbe*>& lhs, const ea::pair<float, ReflectionProbe*>& rhs) { return lhs.first > rhs.first; });
+    for (unsigned i = 0; i < numFaces; ++i)
+        candidates[i].second->QueueNextFace(frame_.frameNumber_);
+}
+
+View* Renderer::DefineQueuedViewport(unsigned index)
 {
     WeakPtr<RenderSurface>& renderTarget = queuedViewports_[index].first;
     WeakPtr<Viewport>& viewport = queuedViewports_[index].second;
 
     // Null pointer means backbuffer view. Differentiate between that and an expired rendersurface
     if ((renderTarget && renderTarget.Expired()) || viewport.Expired())
-        return;
+        return nullptr;
 
     // (Re)allocate the view structure if necessary
     if (!viewport->GetView() || resetViews_)
@@ -1543,14 +1881,14 @@ void Renderer::UpdateQueuedViewport(unsigned index)
     assert(view);
     // Check if view can be defined successfully (has either valid scene, camera and octree, or no scene passes)
     if (!view->Define(renderTarget, viewport))
-        return;
+        return nullptr;
 
     views_.push_back(WeakPtr<View>(view));
 
     const IntRect& viewRect = viewport->GetRect();
     Scene* scene = viewport->GetScene();
     if (!scene)
-        return;
+        return view;
 
     auto* octree = scene->GetComponent<Octree>();
 
@@ -1572,9 +1910,61 @@ void Renderer::UpdateQueuedViewport(unsigned index)
             debug->SetView(viewport->GetCamera());
     }
 
-    // Update view. This may queue further views. View will send update begin/end events once its state is set
-    ResetShadowMapAllocations(); // Each view can reuse the same shadow maps
-    view->Update(frame_);
+    return view;
+}
+
+void Renderer::UpdateQueuedViewports(unsigned begin, unsigned end)
+{
+    // Define all views first, so that views of the same octree can be culled together
+    ea::vector<View*> views;
+    for (unsigned i = begin; i < end; ++i)
+    {
+        if (View* view = DefineQueuedViewport(i))
+            views.push_back(view);
+    }
+
+    // Group the views by octree and cull each group with one octree traversal
+    if (views.size() > 1)
+    {
+        URHO3D_PROFILE("SharedCulling");
+
+        ea::vector<bool> grouped(views.size());
+        for (unsigned i = 0; i < views.size(); ++i)
+        {
+            Octree* octree = views[i]->GetOctree();
+            if (grouped[i] || !octree)
+                continue;
+
+            unsigned numGroupViews = 0;
+            for (unsigned j = i; j < views.size(); ++j)
+            {
+                if (!grouped[j] && views[j]->GetOctree() == octree && !views[j]->GetSourceView())
+                    ++numGroupViews;
+            }
+            if (numGroupViews < 2)
+                continue;
+
+            octree->UpdateCullingData();
+            ea::vector<Drawable*> unused;
+            MultiFrustumOctreeQuery query(unused, DRAWABLE_GEOMETRY | DRAWABLE_LIGHT | DRAWABLE_ZONE);
+            for (unsigned j = i; j < views.size(); ++j)
+            {
+                if (!grouped[j] && views[j]->GetOctree() == octree)
+                {
+                    views[j]->AddToSharedCulling(query);
+                    grouped[j] = true;
+                }
+            }
+            octree->GetDrawables(query);
+        }
+    }
+
+    // Update views. This may queue further views. View will send update begin/end events once its state is set
+    for (View* view : views)
+    {
+        ResetShadowMapAllocations(); // Each view can reuse the same shadow maps
+        view->Update(frame_);
+    }
 }
 
 void Renderer::PrepareViewRender()
@@ -1665,7 +2055,8 @@ void Renderer::Initialize()
 
     initialized_ = true;
 
-    SubscribeToEvent(E_RENDERUPDATE, URHO3D_HANDLER(Renderer, HandleRenderUpdate));
+    if (auto* engine = GetSubsystem<Engine>())
+        engine->onRenderUpdate_.Subscribe(this, &Renderer::HandleRenderUpdate);
 
     URHO3D_LOGINFO("Initialized renderer");
 }
@@ -1867,6 +2258,21 @@ void Renderer::CreateGeometries()
     pointLightGeometry_->SetIndexBuffer(plib);
     pointLightGeometry_->SetDrawRange(TRIANGLE_LIST, 0, plib->GetIndexCount());
 
+    SharedPtr<VertexBuffer> bvb(context_->CreateObject<VertexBuffer>());
+    bvb->SetShadowed(true);
+    bvb->SetSize(8, MASK_POSITION);
+    bvb->SetData(boxVertexData);
+
+    SharedPtr<IndexBuffer> bib(context_->CreateObject<IndexBuffer>());
+    bib->SetShadowed(true);
+    bib->SetSize(36, false);
+    bib->SetData(boxIndexData);
+
+    boxGeometry_ = context_->CreateObject<Geometry>();
+    boxGeometry_->SetVertexBuffer(0, bvb);
+    boxGeometry_->SetIndexBuffer(bib);
+    boxGeometry_->SetDrawRange(TRIANGLE_LIST, 0, bib->GetIndexCount());
+
 #if !defined(URHO3D_OPENGL) || !defined(GL_ES_VERSION_2_0)
     if (graphics_->GetShadowMapFormat())
     {
@@ -1944,7 +2350,8 @@ void Renderer::CreateInstancingBuffer()
     }
 
     instancingBuffer_ = context_->CreateObject<VertexBuffer>();
-    const ea::vector<VertexElement> instancingBufferElements = CreateInstancingBufferElements(numExtraInstancingBufferElements_);
+    instancingBufferOffset_ = 0;
+    const ea::vector<VertexElement> instancingBufferElements = GetInstancingBufferElements(numExtraInstancingBufferElements_);
     if (!instancingBuffer_->SetSize(INSTANCING_BUFFER_DEFAULT_SIZE, instancingBufferElements, true))
     {
         instancingBuffer_.Reset();
@@ -1957,6 +2364,7 @@ void Renderer::ResetShadowMaps()
     shadowMaps_.clear();
     shadowMapAllocations_.clear();
     colorShadowMaps_.clear();
+    cachedShadowMaps_.clear();
 }
 
 void Renderer::ResetBuffers()
@@ -2008,11 +2416,9 @@ void Renderer::HandleScreenMode(StringHash eventType, VariantMap& eventData)
         resetViews_ = true;
 }
 
-void Renderer::HandleRenderUpdate(StringHash eventType, VariantMap& eventData)
+void Renderer::HandleRenderUpdate(UpdateEventArgs& args)
 {
-    using namespace RenderUpdate;
-
-    Update(eventData[P_TIMESTEP].GetFloat());
+    Update(args.timeStep_);
 }
 
 
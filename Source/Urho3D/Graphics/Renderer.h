@@ -38,16 +38,20 @@ namespace Urho3D
 
 class Geometry;
 class Drawable;
+class GPUProfiler;
+class RenderStatistics;
 class Light;
 class Material;
 class Pass;
 class Technique;
 class Octree;
 class Graphics;
+class ReflectionProbe;
 class RenderPath;
 class RenderSurface;
 class ResourceCache;
 class Scene;
+struct UpdateEventArgs;
 class Skeleton;
 class OcclusionBuffer;
 class Technique;
@@ -60,6 +64,8 @@ struct BatchQueue;
 
 static const int SHADOW_MIN_PIXELS = 64;
 static const int INSTANCING_BUFFER_DEFAULT_SIZE = 1024;
+/// Number of frames worth of instance data the instancing buffer ring is sized for before it has to be discarded.
+static const unsigned INSTANCING_BUFFER_RING_FRAMES = 3;
 
 /// Light vertex shader variations.
 enum LightVSVariation
@@ -173,6 +179,23 @@ enum DeferredLightPSVariation
     MAX_DEFERRED_LIGHT_PS_VARIATIONS
 };
 
+/// Persistent shadow map of a light whose content can be kept between frames.
+struct CachedShadowMap
+{
+    /// Light that owns the shadow map.
+    WeakPtr<Light> light_;
+    /// Shadow map texture.
+    SharedPtr<Texture2D> shadowMap_;
+    /// Requested shadow map size. The texture may be smaller if creating it at full size failed.
+    IntVector2 size_;
+    /// Hash of the shadow cameras and casters last rendered into the shadow map.
+    unsigned contentHash_{};
+    /// Valid content flag.
+    bool contentValid_{};
+    /// Frame number on which the shadow map was last allocated.
+    unsigned lastFrame_{};
+};
+
 /// High-level rendering subsystem. Manages drawing of 3D views.
 class URHO3D_API Renderer : public Object
 {
@@ -198,6 +221,8 @@ public:
     void SetDefaultRenderPath(XMLFile* xmlFile);
     /// Set default non-textured material technique.
     void SetDefaultTechnique(Technique* technique);
+    /// Set technique used by the object ID pick pass for materials which do not define own pick pass.
+    void SetPickTechnique(Technique* technique);
     /// Set HDR rendering on/off.
     void SetHDRRendering(bool enable);
     /// Set specular lighting on/off.
@@ -228,6 +253,8 @@ public:
     void SetReuseShadowMaps(bool enable);
     /// Set maximum number of shadow maps created for one resolution. Only has effect if reuse of shadow maps is disabled.
     void SetMaxShadowMaps(int shadowMaps);
+    /// Set caching of point and spot light shadow maps. If enabled, shadow maps whose shadow cameras and shadow casters did not change are not re-rendered. Only has effect if reuse of shadow maps is disabled.
+    void SetCacheShadowMaps(bool enable);
     /// Set dynamic instancing on/off. When on (default), drawables using the same static-type geometry and material will be automatically combined to an instanced draw call.
     void SetDynamicInstancing(bool enable);
     /// Set number of extra instancing buffer elements. Default is 0. Extra 4-vectors are available through TEXCOORD7 and further.
@@ -238,12 +265,39 @@ public:
     void SetMaxSortedInstances(int instances);
     /// Set maximum number of occluder triangles.
     void SetMaxOccluderTriangles(int triangles);
+    /// Set maximum number of per-pixel lights in a forward rendered view. Less important lights beyond it are rendered per-vertex in the base pass. 0 = unlimited.
+    /// This bounds the per-light forward pass cost; there is no clustered or tiled forward path, so each per-pixel light still adds a lit pass per object.
+    void SetMaxPixelLights(int lights);
     /// Set occluder buffer width.
     void SetOcclusionBufferSize(int size);
     /// Set required screen size (1.0 = full screen) for occluders.
     void SetOccluderSizeThreshold(float screenSize);
     /// Set whether to thread occluder rendering. Default false.
     void SetThreadedOcclusion(bool enable);
+    /// Set whether to reuse previous frame occlusion buffer when neither the camera nor the occluders have changed. Default false.
+    void SetReuseOcclusion(bool enable) { reuseOcclusion_ = enable; }
+    /// Set whether to cull geometries using hardware occlusion queries of their bounding boxes. Results are one frame late. Default false.
+    void SetOcclusionQueries(bool enable) { occlusionQueries_ = enable; }
+    /// Set whether to measure GPU time of render path commands and shadow maps with timestamp queries. Default false.
+    void SetGPUProfiling(bool enable);
+    /// Set whether to break down draw calls, primitives and state changes of scene batches by pass, material and drawable type. Default false.
+    void SetRenderStatistics(bool enable);
+    /// Set whether to scale the rendering resolution of backbuffer scene views to hold the target GPU frame time. Default false.
+    void SetDynamicResolution(bool enable);
+    /// Set target GPU frame time in milliseconds for dynamic resolution. Default 16.
+    void SetDynamicResolutionTargetTime(float timeMs) { dynamicResolutionTargetTime_ = Max(timeMs, M_EPSILON); }
+    /// Set minimum and maximum resolution scale for dynamic resolution. Default 0.5 - 1.
+    void SetResolutionScaleRange(float minScale, float maxScale);
+    /// Set resolution scale of backbuffer scene views. Scenes rendered below full resolution are upscaled with sharpening. Overridden every frame when dynamic resolution is enabled. Default 1.
+    void SetResolutionScale(float scale) { resolutionScale_ = targetResolutionScale_ = Clamp(scale, M_EPSILON, 1.0f); }
+    /// Set sharpening amount of the upscale from reduced resolution. 0 disables sharpening. Default 0.5.
+    void SetUpscaleSharpness(float sharpness) { upscaleSharpness_ = Max(sharpness, 0.0f); }
+    /// Set max number of reflection probe cube map faces rendered per frame, across all probes. Default 1.
+    void SetReflectionProbeFacesPerFrame(unsigned faces) { reflectionProbeFacesPerFrame_ = faces; }
+    /// Add a reflection probe to be updated. Called by ReflectionProbe.
+    void AddReflectionProbe(ReflectionProbe* probe);
+    /// Remove a reflection probe. Called by ReflectionProbe.
+    void RemoveReflectionProbe(ReflectionProbe* probe);
     /// Set shadow depth bias multiplier for mobile platforms to counteract possible worse shadow map precision. Default 1.0 (no effect).
     void SetMobileShadowBiasMul(float mul);
     /// Set shadow depth bias addition for mobile platforms to counteract possible worse shadow map precision. Default 0.0 (no effect).
@@ -269,6 +323,8 @@ public:
     RenderPath* GetDefaultRenderPath() const;
     /// Return default non-textured material technique.
     Technique* GetDefaultTechnique() const;
+    /// Return technique used by the object ID pick pass for materials which do not define own pick pass.
+    Technique* GetPickTechnique() const;
 
     /// Return whether HDR rendering is enabled.
     bool GetHDRRendering() const { return hdrRendering_; }
@@ -309,6 +365,33 @@ public:
     /// Return whether shadow maps are reused.
     bool GetReuseShadowMaps() const { return reuseShadowMaps_; }
 
+    /// Return whether GPU time is measured.
+    bool GetGPUProfiling() const { return gpuProfiler_ != nullptr; }
+    /// Return the GPU profiler, or null if GPU profiling is disabled.
+    GPUProfiler* GetGPUProfiler() const { return gpuProfiler_; }
+    /// Return whether render statistics are collected.
+    bool GetRenderStatisticsEnabled() const { return renderStatistics_ != nullptr; }
+    /// Return the render statistics, or null if they are disabled.
+    RenderStatistics* GetRenderStatistics() const { return renderStatistics_; }
+
+    /// Return whether dynamic resolution is enabled.
+    bool GetDynamicResolution() const { return dynamicResolutionProfiler_ != nullptr; }
+    /// Return target GPU frame time in milliseconds for dynamic resolution.
+    float GetDynamicResolutionTargetTime() const { return dynamicResolutionTargetTime_; }
+    /// Return minimum resolution scale for dynamic resolution.
+    float GetMinResolutionScale() const { return minResolutionScale_; }
+    /// Return maximum resolution scale for dynamic resolution.
+    float GetMaxResolutionScale() const { return maxResolutionScale_; }
+    /// Return resolution scale of backbuffer scene views for the current frame.
+    float GetResolutionScale() const { return resolutionScale_; }
+    /// Return sharpening amount of the upscale from reduced resolution.
+    float GetUpscaleSharpness() const { return upscaleSharpness_; }
+    /// Return max number of reflection probe cube map faces rendered per frame.
+    unsigned GetReflectionProbeFacesPerFrame() const { return reflectionProbeFacesPerFrame_; }
+
+    /// Return whether point and spot light shadow maps are cached.
+    bool GetCacheShadowMaps() const { return cacheShadowMaps_; }
+
     /// Return maximum number of shadow maps per resolution.
     int GetMaxShadowMaps() const { return maxShadowMaps_; }
 
@@ -327,6 +410,9 @@ public:
     /// Return maximum number of occluder triangles.
     int GetMaxOccluderTriangles() const { return maxOccluderTriangles_; }
 
+    /// Return maximum number of per-pixel lights in a forward rendered view.
+    int GetMaxPixelLights() const { return maxPixelLights_; }
+
     /// Return occlusion buffer width.
     int GetOcclusionBufferSize() const { return occlusionBufferSize_; }
 
@@ -336,6 +422,11 @@ public:
     /// Return whether occlusion rendering is threaded.
     bool GetThreadedOcclusion() const { return threadedOcclusion_; }
 
+    /// Return whether previous frame occlusion buffer may be reused.
+    bool GetReuseOcclusion() const { return reuseOcclusion_; }
+    /// Return whether hardware occlusion queries are used.
+    bool GetOcclusionQueries() const { return occlusionQueries_; }
+
     /// Return shadow depth bias multiplier for mobile platforms.
     float GetMobileShadowBiasMul() const { return mobileShadowBiasMul_; }
 
@@ -405,8 +496,14 @@ public:
     Geometry* GetLightGeometry(Light* light);
     /// Return quad geometry used in postprocessing.
     Geometry* GetQuadGeometry();
+    /// Return unit box geometry used for occlusion queries.
+    Geometry* GetBoxGeometry();
     /// Allocate a shadow map. If shadow map reuse is disabled, a different map is returned each time.
     Texture2D* GetShadowMap(Light* light, Camera* camera, unsigned viewWidth, unsigned viewHeight);
+    /// Return whether the cached shadow map of a light already contains the content with the given hash.
+    bool IsShadowMapContentValid(Light* light, unsigned contentHash) const;
+    /// Set the content hash of the cached shadow map of a light after rendering it. Zero hash marks the content as not reusable.
+    void SetShadowMapContentHash(Light* light, unsigned contentHash);
     /// Allocate a rendertarget or depth-stencil texture for deferred rendering or postprocessing. Should only be called during actual rendering, not before.
     Texture* GetScreenBuffer
         (int width, int height, unsigned format, int multiSample, bool autoResolve, bool cubemap, bool filtered, bool srgb, unsigned persistentKey = 0);
@@ -429,6 +526,10 @@ public:
     void SetCullMode(CullMode mode, Camera* camera);
     /// Ensure sufficient size of the instancing vertex buffer. Return true if successful.
     bool ResizeInstancingBuffer(unsigned numInstances);
+    /// Allocate a range from the instancing buffer ring and lock it for writing. The previous contents of the buffer are only discarded when the ring wraps around. Return pointer to the locked range and its first instance index, or null if failed.
+    void* LockInstancingBuffer(unsigned numInstances, unsigned& startIndex);
+    /// Unlock the instancing buffer after LockInstancingBuffer.
+    void UnlockInstancingBuffer();
     /// Optimize a light by scissor rectangle.
     void OptimizeLightByScissor(Light* light, Camera* camera);
     /// Optimize a light by marking it to the stencil buffer and setting a stencil test.
@@ -438,6 +539,8 @@ public:
 
     /// Return a view or its source view if it uses one. Used internally for render statistics.
     static View* GetActualView(View* view);
+    /// Return vertex elements of an instancing buffer: the instance transform, per-instance shader parameters and extra elements.
+    static ea::vector<VertexElement> GetInstancingBufferElements(unsigned numExtraElements);
 
 private:
     /// Initialize when screen mode initially set.
@@ -454,10 +557,22 @@ private:
     void CreateGeometries();
     /// Create instancing vertex buffer.
     void CreateInstancingBuffer();
+    /// Create a shadow map texture of the given size. Return null if failed.
+    SharedPtr<Texture2D> CreateShadowMap(int width, int height);
+    /// Return the persistent shadow map of a light, recreating it if the size changed.
+    Texture2D* GetCachedShadowMap(Light* light, int width, int height);
+    /// Remove cached shadow maps of lights that were not rendered during this frame.
+    void RemoveUnusedCachedShadowMaps();
     /// Create point light shadow indirection texture data.
     void SetIndirectionTextureData();
-    /// Update a queued viewport for rendering.
-    void UpdateQueuedViewport(unsigned index);
+    /// Update the resolution scale from the measured GPU frame time.
+    void UpdateDynamicResolution(float timeStep);
+    /// Queue the reflection probe faces with the highest priority for the cameras of the main views.
+    void UpdateReflectionProbes();
+    /// Define a queued viewport for rendering and update its octree. Return the view if it should be updated.
+    View* DefineQueuedViewport(unsigned index);
+    /// Update a range of queued viewports for rendering. Views of the same octree are culled with a single shared query.
+    void UpdateQueuedViewports(unsigned begin, unsigned end);
     /// Prepare for rendering of a new view.
     void PrepareViewRender();
     /// Remove unused occlusion and screen buffers.
@@ -474,8 +589,8 @@ private:
     ea::string GetShadowVariations() const;
     /// Handle screen mode event.
     void HandleScreenMode(StringHash eventType, VariantMap& eventData);
-    /// Handle render update event.
-    void HandleRenderUpdate(StringHash eventType, VariantMap& eventData);
+    /// Handle render update signal.
+    void HandleRenderUpdate(UpdateEventArgs& args);
     /// Blur the shadow map.
     void BlurShadowMap(View* view, Texture2D* shadowMap, float blurScale);
 
@@ -483,8 +598,16 @@ private:
     WeakPtr<Graphics> graphics_;
     /// Default renderpath.
     SharedPtr<RenderPath> defaultRenderPath_;
+    /// GPU profiler, exists only when GPU profiling is enabled.
+    SharedPtr<GPUProfiler> gpuProfiler_;
+    /// GPU frame time profiler, exists only when dynamic resolution is enabled.
+    SharedPtr<GPUProfiler> dynamicResolutionProfiler_;
+    /// Render statistics, exist only when enabled.
+    SharedPtr<RenderStatistics> renderStatistics_;
     /// Default non-textured material technique.
     SharedPtr<Technique> defaultTechnique_;
+    /// Default object ID pick technique.
+    SharedPtr<Technique> pickTechnique_;
     /// Default zone.
     SharedPtr<Zone> defaultZone_;
     /// Directional light quad geometry.
@@ -493,8 +616,12 @@ private:
     SharedPtr<Geometry> spotLightGeometry_;
     /// Point light volume geometry.
     SharedPtr<Geometry> pointLightGeometry_;
+    /// Unit box geometry.
+    SharedPtr<Geometry> boxGeometry_;
     /// Instance stream vertex buffer.
     SharedPtr<VertexBuffer> instancingBuffer_;
+    /// Next free instance index in the instancing buffer ring.
+    unsigned instancingBufferOffset_{};
     /// Default material.
     SharedPtr<Material> defaultMaterial_;
     /// Default range attenuation texture.
@@ -515,6 +642,8 @@ private:
     ea::unordered_map<int, SharedPtr<Texture2D> > colorShadowMaps_;
     /// Shadow map allocations by resolution.
     ea::unordered_map<int, ea::vector<Light*> > shadowMapAllocations_;
+    /// Cached shadow maps by light.
+    ea::unordered_map<Light*, CachedShadowMap> cachedShadowMaps_;
     /// Instance of shadow map filter.
     Object* shadowMapFilterInstance_{};
     /// Function pointer of shadow map filter.
@@ -533,6 +662,8 @@ private:
     ea::vector<WeakPtr<View> > views_;
     /// Prepared views by culling camera.
     ea::unordered_map<Camera*, WeakPtr<View> > preparedViews_;
+    /// Reflection probes to update.
+    ea::vector<WeakPtr<ReflectionProbe> > reflectionProbes_;
     /// Octrees that have been updated during the frame.
     ea::hash_set<Octree*> updatedOctrees_;
     /// Techniques for which missing shader error has been displayed.
@@ -573,6 +704,8 @@ private:
     int maxSortedInstances_{1000};
     /// Maximum occluder triangles.
     int maxOccluderTriangles_{5000};
+    /// Maximum per-pixel lights in a forward rendered view.
+    int maxPixelLights_{};
     /// Occlusion buffer width.
     int occlusionBufferSize_{256};
     /// Occluder screen size threshold.
@@ -583,6 +716,24 @@ private:
     float mobileShadowBiasAdd_{};
     /// Mobile platform shadow normal offset multiplier.
     float mobileNormalOffsetMul_{1.0f};
+    /// Dynamic resolution target GPU frame time in milliseconds.
+    float dynamicResolutionTargetTime_{16.0f};
+    /// Minimum dynamic resolution scale.
+    float minResolutionScale_{0.5f};
+    /// Maximum dynamic resolution scale.
+    float maxResolutionScale_{1.0f};
+    /// Resolution scale in use, quantized to steps so that screen buffers of few sizes are needed.
+    float resolutionScale_{1.0f};
+    /// Unquantized resolution scale the dynamic resolution converges to.
+    float targetResolutionScale_{1.0f};
+    /// Sharpening amount of the upscale.
+    float upscaleSharpness_{0.5f};
+    /// Number of resolved GPU frames already used by dynamic resolution.
+    unsigned dynamicResolutionFrames_{};
+    /// Time since streamed texture mip levels were last checked for restoring.
+    float streamedMipsRestoreTimer_{};
+    /// Max reflection probe faces rendered per frame.
+    unsigned reflectionProbeFacesPerFrame_{1};
     /// Whether to enable spherical harmonics.
     bool sphericalHarmonics_{};
     /// Number of occlusion buffers in use.
@@ -605,12 +756,18 @@ private:
     bool drawShadows_{true};
     /// Shadow map reuse flag.
     bool reuseShadowMaps_{true};
+    /// Shadow map caching flag.
+    bool cacheShadowMaps_{false};
     /// Dynamic instancing flag.
     bool dynamicInstancing_{true};
     /// Number of extra instancing data elements.
     int numExtraInstancingBufferElements_{};
     /// Threaded occlusion rendering flag.
     bool threadedOcclusion_{};
+    /// Occlusion buffer reuse flag.
+    bool reuseOcclusion_{};
+    /// Hardware occlusion queries flag.
+    bool occlusionQueries_{};
     /// Shaders need reloading flag.
     bool shadersDirty_{true};
     /// Initialized flag.
@@ -91,8 +91,12 @@ public:
     /// Release the shader.
     void Release() override;
 
-    /// Compile the shader. Return true if successful.
+    /// Compile the shader. Return true if successful, or if the compile was started in the background.
     bool Create();
+    /// Return whether the shader is still compiling in the background, OpenGL only. Completes the compile once the driver has finished it.
+    bool IsCompilePending();
+    /// Return hash of the final source code including all defines, OpenGL only. Identifies cached program binaries.
+    unsigned GetSourceHash() const;
     /// Set name.
     void SetName(const ea::string& name);
     /// Set defines.
@@ -174,6 +178,8 @@ private:
     ea::string definesClipPlane_;
     /// Shader compile error string.
     ea::string compilerOutput_;
+    /// Background compile in progress flag. Used only on OpenGL.
+    bool compilePending_{};
 };
 
 }
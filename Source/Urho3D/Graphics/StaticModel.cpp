@@ -44,6 +44,8 @@ namespace Urho3D
 
 extern const char* GEOMETRY_CATEGORY;
 
+URHO3D_SLAB_ALLOCATED_SEPARATELY_IMPL(StaticModel)
+
 StaticModel::StaticModel(Context* context) :
     Drawable(context, DRAWABLE_GEOMETRY),
     occlusionLodLevel_(M_MAX_UNSIGNED),
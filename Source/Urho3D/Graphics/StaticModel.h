@@ -44,6 +44,9 @@ class URHO3D_API StaticModel : public Drawable
     URHO3D_OBJECT(StaticModel, Drawable);
 
 public:
+    /// Static models and subclasses are allocated from a separate arena to keep per-frame loops linear in memory.
+    URHO3D_SLAB_ALLOCATED_SEPARATELY
+
     /// Construct.
     explicit StaticModel(Context* context);
     /// Destruct.
@@ -26,11 +26,14 @@
 #include "../Graphics/Batch.h"
 #include "../Graphics/Camera.h"
 #include "../Graphics/Geometry.h"
+#include "../Graphics/GlobalIllumination.h"
 #include "../Graphics/Material.h"
 #include "../Graphics/OcclusionBuffer.h"
 #include "../Graphics/OctreeQuery.h"
+#include "../Graphics/Renderer.h"
 #include "../Graphics/StaticModelGroup.h"
 #include "../Graphics/VertexBuffer.h"
+#include "../Math/MathBatch.h"
 #include "../Scene/Scene.h"
 
 #include "../DebugNew.h"
@@ -63,6 +66,7 @@ void StaticModelGroup::RegisterObject(Context* context)
     URHO3D_ACCESSOR_ATTRIBUTE("Instance Nodes", GetNodeIDsAttr, SetNodeIDsAttr,
         VariantVector, Variant::emptyVariantVector, AM_DEFAULT | AM_NODEIDVECTOR)
         .SetMetadata(AttributeMetadata::P_VECTOR_STRUCT_ELEMENTS, instanceNodesStructureElementNames);
+    URHO3D_ACCESSOR_ATTRIBUTE("Persistent Instancing", GetPersistentInstancing, SetPersistentInstancing, bool, false, AM_DEFAULT);
 }
 
 void StaticModelGroup::ApplyAttributes()
@@ -197,6 +201,78 @@ void StaticModelGroup::UpdateBatches(const FrameInfo& frame)
         lodDistance_ = newLodDistance;
         CalculateLodLevels();
     }
+
+    if (persistentInstancing_)
+    {
+        // Sample the ambient the same way as the view does for the batches, as it is stored in the buffer per instance
+        InstanceShaderParameters parameters;
+        Scene* scene = GetScene();
+        GlobalIllumination* gi = scene ? scene->GetComponent<GlobalIllumination>() : nullptr;
+        if (gi && !batches_.empty() && !batches_[0].lightmapScaleOffset_)
+        {
+            unsigned& hint = GetMutableLightProbeTetrahedronHint();
+#if URHO3D_SPHERICAL_HARMONICS
+            parameters.ambient_ = gi->SampleAmbientSH(worldBoundingBox.Center(), hint);
+#else
+            parameters.ambient_ = gi->SampleAverageAmbient(worldBoundingBox.Center(), hint);
+#endif
+        }
+
+        if (memcmp(&parameters, &instanceShaderParameters_, sizeof(InstanceShaderParameters)) != 0)
+        {
+            instanceShaderParameters_ = parameters;
+            instanceBufferDirty_ = true;
+        }
+
+        // The buffer is bound in place of the instancing buffer of the renderer, so it needs the same extra elements
+        auto* renderer = GetSubsystem<Renderer>();
+        const unsigned numExtraElements = renderer ? renderer->GetNumExtraInstancingBufferElements() : 0;
+        if (numExtraElements != numExtraInstanceElements_)
+        {
+            numExtraInstanceElements_ = numExtraElements;
+            instanceBufferDirty_ = true;
+        }
+
+        VertexBuffer* instanceBuffer = numWorldTransforms_ ? instanceBuffer_.Get() : nullptr;
+        for (unsigned i = 0; i < batches_.size(); ++i)
+            batches_[i].instanceBuffer_ = instanceBuffer;
+    }
+}
+
+void StaticModelGroup::UpdateGeometry(const FrameInfo& frame)
+{
+    if (!instanceBuffer_ || !instanceBufferDirty_)
+        return;
+
+    instanceBufferDirty_ = false;
+    if (!numWorldTransforms_)
+        return;
+
+    const ea::vector<VertexElement> elements = Renderer::GetInstancingBufferElements(numExtraInstanceElements_);
+    if (instanceBuffer_->GetVertexCount() != numWorldTransforms_ || instanceBuffer_->GetElements() != elements)
+        instanceBuffer_->SetSize(numWorldTransforms_, elements);
+
+    auto* dest = static_cast<unsigned char*>(instanceBuffer_->Lock(0, numWorldTransforms_, true));
+    if (!dest)
+        return;
+
+    for (unsigned i = 0; i < numWorldTransforms_; ++i)
+    {
+        memcpy(dest, &worldTransforms_[i], sizeof(Matrix3x4));
+        dest += sizeof(Matrix3x4);
+        memcpy(dest, &instanceShaderParameters_, sizeof(InstanceShaderParameters));
+        dest += sizeof(InstanceShaderParameters);
+        // Extra elements are not filled per instance
+        memset(dest, 0, numExtraInstanceElements_ * sizeof(Vector4));
+        dest += numExtraInstanceElements_ * sizeof(Vector4);
+    }
+
+    instanceBuffer_->Unlock();
+}
+
+UpdateGeometryType StaticModelGroup::GetUpdateGeometryType()
+{
+    return instanceBuffer_ && instanceBufferDirty_ ? UPDATE_MAIN_THREAD : UPDATE_NONE;
 }
 
 unsigned StaticModelGroup::GetNumOccluderTriangles()
@@ -318,6 +394,27 @@ Node* StaticModelGroup::GetInstanceNode(unsigned index) const
     return index < instanceNodes_.size() ? instanceNodes_[index].Get() : nullptr;
 }
 
+void StaticModelGroup::SetPersistentInstancing(bool enable)
+{
+    if (enable == persistentInstancing_)
+        return;
+
+    persistentInstancing_ = enable;
+    if (enable)
+    {
+        instanceBuffer_ = context_->CreateObject<VertexBuffer>();
+        instanceBufferDirty_ = true;
+    }
+    else
+    {
+        instanceBuffer_.Reset();
+        for (unsigned i = 0; i < batches_.size(); ++i)
+            batches_[i].instanceBuffer_ = nullptr;
+    }
+
+    MarkNetworkUpdate();
+}
+
 void StaticModelGroup::SetNodeIDsAttr(const VariantVector& value)
 {
     // Just remember the node IDs. They need to go through the SceneResolver, and we actually find the nodes during
@@ -367,27 +464,25 @@ void StaticModelGroup::OnNodeSetEnabled(Node* node)
 
 void StaticModelGroup::OnWorldBoundingBoxUpdate()
 {
-    // Update transforms and bounding box at the same time to have to go through the objects only once
+    // Gather transforms first, then merge the transformed bounding boxes in one batch
     unsigned index = 0;
 
-    BoundingBox worldBox;
-
     for (unsigned i = 0; i < instanceNodes_.size(); ++i)
     {
         Node* node = instanceNodes_[i];
         if (!node || !node->IsEnabled())
             continue;
 
-        const Matrix3x4& worldTransform = node->GetWorldTransform();
-        worldTransforms_[index++] = worldTransform;
-        worldBox.Merge(boundingBox_.Transformed(worldTransform));
+        worldTransforms_[index++] = node->GetWorldTransform();
     }
 
-    worldBoundingBox_ = worldBox;
+    worldBoundingBox_ = MergeTransformedBoundingBoxes(boundingBox_, worldTransforms_.data(), index);
 
     // Store the amount of valid instances we found instead of resizing worldTransforms_. This is because this function may be
     // called from multiple worker threads simultaneously
     numWorldTransforms_ = index;
+    if (persistentInstancing_)
+        instanceBufferDirty_ = true;
 }
 
 void StaticModelGroup::UpdateNumTransforms()
@@ -22,11 +22,16 @@
 
 #pragma once
 
+#include "../Graphics/Batch.h"
 #include "../Graphics/StaticModel.h"
 
+#include <atomic>
+
 namespace Urho3D
 {
 
+class VertexBuffer;
+
 /// Renders several object instances while culling and receiving light as one unit. Can be used as a CPU-side optimization, but note that also regular StaticModels will use instanced rendering if possible.
 class URHO3D_API StaticModelGroup : public StaticModel
 {
@@ -50,6 +55,10 @@ public:
     unsigned GetNumOccluderTriangles() override;
     /// Draw to occlusion buffer. Return true if did not run out of triangles.
     bool DrawOcclusion(OcclusionBuffer* buffer) override;
+    /// Prepare geometry for rendering. Called from a worker thread if possible (no GPU update.)
+    void UpdateGeometry(const FrameInfo& frame) override;
+    /// Return whether a geometry update is necessary, and if it can happen in a worker thread.
+    UpdateGeometryType GetUpdateGeometryType() override;
 
     /// Add an instance scene node. It does not need any drawable components of its own.
     void AddInstanceNode(Node* node);
@@ -64,6 +73,11 @@ public:
     /// Return instance node by index.
     Node* GetInstanceNode(unsigned index) const;
 
+    /// Set whether instances are drawn from a persistent GPU buffer, rewritten only when the instances or their ambient lighting change. Otherwise they are copied to the renderer's instancing buffer each frame.
+    void SetPersistentInstancing(bool enable);
+    /// Return whether instances are drawn from a persistent GPU buffer.
+    bool GetPersistentInstancing() const { return persistentInstancing_; }
+
     /// Set node IDs attribute.
     void SetNodeIDsAttr(const VariantVector& value);
 
@@ -94,6 +108,16 @@ private:
     mutable bool nodesDirty_{};
     /// Whether nodes have been manipulated by the API and node ID attribute should be refreshed.
     mutable bool nodeIDsDirty_{};
+    /// Persistent instance buffer.
+    SharedPtr<VertexBuffer> instanceBuffer_;
+    /// Per-instance shader parameters written to the persistent instance buffer.
+    InstanceShaderParameters instanceShaderParameters_;
+    /// Persistent instancing flag.
+    bool persistentInstancing_{};
+    /// Number of extra instancing buffer elements of the renderer the persistent instance buffer is laid out for.
+    unsigned numExtraInstanceElements_{};
+    /// Persistent instance buffer needs to be rewritten flag. Set also from worker threads.
+    std::atomic<bool> instanceBufferDirty_{};
 };
 
 }
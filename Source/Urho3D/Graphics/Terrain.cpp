@@ -57,6 +57,18 @@ static const unsigned STITCH_SOUTH = 2;
 static const unsigned STITCH_WEST = 4;
 static const unsigned STITCH_EAST = 8;
 
+/// Index data shared by all terrains with the same patch size and number of LOD levels.
+struct SharedTerrainIndexData
+{
+    /// Index buffer.
+    WeakPtr<IndexBuffer> indexBuffer_;
+    /// Draw ranges for each LOD level and stitching combination.
+    ea::vector<ea::pair<unsigned, unsigned> > drawRanges_;
+};
+
+/// Shared index data by patch size and number of LOD levels. Note: this is not multi-instance safe
+static ea::unordered_map<unsigned, SharedTerrainIndexData> sharedIndexData;
+
 inline void GrowUpdateRegion(IntRect& updateRegion, int x, int y)
 {
     if (updateRegion.left_ < 0)
@@ -1193,6 +1205,15 @@ void Terrain::CreateIndexData()
 {
     URHO3D_PROFILE("CreateIndexData");
 
+    // Index data depends only on patch size and number of LOD levels, reuse it if another terrain has already built it
+    SharedTerrainIndexData& sharedData = sharedIndexData[(static_cast<unsigned>(patchSize_) << 8u) | numLodLevels_];
+    if (sharedData.indexBuffer_ && sharedData.indexBuffer_->GetContext() == context_)
+    {
+        indexBuffer_ = sharedData.indexBuffer_;
+        drawRanges_ = sharedData.drawRanges_;
+        return;
+    }
+
     ea::vector<unsigned short> indices;
     drawRanges_.clear();
     auto row = (unsigned)(patchSize_ + 1);
@@ -1345,8 +1366,14 @@ void Terrain::CreateIndexData()
         }
     }
 
+    // Always create a new buffer, as the current one may be in use by other terrains
+    indexBuffer_ = context_->CreateObject<IndexBuffer>();
+    indexBuffer_->SetShadowed(true);
     indexBuffer_->SetSize(indices.size(), false);
     indexBuffer_->SetData(&indices[0]);
+
+    sharedData.indexBuffer_ = indexBuffer_;
+    sharedData.drawRanges_ = drawRanges_;
 }
 
 float Terrain::GetRawHeight(int x, int z) const
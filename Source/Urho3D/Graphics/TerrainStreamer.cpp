@@ -0,0 +1,350 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include <EASTL/sort.h>
+
+#include "../Core/Context.h"
+#include "../Core/Profiler.h"
+#include "../Graphics/Camera.h"
+#include "../Graphics/Material.h"
+#include "../Graphics/Renderer.h"
+#include "../Graphics/Terrain.h"
+#include "../Graphics/TerrainStreamer.h"
+#include "../Graphics/Viewport.h"
+#include "../Resource/Image.h"
+#include "../Resource/ResourceCache.h"
+#include "../Resource/ResourceEvents.h"
+#include "../Scene/Scene.h"
+#include "../Scene/SceneEvents.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+extern const char* GEOMETRY_CATEGORY;
+
+TerrainStreamer::TerrainStreamer(Context* context) :
+    Component(context)
+{
+}
+
+TerrainStreamer::~TerrainStreamer() = default;
+
+void TerrainStreamer::RegisterObject(Context* context)
+{
+    context->RegisterFactory<TerrainStreamer>(GEOMETRY_CATEGORY);
+
+    URHO3D_ACCESSOR_ATTRIBUTE("Is Enabled", IsEnabled, SetEnabled, bool, true, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Height Map Pattern", GetHeightMapPattern, SetHeightMapPattern, ea::string, EMPTY_STRING, AM_DEFAULT);
+    URHO3D_MIXED_ACCESSOR_ATTRIBUTE("Material", GetMaterialAttr, SetMaterialAttr, ResourceRef, ResourceRef(Material::GetTypeStatic()),
+        AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Tile Size", GetTileSize, SetTileSize, float, 256.0f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Height Scale", GetHeightScale, SetHeightScale, float, 0.25f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Patch Size", GetPatchSize, SetPatchSize, int, 32, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Load Radius", GetLoadRadius, SetLoadRadius, int, 2, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Unload Radius", GetUnloadRadius, SetUnloadRadius, int, 3, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Max Tiles Per Frame", GetMaxTilesPerFrame, SetMaxTilesPerFrame, int, 1, AM_DEFAULT);
+}
+
+void TerrainStreamer::SetHeightMapPattern(const ea::string& pattern)
+{
+    if (pattern != heightMapPattern_)
+    {
+        heightMapPattern_ = pattern;
+        ClearTiles();
+    }
+}
+
+void TerrainStreamer::SetTileSize(float size)
+{
+    size = Max(size, M_EPSILON);
+    if (size != tileSize_)
+    {
+        tileSize_ = size;
+        ClearTiles();
+    }
+}
+
+void TerrainStreamer::SetHeightScale(float scale)
+{
+    if (scale != heightScale_)
+    {
+        heightScale_ = scale;
+        ClearTiles();
+    }
+}
+
+void TerrainStreamer::SetPatchSize(int size)
+{
+    if (size != patchSize_)
+    {
+        patchSize_ = size;
+        ClearTiles();
+    }
+}
+
+void TerrainStreamer::SetMaterial(Material* material)
+{
+    material_ = material;
+    for (const auto& item : tiles_)
+    {
+        if (Terrain* terrain = GetTileTerrain(item.first))
+            terrain->SetMaterial(material_);
+    }
+}
+
+void TerrainStreamer::SetLoadRadius(int radius)
+{
+    loadRadius_ = Max(radius, 0);
+}
+
+void TerrainStreamer::SetUnloadRadius(int radius)
+{
+    unloadRadius_ = Max(radius, 0);
+}
+
+void TerrainStreamer::SetMaxTilesPerFrame(int count)
+{
+    maxTilesPerFrame_ = Max(count, 1);
+}
+
+Material* TerrainStreamer::GetMaterial() const
+{
+    return material_;
+}
+
+IntVector2 TerrainStreamer::GetTileIndex(const Vector3& worldPosition) const
+{
+    const Vector3 position = node_ ? node_->WorldToLocal(worldPosition) : worldPosition;
+    return { FloorToInt(position.x_ / tileSize_), FloorToInt(position.z_ / tileSize_) };
+}
+
+Terrain* TerrainStreamer::GetTileTerrain(const IntVector2& index) const
+{
+    auto iter = tiles_.find(index);
+    if (iter == tiles_.end() || !iter->second.node_)
+        return nullptr;
+    return iter->second.node_->GetComponent<Terrain>();
+}
+
+float TerrainStreamer::GetHeight(const Vector3& worldPosition) const
+{
+    Terrain* terrain = GetTileTerrain(GetTileIndex(worldPosition));
+    return terrain ? terrain->GetHeight(worldPosition) : 0.0f;
+}
+
+void TerrainStreamer::ClearTiles()
+{
+    auto* cache = GetSubsystem<ResourceCache>();
+    for (auto& item : tiles_)
+    {
+        if (item.second.node_)
+            item.second.node_->Remove();
+        cache->ReleaseResource<Image>(item.second.heightMapName_);
+    }
+    tiles_.clear();
+}
+
+void TerrainStreamer::SetMaterialAttr(const ResourceRef& value)
+{
+    auto* cache = GetSubsystem<ResourceCache>();
+    SetMaterial(cache->GetResource<Material>(value.name_));
+}
+
+ResourceRef TerrainStreamer::GetMaterialAttr() const
+{
+    return GetResourceRef(material_, Material::GetTypeStatic());
+}
+
+void TerrainStreamer::OnSceneSet(Scene* scene)
+{
+    if (scene)
+    {
+        SubscribeToEvent(scene, E_SCENEUPDATE, URHO3D_HANDLER(TerrainStreamer, HandleSceneUpdate));
+        SubscribeToEvent(E_RESOURCEBACKGROUNDLOADED, URHO3D_HANDLER(TerrainStreamer, HandleResourceBackgroundLoaded));
+    }
+    else
+    {
+        UnsubscribeFromEvent(E_SCENEUPDATE);
+        UnsubscribeFromEvent(E_RESOURCEBACKGROUNDLOADED);
+        ClearTiles();
+    }
+}
+
+void TerrainStreamer::HandleSceneUpdate(StringHash eventType, VariantMap& eventData)
+{
+    Vector3 focusPosition;
+    if (!IsEnabledEffective() || heightMapPattern_.empty() || !GetFocusPosition(focusPosition))
+        return;
+
+    UpdateTiles(GetTileIndex(focusPosition));
+}
+
+void TerrainStreamer::HandleResourceBackgroundLoaded(StringHash eventType, VariantMap& eventData)
+{
+    using namespace ResourceBackgroundLoaded;
+
+    if (eventData[P_SUCCESS].GetBool())
+        return;
+
+    // Do not retry tiles whose height maps fail to load
+    const ea::string& resourceName = eventData[P_RESOURCENAME].GetString();
+    for (auto& item : tiles_)
+    {
+        if (item.second.heightMapName_ == resourceName)
+            item.second.failed_ = true;
+    }
+}
+
+bool TerrainStreamer::GetFocusPosition(Vector3& position) const
+{
+    if (focusNode_)
+    {
+        position = focusNode_->GetWorldPosition();
+        return true;
+    }
+
+    auto* renderer = GetSubsystem<Renderer>();
+    Viewport* viewport = renderer ? renderer->GetViewport(0) : nullptr;
+    Camera* camera = viewport ? viewport->GetCamera() : nullptr;
+    if (!camera || camera->GetScene() != GetScene())
+        return false;
+
+    position = camera->GetNode()->GetWorldPosition();
+    return true;
+}
+
+void TerrainStreamer::UpdateTiles(const IntVector2& focusTile)
+{
+    URHO3D_PROFILE("UpdateTerrainTiles");
+
+    auto* cache = GetSubsystem<ResourceCache>();
+    const int unloadRadius = Max(unloadRadius_, loadRadius_);
+
+    // Unload tiles out of range
+    ea::vector<IntVector2> unloadedTiles;
+    for (auto iter = tiles_.begin(); iter != tiles_.end();)
+    {
+        const IntVector2 offset = iter->first - focusTile;
+        if (Max(Abs(offset.x_), Abs(offset.y_)) > unloadRadius)
+        {
+            if (iter->second.node_)
+            {
+                iter->second.node_->Remove();
+                unloadedTiles.push_back(iter->first);
+            }
+            cache->ReleaseResource<Image>(iter->second.heightMapName_);
+            iter = tiles_.erase(iter);
+        }
+        else
+            ++iter;
+    }
+    for (const IntVector2& index : unloadedTiles)
+        UpdateNeighbors(index);
+
+    // Request height maps of tiles in range
+    for (int y = focusTile.y_ - loadRadius_; y <= focusTile.y_ + loadRadius_; ++y)
+    {
+        for (int x = focusTile.x_ - loadRadius_; x <= focusTile.x_ + loadRadius_; ++x)
+        {
+            const IntVector2 index(x, y);
+            if (tiles_.contains(index))
+                continue;
+
+            TerrainStreamerTile tile;
+            tile.heightMapName_ = heightMapPattern_.replaced("{x}", ea::to_string(x)).replaced("{y}", ea::to_string(y));
+            if (!cache->Exists(tile.heightMapName_))
+                tile.failed_ = true;
+            else if (!cache->GetExistingResource<Image>(tile.heightMapName_))
+                cache->BackgroundLoadResource<Image>(tile.heightMapName_);
+            tiles_.emplace(index, tile);
+        }
+    }
+
+    // Create terrains for loaded height maps within the frame budget, nearest first
+    ea::vector<ea::pair<int, IntVector2>> readyTiles;
+    for (const auto& item : tiles_)
+    {
+        const TerrainStreamerTile& tile = item.second;
+        if (!tile.node_ && !tile.failed_ && cache->GetExistingResource<Image>(tile.heightMapName_))
+        {
+            const IntVector2 offset = item.first - focusTile;
+            readyTiles.emplace_back(offset.x_ * offset.x_ + offset.y_ * offset.y_, item.first);
+        }
+    }
+
+    const unsigned numCreatedTiles = Min(readyTiles.size(), static_cast<unsigned>(maxTilesPerFrame_));
+    ea::sort(readyTiles.begin(), readyTiles.end(),
+        [](const ea::pair<int, IntVector2>& lhs, const ea::pair<int, IntVector2>& rhs) { return lhs.first < rhs.first; });
+    for (unsigned i = 0; i < numCreatedTiles; ++i)
+    {
+        const IntVector2 index = readyTiles[i].second;
+        CreateTile(index, tiles_[index]);
+    }
+}
+
+void TerrainStreamer::CreateTile(const IntVector2& index, TerrainStreamerTile& tile)
+{
+    URHO3D_PROFILE("CreateTerrainTile");
+
+    auto* cache = GetSubsystem<ResourceCache>();
+    Image* heightMap = cache->GetExistingResource<Image>(tile.heightMapName_);
+    if (!heightMap || heightMap->GetWidth() < 2 || heightMap->GetHeight() < 2)
+    {
+        tile.failed_ = true;
+        return;
+    }
+
+    // Tiles are temporary and not saved with the scene
+    Node* tileNode = node_->CreateTemporaryChild(Format("TerrainTile_{}_{}", index.x_, index.y_), LOCAL);
+    tileNode->SetPosition(Vector3((index.x_ + 0.5f) * tileSize_, 0.0f, (index.y_ + 0.5f) * tileSize_));
+
+    auto* terrain = tileNode->CreateComponent<Terrain>();
+    terrain->SetPatchSize(patchSize_);
+    terrain->SetSpacing(Vector3(tileSize_ / (heightMap->GetWidth() - 1), heightScale_, tileSize_ / (heightMap->GetHeight() - 1)));
+    terrain->SetMaterial(material_);
+    terrain->SetHeightMap(heightMap);
+
+    tile.node_ = tileNode;
+    UpdateNeighbors(index);
+}
+
+void TerrainStreamer::UpdateNeighbors(const IntVector2& index)
+{
+    static const IntVector2 offsets[] = { IntVector2::ZERO, IntVector2::UP, IntVector2::DOWN, IntVector2::LEFT, IntVector2::RIGHT };
+    for (const IntVector2& offset : offsets)
+    {
+        const IntVector2 tileIndex = index + offset;
+        if (Terrain* terrain = GetTileTerrain(tileIndex))
+        {
+            // Terrain rows go from north to south, so the north neighbor has greater Z
+            terrain->SetNeighbors(GetTileTerrain(tileIndex + IntVector2(0, 1)), GetTileTerrain(tileIndex + IntVector2(0, -1)),
+                GetTileTerrain(tileIndex + IntVector2(-1, 0)), GetTileTerrain(tileIndex + IntVector2(1, 0)));
+        }
+    }
+}
+
+}
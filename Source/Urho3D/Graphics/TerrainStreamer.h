@@ -0,0 +1,154 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+/// \file
+
+#pragma once
+
+#include "../Math/Vector2.h"
+#include "../Scene/Component.h"
+
+namespace Urho3D
+{
+
+class Material;
+class Terrain;
+
+/// Streamed terrain tile.
+struct TerrainStreamerTile
+{
+    /// Height map resource name.
+    ea::string heightMapName_;
+    /// Tile node, null when not loaded yet.
+    WeakPtr<Node> node_;
+    /// Whether the height map failed to load.
+    bool failed_{};
+};
+
+/// Component that streams a grid of Terrain tiles around a focus node. Height maps are loaded in background and
+/// tiles are created within a per-frame budget. All tiles share index data and stitch LOD seams with their neighbors.
+class URHO3D_API TerrainStreamer : public Component
+{
+    URHO3D_OBJECT(TerrainStreamer, Component);
+
+public:
+    /// Construct.
+    explicit TerrainStreamer(Context* context);
+    /// Destruct.
+    ~TerrainStreamer() override;
+    /// Register object factory.
+    static void RegisterObject(Context* context);
+
+    /// Set height map resource name pattern, where {x} and {y} are replaced with tile indices.
+    void SetHeightMapPattern(const ea::string& pattern);
+    /// Set world size of each tile along X and Z axes.
+    void SetTileSize(float size);
+    /// Set height (Y) spacing of tiles.
+    void SetHeightScale(float scale);
+    /// Set patch quads per side of tiles. Must be a power of two.
+    void SetPatchSize(int size);
+    /// Set material of tiles.
+    void SetMaterial(Material* material);
+    /// Set distance in tiles around the focus within which tiles are loaded.
+    void SetLoadRadius(int radius);
+    /// Set distance in tiles around the focus beyond which tiles are unloaded.
+    void SetUnloadRadius(int radius);
+    /// Set max number of tiles created per frame.
+    void SetMaxTilesPerFrame(int count);
+    /// Set focus node. If null, the camera of the first viewport is used.
+    void SetFocusNode(Node* node) { focusNode_ = node; }
+
+    /// Return height map resource name pattern.
+    const ea::string& GetHeightMapPattern() const { return heightMapPattern_; }
+    /// Return world size of each tile.
+    float GetTileSize() const { return tileSize_; }
+    /// Return height spacing of tiles.
+    float GetHeightScale() const { return heightScale_; }
+    /// Return patch size of tiles.
+    int GetPatchSize() const { return patchSize_; }
+    /// Return material of tiles.
+    Material* GetMaterial() const;
+    /// Return load radius in tiles.
+    int GetLoadRadius() const { return loadRadius_; }
+    /// Return unload radius in tiles.
+    int GetUnloadRadius() const { return unloadRadius_; }
+    /// Return max number of tiles created per frame.
+    int GetMaxTilesPerFrame() const { return maxTilesPerFrame_; }
+    /// Return focus node.
+    Node* GetFocusNode() const { return focusNode_; }
+
+    /// Return tile index containing world position.
+    IntVector2 GetTileIndex(const Vector3& worldPosition) const;
+    /// Return loaded terrain of tile, or null if not loaded.
+    Terrain* GetTileTerrain(const IntVector2& index) const;
+    /// Return terrain height at world position, or zero if the tile is not loaded.
+    float GetHeight(const Vector3& worldPosition) const;
+    /// Remove all tiles.
+    void ClearTiles();
+
+    /// Set material attribute.
+    void SetMaterialAttr(const ResourceRef& value);
+    /// Return material attribute.
+    ResourceRef GetMaterialAttr() const;
+
+protected:
+    /// Handle scene being assigned.
+    void OnSceneSet(Scene* scene) override;
+
+private:
+    /// Handle scene update.
+    void HandleSceneUpdate(StringHash eventType, VariantMap& eventData);
+    /// Handle background resource load finish.
+    void HandleResourceBackgroundLoaded(StringHash eventType, VariantMap& eventData);
+    /// Return focus world position. Return false if there is no focus.
+    bool GetFocusPosition(Vector3& position) const;
+    /// Update loaded tiles around focus tile.
+    void UpdateTiles(const IntVector2& focusTile);
+    /// Create terrain for tile with loaded height map.
+    void CreateTile(const IntVector2& index, TerrainStreamerTile& tile);
+    /// Update neighbor links of tile and adjacent tiles.
+    void UpdateNeighbors(const IntVector2& index);
+
+    /// Height map resource name pattern.
+    ea::string heightMapPattern_;
+    /// World size of each tile.
+    float tileSize_{ 256.0f };
+    /// Height spacing.
+    float heightScale_{ 0.25f };
+    /// Patch size.
+    int patchSize_{ 32 };
+    /// Material.
+    SharedPtr<Material> material_;
+    /// Load radius in tiles.
+    int loadRadius_{ 2 };
+    /// Unload radius in tiles.
+    int unloadRadius_{ 3 };
+    /// Max tiles created per frame.
+    int maxTilesPerFrame_{ 1 };
+    /// Focus node.
+    WeakPtr<Node> focusNode_;
+    /// Tiles in load range, loaded or pending.
+    ea::unordered_map<IntVector2, TerrainStreamerTile> tiles_;
+};
+
+}
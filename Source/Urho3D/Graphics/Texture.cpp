@@ -25,11 +25,14 @@
 #include "../Graphics/Graphics.h"
 #include "../Graphics/GraphicsImpl.h"
 #include "../Graphics/Material.h"
+#include "../Graphics/Texture2D.h"
 #include "../IO/FileSystem.h"
 #include "../IO/Log.h"
 #include "../Resource/ResourceCache.h"
 #include "../Resource/XMLFile.h"
 
+#include <EASTL/sort.h>
+
 #include "../DebugNew.h"
 
 namespace Urho3D
@@ -282,6 +285,38 @@ void Texture::CheckTextureBudget(StringHash type)
     // Therefore free unused materials first
     if (textureUse > textureBudget)
         cache->ReleaseResources(Material::GetTypeStatic());
+
+    // If still over the budget, drop top mip levels of the largest 2D textures
+    if (type != Texture2D::GetTypeStatic())
+        return;
+
+    ea::vector<Texture2D*> textures;
+    cache->GetResources<Texture2D>(textures);
+
+    textureUse = 0;
+    for (Texture2D* texture : textures)
+        textureUse += texture->GetMemoryUse();
+    if (textureUse <= textureBudget)
+        return;
+
+    const auto compareMemoryUse = [](const Texture2D* lhs, const Texture2D* rhs)
+    {
+        return lhs->GetMemoryUse() > rhs->GetMemoryUse();
+    };
+    ea::sort(textures.begin(), textures.end(), compareMemoryUse);
+
+    for (Texture2D* texture : textures)
+    {
+        if (textureUse <= textureBudget)
+            break;
+        if (texture->GetLevels() <= 1 || texture->GetUsage() != TEXTURE_STATIC || texture->IsStreamedMipsReloadPending())
+            continue;
+
+        // The reload finishes on a later frame, dropping the top level frees about three quarters of the memory
+        const unsigned oldMemoryUse = texture->GetMemoryUse();
+        if (texture->SetStreamedMipsToSkip(texture->GetStreamedMipsToSkip() + 1))
+            textureUse -= oldMemoryUse / 4 * 3;
+    }
 }
 
 }
@@ -123,6 +123,9 @@ public:
     /// Return backup texture.
     Texture* GetBackupTexture() const { return backupTexture_; }
 
+    /// Return whether texture data is still being uploaded over several frames. The backup texture is used for rendering meanwhile.
+    bool IsUploadPending() const { return uploadPending_; }
+
     /// Return mip levels to skip on a quality setting when loading.
     int GetMipsToSkip(MaterialQuality quality) const;
     /// Return mip level width, or 0 if level does not exist.
@@ -247,6 +250,8 @@ protected:
     bool resolveDirty_{};
     /// Mipmap levels regeneration needed -flag.
     bool levelsDirty_{};
+    /// Data upload in progress -flag.
+    bool uploadPending_{};
     /// Backup texture.
     SharedPtr<Texture> backupTexture_;
 };
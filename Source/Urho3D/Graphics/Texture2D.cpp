@@ -23,7 +23,9 @@
 #include "../Precompiled.h"
 
 #include "../Core/Context.h"
+#include "../Core/CoreEvents.h"
 #include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/GraphicsEvents.h"
 #include "../Graphics/GraphicsImpl.h"
@@ -101,7 +103,18 @@ bool Texture2D::EndLoad()
     CheckTextureBudget(GetTypeStatic());
 
     SetParameters(loadParameters_);
+
+    // Queue the levels of background loaded textures, so that finishing a large texture does not stall the frame
+    deferUpload_ = GetAsyncLoadState() == ASYNC_SUCCESS && graphics_->GetTextureUploadBudget() > 0;
     bool success = SetData(loadImage_);
+    deferUpload_ = false;
+
+    if (!pendingLevels_.empty())
+    {
+        uploadPending_ = true;
+        SubscribeToEvent(E_BEGINFRAME, URHO3D_HANDLER(Texture2D, HandleBeginFrame));
+        UploadPendingLevels();
+    }
 
     loadImage_.Reset();
     loadParameters_.Reset();
@@ -109,6 +122,89 @@ bool Texture2D::EndLoad()
     return success;
 }
 
+bool Texture2D::SetStreamedMipsToSkip(unsigned mipsToSkip)
+{
+    requestedStreamedMipsToSkip_ = mipsToSkip;
+    if (mipsToSkip == streamedMipsToSkip_ || streamedMipsReload_)
+        return true;
+
+    // Only static textures loaded from files can be reloaded with different mip range
+    if (!graphics_ || usage_ != TEXTURE_STATIC || GetName().empty())
+        return false;
+
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    if (!workQueue)
+        return false;
+
+    // Decode the image in the background, the texture keeps its current levels until the reload finishes
+    auto reload = ea::make_shared<StreamedMipsReload>();
+    reload->image_ = MakeShared<Image>(context_);
+    streamedMipsReload_ = reload;
+
+    auto* cache = GetSubsystem<ResourceCache>();
+    const ea::string fileName = GetName();
+    workQueue->AddWorkItem([reload, cache, fileName]()
+    {
+        SharedPtr<File> file = cache->GetFile(fileName, false);
+        reload->success_ = file && reload->image_->Load(*file);
+        reload->completed_.store(true, std::memory_order_release);
+    });
+
+    SubscribeToEvent(E_BEGINFRAME, URHO3D_HANDLER(Texture2D, HandleBeginFrame));
+    return true;
+}
+
+void Texture2D::FinishStreamedMipsReload()
+{
+    ea::shared_ptr<StreamedMipsReload> reload = ea::move(streamedMipsReload_);
+
+    if (!reload->success_)
+    {
+        URHO3D_LOGWARNING("Failed to reload texture {} with {} dropped mip levels", GetName(), requestedStreamedMipsToSkip_);
+        requestedStreamedMipsToSkip_ = streamedMipsToSkip_;
+        return;
+    }
+
+    const unsigned oldMipsToSkip = streamedMipsToSkip_;
+    streamedMipsToSkip_ = requestedStreamedMipsToSkip_;
+    if (!SetData(reload->image_))
+    {
+        streamedMipsToSkip_ = oldMipsToSkip;
+        requestedStreamedMipsToSkip_ = oldMipsToSkip;
+        return;
+    }
+
+    // The count may have been changed again while the reload was in progress
+    if (requestedStreamedMipsToSkip_ != streamedMipsToSkip_)
+        SetStreamedMipsToSkip(requestedStreamedMipsToSkip_);
+}
+
+void Texture2D::RestoreStreamedMips(ResourceCache* cache)
+{
+    const unsigned long long textureBudget = cache->GetMemoryBudget(GetTypeStatic());
+    if (!textureBudget)
+        return;
+
+    ea::vector<Texture2D*> textures;
+    cache->GetResources<Texture2D>(textures);
+
+    unsigned long long textureUse = 0;
+    Texture2D* candidate = nullptr;
+    for (Texture2D* texture : textures)
+    {
+        textureUse += texture->GetMemoryUse();
+        if (texture->IsStreamedMipsReloadPending())
+            return;
+        if (texture->GetStreamedMipsToSkip() && (!candidate || texture->GetStreamedMipsToSkip() > candidate->GetStreamedMipsToSkip()))
+            candidate = texture;
+    }
+
+    // One more mip level takes about three times the memory of the current levels. Keep a quarter of the budget free
+    // so that the texture is not dropped again by the next budget check
+    if (candidate && (textureUse + 3ull * candidate->GetMemoryUse()) * 4 <= textureBudget * 3)
+        candidate->SetStreamedMipsToSkip(candidate->GetStreamedMipsToSkip() - 1);
+}
+
 bool Texture2D::SetSize(int width, int height, unsigned format, TextureUsage usage, int multiSample, bool autoResolve)
 {
     if (width <= 0 || height <= 0)
@@ -181,6 +277,75 @@ SharedPtr<Image> Texture2D::GetImage() const
     return rawImage;
 }
 
+void Texture2D::UploadLevel(unsigned level, int width, int height, const unsigned char* data, Image* source)
+{
+    if (!deferUpload_)
+    {
+        SetData(level, 0, 0, width, height, data);
+        return;
+    }
+
+    PendingLevel pendingLevel;
+    pendingLevel.level_ = level;
+    pendingLevel.width_ = width;
+    pendingLevel.height_ = height;
+    pendingLevel.dataSize_ = GetDataSize(width, height);
+    if (source)
+    {
+        pendingLevel.data_ = data;
+        pendingLevel.image_ = source;
+    }
+    else
+        pendingLevel.ownedData_.assign(data, data + pendingLevel.dataSize_);
+
+    pendingLevels_.push_back(ea::move(pendingLevel));
+}
+
+void Texture2D::UploadPendingLevels()
+{
+    URHO3D_PROFILE("UploadPendingTextureLevels");
+
+    // The texture is not bound until complete, so the levels may be uploaded in any order
+    while (!pendingLevels_.empty() && graphics_->ReserveTextureUpload(pendingLevels_.back().dataSize_))
+    {
+        UploadPendingLevel(pendingLevels_.back());
+        pendingLevels_.pop_back();
+    }
+
+    if (pendingLevels_.empty())
+        CancelPendingUpload();
+}
+
+void Texture2D::CancelPendingUpload()
+{
+    if (!uploadPending_ && pendingLevels_.empty())
+        return;
+
+    pendingLevels_.clear();
+    uploadPending_ = false;
+    UpdateBeginFrameSubscription();
+}
+
+void Texture2D::UpdateBeginFrameSubscription()
+{
+    if (!uploadPending_ && !streamedMipsReload_)
+        UnsubscribeFromEvent(E_BEGINFRAME);
+}
+
+void Texture2D::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
+{
+    if (!graphics_ || graphics_->IsDeviceLost())
+        return;
+
+    if (streamedMipsReload_ && streamedMipsReload_->completed_.load(std::memory_order_acquire))
+        FinishStreamedMipsReload();
+
+    if (uploadPending_)
+        UploadPendingLevels();
+    else
+        UpdateBeginFrameSubscription();
+}
+
 void Texture2D::HandleRenderSurfaceUpdate(StringHash eventType, VariantMap& eventData)
 {
     if (renderSurface_ && (renderSurface_->GetUpdateMode() == SURFACE_UPDATEALWAYS || renderSurface_->IsUpdateQueued()))
@@ -26,10 +26,15 @@
 #include "../Graphics/RenderSurface.h"
 #include "../Graphics/Texture.h"
 
+#include <EASTL/shared_ptr.h>
+
+#include <atomic>
+
 namespace Urho3D
 {
 
 class Image;
+class ResourceCache;
 class XMLFile;
 
 /// 2D texture resource.
@@ -73,6 +78,17 @@ public:
     /// Get image data from zero mip level. Only RGB and RGBA textures are supported.
     SharedPtr<Image> GetImage() const;
 
+    /// Set number of top mip levels dropped to reduce memory use, on top of the quality setting. Textures loaded from files are reloaded with the new mip range:
+    /// the image is decoded on the work queue and uploaded on a later frame. Return true if the reload was queued or is not needed.
+    bool SetStreamedMipsToSkip(unsigned mipsToSkip);
+    /// Return number of top mip levels dropped to reduce memory use. Only changes when a reload has succeeded.
+    unsigned GetStreamedMipsToSkip() const { return streamedMipsToSkip_; }
+    /// Return whether a reload with a different number of dropped mip levels is in progress.
+    bool IsStreamedMipsReloadPending() const { return streamedMipsReload_ != nullptr; }
+
+    /// Give back one dropped mip level to a texture if it fits into the texture memory budget with some headroom. Called periodically by the Renderer.
+    static void RestoreStreamedMips(ResourceCache* cache);
+
     /// Return render surface.
     RenderSurface* GetRenderSurface() const { return renderSurface_; }
 
@@ -81,6 +97,42 @@ protected:
     bool Create() override;
 
 private:
+    /// Mip level data queued for upload.
+    struct PendingLevel
+    {
+        /// Return level data.
+        const unsigned char* GetData() const { return ownedData_.empty() ? data_ : ownedData_.data(); }
+
+        /// Mip level.
+        unsigned level_{};
+        /// Level width.
+        int width_{};
+        /// Level height.
+        int height_{};
+        /// Level data size in bytes.
+        unsigned dataSize_{};
+        /// Level data inside the source image.
+        const unsigned char* data_{};
+        /// Source image keeping the level data alive.
+        SharedPtr<Image> image_;
+        /// Copy of the level data when there is no source image.
+        ea::vector<unsigned char> ownedData_;
+    };
+
+    /// Upload a whole mip level now, or queue it if the upload is spread over several frames. Copy the data if no source image is given.
+    void UploadLevel(unsigned level, int width, int height, const unsigned char* data, Image* source);
+    /// Upload a queued mip level through a staging resource when supported.
+    bool UploadPendingLevel(const PendingLevel& level);
+    /// Upload queued mip levels within the per-frame budget. The texture becomes usable when all levels are uploaded.
+    void UploadPendingLevels();
+    /// Drop the queued mip levels.
+    void CancelPendingUpload();
+    /// Apply the background loaded image of a finished mip range reload.
+    void FinishStreamedMipsReload();
+    /// Unsubscribe from frame begin event if there is nothing to continue.
+    void UpdateBeginFrameSubscription();
+    /// Handle frame begin event to continue the queued upload.
+    void HandleBeginFrame(StringHash eventType, VariantMap& eventData);
     /// Handle render surface update event.
     void HandleRenderSurfaceUpdate(StringHash eventType, VariantMap& eventData);
 
@@ -90,6 +142,26 @@ private:
     SharedPtr<Image> loadImage_;
     /// Parameter file acquired during BeginLoad.
     SharedPtr<XMLFile> loadParameters_;
+    /// Number of top mip levels dropped to reduce memory use.
+    unsigned streamedMipsToSkip_{};
+    /// Number of top mip levels to drop when the pending reload finishes.
+    unsigned requestedStreamedMipsToSkip_{};
+    /// State of the mip range reload shared with the work item. Owned through shared_ptr because the last reference may be dropped on either thread.
+    struct StreamedMipsReload
+    {
+        /// Image loaded by the work item.
+        SharedPtr<Image> image_;
+        /// Whether the image was loaded successfully.
+        bool success_{};
+        /// Set by the work item when done.
+        std::atomic<bool> completed_{};
+    };
+    /// Pending mip range reload.
+    ea::shared_ptr<StreamedMipsReload> streamedMipsReload_;
+    /// Mip levels waiting for upload.
+    ea::vector<PendingLevel> pendingLevels_;
+    /// Whether mip levels are queued instead of uploaded immediately.
+    bool deferUpload_{};
 };
 
 }
@@ -25,17 +25,22 @@
 #include <EASTL/sort.h>
 
 #include "../Core/Context.h"
+#include "../Core/FrameStatistics.h"
 #include "../Core/Profiler.h"
+#include "../Core/TaskGraph.h"
 #include "../Core/WorkQueue.h"
 #include "../Graphics/Camera.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/Geometry.h"
 #include "../Graphics/GlobalIllumination.h"
+#include "../Graphics/GPUProfiler.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/GraphicsEvents.h"
 #include "../Graphics/GraphicsImpl.h"
+#include "../Graphics/HierarchicalLodGroup.h"
 #include "../Graphics/Material.h"
 #include "../Graphics/OcclusionBuffer.h"
+#include "../Graphics/OcclusionQuery.h"
 #include "../Graphics/Octree.h"
 #include "../Graphics/Renderer.h"
 #include "../Graphics/RenderPath.h"
@@ -54,6 +59,10 @@
 #include "../Scene/Scene.h"
 #include "../UI/UI.h"
 
+#ifdef URHO3D_SSE
+#include <xmmintrin.h>
+#endif
+
 #include "../DebugNew.h"
 #include "View.h"
 
@@ -61,6 +70,27 @@
 namespace Urho3D
 {
 
+/// Return name of a render path command for the GPU profiler.
+static ea::string GetCommandProfilerName(const RenderPathCommand& command)
+{
+    ea::string name;
+    switch (command.type_)
+    {
+    case CMD_CLEAR: name = "Clear"; break;
+    case CMD_SCENEPASS: name = "ScenePass " + command.pass_; break;
+    case CMD_QUAD: name = "Quad " + command.pixelShaderName_; break;
+    case CMD_FORWARDLIGHTS: name = "ForwardLights " + command.pass_; break;
+    case CMD_LIGHTVOLUMES: name = "LightVolumes " + command.pixelShaderName_; break;
+    case CMD_RENDERUI: name = "RenderUI"; break;
+    case CMD_SENDEVENT: name = "SendEvent " + command.eventName_; break;
+    default: name = "Command"; break;
+    }
+
+    if (!command.tag_.empty())
+        name += " (" + command.tag_ + ")";
+    return name;
+}
+
 /// Update ambient for Drawable.
 static void UpdateBatchAmbient(Batch& destBatch, GlobalIllumination* gi, Drawable* drawable)
 {
@@ -102,6 +132,24 @@ public:
             }
         }
     }
+
+    /// Intersection test for drawables using packed culling data.
+    bool TestPackedDrawables(const OctantCullingData& data, Drawable* const* drawables, bool inside) override
+    {
+        for (unsigned i = 0; i < data.size_; i += 4)
+        {
+            const unsigned visibleMask = inside ? 0xfu : data.TestFrustum(frustum_, i);
+            const unsigned count = Min(4u, data.size_ - i);
+            for (unsigned j = 0; j < count; ++j)
+            {
+                const unsigned index = i + j;
+                if ((visibleMask & (1u << j)) && data.castShadows_[index] && (data.drawableFlags_[index] & drawableFlags_) &&
+                    (data.viewMasks_[index] & viewMask_))
+                    result_.push_back(drawables[index]);
+            }
+        }
+        return true;
+    }
 };
 
 /// %Frustum octree query for zones and occluders.
@@ -131,6 +179,25 @@ public:
             }
         }
     }
+
+    /// Intersection test for drawables using packed culling data.
+    bool TestPackedDrawables(const OctantCullingData& data, Drawable* const* drawables, bool inside) override
+    {
+        for (unsigned i = 0; i < data.size_; i += 4)
+        {
+            const unsigned visibleMask = inside ? 0xfu : data.TestFrustum(frustum_, i);
+            const unsigned count = Min(4u, data.size_ - i);
+            for (unsigned j = 0; j < count; ++j)
+            {
+                const unsigned index = i + j;
+                const unsigned char flags = data.drawableFlags_[index];
+                if ((visibleMask & (1u << j)) && (flags == DRAWABLE_ZONE || (flags == DRAWABLE_GEOMETRY && data.occluders_[index])) &&
+                    (data.viewMasks_[index] & viewMask_))
+                    result_.push_back(drawables[index]);
+            }
+        }
+        return true;
+    }
 };
 
 /// %Frustum octree query with occlusion.
@@ -178,18 +245,40 @@ public:
     OcclusionBuffer* buffer_;
 };
 
-void CheckVisibilityWork(const WorkItem* item, unsigned threadIndex)
+/// Number of drawables processed by one ParallelFor chunk.
+static const unsigned DRAWABLE_GRAIN_SIZE = 32;
+
+/// Return hash of occluder identities, transforms and bounds, used to detect whether occlusion buffer content may be reused.
+static unsigned GetOccludersHash(const ea::vector<Drawable*>& occluders)
+{
+    unsigned hash = occluders.size();
+    for (Drawable* occluder : occluders)
+    {
+        CombineHash(hash, MakeHash(occluder));
+        if (Node* node = occluder->GetNode())
+            CombineHash(hash, node->GetWorldTransform().ToHash());
+
+        const BoundingBox& box = occluder->GetWorldBoundingBox();
+        CombineHash(hash, FloatToRawIntBits(box.min_.x_));
+        CombineHash(hash, FloatToRawIntBits(box.min_.y_));
+        CombineHash(hash, FloatToRawIntBits(box.min_.z_));
+        CombineHash(hash, FloatToRawIntBits(box.max_.x_));
+        CombineHash(hash, FloatToRawIntBits(box.max_.y_));
+        CombineHash(hash, FloatToRawIntBits(box.max_.z_));
+    }
+    return hash;
+}
+
+void CheckVisibilityWork(View* view, Drawable* const* start, Drawable* const* end, unsigned threadIndex)
 {
     URHO3D_PROFILE("CheckVisibilityWork");
-    auto* view = reinterpret_cast<View*>(item->aux_);
-    auto** start = reinterpret_cast<Drawable**>(item->start_);
-    auto** end = reinterpret_cast<Drawable**>(item->end_);
     OcclusionBuffer* buffer = view->occlusionBuffer_;
     const Matrix3x4& viewMatrix = view->cullCamera_->GetView();
     Vector3 viewZ = Vector3(viewMatrix.m20_, viewMatrix.m21_, viewMatrix.m22_);
     Vector3 absViewZ = viewZ.Abs();
     unsigned cameraViewMask = view->cullCamera_->GetViewMask();
     bool cameraZoneOverride = view->cameraZoneOverride_;
+    bool useOcclusionQueries = view->useOcclusionQueries_;
     PerThreadSceneResult& result = view->sceneResults_[threadIndex];
 
     while (start != end)
@@ -207,6 +296,19 @@ void CheckVisibilityWork(const WorkItem* item, unsigned threadIndex)
                     continue;
             }
 
+            // Hierarchical LOD: draw either the cluster proxy or its members
+            HierarchicalLodGroup* hlodGroup = drawable->GetHierarchicalLodGroup();
+            if (hlodGroup && !hlodGroup->IsDrawableVisible(view->cullCamera_, drawable->IsHierarchicalLodProxy()))
+                continue;
+
+            // Keep testing geometries hidden by hardware occlusion queries so that they can become visible again
+            if (useOcclusionQueries && drawable->IsOccludee() && (drawable->GetDrawableFlags() & DRAWABLE_GEOMETRY))
+            {
+                result.occlusionQueryDrawables_.push_back(drawable);
+                if (view->IsOccludedByQuery(drawable))
+                    continue;
+            }
+
             drawable->MarkInView(view->frame_);
 
             // For geometries, find zone, clear lights and calculate view space Z range
@@ -248,63 +350,6 @@ void CheckVisibilityWork(const WorkItem* item, unsigned threadIndex)
     }
 }
 
-void ProcessLightWork(const WorkItem* item, unsigned threadIndex)
-{
-    URHO3D_PROFILE("ProcessLightWork");
-    auto* view = reinterpret_cast<View*>(item->aux_);
-    auto* query = reinterpret_cast<LightQueryResult*>(item->start_);
-
-    view->ProcessLight(*query, threadIndex);
-}
-
-void UpdateDrawableGeometriesWork(const WorkItem* item, unsigned threadIndex)
-{
-    URHO3D_PROFILE("UpdateDrawableGeometriesWork");
-    const FrameInfo& frame = *(reinterpret_cast<FrameInfo*>(item->aux_));
-    auto** start = reinterpret_cast<Drawable**>(item->start_);
-    auto** end = reinterpret_cast<Drawable**>(item->end_);
-
-    while (start != end)
-    {
-        Drawable* drawable = *start++;
-        // We may leave null pointer holes in the queue if a drawable is found out to require a main thread update
-        if (drawable)
-            drawable->UpdateGeometry(frame);
-    }
-}
-
-void SortBatchQueueFrontToBackWork(const WorkItem* item, unsigned threadIndex)
-{
-    URHO3D_PROFILE("SortBatchQueueFrontToBackWork");
-    auto* queue = reinterpret_cast<BatchQueue*>(item->start_);
-
-    queue->SortFrontToBack();
-}
-
-void SortBatchQueueBackToFrontWork(const WorkItem* item, unsigned threadIndex)
-{
-    URHO3D_PROFILE("SortBatchQueueBackToFrontWork");
-    auto* queue = reinterpret_cast<BatchQueue*>(item->start_);
-
-    queue->SortBackToFront();
-}
-
-void SortLightQueueWork(const WorkItem* item, unsigned threadIndex)
-{
-    URHO3D_PROFILE("SortLightQueueWork");
-    auto* start = reinterpret_cast<LightBatchQueue*>(item->start_);
-    start->litBaseBatches_.SortFrontToBack();
-    start->litBatches_.SortFrontToBack();
-}
-
-void SortShadowQueueWork(const WorkItem* item, unsigned threadIndex)
-{
-    URHO3D_PROFILE("SortShadowQueueWork");
-    auto* start = reinterpret_cast<LightBatchQueue*>(item->start_);
-    for (unsigned i = 0; i < start->shadowSplits_.size(); ++i)
-        start->shadowSplits_[i].shadowBatches_.SortFrontToBack();
-}
-
 StringHash ParseTextureTypeXml(ResourceCache* cache, const ea::string& filename);
 
 View::View(Context* context) :
@@ -316,8 +361,11 @@ View::View(Context* context) :
     unsigned numThreads = GetSubsystem<WorkQueue>()->GetNumThreads() + 1; // Worker threads + main thread
     tempDrawables_.resize(numThreads);
     sceneResults_.resize(numThreads);
+    sortTasks_ = ea::make_unique<TaskGraph>(GetSubsystem<WorkQueue>());
 }
 
+View::~View() = default;
+
 void View::RegisterObject(Context* context)
 {
     context->RegisterFactory<View>();
@@ -326,6 +374,8 @@ void View::RegisterObject(Context* context)
 bool View::Define(RenderSurface* renderTarget, Viewport* viewport)
 {
     sourceView_ = nullptr;
+    useOcclusionQueries_ = false;
+    useSharedDrawables_ = false;
     renderPath_ = viewport->GetRenderPath();
     if (!renderPath_)
         return false;
@@ -351,6 +401,21 @@ bool View::Define(RenderSurface* renderTarget, Viewport* viewport)
     viewSize_ = viewRect_.Size();
     rtSize_ = IntVector2(rtWidth, rtHeight);
 
+    // Render backbuffer scene views at reduced resolution if requested. They are upscaled to the viewport at the end
+    const float resolutionScale = renderer_->GetResolutionScale();
+    if (!renderTarget_ && resolutionScale < 1.0f)
+    {
+        for (const RenderPathCommand& command : renderPath_->commands_)
+        {
+            if (command.enabled_ && command.type_ == CMD_SCENEPASS)
+            {
+                viewSize_.x_ = Max(RoundToInt(viewSize_.x_ * resolutionScale), 1);
+                viewSize_.y_ = Max(RoundToInt(viewSize_.y_ * resolutionScale), 1);
+                break;
+            }
+        }
+    }
+
     // On OpenGL flip the viewport if rendering to a texture for consistent UV addressing with Direct3D9
 #ifdef URHO3D_OPENGL
     if (renderTarget_)
@@ -397,6 +462,7 @@ bool View::Define(RenderSurface* renderTarget, Viewport* viewport)
     lightPassIndex_ = Technique::GetPassIndex("light");
     litBasePassIndex_ = Technique::GetPassIndex("litbase");
     litAlphaPassIndex_ = Technique::GetPassIndex("litalpha");
+    pickPassIndex_ = M_MAX_UNSIGNED;
 
     deferred_ = false;
     deferredAmbient_ = false;
@@ -463,6 +529,8 @@ bool View::Define(RenderSurface* renderTarget, Viewport* viewport)
                     alphaPassIndex_ = command.passIndex_;
                     litAlphaPassIndex_ = Technique::GetPassIndex("lit" + command.pass_);
                 }
+                else if (command.metadata_ == "pick")
+                    pickPassIndex_ = command.passIndex_;
             }
 
             auto j = batchQueues_.find(info.passIndex_);
@@ -531,6 +599,7 @@ bool View::Define(RenderSurface* renderTarget, Viewport* viewport)
     drawShadows_ = renderer_->GetDrawShadows();
     materialQuality_ = renderer_->GetMaterialQuality();
     maxOccluderTriangles_ = renderer_->GetMaxOccluderTriangles();
+    maxPixelLights_ = (unsigned)renderer_->GetMaxPixelLights();
     minInstances_ = renderer_->GetMinInstances();
 
     // Set possible quality overrides from the camera
@@ -548,6 +617,24 @@ bool View::Define(RenderSurface* renderTarget, Viewport* viewport)
     if (viewSize_.y_ > viewSize_.x_ * 4)
         maxOccluderTriangles_ = 0;
 
+    // Store already here, so that later views using the same culling camera can share this view also when the views
+    // are defined before any of them is updated
+    renderer_->StorePreparedView(this, cullCamera_);
+    return true;
+}
+
+bool View::AddToSharedCulling(MultiFrustumOctreeQuery& query)
+{
+    useSharedDrawables_ = false;
+    if (sourceView_ || !hasScenePasses_ || !cullCamera_ || !octree_)
+        return false;
+
+    // Set automatic aspect ratio already here, as the frustum is needed before the update
+    if (cullCamera_->GetAutoAspectRatio())
+        cullCamera_->SetAspectRatioInternal((float)viewSize_.x_ / (float)viewSize_.y_);
+
+    query.AddFrustum(cullCamera_->GetFrustum(), cullCamera_->GetViewMask(), sharedDrawables_);
+    useSharedDrawables_ = true;
     return true;
 }
 
@@ -577,7 +664,17 @@ void View::Update(const FrameInfo& frame)
     activeOccluders_ = 0;
     vertexLightQueues_.clear();
     for (auto i = batchQueues_.begin(); i != batchQueues_.end(); ++i)
-        i->second.Clear(maxSortedInstances);
+        i->second.Clear(maxSortedInstances, &frameAllocator_);
+
+    // Light queues may be skipped this frame, so release their arena memory now too before the arena is reused
+    for (LightBatchQueue& lightQueue : lightQueues_)
+    {
+        lightQueue.litBaseBatches_.Clear(maxSortedInstances, &frameAllocator_);
+        lightQueue.litBatches_.Clear(maxSortedInstances, &frameAllocator_);
+        for (ShadowBatchQueue& shadowQueue : lightQueue.shadowSplits_)
+            shadowQueue.shadowBatches_.Clear(maxSortedInstances, &frameAllocator_);
+    }
+    frameAllocator_.BeginFrame();
 
     if (hasScenePasses_ && (!cullCamera_ || !octree_))
     {
@@ -591,7 +688,6 @@ void View::Update(const FrameInfo& frame)
 
     GetDrawables();
     GetBatches();
-    renderer_->StorePreparedView(this, cullCamera_);
 
     SendViewEvent(E_ENDVIEWUPDATE);
 }
@@ -821,11 +917,30 @@ void View::GetDrawables()
         return;
 
     URHO3D_PROFILE("GetDrawables");
+    FrameStageTimer stageTimer(context_, FS_VIEW_CULLING);
+
+    // Refresh packed culling data invalidated since the octree update
+    octree_->UpdateCullingData();
+
+    // Hardware occlusion query results are one frame late and only valid when rendering from the culling camera
+    useOcclusionQueries_ = renderer_->GetOcclusionQueries() && cullCamera_ == camera_;
+    UpdateOcclusionQueries();
 
     auto* queue = GetSubsystem<WorkQueue>();
     ea::vector<Drawable*>& tempDrawables = tempDrawables_[0];
 
     // Get zones and occluders first
+    if (useSharedDrawables_)
+    {
+        tempDrawables.clear();
+        for (Drawable* drawable : sharedDrawables_)
+        {
+            const unsigned char flags = drawable->GetDrawableFlags();
+            if (flags == DRAWABLE_ZONE || (flags == DRAWABLE_GEOMETRY && drawable->IsOccluder()))
+                tempDrawables.push_back(drawable);
+        }
+    }
+    else
     {
         ZoneOccluderOctreeQuery
             query(tempDrawables, cullCamera_->GetFrustum(), DRAWABLE_GEOMETRY | DRAWABLE_ZONE, cullCamera_->GetViewMask());
@@ -833,7 +948,6 @@ void View::GetDrawables()
     }
 
     highestZonePriority_ = M_MIN_INT;
-    int bestPriority = M_MIN_INT;
     Node* cameraNode = cullCamera_->GetNode();
     Vector3 cameraPos = cameraNode->GetWorldPosition();
 
@@ -849,32 +963,22 @@ void View::GetDrawables()
             int priority = zone->GetPriority();
             if (priority > highestZonePriority_)
                 highestZonePriority_ = priority;
-            if (priority > bestPriority && zone->IsInside(cameraPos))
-            {
-                cameraZone_ = zone;
-                bestPriority = priority;
-            }
         }
         else
             occluders_.push_back(drawable);
     }
 
+    zoneIndex_.Define(zones_);
+    if (Zone* zone = zoneIndex_.FindZone(cameraPos, M_MAX_UNSIGNED))
+        cameraZone_ = zone;
+
     // Determine the zone at far clip distance. If not found, or camera zone has override mode, use camera zone
     cameraZoneOverride_ = cameraZone_->GetOverride();
     if (!cameraZoneOverride_)
     {
         Vector3 farClipPos = cameraPos + cameraNode->GetWorldDirection() * Vector3(0.0f, 0.0f, cullCamera_->GetFarClip());
-        bestPriority = M_MIN_INT;
-
-        for (auto i = zones_.begin(); i != zones_.end(); ++i)
-        {
-            int priority = (*i)->GetPriority();
-            if (priority > bestPriority && (*i)->IsInside(farClipPos))
-            {
-                farClipZone_ = *i;
-                bestPriority = priority;
-            }
-        }
+        if (Zone* zone = zoneIndex_.FindZone(farClipPos, M_MAX_UNSIGNED))
+            farClipZone_ = zone;
     }
     if (farClipZone_ == renderer_->GetDefaultZone())
         farClipZone_ = cameraZone_;
@@ -889,14 +993,37 @@ void View::GetDrawables()
             URHO3D_PROFILE("DrawOcclusion");
 
             occlusionBuffer_ = renderer_->GetOcclusionBuffer(cullCamera_);
-            DrawOccluders(occlusionBuffer_, occluders_);
+            if (renderer_->GetReuseOcclusion())
+            {
+                // Skip rendering if the buffer already contains this exact view of the same occluders
+                unsigned occludersHash = GetOccludersHash(occluders_);
+                CombineHash(occludersHash, maxOccluderTriangles_);
+                if (!occlusionBuffer_->IsContentValid(occludersHash))
+                {
+                    DrawOccluders(occlusionBuffer_, occluders_);
+                    occlusionBuffer_->SetContentHash(occludersHash);
+                }
+            }
+            else
+                DrawOccluders(occlusionBuffer_, occluders_);
         }
     }
     else
         occluders_.clear();
 
-    // Get lights and geometries. Coarse occlusion for octants is used at this point
-    if (occlusionBuffer_)
+    // Get lights and geometries. Coarse occlusion for octants is used at this point. The shared query result has no octant
+    // occlusion, but the drawables are still tested against the occlusion buffer one by one below
+    if (useSharedDrawables_)
+    {
+        tempDrawables.clear();
+        for (Drawable* drawable : sharedDrawables_)
+        {
+            if (drawable->GetDrawableFlags() & (DRAWABLE_GEOMETRY | DRAWABLE_LIGHT))
+                tempDrawables.push_back(drawable);
+        }
+        useSharedDrawables_ = false;
+    }
+    else if (occlusionBuffer_)
     {
         OccludedFrustumOctreeQuery query
             (tempDrawables, cullCamera_->GetFrustum(), occlusionBuffer_, DRAWABLE_GEOMETRY | DRAWABLE_LIGHT, cullCamera_->GetViewMask());
@@ -915,39 +1042,24 @@ void View::GetDrawables()
             PerThreadSceneResult& result = sceneResults_[i];
 
             result.geometries_.clear();
+            result.occlusionQueryDrawables_.clear();
             result.lights_.clear();
             result.minZ_ = M_INFINITY;
             result.maxZ_ = 0.0f;
         }
 
-        int numWorkItems = queue->GetNumThreads() + 1; // Worker threads + main thread
-        int drawablesPerItem = tempDrawables.size() / numWorkItems;
-
-        auto start = tempDrawables.begin();
-        // Create a work item for each thread
-        for (int i = 0; i < numWorkItems; ++i)
+        queue->ParallelFor(tempDrawables.size(), DRAWABLE_GRAIN_SIZE,
+            [this, &tempDrawables](unsigned begin, unsigned end, unsigned threadIndex)
         {
-            SharedPtr<WorkItem> item = queue->GetFreeItem();
-            item->priority_ = M_MAX_UNSIGNED;
-            item->workFunction_ = CheckVisibilityWork;
-            item->aux_ = this;
-
-            auto end = tempDrawables.end();
-            if (i < numWorkItems - 1 && end - start > drawablesPerItem)
-                end = start + drawablesPerItem;
-
-            item->start_ = &(*start);
-            item->end_ = &(*end);
-            queue->AddWorkItem(item);
-
-            start = end;
-        }
+            CheckVisibilityWork(this, tempDrawables.data() + begin, tempDrawables.data() + end, threadIndex);
+        });
 
         queue->Complete(M_MAX_UNSIGNED);
     }
 
     // Combine lights, geometries & scene Z range from the threads
     geometries_.clear();
+    occlusionQueryDrawables_.clear();
     lights_.clear();
     minZ_ = M_INFINITY;
     maxZ_ = 0.0f;
@@ -958,6 +1070,8 @@ void View::GetDrawables()
         {
             PerThreadSceneResult& result = sceneResults_[i];
             geometries_.insert(geometries_.end(), result.geometries_.begin(), result.geometries_.end());
+            occlusionQueryDrawables_.insert(occlusionQueryDrawables_.end(), result.occlusionQueryDrawables_.begin(),
+                result.occlusionQueryDrawables_.end());
             lights_.insert(lights_.begin(), result.lights_.begin(), result.lights_.end());
             minZ_ = Min(minZ_, result.minZ_);
             maxZ_ = Max(maxZ_, result.maxZ_);
@@ -970,6 +1084,7 @@ void View::GetDrawables()
         minZ_ = result.minZ_;
         maxZ_ = result.maxZ_;
         ea::swap(geometries_, result.geometries_);
+        ea::swap(occlusionQueryDrawables_, result.occlusionQueryDrawables_);
         ea::swap(lights_, result.lights_);
     }
 
@@ -985,6 +1100,20 @@ void View::GetDrawables()
     }
 
     ea::quick_sort(lights_.begin(), lights_.end(), CompareLights);
+
+    // In forward rendering, render the least important per-pixel lights beyond the limit per-vertex. Move them before
+    // the remaining per-pixel lights, as per-vertex lights must be processed first
+    numDemotedLights_ = 0;
+    if (maxPixelLights_ && !deferred_)
+    {
+        auto firstPixelLight = ea::find_if(lights_.begin(), lights_.end(), [](Light* light) { return !light->GetPerVertex(); });
+        auto numPixelLights = (unsigned)(lights_.end() - firstPixelLight);
+        if (numPixelLights > maxPixelLights_)
+        {
+            numDemotedLights_ = numPixelLights - maxPixelLights_;
+            ea::rotate(firstPixelLight, firstPixelLight + maxPixelLights_, lights_.end());
+        }
+    }
 }
 
 void View::GetBatches()
@@ -992,6 +1121,8 @@ void View::GetBatches()
     if (!octree_ || !cullCamera_)
         return;
 
+    FrameStageTimer stageTimer(context_, FS_BATCHES);
+
     nonThreadedGeometries_.clear();
     threadedGeometries_.clear();
 
@@ -1005,25 +1136,72 @@ void View::ProcessLights()
     // Process lit geometries and shadow casters for each light
     URHO3D_PROFILE("ProcessLights");
 
+    octree_->UpdateCullingData();
+
     auto* queue = GetSubsystem<WorkQueue>();
     lightQueryResults_.resize(lights_.size());
 
+    unsigned numVertexLights = 0;
     for (unsigned i = 0; i < lightQueryResults_.size(); ++i)
     {
-        SharedPtr<WorkItem> item = queue->GetFreeItem();
-        item->priority_ = M_MAX_UNSIGNED;
-        item->workFunction_ = ProcessLightWork;
-        item->aux_ = this;
+        Light* light = lights_[i];
+        if (light->GetPerVertex())
+            ++numVertexLights;
+        lightQueryResults_[i].light_ = light;
+        lightQueryResults_[i].perVertex_ = light->GetPerVertex() || i < numVertexLights + numDemotedLights_;
+    }
+
+    queue->ParallelFor(lightQueryResults_.size(), 1, [this](unsigned begin, unsigned end, unsigned threadIndex)
+    {
+        URHO3D_PROFILE("ProcessLightWork");
+        for (unsigned i = begin; i < end; ++i)
+            ProcessLight(lightQueryResults_[i], threadIndex);
+    });
 
-        LightQueryResult& query = lightQueryResults_[i];
-        query.light_ = lights_[i];
+    // Ensure all lights have been processed before proceeding
+    queue->Complete(M_MAX_UNSIGNED);
 
-        item->start_ = &query;
-        queue->AddWorkItem(item);
+    // Process shadow casters of every split as a separate work item, so that a light with many splits over a large scene
+    // does not hold up the other lights
+    shadowSplitItems_.clear();
+    for (unsigned i = 0; i < lightQueryResults_.size(); ++i)
+    {
+        for (unsigned j = 0; j < lightQueryResults_[i].numSplits_; ++j)
+            shadowSplitItems_.emplace_back(i, j);
     }
 
-    // Ensure all lights have been processed before proceeding
+    if (shadowSplitItems_.empty())
+        return;
+
+    queue->ParallelFor(shadowSplitItems_.size(), 1, [this](unsigned begin, unsigned end, unsigned threadIndex)
+    {
+        URHO3D_PROFILE("ProcessShadowSplitWork");
+        for (unsigned i = begin; i < end; ++i)
+            ProcessShadowSplit(lightQueryResults_[shadowSplitItems_[i].first], shadowSplitItems_[i].second, threadIndex);
+    });
+
     queue->Complete(M_MAX_UNSIGNED);
+
+    // Merge the split shadow casters of each light
+    for (LightQueryResult& query : lightQueryResults_)
+    {
+        if (!query.numSplits_)
+            continue;
+
+        query.shadowCasters_.clear();
+        for (unsigned i = 0; i < query.numSplits_; ++i)
+        {
+            query.shadowCasterBegin_[i] = query.shadowCasters_.size();
+            query.shadowCasters_.insert(query.shadowCasters_.end(), query.splitShadowCasters_[i].begin(),
+                query.splitShadowCasters_[i].end());
+            query.shadowCasterEnd_[i] = query.shadowCasters_.size();
+        }
+
+        // If no shadow casters, the light can be rendered unshadowed. At this point we have not allocated a shadow map yet,
+        // so the only cost has been the shadow camera setup & queries
+        if (query.shadowCasters_.empty())
+            query.numSplits_ = 0;
+    }
 }
 
 void View::GetLightBatches()
@@ -1040,12 +1218,13 @@ void View::GetLightBatches()
         for (auto i = lightQueryResults_.begin(); i !=
             lightQueryResults_.end(); ++i)
         {
-            if (!i->light_->GetPerVertex() && i->litGeometries_.size())
+            if (!i->perVertex_ && i->litGeometries_.size())
                 ++numLightQueues;
         }
 
         lightQueues_.resize(numLightQueues);
         maxLightsDrawables_.clear();
+        const bool cacheShadowMaps = renderer_->GetCacheShadowMaps() && !renderer_->GetReuseShadowMaps();
         auto maxSortedInstances = (unsigned)renderer_->GetMaxSortedInstances();
 
         for (auto i = lightQueryResults_.begin(); i != lightQueryResults_.end(); ++i)
@@ -1059,7 +1238,7 @@ void View::GetLightBatches()
             Light* light = query.light_;
 
             // Per-pixel light
-            if (!light->GetPerVertex())
+            if (!query.perVertex_)
             {
                 unsigned shadowSplits = query.numSplits_;
 
@@ -1069,8 +1248,9 @@ void View::GetLightBatches()
                 lightQueue.light_ = light;
                 lightQueue.negative_ = light->IsNegative();
                 lightQueue.shadowMap_ = nullptr;
-                lightQueue.litBaseBatches_.Clear(maxSortedInstances);
-                lightQueue.litBatches_.Clear(maxSortedInstances);
+                lightQueue.shadowMapHash_ = 0;
+                lightQueue.litBaseBatches_.Clear(maxSortedInstances, &frameAllocator_);
+                lightQueue.litBatches_.Clear(maxSortedInstances, &frameAllocator_);
                 if (forwardLightsCommand_)
                 {
                     SetQueueShaderDefines(lightQueue.litBaseBatches_, *forwardLightsCommand_);
@@ -1092,6 +1272,18 @@ void View::GetLightBatches()
                         shadowSplits = 0;
                 }
 
+                // Cached shadow maps are only re-rendered when the shadow cameras or casters change. Casters with their own
+                // geometry updates can not be tracked, so they disable caching
+                bool cacheShadowMap = shadowSplits > 0 && cacheShadowMaps && light->GetLightType() != LIGHT_DIRECTIONAL;
+                unsigned shadowMapHash = 0;
+                if (cacheShadowMap)
+                {
+                    const BiasParameters& bias = light->GetShadowBias();
+                    shadowMapHash = MakeHash(lightQueue.shadowMap_);
+                    CombineHash(shadowMapHash, FloatToRawIntBits(bias.constantBias_));
+                    CombineHash(shadowMapHash, FloatToRawIntBits(bias.slopeScaledBias_));
+                }
+
                 // Setup shadow batch queues
                 lightQueue.shadowSplits_.resize(shadowSplits);
                 for (unsigned j = 0; j < shadowSplits; ++j)
@@ -1101,17 +1293,25 @@ void View::GetLightBatches()
                     shadowQueue.shadowCamera_ = shadowCamera;
                     shadowQueue.nearSplit_ = query.shadowNearSplits_[j];
                     shadowQueue.farSplit_ = query.shadowFarSplits_[j];
-                    shadowQueue.shadowBatches_.Clear(maxSortedInstances);
+                    shadowQueue.shadowBatches_.Clear(maxSortedInstances, &frameAllocator_);
 
                     // Setup the shadow split viewport and finalize shadow camera parameters
                     shadowQueue.shadowViewport_ = GetShadowMapViewport(light, j, lightQueue.shadowMap_);
                     FinalizeShadowCamera(shadowCamera, light, shadowQueue.shadowViewport_, query.shadowCasterBox_[j]);
+                    if (cacheShadowMap)
+                    {
+                        CombineHash(shadowMapHash, shadowCamera->GetView().ToHash());
+                        CombineHash(shadowMapHash, shadowCamera->GetGPUProjection().ToHash());
+                    }
 
                     // Loop through shadow casters
                     for (auto k = query.shadowCasters_.begin() + query.shadowCasterBegin_[j];
                          k < query.shadowCasters_.begin() + query.shadowCasterEnd_[j]; ++k)
                     {
                         Drawable* drawable = *k;
+                        if (cacheShadowMap && drawable->GetUpdateGeometryType() != UPDATE_NONE)
+                            cacheShadowMap = false;
+
                         // If drawable is not in actual view frustum, mark it in view here and check its geometry update type
                         if (!drawable->IsInView(frame_, true))
                         {
@@ -1129,7 +1329,7 @@ void View::GetLightBatches()
                         {
                             const SourceBatch& srcBatch = batches[l];
 
-                            Technique* tech = GetTechnique(drawable, srcBatch.material_);
+                            Technique* tech = GetTechnique(drawable, srcBatch);
                             if (!srcBatch.geometry_ || !srcBatch.numWorldTransforms_ || !tech)
                                 continue;
 
@@ -1138,7 +1338,16 @@ void View::GetLightBatches()
                             if (!pass)
                                 continue;
 
+                            if (cacheShadowMap)
+                            {
+                                CombineHash(shadowMapHash, MakeHash(srcBatch.geometry_));
+                                CombineHash(shadowMapHash, MakeHash(srcBatch.material_.Get()));
+                                for (unsigned m = 0; m < srcBatch.numWorldTransforms_; ++m)
+                                    CombineHash(shadowMapHash, srcBatch.worldTransform_[m].ToHash());
+                            }
+
                             Batch destBatch(srcBatch);
+                            destBatch.drawableType_ = drawable->GetType();
                             destBatch.pass_ = pass;
                             destBatch.zone_ = nullptr;
 
@@ -1147,6 +1356,10 @@ void View::GetLightBatches()
                     }
                 }
 
+                // A zero hash would mean the shadow map can not be cached
+                if (cacheShadowMap)
+                    lightQueue.shadowMapHash_ = shadowMapHash ? shadowMapHash : 1;
+
                 // Process lit geometries
                 for (auto j = query.litGeometries_.begin(); j !=
                     query.litGeometries_.end(); ++j)
@@ -1170,6 +1383,7 @@ void View::GetLightBatches()
                     volumeBatch.geometryType_ = GEOM_STATIC;
                     volumeBatch.worldTransform_ = &light->GetVolumeTransform(cullCamera_);
                     volumeBatch.numWorldTransforms_ = 1;
+                    volumeBatch.drawableType_ = light->GetType();
                     volumeBatch.lightQueue_ = &lightQueue;
                     volumeBatch.distance_ = light->GetDistance();
                     volumeBatch.material_ = nullptr;
@@ -1243,7 +1457,7 @@ void View::GetBaseBatches()
             if (srcBatch.material_ && srcBatch.material_->GetAuxViewFrameNumber() != frame_.frameNumber_ && !renderTarget_)
                 CheckMaterialForAuxView(srcBatch.material_);
 
-            Technique* tech = GetTechnique(drawable, srcBatch.material_);
+            Technique* tech = GetTechnique(drawable, srcBatch);
             if (!srcBatch.geometry_ || !srcBatch.numWorldTransforms_ || !tech)
                 continue;
 
@@ -1256,13 +1470,28 @@ void View::GetBaseBatches()
                     continue;
 
                 Pass* pass = tech->GetSupportedPass(info.passIndex_);
+                // Materials without own pick pass are rendered with the default pick technique
+                if (!pass && info.passIndex_ == pickPassIndex_)
+                {
+                    if (Technique* pickTech = renderer_->GetPickTechnique())
+                        pass = pickTech->GetSupportedPass(info.passIndex_);
+                }
                 if (!pass)
                     continue;
 
                 Batch destBatch(srcBatch);
+                destBatch.drawableType_ = drawable->GetType();
                 destBatch.pass_ = pass;
                 destBatch.zone_ = GetZone(drawable);
                 UpdateBatchAmbient(destBatch, globalIllumination_, drawable);
+                if (info.passIndex_ == pickPassIndex_)
+                {
+#if URHO3D_SPHERICAL_HARMONICS
+                    destBatch.shaderParameters_.ambient_.Ar_ = EncodePickId(drawable->GetID());
+#else
+                    destBatch.shaderParameters_.ambient_ = EncodePickId(drawable->GetID());
+#endif
+                }
                 destBatch.isBase_ = true;
                 destBatch.lightMask_ = (unsigned char)GetLightMask(drawable);
 
@@ -1321,8 +1550,10 @@ void View::UpdateGeometries()
 
     auto* queue = GetSubsystem<WorkQueue>();
 
-    // Sort batches
+    // Sort batches. Sorting tasks are independent, so they run as one graph without barriers between them
     {
+        sortTasks_->Clear();
+
         for (unsigned i = 0; i < renderPath_->commands_.size(); ++i)
         {
             const RenderPathCommand& command = renderPath_->commands_[i];
@@ -1331,32 +1562,36 @@ void View::UpdateGeometries()
 
             if (command.type_ == CMD_SCENEPASS)
             {
-                SharedPtr<WorkItem> item = queue->GetFreeItem();
-                item->priority_ = M_MAX_UNSIGNED;
-                item->workFunction_ =
-                    command.sortMode_ == SORT_FRONTTOBACK ? SortBatchQueueFrontToBackWork : SortBatchQueueBackToFrontWork;
-                item->start_ = &batchQueues_[command.passIndex_];
-                queue->AddWorkItem(item);
+                BatchQueue* batchQueue = &batchQueues_[command.passIndex_];
+                if (command.sortMode_ == SORT_FRONTTOBACK)
+                    sortTasks_->AddTask("SortBatchQueueFrontToBack", [batchQueue](unsigned) { batchQueue->SortFrontToBack(); });
+                else
+                    sortTasks_->AddTask("SortBatchQueueBackToFront", [batchQueue](unsigned) { batchQueue->SortBackToFront(); });
             }
         }
 
         for (auto i = lightQueues_.begin(); i != lightQueues_.end(); ++i)
         {
-            SharedPtr<WorkItem> lightItem = queue->GetFreeItem();
-            lightItem->priority_ = M_MAX_UNSIGNED;
-            lightItem->workFunction_ = SortLightQueueWork;
-            lightItem->start_ = &(*i);
-            queue->AddWorkItem(lightItem);
+            LightBatchQueue* lightQueue = &(*i);
+            sortTasks_->AddTask("SortLightQueue", [this, lightQueue](unsigned)
+            {
+                lightQueue->litBaseBatches_.SortFrontToBack();
+                lightQueue->litBatches_.SortFrontToBack();
+                // Precalculate light matrices here so that batch preparation on the render thread only uploads them
+                lightQueue->CalculateLightMatrices(renderer_);
+            });
 
             if (i->shadowSplits_.size())
             {
-                SharedPtr<WorkItem> shadowItem = queue->GetFreeItem();
-                shadowItem->priority_ = M_MAX_UNSIGNED;
-                shadowItem->workFunction_ = SortShadowQueueWork;
-                shadowItem->start_ = &(*i);
-                queue->AddWorkItem(shadowItem);
+                sortTasks_->AddTask("SortShadowQueue", [lightQueue](unsigned)
+                {
+                    for (unsigned j = 0; j < lightQueue->shadowSplits_.size(); ++j)
+                        lightQueue->shadowSplits_[j].shadowBatches_.SortFrontToBack();
+                });
             }
         }
+
+        sortTasks_->Run(M_MAX_UNSIGNED);
     }
 
     // Update geometries. Split into threaded and non-threaded updates.
@@ -1375,26 +1610,16 @@ void View::UpdateGeometries()
                 }
             }
 
-            int numWorkItems = queue->GetNumThreads() + 1; // Worker threads + main thread
-            int drawablesPerItem = threadedGeometries_.size() / numWorkItems;
-
-            auto start = threadedGeometries_.begin();
-            for (int i = 0; i < numWorkItems; ++i)
+            queue->ParallelFor(threadedGeometries_.size(), DRAWABLE_GRAIN_SIZE, [this](unsigned begin, unsigned end, unsigned)
             {
-                auto end = threadedGeometries_.end();
-                if (i < numWorkItems - 1 && end - start > drawablesPerItem)
-                    end = start + drawablesPerItem;
-
-                SharedPtr<WorkItem> item = queue->GetFreeItem();
-                item->priority_ = M_MAX_UNSIGNED;
-                item->workFunction_ = UpdateDrawableGeometriesWork;
-                item->aux_ = const_cast<FrameInfo*>(&frame_);
-                item->start_ = &(*start);
-                item->end_ = &(*end);
-                queue->AddWorkItem(item);
-
-                start = end;
-            }
+                URHO3D_PROFILE("UpdateDrawableGeometriesWork");
+                for (unsigned i = begin; i < end; ++i)
+                {
+                    // We may leave null pointer holes in the queue if a drawable is found out to require a main thread update
+                    if (Drawable* drawable = threadedGeometries_[i])
+                        drawable->UpdateGeometry(frame_);
+                }
+            });
         }
 
         // While the work queue is processed, update non-threaded geometries
@@ -1423,7 +1648,7 @@ void View::GetLitBatches(Drawable* drawable, LightBatchQueue& lightQueue, BatchQ
     {
         const SourceBatch& srcBatch = batches[i];
 
-        Technique* tech = GetTechnique(drawable, srcBatch.material_);
+        Technique* tech = GetTechnique(drawable, srcBatch);
         if (!srcBatch.geometry_ || !srcBatch.numWorldTransforms_ || !tech)
             continue;
 
@@ -1432,6 +1657,7 @@ void View::GetLitBatches(Drawable* drawable, LightBatchQueue& lightQueue, BatchQ
             continue;
 
         Batch destBatch(srcBatch);
+        destBatch.drawableType_ = drawable->GetType();
         bool isLitAlpha = false;
 
         // Check for lit base pass. Because it uses the replace blend mode, it must be ensured to be the first light
@@ -1484,18 +1710,27 @@ void View::GetLitBatches(Drawable* drawable, LightBatchQueue& lightQueue, BatchQ
 void View::ExecuteRenderPathCommands()
 {
     View* actualView = sourceView_ ? sourceView_.Get() : this;
+    GPUProfiler* gpuProfiler = renderer_->GetGPUProfiler();
 
     // If not reusing shadowmaps, render all of them first
     if (!renderer_->GetReuseShadowMaps() && renderer_->GetDrawShadows() && !actualView->lightQueues_.empty())
     {
         URHO3D_PROFILE("RenderShadowMaps");
+        if (gpuProfiler)
+            gpuProfiler->BeginBlock("ShadowMaps");
 
         for (auto i = actualView->lightQueues_.begin(); i !=
             actualView->lightQueues_.end(); ++i)
         {
-            if (NeedRenderShadowMap(*i))
+            if (NeedRenderShadowMap(*i) && !renderer_->IsShadowMapContentValid(i->light_, i->shadowMapHash_))
+            {
                 RenderShadowMap(*i);
+                renderer_->SetShadowMapContentHash(i->light_, i->shadowMapHash_);
+            }
         }
+
+        if (gpuProfiler)
+            gpuProfiler->EndBlock();
     }
 
     {
@@ -1596,6 +1831,9 @@ void View::ExecuteRenderPathCommands()
                     currentRenderTarget_ = substituteRenderTarget_ ? substituteRenderTarget_ : renderTarget_;
             }
 
+            if (gpuProfiler)
+                gpuProfiler->BeginBlock(GetCommandProfilerName(command));
+
             switch (command.type_)
             {
             case CMD_CLEAR:
@@ -1635,6 +1873,12 @@ void View::ExecuteRenderPathCommands()
 
                         passCommand_ = nullptr;
                     }
+
+                    // Test bounding boxes against the depth of opaque geometry.
+                    // Issue even if nothing was drawn, as hidden geometries must be tested to become visible again
+                    if (actualView == this && useOcclusionQueries_ && !occlusionQueriesIssued_ &&
+                        (command.passIndex_ == basePassIndex_ || command.passIndex_ == gBufferPassIndex_))
+                        IssueOcclusionQueries(command);
                 }
                 break;
 
@@ -1756,6 +2000,9 @@ void View::ExecuteRenderPathCommands()
                 break;
             }
 
+            if (gpuProfiler)
+                gpuProfiler->EndBlock();
+
             // If current command output to the viewport, mark it modified
             if (viewportWrite)
                 viewportModified = true;
@@ -2047,6 +2294,10 @@ void View::AllocateScreenBuffers()
             needSubstitute = true;
     }
 
+    // If rendering at reduced resolution, need a buffer to upscale from
+    if (viewSize_ != viewRect_.Size())
+        needSubstitute = true;
+
     // Follow final rendertarget format, or use RGB to match the backbuffer format
     unsigned format = renderTarget_ ? renderTarget_->GetParentTexture()->GetFormat() : Graphics::GetRGBFormat();
 
@@ -2164,10 +2415,16 @@ void View::BlitFramebuffer(Texture* source, RenderSurface* destination, bool dep
     graphics_->SetDepthStencil(GetDepthStencil(destination));
     graphics_->SetViewport(destRect);
 
+    // Sharpen when upscaling from reduced resolution
     static const char* shaderName = "CopyFramebuffer";
-    graphics_->SetShaders(graphics_->GetShader(VS, shaderName), graphics_->GetShader(PS, shaderName));
+    static const StringHash sharpnessParam("Sharpness");
+    const float sharpness = renderer_->GetUpscaleSharpness();
+    const bool sharpen = sharpness > 0.0f && destination == renderTarget_ && srcRect.Size() != destRect.Size();
+    graphics_->SetShaders(graphics_->GetShader(VS, shaderName), graphics_->GetShader(PS, shaderName, sharpen ? "SHARPEN" : ""));
 
     SetGBufferShaderParameters(srcSize, srcRect);
+    if (sharpen)
+        graphics_->SetShaderParameter(sharpnessParam, sharpness);
 
     graphics_->SetTexture(TU_DIFFUSE, source);
     DrawFullscreenQuad(true);
@@ -2310,15 +2567,106 @@ void View::DrawOccluders(OcclusionBuffer* buffer, const ea::vector<Drawable*>& o
     buffer->BuildDepthHierarchy();
 }
 
+void View::UpdateOcclusionQueries()
+{
+    // If queries were not rendered last frame, for example because the render path has no opaque pass,
+    // the results are outdated and must not hide anything
+    if (!useOcclusionQueries_ || !occlusionQueriesIssued_)
+        occlusionQueries_.clear();
+    occlusionQueriesIssued_ = false;
+
+    static const unsigned MAX_UNUSED_FRAMES = 60;
+    for (auto i = occlusionQueries_.begin(); i != occlusionQueries_.end();)
+    {
+        DrawableOcclusionQuery& state = i->second;
+        if (!state.drawable_ || frame_.frameNumber_ - state.lastFrame_ > MAX_UNUSED_FRAMES)
+            i = occlusionQueries_.erase(i);
+        else
+        {
+            state.query_->CheckResult();
+            ++i;
+        }
+    }
+}
+
+bool View::IsOccludedByQuery(Drawable* drawable) const
+{
+    auto i = occlusionQueries_.find(drawable);
+    if (i == occlusionQueries_.end() || i->second.drawable_ != drawable)
+        return false;
+
+    // Never hide objects whose bounding box contains the camera, their query is not reliable
+    const float margin = cullCamera_->GetNearClip() * 2.0f;
+    const BoundingBox& box = drawable->GetWorldBoundingBox();
+    const BoundingBox expandedBox(box.min_ - Vector3::ONE * margin, box.max_ + Vector3::ONE * margin);
+    if (expandedBox.IsInside(cullCamera_->GetNode()->GetWorldPosition()) != OUTSIDE)
+        return false;
+
+    return !i->second.query_->IsVisible();
+}
+
+void View::IssueOcclusionQueries(RenderPathCommand& command)
+{
+    URHO3D_PROFILE("IssueOcclusionQueries");
+
+    occlusionQueriesIssued_ = true;
+    if (occlusionQueryDrawables_.empty())
+        return;
+
+    SetRenderTargets(command);
+    graphics_->SetBlendMode(BLEND_REPLACE);
+    graphics_->SetColorWrite(false);
+    graphics_->SetDepthWrite(false);
+    graphics_->SetDepthTest(CMP_LESSEQUAL);
+    graphics_->SetCullMode(CULL_NONE);
+    graphics_->SetStencilTest(false);
+    graphics_->SetScissorTest(false);
+    graphics_->SetShaders(graphics_->GetShader(VS, "Stencil"), graphics_->GetShader(PS, "Stencil"));
+    graphics_->SetShaderParameter(VSP_VIEW, camera_->GetView());
+    graphics_->SetShaderParameter(VSP_VIEWINV, camera_->GetEffectiveWorldTransform());
+    graphics_->SetShaderParameter(VSP_VIEWPROJ, camera_->GetGPUProjection() * camera_->GetView());
+
+    Geometry* geometry = renderer_->GetBoxGeometry();
+    const Vector3 cameraPosition = cullCamera_->GetNode()->GetWorldPosition();
+    const float margin = cullCamera_->GetNearClip() * 2.0f;
+
+    for (Drawable* drawable : occlusionQueryDrawables_)
+    {
+        const BoundingBox& box = drawable->GetWorldBoundingBox();
+        const BoundingBox expandedBox(box.min_ - Vector3::ONE * margin, box.max_ + Vector3::ONE * margin);
+        if (expandedBox.IsInside(cameraPosition) != OUTSIDE)
+            continue;
+
+        DrawableOcclusionQuery& state = occlusionQueries_[drawable];
+        if (state.drawable_ != drawable || !state.query_)
+        {
+            state.drawable_ = drawable;
+            state.query_ = context_->CreateObject<OcclusionQuery>();
+        }
+
+        state.lastFrame_ = frame_.frameNumber_;
+        if (state.query_->IsPending())
+            continue;
+
+        graphics_->SetShaderParameter(VSP_MODEL, Matrix3x4(box.Center(), Quaternion::IDENTITY, box.Size()));
+        state.query_->Begin();
+        geometry->Draw(graphics_);
+        state.query_->End();
+    }
+
+    graphics_->ClearTransformSources();
+    graphics_->SetColorWrite(true);
+    graphics_->SetDepthWrite(true);
+}
+
 void View::ProcessLight(LightQueryResult& query, unsigned threadIndex)
 {
     Light* light = query.light_;
     LightType type = light->GetLightType();
     unsigned lightMask = light->GetLightMaskEffective();
-    const Frustum& frustum = cullCamera_->GetFrustum();
 
     // Check if light should be shadowed
-    bool isShadowed = drawShadows_ && light->GetCastShadows() && !light->GetPerVertex() && light->GetShadowIntensity() < 1.0f;
+    bool isShadowed = drawShadows_ && light->GetCastShadows() && !query.perVertex_ && light->GetShadowIntensity() < 1.0f;
     // If shadow distance non-zero, check it
     if (isShadowed && light->GetShadowDistance() > 0.0f && light->GetDistance() > light->GetShadowDistance())
         isShadowed = false;
@@ -2328,7 +2676,6 @@ void View::ProcessLight(LightQueryResult& query, unsigned threadIndex)
         isShadowed = false;
 #endif
     // Get lit geometries. They must match the light mask and be inside the main camera frustum to be considered
-    ea::vector<Drawable*>& tempDrawables = tempDrawables_[threadIndex];
     query.litGeometries_.clear();
 
     switch (type)
@@ -2342,27 +2689,15 @@ void View::ProcessLight(LightQueryResult& query, unsigned threadIndex)
         break;
 
     case LIGHT_SPOT:
-        {
-            FrustumOctreeQuery octreeQuery(tempDrawables, light->GetFrustum(), DRAWABLE_GEOMETRY,
-                cullCamera_->GetViewMask());
-            octree_->GetDrawables(octreeQuery);
-            for (unsigned i = 0; i < tempDrawables.size(); ++i)
-            {
-                if (tempDrawables[i]->IsInView(frame_) && (GetLightMask(tempDrawables[i]) & lightMask))
-                    query.litGeometries_.push_back(tempDrawables[i]);
-            }
-        }
-        break;
-
     case LIGHT_POINT:
         {
-            SphereOctreeQuery octreeQuery(tempDrawables, Sphere(light->GetNode()->GetWorldPosition(), light->GetRange()),
-                DRAWABLE_GEOMETRY, cullCamera_->GetViewMask());
-            octree_->GetDrawables(octreeQuery);
-            for (unsigned i = 0; i < tempDrawables.size(); ++i)
+            // The volume query is shared by all views of the scene rendered this frame with the same view mask
+            const ea::vector<Drawable*>& volumeDrawables = light->GetVolumeDrawables(octree_, frame_.frameNumber_,
+                cullCamera_->GetViewMask());
+            for (Drawable* drawable : volumeDrawables)
             {
-                if (tempDrawables[i]->IsInView(frame_) && (GetLightMask(tempDrawables[i]) & lightMask))
-                    query.litGeometries_.push_back(tempDrawables[i]);
+                if (drawable->IsInView(frame_) && (GetLightMask(drawable) & lightMask))
+                    query.litGeometries_.push_back(drawable);
             }
         }
         break;
@@ -2378,39 +2713,44 @@ void View::ProcessLight(LightQueryResult& query, unsigned threadIndex)
     // Determine number of shadow cameras and setup their initial positions
     SetupShadowCameras(query);
 
-    // Process each split for shadow casters
-    query.shadowCasters_.clear();
-    for (unsigned i = 0; i < query.numSplits_; ++i)
+    // Point and spot lights reuse the lit geometry query for shadow casters of all splits
+    if (type != LIGHT_DIRECTIONAL)
     {
-        Camera* shadowCamera = query.shadowCameras_[i];
-        const Frustum& shadowCameraFrustum = shadowCamera->GetFrustum();
-        query.shadowCasterBegin_[i] = query.shadowCasterEnd_[i] = query.shadowCasters_.size();
+        const ea::vector<Drawable*>& volumeDrawables = light->GetVolumeDrawables(octree_, frame_.frameNumber_,
+            cullCamera_->GetViewMask());
+        query.shadowCasterCandidates_.assign(volumeDrawables.begin(), volumeDrawables.end());
+    }
+}
 
-        // For point light check that the face is visible: if not, can skip the split
-        if (type == LIGHT_POINT && frustum.IsInsideFast(BoundingBox(shadowCameraFrustum)) == OUTSIDE)
-            continue;
+void View::ProcessShadowSplit(LightQueryResult& query, unsigned splitIndex, unsigned threadIndex)
+{
+    LightType type = query.light_->GetLightType();
+    const Frustum& frustum = cullCamera_->GetFrustum();
+    Camera* shadowCamera = query.shadowCameras_[splitIndex];
+    const Frustum& shadowCameraFrustum = shadowCamera->GetFrustum();
+    query.splitShadowCasters_[splitIndex].clear();
 
-        // For directional light check that the split is inside the visible scene: if not, can skip the split
-        if (type == LIGHT_DIRECTIONAL)
-        {
-            if (minZ_ > query.shadowFarSplits_[i])
-                continue;
-            if (maxZ_ < query.shadowNearSplits_[i])
-                continue;
+    // For point light check that the face is visible: if not, can skip the split
+    if (type == LIGHT_POINT && frustum.IsInsideFast(BoundingBox(shadowCameraFrustum)) == OUTSIDE)
+        return;
 
-            // Reuse lit geometry query for all except directional lights
-            ShadowCasterOctreeQuery query(tempDrawables, shadowCameraFrustum, DRAWABLE_GEOMETRY, cullCamera_->GetViewMask());
-            octree_->GetDrawables(query);
-        }
+    // For directional light check that the split is inside the visible scene: if not, can skip the split
+    if (type == LIGHT_DIRECTIONAL)
+    {
+        if (minZ_ > query.shadowFarSplits_[splitIndex])
+            return;
+        if (maxZ_ < query.shadowNearSplits_[splitIndex])
+            return;
+
+        ea::vector<Drawable*>& tempDrawables = tempDrawables_[threadIndex];
+        ShadowCasterOctreeQuery octreeQuery(tempDrawables, shadowCameraFrustum, DRAWABLE_GEOMETRY, cullCamera_->GetViewMask());
+        octree_->GetDrawables(octreeQuery);
 
         // Check which shadow casters actually contribute to the shadowing
-        ProcessShadowCasters(query, tempDrawables, i);
+        ProcessShadowCasters(query, tempDrawables, splitIndex);
     }
-
-    // If no shadow casters, the light can be rendered unshadowed. At this point we have not allocated a shadow map yet, so the
-    // only cost has been the shadow camera setup & queries
-    if (query.shadowCasters_.empty())
-        query.numSplits_ = 0;
+    else
+        ProcessShadowCasters(query, query.shadowCasterCandidates_, splitIndex);
 }
 
 void View::ProcessShadowCasters(LightQueryResult& query, const ea::vector<Drawable*>& drawables, unsigned splitIndex)
@@ -2470,6 +2810,9 @@ void View::ProcessShadowCasters(LightQueryResult& query, const ea::vector<Drawab
             maxShadowDistance = drawDistance;
         if (maxShadowDistance > 0.0f && drawable->GetDistance() > maxShadowDistance)
             continue;
+        HierarchicalLodGroup* hlodGroup = drawable->GetHierarchicalLodGroup();
+        if (hlodGroup && !hlodGroup->IsDrawableVisible(cullCamera_, drawable->IsHierarchicalLodProxy()))
+            continue;
 
         // Project shadow caster bounding box to light view space for visibility check
         lightViewBox = drawable->GetWorldBoundingBox().Transformed(lightView);
@@ -2482,11 +2825,9 @@ void View::ProcessShadowCasters(LightQueryResult& query, const ea::vector<Drawab
                 lightProjBox = lightViewBox.Projected(lightProj);
                 query.shadowCasterBox_[splitIndex].Merge(lightProjBox);
             }
-            query.shadowCasters_.push_back(drawable);
+            query.splitShadowCasters_[splitIndex].push_back(drawable);
         }
     }
-
-    query.shadowCasterEnd_[splitIndex] = query.shadowCasters_.size();
 }
 
 bool View::IsShadowCasterVisible(Drawable* drawable, BoundingBox lightViewBox, Camera* shadowCamera, const Matrix3x4& lightView,
@@ -2817,7 +3158,6 @@ void View::QuantizeDirLightShadowCamera(Camera* shadowCamera, Light* light, cons
 void View::FindZone(Drawable* drawable)
 {
     Vector3 center = drawable->GetWorldBoundingBox().Center();
-    int bestPriority = M_MIN_INT;
     Zone* newZone = nullptr;
 
     // If bounding box center is in view, the zone assignment is conclusive also for next frames. Otherwise it is temporary
@@ -2832,19 +3172,86 @@ void View::FindZone(Drawable* drawable)
         newZone = lastZone;
     else
     {
-        for (auto i = zones_.begin(); i != zones_.end(); ++i)
+        // Keep the current zone unless the drawable has moved into a zone of higher priority
+        if (lastZone && !(lastZone->GetViewMask() & cullCamera_->GetViewMask()))
+            lastZone = nullptr;
+        newZone = zoneIndex_.FindZone(center, drawable->GetZoneMask(), lastZone);
+    }
+
+    drawable->SetZone(newZone, temporary);
+}
+
+void ZoneIndex::Define(const ea::vector<Zone*>& zones)
+{
+    zones_ = zones;
+    ea::stable_sort(zones_.begin(), zones_.end(), [](Zone* lhs, Zone* rhs) { return lhs->GetPriority() > rhs->GetPriority(); });
+
+    const unsigned numGroups = (zones_.size() + 3) / 4;
+    boxes_.resize(numGroups * 24);
+    for (unsigned i = 0; i < numGroups * 4; ++i)
+    {
+        const BoundingBox box = i < zones_.size() ? zones_[i]->GetWorldBoundingBox() : BoundingBox();
+        float* group = &boxes_[(i / 4) * 24 + (i % 4)];
+        group[0] = box.min_.x_;
+        group[4] = box.min_.y_;
+        group[8] = box.min_.z_;
+        group[12] = box.max_.x_;
+        group[16] = box.max_.y_;
+        group[20] = box.max_.z_;
+    }
+}
+
+Zone* ZoneIndex::FindZone(const Vector3& point, unsigned zoneMask, Zone* currentZone) const
+{
+    // Zones are sorted by priority, so the search ends at the first hit or on reaching the priority of the current zone
+    int minPriority = M_MIN_INT;
+    if (currentZone && (currentZone->GetZoneMask() & zoneMask) && currentZone->IsInside(point))
+        minPriority = currentZone->GetPriority();
+    else
+        currentZone = nullptr;
+
+#ifdef URHO3D_SSE
+    const __m128 x = _mm_set1_ps(point.x_);
+    const __m128 y = _mm_set1_ps(point.y_);
+    const __m128 z = _mm_set1_ps(point.z_);
+#endif
+
+    for (unsigned i = 0; i < zones_.size(); i += 4)
+    {
+        if (zones_[i]->GetPriority() <= minPriority)
+            break;
+
+        // Test the point against the world bounding boxes of four zones before the exact oriented box tests
+        const float* group = &boxes_[(i / 4) * 24];
+#ifdef URHO3D_SSE
+        __m128 inside = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(group), x), _mm_cmple_ps(x, _mm_loadu_ps(group + 12)));
+        inside = _mm_and_ps(inside, _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(group + 4), y), _mm_cmple_ps(y, _mm_loadu_ps(group + 16))));
+        inside = _mm_and_ps(inside, _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(group + 8), z), _mm_cmple_ps(z, _mm_loadu_ps(group + 20))));
+        const unsigned insideMask = (unsigned)_mm_movemask_ps(inside);
+#else
+        unsigned insideMask = 0;
+        for (unsigned j = 0; j < 4; ++j)
         {
-            Zone* zone = *i;
-            int priority = zone->GetPriority();
-            if (priority > bestPriority && (drawable->GetZoneMask() & zone->GetZoneMask()) && zone->IsInside(center))
-            {
-                newZone = zone;
-                bestPriority = priority;
-            }
+            if (group[j] <= point.x_ && point.x_ <= group[12 + j] && group[4 + j] <= point.y_ && point.y_ <= group[16 + j] &&
+                group[8 + j] <= point.z_ && point.z_ <= group[20 + j])
+                insideMask |= 1u << j;
+        }
+#endif
+        if (!insideMask)
+            continue;
+
+        const unsigned count = Min(4u, zones_.size() - i);
+        for (unsigned j = 0; j < count; ++j)
+        {
+            Zone* zone = zones_[i + j];
+            if (zone->GetPriority() <= minPriority)
+                return currentZone;
+            if ((insideMask & (1u << j)) && (zone->GetZoneMask() & zoneMask) && zone->IsInside(point))
+                return zone;
         }
     }
 
-    drawable->SetZone(newZone, temporary);
+    return currentZone;
 }
 
 Technique* View::GetTechnique(Drawable* drawable, Material* material)
@@ -2881,6 +3288,53 @@ Technique* View::GetTechnique(Drawable* drawable, Material* material)
     }
 }
 
+Technique* View::GetTechnique(Drawable* drawable, const SourceBatch& batch)
+{
+    Material* material = batch.material_;
+    if (!material || material->GetNumTechniques() == 1)
+        return GetTechnique(drawable, material);
+
+    const float lodDistance = drawable->GetLodDistance();
+    const unsigned version = material->GetTechniquesVersion();
+    if (batch.cachedTechniquesVersion_ == version && batch.cachedMaterialQuality_ == materialQuality_ &&
+        lodDistance >= batch.cachedLodDistanceMin_ && lodDistance < batch.cachedLodDistanceMax_)
+        return batch.cachedTechnique_;
+
+    // Resolve as above, also tracking the LOD distance range over which the choice stays the same:
+    // it is bounded below by the chosen entry and above by the nearest preceding supported entry
+    const ea::vector<TechniqueEntry>& techniques = material->GetTechniques();
+    Technique* result = nullptr;
+    float rangeMin = -M_INFINITY;
+    float rangeMax = M_INFINITY;
+    bool found = false;
+    for (unsigned i = 0; i < techniques.size(); ++i)
+    {
+        const TechniqueEntry& entry = techniques[i];
+        Technique* tech = entry.technique_;
+
+        if (!tech || (!tech->IsSupported()) || materialQuality_ < entry.qualityLevel_)
+            continue;
+        if (lodDistance >= entry.lodDistance_)
+        {
+            result = tech;
+            rangeMin = entry.lodDistance_;
+            found = true;
+            break;
+        }
+        rangeMax = Min(rangeMax, entry.lodDistance_);
+    }
+
+    if (!found)
+        result = techniques.size() ? techniques.back().technique_ : nullptr;
+
+    batch.cachedTechnique_ = result;
+    batch.cachedTechniquesVersion_ = version;
+    batch.cachedMaterialQuality_ = materialQuality_;
+    batch.cachedLodDistanceMin_ = rangeMin;
+    batch.cachedLodDistanceMax_ = rangeMax;
+    return result;
+}
+
 void View::CheckMaterialForAuxView(Material* material)
 {
     const ea::unordered_map<TextureUnit, SharedPtr<Texture> >& textures = material->GetTextures();
@@ -2937,6 +3391,17 @@ void View::AddBatchToQueue(BatchQueue& queue, Batch& batch, Technique* tech, boo
     if (!batch.material_)
         batch.material_ = renderer_->GetDefaultMaterial();
 
+    // Draw from a persistent instance buffer as is, without copying the instances to the instancing buffer
+    if (allowInstancing && batch.instanceBuffer_ && batch.geometryType_ == GEOM_STATIC && batch.geometry_->GetIndexBuffer() &&
+        renderer_->GetInstancingBuffer())
+    {
+        batch.geometryType_ = GEOM_INSTANCED;
+        renderer_->SetBatchShaders(batch, tech, allowShadows, queue);
+        batch.CalculateSortKey();
+        queue.batches_.push_back(batch);
+        return;
+    }
+
     // Convert to instanced if possible
     if (allowInstancing && batch.geometryType_ == GEOM_STATIC && batch.geometry_->GetIndexBuffer())
         batch.geometryType_ = GEOM_INSTANCED;
@@ -3014,16 +3479,19 @@ void View::PrepareInstancingBuffer()
         totalInstances += i->litBatches_.GetNumInstances();
     }
 
-    if (!totalInstances || !renderer_->ResizeInstancingBuffer(totalInstances))
+    if (!totalInstances)
         return;
 
-    VertexBuffer* instancingBuffer = renderer_->GetInstancingBuffer();
-    unsigned freeIndex = 0;
-    void* dest = instancingBuffer->Lock(0, totalInstances, true);
+    // Allocate from the instancing buffer ring. Instance indices of the batch groups are absolute, so the locked range
+    // is addressed relative to its start index
+    unsigned startIndex = 0;
+    void* dest = renderer_->LockInstancingBuffer(totalInstances, startIndex);
     if (!dest)
         return;
 
-    const unsigned stride = instancingBuffer->GetVertexSize();
+    const unsigned stride = renderer_->GetInstancingBuffer()->GetVertexSize();
+    dest = static_cast<unsigned char*>(dest) - startIndex * stride;
+    unsigned freeIndex = startIndex;
     for (auto i = batchQueues_.begin(); i != batchQueues_.end(); ++i)
         i->second.SetInstancingData(dest, stride, freeIndex);
 
@@ -3035,7 +3503,7 @@ void View::PrepareInstancingBuffer()
         i->litBatches_.SetInstancingData(dest, stride, freeIndex);
     }
 
-    instancingBuffer->Unlock();
+    renderer_->UnlockInstancingBuffer();
 }
 
 void View::SetupLightVolumeBatch(Batch& batch)
@@ -3098,6 +3566,10 @@ void View::RenderShadowMap(const LightBatchQueue& queue)
 {
     URHO3D_PROFILE("RenderShadowMap");
 
+    GPUProfiler* gpuProfiler = renderer_->GetGPUProfiler();
+    if (gpuProfiler)
+        gpuProfiler->BeginBlock("ShadowMap " + queue.light_->GetNode()->GetName());
+
     Texture2D* shadowMap = queue.shadowMap_;
     graphics_->SetTexture(TU_SHADOWMAP, nullptr);
 
@@ -3174,6 +3646,9 @@ void View::RenderShadowMap(const LightBatchQueue& queue)
     // reset some parameters
     graphics_->SetColorWrite(true);
     graphics_->SetDepthBias(0.0f, 0.0f);
+
+    if (gpuProfiler)
+        gpuProfiler->EndBlock();
 }
 
 RenderSurface* View::GetDepthStencil(RenderSurface* renderTarget)
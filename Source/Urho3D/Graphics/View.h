@@ -38,19 +38,21 @@ class DebugRenderer;
 class GlobalIllumination;
 class Light;
 class Drawable;
+class MultiFrustumOctreeQuery;
 class Graphics;
 class OcclusionBuffer;
+class OcclusionQuery;
 class Octree;
 class Renderer;
 class RenderPath;
 class RenderSurface;
+class TaskGraph;
 class Technique;
 class Texture;
 class Texture2D;
 class Viewport;
 class Zone;
 struct RenderPathCommand;
-struct WorkItem;
 
 /// Intermediate light processing result.
 struct LightQueryResult
@@ -63,6 +65,10 @@ struct LightQueryResult
     ea::vector<Drawable*> shadowCasters_;
     /// Shadow cameras.
     Camera* shadowCameras_[MAX_LIGHT_SPLITS];
+    /// Shadow caster candidates of a point or spot light, shared by all its splits.
+    ea::vector<Drawable*> shadowCasterCandidates_;
+    /// Shadow casters of each split before they are merged into the shadow caster list.
+    ea::vector<Drawable*> splitShadowCasters_[MAX_LIGHT_SPLITS];
     /// Shadow caster start indices.
     unsigned shadowCasterBegin_[MAX_LIGHT_SPLITS];
     /// Shadow caster end indices.
@@ -75,6 +81,8 @@ struct LightQueryResult
     float shadowFarSplits_[MAX_LIGHT_SPLITS];
     /// Shadow map split count.
     unsigned numSplits_;
+    /// Whether the light is rendered per-vertex in this view, either by its own setting or due to the per-pixel light limit.
+    bool perVertex_;
 };
 
 /// Scene render pass info.
@@ -92,11 +100,24 @@ struct ScenePassInfo
     BatchQueue* batchQueue_;
 };
 
+/// Hardware occlusion query state of a drawable.
+struct DrawableOcclusionQuery
+{
+    /// Drawable. Used to detect that the drawable was destroyed.
+    WeakPtr<Drawable> drawable_;
+    /// Query of the drawable's bounding box.
+    SharedPtr<OcclusionQuery> query_;
+    /// Frame number when the drawable was last tested.
+    unsigned lastFrame_{};
+};
+
 /// Per-thread geometry, light and scene range collection structure.
 struct PerThreadSceneResult
 {
     /// Geometry objects.
     ea::vector<Drawable*> geometries_;
+    /// Geometry objects to test with hardware occlusion queries.
+    ea::vector<Drawable*> occlusionQueryDrawables_;
     /// Lights.
     ea::vector<Light*> lights_;
     /// Scene minimum Z value.
@@ -105,13 +126,26 @@ struct PerThreadSceneResult
     float maxZ_;
 };
 
+/// Zones of a view sorted by descending priority, with their world bounding boxes packed for testing a point against four zones at a time.
+struct ZoneIndex
+{
+    /// Rebuild from zones.
+    void Define(const ea::vector<Zone*>& zones);
+    /// Return the highest priority zone that contains the point and matches the zone mask. If the current zone contains the point, only zones of higher priority can replace it. Return null if not found.
+    Zone* FindZone(const Vector3& point, unsigned zoneMask, Zone* currentZone = nullptr) const;
+
+    /// Zones sorted by descending priority. Zones of equal priority keep their order.
+    ea::vector<Zone*> zones_;
+    /// World bounding boxes in groups of four zones: four min X, min Y, min Z, max X, max Y and max Z each. The last group is padded with empty boxes.
+    ea::vector<float> boxes_;
+};
+
 static const unsigned MAX_VIEWPORT_TEXTURES = 2;
 
 /// Internal structure for 3D rendering work. Created for each backbuffer and texture viewport, but not for shadow cameras.
 class URHO3D_API View : public Object
 {
-    friend void CheckVisibilityWork(const WorkItem* item, unsigned threadIndex);
-    friend void ProcessLightWork(const WorkItem* item, unsigned threadIndex);
+    friend void CheckVisibilityWork(View* view, Drawable* const* start, Drawable* const* end, unsigned threadIndex);
 
     URHO3D_OBJECT(View, Object);
 
@@ -119,7 +153,7 @@ public:
     /// Construct.
     explicit View(Context* context);
     /// Destruct.
-    ~View() override = default;
+    ~View() override;
 
     /// Register object with the engine.
     static void RegisterObject(Context* context);
@@ -128,6 +162,8 @@ public:
     bool Define(RenderSurface* renderTarget, Viewport* viewport);
     /// Update and cull objects and construct rendering batches.
     void Update(const FrameInfo& frame);
+    /// Add the culling frustum to a query shared with other views of the same octree, to be used by the next update instead of querying the octree separately. Return true if the view takes part. Called by Renderer after Define.
+    bool AddToSharedCulling(MultiFrustumOctreeQuery& query);
     /// Render batches.
     void Render();
 
@@ -243,8 +279,16 @@ private:
     void UpdateOccluders(ea::vector<Drawable*>& occluders, Camera* camera);
     /// Draw occluders to occlusion buffer.
     void DrawOccluders(OcclusionBuffer* buffer, const ea::vector<Drawable*>& occluders);
-    /// Query for lit geometries and shadow casters for a light.
+    /// Read back available hardware occlusion query results and forget drawables that are no longer tested.
+    void UpdateOcclusionQueries();
+    /// Return whether the last hardware occlusion query result of a drawable says it is hidden. Safe to call from worker threads.
+    bool IsOccludedByQuery(Drawable* drawable) const;
+    /// Issue hardware occlusion queries for the bounding boxes of tested drawables. Called after opaque geometry has been rendered.
+    void IssueOcclusionQueries(RenderPathCommand& command);
+    /// Query for lit geometries of a light and set up its shadow cameras.
     void ProcessLight(LightQueryResult& query, unsigned threadIndex);
+    /// Query for shadow casters of one shadow split of a light.
+    void ProcessShadowSplit(LightQueryResult& query, unsigned splitIndex, unsigned threadIndex);
     /// Process shadow casters' visibilities and build their combined view- or projection-space bounding box.
     void ProcessShadowCasters(LightQueryResult& query, const ea::vector<Drawable*>& drawables, unsigned splitIndex);
     /// Set up initial shadow camera view(s).
@@ -266,6 +310,8 @@ private:
     void FindZone(Drawable* drawable);
     /// Return material technique, considering the drawable's LOD distance.
     Technique* GetTechnique(Drawable* drawable, Material* material);
+    /// Return source batch material technique, considering the drawable's LOD distance. Reuses the technique cached in the batch when still valid.
+    Technique* GetTechnique(Drawable* drawable, const SourceBatch& batch);
     /// Check if material should render an auxiliary view (if it has a camera attached).
     void CheckMaterialForAuxView(Material* material);
     /// Set shader defines for a batch queue if used.
@@ -339,6 +385,14 @@ private:
     Zone* farClipZone_{};
     /// Occlusion buffer for the main camera.
     OcclusionBuffer* occlusionBuffer_{};
+    /// Hardware occlusion query states by drawable.
+    ea::unordered_map<Drawable*, DrawableOcclusionQuery> occlusionQueries_;
+    /// Geometry objects to test with hardware occlusion queries this frame.
+    ea::vector<Drawable*> occlusionQueryDrawables_;
+    /// Hardware occlusion queries flag.
+    bool useOcclusionQueries_{};
+    /// Hardware occlusion queries issued this frame flag.
+    bool occlusionQueriesIssued_{};
     /// Destination color rendertarget.
     RenderSurface* renderTarget_{};
     /// Substitute rendertarget for deferred rendering. Allocated if necessary.
@@ -371,6 +425,10 @@ private:
     int materialQuality_{};
     /// Maximum number of occluder triangles.
     int maxOccluderTriangles_{};
+    /// Maximum number of per-pixel lights, 0 = unlimited.
+    unsigned maxPixelLights_{};
+    /// Number of per-pixel lights at the start of the light list that are rendered per-vertex due to the per-pixel light limit.
+    unsigned numDemotedLights_{};
     /// Minimum number of instances required in a batch group to render as instanced.
     int minInstances_{};
     /// Highest zone priority currently visible.
@@ -397,10 +455,18 @@ private:
     RenderPath* renderPath_{};
     /// Per-thread octree query results.
     ea::vector<ea::vector<Drawable*> > tempDrawables_;
+    /// Zones, geometries and lights inside the culling frustum from a query shared with other views.
+    ea::vector<Drawable*> sharedDrawables_;
+    /// Whether the next update uses the shared query result instead of querying the octree.
+    bool useSharedDrawables_{};
     /// Per-thread geometries, lights and Z range collection results.
     ea::vector<PerThreadSceneResult> sceneResults_;
+    /// Batch queue sorting tasks.
+    ea::unique_ptr<TaskGraph> sortTasks_;
     /// Visible zones.
     ea::vector<Zone*> zones_;
+    /// Visible zones indexed for zone lookups.
+    ZoneIndex zoneIndex_;
     /// Visible geometry objects.
     ea::vector<Drawable*> geometries_;
     /// Geometry objects that will be updated in the main thread.
@@ -420,8 +486,12 @@ private:
     ea::unordered_map<StringHash, Texture*> renderTargets_;
     /// Intermediate light processing results.
     ea::vector<LightQueryResult> lightQueryResults_;
+    /// Light query result and split index pairs of shadow splits to process.
+    ea::vector<ea::pair<unsigned, unsigned> > shadowSplitItems_;
     /// Info for scene render passes defined by the renderpath.
     ea::vector<ScenePassInfo> scenePasses_;
+    /// Arena for batch groups and sort tables. Declared before the batch queues so that it outlives them.
+    FrameAllocator frameAllocator_;
     /// Per-pixel light queues.
     ea::vector<LightBatchQueue> lightQueues_;
     /// Per-vertex light queues.
@@ -440,6 +510,8 @@ private:
     unsigned litBasePassIndex_{};
     /// Index of the litalpha pass.
     unsigned litAlphaPassIndex_{};
+    /// Index of the object ID pick pass.
+    unsigned pickPassIndex_{};
     /// Pointer to the light volume command if any.
     const RenderPathCommand* lightVolumeCommand_{};
     /// Pointer to the forwardlights command if any.
@@ -176,7 +176,11 @@ void IKEffector::SetWeight(float weight)
 {
     weight_ = Clamp(weight, 0.0f, 1.0f);
     if (ikEffectorNode_ != nullptr)
+    {
         ikEffectorNode_->effector->weight = weight_;
+        if (solver_)
+            solver_->InvalidatePoseCache();
+    }
 }
 
 // ----------------------------------------------------------------------------
@@ -193,6 +197,7 @@ void IKEffector::SetRotationWeight(float weight)
     {
         ikEffectorNode_->rotation_weight = rotationWeight_;
         ik_calculate_rotation_weight_decays(&solver_->solver_->chain_tree);
+        solver_->InvalidatePoseCache();
     }
 }
 
@@ -210,6 +215,7 @@ void IKEffector::SetRotationDecay(float decay)
     {
         ikEffectorNode_->effector->rotation_decay = rotationDecay_;
         ik_calculate_rotation_weight_decays(&solver_->solver_->chain_tree);
+        solver_->InvalidatePoseCache();
     }
 }
 
@@ -225,6 +231,8 @@ void IKEffector::SetFeature(Feature feature, bool enable)
                 ikEffectorNode_->effector->flags &= ~EFFECTOR_WEIGHT_NLERP;
                 if (enable)
                     ikEffectorNode_->effector->flags |= EFFECTOR_WEIGHT_NLERP;
+                if (solver_)
+                    solver_->InvalidatePoseCache();
             }
         } break;
 
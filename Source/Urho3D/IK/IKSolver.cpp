@@ -25,6 +25,7 @@
 #include "../IK/IKEvents.h"
 #include "../IK/IKEffector.h"
 #include "../IK/IKConverters.h"
+#include "../IK/IKWorld.h"
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
@@ -32,6 +33,7 @@
 #include "../Graphics/AnimationState.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../IO/Log.h"
+#include "../Scene/Scene.h"
 #include "../Scene/SceneEvents.h"
 
 #include <ik/effector.h>
@@ -72,6 +74,9 @@ IKSolver::~IKSolver()
     for (auto it = effectorList_.begin(); it != effectorList_.end(); ++it)
         (*it)->SetIKEffectorNode(nullptr);
 
+    if (world_)
+        world_->RemoveSolver(this);
+
     ik_solver_destroy(solver_);
     context_->ReleaseIK();
 }
@@ -102,6 +107,7 @@ void IKSolver::RegisterObject(Context* context)
     URHO3D_ACCESSOR_ATTRIBUTE("Use Original Pose", GetUSE_ORIGINAL_POSE, SetUSE_ORIGINAL_POSE, bool, false, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Enable Constraints", GetCONSTRAINTS, SetCONSTRAINTS, bool, false, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Auto Solve", GetAUTO_SOLVE, SetAUTO_SOLVE, bool, true, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Pose Cache Tolerance", GetPoseCacheTolerance, SetPoseCacheTolerance, float, 0.001f, AM_DEFAULT);
 }
 
 // ----------------------------------------------------------------------------
@@ -170,23 +176,14 @@ void IKSolver::SetFeature(Feature feature, bool enable)
                 solver_->flags |= SOLVER_CALCULATE_TARGET_ROTATIONS;
         } break;
 
-        case AUTO_SOLVE:
-        {
-            if (((features_ & AUTO_SOLVE) != 0) == enable)
-                break;
-
-            if (enable)
-                SubscribeToEvent(GetScene(), E_SCENEDRAWABLEUPDATEFINISHED, URHO3D_HANDLER(IKSolver, HandleSceneDrawableUpdateFinished));
-            else
-                UnsubscribeFromEvent(GetScene(), E_SCENEDRAWABLEUPDATEFINISHED);
-        } break;
-
         default: break;
     }
 
     features_ &= ~feature;
     if (enable)
         features_ |= feature;
+
+    InvalidatePoseCache();
 }
 
 // ----------------------------------------------------------------------------
@@ -199,6 +196,7 @@ unsigned IKSolver::GetMaximumIterations() const
 void IKSolver::SetMaximumIterations(unsigned iterations)
 {
     solver_->max_iterations = iterations;
+    InvalidatePoseCache();
 }
 
 // ----------------------------------------------------------------------------
@@ -213,6 +211,19 @@ void IKSolver::SetTolerance(float tolerance)
     if (tolerance < M_EPSILON)
         tolerance = M_EPSILON;
     solver_->tolerance = tolerance;
+    InvalidatePoseCache();
+}
+
+// ----------------------------------------------------------------------------
+float IKSolver::GetPoseCacheTolerance() const
+{
+    return poseCacheTolerance_;
+}
+
+// ----------------------------------------------------------------------------
+void IKSolver::SetPoseCacheTolerance(float tolerance)
+{
+    poseCacheTolerance_ = Max(tolerance, 0.0f);
 }
 
 // ----------------------------------------------------------------------------
@@ -264,6 +275,7 @@ ik_node_t* IKSolver::CreateIKNodeFromUrhoNode(const Node* node)
 void IKSolver::DestroyTree()
 {
     ik_solver_destroy_tree(solver_);
+    poseNodesDirty_ = true;
     effectorList_.clear();
     constraintList_.clear();
 }
@@ -344,6 +356,7 @@ bool IKSolver::BuildTreeToEffector(IKEffector* effector)
 
         ik_node_t* ikChildNode = CreateIKNodeFromUrhoNode(iterNode);
         ik_node_add_child(ikNode, ikChildNode);
+        poseNodesDirty_ = true;
 
         ikNode = ikChildNode;
     }
@@ -400,6 +413,16 @@ void IKSolver::Solve()
 {
     URHO3D_PROFILE("IKSolve");
 
+    if (BeginSolve(-1.0f))
+    {
+        SolvePose();
+        EndSolve();
+    }
+}
+
+// ----------------------------------------------------------------------------
+bool IKSolver::BeginSolve(float cacheTolerance)
+{
     if (treeNeedsRebuild)
         RebuildTree();
 
@@ -407,28 +430,186 @@ void IKSolver::Solve()
         RebuildChainTrees();
 
     if (IsSolverTreeValid() == false)
-        return;
-
-    if (features_ & UPDATE_ORIGINAL_POSE)
-        ApplySceneToOriginalPose();
+        return false;
 
-    if (features_ & UPDATE_ACTIVE_POSE)
-        ApplySceneToActivePose();
-
-    if (features_ & USE_ORIGINAL_POSE)
-        ApplyOriginalPoseToActivePose();
+    if (poseNodesDirty_)
+        CollectPoseNodes();
 
     for (auto it = effectorList_.begin(); it != effectorList_.end(); ++it)
     {
         (*it)->UpdateTargetNodePosition();
     }
 
+    rootTransform_ = node_->GetWorldTransform();
+    rootInverseTransform_ = rootTransform_.Inverse();
+    rootRotation_ = node_->GetWorldRotation();
+
+    // Scene pose is read here, the internal tree is updated from it by SolvePose()
+    if (features_ & (UPDATE_ORIGINAL_POSE | UPDATE_ACTIVE_POSE))
+    {
+        for (unsigned i = 0; i < poseNodes_.size(); ++i)
+        {
+            scenePositions_[i] = poseNodes_[i]->GetWorldPosition();
+            sceneRotations_[i] = poseNodes_[i]->GetWorldRotation();
+        }
+    }
+
+    solveRequired_ = cacheTolerance < 0.0f || !poseCacheValid_ || HasPoseInputChanged(cacheTolerance);
+    if (solveRequired_)
+        StorePoseInput();
+
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+void IKSolver::SolvePose()
+{
+    if (!solveRequired_)
+        return;
+
+    if (features_ & (UPDATE_ORIGINAL_POSE | UPDATE_ACTIVE_POSE))
+    {
+        const bool updateOriginal = (features_ & UPDATE_ORIGINAL_POSE) != 0;
+        const bool updateActive = (features_ & UPDATE_ACTIVE_POSE) != 0;
+        for (unsigned i = 0; i < poseIKNodes_.size(); ++i)
+        {
+            ik_node_t* ikNode = poseIKNodes_[i];
+            if (updateOriginal)
+            {
+                ikNode->original_position = Vec3Urho2IK(scenePositions_[i]);
+                ikNode->original_rotation = QuatUrho2IK(sceneRotations_[i]);
+            }
+            if (updateActive)
+            {
+                ikNode->position = Vec3Urho2IK(scenePositions_[i]);
+                ikNode->rotation = QuatUrho2IK(sceneRotations_[i]);
+            }
+        }
+    }
+
+    if (features_ & USE_ORIGINAL_POSE)
+        ApplyOriginalPoseToActivePose();
+
     ik_solver_solve(solver_);
 
     if (features_ & JOINT_ROTATIONS)
         ik_solver_calculate_joint_rotations(solver_);
 
-    ApplyActivePoseToScene();
+    // Keep the solution relative to the solver node, so that it can be reapplied after the node has moved
+    const Quaternion rootInverseRotation = rootRotation_.Inverse();
+    for (unsigned i = 0; i < poseIKNodes_.size(); ++i)
+    {
+        solvedPositions_[i] = rootInverseTransform_ * Vec3IK2Urho(&poseIKNodes_[i]->position);
+        solvedRotations_[i] = rootInverseRotation * QuatIK2Urho(&poseIKNodes_[i]->rotation);
+    }
+
+    poseCacheValid_ = true;
+}
+
+// ----------------------------------------------------------------------------
+void IKSolver::EndSolve()
+{
+    for (unsigned i = 0; i < poseNodes_.size(); ++i)
+    {
+        Node* node = poseNodes_[i];
+        node->SetWorldRotation(rootRotation_ * solvedRotations_[i]);
+        node->SetWorldPosition(rootTransform_ * solvedPositions_[i]);
+    }
+}
+
+// ----------------------------------------------------------------------------
+static void CollectPoseNodesRecursive(ik_node_t* ikNode, ea::vector<Node*>& nodes, ea::vector<ik_node_t*>& ikNodes)
+{
+    nodes.push_back(static_cast<Node*>(ikNode->user_data));
+    ikNodes.push_back(ikNode);
+
+    BSTV_FOR_EACH(&ikNode->children, ik_node_t, guid, child)
+        CollectPoseNodesRecursive(child, nodes, ikNodes);
+    BSTV_END_EACH
+}
+void IKSolver::CollectPoseNodes()
+{
+    poseNodes_.clear();
+    poseIKNodes_.clear();
+    if (solver_->tree != nullptr)
+        CollectPoseNodesRecursive(solver_->tree, poseNodes_, poseIKNodes_);
+
+    const unsigned numNodes = poseNodes_.size();
+    scenePositions_.resize(numNodes);
+    sceneRotations_.resize(numNodes);
+    cachedPositions_.resize(numNodes);
+    cachedRotations_.resize(numNodes);
+    solvedPositions_.resize(numNodes);
+    solvedRotations_.resize(numNodes);
+
+    poseNodesDirty_ = false;
+    poseCacheValid_ = false;
+}
+
+// ----------------------------------------------------------------------------
+bool IKSolver::HasPoseInputChanged(float tolerance) const
+{
+    const float toleranceSquared = tolerance * tolerance;
+    const float minRotationDot = 1.0f - toleranceSquared;
+    const Quaternion rootInverseRotation = rootRotation_.Inverse();
+
+    if (cachedTargetPositions_.size() != effectorList_.size())
+        return true;
+
+    for (unsigned i = 0; i < effectorList_.size(); ++i)
+    {
+        const IKEffector* effector = effectorList_[i];
+        const Vector3 targetPosition = rootInverseTransform_ * effector->GetTargetPosition();
+        if ((targetPosition - cachedTargetPositions_[i]).LengthSquared() > toleranceSquared)
+            return true;
+        const Quaternion targetRotation = rootInverseRotation * effector->GetTargetRotation();
+        if (Abs(targetRotation.DotProduct(cachedTargetRotations_[i])) < minRotationDot)
+            return true;
+    }
+
+    if (features_ & (UPDATE_ORIGINAL_POSE | UPDATE_ACTIVE_POSE))
+    {
+        for (unsigned i = 0; i < poseNodes_.size(); ++i)
+        {
+            const Vector3 position = rootInverseTransform_ * scenePositions_[i];
+            if ((position - cachedPositions_[i]).LengthSquared() > toleranceSquared)
+                return true;
+            const Quaternion rotation = rootInverseRotation * sceneRotations_[i];
+            if (Abs(rotation.DotProduct(cachedRotations_[i])) < minRotationDot)
+                return true;
+        }
+    }
+
+    return false;
+}
+
+// ----------------------------------------------------------------------------
+void IKSolver::StorePoseInput()
+{
+    const Quaternion rootInverseRotation = rootRotation_.Inverse();
+
+    cachedTargetPositions_.resize(effectorList_.size());
+    cachedTargetRotations_.resize(effectorList_.size());
+    for (unsigned i = 0; i < effectorList_.size(); ++i)
+    {
+        cachedTargetPositions_[i] = rootInverseTransform_ * effectorList_[i]->GetTargetPosition();
+        cachedTargetRotations_[i] = rootInverseRotation * effectorList_[i]->GetTargetRotation();
+    }
+
+    if (features_ & (UPDATE_ORIGINAL_POSE | UPDATE_ACTIVE_POSE))
+    {
+        for (unsigned i = 0; i < poseNodes_.size(); ++i)
+        {
+            cachedPositions_[i] = rootInverseTransform_ * scenePositions_[i];
+            cachedRotations_[i] = rootInverseRotation * sceneRotations_[i];
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+void IKSolver::InvalidatePoseCache()
+{
+    poseCacheValid_ = false;
 }
 
 // ----------------------------------------------------------------------------
@@ -489,12 +670,14 @@ void IKSolver::ApplyOriginalPoseToActivePose()
 void IKSolver::MarkChainsNeedUpdating()
 {
     chainTreesNeedUpdating_ = true;
+    poseNodesDirty_ = true;
 }
 
 // ----------------------------------------------------------------------------
 void IKSolver::MarkTreeNeedsRebuild()
 {
     treeNeedsRebuild = true;
+    poseNodesDirty_ = true;
 }
 
 // ----------------------------------------------------------------------------
@@ -518,8 +701,13 @@ bool IKSolver::IsSolverTreeValid() const
 // ----------------------------------------------------------------------------
 void IKSolver::OnSceneSet(Scene* scene)
 {
-    if (features_ & AUTO_SOLVE)
-        SubscribeToEvent(scene, E_SCENEDRAWABLEUPDATEFINISHED, URHO3D_HANDLER(IKSolver, HandleSceneDrawableUpdateFinished));
+    // All solvers of the scene are solved together by the IK world
+    if (world_)
+        world_->RemoveSolver(this);
+
+    world_ = scene ? scene->GetOrCreateComponent<IKWorld>() : nullptr;
+    if (world_)
+        world_->AddSolver(this);
 }
 
 // ----------------------------------------------------------------------------
@@ -719,12 +907,6 @@ void IKSolver::HandleNodeRemoved(StringHash eventType, VariantMap& eventData)
     }
 }
 
-// ----------------------------------------------------------------------------
-void IKSolver::HandleSceneDrawableUpdateFinished(StringHash eventType, VariantMap& eventData)
-{
-    Solve();
-}
-
 // ----------------------------------------------------------------------------
 void IKSolver::DrawDebugGeometry(bool depthTest)
 {
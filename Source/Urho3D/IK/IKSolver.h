@@ -32,6 +32,7 @@ namespace Urho3D
 class AnimationState;
 class IKConstraint;
 class IKEffector;
+class IKWorld;
 
 /*!
  * @brief Marks the root or "beginning" of an IK chain or multiple IK chains.
@@ -234,6 +235,19 @@ public:
      */
     void SetTolerance(float tolerance);
 
+    /// Returns the configured pose cache tolerance.
+    float GetPoseCacheTolerance() const;
+
+    /*!
+     * @brief Sets how far the effector targets and the animated pose may move
+     * before the chains are solved again when solving automatically. Until
+     * then, the previous solution is reapplied relative to the solver node.
+     *
+     * @param tolerance Distance in world units. Zero disables the cache. The
+     * default value is 0.001.
+     */
+    void SetPoseCacheTolerance(float tolerance);
+
     /*!
      * @brief Updates the solver's internal data structures, which is required
      * whenever the tree is modified in any way (e.g. adding or removing nodes,
@@ -310,6 +324,22 @@ public:
 
 private:
     friend class IKEffector;
+    friend class IKWorld;
+
+    /// Updates the tree, reads the scene pose and effector targets and decides whether the chains need solving. Negative tolerance always solves. Returns false if the tree is not valid.
+    bool BeginSolve(float cacheTolerance);
+    /// Solves the chains into the pose buffers. Only touches the internal state of this solver, so different solvers can be solved in parallel.
+    void SolvePose();
+    /// Applies the solved pose to the scene graph.
+    void EndSolve();
+    /// Collects the nodes of the tree into the pose buffers.
+    void CollectPoseNodes();
+    /// Returns whether the scene pose or the effector targets moved further than the tolerance since the last solve.
+    bool HasPoseInputChanged(float tolerance) const;
+    /// Remembers the scene pose and the effector targets of current solve.
+    void StorePoseInput();
+    /// Forgets the cached solution, e.g. when solver or effector parameters change.
+    void InvalidatePoseCache();
 
     /// Indicates that the internal structures of the IK library need to be updated. See the documentation of ik_solver_rebuild_chain_trees() for more info on when this happens.
     void MarkChainsNeedUpdating();
@@ -318,7 +348,7 @@ private:
     /// Returns false if calling Solve() would cause the IK library to abort. Urho3D's error handling philosophy is to log an error and continue, not crash.
     bool IsSolverTreeValid() const;
 
-    /// Subscribe to drawable update finished event here.
+    /// Registers with the IK world of the scene here.
     void OnSceneSet(Scene* scene) override;
     /// Destroys and creates the tree.
     void OnNodeSet(Node* node) override;
@@ -345,8 +375,6 @@ private:
     void HandleComponentRemoved(StringHash eventType, VariantMap& eventData);
     void HandleNodeAdded(StringHash eventType, VariantMap& eventData);
     void HandleNodeRemoved(StringHash eventType, VariantMap& eventData);
-    /// Invokes the IK solver.
-    void HandleSceneDrawableUpdateFinished(StringHash eventType, VariantMap& eventData);
 
     // Need these wrapper functions flags of GetFeature/SetFeature can be correctly exposed to the editor and to AngelScript and lua
 public:
@@ -375,6 +403,43 @@ private:
     bool chainTreesNeedUpdating_;
     bool treeNeedsRebuild;
     bool solverTreeValid_;
+
+    /// Scene world that batches the solvers of the scene.
+    WeakPtr<IKWorld> world_;
+    /// Scene nodes of the tree, parents before children.
+    ea::vector<Node*> poseNodes_;
+    /// Nodes of the internal tree matching the scene nodes.
+    ea::vector<ik_node_t*> poseIKNodes_;
+    /// World positions of the scene nodes read for current solve.
+    ea::vector<Vector3> scenePositions_;
+    /// World rotations of the scene nodes read for current solve.
+    ea::vector<Quaternion> sceneRotations_;
+    /// Scene node positions of the last solve, relative to the solver node.
+    ea::vector<Vector3> cachedPositions_;
+    /// Scene node rotations of the last solve, relative to the solver node.
+    ea::vector<Quaternion> cachedRotations_;
+    /// Effector target positions of the last solve, relative to the solver node.
+    ea::vector<Vector3> cachedTargetPositions_;
+    /// Effector target rotations of the last solve, relative to the solver node.
+    ea::vector<Quaternion> cachedTargetRotations_;
+    /// Solved node positions relative to the solver node.
+    ea::vector<Vector3> solvedPositions_;
+    /// Solved node rotations relative to the solver node.
+    ea::vector<Quaternion> solvedRotations_;
+    /// World transform of the solver node for current solve.
+    Matrix3x4 rootTransform_;
+    /// Inverse world transform of the solver node for current solve.
+    Matrix3x4 rootInverseTransform_;
+    /// World rotation of the solver node for current solve.
+    Quaternion rootRotation_;
+    /// Distance the pose inputs may move before solving again.
+    float poseCacheTolerance_{0.001f};
+    /// Whether the pose buffers need to be collected again.
+    bool poseNodesDirty_{true};
+    /// Whether the solved pose buffers hold a valid solution.
+    bool poseCacheValid_{};
+    /// Whether current solve needs to run the solver.
+    bool solveRequired_{};
 };
 
 } // namespace Urho3D
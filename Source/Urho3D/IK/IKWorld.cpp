@@ -0,0 +1,190 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../IK/IKWorld.h"
+#include "../IK/IKSolver.h"
+
+#include "../Core/Context.h"
+#include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
+#include "../Graphics/Camera.h"
+#include "../Graphics/Renderer.h"
+#include "../Graphics/Viewport.h"
+#include "../Scene/Scene.h"
+#include "../Scene/SceneEvents.h"
+
+namespace Urho3D
+{
+
+extern const char* IK_CATEGORY;
+
+/// Minimum number of solvers per work item.
+static const unsigned SOLVERS_PER_WORK_ITEM = 4;
+
+// ----------------------------------------------------------------------------
+IKWorld::IKWorld(Context* context) :
+    Component(context)
+{
+}
+
+// ----------------------------------------------------------------------------
+IKWorld::~IKWorld() = default;
+
+// ----------------------------------------------------------------------------
+void IKWorld::RegisterObject(Context* context)
+{
+    context->RegisterFactory<IKWorld>(IK_CATEGORY);
+
+    URHO3D_ACCESSOR_ATTRIBUTE("LOD Distance", GetLodDistance, SetLodDistance, float, 0.0f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("LOD Interval", GetLodInterval, SetLodInterval, unsigned, 4, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Threaded", IsThreaded, SetThreaded, bool, true, AM_DEFAULT);
+}
+
+// ----------------------------------------------------------------------------
+void IKWorld::SetLodDistance(float distance)
+{
+    lodDistance_ = Max(distance, 0.0f);
+}
+
+// ----------------------------------------------------------------------------
+void IKWorld::SetLodInterval(unsigned interval)
+{
+    lodInterval_ = Max(interval, 1u);
+}
+
+// ----------------------------------------------------------------------------
+void IKWorld::AddSolver(IKSolver* solver)
+{
+    if (!solvers_.contains(solver))
+        solvers_.push_back(solver);
+}
+
+// ----------------------------------------------------------------------------
+void IKWorld::RemoveSolver(IKSolver* solver)
+{
+    solvers_.erase_first_unsorted(solver);
+}
+
+// ----------------------------------------------------------------------------
+void IKWorld::SolveAll()
+{
+    URHO3D_PROFILE("IKSolveAll");
+
+    if (lodDistance_ > 0.0f)
+        UpdateCameraPositions();
+    ++frameCounter_;
+
+    // Gather scene poses and targets on the main thread, as reading world transforms is not thread safe
+    activeSolvers_.clear();
+    for (unsigned i = 0; i < solvers_.size(); ++i)
+    {
+        IKSolver* solver = solvers_[i];
+        if (!solver->GetFeature(IKSolver::AUTO_SOLVE))
+            continue;
+
+        // Spread the solves of distant solvers over the interval
+        float cacheTolerance = solver->GetPoseCacheTolerance();
+        if (lodDistance_ > 0.0f && (frameCounter_ + i) % lodInterval_ != 0 && IsBeyondLodDistance(solver))
+            cacheTolerance = M_INFINITY;
+
+        if (solver->BeginSolve(cacheTolerance))
+            activeSolvers_.push_back(solver);
+    }
+
+    // Solve the chains. Each solver only touches its own internal state
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    if (threaded_ && workQueue && workQueue->GetNumThreads() > 0 && activeSolvers_.size() > SOLVERS_PER_WORK_ITEM)
+    {
+        workQueue->ParallelFor(activeSolvers_.size(), SOLVERS_PER_WORK_ITEM,
+            [this](unsigned begin, unsigned end, unsigned threadIndex)
+        {
+            for (unsigned i = begin; i < end; ++i)
+                activeSolvers_[i]->SolvePose();
+        });
+        workQueue->Complete(M_MAX_UNSIGNED);
+    }
+    else
+    {
+        for (IKSolver* solver : activeSolvers_)
+            solver->SolvePose();
+    }
+
+    // Apply the solutions on the main thread
+    for (IKSolver* solver : activeSolvers_)
+        solver->EndSolve();
+}
+
+// ----------------------------------------------------------------------------
+void IKWorld::OnSceneSet(Scene* scene)
+{
+    if (scene)
+        SubscribeToEvent(scene, E_SCENEDRAWABLEUPDATEFINISHED, URHO3D_HANDLER(IKWorld, HandleSceneDrawableUpdateFinished));
+    else
+        UnsubscribeFromEvent(E_SCENEDRAWABLEUPDATEFINISHED);
+}
+
+// ----------------------------------------------------------------------------
+void IKWorld::UpdateCameraPositions()
+{
+    cameraPositions_.clear();
+
+    auto* renderer = GetSubsystem<Renderer>();
+    if (!renderer)
+        return;
+
+    Scene* scene = GetScene();
+    for (unsigned i = 0; i < renderer->GetNumViewports(); ++i)
+    {
+        Viewport* viewport = renderer->GetViewport(i);
+        if (!viewport || viewport->GetScene() != scene)
+            continue;
+
+        Camera* camera = viewport->GetCamera();
+        if (camera && camera->GetNode())
+            cameraPositions_.push_back(camera->GetNode()->GetWorldPosition());
+    }
+}
+
+// ----------------------------------------------------------------------------
+bool IKWorld::IsBeyondLodDistance(const IKSolver* solver) const
+{
+    // Without cameras there is nothing to measure the distance from
+    if (cameraPositions_.empty())
+        return false;
+
+    const Vector3 position = solver->GetNode()->GetWorldPosition();
+    const float lodDistanceSquared = lodDistance_ * lodDistance_;
+    for (const Vector3& cameraPosition : cameraPositions_)
+    {
+        if ((position - cameraPosition).LengthSquared() <= lodDistanceSquared)
+            return false;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+void IKWorld::HandleSceneDrawableUpdateFinished(StringHash eventType, VariantMap& eventData)
+{
+    SolveAll();
+}
+
+} // namespace Urho3D
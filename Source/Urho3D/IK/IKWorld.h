@@ -0,0 +1,106 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Scene/Component.h"
+
+namespace Urho3D
+{
+
+class IKSolver;
+
+/*!
+ * @brief Solves all IK solvers of the scene together once the drawables have
+ * been updated. Created automatically by IKSolver.
+ *
+ * Scene poses and targets are gathered on the main thread, the chains of
+ * different solvers are solved in parallel on the work queue threads and the
+ * results are applied back to the scene graph on the main thread. Solvers
+ * whose targets and pose have not moved reuse their previous solution, and
+ * solvers far from the cameras are solved less often.
+ */
+class URHO3D_API IKWorld : public Component
+{
+    URHO3D_OBJECT(IKWorld, Component)
+
+public:
+    /// Construct.
+    explicit IKWorld(Context* context);
+    /// Destruct.
+    ~IKWorld() override;
+    /// Registers this class to the context.
+    static void RegisterObject(Context* context);
+
+    /*!
+     * @brief Sets the distance from the nearest camera beyond which solvers
+     * are solved only every LOD interval frames. In between, the previous
+     * solution is reapplied relative to the solver node.
+     * @param distance Distance in world units. Zero disables the LOD.
+     */
+    void SetLodDistance(float distance);
+    /// Returns the LOD distance.
+    float GetLodDistance() const { return lodDistance_; }
+    /// Sets how many frames pass between solves of solvers beyond the LOD distance. Default 4.
+    void SetLodInterval(unsigned interval);
+    /// Returns the LOD interval.
+    unsigned GetLodInterval() const { return lodInterval_; }
+    /// Sets whether solvers are solved on the work queue threads. Enabled by default.
+    void SetThreaded(bool enable) { threaded_ = enable; }
+    /// Returns whether solvers are solved on the work queue threads.
+    bool IsThreaded() const { return threaded_; }
+
+    /// Solves all auto solving solvers. Called automatically when the drawables of the scene have been updated.
+    void SolveAll();
+
+    /// Adds a solver. Called by IKSolver.
+    void AddSolver(IKSolver* solver);
+    /// Removes a solver. Called by IKSolver.
+    void RemoveSolver(IKSolver* solver);
+
+private:
+    /// Subscribes to drawable update finished event here.
+    void OnSceneSet(Scene* scene) override;
+    /// Collects world positions of the cameras viewing the scene.
+    void UpdateCameraPositions();
+    /// Returns whether the solver is beyond the LOD distance from all cameras.
+    bool IsBeyondLodDistance(const IKSolver* solver) const;
+    /// Solves the solvers.
+    void HandleSceneDrawableUpdateFinished(StringHash eventType, VariantMap& eventData);
+
+    /// Solvers of the scene.
+    ea::vector<IKSolver*> solvers_;
+    /// Solvers being solved on current frame.
+    ea::vector<IKSolver*> activeSolvers_;
+    /// World positions of the cameras viewing the scene.
+    ea::vector<Vector3> cameraPositions_;
+    /// LOD distance.
+    float lodDistance_{};
+    /// LOD interval in frames.
+    unsigned lodInterval_{4};
+    /// Frame counter for the LOD interval.
+    unsigned frameCounter_{};
+    /// Whether to solve on the work queue threads.
+    bool threaded_{true};
+};
+
+} // namespace Urho3D
@@ -56,6 +56,15 @@ unsigned DecompressData(void* dest, const void* src, unsigned destSize)
         return (unsigned)LZ4_decompress_fast((const char*)src, (char*)dest, destSize);
 }
 
+unsigned DecompressData(void* dest, const void* src, unsigned srcSize, unsigned destSize)
+{
+    if (!dest || !src || !srcSize || !destSize)
+        return 0;
+
+    const int result = LZ4_decompress_safe((const char*)src, (char*)dest, srcSize, destSize);
+    return result > 0 ? (unsigned)result : 0;
+}
+
 bool CompressStream(Serializer& dest, Deserializer& src)
 {
     unsigned srcSize = src.GetSize() - src.GetPosition();
@@ -101,7 +110,8 @@ bool DecompressStream(Serializer& dest, Deserializer& src)
     if (src.Read(srcBuffer.get(), srcSize) != srcSize)
         return false;
 
-    LZ4_decompress_fast((const char*)srcBuffer.get(), (char*)destBuffer.get(), destSize);
+    if (LZ4_decompress_safe((const char*)srcBuffer.get(), (char*)destBuffer.get(), srcSize, destSize) != (int)destSize)
+        return false;
     return dest.Write(destBuffer.get(), destSize) == destSize;
 }
 
@@ -33,6 +33,13 @@
 #include <SDL/SDL_rwops.h>
 #endif
 
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define URHO3D_FILE_PREFETCH
+#endif
+
 #include <cstdio>
 #include <LZ4/lz4.h>
 
@@ -63,6 +70,7 @@ static const char* openMode[] =
 static const unsigned READ_BUFFER_SIZE = 32768;
 #endif
 static const unsigned SKIP_BUFFER_SIZE = 1024;
+static const unsigned BLOCK_HEADER_SIZE = 4;
 
 File::File(Context* context) :
     Object(context),
@@ -136,6 +144,26 @@ bool File::Open(PackageFile* package, const ea::string& fileName)
     if (!entry)
         return false;
 
+    // Read uncompressed files directly from the mapped package without opening a file handle
+    if (const unsigned char* packageData = package->GetMappedData())
+    {
+        Close();
+
+        fileName_ = fileName;
+        absoluteFileName_ = package->GetName();
+        mode_ = FILE_READ;
+        mappedPackage_ = package;
+        mappedData_ = packageData + entry->offset_;
+        offset_ = entry->offset_;
+        checksum_ = entry->checksum_;
+        size_ = entry->size_;
+        position_ = 0;
+        compressed_ = false;
+        readSyncNeeded_ = false;
+        writeSyncNeeded_ = false;
+        return true;
+    }
+
     bool success = OpenInternal(package->GetName(), FILE_READ, true);
     if (!success)
     {
@@ -148,6 +176,10 @@ bool File::Open(PackageFile* package, const ea::string& fileName)
     checksum_ = entry->checksum_;
     size_ = entry->size_;
     compressed_ = package->IsCompressed();
+    blockOffsets_.clear();
+    blockSize_ = 0;
+    nextBlockOffset_ = offset_;
+    nextBlockIndex_ = 0;
 
     // Seek to beginning of package entry's file data
     SeekInternal(offset_);
@@ -173,6 +205,13 @@ unsigned File::Read(void* dest, unsigned size)
     if (!size)
         return 0;
 
+    if (mappedData_)
+    {
+        memcpy(dest, mappedData_ + position_, size);
+        position_ += size;
+        return size;
+    }
+
 #ifdef __ANDROID__
     if (assetHandle_ && !compressed_)
     {
@@ -217,17 +256,14 @@ unsigned File::Read(void* dest, unsigned size)
         {
             if (!readBuffer_ || readBufferOffset_ >= readBufferSize_)
             {
-                unsigned char blockHeaderBytes[4];
-                ReadInternal(blockHeaderBytes, sizeof blockHeaderBytes);
-
-                MemoryBuffer blockHeader(&blockHeaderBytes[0], sizeof blockHeaderBytes);
-                unsigned unpackedSize = blockHeader.ReadUShort();
-                unsigned packedSize = blockHeader.ReadUShort();
+                unsigned unpackedSize = 0;
+                unsigned packedSize = 0;
+                ReadBlockHeader(unpackedSize, packedSize);
 
                 if (!readBuffer_)
                 {
-                    readBuffer_ = new unsigned char[unpackedSize];
-                    inputBuffer_ = new unsigned char[LZ4_compressBound(unpackedSize)];
+                    readBuffer_ = new unsigned char[blockSize_];
+                    inputBuffer_ = new unsigned char[LZ4_compressBound(blockSize_)];
                 }
 
                 /// \todo Handle errors
@@ -236,6 +272,8 @@ unsigned File::Read(void* dest, unsigned size)
 
                 readBufferSize_ = unpackedSize;
                 readBufferOffset_ = 0;
+                nextBlockOffset_ += BLOCK_HEADER_SIZE + packedSize;
+                ++nextBlockIndex_;
             }
 
             unsigned copySize = Min((readBufferSize_ - readBufferOffset_), sizeLeft);
@@ -281,25 +319,53 @@ unsigned File::Seek(unsigned position)
     if (mode_ == FILE_READ && position > size_)
         position = size_;
 
+    if (mappedData_)
+    {
+        position_ = position;
+        return position_;
+    }
+
     if (compressed_)
     {
-        // Start over from the beginning
-        if (position == 0)
+        // Stay within the current block if possible
+        const unsigned bufferStart = position_ - readBufferOffset_;
+        if (readBufferSize_ && position >= bufferStart && position < bufferStart + readBufferSize_)
         {
-            position_ = 0;
-            readBufferOffset_ = 0;
-            readBufferSize_ = 0;
-            SeekInternal(offset_);
+            readBufferOffset_ = position - bufferStart;
+            position_ = position;
+            return position_;
         }
-        // Skip bytes
-        else if (position >= position_)
+
+        // Restart from the closest known block before the position
+        const unsigned knownBlock = blockSize_ && !blockOffsets_.empty()
+            ? Min(position / blockSize_, blockOffsets_.size() - 1) : 0;
+        position_ = knownBlock * blockSize_;
+        readBufferOffset_ = 0;
+        readBufferSize_ = 0;
+        nextBlockIndex_ = knownBlock;
+        nextBlockOffset_ = blockOffsets_.empty() ? offset_ : blockOffsets_[knownBlock];
+        SeekInternal(nextBlockOffset_);
+
+        // Skip whole blocks without decompressing them
+        while (position_ < size_)
         {
-            unsigned char skipBuffer[SKIP_BUFFER_SIZE];
-            while (position > position_)
-                Read(skipBuffer, Min(position - position_, SKIP_BUFFER_SIZE));
+            unsigned unpackedSize = 0;
+            unsigned packedSize = 0;
+            ReadBlockHeader(unpackedSize, packedSize);
+            if (position_ + unpackedSize > position)
+                break;
+
+            position_ += unpackedSize;
+            nextBlockOffset_ += BLOCK_HEADER_SIZE + packedSize;
+            ++nextBlockIndex_;
+            SeekInternal(nextBlockOffset_);
         }
-        else
-            URHO3D_LOGERROR("Seeking backward in a compressed file is not supported");
+        SeekInternal(nextBlockOffset_);
+
+        // Decompress the block containing the position and skip the remaining bytes
+        unsigned char skipBuffer[SKIP_BUFFER_SIZE];
+        while (position > position_)
+            Read(skipBuffer, Min(position - position_, SKIP_BUFFER_SIZE));
 
         return position_;
     }
@@ -393,6 +459,16 @@ void File::Close()
     readBuffer_.reset();
     inputBuffer_.reset();
 
+    if (mappedData_)
+    {
+        mappedData_ = nullptr;
+        mappedPackage_ = nullptr;
+        position_ = 0;
+        size_ = 0;
+        offset_ = 0;
+        checksum_ = 0;
+    }
+
     if (handle_)
     {
         fclose((FILE*)handle_);
@@ -410,6 +486,25 @@ void File::Flush()
         fflush((FILE*)handle_);
 }
 
+void File::Prefetch()
+{
+#ifdef URHO3D_FILE_PREFETCH
+    if (mode_ != FILE_READ || !size_)
+        return;
+
+    if (mappedData_)
+    {
+        // Range must start at page boundary
+        const auto pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+        const auto begin = reinterpret_cast<uintptr_t>(mappedData_) & ~(pageSize - 1);
+        const auto end = reinterpret_cast<uintptr_t>(mappedData_) + size_;
+        madvise(reinterpret_cast<void*>(begin), end - begin, MADV_WILLNEED);
+    }
+    else if (handle_)
+        posix_fadvise(fileno((FILE*)handle_), offset_, size_, POSIX_FADV_WILLNEED);
+#endif
+}
+
 void File::SetName(const ea::string& name)
 {
     fileName_ = name;
@@ -420,7 +515,7 @@ bool File::IsOpen() const
 #ifdef __ANDROID__
     return handle_ != 0 || assetHandle_ != 0;
 #else
-    return handle_ != nullptr;
+    return handle_ != nullptr || mappedData_ != nullptr;
 #endif
 }
 
@@ -524,6 +619,22 @@ bool File::OpenInternal(const ea::string& fileName, FileMode mode, bool fromPack
     return true;
 }
 
+void File::ReadBlockHeader(unsigned& unpackedSize, unsigned& packedSize)
+{
+    unsigned char blockHeaderBytes[BLOCK_HEADER_SIZE];
+    ReadInternal(blockHeaderBytes, sizeof blockHeaderBytes);
+
+    MemoryBuffer blockHeader(&blockHeaderBytes[0], sizeof blockHeaderBytes);
+    unpackedSize = blockHeader.ReadUShort();
+    packedSize = blockHeader.ReadUShort();
+
+    // All blocks except the last one have the same size as the first one
+    if (nextBlockIndex_ == blockOffsets_.size())
+        blockOffsets_.push_back(nextBlockOffset_);
+    if (!blockSize_)
+        blockSize_ = unpackedSize;
+}
+
 bool File::ReadInternal(void* dest, unsigned size)
 {
 #ifdef __ANDROID__
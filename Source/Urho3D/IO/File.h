@@ -99,6 +99,8 @@ public:
     void Close();
     /// Flush any buffered output to the file.
     void Flush();
+    /// Hint the operating system to start reading the file contents in background. No-op on platforms without read-ahead hints.
+    void Prefetch();
     /// Change the file name. Used by the resource system.
     void SetName(const ea::string& name);
 
@@ -114,6 +116,9 @@ public:
     /// Return whether the file originates from a package.
     bool IsPackaged() const { return offset_ != 0; }
 
+    /// Return file contents if the file is read from a memory-mapped package, null otherwise.
+    const unsigned char* GetMappedData() const { return mappedData_; }
+
     /// Reads a binary file to buffer.
     void ReadBinary(ea::vector<unsigned char>& buffer);
 
@@ -137,6 +142,8 @@ private:
     bool ReadInternal(void* dest, unsigned size);
     /// Seek in file internally using either C standard IO functions or SDL RWops for Android asset files.
     void SeekInternal(unsigned newPosition);
+    /// Read header of the next compressed block and remember the block offset.
+    void ReadBlockHeader(unsigned& unpackedSize, unsigned& packedSize);
 
     /// File name. For files from ResourceCache, relative to cache directory.
     ea::string fileName_;
@@ -158,6 +165,18 @@ private:
     unsigned readBufferOffset_;
     /// Bytes in the current read buffer.
     unsigned readBufferSize_;
+    /// Package the file is memory-mapped from.
+    SharedPtr<PackageFile> mappedPackage_;
+    /// File contents within the memory-mapped package.
+    const unsigned char* mappedData_{};
+    /// Offsets of the compressed blocks discovered so far.
+    ea::vector<unsigned> blockOffsets_;
+    /// Uncompressed size of all compressed blocks except the last one.
+    unsigned blockSize_{};
+    /// Offset of the next compressed block to read.
+    unsigned nextBlockOffset_{};
+    /// Index of the next compressed block to read.
+    unsigned nextBlockIndex_{};
     /// Start position within a package file, 0 for regular files.
     unsigned offset_;
     /// Content checksum.
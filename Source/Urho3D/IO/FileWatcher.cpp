@@ -32,6 +32,8 @@
 #elif __linux__
 #include <sys/inotify.h>
 #include <sys/ioctl.h>
+#include <poll.h>
+#include <cerrno>
 extern "C"
 {
 // Need read/close for inotify
@@ -280,12 +282,12 @@ void FileWatcher::ThreadFunction()
                 else if (record->Action == FILE_ACTION_RENAMED_OLD_NAME)
                     rename.oldFileName_ = fileName;
                 else if (record->Action == FILE_ACTION_RENAMED_NEW_NAME)
-                    rename.oldFileName_ = fileName;
+                    rename.fileName_ = fileName;
 
                 if (!rename.oldFileName_.empty() && !rename.fileName_.empty())
                 {
                     AddChange(rename);
-                    rename = {};
+                    rename = {FILECHANGE_RENAMED, EMPTY_STRING, EMPTY_STRING};
                 }
 
                 if (!record->NextEntryOffset)
@@ -300,14 +302,18 @@ void FileWatcher::ThreadFunction()
 
     while (shouldRun_)
     {
+        // Block until inotify has events instead of polling, but wake up periodically to check for stop requests
+        pollfd descriptor{watchHandle_, POLLIN, 0};
+        const int ready = poll(&descriptor, 1, 100);
+        if (ready < 0 && errno != EINTR)
+            return;
+        if (ready <= 0 || !(descriptor.revents & POLLIN))
+            continue;
+
         unsigned available = 0;
         ioctl(watchHandle_, FIONREAD, &available);
-
         if (available == 0)
-        {
-            Time::Sleep(100);
             continue;
-        }
 
         int i = 0;
         auto length = (int)read(watchHandle_, buffer, Min(available, sizeof(buffer)));
@@ -395,10 +401,27 @@ void FileWatcher::AddChange(const FileChange& change)
 
     auto it = changes_.find(change.fileName_);
     if (it == changes_.end())
+    {
         changes_[change.fileName_].change_ = change;
-    else
-        // Reset the timer associated with the filename. Will be notified once timer exceeds the delay
-        it->second.timer_.Reset();
+        return;
+    }
+
+    // Coalesce with the pending change so that a burst of events (e.g. a version control sync) is reported once
+    FileChange& pending = it->second.change_;
+    if (pending.kind_ == FILECHANGE_ADDED && change.kind_ == FILECHANGE_REMOVED)
+    {
+        // File was created and deleted before anyone noticed, drop it altogether
+        changes_.erase(it);
+        return;
+    }
+    else if (pending.kind_ == FILECHANGE_REMOVED && change.kind_ == FILECHANGE_ADDED)
+        pending.kind_ = FILECHANGE_MODIFIED;
+    else if (change.kind_ == FILECHANGE_REMOVED || change.kind_ == FILECHANGE_RENAMED)
+        pending = change;
+    // Otherwise the pending change kind already describes the change (e.g. added and then modified is still added)
+
+    // Reset the timer associated with the filename. Will be notified once timer exceeds the delay
+    it->second.timer_.Reset();
 }
 
 bool FileWatcher::GetNextChange(FileChange& dest)
@@ -425,4 +448,26 @@ bool FileWatcher::GetNextChange(FileChange& dest)
     }
 }
 
+unsigned FileWatcher::GetNextChanges(ea::vector<FileChange>& dest)
+{
+    MutexLock lock(changesMutex_);
+
+    auto delayMsec = (unsigned)(delay_ * 1000.0f);
+
+    unsigned numChanges = 0;
+    for (auto i = changes_.begin(); i != changes_.end();)
+    {
+        if (i->second.timer_.GetMSec(false) >= delayMsec)
+        {
+            dest.push_back(ea::move(i->second.change_));
+            i = changes_.erase(i);
+            ++numChanges;
+        }
+        else
+            ++i;
+    }
+
+    return numChanges;
+}
+
 }
@@ -76,10 +76,12 @@ public:
     void StopWatching();
     /// Set the delay in seconds before file changes are notified. This (hopefully) avoids notifying when a file save is still in progress. Default 1 second.
     void SetDelay(float interval);
-    /// Add a file change into the changes queue.
+    /// Add a file change into the changes queue. Repeated changes of the same file are coalesced into one.
     void AddChange(const FileChange& change);
     /// Return a file change (true if was found, false if not).
     bool GetNextChange(FileChange& dest);
+    /// Append all file changes whose delay has elapsed to the destination vector. Return number of changes appended.
+    unsigned GetNextChanges(ea::vector<FileChange>& dest);
 
     /// Return the path being watched, or empty if not watching.
     const ea::string& GetPath() const { return path_; }
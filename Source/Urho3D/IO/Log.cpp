@@ -39,7 +39,10 @@
 #include <spdlog/sinks/base_sink.h>
 #include <spdlog/details/null_mutex.h>
 
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
+#include <thread>
 #include <cstdio>
 
 #ifdef __ANDROID__
@@ -139,6 +142,259 @@ protected:
 using MessageForwarderSink_mt = MessageForwarderSink<std::mutex>;
 using MessageForwarderSink_st = MessageForwarderSink<spdlog::details::null_mutex>;
 
+/// Sink that passes messages to the target sink either directly or through a lock-free queue drained by the log thread.
+class AsyncLogSink : public spdlog::sinks::sink, public Thread
+{
+public:
+    explicit AsyncLogSink(std::shared_ptr<spdlog::sinks::sink> target)
+        : Thread("Log")
+        , target_(std::move(target))
+    {
+    }
+
+    ~AsyncLogSink() override { SetAsync(false, 0, LOG_OVERFLOW_BLOCK); }
+
+    /// Enable or disable the queue. Queue size is rounded up to power of two.
+    void SetAsync(bool enable, unsigned queueSize, LogOverflowPolicy policy)
+    {
+        if (async_.load(std::memory_order_relaxed))
+        {
+            // New messages now bypass the queue. Wait for the threads still pushing, the log thread keeps draining for them,
+            // so that the slots are not reallocated under them
+            async_.store(false);
+            while (numPushing_.load())
+            {
+                WakeUp();
+                std::this_thread::yield();
+            }
+
+            Stop();
+            // Write the messages pushed while the log thread was stopping
+            DrainQueue();
+        }
+
+        if (!enable)
+            return;
+
+        const unsigned numSlots = NextPowerOfTwo(Max(queueSize, 2u));
+        slots_ = ea::make_unique<Slot[]>(numSlots);
+        for (unsigned i = 0; i < numSlots; ++i)
+            slots_[i].sequence_.store(i, std::memory_order_relaxed);
+        mask_ = numSlots - 1;
+        enqueuePos_.store(0, std::memory_order_relaxed);
+        dequeuePos_ = 0;
+        policy_ = policy;
+
+        async_.store(true, std::memory_order_release);
+        Run();
+    }
+
+    /// Return whether the queue is enabled.
+    bool IsAsync() const { return async_.load(std::memory_order_relaxed); }
+
+    /// Return total number of discarded messages.
+    unsigned GetNumDroppedMessages() const { return totalDropped_.load(std::memory_order_relaxed); }
+
+    void log(const spdlog::details::log_msg& msg) override
+    {
+        // Announce the push before checking the flag, SetAsync waits for announced pushes before touching the queue
+        numPushing_.fetch_add(1);
+        if (!async_.load())
+        {
+            numPushing_.fetch_sub(1);
+            target_->log(msg);
+            return;
+        }
+
+        while (!TryPush(msg))
+        {
+            if (policy_ == LOG_OVERFLOW_DISCARD)
+            {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                totalDropped_.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+            WakeUp();
+            std::this_thread::yield();
+        }
+
+        if (sleeping_.load(std::memory_order_acquire))
+            WakeUp();
+        numPushing_.fetch_sub(1, std::memory_order_release);
+    }
+
+    void flush() override
+    {
+        if (async_.load(std::memory_order_acquire))
+        {
+            // Wait until the log thread catches up with the messages queued so far
+            const unsigned pos = enqueuePos_.load(std::memory_order_acquire);
+            while (static_cast<int>(writtenPos_.load(std::memory_order_acquire) - pos) < 0 && async_.load(std::memory_order_acquire))
+            {
+                WakeUp();
+                std::this_thread::yield();
+            }
+        }
+        target_->flush();
+    }
+
+    void set_pattern(const eastl::string& pattern) override { target_->set_pattern(pattern); }
+
+    void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override { target_->set_formatter(std::move(sink_formatter)); }
+
+    /// Write queued messages until the queue is disabled.
+    void ThreadFunction() override
+    {
+        while (shouldRun_)
+        {
+            if (DrainQueue())
+                continue;
+
+            std::unique_lock<std::mutex> lock(wakeUpMutex_);
+            sleeping_.store(true, std::memory_order_release);
+            // Message may have been pushed right before going to sleep, so don't wait long
+            wakeUp_.wait_for(lock, std::chrono::milliseconds(10));
+            sleeping_.store(false, std::memory_order_release);
+        }
+    }
+
+private:
+    /// Queue slot. Payload buffer is reused between messages.
+    struct Slot
+    {
+        std::atomic<unsigned> sequence_{};
+        spdlog::string_view_t loggerName_;
+        spdlog::level::level_enum level_{};
+        spdlog::log_clock::time_point time_;
+        size_t threadId_{};
+        ea::string payload_;
+    };
+
+    /// Copy message into the queue. Return false if the queue is full.
+    bool TryPush(const spdlog::details::log_msg& msg)
+    {
+        unsigned pos = enqueuePos_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Slot& slot = slots_[pos & mask_];
+            const unsigned sequence = slot.sequence_.load(std::memory_order_acquire);
+            const int diff = static_cast<int>(sequence - pos);
+            if (diff == 0)
+            {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    // Logger names stay valid as loggers are never unregistered
+                    slot.loggerName_ = msg.logger_name;
+                    slot.level_ = msg.level;
+                    slot.time_ = msg.time;
+                    slot.threadId_ = msg.thread_id;
+                    slot.payload_.assign(msg.payload.data(), msg.payload.size());
+                    slot.sequence_.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+                return false;
+            else
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    /// Write all queued messages to the target sink. Return false if the queue was empty.
+    bool DrainQueue()
+    {
+        if (!slots_)
+            return false;
+
+        bool written = false;
+        for (;;)
+        {
+            Slot& slot = slots_[dequeuePos_ & mask_];
+            if (static_cast<int>(slot.sequence_.load(std::memory_order_acquire) - (dequeuePos_ + 1)) < 0)
+                break;
+
+            spdlog::details::log_msg msg(slot.loggerName_, slot.level_,
+                spdlog::string_view_t(slot.payload_.data(), slot.payload_.size()));
+            msg.time = slot.time_;
+            msg.thread_id = slot.threadId_;
+            target_->log(msg);
+
+            slot.sequence_.store(dequeuePos_ + mask_ + 1, std::memory_order_release);
+            ++dequeuePos_;
+            writtenPos_.store(dequeuePos_, std::memory_order_release);
+            written = true;
+        }
+
+        if (const unsigned dropped = dropped_.exchange(0, std::memory_order_relaxed))
+        {
+            const ea::string message = Format("{} log messages were dropped because the log queue was full", dropped);
+            spdlog::details::log_msg msg("Log", spdlog::level::warn, spdlog::string_view_t(message.data(), message.size()));
+            target_->log(msg);
+        }
+
+        return written;
+    }
+
+    /// Wake up the log thread.
+    void WakeUp()
+    {
+        std::lock_guard<std::mutex> lock(wakeUpMutex_);
+        wakeUp_.notify_one();
+    }
+
+    /// Sink that receives the messages.
+    std::shared_ptr<spdlog::sinks::sink> target_;
+    /// Queue slots.
+    ea::unique_ptr<Slot[]> slots_;
+    /// Mask of the slot index.
+    unsigned mask_{};
+    /// Next position to push to.
+    std::atomic<unsigned> enqueuePos_{};
+    /// Next position to pop from. Accessed by the log thread only.
+    unsigned dequeuePos_{};
+    /// Position up to which messages are written.
+    std::atomic<unsigned> writtenPos_{};
+    /// Whether the queue is enabled.
+    std::atomic<bool> async_{};
+    /// Number of threads that may be pushing to the queue.
+    std::atomic<unsigned> numPushing_{};
+    /// Whether the log thread is waiting for messages.
+    std::atomic<bool> sleeping_{};
+    /// Messages dropped since the last report.
+    std::atomic<unsigned> dropped_{};
+    /// Messages dropped in total.
+    std::atomic<unsigned> totalDropped_{};
+    /// Overflow policy.
+    LogOverflowPolicy policy_{LOG_OVERFLOW_BLOCK};
+    /// Mutex for waking up the log thread.
+    std::mutex wakeUpMutex_;
+    /// Condition for waking up the log thread.
+    std::condition_variable wakeUp_;
+};
+
+/// Append structured field to the message in logfmt style, quoting the value if necessary.
+static void AppendLogField(ea::string& message, const LogField& field)
+{
+    const ea::string value = field.value_.ToString();
+    message += ' ';
+    message += field.key_;
+    message += '=';
+    if (!value.empty() && value.find_first_of(" \t\"=") == ea::string::npos)
+    {
+        message += value;
+        return;
+    }
+
+    message += '"';
+    for (char c : value)
+    {
+        if (c == '"' || c == '\\')
+            message += '\\';
+        message += c;
+    }
+    message += '"';
+}
+
 Logger::Logger(void* logger)
     : logger_(logger)
 {
@@ -175,6 +431,21 @@ void Logger::Write(LogLevel level, const ea::string& message) const
     }
 }
 
+void Logger::Write(LogLevel level, const ea::string& message, std::initializer_list<LogField> fields) const
+{
+    if (logger_ == nullptr || level < LOG_TRACE || level >= LOG_NONE)
+        return;
+
+    auto* logger = reinterpret_cast<spdlog::logger*>(logger_);
+    if (!logger->should_log(ConvertLogLevel(level)))
+        return;
+
+    ea::string text = message;
+    for (const LogField& field : fields)
+        AppendLogField(text, field);
+    Write(level, text);
+}
+
 class LogImpl : public Object
 {
     URHO3D_OBJECT(LogImpl, Object);
@@ -195,6 +466,7 @@ public:
 #endif
         sinkProxy_->add_sink(platformSink_);
         sinkProxy_->add_sink(std::make_shared<MessageForwarderSink_mt>());
+        asyncSink_ = std::make_shared<AsyncLogSink>(sinkProxy_);
     }
 
 #ifdef __ANDROID__
@@ -215,6 +487,8 @@ public:
 #endif
     /// Sink that forwards messages to all other sinks.
     std::shared_ptr<spdlog::sinks::dist_sink_mt> sinkProxy_;
+    /// Sink that loggers write to. Forwards messages to the sink proxy, optionally through the log thread.
+    std::shared_ptr<AsyncLogSink> asyncSink_;
 };
 
 Log::Log(Context* context) :
@@ -229,6 +503,7 @@ Log::Log(Context* context) :
 
 Log::~Log()
 {
+    impl_->asyncSink_->SetAsync(false, 0, LOG_OVERFLOW_BLOCK);
     logInstance = nullptr;
 }
 
@@ -278,6 +553,26 @@ void Log::SetQuiet(bool quiet)
     impl_->platformSink_->set_level(ConvertLogLevel(quiet ? LOG_NONE : level_));
 }
 
+void Log::SetAsync(bool enable, unsigned queueSize, LogOverflowPolicy policy)
+{
+    impl_->asyncSink_->SetAsync(enable, queueSize, policy);
+}
+
+void Log::Flush()
+{
+    impl_->asyncSink_->flush();
+}
+
+bool Log::IsAsync() const
+{
+    return impl_->asyncSink_->IsAsync();
+}
+
+unsigned Log::GetNumDroppedMessages() const
+{
+    return impl_->asyncSink_->GetNumDroppedMessages();
+}
+
 void Log::SetLogFormat(const ea::string& format)
 {
     formatPattern_ = format;
@@ -305,7 +600,7 @@ Logger Log::GetLogger(const ea::string& name)
 
     if (!logger)
     {
-        logger = std::make_shared<spdlog::logger>(name, logInstance->impl_->sinkProxy_);
+        logger = std::make_shared<spdlog::logger>(name, logInstance->impl_->asyncSink_);
         spdlog::register_logger(logger);
     }
 
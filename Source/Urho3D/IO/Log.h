@@ -24,6 +24,8 @@
 
 #include <EASTL/list.h>
 
+#include <initializer_list>
+
 #include "../Core/Macros.h"
 #include "../Core/Mutex.h"
 #include "../Core/Object.h"
@@ -76,6 +78,30 @@ static const char* logLevelNames[] =
     nullptr
 };
 
+/// Behavior of asynchronous logging when the message queue is full.
+enum LogOverflowPolicy
+{
+    /// Wait until the log thread frees space in the queue.
+    LOG_OVERFLOW_BLOCK = 0,
+    /// Discard the message. The number of discarded messages is logged once there is space again.
+    LOG_OVERFLOW_DISCARD,
+};
+
+/// Default number of messages in the asynchronous log queue.
+static const unsigned DEFAULT_ASYNC_LOG_QUEUE_SIZE = 8192;
+
+/// Structured key/value field of a log message. Fields are appended to the message in logfmt style, e.g. `key=value`.
+struct LogField
+{
+    /// Construct from key and value of any type convertible to Variant.
+    LogField(const char* key, const Variant& value) : key_(key), value_(value) { }
+
+    /// Field key.
+    const char* key_{};
+    /// Field value.
+    Variant value_;
+};
+
 class File;
 
 /// Stored log message from another thread.
@@ -131,7 +157,15 @@ public:
     template<typename... Args> void Warning(const ea::string& message) const { Write(LOG_WARNING, message.c_str()); }
     template<typename... Args> void Error(const ea::string& message) const   { Write(LOG_ERROR, message.c_str()); }
 
+    void Trace(const ea::string& message, std::initializer_list<LogField> fields) const   { Write(LOG_TRACE, message, fields); }
+    void Debug(const ea::string& message, std::initializer_list<LogField> fields) const   { Write(LOG_DEBUG, message, fields); }
+    void Info(const ea::string& message, std::initializer_list<LogField> fields) const    { Write(LOG_INFO, message, fields); }
+    void Warning(const ea::string& message, std::initializer_list<LogField> fields) const { Write(LOG_WARNING, message, fields); }
+    void Error(const ea::string& message, std::initializer_list<LogField> fields) const   { Write(LOG_ERROR, message, fields); }
+
     void Write(LogLevel level, const ea::string& message) const;
+    /// Write message with structured fields. Fields are formatted only if the level is enabled.
+    void Write(LogLevel level, const ea::string& message, std::initializer_list<LogField> fields) const;
 
 protected:
     /// Instance of spdlog logger.
@@ -161,12 +195,20 @@ public:
     void SetLogFormat(const ea::string& format);
     /// Set quiet mode ie. only print error entries to standard error stream (which is normally redirected to console also). Output to log file is not affected by this mode.
     void SetQuiet(bool quiet);
+    /// Enable or disable asynchronous logging. Messages are put into a lock-free queue and written to the sinks by a log thread, so logging threads never wait for file or console output. Should be called from the main thread.
+    void SetAsync(bool enable, unsigned queueSize = DEFAULT_ASYNC_LOG_QUEUE_SIZE, LogOverflowPolicy policy = LOG_OVERFLOW_BLOCK);
+    /// Wait until all queued messages are written and flush the sinks.
+    void Flush();
 
     /// Return logging level.
     LogLevel GetLevel() const { return level_; }
 
     /// Return whether log is in quiet mode (only errors printed to standard error stream).
     bool IsQuiet() const { return quiet_; }
+    /// Return whether asynchronous logging is enabled.
+    bool IsAsync() const;
+    /// Return total number of messages discarded because the asynchronous log queue was full.
+    unsigned GetNumDroppedMessages() const;
 
     /// Returns a logger with specified name.
     static Logger GetLogger(const ea::string& name);
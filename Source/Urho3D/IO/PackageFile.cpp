@@ -27,6 +27,15 @@
 #include "../IO/PackageFile.h"
 #include "../IO/FileSystem.h"
 
+#ifdef _WIN32
+#include <windows.h>
+#elif !defined(__ANDROID__) && !defined(__EMSCRIPTEN__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define URHO3D_PACKAGE_MMAP
+#endif
+
 namespace Urho3D
 {
 
@@ -49,10 +58,15 @@ PackageFile::PackageFile(Context* context, const ea::string& fileName, unsigned
     Open(fileName, startOffset);
 }
 
-PackageFile::~PackageFile() = default;
+PackageFile::~PackageFile()
+{
+    UnmapFile();
+}
 
 bool PackageFile::Open(const ea::string& fileName, unsigned startOffset)
 {
+    UnmapFile();
+
     SharedPtr<File> file(new File(context_, fileName));
     if (!file->IsOpen())
         return false;
@@ -119,7 +133,79 @@ bool PackageFile::Open(const ea::string& fileName, unsigned startOffset)
             entries_[entryName] = newEntry;
     }
 
+    // Uncompressed entries are read directly from memory, falling back to file reads if mapping fails
+    if (!compressed_)
+    {
+        file->Close();
+        MapFile();
+    }
+
+    return true;
+}
+
+bool PackageFile::MapFile()
+{
+    if (!totalSize_)
+        return false;
+
+#ifdef _WIN32
+    HANDLE fileHandle = CreateFileW(GetWideNativePath(fileName_).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+        return false;
+
+    HANDLE mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mappingHandle)
+    {
+        CloseHandle(fileHandle);
+        return false;
+    }
+
+    void* data = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (!data)
+    {
+        CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+        return false;
+    }
+
+    mappedFileHandle_ = fileHandle;
+    mappingHandle_ = mappingHandle;
+    mappedData_ = static_cast<unsigned char*>(data);
     return true;
+#elif defined(URHO3D_PACKAGE_MMAP)
+    const int fd = open(GetNativePath(fileName_).c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    // The mapping stays valid after the descriptor is closed
+    void* data = mmap(nullptr, totalSize_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return false;
+
+    mappedData_ = static_cast<unsigned char*>(data);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void PackageFile::UnmapFile()
+{
+    if (!mappedData_)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(mappedData_);
+    CloseHandle(mappingHandle_);
+    CloseHandle(mappedFileHandle_);
+    mappingHandle_ = nullptr;
+    mappedFileHandle_ = nullptr;
+#elif defined(URHO3D_PACKAGE_MMAP)
+    munmap(mappedData_, totalSize_);
+#endif
+    mappedData_ = nullptr;
 }
 
 bool PackageFile::Exists(const ea::string& fileName) const
@@ -82,6 +82,9 @@ public:
     /// Return whether the files are compressed.
     bool IsCompressed() const { return compressed_; }
 
+    /// Return package file contents if the package is memory-mapped, null otherwise. Only uncompressed packages are mapped.
+    const unsigned char* GetMappedData() const { return mappedData_; }
+
     /// Return list of file names in the package.
     const ea::vector<ea::string> GetEntryNames() const { return entries_.keys(); }
 
@@ -101,6 +104,11 @@ public:
     void Scan(ea::vector<ea::string>& result, const ea::string& pathName, const ea::string& filter, bool recursive) const;
 
 private:
+    /// Map uncompressed package file contents into memory. Return true if successful.
+    bool MapFile();
+    /// Unmap package file contents.
+    void UnmapFile();
+
     /// File entries.
     ea::unordered_map<ea::string, PackageEntry> entries_;
     /// File name.
@@ -115,6 +123,14 @@ private:
     unsigned checksum_;
     /// Compressed flag.
     bool compressed_;
+    /// Memory-mapped package file contents.
+    unsigned char* mappedData_{};
+#ifdef _WIN32
+    /// File handle of the mapped package.
+    void* mappedFileHandle_{};
+    /// File mapping object handle.
+    void* mappingHandle_{};
+#endif
 };
 
 }
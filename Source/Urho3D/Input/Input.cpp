@@ -433,6 +433,9 @@ void Input::Update()
         mouseMoved = true;
 
     ResetInputAccumulation();
+    // Input latched after the previous frame update now starts the accumulation of this frame
+    SwapLatchedInput();
+    frameTimestamp_ = SDL_GetTicks();
 
     SDL_Event evt;
     while (SDL_PollEvent(&evt))
@@ -571,6 +574,37 @@ void Input::Update()
 #endif
 }
 
+void Input::LatchInput()
+{
+    if (!initialized_)
+        return;
+
+#ifndef __EMSCRIPTEN__
+    URHO3D_PROFILE("LatchInput");
+
+    // Accumulate separately, the next frame update would otherwise reset the latched presses and movement unseen
+    SwapLatchedInput();
+
+    SDL_Event evt;
+    while (SDL_PollEvent(&evt))
+        HandleSDLEvent(&evt);
+
+    SwapLatchedInput();
+#endif
+}
+
+void Input::SetLateLatching(bool enable)
+{
+    if (lateLatching_ == enable)
+        return;
+
+    lateLatching_ = enable;
+    if (lateLatching_)
+        SubscribeToEvent(E_RENDERUPDATE, URHO3D_HANDLER(Input, HandleRenderUpdate));
+    else
+        UnsubscribeFromEvent(E_RENDERUPDATE);
+}
+
 void Input::SetMouseVisible(bool enable, bool suppressEvent)
 {
     const bool startMouseVisible = mouseVisible_;
@@ -1596,6 +1630,7 @@ void Input::ResetInputAccumulation()
     mouseButtonClick_ = MOUSEB_NONE;
     mouseMove_ = IntVector2::ZERO;
     mouseMoveWheel_ = 0;
+    inputHistory_.clear();
     for (auto i = joysticks_.begin(); i != joysticks_.end(); ++i)
     {
         for (unsigned j = 0; j < i->second.buttonPress_.size(); ++j)
@@ -1611,6 +1646,38 @@ void Input::ResetInputAccumulation()
     }
 }
 
+void Input::SwapLatchedInput()
+{
+    ea::swap(keyPress_, latchedInput_.keyPress_);
+    ea::swap(scancodePress_, latchedInput_.scancodePress_);
+    ea::swap(mouseButtonPress_, latchedInput_.mouseButtonPress_);
+    ea::swap(mouseButtonClick_, latchedInput_.mouseButtonClick_);
+    ea::swap(mouseMove_, latchedInput_.mouseMove_);
+    ea::swap(mouseMoveScaled_, latchedInput_.mouseMoveScaled_);
+    ea::swap(mouseMoveWheel_, latchedInput_.mouseMoveWheel_);
+    ea::swap(inputHistory_, latchedInput_.inputHistory_);
+
+    ea::vector<ea::pair<SDL_JoystickID, unsigned>> joystickButtonPress;
+    for (auto i = joysticks_.begin(); i != joysticks_.end(); ++i)
+    {
+        for (unsigned j = 0; j < i->second.buttonPress_.size(); ++j)
+        {
+            if (i->second.buttonPress_[j])
+            {
+                joystickButtonPress.emplace_back(i->first, j);
+                i->second.buttonPress_[j] = false;
+            }
+        }
+    }
+    for (const auto& press : latchedInput_.joystickButtonPress_)
+    {
+        auto i = joysticks_.find(press.first);
+        if (i != joysticks_.end() && press.second < i->second.buttonPress_.size())
+            i->second.buttonPress_[press.second] = true;
+    }
+    latchedInput_.joystickButtonPress_ = ea::move(joystickButtonPress);
+}
+
 void Input::GainFocus()
 {
     ResetState();
@@ -1677,6 +1744,7 @@ void Input::ResetState()
     mouseMoveWheel_ = 0;
     mouseButtonPress_ = MOUSEB_NONE;
     mouseButtonClick_ = MOUSEB_NONE;
+    latchedInput_ = LatchedInput{};
 }
 
 void Input::ResetTouches()
@@ -1931,11 +1999,13 @@ void Input::HandleSDLEvent(void* sdlEvent)
     switch (evt.type)
     {
     case SDL_KEYDOWN:
-        SetKey(ConvertSDLKeyCode(evt.key.keysym.sym, evt.key.keysym.scancode), (Scancode)evt.key.keysym.scancode, true);
-        break;
-
     case SDL_KEYUP:
-        SetKey(ConvertSDLKeyCode(evt.key.keysym.sym, evt.key.keysym.scancode), (Scancode)evt.key.keysym.scancode, false);
+        {
+            const bool down = evt.type == SDL_KEYDOWN;
+            const Key key = ConvertSDLKeyCode(evt.key.keysym.sym, evt.key.keysym.scancode);
+            inputHistory_.push_back(InputSample{ IST_KEY, evt.key.timestamp, static_cast<int>(key), 0, down });
+            SetKey(key, (Scancode)evt.key.keysym.scancode, down);
+        }
         break;
 
     case SDL_TEXTINPUT:
@@ -1964,6 +2034,7 @@ void Input::HandleSDLEvent(void* sdlEvent)
         if (!touchEmulation_)
         {
             const auto mouseButton = static_cast<MouseButton>(1u << (evt.button.button - 1u));  // NOLINT(misc-misplaced-widening-cast)
+            inputHistory_.push_back(InputSample{ IST_MOUSEBUTTON, evt.button.timestamp, static_cast<int>(mouseButton), 0, true });
             SetMouseButton(mouseButton, true, evt.button.clicks);
         }
         else
@@ -1990,6 +2061,7 @@ void Input::HandleSDLEvent(void* sdlEvent)
         if (!touchEmulation_)
         {
             const auto mouseButton = static_cast<MouseButton>(1u << (evt.button.button - 1u));  // NOLINT(misc-misplaced-widening-cast)
+            inputHistory_.push_back(InputSample{ IST_MOUSEBUTTON, evt.button.timestamp, static_cast<int>(mouseButton), 0, false });
             SetMouseButton(mouseButton, false, evt.button.clicks);
         }
         else
@@ -2032,6 +2104,9 @@ void Input::HandleSDLEvent(void* sdlEvent)
             mouseMove_.y_ += evt.motion.yrel;
             mouseMoveScaled_ = false;
 
+            const Vector2 delta{ evt.motion.xrel * inputScale_.x_, evt.motion.yrel * inputScale_.y_ };
+            inputHistory_.push_back(InputSample{ IST_MOUSEMOVE, evt.motion.timestamp, 0, 0, false, delta });
+
             if (!suppressNextMouseMove_)
             {
                 using namespace MouseMove;
@@ -2070,7 +2145,11 @@ void Input::HandleSDLEvent(void* sdlEvent)
 
     case SDL_MOUSEWHEEL:
         if (!touchEmulation_)
+        {
+            const Vector2 delta{ static_cast<float>(evt.wheel.y), 0.0f };
+            inputHistory_.push_back(InputSample{ IST_MOUSEWHEEL, evt.wheel.timestamp, 0, 0, false, delta });
             SetMouseWheel(evt.wheel.y);
+        }
         break;
 
     case SDL_FINGERDOWN:
@@ -2284,6 +2363,8 @@ void Input::HandleSDLEvent(void* sdlEvent)
                     // (we'll also get the controller event)
                     if (!state.controller_)
                         state.axes_[evt.jaxis.axis] = eventData[P_POSITION].GetFloat();
+                    const Vector2 position{ eventData[P_POSITION].GetFloat(), 0.0f };
+                    inputHistory_.push_back(InputSample{ IST_JOYSTICKAXIS, evt.jaxis.timestamp, evt.jaxis.axis, joystickID, false, position });
                     SendEvent(E_JOYSTICKAXISMOVE, eventData);
                 }
             }
@@ -2366,6 +2447,8 @@ void Input::HandleSDLEvent(void* sdlEvent)
             if (evt.caxis.axis < state.axes_.size())
             {
                 state.axes_[evt.caxis.axis] = eventData[P_POSITION].GetFloat();
+                const Vector2 position{ eventData[P_POSITION].GetFloat(), 0.0f };
+                inputHistory_.push_back(InputSample{ IST_JOYSTICKAXIS, evt.caxis.timestamp, evt.caxis.axis, joystickID, false, position });
                 SendEvent(E_JOYSTICKAXISMOVE, eventData);
             }
         }
@@ -2461,6 +2544,11 @@ void Input::HandleScreenMode(StringHash eventType, VariantMap& eventData)
         inputScale_ = Vector2::ONE;
 }
 
+void Input::HandleRenderUpdate(StringHash eventType, VariantMap& eventData)
+{
+    LatchInput();
+}
+
 void Input::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
 {
     // Update input right at the beginning of the frame
@@ -54,6 +54,33 @@ class XMLFile;
 
 const IntVector2 MOUSE_POSITION_OFFSCREEN = IntVector2(M_MIN_INT, M_MIN_INT);
 
+/// Type of timestamped input sample.
+enum InputSampleType
+{
+    IST_KEY = 0,
+    IST_MOUSEBUTTON,
+    IST_MOUSEMOVE,
+    IST_MOUSEWHEEL,
+    IST_JOYSTICKAXIS
+};
+
+/// Timestamped input sample, for consuming input at finer resolution than frames.
+struct InputSample
+{
+    /// Sample type.
+    InputSampleType type_{};
+    /// Time when the operating system event was received in milliseconds, in the time base of SDL_GetTicks().
+    unsigned timestamp_{};
+    /// Key, mouse button or joystick axis index.
+    int code_{};
+    /// Joystick ID of joystick axis sample.
+    SDL_JoystickID joystickID_{};
+    /// Whether the key or mouse button is down.
+    bool down_{};
+    /// Mouse movement in backbuffer coordinates, wheel movement in X or joystick axis position in X.
+    Vector2 value_;
+};
+
 /// %Input state for a finger touch.
 struct URHO3D_API TouchState
 {
@@ -147,6 +174,10 @@ public:
 
     /// Poll for window messages. Called by HandleBeginFrame().
     void Update();
+    /// Poll for window messages arrived since the frame update. Key, button and position state is updated right away, while presses, movement and history samples are carried into the next frame. Movement of the hidden cursor outside of relative mouse mode is still measured on frame update only.
+    void LatchInput();
+    /// Set whether input is latched again right before network client controls are assigned and before the render update.
+    void SetLateLatching(bool enable);
     /// Set whether ALT-ENTER fullscreen toggle is enabled.
     void SetToggleFullscreen(bool enable);
     /// Set whether the operating system mouse cursor is visible. When not visible (default), is kept centered to prevent leaving the window. Mouse visibility event can be suppressed-- this also recalls any unsuppressed SetMouseVisible which can be returned by ResetMouseVisible().
@@ -257,6 +288,12 @@ public:
     int GetMouseMoveY() const;
     /// Return mouse wheel movement since last frame.
     int GetMouseMoveWheel() const { return mouseMoveWheel_; }
+    /// Return timestamped key, mouse and joystick axis samples since last frame in the order of arrival, starting with the ones latched after the previous frame update.
+    const ea::vector<InputSample>& GetInputHistory() const { return inputHistory_; }
+    /// Return time of the frame update in milliseconds, in the time base of SDL_GetTicks().
+    unsigned GetFrameTimestamp() const { return frameTimestamp_; }
+    /// Return whether input is latched again before network controls and the render update.
+    bool GetLateLatching() const { return lateLatching_; }
     /// Return input coordinate scaling. Should return non-unity on High DPI display.
     Vector2 GetInputScale() const { return inputScale_; }
 
@@ -325,6 +362,8 @@ private:
     void ResetTouches();
     /// Reset input accumulation.
     void ResetInputAccumulation();
+    /// Exchange the input accumulation of this frame with the latched input accumulation.
+    void SwapLatchedInput();
     /// Get the index of a touch based on the touch ID.
     unsigned GetTouchIndexFromID(int touchID);
     /// Used internally to return and remove the next available touch index.
@@ -351,6 +390,8 @@ private:
     void HandleScreenJoystickTouch(StringHash eventType, VariantMap& eventData);
     /// Handle SDL event.
     void HandleSDLEvent(void* sdlEvent);
+    /// Handle render update event when late latching is enabled.
+    void HandleRenderUpdate(StringHash eventType, VariantMap& eventData);
 
 #ifndef __EMSCRIPTEN__
     /// Set SDL mouse mode relative.
@@ -368,6 +409,29 @@ private:
     void HandleEndFrame(StringHash eventType, VariantMap& eventData);
 #endif
 
+    /// Input accumulated by LatchInput() for the next frame.
+    struct LatchedInput
+    {
+        /// Key pressed state.
+        ea::hash_set<int> keyPress_;
+        /// Key pressed state by scancode.
+        ea::hash_set<int> scancodePress_;
+        /// Mouse buttons' pressed state.
+        MouseButtonFlags mouseButtonPress_;
+        /// Mouse buttons' clicked state.
+        MouseButtonFlags mouseButtonClick_;
+        /// Mouse movement.
+        IntVector2 mouseMove_;
+        /// Whether mouse movement is in backbuffer scale.
+        bool mouseMoveScaled_{};
+        /// Mouse wheel movement.
+        int mouseMoveWheel_{};
+        /// Pressed joystick buttons as joystick ID and button index.
+        ea::vector<ea::pair<SDL_JoystickID, unsigned>> joystickButtonPress_;
+        /// Timestamped input samples.
+        ea::vector<InputSample> inputHistory_;
+    };
+
     /// Graphics subsystem.
     WeakPtr<Graphics> graphics_;
     /// Key down state.
@@ -406,6 +470,14 @@ private:
     IntVector2 mouseMove_;
     /// Mouse wheel movement since last frame.
     int mouseMoveWheel_;
+    /// Timestamped input samples since last frame.
+    ea::vector<InputSample> inputHistory_;
+    /// Time of the frame update.
+    unsigned frameTimestamp_{};
+    /// Late latching flag.
+    bool lateLatching_{};
+    /// Input latched since the frame update.
+    LatchedInput latchedInput_;
     /// Input coordinate scaling. Non-unity when window and backbuffer have different sizes (e.g. Retina display).
     Vector2 inputScale_;
     /// SDL window ID.
@@ -0,0 +1,788 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Math/MathBatch.h"
+
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define URHO3D_MATH_BATCH_AVX
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define URHO3D_TARGET_AVX
+#else
+#define URHO3D_TARGET_AVX __attribute__((target("avx")))
+#endif
+#endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define URHO3D_MATH_BATCH_NEON
+#include <arm_neon.h>
+#endif
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Return whether the CPU and OS support AVX.
+bool IsAVXSupported()
+{
+#if !defined(URHO3D_MATH_BATCH_AVX)
+    return false;
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    return osxsave && avx && (_xgetbv(0) & 0x6) == 0x6;
+#else
+    return __builtin_cpu_supports("avx");
+#endif
+}
+
+/// Return best backend for this build and CPU.
+MathBatchBackend DetectBackend()
+{
+#if defined(URHO3D_MATH_BATCH_NEON)
+    return MathBatchBackend::NEON;
+#elif defined(URHO3D_SSE)
+    return IsAVXSupported() ? MathBatchBackend::AVX : MathBatchBackend::SSE2;
+#else
+    return MathBatchBackend::Scalar;
+#endif
+}
+
+/// Return storage of current backend.
+MathBatchBackend& GetBackendStorage()
+{
+    static MathBatchBackend backend = DetectBackend();
+    return backend;
+}
+
+void TransformStreamScalar(const Matrix3x4& m, const float* sx, const float* sy, const float* sz,
+    float* dx, float* dy, float* dz, unsigned begin, unsigned end)
+{
+    for (unsigned i = begin; i < end; ++i)
+    {
+        const float x = sx[i];
+        const float y = sy[i];
+        const float z = sz[i];
+        dx[i] = m.m00_ * x + m.m01_ * y + m.m02_ * z + m.m03_;
+        dy[i] = m.m10_ * x + m.m11_ * y + m.m12_ * z + m.m13_;
+        dz[i] = m.m20_ * x + m.m21_ * y + m.m22_ * z + m.m23_;
+    }
+}
+
+void TransformVectorsScalar(const Matrix3x4& m, const Vector3* src, Vector3* dest, unsigned begin, unsigned end, float w)
+{
+    for (unsigned i = begin; i < end; ++i)
+    {
+        const Vector3 v = src[i];
+        dest[i] = Vector3(
+            m.m00_ * v.x_ + m.m01_ * v.y_ + m.m02_ * v.z_ + m.m03_ * w,
+            m.m10_ * v.x_ + m.m11_ * v.y_ + m.m12_ * v.z_ + m.m13_ * w,
+            m.m20_ * v.x_ + m.m21_ * v.y_ + m.m22_ * v.z_ + m.m23_ * w
+        );
+    }
+}
+
+BoundingBox TransformBoundingBoxScalar(const Matrix3x4& m, const BoundingBox& box)
+{
+    const Vector3 center = (box.min_ + box.max_) * 0.5f;
+    const Vector3 edge = box.max_ - center;
+    const Vector3 newCenter(
+        m.m00_ * center.x_ + m.m01_ * center.y_ + m.m02_ * center.z_ + m.m03_,
+        m.m10_ * center.x_ + m.m11_ * center.y_ + m.m12_ * center.z_ + m.m13_,
+        m.m20_ * center.x_ + m.m21_ * center.y_ + m.m22_ * center.z_ + m.m23_
+    );
+    const Vector3 newEdge(
+        Abs(m.m00_) * edge.x_ + Abs(m.m01_) * edge.y_ + Abs(m.m02_) * edge.z_,
+        Abs(m.m10_) * edge.x_ + Abs(m.m11_) * edge.y_ + Abs(m.m12_) * edge.z_,
+        Abs(m.m20_) * edge.x_ + Abs(m.m21_) * edge.y_ + Abs(m.m22_) * edge.z_
+    );
+    return BoundingBox(newCenter - newEdge, newCenter + newEdge);
+}
+
+void ComposeTransformScalar(const Vector3& t, const Quaternion& q, const Vector3& s, Matrix3x4& dest)
+{
+    const Matrix3 r = q.RotationMatrix();
+    dest.m00_ = r.m00_ * s.x_;
+    dest.m01_ = r.m01_ * s.y_;
+    dest.m02_ = r.m02_ * s.z_;
+    dest.m03_ = t.x_;
+    dest.m10_ = r.m10_ * s.x_;
+    dest.m11_ = r.m11_ * s.y_;
+    dest.m12_ = r.m12_ * s.z_;
+    dest.m13_ = t.y_;
+    dest.m20_ = r.m20_ * s.x_;
+    dest.m21_ = r.m21_ * s.y_;
+    dest.m22_ = r.m22_ * s.z_;
+    dest.m23_ = t.z_;
+}
+
+#ifdef URHO3D_SSE
+/// Return whether the backend uses SSE2 kernels.
+bool UseSSE(MathBatchBackend backend)
+{
+    return backend == MathBatchBackend::SSE2 || backend == MathBatchBackend::AVX;
+}
+
+/// Matrix elements broadcast to SSE registers.
+struct MatrixSSE
+{
+    explicit MatrixSSE(const Matrix3x4& m)
+    {
+        const float* data = m.Data();
+        for (unsigned i = 0; i < 12; ++i)
+            m_[i] = _mm_set1_ps(data[i]);
+    }
+
+    __m128 m_[12];
+};
+
+/// Load 4 interleaved Vector3 and return them as X, Y and Z registers.
+inline void LoadVector3x4(const Vector3* src, __m128& x, __m128& y, __m128& z)
+{
+    const float* data = &src->x_;
+    const __m128 a = _mm_loadu_ps(data);
+    const __m128 b = _mm_loadu_ps(data + 4);
+    const __m128 c = _mm_loadu_ps(data + 8);
+    const __m128 xy = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2));
+    const __m128 yz = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1));
+    x = _mm_shuffle_ps(a, xy, _MM_SHUFFLE(2, 0, 3, 0));
+    y = _mm_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+    z = _mm_shuffle_ps(yz, c, _MM_SHUFFLE(3, 0, 3, 1));
+}
+
+/// Store X, Y and Z registers as 4 interleaved Vector3.
+inline void StoreVector3x4(Vector3* dest, __m128 x, __m128 y, __m128 z)
+{
+    float* data = &dest->x_;
+    const __m128 xyLow = _mm_unpacklo_ps(x, y);
+    const __m128 xyHigh = _mm_unpackhi_ps(x, y);
+    const __m128 t0 = _mm_shuffle_ps(z, xyLow, _MM_SHUFFLE(3, 2, 1, 0));
+    const __m128 t1 = _mm_shuffle_ps(z, xyHigh, _MM_SHUFFLE(3, 2, 3, 2));
+    _mm_storeu_ps(data, _mm_shuffle_ps(xyLow, t0, _MM_SHUFFLE(2, 0, 1, 0)));
+    _mm_storeu_ps(data + 4, _mm_shuffle_ps(t0, xyHigh, _MM_SHUFFLE(1, 0, 1, 3)));
+    _mm_storeu_ps(data + 8, _mm_shuffle_ps(t1, t1, _MM_SHUFFLE(1, 3, 2, 0)));
+}
+
+/// Return X * m0 + Y * m1 + Z * m2 + m3.
+inline __m128 DotRowSSE(const __m128* row, __m128 x, __m128 y, __m128 z)
+{
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(row[0], x), _mm_mul_ps(row[1], y)), _mm_add_ps(_mm_mul_ps(row[2], z), row[3]));
+}
+
+/// Return X * m0 + Y * m1 + Z * m2.
+inline __m128 DotRowNoTranslationSSE(const __m128* row, __m128 x, __m128 y, __m128 z)
+{
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(row[0], x), _mm_mul_ps(row[1], y)), _mm_mul_ps(row[2], z));
+}
+
+void TransformStreamSSE(const Matrix3x4& transform, const float* sx, const float* sy, const float* sz,
+    float* dx, float* dy, float* dz, unsigned count)
+{
+    const MatrixSSE m(transform);
+    // Streams are padded, so the last partial register may be processed whole
+    for (unsigned i = 0; i < count; i += 4)
+    {
+        const __m128 x = _mm_loadu_ps(sx + i);
+        const __m128 y = _mm_loadu_ps(sy + i);
+        const __m128 z = _mm_loadu_ps(sz + i);
+        _mm_storeu_ps(dx + i, DotRowSSE(&m.m_[0], x, y, z));
+        _mm_storeu_ps(dy + i, DotRowSSE(&m.m_[4], x, y, z));
+        _mm_storeu_ps(dz + i, DotRowSSE(&m.m_[8], x, y, z));
+    }
+}
+
+void TransformVectorsSSE(const Matrix3x4& transform, const Vector3* src, Vector3* dest, unsigned count, bool translate)
+{
+    const MatrixSSE m(transform);
+    const unsigned simdCount = count & ~3u;
+    for (unsigned i = 0; i < simdCount; i += 4)
+    {
+        __m128 x, y, z;
+        LoadVector3x4(src + i, x, y, z);
+        if (translate)
+            StoreVector3x4(dest + i, DotRowSSE(&m.m_[0], x, y, z), DotRowSSE(&m.m_[4], x, y, z), DotRowSSE(&m.m_[8], x, y, z));
+        else
+        {
+            StoreVector3x4(dest + i, DotRowNoTranslationSSE(&m.m_[0], x, y, z), DotRowNoTranslationSSE(&m.m_[4], x, y, z),
+                DotRowNoTranslationSSE(&m.m_[8], x, y, z));
+        }
+    }
+    TransformVectorsScalar(transform, src, dest, simdCount, count, translate ? 1.0f : 0.0f);
+}
+
+void TransformBoundingBoxesSSE(const Matrix3x4& transform, const BoundingBox* src, BoundingBox* dest, unsigned count)
+{
+    const MatrixSSE m(transform);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    const __m128 half = _mm_set1_ps(0.5f);
+    __m128 absM[12];
+    for (unsigned i = 0; i < 12; ++i)
+        absM[i] = _mm_and_ps(m.m_[i], absMask);
+
+    const unsigned simdCount = count & ~3u;
+    for (unsigned i = 0; i < simdCount; i += 4)
+    {
+        // Bounding box min and max are padded to four floats, so they can be transposed directly
+        __m128 minX = _mm_loadu_ps(&src[i].min_.x_);
+        __m128 minY = _mm_loadu_ps(&src[i + 1].min_.x_);
+        __m128 minZ = _mm_loadu_ps(&src[i + 2].min_.x_);
+        __m128 minW = _mm_loadu_ps(&src[i + 3].min_.x_);
+        __m128 maxX = _mm_loadu_ps(&src[i].max_.x_);
+        __m128 maxY = _mm_loadu_ps(&src[i + 1].max_.x_);
+        __m128 maxZ = _mm_loadu_ps(&src[i + 2].max_.x_);
+        __m128 maxW = _mm_loadu_ps(&src[i + 3].max_.x_);
+        _MM_TRANSPOSE4_PS(minX, minY, minZ, minW);
+        _MM_TRANSPOSE4_PS(maxX, maxY, maxZ, maxW);
+
+        const __m128 cx = _mm_mul_ps(_mm_add_ps(minX, maxX), half);
+        const __m128 cy = _mm_mul_ps(_mm_add_ps(minY, maxY), half);
+        const __m128 cz = _mm_mul_ps(_mm_add_ps(minZ, maxZ), half);
+        const __m128 ex = _mm_sub_ps(maxX, cx);
+        const __m128 ey = _mm_sub_ps(maxY, cy);
+        const __m128 ez = _mm_sub_ps(maxZ, cz);
+
+        const __m128 newCX = DotRowSSE(&m.m_[0], cx, cy, cz);
+        const __m128 newCY = DotRowSSE(&m.m_[4], cx, cy, cz);
+        const __m128 newCZ = DotRowSSE(&m.m_[8], cx, cy, cz);
+        const __m128 newEX = DotRowNoTranslationSSE(&absM[0], ex, ey, ez);
+        const __m128 newEY = DotRowNoTranslationSSE(&absM[4], ex, ey, ez);
+        const __m128 newEZ = DotRowNoTranslationSSE(&absM[8], ex, ey, ez);
+
+        minX = _mm_sub_ps(newCX, newEX);
+        minY = _mm_sub_ps(newCY, newEY);
+        minZ = _mm_sub_ps(newCZ, newEZ);
+        minW = _mm_setzero_ps();
+        maxX = _mm_add_ps(newCX, newEX);
+        maxY = _mm_add_ps(newCY, newEY);
+        maxZ = _mm_add_ps(newCZ, newEZ);
+        maxW = _mm_setzero_ps();
+        _MM_TRANSPOSE4_PS(minX, minY, minZ, minW);
+        _MM_TRANSPOSE4_PS(maxX, maxY, maxZ, maxW);
+        _mm_storeu_ps(&dest[i].min_.x_, minX);
+        _mm_storeu_ps(&dest[i + 1].min_.x_, minY);
+        _mm_storeu_ps(&dest[i + 2].min_.x_, minZ);
+        _mm_storeu_ps(&dest[i + 3].min_.x_, minW);
+        _mm_storeu_ps(&dest[i].max_.x_, maxX);
+        _mm_storeu_ps(&dest[i + 1].max_.x_, maxY);
+        _mm_storeu_ps(&dest[i + 2].max_.x_, maxZ);
+        _mm_storeu_ps(&dest[i + 3].max_.x_, maxW);
+    }
+    for (unsigned i = simdCount; i < count; ++i)
+        dest[i] = src[i].Transformed(transform);
+}
+
+BoundingBox MergeTransformedBoundingBoxesSSE(const BoundingBox& box, const Matrix3x4* transforms, unsigned count)
+{
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    const Vector3 center = box.Center();
+    const Vector3 edge = box.HalfSize();
+    const __m128 cx = _mm_set1_ps(center.x_);
+    const __m128 cy = _mm_set1_ps(center.y_);
+    const __m128 cz = _mm_set1_ps(center.z_);
+    const __m128 ex = _mm_set1_ps(edge.x_);
+    const __m128 ey = _mm_set1_ps(edge.y_);
+    const __m128 ez = _mm_set1_ps(edge.z_);
+
+    __m128 minX = _mm_set1_ps(M_INFINITY);
+    __m128 minY = minX;
+    __m128 minZ = minX;
+    __m128 maxX = _mm_set1_ps(-M_INFINITY);
+    __m128 maxY = maxX;
+    __m128 maxZ = maxX;
+
+    const unsigned simdCount = count & ~3u;
+    for (unsigned i = 0; i < simdCount; i += 4)
+    {
+        // Transpose rows of 4 matrices so that each register holds one element of all matrices
+        __m128 m[12];
+        for (unsigned row = 0; row < 3; ++row)
+        {
+            m[row * 4] = _mm_loadu_ps(&transforms[i].m00_ + row * 4);
+            m[row * 4 + 1] = _mm_loadu_ps(&transforms[i + 1].m00_ + row * 4);
+            m[row * 4 + 2] = _mm_loadu_ps(&transforms[i + 2].m00_ + row * 4);
+            m[row * 4 + 3] = _mm_loadu_ps(&transforms[i + 3].m00_ + row * 4);
+            _MM_TRANSPOSE4_PS(m[row * 4], m[row * 4 + 1], m[row * 4 + 2], m[row * 4 + 3]);
+        }
+        __m128 absM[12];
+        for (unsigned j = 0; j < 12; ++j)
+            absM[j] = _mm_and_ps(m[j], absMask);
+
+        const __m128 newCX = DotRowSSE(&m[0], cx, cy, cz);
+        const __m128 newCY = DotRowSSE(&m[4], cx, cy, cz);
+        const __m128 newCZ = DotRowSSE(&m[8], cx, cy, cz);
+        const __m128 newEX = DotRowNoTranslationSSE(&absM[0], ex, ey, ez);
+        const __m128 newEY = DotRowNoTranslationSSE(&absM[4], ex, ey, ez);
+        const __m128 newEZ = DotRowNoTranslationSSE(&absM[8], ex, ey, ez);
+
+        minX = _mm_min_ps(minX, _mm_sub_ps(newCX, newEX));
+        minY = _mm_min_ps(minY, _mm_sub_ps(newCY, newEY));
+        minZ = _mm_min_ps(minZ, _mm_sub_ps(newCZ, newEZ));
+        maxX = _mm_max_ps(maxX, _mm_add_ps(newCX, newEX));
+        maxY = _mm_max_ps(maxY, _mm_add_ps(newCY, newEY));
+        maxZ = _mm_max_ps(maxZ, _mm_add_ps(newCZ, newEZ));
+    }
+
+    // Reduce lanes into min and max registers laid out as (x, y, z, 0)
+    __m128 minW = _mm_setzero_ps();
+    __m128 maxW = _mm_setzero_ps();
+    _MM_TRANSPOSE4_PS(minX, minY, minZ, minW);
+    _MM_TRANSPOSE4_PS(maxX, maxY, maxZ, maxW);
+    BoundingBox result(_mm_min_ps(_mm_min_ps(minX, minY), _mm_min_ps(minZ, minW)),
+        _mm_max_ps(_mm_max_ps(maxX, maxY), _mm_max_ps(maxZ, maxW)));
+
+    for (unsigned i = simdCount; i < count; ++i)
+        result.Merge(box.Transformed(transforms[i]));
+    return result;
+}
+
+/// Quaternion components of 4 quaternions.
+struct QuaternionsSSE
+{
+    /// Load 4 quaternions.
+    explicit QuaternionsSSE(const Quaternion* src)
+    {
+        w_ = _mm_loadu_ps(&src[0].w_);
+        x_ = _mm_loadu_ps(&src[1].w_);
+        y_ = _mm_loadu_ps(&src[2].w_);
+        z_ = _mm_loadu_ps(&src[3].w_);
+        _MM_TRANSPOSE4_PS(w_, x_, y_, z_);
+    }
+
+    /// Compute rotation matrix elements in row-major order.
+    void ToMatrix(__m128* m) const
+    {
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 x2 = _mm_add_ps(x_, x_);
+        const __m128 y2 = _mm_add_ps(y_, y_);
+        const __m128 z2 = _mm_add_ps(z_, z_);
+        const __m128 xx = _mm_mul_ps(x_, x2);
+        const __m128 yy = _mm_mul_ps(y_, y2);
+        const __m128 zz = _mm_mul_ps(z_, z2);
+        const __m128 xy = _mm_mul_ps(x_, y2);
+        const __m128 xz = _mm_mul_ps(x_, z2);
+        const __m128 yz = _mm_mul_ps(y_, z2);
+        const __m128 wx = _mm_mul_ps(w_, x2);
+        const __m128 wy = _mm_mul_ps(w_, y2);
+        const __m128 wz = _mm_mul_ps(w_, z2);
+        m[0] = _mm_sub_ps(one, _mm_add_ps(yy, zz));
+        m[1] = _mm_sub_ps(xy, wz);
+        m[2] = _mm_add_ps(xz, wy);
+        m[3] = _mm_add_ps(xy, wz);
+        m[4] = _mm_sub_ps(one, _mm_add_ps(xx, zz));
+        m[5] = _mm_sub_ps(yz, wx);
+        m[6] = _mm_sub_ps(xz, wy);
+        m[7] = _mm_add_ps(yz, wx);
+        m[8] = _mm_sub_ps(one, _mm_add_ps(xx, yy));
+    }
+
+    __m128 w_;
+    __m128 x_;
+    __m128 y_;
+    __m128 z_;
+};
+
+void QuaternionsToMatricesSSE(const Quaternion* src, Matrix3* dest, unsigned count)
+{
+    const unsigned simdCount = count & ~3u;
+    for (unsigned i = 0; i < simdCount; i += 4)
+    {
+        __m128 m[9];
+        QuaternionsSSE(src + i).ToMatrix(m);
+
+        // Matrix3 has no padding, so scatter through a small buffer
+        alignas(16) float elements[9][4];
+        for (unsigned j = 0; j < 9; ++j)
+            _mm_store_ps(elements[j], m[j]);
+        for (unsigned k = 0; k < 4; ++k)
+        {
+            float* data = &dest[i + k].m00_;
+            for (unsigned j = 0; j < 9; ++j)
+                data[j] = elements[j][k];
+        }
+    }
+    for (unsigned i = simdCount; i < count; ++i)
+        dest[i] = src[i].RotationMatrix();
+}
+
+void ComposeTransformsSSE(const Vector3* translations, const Quaternion* rotations, const Vector3* scales, Matrix3x4* dest, unsigned count)
+{
+    const unsigned simdCount = count & ~3u;
+    for (unsigned i = 0; i < simdCount; i += 4)
+    {
+        __m128 r[9];
+        QuaternionsSSE(rotations + i).ToMatrix(r);
+
+        __m128 tx, ty, tz;
+        LoadVector3x4(translations + i, tx, ty, tz);
+        if (scales)
+        {
+            __m128 sx, sy, sz;
+            LoadVector3x4(scales + i, sx, sy, sz);
+            for (unsigned row = 0; row < 3; ++row)
+            {
+                r[row * 3] = _mm_mul_ps(r[row * 3], sx);
+                r[row * 3 + 1] = _mm_mul_ps(r[row * 3 + 1], sy);
+                r[row * 3 + 2] = _mm_mul_ps(r[row * 3 + 2], sz);
+            }
+        }
+
+        // Transpose each row back so that it can be stored to 4 matrices
+        const __m128 t[3] = { tx, ty, tz };
+        for (unsigned row = 0; row < 3; ++row)
+        {
+            __m128 m0 = r[row * 3];
+            __m128 m1 = r[row * 3 + 1];
+            __m128 m2 = r[row * 3 + 2];
+            __m128 m3 = t[row];
+            _MM_TRANSPOSE4_PS(m0, m1, m2, m3);
+            _mm_storeu_ps(&dest[i].m00_ + row * 4, m0);
+            _mm_storeu_ps(&dest[i + 1].m00_ + row * 4, m1);
+            _mm_storeu_ps(&dest[i + 2].m00_ + row * 4, m2);
+            _mm_storeu_ps(&dest[i + 3].m00_ + row * 4, m3);
+        }
+    }
+    for (unsigned i = simdCount; i < count; ++i)
+        ComposeTransformScalar(translations[i], rotations[i], scales ? scales[i] : Vector3::ONE, dest[i]);
+}
+#endif
+
+#ifdef URHO3D_MATH_BATCH_AVX
+URHO3D_TARGET_AVX void TransformStreamAVX(const Matrix3x4& transform, const float* sx, const float* sy, const float* sz,
+    float* dx, float* dy, float* dz, unsigned count)
+{
+    const float* data = transform.Data();
+    __m256 m[12];
+    for (unsigned i = 0; i < 12; ++i)
+        m[i] = _mm256_set1_ps(data[i]);
+
+    // Streams are padded to 8 elements, so the last partial register may be processed whole
+    for (unsigned i = 0; i < count; i += 8)
+    {
+        const __m256 x = _mm256_loadu_ps(sx + i);
+        const __m256 y = _mm256_loadu_ps(sy + i);
+        const __m256 z = _mm256_loadu_ps(sz + i);
+        const __m256 rx = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m[0], x), _mm256_mul_ps(m[1], y)),
+            _mm256_add_ps(_mm256_mul_ps(m[2], z), m[3]));
+        const __m256 ry = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m[4], x), _mm256_mul_ps(m[5], y)),
+            _mm256_add_ps(_mm256_mul_ps(m[6], z), m[7]));
+        const __m256 rz = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m[8], x), _mm256_mul_ps(m[9], y)),
+            _mm256_add_ps(_mm256_mul_ps(m[10], z), m[11]));
+        _mm256_storeu_ps(dx + i, rx);
+        _mm256_storeu_ps(dy + i, ry);
+        _mm256_storeu_ps(dz + i, rz);
+    }
+}
+#endif
+
+#ifdef URHO3D_MATH_BATCH_NEON
+/// Matrix elements broadcast to NEON registers.
+struct MatrixNEON
+{
+    explicit MatrixNEON(const Matrix3x4& m)
+    {
+        const float* data = m.Data();
+        for (unsigned i = 0; i < 12; ++i)
+            m_[i] = vdupq_n_f32(data[i]);
+    }
+
+    float32x4_t m_[12];
+};
+
+/// Return X * m0 + Y * m1 + Z * m2 + m3 * W.
+inline float32x4_t DotRowNEON(const float32x4_t* row, float32x4_t x, float32x4_t y, float32x4_t z, float w)
+{
+    return vmlaq_f32(vmlaq_f32(vmlaq_f32(vmulq_n_f32(row[3], w), row[0], x), row[1], y), row[2], z);
+}
+
+void TransformStreamNEON(const Matrix3x4& transform, const float* sx, const float* sy, const float* sz,
+    float* dx, float* dy, float* dz, unsigned count)
+{
+    const MatrixNEON m(transform);
+    // Streams are padded, so the last partial register may be processed whole
+    for (unsigned i = 0; i < count; i += 4)
+    {
+        const float32x4_t x = vld1q_f32(sx + i);
+        const float32x4_t y = vld1q_f32(sy + i);
+        const float32x4_t z = vld1q_f32(sz + i);
+        vst1q_f32(dx + i, DotRowNEON(&m.m_[0], x, y, z, 1.0f));
+        vst1q_f32(dy + i, DotRowNEON(&m.m_[4], x, y, z, 1.0f));
+        vst1q_f32(dz + i, DotRowNEON(&m.m_[8], x, y, z, 1.0f));
+    }
+}
+
+void TransformVectorsNEON(const Matrix3x4& transform, const Vector3* src, Vector3* dest, unsigned count, float w)
+{
+    const MatrixNEON m(transform);
+    const unsigned simdCount = count & ~3u;
+    for (unsigned i = 0; i < simdCount; i += 4)
+    {
+        const float32x4x3_t v = vld3q_f32(&src[i].x_);
+        float32x4x3_t result;
+        result.val[0] = DotRowNEON(&m.m_[0], v.val[0], v.val[1], v.val[2], w);
+        result.val[1] = DotRowNEON(&m.m_[4], v.val[0], v.val[1], v.val[2], w);
+        result.val[2] = DotRowNEON(&m.m_[8], v.val[0], v.val[1], v.val[2], w);
+        vst3q_f32(&dest[i].x_, result);
+    }
+    TransformVectorsScalar(transform, src, dest, simdCount, count, w);
+}
+
+/// Compute rotation matrix elements of 4 quaternions in row-major order.
+void QuaternionsToMatrixNEON(const Quaternion* src, float32x4_t* m)
+{
+    const float32x4x4_t q = vld4q_f32(&src->w_);
+    const float32x4_t w = q.val[0];
+    const float32x4_t x = q.val[1];
+    const float32x4_t y = q.val[2];
+    const float32x4_t z = q.val[3];
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t x2 = vaddq_f32(x, x);
+    const float32x4_t y2 = vaddq_f32(y, y);
+    const float32x4_t z2 = vaddq_f32(z, z);
+    const float32x4_t xx = vmulq_f32(x, x2);
+    const float32x4_t yy = vmulq_f32(y, y2);
+    const float32x4_t zz = vmulq_f32(z, z2);
+    const float32x4_t xy = vmulq_f32(x, y2);
+    const float32x4_t xz = vmulq_f32(x, z2);
+    const float32x4_t yz = vmulq_f32(y, z2);
+    const float32x4_t wx = vmulq_f32(w, x2);
+    const float32x4_t wy = vmulq_f32(w, y2);
+    const float32x4_t wz = vmulq_f32(w, z2);
+    m[0] = vsubq_f32(one, vaddq_f32(yy, zz));
+    m[1] = vsubq_f32(xy, wz);
+    m[2] = vaddq_f32(xz, wy);
+    m[3] = vaddq_f32(xy, wz);
+    m[4] = vsubq_f32(one, vaddq_f32(xx, zz));
+    m[5] = vsubq_f32(yz, wx);
+    m[6] = vsubq_f32(xz, wy);
+    m[7] = vaddq_f32(yz, wx);
+    m[8] = vsubq_f32(one, vaddq_f32(xx, yy));
+}
+
+void QuaternionsToMatricesNEON(const Quaternion* src, Matrix3* dest, unsigned count)
+{
+    const unsigned simdCount = count & ~3u;
+    for (unsigned i = 0; i < simdCount; i += 4)
+    {
+        float32x4_t m[9];
+        QuaternionsToMatrixNEON(src + i, m);
+
+        // Matrix3 has no padding, so scatter through a small buffer
+        float elements[9][4];
+        for (unsigned j = 0; j < 9; ++j)
+            vst1q_f32(elements[j], m[j]);
+        for (unsigned k = 0; k < 4; ++k)
+        {
+            float* data = &dest[i + k].m00_;
+            for (unsigned j = 0; j < 9; ++j)
+                data[j] = elements[j][k];
+        }
+    }
+    for (unsigned i = simdCount; i < count; ++i)
+        dest[i] = src[i].RotationMatrix();
+}
+#endif
+
+}
+
+void Vector3Stream::Resize(unsigned size)
+{
+    const unsigned paddedSize = (size + 7) & ~7u;
+    x_.resize(paddedSize);
+    y_.resize(paddedSize);
+    z_.resize(paddedSize);
+    size_ = size;
+}
+
+void Vector3Stream::FromVectors(const Vector3* src, unsigned count)
+{
+    Resize(count);
+    for (unsigned i = 0; i < count; ++i)
+        Set(i, src[i]);
+}
+
+void Vector3Stream::ToVectors(Vector3* dest) const
+{
+    for (unsigned i = 0; i < size_; ++i)
+        dest[i] = Get(i);
+}
+
+MathBatchBackend GetMathBatchBackend()
+{
+    return GetBackendStorage();
+}
+
+bool IsMathBatchBackendSupported(MathBatchBackend backend)
+{
+    switch (backend)
+    {
+    case MathBatchBackend::Scalar:
+        return true;
+#ifdef URHO3D_SSE
+    case MathBatchBackend::SSE2:
+        return true;
+    case MathBatchBackend::AVX:
+        return IsAVXSupported();
+#endif
+#ifdef URHO3D_MATH_BATCH_NEON
+    case MathBatchBackend::NEON:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+bool SetMathBatchBackend(MathBatchBackend backend)
+{
+    if (!IsMathBatchBackendSupported(backend))
+        return false;
+
+    GetBackendStorage() = backend;
+    return true;
+}
+
+void TransformPoints(const Matrix3x4& transform, const Vector3Stream& src, Vector3Stream& dest)
+{
+    const unsigned count = src.Size();
+    dest.Resize(count);
+
+    const float* sx = src.X();
+    const float* sy = src.Y();
+    const float* sz = src.Z();
+    float* dx = dest.X();
+    float* dy = dest.Y();
+    float* dz = dest.Z();
+
+    switch (GetBackendStorage())
+    {
+#ifdef URHO3D_MATH_BATCH_AVX
+    case MathBatchBackend::AVX:
+        TransformStreamAVX(transform, sx, sy, sz, dx, dy, dz, count);
+        return;
+#endif
+#ifdef URHO3D_SSE
+    case MathBatchBackend::SSE2:
+        TransformStreamSSE(transform, sx, sy, sz, dx, dy, dz, count);
+        return;
+#endif
+#ifdef URHO3D_MATH_BATCH_NEON
+    case MathBatchBackend::NEON:
+        TransformStreamNEON(transform, sx, sy, sz, dx, dy, dz, count);
+        return;
+#endif
+    default:
+        TransformStreamScalar(transform, sx, sy, sz, dx, dy, dz, 0, count);
+        return;
+    }
+}
+
+void TransformPoints(const Matrix3x4& transform, const Vector3* src, Vector3* dest, unsigned count)
+{
+    const MathBatchBackend backend = GetBackendStorage();
+#ifdef URHO3D_SSE
+    if (UseSSE(backend))
+        return TransformVectorsSSE(transform, src, dest, count, true);
+#endif
+#ifdef URHO3D_MATH_BATCH_NEON
+    if (backend == MathBatchBackend::NEON)
+        return TransformVectorsNEON(transform, src, dest, count, 1.0f);
+#endif
+    TransformVectorsScalar(transform, src, dest, 0, count, 1.0f);
+}
+
+void TransformDirections(const Matrix3x4& transform, const Vector3* src, Vector3* dest, unsigned count)
+{
+    const MathBatchBackend backend = GetBackendStorage();
+#ifdef URHO3D_SSE
+    if (UseSSE(backend))
+        return TransformVectorsSSE(transform, src, dest, count, false);
+#endif
+#ifdef URHO3D_MATH_BATCH_NEON
+    if (backend == MathBatchBackend::NEON)
+        return TransformVectorsNEON(transform, src, dest, count, 0.0f);
+#endif
+    TransformVectorsScalar(transform, src, dest, 0, count, 0.0f);
+}
+
+void TransformBoundingBoxes(const Matrix3x4& transform, const BoundingBox* src, BoundingBox* dest, unsigned count)
+{
+#ifdef URHO3D_SSE
+    if (UseSSE(GetBackendStorage()))
+        return TransformBoundingBoxesSSE(transform, src, dest, count);
+#endif
+    for (unsigned i = 0; i < count; ++i)
+        dest[i] = TransformBoundingBoxScalar(transform, src[i]);
+}
+
+BoundingBox MergeTransformedBoundingBoxes(const BoundingBox& box, const Matrix3x4* transforms, unsigned count)
+{
+    if (!box.Defined())
+        return box;
+
+#ifdef URHO3D_SSE
+    if (UseSSE(GetBackendStorage()))
+        return MergeTransformedBoundingBoxesSSE(box, transforms, count);
+#endif
+    BoundingBox result;
+    for (unsigned i = 0; i < count; ++i)
+        result.Merge(TransformBoundingBoxScalar(transforms[i], box));
+    return result;
+}
+
+void QuaternionsToMatrices(const Quaternion* src, Matrix3* dest, unsigned count)
+{
+    const MathBatchBackend backend = GetBackendStorage();
+#ifdef URHO3D_SSE
+    if (UseSSE(backend))
+        return QuaternionsToMatricesSSE(src, dest, count);
+#endif
+#ifdef URHO3D_MATH_BATCH_NEON
+    if (backend == MathBatchBackend::NEON)
+        return QuaternionsToMatricesNEON(src, dest, count);
+#endif
+    for (unsigned i = 0; i < count; ++i)
+        dest[i] = src[i].RotationMatrix();
+}
+
+void ComposeTransforms(const Vector3* translations, const Quaternion* rotations, const Vector3* scales, Matrix3x4* dest, unsigned count)
+{
+#ifdef URHO3D_SSE
+    if (UseSSE(GetBackendStorage()))
+        return ComposeTransformsSSE(translations, rotations, scales, dest, count);
+#endif
+    for (unsigned i = 0; i < count; ++i)
+        ComposeTransformScalar(translations[i], rotations[i], scales ? scales[i] : Vector3::ONE, dest[i]);
+}
+
+}
@@ -0,0 +1,123 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Math/BoundingBox.h"
+#include "../Math/Matrix3.h"
+#include "../Math/Matrix3x4.h"
+#include "../Math/Quaternion.h"
+
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+/// Instruction set used by the batched math kernels.
+enum class MathBatchBackend
+{
+    /// Portable scalar code.
+    Scalar,
+    /// 4-wide SSE2 kernels.
+    SSE2,
+    /// 8-wide AVX kernels where available, SSE2 kernels otherwise.
+    AVX,
+    /// 4-wide NEON kernels.
+    NEON
+};
+
+/// Structure-of-arrays stream of 3D vectors. Component arrays are padded to a multiple of 8 elements so that kernels may read and write whole SIMD registers.
+class URHO3D_API Vector3Stream
+{
+public:
+    /// Construct empty.
+    Vector3Stream() = default;
+    /// Construct with size.
+    explicit Vector3Stream(unsigned size) { Resize(size); }
+
+    /// Resize. Contents of new elements are undefined.
+    void Resize(unsigned size);
+    /// Clear.
+    void Clear() { Resize(0); }
+    /// Set element.
+    void Set(unsigned index, const Vector3& value)
+    {
+        x_[index] = value.x_;
+        y_[index] = value.y_;
+        z_[index] = value.z_;
+    }
+    /// Copy elements from an array of structures. Resizes the stream to match.
+    void FromVectors(const Vector3* src, unsigned count);
+    /// Copy elements to an array of structures.
+    void ToVectors(Vector3* dest) const;
+
+    /// Return element.
+    Vector3 Get(unsigned index) const { return Vector3(x_[index], y_[index], z_[index]); }
+    /// Return number of elements.
+    unsigned Size() const { return size_; }
+    /// Return X components.
+    float* X() { return x_.data(); }
+    /// Return Y components.
+    float* Y() { return y_.data(); }
+    /// Return Z components.
+    float* Z() { return z_.data(); }
+    /// Return X components.
+    const float* X() const { return x_.data(); }
+    /// Return Y components.
+    const float* Y() const { return y_.data(); }
+    /// Return Z components.
+    const float* Z() const { return z_.data(); }
+
+private:
+    /// X components.
+    ea::vector<float> x_;
+    /// Y components.
+    ea::vector<float> y_;
+    /// Z components.
+    ea::vector<float> z_;
+    /// Number of elements.
+    unsigned size_{};
+};
+
+/// Return backend used by the batched math kernels. Chosen at startup from the CPU features.
+URHO3D_API MathBatchBackend GetMathBatchBackend();
+/// Return whether the backend is supported by this build and CPU.
+URHO3D_API bool IsMathBatchBackendSupported(MathBatchBackend backend);
+/// Override backend used by the batched math kernels, e.g. to compare against scalar code. Return false if not supported. Not thread safe.
+URHO3D_API bool SetMathBatchBackend(MathBatchBackend backend);
+
+/// Transform points of a structure-of-arrays stream. Destination is resized to match, and may be the same as the source.
+URHO3D_API void TransformPoints(const Matrix3x4& transform, const Vector3Stream& src, Vector3Stream& dest);
+/// Transform an array of points. Destination may be the same as the source.
+URHO3D_API void TransformPoints(const Matrix3x4& transform, const Vector3* src, Vector3* dest, unsigned count);
+/// Transform an array of directions without translation. Destination may be the same as the source.
+URHO3D_API void TransformDirections(const Matrix3x4& transform, const Vector3* src, Vector3* dest, unsigned count);
+/// Transform an array of bounding boxes. Destination may be the same as the source.
+URHO3D_API void TransformBoundingBoxes(const Matrix3x4& transform, const BoundingBox* src, BoundingBox* dest, unsigned count);
+/// Transform one bounding box by an array of transforms and return the merged result.
+URHO3D_API BoundingBox MergeTransformedBoundingBoxes(const BoundingBox& box, const Matrix3x4* transforms, unsigned count);
+/// Convert an array of quaternions to rotation matrices.
+URHO3D_API void QuaternionsToMatrices(const Quaternion* src, Matrix3* dest, unsigned count);
+/// Compose an array of transforms from translations, rotations and scales. Scales may be null for unit scale.
+URHO3D_API void ComposeTransforms(const Vector3* translations, const Quaternion* rotations, const Vector3* scales, Matrix3x4* dest, unsigned count);
+
+}
@@ -30,12 +30,113 @@
 #include "../IO/Log.h"
 
 #include <cstdio>
+#include <cstring>
+
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#endif
 
 #include "../DebugNew.h"
 
 namespace Urho3D
 {
 
+namespace
+{
+
+/// SDBM hash multiplier, SDBMHash(hash, c) == hash * SDBM_MULTIPLIER + c.
+static constexpr unsigned SDBM_MULTIPLIER = 65599u;
+
+/// Return SDBM_MULTIPLIER raised to the power, modulo 2^32.
+constexpr unsigned SDBMPower(unsigned power)
+{
+    unsigned result = 1;
+    while (power--)
+        result *= SDBM_MULTIPLIER;
+    return result;
+}
+
+static_assert(SDBMHash(SDBMHash(0, 'a'), 'b') == 'a' * SDBMPower(1) + 'b', "Unexpected SDBM hash recurrence.");
+
+/// Hash 8-byte blocks. The byte terms of a block do not depend on each other, unlike the byte by byte recurrence.
+unsigned CalculateBlocks8(const unsigned char* bytes, unsigned numBlocks, unsigned hash)
+{
+    static constexpr unsigned P1 = SDBMPower(1);
+    static constexpr unsigned P2 = SDBMPower(2);
+    static constexpr unsigned P3 = SDBMPower(3);
+    static constexpr unsigned P4 = SDBMPower(4);
+    static constexpr unsigned P5 = SDBMPower(5);
+    static constexpr unsigned P6 = SDBMPower(6);
+    static constexpr unsigned P7 = SDBMPower(7);
+    static constexpr unsigned P8 = SDBMPower(8);
+
+    for (unsigned i = 0; i < numBlocks; ++i, bytes += 8)
+    {
+        const unsigned high = bytes[0] * P7 + bytes[1] * P6 + bytes[2] * P5 + bytes[3] * P4;
+        const unsigned low = bytes[4] * P3 + bytes[5] * P2 + bytes[6] * P1 + bytes[7];
+        hash = hash * P8 + high + low;
+    }
+    return hash;
+}
+
+#ifdef URHO3D_SSE
+/// Minimum data length to use the SSE2 implementation.
+static constexpr unsigned SSE_HASH_MIN_LENGTH = 64;
+
+/// Multiply 32-bit lanes, keeping the low 32 bits of the products.
+inline __m128i MultiplyLow32(__m128i a, __m128i b)
+{
+    const __m128i even = _mm_mul_epu32(a, b);
+    const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+/// Hash 16-byte blocks. Each of the 16 lanes accumulates the bytes at its position in the blocks, the lanes are then merged.
+unsigned CalculateBlocks16SSE(const unsigned char* bytes, unsigned numBlocks, unsigned hash)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i blockPower = _mm_set1_epi32(static_cast<int>(SDBMPower(16)));
+    __m128i acc0 = zero;
+    __m128i acc1 = zero;
+    __m128i acc2 = zero;
+    __m128i acc3 = zero;
+    unsigned hashPower = 1;
+
+    for (unsigned i = 0; i < numBlocks; ++i, bytes += 16)
+    {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+        const __m128i low = _mm_unpacklo_epi8(block, zero);
+        const __m128i high = _mm_unpackhi_epi8(block, zero);
+
+        acc0 = _mm_add_epi32(MultiplyLow32(acc0, blockPower), _mm_unpacklo_epi16(low, zero));
+        acc1 = _mm_add_epi32(MultiplyLow32(acc1, blockPower), _mm_unpackhi_epi16(low, zero));
+        acc2 = _mm_add_epi32(MultiplyLow32(acc2, blockPower), _mm_unpacklo_epi16(high, zero));
+        acc3 = _mm_add_epi32(MultiplyLow32(acc3, blockPower), _mm_unpackhi_epi16(high, zero));
+        hashPower *= SDBMPower(16);
+    }
+
+    // Weight lane j by the power of its distance from the end of a block
+    const __m128i weights0 = _mm_setr_epi32(static_cast<int>(SDBMPower(15)), static_cast<int>(SDBMPower(14)),
+        static_cast<int>(SDBMPower(13)), static_cast<int>(SDBMPower(12)));
+    const __m128i weights1 = _mm_setr_epi32(static_cast<int>(SDBMPower(11)), static_cast<int>(SDBMPower(10)),
+        static_cast<int>(SDBMPower(9)), static_cast<int>(SDBMPower(8)));
+    const __m128i weights2 = _mm_setr_epi32(static_cast<int>(SDBMPower(7)), static_cast<int>(SDBMPower(6)),
+        static_cast<int>(SDBMPower(5)), static_cast<int>(SDBMPower(4)));
+    const __m128i weights3 = _mm_setr_epi32(static_cast<int>(SDBMPower(3)), static_cast<int>(SDBMPower(2)),
+        static_cast<int>(SDBMPower(1)), 1);
+
+    __m128i sum = _mm_add_epi32(
+        _mm_add_epi32(MultiplyLow32(acc0, weights0), MultiplyLow32(acc1, weights1)),
+        _mm_add_epi32(MultiplyLow32(acc2, weights2), MultiplyLow32(acc3, weights3)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    return hash * hashPower + static_cast<unsigned>(_mm_cvtsi128_si32(sum));
+}
+#endif
+
+}
+
 #ifdef URHO3D_HASH_DEBUG
 
 // Expose map to let Visual Studio debugger access it if Urho3D is linked statically.
@@ -61,7 +162,7 @@ StringHash::StringHash(const char* str) noexcept :      // NOLINT(google-explici
 }
 #endif
 StringHash::StringHash(const ea::string& str) noexcept :
-    value_(Calculate(str.c_str()))
+    value_(Calculate(static_cast<const void*>(str.data()), ea::min(str.find('\0'), str.length())))
 {
 #ifdef URHO3D_HASH_DEBUG
     Urho3D::GetGlobalStringHashRegister().RegisterString(*this, str.c_str());
@@ -82,10 +183,7 @@ unsigned StringHash::Calculate(const char* str, unsigned hash)
     if (!str)
         return hash;
 
-    while (*str)
-        hash = SDBMHash(hash, (unsigned char)*str++);
-
-    return hash;
+    return Calculate(static_cast<const void*>(str), static_cast<unsigned>(strlen(str)), hash);
 }
 #endif
 
@@ -95,6 +193,22 @@ unsigned StringHash::Calculate(const void* data, unsigned int length, unsigned i
         return hash;
 
     auto* bytes = static_cast<const unsigned char*>(data);
+
+#ifdef URHO3D_SSE
+    if (length >= SSE_HASH_MIN_LENGTH)
+    {
+        const unsigned numBlocks = length / 16;
+        hash = CalculateBlocks16SSE(bytes, numBlocks, hash);
+        bytes += numBlocks * 16;
+        length -= numBlocks * 16;
+    }
+#endif
+
+    const unsigned numBlocks = length / 8;
+    hash = CalculateBlocks8(bytes, numBlocks, hash);
+    bytes += numBlocks * 8;
+    length -= numBlocks * 8;
+
     auto* end = bytes + length;
     while (bytes < end)
         hash = SDBMHash(hash, (unsigned char)*bytes++);
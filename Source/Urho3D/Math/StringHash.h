@@ -37,7 +37,7 @@ class URHO3D_API StringHash
 {
 public:
     /// Construct with zero value.
-    StringHash() noexcept :
+    constexpr StringHash() noexcept :
         value_(0)
     {
     }
@@ -46,7 +46,7 @@ public:
     StringHash(const StringHash& rhs) noexcept = default;
 
     /// Construct with an initial value.
-    explicit StringHash(unsigned value) noexcept :
+    explicit constexpr StringHash(unsigned value) noexcept :
         value_(value)
     {
     }
@@ -60,9 +60,9 @@ public:
 #else
     StringHash(const char* str) noexcept;      // NOLINT(google-explicit-constructor)
 #endif
-    /// Construct from a string.
+    /// Construct from a string. Hashes up to the first null character, same as the C string constructor.
     StringHash(const ea::string& str) noexcept;      // NOLINT(google-explicit-constructor)
-    /// Construct from a string.
+    /// Construct from a string view. Hashes the whole view, including any embedded null characters.
     StringHash(const ea::string_view& str) noexcept;      // NOLINT(google-explicit-constructor)
 
     /// Assign from another hash.
@@ -84,22 +84,22 @@ public:
     }
 
     /// Test for equality with another hash.
-    bool operator ==(const StringHash& rhs) const { return value_ == rhs.value_; }
+    constexpr bool operator ==(const StringHash& rhs) const { return value_ == rhs.value_; }
 
     /// Test for inequality with another hash.
-    bool operator !=(const StringHash& rhs) const { return value_ != rhs.value_; }
+    constexpr bool operator !=(const StringHash& rhs) const { return value_ != rhs.value_; }
 
     /// Test if less than another hash.
-    bool operator <(const StringHash& rhs) const { return value_ < rhs.value_; }
+    constexpr bool operator <(const StringHash& rhs) const { return value_ < rhs.value_; }
 
     /// Test if greater than another hash.
-    bool operator >(const StringHash& rhs) const { return value_ > rhs.value_; }
+    constexpr bool operator >(const StringHash& rhs) const { return value_ > rhs.value_; }
 
     /// Return true if nonzero hash value.
-    explicit operator bool() const { return value_ != 0; }
+    explicit constexpr operator bool() const { return value_ != 0; }
 
     /// Return hash value.
-    unsigned Value() const { return value_; }
+    constexpr unsigned Value() const { return value_; }
 
     /// Return as string.
     ea::string ToString() const;
@@ -108,18 +108,22 @@ public:
     ea::string Reverse() const;
 
     /// Return hash value for HashSet & HashMap.
-    unsigned ToHash() const { return value_; }
+    constexpr unsigned ToHash() const { return value_; }
 #ifndef URHO3D_HASH_DEBUG
-    /// Calculate hash value from a C string.
+    /// Calculate hash value from a C string. Evaluated at compile time for string literals.
     static constexpr unsigned Calculate(const char* str, unsigned hash = 0)
     {
-        return str == nullptr || *str == 0 ? hash : Calculate(str + 1, SDBMHash(hash, (unsigned char)*str));
+        if (str == nullptr)
+            return hash;
+        while (*str)
+            hash = SDBMHash(hash, (unsigned char)*str++);
+        return hash;
     }
 #else
     /// Calculate hash value from a C string.
     static unsigned Calculate(const char* str, unsigned hash = 0);
 #endif
-    /// Calculate hash value from binary data.
+    /// Calculate hash value from binary data. Gives the same result as hashing the bytes one by one, but processes long data in blocks.
     static unsigned Calculate(const void* data, unsigned length, unsigned hash = 0);
 
     /// Get global StringHashRegister. Use for debug purposes only. Return nullptr if URHO3D_HASH_DEBUG is off.
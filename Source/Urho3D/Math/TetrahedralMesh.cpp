@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Core/WorkQueue.h"
 #include "../IO/ArchiveSerialization.h"
 #include "../IO/Log.h"
 #include "../Math/Plane.h"
@@ -80,6 +81,43 @@ struct TetrahedralMeshEdge
     }
 };
 
+/// Spread lower 10 bits of the value so that there are two zero bits between each pair of bits.
+unsigned SpreadBits(unsigned value)
+{
+    value &= 0x3ff;
+    value = (value | (value << 16)) & 0x030000ff;
+    value = (value | (value << 8)) & 0x0300f00f;
+    value = (value | (value << 4)) & 0x030c30c3;
+    value = (value | (value << 2)) & 0x09249249;
+    return value;
+}
+
+/// Return Morton code of the position within bounding box.
+unsigned GetMortonCode(const Vector3& position, const BoundingBox& boundingBox)
+{
+    static const float maxCoord = 1023.0f;
+    const Vector3 size = VectorMax(boundingBox.Size(), Vector3::ONE * M_LARGE_EPSILON);
+    const Vector3 coords = VectorMin(VectorMax((position - boundingBox.min_) / size, Vector3::ZERO), Vector3::ONE) * maxCoord;
+    return SpreadBits(static_cast<unsigned>(coords.x_))
+        | (SpreadBits(static_cast<unsigned>(coords.y_)) << 1)
+        | (SpreadBits(static_cast<unsigned>(coords.z_)) << 2);
+}
+
+/// Invoke callback for ranges of items, in parallel if work queue is provided.
+template <class T>
+void ForEachRange(WorkQueue* workQueue, unsigned count, unsigned grainSize, const T& callback)
+{
+    if (!workQueue || count <= grainSize)
+    {
+        callback(0u, count);
+        return;
+    }
+
+    workQueue->ParallelFor(count, grainSize,
+        [&callback](unsigned begin, unsigned end, unsigned /*threadIndex*/) { callback(begin, end); });
+    workQueue->Complete(M_MAX_UNSIGNED);
+}
+
 }
 
 bool TetrahedralMeshSurface::CalculateAdjacency()
@@ -144,7 +182,7 @@ bool TetrahedralMeshSurface::IsClosedSurface() const
     return true;
 }
 
-void TetrahedralMesh::Define(ea::span<const Vector3> positions)
+void TetrahedralMesh::Define(ea::span<const Vector3> positions, WorkQueue* workQueue)
 {
     BoundingBox boundingBox(positions.data(), positions.size());
     const Vector3 size = boundingBox.Size();
@@ -152,7 +190,8 @@ void TetrahedralMesh::Define(ea::span<const Vector3> positions)
     boundingBox.min_ -= Vector3::ONE;
     boundingBox.max_ += Vector3::ONE;
     InitializeSuperMesh(boundingBox);
-    BuildTetrahedrons(positions);
+    BuildTetrahedrons(positions, workQueue);
+    BuildLookupGrid(workQueue);
 }
 
 void TetrahedralMesh::CollectEdges(ea::vector<ea::pair<unsigned, unsigned>>& edges)
@@ -271,10 +310,14 @@ Vector4 TetrahedralMesh::GetInterpolationFactors(const Vector3& position, unsign
 
     const unsigned maxIters = tetrahedrons_.size();
     if (tetIndexHint >= maxIters)
-        tetIndexHint = 0;
+        tetIndexHint = !lookupGrid_.empty() ? GetLookupGridTetrahedron(position) : 0;
 
     for (unsigned i = 0; i < maxIters; ++i)
     {
+        // Hint is far from the position, e.g. after teleport. Restart from the lookup grid
+        if (i == MaxHintWalkSteps && !lookupGrid_.empty())
+            tetIndexHint = GetLookupGridTetrahedron(position);
+
         const Vector4 weights = GetBarycentricCoords(tetIndexHint, position);
         if (weights.x_ >= 0.0f && weights.y_ >= 0.0f && weights.z_ >= 0.0f && weights.w_ >= 0.0f)
             return weights;
@@ -291,6 +334,59 @@ Vector4 TetrahedralMesh::GetInterpolationFactors(const Vector3& position, unsign
     return GetBarycentricCoords(tetIndexHint, position);
 }
 
+void TetrahedralMesh::BuildLookupGrid(WorkQueue* workQueue)
+{
+    lookupGrid_.clear();
+    if (numInnerTetrahedrons_ == 0)
+        return;
+
+    // Aim at about one cell per inner tetrahedron
+    const BoundingBox boundingBox(vertices_.data(), vertices_.size());
+    const Vector3 size = VectorMax(boundingBox.Size(), Vector3::ONE * M_LARGE_EPSILON);
+    const float maxSize = ea::max({ size.x_, size.y_, size.z_ });
+    const float maxCells = static_cast<float>(MaxLookupGridDimension * MaxLookupGridDimension * MaxLookupGridDimension);
+    const float numCells = ea::min(static_cast<float>(numInnerTetrahedrons_), maxCells);
+    const float cellSize = ea::max(std::cbrt(size.x_ * size.y_ * size.z_ / numCells), maxSize / MaxLookupGridDimension);
+
+    lookupGridSize_ = VectorMax(IntVector3::ONE,
+        VectorMin(VectorCeilToInt(size / cellSize), IntVector3::ONE * MaxLookupGridDimension));
+    lookupGridOrigin_ = boundingBox.min_;
+    lookupGridScale_ = static_cast<Vector3>(lookupGridSize_) / size;
+
+    // Walk from the previous cell, neighbour cells are close to each other. Each range of slices has its own walk
+    ea::vector<unsigned> lookupGrid(lookupGridSize_.x_ * lookupGridSize_.y_ * lookupGridSize_.z_);
+    ForEachRange(workQueue, lookupGridSize_.z_, 1, [&](unsigned beginZ, unsigned endZ)
+    {
+        unsigned hint = M_MAX_UNSIGNED;
+        unsigned cellIndex = beginZ * lookupGridSize_.y_ * lookupGridSize_.x_;
+        for (int z = static_cast<int>(beginZ); z < static_cast<int>(endZ); ++z)
+        {
+            for (int y = 0; y < lookupGridSize_.y_; ++y)
+            {
+                for (int x = 0; x < lookupGridSize_.x_; ++x)
+                {
+                    const Vector3 cellCenter = lookupGridOrigin_
+                        + (Vector3(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)) + Vector3::ONE * 0.5f)
+                        / lookupGridScale_;
+                    GetInterpolationFactors(cellCenter, hint);
+                    lookupGrid[cellIndex++] = hint;
+                }
+            }
+        }
+    });
+
+    lookupGrid_ = ea::move(lookupGrid);
+}
+
+unsigned TetrahedralMesh::GetLookupGridTetrahedron(const Vector3& position) const
+{
+    const IntVector3 cell = VectorFloorToInt((position - lookupGridOrigin_) * lookupGridScale_);
+    const int x = Clamp(cell.x_, 0, lookupGridSize_.x_ - 1);
+    const int y = Clamp(cell.y_, 0, lookupGridSize_.y_ - 1);
+    const int z = Clamp(cell.z_, 0, lookupGridSize_.z_ - 1);
+    return lookupGrid_[x + (y + z * lookupGridSize_.y_) * lookupGridSize_.x_];
+}
+
 int TetrahedralMesh::SolveCubicEquation(double result[], double a, double b, double c, double eps)
 {
     // Performance-critical code, don't use degree-based functions here
@@ -388,14 +484,18 @@ Vector3 TetrahedralMesh::GetTriangleBarycentricCoords(const Vector3& position,
     return { u, v, w };
 }
 
-unsigned TetrahedralMesh::FindTetrahedron(const Vector3& position, ea::vector<bool>& removed) const
+unsigned TetrahedralMesh::FindTetrahedron(const Vector3& position, ea::vector<bool>& removed, unsigned startTetIndex) const
 {
-    auto firstNotRemovedIter = ea::find(removed.begin(), removed.end(), false);
-    if (firstNotRemovedIter == removed.end())
-        return M_MAX_UNSIGNED;
+    unsigned tetIndex = startTetIndex;
+    if (tetIndex >= removed.size() || removed[tetIndex])
+    {
+        auto firstNotRemovedIter = ea::find(removed.begin(), removed.end(), false);
+        if (firstNotRemovedIter == removed.end())
+            return M_MAX_UNSIGNED;
+        tetIndex = firstNotRemovedIter - removed.begin();
+    }
 
     const unsigned maxIters = tetrahedrons_.size();
-    unsigned tetIndex = firstNotRemovedIter - removed.begin();
     for (unsigned i = 0; i < maxIters; ++i)
     {
         // Found one
@@ -470,7 +570,7 @@ void TetrahedralMesh::InitializeSuperMesh(const BoundingBox& boundingBox)
     }
 }
 
-void TetrahedralMesh::BuildTetrahedrons(ea::span<const Vector3> positions)
+void TetrahedralMesh::BuildTetrahedrons(ea::span<const Vector3> positions, WorkQueue* workQueue)
 {
     // Initialize context
     DelaunayContext ctx;
@@ -483,9 +583,18 @@ void TetrahedralMesh::BuildTetrahedrons(ea::span<const Vector3> positions)
     const unsigned startVertex = vertices_.size();
     vertices_.insert(vertices_.end(), positions.begin(), positions.end());
 
-    ea::vector<unsigned> verticesQueue;
+    // Insert vertices along Morton curve, so each search starts next to the previous insertion
+    const BoundingBox boundingBox(positions.data(), positions.size());
+    ea::vector<ea::pair<unsigned, unsigned>> sortedVertices;
+    sortedVertices.reserve(positions.size());
     for (unsigned newVertexIndex = startVertex; newVertexIndex < vertices_.size(); ++newVertexIndex)
-        verticesQueue.push_back(newVertexIndex);
+        sortedVertices.emplace_back(GetMortonCode(vertices_[newVertexIndex], boundingBox), newVertexIndex);
+    ea::sort(sortedVertices.begin(), sortedVertices.end());
+
+    ea::vector<unsigned> verticesQueue;
+    verticesQueue.reserve(sortedVertices.size());
+    for (const auto& codeAndIndex : sortedVertices)
+        verticesQueue.push_back(codeAndIndex.second);
 
     // Triangulate
     TetrahedralMeshSurface holeSurface;
@@ -560,7 +669,7 @@ void TetrahedralMesh::BuildTetrahedrons(ea::span<const Vector3> positions)
 
     CalculateHullNormals(hullSurface);
     BuildOuterTetrahedrons(hullSurface);
-    CalculateOuterMatrices();
+    CalculateOuterMatrices(workQueue);
 }
 
 bool TetrahedralMesh::IsAdjacencyValid(bool fullyConnected) const
@@ -607,7 +716,7 @@ bool TetrahedralMesh::FindAndRemoveIntersected(TetrahedralMesh::DelaunayContext&
     removedTetrahedrons.clear();
 
     // Find first tetrahedron to remove
-    const unsigned firstTetIndex = FindTetrahedron(position, ctx.removed_);
+    const unsigned firstTetIndex = FindTetrahedron(position, ctx.removed_, ctx.lastTetIndex_);
     if (firstTetIndex == M_MAX_UNSIGNED || !ctx.IsInsideCircumsphere(firstTetIndex, position))
     {
         URHO3D_LOGERROR("Cannot find tetrahedron to insert vertex at {}", position.ToString());
@@ -799,6 +908,7 @@ void TetrahedralMesh::FillStarShapedHole(TetrahedralMesh::DelaunayContext& ctx,
 
         ctx.removed_[newTetIndex] = false;
         ctx.circumspheres_[newTetIndex] = GetTetrahedronCircumsphere(newTetIndex);
+        ctx.lastTetIndex_ = newTetIndex;
     }
 }
 
@@ -1113,109 +1223,113 @@ void TetrahedralMesh::BuildOuterTetrahedrons(const TetrahedralMeshSurface& hullS
     assert(IsAdjacencyValid(true));
 }
 
-void TetrahedralMesh::CalculateOuterMatrices()
+void TetrahedralMesh::CalculateOuterMatrices(WorkQueue* workQueue)
 {
-    for (unsigned tetIndex = numInnerTetrahedrons_; tetIndex < tetrahedrons_.size(); ++tetIndex)
+    const unsigned numOuterTetrahedrons = tetrahedrons_.size() - numInnerTetrahedrons_;
+    ForEachRange(workQueue, numOuterTetrahedrons, 256, [&](unsigned begin, unsigned end)
     {
-        Tetrahedron& tetrahedron = tetrahedrons_[tetIndex];
-
-        Vector3 positions[3];
-        Vector3 normals[3];
-        for (unsigned i = 0; i < 3; ++i)
+        for (unsigned tetIndex = numInnerTetrahedrons_ + begin; tetIndex < numInnerTetrahedrons_ + end; ++tetIndex)
         {
-            positions[i] = vertices_[tetrahedron.indices_[i]];
-            normals[i] = hullNormals_[tetrahedron.indices_[i]];
-        }
+            Tetrahedron& tetrahedron = tetrahedrons_[tetIndex];
 
-        const Vector3 A = positions[0] - positions[2];
-        const Vector3 Ap = normals[0] - normals[2];
-        const Vector3 B = positions[1] - positions[2];
-        const Vector3 Bp = normals[1] - normals[2];
-        const Vector3 P2 = positions[2];
-        const Vector3 Cp = -normals[2];
-
-        Matrix3x4& m = tetrahedron.matrix_;
-
-        m.m00_ = // input.x *
-            + Ap.y_ * Bp.z_
-            - Ap.z_ * Bp.y_;
-        m.m01_ = // input.y *
-            - Ap.x_ * Bp.z_
-            + Ap.z_ * Bp.x_;
-        m.m02_ = // input.z *
-            + Ap.x_ * Bp.y_
-            - Ap.y_ * Bp.x_;
-        m.m03_ = // 1 *
-            + A.x_ * Bp.y_* Cp.z_
-            - A.y_ * Bp.x_ * Cp.z_
-            + Ap.x_ * B.y_ * Cp.z_
-            - Ap.y_ * B.x_ * Cp.z_
-            + A.z_ * Bp.x_ * Cp.y_
-            - A.z_ * Bp.y_ * Cp.x_
-            + Ap.z_ * B.x_ * Cp.y_
-            - Ap.z_ * B.y_ * Cp.x_
-            - A.x_ * Bp.z_ * Cp.y_
-            + A.y_ * Bp.z_ * Cp.x_
-            - Ap.x_ * B.z_ * Cp.y_
-            + Ap.y_ * B.z_ * Cp.x_;
-        m.m03_ -= P2.x_ * m.m00_ + P2.y_ * m.m01_ + P2.z_ * m.m02_;
-
-        m.m10_ = // input.x *
-            + Ap.y_ * B.z_
-            + A.y_ * Bp.z_
-            - Ap.z_ * B.y_
-            - A.z_ * Bp.y_;
-        m.m11_ = // input.y *
-            - A.x_ * Bp.z_
-            - Ap.x_ * B.z_
-            + A.z_ * Bp.x_
-            + Ap.z_ * B.x_;
-        m.m12_ = // input.z *
-            + A.x_ * Bp.y_
-            - A.y_ * Bp.x_
-            + Ap.x_ * B.y_
-            - Ap.y_ * B.x_;
-        m.m13_ = // 1 *
-            + A.x_ * B.y_ * Cp.z_
-            - A.y_ * B.x_ * Cp.z_
-            - A.x_ * B.z_ * Cp.y_
-            + A.y_ * B.z_ * Cp.x_
-            + A.z_ * B.x_ * Cp.y_
-            - A.z_ * B.y_ * Cp.x_;
-        m.m13_ -= P2.x_ * m.m10_ + P2.y_ * m.m11_ + P2.z_ * m.m12_;
-
-        m.m20_ = // input.x *
-            - A.z_ * B.y_
-            + A.y_ * B.z_;
-        m.m21_ = // input.y *
-            - A.x_ * B.z_
-            + A.z_ * B.x_;
-        m.m22_ = // input.z *
-            + A.x_ * B.y_
-            - A.y_ * B.x_;
-        m.m23_ = 0.0f; // 1 *
-        m.m23_ -= P2.x_ * m.m20_ + P2.y_ * m.m21_ + P2.z_ * m.m22_;
-
-        const float a =
-            + Ap.x_ * Bp.y_ * Cp.z_
-            - Ap.y_ * Bp.x_ * Cp.z_
-            + Ap.z_ * Bp.x_ * Cp.y_
-            - Ap.z_ * Bp.y_ * Cp.x_
-            + Ap.y_ * Bp.z_ * Cp.x_
-            - Ap.x_ * Bp.z_ * Cp.y_;
-
-        if (Abs(a) > M_LARGE_EPSILON)
-        {
-            // d is not zero, so the polynomial at^3 + bt^2 + ct + d = 0 is actually cubic
-            // and we can simplify to the monic form t^3 + pt^2 + qt + r = 0
-            m = m * (1.0f / a);
-        }
-        else
-        {
-            // It's actually a quadratic or even linear equation
-            tetrahedron.indices_[3] = Tetrahedron::Infinity2;
+            Vector3 positions[3];
+            Vector3 normals[3];
+            for (unsigned i = 0; i < 3; ++i)
+            {
+                positions[i] = vertices_[tetrahedron.indices_[i]];
+                normals[i] = hullNormals_[tetrahedron.indices_[i]];
+            }
+
+            const Vector3 A = positions[0] - positions[2];
+            const Vector3 Ap = normals[0] - normals[2];
+            const Vector3 B = positions[1] - positions[2];
+            const Vector3 Bp = normals[1] - normals[2];
+            const Vector3 P2 = positions[2];
+            const Vector3 Cp = -normals[2];
+
+            Matrix3x4& m = tetrahedron.matrix_;
+
+            m.m00_ = // input.x *
+                + Ap.y_ * Bp.z_
+                - Ap.z_ * Bp.y_;
+            m.m01_ = // input.y *
+                - Ap.x_ * Bp.z_
+                + Ap.z_ * Bp.x_;
+            m.m02_ = // input.z *
+                + Ap.x_ * Bp.y_
+                - Ap.y_ * Bp.x_;
+            m.m03_ = // 1 *
+                + A.x_ * Bp.y_* Cp.z_
+                - A.y_ * Bp.x_ * Cp.z_
+                + Ap.x_ * B.y_ * Cp.z_
+                - Ap.y_ * B.x_ * Cp.z_
+                + A.z_ * Bp.x_ * Cp.y_
+                - A.z_ * Bp.y_ * Cp.x_
+                + Ap.z_ * B.x_ * Cp.y_
+                - Ap.z_ * B.y_ * Cp.x_
+                - A.x_ * Bp.z_ * Cp.y_
+                + A.y_ * Bp.z_ * Cp.x_
+                - Ap.x_ * B.z_ * Cp.y_
+                + Ap.y_ * B.z_ * Cp.x_;
+            m.m03_ -= P2.x_ * m.m00_ + P2.y_ * m.m01_ + P2.z_ * m.m02_;
+
+            m.m10_ = // input.x *
+                + Ap.y_ * B.z_
+                + A.y_ * Bp.z_
+                - Ap.z_ * B.y_
+                - A.z_ * Bp.y_;
+            m.m11_ = // input.y *
+                - A.x_ * Bp.z_
+                - Ap.x_ * B.z_
+                + A.z_ * Bp.x_
+                + Ap.z_ * B.x_;
+            m.m12_ = // input.z *
+                + A.x_ * Bp.y_
+                - A.y_ * Bp.x_
+                + Ap.x_ * B.y_
+                - Ap.y_ * B.x_;
+            m.m13_ = // 1 *
+                + A.x_ * B.y_ * Cp.z_
+                - A.y_ * B.x_ * Cp.z_
+                - A.x_ * B.z_ * Cp.y_
+                + A.y_ * B.z_ * Cp.x_
+                + A.z_ * B.x_ * Cp.y_
+                - A.z_ * B.y_ * Cp.x_;
+            m.m13_ -= P2.x_ * m.m10_ + P2.y_ * m.m11_ + P2.z_ * m.m12_;
+
+            m.m20_ = // input.x *
+                - A.z_ * B.y_
+                + A.y_ * B.z_;
+            m.m21_ = // input.y *
+                - A.x_ * B.z_
+                + A.z_ * B.x_;
+            m.m22_ = // input.z *
+                + A.x_ * B.y_
+                - A.y_ * B.x_;
+            m.m23_ = 0.0f; // 1 *
+            m.m23_ -= P2.x_ * m.m20_ + P2.y_ * m.m21_ + P2.z_ * m.m22_;
+
+            const float a =
+                + Ap.x_ * Bp.y_ * Cp.z_
+                - Ap.y_ * Bp.x_ * Cp.z_
+                + Ap.z_ * Bp.x_ * Cp.y_
+                - Ap.z_ * Bp.y_ * Cp.x_
+                + Ap.y_ * Bp.z_ * Cp.x_
+                - Ap.x_ * Bp.z_ * Cp.y_;
+
+            if (Abs(a) > M_LARGE_EPSILON)
+            {
+                // d is not zero, so the polynomial at^3 + bt^2 + ct + d = 0 is actually cubic
+                // and we can simplify to the monic form t^3 + pt^2 + qt + r = 0
+                m = m * (1.0f / a);
+            }
+            else
+            {
+                // It's actually a quadratic or even linear equation
+                tetrahedron.indices_[3] = Tetrahedron::Infinity2;
+            }
         }
-    }
+    });
 }
 
 bool SerializeValue(Archive& archive, const char* name, Tetrahedron& value)
@@ -1244,6 +1358,8 @@ bool SerializeValue(Archive& archive, const char* name, TetrahedralMesh& value)
         SerializeVector(archive, "Tetrahedrons", "Tetrahedron", value.tetrahedrons_);
         SerializeVector(archive, "HullNormals", "Hulls", value.hullNormals_);
         SerializeValue(archive, "NumInnerTetrahedrons", value.numInnerTetrahedrons_);
+        if (archive.IsInput())
+            value.BuildLookupGrid();
         return true;
     }
     return false;
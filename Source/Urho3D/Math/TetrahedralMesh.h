@@ -37,6 +37,7 @@ namespace Urho3D
 {
 
 class Archive;
+class WorkQueue;
 
 /// 3-vector with double precision.
 struct HighPrecisionVector3
@@ -300,8 +301,8 @@ struct Tetrahedron
 class URHO3D_API TetrahedralMesh
 {
 public:
-    /// Define mesh from vertices.
-    void Define(ea::span<const Vector3> positions);
+    /// Define mesh from vertices. Independent steps are done in parallel if work queue is provided.
+    void Define(ea::span<const Vector3> positions, WorkQueue* workQueue = nullptr);
 
     /// Collect all edges in the mesh, e.g. for debug rendering.
     void CollectEdges(ea::vector<ea::pair<unsigned, unsigned>>& edges);
@@ -320,6 +321,8 @@ public:
 
     /// Find tetrahedron containing given position and calculate barycentric coordinates within this tetrahedron.
     Vector4 GetInterpolationFactors(const Vector3& position, unsigned& tetIndexHint) const;
+    /// Build lookup grid for fast initial tetrahedron search. Called automatically on Define and deserialization.
+    void BuildLookupGrid(WorkQueue* workQueue = nullptr);
 
     /// Sample value at given position from the arbitrary container of per-vertex data.
     template <class Container>
@@ -351,15 +354,23 @@ private:
     /// Calculate barycentric coordinates on triangle.
     static Vector3 GetTriangleBarycentricCoords(const Vector3& position,
         const Vector3& p1, const Vector3& p2, const Vector3& p3);
-    /// Find tetrahedron for given position. Ignore removed tetrahedrons. Return invalid index if cannot find.
-    unsigned FindTetrahedron(const Vector3& position, ea::vector<bool>& removed) const;
+    /// Find tetrahedron for given position starting from the hint. Ignore removed tetrahedrons.
+    /// Return invalid index if cannot find.
+    unsigned FindTetrahedron(const Vector3& position, ea::vector<bool>& removed, unsigned startTetIndex) const;
+    /// Return tetrahedron to start search from, using lookup grid.
+    unsigned GetLookupGridTetrahedron(const Vector3& position) const;
+
+    /// Max number of steps from the hint before the search restarts from the lookup grid.
+    static const unsigned MaxHintWalkSteps = 4;
+    /// Max number of lookup grid cells per dimension.
+    static const int MaxLookupGridDimension = 64;
 
     /// Number of initial super-mesh vertices.
     static const unsigned NumSuperMeshVertices = 8;
     /// Create super-mesh for Delaunay triangulation.
     void InitializeSuperMesh(const BoundingBox& boundingBox);
     /// Build tetrahedrons for given positions.
-    void BuildTetrahedrons(ea::span<const Vector3> positions);
+    void BuildTetrahedrons(ea::span<const Vector3> positions, WorkQueue* workQueue);
     /// Return whether the adjacency is valid.
     bool IsAdjacencyValid(bool fullyConnected) const;
     /// Disconnect tetrahedron from mesh.
@@ -372,6 +383,8 @@ private:
         ea::vector<HighPrecisionSphere> circumspheres_;
         /// Whether the tetrahedron is removed.
         ea::vector<bool> removed_;
+        /// Last created tetrahedron. Vertices are inserted in spatially coherent order, so search starts here.
+        unsigned lastTetIndex_{};
         /// Tests if point is inside circumsphere of tetrahedron.
         bool IsInsideCircumsphere(unsigned tetIndex, const Vector3& position)
         {
@@ -410,7 +423,7 @@ private:
     /// Build outer tetrahedrons.
     void BuildOuterTetrahedrons(const TetrahedralMeshSurface& hullSurface);
     /// Calculate matrices for outer tetrahedrons.
-    void CalculateOuterMatrices();
+    void CalculateOuterMatrices(WorkQueue* workQueue);
 
 public:
     /// Vertices.
@@ -424,6 +437,15 @@ public:
     /// Number of inner tetrahedrons.
     unsigned numInnerTetrahedrons_{};
 
+    /// Minimum corner of lookup grid.
+    Vector3 lookupGridOrigin_;
+    /// Conversion from position offset to lookup grid cell coordinates.
+    Vector3 lookupGridScale_;
+    /// Dimensions of lookup grid.
+    IntVector3 lookupGridSize_;
+    /// Tetrahedron containing the center of each lookup grid cell, or nearest outer tetrahedron.
+    ea::vector<unsigned> lookupGrid_;
+
     /// Debug array of edges related to errors in generation.
     mutable ea::vector<ea::pair<unsigned, unsigned>> debugHighlightEdges_;
 };
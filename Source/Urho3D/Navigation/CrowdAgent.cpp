@@ -77,6 +77,8 @@ static const char* crowdAgentPushinessNames[] = {
     nullptr
 };
 
+URHO3D_SLAB_ALLOCATED_SEPARATELY_IMPL(CrowdAgent)
+
 CrowdAgent::CrowdAgent(Context* context) :
     Component(context),
     agentCrowdId_(-1),
@@ -552,21 +554,25 @@ void CrowdAgent::OnCrowdPositionUpdate(dtCrowdAgent* ag, float* /*pos*/, float d
                 ignoreTransformChanges_ = false;
             }
 
-            using namespace CrowdAgentReposition;
+            // Large crowds may opt out of the per-agent events and read the node positions instead
+            if (crowdManager_->GetAgentRepositionEvents())
+            {
+                using namespace CrowdAgentReposition;
 
-            VariantMap& map = GetEventDataMap();
-            map[P_NODE] = node_;
-            map[P_CROWD_AGENT] = this;
-            map[P_POSITION] = newPos;
-            map[P_VELOCITY] = newVel;
-            map[P_ARRIVED] = HasArrived();
-            map[P_TIMESTEP] = dt;
-            crowdManager_->SendEvent(E_CROWD_AGENT_REPOSITION, map);
-            if (self.Expired())
-                return;
-            node_->SendEvent(E_CROWD_AGENT_NODE_REPOSITION, map);
-            if (self.Expired())
-                return;
+                VariantMap& map = GetEventDataMap();
+                map[P_NODE] = node_;
+                map[P_CROWD_AGENT] = this;
+                map[P_POSITION] = newPos;
+                map[P_VELOCITY] = newVel;
+                map[P_ARRIVED] = HasArrived();
+                map[P_TIMESTEP] = dt;
+                crowdManager_->SendEvent(E_CROWD_AGENT_REPOSITION, map);
+                if (self.Expired())
+                    return;
+                node_->SendEvent(E_CROWD_AGENT_NODE_REPOSITION, map);
+                if (self.Expired())
+                    return;
+            }
         }
 
         // Send a notification event if we've reached the destination
@@ -79,6 +79,9 @@ class URHO3D_API CrowdAgent : public Component
     friend void CrowdAgentUpdateCallback(bool positionUpdate, dtCrowdAgent* ag, float* pos, float dt);
 
 public:
+    /// Crowd agents are updated every frame, so they are allocated from a separate arena.
+    URHO3D_SLAB_ALLOCATED_SEPARATELY
+
     /// Construct.
     explicit CrowdAgent(Context* context);
     /// Destruct.
@@ -24,6 +24,8 @@
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../Core/Thread.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../IO/Log.h"
 #include "../Navigation/CrowdAgent.h"
@@ -45,6 +47,8 @@ extern const char* NAVIGATION_CATEGORY;
 
 static const unsigned DEFAULT_MAX_AGENTS = 512;
 static const float DEFAULT_MAX_AGENT_RADIUS = 0.f;
+/// Number of agents processed at once by a worker thread in the parallel crowd update phases.
+static const unsigned CROWD_UPDATE_GRAIN_SIZE = 32;
 
 static const StringVector filterTypesStructureElementNames =
 {
@@ -78,6 +82,23 @@ void CrowdAgentUpdateCallback(bool positionUpdate, dtCrowdAgent* ag, float* pos,
         crowdAgent->OnCrowdVelocityUpdate(ag, pos, dt);
 }
 
+void CrowdParallelForCallback(void* userData, int count, dtParallelForFunc func, void* context)
+{
+    auto workQueue = static_cast<WorkQueue*>(userData);
+    // Nested parallel loops from a worker thread could deadlock waiting for the queue, so run them inline
+    if (!Thread::IsMainThread())
+    {
+        func(context, 0, count, 0);
+        return;
+    }
+
+    workQueue->ParallelFor(count, CROWD_UPDATE_GRAIN_SIZE, [func, context](unsigned begin, unsigned end, unsigned threadIndex)
+    {
+        func(context, static_cast<int>(begin), static_cast<int>(end), static_cast<int>(threadIndex));
+    });
+    workQueue->Complete(M_MAX_UNSIGNED);
+}
+
 CrowdManager::CrowdManager(Context* context) :
     Component(context),
     maxAgents_(DEFAULT_MAX_AGENTS),
@@ -102,6 +123,7 @@ void CrowdManager::RegisterObject(Context* context)
     URHO3D_ATTRIBUTE("Max Agents", unsigned, maxAgents_, DEFAULT_MAX_AGENTS, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Max Agent Radius", float, maxAgentRadius_, DEFAULT_MAX_AGENT_RADIUS, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Navigation Mesh", unsigned, navigationMeshId_, 0, AM_DEFAULT | AM_COMPONENTID);
+    URHO3D_ATTRIBUTE("Agent Reposition Events", bool, agentRepositionEvents_, true, AM_DEFAULT);
     URHO3D_MIXED_ACCESSOR_ATTRIBUTE("Filter Types", GetQueryFilterTypesAttr, SetQueryFilterTypesAttr,
         VariantVector, Variant::emptyVariantVector, AM_DEFAULT)
         .SetMetadata(AttributeMetadata::P_VECTOR_STRUCT_ELEMENTS, filterTypesStructureElementNames);
@@ -594,6 +616,14 @@ bool CrowdManager::CreateCrowd()
         return false;
     }
 
+    // Update the per-agent phases of the crowd in parallel when worker threads are available
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    if (workQueue && workQueue->GetNumThreads() > 0)
+    {
+        if (!crowd_->setParallelFor(CrowdParallelForCallback, workQueue, workQueue->GetNumThreads() + 1))
+            URHO3D_LOGWARNING("Could not initialize parallel DetourCrowd update, updating on the main thread");
+    }
+
     // Reconfigure the newly initialized crowd
     SetQueryFilterTypesAttr(queryFilterTypeConfiguration);
     SetObstacleAvoidanceTypesAttr(obstacleAvoidanceTypeConfiguration);
@@ -109,6 +109,8 @@ public:
     void SetObstacleAvoidanceTypesAttr(const VariantVector& value);
     /// Set the params for the specified obstacle avoidance type.
     void SetObstacleAvoidanceParams(unsigned obstacleAvoidanceType, const CrowdObstacleAvoidanceParams& params);
+    /// Set whether to send reposition events for each moved agent. Disabling them saves event overhead in large crowds.
+    void SetAgentRepositionEvents(bool enable) { agentRepositionEvents_ = enable; }
 
     /// Get all the crowd agent components in the specified node hierarchy. If the node is not specified then use scene node. When inCrowdFilter is set to true then only get agents that are in the crowd.
     ea::vector<CrowdAgent*> GetAgents(Node* node = nullptr, bool inCrowdFilter = true) const;
@@ -133,6 +135,9 @@ public:
     /// Get the maximum radius of any agent.
     float GetMaxAgentRadius() const { return maxAgentRadius_; }
 
+    /// Return whether reposition events are sent for each moved agent.
+    bool GetAgentRepositionEvents() const { return agentRepositionEvents_; }
+
     /// Get the Navigation mesh assigned to the crowd.
     NavigationMesh* GetNavigationMesh() const { return navigationMesh_; }
 
@@ -199,6 +204,8 @@ private:
     unsigned maxAgents_{};
     /// The maximum radius of any agent that will be added to the crowd.
     float maxAgentRadius_{};
+    /// Whether to send reposition events for each moved agent.
+    bool agentRepositionEvents_{true};
     /// Number of query filter types configured in the crowd. Limit to DT_CROWD_MAX_QUERY_FILTER_TYPE.
     unsigned numQueryFilterTypes_{};
     /// Number of configured area in each filter type. Limit to DT_MAX_AREAS.
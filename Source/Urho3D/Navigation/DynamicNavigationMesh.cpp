@@ -21,22 +21,29 @@
 //
 
 #include <EASTL/shared_array.h>
+#include <EASTL/sort.h>
 
 #include "../Precompiled.h"
 
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../Core/Thread.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/DebugRenderer.h"
+#include "../IO/File.h"
+#include "../IO/FileSystem.h"
 #include "../IO/Log.h"
 #include "../IO/MemoryBuffer.h"
 #include "../Navigation/CrowdAgent.h"
+#include "../Navigation/CrowdManager.h"
 #include "../Navigation/DynamicNavigationMesh.h"
 #include "../Navigation/NavArea.h"
 #include "../Navigation/NavBuildData.h"
 #include "../Navigation/NavigationEvents.h"
 #include "../Navigation/Obstacle.h"
 #include "../Navigation/OffMeshConnection.h"
+#include "../Resource/ResourceCache.h"
 #include "../Scene/Node.h"
 #include "../Scene/Scene.h"
 #include "../Scene/SceneEvents.h"
@@ -161,20 +168,20 @@ struct MeshProcess : public dtTileCacheMeshProcess
 
 
 // From the Detour/Recast Sample_TempObstacles.cpp
-struct LinearAllocator : public dtTileCacheAlloc
+struct TileCacheLinearAllocator : public dtTileCacheAlloc
 {
     unsigned char* buffer;
     int capacity;
     int top;
     int high;
 
-    explicit LinearAllocator(const int cap) :
+    explicit TileCacheLinearAllocator(const int cap) :
         buffer(nullptr), capacity(0), top(0), high(0)
     {
         resize(cap);
     }
 
-    ~LinearAllocator() override
+    ~TileCacheLinearAllocator() override
     {
         dtFree(buffer);
     }
@@ -217,7 +224,7 @@ DynamicNavigationMesh::DynamicNavigationMesh(Context* context) :
     // 64 is the largest tile-size that DetourTileCache will tolerate without silently failing
     tileSize_ = 64;
     partitionType_ = NAVMESH_PARTITION_MONOTONE;
-    allocator_ = ea::make_unique<LinearAllocator>(32000); //32kb to start
+    allocator_ = ea::make_unique<TileCacheLinearAllocator>(32000); //32kb to start
     compressor_ = ea::make_unique<TileCompressor>();
     meshProcessor_ = ea::make_unique<MeshProcess>(this);
 }
@@ -235,6 +242,10 @@ void DynamicNavigationMesh::RegisterObject(Context* context)
     URHO3D_ACCESSOR_ATTRIBUTE("Max Obstacles", GetMaxObstacles, SetMaxObstacles, unsigned, DEFAULT_MAX_OBSTACLES, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Max Layers", GetMaxLayers, SetMaxLayers, unsigned, DEFAULT_MAX_LAYERS, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Draw Obstacles", GetDrawObstacles, SetDrawObstacles, bool, false, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Tile Directory", GetTileDirectory, SetTileDirectory, ea::string, EMPTY_STRING, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Tile Load Distance", GetTileLoadDistance, SetTileLoadDistance, float, 100.0f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Tile Unload Distance", GetTileUnloadDistance, SetTileUnloadDistance, float, 150.0f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Max Streamed Tiles Per Frame", GetMaxStreamedTilesPerFrame, SetMaxStreamedTilesPerFrame, unsigned, 4, AM_DEFAULT);
 }
 
 bool DynamicNavigationMesh::Allocate(const BoundingBox& boundingBox, unsigned maxTiles)
@@ -314,6 +325,7 @@ bool DynamicNavigationMesh::Allocate(const BoundingBox& boundingBox, unsigned ma
     }
 
     URHO3D_LOGDEBUG("Allocated empty navigation mesh with max " + ea::to_string(maxTiles) + " tiles");
+    InitializeTileStreaming();
 
     // Scan for obstacles to insert into us
     ea::vector<Node*> obstacles;
@@ -431,32 +443,29 @@ bool DynamicNavigationMesh::Build()
         // Build each tile
         unsigned numTiles = 0;
 
-        for (int z = 0; z < numTilesZ_; ++z)
+        BuildTileLayers(geometryList, IntVector2::ZERO, GetNumTiles() - IntVector2::ONE,
+            [&](const IntVector2& tile, TileCacheData* tiles, int layerCt)
         {
-            for (int x = 0; x < numTilesX_; ++x)
+            for (int i = 0; i < layerCt; ++i)
             {
-                TileCacheData tiles[TILECACHE_MAXLAYERS];
-                int layerCt = BuildTile(geometryList, x, z, tiles);
-                for (int i = 0; i < layerCt; ++i)
+                dtCompressedTileRef tileRef;
+                int status = tileCache_->addTile(tiles[i].data, tiles[i].dataSize, DT_COMPRESSEDTILE_FREE_DATA, &tileRef);
+                if (dtStatusFailed((dtStatus)status))
                 {
-                    dtCompressedTileRef tileRef;
-                    int status = tileCache_->addTile(tiles[i].data, tiles[i].dataSize, DT_COMPRESSEDTILE_FREE_DATA, &tileRef);
-                    if (dtStatusFailed((dtStatus)status))
-                    {
-                        dtFree(tiles[i].data);
-                        tiles[i].data = nullptr;
-                    }
+                    dtFree(tiles[i].data);
+                    tiles[i].data = nullptr;
                 }
-                tileCache_->buildNavMeshTilesAt(x, z, navMesh_);
-                ++numTiles;
             }
-        }
+            tileCache_->buildNavMeshTilesAt(tile.x_, tile.y_, navMesh_);
+            ++numTiles;
+        });
 
         // For a full build it's necessary to update the nav mesh
         // not doing so will cause dependent components to crash, like CrowdManager
         tileCache_->update(0, navMesh_);
 
         URHO3D_LOGDEBUG("Built navigation mesh with " + ea::to_string(numTiles) + " tiles");
+        InitializeTileStreaming();
 
         // Send a notification event to concerned parties that we've been fully rebuilt
         {
@@ -574,6 +583,19 @@ void DynamicNavigationMesh::RemoveTile(const IntVector2& tile)
             dtFree(data);
     }
 
+    // Base class removes only the first layer of the mesh tile
+    const dtMeshTile* meshTiles[TILECACHE_MAXLAYERS];
+    const int meshTileCt = navMesh_->getTilesAt(tile.x_, tile.y_, meshTiles, maxLayers_);
+    for (int i = 0; i < meshTileCt; ++i)
+    {
+        if (meshTiles[i]->header && meshTiles[i]->header->layer != 0)
+            navMesh_->removeTile(navMesh_->getTileRef(meshTiles[i]), nullptr, nullptr);
+    }
+
+    const unsigned stateIndex = GetTileStateIndex(tile);
+    if (stateIndex != M_MAX_UNSIGNED && tileStates_[stateIndex] == TileState::Loaded)
+        tileStates_[stateIndex] = TileState::Unloaded;
+
     NavigationMesh::RemoveTile(tile);
 }
 
@@ -588,6 +610,13 @@ void DynamicNavigationMesh::RemoveAllTiles()
             tileCache_->removeTile(tileCache_->getTileRef(tile), nullptr, nullptr);
     }
 
+    for (TileState& state : tileStates_)
+    {
+        if (state == TileState::Loaded)
+            state = TileState::Unloaded;
+    }
+    loadedTiles_.clear();
+
     NavigationMesh::RemoveAllTiles();
 }
 
@@ -721,6 +750,7 @@ void DynamicNavigationMesh::SetNavigationDataAttr(const ea::vector<unsigned char
     }
 
     ReadTiles(buffer, true);
+    InitializeTileStreaming();
     // \todo Shall we send E_NAVIGATION_MESH_REBUILT here?
 }
 
@@ -739,9 +769,13 @@ ea::vector<unsigned char> DynamicNavigationMesh::GetNavigationDataAttr() const
         const dtTileCacheParams* tcParams = tileCache_->getParams();
         ret.Write(tcParams, sizeof(dtTileCacheParams));
 
-        for (int z = 0; z < numTilesZ_; ++z)
-            for (int x = 0; x < numTilesX_; ++x)
-                WriteTiles(ret, x, z);
+        // Streamed tiles are saved separately
+        if (tileDirectory_.empty())
+        {
+            for (int z = 0; z < numTilesZ_; ++z)
+                for (int x = 0; x < numTilesX_; ++x)
+                    WriteTiles(ret, x, z);
+        }
     }
     return ret.GetBuffer();
 }
@@ -753,6 +787,209 @@ void DynamicNavigationMesh::SetMaxLayers(unsigned maxLayers)
     maxLayers_ = Max(3U, Min(maxLayers, TILECACHE_MAXLAYERS));
 }
 
+void DynamicNavigationMesh::SetTileDirectory(const ea::string& directory)
+{
+    tileDirectory_ = directory.empty() ? EMPTY_STRING : AddTrailingSlash(directory);
+
+    // Tiles that were missing in the old directory may exist in the new one
+    for (TileState& state : tileStates_)
+    {
+        if (state == TileState::Missing)
+            state = TileState::Unloaded;
+    }
+}
+
+bool DynamicNavigationMesh::SaveTiles(const ea::string& directoryPath) const
+{
+    if (!tileCache_)
+    {
+        URHO3D_LOGERROR("Navigation mesh must be built before tiles can be saved");
+        return false;
+    }
+
+    auto* fileSystem = GetSubsystem<FileSystem>();
+    const ea::string directory = AddTrailingSlash(directoryPath);
+    if (!fileSystem->CreateDirsRecursive(directory))
+    {
+        URHO3D_LOGERROR("Cannot create navigation tile directory {}", directory);
+        return false;
+    }
+
+    for (int z = 0; z < numTilesZ_; ++z)
+    {
+        for (int x = 0; x < numTilesX_; ++x)
+        {
+            const IntVector2 tile{ x, z };
+            const unsigned stateIndex = GetTileStateIndex(tile);
+            const ea::string fileName = directory + GetTileFileName(tile);
+
+            // Tiles streamed out keep their files
+            if (stateIndex != M_MAX_UNSIGNED && tileStates_[stateIndex] != TileState::Loaded)
+                continue;
+
+            const ea::vector<unsigned char> tileData = GetTileData(tile);
+            if (tileData.empty())
+            {
+                if (fileSystem->FileExists(fileName))
+                    fileSystem->Delete(fileName);
+                continue;
+            }
+
+            File file(context_, fileName, FILE_WRITE);
+            if (!file.IsOpen() || file.Write(tileData.data(), tileData.size()) != tileData.size())
+            {
+                URHO3D_LOGERROR("Cannot save navigation tile {}", fileName);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void DynamicNavigationMesh::AddStreamingAnchor(Node* anchor)
+{
+    if (anchor && !streamingAnchors_.contains(WeakPtr<Node>(anchor)))
+        streamingAnchors_.emplace_back(anchor);
+}
+
+void DynamicNavigationMesh::RemoveStreamingAnchor(Node* anchor)
+{
+    streamingAnchors_.erase_first(WeakPtr<Node>(anchor));
+}
+
+void DynamicNavigationMesh::UpdateTileStreaming()
+{
+    if (tileDirectory_.empty() || !tileCache_ || !navMesh_ || !node_ || tileStates_.empty())
+        return;
+
+    URHO3D_PROFILE("UpdateNavigationTileStreaming");
+
+    // Collect positions around which tiles are streamed, in the local space of the mesh
+    ea::erase_if(streamingAnchors_, [](const WeakPtr<Node>& anchor) { return !anchor; });
+
+    const Matrix3x4 inverseTransform = node_->GetWorldTransform().Inverse();
+    ea::vector<Vector3> positions;
+    for (Node* anchor : streamingAnchors_)
+        positions.push_back(inverseTransform * anchor->GetWorldPosition());
+
+    Scene* scene = GetScene();
+    auto* crowdManager = scene ? scene->GetComponent<CrowdManager>() : nullptr;
+    if (crowdManager && crowdManager->GetNavigationMesh() == this)
+    {
+        for (CrowdAgent* agent : crowdManager->GetAgents())
+            positions.push_back(inverseTransform * agent->GetPosition());
+    }
+
+    // Unload far tiles, they are loaded from the tile directory again when needed
+    ea::erase_if(loadedTiles_, [&](const IntVector2& tile)
+    {
+        if (tileStates_[GetTileStateIndex(tile)] != TileState::Loaded)
+            return true;
+
+        const BoundingBox tileBoundingBox = GetTileBoundingBox(tile);
+        for (const Vector3& position : positions)
+        {
+            if (tileBoundingBox.DistanceToPoint(position) <= tileUnloadDistance_)
+                return false;
+        }
+
+        RemoveTile(tile);
+        return true;
+    });
+
+    // Collect close tiles to load
+    const float tileEdgeLength = static_cast<float>(tileSize_) * cellSize_;
+    const IntVector2 maxTile = GetNumTiles() - IntVector2::ONE;
+    ea::vector<ea::pair<float, IntVector2>> tilesToLoad;
+    for (const Vector3& position : positions)
+    {
+        const Vector3 offset = position - boundingBox_.min_;
+        const Vector2 offset2D{ offset.x_, offset.z_ };
+        const IntVector2 from = VectorMax(IntVector2::ZERO, VectorFloorToInt((offset2D - Vector2::ONE * tileLoadDistance_) / tileEdgeLength));
+        const IntVector2 to = VectorMin(maxTile, VectorFloorToInt((offset2D + Vector2::ONE * tileLoadDistance_) / tileEdgeLength));
+        for (int z = from.y_; z <= to.y_; ++z)
+        {
+            for (int x = from.x_; x <= to.x_; ++x)
+            {
+                const IntVector2 tile{ x, z };
+                if (tileStates_[GetTileStateIndex(tile)] != TileState::Unloaded)
+                    continue;
+
+                const float distance = GetTileBoundingBox(tile).DistanceToPoint(position);
+                if (distance <= tileLoadDistance_)
+                    tilesToLoad.emplace_back(distance, tile);
+            }
+        }
+    }
+
+    // Load the closest tiles first. Obstacles are re-applied to added tiles on E_NAVIGATION_TILE_ADDED
+    ea::sort(tilesToLoad.begin(), tilesToLoad.end(),
+        [](const ea::pair<float, IntVector2>& lhs, const ea::pair<float, IntVector2>& rhs) { return lhs.first < rhs.first; });
+
+    auto* cache = GetSubsystem<ResourceCache>();
+    unsigned tilesBudget = maxStreamedTilesPerFrame_;
+    for (const auto& distanceAndTile : tilesToLoad)
+    {
+        if (tilesBudget == 0)
+            break;
+
+        const IntVector2& tile = distanceAndTile.second;
+        TileState& state = tileStates_[GetTileStateIndex(tile)];
+        if (state != TileState::Unloaded)
+            continue;
+
+        --tilesBudget;
+
+        // Empty tiles are not saved
+        const ea::string fileName = tileDirectory_ + GetTileFileName(tile);
+        SharedPtr<File> file = cache->Exists(fileName) ? cache->GetFile(fileName) : nullptr;
+        if (!file || !ReadTiles(*file, false))
+            state = TileState::Missing;
+    }
+}
+
+ea::string DynamicNavigationMesh::GetTileFileName(const IntVector2& tile)
+{
+    return Format("{}_{}.navtile", tile.x_, tile.y_);
+}
+
+void DynamicNavigationMesh::InitializeTileStreaming()
+{
+    tileStates_.clear();
+    loadedTiles_.clear();
+    if (!tileCache_)
+        return;
+
+    tileStates_.resize(numTilesX_ * numTilesZ_, TileState::Unloaded);
+
+    dtCompressedTileRef tiles[TILECACHE_MAXLAYERS];
+    for (int z = 0; z < numTilesZ_; ++z)
+    {
+        for (int x = 0; x < numTilesX_; ++x)
+        {
+            if (tileCache_->getTilesAt(x, z, tiles, maxLayers_) > 0)
+                MarkTileLoaded(IntVector2(x, z));
+        }
+    }
+}
+
+void DynamicNavigationMesh::MarkTileLoaded(const IntVector2& tile)
+{
+    const unsigned stateIndex = GetTileStateIndex(tile);
+    if (stateIndex == M_MAX_UNSIGNED || tileStates_[stateIndex] == TileState::Loaded)
+        return;
+
+    tileStates_[stateIndex] = TileState::Loaded;
+    loadedTiles_.push_back(tile);
+}
+
+unsigned DynamicNavigationMesh::GetTileStateIndex(const IntVector2& tile) const
+{
+    if (tile.x_ < 0 || tile.y_ < 0 || tile.x_ >= numTilesX_ || tile.y_ >= numTilesZ_ || tileStates_.empty())
+        return M_MAX_UNSIGNED;
+    return static_cast<unsigned>(tile.y_ * numTilesX_ + tile.x_);
+}
+
 void DynamicNavigationMesh::WriteTiles(Serializer& dest, int x, int z) const
 {
     dtCompressedTileRef tiles[TILECACHE_MAXLAYERS];
@@ -799,7 +1036,10 @@ bool DynamicNavigationMesh::ReadTiles(Deserializer& source, bool silent)
     }
 
     for (unsigned i = 0; i < tileQueue_.size(); ++i)
+    {
         tileCache_->buildNavMeshTilesAt(tileQueue_[i].x_, tileQueue_[i].y_, navMesh_);
+        MarkTileLoaded(tileQueue_[i]);
+    }
 
     tileCache_->update(0, navMesh_);
 
@@ -825,55 +1065,41 @@ int DynamicNavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometr
 
     tileCache_->removeTile(navMesh_->getTileRefAt(x, z, 0), nullptr, nullptr);
 
-    const BoundingBox tileBoundingBox = GetTileBoundingBox(IntVector2(x, z));
-
     DynamicNavBuildData build(allocator_.get());
 
     rcConfig cfg;   // NOLINT(hicpp-member-init)
-    memset(&cfg, 0, sizeof cfg);
-    cfg.cs = cellSize_;
-    cfg.ch = cellHeight_;
-    cfg.walkableSlopeAngle = agentMaxSlope_;
-    cfg.walkableHeight = (int)ceilf(agentHeight_ / cfg.ch);
-    cfg.walkableClimb = (int)floorf(agentMaxClimb_ / cfg.ch);
-    cfg.walkableRadius = (int)ceilf(agentRadius_ / cfg.cs);
-    cfg.maxEdgeLen = (int)(edgeMaxLength_ / cellSize_);
-    cfg.maxSimplificationError = edgeMaxError_;
-    cfg.minRegionArea = (int)sqrtf(regionMinSize_);
-    cfg.mergeRegionArea = (int)sqrtf(regionMergeSize_);
-    cfg.maxVertsPerPoly = 6;
-    cfg.tileSize = tileSize_;
-    cfg.borderSize = cfg.walkableRadius + 3; // Add padding
-    cfg.width = cfg.tileSize + cfg.borderSize * 2;
-    cfg.height = cfg.tileSize + cfg.borderSize * 2;
-    cfg.detailSampleDist = detailSampleDistance_ < 0.9f ? 0.0f : cellSize_ * detailSampleDistance_;
-    cfg.detailSampleMaxError = cellHeight_ * detailSampleMaxError_;
-
-    rcVcopy(cfg.bmin, &tileBoundingBox.min_.x_);
-    rcVcopy(cfg.bmax, &tileBoundingBox.max_.x_);
-    cfg.bmin[0] -= cfg.borderSize * cfg.cs;
-    cfg.bmin[2] -= cfg.borderSize * cfg.cs;
-    cfg.bmax[0] += cfg.borderSize * cfg.cs;
-    cfg.bmax[2] += cfg.borderSize * cfg.cs;
+    GetTileConfig(cfg, IntVector2(x, z));
 
     BoundingBox expandedBox(*reinterpret_cast<Vector3*>(cfg.bmin), *reinterpret_cast<Vector3*>(cfg.bmax));
     GetTileGeometry(&build, geometryList, expandedBox);
 
+    const int layerCt = BuildTileLayers(build, cfg, IntVector2(x, z), tiles);
+    if (layerCt < 0)
+        return 0;
+
+    SendTileRebuiltEvent(IntVector2(x, z));
+    return layerCt;
+}
+
+int DynamicNavigationMesh::BuildTileLayers(DynamicNavBuildData& build, const rcConfig& cfg, const IntVector2& tile, TileCacheData* tiles) const
+{
+    URHO3D_PROFILE("BuildNavigationMeshTileLayers");
+
     if (build.vertices_.empty() || build.indices_.empty())
-        return 0; // Nothing to do
+        return -1; // Nothing to do
 
     build.heightField_ = rcAllocHeightfield();
     if (!build.heightField_)
     {
         URHO3D_LOGERROR("Could not allocate heightfield");
-        return 0;
+        return -1;
     }
 
     if (!rcCreateHeightfield(build.ctx_, *build.heightField_, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs,
         cfg.ch))
     {
         URHO3D_LOGERROR("Could not create heightfield");
-        return 0;
+        return -1;
     }
 
     unsigned numTriangles = build.indices_.size() / 3;
@@ -893,18 +1119,18 @@ int DynamicNavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometr
     if (!build.compactHeightField_)
     {
         URHO3D_LOGERROR("Could not allocate create compact heightfield");
-        return 0;
+        return -1;
     }
     if (!rcBuildCompactHeightfield(build.ctx_, cfg.walkableHeight, cfg.walkableClimb, *build.heightField_,
         *build.compactHeightField_))
     {
         URHO3D_LOGERROR("Could not build compact heightfield");
-        return 0;
+        return -1;
     }
     if (!rcErodeWalkableArea(build.ctx_, cfg.walkableRadius, *build.compactHeightField_))
     {
         URHO3D_LOGERROR("Could not erode compact heightfield");
-        return 0;
+        return -1;
     }
 
     // area volumes
@@ -917,13 +1143,13 @@ int DynamicNavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometr
         if (!rcBuildDistanceField(build.ctx_, *build.compactHeightField_))
         {
             URHO3D_LOGERROR("Could not build distance field");
-            return 0;
+            return -1;
         }
         if (!rcBuildRegions(build.ctx_, *build.compactHeightField_, cfg.borderSize, cfg.minRegionArea,
             cfg.mergeRegionArea))
         {
             URHO3D_LOGERROR("Could not build regions");
-            return 0;
+            return -1;
         }
     }
     else
@@ -931,7 +1157,7 @@ int DynamicNavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometr
         if (!rcBuildRegionsMonotone(build.ctx_, *build.compactHeightField_, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea))
         {
             URHO3D_LOGERROR("Could not build monotone regions");
-            return 0;
+            return -1;
         }
     }
 
@@ -939,14 +1165,14 @@ int DynamicNavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometr
     if (!build.heightFieldLayers_)
     {
         URHO3D_LOGERROR("Could not allocate height field layer set");
-        return 0;
+        return -1;
     }
 
     if (!rcBuildHeightfieldLayers(build.ctx_, *build.compactHeightField_, cfg.borderSize, cfg.walkableHeight,
         *build.heightFieldLayers_))
     {
         URHO3D_LOGERROR("Could not build height field layers");
-        return 0;
+        return -1;
     }
 
     int retCt = 0;
@@ -955,8 +1181,8 @@ int DynamicNavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometr
         dtTileCacheLayerHeader header;      // NOLINT(hicpp-member-init)
         header.magic = DT_TILECACHE_MAGIC;
         header.version = DT_TILECACHE_VERSION;
-        header.tx = x;
-        header.ty = z;
+        header.tx = tile.x_;
+        header.ty = tile.y_;
         header.tlayer = i;
 
         rcHeightfieldLayer* layer = &build.heightFieldLayers_->layers[i];
@@ -978,23 +1204,12 @@ int DynamicNavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometr
                 &(tiles[retCt].data), &tiles[retCt].dataSize)))
         {
             URHO3D_LOGERROR("Failed to build tile cache layers");
-            return 0;
+            return -1;
         }
         else
             ++retCt;
     }
 
-    // Send a notification of the rebuild of this tile to anyone interested
-    {
-        using namespace NavigationAreaRebuilt;
-        VariantMap& eventData = GetContext()->GetEventDataMap();
-        eventData[P_NODE] = GetNode();
-        eventData[P_MESH] = this;
-        eventData[P_BOUNDSMIN] = Variant(tileBoundingBox.min_);
-        eventData[P_BOUNDSMAX] = Variant(tileBoundingBox.max_);
-        SendEvent(E_NAVIGATION_AREA_REBUILT, eventData);
-    }
-
     return retCt;
 }
 
@@ -1014,30 +1229,112 @@ unsigned DynamicNavigationMesh::BuildTiles(ea::vector<NavigationGeometryInfo>& g
                 if (!dtStatusFailed(tileCache_->removeTile(existing[i], &data, nullptr)) && data != nullptr)
                     dtFree(data);
             }
+        }
+    }
 
-            TileCacheData tiles[TILECACHE_MAXLAYERS];
-            int layerCt = BuildTile(geometryList, x, z, tiles);
-            for (int i = 0; i < layerCt; ++i)
+    BuildTileLayers(geometryList, from, to, [&](const IntVector2& tile, TileCacheData* tiles, int layerCt)
+    {
+        if (layerCt > 0)
+            MarkTileLoaded(tile);
+
+        for (int i = 0; i < layerCt; ++i)
+        {
+            dtCompressedTileRef tileRef;
+            int status = tileCache_->addTile(tiles[i].data, tiles[i].dataSize, DT_COMPRESSEDTILE_FREE_DATA, &tileRef);
+            if (dtStatusFailed((dtStatus)status))
             {
-                dtCompressedTileRef tileRef;
-                int status = tileCache_->addTile(tiles[i].data, tiles[i].dataSize, DT_COMPRESSEDTILE_FREE_DATA, &tileRef);
-                if (dtStatusFailed((dtStatus)status))
-                {
-                    dtFree(tiles[i].data);
-                    tiles[i].data = nullptr;
-                }
-                else
-                {
-                    tileCache_->buildNavMeshTile(tileRef, navMesh_);
-                    ++numTiles;
-                }
+                dtFree(tiles[i].data);
+                tiles[i].data = nullptr;
+            }
+            else
+            {
+                tileCache_->buildNavMeshTile(tileRef, navMesh_);
+                ++numTiles;
             }
         }
-    }
+    });
 
     return numTiles;
 }
 
+template <class T>
+void DynamicNavigationMesh::BuildTileLayers(ea::vector<NavigationGeometryInfo>& geometryList, const IntVector2& from, const IntVector2& to,
+    const T& callback)
+{
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    if (!workQueue || !workQueue->GetNumThreads() || !Thread::IsMainThread() || from == to)
+    {
+        for (int z = from.y_; z <= to.y_; ++z)
+        {
+            for (int x = from.x_; x <= to.x_; ++x)
+            {
+                TileCacheData tiles[TILECACHE_MAXLAYERS];
+                const int layerCt = BuildTile(geometryList, x, z, tiles);
+                callback(IntVector2(x, z), tiles, layerCt);
+            }
+        }
+        return;
+    }
+
+    struct TileBuild
+    {
+        explicit TileBuild(dtTileCacheAlloc* allocator) : build_(allocator) {}
+
+        IntVector2 tile_;
+        rcConfig cfg_;
+        DynamicNavBuildData build_;
+        TileCacheData layers_[TILECACHE_MAXLAYERS];
+        int layerCt_{};
+    };
+
+    ea::vector<IntVector2> tiles;
+    for (int z = from.y_; z <= to.y_; ++z)
+    {
+        for (int x = from.x_; x <= to.x_; ++x)
+            tiles.emplace_back(x, z);
+    }
+
+    // Scene access and tile cache modification stay on the main thread, only Recast and compression run on the work queue.
+    // Tiles are processed in batches to bound the memory used by collected geometry
+    ea::vector<ea::unique_ptr<TileBuild>> batch;
+    for (unsigned batchStart = 0; batchStart < tiles.size(); batchStart += NAVMESH_TILE_BUILD_BATCH_SIZE)
+    {
+        URHO3D_PROFILE("BuildNavigationMeshTiles");
+
+        batch.clear();
+        const unsigned batchEnd = Min(batchStart + NAVMESH_TILE_BUILD_BATCH_SIZE, tiles.size());
+        for (unsigned i = batchStart; i < batchEnd; ++i)
+        {
+            auto tileBuild = ea::make_unique<TileBuild>(allocator_.get());
+            tileBuild->tile_ = tiles[i];
+
+            tileCache_->removeTile(navMesh_->getTileRefAt(tiles[i].x_, tiles[i].y_, 0), nullptr, nullptr);
+
+            GetTileConfig(tileBuild->cfg_, tiles[i]);
+            BoundingBox expandedBox(*reinterpret_cast<Vector3*>(tileBuild->cfg_.bmin), *reinterpret_cast<Vector3*>(tileBuild->cfg_.bmax));
+            GetTileGeometry(&tileBuild->build_, geometryList, expandedBox);
+            batch.push_back(ea::move(tileBuild));
+        }
+
+        workQueue->ParallelFor(batch.size(), 1, [this, &batch](unsigned begin, unsigned end, unsigned)
+        {
+            for (unsigned i = begin; i < end; ++i)
+            {
+                TileBuild& tileBuild = *batch[i];
+                tileBuild.layerCt_ = BuildTileLayers(tileBuild.build_, tileBuild.cfg_, tileBuild.tile_, tileBuild.layers_);
+            }
+        });
+        workQueue->Complete(M_MAX_UNSIGNED);
+
+        for (const auto& tileBuild : batch)
+        {
+            if (tileBuild->layerCt_ >= 0)
+                SendTileRebuiltEvent(tileBuild->tile_);
+            callback(tileBuild->tile_, tileBuild->layers_, Max(tileBuild->layerCt_, 0));
+        }
+    }
+}
+
 ea::vector<OffMeshConnection*> DynamicNavigationMesh::CollectOffMeshConnections(const BoundingBox& bounds)
 {
     ea::vector<OffMeshConnection*> connections;
@@ -1066,6 +1363,8 @@ void DynamicNavigationMesh::ReleaseTileCache()
 {
     dtFreeTileCache(tileCache_);
     tileCache_ = nullptr;
+    tileStates_.clear();
+    loadedTiles_.clear();
 }
 
 void DynamicNavigationMesh::OnSceneSet(Scene* scene)
@@ -1157,7 +1456,10 @@ void DynamicNavigationMesh::HandleSceneSubsystemUpdate(StringHash eventType, Var
     using namespace SceneSubsystemUpdate;
 
     if (tileCache_ && navMesh_ && IsEnabledEffective())
+    {
+        UpdateTileStreaming();
         tileCache_->update(eventData[P_TIMESTEP].GetFloat(), navMesh_);
+    }
 }
 
 }
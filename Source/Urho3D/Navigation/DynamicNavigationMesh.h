@@ -40,6 +40,8 @@ namespace Urho3D
 class OffMeshConnection;
 class Obstacle;
 
+struct DynamicNavBuildData;
+
 class URHO3D_API DynamicNavigationMesh : public NavigationMesh
 {
     URHO3D_OBJECT(DynamicNavigationMesh, NavigationMesh)
@@ -64,6 +66,10 @@ public:
     bool Build(const BoundingBox& boundingBox) override;
     /// Rebuild part of the navigation mesh in the rectangular area. Return true if successful.
     bool Build(const IntVector2& from, const IntVector2& to) override;
+    /// Rebuild part of the navigation mesh contained by the world-space bounding box immediately, as tile cache rebuilds are not queued in the background.
+    void BuildAsync(const BoundingBox& boundingBox) override { Build(boundingBox); }
+    /// Rebuild part of the navigation mesh in the rectangular area immediately, as tile cache rebuilds are not queued in the background.
+    void BuildAsync(const IntVector2& from, const IntVector2& to) override { Build(from, to); }
     /// Return tile data.
     ea::vector<unsigned char> GetTileData(const IntVector2& tile) const override;
     /// Return whether the Obstacle is touching the given tile.
@@ -100,6 +106,36 @@ public:
     /// Return whether to draw Obstacles.
     bool GetDrawObstacles() const { return drawObstacles_; }
 
+    /// Set resource directory of separately saved tiles. When set, tiles are streamed in and out around streaming anchors and crowd agents, and the navigation data attribute doesn't contain tiles.
+    void SetTileDirectory(const ea::string& directory);
+    /// Save each tile in memory to a separate file in the file system directory. Files of empty tiles are removed. Return true if successful.
+    bool SaveTiles(const ea::string& directoryPath) const;
+    /// Add streaming anchor. Tiles are streamed around anchors and agents of the crowd manager using this mesh.
+    void AddStreamingAnchor(Node* anchor);
+    /// Remove streaming anchor.
+    void RemoveStreamingAnchor(Node* anchor);
+    /// Set distance from anchors to tile at which tile is loaded.
+    void SetTileLoadDistance(float distance) { tileLoadDistance_ = Max(distance, 0.0f); }
+    /// Set distance from anchors to tile at which tile is unloaded. Should be greater than load distance.
+    void SetTileUnloadDistance(float distance) { tileUnloadDistance_ = Max(distance, 0.0f); }
+    /// Set max number of tiles loaded per frame.
+    void SetMaxStreamedTilesPerFrame(unsigned count) { maxStreamedTilesPerFrame_ = count; }
+    /// Load and unload tiles from the tile directory. Called automatically on scene subsystem update.
+    void UpdateTileStreaming();
+
+    /// Return resource directory of separately saved tiles.
+    const ea::string& GetTileDirectory() const { return tileDirectory_; }
+    /// Return tile load distance.
+    float GetTileLoadDistance() const { return tileLoadDistance_; }
+    /// Return tile unload distance.
+    float GetTileUnloadDistance() const { return tileUnloadDistance_; }
+    /// Return max number of tiles loaded per frame.
+    unsigned GetMaxStreamedTilesPerFrame() const { return maxStreamedTilesPerFrame_; }
+    /// Return number of tiles in memory.
+    unsigned GetNumLoadedTiles() const { return loadedTiles_.size(); }
+    /// Return name of the tile file within tile directory.
+    static ea::string GetTileFileName(const IntVector2& tile);
+
 protected:
     struct TileCacheData;
 
@@ -117,6 +153,10 @@ protected:
 
     /// Build one tile of the navigation mesh. Return true if successful.
     int BuildTile(ea::vector<NavigationGeometryInfo>& geometryList, int x, int z, TileCacheData* tiles);
+    /// Build tile cache layers of one tile from collected geometry. Does not access the scene or the tile cache, so is safe to call from worker threads. Return number of layers, or -1 if there is nothing to build or on error.
+    int BuildTileLayers(DynamicNavBuildData& build, const rcConfig& cfg, const IntVector2& tile, TileCacheData* tiles) const;
+    /// Build tile cache layers of tiles in the rectangular area, running Recast on the work queue when it has worker threads. The callback is called on the calling thread with each tile, its layers and layer count.
+    template <class T> void BuildTileLayers(ea::vector<NavigationGeometryInfo>& geometryList, const IntVector2& from, const IntVector2& to, const T& callback);
     /// Build tiles in the rectangular area. Return number of built tiles.
     unsigned BuildTiles(ea::vector<NavigationGeometryInfo>& geometryList, const IntVector2& from, const IntVector2& to);
     /// Off-mesh connections to be rebuilt in the mesh processor.
@@ -131,6 +171,20 @@ private:
     bool ReadTiles(Deserializer& source, bool silent);
     /// Free the tile cache.
     void ReleaseTileCache();
+    /// Reset streaming state of all tiles from the tile cache contents.
+    void InitializeTileStreaming();
+    /// Mark tile as present in memory.
+    void MarkTileLoaded(const IntVector2& tile);
+    /// Return index of tile streaming state, or M_MAX_UNSIGNED if the tile is outside of the mesh.
+    unsigned GetTileStateIndex(const IntVector2& tile) const;
+
+    /// Streaming state of tile.
+    enum class TileState : unsigned char
+    {
+        Unloaded,
+        Loaded,
+        Missing
+    };
 
     /// Detour tile cache instance that works with the nav mesh.
     dtTileCache* tileCache_{};
@@ -148,6 +202,21 @@ private:
     bool drawObstacles_{};
     /// Queue of tiles to be built.
     ea::vector<IntVector2> tileQueue_;
+
+    /// Resource directory of separately saved tiles, with trailing slash.
+    ea::string tileDirectory_;
+    /// Nodes around which tiles are streamed.
+    ea::vector<WeakPtr<Node>> streamingAnchors_;
+    /// Tile load distance.
+    float tileLoadDistance_{ 100.0f };
+    /// Tile unload distance.
+    float tileUnloadDistance_{ 150.0f };
+    /// Max number of tiles loaded per frame.
+    unsigned maxStreamedTilesPerFrame_{ 4 };
+    /// Streaming states of all tiles.
+    ea::vector<TileState> tileStates_;
+    /// Tiles in memory.
+    ea::vector<IntVector2> loadedTiles_;
 };
 
 }
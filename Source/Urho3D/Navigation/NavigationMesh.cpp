@@ -23,7 +23,11 @@
 #include "../Precompiled.h"
 
 #include "../Core/Context.h"
+#include "../Core/MemoryTracker.h"
 #include "../Core/Profiler.h"
+#include "../Core/Thread.h"
+#include "../Core/Timer.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/Drawable.h"
 #include "../Graphics/Geometry.h"
@@ -46,6 +50,7 @@
 #include "../Physics/CollisionShape.h"
 #endif
 #include "../Scene/Scene.h"
+#include "../Scene/SceneEvents.h"
 
 #include <cfloat>
 #include <Detour/DetourNavMesh.h>
@@ -83,6 +88,30 @@ static const float DEFAULT_DETAIL_SAMPLE_MAX_ERROR = 1.0f;
 
 static const int MAX_POLYS = 2048;
 
+/// Tile of the navigation mesh being rebuilt in the background.
+struct NavigationMesh::AsyncTileBuild
+{
+    /// Free tile data that was not swapped in.
+    ~AsyncTileBuild() { dtFree(navData_); }
+
+    /// Navigation mesh.
+    const NavigationMesh* mesh_{};
+    /// Tile index.
+    IntVector2 tile_;
+    /// Recast configuration.
+    rcConfig cfg_;
+    /// Build data with the collected geometry.
+    SimpleNavBuildData build_;
+    /// Built Detour tile data.
+    unsigned char* navData_{};
+    /// Built Detour tile data size.
+    int navDataSize_{};
+    /// Whether the build was successful.
+    bool success_{};
+    /// Work item of the build.
+    SharedPtr<WorkItem> item_;
+};
+
 
 /// Temporary data for finding a path.
 struct FindPathData
@@ -97,6 +126,51 @@ struct FindPathData
     unsigned char pathFlags_[MAX_POLYS]{};
 };
 
+/// Asynchronous path request.
+struct NavigationMesh::PathRequest
+{
+    /// Request ID.
+    unsigned id_{};
+    /// Start point in navigation mesh space.
+    Vector3 localStart_;
+    /// End point in navigation mesh space.
+    Vector3 localEnd_;
+    /// How far off the navigation mesh the points can be.
+    Vector3 extents_;
+    /// Navigation mesh world transform at the time of the request.
+    Matrix3x4 transform_;
+    /// World space path points.
+    ea::vector<Vector3> path_;
+    /// Status.
+    PathRequestStatus status_{PATH_REQUEST_PENDING};
+    /// Whether the request was cancelled while assigned to a query slot.
+    bool cancelled_{};
+};
+
+/// Detour query with a sequence of path requests, processed by one thread at a time.
+struct NavigationMesh::PathQuerySlot
+{
+    /// Free the query.
+    ~PathQuerySlot() { dtFreeNavMeshQuery(query_); }
+
+    /// Detour query.
+    dtNavMeshQuery* query_{};
+    /// Assigned path requests.
+    ea::vector<PathRequest*> requests_;
+    /// Number of finished requests at the beginning of the assigned requests.
+    unsigned numProcessed_{};
+    /// Whether the sliced search of the first unfinished request is in progress.
+    bool sliced_{};
+    /// Start polygon of the first unfinished request.
+    dtPolyRef startRef_{};
+    /// End polygon of the first unfinished request.
+    dtPolyRef endRef_{};
+    /// Temporary data for finding a path.
+    FindPathData pathData_;
+    /// Polygon corridors to add to the cache.
+    ea::vector<ea::pair<ea::pair<dtPolyRef, dtPolyRef>, ea::vector<dtPolyRef>>> newCacheEntries_;
+};
+
 NavigationMesh::NavigationMesh(Context* context) :
     Component(context),
     navMesh_(nullptr),
@@ -129,6 +203,7 @@ NavigationMesh::NavigationMesh(Context* context) :
 NavigationMesh::~NavigationMesh()
 {
     ReleaseNavigationMesh();
+    CancelAsyncBuild();
 }
 
 void NavigationMesh::RegisterObject(Context* context)
@@ -384,8 +459,10 @@ bool NavigationMesh::Allocate(const BoundingBox& boundingBox, unsigned maxTiles)
 bool NavigationMesh::Build()
 {
     URHO3D_PROFILE("BuildNavigationMesh");
+    MemoryTagScope memoryTag(MEMORY_TAG_NAVIGATION);
 
     // Release existing navigation data and zero the bounding box
+    CancelAsyncBuild();
     ReleaseNavigationMesh();
 
     if (!node_)
@@ -521,6 +598,193 @@ bool NavigationMesh::Build(const IntVector2& from, const IntVector2& to)
     return true;
 }
 
+void NavigationMesh::BuildAsync(const BoundingBox& boundingBox)
+{
+    if (!node_ || !navMesh_)
+    {
+        URHO3D_LOGERROR("Navigation mesh must first be built fully before it can be partially rebuilt");
+        return;
+    }
+
+    BoundingBox localSpaceBox = boundingBox.Transformed(node_->GetWorldTransform().Inverse());
+
+    float tileEdgeLength = (float)tileSize_ * cellSize_;
+
+    int sx = Clamp((int)((localSpaceBox.min_.x_ - boundingBox_.min_.x_) / tileEdgeLength), 0, numTilesX_ - 1);
+    int sz = Clamp((int)((localSpaceBox.min_.z_ - boundingBox_.min_.z_) / tileEdgeLength), 0, numTilesZ_ - 1);
+    int ex = Clamp((int)((localSpaceBox.max_.x_ - boundingBox_.min_.x_) / tileEdgeLength), 0, numTilesX_ - 1);
+    int ez = Clamp((int)((localSpaceBox.max_.z_ - boundingBox_.min_.z_) / tileEdgeLength), 0, numTilesZ_ - 1);
+
+    BuildAsync(IntVector2(sx, sz), IntVector2(ex, ez));
+}
+
+void NavigationMesh::BuildAsync(const IntVector2& from, const IntVector2& to)
+{
+    if (!node_ || !navMesh_)
+    {
+        URHO3D_LOGERROR("Navigation mesh must first be built fully before it can be partially rebuilt");
+        return;
+    }
+
+    // Tiles that are already being built are queued again, as their geometry snapshot is outdated
+    for (int z = from.y_; z <= to.y_; ++z)
+    {
+        for (int x = from.x_; x <= to.x_; ++x)
+        {
+            const IntVector2 tile(x, z);
+            if (!asyncTileQueue_.contains(tile))
+                asyncTileQueue_.push_back(tile);
+        }
+    }
+
+    if (Scene* scene = GetScene())
+    {
+        if (!HasSubscribedToEvent(scene, E_SCENEPOSTUPDATE))
+            SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(NavigationMesh, HandleAsyncBuildUpdate));
+        StartAsyncTileBuilds();
+    }
+    else
+        CompleteAsyncBuild();
+}
+
+void NavigationMesh::CompleteAsyncBuild()
+{
+    URHO3D_PROFILE("CompleteAsyncNavigationMeshBuild");
+
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    while (!asyncTileQueue_.empty() || !asyncTileBuilds_.empty())
+    {
+        StartAsyncTileBuilds();
+
+        // Take the builds out before swapping the tiles in, as tile rebuilt event handlers may queue or cancel builds
+        ea::vector<ea::unique_ptr<AsyncTileBuild>> tileBuilds = ea::move(asyncTileBuilds_);
+        asyncTileBuilds_.clear();
+
+        for (const auto& tileBuild : tileBuilds)
+        {
+            // If the build has not been started yet, it is run here
+            WorkItem* item = tileBuild->item_;
+            if (workQueue)
+                workQueue->CompleteItem(item);
+            else
+                item->workFunction_(item, 0);
+        }
+
+        for (const auto& tileBuild : tileBuilds)
+            FinishAsyncTileBuild(*tileBuild);
+
+        // The mesh may have been released by event handlers
+        if (!navMesh_)
+            CancelAsyncBuild();
+    }
+
+    UnsubscribeFromEvent(E_SCENEPOSTUPDATE);
+}
+
+void NavigationMesh::CancelAsyncBuild()
+{
+    asyncTileQueue_.clear();
+
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    for (const auto& tileBuild : asyncTileBuilds_)
+    {
+        // Wait for the builds that have already been started
+        if (workQueue && !workQueue->RemoveWorkItem(tileBuild->item_))
+            workQueue->CompleteItem(tileBuild->item_);
+    }
+    asyncTileBuilds_.clear();
+
+    UnsubscribeFromEvent(E_SCENEPOSTUPDATE);
+}
+
+void NavigationMesh::StartAsyncTileBuilds()
+{
+    if (asyncTileQueue_.empty() || asyncTileBuilds_.size() >= NAVMESH_TILE_BUILD_BATCH_SIZE || !navMesh_)
+        return;
+
+    URHO3D_PROFILE("StartAsyncNavigationMeshBuild");
+
+    ea::vector<NavigationGeometryInfo> geometryList;
+    CollectGeometries(geometryList);
+
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    const unsigned numStarted = Min(asyncTileQueue_.size(), NAVMESH_TILE_BUILD_BATCH_SIZE - asyncTileBuilds_.size());
+    for (unsigned i = 0; i < numStarted; ++i)
+    {
+        auto tileBuild = ea::make_unique<AsyncTileBuild>();
+        tileBuild->mesh_ = this;
+        tileBuild->tile_ = asyncTileQueue_[i];
+
+        GetTileConfig(tileBuild->cfg_, tileBuild->tile_);
+        BoundingBox expandedBox(*reinterpret_cast<Vector3*>(tileBuild->cfg_.bmin), *reinterpret_cast<Vector3*>(tileBuild->cfg_.bmax));
+        GetTileGeometry(&tileBuild->build_, geometryList, expandedBox);
+
+        // Use a private item, so that a pooled item can not be recycled before the build is waited for
+        tileBuild->item_ = MakeShared<WorkItem>();
+        tileBuild->item_->aux_ = tileBuild.get();
+        tileBuild->item_->priority_ = 0;
+        tileBuild->item_->workFunction_ = [](const WorkItem* item, unsigned)
+        {
+            auto* build = static_cast<AsyncTileBuild*>(item->aux_);
+            build->success_ = build->mesh_->BuildTileMesh(build->build_, build->cfg_, build->tile_, build->navData_, build->navDataSize_);
+        };
+
+        if (workQueue)
+            workQueue->AddWorkItem(tileBuild->item_);
+        asyncTileBuilds_.push_back(ea::move(tileBuild));
+    }
+
+    asyncTileQueue_.erase(asyncTileQueue_.begin(), asyncTileQueue_.begin() + numStarted);
+}
+
+void NavigationMesh::FinishAsyncTileBuild(AsyncTileBuild& tileBuild)
+{
+    // Keep the old tile if the build failed
+    if (!tileBuild.success_ || !navMesh_)
+        return;
+
+    navMesh_->removeTile(navMesh_->getTileRefAt(tileBuild.tile_.x_, tileBuild.tile_.y_, 0), nullptr, nullptr);
+
+    if (tileBuild.navData_)
+    {
+        AddTileMesh(tileBuild.tile_, tileBuild.navData_, tileBuild.navDataSize_);
+        tileBuild.navData_ = nullptr;
+    }
+}
+
+void NavigationMesh::HandleAsyncBuildUpdate(StringHash /*eventType*/, VariantMap& /*eventData*/)
+{
+    URHO3D_PROFILE("UpdateAsyncNavigationMeshBuild");
+
+    if (!navMesh_)
+    {
+        CancelAsyncBuild();
+        return;
+    }
+
+    // Swap in finished tiles in the order they were queued, so that a newer build of the same tile wins
+    HiresTimer timer;
+    const long long budgetUSec = static_cast<long long>(asyncBuildTimeBudget_ * 1000.0f);
+    unsigned numFinished = 0;
+    while (!asyncTileBuilds_.empty() && asyncTileBuilds_.front()->item_->completed_)
+    {
+        if (numFinished && timer.GetUSec(false) >= budgetUSec)
+            break;
+
+        // Take the build out before swapping the tile in, as tile rebuilt event handlers may queue or cancel builds
+        ea::unique_ptr<AsyncTileBuild> tileBuild = ea::move(asyncTileBuilds_.front());
+        asyncTileBuilds_.erase(asyncTileBuilds_.begin());
+
+        FinishAsyncTileBuild(*tileBuild);
+        ++numFinished;
+    }
+
+    StartAsyncTileBuilds();
+
+    if (asyncTileQueue_.empty() && asyncTileBuilds_.empty())
+        UnsubscribeFromEvent(E_SCENEPOSTUPDATE);
+}
+
 ea::vector<unsigned char> NavigationMesh::GetTileData(const IntVector2& tile) const
 {
     VectorBuffer ret;
@@ -661,6 +925,319 @@ void NavigationMesh::FindPath(ea::vector<Vector3>& dest, const Vector3& start, c
         dest.push_back(navPathPoints[i].position_);
 }
 
+unsigned NavigationMesh::RequestPath(const Vector3& start, const Vector3& end, const Vector3& extents)
+{
+    Scene* scene = GetScene();
+    if (!navMesh_ || !scene)
+        return 0;
+
+    // Skip IDs of requests that are still alive after the counter wraps around
+    auto request = ea::make_unique<PathRequest>();
+    do
+    {
+        request->id_ = nextPathRequestId_++;
+        if (!nextPathRequestId_)
+            nextPathRequestId_ = 1;
+    } while (!request->id_ || pathRequests_.contains(request->id_));
+
+    // Navigation data is in local space. Transform path points from world to local
+    request->transform_ = node_->GetWorldTransform();
+    const Matrix3x4 inverse = request->transform_.Inverse();
+    request->localStart_ = inverse * start;
+    request->localEnd_ = inverse * end;
+    request->extents_ = extents;
+
+    const unsigned id = request->id_;
+    pendingPathRequests_.push_back(request.get());
+    pathRequests_[id] = ea::move(request);
+
+    if (!HasSubscribedToEvent(scene, E_SCENEUPDATE))
+        SubscribeToEvent(scene, E_SCENEUPDATE, URHO3D_HANDLER(NavigationMesh, HandlePathRequestUpdate));
+
+    return id;
+}
+
+PathRequestStatus NavigationMesh::GetPathRequestStatus(unsigned id) const
+{
+    const auto iter = pathRequests_.find(id);
+    return iter != pathRequests_.end() ? iter->second->status_ : PATH_REQUEST_INVALID;
+}
+
+bool NavigationMesh::TakePathRequestResult(unsigned id, ea::vector<Vector3>& dest)
+{
+    dest.clear();
+
+    const auto iter = pathRequests_.find(id);
+    if (iter == pathRequests_.end() || iter->second->status_ == PATH_REQUEST_PENDING)
+        return false;
+
+    const bool succeeded = iter->second->status_ == PATH_REQUEST_SUCCEEDED;
+    dest = ea::move(iter->second->path_);
+    pathRequests_.erase(iter);
+    return succeeded;
+}
+
+void NavigationMesh::CancelPathRequest(unsigned id)
+{
+    const auto iter = pathRequests_.find(id);
+    if (iter == pathRequests_.end())
+        return;
+
+    PathRequest* request = iter->second.get();
+    if (request->status_ != PATH_REQUEST_PENDING)
+        pathRequests_.erase(iter);
+    else if (pendingPathRequests_.contains(request))
+    {
+        pendingPathRequests_.erase_first(request);
+        pathRequests_.erase(iter);
+    }
+    else
+    {
+        // Assigned to a query slot, which forgets it on the next update
+        request->cancelled_ = true;
+    }
+}
+
+void NavigationMesh::SetPathCacheSize(unsigned size)
+{
+    pathCacheSize_ = size;
+    while (pathCache_.size() > pathCacheSize_)
+    {
+        pathCache_.erase(pathCacheOrder_.front());
+        pathCacheOrder_.erase(pathCacheOrder_.begin());
+    }
+}
+
+void NavigationMesh::ClearPathCache()
+{
+    pathCache_.clear();
+    pathCacheOrder_.clear();
+}
+
+void NavigationMesh::ProcessPathRequests(PathQuerySlot& slot, unsigned nodeBudget) const
+{
+    URHO3D_PROFILE("ProcessPathRequests");
+
+    dtNavMeshQuery* query = slot.query_;
+    FindPathData& data = slot.pathData_;
+    const dtQueryFilter* filter = queryFilter_.get();
+
+    const auto finishRequest = [&](PathRequest& request, int numPolys)
+    {
+        ++slot.numProcessed_;
+        slot.sliced_ = false;
+        if (!numPolys)
+        {
+            request.status_ = PATH_REQUEST_FAILED;
+            return;
+        }
+
+        // If full path was not found, clamp end point to the end polygon
+        Vector3 actualLocalEnd = request.localEnd_;
+        if (data.polys_[numPolys - 1] != slot.endRef_)
+            query->closestPointOnPoly(data.polys_[numPolys - 1], &request.localEnd_.x_, &actualLocalEnd.x_, nullptr);
+
+        int numPathPoints = 0;
+        query->findStraightPath(&request.localStart_.x_, &actualLocalEnd.x_, data.polys_, numPolys,
+            &data.pathPoints_[0].x_, data.pathFlags_, data.pathPolys_, &numPathPoints, MAX_POLYS);
+
+        // Transform path result back to world space
+        request.path_.resize(numPathPoints);
+        for (int i = 0; i < numPathPoints; ++i)
+            request.path_[i] = request.transform_ * data.pathPoints_[i];
+        request.status_ = numPathPoints ? PATH_REQUEST_SUCCEEDED : PATH_REQUEST_FAILED;
+    };
+
+    int budget = static_cast<int>(nodeBudget);
+    while (slot.numProcessed_ < slot.requests_.size() && budget > 0)
+    {
+        PathRequest& request = *slot.requests_[slot.numProcessed_];
+        if (request.cancelled_)
+        {
+            ++slot.numProcessed_;
+            slot.sliced_ = false;
+            continue;
+        }
+
+        if (!slot.sliced_)
+        {
+            // Count each request against the budget, so that cache hits are bounded too
+            --budget;
+
+            slot.startRef_ = 0;
+            slot.endRef_ = 0;
+            query->findNearestPoly(&request.localStart_.x_, &request.extents_.x_, filter, &slot.startRef_, nullptr);
+            query->findNearestPoly(&request.localEnd_.x_, &request.extents_.x_, filter, &slot.endRef_, nullptr);
+            if (!slot.startRef_ || !slot.endRef_)
+            {
+                finishRequest(request, 0);
+                continue;
+            }
+
+            // Reuse the cached corridor if none of its polygons were removed since
+            const auto cached = pathCache_.find(ea::make_pair(slot.startRef_, slot.endRef_));
+            if (cached != pathCache_.end())
+            {
+                const ea::vector<dtPolyRef>& polys = cached->second;
+                const bool valid = ea::all_of(polys.begin(), polys.end(), [this](dtPolyRef ref) { return navMesh_->isValidPolyRef(ref); });
+                if (valid)
+                {
+                    ea::copy(polys.begin(), polys.end(), data.polys_);
+                    finishRequest(request, polys.size());
+                    continue;
+                }
+            }
+
+            query->initSlicedFindPath(slot.startRef_, slot.endRef_, &request.localStart_.x_, &request.localEnd_.x_, filter);
+            slot.sliced_ = true;
+        }
+
+        int numIterations = 0;
+        const dtStatus status = query->updateSlicedFindPath(budget, &numIterations);
+        budget -= Max(numIterations, 1);
+        if (dtStatusInProgress(status))
+            break;
+
+        int numPolys = 0;
+        query->finalizeSlicedFindPath(data.polys_, &numPolys, MAX_POLYS);
+        if (pathCacheSize_ && numPolys && data.polys_[numPolys - 1] == slot.endRef_)
+        {
+            slot.newCacheEntries_.emplace_back(ea::make_pair(slot.startRef_, slot.endRef_),
+                ea::vector<dtPolyRef>(data.polys_, data.polys_ + numPolys));
+        }
+        finishRequest(request, numPolys);
+    }
+}
+
+void NavigationMesh::HandlePathRequestUpdate(StringHash /*eventType*/, VariantMap& /*eventData*/)
+{
+    URHO3D_PROFILE("UpdatePathRequests");
+
+    const auto failRequests = [this](ea::span<PathRequest* const> requests)
+    {
+        for (PathRequest* request : requests)
+        {
+            if (request->cancelled_)
+                pathRequests_.erase(request->id_);
+            else
+                request->status_ = PATH_REQUEST_FAILED;
+        }
+    };
+
+    const auto failAllRequests = [&]()
+    {
+        failRequests(pendingPathRequests_);
+        pendingPathRequests_.clear();
+        for (const auto& slot : pathQuerySlots_)
+        {
+            failRequests(ea::span<PathRequest* const>(slot->requests_).subspan(slot->numProcessed_));
+            slot->requests_.clear();
+            slot->numProcessed_ = 0;
+            slot->sliced_ = false;
+        }
+        UnsubscribeFromEvent(E_SCENEUPDATE);
+    };
+
+    // Requests can not be processed without the navigation mesh
+    if (!navMesh_)
+    {
+        failAllRequests();
+        return;
+    }
+
+    // Restart searches and drop cached corridors when the navigation mesh is recreated
+    if (pathQueryNavMesh_ != navMesh_)
+    {
+        ClearPathCache();
+        for (const auto& slot : pathQuerySlots_)
+        {
+            slot->query_->init(navMesh_, MAX_POLYS);
+            slot->sliced_ = false;
+        }
+        pathQueryNavMesh_ = navMesh_;
+    }
+
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    const unsigned numSlots = (workQueue ? workQueue->GetNumThreads() : 0) + 1;
+    while (pathQuerySlots_.size() < numSlots)
+    {
+        auto slot = ea::make_unique<PathQuerySlot>();
+        slot->query_ = dtAllocNavMeshQuery();
+        if (!slot->query_ || dtStatusFailed(slot->query_->init(navMesh_, MAX_POLYS)))
+        {
+            URHO3D_LOGERROR("Could not create navigation mesh query");
+            failAllRequests();
+            return;
+        }
+        pathQuerySlots_.push_back(ea::move(slot));
+    }
+
+    // Assign new requests to the least loaded slots
+    for (PathRequest* request : pendingPathRequests_)
+    {
+        PathQuerySlot* bestSlot = nullptr;
+        for (const auto& slot : pathQuerySlots_)
+        {
+            if (!bestSlot || slot->requests_.size() - slot->numProcessed_ < bestSlot->requests_.size() - bestSlot->numProcessed_)
+                bestSlot = slot.get();
+        }
+        bestSlot->requests_.push_back(request);
+    }
+    pendingPathRequests_.clear();
+
+    unsigned numBusySlots = 0;
+    for (const auto& slot : pathQuerySlots_)
+    {
+        if (slot->numProcessed_ < slot->requests_.size())
+            ++numBusySlots;
+    }
+
+    if (numBusySlots)
+    {
+        const unsigned slotBudget = Max(pathNodeBudget_ / numBusySlots, 1u);
+        if (workQueue && numBusySlots > 1)
+        {
+            workQueue->ParallelFor(pathQuerySlots_.size(), 1, [this, slotBudget](unsigned begin, unsigned end, unsigned)
+            {
+                for (unsigned i = begin; i < end; ++i)
+                    ProcessPathRequests(*pathQuerySlots_[i], slotBudget);
+            });
+            workQueue->Complete(M_MAX_UNSIGNED);
+        }
+        else
+        {
+            for (const auto& slot : pathQuerySlots_)
+                ProcessPathRequests(*slot, slotBudget);
+        }
+    }
+
+    // Publish results, forget cancelled requests and cache the found corridors
+    bool anyPending = false;
+    for (const auto& slot : pathQuerySlots_)
+    {
+        for (unsigned i = 0; i < slot->numProcessed_; ++i)
+        {
+            if (slot->requests_[i]->cancelled_)
+                pathRequests_.erase(slot->requests_[i]->id_);
+        }
+        slot->requests_.erase(slot->requests_.begin(), slot->requests_.begin() + slot->numProcessed_);
+        slot->numProcessed_ = 0;
+        anyPending |= !slot->requests_.empty();
+
+        for (auto& [key, polys] : slot->newCacheEntries_)
+        {
+            if (!pathCache_.contains(key))
+                pathCacheOrder_.push_back(key);
+            pathCache_[key] = ea::move(polys);
+        }
+        slot->newCacheEntries_.clear();
+    }
+    SetPathCacheSize(pathCacheSize_);
+
+    if (!anyPending)
+        UnsubscribeFromEvent(E_SCENEUPDATE);
+}
+
 void NavigationMesh::FindPath(ea::vector<NavigationPathPoint>& dest, const Vector3& start, const Vector3& end,
     const Vector3& extents, const dtQueryFilter* filter)
 {
@@ -1306,11 +1883,26 @@ bool NavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometryList,
     // Remove previous tile (if any)
     navMesh_->removeTile(navMesh_->getTileRefAt(x, z, 0), nullptr, nullptr);
 
-    const BoundingBox tileBoundingBox = GetTileBoundingBox(IntVector2(x, z));
-
     SimpleNavBuildData build;
 
     rcConfig cfg;       // NOLINT(hicpp-member-init)
+    GetTileConfig(cfg, IntVector2(x, z));
+
+    BoundingBox expandedBox(*reinterpret_cast<Vector3*>(cfg.bmin), *reinterpret_cast<Vector3*>(cfg.bmax));
+    GetTileGeometry(&build, geometryList, expandedBox);
+
+    unsigned char* navData = nullptr;
+    int navDataSize = 0;
+    if (!BuildTileMesh(build, cfg, IntVector2(x, z), navData, navDataSize))
+        return false;
+
+    return !navData || AddTileMesh(IntVector2(x, z), navData, navDataSize);
+}
+
+void NavigationMesh::GetTileConfig(rcConfig& cfg, const IntVector2& tile) const
+{
+    const BoundingBox tileBoundingBox = GetTileBoundingBox(tile);
+
     memset(&cfg, 0, sizeof cfg);
     cfg.cs = cellSize_;
     cfg.ch = cellHeight_;
@@ -1336,9 +1928,12 @@ bool NavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometryList,
     cfg.bmin[2] -= cfg.borderSize * cfg.cs;
     cfg.bmax[0] += cfg.borderSize * cfg.cs;
     cfg.bmax[2] += cfg.borderSize * cfg.cs;
+}
 
-    BoundingBox expandedBox(*reinterpret_cast<Vector3*>(cfg.bmin), *reinterpret_cast<Vector3*>(cfg.bmax));
-    GetTileGeometry(&build, geometryList, expandedBox);
+bool NavigationMesh::BuildTileMesh(SimpleNavBuildData& build, const rcConfig& cfg, const IntVector2& tile,
+    unsigned char*& navData, int& navDataSize) const
+{
+    URHO3D_PROFILE("BuildNavigationMeshTileData");
 
     if (build.vertices_.empty() || build.indices_.empty())
         return true; // Nothing to do
@@ -1462,9 +2057,6 @@ bool NavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometryList,
             build.polyMesh_->flags[i] = 0x1;
     }
 
-    unsigned char* navData = nullptr;
-    int navDataSize = 0;
-
     dtNavMeshCreateParams params;       // NOLINT(hicpp-member-init)
     memset(&params, 0, sizeof params);
     params.verts = build.polyMesh_->verts;
@@ -1482,8 +2074,8 @@ bool NavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometryList,
     params.walkableHeight = agentHeight_;
     params.walkableRadius = agentRadius_;
     params.walkableClimb = agentMaxClimb_;
-    params.tileX = x;
-    params.tileY = z;
+    params.tileX = tile.x_;
+    params.tileY = tile.y_;
     rcVcopy(params.bmin, build.polyMesh_->bmin);
     rcVcopy(params.bmax, build.polyMesh_->bmax);
     params.cs = cfg.cs;
@@ -1507,6 +2099,11 @@ bool NavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometryList,
         return false;
     }
 
+    return true;
+}
+
+bool NavigationMesh::AddTileMesh(const IntVector2& tile, unsigned char* navData, int navDataSize)
+{
     if (dtStatusFailed(navMesh_->addTile(navData, navDataSize, DT_TILE_FREE_DATA, 0, nullptr)))
     {
         URHO3D_LOGERROR("Failed to add navigation mesh tile");
@@ -1514,31 +2111,98 @@ bool NavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometryList,
         return false;
     }
 
-    // Send a notification of the rebuild of this tile to anyone interested
-    {
-        using namespace NavigationAreaRebuilt;
-        VariantMap& eventData = GetContext()->GetEventDataMap();
-        eventData[P_NODE] = GetNode();
-        eventData[P_MESH] = this;
-        eventData[P_BOUNDSMIN] = Variant(tileBoundingBox.min_);
-        eventData[P_BOUNDSMAX] = Variant(tileBoundingBox.max_);
-        SendEvent(E_NAVIGATION_AREA_REBUILT, eventData);
-    }
+    SendTileRebuiltEvent(tile);
     return true;
 }
 
+void NavigationMesh::SendTileRebuiltEvent(const IntVector2& tile)
+{
+    // Send a notification of the rebuild of this tile to anyone interested
+    using namespace NavigationAreaRebuilt;
+    const BoundingBox tileBoundingBox = GetTileBoundingBox(tile);
+    VariantMap& eventData = GetContext()->GetEventDataMap();
+    eventData[P_NODE] = GetNode();
+    eventData[P_MESH] = this;
+    eventData[P_BOUNDSMIN] = Variant(tileBoundingBox.min_);
+    eventData[P_BOUNDSMAX] = Variant(tileBoundingBox.max_);
+    SendEvent(E_NAVIGATION_AREA_REBUILT, eventData);
+}
+
 unsigned NavigationMesh::BuildTiles(ea::vector<NavigationGeometryInfo>& geometryList, const IntVector2& from, const IntVector2& to)
 {
     unsigned numTiles = 0;
 
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    if (!workQueue || !workQueue->GetNumThreads() || !Thread::IsMainThread() || from == to)
+    {
+        for (int z = from.y_; z <= to.y_; ++z)
+        {
+            for (int x = from.x_; x <= to.x_; ++x)
+            {
+                if (BuildTile(geometryList, x, z))
+                    ++numTiles;
+            }
+        }
+        return numTiles;
+    }
+
+    struct TileBuild
+    {
+        IntVector2 tile_;
+        rcConfig cfg_;
+        SimpleNavBuildData build_;
+        unsigned char* navData_{};
+        int navDataSize_{};
+        bool success_{};
+    };
+
+    ea::vector<IntVector2> tiles;
     for (int z = from.y_; z <= to.y_; ++z)
     {
         for (int x = from.x_; x <= to.x_; ++x)
+            tiles.emplace_back(x, z);
+    }
+
+    // Scene access and navigation mesh modification stay on the main thread, only Recast runs on the work queue.
+    // Tiles are processed in batches to bound the memory used by collected geometry
+    ea::vector<ea::unique_ptr<TileBuild>> batch;
+    for (unsigned batchStart = 0; batchStart < tiles.size(); batchStart += NAVMESH_TILE_BUILD_BATCH_SIZE)
+    {
+        URHO3D_PROFILE("BuildNavigationMeshTiles");
+
+        batch.clear();
+        const unsigned batchEnd = Min(batchStart + NAVMESH_TILE_BUILD_BATCH_SIZE, tiles.size());
+        for (unsigned i = batchStart; i < batchEnd; ++i)
+        {
+            auto tileBuild = ea::make_unique<TileBuild>();
+            tileBuild->tile_ = tiles[i];
+
+            navMesh_->removeTile(navMesh_->getTileRefAt(tiles[i].x_, tiles[i].y_, 0), nullptr, nullptr);
+
+            GetTileConfig(tileBuild->cfg_, tiles[i]);
+            BoundingBox expandedBox(*reinterpret_cast<Vector3*>(tileBuild->cfg_.bmin), *reinterpret_cast<Vector3*>(tileBuild->cfg_.bmax));
+            GetTileGeometry(&tileBuild->build_, geometryList, expandedBox);
+            batch.push_back(ea::move(tileBuild));
+        }
+
+        workQueue->ParallelFor(batch.size(), 1, [this, &batch](unsigned begin, unsigned end, unsigned)
         {
-            if (BuildTile(geometryList, x, z))
+            for (unsigned i = begin; i < end; ++i)
+            {
+                TileBuild& tileBuild = *batch[i];
+                tileBuild.success_ = BuildTileMesh(tileBuild.build_, tileBuild.cfg_, tileBuild.tile_,
+                    tileBuild.navData_, tileBuild.navDataSize_);
+            }
+        });
+        workQueue->Complete(M_MAX_UNSIGNED);
+
+        for (const auto& tileBuild : batch)
+        {
+            if (tileBuild->success_ && (!tileBuild->navData_ || AddTileMesh(tileBuild->tile_, tileBuild->navData_, tileBuild->navDataSize_)))
                 ++numTiles;
         }
     }
+
     return numTiles;
 }
 
@@ -1568,6 +2232,9 @@ bool NavigationMesh::InitializeQuery()
 
 void NavigationMesh::ReleaseNavigationMesh()
 {
+    // Path query slots are reinitialized for the next navigation mesh
+    pathQueryNavMesh_ = nullptr;
+
     dtFreeNavMesh(navMesh_);
     navMesh_ = nullptr;
 
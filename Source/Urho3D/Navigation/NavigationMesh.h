@@ -25,6 +25,7 @@
 #pragma once
 
 #include <EASTL/unique_ptr.h>
+#include <EASTL/unordered_map.h>
 
 #include "../Math/BoundingBox.h"
 #include "../Math/Matrix3x4.h"
@@ -40,6 +41,8 @@ class dtNavMesh;
 class dtNavMeshQuery;
 class dtQueryFilter;
 
+struct rcConfig;
+
 namespace Urho3D
 {
 
@@ -54,6 +57,10 @@ class NavArea;
 
 struct FindPathData;
 struct NavBuildData;
+struct SimpleNavBuildData;
+
+/// Maximum number of tiles whose geometry is collected at once when building tiles on the work queue.
+static const unsigned NAVMESH_TILE_BUILD_BATCH_SIZE = 64;
 
 /// Description of a navigation mesh geometry component, with transform and bounds information.
 struct NavigationGeometryInfo
@@ -78,6 +85,15 @@ enum NavigationPathPointFlag
     NAVPATHFLAG_OFF_MESH = 0x04
 };
 
+/// Status of an asynchronous path request.
+enum PathRequestStatus
+{
+    PATH_REQUEST_INVALID = 0,
+    PATH_REQUEST_PENDING,
+    PATH_REQUEST_SUCCEEDED,
+    PATH_REQUEST_FAILED
+};
+
 struct URHO3D_API NavigationPathPoint
 {
     /// World-space position of the path point.
@@ -144,6 +160,16 @@ public:
     virtual bool Build(const BoundingBox& boundingBox);
     /// Rebuild part of the navigation mesh in the rectangular area. Return true if successful.
     virtual bool Build(const IntVector2& from, const IntVector2& to);
+    /// Queue a background rebuild of part of the navigation mesh contained by the world-space bounding box. Geometry is collected on the main thread, Recast runs on the work queue, and built tiles are swapped in under the per-frame time budget. Queries use the old tiles until the swap.
+    virtual void BuildAsync(const BoundingBox& boundingBox);
+    /// Queue a background rebuild of part of the navigation mesh in the rectangular area.
+    virtual void BuildAsync(const IntVector2& from, const IntVector2& to);
+    /// Finish all queued background rebuilds immediately.
+    void CompleteAsyncBuild();
+    /// Cancel queued background rebuilds. Tiles that are being built are waited for and discarded.
+    void CancelAsyncBuild();
+    /// Set time budget in milliseconds for swapping in background built tiles per frame. At least one tile is swapped per frame.
+    void SetAsyncBuildTimeBudget(float milliseconds) { asyncBuildTimeBudget_ = Max(milliseconds, 0.0f); }
     /// Return tile data.
     virtual ea::vector<unsigned char> GetTileData(const IntVector2& tile) const;
     /// Add tile to navigation mesh.
@@ -171,6 +197,20 @@ public:
     void FindPath
         (ea::vector<NavigationPathPoint>& dest, const Vector3& start, const Vector3& end, const Vector3& extents = Vector3::ONE,
             const dtQueryFilter* filter = nullptr);
+    /// Queue an asynchronous path request between world space points. Requests are processed on the work queue with sliced path finding under the per-frame node budget. Return request ID, or 0 if the navigation mesh is not built.
+    unsigned RequestPath(const Vector3& start, const Vector3& end, const Vector3& extents = Vector3::ONE);
+    /// Return status of a path request.
+    PathRequestStatus GetPathRequestStatus(unsigned id) const;
+    /// Return points of a finished path request and forget the request. Return true if the path was found.
+    bool TakePathRequestResult(unsigned id, ea::vector<Vector3>& dest);
+    /// Cancel and forget a path request.
+    void CancelPathRequest(unsigned id);
+    /// Set total number of search nodes processed by path requests per frame.
+    void SetPathNodeBudget(unsigned nodes) { pathNodeBudget_ = Max(nodes, 1u); }
+    /// Set maximum number of cached polygon corridors between start and end polygons. 0 disables the cache.
+    void SetPathCacheSize(unsigned size);
+    /// Clear cached polygon corridors of path requests.
+    void ClearPathCache();
     /// Return a random point on the navigation mesh.
     Vector3 GetRandomPoint(const dtQueryFilter* filter = nullptr, dtPolyRef* randomRef = nullptr);
     /// Return a random point on the navigation mesh within a circle. The circle radius is only a guideline and in practice the returned point may be further away.
@@ -251,6 +291,18 @@ public:
     /// Return number of tiles.
     IntVector2 GetNumTiles() const { return IntVector2(numTilesX_, numTilesZ_); }
 
+    /// Return time budget in milliseconds for swapping in background built tiles per frame.
+    float GetAsyncBuildTimeBudget() const { return asyncBuildTimeBudget_; }
+
+    /// Return total number of search nodes processed by path requests per frame.
+    unsigned GetPathNodeBudget() const { return pathNodeBudget_; }
+
+    /// Return maximum number of cached polygon corridors of path requests.
+    unsigned GetPathCacheSize() const { return pathCacheSize_; }
+
+    /// Return number of tiles queued or being rebuilt in the background.
+    unsigned GetNumAsyncBuildTiles() const { return asyncTileQueue_.size() + asyncTileBuilds_.size(); }
+
     /// Set the partition type used for polygon generation.
     void SetPartitionType(NavmeshPartitionType partitionType);
 
@@ -291,7 +343,15 @@ protected:
     void AddTriMeshGeometry(NavBuildData* build, Geometry* geometry, const Matrix3x4& transform);
     /// Build one tile of the navigation mesh. Return true if successful.
     virtual bool BuildTile(ea::vector<NavigationGeometryInfo>& geometryList, int x, int z);
-    /// Build tiles in the rectangular area. Return number of built tiles.
+    /// Fill Recast configuration of a tile. The bounds include the tile border.
+    void GetTileConfig(rcConfig& cfg, const IntVector2& tile) const;
+    /// Build Detour data of one tile from collected geometry. Leaves the data null if there is nothing to build. Does not access the scene or the navigation mesh, so is safe to call from worker threads. Return true if successful.
+    bool BuildTileMesh(SimpleNavBuildData& build, const rcConfig& cfg, const IntVector2& tile, unsigned char*& navData, int& navDataSize) const;
+    /// Add built tile data to the navigation mesh, which takes ownership of it, and send the area rebuilt event. Return true if successful.
+    bool AddTileMesh(const IntVector2& tile, unsigned char* navData, int navDataSize);
+    /// Send the area rebuilt event of a tile.
+    void SendTileRebuiltEvent(const IntVector2& tile);
+    /// Build tiles in the rectangular area, running Recast on the work queue when it has worker threads. Return number of built tiles.
     unsigned BuildTiles(ea::vector<NavigationGeometryInfo>& geometryList, const IntVector2& from, const IntVector2& to);
     /// Ensure that the navigation mesh query is initialized. Return true if successful.
     bool InitializeQuery();
@@ -352,6 +412,47 @@ protected:
     bool drawNavAreas_;
     /// NavAreas for this NavMesh.
     ea::vector<WeakPtr<NavArea> > areas_;
+
+private:
+    struct AsyncTileBuild;
+    struct PathRequest;
+    struct PathQuerySlot;
+
+    /// Start background builds of queued tiles.
+    void StartAsyncTileBuilds();
+    /// Swap in a finished background built tile.
+    void FinishAsyncTileBuild(AsyncTileBuild& tileBuild);
+    /// Swap in finished background built tiles under the time budget and start new builds.
+    void HandleAsyncBuildUpdate(StringHash eventType, VariantMap& eventData);
+    /// Process path requests in a query slot. Called from worker threads.
+    void ProcessPathRequests(PathQuerySlot& slot, unsigned nodeBudget) const;
+    /// Process pending path requests.
+    void HandlePathRequestUpdate(StringHash eventType, VariantMap& eventData);
+
+    /// Tiles queued for background rebuild.
+    ea::vector<IntVector2> asyncTileQueue_;
+    /// Tiles being built in the background, in order of queuing.
+    ea::vector<ea::unique_ptr<AsyncTileBuild>> asyncTileBuilds_;
+    /// Time budget in milliseconds for swapping in background built tiles per frame.
+    float asyncBuildTimeBudget_{1.0f};
+    /// Path requests by ID.
+    ea::unordered_map<unsigned, ea::unique_ptr<PathRequest>> pathRequests_;
+    /// Path requests not yet assigned to a query slot, in order of request.
+    ea::vector<PathRequest*> pendingPathRequests_;
+    /// Path query slots with their own Detour queries, processed in parallel.
+    ea::vector<ea::unique_ptr<PathQuerySlot>> pathQuerySlots_;
+    /// Cached polygon corridors by start and end polygon.
+    ea::unordered_map<ea::pair<dtPolyRef, dtPolyRef>, ea::vector<dtPolyRef>> pathCache_;
+    /// Cached corridor keys in order of insertion, for eviction.
+    ea::vector<ea::pair<dtPolyRef, dtPolyRef>> pathCacheOrder_;
+    /// Navigation mesh the path query slots are initialized for.
+    const dtNavMesh* pathQueryNavMesh_{};
+    /// Next path request ID.
+    unsigned nextPathRequestId_{1};
+    /// Total number of search nodes processed by path requests per frame.
+    unsigned pathNodeBudget_{4096};
+    /// Maximum number of cached polygon corridors.
+    unsigned pathCacheSize_{256};
 };
 
 /// Register Navigation library objects.
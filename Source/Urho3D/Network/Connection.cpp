@@ -22,7 +22,10 @@
 
 #include "../Precompiled.h"
 
+#include <EASTL/sort.h>
+
 #include "../Core/Context.h"
+#include "../Core/Mutex.h"
 #include "../Core/Profiler.h"
 #include "../IO/File.h"
 #include "../IO/FileSystem.h"
@@ -58,7 +61,40 @@ namespace Urho3D
 
 static const int STATS_INTERVAL_MSEC = 2000;
 
+/// Extension of package files that are still being downloaded.
+static const char* PARTIAL_PACKAGE_EXTENSION = ".part";
+
+/// Return checksum of a package fragment.
+static unsigned GetFragmentChecksum(const unsigned char* data, unsigned size)
+{
+    unsigned checksum = 0;
+    for (unsigned i = 0; i < size; ++i)
+        checksum = SDBMHash(checksum, data[i]);
+    return checksum;
+}
+
+/// Remote event batch entry flag: the event has a sender node.
+static const unsigned char REMOTE_EVENT_NODE = 0x1;
+/// Remote event batch entry flag: the event data is written as schema values.
+static const unsigned char REMOTE_EVENT_SCHEMA = 0x2;
+
+/// Return whether event data has exactly the fields of the schema.
+static bool MatchesSchema(const VariantMap& eventData, const RemoteEventSchema& schema)
+{
+    if (eventData.size() != schema.size())
+        return false;
+
+    for (const auto& field : schema)
+    {
+        auto i = eventData.find(field.first);
+        if (i == eventData.end() || i->second.GetType() != field.second)
+            return false;
+    }
+    return true;
+}
+
 PackageDownload::PackageDownload() :
+    nextFragment_(0),
     totalFragments_(0),
     checksum_(0),
     initiated_(false)
@@ -127,6 +163,19 @@ void Connection::SendMessage(int msgID, bool reliable, bool inOrder, const unsig
     buffer.WriteUInt((unsigned int)msgID);
     buffer.Write(data, numBytes);
     PacketReliability reliability = reliable ? (inOrder ? RELIABLE_ORDERED : RELIABLE) : (inOrder ? UNRELIABLE_SEQUENCED : UNRELIABLE);
+
+    NetworkTrafficStats& stats = messageStats_[msgID];
+    ++stats.messagesOut_;
+    stats.bytesOut_ += buffer.GetSize();
+
+    if (deferMessages_)
+    {
+        deferredMessages_.WriteUByte((unsigned char)reliability);
+        deferredMessages_.WriteVLE(buffer.GetSize());
+        deferredMessages_.Write(buffer.GetData(), buffer.GetSize());
+        return;
+    }
+
     if (peer_) {
         peer_->Send((const char *) buffer.GetData(), (int) buffer.GetSize(), HIGH_PRIORITY, reliability, (char) 0, *address_, false);
         tempPacketCounter_.y_++;
@@ -272,6 +321,28 @@ void Connection::SendServerUpdate()
     }
 }
 
+void Connection::SetDeferMessages(bool enable)
+{
+    deferMessages_ = enable;
+    if (deferMessages_ || !deferredMessages_.GetSize())
+        return;
+
+    MemoryBuffer messages(deferredMessages_.GetData(), deferredMessages_.GetSize());
+    while (!messages.IsEof())
+    {
+        const auto reliability = (PacketReliability)messages.ReadUByte();
+        const unsigned size = messages.ReadVLE();
+        const unsigned position = messages.GetPosition();
+        if (peer_)
+        {
+            peer_->Send((const char*)messages.GetData() + position, (int)size, HIGH_PRIORITY, reliability, (char)0, *address_, false);
+            tempPacketCounter_.y_++;
+        }
+        messages.Seek(position + size);
+    }
+    deferredMessages_.Clear();
+}
+
 void Connection::SendClientUpdate()
 {
     if (!scene_ || !sceneLoaded_)
@@ -299,7 +370,9 @@ void Connection::SendRemoteEvents()
     {
         statsTimer_.Reset();
         char statsBuffer[256];
-        sprintf(statsBuffer, "RTT %.3f ms Pkt in %i Pkt out %i Data in %.3f KB/s Data out %.3f KB/s, Last heard %u", GetRoundTripTime(),
+        sprintf(statsBuffer, "RTT %.3f ms Jitter %.3f ms Pkt in %i Pkt out %i Data in %.3f KB/s Data out %.3f KB/s, Last heard %u",
+            GetRoundTripTime(),
+            GetRoundTripJitter(),
             GetPacketsInPerSec(),
             GetPacketsOutPerSec(),
             GetBytesInPerSec(),
@@ -309,6 +382,21 @@ void Connection::SendRemoteEvents()
     }
 #endif
 
+    // Smooth the round trip time variation as in RFC 3550. The peer measures the round trip time only every few seconds,
+    // so feed the estimator only when the ping or the clock differential calculated along with it have changed
+    if (peer_)
+    {
+        const int ping = peer_->GetLastPing(*address_);
+        const unsigned long long clockDifferential = peer_->GetClockDifferential(*address_);
+        if (ping != lastPing_ || clockDifferential != lastClockDifferential_)
+        {
+            if (ping >= 0 && lastPing_ >= 0)
+                jitter_ += (Abs(static_cast<float>(ping - lastPing_)) - jitter_) / 16.0f;
+            lastPing_ = ping;
+            lastClockDifferential_ = clockDifferential;
+        }
+    }
+
     if (packetCounterTimer_.GetMSec(false) > 1000)
     {
         packetCounterTimer_.Reset();
@@ -321,22 +409,42 @@ void Connection::SendRemoteEvents()
 
     URHO3D_PROFILE("SendRemoteEvents");
 
-    for (auto i = remoteEvents_.begin(); i != remoteEvents_.end(); ++i)
+    auto* network = GetSubsystem<Network>();
+
+    // Aggregate the events into at most two messages, as their order only matters among the in-order events
+    for (bool inOrder : { true, false })
     {
-        msg_.Clear();
-        if (!i->senderID_)
+        unsigned numEvents = 0;
+        VectorBuffer events;
+        for (const RemoteEvent& event : remoteEvents_)
         {
-            msg_.WriteStringHash(i->eventType_);
-            msg_.WriteVariantMap(i->eventData_);
-            SendMessage(MSG_REMOTEEVENT, true, i->inOrder_, msg_);
-        }
-        else
-        {
-            msg_.WriteNetID(i->senderID_);
-            msg_.WriteStringHash(i->eventType_);
-            msg_.WriteVariantMap(i->eventData_);
-            SendMessage(MSG_REMOTENODEEVENT, true, i->inOrder_, msg_);
+            if (event.inOrder_ != inOrder)
+                continue;
+
+            const RemoteEventSchema* schema = network->GetRemoteEventSchema(event.eventType_);
+            const bool useSchema = schema && MatchesSchema(event.eventData_, *schema);
+
+            events.WriteUByte((event.senderID_ ? REMOTE_EVENT_NODE : 0) | (useSchema ? REMOTE_EVENT_SCHEMA : 0));
+            if (event.senderID_)
+                events.WriteNetID(event.senderID_);
+            events.WriteStringHash(event.eventType_);
+            if (useSchema)
+            {
+                for (const auto& field : *schema)
+                    events.WriteVariantData(event.eventData_.find(field.first)->second);
+            }
+            else
+                events.WriteVariantMap(event.eventData_);
+            ++numEvents;
         }
+
+        if (!numEvents)
+            continue;
+
+        msg_.Clear();
+        msg_.WriteVLE(numEvents);
+        msg_.Write(events.GetData(), events.GetSize());
+        SendMessage(MSG_REMOTEEVENTBATCH, true, inOrder, msg_);
     }
 
     remoteEvents_.clear();
@@ -356,11 +464,13 @@ void Connection::SendPackages()
                 (unsigned)Min((int)(upload.file_->GetSize() - upload.file_->GetPosition()), (int)PACKAGE_FRAGMENT_SIZE);
             upload.file_->Read(buffer, fragmentSize);
 
+            // Fragments are sent in order, so that the client can resume from the size of its partial file
             msg_.Clear();
             msg_.WriteStringHash(current->first);
             msg_.WriteUInt(upload.fragment_++);
+            msg_.WriteUInt(GetFragmentChecksum(buffer, fragmentSize));
             msg_.Write(buffer, fragmentSize);
-            SendMessage(MSG_PACKAGEDATA, true, false, msg_);
+            SendMessage(MSG_PACKAGEDATA, true, true, msg_);
 
             // Check if upload finished
             if (upload.fragment_ == upload.totalFragments_)
@@ -411,6 +521,9 @@ bool Connection::ProcessMessage(int msgID, MemoryBuffer& msg)
     // New incomming message, reset last heard timer
     lastHeardTimer_.Reset();
     tempPacketCounter_.x_++;
+    NetworkTrafficStats& stats = messageStats_[msgID];
+    ++stats.messagesIn_;
+    stats.bytesIn_ += msg.GetSize();
     bool processed = true;
 
     switch (msgID)
@@ -456,6 +569,10 @@ bool Connection::ProcessMessage(int msgID, MemoryBuffer& msg)
         ProcessRemoteEvent(msgID, msg);
         break;
 
+    case MSG_REMOTEEVENTBATCH:
+        ProcessRemoteEventBatch(msg);
+        break;
+
     case MSG_PACKAGEINFO:
         ProcessPackageInfo(msgID, msg);
         break;
@@ -757,6 +874,7 @@ void Connection::ProcessPackageDownload(int msgID, MemoryBuffer& msg)
         else
         {
             ea::string name = msg.ReadString();
+            const unsigned startFragment = msg.IsEof() ? 0 : msg.ReadUInt();
 
             if (!scene_)
             {
@@ -790,11 +908,29 @@ void Connection::ProcessPackageDownload(int msgID, MemoryBuffer& msg)
                         return;
                     }
 
-                    URHO3D_LOGINFO("Transmitting package file " + name + " to client " + ToString());
+                    // An empty package has no fragments, the client completes it without a transfer
+                    const unsigned totalFragments = (file->GetSize() + PACKAGE_FRAGMENT_SIZE - 1) / PACKAGE_FRAGMENT_SIZE;
+                    if (!totalFragments)
+                        return;
+                    if (startFragment >= totalFragments)
+                    {
+                        URHO3D_LOGERROR("Client requested package file " + name + " from an invalid fragment");
+                        SendPackageError(name);
+                        return;
+                    }
+
+                    if (startFragment)
+                    {
+                        URHO3D_LOGINFO("Resuming transmission of package file " + name + " to client " + ToString() +
+                            " from fragment " + ea::to_string(startFragment));
+                        file->Seek(startFragment * PACKAGE_FRAGMENT_SIZE);
+                    }
+                    else
+                        URHO3D_LOGINFO("Transmitting package file " + name + " to client " + ToString());
 
                     uploads_[nameHash].file_ = file;
-                    uploads_[nameHash].fragment_ = 0;
-                    uploads_[nameHash].totalFragments_ = (file->GetSize() + PACKAGE_FRAGMENT_SIZE - 1) / PACKAGE_FRAGMENT_SIZE;
+                    uploads_[nameHash].fragment_ = startFragment;
+                    uploads_[nameHash].totalFragments_ = totalFragments;
                     return;
                 }
             }
@@ -831,52 +967,35 @@ void Connection::ProcessPackageDownload(int msgID, MemoryBuffer& msg)
                 return;
             }
 
-            // If file has not yet been opened, try to open now. Prepend the checksum to the filename to allow multiple versions
-            if (!download.file_)
-            {
-                download.file_ = new File(context_,
-                    GetSubsystem<Network>()->GetPackageCacheDir() + ToStringHex(download.checksum_) + "_" + download.name_,
-                    FILE_WRITE);
-                if (!download.file_->IsOpen())
-                {
-                    OnPackageDownloadFailed(download.name_);
-                    return;
-                }
-            }
-
-            // Write the fragment data to the proper index
+            // Fragments arrive in order and are written directly to the partial file
             unsigned char buffer[PACKAGE_FRAGMENT_SIZE];
             unsigned index = msg.ReadUInt();
-            unsigned fragmentSize = msg.GetSize() - msg.GetPosition();
+            unsigned checksum = msg.ReadUInt();
+            unsigned fragmentSize = Min(msg.GetSize() - msg.GetPosition(), PACKAGE_FRAGMENT_SIZE);
 
             msg.Read(buffer, fragmentSize);
-            download.file_->Seek(index * PACKAGE_FRAGMENT_SIZE);
+            if (index != download.nextFragment_ || checksum != GetFragmentChecksum(buffer, fragmentSize))
+            {
+                URHO3D_LOGERROR("Received corrupt fragment " + ea::to_string(index) + " of package " + download.name_);
+                download.file_->Close();
+                GetSubsystem<FileSystem>()->Delete(download.file_->GetName());
+                OnPackageDownloadFailed(download.name_);
+                return;
+            }
+
             download.file_->Write(buffer, fragmentSize);
-            download.receivedFragments_.insert(index);
+            ++download.nextFragment_;
 
             // Check if all fragments received
-            if (download.receivedFragments_.size() == download.totalFragments_)
+            if (download.nextFragment_ == download.totalFragments_)
             {
-                URHO3D_LOGINFO("Package " + download.name_ + " downloaded successfully");
-
-                // Instantiate the package and add to the resource system, as we will need it to load the scene
-                download.file_->Close();
-                GetSubsystem<ResourceCache>()->AddPackageFile(download.file_->GetName(), 0);
-
-                // Then start the next download if there are more
-                downloads_.erase(i);
-                if (downloads_.empty())
-                    OnPackagesReady();
-                else
+                if (!FinishPackageDownload(download))
                 {
-                    PackageDownload& nextDownload = downloads_.begin()->second;
-
-                    URHO3D_LOGINFO("Requesting package " + nextDownload.name_ + " from server");
-                    msg_.Clear();
-                    msg_.WriteString(nextDownload.name_);
-                    SendMessage(MSG_REQUESTPACKAGE, true, true, msg_);
-                    nextDownload.initiated_ = true;
+                    OnPackageDownloadFailed(download.name_);
+                    return;
                 }
+
+                OnPackageDownloaded(nameHash);
             }
         }
         break;
@@ -968,47 +1087,74 @@ void Connection::ProcessSceneLoaded(int msgID, MemoryBuffer& msg)
 
 void Connection::ProcessRemoteEvent(int msgID, MemoryBuffer& msg)
 {
-    using namespace RemoteEventData;
+    const unsigned senderID = msgID == MSG_REMOTENODEEVENT ? msg.ReadNetID() : 0;
+    const StringHash eventType = msg.ReadStringHash();
+    VariantMap eventData = msg.ReadVariantMap();
+    DispatchRemoteEvent(senderID, eventType, eventData);
+}
+
+void Connection::ProcessRemoteEventBatch(MemoryBuffer& msg)
+{
+    auto* network = GetSubsystem<Network>();
 
-    if (msgID == MSG_REMOTEEVENT)
+    const unsigned numEvents = msg.ReadVLE();
+    for (unsigned i = 0; i < numEvents && !msg.IsEof(); ++i)
     {
-        StringHash eventType = msg.ReadStringHash();
-        if (!GetSubsystem<Network>()->CheckRemoteEvent(eventType))
+        const unsigned char flags = msg.ReadUByte();
+        const unsigned senderID = (flags & REMOTE_EVENT_NODE) ? msg.ReadNetID() : 0;
+        const StringHash eventType = msg.ReadStringHash();
+
+        VariantMap eventData;
+        if (flags & REMOTE_EVENT_SCHEMA)
         {
-            URHO3D_LOGWARNING("Discarding not allowed remote event " + eventType.ToString());
-            return;
+            const RemoteEventSchema* schema = network->GetRemoteEventSchema(eventType);
+            if (!schema)
+            {
+                // Rest of the batch can not be parsed without knowing the field types
+                URHO3D_LOGERROR("Missing schema for remote event " + eventType.ToString() + ", discarding remaining events");
+                return;
+            }
+
+            for (const auto& field : *schema)
+                eventData[field.first] = msg.ReadVariant(field.second);
         }
+        else
+            eventData = msg.ReadVariantMap();
 
-        VariantMap eventData = msg.ReadVariantMap();
-        eventData[P_CONNECTION] = this;
-        SendEvent(eventType, eventData);
+        DispatchRemoteEvent(senderID, eventType, eventData);
     }
-    else
+}
+
+void Connection::DispatchRemoteEvent(unsigned senderID, StringHash eventType, VariantMap& eventData)
+{
+    using namespace RemoteEventData;
+
+    if (!GetSubsystem<Network>()->CheckRemoteEvent(eventType))
     {
-        if (!scene_)
-        {
-            URHO3D_LOGERROR("Can not receive remote node event without an assigned scene");
-            return;
-        }
+        URHO3D_LOGWARNING("Discarding not allowed remote event " + eventType.ToString());
+        return;
+    }
 
-        unsigned nodeID = msg.ReadNetID();
-        StringHash eventType = msg.ReadStringHash();
-        if (!GetSubsystem<Network>()->CheckRemoteEvent(eventType))
-        {
-            URHO3D_LOGWARNING("Discarding not allowed remote event " + eventType.ToString());
-            return;
-        }
+    eventData[P_CONNECTION] = this;
+    if (!senderID)
+    {
+        SendEvent(eventType, eventData);
+        return;
+    }
 
-        VariantMap eventData = msg.ReadVariantMap();
-        Node* sender = scene_->GetNode(nodeID);
-        if (!sender)
-        {
-            URHO3D_LOGWARNING("Missing sender for remote node event, discarding");
-            return;
-        }
-        eventData[P_CONNECTION] = this;
-        sender->SendEvent(eventType, eventData);
+    if (!scene_)
+    {
+        URHO3D_LOGERROR("Can not receive remote node event without an assigned scene");
+        return;
     }
+
+    Node* sender = scene_->GetNode(senderID);
+    if (!sender)
+    {
+        URHO3D_LOGWARNING("Missing sender for remote node event, discarding");
+        return;
+    }
+    sender->SendEvent(eventType, eventData);
 }
 
 Scene* Connection::GetScene() const
@@ -1069,6 +1215,80 @@ int Connection::GetPacketsOutPerSec() const
     return packetCounter_.y_;
 }
 
+unsigned Connection::GetNumQueuedMessages() const
+{
+    unsigned numMessages = 0;
+    if (peer_)
+    {
+        SLNet::RakNetStatistics stats{};
+        if (peer_->GetStatistics(address_->systemAddress, &stats))
+        {
+            for (unsigned i = 0; i < NUMBER_OF_PRIORITIES; ++i)
+                numMessages += stats.messageInSendBuffer[i];
+        }
+    }
+    return numMessages;
+}
+
+unsigned Connection::GetNumQueuedBytes() const
+{
+    double numBytes = 0.0;
+    if (peer_)
+    {
+        SLNet::RakNetStatistics stats{};
+        if (peer_->GetStatistics(address_->systemAddress, &stats))
+        {
+            for (unsigned i = 0; i < NUMBER_OF_PRIORITIES; ++i)
+                numBytes += stats.bytesInSendBuffer[i];
+        }
+    }
+    return static_cast<unsigned>(numBytes);
+}
+
+void Connection::ResetStatistics()
+{
+    messageStats_.clear();
+    replicationStats_.clear();
+}
+
+ea::string Connection::PrintStatistics(unsigned maxTypes) const
+{
+    char line[256];
+    sprintf(line, "%s RTT %.1f ms Jitter %.1f ms In %.1f KB/s Out %.1f KB/s Queued %u msg %s Pending nodes %u\n",
+        ToString().c_str(), GetRoundTripTime(), GetRoundTripJitter(), GetBytesInPerSec() / 1024.0f, GetBytesOutPerSec() / 1024.0f,
+        GetNumQueuedMessages(), GetFileSizeString(GetNumQueuedBytes()).c_str(), GetNumPendingNodes());
+    ea::string output = line;
+
+    ea::vector<ea::pair<int, NetworkTrafficStats>> messages(messageStats_.begin(), messageStats_.end());
+    ea::sort(messages.begin(), messages.end(), [](const auto& lhs, const auto& rhs) { return lhs.second.bytesOut_ > rhs.second.bytesOut_; });
+    if (messages.size() > maxTypes)
+        messages.resize(maxTypes);
+
+    output += "Message          Sent      Bytes   Received      Bytes\n";
+    for (const auto& item : messages)
+    {
+        sprintf(line, "0x%-8x %10u %10s %10u %10s\n", item.first, item.second.messagesOut_,
+            GetFileSizeString(item.second.bytesOut_).c_str(), item.second.messagesIn_, GetFileSizeString(item.second.bytesIn_).c_str());
+        output += line;
+    }
+
+    ea::vector<ea::pair<StringHash, NetworkTrafficStats>> types(replicationStats_.begin(), replicationStats_.end());
+    ea::sort(types.begin(), types.end(), [](const auto& lhs, const auto& rhs) { return lhs.second.bytesOut_ > rhs.second.bytesOut_; });
+    if (types.size() > maxTypes)
+        types.resize(maxTypes);
+
+    output += "Replicated type           Updates      Bytes  Write ms\n";
+    for (const auto& item : types)
+    {
+        const ea::string& typeName = context_->GetTypeName(item.first);
+        sprintf(line, "%-24s %8u %10s %9.3f\n", typeName.empty() ? item.first.ToString().c_str() : typeName.c_str(),
+            item.second.messagesOut_, GetFileSizeString(item.second.bytesOut_).c_str(), item.second.serializeTime_ / 1000.0);
+        output += line;
+    }
+
+    return output;
+}
+
 ea::string Connection::ToString() const
 {
     return GetAddress() + ":" + ea::to_string(GetPort());
@@ -1096,7 +1316,7 @@ float Connection::GetDownloadProgress() const
         downloads_.end(); ++i)
     {
         if (i->second.initiated_)
-            return (float)i->second.receivedFragments_.size() / (float)i->second.totalFragments_;
+            return (float)i->second.nextFragment_ / (float)i->second.totalFragments_;
     }
     return 1.0f;
 }
@@ -1165,6 +1385,8 @@ void Connection::ProcessNode(unsigned nodeID)
             // would be enough. However, this may be better due to the client not possibly having updated parenting
             // information at the time of receiving this message
             SendMessage(MSG_REMOVENODE, true, true, msg_);
+
+            MutexLock lock(GetSubsystem<Network>()->GetReplicationStateMutex());
             sceneState_.nodeStates_.erase(nodeID);
         }
         else
@@ -1184,6 +1406,14 @@ void Connection::ProcessNode(unsigned nodeID)
     }
 }
 
+void Connection::AddReplicationStats(StringHash type, unsigned bytes, long long serializeTime)
+{
+    NetworkTrafficStats& stats = replicationStats_[type];
+    ++stats.messagesOut_;
+    stats.bytesOut_ += bytes;
+    stats.serializeTime_ += serializeTime;
+}
+
 void Connection::ProcessNewNode(Node* node)
 {
     // Process depended upon nodes first, if they are dirty
@@ -1195,17 +1425,41 @@ void Connection::ProcessNewNode(Node* node)
             ProcessNode(nodeID);
     }
 
+    // Postpone nodes outside the area of interest, and nodes whose depended upon nodes were postponed.
+    // They stay dirty and are checked again on the next update
+    auto* priority = node->GetComponent<NetworkPriority>();
+    if (priority && (!priority->GetAlwaysUpdateOwner() || node->GetOwner() != this))
+    {
+        if (!priority->IsRelevant((node->GetWorldPosition() - position_).Length()))
+            return;
+    }
+    for (auto i = dependencyNodes.begin(); i != dependencyNodes.end(); ++i)
+    {
+        unsigned nodeID = (*i)->GetID();
+        if (sceneState_.dirtyNodes_.contains(nodeID) && !sceneState_.nodeStates_.contains(nodeID))
+            return;
+    }
+
     msg_.Clear();
     msg_.WriteNetID(node->GetID());
 
     NodeReplicationState& nodeState = sceneState_.nodeStates_[node->GetID()];
     nodeState.connection_ = this;
     nodeState.sceneState_ = &sceneState_;
-    nodeState.node_ = node;
-    node->AddReplicationState(&nodeState);
+    {
+        MutexLock lock(GetSubsystem<Network>()->GetReplicationStateMutex());
+        nodeState.node_ = node;
+        node->AddReplicationState(&nodeState);
+    }
 
     // Write node's attributes
-    node->WriteInitialDeltaUpdate(msg_, timeStamp_);
+    unsigned startSize = msg_.GetSize();
+    HiresTimer serializeTimer;
+    {
+        MutexLock lock(GetSubsystem<Network>()->GetInitialUpdateMutex());
+        node->WriteInitialDeltaUpdate(msg_, timeStamp_);
+    }
+    AddReplicationStats(node->GetType(), msg_.GetSize() - startSize, serializeTimer.GetUSec(false));
 
     // Write node's user variables
     const VariantMap& vars = node->GetVars();
@@ -1229,12 +1483,21 @@ void Connection::ProcessNewNode(Node* node)
         ComponentReplicationState& componentState = nodeState.componentStates_[component->GetID()];
         componentState.connection_ = this;
         componentState.nodeState_ = &nodeState;
-        componentState.component_ = component;
-        component->AddReplicationState(&componentState);
+        {
+            MutexLock lock(GetSubsystem<Network>()->GetReplicationStateMutex());
+            componentState.component_ = component;
+            component->AddReplicationState(&componentState);
+        }
 
         msg_.WriteStringHash(component->GetType());
         msg_.WriteNetID(component->GetID());
-        component->WriteInitialDeltaUpdate(msg_, timeStamp_);
+        startSize = msg_.GetSize();
+        serializeTimer.Reset();
+        {
+            MutexLock lock(GetSubsystem<Network>()->GetInitialUpdateMutex());
+            component->WriteInitialDeltaUpdate(msg_, timeStamp_);
+        }
+        AddReplicationStats(component->GetType(), msg_.GetSize() - startSize, serializeTimer.GetUSec(false));
     }
 
     SendMessage(MSG_CREATENODE, true, true, msg_);
@@ -1260,7 +1523,7 @@ void Connection::ProcessExistingNode(Node* node, NodeReplicationState& nodeState
     if (priority && (!priority->GetAlwaysUpdateOwner() || node->GetOwner() != this))
     {
         float distance = (node->GetWorldPosition() - position_).Length();
-        if (!priority->CheckUpdate(distance, nodeState.priorityAcc_))
+        if (!priority->IsRelevant(distance) || !priority->CheckUpdate(distance, nodeState.priorityAcc_))
             return;
     }
 
@@ -1285,7 +1548,9 @@ void Connection::ProcessExistingNode(Node* node, NodeReplicationState& nodeState
         {
             msg_.Clear();
             msg_.WriteNetID(node->GetID());
+            HiresTimer serializeTimer;
             node->WriteLatestDataUpdate(msg_, timeStamp_);
+            AddReplicationStats(node->GetType(), msg_.GetSize(), serializeTimer.GetUSec(false));
 
             SendMessage(MSG_NODELATESTDATA, true, false, msg_, node->GetID());
         }
@@ -1295,7 +1560,9 @@ void Connection::ProcessExistingNode(Node* node, NodeReplicationState& nodeState
         {
             msg_.Clear();
             msg_.WriteNetID(node->GetID());
+            HiresTimer serializeTimer;
             node->WriteDeltaUpdate(msg_, nodeState.dirtyAttributes_, timeStamp_);
+            AddReplicationStats(node->GetType(), msg_.GetSize(), serializeTimer.GetUSec(false));
 
             // Write changed variables
             msg_.WriteVLE(nodeState.dirtyVars_.size());
@@ -1338,6 +1605,8 @@ void Connection::ProcessExistingNode(Node* node, NodeReplicationState& nodeState
             msg_.WriteNetID(current->first);
 
             SendMessage(MSG_REMOVECOMPONENT, true, true, msg_);
+
+            MutexLock lock(GetSubsystem<Network>()->GetReplicationStateMutex());
             nodeState.componentStates_.erase(current);
         }
         else
@@ -1363,7 +1632,9 @@ void Connection::ProcessExistingNode(Node* node, NodeReplicationState& nodeState
                 {
                     msg_.Clear();
                     msg_.WriteNetID(component->GetID());
+                    HiresTimer serializeTimer;
                     component->WriteLatestDataUpdate(msg_, timeStamp_);
+                    AddReplicationStats(component->GetType(), msg_.GetSize(), serializeTimer.GetUSec(false));
 
                     SendMessage(MSG_COMPONENTLATESTDATA, true, false, msg_, component->GetID());
                 }
@@ -1373,7 +1644,9 @@ void Connection::ProcessExistingNode(Node* node, NodeReplicationState& nodeState
                 {
                     msg_.Clear();
                     msg_.WriteNetID(component->GetID());
+                    HiresTimer serializeTimer;
                     component->WriteDeltaUpdate(msg_, componentState.dirtyAttributes_, timeStamp_);
+                    AddReplicationStats(component->GetType(), msg_.GetSize(), serializeTimer.GetUSec(false));
 
                     SendMessage(MSG_COMPONENTDELTAUPDATE, true, true, msg_);
 
@@ -1402,14 +1675,23 @@ void Connection::ProcessExistingNode(Node* node, NodeReplicationState& nodeState
                 ComponentReplicationState& componentState = nodeState.componentStates_[component->GetID()];
                 componentState.connection_ = this;
                 componentState.nodeState_ = &nodeState;
-                componentState.component_ = component;
-                component->AddReplicationState(&componentState);
+                {
+                    MutexLock lock(GetSubsystem<Network>()->GetReplicationStateMutex());
+                    componentState.component_ = component;
+                    component->AddReplicationState(&componentState);
+                }
 
                 msg_.Clear();
                 msg_.WriteNetID(node->GetID());
                 msg_.WriteStringHash(component->GetType());
                 msg_.WriteNetID(component->GetID());
-                component->WriteInitialDeltaUpdate(msg_, timeStamp_);
+                const unsigned startSize = msg_.GetSize();
+                HiresTimer serializeTimer;
+                {
+                    MutexLock lock(GetSubsystem<Network>()->GetInitialUpdateMutex());
+                    component->WriteInitialDeltaUpdate(msg_, timeStamp_);
+                }
+                AddReplicationStats(component->GetType(), msg_.GetSize() - startSize, serializeTimer.GetUSec(false));
 
                 SendMessage(MSG_CREATECOMPONENT, true, true, msg_);
             }
@@ -1484,18 +1766,30 @@ bool Connection::RequestNeededPackages(unsigned numPackages, MemoryBuffer& msg)
         }
 
         // Package not found, need to request a download
-        if (!found)
-            RequestPackage(name, fileSize, checksum);
+        if (!found && !RequestPackage(name, fileSize, checksum))
+        {
+            downloads_.clear();
+            return false;
+        }
     }
 
     return true;
 }
 
-void Connection::RequestPackage(const ea::string& name, unsigned fileSize, unsigned checksum)
+bool Connection::RequestPackage(const ea::string& name, unsigned fileSize, unsigned checksum)
 {
     StringHash nameHash(name);
     if (downloads_.contains(nameHash))
-        return; // Download already exists
+        return true; // Download already exists
+
+    // An empty package has nothing to transfer, so complete it right away instead of queueing it
+    if (!fileSize)
+    {
+        PackageDownload download;
+        download.name_ = name;
+        download.checksum_ = checksum;
+        return StartPackageDownload(download) && FinishPackageDownload(download);
+    }
 
     PackageDownload& download = downloads_[nameHash];
     download.name_ = name;
@@ -1503,13 +1797,93 @@ void Connection::RequestPackage(const ea::string& name, unsigned fileSize, unsig
     download.checksum_ = checksum;
 
     // Start download now only if no existing downloads, else wait for the existing ones to finish
-    if (downloads_.size() == 1)
+    if (downloads_.size() == 1 && !StartPackageDownload(download))
     {
-        URHO3D_LOGINFO("Requesting package " + name + " from server");
-        msg_.Clear();
-        msg_.WriteString(name);
-        SendMessage(MSG_REQUESTPACKAGE, true, true, msg_);
-        download.initiated_ = true;
+        downloads_.erase(nameHash);
+        return false;
+    }
+    return true;
+}
+
+bool Connection::StartPackageDownload(PackageDownload& download)
+{
+    // Prepend the checksum to the filename to allow multiple versions
+    auto* fileSystem = GetSubsystem<FileSystem>();
+    const ea::string fileName = GetSubsystem<Network>()->GetPackageCacheDir() + ToStringHex(download.checksum_) + "_" +
+        download.name_ + PARTIAL_PACKAGE_EXTENSION;
+
+    // Resume after the last complete fragment of a previous interrupted download
+    const bool resume = fileSystem->FileExists(fileName);
+    download.file_ = new File(context_, fileName, resume ? FILE_READWRITE : FILE_WRITE);
+    if (!download.file_->IsOpen())
+    {
+        // Fail before requesting, the server would otherwise transmit data that can not be stored
+        URHO3D_LOGERROR("Failed to create package file " + fileName);
+        return false;
+    }
+
+    // An empty package has no fragments to request
+    if (!download.totalFragments_)
+        return true;
+
+    if (resume)
+    {
+        download.nextFragment_ = Min(download.file_->GetSize() / PACKAGE_FRAGMENT_SIZE, download.totalFragments_ - 1);
+        download.file_->Seek(download.nextFragment_ * PACKAGE_FRAGMENT_SIZE);
+    }
+
+    if (download.nextFragment_)
+        URHO3D_LOGINFO("Resuming download of package " + download.name_ + " from fragment " + ea::to_string(download.nextFragment_));
+    else
+        URHO3D_LOGINFO("Requesting package " + download.name_ + " from server");
+
+    msg_.Clear();
+    msg_.WriteString(download.name_);
+    msg_.WriteUInt(download.nextFragment_);
+    SendMessage(MSG_REQUESTPACKAGE, true, true, msg_);
+    download.initiated_ = true;
+    return true;
+}
+
+bool Connection::FinishPackageDownload(PackageDownload& download)
+{
+    auto* fileSystem = GetSubsystem<FileSystem>();
+    const ea::string partialFileName = download.file_->GetName();
+    const ea::string fileName = partialFileName.substr(0, partialFileName.length() - strlen(PARTIAL_PACKAGE_EXTENSION));
+
+    download.file_->Close();
+    if (!fileSystem->Rename(partialFileName, fileName))
+    {
+        URHO3D_LOGERROR("Failed to rename downloaded package " + partialFileName);
+        return false;
+    }
+
+    // Check that the result is a valid package of the expected version
+    SharedPtr<PackageFile> package(new PackageFile(context_, fileName));
+    if (package->GetChecksum() != download.checksum_)
+    {
+        URHO3D_LOGERROR("Downloaded package " + download.name_ + " has a wrong checksum");
+        fileSystem->Delete(fileName);
+        return false;
+    }
+
+    URHO3D_LOGINFO("Package " + download.name_ + " downloaded successfully");
+
+    // Add the package to the resource system, as we will need it to load the scene
+    return GetSubsystem<ResourceCache>()->AddPackageFile(package, 0);
+}
+
+void Connection::OnPackageDownloaded(StringHash nameHash)
+{
+    // Start the next download if there are more
+    downloads_.erase(nameHash);
+    if (downloads_.empty())
+        OnPackagesReady();
+    else
+    {
+        PackageDownload& next = downloads_.begin()->second;
+        if (!StartPackageDownload(next))
+            OnPackageDownloadFailed(next.name_);
     }
 }
 
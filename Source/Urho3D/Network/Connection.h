@@ -65,16 +65,34 @@ struct RemoteEvent
     bool inOrder_;
 };
 
+/// Field names and types of a remote event schema, in transmission order.
+using RemoteEventSchema = ea::vector<ea::pair<StringHash, VariantType>>;
+
+/// Traffic statistics of a network message type, or sent replication data statistics of a node or component type.
+struct NetworkTrafficStats
+{
+    /// Number of messages or updates sent.
+    unsigned messagesOut_{};
+    /// Number of bytes sent.
+    unsigned long long bytesOut_{};
+    /// Number of messages received.
+    unsigned messagesIn_{};
+    /// Number of bytes received.
+    unsigned long long bytesIn_{};
+    /// Time spent writing updates in microseconds.
+    long long serializeTime_{};
+};
+
 /// Package file receive transfer.
 struct PackageDownload
 {
     /// Construct with defaults.
     PackageDownload();
 
-    /// Destination file.
+    /// Destination file. Fragments are written in order into a partial file, so that the download can resume from its size.
     SharedPtr<File> file_;
-    /// Already received fragments.
-    ea::hash_set<unsigned> receivedFragments_;
+    /// Index of the next expected fragment.
+    unsigned nextFragment_;
     /// Package name.
     ea::string name_;
     /// Total number of fragments.
@@ -147,8 +165,10 @@ public:
     void SetLogStatistics(bool enable);
     /// Disconnect. If wait time is non-zero, will block while waiting for disconnect to finish.
     void Disconnect(int waitMSec = 0);
-    /// Send scene update messages. Called by Network.
+    /// Send scene update messages. Called by Network. May be called from a worker thread while messages are deferred.
     void SendServerUpdate();
+    /// Set whether sent messages are queued instead of passed to the network peer. Disabling sends the queued messages. Called by Network.
+    void SetDeferMessages(bool enable);
     /// Send latest controls from the client. Called by Network.
     void SendClientUpdate();
     /// Send queued remote events. Called by Network.
@@ -223,6 +243,30 @@ public:
     /// Return packets sent per second.
     int GetPacketsOutPerSec() const;
 
+    /// Return the smoothed variation of the round trip time in milliseconds.
+    float GetRoundTripJitter() const { return jitter_; }
+
+    /// Return number of messages waiting in the send buffer.
+    unsigned GetNumQueuedMessages() const;
+
+    /// Return number of bytes waiting in the send buffer.
+    unsigned GetNumQueuedBytes() const;
+
+    /// Return number of dirty nodes left unsent after the last server update, for example postponed by interest management.
+    unsigned GetNumPendingNodes() const { return sceneState_.dirtyNodes_.size(); }
+
+    /// Return traffic statistics by message ID.
+    const ea::unordered_map<int, NetworkTrafficStats>& GetMessageStats() const { return messageStats_; }
+
+    /// Return sent replication data statistics by node or component type.
+    const ea::unordered_map<StringHash, NetworkTrafficStats>& GetReplicationStats() const { return replicationStats_; }
+
+    /// Reset message and replication statistics.
+    void ResetStatistics();
+
+    /// Return a formatted string of connection statistics, including the message and replication types with most bytes sent.
+    ea::string PrintStatistics(unsigned maxTypes = 8) const;
+
     /// Return an address:port string.
     ea::string ToString() const;
     /// Return number of package downloads remaining.
@@ -263,6 +307,10 @@ private:
     void ProcessSceneLoaded(int msgID, MemoryBuffer& msg);
     /// Process a remote event message from the client or server. Called by Network.
     void ProcessRemoteEvent(int msgID, MemoryBuffer& msg);
+    /// Process a batch of remote events.
+    void ProcessRemoteEventBatch(MemoryBuffer& msg);
+    /// Send a received remote event locally, from the sender node if not zero.
+    void DispatchRemoteEvent(unsigned senderID, StringHash eventType, VariantMap& eventData);
     /// Process a node for sending a network update. Recurses to process depended on node(s) first.
     void ProcessNode(unsigned nodeID);
     /// Process a node that the client has not yet received.
@@ -273,12 +321,20 @@ private:
     void ProcessPackageInfo(int msgID, MemoryBuffer& msg);
     /// Check a package list received from server and initiate package downloads as necessary. Return true on success, or false if failed to initialze downloads (cache dir not set).
     bool RequestNeededPackages(unsigned numPackages, MemoryBuffer& msg);
-    /// Initiate a package download.
-    void RequestPackage(const ea::string& name, unsigned fileSize, unsigned checksum);
+    /// Initiate a package download. Return false if the package file could not be created.
+    bool RequestPackage(const ea::string& name, unsigned fileSize, unsigned checksum);
+    /// Open the partial file of a package download and request the remaining fragments from the server. An empty package is not requested. Return false if the file could not be opened.
+    bool StartPackageDownload(PackageDownload& download);
+    /// Verify a downloaded package and add it to the resource cache. Return true on success.
+    bool FinishPackageDownload(PackageDownload& download);
+    /// Add sent replication data of a node or component type to the statistics.
+    void AddReplicationStats(StringHash type, unsigned bytes, long long serializeTime);
     /// Send an error reply for a package download.
     void SendPackageError(const ea::string& name);
     /// Handle scene load failure on the server or client.
     void OnSceneLoadFailed();
+    /// Start the next queued package download, or load the scene if all packages are ready.
+    void OnPackageDownloaded(StringHash nameHash);
     /// Handle a package download failure on the client.
     void OnPackageDownloadFailed(const ea::string& name);
     /// Handle all packages loaded successfully. Also called directly on MSG_LOADSCENE if there are none.
@@ -300,12 +356,24 @@ private:
     ea::hash_set<unsigned> nodesToProcess_;
     /// Reusable message buffer.
     VectorBuffer msg_;
+    /// Messages queued while deferred, as reliability, size and packet data.
+    VectorBuffer deferredMessages_;
     /// Queued remote events.
     ea::vector<RemoteEvent> remoteEvents_;
     /// Scene file to load once all packages (if any) have been downloaded.
     ea::string sceneFileName_;
     /// Statistics timer.
     Timer statsTimer_;
+    /// Traffic statistics by message ID.
+    ea::unordered_map<int, NetworkTrafficStats> messageStats_;
+    /// Sent replication data statistics by node or component type.
+    ea::unordered_map<StringHash, NetworkTrafficStats> replicationStats_;
+    /// Smoothed round trip time variation in milliseconds.
+    float jitter_{};
+    /// Last sampled round trip time in milliseconds.
+    int lastPing_{-1};
+    /// Clock differential of the last round trip time sample, recalculated by the peer on each ping reply.
+    unsigned long long lastClockDifferential_{};
     /// Remote endpoint port.
     unsigned short port_;
     /// Observer position for interest management.
@@ -322,6 +390,8 @@ private:
     bool sceneLoaded_;
     /// Show statistics flag.
     bool logStatistics_;
+    /// Message deferral flag.
+    bool deferMessages_{};
     /// Address of this connection.
     SLNet::AddressOrGUID* address_;
     /// Raknet peer object.
@@ -0,0 +1,575 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Core/CoreEvents.h"
+#include "../Core/Profiler.h"
+#include "../IO/File.h"
+#include "../IO/FileSystem.h"
+#include "../IO/Log.h"
+#include "../Network/HttpClient.h"
+#include "../Network/NetworkEvents.h"
+#include "../Resource/ResourceCache.h"
+
+#include <Civetweb/civetweb.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+static const unsigned ERROR_BUFFER_SIZE = 256;
+static const unsigned READ_BUFFER_SIZE = 65536;
+
+/// Parsed request URL.
+struct HttpClientURL
+{
+    /// Parse URL.
+    explicit HttpClientURL(const ea::string& url)
+    {
+        unsigned protocolEnd = url.find("://");
+        if (protocolEnd != ea::string::npos)
+        {
+            protocol_ = url.substr(0, protocolEnd);
+            host_ = url.substr(protocolEnd + 3);
+        }
+        else
+            host_ = url;
+
+        unsigned pathStart = host_.find('/');
+        if (pathStart != ea::string::npos)
+        {
+            path_ = host_.substr(pathStart);
+            host_ = host_.substr(0, pathStart);
+        }
+
+        secure_ = protocol_.comparei("https") == 0;
+        unsigned portStart = host_.find(':');
+        if (portStart != ea::string::npos)
+        {
+            port_ = ToInt(host_.substr(portStart + 1));
+            host_ = host_.substr(0, portStart);
+        }
+        else if (secure_)
+            port_ = 443;
+    }
+
+    /// Return key identifying connections which can serve this URL.
+    ea::string GetConnectionKey() const { return Format("{}://{}:{}", protocol_, host_, port_); }
+
+    /// Protocol.
+    ea::string protocol_{"http"};
+    /// Host name.
+    ea::string host_;
+    /// Path with query.
+    ea::string path_{"/"};
+    /// Port.
+    int port_{80};
+    /// Whether TLS is used.
+    bool secure_{};
+};
+
+class HttpClient::Worker : public Thread
+{
+public:
+    /// Construct.
+    explicit Worker(HttpClient* client) : Thread("HttpClient"), client_(client) { }
+
+    /// Execute queued requests until queue is empty.
+    void ThreadFunction() override
+    {
+        while (shouldRun_)
+        {
+            SharedPtr<HttpClientRequest> request = client_->TakeRequest();
+            if (!request)
+                break;
+            client_->Execute(request);
+        }
+        finished_ = true;
+    }
+
+    /// Owner client.
+    HttpClient* client_{};
+    /// Whether thread function returned.
+    std::atomic<bool> finished_{false};
+};
+
+HttpClientRequest::HttpClientRequest(const ea::string& url, const ea::string& verb, const ea::vector<ea::string>& headers,
+    const ea::string& postData, const ea::string& fileName) :
+    url_(url.trimmed()),
+    verb_(!verb.empty() ? verb : "GET"),
+    headers_(headers),
+    postData_(postData),
+    fileName_(fileName)
+{
+}
+
+ea::string HttpClientRequest::GetError() const
+{
+    MutexLock lock(mutex_);
+    return error_;
+}
+
+HttpClient::HttpClient(Context* context) :
+    Object(context)
+{
+#ifdef URHO3D_SSL
+    static bool sslInitialized = false;
+    if (!sslInitialized)
+    {
+        mg_init_library(MG_FEATURES_TLS);
+        sslInitialized = true;
+    }
+#endif
+
+    SubscribeToEvent(E_BEGINFRAME, URHO3D_HANDLER(HttpClient, HandleBeginFrame));
+}
+
+HttpClient::~HttpClient()
+{
+    {
+        MutexLock lock(mutex_);
+        for (HttpClientRequest* request : queue_)
+            request->Cancel();
+        queue_.clear();
+    }
+    for (HttpClientRequest* request : active_)
+        request->Cancel();
+
+    for (auto& worker : workers_)
+        worker->Stop();
+    workers_.clear();
+
+    for (PooledConnection& pooled : pool_)
+        mg_close_connection(pooled.connection_);
+    pool_.clear();
+}
+
+SharedPtr<HttpClientRequest> HttpClient::Send(const ea::string& url, const ea::string& verb,
+    const ea::vector<ea::string>& headers, const ea::string& postData)
+{
+    return Queue(new HttpClientRequest(url, verb, headers, postData, EMPTY_STRING));
+}
+
+SharedPtr<HttpClientRequest> HttpClient::Download(const ea::string& url, const ea::string& fileName,
+    const ea::vector<ea::string>& headers)
+{
+    return Queue(new HttpClientRequest(url, "GET", headers, EMPTY_STRING, fileName));
+}
+
+SharedPtr<HttpClientRequest> HttpClient::DownloadPackage(const ea::string& url, const ea::string& fileName)
+{
+    SharedPtr<HttpClientRequest> request(new HttpClientRequest(url, "GET", {}, EMPTY_STRING, fileName));
+    request->addAsPackage_ = true;
+    return Queue(request);
+}
+
+void HttpClient::SetMaxConcurrentRequests(unsigned count)
+{
+    // Running workers finish their current requests, limit applies to workers started afterwards.
+    maxConcurrentRequests_ = Max(count, 1U);
+    StartWorkers();
+}
+
+void HttpClient::SetMaxIdleConnections(unsigned count)
+{
+    MutexLock lock(mutex_);
+    maxIdleConnections_ = count;
+    while (pool_.size() > maxIdleConnections_)
+    {
+        mg_close_connection(pool_.front().connection_);
+        pool_.pop_front();
+    }
+}
+
+unsigned HttpClient::GetNumQueuedRequests() const
+{
+    MutexLock lock(mutex_);
+    return queue_.size();
+}
+
+unsigned HttpClient::GetNumIdleConnections() const
+{
+    MutexLock lock(mutex_);
+    return pool_.size();
+}
+
+SharedPtr<HttpClientRequest> HttpClient::Queue(HttpClientRequest* request)
+{
+    SharedPtr<HttpClientRequest> result(request);
+    URHO3D_LOGDEBUG("HTTP " + request->GetVerb() + " request to URL " + request->GetURL() + " queued");
+
+#ifdef URHO3D_THREADING
+    {
+        MutexLock lock(mutex_);
+        queue_.push_back(result);
+    }
+    active_.push_back(result);
+    StartWorkers();
+#else
+    {
+        MutexLock lock(request->mutex_);
+        request->error_ = "Threading is disabled";
+    }
+    request->state_ = HTTP_ERROR;
+    active_.push_back(result);
+    URHO3D_LOGERROR("HTTP request will not execute as threading is disabled");
+#endif
+    return result;
+}
+
+void HttpClient::StartWorkers()
+{
+    // Join workers which ran out of requests
+    for (auto& worker : workers_)
+    {
+        if (worker->finished_)
+            worker->Stop();
+    }
+    workers_.erase(ea::remove_if(workers_.begin(), workers_.end(),
+        [](const ea::unique_ptr<Worker>& worker) { return !worker->IsStarted(); }), workers_.end());
+
+    const unsigned numQueued = GetNumQueuedRequests();
+    while (workers_.size() < maxConcurrentRequests_ && workers_.size() < numQueued)
+    {
+        auto worker = ea::make_unique<Worker>(this);
+        if (!worker->Run())
+        {
+            URHO3D_LOGERROR("Failed to start HTTP client worker thread");
+            break;
+        }
+        workers_.push_back(ea::move(worker));
+    }
+}
+
+SharedPtr<HttpClientRequest> HttpClient::TakeRequest()
+{
+    MutexLock lock(mutex_);
+    if (queue_.empty())
+        return nullptr;
+
+    SharedPtr<HttpClientRequest> request = queue_.front();
+    queue_.pop_front();
+    return request;
+}
+
+void HttpClient::Execute(HttpClientRequest* request)
+{
+    URHO3D_PROFILE("HttpClientRequest");
+
+    const HttpClientURL url(request->GetURL());
+    const ea::string key = url.GetConnectionKey();
+
+    ea::string error;
+    for (;;)
+    {
+        if (request->IsCancelled())
+        {
+            error = "Request cancelled";
+            break;
+        }
+
+        bool reused = true;
+        mg_connection* connection = AcquireConnection(key);
+        if (!connection)
+        {
+            reused = false;
+
+            // May block due to DNS query
+            char errorBuffer[ERROR_BUFFER_SIZE];
+            memset(errorBuffer, 0, sizeof(errorBuffer));
+            connection = mg_connect_client(url.host_.c_str(), url.port_, url.secure_ ? 1 : 0, errorBuffer, sizeof(errorBuffer));
+            if (!connection)
+            {
+                error = errorBuffer;
+                break;
+            }
+        }
+
+        bool keepAlive = false;
+        if (ExecuteOnConnection(request, connection, url.host_, url.path_, keepAlive))
+        {
+            if (keepAlive)
+                ReleaseConnection(key, connection);
+            else
+                mg_close_connection(connection);
+            return;
+        }
+
+        // Server may have closed idle connection in the meantime, retry on a new connection.
+        mg_close_connection(connection);
+        if (!reused)
+        {
+            error = request->GetError();
+            break;
+        }
+    }
+
+    {
+        MutexLock lock(request->mutex_);
+        request->error_ = error;
+    }
+    request->state_ = HTTP_ERROR;
+}
+
+bool HttpClient::ExecuteOnConnection(HttpClientRequest* request, mg_connection* connection, const ea::string& host,
+    const ea::string& path, bool& keepAlive)
+{
+    keepAlive = false;
+
+    auto setError = [request](const ea::string& error)
+    {
+        MutexLock lock(request->mutex_);
+        request->error_ = error;
+    };
+
+    ea::string headersStr;
+    for (const ea::string& header : request->headers_)
+    {
+        // Trim and only add non-empty header strings
+        ea::string trimmed = header.trimmed();
+        if (!trimmed.empty())
+            headersStr += trimmed + "\r\n";
+    }
+    if (!request->postData_.empty())
+        headersStr += Format("Content-Length: {}\r\n", request->postData_.length());
+
+    if (mg_printf(connection, "%s %s HTTP/1.1\r\nHost: %s\r\nConnection: keep-alive\r\n%s\r\n",
+        request->verb_.c_str(), path.c_str(), host.c_str(), headersStr.c_str()) <= 0)
+    {
+        setError("Failed to send request");
+        return false;
+    }
+    if (!request->postData_.empty() && mg_write(connection, request->postData_.data(), request->postData_.length()) <= 0)
+    {
+        setError("Failed to send request data");
+        return false;
+    }
+
+    char errorBuffer[ERROR_BUFFER_SIZE];
+    memset(errorBuffer, 0, sizeof(errorBuffer));
+    if (mg_get_response(connection, errorBuffer, sizeof(errorBuffer), requestTimeout_) < 0)
+    {
+        setError(errorBuffer);
+        return false;
+    }
+
+    // Response is received, request is not retried from this point
+    const mg_response_info* info = mg_get_response_info(connection);
+    if (!info)
+    {
+        setError("Bad response");
+        request->state_ = HTTP_ERROR;
+        return true;
+    }
+
+    request->statusCode_ = info->status_code;
+    request->contentLength_ = info->content_length;
+    request->state_ = HTTP_OPEN;
+
+    // Only connections with known response length can be reused, otherwise body ends when connection is closed.
+    bool canKeepAlive = info->content_length >= 0 && info->http_version && strcmp(info->http_version, "1.1") == 0;
+    for (int i = 0; i < info->num_headers; ++i)
+    {
+        const mg_header& header = info->http_headers[i];
+        if (header.name && header.value && ea::string(header.name).comparei("Connection") == 0 && ea::string(header.value).comparei("close") == 0)
+            canKeepAlive = false;
+    }
+
+    ea::unique_ptr<File> file;
+    if (!request->fileName_.empty())
+    {
+        file = ea::make_unique<File>(context_, request->fileName_, FILE_WRITE);
+        if (!file->IsOpen())
+        {
+            setError("Failed to open " + request->fileName_ + " for writing");
+            request->state_ = HTTP_ERROR;
+            return true;
+        }
+    }
+
+    const long long contentLength = info->content_length;
+    ea::vector<unsigned char> buffer(READ_BUFFER_SIZE);
+    long long received = 0;
+    ea::string error;
+    while (contentLength < 0 || received < contentLength)
+    {
+        if (request->IsCancelled())
+        {
+            error = "Request cancelled";
+            break;
+        }
+
+        size_t size = READ_BUFFER_SIZE;
+        if (contentLength >= 0)
+            size = static_cast<size_t>(Min(contentLength - received, static_cast<long long>(READ_BUFFER_SIZE)));
+
+        const int bytesRead = mg_read(connection, buffer.data(), size);
+        if (bytesRead < 0)
+        {
+            error = "Failed to read response";
+            break;
+        }
+        if (bytesRead == 0)
+        {
+            if (contentLength >= 0)
+                error = "Connection closed before response was complete";
+            break;
+        }
+
+        if (file)
+        {
+            if (file->Write(buffer.data(), static_cast<unsigned>(bytesRead)) != static_cast<unsigned>(bytesRead))
+            {
+                error = "Failed to write " + request->fileName_;
+                break;
+            }
+        }
+        else
+            request->body_.insert(request->body_.end(), buffer.data(), buffer.data() + bytesRead);
+
+        received += bytesRead;
+        request->bytesReceived_ = received;
+    }
+
+    if (file)
+        file->Close();
+
+    if (!error.empty())
+    {
+        setError(error);
+        request->state_ = HTTP_ERROR;
+        return true;
+    }
+
+    keepAlive = canKeepAlive;
+    request->state_ = HTTP_CLOSED;
+    return true;
+}
+
+mg_connection* HttpClient::AcquireConnection(const ea::string& key)
+{
+    CloseExpiredConnections();
+
+    MutexLock lock(mutex_);
+    // Most recently released connection is least likely to be closed by the server
+    for (unsigned i = pool_.size(); i-- > 0;)
+    {
+        if (pool_[i].key_ == key)
+        {
+            mg_connection* connection = pool_[i].connection_;
+            pool_.erase_at(i);
+            return connection;
+        }
+    }
+    return nullptr;
+}
+
+void HttpClient::ReleaseConnection(const ea::string& key, mg_connection* connection)
+{
+    MutexLock lock(mutex_);
+    if (maxIdleConnections_ == 0)
+    {
+        mg_close_connection(connection);
+        return;
+    }
+
+    if (pool_.size() >= maxIdleConnections_)
+    {
+        mg_close_connection(pool_.front().connection_);
+        pool_.pop_front();
+    }
+
+    PooledConnection pooled;
+    pooled.key_ = key;
+    pooled.connection_ = connection;
+    pool_.push_back(pooled);
+}
+
+void HttpClient::CloseExpiredConnections()
+{
+    MutexLock lock(mutex_);
+    const unsigned timeout = keepAliveTimeout_;
+    for (unsigned i = 0; i < pool_.size();)
+    {
+        if (pool_[i].idleTimer_.GetMSec(false) >= timeout)
+        {
+            mg_close_connection(pool_[i].connection_);
+            pool_.erase_at(i);
+        }
+        else
+            ++i;
+    }
+}
+
+void HttpClient::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
+{
+    StartWorkers();
+    CloseExpiredConnections();
+
+    if (active_.empty())
+        return;
+
+    // Events may queue new requests, so collect finished ones first
+    ea::vector<SharedPtr<HttpClientRequest>> finished;
+    for (unsigned i = 0; i < active_.size();)
+    {
+        if (active_[i]->IsFinished())
+        {
+            finished.push_back(active_[i]);
+            active_.erase_at(i);
+        }
+        else
+            ++i;
+    }
+
+    for (HttpClientRequest* request : finished)
+    {
+        const bool succeeded = request->IsSucceeded();
+        if (!request->fileName_.empty())
+        {
+            if (!succeeded)
+                GetSubsystem<FileSystem>()->Delete(request->fileName_);
+            else if (request->addAsPackage_)
+            {
+                if (auto* cache = GetSubsystem<ResourceCache>())
+                    cache->AddPackageFile(request->fileName_);
+            }
+        }
+
+        if (!succeeded)
+        {
+            URHO3D_LOGWARNING("HTTP {} request to URL {} failed: {}", request->GetVerb(), request->GetURL(),
+                request->GetState() == HTTP_ERROR ? request->GetError() : Format("status {}", request->GetStatusCode()));
+        }
+
+        using namespace HttpRequestFinished;
+        VariantMap& eventData = GetEventDataMap();
+        eventData[P_REQUEST] = request;
+        eventData[P_SUCCEEDED] = succeeded;
+        SendEvent(E_HTTPREQUESTFINISHED, eventData);
+    }
+}
+
+}
@@ -0,0 +1,214 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+/// \file
+
+#pragma once
+
+#include "../Core/Mutex.h"
+#include "../Core/Object.h"
+#include "../Core/Thread.h"
+#include "../Core/Timer.h"
+#include "../Network/HttpRequest.h"
+
+#include <EASTL/unique_ptr.h>
+
+#include <atomic>
+
+struct mg_connection;
+
+namespace Urho3D
+{
+
+class File;
+class HttpClient;
+
+/// Request executed by the pooled HTTP client. State changes and the response are written by a worker thread, the
+/// request is safe to inspect from the main thread at any time.
+class URHO3D_API HttpClientRequest : public RefCounted
+{
+    friend class HttpClient;
+
+public:
+    /// Construct.
+    HttpClientRequest(const ea::string& url, const ea::string& verb, const ea::vector<ea::string>& headers,
+        const ea::string& postData, const ea::string& fileName);
+
+    /// Cancel the request. Connection is closed once worker thread notices cancellation.
+    void Cancel() { cancelled_ = true; }
+
+    /// Return URL used in the request.
+    const ea::string& GetURL() const { return url_; }
+    /// Return verb used in the request.
+    const ea::string& GetVerb() const { return verb_; }
+    /// Return name of the file response is streamed into. Empty if response is kept in memory.
+    const ea::string& GetFileName() const { return fileName_; }
+    /// Return request state. HTTP_INITIALIZING while queued or connecting, HTTP_OPEN while response is received.
+    HttpRequestState GetState() const { return state_; }
+    /// Return HTTP status code of the response, or 0 if no response was received.
+    int GetStatusCode() const { return statusCode_; }
+    /// Return response content length, or -1 if not known.
+    long long GetContentLength() const { return contentLength_; }
+    /// Return number of response body bytes received so far.
+    long long GetBytesReceived() const { return bytesReceived_; }
+    /// Return error. Only non-empty in the error state.
+    ea::string GetError() const;
+    /// Return response body. Only valid once request is closed and response is not streamed into a file.
+    const ea::vector<unsigned char>& GetBody() const { return body_; }
+    /// Return whether request finished, successfully or not.
+    bool IsFinished() const { return state_ == HTTP_CLOSED || state_ == HTTP_ERROR; }
+    /// Return whether request finished with 2xx status code.
+    bool IsSucceeded() const { return state_ == HTTP_CLOSED && statusCode_ >= 200 && statusCode_ < 300; }
+    /// Return whether request is cancelled.
+    bool IsCancelled() const { return cancelled_; }
+
+private:
+    /// URL.
+    ea::string url_;
+    /// Verb.
+    ea::string verb_;
+    /// Headers.
+    ea::vector<ea::string> headers_;
+    /// POST data.
+    ea::string postData_;
+    /// Name of the file response is streamed into.
+    ea::string fileName_;
+    /// Response body, unless it is streamed into a file.
+    ea::vector<unsigned char> body_;
+    /// Error string. Empty if no error.
+    ea::string error_;
+    /// Mutex for error string.
+    mutable Mutex mutex_;
+    /// Request state.
+    std::atomic<HttpRequestState> state_{HTTP_INITIALIZING};
+    /// Response status code.
+    std::atomic<int> statusCode_{0};
+    /// Response content length.
+    std::atomic<long long> contentLength_{-1};
+    /// Received response body bytes.
+    std::atomic<long long> bytesReceived_{0};
+    /// Cancellation flag.
+    std::atomic<bool> cancelled_{false};
+    /// Whether downloaded file is registered as resource package on success.
+    bool addAsPackage_{};
+};
+
+/// %HTTP client which executes requests asynchronously on a limited number of worker threads and keeps idle
+/// connections alive for reuse by the following requests to the same host.
+class URHO3D_API HttpClient : public Object
+{
+    URHO3D_OBJECT(HttpClient, Object);
+
+public:
+    /// Construct.
+    explicit HttpClient(Context* context);
+    /// Destruct. Cancel pending requests and close pooled connections.
+    ~HttpClient() override;
+
+    /// Queue a request. Empty verb defaults to a GET request. Response is kept in memory.
+    SharedPtr<HttpClientRequest> Send(const ea::string& url, const ea::string& verb = EMPTY_STRING,
+        const ea::vector<ea::string>& headers = ea::vector<ea::string>(), const ea::string& postData = EMPTY_STRING);
+    /// Queue a GET request which streams response body into a file.
+    SharedPtr<HttpClientRequest> Download(const ea::string& url, const ea::string& fileName,
+        const ea::vector<ea::string>& headers = ea::vector<ea::string>());
+    /// Queue download of a resource package. Package is added to the resource cache once download succeeds.
+    SharedPtr<HttpClientRequest> DownloadPackage(const ea::string& url, const ea::string& fileName);
+
+    /// Set maximum number of requests executed at the same time.
+    void SetMaxConcurrentRequests(unsigned count);
+    /// Set maximum number of idle connections kept alive.
+    void SetMaxIdleConnections(unsigned count);
+    /// Set time in milliseconds after which idle connection is closed.
+    void SetKeepAliveTimeout(unsigned timeoutMs) { keepAliveTimeout_ = timeoutMs; }
+    /// Set response timeout in milliseconds.
+    void SetRequestTimeout(unsigned timeoutMs) { requestTimeout_ = timeoutMs; }
+
+    /// Return maximum number of requests executed at the same time.
+    unsigned GetMaxConcurrentRequests() const { return maxConcurrentRequests_; }
+    /// Return maximum number of idle connections kept alive.
+    unsigned GetMaxIdleConnections() const { return maxIdleConnections_; }
+    /// Return time in milliseconds after which idle connection is closed.
+    unsigned GetKeepAliveTimeout() const { return keepAliveTimeout_; }
+    /// Return response timeout in milliseconds.
+    unsigned GetRequestTimeout() const { return requestTimeout_; }
+    /// Return number of queued requests which were not started yet.
+    unsigned GetNumQueuedRequests() const;
+    /// Return number of idle connections kept alive.
+    unsigned GetNumIdleConnections() const;
+
+private:
+    /// Worker thread which executes queued requests.
+    class Worker;
+
+    /// Idle connection kept alive.
+    struct PooledConnection
+    {
+        /// Host, port and protocol of the connection.
+        ea::string key_;
+        /// Civetweb connection.
+        mg_connection* connection_{};
+        /// Time since connection became idle.
+        Timer idleTimer_;
+    };
+
+    /// Queue request and start workers if necessary.
+    SharedPtr<HttpClientRequest> Queue(HttpClientRequest* request);
+    /// Start workers for queued requests up to concurrency limit.
+    void StartWorkers();
+    /// Take next queued request. Return null if queue is empty. Called from worker threads.
+    SharedPtr<HttpClientRequest> TakeRequest();
+    /// Execute request. Called from worker threads.
+    void Execute(HttpClientRequest* request);
+    /// Execute request on connection. Return false if connection failed before response was received.
+    bool ExecuteOnConnection(HttpClientRequest* request, mg_connection* connection, const ea::string& host,
+        const ea::string& path, bool& keepAlive);
+    /// Take idle connection to host. Return null if none.
+    mg_connection* AcquireConnection(const ea::string& key);
+    /// Return connection to the pool, or close it if pool is full.
+    void ReleaseConnection(const ea::string& key, mg_connection* connection);
+    /// Close expired idle connections.
+    void CloseExpiredConnections();
+    /// Handle frame start. Send events for finished requests and restart workers.
+    void HandleBeginFrame(StringHash eventType, VariantMap& eventData);
+
+    /// Maximum number of concurrent requests.
+    unsigned maxConcurrentRequests_{4};
+    /// Maximum number of idle connections.
+    unsigned maxIdleConnections_{8};
+    /// Idle connection timeout.
+    std::atomic<unsigned> keepAliveTimeout_{15000};
+    /// Response timeout.
+    std::atomic<unsigned> requestTimeout_{30000};
+    /// Worker threads.
+    ea::vector<ea::unique_ptr<Worker>> workers_;
+    /// Queued requests.
+    ea::vector<SharedPtr<HttpClientRequest>> queue_;
+    /// Requests which are executed or waiting for finished event.
+    ea::vector<SharedPtr<HttpClientRequest>> active_;
+    /// Idle connections.
+    ea::vector<PooledConnection> pool_;
+    /// Mutex for queue and pool.
+    mutable Mutex mutex_;
+};
+
+}
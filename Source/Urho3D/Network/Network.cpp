@@ -24,13 +24,19 @@
 
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
+#include "../Core/FrameStatistics.h"
+#include "../Core/MemoryTracker.h"
 #include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
+#include "../Engine/Engine.h"
 #include "../Engine/EngineEvents.h"
 #include "../IO/FileSystem.h"
+#include "../Input/Input.h"
 #include "../Input/InputEvents.h"
 #include "../IO/IOEvents.h"
 #include "../IO/Log.h"
 #include "../IO/MemoryBuffer.h"
+#include "../Network/HttpClient.h"
 #include "../Network/HttpRequest.h"
 #include "../Network/Network.h"
 #include "../Network/NetworkEvents.h"
@@ -192,6 +198,8 @@ static const char* RAKNET_MESSAGEID_STRINGS[] = {
 
 static const int DEFAULT_UPDATE_FPS = 30;
 static const int SERVER_TIMEOUT_TIME = 10000;
+/// Minimum number of client connections to build their server updates in worker threads.
+static const unsigned SERVER_UPDATE_THREADED_THRESHOLD = 4;
 
 Network::Network(Context* context) :
     Object(context),
@@ -216,11 +224,14 @@ Network::Network(Context* context) :
 
     SetNATServerInfo("127.0.0.1", 61111);
 
-    // Register Network library object factories
-    RegisterNetworkLibrary(context_);
+    // Register Network library object factories. Additional Network instances, such as the ones of load testing
+    // clients, share the factories of the first one
+    if (context_->GetTypeName(Connection::GetTypeStatic()).empty())
+        RegisterNetworkLibrary(context_);
 
     SubscribeToEvent(E_BEGINFRAME, URHO3D_HANDLER(Network, HandleBeginFrame));
-    SubscribeToEvent(E_RENDERUPDATE, URHO3D_HANDLER(Network, HandleRenderUpdate));
+    if (auto* engine = GetSubsystem<Engine>())
+        engine->onRenderUpdate_.Subscribe(this, &Network::HandleRenderUpdate);
 
     // Blacklist remote events which are not to be allowed to be registered in any case
     blacklistedRemoteEvents_.insert(E_CONSOLECOMMAND);
@@ -654,6 +665,13 @@ SharedPtr<HttpRequest> Network::MakeHttpRequest(const ea::string& url, const ea:
     return request;
 }
 
+HttpClient* Network::GetHttpClient()
+{
+    if (!httpClient_)
+        httpClient_ = MakeShared<HttpClient>(context_);
+    return httpClient_;
+}
+
 void Network::BanAddress(const ea::string& address)
 {
     rakPeer_->AddToBanList(address.c_str(), 0);
@@ -699,6 +717,17 @@ bool Network::CheckRemoteEvent(StringHash eventType) const
     return allowedRemoteEvents_.contains(eventType);
 }
 
+void Network::RegisterRemoteEventSchema(StringHash eventType, const RemoteEventSchema& schema)
+{
+    remoteEventSchemas_[eventType] = schema;
+}
+
+const RemoteEventSchema* Network::GetRemoteEventSchema(StringHash eventType) const
+{
+    auto i = remoteEventSchemas_.find(eventType);
+    return i != remoteEventSchemas_.end() ? &i->second : nullptr;
+}
+
 void Network::HandleIncomingPacket(SLNet::Packet* packet, bool isServer)
 {
     unsigned char packetID = packet->data[0];
@@ -896,6 +925,8 @@ void Network::HandleIncomingPacket(SLNet::Packet* packet, bool isServer)
 void Network::Update(float timeStep)
 {
     URHO3D_PROFILE("UpdateNetwork");
+    FrameStageTimer stageTimer(context_, FS_NETWORK);
+    MemoryTagScope memoryTag(MEMORY_TAG_NETWORK);
 
     //Process all incoming messages for the server
     if (rakPeer_->IsActive())
@@ -921,12 +952,19 @@ void Network::Update(float timeStep)
 void Network::PostUpdate(float timeStep)
 {
     URHO3D_PROFILE("PostUpdateNetwork");
+    FrameStageTimer stageTimer(context_, FS_NETWORK);
+    MemoryTagScope memoryTag(MEMORY_TAG_NETWORK);
 
     // Check if periodic update should happen now
     updateAcc_ += timeStep;
     bool updateNow = updateAcc_ >= updateInterval_;
     if (updateNow)
     {
+        // Latch the latest input, so that the client controls set below are as recent as possible
+        auto* input = GetSubsystem<Input>();
+        if (serverConnection_ && input && input->GetLateLatching())
+            input->LatchInput();
+
         // Notify of the impending update to allow for example updated client controls to be set
         SendEvent(E_NETWORKUPDATE);
         updateAcc_ = fmodf(updateAcc_, updateInterval_);
@@ -934,6 +972,7 @@ void Network::PostUpdate(float timeStep)
         if (IsServerRunning())
         {
             // Collect and prepare all networked scenes
+            bool scenesTransformsResolved = true;
             {
                 URHO3D_PROFILE("PrepareServerUpdate");
 
@@ -945,17 +984,50 @@ void Network::PostUpdate(float timeStep)
                         networkScenes_.insert(scene);
                 }
 
+                // Also resolve dirty world transforms, so that interest management only reads them. Scenes with
+                // updates disabled do not queue dirty nodes, their transforms would be lazily updated by the workers
                 for (auto i = networkScenes_.begin(); i != networkScenes_.end(); ++i)
+                {
                     (*i)->PrepareNetworkUpdate();
+                    (*i)->UpdateTransforms();
+                    scenesTransformsResolved &= (*i)->IsUpdateEnabled();
+                }
             }
 
             {
                 URHO3D_PROFILE("SendServerUpdate");
 
+                auto* queue = GetSubsystem<WorkQueue>();
+                const bool threaded = queue && queue->GetNumThreads() > 0 && scenesTransformsResolved &&
+                    clientConnections_.size() >= SERVER_UPDATE_THREADED_THRESHOLD;
+
+                if (threaded)
+                {
+                    // Build the updates in parallel. Scene network state is read-only after PrepareNetworkUpdate,
+                    // and the messages are queued per connection and sent below in the original order
+                    ea::vector<Connection*> connections;
+                    connections.reserve(clientConnections_.size());
+                    for (auto i = clientConnections_.begin(); i != clientConnections_.end(); ++i)
+                    {
+                        i->second->SetDeferMessages(true);
+                        connections.push_back(i->second);
+                    }
+
+                    queue->ParallelFor(connections.size(), 1, [&connections](unsigned begin, unsigned end, unsigned)
+                    {
+                        for (unsigned i = begin; i < end; ++i)
+                            connections[i]->SendServerUpdate();
+                    });
+                    queue->Complete(M_MAX_UNSIGNED);
+                }
+
                 // Then send server updates for each client connection
                 for (auto i = clientConnections_.begin(); i != clientConnections_.end(); ++i)
                 {
-                    i->second->SendServerUpdate();
+                    if (threaded)
+                        i->second->SetDeferMessages(false);
+                    else
+                        i->second->SendServerUpdate();
                     i->second->SendRemoteEvents();
                     i->second->SendPackages();
                 }
@@ -969,6 +1041,27 @@ void Network::PostUpdate(float timeStep)
             serverConnection_->SendRemoteEvents();
         }
 
+#if URHO3D_PROFILING
+        // Plot the total traffic and the replication backlog of all connections
+        float bytesIn = 0.0f;
+        float bytesOut = 0.0f;
+        int64_t pendingNodes = 0;
+        for (auto i = clientConnections_.begin(); i != clientConnections_.end(); ++i)
+        {
+            bytesIn += i->second->GetBytesInPerSec();
+            bytesOut += i->second->GetBytesOutPerSec();
+            pendingNodes += i->second->GetNumPendingNodes();
+        }
+        if (serverConnection_)
+        {
+            bytesIn += serverConnection_->GetBytesInPerSec();
+            bytesOut += serverConnection_->GetBytesOutPerSec();
+        }
+        URHO3D_PROFILE_VALUE("NetworkBytesIn", bytesIn);
+        URHO3D_PROFILE_VALUE("NetworkBytesOut", bytesOut);
+        URHO3D_PROFILE_VALUE("NetworkPendingNodes", pendingNodes);
+#endif
+
         // Notify that the update was sent
         SendEvent(E_NETWORKUPDATESENT);
     }
@@ -981,11 +1074,9 @@ void Network::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
     Update(eventData[P_TIMESTEP].GetFloat());
 }
 
-void Network::HandleRenderUpdate(StringHash eventType, VariantMap& eventData)
+void Network::HandleRenderUpdate(UpdateEventArgs& args)
 {
-    using namespace RenderUpdate;
-
-    PostUpdate(eventData[P_TIMESTEP].GetFloat());
+    PostUpdate(args.timeStep_);
 }
 
 void Network::OnServerConnected(const SLNet::AddressOrGUID& address)
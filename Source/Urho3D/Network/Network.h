@@ -24,6 +24,7 @@
 
 #include <EASTL/hash_set.h>
 
+#include "../Core/Mutex.h"
 #include "../Core/Object.h"
 #include "../IO/VectorBuffer.h"
 #include "../Network/Connection.h"
@@ -31,9 +32,11 @@
 namespace Urho3D
 {
 
+class HttpClient;
 class HttpRequest;
 class MemoryBuffer;
 class Scene;
+struct UpdateEventArgs;
 
 /// %Network subsystem. Manages client-server communications using the UDP protocol.
 class URHO3D_API Network : public Object
@@ -97,12 +100,16 @@ public:
     void UnregisterRemoteEvent(StringHash eventType);
     /// Unregister all remote events.
     void UnregisterAllRemoteEvents();
+    /// Register a compact schema for a remote event. Event data with exactly these fields is sent as values in this order, without the keys. Must be registered identically on both ends.
+    void RegisterRemoteEventSchema(StringHash eventType, const RemoteEventSchema& schema);
     /// Set the package download cache directory.
     void SetPackageCacheDir(const ea::string& path);
     /// Trigger all client connections in the specified scene to download a package file from the server. Can be used to download additional resource packages when clients are already joined in the scene. The package must have been added as a requirement to the scene, or else the eventual download will fail.
     void SendPackageToClients(Scene* scene, PackageFile* package);
     /// Perform an HTTP request to the specified URL. Empty verb defaults to a GET request. Return a request object which can be used to read the response data.
     SharedPtr<HttpRequest> MakeHttpRequest(const ea::string& url, const ea::string& verb = EMPTY_STRING, const ea::vector<ea::string>& headers = ea::vector<ea::string>(), const ea::string& postData = EMPTY_STRING);
+    /// Return pooled asynchronous HTTP client. Created on first use.
+    HttpClient* GetHttpClient();
     /// Ban specific IP addresses.
     void BanAddress(const ea::string& address);
     /// Return network update FPS.
@@ -124,6 +131,8 @@ public:
     bool IsServerRunning() const;
     /// Return whether a remote event is allowed to be received.
     bool CheckRemoteEvent(StringHash eventType) const;
+    /// Return the schema of a remote event, or null if not registered.
+    const RemoteEventSchema* GetRemoteEventSchema(StringHash eventType) const;
 
     /// Return the package download cache directory.
     const ea::string& GetPackageCacheDir() const { return packageCacheDir_; }
@@ -132,12 +141,16 @@ public:
     void Update(float timeStep);
     /// Send outgoing messages after frame logic. Called by HandleRenderUpdate.
     void PostUpdate(float timeStep);
+    /// Return mutex guarding weak reference counts and replication state lists of nodes and components, which are shared by connections updated in parallel.
+    Mutex& GetReplicationStateMutex() { return replicationStateMutex_; }
+    /// Return mutex guarding shared initial delta updates, which are created on demand by connections updated in parallel.
+    Mutex& GetInitialUpdateMutex() { return initialUpdateMutex_; }
 
 private:
     /// Handle begin frame event.
     void HandleBeginFrame(StringHash eventType, VariantMap& eventData);
-    /// Handle render update frame event.
-    void HandleRenderUpdate(StringHash eventType, VariantMap& eventData);
+    /// Handle render update frame signal.
+    void HandleRenderUpdate(UpdateEventArgs& args);
     /// Handle server connection.
     void OnServerConnected(const SLNet::AddressOrGUID& address);
     /// Handle server disconnection.
@@ -159,8 +172,12 @@ private:
     ea::unordered_map<unsigned long, SharedPtr<Connection> > clientConnections_;
     /// Allowed remote events.
     ea::hash_set<StringHash> allowedRemoteEvents_;
+    /// Compact remote event schemas.
+    ea::unordered_map<StringHash, RemoteEventSchema> remoteEventSchemas_;
     /// Remote event fixed blacklist.
     ea::hash_set<StringHash> blacklistedRemoteEvents_;
+    /// Pooled asynchronous HTTP client.
+    SharedPtr<HttpClient> httpClient_;
     /// Networked scenes.
     ea::hash_set<Scene*> networkScenes_;
     /// Update FPS.
@@ -193,6 +210,10 @@ private:
     SLNet::RakNetGUID* remoteGUID_;
     /// Local server GUID.
     ea::string guid_;
+    /// Replication state mutex.
+    Mutex replicationStateMutex_;
+    /// Shared initial delta update mutex.
+    Mutex initialUpdateMutex_;
 };
 
 /// Register Network library objects.
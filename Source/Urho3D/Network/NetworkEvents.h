@@ -149,4 +149,11 @@ URHO3D_EVENT(E_NATMASTERDISCONNECTED, NetworkNatMasterDisconnected)
 {
 }
 
+/// HTTP client request finished, successfully or not.
+URHO3D_EVENT(E_HTTPREQUESTFINISHED, HttpRequestFinished)
+{
+    URHO3D_PARAM(P_REQUEST, Request);              // HttpClientRequest pointer
+    URHO3D_PARAM(P_SUCCEEDED, Succeeded);          // bool
+}
+
 }
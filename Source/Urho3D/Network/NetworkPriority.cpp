@@ -56,6 +56,7 @@ void NetworkPriority::RegisterObject(Context* context)
     URHO3D_ATTRIBUTE("Distance Factor", float, distanceFactor_, DEFAULT_DISTANCE_FACTOR, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Minimum Priority", float, minPriority_, DEFAULT_MIN_PRIORITY, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Always Update Owner", bool, alwaysUpdateOwner_, true, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Relevancy Distance", float, relevancyDistance_, 0.0f, AM_DEFAULT);
 }
 
 void NetworkPriority::SetBasePriority(float priority)
@@ -82,6 +83,12 @@ void NetworkPriority::SetAlwaysUpdateOwner(bool enable)
     MarkNetworkUpdate();
 }
 
+void NetworkPriority::SetRelevancyDistance(float distance)
+{
+    relevancyDistance_ = Max(distance, 0.0f);
+    MarkNetworkUpdate();
+}
+
 bool NetworkPriority::CheckUpdate(float distance, float& accumulator)
 {
     float currentPriority = Max(basePriority_ - distanceFactor_ * distance, minPriority_);
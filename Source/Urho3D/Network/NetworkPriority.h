@@ -48,6 +48,8 @@ public:
     void SetMinPriority(float priority);
     /// Set whether updates to owner should be sent always at full rate. Default true.
     void SetAlwaysUpdateOwner(bool enable);
+    /// Set relevancy distance. Nodes farther from the observer are not created or updated on the client until it comes closer. Default 0 (unlimited).
+    void SetRelevancyDistance(float distance);
 
     /// Return base priority.
     float GetBasePriority() const { return basePriority_; }
@@ -61,6 +63,12 @@ public:
     /// Return whether updates to owner should be sent always at full rate.
     bool GetAlwaysUpdateOwner() const { return alwaysUpdateOwner_; }
 
+    /// Return relevancy distance.
+    float GetRelevancyDistance() const { return relevancyDistance_; }
+
+    /// Return whether the node is within the area of interest of an observer at given distance. Called by Connection.
+    bool IsRelevant(float distance) const { return relevancyDistance_ <= 0.0f || distance <= relevancyDistance_; }
+
     /// Increment and check priority accumulator. Return true if should update. Called by Connection.
     bool CheckUpdate(float distance, float& accumulator);
 
@@ -73,6 +81,8 @@ private:
     float minPriority_;
     /// Update owner at full rate flag.
     bool alwaysUpdateOwner_;
+    /// Relevancy distance.
+    float relevancyDistance_{};
 };
 
 }
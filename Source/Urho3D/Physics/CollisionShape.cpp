@@ -37,6 +37,7 @@
 #include "../Physics/PhysicsUtils.h"
 #include "../Physics/PhysicsWorld.h"
 #include "../Physics/RigidBody.h"
+#include "../Physics/TriangleMeshBvh.h"
 #include "../Resource/ResourceCache.h"
 #include "../Resource/ResourceEvents.h"
 #include "../Scene/Scene.h"
@@ -137,6 +138,7 @@ public:
 
         // Bullet will not work properly with quantized AABB compression, if the triangle count is too large. Use a conservative
         // threshold value
+        numTriangles_ = totalTriangles;
         useQuantize_ = totalTriangles <= QUANTIZE_MAX_TRIANGLES;
     }
 
@@ -185,9 +187,12 @@ public:
             totalTriangles += meshIndex.m_numTriangles;
         }
 
+        numTriangles_ = totalTriangles;
         useQuantize_ = totalTriangles <= QUANTIZE_MAX_TRIANGLES;
     }
 
+    /// Total number of triangles.
+    unsigned numTriangles_;
     /// OK to use quantization flag.
     bool useQuantize_;
 
@@ -196,9 +201,29 @@ private:
     ea::vector<ea::shared_array<unsigned char> > dataArrays_;
 };
 
-TriangleMeshData::TriangleMeshData(Model* model, unsigned lodLevel)
+TriangleMeshData::TriangleMeshData(Model* model, unsigned lodLevel, bool useCookedBvh)
 {
     meshInterface_ = ea::make_unique<TriangleMeshInterface>(model, lodLevel);
+
+    // Building the hierarchy and the internal edge info is slow for big meshes, so prefer data cooked by the asset pipeline
+    auto* cache = model->GetSubsystem<ResourceCache>();
+    const ea::string cookedName = TriangleMeshBvh::GetCookedName(model->GetName(), lodLevel);
+    if (useCookedBvh && cache && !model->GetName().empty() && cache->Exists(cookedName))
+    {
+        auto* cookedBvh = cache->GetResource<TriangleMeshBvh>(cookedName);
+        if (cookedBvh && cookedBvh->GetBvh() && cookedBvh->GetNumTriangles() == meshInterface_->numTriangles_ &&
+            cookedBvh->IsQuantized() == meshInterface_->useQuantize_)
+        {
+            shape_ = ea::make_unique<btBvhTriangleMeshShape>(meshInterface_.get(), meshInterface_->useQuantize_, false);
+            shape_->setOptimizedBvh(cookedBvh->GetBvh());
+            shape_->setTriangleInfoMap(cookedBvh->GetTriangleInfoMap());
+            cookedBvh_ = cookedBvh;
+            return;
+        }
+
+        URHO3D_LOGWARNING("Cooked triangle mesh BVH {} does not match model {}, rebuilding", cookedName, model->GetName());
+    }
+
     shape_ = ea::make_unique<btBvhTriangleMeshShape>(meshInterface_.get(), meshInterface_->useQuantize_, true);
 
     infoMap_ = ea::make_unique<btTriangleInfoMap>();
@@ -214,6 +239,12 @@ TriangleMeshData::TriangleMeshData(CustomGeometry* custom)
     btGenerateInternalEdgeInfo(shape_.get(), infoMap_.get());
 }
 
+TriangleMeshData::~TriangleMeshData()
+{
+    // Destroy the shape before the cooked hierarchy it refers to
+    shape_.reset();
+}
+
 GImpactMeshData::GImpactMeshData(Model* model, unsigned lodLevel)
 {
     meshInterface_ = ea::make_unique<TriangleMeshInterface>(model, lodLevel);
@@ -476,6 +507,12 @@ CollisionShape::~CollisionShape()
         physicsWorld_->RemoveCollisionShape(this);
 }
 
+void CollisionShape::CompleteAsyncStep() const
+{
+    if (physicsWorld_ && physicsWorld_->IsSimulatingAsync())
+        physicsWorld_->CompleteAsyncStep();
+}
+
 void CollisionShape::RegisterObject(Context* context)
 {
     context->RegisterFactory<CollisionShape>(PHYSICS_CATEGORY);
@@ -493,6 +530,7 @@ void CollisionShape::RegisterObject(Context* context)
 
 void CollisionShape::ApplyAttributes()
 {
+    CompleteAsyncStep();
     if (recreateShape_)
     {
         UpdateShape();
@@ -502,11 +540,13 @@ void CollisionShape::ApplyAttributes()
 
 void CollisionShape::OnSetEnabled()
 {
+    CompleteAsyncStep();
     NotifyRigidBody();
 }
 
 void CollisionShape::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
 {
+    CompleteAsyncStep();
     if (debug && physicsWorld_ && shape_ && node_ && IsEnabledEffective())
     {
         // Use the rigid body's world transform if possible, as it may be different from the rendering transform
@@ -569,6 +609,7 @@ void CollisionShape::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
 
 void CollisionShape::SetBox(const Vector3& size, const Vector3& position, const Quaternion& rotation)
 {
+    CompleteAsyncStep();
     if (model_)
         UnsubscribeFromEvent(model_, E_RELOADFINISHED);
 
@@ -586,6 +627,7 @@ void CollisionShape::SetBox(const Vector3& size, const Vector3& position, const
 
 void CollisionShape::SetSphere(float diameter, const Vector3& position, const Quaternion& rotation)
 {
+    CompleteAsyncStep();
     if (model_)
         UnsubscribeFromEvent(model_, E_RELOADFINISHED);
 
@@ -603,6 +645,7 @@ void CollisionShape::SetSphere(float diameter, const Vector3& position, const Qu
 
 void CollisionShape::SetStaticPlane(const Vector3& position, const Quaternion& rotation)
 {
+    CompleteAsyncStep();
     if (model_)
         UnsubscribeFromEvent(model_, E_RELOADFINISHED);
 
@@ -619,6 +662,7 @@ void CollisionShape::SetStaticPlane(const Vector3& position, const Quaternion& r
 
 void CollisionShape::SetCylinder(float diameter, float height, const Vector3& position, const Quaternion& rotation)
 {
+    CompleteAsyncStep();
     if (model_)
         UnsubscribeFromEvent(model_, E_RELOADFINISHED);
 
@@ -636,6 +680,7 @@ void CollisionShape::SetCylinder(float diameter, float height, const Vector3& po
 
 void CollisionShape::SetCapsule(float diameter, float height, const Vector3& position, const Quaternion& rotation)
 {
+    CompleteAsyncStep();
     if (model_)
         UnsubscribeFromEvent(model_, E_RELOADFINISHED);
 
@@ -653,6 +698,7 @@ void CollisionShape::SetCapsule(float diameter, float height, const Vector3& pos
 
 void CollisionShape::SetCone(float diameter, float height, const Vector3& position, const Quaternion& rotation)
 {
+    CompleteAsyncStep();
     if (model_)
         UnsubscribeFromEvent(model_, E_RELOADFINISHED);
 
@@ -671,41 +717,48 @@ void CollisionShape::SetCone(float diameter, float height, const Vector3& positi
 void CollisionShape::SetTriangleMesh(Model* model, unsigned lodLevel, const Vector3& scale, const Vector3& position,
     const Quaternion& rotation)
 {
+    CompleteAsyncStep();
     SetModelShape(SHAPE_TRIANGLEMESH, model, lodLevel, scale, position, rotation);
 }
 
 void CollisionShape::SetCustomTriangleMesh(CustomGeometry* custom, const Vector3& scale, const Vector3& position,
     const Quaternion& rotation)
 {
+    CompleteAsyncStep();
     SetCustomShape(SHAPE_TRIANGLEMESH, custom, scale, position, rotation);
 }
 
 void CollisionShape::SetConvexHull(Model* model, unsigned lodLevel, const Vector3& scale, const Vector3& position,
     const Quaternion& rotation)
 {
+    CompleteAsyncStep();
     SetModelShape(SHAPE_CONVEXHULL, model, lodLevel, scale, position, rotation);
 }
 
 void CollisionShape::SetCustomConvexHull(CustomGeometry* custom, const Vector3& scale, const Vector3& position,
     const Quaternion& rotation)
 {
+    CompleteAsyncStep();
     SetCustomShape(SHAPE_CONVEXHULL, custom, scale, position, rotation);
 }
 
 void CollisionShape::SetGImpactMesh(Model* model, unsigned lodLevel, const Vector3& scale, const Vector3& position,
     const Quaternion& rotation)
 {
+    CompleteAsyncStep();
     SetModelShape(SHAPE_GIMPACTMESH, model, lodLevel, scale, position, rotation);
 }
 
 void CollisionShape::SetCustomGImpactMesh(CustomGeometry* custom, const Vector3& scale, const Vector3& position,
     const Quaternion& rotation)
 {
+    CompleteAsyncStep();
     SetCustomShape(SHAPE_GIMPACTMESH, custom, scale, position, rotation);
 }
 
 void CollisionShape::SetTerrain(unsigned lodLevel)
 {
+    CompleteAsyncStep();
     auto* terrain = GetComponent<Terrain>();
     if (!terrain)
     {
@@ -726,6 +779,7 @@ void CollisionShape::SetTerrain(unsigned lodLevel)
 
 void CollisionShape::SetShapeType(ShapeType type)
 {
+    CompleteAsyncStep();
     if (type != shapeType_)
     {
         shapeType_ = type;
@@ -737,6 +791,7 @@ void CollisionShape::SetShapeType(ShapeType type)
 
 void CollisionShape::SetSize(const Vector3& size)
 {
+    CompleteAsyncStep();
     if (size != size_)
     {
         size_ = size;
@@ -748,6 +803,7 @@ void CollisionShape::SetSize(const Vector3& size)
 
 void CollisionShape::SetPosition(const Vector3& position)
 {
+    CompleteAsyncStep();
     if (position != position_)
     {
         position_ = position;
@@ -758,6 +814,7 @@ void CollisionShape::SetPosition(const Vector3& position)
 
 void CollisionShape::SetRotation(const Quaternion& rotation)
 {
+    CompleteAsyncStep();
     if (rotation != rotation_)
     {
         rotation_ = rotation;
@@ -768,6 +825,7 @@ void CollisionShape::SetRotation(const Quaternion& rotation)
 
 void CollisionShape::SetTransform(const Vector3& position, const Quaternion& rotation)
 {
+    CompleteAsyncStep();
     if (position != position_ || rotation != rotation_)
     {
         position_ = position;
@@ -779,6 +837,7 @@ void CollisionShape::SetTransform(const Vector3& position, const Quaternion& rot
 
 void CollisionShape::SetMargin(float margin)
 {
+    CompleteAsyncStep();
     margin = Max(margin, 0.0f);
 
     if (margin != margin_)
@@ -792,6 +851,7 @@ void CollisionShape::SetMargin(float margin)
 
 void CollisionShape::SetModel(Model* model)
 {
+    CompleteAsyncStep();
     if (model != model_)
     {
         if (model_)
@@ -809,6 +869,7 @@ void CollisionShape::SetModel(Model* model)
 
 void CollisionShape::SetLodLevel(unsigned lodLevel)
 {
+    CompleteAsyncStep();
     if (lodLevel != lodLevel_)
     {
         lodLevel_ = lodLevel;
@@ -823,6 +884,7 @@ void CollisionShape::SetLodLevel(unsigned lodLevel)
 
 BoundingBox CollisionShape::GetWorldBoundingBox() const
 {
+    CompleteAsyncStep();
     if (shape_ && node_)
     {
         // Use the rigid body's world transform if possible, as it may be different from the rendering transform
@@ -844,6 +906,7 @@ BoundingBox CollisionShape::GetWorldBoundingBox() const
 
 void CollisionShape::NotifyRigidBody(bool updateMass)
 {
+    CompleteAsyncStep();
     btCompoundShape* compound = GetParentCompoundShape();
     if (node_ && shape_ && compound)
     {
@@ -875,6 +938,7 @@ void CollisionShape::NotifyRigidBody(bool updateMass)
 
 void CollisionShape::SetModelAttr(const ResourceRef& value)
 {
+    CompleteAsyncStep();
     auto* cache = GetSubsystem<ResourceCache>();
     model_ = cache->GetResource<Model>(value.name_);
     recreateShape_ = true;
@@ -888,6 +952,7 @@ ResourceRef CollisionShape::GetModelAttr() const
 
 void CollisionShape::ReleaseShape()
 {
+    CompleteAsyncStep();
     btCompoundShape* compound = GetParentCompoundShape();
     if (shape_ && compound)
     {
@@ -946,6 +1011,7 @@ void CollisionShape::OnSceneSet(Scene* scene)
 
 void CollisionShape::OnMarkedDirty(Node* node)
 {
+    CompleteAsyncStep();
     Vector3 newWorldScale = node_->GetWorldScale();
     if (HasWorldScaleChanged(cachedWorldScale_, newWorldScale) && shape_)
     {
@@ -992,6 +1058,7 @@ void CollisionShape::OnMarkedDirty(Node* node)
 
 btCompoundShape* CollisionShape::GetParentCompoundShape()
 {
+    CompleteAsyncStep();
     if (!rigidBody_)
         rigidBody_ = GetComponent<RigidBody>();
 
@@ -1000,6 +1067,7 @@ btCompoundShape* CollisionShape::GetParentCompoundShape()
 
 void CollisionShape::UpdateShape()
 {
+    CompleteAsyncStep();
     URHO3D_PROFILE("UpdateCollisionShape");
 
     ReleaseShape();
@@ -1097,6 +1165,7 @@ void CollisionShape::UpdateShape()
 
 void CollisionShape::UpdateCachedGeometryShape(CollisionGeometryDataCache& cache)
 {
+    CompleteAsyncStep();
     Scene* scene = GetScene();
     size_ = size_.Abs();
     if (customGeometryID_ && scene)
@@ -1139,6 +1208,7 @@ void CollisionShape::UpdateCachedGeometryShape(CollisionGeometryDataCache& cache
 void CollisionShape::SetModelShape(ShapeType shapeType, Model* model, unsigned lodLevel,
     const Vector3& scale, const Vector3& position, const Quaternion& rotation)
 {
+    CompleteAsyncStep();
     if (!model)
     {
         URHO3D_LOGERROR("Null model, can not set collsion shape");
@@ -1164,6 +1234,7 @@ void CollisionShape::SetModelShape(ShapeType shapeType, Model* model, unsigned l
 void CollisionShape::SetCustomShape(ShapeType shapeType, CustomGeometry* custom,
     const Vector3& scale, const Vector3& position, const Quaternion& rotation)
 {
+    CompleteAsyncStep();
     if (!custom)
     {
         URHO3D_LOGERROR("Null custom geometry, can not set collsion shape");
@@ -1193,6 +1264,7 @@ void CollisionShape::SetCustomShape(ShapeType shapeType, CustomGeometry* custom,
 
 btCollisionShape* CollisionShape::UpdateDerivedShape(int shapeType, const Vector3& newWorldScale)
 {
+    CompleteAsyncStep();
     // To be overridden in derived classes.
     return nullptr;
 }
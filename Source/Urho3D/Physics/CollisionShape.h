@@ -47,6 +47,7 @@ class Model;
 class PhysicsWorld;
 class RigidBody;
 class Terrain;
+class TriangleMeshBvh;
 class TriangleMeshInterface;
 
 /// Collision shape type.
@@ -76,17 +77,21 @@ using CollisionGeometryDataCache = ea::unordered_map<ea::pair<Model*, unsigned>,
 /// Triangle mesh geometry data.
 struct TriangleMeshData : public CollisionGeometryData
 {
-    /// Construct from a model.
-    TriangleMeshData(Model* model, unsigned lodLevel);
+    /// Construct from a model. Use the cooked hierarchy of the model, if it exists and matches the model.
+    TriangleMeshData(Model* model, unsigned lodLevel, bool useCookedBvh = true);
     /// Construct from a custom geometry.
     explicit TriangleMeshData(CustomGeometry* custom);
+    /// Destruct.
+    ~TriangleMeshData();
 
     /// Bullet triangle mesh interface.
     ea::unique_ptr<TriangleMeshInterface> meshInterface_;
     /// Bullet triangle mesh collision shape.
     ea::unique_ptr<btBvhTriangleMeshShape> shape_;
-    /// Bullet triangle info map.
+    /// Bullet triangle info map. Null if the cooked hierarchy is used.
     ea::unique_ptr<btTriangleInfoMap> infoMap_;
+    /// Cooked hierarchy and triangle info map shared with other physics worlds.
+    SharedPtr<TriangleMeshBvh> cookedBvh_;
 };
 
 /// Triangle mesh geometry data.
@@ -268,6 +273,8 @@ protected:
     virtual btCollisionShape* UpdateDerivedShape(int shapeType, const Vector3& newWorldScale);
 
 private:
+    /// Complete an asynchronous simulation step of the physics world before the Bullet objects are accessed from the main thread.
+    void CompleteAsyncStep() const;
     /// Find the parent rigid body component and return its compound collision shape.
     btCompoundShape* GetParentCompoundShape();
     /// Update the collision shape after attribute changes.
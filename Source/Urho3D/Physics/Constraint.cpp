@@ -79,6 +79,12 @@ Constraint::~Constraint()
         physicsWorld_->RemoveConstraint(this);
 }
 
+void Constraint::CompleteAsyncStep() const
+{
+    if (physicsWorld_ && physicsWorld_->IsSimulatingAsync())
+        physicsWorld_->CompleteAsyncStep();
+}
+
 void Constraint::RegisterObject(Context* context)
 {
     context->RegisterFactory<Constraint>(PHYSICS_CATEGORY);
@@ -99,6 +105,7 @@ void Constraint::RegisterObject(Context* context)
 
 void Constraint::ApplyAttributes()
 {
+    CompleteAsyncStep();
     if (recreateConstraint_)
     {
         if (otherBody_)
@@ -125,6 +132,7 @@ void Constraint::ApplyAttributes()
 
 void Constraint::OnSetEnabled()
 {
+    CompleteAsyncStep();
     if (constraint_)
         constraint_->setEnabled(IsEnabledEffective());
 }
@@ -137,6 +145,7 @@ void Constraint::GetDependencyNodes(ea::vector<Node*>& dest)
 
 void Constraint::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
 {
+    CompleteAsyncStep();
     if (debug && physicsWorld_ && constraint_)
     {
         physicsWorld_->SetDebugRenderer(debug);
@@ -148,6 +157,7 @@ void Constraint::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
 
 void Constraint::SetConstraintType(ConstraintType type)
 {
+    CompleteAsyncStep();
     if (type != constraintType_ || !constraint_)
     {
         constraintType_ = type;
@@ -158,6 +168,7 @@ void Constraint::SetConstraintType(ConstraintType type)
 
 void Constraint::SetOtherBody(RigidBody* body)
 {
+    CompleteAsyncStep();
     if (otherBody_ != body)
     {
         if (otherBody_)
@@ -176,6 +187,7 @@ void Constraint::SetOtherBody(RigidBody* body)
 
 void Constraint::SetPosition(const Vector3& position)
 {
+    CompleteAsyncStep();
     if (position != position_)
     {
         position_ = position;
@@ -186,6 +198,7 @@ void Constraint::SetPosition(const Vector3& position)
 
 void Constraint::SetRotation(const Quaternion& rotation)
 {
+    CompleteAsyncStep();
     if (rotation != rotation_)
     {
         rotation_ = rotation;
@@ -196,6 +209,7 @@ void Constraint::SetRotation(const Quaternion& rotation)
 
 void Constraint::SetAxis(const Vector3& axis)
 {
+    CompleteAsyncStep();
     switch (constraintType_)
     {
     case CONSTRAINT_POINT:
@@ -218,6 +232,7 @@ void Constraint::SetAxis(const Vector3& axis)
 
 void Constraint::SetOtherPosition(const Vector3& position)
 {
+    CompleteAsyncStep();
     if (position != otherPosition_)
     {
         otherPosition_ = position;
@@ -228,6 +243,7 @@ void Constraint::SetOtherPosition(const Vector3& position)
 
 void Constraint::SetOtherRotation(const Quaternion& rotation)
 {
+    CompleteAsyncStep();
     if (rotation != otherRotation_)
     {
         otherRotation_ = rotation;
@@ -238,6 +254,7 @@ void Constraint::SetOtherRotation(const Quaternion& rotation)
 
 void Constraint::SetOtherAxis(const Vector3& axis)
 {
+    CompleteAsyncStep();
     switch (constraintType_)
     {
     case CONSTRAINT_POINT:
@@ -260,6 +277,7 @@ void Constraint::SetOtherAxis(const Vector3& axis)
 
 void Constraint::SetWorldPosition(const Vector3& position)
 {
+    CompleteAsyncStep();
     if (constraint_)
     {
         btTransform ownBodyInverse = constraint_->getRigidBodyA().getWorldTransform().inverse();
@@ -281,6 +299,7 @@ void Constraint::SetWorldPosition(const Vector3& position)
 
 void Constraint::SetHighLimit(const Vector2& limit)
 {
+    CompleteAsyncStep();
     if (limit != highLimit_)
     {
         highLimit_ = limit;
@@ -291,6 +310,7 @@ void Constraint::SetHighLimit(const Vector2& limit)
 
 void Constraint::SetLowLimit(const Vector2& limit)
 {
+    CompleteAsyncStep();
     if (limit != lowLimit_)
     {
         lowLimit_ = limit;
@@ -301,6 +321,7 @@ void Constraint::SetLowLimit(const Vector2& limit)
 
 void Constraint::SetERP(float erp)
 {
+    CompleteAsyncStep();
     erp = Max(erp, 0.0f);
 
     if (erp != erp_)
@@ -313,6 +334,7 @@ void Constraint::SetERP(float erp)
 
 void Constraint::SetCFM(float cfm)
 {
+    CompleteAsyncStep();
     cfm = Max(cfm, 0.0f);
 
     if (cfm != cfm_)
@@ -325,6 +347,7 @@ void Constraint::SetCFM(float cfm)
 
 void Constraint::SetDisableCollision(bool disable)
 {
+    CompleteAsyncStep();
     if (disable != disableCollision_)
     {
         disableCollision_ = disable;
@@ -335,6 +358,7 @@ void Constraint::SetDisableCollision(bool disable)
 
 Vector3 Constraint::GetWorldPosition() const
 {
+    CompleteAsyncStep();
     if (constraint_)
     {
         btTransform ownBody = constraint_->getRigidBodyA().getWorldTransform();
@@ -346,6 +370,7 @@ Vector3 Constraint::GetWorldPosition() const
 
 void Constraint::ReleaseConstraint()
 {
+    CompleteAsyncStep();
     if (constraint_)
     {
         if (ownBody_)
@@ -362,6 +387,7 @@ void Constraint::ReleaseConstraint()
 
 void Constraint::ApplyFrames()
 {
+    CompleteAsyncStep();
     if (!constraint_ || !node_ || (otherBody_ && !otherBody_->GetNode()))
         return;
 
@@ -450,13 +476,25 @@ void Constraint::OnSceneSet(Scene* scene)
 
 void Constraint::OnMarkedDirty(Node* node)
 {
+    CompleteAsyncStep();
     /// \todo This does not catch the connected body node's scale changing
     if (HasWorldScaleChanged(cachedWorldScale_, node->GetWorldScale()))
+    {
+        // Physics operations are not safe from worker threads
+        Scene* scene = GetScene();
+        if (scene && scene->IsThreadedUpdate())
+        {
+            scene->DelayedMarkedDirty(this);
+            return;
+        }
+
         ApplyFrames();
+    }
 }
 
 void Constraint::CreateConstraint()
 {
+    CompleteAsyncStep();
     URHO3D_PROFILE("CreateConstraint");
 
     cachedWorldScale_ = node_->GetWorldScale();
@@ -538,6 +576,7 @@ void Constraint::CreateConstraint()
 
 void Constraint::ApplyLimits()
 {
+    CompleteAsyncStep();
     if (!constraint_)
         return;
 
@@ -579,6 +618,7 @@ void Constraint::ApplyLimits()
 
 void Constraint::AdjustOtherBodyPosition()
 {
+    CompleteAsyncStep();
     // Convenience for editing static constraints: if not connected to another body, adjust world position to match local
     // (when deserializing, the proper other body position will be read after own position, so this calculation is safely
     // overridden and does not accumulate constraint error
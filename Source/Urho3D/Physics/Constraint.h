@@ -156,6 +156,8 @@ protected:
     void OnMarkedDirty(Node* node) override;
 
 private:
+    /// Complete an asynchronous simulation step of the physics world before the Bullet objects are accessed from the main thread.
+    void CompleteAsyncStep() const;
     /// Create the constraint.
     void CreateConstraint();
     /// Apply high and low constraint limits.
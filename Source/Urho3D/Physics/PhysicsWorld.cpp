@@ -25,8 +25,13 @@
 #include <EASTL/sort.h>
 
 #include "../Core/Context.h"
+#include "../Core/CoreEvents.h"
+#include "../Core/FrameStatistics.h"
 #include "../Core/Mutex.h"
+#include "../Core/MemoryTracker.h"
 #include "../Core/Profiler.h"
+#include "../Core/Thread.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/Model.h"
 #include "../IO/Log.h"
@@ -38,8 +43,12 @@
 #include "../Physics/PhysicsWorld.h"
 #include "../Physics/RaycastVehicle.h"
 #include "../Physics/RigidBody.h"
+#include "../Physics/TriangleMeshBvh.h"
 #include "../Scene/Scene.h"
 #include "../Scene/SceneEvents.h"
+#ifdef URHO3D_SYSTEMUI
+#include "../SystemUI/DebugHud.h"
+#endif
 
 #include <Bullet/BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
 #include <Bullet/BulletCollision/CollisionDispatch/btDefaultCollisionConfiguration.h>
@@ -49,6 +58,10 @@
 #include <Bullet/BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h>
 #include <Bullet/BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolver.h>
 #include <Bullet/BulletDynamics/Dynamics/btDiscreteDynamicsWorld.h>
+#include <Bullet/BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#include <Bullet/BulletDynamics/Dynamics/btSimulationIslandManagerMt.h>
+
+#include <thread>
 
 
 extern ContactAddedCallback gContactAddedCallback;
@@ -147,6 +160,215 @@ struct PhysicsQueryCallback : public btCollisionWorld::ContactResultCallback
     unsigned collisionMask_;
 };
 
+/// Callback for batched broadphase overlap queries.
+struct PhysicsOverlapCallback : public btBroadphaseAabbCallback
+{
+    /// Construct.
+    PhysicsOverlapCallback(ea::vector<ea::pair<unsigned, RigidBody*>>& result, unsigned queryIndex, unsigned collisionMask) :
+        result_(result),
+        queryIndex_(queryIndex),
+        collisionMask_(collisionMask)
+    {
+    }
+
+    /// Add an overlapping broadphase proxy.
+    bool process(const btBroadphaseProxy* proxy) override
+    {
+        auto* object = static_cast<btCollisionObject*>(proxy->m_clientObject);
+        auto* body = object ? static_cast<RigidBody*>(object->getUserPointer()) : nullptr;
+        if (body && (body->GetCollisionLayer() & collisionMask_))
+            result_.emplace_back(queryIndex_, body);
+        return true;
+    }
+
+    /// Found rigid bodies.
+    ea::vector<ea::pair<unsigned, RigidBody*>>& result_;
+    /// Index of the query.
+    unsigned queryIndex_;
+    /// Collision mask for the query.
+    unsigned collisionMask_;
+};
+
+/// Number of batched physics queries executed per work item.
+static const unsigned PHYSICS_QUERY_BATCH_GRAIN = 16;
+/// Factor for raising or lowering the deactivation scale when the active body budget is exceeded or met again.
+static const float DEACTIVATION_SCALE_STEP = 1.25f;
+/// Maximum deactivation scale.
+static const float MAX_DEACTIVATION_SCALE = 16.0f;
+
+/// Bullet dynamics world that measures the phases of the simulation step and applies the deactivation scale.
+template <class T> class PhysicsDynamicsWorld : public T
+{
+public:
+    /// Construct.
+    PhysicsDynamicsWorld(PhysicsWorldStatistics& statistics, btDispatcher* dispatcher, btBroadphaseInterface* broadphase,
+        btConstraintSolver* solver, btCollisionConfiguration* collisionConfiguration) :
+        T(dispatcher, broadphase, solver, collisionConfiguration),
+        statistics_(statistics)
+    {
+    }
+
+    /// Perform one simulation substep.
+    void internalSingleStepSimulation(btScalar timeStep) override
+    {
+        ++statistics_.numSubSteps_;
+        T::internalSingleStepSimulation(timeStep);
+    }
+
+    /// Perform collision detection.
+    void performDiscreteCollisionDetection() override
+    {
+        URHO3D_PROFILE("PhysicsCollisionDetection");
+        HiresTimer timer;
+        T::performDiscreteCollisionDetection();
+        statistics_.collisionTime_ += timer.GetUSec(false) / 1000.0f;
+    }
+
+    /// Build simulation islands.
+    void calculateSimulationIslands() override
+    {
+        URHO3D_PROFILE("PhysicsIslands");
+        HiresTimer timer;
+        T::calculateSimulationIslands();
+        statistics_.islandTime_ += timer.GetUSec(false) / 1000.0f;
+    }
+
+    /// Solve constraints and contacts.
+    void solveConstraints(btContactSolverInfo& solverInfo) override
+    {
+        URHO3D_PROFILE("PhysicsSolveConstraints");
+        HiresTimer timer;
+        T::solveConstraints(solverInfo);
+        statistics_.solverTime_ += timer.GetUSec(false) / 1000.0f;
+    }
+
+    /// Integrate body transforms.
+    void integrateTransforms(btScalar timeStep) override
+    {
+        URHO3D_PROFILE("PhysicsIntegrateTransforms");
+        HiresTimer timer;
+        T::integrateTransforms(timeStep);
+        statistics_.integrationTime_ += timer.GetUSec(false) / 1000.0f;
+    }
+
+    /// Update body activation states using the rest thresholds multiplied by the deactivation scale.
+    void updateActivationState(btScalar timeStep) override
+    {
+        const float scale = statistics_.deactivationScale_;
+        if (scale == 1.0f)
+        {
+            T::updateActivationState(timeStep);
+            return;
+        }
+
+        // Scale the thresholds only for the duration of the update, so that the rest threshold attributes stay intact
+        btAlignedObjectArray<btRigidBody*>& bodies = this->m_nonStaticRigidBodies;
+        thresholds_.resize(bodies.size());
+        for (int i = 0; i < bodies.size(); ++i)
+        {
+            thresholds_[i] = ea::make_pair(bodies[i]->getLinearSleepingThreshold(), bodies[i]->getAngularSleepingThreshold());
+            bodies[i]->setSleepingThresholds(thresholds_[i].first * scale, thresholds_[i].second * scale);
+        }
+
+        T::updateActivationState(timeStep);
+
+        for (int i = 0; i < bodies.size(); ++i)
+            bodies[i]->setSleepingThresholds(thresholds_[i].first, thresholds_[i].second);
+    }
+
+private:
+    /// Statistics of the owning physics world.
+    PhysicsWorldStatistics& statistics_;
+    /// Unscaled rest thresholds of the bodies.
+    ea::vector<ea::pair<btScalar, btScalar>> thresholds_;
+};
+
+#if BT_THREADSAFE
+/// Work queue thread index of the thread solving a simulation island.
+static thread_local unsigned physicsSolverThreadIndex = 0;
+/// Work queue of the world stepped on the current thread. Bullet's island dispatch function does not take user data,
+/// so it is set for the duration of the step. Null when islands should be solved serially.
+static thread_local WorkQueue* physicsStepWorkQueue = nullptr;
+
+/// Constraint solver with one sequential impulse solver per work queue thread, so that islands can be solved in parallel.
+class PhysicsSolverPool : public btConstraintSolver
+{
+public:
+    /// Construct.
+    explicit PhysicsSolverPool(unsigned numThreads)
+    {
+        solvers_.resize(numThreads);
+        for (auto& solver : solvers_)
+            solver = ea::make_unique<btSequentialImpulseConstraintSolver>();
+    }
+
+    /// Prepare all solvers.
+    void prepareSolve(int numBodies, int numManifolds) override
+    {
+        for (auto& solver : solvers_)
+            solver->prepareSolve(numBodies, numManifolds);
+    }
+
+    /// Solve island with the solver of the current thread.
+    btScalar solveGroup(btCollisionObject** bodies, int numBodies, btPersistentManifold** manifolds, int numManifolds,
+        btTypedConstraint** constraints, int numConstraints, const btContactSolverInfo& info, btIDebugDraw* debugDrawer,
+        btDispatcher* dispatcher) override
+    {
+        return solvers_[physicsSolverThreadIndex]->solveGroup(bodies, numBodies, manifolds, numManifolds, constraints,
+            numConstraints, info, debugDrawer, dispatcher);
+    }
+
+    /// Finish all solvers.
+    void allSolved(const btContactSolverInfo& info, btIDebugDraw* debugDrawer) override
+    {
+        for (auto& solver : solvers_)
+            solver->allSolved(info, debugDrawer);
+    }
+
+    /// Reset all solvers.
+    void reset() override
+    {
+        for (auto& solver : solvers_)
+            solver->reset();
+    }
+
+    /// Return solver type.
+    btConstraintSolverType getSolverType() const override { return BT_SEQUENTIAL_IMPULSE_SOLVER; }
+
+private:
+    /// Solvers by work queue thread index.
+    ea::vector<ea::unique_ptr<btSequentialImpulseConstraintSolver>> solvers_;
+};
+
+/// Solve simulation islands in parallel on the work queue.
+static void DispatchPhysicsIslands(btAlignedObjectArray<btSimulationIslandManagerMt::Island*>* islandsPtr,
+    btSimulationIslandManagerMt::IslandCallback* callback)
+{
+    btAlignedObjectArray<btSimulationIslandManagerMt::Island*>& islands = *islandsPtr;
+    const auto solveIslands = [&islands, callback](unsigned begin, unsigned end, unsigned threadIndex)
+    {
+        physicsSolverThreadIndex = threadIndex;
+        for (unsigned i = begin; i < end; ++i)
+        {
+            btSimulationIslandManagerMt::Island* island = islands[i];
+            btPersistentManifold** manifolds = island->manifoldArray.size() ? &island->manifoldArray[0] : nullptr;
+            btTypedConstraint** constraints = island->constraintArray.size() ? &island->constraintArray[0] : nullptr;
+            callback->processIsland(&island->bodyArray[0], island->bodyArray.size(), manifolds, island->manifoldArray.size(),
+                constraints, island->constraintArray.size(), island->id);
+        }
+        physicsSolverThreadIndex = 0;
+    };
+
+    if (physicsStepWorkQueue)
+    {
+        physicsStepWorkQueue->ParallelFor(islands.size(), 1, solveIslands);
+        physicsStepWorkQueue->Complete(M_MAX_UNSIGNED);
+    }
+    else
+        solveIslands(0, islands.size(), 0);
+}
+#endif
+
 PhysicsWorld::PhysicsWorld(Context* context) :
     Component(context),
     fps_(DEFAULT_FPS),
@@ -163,8 +385,25 @@ PhysicsWorld::PhysicsWorld(Context* context) :
     btGImpactCollisionAlgorithm::registerAlgorithm(static_cast<btCollisionDispatcher*>(collisionDispatcher_.get()));
 
     broadphase_ = ea::make_unique<btDbvtBroadphase>();
-    solver_ = ea::make_unique<btSequentialImpulseConstraintSolver>();
-    world_ = ea::make_unique<btDiscreteDynamicsWorld>(collisionDispatcher_.get(), broadphase_.get(), solver_.get(), collisionConfiguration_);
+
+#if BT_THREADSAFE
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    multithreaded_ = PhysicsWorld::config.multithreaded_ && workQueue && workQueue->GetNumThreads() > 0;
+    if (multithreaded_)
+    {
+        workQueue_ = workQueue;
+        solver_ = ea::make_unique<PhysicsSolverPool>(workQueue->GetNumThreads() + 1);
+        world_ = ea::make_unique<PhysicsDynamicsWorld<btDiscreteDynamicsWorldMt>>(statistics_, collisionDispatcher_.get(),
+            broadphase_.get(), solver_.get(), collisionConfiguration_);
+        static_cast<btSimulationIslandManagerMt*>(world_->getSimulationIslandManager())->setIslandDispatchFunction(DispatchPhysicsIslands);
+    }
+    else
+#endif
+    {
+        solver_ = ea::make_unique<btSequentialImpulseConstraintSolver>();
+        world_ = ea::make_unique<PhysicsDynamicsWorld<btDiscreteDynamicsWorld>>(statistics_, collisionDispatcher_.get(),
+            broadphase_.get(), solver_.get(), collisionConfiguration_);
+    }
 
     world_->setGravity(ToBtVector3(DEFAULT_GRAVITY));
     world_->getDispatchInfo().m_useContinuous = true;
@@ -177,6 +416,10 @@ PhysicsWorld::PhysicsWorld(Context* context) :
 
 PhysicsWorld::~PhysicsWorld()
 {
+    // Scene nodes may already be destroyed, so discard the results of an unfinished step
+    WaitForAsyncStep();
+    asyncWorldTransforms_.clear();
+
     if (scene_)
     {
         // Force all remaining constraints, rigid bodies and collision shapes to release themselves
@@ -211,8 +454,11 @@ void PhysicsWorld::RegisterObject(Context* context)
     URHO3D_ACCESSOR_ATTRIBUTE("Solver Iterations", GetNumIterations, SetNumIterations, int, 10, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Net Max Angular Vel.", float, maxNetworkAngularVelocity_, DEFAULT_MAX_NETWORK_ANGULAR_VELOCITY, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Interpolation", bool, interpolation_, true, AM_FILE);
+    URHO3D_ACCESSOR_ATTRIBUTE("Async Simulation", GetAsyncSimulation, SetAsyncSimulation, bool, false, AM_FILE);
     URHO3D_ATTRIBUTE("Internal Edge Utility", bool, internalEdge_, true, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Split Impulse", GetSplitImpulse, SetSplitImpulse, bool, false, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Max Active Bodies", unsigned, maxActiveBodies_, 0, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Collision Events", bool, collisionEventsEnabled_, true, AM_DEFAULT);
 }
 
 bool PhysicsWorld::isVisible(const btVector3& aabbMin, const btVector3& aabbMax)
@@ -235,6 +481,8 @@ void PhysicsWorld::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
     {
         URHO3D_PROFILE("PhysicsDrawDebug");
 
+        CompleteAsyncStep();
+
         debugRenderer_ = debug;
         debugDepthTest_ = depthTest;
         world_->debugDrawWorld();
@@ -259,6 +507,36 @@ void PhysicsWorld::draw3dText(const btVector3& location, const char* textString)
 void PhysicsWorld::Update(float timeStep)
 {
     URHO3D_PROFILE("UpdatePhysics");
+    FrameStageTimer stageTimer(context_, FS_PHYSICS);
+    MemoryTagScope memoryTag(MEMORY_TAG_PHYSICS);
+
+    // Without worker threads an asynchronous step would only run at the end of the frame, so step synchronously
+    auto* workQueue = asyncSimulation_ ? GetSubsystem<WorkQueue>() : nullptr;
+    if (workQueue && workQueue->GetNumThreads())
+    {
+        BeginAsyncStep(workQueue, timeStep);
+        return;
+    }
+
+    FinishAsyncStep();
+
+    delayedWorldTransforms_.clear();
+    simulating_ = true;
+    StepSimulation(timeStep);
+    simulating_ = false;
+
+    ApplyDelayedWorldTransforms();
+    ReportStatistics();
+}
+
+void PhysicsWorld::StepSimulation(float timeStep)
+{
+    HiresTimer stepTimer;
+    statistics_.numSubSteps_ = 0;
+    statistics_.collisionTime_ = 0.0f;
+    statistics_.islandTime_ = 0.0f;
+    statistics_.solverTime_ = 0.0f;
+    statistics_.integrationTime_ = 0.0f;
 
     float internalTimeStep = 1.0f / fps_;
     int maxSubSteps = (int)(timeStep * fps_) + 1;
@@ -270,8 +548,10 @@ void PhysicsWorld::Update(float timeStep)
     else if (maxSubSteps_ > 0)
         maxSubSteps = Min(maxSubSteps, maxSubSteps_);
 
-    delayedWorldTransforms_.clear();
-    simulating_ = true;
+#if BT_THREADSAFE
+    // The work queue can only be driven from the main thread, so an asynchronous step solves its islands serially
+    physicsStepWorkQueue = multithreaded_ && Thread::IsMainThread() ? workQueue_ : nullptr;
+#endif
 
     if (interpolation_)
         world_->stepSimulation(timeStep, maxSubSteps, internalTimeStep);
@@ -286,8 +566,188 @@ void PhysicsWorld::Update(float timeStep)
         }
     }
 
+#if BT_THREADSAFE
+    physicsStepWorkQueue = nullptr;
+#endif
+
+    statistics_.stepTime_ = stepTimer.GetUSec(false) / 1000.0f;
+    UpdateStatistics();
+}
+
+void PhysicsWorld::UpdateStatistics()
+{
+    statistics_.numBroadphasePairs_ = broadphase_->getOverlappingPairCache()->getNumOverlappingPairs();
+    statistics_.numManifolds_ = collisionDispatcher_->getNumManifolds();
+    statistics_.numContacts_ = 0;
+    for (unsigned i = 0; i < statistics_.numManifolds_; ++i)
+        statistics_.numContacts_ += collisionDispatcher_->getManifoldByIndexInternal(i)->getNumContacts();
+    statistics_.numSolverIterations_ = world_->getSolverInfo().m_numIterations;
+
+    // Island tags are union-find roots, so they index the collision object array
+    const btCollisionObjectArray& objects = world_->getCollisionObjectArray();
+    islandMarks_.clear();
+    islandMarks_.resize(objects.size());
+    statistics_.numIslands_ = 0;
+    statistics_.numActiveBodies_ = 0;
+    statistics_.numSleepingBodies_ = 0;
+    statistics_.numStaticBodies_ = 0;
+    for (int i = 0; i < objects.size(); ++i)
+    {
+        const btCollisionObject* object = objects[i];
+        if (object->isStaticOrKinematicObject())
+        {
+            ++statistics_.numStaticBodies_;
+            continue;
+        }
+
+        if (object->isActive())
+            ++statistics_.numActiveBodies_;
+        else
+            ++statistics_.numSleepingBodies_;
+
+        const int islandTag = object->getIslandTag();
+        if (islandTag >= 0 && islandTag < objects.size() && !islandMarks_[islandTag])
+        {
+            islandMarks_[islandTag] = true;
+            ++statistics_.numIslands_;
+        }
+    }
+
+    // Raise the rest thresholds while over the budget, and lower them back once well below it
+    float& scale = statistics_.deactivationScale_;
+    if (maxActiveBodies_ && statistics_.numActiveBodies_ > maxActiveBodies_)
+        scale = Min(scale * DEACTIVATION_SCALE_STEP, MAX_DEACTIVATION_SCALE);
+    else if (!maxActiveBodies_ || statistics_.numActiveBodies_ * 4 < maxActiveBodies_ * 3)
+        scale = Max(scale / DEACTIVATION_SCALE_STEP, 1.0f);
+}
+
+void PhysicsWorld::ReportStatistics()
+{
+#if URHO3D_PROFILING
+    URHO3D_PROFILE_VALUE("PhysicsActiveBodies", static_cast<int64_t>(statistics_.numActiveBodies_));
+    URHO3D_PROFILE_VALUE("PhysicsSleepingBodies", static_cast<int64_t>(statistics_.numSleepingBodies_));
+    URHO3D_PROFILE_VALUE("PhysicsIslands", static_cast<int64_t>(statistics_.numIslands_));
+    URHO3D_PROFILE_VALUE("PhysicsBroadphasePairs", static_cast<int64_t>(statistics_.numBroadphasePairs_));
+    URHO3D_PROFILE_VALUE("PhysicsContacts", static_cast<int64_t>(statistics_.numContacts_));
+    URHO3D_PROFILE_VALUE("PhysicsStepTime", statistics_.stepTime_);
+#endif
+
+#ifdef URHO3D_SYSTEMUI
+    if (auto* debugHud = GetSubsystem<DebugHud>())
+    {
+        debugHud->SetAppStats("Physics", Format("{} active, {} sleeping, {} islands, {} contacts, {:.2f} ms",
+            statistics_.numActiveBodies_, statistics_.numSleepingBodies_, statistics_.numIslands_, statistics_.numContacts_,
+            statistics_.stepTime_));
+    }
+#endif
+}
+
+ea::string PhysicsWorld::PrintStatistics() const
+{
+    const PhysicsWorldStatistics& stats = statistics_;
+    ea::string output;
+    output += Format("Substeps {}, solver iterations {}\n", stats.numSubSteps_, stats.numSolverIterations_);
+    output += Format("Bodies {} active, {} sleeping, {} static, {} islands\n", stats.numActiveBodies_,
+        stats.numSleepingBodies_, stats.numStaticBodies_, stats.numIslands_);
+    output += Format("Broadphase pairs {}, manifolds {}, contacts {}\n", stats.numBroadphasePairs_, stats.numManifolds_,
+        stats.numContacts_);
+    output += Format("Deactivation scale {:.2f}\n", stats.deactivationScale_);
+    output += Format("Step {:.2f} ms: collision {:.2f}, islands {:.2f}, solver {:.2f}, integration {:.2f}\n",
+        stats.stepTime_, stats.collisionTime_, stats.islandTime_, stats.solverTime_, stats.integrationTime_);
+    return output;
+}
+
+void PhysicsWorld::BeginAsyncStep(WorkQueue* workQueue, float timeStep)
+{
+    // Finish the previous step in case the frame did not end since it was started
+    FinishAsyncStep();
+
+    // Events are sent from the main thread once per frame instead of from the substep callbacks
+    simulating_ = true;
+    PreStep(timeStep);
     simulating_ = false;
 
+    // Bullet reads kinematic body transforms during the step, so capture them while the nodes can be safely accessed
+    for (RigidBody* body : rigidBodies_)
+    {
+        if (body->IsKinematic())
+            body->CacheKinematicWorldTransform();
+    }
+
+    delayedWorldTransforms_.clear();
+    asyncWorldTransforms_.clear();
+    asyncTimeStep_ = timeStep;
+    asyncStepping_ = true;
+
+    // Use a private item, so that a pooled item can not be recycled before the step is waited for
+    asyncStepItem_ = MakeShared<WorkItem>();
+    asyncStepItem_->aux_ = this;
+    asyncStepItem_->priority_ = 0;
+    asyncStepItem_->workFunction_ = [](const WorkItem* item, unsigned)
+    {
+        auto* physicsWorld = static_cast<PhysicsWorld*>(item->aux_);
+        physicsWorld->StepSimulation(physicsWorld->asyncTimeStep_);
+    };
+    workQueue->AddWorkItem(asyncStepItem_);
+}
+
+void PhysicsWorld::WaitForAsyncStep()
+{
+    if (!asyncStepping_)
+        return;
+
+    URHO3D_PROFILE("WaitPhysicsStep");
+
+    // If the step has not been started yet, take it from the queue and run it here
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    if (!workQueue || workQueue->RemoveWorkItem(asyncStepItem_))
+        asyncStepItem_->workFunction_(asyncStepItem_, 0);
+    else
+    {
+        while (!asyncStepItem_->completed_)
+            std::this_thread::yield();
+    }
+
+    asyncStepItem_.Reset();
+    asyncStepping_ = false;
+}
+
+void PhysicsWorld::CompleteAsyncStep()
+{
+    // Worker threads can not wait for the step. Physics components defer their node dirty handling to the main thread
+    // during threaded scene update
+    if (!asyncStepping_ || !Thread::IsMainThread())
+        return;
+
+    WaitForAsyncStep();
+
+    URHO3D_PROFILE("ApplyPhysicsStep");
+
+    // Apply the transforms of all moved bodies in one pass
+    for (const DelayedWorldTransform& transform : asyncWorldTransforms_)
+        transform.rigidBody_->SetSimulatedWorldTransform(transform.worldPosition_, transform.worldRotation_);
+    asyncWorldTransforms_.clear();
+
+    ApplyDelayedWorldTransforms();
+    ReportStatistics();
+    asyncEventsPending_ = true;
+}
+
+void PhysicsWorld::FinishAsyncStep()
+{
+    CompleteAsyncStep();
+
+    if (asyncEventsPending_)
+    {
+        asyncEventsPending_ = false;
+        simulating_ = true;
+        PostStep(asyncTimeStep_);
+        simulating_ = false;
+    }
+}
+
+void PhysicsWorld::ApplyDelayedWorldTransforms()
+{
     // Apply delayed (parented) world transforms now
     while (!delayedWorldTransforms_.empty())
     {
@@ -351,6 +811,25 @@ void PhysicsWorld::SetInterpolation(bool enable)
     interpolation_ = enable;
 }
 
+void PhysicsWorld::SetMaxActiveBodies(unsigned num)
+{
+    maxActiveBodies_ = num;
+    MarkNetworkUpdate();
+}
+
+void PhysicsWorld::SetCollisionEventsEnabled(bool enable)
+{
+    collisionEventsEnabled_ = enable;
+    MarkNetworkUpdate();
+}
+
+void PhysicsWorld::SetAsyncSimulation(bool enable)
+{
+    if (!enable)
+        CompleteAsyncStep();
+    asyncSimulation_ = enable;
+}
+
 void PhysicsWorld::SetInternalEdge(bool enable)
 {
     internalEdge_ = enable;
@@ -376,6 +855,8 @@ void PhysicsWorld::Raycast(ea::vector<PhysicsRaycastResult>& result, const Ray&
 {
     URHO3D_PROFILE("PhysicsRaycast");
 
+    CompleteAsyncStep();
+
     if (maxDistance >= M_INFINITY)
         URHO3D_LOGWARNING("Infinite maxDistance in physics raycast is not supported");
 
@@ -404,6 +885,8 @@ void PhysicsWorld::RaycastSingle(PhysicsRaycastResult& result, const Ray& ray, f
 {
     URHO3D_PROFILE("PhysicsRaycastSingle");
 
+    CompleteAsyncStep();
+
     if (maxDistance >= M_INFINITY)
         URHO3D_LOGWARNING("Infinite maxDistance in physics raycast is not supported");
 
@@ -436,6 +919,8 @@ void PhysicsWorld::RaycastSingleSegmented(PhysicsRaycastResult& result, const Ra
 {
     URHO3D_PROFILE("PhysicsRaycastSingleSegmented");
 
+    CompleteAsyncStep();
+
     assert(overlapDistance < segmentDistance);
 
     if (maxDistance >= M_INFINITY)
@@ -488,6 +973,8 @@ void PhysicsWorld::SphereCast(PhysicsRaycastResult& result, const Ray& ray, floa
 {
     URHO3D_PROFILE("PhysicsSphereCast");
 
+    CompleteAsyncStep();
+
     if (maxDistance >= M_INFINITY)
         URHO3D_LOGWARNING("Infinite maxDistance in physics sphere cast is not supported");
 
@@ -523,6 +1010,8 @@ void PhysicsWorld::SphereCast(PhysicsRaycastResult& result, const Ray& ray, floa
 void PhysicsWorld::ConvexCast(PhysicsRaycastResult& result, CollisionShape* shape, const Vector3& startPos,
     const Quaternion& startRot, const Vector3& endPos, const Quaternion& endRot, unsigned collisionMask)
 {
+    CompleteAsyncStep();
+
     if (!shape || !shape->GetCollisionShape())
     {
         URHO3D_LOGERROR("Null collision shape for convex cast");
@@ -625,6 +1114,8 @@ void PhysicsWorld::GetRigidBodies(ea::vector<RigidBody*>& result, const Sphere&
 {
     URHO3D_PROFILE("PhysicsSphereQuery");
 
+    CompleteAsyncStep();
+
     result.clear();
 
     btSphereShape sphereShape(sphere.radius_);
@@ -644,6 +1135,8 @@ void PhysicsWorld::GetRigidBodies(ea::vector<RigidBody*>& result, const Bounding
 {
     URHO3D_PROFILE("PhysicsBoxQuery");
 
+    CompleteAsyncStep();
+
     result.clear();
 
     btBoxShape boxShape(ToBtVector3(box.HalfSize()));
@@ -662,6 +1155,8 @@ void PhysicsWorld::GetRigidBodies(ea::vector<RigidBody*>& result, const RigidBod
 {
     URHO3D_PROFILE("PhysicsBodyQuery");
 
+    CompleteAsyncStep();
+
     result.clear();
 
     if (!body || !body->GetBody())
@@ -703,6 +1198,102 @@ void PhysicsWorld::GetCollidingBodies(ea::vector<RigidBody*>& result, const Rigi
     }
 }
 
+void PhysicsWorld::GetContactPairs(ea::vector<PhysicsContactPair>& result, unsigned collisionMask) const
+{
+    result.clear();
+
+    for (const PhysicsContactPair& pair : contactPairs_)
+    {
+        if ((pair.bodyA_->GetCollisionLayer() & collisionMask) || (pair.bodyB_->GetCollisionLayer() & collisionMask))
+            result.push_back(pair);
+    }
+}
+
+void PhysicsWorld::ExecuteQueries(PhysicsQueryBatch& batch)
+{
+    URHO3D_PROFILE("PhysicsQueryBatch");
+
+    CompleteAsyncStep();
+
+    if (simulating_)
+    {
+        URHO3D_LOGERROR("Physics queries can not be executed during a simulation step");
+        return;
+    }
+
+    const unsigned numQueries = batch.queries_.size();
+    batch.hits_.resize(numQueries);
+
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    const unsigned numThreads = workQueue ? workQueue->GetNumThreads() + 1 : 1;
+    batch.threadOverlaps_.resize(numThreads);
+    for (auto& threadOverlaps : batch.threadOverlaps_)
+        threadOverlaps.clear();
+
+    // The world is not modified while the calling thread waits, so the queries only read it
+    const auto executeQueries = [this, &batch](unsigned begin, unsigned end, unsigned threadIndex)
+    {
+        for (unsigned i = begin; i < end; ++i)
+        {
+            const PhysicsQueryBatch::Query& query = batch.queries_[i];
+            PhysicsRaycastResult& hit = batch.hits_[i];
+            switch (query.type_)
+            {
+            case PHYSICS_QUERY_RAYCAST:
+                RaycastSingle(hit, query.ray_, query.maxDistance_, query.collisionMask_);
+                break;
+
+            case PHYSICS_QUERY_SPHERECAST:
+                SphereCast(hit, query.ray_, query.radius_, query.maxDistance_, query.collisionMask_);
+                break;
+
+            case PHYSICS_QUERY_OVERLAP:
+                {
+                    hit = PhysicsRaycastResult{};
+                    PhysicsOverlapCallback callback(batch.threadOverlaps_[threadIndex], i, query.collisionMask_);
+                    world_->getBroadphase()->aabbTest(ToBtVector3(query.box_.min_), ToBtVector3(query.box_.max_), callback);
+                }
+                break;
+            }
+        }
+    };
+
+    // Bullet ray tests share traversal stacks unless it is built thread-safe
+#if BT_THREADSAFE
+    if (numThreads > 1 && numQueries > PHYSICS_QUERY_BATCH_GRAIN)
+    {
+        workQueue->ParallelFor(numQueries, PHYSICS_QUERY_BATCH_GRAIN, executeQueries);
+        workQueue->Complete(M_MAX_UNSIGNED);
+    }
+    else
+#endif
+        executeQueries(0, numQueries, 0);
+
+    // Group overlapping bodies by query index
+    batch.overlapRanges_.clear();
+    batch.overlapRanges_.resize(numQueries);
+    for (const auto& threadOverlaps : batch.threadOverlaps_)
+    {
+        for (const auto& overlap : threadOverlaps)
+            ++batch.overlapRanges_[overlap.first].second;
+    }
+
+    unsigned offset = 0;
+    for (auto& range : batch.overlapRanges_)
+    {
+        range.first = offset;
+        offset += range.second;
+        range.second = range.first;
+    }
+
+    batch.overlaps_.resize(offset);
+    for (const auto& threadOverlaps : batch.threadOverlaps_)
+    {
+        for (const auto& overlap : threadOverlaps)
+            batch.overlaps_[batch.overlapRanges_[overlap.first].second++] = overlap.second;
+    }
+}
+
 Vector3 PhysicsWorld::GetGravity() const
 {
     return ToVector3(world_->getGravity());
@@ -720,14 +1311,19 @@ bool PhysicsWorld::GetSplitImpulse() const
 
 void PhysicsWorld::AddRigidBody(RigidBody* body)
 {
+    CompleteAsyncStep();
     rigidBodies_.push_back(body);
 }
 
 void PhysicsWorld::RemoveRigidBody(RigidBody* body)
 {
+    CompleteAsyncStep();
     rigidBodies_.erase_first(body);
     // Remove possible dangling pointer from the delayedWorldTransforms structure
     delayedWorldTransforms_.erase(body);
+    // Also from the contact stream. Pairs refer to contact points by index, so the points can stay
+    ea::erase_if(contactPairs_, [body](const PhysicsContactPair& pair) { return pair.bodyA_ == body || pair.bodyB_ == body; });
+    ea::erase_if(endedContactPairs_, [body](const ea::pair<RigidBody*, RigidBody*>& pair) { return pair.first == body || pair.second == body; });
 }
 
 void PhysicsWorld::AddCollisionShape(CollisionShape* shape)
@@ -742,11 +1338,13 @@ void PhysicsWorld::RemoveCollisionShape(CollisionShape* shape)
 
 void PhysicsWorld::AddConstraint(Constraint* constraint)
 {
+    CompleteAsyncStep();
     constraints_.push_back(constraint);
 }
 
 void PhysicsWorld::RemoveConstraint(Constraint* constraint)
 {
+    CompleteAsyncStep();
     constraints_.erase_first(constraint);
 }
 
@@ -786,9 +1384,14 @@ void PhysicsWorld::OnSceneSet(Scene* scene)
     {
         scene_ = GetScene();
         SubscribeToEvent(scene_, E_SCENESUBSYSTEMUPDATE, URHO3D_HANDLER(PhysicsWorld, HandleSceneSubsystemUpdate));
+        SubscribeToEvent(E_ENDFRAME, URHO3D_HANDLER(PhysicsWorld, HandleEndFrame));
     }
     else
+    {
+        CompleteAsyncStep();
         UnsubscribeFromEvent(E_SCENESUBSYSTEMUPDATE);
+        UnsubscribeFromEvent(E_ENDFRAME);
+    }
 }
 
 void PhysicsWorld::HandleSceneSubsystemUpdate(StringHash eventType, VariantMap& eventData)
@@ -800,8 +1403,17 @@ void PhysicsWorld::HandleSceneSubsystemUpdate(StringHash eventType, VariantMap&
     Update(eventData[P_TIMESTEP].GetFloat());
 }
 
+void PhysicsWorld::HandleEndFrame(StringHash eventType, VariantMap& eventData)
+{
+    FinishAsyncStep();
+}
+
 void PhysicsWorld::PreStep(float timeStep)
 {
+    // Substep callbacks of an asynchronous step run on a worker thread, where events can not be sent
+    if (asyncStepping_)
+        return;
+
     // Send pre-step event
     using namespace PhysicsPreStep;
 
@@ -816,6 +1428,9 @@ void PhysicsWorld::PreStep(float timeStep)
 
 void PhysicsWorld::PostStep(float timeStep)
 {
+    if (asyncStepping_)
+        return;
+
     // URHO3D_PROFILE_END();
 
     SendCollisionEvents();
@@ -834,15 +1449,11 @@ void PhysicsWorld::SendCollisionEvents()
     URHO3D_PROFILE("SendCollisionEvents");
 
     currentCollisions_.clear();
-    physicsCollisionData_.clear();
-    nodeCollisionData_.clear();
 
     int numManifolds = collisionDispatcher_->getNumManifolds();
 
     if (numManifolds)
     {
-        physicsCollisionData_[PhysicsCollision::P_WORLD] = this;
-
         for (int i = 0; i < numManifolds; ++i)
         {
             btPersistentManifold* contactManifold = collisionDispatcher_->getManifoldByIndexInternal(i);
@@ -885,6 +1496,77 @@ void PhysicsWorld::SendCollisionEvents()
                 currentCollisions_[bodyPair].flippedManifold_ = contactManifold;
             }
         }
+    }
+
+    BuildContactStream();
+    if (collisionEventsEnabled_)
+        SendContactEvents();
+
+    previousCollisions_ = currentCollisions_;
+}
+
+void PhysicsWorld::BuildContactStream()
+{
+    contactPairs_.clear();
+    contactPoints_.clear();
+    endedContactPairs_.clear();
+
+    const auto appendContacts = [this](btPersistentManifold* contactManifold, float normalSign)
+    {
+        if (!contactManifold)
+            return;
+
+        for (int j = 0; j < contactManifold->getNumContacts(); ++j)
+        {
+            const btManifoldPoint& point = contactManifold->getContactPoint(j);
+            contactPoints_.push_back(PhysicsContactPoint{ ToVector3(point.m_positionWorldOnB),
+                ToVector3(point.m_normalWorldOnB) * normalSign, point.m_distance1, point.m_appliedImpulse });
+        }
+    };
+
+    for (const auto& [bodies, manifolds] : currentCollisions_)
+    {
+        PhysicsContactPair pair;
+        pair.bodyA_ = bodies.first;
+        pair.bodyB_ = bodies.second;
+        pair.firstContact_ = contactPoints_.size();
+        pair.new_ = !previousCollisions_.contains(bodies);
+        pair.trigger_ = pair.bodyA_->IsTrigger() || pair.bodyB_->IsTrigger();
+
+        appendContacts(manifolds.manifold_, 1.0f);
+        appendContacts(manifolds.flippedManifold_, -1.0f);
+        pair.numContacts_ = contactPoints_.size() - pair.firstContact_;
+        contactPairs_.push_back(pair);
+    }
+
+    for (const auto& [bodies, manifolds] : previousCollisions_)
+    {
+        RigidBody* bodyA = bodies.first;
+        RigidBody* bodyB = bodies.second;
+        if (!bodyA || !bodyB || currentCollisions_.contains(bodies))
+            continue;
+
+        // Apply the same filtering as collision end events
+        if (bodyA->GetMass() == 0.0f && bodyB->GetMass() == 0.0f)
+            continue;
+        if (bodyA->GetCollisionEventMode() == COLLISION_NEVER || bodyB->GetCollisionEventMode() == COLLISION_NEVER)
+            continue;
+        if (bodyA->GetCollisionEventMode() == COLLISION_ACTIVE && bodyB->GetCollisionEventMode() == COLLISION_ACTIVE &&
+            !bodyA->IsActive() && !bodyB->IsActive())
+            continue;
+
+        endedContactPairs_.emplace_back(bodyA, bodyB);
+    }
+}
+
+void PhysicsWorld::SendContactEvents()
+{
+    physicsCollisionData_.clear();
+    nodeCollisionData_.clear();
+
+    if (!currentCollisions_.empty())
+    {
+        physicsCollisionData_[PhysicsCollision::P_WORLD] = this;
 
         for (auto i = currentCollisions_.begin();
              i != currentCollisions_.end(); ++i)
@@ -1071,8 +1753,41 @@ void PhysicsWorld::SendCollisionEvents()
             }
         }
     }
+}
 
-    previousCollisions_ = currentCollisions_;
+void PhysicsQueryBatch::Clear()
+{
+    queries_.clear();
+    hits_.clear();
+    overlaps_.clear();
+    overlapRanges_.clear();
+}
+
+unsigned PhysicsQueryBatch::AddRaycast(const Ray& ray, float maxDistance, unsigned collisionMask)
+{
+    queries_.push_back(Query{ PHYSICS_QUERY_RAYCAST, ray, BoundingBox{}, 0.0f, maxDistance, collisionMask });
+    return queries_.size() - 1;
+}
+
+unsigned PhysicsQueryBatch::AddSphereCast(const Ray& ray, float radius, float maxDistance, unsigned collisionMask)
+{
+    queries_.push_back(Query{ PHYSICS_QUERY_SPHERECAST, ray, BoundingBox{}, radius, maxDistance, collisionMask });
+    return queries_.size() - 1;
+}
+
+unsigned PhysicsQueryBatch::AddOverlap(const BoundingBox& box, unsigned collisionMask)
+{
+    queries_.push_back(Query{ PHYSICS_QUERY_OVERLAP, Ray{}, box, 0.0f, 0.0f, collisionMask });
+    return queries_.size() - 1;
+}
+
+ea::span<RigidBody* const> PhysicsQueryBatch::GetOverlaps(unsigned index) const
+{
+    if (index >= overlapRanges_.size())
+        return {};
+
+    const auto& range = overlapRanges_[index];
+    return { overlaps_.data() + range.first, range.second - range.first };
 }
 
 void RegisterPhysicsLibrary(Context* context)
@@ -1082,6 +1797,7 @@ void RegisterPhysicsLibrary(Context* context)
     Constraint::RegisterObject(context);
     PhysicsWorld::RegisterObject(context);
     RaycastVehicle::RegisterObject(context);
+    TriangleMeshBvh::RegisterObject(context);
 }
 
 }
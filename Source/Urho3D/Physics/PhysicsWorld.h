@@ -22,10 +22,12 @@
 
 #pragma once
 
+#include <EASTL/span.h>
 #include <EASTL/unique_ptr.h>
 
 #include "../IO/VectorBuffer.h"
 #include "../Math/BoundingBox.h"
+#include "../Math/Ray.h"
 #include "../Math/Sphere.h"
 #include "../Math/Vector3.h"
 #include "../Scene/Component.h"
@@ -49,13 +51,14 @@ class Deserializer;
 class Constraint;
 class Model;
 class Node;
-class Ray;
 class RigidBody;
 class Scene;
 class Serializer;
+class WorkQueue;
 class XMLElement;
 
 struct CollisionGeometryData;
+struct WorkItem;
 
 /// Physics raycast hit.
 struct URHO3D_API PhysicsRaycastResult
@@ -78,6 +81,103 @@ struct URHO3D_API PhysicsRaycastResult
     RigidBody* body_{};
 };
 
+/// Type of a batched physics world query.
+enum PhysicsQueryType
+{
+    PHYSICS_QUERY_RAYCAST = 0,
+    PHYSICS_QUERY_SPHERECAST,
+    PHYSICS_QUERY_OVERLAP
+};
+
+/// Batch of physics world queries executed together by PhysicsWorld::ExecuteQueries. Results are stored contiguously by query index.
+class URHO3D_API PhysicsQueryBatch
+{
+    friend class PhysicsWorld;
+
+public:
+    /// Remove all queries and results.
+    void Clear();
+    /// Add a closest hit raycast. Return query index.
+    unsigned AddRaycast(const Ray& ray, float maxDistance, unsigned collisionMask = M_MAX_UNSIGNED);
+    /// Add a closest hit swept sphere test. Return query index.
+    unsigned AddSphereCast(const Ray& ray, float radius, float maxDistance, unsigned collisionMask = M_MAX_UNSIGNED);
+    /// Add a rigid body bounding box overlap test. Return query index.
+    unsigned AddOverlap(const BoundingBox& box, unsigned collisionMask = M_MAX_UNSIGNED);
+
+    /// Return number of queries.
+    unsigned GetNumQueries() const { return queries_.size(); }
+    /// Return closest hits of all queries. Overlap queries have an empty hit.
+    const ea::vector<PhysicsRaycastResult>& GetHits() const { return hits_; }
+    /// Return closest hit of a raycast or sphere cast query.
+    const PhysicsRaycastResult& GetHit(unsigned index) const { return hits_[index]; }
+    /// Return rigid bodies whose bounding boxes overlap the box of an overlap query.
+    ea::span<RigidBody* const> GetOverlaps(unsigned index) const;
+
+private:
+    /// Query description.
+    struct Query
+    {
+        /// Query type.
+        PhysicsQueryType type_;
+        /// Ray for raycasts and sphere casts.
+        Ray ray_;
+        /// Box for overlap tests.
+        BoundingBox box_;
+        /// Sphere radius.
+        float radius_;
+        /// Maximum distance.
+        float maxDistance_;
+        /// Collision mask.
+        unsigned collisionMask_;
+    };
+
+    /// Queries.
+    ea::vector<Query> queries_;
+    /// Closest hits by query index.
+    ea::vector<PhysicsRaycastResult> hits_;
+    /// Overlapping bodies of all queries, grouped by query index.
+    ea::vector<RigidBody*> overlaps_;
+    /// Start and end offsets into overlaps_ by query index.
+    ea::vector<ea::pair<unsigned, unsigned>> overlapRanges_;
+    /// Per-thread overlap results as query index and rigid body pairs.
+    ea::vector<ea::vector<ea::pair<unsigned, RigidBody*>>> threadOverlaps_;
+};
+
+/// Physics world statistics of the last simulation step.
+struct PhysicsWorldStatistics
+{
+    /// Number of simulation substeps.
+    unsigned numSubSteps_{};
+    /// Number of overlapping broadphase pairs.
+    unsigned numBroadphasePairs_{};
+    /// Number of narrowphase contact manifolds.
+    unsigned numManifolds_{};
+    /// Number of narrowphase contact points.
+    unsigned numContacts_{};
+    /// Number of simulation islands with dynamic bodies.
+    unsigned numIslands_{};
+    /// Number of active dynamic bodies.
+    unsigned numActiveBodies_{};
+    /// Number of sleeping dynamic bodies.
+    unsigned numSleepingBodies_{};
+    /// Number of static and kinematic bodies.
+    unsigned numStaticBodies_{};
+    /// Number of constraint solver iterations per substep.
+    unsigned numSolverIterations_{};
+    /// Scale applied to the rest thresholds of all bodies to stay within the active body budget.
+    float deactivationScale_{1.0f};
+    /// Total time of the step in milliseconds.
+    float stepTime_{};
+    /// Time spent in collision detection in milliseconds.
+    float collisionTime_{};
+    /// Time spent in building simulation islands in milliseconds.
+    float islandTime_{};
+    /// Time spent in the constraint solver in milliseconds.
+    float solverTime_{};
+    /// Time spent in integrating the body transforms in milliseconds.
+    float integrationTime_{};
+};
+
 /// Delayed world transform assignment for parented rigidbodies.
 struct DelayedWorldTransform
 {
@@ -107,16 +207,49 @@ struct ManifoldPair
     btPersistentManifold* flippedManifold_;
 };
 
+/// Contact point of the batched contact stream.
+struct PhysicsContactPoint
+{
+    /// Contact worldspace position.
+    Vector3 position_;
+    /// Contact worldspace normal, pointing from body B towards body A.
+    Vector3 normal_;
+    /// Contact distance, negative on penetration.
+    float distance_{};
+    /// Applied impulse.
+    float impulse_{};
+};
+
+/// Colliding body pair of the batched contact stream. Pointers are valid until the next simulation step, unless the bodies are destroyed.
+struct PhysicsContactPair
+{
+    /// First rigid body.
+    RigidBody* bodyA_{};
+    /// Second rigid body.
+    RigidBody* bodyB_{};
+    /// Index of the first contact point.
+    unsigned firstContact_{};
+    /// Number of contact points.
+    unsigned numContacts_{};
+    /// Whether the collision started on this step.
+    bool new_{};
+    /// Whether either body is a trigger.
+    bool trigger_{};
+};
+
 /// Custom overrides of physics internals. To use overrides, must be set before the physics component is created.
 struct PhysicsWorldConfig
 {
     PhysicsWorldConfig() :
-        collisionConfig_(nullptr)
+        collisionConfig_(nullptr),
+        multithreaded_(false)
     {
     }
 
     /// Override for the collision configuration (default btDefaultCollisionConfiguration).
     btCollisionConfiguration* collisionConfig_;
+    /// Whether to solve simulation islands in parallel on the work queue. Requires Bullet built with BT_THREADSAFE and at least one worker thread.
+    bool multithreaded_;
 };
 
 static const int DEFAULT_FPS = 60;
@@ -178,10 +311,16 @@ public:
     void SetUpdateEnabled(bool enable);
     /// Set whether to interpolate between simulation steps.
     void SetInterpolation(bool enable);
+    /// Set whether to step the simulation on a worker thread while the frame is rendered. The results are applied at the end of the frame. Disabled by default.
+    void SetAsyncSimulation(bool enable);
     /// Set whether to use Bullet's internal edge utility for trimesh collisions. Disabled by default.
     void SetInternalEdge(bool enable);
     /// Set split impulse collision mode. This is more accurate, but slower. Disabled by default.
     void SetSplitImpulse(bool enable);
+    /// Set the active dynamic body budget. When exceeded, the rest thresholds of all bodies are raised to put more of them to sleep. 0 (default) is unlimited.
+    void SetMaxActiveBodies(unsigned num);
+    /// Set whether to send collision events. When disabled, collisions are only available through the contact stream. Enabled by default.
+    void SetCollisionEventsEnabled(bool enable);
     /// Set maximum angular velocity for network replication.
     void SetMaxNetworkAngularVelocity(float velocity);
     /// Perform a physics world raycast and return all hits.
@@ -211,6 +350,10 @@ public:
     void GetRigidBodies(ea::vector<RigidBody*>& result, const RigidBody* body);
     /// Return rigid bodies that have been in collision with the specified body on the last simulation step. Only returns collisions that were sent as events (depends on collision event mode) and excludes e.g. static-static collisions.
     void GetCollidingBodies(ea::vector<RigidBody*>& result, const RigidBody* body);
+    /// Return colliding body pairs of the last simulation step, where either body's collision layer matches the mask.
+    void GetContactPairs(ea::vector<PhysicsContactPair>& result, unsigned collisionMask = M_MAX_UNSIGNED) const;
+    /// Execute a batch of queries, in parallel on the work queue when physics is built thread-safe. Must not be called during a simulation step.
+    void ExecuteQueries(PhysicsQueryBatch& batch);
 
     /// Return gravity.
     Vector3 GetGravity() const;
@@ -227,6 +370,9 @@ public:
     /// Return whether interpolation between simulation steps is enabled.
     bool GetInterpolation() const { return interpolation_; }
 
+    /// Return whether the simulation is stepped asynchronously.
+    bool GetAsyncSimulation() const { return asyncSimulation_; }
+
     /// Return whether Bullet's internal edge utility for trimesh collisions is enabled.
     bool GetInternalEdge() const { return internalEdge_; }
 
@@ -239,6 +385,29 @@ public:
     /// Return maximum angular velocity for network replication.
     float GetMaxNetworkAngularVelocity() const { return maxNetworkAngularVelocity_; }
 
+    /// Return whether collision events are sent.
+    bool GetCollisionEventsEnabled() const { return collisionEventsEnabled_; }
+
+    /// Return colliding body pairs of the last simulation step. Filtered the same as collision events.
+    const ea::vector<PhysicsContactPair>& GetContactPairs() const { return contactPairs_; }
+    /// Return contact points of the last simulation step, grouped by contact pair.
+    const ea::vector<PhysicsContactPoint>& GetContactPoints() const { return contactPoints_; }
+    /// Return contact points of a contact pair.
+    ea::span<const PhysicsContactPoint> GetContactPoints(const PhysicsContactPair& pair) const
+    {
+        return { contactPoints_.data() + pair.firstContact_, pair.numContacts_ };
+    }
+    /// Return body pairs whose collision ended on the last simulation step.
+    const ea::vector<ea::pair<RigidBody*, RigidBody*>>& GetEndedContactPairs() const { return endedContactPairs_; }
+
+    /// Return the active dynamic body budget.
+    unsigned GetMaxActiveBodies() const { return maxActiveBodies_; }
+
+    /// Return statistics of the last simulation step.
+    const PhysicsWorldStatistics& GetStatistics() const { return statistics_; }
+    /// Return statistics of the last simulation step as text.
+    ea::string PrintStatistics() const;
+
     /// Add a rigid body to keep track of. Called by RigidBody.
     void AddRigidBody(RigidBody* body);
     /// Remove a rigid body. Called by RigidBody.
@@ -261,7 +430,19 @@ public:
     void SetDebugDepthTest(bool enable);
 
     /// Return the Bullet physics world.
-    btDiscreteDynamicsWorld* GetWorld() { return world_.get(); }
+    btDiscreteDynamicsWorld* GetWorld()
+    {
+        if (asyncStepping_)
+            CompleteAsyncStep();
+        return world_.get();
+    }
+
+    /// Wait for an asynchronous simulation step to finish and apply its transforms to the scene nodes. Called automatically before accessing the Bullet world from the main thread.
+    void CompleteAsyncStep();
+    /// Return whether an asynchronous simulation step is in progress.
+    bool IsSimulatingAsync() const { return asyncStepping_; }
+    /// Add a world transform produced by an asynchronous simulation step. Called by RigidBody from the simulating thread.
+    void AddAsyncWorldTransform(const DelayedWorldTransform& transform) { asyncWorldTransforms_.push_back(transform); }
 
     /// Clean up the geometry cache.
     void CleanupGeometryCache();
@@ -287,6 +468,9 @@ public:
     /// Overrides of the internal configuration.
     static struct PhysicsWorldConfig config;
 
+    /// Return whether simulation islands are solved in parallel.
+    bool IsMultithreaded() const { return multithreaded_; }
+
 protected:
     /// Handle scene being assigned.
     void OnSceneSet(Scene* scene) override;
@@ -294,12 +478,32 @@ protected:
 private:
     /// Handle the scene subsystem update event, step simulation here.
     void HandleSceneSubsystemUpdate(StringHash eventType, VariantMap& eventData);
+    /// Handle the end of frame event, finish the asynchronous simulation step here.
+    void HandleEndFrame(StringHash eventType, VariantMap& eventData);
+    /// Step the Bullet world by the frame time step.
+    void StepSimulation(float timeStep);
+    /// Start stepping the Bullet world on a worker thread.
+    void BeginAsyncStep(WorkQueue* workQueue, float timeStep);
+    /// Wait for the asynchronous simulation step without applying its results.
+    void WaitForAsyncStep();
+    /// Complete the asynchronous simulation step and send its post-step events.
+    void FinishAsyncStep();
+    /// Apply delayed (parented) world transforms.
+    void ApplyDelayedWorldTransforms();
+    /// Gather statistics after a simulation step and adjust the deactivation scale to the active body budget.
+    void UpdateStatistics();
+    /// Report statistics to the profiler and the debug HUD.
+    void ReportStatistics();
     /// Trigger update before each physics simulation step.
     void PreStep(float timeStep);
     /// Trigger update after each physics simulation step.
     void PostStep(float timeStep);
     /// Send accumulated collision events.
     void SendCollisionEvents();
+    /// Fill the contact stream from the current collision pairs.
+    void BuildContactStream();
+    /// Send collision events of the current and ended collision pairs.
+    void SendContactEvents();
 
     /// Bullet collision configuration.
     btCollisionConfiguration* collisionConfiguration_{};
@@ -325,6 +529,10 @@ private:
     ea::unordered_map<ea::pair<WeakPtr<RigidBody>, WeakPtr<RigidBody> >, ManifoldPair> previousCollisions_;
     /// Delayed (parented) world transform assignments.
     ea::unordered_map<RigidBody*, DelayedWorldTransform> delayedWorldTransforms_;
+    /// World transforms produced by the asynchronous simulation step, applied on the main thread.
+    ea::vector<DelayedWorldTransform> asyncWorldTransforms_;
+    /// Work item of the asynchronous simulation step.
+    SharedPtr<WorkItem> asyncStepItem_;
     /// Cache for trimesh geometry data by model and LOD level.
     CollisionGeometryDataCache triMeshCache_;
     /// Cache for convex geometry data by model and LOD level.
@@ -337,18 +545,40 @@ private:
     VariantMap nodeCollisionData_;
     /// Preallocated buffer for physics collision contact data.
     VectorBuffer contacts_;
+    /// Contact stream body pairs.
+    ea::vector<PhysicsContactPair> contactPairs_;
+    /// Contact stream points.
+    ea::vector<PhysicsContactPoint> contactPoints_;
+    /// Contact stream body pairs whose collision ended.
+    ea::vector<ea::pair<RigidBody*, RigidBody*>> endedContactPairs_;
     /// Simulation substeps per second.
     unsigned fps_{DEFAULT_FPS};
     /// Maximum number of simulation substeps per frame. 0 (default) unlimited, or negative values for adaptive timestep.
     int maxSubSteps_{};
     /// Time accumulator for non-interpolated mode.
     float timeAcc_{};
+    /// Time step of the asynchronous simulation step.
+    float asyncTimeStep_{};
     /// Maximum angular velocity for network replication.
     float maxNetworkAngularVelocity_{DEFAULT_MAX_NETWORK_ANGULAR_VELOCITY};
+    /// Active dynamic body budget.
+    unsigned maxActiveBodies_{};
+    /// Statistics of the last simulation step. Phase times are accumulated by the Bullet world during the step.
+    PhysicsWorldStatistics statistics_;
+    /// Island marks used for counting islands.
+    ea::vector<bool> islandMarks_;
     /// Automatic simulation update enabled flag.
     bool updateEnabled_{true};
+    /// Collision events enabled flag.
+    bool collisionEventsEnabled_{true};
     /// Interpolation flag.
     bool interpolation_{true};
+    /// Asynchronous simulation flag.
+    bool asyncSimulation_{};
+    /// Asynchronous simulation step in progress flag.
+    bool asyncStepping_{};
+    /// Asynchronous simulation step results have been applied but the post-step events not yet sent flag.
+    bool asyncEventsPending_{};
     /// Use internal edge utility flag.
     bool internalEdge_{true};
     /// Applying transforms flag.
@@ -357,6 +587,10 @@ private:
     bool simulating_{};
     /// Debug draw depth test mode.
     bool debugDepthTest_{};
+    /// Simulation islands are solved in parallel flag.
+    bool multithreaded_{};
+    /// Work queue solving the simulation islands when multithreaded.
+    WorkQueue* workQueue_{};
     /// Debug renderer.
     DebugRenderer* debugRenderer_{};
     /// Debug draw flags.
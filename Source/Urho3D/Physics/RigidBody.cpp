@@ -61,6 +61,8 @@ static const char* collisionEventModeNames[] =
 
 extern const char* PHYSICS_CATEGORY;
 
+URHO3D_SLAB_ALLOCATED_SEPARATELY_IMPL(RigidBody)
+
 RigidBody::RigidBody(Context* context) :
     Component(context),
     gravityOverride_(Vector3::ZERO),
@@ -91,6 +93,12 @@ RigidBody::~RigidBody()
         physicsWorld_->RemoveRigidBody(this);
 }
 
+void RigidBody::CompleteAsyncStep() const
+{
+    if (physicsWorld_ && physicsWorld_->IsSimulatingAsync())
+        physicsWorld_->CompleteAsyncStep();
+}
+
 void RigidBody::RegisterObject(Context* context)
 {
     context->RegisterFactory<RigidBody>(PHYSICS_CATEGORY);
@@ -130,12 +138,14 @@ void RigidBody::RegisterObject(Context* context)
 
 void RigidBody::ApplyAttributes()
 {
+    CompleteAsyncStep();
     if (readdBody_)
         AddBodyToWorld();
 }
 
 void RigidBody::OnSetEnabled()
 {
+    CompleteAsyncStep();
     bool enabled = IsEnabledEffective();
 
     if (enabled && !inWorld_)
@@ -150,8 +160,12 @@ void RigidBody::getWorldTransform(btTransform& worldTrans) const
     // so check to be sure
     if (node_)
     {
-        lastPosition_ = node_->GetWorldPosition();
-        lastRotation_ = node_->GetWorldRotation();
+        // During an asynchronous step the node can not be accessed, use the transform cached before the step instead
+        if (!physicsWorld_ || !physicsWorld_->IsSimulatingAsync())
+        {
+            lastPosition_ = node_->GetWorldPosition();
+            lastRotation_ = node_->GetWorldRotation();
+        }
         worldTrans.setOrigin(ToBtVector3(lastPosition_ + lastRotation_ * centerOfMass_));
         worldTrans.setRotation(ToBtQuaternion(lastRotation_));
     }
@@ -166,6 +180,25 @@ void RigidBody::setWorldTransform(const btTransform& worldTrans)
 
     Quaternion newWorldRotation = ToQuaternion(worldTrans.getRotation());
     Vector3 newWorldPosition = ToVector3(worldTrans.getOrigin()) - newWorldRotation * centerOfMass_;
+
+    // Scene nodes can not be modified from the thread of an asynchronous step, so let PhysicsWorld apply the transform later
+    if (physicsWorld_ && physicsWorld_->IsSimulatingAsync())
+    {
+        DelayedWorldTransform transform;
+        transform.rigidBody_ = this;
+        transform.parentRigidBody_ = nullptr;
+        transform.worldPosition_ = newWorldPosition;
+        transform.worldRotation_ = newWorldRotation;
+        physicsWorld_->AddAsyncWorldTransform(transform);
+    }
+    else
+        SetSimulatedWorldTransform(newWorldPosition, newWorldRotation);
+
+    hasSimulated_ = true;
+}
+
+void RigidBody::SetSimulatedWorldTransform(const Vector3& newWorldPosition, const Quaternion& newWorldRotation)
+{
     RigidBody* parentRigidBody = nullptr;
 
     // It is possible that the RigidBody component has been kept alive via a shared pointer,
@@ -192,12 +225,20 @@ void RigidBody::setWorldTransform(const btTransform& worldTrans)
 
         MarkNetworkUpdate();
     }
+}
 
-    hasSimulated_ = true;
+void RigidBody::CacheKinematicWorldTransform()
+{
+    if (node_)
+    {
+        lastPosition_ = node_->GetWorldPosition();
+        lastRotation_ = node_->GetWorldRotation();
+    }
 }
 
 void RigidBody::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
 {
+    CompleteAsyncStep();
     if (debug && physicsWorld_ && body_ && IsEnabledEffective())
     {
         physicsWorld_->SetDebugRenderer(debug);
@@ -213,6 +254,7 @@ void RigidBody::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
 
 void RigidBody::SetMass(float mass)
 {
+    CompleteAsyncStep();
     mass = Max(mass, 0.0f);
 
     if (mass != mass_)
@@ -225,6 +267,7 @@ void RigidBody::SetMass(float mass)
 
 void RigidBody::SetPosition(const Vector3& position)
 {
+    CompleteAsyncStep();
     if (body_)
     {
         btTransform& worldTrans = body_->getWorldTransform();
@@ -248,6 +291,7 @@ void RigidBody::SetPosition(const Vector3& position)
 
 void RigidBody::SetRotation(const Quaternion& rotation)
 {
+    CompleteAsyncStep();
     if (body_)
     {
         Vector3 oldPosition = GetPosition();
@@ -274,6 +318,7 @@ void RigidBody::SetRotation(const Quaternion& rotation)
 
 void RigidBody::SetTransform(const Vector3& position, const Quaternion& rotation)
 {
+    CompleteAsyncStep();
     if (body_)
     {
         btTransform& worldTrans = body_->getWorldTransform();
@@ -297,6 +342,7 @@ void RigidBody::SetTransform(const Vector3& position, const Quaternion& rotation
 
 void RigidBody::SetLinearVelocity(const Vector3& velocity)
 {
+    CompleteAsyncStep();
     if (body_)
     {
         body_->setLinearVelocity(ToBtVector3(velocity));
@@ -308,6 +354,7 @@ void RigidBody::SetLinearVelocity(const Vector3& velocity)
 
 void RigidBody::SetLinearFactor(const Vector3& factor)
 {
+    CompleteAsyncStep();
     if (body_)
     {
         body_->setLinearFactor(ToBtVector3(factor));
@@ -317,6 +364,7 @@ void RigidBody::SetLinearFactor(const Vector3& factor)
 
 void RigidBody::SetLinearRestThreshold(float threshold)
 {
+    CompleteAsyncStep();
     if (body_)
     {
         body_->setSleepingThresholds(threshold, body_->getAngularSleepingThreshold());
@@ -326,6 +374,7 @@ void RigidBody::SetLinearRestThreshold(float threshold)
 
 void RigidBody::SetLinearDamping(float damping)
 {
+    CompleteAsyncStep();
     if (body_)
     {
         body_->setDamping(damping, body_->getAngularDamping());
@@ -335,6 +384,7 @@ void RigidBody::SetLinearDamping(float damping)
 
 void RigidBody::SetAngularVelocity(const Vector3& velocity)
 {
+    CompleteAsyncStep();
     if (body_)
     {
         body_->setAngularVelocity(ToBtVector3(velocity));
@@ -346,6 +396,7 @@ void RigidBody::SetAngularVelocity(const Vector3& velocity)
 
 void RigidBody::SetAngularFactor(const Vector3& factor)
 {
+    CompleteAsyncStep();
     if (body_)
     {
         body_->setAngularFactor(ToBtVector3(factor));
@@ -355,6 +406,7 @@ void RigidBody::SetAngularFactor(const Vector3& factor)
 
 void RigidBody::SetAngularRestThreshold(float threshold)
 {
+    CompleteAsyncStep();
     if (body_)
     {
         body_->setSleepingThresholds(body_->getLinearSleepingThreshold(), threshold);
@@ -364,6 +416,7 @@ void RigidBody::SetAngularRestThreshold(float threshold)
 
 void RigidBody::SetAngularDamping(float damping)
 {
+    CompleteAsyncStep();
     if (body_)
     {
         body_->setDamping(body_->getLinearDamping(), damping);
@@ -373,6 +426,7 @@ void RigidBody::SetAngularDamping(float damping)
 
 void RigidBody::SetFriction(float friction)
 {
+    CompleteAsyncStep();
     if (body_)
     {
         body_->setFriction(friction);
@@ -382,6 +436,7 @@ void RigidBody::SetFriction(float friction)
 
 void RigidBody::SetAnisotropicFriction(const Vector3& friction)
 {
+    CompleteAsyncStep();
     if (body_)
     {
         body_->setAnisotropicFriction(ToBtVector3(friction));
@@ -391,6 +446,7 @@ void RigidBody::SetAnisotropicFriction(const Vector3& friction)
 
 void RigidBody::SetRollingFriction(float friction)
 {
+    CompleteAsyncStep();
     if (body_)
     {
         body_->setRollingFriction(friction);
@@ -400,6 +456,7 @@ void RigidBody::SetRollingFriction(float friction)
 
 void RigidBody::SetRestitution(float restitution)
 {
+    CompleteAsyncStep();
     if (body_)
     {
         body_->setRestitution(restitution);
@@ -409,6 +466,7 @@ void RigidBody::SetRestitution(float restitution)
 
 void RigidBody::SetContactProcessingThreshold(float threshold)
 {
+    CompleteAsyncStep();
     if (body_)
     {
         body_->setContactProcessingThreshold(threshold);
@@ -418,6 +476,7 @@ void RigidBody::SetContactProcessingThreshold(float threshold)
 
 void RigidBody::SetCcdRadius(float radius)
 {
+    CompleteAsyncStep();
     radius = Max(radius, 0.0f);
     if (body_)
     {
@@ -428,6 +487,7 @@ void RigidBody::SetCcdRadius(float radius)
 
 void RigidBody::SetCcdMotionThreshold(float threshold)
 {
+    CompleteAsyncStep();
     threshold = Max(threshold, 0.0f);
     if (body_)
     {
@@ -438,6 +498,7 @@ void RigidBody::SetCcdMotionThreshold(float threshold)
 
 void RigidBody::SetUseGravity(bool enable)
 {
+    CompleteAsyncStep();
     if (enable != useGravity_)
     {
         useGravity_ = enable;
@@ -448,6 +509,7 @@ void RigidBody::SetUseGravity(bool enable)
 
 void RigidBody::SetGravityOverride(const Vector3& gravity)
 {
+    CompleteAsyncStep();
     if (gravity != gravityOverride_)
     {
         gravityOverride_ = gravity;
@@ -458,6 +520,7 @@ void RigidBody::SetGravityOverride(const Vector3& gravity)
 
 void RigidBody::SetKinematic(bool enable)
 {
+    CompleteAsyncStep();
     if (enable != kinematic_)
     {
         kinematic_ = enable;
@@ -468,6 +531,7 @@ void RigidBody::SetKinematic(bool enable)
 
 void RigidBody::SetTrigger(bool enable)
 {
+    CompleteAsyncStep();
     if (enable != trigger_)
     {
         trigger_ = enable;
@@ -478,6 +542,7 @@ void RigidBody::SetTrigger(bool enable)
 
 void RigidBody::SetCollisionLayer(unsigned layer)
 {
+    CompleteAsyncStep();
     if (layer != collisionLayer_)
     {
         collisionLayer_ = layer;
@@ -488,6 +553,7 @@ void RigidBody::SetCollisionLayer(unsigned layer)
 
 void RigidBody::SetCollisionMask(unsigned mask)
 {
+    CompleteAsyncStep();
     if (mask != collisionMask_)
     {
         collisionMask_ = mask;
@@ -498,6 +564,7 @@ void RigidBody::SetCollisionMask(unsigned mask)
 
 void RigidBody::SetCollisionLayerAndMask(unsigned layer, unsigned mask)
 {
+    CompleteAsyncStep();
     if (layer != collisionLayer_ || mask != collisionMask_)
     {
         collisionLayer_ = layer;
@@ -509,12 +576,14 @@ void RigidBody::SetCollisionLayerAndMask(unsigned layer, unsigned mask)
 
 void RigidBody::SetCollisionEventMode(CollisionEventMode mode)
 {
+    CompleteAsyncStep();
     collisionEventMode_ = mode;
     MarkNetworkUpdate();
 }
 
 void RigidBody::ApplyForce(const Vector3& force)
 {
+    CompleteAsyncStep();
     if (body_ && force != Vector3::ZERO)
     {
         Activate();
@@ -524,6 +593,7 @@ void RigidBody::ApplyForce(const Vector3& force)
 
 void RigidBody::ApplyForce(const Vector3& force, const Vector3& position)
 {
+    CompleteAsyncStep();
     if (body_ && force != Vector3::ZERO)
     {
         Activate();
@@ -533,6 +603,7 @@ void RigidBody::ApplyForce(const Vector3& force, const Vector3& position)
 
 void RigidBody::ApplyTorque(const Vector3& torque)
 {
+    CompleteAsyncStep();
     if (body_ && torque != Vector3::ZERO)
     {
         Activate();
@@ -542,6 +613,7 @@ void RigidBody::ApplyTorque(const Vector3& torque)
 
 void RigidBody::ApplyImpulse(const Vector3& impulse)
 {
+    CompleteAsyncStep();
     if (body_ && impulse != Vector3::ZERO)
     {
         Activate();
@@ -551,6 +623,7 @@ void RigidBody::ApplyImpulse(const Vector3& impulse)
 
 void RigidBody::ApplyImpulse(const Vector3& impulse, const Vector3& position)
 {
+    CompleteAsyncStep();
     if (body_ && impulse != Vector3::ZERO)
     {
         Activate();
@@ -560,6 +633,7 @@ void RigidBody::ApplyImpulse(const Vector3& impulse, const Vector3& position)
 
 void RigidBody::ApplyTorqueImpulse(const Vector3& torque)
 {
+    CompleteAsyncStep();
     if (body_ && torque != Vector3::ZERO)
     {
         Activate();
@@ -569,18 +643,21 @@ void RigidBody::ApplyTorqueImpulse(const Vector3& torque)
 
 void RigidBody::ResetForces()
 {
+    CompleteAsyncStep();
     if (body_)
         body_->clearForces();
 }
 
 void RigidBody::Activate()
 {
+    CompleteAsyncStep();
     if (body_ && mass_ > 0.0f)
         body_->activate(true);
 }
 
 void RigidBody::ReAddBodyToWorld()
 {
+    CompleteAsyncStep();
     if (body_ && inWorld_)
         AddBodyToWorld();
 }
@@ -592,6 +669,7 @@ void RigidBody::DisableMassUpdate()
 
 void RigidBody::EnableMassUpdate()
 {
+    CompleteAsyncStep();
     if (!enableMassUpdate_)
     {
         enableMassUpdate_ = true;
@@ -601,6 +679,7 @@ void RigidBody::EnableMassUpdate()
 
 Vector3 RigidBody::GetPosition() const
 {
+    CompleteAsyncStep();
     if (body_)
     {
         const btTransform& transform = body_->getWorldTransform();
@@ -612,96 +691,115 @@ Vector3 RigidBody::GetPosition() const
 
 Quaternion RigidBody::GetRotation() const
 {
+    CompleteAsyncStep();
     return body_ ? ToQuaternion(body_->getWorldTransform().getRotation()) : Quaternion::IDENTITY;
 }
 
 Vector3 RigidBody::GetLinearVelocity() const
 {
+    CompleteAsyncStep();
     return body_ ? ToVector3(body_->getLinearVelocity()) : Vector3::ZERO;
 }
 
 Vector3 RigidBody::GetLinearFactor() const
 {
+    CompleteAsyncStep();
     return body_ ? ToVector3(body_->getLinearFactor()) : Vector3::ZERO;
 }
 
 Vector3 RigidBody::GetVelocityAtPoint(const Vector3& position) const
 {
+    CompleteAsyncStep();
     return body_ ? ToVector3(body_->getVelocityInLocalPoint(ToBtVector3(position - centerOfMass_))) : Vector3::ZERO;
 }
 
 float RigidBody::GetLinearRestThreshold() const
 {
+    CompleteAsyncStep();
     return body_ ? body_->getLinearSleepingThreshold() : 0.0f;
 }
 
 float RigidBody::GetLinearDamping() const
 {
+    CompleteAsyncStep();
     return body_ ? body_->getLinearDamping() : 0.0f;
 }
 
 Vector3 RigidBody::GetAngularVelocity() const
 {
+    CompleteAsyncStep();
     return body_ ? ToVector3(body_->getAngularVelocity()) : Vector3::ZERO;
 }
 
 Vector3 RigidBody::GetAngularFactor() const
 {
+    CompleteAsyncStep();
     return body_ ? ToVector3(body_->getAngularFactor()) : Vector3::ZERO;
 }
 
 float RigidBody::GetAngularRestThreshold() const
 {
+    CompleteAsyncStep();
     return body_ ? body_->getAngularSleepingThreshold() : 0.0f;
 }
 
 float RigidBody::GetAngularDamping() const
 {
+    CompleteAsyncStep();
     return body_ ? body_->getAngularDamping() : 0.0f;
 }
 
 float RigidBody::GetFriction() const
 {
+    CompleteAsyncStep();
     return body_ ? body_->getFriction() : 0.0f;
 }
 
 Vector3 RigidBody::GetAnisotropicFriction() const
 {
+    CompleteAsyncStep();
     return body_ ? ToVector3(body_->getAnisotropicFriction()) : Vector3::ZERO;
 }
 
 float RigidBody::GetRollingFriction() const
 {
+    CompleteAsyncStep();
     return body_ ? body_->getRollingFriction() : 0.0f;
 }
 
 float RigidBody::GetRestitution() const
 {
+    CompleteAsyncStep();
     return body_ ? body_->getRestitution() : 0.0f;
 }
 
 float RigidBody::GetContactProcessingThreshold() const
 {
+    CompleteAsyncStep();
     return body_ ? body_->getContactProcessingThreshold() : 0.0f;
 }
 
 float RigidBody::GetCcdRadius() const
 {
+    CompleteAsyncStep();
     return body_ ? body_->getCcdSweptSphereRadius() : 0.0f;
 }
 
 float RigidBody::GetCcdMotionThreshold() const
 {
+    CompleteAsyncStep();
     return body_ ? body_->getCcdMotionThreshold() : 0.0f;
 }
 
 bool RigidBody::IsActive() const
 {
+    CompleteAsyncStep();
     return body_ ? body_->isActive() : false;
 }
 
 void RigidBody::GetCollidingBodies(ea::vector<RigidBody*>& result) const
 {
+    CompleteAsyncStep();
     if (physicsWorld_)
         physicsWorld_->GetCollidingBodies(result, this);
     else
@@ -738,6 +836,7 @@ void RigidBody::ApplyWorldTransform(const Vector3& newWorldPosition, const Quate
 
 void RigidBody::UpdateMass()
 {
+    CompleteAsyncStep();
     if (!body_ || !enableMassUpdate_)
         return;
 
@@ -821,6 +920,7 @@ void RigidBody::UpdateMass()
 
 void RigidBody::UpdateGravity()
 {
+    CompleteAsyncStep();
     if (physicsWorld_ && body_)
     {
         btDiscreteDynamicsWorld* world = physicsWorld_->GetWorld();
@@ -847,6 +947,7 @@ void RigidBody::UpdateGravity()
 
 void RigidBody::SetNetAngularVelocityAttr(const ea::vector<unsigned char>& value)
 {
+    CompleteAsyncStep();
     float maxVelocity = physicsWorld_ ? physicsWorld_->GetMaxNetworkAngularVelocity() : DEFAULT_MAX_NETWORK_ANGULAR_VELOCITY;
     MemoryBuffer buf(value);
     SetAngularVelocity(buf.ReadPackedVector3(maxVelocity));
@@ -874,6 +975,7 @@ void RigidBody::RemoveConstraint(Constraint* constraint)
 
 void RigidBody::ReleaseBody()
 {
+    CompleteAsyncStep();
     if (body_)
     {
         // Release all constraints which refer to this body
@@ -890,6 +992,7 @@ void RigidBody::ReleaseBody()
 
 void RigidBody::OnMarkedDirty(Node* node)
 {
+    CompleteAsyncStep();
     // If node transform changes, apply it back to the physics transform. However, do not do this when a SmoothedTransform
     // is in use, because in that case the node transform will be constantly updated into smoothed, possibly non-physical
     // states; rather follow the SmoothedTransform target transform directly
@@ -905,6 +1008,10 @@ void RigidBody::OnMarkedDirty(Node* node)
             return;
         }
 
+        // The body is about to be modified, so the asynchronous step must not be using it anymore
+        if (physicsWorld_)
+            physicsWorld_->CompleteAsyncStep();
+
         // Check if transform has changed from the last one set in ApplyWorldTransform()
         Vector3 newPosition = node_->GetWorldPosition();
         Quaternion newRotation = node_->GetWorldRotation();
@@ -951,6 +1058,7 @@ void RigidBody::OnSceneSet(Scene* scene)
 
 void RigidBody::AddBodyToWorld()
 {
+    CompleteAsyncStep();
     if (!physicsWorld_)
         return;
 
@@ -1027,6 +1135,7 @@ void RigidBody::AddBodyToWorld()
 
 void RigidBody::RemoveBodyFromWorld()
 {
+    CompleteAsyncStep();
     if (physicsWorld_ && body_ && inWorld_)
     {
         btDiscreteDynamicsWorld* world = physicsWorld_->GetWorld();
@@ -54,6 +54,9 @@ class URHO3D_API RigidBody : public Component, public btMotionState
     URHO3D_OBJECT(RigidBody, Component);
 
 public:
+    /// Rigid bodies are iterated every physics step, so they are allocated from a separate arena.
+    URHO3D_SLAB_ALLOCATED_SEPARATELY
+
     /// Construct.
     explicit RigidBody(Context* context);
     /// Destruct. Free the rigid body and geometries.
@@ -230,6 +233,10 @@ public:
 
     /// Apply new world transform after a simulation step. Called internally.
     void ApplyWorldTransform(const Vector3& newWorldPosition, const Quaternion& newWorldRotation);
+    /// Apply world transform from the simulation, or delay it if parented to another rigid body. Called internally.
+    void SetSimulatedWorldTransform(const Vector3& newWorldPosition, const Quaternion& newWorldRotation);
+    /// Store the node world transform to be returned to Bullet during an asynchronous step. Called internally.
+    void CacheKinematicWorldTransform();
     /// Update mass and inertia to the Bullet rigid body. Readd body to world if necessary: if was in world and the Bullet collision shape to use changed.
     void UpdateMass();
     /// Update gravity parameters to the Bullet rigid body.
@@ -254,6 +261,8 @@ protected:
     void OnMarkedDirty(Node* node) override;
 
 private:
+    /// Complete an asynchronous simulation step of the physics world before the Bullet objects are accessed from the main thread.
+    void CompleteAsyncStep() const;
     /// Create the rigid body, or re-add to the physics world with changed flags. Calls UpdateMass().
     void AddBodyToWorld();
     /// Remove the rigid body from the physics world.
@@ -0,0 +1,223 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Core/Profiler.h"
+#include "../Graphics/Model.h"
+#include "../IO/Deserializer.h"
+#include "../IO/FileSystem.h"
+#include "../IO/Log.h"
+#include "../IO/Serializer.h"
+#include "../Physics/CollisionShape.h"
+#include "../Physics/TriangleMeshBvh.h"
+
+#include <Bullet/BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h>
+#include <Bullet/BulletCollision/CollisionShapes/btOptimizedBvh.h>
+#include <Bullet/BulletCollision/CollisionShapes/btTriangleIndexVertexArray.h>
+#include <Bullet/BulletCollision/CollisionShapes/btTriangleInfoMap.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+/// Alignment of the in-place hierarchy buffer required by Bullet.
+static const unsigned BVH_BUFFER_ALIGNMENT = 16;
+
+TriangleMeshBvh::TriangleMeshBvh(Context* context) :
+    Resource(context)
+{
+}
+
+TriangleMeshBvh::~TriangleMeshBvh()
+{
+    Release();
+}
+
+void TriangleMeshBvh::RegisterObject(Context* context)
+{
+    context->RegisterFactory<TriangleMeshBvh>();
+}
+
+bool TriangleMeshBvh::BeginLoad(Deserializer& source)
+{
+    // Collision shapes refer to the hierarchy directly, so it can not be replaced under them
+    if (bvh_ && Refs() > 1)
+    {
+        URHO3D_LOGWARNING("Can not reload triangle mesh BVH {} while it is in use", GetName());
+        return false;
+    }
+
+    if (source.ReadFileID() != "UBVH")
+    {
+        URHO3D_LOGERROR("{} is not a valid triangle mesh BVH file", source.GetName());
+        return false;
+    }
+
+    Release();
+
+    numTriangles_ = source.ReadUInt();
+    quantized_ = source.ReadBool();
+
+    const unsigned bvhSize = source.ReadUInt();
+    AllocateBuffer(bvhSize);
+    if (source.Read(buffer_, bvhSize) != bvhSize)
+    {
+        URHO3D_LOGERROR("Unexpected end of triangle mesh BVH file {}", source.GetName());
+        Release();
+        return false;
+    }
+    bvh_ = btOptimizedBvh::deSerializeInPlace(buffer_, bufferSize_, false);
+
+    infoMap_ = ea::make_unique<btTriangleInfoMap>();
+    const unsigned numInfos = source.ReadUInt();
+    for (unsigned i = 0; i < numInfos; ++i)
+    {
+        const int key = source.ReadInt();
+        btTriangleInfo info;
+        info.m_flags = source.ReadInt();
+        info.m_edgeV0V1Angle = source.ReadFloat();
+        info.m_edgeV1V2Angle = source.ReadFloat();
+        info.m_edgeV2V0Angle = source.ReadFloat();
+        infoMap_->insert(key, info);
+    }
+
+    SetMemoryUse(sizeof(TriangleMeshBvh) + bufferSize_ + numInfos * (sizeof(int) + sizeof(btTriangleInfo)));
+    return true;
+}
+
+bool TriangleMeshBvh::Save(Serializer& dest) const
+{
+    if (!bvh_ || !infoMap_)
+    {
+        URHO3D_LOGERROR("Can not save empty triangle mesh BVH");
+        return false;
+    }
+
+    // The loaded buffer holds live pointers, so serialize a fresh copy of the hierarchy
+    const unsigned bvhSize = bvh_->calculateSerializeBufferSize();
+    void* bvhData = btAlignedAlloc(bvhSize, BVH_BUFFER_ALIGNMENT);
+    bvh_->serializeInPlace(bvhData, bvhSize, false);
+
+    dest.WriteFileID("UBVH");
+    dest.WriteUInt(numTriangles_);
+    dest.WriteBool(quantized_);
+    dest.WriteUInt(bvhSize);
+    const bool success = dest.Write(bvhData, bvhSize) == bvhSize;
+    btAlignedFree(bvhData);
+
+    dest.WriteUInt(infoMap_->size());
+    for (int i = 0; i < infoMap_->size(); ++i)
+    {
+        const btTriangleInfo& info = *infoMap_->getAtIndex(i);
+        dest.WriteInt(infoMap_->getKeyAtIndex(i).getUid1());
+        dest.WriteInt(info.m_flags);
+        dest.WriteFloat(info.m_edgeV0V1Angle);
+        dest.WriteFloat(info.m_edgeV1V2Angle);
+        dest.WriteFloat(info.m_edgeV2V0Angle);
+    }
+
+    return success;
+}
+
+bool TriangleMeshBvh::Cook(Model* model, unsigned lodLevel)
+{
+    URHO3D_PROFILE("CookTriangleMeshBvh");
+
+    if (!model)
+    {
+        URHO3D_LOGERROR("Null model for triangle mesh BVH");
+        return false;
+    }
+
+    TriangleMeshData data(model, lodLevel, false);
+    return SetShape(data.shape_.get(), data.infoMap_.get());
+}
+
+bool TriangleMeshBvh::SetShape(btBvhTriangleMeshShape* shape, btTriangleInfoMap* infoMap)
+{
+    if (!shape || !shape->getOptimizedBvh() || !infoMap)
+    {
+        URHO3D_LOGERROR("Triangle mesh shape has no BVH or internal edge info");
+        return false;
+    }
+
+    Release();
+
+    numTriangles_ = GetNumTriangles(shape);
+    quantized_ = shape->usesQuantizedAabbCompression();
+
+    const btOptimizedBvh* bvh = shape->getOptimizedBvh();
+    AllocateBuffer(bvh->calculateSerializeBufferSize());
+    bvh->serializeInPlace(buffer_, bufferSize_, false);
+    bvh_ = btOptimizedBvh::deSerializeInPlace(buffer_, bufferSize_, false);
+
+    infoMap_ = ea::make_unique<btTriangleInfoMap>();
+    for (int i = 0; i < infoMap->size(); ++i)
+        infoMap_->insert(infoMap->getKeyAtIndex(i), *infoMap->getAtIndex(i));
+    return true;
+}
+
+ea::string TriangleMeshBvh::GetCookedName(const ea::string& modelName, unsigned lodLevel)
+{
+    if (!lodLevel)
+        return ReplaceExtension(modelName, ".bvh");
+    else
+        return ReplaceExtension(modelName, Format("_LOD{}.bvh", lodLevel));
+}
+
+unsigned TriangleMeshBvh::GetNumTriangles(btBvhTriangleMeshShape* shape)
+{
+    unsigned numTriangles = 0;
+    const auto* meshInterface = static_cast<const btTriangleIndexVertexArray*>(shape->getMeshInterface());
+    const IndexedMeshArray& meshes = meshInterface->getIndexedMeshArray();
+    for (int i = 0; i < meshes.size(); ++i)
+        numTriangles += meshes[i].m_numTriangles;
+    return numTriangles;
+}
+
+void TriangleMeshBvh::AllocateBuffer(unsigned size)
+{
+    buffer_ = btAlignedAlloc(size, BVH_BUFFER_ALIGNMENT);
+    bufferSize_ = size;
+}
+
+void TriangleMeshBvh::Release()
+{
+    // The hierarchy was constructed in place and does not own its arrays, so only destruct it
+    if (bvh_)
+        bvh_->~btOptimizedBvh();
+    bvh_ = nullptr;
+
+    btAlignedFree(buffer_);
+    buffer_ = nullptr;
+    bufferSize_ = 0;
+
+    infoMap_.reset();
+    numTriangles_ = 0;
+    quantized_ = false;
+}
+
+}
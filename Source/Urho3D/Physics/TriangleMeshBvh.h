@@ -0,0 +1,100 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+/// \file
+
+#pragma once
+
+#include "../Resource/Resource.h"
+
+#include <EASTL/unique_ptr.h>
+
+class btBvhTriangleMeshShape;
+class btOptimizedBvh;
+
+struct btTriangleInfoMap;
+
+namespace Urho3D
+{
+
+class Model;
+
+/// Cooked triangle mesh collision data of a model LOD level: Bullet bounding volume hierarchy and internal edge info.
+/// Loaded once through the resource cache and shared by all physics worlds using the model.
+class URHO3D_API TriangleMeshBvh : public Resource
+{
+    URHO3D_OBJECT(TriangleMeshBvh, Resource);
+
+public:
+    /// Construct.
+    explicit TriangleMeshBvh(Context* context);
+    /// Destruct.
+    ~TriangleMeshBvh() override;
+    /// Register object factory.
+    static void RegisterObject(Context* context);
+
+    /// Load resource from stream. May be called from a worker thread. Return true if successful.
+    bool BeginLoad(Deserializer& source) override;
+    /// Save resource. Return true if successful.
+    bool Save(Serializer& dest) const override;
+
+    /// Build from a model LOD level. Return true if successful.
+    bool Cook(Model* model, unsigned lodLevel);
+    /// Copy from a triangle mesh shape with a built hierarchy and the internal edge info generated for it. Return true if successful.
+    bool SetShape(btBvhTriangleMeshShape* shape, btTriangleInfoMap* infoMap);
+
+    /// Return number of triangles the hierarchy was built for.
+    unsigned GetNumTriangles() const { return numTriangles_; }
+    /// Return whether the hierarchy uses quantized bounding boxes.
+    bool IsQuantized() const { return quantized_; }
+    /// Return Bullet bounding volume hierarchy, or null if empty.
+    btOptimizedBvh* GetBvh() const { return bvh_; }
+    /// Return Bullet internal edge info, or null if empty.
+    btTriangleInfoMap* GetTriangleInfoMap() const { return infoMap_.get(); }
+
+    /// Return resource name of the cooked data for a model LOD level.
+    static ea::string GetCookedName(const ea::string& modelName, unsigned lodLevel);
+    /// Return number of triangles in a triangle mesh shape.
+    static unsigned GetNumTriangles(btBvhTriangleMeshShape* shape);
+
+private:
+    /// Allocate hierarchy buffer.
+    void AllocateBuffer(unsigned size);
+    /// Free all data.
+    void Release();
+
+    /// Aligned buffer holding the hierarchy in place.
+    void* buffer_{};
+    /// Size of the hierarchy buffer.
+    unsigned bufferSize_{};
+    /// Bullet bounding volume hierarchy stored in the buffer.
+    btOptimizedBvh* bvh_{};
+    /// Bullet internal edge info.
+    ea::unique_ptr<btTriangleInfoMap> infoMap_;
+    /// Number of triangles.
+    unsigned numTriangles_{};
+    /// Quantized bounding boxes flag.
+    bool quantized_{};
+};
+
+}
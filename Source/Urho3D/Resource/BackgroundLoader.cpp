@@ -25,6 +25,8 @@
 #include "../Precompiled.h"
 
 #include "../Core/Context.h"
+#include "../Core/FrameStatistics.h"
+#include "../Core/MemoryTracker.h"
 #include "../Core/Profiler.h"
 #include "../IO/Log.h"
 #include "../Resource/BackgroundLoader.h"
@@ -36,6 +38,9 @@
 namespace Urho3D
 {
 
+/// Max number of queued resources with files opened and prefetched ahead of loading.
+static const unsigned MAX_PREFETCHED_FILES = 16;
+
 BackgroundLoader::BackgroundLoader(ResourceCache* owner) :
     owner_(owner)
 {
@@ -43,69 +48,141 @@ BackgroundLoader::BackgroundLoader(ResourceCache* owner) :
 
 BackgroundLoader::~BackgroundLoader()
 {
+    SetNumThreads(1);
+
     MutexLock lock(backgroundLoadMutex_);
 
     backgroundLoadQueue_.clear();
 }
 
+void BackgroundLoaderWorker::ThreadFunction()
+{
+    while (shouldRun_)
+    {
+        if (!loader_->LoadNextResource())
+            Time::Sleep(5);
+    }
+}
+
 void BackgroundLoader::ThreadFunction()
 {
+    MemoryTagScope memoryTag(MEMORY_TAG_RESOURCE);
+
     while (shouldRun_)
     {
-        backgroundLoadMutex_.Acquire();
+        if (!LoadNextResource())
+            Time::Sleep(5);
+    }
+}
 
-        // Search for a queued resource that has not been loaded yet
-        auto i = backgroundLoadQueue_.begin();
-        while (i != backgroundLoadQueue_.end())
+void BackgroundLoader::SetNumThreads(unsigned numThreads)
+{
+    // Missing threads are started on demand when resources are queued
+    ea::vector<ea::unique_ptr<BackgroundLoaderWorker>> surplusWorkers;
+    {
+        MutexLock lock(backgroundLoadMutex_);
+        numThreads_ = Max(numThreads, 1U);
+        while (workers_.size() + 1 > numThreads_)
         {
-            if (i->second.resource_->GetAsyncLoadState() == ASYNC_QUEUED)
-                break;
-            else
-                ++i;
+            surplusWorkers.push_back(ea::move(workers_.back()));
+            workers_.pop_back();
         }
+    }
+
+    // Workers need the mutex to finish their current resource
+    for (const auto& worker : surplusWorkers)
+        worker->Stop();
+}
+
+bool BackgroundLoader::LoadNextResource()
+{
+    backgroundLoadMutex_.Acquire();
+
+    // Search for a queued resource that has not been loaded yet. Prefer resources that other resources depend on
+    auto i = backgroundLoadQueue_.end();
+    for (auto j = backgroundLoadQueue_.begin(); j != backgroundLoadQueue_.end(); ++j)
+    {
+        if (j->second.resource_->GetAsyncLoadState() != ASYNC_QUEUED)
+            continue;
 
         if (i == backgroundLoadQueue_.end())
+            i = j;
+        if (!j->second.dependents_.empty())
         {
-            // No resources to load found
-            backgroundLoadMutex_.Release();
-            Time::Sleep(5);
+            i = j;
+            break;
         }
-        else
+    }
+
+    if (i == backgroundLoadQueue_.end())
+    {
+        // No resources to load found
+        backgroundLoadMutex_.Release();
+        return false;
+    }
+
+    BackgroundLoadItem& item = i->second;
+    Resource* resource = item.resource_;
+    // Claim the resource so that other loading threads skip it. We can be sure that the item is not removed
+    // from the queue as long as it is in the "queued" or "loading" state
+    resource->SetAsyncLoadState(ASYNC_LOADING);
+    SharedPtr<File> file = ea::move(item.file_);
+    if (file)
+        --numPrefetchedFiles_;
+
+    // Pick next queued resources to prefetch
+    ea::vector<ea::pair<StringHash, StringHash>> prefetchKeys;
+    ea::vector<ea::string> prefetchNames;
+    for (auto j = backgroundLoadQueue_.begin(); j != backgroundLoadQueue_.end(); ++j)
+    {
+        if (numPrefetchedFiles_ + prefetchKeys.size() >= MAX_PREFETCHED_FILES)
+            break;
+
+        const BackgroundLoadItem& queuedItem = j->second;
+        if (!queuedItem.file_ && queuedItem.resource_->GetAsyncLoadState() == ASYNC_QUEUED)
         {
-            BackgroundLoadItem& item = i->second;
-            Resource* resource = item.resource_;
-            // We can be sure that the item is not removed from the queue as long as it is in the
-            // "queued" or "loading" state
-            backgroundLoadMutex_.Release();
-
-            bool success = false;
-            SharedPtr<File> file = owner_->GetFile(resource->GetName(), item.sendEventOnFailure_);
-            if (file)
-            {
-                resource->SetAsyncLoadState(ASYNC_LOADING);
-                success = resource->BeginLoad(*file);
-            }
+            prefetchKeys.push_back(j->first);
+            prefetchNames.push_back(queuedItem.resource_->GetName());
+        }
+    }
+    backgroundLoadMutex_.Release();
 
-            // Process dependencies now
-            // Need to lock the queue again when manipulating other entries
-            ea::pair<StringHash, StringHash> key = ea::make_pair(resource->GetType(), resource->GetNameHash());
-            backgroundLoadMutex_.Acquire();
-            if (item.dependents_.size())
-            {
-                for (auto i = item.dependents_.begin(); i != item.dependents_.end(); ++i)
-                {
-                    auto j = backgroundLoadQueue_.find(*i);
-                    if (j != backgroundLoadQueue_.end())
-                        j->second.dependencies_.erase(key);
-                }
+    PrefetchFiles(prefetchKeys, prefetchNames);
 
-                item.dependents_.clear();
-            }
+    bool success = false;
+    if (!file)
+    {
+        item.openTime_ = HiresTimer::GetTimestamp();
+        file = owner_->GetFile(resource->GetName(), item.sendEventOnFailure_);
+    }
+    item.beginLoadTime_ = HiresTimer::GetTimestamp();
+    if (file)
+    {
+        URHO3D_PROFILE(ea::string("Load" + resource->GetTypeName()).c_str());
+        item.fileSize_ = file->GetSize();
+        success = resource->BeginLoad(*file);
+    }
+    item.beginLoadEndTime_ = HiresTimer::GetTimestamp();
 
-            resource->SetAsyncLoadState(success ? ASYNC_SUCCESS : ASYNC_FAIL);
-            backgroundLoadMutex_.Release();
+    // Process dependencies now
+    // Need to lock the queue again when manipulating other entries
+    ea::pair<StringHash, StringHash> key = ea::make_pair(resource->GetType(), resource->GetNameHash());
+    backgroundLoadMutex_.Acquire();
+    if (item.dependents_.size())
+    {
+        for (auto i = item.dependents_.begin(); i != item.dependents_.end(); ++i)
+        {
+            auto j = backgroundLoadQueue_.find(*i);
+            if (j != backgroundLoadQueue_.end())
+                j->second.dependencies_.erase(key);
         }
+
+        item.dependents_.clear();
     }
+
+    resource->SetAsyncLoadState(success ? ASYNC_SUCCESS : ASYNC_FAIL);
+    backgroundLoadMutex_.Release();
+    return true;
 }
 
 bool BackgroundLoader::QueueResource(StringHash type, const ea::string& name, bool sendEventOnFailure, Resource* caller)
@@ -121,6 +198,7 @@ bool BackgroundLoader::QueueResource(StringHash type, const ea::string& name, bo
 
     BackgroundLoadItem& item = backgroundLoadQueue_[key];
     item.sendEventOnFailure_ = sendEventOnFailure;
+    item.queueTime_ = HiresTimer::GetTimestamp();
 
     // Make sure the pointer is non-null and is a Resource subclass
     item.resource_ = DynamicCast<Resource>(owner_->GetContext()->CreateObject(type));
@@ -163,9 +241,15 @@ bool BackgroundLoader::QueueResource(StringHash type, const ea::string& name, bo
                        " requested for a background loaded resource but was not in the background load queue");
     }
 
-    // Start the background loader thread now
+    // Start the background loader threads now
     if (!IsStarted())
         Run();
+    while (workers_.size() + 1 < numThreads_)
+    {
+        auto worker = ea::make_unique<BackgroundLoaderWorker>(this);
+        worker->Run();
+        workers_.push_back(ea::move(worker));
+    }
 
     return true;
 }
@@ -257,10 +341,35 @@ unsigned BackgroundLoader::GetNumQueuedResources() const
     return backgroundLoadQueue_.size();
 }
 
+void BackgroundLoader::PrefetchFiles(
+    const ea::vector<ea::pair<StringHash, StringHash>>& keys, const ea::vector<ea::string>& names)
+{
+    for (unsigned i = 0; i < keys.size(); ++i)
+    {
+        const long long openTime = HiresTimer::GetTimestamp();
+        SharedPtr<File> file = owner_->GetFile(names[i], false);
+        if (!file)
+            continue;
+
+        file->Prefetch();
+
+        // The resource may have been picked up by another thread meanwhile
+        MutexLock lock(backgroundLoadMutex_);
+        auto j = backgroundLoadQueue_.find(keys[i]);
+        if (j != backgroundLoadQueue_.end() && !j->second.file_ && j->second.resource_->GetAsyncLoadState() == ASYNC_QUEUED)
+        {
+            j->second.file_ = file;
+            j->second.openTime_ = openTime;
+            ++numPrefetchedFiles_;
+        }
+    }
+}
+
 void BackgroundLoader::FinishBackgroundLoading(BackgroundLoadItem& item)
 {
     Resource* resource = item.resource_;
 
+    const long long endLoadTime = HiresTimer::GetTimestamp();
     bool success = resource->GetAsyncLoadState() == ASYNC_SUCCESS;
     // If BeginLoad() phase was successful, call EndLoad() and get the final success/failure result
     if (success)
@@ -270,6 +379,7 @@ void BackgroundLoader::FinishBackgroundLoading(BackgroundLoadItem& item)
         success = resource->EndLoad();
     }
     resource->SetAsyncLoadState(ASYNC_DONE);
+    const long long finishTime = HiresTimer::GetTimestamp();
 
     if (!success && item.sendEventOnFailure_)
     {
@@ -280,6 +390,15 @@ void BackgroundLoader::FinishBackgroundLoading(BackgroundLoadItem& item)
         owner_->SendEvent(E_LOADFAILED, eventData);
     }
 
+    if (success)
+    {
+        if (auto* statistics = owner_->GetSubsystem<FrameStatistics>())
+        {
+            statistics->IncrementCounter(FC_RESOURCE_LOADS);
+            statistics->AddMarker(FM_RESOURCE_LOAD, resource->GetName());
+        }
+    }
+
     // Store to the cache just before sending the event; use same mechanism as for manual resources
     if (success || owner_->GetReturnFailedResources())
         owner_->AddManualResource(resource);
@@ -292,6 +411,13 @@ void BackgroundLoader::FinishBackgroundLoading(BackgroundLoadItem& item)
         eventData[P_RESOURCENAME] = resource->GetName();
         eventData[P_SUCCESS] = success;
         eventData[P_RESOURCE] = resource;
+        eventData[P_FILESIZE] = item.fileSize_;
+        eventData[P_QUEUETIME] = item.queueTime_;
+        eventData[P_OPENTIME] = item.openTime_;
+        eventData[P_BEGINLOADTIME] = item.beginLoadTime_;
+        eventData[P_BEGINLOADENDTIME] = item.beginLoadEndTime_;
+        eventData[P_ENDLOADTIME] = endLoadTime;
+        eventData[P_FINISHTIME] = finishTime;
         owner_->SendEvent(E_RESOURCEBACKGROUNDLOADED, eventData);
     }
 }
@@ -23,7 +23,9 @@
 #pragma once
 
 #include <EASTL/hash_set.h>
+#include <EASTL/unique_ptr.h>
 #include <EASTL/unordered_map.h>
+#include <EASTL/vector.h>
 
 #include "../Core/Mutex.h"
 #include "../Container/Ptr.h"
@@ -33,6 +35,8 @@
 namespace Urho3D
 {
 
+class BackgroundLoader;
+class File;
 class Resource;
 class ResourceCache;
 
@@ -45,10 +49,37 @@ struct URHO3D_API BackgroundLoadItem
     ea::hash_set<ea::pair<StringHash, StringHash> > dependencies_;
     /// Resources that depend on this resource's loading.
     ea::hash_set<ea::pair<StringHash, StringHash> > dependents_;
+    /// File opened and prefetched ahead of loading, if any.
+    SharedPtr<File> file_;
+    /// Size of the loaded file.
+    unsigned fileSize_{};
+    /// Timestamp of queueing, see HiresTimer::GetTimestamp().
+    long long queueTime_{};
+    /// Timestamp of the start of the file open.
+    long long openTime_{};
+    /// Timestamp of the start of BeginLoad().
+    long long beginLoadTime_{};
+    /// Timestamp of the end of BeginLoad().
+    long long beginLoadEndTime_{};
     /// Whether to send failure event.
     bool sendEventOnFailure_;
 };
 
+/// Additional thread of the background loader.
+class URHO3D_API BackgroundLoaderWorker : public Thread
+{
+public:
+    /// Construct.
+    explicit BackgroundLoaderWorker(BackgroundLoader* loader) : loader_(loader) { }
+
+    /// Resource background loading loop.
+    void ThreadFunction() override;
+
+private:
+    /// Background loader.
+    BackgroundLoader* loader_;
+};
+
 /// Background loader of resources. Owned by the ResourceCache.
 class URHO3D_API BackgroundLoader : public RefCounted, public Thread
 {
@@ -69,12 +100,21 @@ public:
     /// Process resources that are ready to finish.
     void FinishResources(int maxMs);
 
+    /// Set number of threads that call BeginLoad() of queued resources. Default 1.
+    void SetNumThreads(unsigned numThreads);
+    /// Load next queued resource in the calling thread. Return false if there is nothing to load.
+    bool LoadNextResource();
+
     /// Return amount of resources in the load queue.
     unsigned GetNumQueuedResources() const;
+    /// Return number of loading threads.
+    unsigned GetNumThreads() const { return numThreads_; }
 
 private:
     /// Finish one background loaded resource.
     void FinishBackgroundLoading(BackgroundLoadItem& item);
+    /// Open and prefetch files of queued resources so that their reads are in flight before loading.
+    void PrefetchFiles(const ea::vector<ea::pair<StringHash, StringHash>>& keys, const ea::vector<ea::string>& names);
 
     /// Resource cache.
     ResourceCache* owner_;
@@ -82,6 +122,12 @@ private:
     mutable Mutex backgroundLoadMutex_;
     /// Resources that are queued for background loading.
     ea::unordered_map<ea::pair<StringHash, StringHash>, BackgroundLoadItem> backgroundLoadQueue_;
+    /// Number of queued resources with prefetched files.
+    unsigned numPrefetchedFiles_{};
+    /// Number of loading threads, including this one.
+    unsigned numThreads_{ 1 };
+    /// Additional loading threads.
+    ea::vector<ea::unique_ptr<BackgroundLoaderWorker>> workers_;
 };
 
 }
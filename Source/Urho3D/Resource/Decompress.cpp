@@ -281,6 +281,224 @@ void DecompressImageDXT(unsigned char* rgba, const void* blocks, int width, int
     }
 }
 
+// DXT compression using range fit along the principal axis of block colours
+
+static unsigned short Pack565(const float* colour)
+{
+    const int red = Clamp(static_cast<int>(colour[0] * (31.0f / 255.0f) + 0.5f), 0, 31);
+    const int green = Clamp(static_cast<int>(colour[1] * (63.0f / 255.0f) + 0.5f), 0, 63);
+    const int blue = Clamp(static_cast<int>(colour[2] * (31.0f / 255.0f) + 0.5f), 0, 31);
+    return static_cast<unsigned short>((red << 11) | (green << 5) | blue);
+}
+
+static void CompressColourDXT(unsigned char* block, const unsigned char* rgba)
+{
+    // compute the mean and the covariance of the block colours
+    float mean[3]{};
+    for (int i = 0; i < 16; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+            mean[j] += rgba[4 * i + j] / 16.0f;
+    }
+
+    float covariance[6]{};
+    for (int i = 0; i < 16; ++i)
+    {
+        const float r = rgba[4 * i] - mean[0];
+        const float g = rgba[4 * i + 1] - mean[1];
+        const float b = rgba[4 * i + 2] - mean[2];
+        covariance[0] += r * r;
+        covariance[1] += r * g;
+        covariance[2] += r * b;
+        covariance[3] += g * g;
+        covariance[4] += g * b;
+        covariance[5] += b * b;
+    }
+
+    // find the principal axis with a few power iterations
+    float axis[3]{ 1.0f, 1.0f, 1.0f };
+    for (int iteration = 0; iteration < 8; ++iteration)
+    {
+        const float x = axis[0] * covariance[0] + axis[1] * covariance[1] + axis[2] * covariance[2];
+        const float y = axis[0] * covariance[1] + axis[1] * covariance[3] + axis[2] * covariance[4];
+        const float z = axis[0] * covariance[2] + axis[1] * covariance[4] + axis[2] * covariance[5];
+        const float length = ea::max({ Abs(x), Abs(y), Abs(z) });
+        if (length < M_EPSILON)
+            break;
+        axis[0] = x / length;
+        axis[1] = y / length;
+        axis[2] = z / length;
+    }
+
+    // take the extreme colours along the axis as endpoints
+    int minIndex = 0;
+    int maxIndex = 0;
+    float minDot = M_INFINITY;
+    float maxDot = -M_INFINITY;
+    for (int i = 0; i < 16; ++i)
+    {
+        const float dot = rgba[4 * i] * axis[0] + rgba[4 * i + 1] * axis[1] + rgba[4 * i + 2] * axis[2];
+        if (dot < minDot)
+        {
+            minDot = dot;
+            minIndex = i;
+        }
+        if (dot > maxDot)
+        {
+            maxDot = dot;
+            maxIndex = i;
+        }
+    }
+
+    const float start[3]{ static_cast<float>(rgba[4 * maxIndex]),
+        static_cast<float>(rgba[4 * maxIndex + 1]), static_cast<float>(rgba[4 * maxIndex + 2]) };
+    const float end[3]{ static_cast<float>(rgba[4 * minIndex]),
+        static_cast<float>(rgba[4 * minIndex + 1]), static_cast<float>(rgba[4 * minIndex + 2]) };
+    unsigned short a = Pack565(start);
+    unsigned short b = Pack565(end);
+
+    // the 4-colour codebook requires a > b
+    if (a < b)
+        ea::swap(a, b);
+
+    unsigned char indices[16]{};
+    if (a != b)
+    {
+        // build the codebook exactly as the decoder does
+        unsigned char packed[4]{ static_cast<unsigned char>(a & 0xff), static_cast<unsigned char>(a >> 8),
+            static_cast<unsigned char>(b & 0xff), static_cast<unsigned char>(b >> 8) };
+        unsigned char codes[16];
+        Unpack565(packed, codes);
+        Unpack565(packed + 2, codes + 4);
+        for (int i = 0; i < 3; ++i)
+        {
+            codes[8 + i] = static_cast<unsigned char>((2 * codes[i] + codes[4 + i]) / 3);
+            codes[12 + i] = static_cast<unsigned char>((codes[i] + 2 * codes[4 + i]) / 3);
+        }
+
+        // match each pixel to the closest code
+        for (int i = 0; i < 16; ++i)
+        {
+            int bestError = M_MAX_INT;
+            for (int code = 0; code < 4; ++code)
+            {
+                int error = 0;
+                for (int j = 0; j < 3; ++j)
+                {
+                    const int delta = static_cast<int>(rgba[4 * i + j]) - codes[4 * code + j];
+                    error += delta * delta;
+                }
+                if (error < bestError)
+                {
+                    bestError = error;
+                    indices[i] = static_cast<unsigned char>(code);
+                }
+            }
+        }
+    }
+
+    // write the endpoints and the packed indices
+    block[0] = static_cast<unsigned char>(a & 0xff);
+    block[1] = static_cast<unsigned char>(a >> 8);
+    block[2] = static_cast<unsigned char>(b & 0xff);
+    block[3] = static_cast<unsigned char>(b >> 8);
+    for (int i = 0; i < 4; ++i)
+    {
+        const unsigned char* ind = indices + 4 * i;
+        block[4 + i] = static_cast<unsigned char>(ind[0] | (ind[1] << 2) | (ind[2] << 4) | (ind[3] << 6));
+    }
+}
+
+static void CompressAlphaDXT5(unsigned char* block, const unsigned char* rgba)
+{
+    // use the 7-alpha codebook between the extreme values
+    int minAlpha = 255;
+    int maxAlpha = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        minAlpha = ea::min<int>(minAlpha, rgba[4 * i + 3]);
+        maxAlpha = ea::max<int>(maxAlpha, rgba[4 * i + 3]);
+    }
+
+    unsigned char codes[8];
+    codes[0] = static_cast<unsigned char>(maxAlpha);
+    codes[1] = static_cast<unsigned char>(minAlpha);
+    for (int i = 1; i < 7; ++i)
+        codes[1 + i] = static_cast<unsigned char>(((7 - i) * maxAlpha + i * minAlpha) / 7);
+
+    unsigned char indices[16]{};
+    if (maxAlpha != minAlpha)
+    {
+        for (int i = 0; i < 16; ++i)
+        {
+            int bestError = M_MAX_INT;
+            for (int code = 0; code < 8; ++code)
+            {
+                const int error = Abs(static_cast<int>(rgba[4 * i + 3]) - codes[code]);
+                if (error < bestError)
+                {
+                    bestError = error;
+                    indices[i] = static_cast<unsigned char>(code);
+                }
+            }
+        }
+    }
+
+    // write the endpoints and two groups of 8 3-bit indices
+    block[0] = codes[0];
+    block[1] = codes[1];
+    unsigned char* dest = block + 2;
+    for (int i = 0; i < 2; ++i)
+    {
+        int value = 0;
+        for (int j = 0; j < 8; ++j)
+            value |= indices[8 * i + j] << 3 * j;
+
+        for (int j = 0; j < 3; ++j)
+            *dest++ = static_cast<unsigned char>((value >> 8 * j) & 0xff);
+    }
+}
+
+void CompressImageDXT(void* blocks, const unsigned char* rgba, int width, int height, CompressedFormat format)
+{
+    auto* targetBlock = reinterpret_cast<unsigned char*>(blocks);
+    const int bytesPerBlock = format == CF_DXT1 ? 8 : 16;
+
+    // loop over blocks
+    for (int y = 0; y < height; y += 4)
+    {
+        for (int x = 0; x < width; x += 4)
+        {
+            // gather the block pixels, replicating edge pixels for partial blocks
+            unsigned char sourceRgba[4 * 16];
+            unsigned char* targetPixel = sourceRgba;
+            for (int py = 0; py < 4; ++py)
+            {
+                for (int px = 0; px < 4; ++px)
+                {
+                    const int sx = ea::min(x + px, width - 1);
+                    const int sy = ea::min(y + py, height - 1);
+                    const unsigned char* sourcePixel = rgba + 4 * (width * sy + sx);
+                    for (int i = 0; i < 4; ++i)
+                        *targetPixel++ = *sourcePixel++;
+                }
+            }
+
+            // compress the block
+            if (format == CF_DXT5)
+            {
+                CompressAlphaDXT5(targetBlock, sourceRgba);
+                CompressColourDXT(targetBlock + 8, sourceRgba);
+            }
+            else
+                CompressColourDXT(targetBlock, sourceRgba);
+
+            // advance
+            targetBlock += bytesPerBlock;
+        }
+    }
+}
+
 // PVRTC decompression based on the Oolong Engine, modified for Urho3D
 
 #define PT_INDEX    (2) /*The Punch-through index*/
@@ -30,6 +30,8 @@ namespace Urho3D
 /// Decompress a DXT compressed image to RGBA.
 URHO3D_API void
     DecompressImageDXT(unsigned char* rgba, const void* blocks, int width, int height, int depth, CompressedFormat format);
+/// Compress an RGBA image to DXT1 or DXT5.
+URHO3D_API void CompressImageDXT(void* blocks, const unsigned char* rgba, int width, int height, CompressedFormat format);
 /// Decompress an ETC1/ETC2 compressed image to RGBA.
 URHO3D_API void DecompressImageETC(unsigned char* dstImage, const void* blocks, int width, int height, bool hasAlpha);
 /// Decompress a PVRTC compressed image to RGBA.
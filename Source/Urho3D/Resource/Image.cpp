@@ -24,6 +24,8 @@
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../Core/Thread.h"
+#include "../Core/WorkQueue.h"
 #include "../IO/File.h"
 #include "../IO/FileSystem.h"
 #include "../IO/Log.h"
@@ -38,6 +40,10 @@
 #include <webp/mux.h>
 #endif
 
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#endif
+
 #include "../DebugNew.h"
 
 #ifndef MAKEFOURCC
@@ -214,26 +220,246 @@ struct DDSurfaceDesc2
     unsigned dwTextureStage_;
 };
 
-bool CompressedLevel::Decompress(unsigned char* dest) const
+/// Minimum number of destination bytes processed by one parallel image work chunk.
+static const unsigned IMAGE_PARALLEL_GRAIN_BYTES = 64 * 1024;
+/// Number of steps in the linear to sRGB lookup table.
+static const unsigned SRGB_LINEAR_STEPS = 4096;
+
+/// Process rows [0, numRows) of rowSize destination bytes each. Rows are split over the work queue when called from the main thread, as images may also be processed on background loading threads.
+template <class T> static void ProcessImageRows(WorkQueue* queue, unsigned numRows, unsigned rowSize, const T& callback)
+{
+    const unsigned grainSize = Max(IMAGE_PARALLEL_GRAIN_BYTES / Max(rowSize, 1u), 1u);
+    if (queue && queue->GetNumThreads() && numRows > grainSize && Thread::IsMainThread())
+    {
+        queue->ParallelFor(numRows, grainSize, [&callback](unsigned begin, unsigned end, unsigned) { callback(begin, end); });
+        queue->Complete(M_MAX_UNSIGNED);
+    }
+    else
+        callback(0, numRows);
+}
+
+/// Lookup tables for filtering sRGB images in linear space.
+struct SRGBTables
+{
+    /// Construct.
+    SRGBTables()
+    {
+        for (unsigned i = 0; i < 256; ++i)
+            toLinear_[i] = Color::ConvertGammaToLinear(i / 255.0f);
+        for (unsigned i = 0; i < SRGB_LINEAR_STEPS; ++i)
+            toGamma_[i] = (unsigned char)RoundToInt(Color::ConvertLinearToGamma(i / (float)(SRGB_LINEAR_STEPS - 1)) * 255.0f);
+    }
+
+    /// Convert linear value in range [0, 1] to sRGB.
+    unsigned char ToGamma(float value) const { return toGamma_[(unsigned)(value * (SRGB_LINEAR_STEPS - 1) + 0.5f)]; }
+
+    /// sRGB to linear table.
+    float toLinear_[256];
+    /// Linear to sRGB table.
+    unsigned char toGamma_[SRGB_LINEAR_STEPS];
+};
+
+static const SRGBTables& GetSRGBTables()
+{
+    static const SRGBTables tables;
+    return tables;
+}
+
+/// Downsample rows [begin, end) of a 2D mip level with a box filter, averaging color in linear space. Alpha of 2 and 4 component images is averaged as is.
+static void DownsampleRows2DSRGB(const unsigned char* in, unsigned char* outData, int widthIn, int widthOut, unsigned components,
+    int begin, int end)
+{
+    const SRGBTables& tables = GetSRGBTables();
+    const bool hasAlpha = components == 2 || components == 4;
+    const unsigned numColors = hasAlpha ? components - 1 : components;
+
+    for (int y = begin; y < end; ++y)
+    {
+        const unsigned char* inUpper = &in[(y * 2) * widthIn * components];
+        const unsigned char* inLower = &in[(y * 2 + 1) * widthIn * components];
+        unsigned char* out = &outData[y * widthOut * components];
+
+        for (int x = 0; x < widthOut; ++x)
+        {
+            const unsigned char* upper = &inUpper[x * 2 * components];
+            const unsigned char* lower = &inLower[x * 2 * components];
+            unsigned char* dest = &out[x * components];
+
+            for (unsigned c = 0; c < numColors; ++c)
+            {
+                const float sum = tables.toLinear_[upper[c]] + tables.toLinear_[upper[c + components]] +
+                    tables.toLinear_[lower[c]] + tables.toLinear_[lower[c + components]];
+                dest[c] = tables.ToGamma(sum * 0.25f);
+            }
+            if (hasAlpha)
+            {
+                dest[numColors] = (unsigned char)(((unsigned)upper[numColors] + upper[numColors + components] +
+                                                   lower[numColors] + lower[numColors + components]) >> 2);
+            }
+        }
+    }
+}
+
+/// Downsample rows [begin, end) of a 2D mip level with a box filter.
+static void DownsampleRows2D(const unsigned char* in, unsigned char* outData, int widthIn, int widthOut, unsigned components,
+    bool sRGB, int begin, int end)
+{
+    if (sRGB)
+    {
+        DownsampleRows2DSRGB(in, outData, widthIn, widthOut, components, begin, end);
+        return;
+    }
+
+    switch (components)
+    {
+    case 1:
+        for (int y = begin; y < end; ++y)
+        {
+            const unsigned char* inUpper = &in[(y * 2) * widthIn];
+            const unsigned char* inLower = &in[(y * 2 + 1) * widthIn];
+            unsigned char* out = &outData[y * widthOut];
+
+            int x = 0;
+#ifdef URHO3D_SSE
+            // 16 input pixels per row to 8 output pixels
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i ones = _mm_set1_epi16(1);
+            for (; x + 8 <= widthOut; x += 8)
+            {
+                const __m128i upper = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&inUpper[x * 2]));
+                const __m128i lower = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&inLower[x * 2]));
+                const __m128i sumLow = _mm_add_epi16(_mm_unpacklo_epi8(upper, zero), _mm_unpacklo_epi8(lower, zero));
+                const __m128i sumHigh = _mm_add_epi16(_mm_unpackhi_epi8(upper, zero), _mm_unpackhi_epi8(lower, zero));
+                const __m128i sum = _mm_packs_epi32(_mm_madd_epi16(sumLow, ones), _mm_madd_epi16(sumHigh, ones));
+                const __m128i result = _mm_srli_epi16(sum, 2);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(&out[x]), _mm_packus_epi16(result, result));
+            }
+#endif
+            for (; x < widthOut; ++x)
+            {
+                out[x] = (unsigned char)(((unsigned)inUpper[x * 2] + inUpper[x * 2 + 1] +
+                                          inLower[x * 2] + inLower[x * 2 + 1]) >> 2);
+            }
+        }
+        break;
+
+    case 2:
+        for (int y = begin; y < end; ++y)
+        {
+            const unsigned char* inUpper = &in[(y * 2) * widthIn * 2];
+            const unsigned char* inLower = &in[(y * 2 + 1) * widthIn * 2];
+            unsigned char* out = &outData[y * widthOut * 2];
+
+            for (int x = 0; x < widthOut * 2; x += 2)
+            {
+                out[x] = (unsigned char)(((unsigned)inUpper[x * 2] + inUpper[x * 2 + 2] +
+                                          inLower[x * 2] + inLower[x * 2 + 2]) >> 2);
+                out[x + 1] = (unsigned char)(((unsigned)inUpper[x * 2 + 1] + inUpper[x * 2 + 3] +
+                                              inLower[x * 2 + 1] + inLower[x * 2 + 3]) >> 2);
+            }
+        }
+        break;
+
+    case 3:
+        for (int y = begin; y < end; ++y)
+        {
+            const unsigned char* inUpper = &in[(y * 2) * widthIn * 3];
+            const unsigned char* inLower = &in[(y * 2 + 1) * widthIn * 3];
+            unsigned char* out = &outData[y * widthOut * 3];
+
+            for (int x = 0; x < widthOut * 3; x += 3)
+            {
+                out[x] = (unsigned char)(((unsigned)inUpper[x * 2] + inUpper[x * 2 + 3] +
+                                          inLower[x * 2] + inLower[x * 2 + 3]) >> 2);
+                out[x + 1] = (unsigned char)(((unsigned)inUpper[x * 2 + 1] + inUpper[x * 2 + 4] +
+                                              inLower[x * 2 + 1] + inLower[x * 2 + 4]) >> 2);
+                out[x + 2] = (unsigned char)(((unsigned)inUpper[x * 2 + 2] + inUpper[x * 2 + 5] +
+                                              inLower[x * 2 + 2] + inLower[x * 2 + 5]) >> 2);
+            }
+        }
+        break;
+
+    case 4:
+        for (int y = begin; y < end; ++y)
+        {
+            const unsigned char* inUpper = &in[(y * 2) * widthIn * 4];
+            const unsigned char* inLower = &in[(y * 2 + 1) * widthIn * 4];
+            unsigned char* out = &outData[y * widthOut * 4];
+
+            int x = 0;
+#ifdef URHO3D_SSE
+            // 4 input pixels per row to 2 output pixels
+            const __m128i zero = _mm_setzero_si128();
+            for (; x + 8 <= widthOut * 4; x += 8)
+            {
+                const __m128i upper = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&inUpper[x * 2]));
+                const __m128i lower = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&inLower[x * 2]));
+                const __m128i sumLow = _mm_add_epi16(_mm_unpacklo_epi8(upper, zero), _mm_unpacklo_epi8(lower, zero));
+                const __m128i sumHigh = _mm_add_epi16(_mm_unpackhi_epi8(upper, zero), _mm_unpackhi_epi8(lower, zero));
+                const __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(sumLow, sumHigh), _mm_unpackhi_epi64(sumLow, sumHigh));
+                const __m128i result = _mm_srli_epi16(sum, 2);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(&out[x]), _mm_packus_epi16(result, result));
+            }
+#endif
+            for (; x < widthOut * 4; x += 4)
+            {
+                out[x] = (unsigned char)(((unsigned)inUpper[x * 2] + inUpper[x * 2 + 4] +
+                                          inLower[x * 2] + inLower[x * 2 + 4]) >> 2);
+                out[x + 1] = (unsigned char)(((unsigned)inUpper[x * 2 + 1] + inUpper[x * 2 + 5] +
+                                              inLower[x * 2 + 1] + inLower[x * 2 + 5]) >> 2);
+                out[x + 2] = (unsigned char)(((unsigned)inUpper[x * 2 + 2] + inUpper[x * 2 + 6] +
+                                              inLower[x * 2 + 2] + inLower[x * 2 + 6]) >> 2);
+                out[x + 3] = (unsigned char)(((unsigned)inUpper[x * 2 + 3] + inUpper[x * 2 + 7] +
+                                              inLower[x * 2 + 3] + inLower[x * 2 + 7]) >> 2);
+            }
+        }
+        break;
+
+    default:
+        assert(false);  // Should never reach here
+        break;
+    }
+}
+
+bool CompressedLevel::Decompress(unsigned char* dest, WorkQueue* workQueue) const
 {
     if (!data_)
         return false;
 
+    // Blocks are 4x4 pixels and independent of each other, so block rows of a 2D level can be decompressed in parallel
+    const unsigned numBlockRows = (unsigned)(height_ + 3) / 4;
+    const unsigned blockSize = (format_ == CF_DXT1 || format_ == CF_ETC1 || format_ == CF_ETC2_RGB) ? 8 : 16;
+    const unsigned blockRowSize = (unsigned)(width_ + 3) / 4 * blockSize;
+    const unsigned destBlockRowSize = width_ * 4 * 4;
+
     switch (format_)
     {
     case CF_DXT1:
     case CF_DXT3:
     case CF_DXT5:
-        DecompressImageDXT(dest, data_, width_, height_, depth_, format_);
+        if (depth_ > 1)
+            DecompressImageDXT(dest, data_, width_, height_, depth_, format_);
+        else
+        {
+            ProcessImageRows(workQueue, numBlockRows, destBlockRowSize, [&](unsigned begin, unsigned end)
+            {
+                const int y = begin * 4;
+                DecompressImageDXT(dest + y * width_ * 4, data_ + begin * blockRowSize, width_, Min((int)end * 4, height_) - y, 1,
+                    format_);
+            });
+        }
         return true;
 
     // ETC2 format is compatible with ETC1, so we just use the same function.
     case CF_ETC1:
     case CF_ETC2_RGB:
-        DecompressImageETC(dest, data_, width_, height_, false);
-        return true;
     case CF_ETC2_RGBA:
-        DecompressImageETC(dest, data_, width_, height_, true);
+        ProcessImageRows(workQueue, numBlockRows, destBlockRowSize, [&](unsigned begin, unsigned end)
+        {
+            const int y = begin * 4;
+            DecompressImageETC(dest + y * width_ * 4, data_ + begin * blockRowSize, width_, Min((int)end * 4, height_) - y,
+                format_ == CF_ETC2_RGBA);
+        });
         return true;
 
     case CF_PVRTC_RGB_2BPP:
@@ -819,14 +1045,19 @@ bool Image::BeginLoad(Deserializer& source)
         size_t imgSize = (size_t)features.width * features.height * (features.has_alpha ? 4 : 3);
         ea::shared_array<uint8_t> pixelData(new uint8_t[imgSize]);
 
-        bool decodeError(false);
-        if (features.has_alpha)
+        // Decode into the pixel buffer, letting the decoder filter and decode alpha on a separate thread
+        WebPDecoderConfig config;
+        bool decodeError = !WebPInitDecoderConfig(&config);
+        if (!decodeError)
         {
-            decodeError = WebPDecodeRGBAInto(data.get(), dataSize, pixelData.get(), imgSize, 4 * features.width) == nullptr;
-        }
-        else
-        {
-            decodeError = WebPDecodeRGBInto(data.get(), dataSize, pixelData.get(), imgSize, 3 * features.width) == nullptr;
+            config.options.use_threads = 1;
+            config.output.colorspace = features.has_alpha ? MODE_RGBA : MODE_RGB;
+            config.output.is_external_memory = 1;
+            config.output.u.RGBA.rgba = pixelData.get();
+            config.output.u.RGBA.stride = (features.has_alpha ? 4 : 3) * features.width;
+            config.output.u.RGBA.size = imgSize;
+            decodeError = WebPDecode(data.get(), dataSize, &config) != VP8_STATUS_OK;
+            WebPFreeDecBuffer(&config.output);
         }
         if (decodeError)
         {
@@ -1352,8 +1583,40 @@ bool Image::SaveDDS(const ea::string& fileName) const
 
     if (IsCompressed())
     {
-        URHO3D_LOGERROR("Can not save compressed image to DDS");
-        return false;
+        if (compressedFormat_ != CF_DXT1 && compressedFormat_ != CF_DXT3 && compressedFormat_ != CF_DXT5)
+        {
+            URHO3D_LOGERROR("Can not save compressed image to DDS, only DXT formats are supported");
+            return false;
+        }
+
+        outFile.WriteFileID("DDS ");
+
+        DDSurfaceDesc2 ddsd;        // NOLINT(hicpp-member-init)
+        memset(&ddsd, 0, sizeof(ddsd));
+        ddsd.dwSize_ = sizeof(ddsd);
+        ddsd.dwFlags_ = 0x00000001l /*DDSD_CAPS*/
+            | 0x00000002l /*DDSD_HEIGHT*/ | 0x00000004l /*DDSD_WIDTH*/ | 0x00020000l /*DDSD_MIPMAPCOUNT*/ | 0x00001000l /*DDSD_PIXELFORMAT*/;
+        ddsd.dwWidth_ = width_;
+        ddsd.dwHeight_ = height_;
+        ddsd.dwMipMapCount_ = numCompressedLevels_;
+        ddsd.ddpfPixelFormat_.dwFlags_ = 0x00000004l /*DDPF_FOURCC*/;
+        ddsd.ddpfPixelFormat_.dwSize_ = sizeof(ddsd.ddpfPixelFormat_);
+        ddsd.ddpfPixelFormat_.dwFourCC_ = compressedFormat_ == CF_DXT1 ? FOURCC_DXT1
+            : compressedFormat_ == CF_DXT3 ? FOURCC_DXT3 : FOURCC_DXT5;
+        ddsd.ddsCaps_.dwCaps_ = DDSCAPS_TEXTURE;
+        if (numCompressedLevels_ > 1)
+            ddsd.ddsCaps_.dwCaps_ |= DDSCAPS_COMPLEX | DDSCAPS_MIPMAP;
+
+        outFile.Write(&ddsd, sizeof(ddsd));
+        for (unsigned i = 0; i < numCompressedLevels_; ++i)
+        {
+            const CompressedLevel level = GetCompressedLevel(i);
+            if (!level.data_)
+                return false;
+            outFile.Write(level.data_, level.dataSize_);
+        }
+
+        return true;
     }
 
     if (components_ != 4)
@@ -1601,7 +1864,7 @@ Color Image::GetPixelTrilinear(float x, float y, float z) const
     return colorNear.Lerp(colorFar, zF);
 }
 
-SharedPtr<Image> Image::GetNextLevel() const
+SharedPtr<Image> Image::GetNextLevel(bool sRGB) const
 {
     if (IsCompressed())
     {
@@ -1689,84 +1952,12 @@ SharedPtr<Image> Image::GetNextLevel() const
     // 2D case
     else if (depth_ == 1)
     {
-        switch (components_)
+        const int widthIn = width_;
+        const unsigned components = components_;
+        ProcessImageRows(GetSubsystem<WorkQueue>(), heightOut, widthOut * components, [=](unsigned begin, unsigned end)
         {
-        case 1:
-            for (int y = 0; y < heightOut; ++y)
-            {
-                const unsigned char* inUpper = &pixelDataIn[(y * 2) * width_];
-                const unsigned char* inLower = &pixelDataIn[(y * 2 + 1) * width_];
-                unsigned char* out = &pixelDataOut[y * widthOut];
-
-                for (int x = 0; x < widthOut; ++x)
-                {
-                    out[x] = (unsigned char)(((unsigned)inUpper[x * 2] + inUpper[x * 2 + 1] +
-                                              inLower[x * 2] + inLower[x * 2 + 1]) >> 2);
-                }
-            }
-            break;
-
-        case 2:
-            for (int y = 0; y < heightOut; ++y)
-            {
-                const unsigned char* inUpper = &pixelDataIn[(y * 2) * width_ * 2];
-                const unsigned char* inLower = &pixelDataIn[(y * 2 + 1) * width_ * 2];
-                unsigned char* out = &pixelDataOut[y * widthOut * 2];
-
-                for (int x = 0; x < widthOut * 2; x += 2)
-                {
-                    out[x] = (unsigned char)(((unsigned)inUpper[x * 2] + inUpper[x * 2 + 2] +
-                                              inLower[x * 2] + inLower[x * 2 + 2]) >> 2);
-                    out[x + 1] = (unsigned char)(((unsigned)inUpper[x * 2 + 1] + inUpper[x * 2 + 3] +
-                                                  inLower[x * 2 + 1] + inLower[x * 2 + 3]) >> 2);
-                }
-            }
-            break;
-
-        case 3:
-            for (int y = 0; y < heightOut; ++y)
-            {
-                const unsigned char* inUpper = &pixelDataIn[(y * 2) * width_ * 3];
-                const unsigned char* inLower = &pixelDataIn[(y * 2 + 1) * width_ * 3];
-                unsigned char* out = &pixelDataOut[y * widthOut * 3];
-
-                for (int x = 0; x < widthOut * 3; x += 3)
-                {
-                    out[x] = (unsigned char)(((unsigned)inUpper[x * 2] + inUpper[x * 2 + 3] +
-                                              inLower[x * 2] + inLower[x * 2 + 3]) >> 2);
-                    out[x + 1] = (unsigned char)(((unsigned)inUpper[x * 2 + 1] + inUpper[x * 2 + 4] +
-                                                  inLower[x * 2 + 1] + inLower[x * 2 + 4]) >> 2);
-                    out[x + 2] = (unsigned char)(((unsigned)inUpper[x * 2 + 2] + inUpper[x * 2 + 5] +
-                                                  inLower[x * 2 + 2] + inLower[x * 2 + 5]) >> 2);
-                }
-            }
-            break;
-
-        case 4:
-            for (int y = 0; y < heightOut; ++y)
-            {
-                const unsigned char* inUpper = &pixelDataIn[(y * 2) * width_ * 4];
-                const unsigned char* inLower = &pixelDataIn[(y * 2 + 1) * width_ * 4];
-                unsigned char* out = &pixelDataOut[y * widthOut * 4];
-
-                for (int x = 0; x < widthOut * 4; x += 4)
-                {
-                    out[x] = (unsigned char)(((unsigned)inUpper[x * 2] + inUpper[x * 2 + 4] +
-                                              inLower[x * 2] + inLower[x * 2 + 4]) >> 2);
-                    out[x + 1] = (unsigned char)(((unsigned)inUpper[x * 2 + 1] + inUpper[x * 2 + 5] +
-                                                  inLower[x * 2 + 1] + inLower[x * 2 + 5]) >> 2);
-                    out[x + 2] = (unsigned char)(((unsigned)inUpper[x * 2 + 2] + inUpper[x * 2 + 6] +
-                                                  inLower[x * 2 + 2] + inLower[x * 2 + 6]) >> 2);
-                    out[x + 3] = (unsigned char)(((unsigned)inUpper[x * 2 + 3] + inUpper[x * 2 + 7] +
-                                                  inLower[x * 2 + 3] + inLower[x * 2 + 7]) >> 2);
-                }
-            }
-            break;
-
-        default:
-            assert(false);  // Should never reach here
-            break;
-        }
+            DownsampleRows2D(pixelDataIn, pixelDataOut, widthIn, widthOut, components, sRGB, begin, end);
+        });
     }
     // 3D case
     else
@@ -2121,6 +2312,59 @@ SharedPtr<Image> Image::GetDecompressedImage() const
     return decompressedImage;
 }
 
+SharedPtr<Image> Image::GetCompressedImage(CompressedFormat format) const
+{
+    if (format != CF_DXT1 && format != CF_DXT5)
+    {
+        URHO3D_LOGERROR("Only DXT1 and DXT5 image compression is supported");
+        return nullptr;
+    }
+    if (IsCompressed())
+    {
+        URHO3D_LOGERROR("Can not compress already compressed image");
+        return nullptr;
+    }
+    if (depth_ > 1)
+    {
+        URHO3D_LOGERROR("Compression not supported for 3D images");
+        return nullptr;
+    }
+
+    SharedPtr<Image> rgbaImage = ConvertToRGBA();
+    if (!rgbaImage)
+        return nullptr;
+
+    // Generate the full mip chain down to 1x1, as compressed images can not have their mips generated on load
+    ea::vector<SharedPtr<Image>> levels;
+    levels.push_back(rgbaImage);
+    while (levels.back()->GetWidth() > 1 || levels.back()->GetHeight() > 1)
+        levels.push_back(levels.back()->GetNextLevel(sRGB_));
+
+    const unsigned blockSize = format == CF_DXT1 ? 8 : 16;
+    unsigned dataSize = 0;
+    for (const SharedPtr<Image>& level : levels)
+        dataSize += ((level->GetWidth() + 3) / 4) * ((level->GetHeight() + 3) / 4) * blockSize;
+
+    auto compressedImage = MakeShared<Image>(context_);
+    compressedImage->data_ = new unsigned char[dataSize];
+    compressedImage->width_ = width_;
+    compressedImage->height_ = height_;
+    compressedImage->depth_ = 1;
+    compressedImage->components_ = format == CF_DXT1 ? 3 : 4;
+    compressedImage->compressedFormat_ = format;
+    compressedImage->numCompressedLevels_ = levels.size();
+    compressedImage->sRGB_ = sRGB_;
+    compressedImage->SetMemoryUse(dataSize);
+
+    unsigned char* dest = compressedImage->data_.get();
+    for (const SharedPtr<Image>& level : levels)
+    {
+        CompressImageDXT(dest, level->GetData(), level->GetWidth(), level->GetHeight(), format);
+        dest += ((level->GetWidth() + 3) / 4) * ((level->GetHeight() + 3) / 4) * blockSize;
+    }
+    return compressedImage;
+}
+
 SharedPtr<Image> Image::GetSubimage(const IntRect& rect) const
 {
     if (!data_)
@@ -2349,6 +2593,17 @@ unsigned char* Image::GetImageData(Deserializer& source, int& width, int& height
 {
     unsigned dataSize = source.GetSize();
 
+    // Decode directly from the memory-mapped package if possible
+    if (auto file = dynamic_cast<File*>(&source))
+    {
+        if (const unsigned char* mappedData = file->GetMappedData())
+        {
+            const unsigned position = file->GetPosition();
+            file->Seek(dataSize);
+            return stbi_load_from_memory(mappedData + position, dataSize - position, &width, &height, (int*)&components, 0);
+        }
+    }
+
     ea::shared_array<unsigned char> buffer(new unsigned char[dataSize]);
     source.Read(buffer.get(), dataSize);
     return stbi_load_from_memory(buffer.get(), dataSize, &width, &height, (int*)&components, 0);
@@ -33,6 +33,8 @@ struct SDL_Surface;
 namespace Urho3D
 {
 
+class WorkQueue;
+
 static const int COLOR_LUT_SIZE = 16;
 
 /// Supported compressed image formats.
@@ -56,7 +58,8 @@ enum CompressedFormat
 struct URHO3D_API CompressedLevel
 {
     /// Decompress to RGBA. The destination buffer required is width * height * 4 bytes. Return true if successful.
-    bool Decompress(unsigned char* dest) const;
+    /// When a work queue is given and called from the main thread, block rows of large DXT and ETC levels are decompressed in parallel.
+    bool Decompress(unsigned char* dest, WorkQueue* workQueue = nullptr) const;
 
     /// Compressed image data.
     unsigned char* data_{};
@@ -132,7 +135,7 @@ public:
     bool SaveTGA(const ea::string& fileName) const;
     /// Save in JPG format with specified quality. Return true if successful.
     bool SaveJPG(const ea::string& fileName, int quality) const;
-    /// Save in DDS format. Only uncompressed RGBA images are supported. Return true if successful.
+    /// Save in DDS format. Only uncompressed RGBA images and DXT compressed images are supported. Return true if successful.
     bool SaveDDS(const ea::string& fileName) const;
     /// Save in WebP format with minimum (fastest) or specified compression. Return true if successful. Fails always if WebP support is not compiled in.
     bool SaveWEBP(const ea::string& fileName, float compression = 0.0f) const;
@@ -181,7 +184,8 @@ public:
     unsigned GetNumCompressedLevels() const { return numCompressedLevels_; }
 
     /// Return next mip level by bilinear filtering. Note that if the image is already 1x1x1, will keep returning an image of that size.
-    SharedPtr<Image> GetNextLevel() const;
+    /// When sRGB is true, color of 2D images is averaged in linear space. Large 2D levels are split over the work queue when called from the main thread.
+    SharedPtr<Image> GetNextLevel(bool sRGB = false) const;
     /// Return the next sibling image of an array or cubemap.
     SharedPtr<Image> GetNextSibling() const { return nextSibling_;  }
     /// Return image converted to 4-component (RGBA) to circumvent modern rendering API's not supporting e.g. the luminance-alpha format.
@@ -190,6 +194,8 @@ public:
     CompressedLevel GetCompressedLevel(unsigned index) const;
     /// Return decompressed image data in RGBA format.
     SharedPtr<Image> GetDecompressedImage() const;
+    /// Return image compressed to DXT1 or DXT5 format or null if failed. 2D images only. The full mip chain is generated and compressed.
+    SharedPtr<Image> GetCompressedImage(CompressedFormat format) const;
     /// Return subimage from the image by the defined rect or null if failed. 3D images are not supported. You must free the subimage yourself.
     SharedPtr<Image> GetSubimage(const IntRect& rect) const;
     /// Return an SDL surface from the image, or null if failed. Only RGB images are supported. Specify rect to only return partial image. You must free the surface yourself.
@@ -22,11 +22,336 @@
 
 #include "../Core/StringUtils.h"
 #include "../IO/ArchiveSerialization.h"
+#include "../IO/Deserializer.h"
 #include "../Resource/JSONArchive.h"
 
+#include <rapidjson/error/en.h>
+#include <rapidjson/reader.h>
+
 namespace Urho3D
 {
 
+namespace
+{
+
+// Generate typed reads of JSON values shared by the input archives
+#define URHO3D_JSON_READ_IMPL(type, function, check) \
+    bool ReadJSONValue(const JSONValue& jsonValue, type& value) \
+    { \
+        if (!jsonValue.check()) \
+            return false; \
+        value = jsonValue.function(); \
+        return true; \
+    }
+
+URHO3D_JSON_READ_IMPL(bool, GetBool, IsBool);
+URHO3D_JSON_READ_IMPL(signed char, GetInt, IsNumber);
+URHO3D_JSON_READ_IMPL(short, GetInt, IsNumber);
+URHO3D_JSON_READ_IMPL(int, GetInt, IsNumber);
+URHO3D_JSON_READ_IMPL(unsigned char, GetUInt, IsNumber);
+URHO3D_JSON_READ_IMPL(unsigned short, GetUInt, IsNumber);
+URHO3D_JSON_READ_IMPL(unsigned int, GetUInt, IsNumber);
+URHO3D_JSON_READ_IMPL(float, GetFloat, IsNumber);
+URHO3D_JSON_READ_IMPL(double, GetDouble, IsNumber);
+URHO3D_JSON_READ_IMPL(ea::string, GetString, IsString);
+
+#undef URHO3D_JSON_READ_IMPL
+
+bool ReadJSONValue(const JSONValue& jsonValue, long long& value)
+{
+    if (!jsonValue.IsString())
+        return false;
+    sscanf(jsonValue.GetString().c_str(), "%lld", &value);
+    return true;
+}
+
+bool ReadJSONValue(const JSONValue& jsonValue, unsigned long long& value)
+{
+    if (!jsonValue.IsString())
+        return false;
+    sscanf(jsonValue.GetString().c_str(), "%llu", &value);
+    return true;
+}
+
+/// Parse flags of JSON streams, same as of JSONFile.
+static const unsigned JSON_STREAM_PARSE_FLAGS = rapidjson::kParseCommentsFlag | rapidjson::kParseTrailingCommasFlag;
+/// Size of chunks read from JSON streams.
+static const unsigned JSON_STREAM_CHUNK_SIZE = 64 * 1024;
+
+/// rapidjson input stream reading from Deserializer by chunks.
+class DeserializerStream
+{
+public:
+    using Ch = char;
+
+    /// Construct.
+    explicit DeserializerStream(Deserializer& source)
+        : source_(source)
+        , buffer_(JSON_STREAM_CHUNK_SIZE)
+    {
+        Fill();
+    }
+
+    /// Return current character, or zero at the end.
+    Ch Peek() const { return current_ < end_ ? *current_ : '\0'; }
+    /// Return current character and advance.
+    Ch Take()
+    {
+        if (current_ >= end_)
+            return '\0';
+
+        const Ch ch = *current_++;
+        ++offset_;
+        if (current_ == end_)
+            Fill();
+        return ch;
+    }
+    /// Return number of characters read.
+    size_t Tell() const { return offset_; }
+
+    /// Output is not supported.
+    Ch* PutBegin() { assert(0); return nullptr; }
+    void Put(Ch) { assert(0); }
+    void Flush() { assert(0); }
+    size_t PutEnd(Ch*) { assert(0); return 0; }
+
+private:
+    /// Read next chunk.
+    void Fill()
+    {
+        const unsigned size = source_.IsEof() ? 0 : source_.Read(buffer_.data(), buffer_.size());
+        current_ = buffer_.data();
+        end_ = current_ + size;
+    }
+
+    /// Source stream.
+    Deserializer& source_;
+    /// Chunk buffer.
+    ea::vector<Ch> buffer_;
+    /// Current position in the chunk.
+    const Ch* current_{};
+    /// End of the chunk.
+    const Ch* end_{};
+    /// Number of characters read.
+    size_t offset_{};
+};
+
+/// Collects element counts of arrays and objects in document order.
+struct ContainerSizeCounter : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, ContainerSizeCounter>
+{
+    bool StartObject() { return Start(); }
+    bool EndObject(rapidjson::SizeType count) { return End(count); }
+    bool StartArray() { return Start(); }
+    bool EndArray(rapidjson::SizeType count) { return End(count); }
+
+    bool Start()
+    {
+        openContainers_.push_back(sizes_.size());
+        sizes_.push_back(0);
+        return true;
+    }
+
+    bool End(unsigned count)
+    {
+        sizes_[openContainers_.back()] = count;
+        openContainers_.pop_back();
+        return true;
+    }
+
+    /// Element counts in document order.
+    ea::vector<unsigned> sizes_;
+    /// Indices of the containers being parsed.
+    ea::vector<unsigned> openContainers_;
+};
+
+bool ReadJSONBytes(const JSONValue& jsonValue, ea::vector<unsigned char>& tempBuffer, void* bytes, unsigned size)
+{
+    if (!jsonValue.IsString())
+        return false;
+    if (!HexStringToBuffer(tempBuffer, jsonValue.GetString()))
+        return false;
+    if (size != tempBuffer.size())
+        return false;
+    ea::copy(tempBuffer.begin(), tempBuffer.end(), static_cast<unsigned char*>(bytes));
+    return true;
+}
+
+}
+
+/// Pull parser of JSON streams. Reads one token at a time.
+struct JSONStreamReader
+{
+    /// Token type.
+    enum TokenType
+    {
+        TOKEN_VALUE,
+        TOKEN_KEY,
+        TOKEN_START_OBJECT,
+        TOKEN_END_OBJECT,
+        TOKEN_START_ARRAY,
+        TOKEN_END_ARRAY
+    };
+
+    /// Receives the tokens from rapidjson.
+    struct Handler
+    {
+        bool Null() { return SetValue(JSONValue{}); }
+        bool Bool(bool value) { return SetValue(value); }
+        bool Int(int value) { return SetValue(value); }
+        bool Uint(unsigned value) { return SetValue(value); }
+        bool Int64(int64_t value) { return SetValue(static_cast<double>(value)); }
+        bool Uint64(uint64_t value) { return SetValue(static_cast<double>(value)); }
+        bool Double(double value) { return SetValue(value); }
+        bool RawNumber(const char* str, rapidjson::SizeType length, bool copy) { return String(str, length, copy); }
+        bool String(const char* str, rapidjson::SizeType length, bool /*copy*/) { return SetValue(ea::string(str, length)); }
+        bool Key(const char* str, rapidjson::SizeType length, bool /*copy*/)
+        {
+            type_ = TOKEN_KEY;
+            key_.assign(str, length);
+            return true;
+        }
+        bool StartObject() { type_ = TOKEN_START_OBJECT; return true; }
+        bool EndObject(rapidjson::SizeType /*count*/) { type_ = TOKEN_END_OBJECT; return true; }
+        bool StartArray() { type_ = TOKEN_START_ARRAY; return true; }
+        bool EndArray(rapidjson::SizeType /*count*/) { type_ = TOKEN_END_ARRAY; return true; }
+
+        bool SetValue(JSONValue value)
+        {
+            type_ = TOKEN_VALUE;
+            value_ = ea::move(value);
+            return true;
+        }
+
+        /// Token type.
+        TokenType type_{};
+        /// Scalar value.
+        JSONValue value_;
+        /// Object key.
+        ea::string key_;
+    };
+
+    /// Construct.
+    JSONStreamReader(Deserializer& source, ea::vector<unsigned> containerSizes)
+        : stream_(source)
+        , containerSizes_(ea::move(containerSizes))
+    {
+        reader_.IterativeParseInit();
+    }
+
+    /// Read the next token if not read yet. Return false on error.
+    bool Peek()
+    {
+        if (hasToken_)
+            return true;
+
+        if (reader_.IterativeParseComplete() || !reader_.IterativeParseNext<JSON_STREAM_PARSE_FLAGS>(stream_, handler_))
+            return false;
+
+        hasToken_ = true;
+        if (handler_.type_ == TOKEN_START_OBJECT || handler_.type_ == TOKEN_START_ARRAY)
+            containerSize_ = nextContainer_ < containerSizes_.size() ? containerSizes_[nextContainer_++] : 0;
+        return true;
+    }
+
+    /// Return type of the current token.
+    TokenType GetType() const { return handler_.type_; }
+    /// Return whether the current token ends an object or array.
+    bool IsEnd() const { return handler_.type_ == TOKEN_END_OBJECT || handler_.type_ == TOKEN_END_ARRAY; }
+    /// Consume the current token.
+    void Consume() { hasToken_ = false; }
+
+    /// Read the next value with all its elements.
+    bool ReadValue(JSONValue& dest)
+    {
+        if (!Peek())
+            return false;
+
+        Consume();
+        switch (handler_.type_)
+        {
+        case TOKEN_VALUE:
+            dest = ea::move(handler_.value_);
+            return true;
+
+        case TOKEN_START_OBJECT:
+            dest.SetType(JSON_OBJECT);
+            for (;;)
+            {
+                if (!Peek())
+                    return false;
+                Consume();
+                if (handler_.type_ == TOKEN_END_OBJECT)
+                    return true;
+                if (handler_.type_ != TOKEN_KEY)
+                    return false;
+
+                const ea::string key = ea::move(handler_.key_);
+                JSONValue element;
+                if (!ReadValue(element))
+                    return false;
+                dest.Set(key, ea::move(element));
+            }
+
+        case TOKEN_START_ARRAY:
+            dest.SetType(JSON_ARRAY);
+            for (;;)
+            {
+                if (!Peek())
+                    return false;
+                if (handler_.type_ == TOKEN_END_ARRAY)
+                {
+                    Consume();
+                    return true;
+                }
+
+                JSONValue element;
+                if (!ReadValue(element))
+                    return false;
+                dest.Push(ea::move(element));
+            }
+
+        default:
+            return false;
+        }
+    }
+
+    /// Skip the remaining tokens of the current object or array, including its end.
+    bool SkipToEnd()
+    {
+        unsigned depth = 0;
+        for (;;)
+        {
+            if (!Peek())
+                return false;
+            Consume();
+
+            if (handler_.type_ == TOKEN_START_OBJECT || handler_.type_ == TOKEN_START_ARRAY)
+                ++depth;
+            else if (IsEnd())
+            {
+                if (!depth)
+                    return true;
+                --depth;
+            }
+        }
+    }
+
+    /// Input stream.
+    DeserializerStream stream_;
+    /// Parser.
+    rapidjson::Reader reader_;
+    /// Token handler.
+    Handler handler_;
+    /// Element counts of arrays and objects in document order.
+    ea::vector<unsigned> containerSizes_;
+    /// Index of the next array or object.
+    unsigned nextContainer_{};
+    /// Element count of the current token, if it starts an array or object.
+    unsigned containerSize_{};
+    /// Whether the current token is read and not consumed.
+    bool hasToken_{};
+};
+
 JSONOutputArchiveBlock::JSONOutputArchiveBlock(const char* name, ArchiveBlockType type, JSONValue* blockValue, unsigned sizeHint)
     : name_(name)
     , type_(type)
@@ -479,65 +804,277 @@ bool JSONInputArchive::SerializeKey(unsigned& key)
     return false;
 }
 
-bool JSONInputArchive::Serialize(const char* name, long long& value)
+bool JSONInputArchive::CheckEOF(const char* elementName, const char* debugName)
 {
-    if (const JSONValue* jsonValue = ReadElement(name))
+    if (HasError())
+        return false;
+
+    if (!ValidateName(elementName))
     {
-        if (jsonValue->IsString())
-        {
-            const ea::string stringValue = jsonValue->GetString();
-            sscanf(stringValue.c_str(), "%lld", &value);
-            return true;
-        }
+        SetErrorFormatted(ArchiveBase::fatalInvalidName, debugName);
+        return false;
     }
-    return false;
+
+    if (IsEOF())
+    {
+        SetErrorFormatted(ArchiveBase::errorEOF_elementName, debugName);
+        return false;
+    }
+
+    return true;
 }
 
-bool JSONInputArchive::Serialize(const char* name, unsigned long long& value)
+bool JSONInputArchive::CheckEOFAndRoot(const char* elementName, const char* debugName)
 {
-    if (const JSONValue* jsonValue = ReadElement(name))
+    if (!CheckEOF(elementName, debugName))
+        return false;
+
+    if (stack_.empty())
     {
-        if (jsonValue->IsString())
+        SetErrorFormatted(ArchiveBase::fatalRootBlockNotOpened_elementName, debugName);
+        assert(0);
+        return false;
+    }
+
+    return true;
+}
+
+const JSONValue* JSONInputArchive::ReadElement(const char* name)
+{
+    if (!CheckEOFAndRoot(name, name))
+        return nullptr;
+
+    return GetCurrentBlock().ReadElement(*this, name, nullptr);
+}
+
+// Generate serialization implementation (JSON input)
+#define URHO3D_JSON_IN_IMPL(archive, type) \
+    bool archive::Serialize(const char* name, type& value) \
+    { \
+        const JSONValue* jsonValue = ReadElement(name); \
+        return jsonValue && ReadJSONValue(*jsonValue, value); \
+    }
+
+URHO3D_JSON_IN_IMPL(JSONInputArchive, bool);
+URHO3D_JSON_IN_IMPL(JSONInputArchive, signed char);
+URHO3D_JSON_IN_IMPL(JSONInputArchive, short);
+URHO3D_JSON_IN_IMPL(JSONInputArchive, int);
+URHO3D_JSON_IN_IMPL(JSONInputArchive, unsigned char);
+URHO3D_JSON_IN_IMPL(JSONInputArchive, unsigned short);
+URHO3D_JSON_IN_IMPL(JSONInputArchive, unsigned int);
+URHO3D_JSON_IN_IMPL(JSONInputArchive, long long);
+URHO3D_JSON_IN_IMPL(JSONInputArchive, unsigned long long);
+URHO3D_JSON_IN_IMPL(JSONInputArchive, float);
+URHO3D_JSON_IN_IMPL(JSONInputArchive, double);
+URHO3D_JSON_IN_IMPL(JSONInputArchive, ea::string);
+
+bool JSONInputArchive::SerializeBytes(const char* name, void* bytes, unsigned size)
+{
+    const JSONValue* jsonValue = ReadElement(name);
+    return jsonValue && ReadJSONBytes(*jsonValue, tempBuffer_, bytes, size);
+}
+
+bool JSONInputArchive::SerializeVLE(const char* name, unsigned& value)
+{
+    const JSONValue* jsonValue = ReadElement(name);
+    return jsonValue && ReadJSONValue(*jsonValue, value);
+}
+
+JSONStreamInputArchiveBlock::JSONStreamInputArchiveBlock(const char* name, ArchiveBlockType type, unsigned sizeHint)
+    : name_(name ? name : "")
+    , type_(type)
+    , sizeHint_(sizeHint)
+{
+}
+
+JSONStreamInputArchiveBlock::JSONStreamInputArchiveBlock(const char* name, ArchiveBlockType type, const JSONValue* value)
+    : name_(name ? name : "")
+    , type_(type)
+    , sizeHint_(value->Size())
+    , bufferedBlock_(ea::in_place, name, type, value)
+{
+}
+
+JSONStreamInputArchive::JSONStreamInputArchive(Context* context, Deserializer& source)
+    : context_(context)
+    , name_(source.GetName())
+{
+    // Collect the sizes first, because Array and Map blocks must report their size when opened
+    const unsigned startPosition = source.GetPosition();
+    ContainerSizeCounter counter;
+    {
+        DeserializerStream stream(source);
+        rapidjson::Reader reader;
+        if (!reader.Parse<JSON_STREAM_PARSE_FLAGS>(stream, counter))
         {
-            const ea::string stringValue = jsonValue->GetString();
-            sscanf(stringValue.c_str(), "%llu", &value);
-            return true;
+            SetErrorFormatted("Could not parse JSON data from {}: {} at offset {}", name_,
+                rapidjson::GetParseError_En(reader.GetParseErrorCode()), reader.GetErrorOffset());
+            return;
         }
     }
-    return false;
+
+    if (source.Seek(startPosition) != startPosition)
+    {
+        SetErrorFormatted("Could not seek JSON stream {}", name_);
+        return;
+    }
+
+    reader_ = ea::make_unique<JSONStreamReader>(source, ea::move(counter.sizes_));
 }
 
-bool JSONInputArchive::SerializeBytes(const char* name, void* bytes, unsigned size)
+JSONStreamInputArchive::~JSONStreamInputArchive() = default;
+
+ea::string JSONStreamInputArchive::GetCurrentStackString()
+{
+    ea::string result;
+    for (const Block& block : stack_)
+    {
+        if (!result.empty())
+            result += "/";
+        result += ea::string{ block.GetName() };
+    }
+    return result;
+}
+
+bool JSONStreamInputArchive::BeginBlock(const char* name, unsigned& sizeHint, bool safe, ArchiveBlockType type)
 {
-    if (const JSONValue* jsonValue = ReadElement(name))
+    if (!CheckEOF(name, name))
+        return false;
+
+    if (!stack_.empty())
     {
-        if (jsonValue->IsString())
+        Block& parentBlock = GetCurrentBlock();
+
+        // Blocks inside of buffered blocks are buffered too
+        const JSONValue* blockValue = nullptr;
+        if (parentBlock.IsBuffered())
         {
-            if (!HexStringToBuffer(tempBuffer_, jsonValue->GetString()))
+            blockValue = parentBlock.bufferedBlock_->ReadElement(*this, name, &type);
+            if (!blockValue)
                 return false;
-            if (size != tempBuffer_.size())
+        }
+        else if (!FindElement(name, blockValue))
+            return false;
+
+        if (blockValue)
+        {
+            if (!IsArchiveBlockTypeMatching(*blockValue, type))
+            {
+                SetErrorFormatted(ArchiveBase::errorUnexpectedBlockType_blockName, name);
                 return false;
-            ea::copy(tempBuffer_.begin(), tempBuffer_.end(), static_cast<unsigned char*>(bytes));
+            }
+
+            Block block{ name, type, blockValue };
+            sizeHint = block.sizeHint_;
+            stack_.push_back(ea::move(block));
             return true;
         }
     }
-    return false;
+
+    // Open block in the stream
+    if (!reader_->Peek())
+    {
+        SetErrorFormatted(ArchiveBase::errorUnspecifiedFailure_elementName, name);
+        return false;
+    }
+
+    const JSONStreamReader::TokenType tokenType = reader_->GetType();
+    if (tokenType == JSONStreamReader::TOKEN_VALUE && reader_->handler_.value_.IsNull())
+    {
+        // Null value is an empty block
+        Block block{ name, type, 0u };
+        block.ownedValue_ = ea::make_unique<JSONValue>();
+        block.bufferedBlock_.emplace(name, type, block.ownedValue_.get());
+        reader_->Consume();
+        NextElement();
+
+        sizeHint = 0;
+        stack_.push_back(ea::move(block));
+        return true;
+    }
+
+    if (!(tokenType == JSONStreamReader::TOKEN_START_ARRAY && IsArchiveBlockJSONArray(type))
+        && !(tokenType == JSONStreamReader::TOKEN_START_OBJECT && IsArchiveBlockJSONObject(type)))
+    {
+        SetErrorFormatted(ArchiveBase::errorUnexpectedBlockType_blockName, name);
+        return false;
+    }
+
+    sizeHint = reader_->containerSize_;
+    reader_->Consume();
+    NextElement();
+    stack_.push_back(Block{ name, type, sizeHint });
+    return true;
 }
 
-bool JSONInputArchive::SerializeVLE(const char* name, unsigned& value)
+bool JSONStreamInputArchive::EndBlock()
 {
-    if (const JSONValue* jsonValue = ReadElement(name))
+    if (stack_.empty())
     {
-        if (jsonValue->IsNumber())
-        {
-            value = jsonValue->GetUInt();
-            return true;
-        }
+        SetErrorFormatted(ArchiveBase::fatalUnexpectedEndBlock);
+        return false;
+    }
+
+    // Skip the elements that were not read
+    if (!GetCurrentBlock().IsBuffered() && !HasError() && !reader_->SkipToEnd())
+        SetErrorFormatted(ArchiveBase::errorUnspecifiedFailure_elementName, ArchiveBase::blockElementName_);
+
+    stack_.pop_back();
+    if (stack_.empty())
+        CloseArchive();
+    return true;
+}
+
+bool JSONStreamInputArchive::SerializeKey(ea::string& key)
+{
+    if (!CheckEOFAndRoot("", ArchiveBase::keyElementName_))
+        return false;
+
+    return ReadCurrentKey(key);
+}
+
+bool JSONStreamInputArchive::SerializeKey(unsigned& key)
+{
+    if (!CheckEOFAndRoot("", ArchiveBase::keyElementName_))
+        return false;
+
+    ea::string stringKey;
+    if (ReadCurrentKey(stringKey))
+    {
+        key = ToUInt(stringKey);
+        return true;
     }
     return false;
 }
 
-bool JSONInputArchive::CheckEOF(const char* elementName, const char* debugName)
+URHO3D_JSON_IN_IMPL(JSONStreamInputArchive, bool);
+URHO3D_JSON_IN_IMPL(JSONStreamInputArchive, signed char);
+URHO3D_JSON_IN_IMPL(JSONStreamInputArchive, short);
+URHO3D_JSON_IN_IMPL(JSONStreamInputArchive, int);
+URHO3D_JSON_IN_IMPL(JSONStreamInputArchive, unsigned char);
+URHO3D_JSON_IN_IMPL(JSONStreamInputArchive, unsigned short);
+URHO3D_JSON_IN_IMPL(JSONStreamInputArchive, unsigned int);
+URHO3D_JSON_IN_IMPL(JSONStreamInputArchive, long long);
+URHO3D_JSON_IN_IMPL(JSONStreamInputArchive, unsigned long long);
+URHO3D_JSON_IN_IMPL(JSONStreamInputArchive, float);
+URHO3D_JSON_IN_IMPL(JSONStreamInputArchive, double);
+URHO3D_JSON_IN_IMPL(JSONStreamInputArchive, ea::string);
+
+#undef URHO3D_JSON_IN_IMPL
+
+bool JSONStreamInputArchive::SerializeBytes(const char* name, void* bytes, unsigned size)
+{
+    const JSONValue* jsonValue = ReadElement(name);
+    return jsonValue && ReadJSONBytes(*jsonValue, tempBuffer_, bytes, size);
+}
+
+bool JSONStreamInputArchive::SerializeVLE(const char* name, unsigned& value)
+{
+    const JSONValue* jsonValue = ReadElement(name);
+    return jsonValue && ReadJSONValue(*jsonValue, value);
+}
+
+bool JSONStreamInputArchive::CheckEOF(const char* elementName, const char* debugName)
 {
     if (HasError())
         return false;
@@ -557,7 +1094,7 @@ bool JSONInputArchive::CheckEOF(const char* elementName, const char* debugName)
     return true;
 }
 
-bool JSONInputArchive::CheckEOFAndRoot(const char* elementName, const char* debugName)
+bool JSONStreamInputArchive::CheckEOFAndRoot(const char* elementName, const char* debugName)
 {
     if (!CheckEOF(elementName, debugName))
         return false;
@@ -572,40 +1109,135 @@ bool JSONInputArchive::CheckEOFAndRoot(const char* elementName, const char* debu
     return true;
 }
 
-const JSONValue* JSONInputArchive::ReadElement(const char* name)
+bool JSONStreamInputArchive::ReadCurrentKey(ea::string& key)
+{
+    Block& block = GetCurrentBlock();
+    if (block.IsBuffered())
+        return block.bufferedBlock_->ReadCurrentKey(*this, key);
+
+    if (block.type_ != ArchiveBlockType::Map)
+    {
+        SetErrorFormatted(ArchiveBase::fatalUnexpectedKeySerialization);
+        assert(0);
+        return false;
+    }
+
+    if (block.keyRead_)
+    {
+        SetErrorFormatted(ArchiveBase::fatalDuplicateKeySerialization);
+        assert(0);
+        return false;
+    }
+
+    if (!reader_->Peek() || reader_->GetType() != JSONStreamReader::TOKEN_KEY)
+    {
+        SetErrorFormatted(ArchiveBase::errorElementNotFound_elementName, ArchiveBase::keyElementName_);
+        return false;
+    }
+
+    key = reader_->handler_.key_;
+    reader_->Consume();
+    block.keyRead_ = true;
+    return true;
+}
+
+bool JSONStreamInputArchive::FindElement(const char* name, const JSONValue*& bufferedValue)
+{
+    Block& block = GetCurrentBlock();
+    bufferedValue = nullptr;
+
+    if (block.type_ == ArchiveBlockType::Map && !block.keyRead_)
+    {
+        SetErrorFormatted(ArchiveBase::fatalMissingKeySerialization);
+        assert(0);
+        return false;
+    }
+
+    if (block.type_ != ArchiveBlockType::Unordered)
+    {
+        if (!reader_->Peek() || reader_->IsEnd())
+        {
+            SetErrorFormatted(ArchiveBase::errorElementNotFound_elementName, name);
+            return false;
+        }
+        return true;
+    }
+
+    if (!name)
+    {
+        SetErrorFormatted(ArchiveBase::fatalMissingElementName);
+        assert(0);
+        return false;
+    }
+
+    const auto iter = block.bufferedElements_.find_as(name);
+    if (iter != block.bufferedElements_.end())
+    {
+        bufferedValue = &iter->second;
+        return true;
+    }
+
+    // Elements are usually read in the order they were written, so buffer only the ones that are skipped over
+    for (;;)
+    {
+        if (!reader_->Peek())
+        {
+            SetErrorFormatted(ArchiveBase::errorUnspecifiedFailure_elementName, name);
+            return false;
+        }
+
+        // Not an error in Unordered block
+        if (reader_->IsEnd())
+            return false;
+
+        if (reader_->GetType() != JSONStreamReader::TOKEN_KEY)
+        {
+            SetErrorFormatted(ArchiveBase::errorUnspecifiedFailure_elementName, name);
+            return false;
+        }
+
+        const ea::string key = reader_->handler_.key_;
+        reader_->Consume();
+        if (key == name)
+            return true;
+
+        if (!reader_->ReadValue(block.bufferedElements_[key]))
+        {
+            SetErrorFormatted(ArchiveBase::errorUnspecifiedFailure_elementName, key);
+            return false;
+        }
+    }
+}
+
+const JSONValue* JSONStreamInputArchive::ReadElement(const char* name)
 {
     if (!CheckEOFAndRoot(name, name))
         return nullptr;
 
-    return GetCurrentBlock().ReadElement(*this, name, nullptr);
-}
+    Block& block = GetCurrentBlock();
+    if (block.IsBuffered())
+        return block.bufferedBlock_->ReadElement(*this, name, nullptr);
 
-// Generate serialization implementation (JSON input)
-#define URHO3D_JSON_IN_IMPL(type, function, check) \
-    bool JSONInputArchive::Serialize(const char* name, type& value) \
-    { \
-        if (const JSONValue* jsonValue = ReadElement(name)) \
-        { \
-            if (jsonValue->check()) \
-            { \
-                value = jsonValue->function(); \
-                return true; \
-            } \
-        } \
-        return false; \
-    }
-
-URHO3D_JSON_IN_IMPL(bool, GetBool, IsBool);
-URHO3D_JSON_IN_IMPL(signed char, GetInt, IsNumber);
-URHO3D_JSON_IN_IMPL(short, GetInt, IsNumber);
-URHO3D_JSON_IN_IMPL(int, GetInt, IsNumber);
-URHO3D_JSON_IN_IMPL(unsigned char, GetUInt, IsNumber);
-URHO3D_JSON_IN_IMPL(unsigned short, GetUInt, IsNumber);
-URHO3D_JSON_IN_IMPL(unsigned int, GetUInt, IsNumber);
-URHO3D_JSON_IN_IMPL(float, GetFloat, IsNumber);
-URHO3D_JSON_IN_IMPL(double, GetDouble, IsNumber);
-URHO3D_JSON_IN_IMPL(ea::string, GetString, IsString);
+    const JSONValue* bufferedValue = nullptr;
+    if (!FindElement(name, bufferedValue))
+        return nullptr;
+    if (bufferedValue)
+        return bufferedValue;
 
-#undef URHO3D_JSON_IN_IMPL
+    if (!reader_->ReadValue(tempValue_))
+    {
+        SetErrorFormatted(ArchiveBase::errorUnspecifiedFailure_elementName, name);
+        return nullptr;
+    }
+
+    NextElement();
+    return &tempValue_;
+}
+
+void JSONStreamInputArchive::NextElement()
+{
+    if (!stack_.empty())
+        GetCurrentBlock().keyRead_ = false;
+}
 
 }
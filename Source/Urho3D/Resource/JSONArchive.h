@@ -26,9 +26,14 @@
 #include "../Resource/JSONFile.h"
 #include "../Resource/JSONValue.h"
 
+#include <EASTL/optional.h>
+
 namespace Urho3D
 {
 
+class Deserializer;
+struct JSONStreamReader;
+
 /// Return whether the block type should be serialized as JSON array.
 inline bool IsArchiveBlockJSONArray(ArchiveBlockType type) { return type == ArchiveBlockType::Array || type == ArchiveBlockType::Sequential; }
 
@@ -303,4 +308,130 @@ private:
     const JSONValue& rootValue_;
 };
 
+/// JSON stream input archive block. Internal.
+struct JSONStreamInputArchiveBlock
+{
+    /// Construct block read from the stream.
+    JSONStreamInputArchiveBlock(const char* name, ArchiveBlockType type, unsigned sizeHint);
+    /// Construct block read from buffered value.
+    JSONStreamInputArchiveBlock(const char* name, ArchiveBlockType type, const JSONValue* value);
+
+    /// Return name.
+    ea::string_view GetName() const { return name_; }
+    /// Return block type.
+    ArchiveBlockType GetType() const { return type_; }
+    /// Return whether the block is read from buffered value instead of the stream.
+    bool IsBuffered() const { return bufferedBlock_.has_value(); }
+
+    /// Block name.
+    ea::string_view name_{};
+    /// Block type.
+    ArchiveBlockType type_{};
+    /// Number of elements.
+    unsigned sizeHint_{};
+    /// Block over buffered value, if the block was read ahead of the requested order.
+    ea::optional<JSONInputArchiveBlock> bufferedBlock_;
+    /// Buffered value owned by the block.
+    ea::unique_ptr<JSONValue> ownedValue_;
+    /// Elements of Unordered block read ahead from the stream while looking for another element.
+    ea::unordered_map<ea::string, JSONValue> bufferedElements_;
+    /// Whether the key was read (for Map blocks).
+    bool keyRead_{};
+};
+
+/// JSON input archive that parses the source stream incrementally instead of building a JSONFile.
+/// Memory use is bounded by the elements of Unordered blocks read out of order, which are buffered until requested.
+/// The source must be seekable: sizes of arrays and objects are collected in a first pass.
+class URHO3D_API JSONStreamInputArchive : public ArchiveBaseT<true, true>
+{
+public:
+    /// Construct from stream. The stream must outlive the archive.
+    JSONStreamInputArchive(Context* context, Deserializer& source);
+    /// Destruct.
+    ~JSONStreamInputArchive();
+
+    /// Get context.
+    Context* GetContext() final { return context_; }
+    /// Return name of the archive.
+    ea::string_view GetName() const final { return name_; }
+    /// Whether the unordered element access is supported for Unordered blocks.
+    bool IsUnorderedSupportedNow() const final { return !stack_.empty() && stack_.back().GetType() == ArchiveBlockType::Unordered; }
+    /// Return current string stack.
+    ea::string GetCurrentStackString() final;
+
+    /// Begin archive block.
+    bool BeginBlock(const char* name, unsigned& sizeHint, bool safe, ArchiveBlockType type) final;
+    /// End archive block.
+    bool EndBlock() final;
+
+    /// Serialize string key. Used with Map block only.
+    bool SerializeKey(ea::string& key) final;
+    /// Serialize unsigned integer key. Used with Map block only.
+    bool SerializeKey(unsigned& key) final;
+
+    /// Serialize bool.
+    bool Serialize(const char* name, bool& value) final;
+    /// Serialize signed char.
+    bool Serialize(const char* name, signed char& value) final;
+    /// Serialize unsigned char.
+    bool Serialize(const char* name, unsigned char& value) final;
+    /// Serialize signed short.
+    bool Serialize(const char* name, short& value) final;
+    /// Serialize unsigned short.
+    bool Serialize(const char* name, unsigned short& value) final;
+    /// Serialize signed int.
+    bool Serialize(const char* name, int& value) final;
+    /// Serialize unsigned int.
+    bool Serialize(const char* name, unsigned int& value) final;
+    /// Serialize signed long.
+    bool Serialize(const char* name, long long& value) final;
+    /// Serialize unsigned long.
+    bool Serialize(const char* name, unsigned long long& value) final;
+    /// Serialize float.
+    bool Serialize(const char* name, float& value) final;
+    /// Serialize double.
+    bool Serialize(const char* name, double& value) final;
+    /// Serialize string.
+    bool Serialize(const char* name, ea::string& value) final;
+
+    /// Serialize bytes. Size is not encoded and should be provided externally!
+    bool SerializeBytes(const char* name, void* bytes, unsigned size) final;
+    /// Serialize Variable Length Encoded unsigned integer, up to 29 significant bits.
+    bool SerializeVLE(const char* name, unsigned& value) final;
+
+private:
+    /// Block type.
+    using Block = JSONStreamInputArchiveBlock;
+
+    /// Return current block.
+    Block& GetCurrentBlock() { return stack_.back(); }
+
+    /// Check EOF.
+    bool CheckEOF(const char* elementName, const char* debugName);
+    /// Check EOF and root block.
+    bool CheckEOFAndRoot(const char* elementName, const char* debugName);
+    /// Read key of the next element of Map block.
+    bool ReadCurrentKey(ea::string& key);
+    /// Position the stream at the next element of the current block, or find it among buffered elements.
+    /// Return false if not found. Buffered value is returned in the output pointer, null if the element is in the stream.
+    bool FindElement(const char* name, const JSONValue*& bufferedValue);
+    /// Deserialize scalar element.
+    const JSONValue* ReadElement(const char* name);
+    /// Finish element read and move to the next one.
+    void NextElement();
+
+    /// Context.
+    Context* context_{};
+    /// Archive name.
+    ea::string name_;
+    /// Stream reader.
+    ea::unique_ptr<JSONStreamReader> reader_;
+    /// Blocks stack.
+    ea::vector<Block> stack_;
+    /// Last scalar value read from the stream.
+    JSONValue tempValue_;
+    /// Temporary buffer.
+    ea::vector<unsigned char> tempBuffer_;
+};
+
 }
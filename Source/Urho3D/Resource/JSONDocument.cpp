@@ -0,0 +1,320 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Core/Profiler.h"
+#include "../IO/Deserializer.h"
+#include "../IO/Log.h"
+#include "../Resource/JSONDocument.h"
+
+#include <EASTL/sort.h>
+
+#include <rapidjson/error/en.h>
+#include <rapidjson/reader.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Builds flat node array from SAX events.
+struct JSONDocumentBuilder : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, JSONDocumentBuilder>
+{
+    using Node = JSONDocument::Node;
+
+    JSONDocumentBuilder(const char* buffer, ea::vector<Node>& nodes) : buffer_(buffer), nodes_(nodes) {}
+
+    bool Null() { return AddValue(JSON_NULL, JSONNT_NAN, 0.0); }
+    bool Bool(bool value) { return AddValue(JSON_BOOL, JSONNT_NAN, value ? 1.0 : 0.0); }
+    bool Int(int value) { return AddValue(JSON_NUMBER, JSONNT_INT, value); }
+    bool Uint(unsigned value) { return AddValue(JSON_NUMBER, value <= static_cast<unsigned>(M_MAX_INT) ? JSONNT_INT : JSONNT_UINT, value); }
+    bool Int64(int64_t value) { return AddValue(JSON_NUMBER, JSONNT_FLOAT_DOUBLE, static_cast<double>(value)); }
+    bool Uint64(uint64_t value) { return AddValue(JSON_NUMBER, JSONNT_FLOAT_DOUBLE, static_cast<double>(value)); }
+    bool Double(double value) { return AddValue(JSON_NUMBER, JSONNT_FLOAT_DOUBLE, value); }
+
+    bool String(const char* str, rapidjson::SizeType length, bool /*copy*/)
+    {
+        Node& node = PushNode(JSON_STRING);
+        node.offset_ = GetOffset(str);
+        node.length_ = length;
+        return true;
+    }
+
+    bool Key(const char* str, rapidjson::SizeType length, bool /*copy*/)
+    {
+        pendingKeyOffset_ = GetOffset(str);
+        pendingKeyLength_ = length;
+        return true;
+    }
+
+    bool StartObject() { return StartContainer(JSON_OBJECT); }
+    bool EndObject(rapidjson::SizeType /*count*/) { return EndContainer(); }
+    bool StartArray() { return StartContainer(JSON_ARRAY); }
+    bool EndArray(rapidjson::SizeType /*count*/) { return EndContainer(); }
+
+    bool AddValue(JSONValueType type, JSONNumberType numberType, double value)
+    {
+        Node& node = PushNode(type);
+        node.numberType_ = static_cast<unsigned char>(numberType);
+        node.numberValue_ = value;
+        return true;
+    }
+
+    bool StartContainer(JSONValueType type)
+    {
+        PushNode(type);
+        openContainers_.push_back(scratch_.size() - 1);
+        return true;
+    }
+
+    bool EndContainer()
+    {
+        // Move the elements to the final storage, so they are contiguous
+        const unsigned containerIndex = openContainers_.back();
+        openContainers_.pop_back();
+
+        Node& container = scratch_[containerIndex];
+        const auto elementsBegin = scratch_.begin() + containerIndex + 1;
+        if (container.type_ == JSON_OBJECT)
+        {
+            ea::stable_sort(elementsBegin, scratch_.end(),
+                [](const Node& lhs, const Node& rhs) { return lhs.keyHash_ < rhs.keyHash_; });
+        }
+
+        container.offset_ = nodes_.size();
+        container.length_ = scratch_.end() - elementsBegin;
+        nodes_.insert(nodes_.end(), elementsBegin, scratch_.end());
+        scratch_.erase(elementsBegin, scratch_.end());
+        return true;
+    }
+
+    Node& PushNode(JSONValueType type)
+    {
+        Node& node = scratch_.push_back();
+        node.type_ = static_cast<unsigned char>(type);
+        if (!openContainers_.empty() && scratch_[openContainers_.back()].type_ == JSON_OBJECT)
+        {
+            node.keyOffset_ = pendingKeyOffset_;
+            node.keyLength_ = pendingKeyLength_;
+            node.keyHash_ = StringHash(ea::string_view{ buffer_ + pendingKeyOffset_, pendingKeyLength_ });
+        }
+        return node;
+    }
+
+    unsigned GetOffset(const char* str) const { return static_cast<unsigned>(str - buffer_); }
+
+    /// Source buffer.
+    const char* buffer_{};
+    /// Final node storage.
+    ea::vector<Node>& nodes_;
+    /// Nodes of the containers being parsed, followed by their elements parsed so far.
+    ea::vector<Node> scratch_;
+    /// Indices of the containers being parsed in the scratch array.
+    ea::vector<unsigned> openContainers_;
+    /// Key of the next object member.
+    unsigned pendingKeyOffset_{};
+    unsigned pendingKeyLength_{};
+};
+
+}
+
+JSONValueType JSONDocumentValue::GetValueType() const
+{
+    return document_ ? static_cast<JSONValueType>(document_->nodes_[index_].type_) : JSON_NULL;
+}
+
+JSONNumberType JSONDocumentValue::GetNumberType() const
+{
+    return document_ ? static_cast<JSONNumberType>(document_->nodes_[index_].numberType_) : JSONNT_NAN;
+}
+
+bool JSONDocumentValue::GetBool(bool defaultValue) const
+{
+    return IsBool() ? document_->nodes_[index_].numberValue_ != 0.0 : defaultValue;
+}
+
+double JSONDocumentValue::GetDouble(double defaultValue) const
+{
+    return IsNumber() ? document_->nodes_[index_].numberValue_ : defaultValue;
+}
+
+ea::string_view JSONDocumentValue::GetString(ea::string_view defaultValue) const
+{
+    if (!IsString())
+        return defaultValue;
+
+    const JSONDocument::Node& node = document_->nodes_[index_];
+    return document_->GetString(node.offset_, node.length_);
+}
+
+const char* JSONDocumentValue::GetCString(const char* defaultValue) const
+{
+    return IsString() ? GetString().data() : defaultValue;
+}
+
+unsigned JSONDocumentValue::Size() const
+{
+    return IsArray() || IsObject() ? document_->nodes_[index_].length_ : 0;
+}
+
+JSONDocumentValue JSONDocumentValue::Get(unsigned index) const
+{
+    if (index >= Size())
+        return {};
+
+    return { document_, document_->nodes_[index_].offset_ + index };
+}
+
+ea::string_view JSONDocumentValue::GetKey(unsigned index) const
+{
+    if (!IsObject() || index >= Size())
+        return {};
+
+    const JSONDocument::Node& member = document_->nodes_[document_->nodes_[index_].offset_ + index];
+    return document_->GetString(member.keyOffset_, member.keyLength_);
+}
+
+JSONDocumentValue JSONDocumentValue::Get(ea::string_view key) const
+{
+    if (!IsObject())
+        return {};
+
+    const JSONDocument::Node& node = document_->nodes_[index_];
+    const auto begin = document_->nodes_.begin() + node.offset_;
+    const auto end = begin + node.length_;
+
+    const StringHash keyHash{ key };
+    auto iter = ea::lower_bound(begin, end, keyHash,
+        [](const JSONDocument::Node& member, StringHash hash) { return member.keyHash_ < hash; });
+
+    // Compare strings too in case of hash collision
+    for (; iter != end && iter->keyHash_ == keyHash; ++iter)
+    {
+        if (document_->GetString(iter->keyOffset_, iter->keyLength_) == key)
+            return { document_, static_cast<unsigned>(iter - document_->nodes_.begin()) };
+    }
+    return {};
+}
+
+void JSONDocumentValue::ToJSONValue(JSONValue& dest) const
+{
+    switch (GetValueType())
+    {
+    case JSON_NULL:
+        dest.SetType(JSON_NULL);
+        break;
+
+    case JSON_BOOL:
+        dest = GetBool();
+        break;
+
+    case JSON_NUMBER:
+        switch (GetNumberType())
+        {
+        case JSONNT_INT: dest = GetInt(); break;
+        case JSONNT_UINT: dest = GetUInt(); break;
+        default: dest = GetDouble(); break;
+        }
+        break;
+
+    case JSON_STRING:
+        dest = ea::string(GetString());
+        break;
+
+    case JSON_ARRAY:
+        {
+            const unsigned size = Size();
+            dest.Resize(size);
+            for (unsigned i = 0; i < size; ++i)
+                Get(i).ToJSONValue(dest[i]);
+        }
+        break;
+
+    case JSON_OBJECT:
+        {
+            dest.SetType(JSON_OBJECT);
+            const unsigned size = Size();
+            for (unsigned i = 0; i < size; ++i)
+                Get(i).ToJSONValue(dest[ea::string(GetKey(i))]);
+        }
+        break;
+    }
+}
+
+JSONValue JSONDocumentValue::ToJSONValue() const
+{
+    JSONValue result;
+    ToJSONValue(result);
+    return result;
+}
+
+bool JSONDocument::Parse(ea::string source)
+{
+    URHO3D_PROFILE("ParseJSONDocument");
+
+    Clear();
+    buffer_ = ea::move(source);
+
+    JSONDocumentBuilder builder{ buffer_.data(), nodes_ };
+    rapidjson::InsituStringStream stream{ buffer_.data() };
+    rapidjson::Reader reader;
+    if (!reader.Parse<rapidjson::kParseInsituFlag | rapidjson::kParseCommentsFlag | rapidjson::kParseTrailingCommasFlag>(stream, builder))
+    {
+        URHO3D_LOGERROR("Could not parse JSON data: {} at offset {}",
+            rapidjson::GetParseError_En(reader.GetParseErrorCode()), reader.GetErrorOffset());
+        Clear();
+        return false;
+    }
+
+    // Root is the only node left in the scratch array
+    assert(builder.scratch_.size() == 1);
+    rootIndex_ = nodes_.size();
+    nodes_.push_back(builder.scratch_.back());
+    return true;
+}
+
+bool JSONDocument::Load(Deserializer& source)
+{
+    const unsigned dataSize = source.GetSize() - source.GetPosition();
+    ea::string text;
+    text.resize(dataSize);
+    if (source.Read(text.data(), dataSize) != dataSize)
+    {
+        URHO3D_LOGERROR("Could not read JSON data from {}", source.GetName());
+        return false;
+    }
+    return Parse(ea::move(text));
+}
+
+void JSONDocument::Clear()
+{
+    buffer_.clear();
+    nodes_.clear();
+    rootIndex_ = 0;
+}
+
+}
@@ -0,0 +1,163 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+/// \file
+
+#pragma once
+
+#include "../Math/StringHash.h"
+#include "../Resource/JSONValue.h"
+
+#include <EASTL/string_view.h>
+
+namespace Urho3D
+{
+
+class Deserializer;
+class JSONDocument;
+
+/// Read-only view of the value stored in JSONDocument. Valid as long as the document is not modified or destroyed.
+class URHO3D_API JSONDocumentValue
+{
+public:
+    /// Construct null value.
+    JSONDocumentValue() = default;
+    /// Construct from document and node index.
+    JSONDocumentValue(const JSONDocument* document, unsigned index) : document_(document), index_(index) {}
+
+    /// Return whether the value is stored in the document.
+    bool IsValid() const { return document_ != nullptr; }
+    /// Return value type.
+    JSONValueType GetValueType() const;
+    /// Return number type.
+    JSONNumberType GetNumberType() const;
+
+    /// Check is null.
+    bool IsNull() const { return GetValueType() == JSON_NULL; }
+    /// Check is boolean.
+    bool IsBool() const { return GetValueType() == JSON_BOOL; }
+    /// Check is number.
+    bool IsNumber() const { return GetValueType() == JSON_NUMBER; }
+    /// Check is string.
+    bool IsString() const { return GetValueType() == JSON_STRING; }
+    /// Check is array.
+    bool IsArray() const { return GetValueType() == JSON_ARRAY; }
+    /// Check is object.
+    bool IsObject() const { return GetValueType() == JSON_OBJECT; }
+
+    /// Return boolean value.
+    bool GetBool(bool defaultValue = false) const;
+    /// Return integer value.
+    int GetInt(int defaultValue = 0) const { return static_cast<int>(GetDouble(defaultValue)); }
+    /// Return unsigned integer value.
+    unsigned GetUInt(unsigned defaultValue = 0) const { return static_cast<unsigned>(GetDouble(defaultValue)); }
+    /// Return float value.
+    float GetFloat(float defaultValue = 0.0f) const { return static_cast<float>(GetDouble(defaultValue)); }
+    /// Return double value.
+    double GetDouble(double defaultValue = 0.0) const;
+    /// Return string value. The string is stored in the document and is null-terminated.
+    ea::string_view GetString(ea::string_view defaultValue = {}) const;
+    /// Return C string value.
+    const char* GetCString(const char* defaultValue = "") const;
+
+    /// Return number of elements of array or object.
+    unsigned Size() const;
+    /// Return array element or object member value by index. Object members are sorted by key hash.
+    JSONDocumentValue operator[](unsigned index) const { return Get(index); }
+    /// Return array element or object member value by index.
+    JSONDocumentValue Get(unsigned index) const;
+    /// Return key of object member by index.
+    ea::string_view GetKey(unsigned index) const;
+    /// Return object member value by key. Return null value if not found.
+    JSONDocumentValue Get(ea::string_view key) const;
+    /// Return whether the object contains the key.
+    bool Contains(ea::string_view key) const { return Get(key).IsValid(); }
+
+    /// Convert to JSONValue.
+    void ToJSONValue(JSONValue& dest) const;
+    /// Convert to JSONValue.
+    JSONValue ToJSONValue() const;
+
+private:
+    /// Document.
+    const JSONDocument* document_{};
+    /// Node index.
+    unsigned index_{};
+};
+
+/// Compact read-only JSON DOM. The source text is parsed in-situ: strings and keys reference the source buffer.
+/// All values are stored in one flat array, elements of each array or object are contiguous,
+/// and object members are sorted by key hash for binary search.
+class URHO3D_API JSONDocument
+{
+    friend class JSONDocumentValue;
+
+public:
+    /// Value node.
+    struct Node
+    {
+        /// Value type.
+        unsigned char type_{};
+        /// Number type.
+        unsigned char numberType_{};
+        /// Number value, or 0 and 1 for boolean value.
+        double numberValue_{};
+        /// String offset in the buffer, or index of the first element for array or object.
+        unsigned offset_{};
+        /// String length, or number of elements for array or object.
+        unsigned length_{};
+        /// Key hash, if the node is object member.
+        StringHash keyHash_;
+        /// Key offset in the buffer.
+        unsigned keyOffset_{};
+        /// Key length.
+        unsigned keyLength_{};
+    };
+
+    /// Parse JSON text. Previous contents are discarded.
+    bool Parse(ea::string source);
+    /// Read and parse JSON text from stream.
+    bool Load(Deserializer& source);
+    /// Clear the document.
+    void Clear();
+
+    /// Return root value. Null value if the document is empty.
+    JSONDocumentValue GetRoot() const { return nodes_.empty() ? JSONDocumentValue{} : JSONDocumentValue{ this, rootIndex_ }; }
+    /// Return number of values stored.
+    unsigned GetNumValues() const { return nodes_.size(); }
+    /// Return approximate memory use in bytes.
+    unsigned GetMemoryUse() const { return buffer_.capacity() + nodes_.capacity() * sizeof(Node); }
+
+private:
+    /// Return string stored at offset in the buffer.
+    ea::string_view GetString(unsigned offset, unsigned length) const { return { buffer_.data() + offset, length }; }
+
+    /// Source text, modified by in-situ parsing.
+    ea::string buffer_;
+    /// Value nodes.
+    ea::vector<Node> nodes_;
+    /// Root node index.
+    unsigned rootIndex_{};
+};
+
+}
@@ -124,8 +124,9 @@ bool JSONFile::BeginLoad(Deserializer& source)
         return false;
     buffer[dataSize] = '\0';
 
+    // Parse in-situ: the buffer outlives the document, so strings don't need to be copied
     rapidjson::Document document;
-    if (document.Parse<kParseCommentsFlag | kParseTrailingCommasFlag>(buffer.get()).HasParseError())
+    if (document.ParseInsitu<kParseCommentsFlag | kParseTrailingCommasFlag>(buffer.get()).HasParseError())
     {
         URHO3D_LOGERROR("Could not parse JSON data from " + source.GetName());
         return false;
@@ -24,6 +24,8 @@
 
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
+#include "../Core/FrameStatistics.h"
+#include "../Core/MemoryTracker.h"
 #include "../Core/Profiler.h"
 #include "../Core/WorkQueue.h"
 #include "../IO/FileSystem.h"
@@ -40,6 +42,8 @@
 #include "../Resource/ResourceEvents.h"
 #include "../Resource/XMLFile.h"
 
+#include <EASTL/sort.h>
+
 #include "../DebugNew.h"
 
 #include <cstdio>
@@ -69,13 +73,27 @@ static const char* checkDirs[] =
 
 static const SharedPtr<Resource> noResource;
 
+/// Interval of periodic memory budget enforcement in milliseconds.
+static const unsigned MEMORY_BUDGET_UPDATE_INTERVAL_MS = 1000;
+
+/// Return key of a file name in the merged package index. Package lookups are case-insensitive on Windows.
+static StringHash GetPackageIndexKey(const ea::string& name)
+{
+#ifdef _WIN32
+    return StringHash(name.to_lower());
+#else
+    return StringHash(name);
+#endif
+}
+
 ResourceCache::ResourceCache(Context* context) :
     Object(context),
     autoReloadResources_(false),
     returnFailedResources_(false),
     searchPackagesFirst_(true),
     isRouting_(false),
-    finishBackgroundResourcesMs_(5)
+    finishBackgroundResourcesMs_(5),
+    autoReloadResourcesMs_(10)
 {
     // Register Resource library object factories
     RegisterResourceLibrary(context_);
@@ -146,10 +164,22 @@ bool ResourceCache::AddPackageFile(PackageFile* package, unsigned priority)
         return false;
     }
 
-    if (priority < packages_.size())
+    // Packages added first or last only need their own entries indexed
+    if (priority == 0 || packages_.empty())
+    {
+        packages_.insert_at(0, SharedPtr<PackageFile>(package));
+        AddToPackageIndex(package, true);
+    }
+    else if (priority < packages_.size())
+    {
         packages_.insert_at(priority, SharedPtr<PackageFile>(package));
+        RebuildPackageIndex();
+    }
     else
+    {
         packages_.push_back(SharedPtr<PackageFile>(package));
+        AddToPackageIndex(package, false);
+    }
 
     URHO3D_LOGINFO("Added resource package " + package->GetName());
     return true;
@@ -220,6 +250,7 @@ void ResourceCache::RemovePackageFile(PackageFile* package, bool releaseResource
                 ReleasePackageResources(i->Get(), forceRelease);
             URHO3D_LOGINFO("Removed resource package " + (*i)->GetName());
             packages_.erase(i);
+            RebuildPackageIndex();
             return;
         }
     }
@@ -240,6 +271,7 @@ void ResourceCache::RemovePackageFile(const ea::string& fileName, bool releaseRe
                 ReleasePackageResources(i->Get(), forceRelease);
             URHO3D_LOGINFO("Removed resource package " + (*i)->GetName());
             packages_.erase(i);
+            RebuildPackageIndex();
             return;
         }
     }
@@ -444,6 +476,94 @@ void ResourceCache::ReloadResourceWithDependencies(const ea::string& fileName)
     }
 }
 
+void ResourceCache::ProcessFileChanges()
+{
+    // Gather the changes of all watchers first, so that a burst of changes is reloaded as one batch
+    ea::vector<FileChange> changes;
+    for (FileWatcher* watcher : fileWatchers_)
+    {
+        changes.clear();
+        watcher->GetNextChanges(changes);
+        for (FileChange& change : changes)
+        {
+            auto it = ignoreResourceAutoReload_.find(change.fileName_);
+            if (it != ignoreResourceAutoReload_.end())
+            {
+                ignoreResourceAutoReload_.erase(it);
+                continue;
+            }
+
+            ea::string fullName = watcher->GetPath() + change.fileName_;
+            if (pendingFileChangeNames_.insert(StringHash(fullName)).second)
+                pendingFileChanges_.emplace_back(ea::move(change.fileName_), ea::move(fullName));
+        }
+    }
+
+    if (pendingFileChanges_.empty())
+        return;
+
+    URHO3D_PROFILE("ReloadChangedResources");
+
+    // Reload the changed resources themselves first and their dependents only after that, so that dependents see
+    // the new versions of all resources changed in this batch and are reloaded once even if several of them changed
+    ea::vector<ea::pair<ea::string, ea::string> > processed;
+    ea::vector<SharedPtr<Resource> > dependents;
+    ea::hash_set<Resource*> queuedDependents;
+    HiresTimer timer;
+    while (!pendingFileChanges_.empty() && (processed.empty() || timer.GetUSec(false) < autoReloadResourcesMs_ * 1000LL))
+    {
+        processed.push_back(ea::move(pendingFileChanges_.front()));
+        pendingFileChanges_.pop_front();
+
+        const ea::string& fileName = processed.back().first;
+        pendingFileChangeNames_.erase(StringHash(processed.back().second));
+
+        StringHash fileNameHash(fileName);
+        // Copy the pointer, reloading may modify the resource groups
+        SharedPtr<Resource> resource = FindResource(fileNameHash);
+        if (resource)
+        {
+            URHO3D_LOGDEBUG("Reloading changed resource " + fileName);
+            ReloadResource(resource.Get());
+        }
+
+        // Always perform dependency resource check for resource loaded from XML file as it could be used in inheritance
+        if (!resource || GetExtension(resource->GetName()) == ".xml")
+        {
+            auto j = dependentResources_.find(fileNameHash);
+            if (j != dependentResources_.end())
+            {
+                for (auto k = j->second.begin(); k != j->second.end(); ++k)
+                {
+                    const SharedPtr<Resource>& dependent = FindResource(*k);
+                    if (dependent && queuedDependents.insert(dependent.Get()).second)
+                        dependents.push_back(dependent);
+                }
+            }
+        }
+    }
+
+    for (const SharedPtr<Resource>& dependent : dependents)
+    {
+        URHO3D_LOGDEBUG("Reloading resource " + dependent->GetName() + " depending on changed files");
+        ReloadResource(dependent.Get());
+    }
+
+    if (!pendingFileChanges_.empty())
+        URHO3D_LOGDEBUG("Deferred reloading of {} changed files to the next frame", pendingFileChanges_.size());
+
+    // Finally send a general file changed event even if the file was not a tracked resource
+    for (const auto& change : processed)
+    {
+        using namespace FileChanged;
+
+        VariantMap& eventData = GetEventDataMap();
+        eventData[P_FILENAME] = change.second;
+        eventData[P_RESOURCENAME] = change.first;
+        SendEvent(E_FILECHANGED, eventData);
+    }
+}
+
 void ResourceCache::SetMemoryBudget(StringHash type, unsigned long long budget)
 {
     resourceGroups_[type].memoryBudget_ = budget;
@@ -463,7 +583,11 @@ void ResourceCache::SetAutoReloadResources(bool enable)
             }
         }
         else
+        {
             fileWatchers_.clear();
+            pendingFileChanges_.clear();
+            pendingFileChangeNames_.clear();
+        }
 
         autoReloadResources_ = enable;
     }
@@ -546,34 +670,45 @@ SharedPtr<File> ResourceCache::GetFile(const ea::string& name, bool sendEventOnF
 
 Resource* ResourceCache::GetExistingResource(StringHash type, const ea::string& name)
 {
-    ea::string sanitatedName = SanitateResourceName(name);
-
     if (!Thread::IsMainThread())
     {
-        URHO3D_LOGERROR("Attempted to get resource " + sanitatedName + " from outside the main thread");
+        URHO3D_LOGERROR("Attempted to get resource " + name + " from outside the main thread");
         return nullptr;
     }
 
+    // Most names are already sanitated, try them as is to skip sanitation
+    const auto findResource = [&](StringHash nameHash) -> const SharedPtr<Resource>&
+    {
+        return type != StringHash::ZERO ? FindResource(type, nameHash) : FindResource(nameHash);
+    };
+    if (const SharedPtr<Resource>& existing = findResource(StringHash(name)))
+        return existing;
+
+    ea::string sanitatedName = SanitateResourceName(name);
+
     // If empty name, return null pointer immediately
-    if (sanitatedName.empty())
+    if (sanitatedName.empty() || sanitatedName == name)
         return nullptr;
 
-    StringHash nameHash(sanitatedName);
-
-    const SharedPtr<Resource>& existing = type == StringHash::ZERO ? FindResource(type, nameHash) : FindResource(nameHash);
-    return existing;
+    return findResource(StringHash(sanitatedName));
 }
 
 Resource* ResourceCache::GetResource(StringHash type, const ea::string& name, bool sendEventOnFailure)
 {
-    ea::string sanitatedName = SanitateResourceName(name);
+    MemoryTagScope memoryTag(MEMORY_TAG_RESOURCE);
 
     if (!Thread::IsMainThread())
     {
-        URHO3D_LOGERROR("Attempted to get resource " + sanitatedName + " from outside the main thread");
+        URHO3D_LOGERROR("Attempted to get resource " + name + " from outside the main thread");
         return nullptr;
     }
 
+    // Most names are already sanitated, try them as is to skip sanitation. Resources in the cache are finished loading
+    if (const SharedPtr<Resource>& existing = FindResource(type, StringHash(name)))
+        return existing;
+
+    ea::string sanitatedName = SanitateResourceName(name);
+
     // If empty name, return null pointer immediately
     if (sanitatedName.empty())
         return nullptr;
@@ -632,6 +767,11 @@ Resource* ResourceCache::GetResource(StringHash type, const ea::string& name, bo
         if (!returnFailedResources_)
             return nullptr;
     }
+    else if (auto* statistics = GetSubsystem<FrameStatistics>())
+    {
+        statistics->IncrementCounter(FC_RESOURCE_LOADS);
+        statistics->AddMarker(FM_RESOURCE_LOAD, sanitatedName);
+    }
 
     // Store to cache
     resource->ResetUseTimer();
@@ -663,6 +803,8 @@ bool ResourceCache::BackgroundLoadResource(StringHash type, const ea::string& na
 
 SharedPtr<Resource> ResourceCache::GetTempResource(StringHash type, const ea::string& name, bool sendEventOnFailure)
 {
+    MemoryTagScope memoryTag(MEMORY_TAG_RESOURCE);
+
     ea::string sanitatedName = SanitateResourceName(name);
 
     // If empty name, return null pointer immediately
@@ -712,6 +854,12 @@ SharedPtr<Resource> ResourceCache::GetTempResource(StringHash type, const ea::st
         return SharedPtr<Resource>();
     }
 
+    if (auto* statistics = GetSubsystem<FrameStatistics>())
+    {
+        statistics->IncrementCounter(FC_RESOURCE_LOADS);
+        statistics->AddMarker(FM_RESOURCE_LOAD, sanitatedName);
+    }
+
     return resource;
 }
 
@@ -724,6 +872,22 @@ unsigned ResourceCache::GetNumBackgroundLoadResources() const
 #endif
 }
 
+void ResourceCache::SetNumBackgroundLoadThreads(unsigned numThreads)
+{
+#ifdef URHO3D_THREADING
+    backgroundLoader_->SetNumThreads(numThreads);
+#endif
+}
+
+unsigned ResourceCache::GetNumBackgroundLoadThreads() const
+{
+#ifdef URHO3D_THREADING
+    return backgroundLoader_->GetNumThreads();
+#else
+    return 0;
+#endif
+}
+
 void ResourceCache::GetResources(ea::vector<Resource*>& result, StringHash type) const
 {
     result.clear();
@@ -746,11 +910,8 @@ bool ResourceCache::Exists(const ea::string& name) const
     if (sanitatedName.empty())
         return false;
 
-    for (unsigned i = 0; i < packages_.size(); ++i)
-    {
-        if (packages_[i]->Exists(sanitatedName))
-            return true;
-    }
+    if (FindPackage(sanitatedName))
+        return true;
 
     auto* fileSystem = GetSubsystem<FileSystem>();
     for (unsigned i = 0; i < resourceDirs_.size(); ++i)
@@ -1046,63 +1207,82 @@ void ResourceCache::UpdateResourceGroup(StringHash type)
     if (i == resourceGroups_.end())
         return;
 
-    for (;;)
+    ResourceGroup& group = i->second;
+
+    // Recalculate memory use and collect resources that can be released
+    // (resources in use always return a zero timer and can not be removed)
+    unsigned long long totalSize = 0;
+    ea::vector<ea::pair<unsigned, StringHash>> unusedResources;
+    for (auto j = group.resources_.begin(); j != group.resources_.end(); ++j)
     {
-        unsigned totalSize = 0;
-        unsigned oldestTimer = 0;
-        auto oldestResource = i->second.resources_.end();
+        totalSize += j->second->GetMemoryUse();
+        const unsigned useTimer = j->second->GetUseTimer();
+        if (useTimer > 0)
+            unusedResources.emplace_back(useTimer, j->first);
+    }
 
-        for (auto j = i->second.resources_.begin();
-             j != i->second.resources_.end(); ++j)
-        {
-            totalSize += j->second->GetMemoryUse();
-            unsigned useTimer = j->second->GetUseTimer();
-            if (useTimer > oldestTimer)
-            {
-                oldestTimer = useTimer;
-                oldestResource = j;
-            }
-        }
+    group.memoryUse_ = totalSize;
+    if (!group.memoryBudget_ || group.memoryUse_ <= group.memoryBudget_)
+        return;
 
-        i->second.memoryUse_ = totalSize;
+    // If memory budget is exceeded, remove least recently used resources first
+    const auto compareUseTimers = [](const ea::pair<unsigned, StringHash>& lhs, const ea::pair<unsigned, StringHash>& rhs)
+    {
+        return lhs.first > rhs.first;
+    };
+    ea::sort(unusedResources.begin(), unusedResources.end(), compareUseTimers);
 
-        // If memory budget defined and is exceeded, remove the oldest resource and loop again
-        // (resources in use always return a zero timer and can not be removed)
-        if (i->second.memoryBudget_ && i->second.memoryUse_ > i->second.memoryBudget_ &&
-            oldestResource != i->second.resources_.end())
-        {
-            URHO3D_LOGDEBUG("Resource group " + oldestResource->second->GetTypeName() + " over memory budget, releasing resource " +
-                     oldestResource->second->GetName());
-            i->second.resources_.erase(oldestResource);
-        }
-        else
+    for (const auto& unusedResource : unusedResources)
+    {
+        if (group.memoryUse_ <= group.memoryBudget_)
             break;
+
+        auto j = group.resources_.find(unusedResource.second);
+        Resource* resource = j->second;
+        URHO3D_LOGDEBUG("Resource group " + resource->GetTypeName() + " over memory budget, releasing resource " +
+                 resource->GetName());
+
+        group.memoryUse_ -= resource->GetMemoryUse();
+        evictedResources_.emplace_back(type, resource->GetName());
+        group.resources_.erase(j);
     }
 }
 
 void ResourceCache::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
 {
-    for (unsigned i = 0; i < fileWatchers_.size(); ++i)
+    ProcessFileChanges();
+
+    // Resources age while they stay unused, so enforce memory budgets periodically too
+    if (memoryBudgetTimer_.GetMSec(false) >= MEMORY_BUDGET_UPDATE_INTERVAL_MS)
     {
-        FileChange change;
-        while (fileWatchers_[i]->GetNextChange(change))
+        URHO3D_PROFILE("UpdateResourceMemoryBudgets");
+        memoryBudgetTimer_.Reset();
+
+        ea::vector<StringHash> budgetedTypes;
+        for (auto i = resourceGroups_.begin(); i != resourceGroups_.end(); ++i)
         {
-            auto it = ignoreResourceAutoReload_.find(change.fileName_);
-            if (it != ignoreResourceAutoReload_.end())
-            {
-                ignoreResourceAutoReload_.erase(it);
-                continue;
-            }
+            if (i->second.memoryBudget_)
+                budgetedTypes.push_back(i->first);
+        }
+        for (StringHash type : budgetedTypes)
+            UpdateResourceGroup(type);
 
-            ReloadResourceWithDependencies(change.fileName_);
+        URHO3D_PROFILE_VALUE("ResourceMemoryUse", static_cast<int64_t>(GetTotalMemoryUse()));
+    }
 
-            // Finally send a general file changed event even if the file was not a tracked resource
-            using namespace FileChanged;
+    // Notify about resources released due to memory budget
+    if (!evictedResources_.empty())
+    {
+        const auto evictedResources = ea::move(evictedResources_);
+        evictedResources_.clear();
+        for (const auto& evictedResource : evictedResources)
+        {
+            using namespace ResourceEvicted;
 
             VariantMap& eventData = GetEventDataMap();
-            eventData[P_FILENAME] = fileWatchers_[i]->GetPath() + change.fileName_;
-            eventData[P_RESOURCENAME] = change.fileName_;
-            SendEvent(E_FILECHANGED, eventData);
+            eventData[P_RESOURCETYPE] = evictedResource.first;
+            eventData[P_RESOURCENAME] = evictedResource.second;
+            SendEvent(E_RESOURCEEVICTED, eventData);
         }
     }
 
@@ -1139,15 +1319,51 @@ File* ResourceCache::SearchResourceDirs(const ea::string& name)
 
 File* ResourceCache::SearchPackages(const ea::string& name)
 {
-    for (unsigned i = 0; i < packages_.size(); ++i)
+    if (PackageFile* package = FindPackage(name))
+        return new File(context_, package, name);
+
+    return nullptr;
+}
+
+PackageFile* ResourceCache::FindPackage(const ea::string& name) const
+{
+    auto i = packageIndex_.find(GetPackageIndexKey(name));
+    if (i == packageIndex_.end())
+        return nullptr;
+    if (i->second->Exists(name))
+        return i->second;
+
+    // Name hash collides with an entry of another name. Fall back to searching the packages in priority order
+    for (const SharedPtr<PackageFile>& package : packages_)
     {
-        if (packages_[i]->Exists(name))
-            return new File(context_, packages_[i], name);
+        if (package->Exists(name))
+            return package;
     }
 
     return nullptr;
 }
 
+void ResourceCache::AddToPackageIndex(PackageFile* package, bool overwrite)
+{
+    const ea::unordered_map<ea::string, PackageEntry>& entries = package->GetEntries();
+    packageIndex_.reserve(packageIndex_.size() + entries.size());
+    for (const auto& entry : entries)
+    {
+        const StringHash key = GetPackageIndexKey(entry.first);
+        if (overwrite)
+            packageIndex_[key] = package;
+        else
+            packageIndex_.emplace(key, package);
+    }
+}
+
+void ResourceCache::RebuildPackageIndex()
+{
+    packageIndex_.clear();
+    for (const SharedPtr<PackageFile>& package : packages_)
+        AddToPackageIndex(package, false);
+}
+
 void RegisterResourceLibrary(Context* context)
 {
     BinaryFile::RegisterObject(context);
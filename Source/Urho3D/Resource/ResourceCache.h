@@ -26,9 +26,11 @@
 
 #include <EASTL/unique_ptr.h>
 #include <EASTL/hash_set.h>
+#include <EASTL/deque.h>
 
 #include "../Container/Ptr.h"
 #include "../Core/Mutex.h"
+#include "../Core/Timer.h"
 #include "../IO/File.h"
 #include "../Resource/Resource.h"
 
@@ -134,6 +136,10 @@ public:
 
     /// Set how many milliseconds maximum per frame to spend on finishing background loaded resources.
     void SetFinishBackgroundResourcesMs(int ms) { finishBackgroundResourcesMs_ = Max(ms, 1); }
+    /// Set how many milliseconds maximum per frame to spend on automatically reloading changed resources. Remaining changes are deferred to the next frames.
+    void SetAutoReloadResourcesMs(int ms) { autoReloadResourcesMs_ = Max(ms, 1); }
+    /// Set number of threads used for background loading of resources. Resources must be safe to BeginLoad() concurrently to use more than one. Default 1.
+    void SetNumBackgroundLoadThreads(unsigned numThreads);
 
     /// Add a resource router object. By default there is none, so the routing process is skipped.
     void AddResourceRouter(ResourceRouter* router, bool addAsFirst = false);
@@ -198,6 +204,12 @@ public:
 
     /// Return how many milliseconds maximum to spend on finishing background loaded resources.
     int GetFinishBackgroundResourcesMs() const { return finishBackgroundResourcesMs_; }
+    /// Return how many milliseconds maximum per frame to spend on automatically reloading changed resources.
+    int GetAutoReloadResourcesMs() const { return autoReloadResourcesMs_; }
+    /// Return number of file changes waiting to be reloaded.
+    unsigned GetNumPendingFileChanges() const { return pendingFileChanges_.size(); }
+    /// Return number of threads used for background loading of resources.
+    unsigned GetNumBackgroundLoadThreads() const;
 
     /// Return a resource router by index.
     ResourceRouter* GetResourceRouter(unsigned index) const;
@@ -247,10 +259,18 @@ private:
     void UpdateResourceGroup(StringHash type);
     /// Handle begin frame event. Automatic resource reloads and the finalization of background loaded resources are processed here.
     void HandleBeginFrame(StringHash eventType, VariantMap& eventData);
+    /// Gather file changes from the file watchers and reload changed resources and their dependents within the time budget.
+    void ProcessFileChanges();
     /// Search FileSystem for file.
     File* SearchResourceDirs(const ea::string& name);
     /// Search resource packages for file.
     File* SearchPackages(const ea::string& name);
+    /// Return the highest priority package containing the file, or null if not found. Uses the merged package index.
+    PackageFile* FindPackage(const ea::string& name) const;
+    /// Add package entries to the merged package index. When overwrite is true, the package takes precedence over already indexed ones.
+    void AddToPackageIndex(PackageFile* package, bool overwrite);
+    /// Rebuild the merged package index from all packages.
+    void RebuildPackageIndex();
 
     /// Mutex for thread-safe access to the resource directories, resource packages and resource dependencies.
     mutable Mutex resourceMutex_;
@@ -262,6 +282,8 @@ private:
     ea::vector<SharedPtr<FileWatcher> > fileWatchers_;
     /// Package files.
     ea::vector<SharedPtr<PackageFile> > packages_;
+    /// Merged index of package entries, mapping entry name hash to the highest priority package containing it.
+    ea::unordered_map<StringHash, PackageFile*> packageIndex_;
     /// Dependent resources. Only used with automatic reload to eg. trigger reload of a cube texture when any of its faces change.
     ea::unordered_map<StringHash, ea::hash_set<StringHash> > dependentResources_;
     /// Resource background loader.
@@ -278,8 +300,18 @@ private:
     mutable bool isRouting_;
     /// How many milliseconds maximum per frame to spend on finishing background loaded resources.
     int finishBackgroundResourcesMs_;
+    /// How many milliseconds maximum per frame to spend on automatically reloading changed resources.
+    int autoReloadResourcesMs_;
+    /// File changes waiting to be reloaded, resource name and full file name.
+    ea::deque<ea::pair<ea::string, ea::string> > pendingFileChanges_;
+    /// Hashes of full file names in the pending file changes, to not queue the same change twice.
+    ea::hash_set<StringHash> pendingFileChangeNames_;
     /// List of resources that will not be auto-reloaded if reloading event triggers.
     ea::vector<ea::string> ignoreResourceAutoReload_;
+    /// Timer for periodic memory budget enforcement.
+    Timer memoryBudgetTimer_;
+    /// Resources released due to memory budget since the last frame, type and name.
+    ea::vector<ea::pair<StringHash, ea::string>> evictedResources_;
 };
 
 template <class T> T* ResourceCache::GetExistingResource(const ea::string& name)
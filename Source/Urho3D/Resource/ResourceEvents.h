@@ -73,6 +73,20 @@ URHO3D_EVENT(E_RESOURCEBACKGROUNDLOADED, ResourceBackgroundLoaded)
     URHO3D_PARAM(P_RESOURCENAME, ResourceName);            // String
     URHO3D_PARAM(P_SUCCESS, Success);                      // bool
     URHO3D_PARAM(P_RESOURCE, Resource);                    // Resource pointer
+    URHO3D_PARAM(P_FILESIZE, FileSize);                    // unsigned
+    URHO3D_PARAM(P_QUEUETIME, QueueTime);                  // long long, HiresTimer timestamp in microseconds
+    URHO3D_PARAM(P_OPENTIME, OpenTime);                    // long long, start of the file open
+    URHO3D_PARAM(P_BEGINLOADTIME, BeginLoadTime);          // long long, start of BeginLoad()
+    URHO3D_PARAM(P_BEGINLOADENDTIME, BeginLoadEndTime);    // long long, end of BeginLoad()
+    URHO3D_PARAM(P_ENDLOADTIME, EndLoadTime);              // long long, start of EndLoad()
+    URHO3D_PARAM(P_FINISHTIME, FinishTime);                // long long, end of EndLoad()
+}
+
+/// Resource released from the cache because its type was over the memory budget. Sent on the next frame begin.
+URHO3D_EVENT(E_RESOURCEEVICTED, ResourceEvicted)
+{
+    URHO3D_PARAM(P_RESOURCETYPE, ResourceType);            // StringHash
+    URHO3D_PARAM(P_RESOURCENAME, ResourceName);            // String
 }
 
 /// Language changed.
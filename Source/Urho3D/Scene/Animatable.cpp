@@ -58,7 +58,6 @@ void AttributeAnimationInfo::ApplyValue(const Variant& newValue)
     if (animatable)
     {
         animatable->OnSetAttribute(attributeInfo_, newValue);
-        animatable->ApplyAttributes();
     }
 }
 
@@ -366,11 +365,12 @@ void Animatable::SetAnimationTime(float time)
                 target->SetAttributeAnimationTime(outName, time);
         }
     }
-    else
+    else if (!attributeAnimationInfos_.empty())
     {
         for (auto i = attributeAnimationInfos_.begin();
             i != attributeAnimationInfos_.end(); ++i)
             i->second->SetTime(time);
+        ApplyAttributes();
     }
 }
 
@@ -486,7 +486,10 @@ void Animatable::SetAttributeAnimationTime(const ea::string& name, float time)
 {
     AttributeAnimationInfo* info = GetAttributeAnimationInfo(name);
     if (info)
+    {
         info->SetTime(time);
+        ApplyAttributes();
+    }
 }
 
 void Animatable::RemoveObjectAnimation()
@@ -606,6 +609,10 @@ void Animatable::UpdateAttributeAnimations(float timeStep)
             finishedNames.push_back(i->second->GetAttributeInfo().name_);
     }
 
+    // Apply once for all animated attributes
+    if (!attributeAnimationInfos_.empty())
+        ApplyAttributes();
+
     for (unsigned i = 0; i < finishedNames.size(); ++i)
         SetAttributeAnimation(finishedNames[i], nullptr);
 }
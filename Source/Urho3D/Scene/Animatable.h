@@ -53,7 +53,8 @@ public:
     const AttributeInfo& GetAttributeInfo() const { return attributeInfo_; }
 
 protected:
-    /// Apply new animation value to the target object. Called by Update().
+    /// Apply new animation value to the target object. Called by Update(). ApplyAttributes() is called by the owner
+    /// once all animations of the object are updated.
     void ApplyValue(const Variant& newValue) override;
 
 private:
@@ -65,6 +66,7 @@ private:
 class URHO3D_API Animatable : public Serializable
 {
     URHO3D_OBJECT(Animatable, Serializable);
+    friend class Scene;
 
 public:
     /// Construct.
@@ -160,6 +162,8 @@ protected:
     ea::hash_set<const AttributeInfo*> animatedNetworkAttributes_;
     /// Attribute animation infos.
     ea::unordered_map<ea::string, SharedPtr<AttributeAnimationInfo> > attributeAnimationInfos_;
+    /// Index in the scene list of animated objects. Maintained by the scene.
+    unsigned attributeAnimationTargetIndex_{M_MAX_UNSIGNED};
 };
 
 }
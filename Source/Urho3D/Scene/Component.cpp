@@ -177,6 +177,7 @@ void Component::PrepareNetworkUpdate()
     unsigned numAttributes = attributes->size();
 
     // Check for attribute changes
+    DirtyBits changedAttributes;
     for (unsigned i = 0; i < numAttributes; ++i)
     {
         const AttributeInfo& attr = attributes->at(i);
@@ -184,11 +185,9 @@ void Component::PrepareNetworkUpdate()
         if (animationEnabled_ && IsAnimatedNetworkAttribute(attr))
             continue;
 
-        OnGetAttribute(attr, networkState_->currentValues_[i]);
-
-        if (networkState_->currentValues_[i] != networkState_->previousValues_[i])
+        if (UpdateNetworkAttribute(i))
         {
-            networkState_->previousValues_[i] = networkState_->currentValues_[i];
+            changedAttributes.Set(i);
 
             // Mark the attribute dirty in all replication states that are tracking this component
             for (auto j = networkState_->replicationStates_.begin();
@@ -208,6 +207,8 @@ void Component::PrepareNetworkUpdate()
         }
     }
 
+    PrepareSharedNetworkUpdates(changedAttributes);
+
     networkUpdate_ = false;
 }
 
@@ -225,14 +226,16 @@ void Component::CleanupConnection(Connection* connection)
 
 void Component::OnAttributeAnimationAdded()
 {
-    if (attributeAnimationInfos_.size() == 1)
-        SubscribeToEvent(GetScene(), E_ATTRIBUTEANIMATIONUPDATE, URHO3D_HANDLER(Component, HandleAttributeAnimationUpdate));
+    Scene* scene = GetScene();
+    if (attributeAnimationInfos_.size() == 1 && scene)
+        scene->AddAttributeAnimationTarget(this);
 }
 
 void Component::OnAttributeAnimationRemoved()
 {
-    if (attributeAnimationInfos_.empty())
-        UnsubscribeFromEvent(GetScene(), E_ATTRIBUTEANIMATIONUPDATE);
+    Scene* scene = GetScene();
+    if (attributeAnimationInfos_.empty() && scene)
+        scene->RemoveAttributeAnimationTarget(this);
 }
 
 void Component::OnNodeSet(Node* node)
@@ -280,13 +283,6 @@ void Component::GetComponents(ea::vector<Component*>& dest, StringHash type) con
         dest.clear();
 }
 
-void Component::HandleAttributeAnimationUpdate(StringHash eventType, VariantMap& eventData)
-{
-    using namespace AttributeAnimationUpdate;
-
-    UpdateAttributeAnimations(eventData[P_TIMESTEP].GetFloat());
-}
-
 Component* Component::GetFixedUpdateSource()
 {
     Component* ret = nullptr;
@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include "../Container/SlabAllocator.h"
 #include "../Scene/Animatable.h"
 
 namespace Urho3D
@@ -50,8 +51,12 @@ class URHO3D_API Component : public Animatable
 
     friend class Node;
     friend class Scene;
+    friend class SceneComponentIndex;
 
 public:
+    /// Components and their subclasses are allocated from slabs, as they are created and destroyed at a high rate.
+    URHO3D_SLAB_ALLOCATED
+
     /// Construct.
     explicit Component(Context* context);
     /// Destruct.
@@ -127,8 +132,6 @@ protected:
     void SetID(unsigned id);
     /// Set scene node. Called by Node when creating the component.
     void SetNode(Node* node);
-    /// Handle scene attribute animation update event.
-    void HandleAttributeAnimationUpdate(StringHash eventType, VariantMap& eventData);
     /// Return a component from the scene root that sends out fixed update events (either PhysicsWorld or PhysicsWorld2D). Return null if neither exists.
     Component* GetFixedUpdateSource();
     /// Perform autoremove. Called by subclasses. Caller should keep a weak pointer to itself to check whether was actually removed, and return immediately without further member operations in that case.
@@ -142,6 +145,12 @@ protected:
     bool networkUpdate_;
     /// Enabled flag.
     bool enabled_;
+    /// Position in the scene component index of its type.
+    unsigned indexPosition_{ M_MAX_UNSIGNED };
+    /// Change journal flags in the scene component index of its type.
+    unsigned char indexJournalFlags_{};
+    /// Position in the added or modified list of the change journal.
+    unsigned indexJournalPosition_{};
 };
 
 template <class T> T* Component::GetComponent() const { return static_cast<T*>(GetComponent(T::GetTypeStatic())); }
@@ -23,16 +23,16 @@
 #include "../Precompiled.h"
 
 #include "../IO/Log.h"
-#if defined(URHO3D_PHYSICS) || defined(URHO3D_URHO2D)
-#include "../Physics/PhysicsEvents.h"
-#endif
 #include "../Scene/LogicComponent.h"
+#include "../Scene/LogicComponentScheduler.h"
 #include "../Scene/Scene.h"
 #include "../Scene/SceneEvents.h"
 
 namespace Urho3D
 {
 
+URHO3D_SLAB_ALLOCATED_SEPARATELY_IMPL(LogicComponent)
+
 LogicComponent::LogicComponent(Context* context) :
     Component(context),
     updateEventMask_(USE_UPDATE | USE_POSTUPDATE | USE_FIXEDUPDATE | USE_FIXEDPOSTUPDATE),
@@ -87,20 +87,23 @@ void LogicComponent::OnNodeSet(Node* node)
     }
 }
 
+void LogicComponent::SetThreadSafeUpdate(bool enable)
+{
+    if (threadSafeUpdate_ != enable)
+    {
+        // The component moves to another batch of the scheduler
+        RemoveFromScheduler();
+        threadSafeUpdate_ = enable;
+        UpdateEventSubscription();
+    }
+}
+
 void LogicComponent::OnSceneSet(Scene* scene)
 {
     if (scene)
         UpdateEventSubscription();
     else
-    {
-        UnsubscribeFromEvent(E_SCENEUPDATE);
-        UnsubscribeFromEvent(E_SCENEPOSTUPDATE);
-#if defined(URHO3D_PHYSICS) || defined(URHO3D_URHO2D)
-        UnsubscribeFromEvent(E_PHYSICSPRESTEP);
-        UnsubscribeFromEvent(E_PHYSICSPOSTSTEP);
-#endif
-        currentEventMask_ = USE_NO_EVENT;
-    }
+        RemoveFromScheduler();
 }
 
 void LogicComponent::UpdateEventSubscription()
@@ -110,30 +113,13 @@ void LogicComponent::UpdateEventSubscription()
         return;
 
     bool enabled = IsEnabledEffective();
+    updateScene_ = scene;
 
     bool needUpdate = enabled && ((updateEventMask_ & USE_UPDATE) || !delayedStartCalled_);
-    if (needUpdate && !(currentEventMask_ & USE_UPDATE))
-    {
-        SubscribeToEvent(scene, E_SCENEUPDATE, URHO3D_HANDLER(LogicComponent, HandleSceneUpdate));
-        currentEventMask_ |= USE_UPDATE;
-    }
-    else if (!needUpdate && (currentEventMask_ & USE_UPDATE))
-    {
-        UnsubscribeFromEvent(scene, E_SCENEUPDATE);
-        currentEventMask_ &= ~USE_UPDATE;
-    }
+    SetPhaseScheduled(scene, USE_UPDATE, LogicUpdatePhase::Update, needUpdate);
 
     bool needPostUpdate = enabled && (updateEventMask_ & USE_POSTUPDATE);
-    if (needPostUpdate && !(currentEventMask_ & USE_POSTUPDATE))
-    {
-        SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(LogicComponent, HandleScenePostUpdate));
-        currentEventMask_ |= USE_POSTUPDATE;
-    }
-    else if (!needPostUpdate && (currentEventMask_ & USE_POSTUPDATE))
-    {
-        UnsubscribeFromEvent(scene, E_SCENEPOSTUPDATE);
-        currentEventMask_ &= ~USE_POSTUPDATE;
-    }
+    SetPhaseScheduled(scene, USE_POSTUPDATE, LogicUpdatePhase::PostUpdate, needPostUpdate);
 
 #if defined(URHO3D_PHYSICS) || defined(URHO3D_URHO2D)
     Component* world = GetFixedUpdateSource();
@@ -141,87 +127,38 @@ void LogicComponent::UpdateEventSubscription()
         return;
 
     bool needFixedUpdate = enabled && (updateEventMask_ & USE_FIXEDUPDATE);
-    if (needFixedUpdate && !(currentEventMask_ & USE_FIXEDUPDATE))
-    {
-        SubscribeToEvent(world, E_PHYSICSPRESTEP, URHO3D_HANDLER(LogicComponent, HandlePhysicsPreStep));
-        currentEventMask_ |= USE_FIXEDUPDATE;
-    }
-    else if (!needFixedUpdate && (currentEventMask_ & USE_FIXEDUPDATE))
-    {
-        UnsubscribeFromEvent(world, E_PHYSICSPRESTEP);
-        currentEventMask_ &= ~USE_FIXEDUPDATE;
-    }
+    SetPhaseScheduled(scene, USE_FIXEDUPDATE, LogicUpdatePhase::FixedUpdate, needFixedUpdate, world);
 
     bool needFixedPostUpdate = enabled && (updateEventMask_ & USE_FIXEDPOSTUPDATE);
-    if (needFixedPostUpdate && !(currentEventMask_ & USE_FIXEDPOSTUPDATE))
-    {
-        SubscribeToEvent(world, E_PHYSICSPOSTSTEP, URHO3D_HANDLER(LogicComponent, HandlePhysicsPostStep));
-        currentEventMask_ |= USE_FIXEDPOSTUPDATE;
-    }
-    else if (!needFixedPostUpdate && (currentEventMask_ & USE_FIXEDPOSTUPDATE))
-    {
-        UnsubscribeFromEvent(world, E_PHYSICSPOSTSTEP);
-        currentEventMask_ &= ~USE_FIXEDPOSTUPDATE;
-    }
+    SetPhaseScheduled(scene, USE_FIXEDPOSTUPDATE, LogicUpdatePhase::FixedPostUpdate, needFixedPostUpdate, world);
 #endif
 }
 
-void LogicComponent::HandleSceneUpdate(StringHash eventType, VariantMap& eventData)
+void LogicComponent::SetPhaseScheduled(Scene* scene, UpdateEvent event, LogicUpdatePhase phase, bool scheduled,
+    Component* fixedUpdateSource)
 {
-    using namespace SceneUpdate;
-
-    // Execute user-defined delayed start function before first update
-    if (!delayedStartCalled_)
+    if (scheduled && !(currentEventMask_ & event))
     {
-        DelayedStart();
-        delayedStartCalled_ = true;
-
-        // If did not need actual update events, unsubscribe now
-        if (!(updateEventMask_ & USE_UPDATE))
-        {
-            UnsubscribeFromEvent(GetScene(), E_SCENEUPDATE);
-            currentEventMask_ &= ~USE_UPDATE;
-            return;
-        }
+        scene->GetLogicComponentScheduler()->Add(this, phase, fixedUpdateSource);
+        currentEventMask_ |= event;
     }
-
-    // Then execute user-defined update function
-    Update(eventData[P_TIMESTEP].GetFloat());
-}
-
-void LogicComponent::HandleScenePostUpdate(StringHash eventType, VariantMap& eventData)
-{
-    using namespace ScenePostUpdate;
-
-    // Execute user-defined post-update function
-    PostUpdate(eventData[P_TIMESTEP].GetFloat());
-}
-
-#if defined(URHO3D_PHYSICS) || defined(URHO3D_URHO2D)
-
-void LogicComponent::HandlePhysicsPreStep(StringHash eventType, VariantMap& eventData)
-{
-    using namespace PhysicsPreStep;
-
-    // Execute user-defined delayed start function before first fixed update if not called yet
-    if (!delayedStartCalled_)
+    else if (!scheduled && (currentEventMask_ & event))
     {
-        DelayedStart();
-        delayedStartCalled_ = true;
+        scene->GetLogicComponentScheduler()->Remove(this, phase);
+        currentEventMask_ &= ~event;
     }
-
-    // Execute user-defined fixed update function
-    FixedUpdate(eventData[P_TIMESTEP].GetFloat());
 }
 
-void LogicComponent::HandlePhysicsPostStep(StringHash eventType, VariantMap& eventData)
+void LogicComponent::RemoveFromScheduler()
 {
-    using namespace PhysicsPostStep;
-
-    // Execute user-defined fixed post-update function
-    FixedPostUpdate(eventData[P_TIMESTEP].GetFloat());
+    if (Scene* updateScene = updateScene_)
+    {
+        LogicComponentScheduler* scheduler = updateScene->GetLogicComponentScheduler();
+        for (unsigned i = 0; i < NUM_LOGIC_UPDATE_PHASES; ++i)
+            scheduler->Remove(this, static_cast<LogicUpdatePhase>(i));
+    }
+    updateScene_.Reset();
+    currentEventMask_ = USE_NO_EVENT;
 }
 
-#endif
-
 }
@@ -45,11 +45,38 @@ enum UpdateEvent : unsigned
 };
 URHO3D_FLAGSET(UpdateEvent, UpdateEventFlags);
 
+/// Phase of logic update.
+enum class LogicUpdatePhase : unsigned
+{
+    Update,
+    PostUpdate,
+    FixedUpdate,
+    FixedPostUpdate,
+    Count
+};
+
+/// Number of logic update phases.
+static const unsigned NUM_LOGIC_UPDATE_PHASES = static_cast<unsigned>(LogicUpdatePhase::Count);
+
+/// Position of logic component in LogicComponentScheduler.
+struct LogicComponentSlot
+{
+    /// Batch index.
+    unsigned batch_{ M_MAX_UNSIGNED };
+    /// Index in the batch.
+    unsigned index_{ M_MAX_UNSIGNED };
+};
+
 /// Helper base class for user-defined game logic components that hooks up to update events and forwards them to virtual functions similar to ScriptInstance class.
 class URHO3D_API LogicComponent : public Component
 {
     URHO3D_OBJECT(LogicComponent, Component);
 
+    friend class LogicComponentScheduler;
+
+    /// Logic components are updated every frame, so they and their subclasses are allocated from a separate arena.
+    URHO3D_SLAB_ALLOCATED_SEPARATELY
+
     /// Construct.
     explicit LogicComponent(Context* context);
     /// Destruct.
@@ -67,9 +94,9 @@ class URHO3D_API LogicComponent : public Component
     /// Called when the component is detached from a scene node, usually on destruction. Note that you will no longer have access to the node and scene at that point.
     virtual void Stop() { }
 
-    /// Called on scene update, variable timestep.
+    /// Called on scene update, variable timestep. Called before the E_SCENEUPDATE event is sent.
     virtual void Update(float timeStep);
-    /// Called on scene post-update, variable timestep.
+    /// Called on scene post-update, variable timestep. Called before the E_SCENEPOSTUPDATE event is sent.
     virtual void PostUpdate(float timeStep);
     /// Called on physics update, fixed timestep.
     virtual void FixedUpdate(float timeStep);
@@ -81,6 +108,14 @@ class URHO3D_API LogicComponent : public Component
 
     /// Return what update events are subscribed to.
     UpdateEventFlags GetUpdateEventMask() const { return updateEventMask_; }
+    /// Set whether Update(), PostUpdate(), FixedUpdate() and FixedPostUpdate() may be called from worker threads in parallel with other components. They must not create or remove nodes and components, or modify shared state, then.
+    void SetThreadSafeUpdate(bool enable);
+    /// Return whether the update functions may be called in parallel.
+    bool IsThreadSafeUpdate() const { return threadSafeUpdate_; }
+    /// Set to call Update() and PostUpdate() once per this number of frames with accumulated time step. Use for level of detail. Default 1.
+    void SetUpdateDivisor(unsigned divisor) { updateDivisor_ = Max(divisor, 1u); }
+    /// Return update divisor.
+    unsigned GetUpdateDivisor() const { return updateDivisor_; }
 
     /// Return whether the DelayedStart() function has been called.
     bool IsDelayedStartCalled() const { return delayedStartCalled_; }
@@ -92,24 +127,30 @@ protected:
     void OnSceneSet(Scene* scene) override;
 
 private:
-    /// Subscribe/unsubscribe to update events based on current enabled state and update event mask.
+    /// Add or remove the component from the scene scheduler based on current enabled state and update event mask.
     void UpdateEventSubscription();
-    /// Handle scene update event.
-    void HandleSceneUpdate(StringHash eventType, VariantMap& eventData);
-    /// Handle scene post-update event.
-    void HandleScenePostUpdate(StringHash eventType, VariantMap& eventData);
-#if defined(URHO3D_PHYSICS) || defined(URHO3D_URHO2D)
-    /// Handle physics pre-step event.
-    void HandlePhysicsPreStep(StringHash eventType, VariantMap& eventData);
-    /// Handle physics post-step event.
-    void HandlePhysicsPostStep(StringHash eventType, VariantMap& eventData);
-#endif
+    /// Add or remove the component from the phase of the scene scheduler.
+    void SetPhaseScheduled(Scene* scene, UpdateEvent event, LogicUpdatePhase phase, bool scheduled, Component* fixedUpdateSource = nullptr);
+    /// Remove the component from all phases of the scene scheduler.
+    void RemoveFromScheduler();
     /// Requested event subscription mask.
     UpdateEventFlags updateEventMask_;
     /// Current event subscription mask.
     UpdateEventFlags currentEventMask_;
+    /// Scene whose update signals are subscribed to.
+    WeakPtr<Scene> updateScene_;
     /// Flag for delayed start.
     bool delayedStartCalled_;
+    /// Whether the update functions may be called in parallel.
+    bool threadSafeUpdate_{};
+    /// Update divisor.
+    unsigned updateDivisor_{ 1 };
+    /// Time step accumulated for skipped updates.
+    float updateTimeAccumulator_{};
+    /// Time step accumulated for skipped post-updates.
+    float postUpdateTimeAccumulator_{};
+    /// Positions in the scene scheduler.
+    LogicComponentSlot schedulerSlots_[NUM_LOGIC_UPDATE_PHASES];
 };
 
 }
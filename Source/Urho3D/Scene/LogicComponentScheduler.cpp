@@ -0,0 +1,281 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
+#if defined(URHO3D_PHYSICS) || defined(URHO3D_URHO2D)
+#include "../Physics/PhysicsEvents.h"
+#endif
+#include "../Scene/LogicComponentScheduler.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Number of thread-safe components updated by one work item chunk.
+const unsigned LOGIC_UPDATE_GRAIN_SIZE = 64;
+
+}
+
+LogicComponentScheduler::LogicComponentScheduler(Context* context) :
+    Object(context)
+{
+}
+
+LogicComponentScheduler::~LogicComponentScheduler() = default;
+
+void LogicComponentScheduler::Add(LogicComponent* component, LogicUpdatePhase phase, Component* fixedUpdateSource)
+{
+    const unsigned phaseIndex = static_cast<unsigned>(phase);
+    LogicComponentSlot& slot = component->schedulerSlots_[phaseIndex];
+    if (slot.batch_ != M_MAX_UNSIGNED)
+        return;
+
+    if (fixedUpdateSource)
+        SetFixedUpdateSource(fixedUpdateSource);
+
+    PhaseState& phaseState = phases_[phaseIndex];
+    const StringHash type = component->GetType();
+    const bool threadSafe = component->IsThreadSafeUpdate();
+    auto iter = ea::find_if(phaseState.batches_.begin(), phaseState.batches_.end(),
+        [&](const Batch& batch) { return batch.type_ == type && batch.threadSafe_ == threadSafe; });
+    if (iter == phaseState.batches_.end())
+    {
+        Batch& batch = phaseState.batches_.push_back();
+        batch.type_ = type;
+        batch.threadSafe_ = threadSafe;
+        iter = phaseState.batches_.end() - 1;
+    }
+
+    // Components added during the update are updated starting from the next one
+    slot.batch_ = static_cast<unsigned>(iter - phaseState.batches_.begin());
+    slot.index_ = iter->components_.size();
+    iter->components_.push_back(component);
+    ++phaseState.numComponents_;
+}
+
+void LogicComponentScheduler::Remove(LogicComponent* component, LogicUpdatePhase phase)
+{
+    const unsigned phaseIndex = static_cast<unsigned>(phase);
+    LogicComponentSlot& slot = component->schedulerSlots_[phaseIndex];
+    if (slot.batch_ == M_MAX_UNSIGNED)
+        return;
+
+    PhaseState& phaseState = phases_[phaseIndex];
+    ea::vector<LogicComponent*>& components = phaseState.batches_[slot.batch_].components_;
+    assert(components[slot.index_] == component);
+
+    if (phaseState.updating_)
+    {
+        // Keep the order of the components being iterated
+        components[slot.index_] = nullptr;
+        phaseState.needCompaction_ = true;
+    }
+    else
+    {
+        LogicComponent* lastComponent = components.back();
+        components[slot.index_] = lastComponent;
+        lastComponent->schedulerSlots_[phaseIndex].index_ = slot.index_;
+        components.pop_back();
+    }
+
+    slot = {};
+    --phaseState.numComponents_;
+}
+
+void LogicComponentScheduler::Update(LogicUpdatePhase phase, float timeStep)
+{
+    const unsigned phaseIndex = static_cast<unsigned>(phase);
+    PhaseState& phaseState = phases_[phaseIndex];
+    if (phaseState.numComponents_ == 0)
+        return;
+
+    URHO3D_PROFILE("UpdateLogicComponents");
+
+    auto* queue = GetSubsystem<WorkQueue>();
+    const unsigned frameNumber = phaseState.frameNumber_++;
+    const bool hasDelayedStart = phase == LogicUpdatePhase::Update || phase == LogicUpdatePhase::FixedUpdate;
+
+    phaseState.updating_ = true;
+    for (unsigned batchIndex = 0; batchIndex < phaseState.batches_.size(); ++batchIndex)
+    {
+        const Batch& batch = phaseState.batches_[batchIndex];
+        if (!batch.threadSafe_ || !queue || queue->GetNumThreads() == 0)
+        {
+            // Components may be added to the batch during the update
+            const unsigned numComponents = batch.components_.size();
+            for (unsigned i = 0; i < numComponents; ++i)
+            {
+                if (LogicComponent* component = phaseState.batches_[batchIndex].components_[i])
+                    UpdateComponent(component, phase, frameNumber, timeStep);
+            }
+            continue;
+        }
+
+        // Delayed start is not expected to be thread-safe, call it first
+        if (hasDelayedStart)
+        {
+            const unsigned numComponents = batch.components_.size();
+            for (unsigned i = 0; i < numComponents; ++i)
+            {
+                LogicComponent* component = phaseState.batches_[batchIndex].components_[i];
+                if (component && !component->delayedStartCalled_)
+                {
+                    component->DelayedStart();
+                    component->delayedStartCalled_ = true;
+                    if (phase == LogicUpdatePhase::Update && !(component->updateEventMask_ & USE_UPDATE))
+                        component->SetPhaseScheduled(component->GetScene(), USE_UPDATE, phase, false);
+                }
+            }
+        }
+
+        const Batch& parallelBatch = phaseState.batches_[batchIndex];
+        queue->ParallelFor(parallelBatch.components_.size(), LOGIC_UPDATE_GRAIN_SIZE,
+            [&](unsigned begin, unsigned end, unsigned)
+        {
+            for (unsigned i = begin; i < end; ++i)
+            {
+                if (LogicComponent* component = parallelBatch.components_[i])
+                    UpdateComponent(component, phase, frameNumber, timeStep);
+            }
+        });
+        queue->Complete(M_MAX_UNSIGNED);
+    }
+    phaseState.updating_ = false;
+
+    if (phaseState.needCompaction_)
+        Compact(phase);
+}
+
+unsigned LogicComponentScheduler::GetNumComponents(LogicUpdatePhase phase) const
+{
+    return phases_[static_cast<unsigned>(phase)].numComponents_;
+}
+
+void LogicComponentScheduler::UpdateComponent(LogicComponent* component, LogicUpdatePhase phase, unsigned frameNumber, float timeStep)
+{
+    switch (phase)
+    {
+    case LogicUpdatePhase::Update:
+        // Execute user-defined delayed start function before first update
+        if (!component->delayedStartCalled_)
+        {
+            component->DelayedStart();
+            component->delayedStartCalled_ = true;
+
+            // If did not need actual update events, unschedule now
+            if (!(component->updateEventMask_ & USE_UPDATE))
+            {
+                component->SetPhaseScheduled(component->GetScene(), USE_UPDATE, phase, false);
+                return;
+            }
+        }
+        break;
+
+    case LogicUpdatePhase::FixedUpdate:
+        // Execute user-defined delayed start function before first fixed update if not called yet
+        if (!component->delayedStartCalled_)
+        {
+            component->DelayedStart();
+            component->delayedStartCalled_ = true;
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    // Skip variable timestep updates of components with update divisor, spreading them over frames
+    if (phase == LogicUpdatePhase::Update || phase == LogicUpdatePhase::PostUpdate)
+    {
+        const unsigned divisor = component->updateDivisor_;
+        if (divisor > 1)
+        {
+            float& accumulator = phase == LogicUpdatePhase::Update
+                ? component->updateTimeAccumulator_ : component->postUpdateTimeAccumulator_;
+            accumulator += timeStep;
+            if ((frameNumber + component->GetID()) % divisor != 0)
+                return;
+
+            timeStep = accumulator;
+            accumulator = 0.0f;
+        }
+    }
+
+    switch (phase)
+    {
+    case LogicUpdatePhase::Update: component->Update(timeStep); break;
+    case LogicUpdatePhase::PostUpdate: component->PostUpdate(timeStep); break;
+    case LogicUpdatePhase::FixedUpdate: component->FixedUpdate(timeStep); break;
+    case LogicUpdatePhase::FixedPostUpdate: component->FixedPostUpdate(timeStep); break;
+    default: break;
+    }
+}
+
+void LogicComponentScheduler::Compact(LogicUpdatePhase phase)
+{
+    const unsigned phaseIndex = static_cast<unsigned>(phase);
+    PhaseState& phaseState = phases_[phaseIndex];
+    for (Batch& batch : phaseState.batches_)
+    {
+        ea::erase(batch.components_, nullptr);
+        for (unsigned i = 0; i < batch.components_.size(); ++i)
+            batch.components_[i]->schedulerSlots_[phaseIndex].index_ = i;
+    }
+    phaseState.needCompaction_ = false;
+}
+
+void LogicComponentScheduler::SetFixedUpdateSource(Component* source)
+{
+#if defined(URHO3D_PHYSICS) || defined(URHO3D_URHO2D)
+    if (fixedUpdateSource_ == source)
+        return;
+
+    if (fixedUpdateSource_)
+    {
+        UnsubscribeFromEvent(fixedUpdateSource_, E_PHYSICSPRESTEP);
+        UnsubscribeFromEvent(fixedUpdateSource_, E_PHYSICSPOSTSTEP);
+    }
+
+    fixedUpdateSource_ = source;
+    SubscribeToEvent(source, E_PHYSICSPRESTEP, [this](StringHash, VariantMap& eventData)
+    {
+        using namespace PhysicsPreStep;
+        Update(LogicUpdatePhase::FixedUpdate, eventData[P_TIMESTEP].GetFloat());
+    });
+    SubscribeToEvent(source, E_PHYSICSPOSTSTEP, [this](StringHash, VariantMap& eventData)
+    {
+        using namespace PhysicsPostStep;
+        Update(LogicUpdatePhase::FixedPostUpdate, eventData[P_TIMESTEP].GetFloat());
+    });
+#endif
+}
+
+}
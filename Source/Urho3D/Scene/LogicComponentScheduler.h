@@ -0,0 +1,96 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+/// \file
+
+#pragma once
+
+#include "../Core/Object.h"
+#include "../Scene/LogicComponent.h"
+
+namespace Urho3D
+{
+
+/// Scheduler of logic component updates owned by the Scene. Components are kept in per-type lists for each phase and
+/// their update functions are called directly in loops. Components marked as thread-safe are updated in parallel.
+class URHO3D_API LogicComponentScheduler : public Object
+{
+    URHO3D_OBJECT(LogicComponentScheduler, Object);
+
+public:
+    /// Construct.
+    explicit LogicComponentScheduler(Context* context);
+    /// Destruct.
+    ~LogicComponentScheduler() override;
+
+    /// Add component to the phase. Fixed phases are driven by the fixed update source.
+    void Add(LogicComponent* component, LogicUpdatePhase phase, Component* fixedUpdateSource = nullptr);
+    /// Remove component from the phase.
+    void Remove(LogicComponent* component, LogicUpdatePhase phase);
+    /// Update components of the phase.
+    void Update(LogicUpdatePhase phase, float timeStep);
+
+    /// Return number of components in the phase.
+    unsigned GetNumComponents(LogicUpdatePhase phase) const;
+
+private:
+    /// Components of the same type and thread safety.
+    struct Batch
+    {
+        /// Component type.
+        StringHash type_;
+        /// Whether the components are updated in parallel.
+        bool threadSafe_{};
+        /// Components. Removed components are null until the batch is compacted.
+        ea::vector<LogicComponent*> components_;
+    };
+
+    /// Batches of the phase.
+    struct PhaseState
+    {
+        /// Batches.
+        ea::vector<Batch> batches_;
+        /// Number of components.
+        unsigned numComponents_{};
+        /// Number of updates of the phase performed.
+        unsigned frameNumber_{};
+        /// Whether the phase is being updated.
+        bool updating_{};
+        /// Whether there are removed components to compact.
+        bool needCompaction_{};
+    };
+
+    /// Update component in the phase.
+    void UpdateComponent(LogicComponent* component, LogicUpdatePhase phase, unsigned frameNumber, float timeStep);
+    /// Remove null components from batches of the phase.
+    void Compact(LogicUpdatePhase phase);
+    /// Subscribe to fixed update events of the source.
+    void SetFixedUpdateSource(Component* source);
+
+    /// Phases.
+    PhaseState phases_[NUM_LOGIC_UPDATE_PHASES];
+    /// Component that sends out fixed update events.
+    WeakPtr<Component> fixedUpdateSource_;
+};
+
+}
@@ -884,6 +884,10 @@ void Node::SetOwner(Connection* owner)
 
 void Node::MarkDirty()
 {
+    // Only the topmost dirty node of a hierarchy is queued, its children are reached by the scene's transform update pass
+    if (!dirty_ && scene_ && parent_ && (parent_ == scene_ || !parent_->dirty_))
+        scene_->MarkTransformDirty(this);
+
     Node *cur = this;
     for (;;)
     {
@@ -1826,6 +1830,104 @@ bool Node::LoadJSON(const JSONValue& source, SceneResolver& resolver, bool loadC
     return true;
 }
 
+bool Node::DecodeHierarchy(Context* context, Deserializer& source, DecodedNode& dest)
+{
+    dest.id_ = source.ReadUInt();
+    if (!Serializable::DecodeBinary(context, GetTypeStatic(), source, dest.attributes_))
+        return false;
+
+    const unsigned numComponents = source.ReadVLE();
+    for (unsigned i = 0; i < numComponents; ++i)
+    {
+        VectorBuffer compBuffer(source, source.ReadVLE());
+        DecodedComponent& component = dest.components_.emplace_back();
+        component.type_ = compBuffer.ReadStringHash();
+        component.id_ = compBuffer.ReadUInt();
+
+        // Keep the data of components that can not be decoded without creating them
+        const unsigned dataStart = compBuffer.GetPosition();
+        if (!Serializable::DecodeBinary(context, component.type_, compBuffer, component.attributes_))
+        {
+            component.loadSource_ = true;
+            component.binarySource_.assign(compBuffer.GetData() + dataStart, compBuffer.GetData() + compBuffer.GetSize());
+        }
+    }
+
+    const unsigned numChildren = source.ReadVLE();
+    for (unsigned i = 0; i < numChildren; ++i)
+    {
+        if (!DecodeHierarchy(context, source, dest.children_.emplace_back()))
+            return false;
+    }
+
+    return true;
+}
+
+void Node::DecodeHierarchyXML(Context* context, const XMLElement& source, DecodedNode& dest)
+{
+    dest.id_ = source.GetUInt("id");
+    dest.xmlSource_ = source;
+    if (source.HasChild("objectanimation") || source.HasChild("attributeanimation")
+        || !Serializable::DecodeXML(context, GetTypeStatic(), source, dest.attributes_))
+    {
+        dest.loadSource_ = true;
+        return;
+    }
+
+    for (XMLElement compElem = source.GetChild("component"); compElem; compElem = compElem.GetNext("component"))
+    {
+        DecodedComponent& component = dest.components_.emplace_back();
+        component.typeName_ = compElem.GetAttribute("type");
+        component.type_ = component.typeName_;
+        component.id_ = compElem.GetUInt("id");
+        component.xmlSource_ = compElem;
+        component.loadSource_ = compElem.HasChild("objectanimation") || compElem.HasChild("attributeanimation")
+            || !Serializable::DecodeXML(context, component.type_, compElem, component.attributes_);
+    }
+
+    for (XMLElement childElem = source.GetChild("node"); childElem; childElem = childElem.GetNext("node"))
+        DecodeHierarchyXML(context, childElem, dest.children_.emplace_back());
+}
+
+void Node::DecodeHierarchyJSON(Context* context, const JSONValue& source, DecodedNode& dest)
+{
+    dest.id_ = source.Get("id").GetUInt();
+    dest.jsonSource_ = &source;
+    if (source.Contains("objectanimation") || source.Contains("attributeanimation")
+        || !Serializable::DecodeJSON(context, GetTypeStatic(), source, dest.attributes_))
+    {
+        dest.loadSource_ = true;
+        return;
+    }
+
+    for (const JSONValue& compVal : source.Get("components").GetArray())
+    {
+        DecodedComponent& component = dest.components_.emplace_back();
+        component.typeName_ = compVal.Get("type").GetString();
+        component.type_ = component.typeName_;
+        component.id_ = compVal.Get("id").GetUInt();
+        component.jsonSource_ = &compVal;
+        component.loadSource_ = compVal.Contains("objectanimation") || compVal.Contains("attributeanimation")
+            || !Serializable::DecodeJSON(context, component.type_, compVal, component.attributes_);
+    }
+
+    for (const JSONValue& childVal : source.Get("children").GetArray())
+        DecodeHierarchyJSON(context, childVal, dest.children_.emplace_back());
+}
+
+bool Node::LoadDecodedComponent(Component* component, const DecodedComponent& source)
+{
+    if (!source.loadSource_)
+        return component->LoadDecoded(source.attributes_);
+    if (source.jsonSource_)
+        return component->LoadJSON(*source.jsonSource_);
+    if (source.xmlSource_)
+        return component->LoadXML(source.xmlSource_);
+
+    MemoryBuffer buffer(source.binarySource_);
+    return component->Load(buffer);
+}
+
 void Node::PrepareNetworkUpdate()
 {
     // Update dependency nodes list first
@@ -1857,6 +1959,7 @@ void Node::PrepareNetworkUpdate()
     unsigned numAttributes = attributes->size();
 
     // Check for attribute changes
+    DirtyBits changedAttributes;
     for (unsigned i = 0; i < numAttributes; ++i)
     {
         const AttributeInfo& attr = attributes->at(i);
@@ -1864,11 +1967,9 @@ void Node::PrepareNetworkUpdate()
         if (animationEnabled_ && IsAnimatedNetworkAttribute(attr))
             continue;
 
-        OnGetAttribute(attr, networkState_->currentValues_[i]);
-
-        if (networkState_->currentValues_[i] != networkState_->previousValues_[i])
+        if (UpdateNetworkAttribute(i))
         {
-            networkState_->previousValues_[i] = networkState_->currentValues_[i];
+            changedAttributes.Set(i);
 
             // Mark the attribute dirty in all replication states that are tracking this node
             for (auto j = networkState_->replicationStates_.begin();
@@ -1887,6 +1988,8 @@ void Node::PrepareNetworkUpdate()
         }
     }
 
+    PrepareSharedNetworkUpdates(changedAttributes);
+
     // Finally check for user var changes
     for (auto i = vars_.begin(); i != vars_.end(); ++i)
     {
@@ -2049,14 +2152,14 @@ void Node::SetTransformSilent(const Matrix3x4& matrix)
 
 void Node::OnAttributeAnimationAdded()
 {
-    if (attributeAnimationInfos_.size() == 1)
-        SubscribeToEvent(GetScene(), E_ATTRIBUTEANIMATIONUPDATE, URHO3D_HANDLER(Node, HandleAttributeAnimationUpdate));
+    if (attributeAnimationInfos_.size() == 1 && scene_)
+        scene_->AddAttributeAnimationTarget(this);
 }
 
 void Node::OnAttributeAnimationRemoved()
 {
-    if (attributeAnimationInfos_.empty())
-        UnsubscribeFromEvent(GetScene(), E_ATTRIBUTEANIMATIONUPDATE);
+    if (attributeAnimationInfos_.empty() && scene_)
+        scene_->RemoveAttributeAnimationTarget(this);
 }
 
 Animatable* Node::FindAttributeAnimationTarget(const ea::string& name, ea::string& outName)
@@ -2407,11 +2510,4 @@ void Node::RemoveComponent(ea::vector<SharedPtr<Component> >::iterator i)
     components_.erase(i);
 }
 
-void Node::HandleAttributeAnimationUpdate(StringHash eventType, VariantMap& eventData)
-{
-    using namespace AttributeAnimationUpdate;
-
-    UpdateAttributeAnimations(eventData[P_TIMESTEP].GetFloat());
-}
-
 }
@@ -24,8 +24,10 @@
 
 #pragma once
 
+#include "../Container/SlabAllocator.h"
 #include "../IO/VectorBuffer.h"
 #include "../Math/Matrix3x4.h"
+#include "../Resource/XMLElement.h"
 #include "../Scene/Animatable.h"
 
 namespace Urho3D
@@ -54,6 +56,46 @@ enum TransformSpace
     TS_WORLD
 };
 
+/// Component decoded from serialized data without creating it.
+struct DecodedComponent
+{
+    /// Type name. Empty if decoded from binary data.
+    ea::string typeName_;
+    /// Type hash.
+    StringHash type_;
+    /// Serialized ID.
+    unsigned id_{};
+    /// Decoded attribute values.
+    DecodedAttributes attributes_;
+    /// Whether the component must be loaded from the source data on the main thread instead.
+    bool loadSource_{};
+    /// Source XML element.
+    XMLElement xmlSource_;
+    /// Source JSON value.
+    const JSONValue* jsonSource_{};
+    /// Source binary data following the type and ID.
+    ea::vector<unsigned char> binarySource_;
+};
+
+/// Node hierarchy decoded from serialized data without creating it. Decoding is safe on worker threads, creation happens on the main thread.
+struct DecodedNode
+{
+    /// Serialized ID.
+    unsigned id_{};
+    /// Decoded attribute values.
+    DecodedAttributes attributes_;
+    /// Components.
+    ea::vector<DecodedComponent> components_;
+    /// Child nodes.
+    ea::vector<DecodedNode> children_;
+    /// Whether the whole hierarchy must be loaded from the source data on the main thread instead.
+    bool loadSource_{};
+    /// Source XML element.
+    XMLElement xmlSource_;
+    /// Source JSON value.
+    const JSONValue* jsonSource_{};
+};
+
 /// Internal implementation structure for less performance-critical Node variables.
 struct URHO3D_API NodeImpl
 {
@@ -77,8 +119,13 @@ class URHO3D_API Node : public Animatable
     URHO3D_OBJECT(Node, Animatable);
 
     friend class Connection;
+    friend class PrefabResource;
+    friend class Scene;
 
 public:
+    /// Nodes are allocated from slabs, as they are created and destroyed at a high rate.
+    URHO3D_SLAB_ALLOCATED
+
     /// Construct.
     explicit Node(Context* context);
     /// Destruct. Any child nodes are detached.
@@ -307,6 +354,8 @@ public:
     Component* CreateComponent(StringHash type, CreateMode mode = REPLICATED, unsigned id = 0);
     /// Create a component to this node if it does not exist already.
     Component* GetOrCreateComponent(StringHash type, CreateMode mode = REPLICATED, unsigned id = 0);
+    /// Create component, allowing UnknownComponent if actual type is not supported. Leave typeName empty if not known.
+    Component* SafeCreateComponent(const ea::string& typeName, StringHash type, CreateMode mode, unsigned id);
     /// Clone a component from another node using its create mode. Return the clone if successful or null on failure.
     Component* CloneComponent(Component* component, unsigned id = 0);
     /// Clone a component from another node and specify the create mode. Return the clone if successful or null on failure.
@@ -609,6 +658,14 @@ public:
     /// Load components from XML data and optionally load child nodes.
     bool LoadJSON(const JSONValue& source, SceneResolver& resolver, bool loadChildren = true, bool rewriteIDs = false,
         CreateMode mode = REPLICATED);
+    /// Decode node hierarchy from binary data, including the node ID. Safe to call from worker threads. Return true if successful.
+    static bool DecodeHierarchy(Context* context, Deserializer& source, DecodedNode& dest);
+    /// Decode node hierarchy from XML data. Safe to call from worker threads. Hierarchies with attribute animations are left to be loaded from the source.
+    static void DecodeHierarchyXML(Context* context, const XMLElement& source, DecodedNode& dest);
+    /// Decode node hierarchy from JSON data. Safe to call from worker threads. Hierarchies with attribute animations are left to be loaded from the source.
+    static void DecodeHierarchyJSON(Context* context, const JSONValue& source, DecodedNode& dest);
+    /// Load component from decoded data, or from its source data if it could not be decoded. Return true if successful.
+    static bool LoadDecodedComponent(Component* component, const DecodedComponent& source);
     /// Return the depended on nodes to order network updates.
     const ea::vector<Node*>& GetDependencyNodes() const { return impl_->dependencyNodes_; }
 
@@ -653,8 +710,6 @@ protected:
 private:
     /// Set enabled/disabled state with optional recursion. Optionally affect the remembered enable state.
     void SetEnabled(bool enable, bool recursive, bool storeSelf);
-    /// Create component, allowing UnknownComponent if actual type is not supported. Leave typeName empty if not known.
-    Component* SafeCreateComponent(const ea::string& typeName, StringHash type, CreateMode mode, unsigned id);
     /// Recalculate the world transform.
     void UpdateWorldTransform() const;
     /// Remove child node by iterator.
@@ -671,8 +726,6 @@ private:
     Node* CloneRecursive(Node* parent, SceneResolver& resolver, CreateMode mode);
     /// Remove a component from this node with the specified iterator.
     void RemoveComponent(ea::vector<SharedPtr<Component> >::iterator i);
-    /// Handle attribute animation update event.
-    void HandleAttributeAnimationUpdate(StringHash eventType, VariantMap& eventData);
 
     /// World-space transform matrix.
     mutable Matrix3x4 worldTransform_;
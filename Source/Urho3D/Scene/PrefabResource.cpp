@@ -0,0 +1,308 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Core/Profiler.h"
+#include "../IO/FileSystem.h"
+#include "../IO/Log.h"
+#include "../Resource/JSONFile.h"
+#include "../Resource/XMLFile.h"
+#include "../Scene/Component.h"
+#include "../Scene/PrefabResource.h"
+#include "../Scene/Scene.h"
+#include "../Scene/SceneResolver.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+/// ID attribute modes remapped on instantiation.
+static const AttributeModeFlags ID_ATTRIBUTE_MODES = AM_NODEID | AM_COMPONENTID | AM_NODEIDVECTOR;
+
+/// Assign template indices to the nodes and components of the hierarchy in creation order.
+static void IndexTemplateNode(DecodedNode& node, ea::unordered_map<unsigned, unsigned>& nodeIndices,
+    ea::unordered_map<unsigned, unsigned>& componentIndices, ea::vector<DecodedComponent*>& components, unsigned& numNodes,
+    bool& decodedOnly)
+{
+    if (node.id_)
+        nodeIndices[node.id_] = numNodes;
+    ++numNodes;
+
+    if (node.loadSource_)
+    {
+        decodedOnly = false;
+        return;
+    }
+
+    for (DecodedComponent& component : node.components_)
+    {
+        if (component.id_)
+            componentIndices[component.id_] = components.size();
+        if (component.loadSource_)
+            decodedOnly = false;
+        components.push_back(&component);
+    }
+
+    for (DecodedNode& child : node.children_)
+        IndexTemplateNode(child, nodeIndices, componentIndices, components, numNodes, decodedOnly);
+}
+
+/// Return template index of serialized ID, or M_MAX_UNSIGNED if it is outside the prefab.
+static unsigned FindTemplateIndex(const ea::unordered_map<unsigned, unsigned>& indices, unsigned id, const char* objectName)
+{
+    if (!id)
+        return M_MAX_UNSIGNED;
+
+    auto iter = indices.find(id);
+    if (iter == indices.end())
+    {
+        URHO3D_LOGWARNING("Could not resolve {} ID {}", objectName, id);
+        return M_MAX_UNSIGNED;
+    }
+    return iter->second;
+}
+
+PrefabResource::PrefabResource(Context* context) :
+    Resource(context)
+{
+}
+
+PrefabResource::~PrefabResource() = default;
+
+void PrefabResource::RegisterObject(Context* context)
+{
+    context->RegisterFactory<PrefabResource>();
+}
+
+bool PrefabResource::BeginLoad(Deserializer& source)
+{
+    root_ = {};
+    idReferences_.clear();
+    xmlFile_.Reset();
+    jsonFile_.Reset();
+
+    const ea::string extension = GetExtension(source.GetName());
+    if (extension == ".xml")
+    {
+        xmlFile_ = MakeShared<XMLFile>(context_);
+        if (!xmlFile_->Load(source))
+            return false;
+        Node::DecodeHierarchyXML(context_, xmlFile_->GetRoot(), root_);
+    }
+    else if (extension == ".json")
+    {
+        jsonFile_ = MakeShared<JSONFile>(context_);
+        if (!jsonFile_->Load(source))
+            return false;
+        Node::DecodeHierarchyJSON(context_, jsonFile_->GetRoot(), root_);
+    }
+    else if (!Node::DecodeHierarchy(context_, source, root_))
+    {
+        URHO3D_LOGERROR("Could not decode prefab " + GetName());
+        return false;
+    }
+
+    needsResolver_ = !PrepareTemplate();
+
+    // Fully decoded templates do not refer to the source document anymore
+    if (!needsResolver_)
+    {
+        xmlFile_.Reset();
+        jsonFile_.Reset();
+    }
+
+    SetMemoryUse(source.GetSize());
+    return true;
+}
+
+Node* PrefabResource::Instantiate(Node* parent, const Vector3& position, const Quaternion& rotation, CreateMode mode) const
+{
+    if (!parent)
+    {
+        URHO3D_LOGERROR("Null parent node, can not instantiate prefab " + GetName());
+        return nullptr;
+    }
+
+    URHO3D_PROFILE("InstantiatePrefabResource");
+
+    ea::vector<Node*> nodes;
+    ea::vector<Component*> components;
+    nodes.reserve(numNodes_);
+    components.reserve(numComponents_);
+
+    SceneResolver resolver;
+    Node* node = parent->CreateChild(EMPTY_STRING, (mode == REPLICATED && Scene::IsReplicatedID(root_.id_)) ? REPLICATED : LOCAL);
+    if (!InstantiateNode(node, root_, mode, needsResolver_ ? &resolver : nullptr, nodes, components))
+    {
+        node->Remove();
+        return nullptr;
+    }
+
+    if (needsResolver_)
+        resolver.Resolve();
+    else
+    {
+        for (const PrefabIDReference& reference : idReferences_)
+        {
+            Component* component = components[reference.component_];
+            if (!component)
+                continue;
+
+            if (reference.mode_ & AM_NODEIDVECTOR)
+            {
+                const VariantVector& oldIDs = reference.value_.GetVariantVector();
+                if (oldIDs.empty())
+                {
+                    component->SetAttribute(reference.attribute_, reference.value_);
+                    continue;
+                }
+
+                // The first index stores the number of IDs redundantly
+                VariantVector newIDs;
+                newIDs.reserve(oldIDs.size());
+                newIDs.push_back(oldIDs[0]);
+                for (unsigned target : reference.targets_)
+                    newIDs.push_back(target != M_MAX_UNSIGNED ? nodes[target]->GetID() : 0u);
+                component->SetAttribute(reference.attribute_, newIDs);
+            }
+            else
+            {
+                const unsigned target = reference.targets_[0];
+                unsigned newID = reference.value_.GetUInt();
+                if (target != M_MAX_UNSIGNED && (reference.mode_ & AM_NODEID))
+                    newID = nodes[target]->GetID();
+                else if (target != M_MAX_UNSIGNED && components[target])
+                    newID = components[target]->GetID();
+                component->SetAttribute(reference.attribute_, Variant(newID));
+            }
+        }
+    }
+
+    node->SetTransform(position, rotation);
+    node->ApplyAttributes();
+    return node;
+}
+
+bool PrefabResource::PrepareTemplate()
+{
+    ea::unordered_map<unsigned, unsigned> nodeIndices;
+    ea::unordered_map<unsigned, unsigned> componentIndices;
+    ea::vector<DecodedComponent*> components;
+    bool decodedOnly = true;
+
+    numNodes_ = 0;
+    IndexTemplateNode(root_, nodeIndices, componentIndices, components, numNodes_, decodedOnly);
+    numComponents_ = components.size();
+
+    // SceneResolver handles the IDs of the parts loaded from the source data
+    if (!decodedOnly)
+        return false;
+
+    // Move ID attributes out of the decoded values, so that they are applied once with the remapped IDs
+    for (unsigned i = 0; i < components.size(); ++i)
+    {
+        DecodedComponent& component = *components[i];
+        const ea::vector<AttributeInfo>* attributes = context_->GetAttributes(component.type_);
+        if (!attributes)
+            continue;
+
+        for (auto iter = component.attributes_.begin(); iter != component.attributes_.end();)
+        {
+            const AttributeInfo& attr = attributes->at(iter->first);
+            if (!(attr.mode_ & ID_ATTRIBUTE_MODES))
+            {
+                ++iter;
+                continue;
+            }
+
+            PrefabIDReference& reference = idReferences_.emplace_back();
+            reference.component_ = i;
+            reference.attribute_ = iter->first;
+            reference.mode_ = attr.mode_ & ID_ATTRIBUTE_MODES;
+            reference.value_ = iter->second;
+
+            if (reference.mode_ & AM_NODEIDVECTOR)
+            {
+                const VariantVector& oldIDs = reference.value_.GetVariantVector();
+                for (unsigned j = 1; j < oldIDs.size(); ++j)
+                    reference.targets_.push_back(FindTemplateIndex(nodeIndices, oldIDs[j].GetUInt(), "node"));
+            }
+            else if (reference.mode_ & AM_NODEID)
+                reference.targets_.push_back(FindTemplateIndex(nodeIndices, reference.value_.GetUInt(), "node"));
+            else
+                reference.targets_.push_back(FindTemplateIndex(componentIndices, reference.value_.GetUInt(), "component"));
+
+            iter = component.attributes_.erase(iter);
+        }
+    }
+
+    return true;
+}
+
+bool PrefabResource::InstantiateNode(Node* newNode, const DecodedNode& decoded, CreateMode mode, SceneResolver* resolver,
+    ea::vector<Node*>& nodes, ea::vector<Component*>& components) const
+{
+    nodes.push_back(newNode);
+    if (resolver)
+        resolver->AddNode(decoded.id_, newNode);
+
+    // Parts that could not be decoded are loaded from the source, which only happens when resolving through SceneResolver
+    if (decoded.loadSource_)
+    {
+        if (decoded.jsonSource_)
+            return newNode->LoadJSON(*decoded.jsonSource_, *resolver, true, true, mode);
+        return newNode->LoadXML(decoded.xmlSource_, *resolver, true, true, mode);
+    }
+
+    if (!newNode->LoadDecoded(decoded.attributes_))
+        return false;
+
+    for (const DecodedComponent& decodedComponent : decoded.components_)
+    {
+        Component* newComponent = newNode->SafeCreateComponent(decodedComponent.typeName_, decodedComponent.type_,
+            (mode == REPLICATED && Scene::IsReplicatedID(decodedComponent.id_)) ? REPLICATED : LOCAL, 0);
+        components.push_back(newComponent);
+        if (!newComponent)
+            continue;
+
+        if (resolver)
+            resolver->AddComponent(decodedComponent.id_, newComponent);
+        if (!Node::LoadDecodedComponent(newComponent, decodedComponent))
+            return false;
+    }
+
+    for (const DecodedNode& decodedChild : decoded.children_)
+    {
+        Node* newChild = newNode->CreateChild(EMPTY_STRING,
+            (mode == REPLICATED && Scene::IsReplicatedID(decodedChild.id_)) ? REPLICATED : LOCAL);
+        if (!InstantiateNode(newChild, decodedChild, mode, resolver, nodes, components))
+            return false;
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,104 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+/// \file
+
+#pragma once
+
+#include "../Resource/Resource.h"
+#include "../Scene/Node.h"
+
+namespace Urho3D
+{
+
+class JSONFile;
+class XMLFile;
+
+/// Node or component ID attribute of a prefab template, remapped on instantiation.
+struct PrefabIDReference
+{
+    /// Template index of the referencing component.
+    unsigned component_{};
+    /// Attribute index.
+    unsigned attribute_{};
+    /// Attribute mode: AM_NODEID, AM_COMPONENTID or AM_NODEIDVECTOR.
+    AttributeModeFlags mode_;
+    /// Serialized attribute value, kept for IDs that point outside the prefab.
+    Variant value_;
+    /// Template indices of the referenced nodes or components, M_MAX_UNSIGNED if outside the prefab.
+    ea::vector<unsigned> targets_;
+};
+
+/// Prefab resource, decoded once into a template of nodes and components with typed attribute values. Instantiation
+/// creates the hierarchy without parsing and remaps ID attributes through precomputed template indices.
+class URHO3D_API PrefabResource : public Resource
+{
+    URHO3D_OBJECT(PrefabResource, Resource);
+
+public:
+    /// Construct.
+    explicit PrefabResource(Context* context);
+    /// Destruct.
+    ~PrefabResource() override;
+    /// Register object factory.
+    static void RegisterObject(Context* context);
+
+    /// Load resource from stream. May be called from a worker thread. Return true if successful.
+    bool BeginLoad(Deserializer& source) override;
+
+    /// Instantiate the prefab as a child of the parent node. Return root node if successful.
+    Node* Instantiate(Node* parent, const Vector3& position, const Quaternion& rotation, CreateMode mode = REPLICATED) const;
+
+    /// Return root node template.
+    const DecodedNode& GetRoot() const { return root_; }
+    /// Return number of nodes in the template.
+    unsigned GetNumNodes() const { return numNodes_; }
+    /// Return number of components in the template.
+    unsigned GetNumComponents() const { return numComponents_; }
+    /// Return whether instantiation resolves IDs through SceneResolver, because parts of the template are loaded from the source data.
+    bool NeedsResolver() const { return needsResolver_; }
+
+private:
+    /// Count nodes and components and precompute ID references. Return false if the template needs SceneResolver instead.
+    bool PrepareTemplate();
+    /// Create node hierarchy from template. Return true if successful.
+    bool InstantiateNode(Node* newNode, const DecodedNode& decoded, CreateMode mode, SceneResolver* resolver,
+        ea::vector<Node*>& nodes, ea::vector<Component*>& components) const;
+
+    /// Root node template.
+    DecodedNode root_;
+    /// ID attributes to remap on instantiation.
+    ea::vector<PrefabIDReference> idReferences_;
+    /// Source XML file, kept while the template refers to it.
+    SharedPtr<XMLFile> xmlFile_;
+    /// Source JSON file, kept while the template refers to it.
+    SharedPtr<JSONFile> jsonFile_;
+    /// Number of nodes.
+    unsigned numNodes_{};
+    /// Number of components.
+    unsigned numComponents_{};
+    /// Whether instantiation needs SceneResolver.
+    bool needsResolver_{};
+};
+
+}
@@ -26,6 +26,7 @@
 #include <EASTL/unordered_map.h>
 
 #include "../Core/Attribute.h"
+#include "../IO/VectorBuffer.h"
 #include "../Math/StringHash.h"
 
 #include <cstring>
@@ -111,6 +112,15 @@ struct URHO3D_API DirtyBits
     /// Return number of set bits.
     unsigned Count() const { return count_; }
 
+    /// Test for equality with another set of bits.
+    bool operator ==(const DirtyBits& rhs) const
+    {
+        return count_ == rhs.count_ && memcmp(data_, rhs.data_, MAX_NETWORK_ATTRIBUTES / 8) == 0;
+    }
+
+    /// Test for inequality with another set of bits.
+    bool operator !=(const DirtyBits& rhs) const { return !(*this == rhs); }
+
     /// Bit data.
     unsigned char data_[MAX_NETWORK_ATTRIBUTES / 8]{};
     /// Number of set bits.
@@ -130,6 +140,14 @@ struct URHO3D_API NetworkState
     ea::vector<ReplicationState*> replicationStates_;
     /// Previous user variables.
     VariantMap previousVars_;
+    /// Attribute bits of the shared delta update.
+    DirtyBits sharedDeltaBits_;
+    /// Delta update of the last changed attributes without timestamp, shared by all connections with matching dirty bits.
+    VectorBuffer sharedDeltaUpdate_;
+    /// Latest data update without timestamp, shared by all connections. Empty if not valid.
+    VectorBuffer sharedLatestDataUpdate_;
+    /// Initial delta update without timestamp, shared by all connections the object is created for. Empty if not valid.
+    VectorBuffer sharedInitialUpdate_;
     /// Bitmask for intercepting network messages. Used on the client only.
     unsigned long long interceptMask_{};
 };
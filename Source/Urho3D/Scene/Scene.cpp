@@ -24,8 +24,11 @@
 
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
+#include "../Core/MemoryTracker.h"
 #include "../Core/Profiler.h"
+#include "../Core/Timer.h"
 #include "../Core/WorkQueue.h"
+#include "../Engine/Engine.h"
 #include "../Graphics/Texture2D.h"
 #include "../IO/Archive.h"
 #include "../IO/File.h"
@@ -37,9 +40,12 @@
 #include "../Resource/JSONFile.h"
 #include "../Scene/CameraViewport.h"
 #include "../Scene/Component.h"
+#include "../Scene/LogicComponentScheduler.h"
 #include "../Scene/ObjectAnimation.h"
+#include "../Scene/PrefabResource.h"
 #include "../Scene/ReplicationState.h"
 #include "../Scene/Scene.h"
+#include "../Scene/SceneChunkIndex.h"
 #include "../Scene/SceneEvents.h"
 #include "../Scene/SceneManager.h"
 #include "../Scene/SmoothedTransform.h"
@@ -47,6 +53,8 @@
 #include "../Scene/UnknownComponent.h"
 #include "../Scene/ValueAnimation.h"
 
+#include <EASTL/sort.h>
+
 #include "../DebugNew.h"
 
 namespace Urho3D
@@ -58,6 +66,16 @@ const char* SUBSYSTEM_CATEGORY = "Subsystem";
 
 static const float DEFAULT_SMOOTHING_CONSTANT = 50.0f;
 static const float DEFAULT_SNAP_THRESHOLD = 5.0f;
+/// Minimum number of nodes on one hierarchy level to update their transforms in worker threads.
+static const unsigned TRANSFORM_UPDATE_THREADED_THRESHOLD = 256;
+/// Number of nodes updated by one ParallelFor chunk.
+static const unsigned TRANSFORM_UPDATE_GRAIN_SIZE = 64;
+/// Number of frames a streamed lightmap may stay unused before it is released.
+static const unsigned LIGHTMAP_UNLOAD_FRAMES = 300;
+/// Extension appended to the scene file name to get the prefetch manifest name.
+static const char* PREFETCH_MANIFEST_EXTENSION = ".prefetch";
+/// Number of root-level nodes decoded by one work item in parallel async loading.
+static const unsigned ASYNC_DECODE_BATCH_SIZE = 16;
 
 Scene::Scene(Context* context) :
     Node(context),
@@ -76,16 +94,21 @@ Scene::Scene(Context* context) :
     threadedUpdate_(false),
     lightmaps_(Texture2D::GetTypeStatic())
 {
+    logicComponentScheduler_ = MakeShared<LogicComponentScheduler>(context);
+
     // Assign an ID to self so that nodes can refer to this node as a parent
     SetID(GetFreeNodeID(REPLICATED));
     NodeAdded(this);
 
-    SubscribeToEvent(E_UPDATE, URHO3D_HANDLER(Scene, HandleUpdate));
+    if (auto* engine = GetSubsystem<Engine>())
+        engine->onUpdate_.Subscribe(this, &Scene::HandleUpdate);
     SubscribeToEvent(E_RESOURCEBACKGROUNDLOADED, URHO3D_HANDLER(Scene, HandleResourceBackgroundLoaded));
 }
 
 Scene::~Scene()
 {
+    StopAsyncDecoding();
+
     // Remove root-level components first, so that scene subsystems such as the octree destroy themselves. This will speed up
     // the removal of child nodes' components
     RemoveAllComponents();
@@ -115,9 +138,119 @@ void Scene::RegisterObject(Context* context)
     URHO3D_ATTRIBUTE("Variables", VariantMap, vars_, Variant::emptyVariantMap, AM_FILE); // Network replication of vars uses custom data
     URHO3D_MIXED_ACCESSOR_ATTRIBUTE("Variable Names", GetVarNamesAttr, SetVarNamesAttr, ea::string, EMPTY_STRING, AM_FILE | AM_NOEDIT);
     URHO3D_ATTRIBUTE_EX("Lightmaps", ResourceRefList, lightmaps_, MarkLightmapTexturesDirty, ResourceRefList(Texture2D::GetTypeStatic()), AM_DEFAULT);
+    URHO3D_ATTRIBUTE_EX("Stream Lightmaps", bool, streamLightmaps_, MarkLightmapTexturesDirty, false, AM_DEFAULT);
+}
+
+namespace
+{
+
+/// Component is in the added list of the journal.
+const unsigned char JOURNAL_ADDED = 0x1;
+/// Component is in the modified list of the journal.
+const unsigned char JOURNAL_MODIFIED = 0x2;
+
+}
+
+void SceneComponentIndex::Insert(Component* component)
+{
+    if (contains(component))
+        return;
+
+    component->indexPosition_ = components_.size();
+    components_.push_back(component);
+
+    if (journalEnabled_)
+    {
+        AddToJournal(added_, component);
+        component->indexJournalFlags_ = JOURNAL_ADDED;
+    }
+}
+
+void SceneComponentIndex::Erase(Component* component)
+{
+    const unsigned position = component->indexPosition_;
+    if (position >= components_.size() || components_[position] != component)
+        return;
+
+    Component* lastComponent = components_.back();
+    components_[position] = lastComponent;
+    lastComponent->indexPosition_ = position;
+    components_.pop_back();
+    component->indexPosition_ = M_MAX_UNSIGNED;
+
+    if (journalEnabled_)
+    {
+        // Component added and removed within the journal is not reported at all
+        const unsigned char flags = component->indexJournalFlags_;
+        if (flags & JOURNAL_ADDED)
+            RemoveFromJournal(added_, component);
+        else
+            removed_.emplace_back(component);
+        if (flags & JOURNAL_MODIFIED)
+            RemoveFromJournal(modified_, component);
+        component->indexJournalFlags_ = 0;
+    }
+}
+
+void SceneComponentIndex::MarkModified(Component* component)
+{
+    if (journalEnabled_ && !component->indexJournalFlags_ && contains(component))
+    {
+        AddToJournal(modified_, component);
+        component->indexJournalFlags_ = JOURNAL_MODIFIED;
+    }
+}
+
+void SceneComponentIndex::SetJournalEnabled(bool enable)
+{
+    if (journalEnabled_ != enable)
+    {
+        ClearJournal();
+        journalEnabled_ = enable;
+    }
+}
+
+void SceneComponentIndex::ClearJournal()
+{
+    for (Component* component : added_)
+        component->indexJournalFlags_ = 0;
+    for (Component* component : modified_)
+        component->indexJournalFlags_ = 0;
+
+    added_.clear();
+    modified_.clear();
+    removed_.clear();
+}
+
+void SceneComponentIndex::AddToJournal(ea::vector<Component*>& list, Component* component)
+{
+    component->indexJournalPosition_ = list.size();
+    list.push_back(component);
 }
 
-bool Scene::CreateComponentIndex(StringHash componentType)
+void SceneComponentIndex::RemoveFromJournal(ea::vector<Component*>& list, Component* component)
+{
+    const unsigned position = component->indexJournalPosition_;
+    Component* lastComponent = list.back();
+    list[position] = lastComponent;
+    lastComponent->indexJournalPosition_ = position;
+    list.pop_back();
+}
+
+void SceneComponentIndex::SortByAddress()
+{
+    ea::sort(components_.begin(), components_.end());
+    for (unsigned i = 0; i < components_.size(); ++i)
+        components_[i]->indexPosition_ = i;
+}
+
+bool SceneComponentIndex::contains(const Component* component) const
+{
+    const unsigned position = component->indexPosition_;
+    return position < components_.size() && components_[position] == component;
+}
+
+bool Scene::CreateComponentIndex(StringHash componentType, bool journal)
 {
     if (!IsEmpty())
     {
@@ -126,7 +259,7 @@ bool Scene::CreateComponentIndex(StringHash componentType)
     }
 
     indexedComponentTypes_.push_back(componentType);
-    componentIndexes_.emplace_back();
+    componentIndexes_.emplace_back().SetJournalEnabled(journal);
     return true;
 }
 
@@ -138,6 +271,24 @@ const SceneComponentIndex& Scene::GetComponentIndex(StringHash componentType)
     return emptyIndex;
 }
 
+void Scene::SortComponentIndex(StringHash componentType)
+{
+    if (auto index = GetMutableComponentIndex(componentType))
+        index->SortByAddress();
+}
+
+void Scene::ClearComponentIndexJournal(StringHash componentType)
+{
+    if (auto index = GetMutableComponentIndex(componentType))
+        index->ClearJournal();
+}
+
+void Scene::MarkComponentModified(Component* component)
+{
+    if (auto index = GetMutableComponentIndex(component->GetType()))
+        index->MarkModified(component);
+}
+
 bool Scene::Serialize(Archive& archive)
 {
     if (!Node::Serialize(archive))
@@ -264,21 +415,76 @@ void Scene::AddLightmap(const ea::string& lightmapTextureName)
     MarkLightmapTexturesDirty();
 }
 
+void Scene::SetStreamLightmaps(bool enable)
+{
+    streamLightmaps_ = enable;
+    MarkLightmapTexturesDirty();
+}
+
 Texture2D* Scene::GetLightmapTexture(unsigned index)
 {
     if (lightmapTexturesDirty_)
     {
         auto cache = GetSubsystem<ResourceCache>();
         lightmapTextures_.clear();
-        for (const ea::string& lightmapTextureName : lightmaps_.names_)
+        lightmapLastUsedFrames_.clear();
+        if (streamLightmaps_)
         {
-            SharedPtr<Texture2D> texture{ cache->GetResource<Texture2D>(lightmapTextureName) };
-            lightmapTextures_.push_back(texture);
+            // Textures are requested on first use
+            lightmapTextures_.resize(lightmaps_.names_.size());
+            lightmapLastUsedFrames_.resize(lightmaps_.names_.size());
+        }
+        else
+        {
+            for (const ea::string& lightmapTextureName : lightmaps_.names_)
+            {
+                SharedPtr<Texture2D> texture{ cache->GetResource<Texture2D>(lightmapTextureName) };
+                lightmapTextures_.push_back(texture);
+            }
         }
 
         lightmapTexturesDirty_ = false;
     }
-    return index < lightmapTextures_.size() ? lightmapTextures_[index] : nullptr;
+
+    if (index >= lightmapTextures_.size())
+        return nullptr;
+
+    if (streamLightmaps_)
+    {
+        lightmapLastUsedFrames_[index] = GetSubsystem<Time>()->GetFrameNumber();
+        if (!lightmapTextures_[index])
+        {
+            // Queue background loading and pick up the texture once it's ready
+            auto cache = GetSubsystem<ResourceCache>();
+            const ea::string& lightmapTextureName = lightmaps_.names_[index];
+            Texture2D* texture = cache->GetExistingResource<Texture2D>(lightmapTextureName);
+            if (!texture)
+            {
+                cache->BackgroundLoadResource<Texture2D>(lightmapTextureName);
+                texture = cache->GetExistingResource<Texture2D>(lightmapTextureName);
+            }
+            lightmapTextures_[index] = texture;
+        }
+    }
+
+    return lightmapTextures_[index];
+}
+
+void Scene::ReleaseUnusedLightmaps()
+{
+    if (lightmapTexturesDirty_)
+        return;
+
+    auto cache = GetSubsystem<ResourceCache>();
+    const unsigned frameNumber = GetSubsystem<Time>()->GetFrameNumber();
+    for (unsigned i = 0; i < lightmapTextures_.size(); ++i)
+    {
+        if (!lightmapTextures_[i] || frameNumber - lightmapLastUsedFrames_[i] <= LIGHTMAP_UNLOAD_FRAMES)
+            continue;
+
+        lightmapTextures_[i] = nullptr;
+        cache->ReleaseResource<Texture2D>(lightmaps_.names_[i]);
+    }
 }
 
 bool Scene::LoadXML(Deserializer& source)
@@ -408,6 +614,10 @@ bool Scene::LoadAsync(File* file, LoadMode mode)
     asyncProgress_.mode_ = mode;
     asyncProgress_.loadedNodes_ = asyncProgress_.totalNodes_ = asyncProgress_.loadedResources_ = asyncProgress_.totalResources_ = 0;
     asyncProgress_.resources_.clear();
+    asyncProgress_.loadOrder_.clear();
+
+    if (mode != LOAD_SCENE)
+        PreloadManifestResources(file->GetName());
 
     if (mode > LOAD_RESOURCES_ONLY)
     {
@@ -472,6 +682,10 @@ bool Scene::LoadAsyncXML(File* file, LoadMode mode)
     asyncProgress_.mode_ = mode;
     asyncProgress_.loadedNodes_ = asyncProgress_.totalNodes_ = asyncProgress_.loadedResources_ = asyncProgress_.totalResources_ = 0;
     asyncProgress_.resources_.clear();
+    asyncProgress_.loadOrder_.clear();
+
+    if (mode != LOAD_SCENE)
+        PreloadManifestResources(file->GetName());
 
     if (mode > LOAD_RESOURCES_ONLY)
     {
@@ -498,11 +712,17 @@ bool Scene::LoadAsyncXML(File* file, LoadMode mode)
         asyncProgress_.xmlElement_ = childNodeElement;
 
         // Count the amount of child nodes
+        ea::vector<XMLElement> childNodeElements;
         while (childNodeElement)
         {
             ++asyncProgress_.totalNodes_;
+            if (parallelAsyncLoading_)
+                childNodeElements.push_back(childNodeElement);
             childNodeElement = childNodeElement.GetNext("node");
         }
+
+        if (parallelAsyncLoading_)
+            StartAsyncDecoding(ea::move(childNodeElements), {});
     }
     else
     {
@@ -541,6 +761,10 @@ bool Scene::LoadAsyncJSON(File* file, LoadMode mode)
     asyncProgress_.mode_ = mode;
     asyncProgress_.loadedNodes_ = asyncProgress_.totalNodes_ = asyncProgress_.loadedResources_ = asyncProgress_.totalResources_ = 0;
     asyncProgress_.resources_.clear();
+    asyncProgress_.loadOrder_.clear();
+
+    if (mode != LOAD_SCENE)
+        PreloadManifestResources(file->GetName());
 
     if (mode > LOAD_RESOURCES_ONLY)
     {
@@ -568,6 +792,15 @@ bool Scene::LoadAsyncJSON(File* file, LoadMode mode)
 
         // Count the amount of child nodes
         asyncProgress_.totalNodes_ = childrenArray.size();
+
+        if (parallelAsyncLoading_)
+        {
+            // Decode from the values held by the JSON file, which stay valid until the load finishes
+            ea::vector<const JSONValue*> childValues;
+            for (const JSONValue& childValue : json->GetRoot().Get("children").GetArray())
+                childValues.push_back(&childValue);
+            StartAsyncDecoding({}, ea::move(childValues));
+        }
     }
     else
     {
@@ -582,6 +815,8 @@ bool Scene::LoadAsyncJSON(File* file, LoadMode mode)
 
 void Scene::StopAsyncLoading()
 {
+    StopAsyncDecoding();
+
     asyncLoading_ = false;
     asyncProgress_.file_.Reset();
     asyncProgress_.xmlFile_.Reset();
@@ -589,6 +824,7 @@ void Scene::StopAsyncLoading()
     asyncProgress_.xmlElement_ = XMLElement::EMPTY;
     asyncProgress_.jsonIndex_ = 0;
     asyncProgress_.resources_.clear();
+    asyncProgress_.loadOrder_.clear();
     resolver_.Reset();
 }
 
@@ -615,6 +851,36 @@ Node* Scene::Instantiate(Deserializer& source, const Vector3& position, const Qu
     }
 }
 
+Node* Scene::Instantiate(Node* prefab, const Vector3& position, const Quaternion& rotation, CreateMode mode)
+{
+    if (!prefab || prefab == this)
+    {
+        URHO3D_LOGERROR("Null or scene prefab node, can not instantiate");
+        return nullptr;
+    }
+
+    URHO3D_PROFILE("InstantiatePrefab");
+
+    // Clone directly from the live node, skipping serialization
+    SceneResolver resolver;
+    Node* node = prefab->CloneRecursive(this, resolver, mode);
+    resolver.Resolve();
+    node->SetTransform(position, rotation);
+    node->ApplyAttributes();
+    return node;
+}
+
+Node* Scene::Instantiate(PrefabResource* prefab, const Vector3& position, const Quaternion& rotation, CreateMode mode)
+{
+    if (!prefab)
+    {
+        URHO3D_LOGERROR("Null prefab resource, can not instantiate");
+        return nullptr;
+    }
+
+    return prefab->Instantiate(this, position, rotation, mode);
+}
+
 Node* Scene::InstantiateXML(const XMLElement& source, const Vector3& position, const Quaternion& rotation, CreateMode mode)
 {
     URHO3D_PROFILE("InstantiateXML");
@@ -711,6 +977,8 @@ void Scene::Clear(bool clearReplicated, bool clearLocal)
 void Scene::SetUpdateEnabled(bool enable)
 {
     updateEnabled_ = enable;
+    if (!updateEnabled_)
+        dirtyTransformRoots_.clear();
 }
 
 void Scene::SetTimeScale(float scale)
@@ -833,6 +1101,8 @@ const ea::string& Scene::GetVarName(StringHash hash) const
 
 void Scene::Update(float timeStep)
 {
+    MemoryTagScope memoryTag(MEMORY_TAG_SCENE);
+
     if (asyncLoading_)
     {
         UpdateAsyncLoading();
@@ -847,14 +1117,18 @@ void Scene::Update(float timeStep)
 
     using namespace SceneUpdate;
 
+    UpdateEventArgs args{timeStep};
     VariantMap& eventData = GetEventDataMap();
     eventData[P_SCENE] = this;
     eventData[P_TIMESTEP] = timeStep;
 
     // Update variable timestep logic
+    logicComponentScheduler_->Update(LogicUpdatePhase::Update, timeStep);
+    onSceneUpdate_(this, args);
     SendEvent(E_SCENEUPDATE, eventData);
 
     // Update scene attribute animation.
+    UpdateAttributeAnimationTargets(timeStep);
     SendEvent(E_ATTRIBUTEANIMATIONUPDATE, eventData);
 
     // Update scene subsystems. If a physics world is present, it will be updated, triggering fixed timestep logic updates
@@ -875,14 +1149,79 @@ void Scene::Update(float timeStep)
     }
 
     // Post-update variable timestep logic
+    logicComponentScheduler_->Update(LogicUpdatePhase::PostUpdate, timeStep);
+    onScenePostUpdate_(this, args);
     SendEvent(E_SCENEPOSTUPDATE, eventData);
 
+    // Resolve world transforms of nodes moved during the update before rendering queries them one by one
+    UpdateTransforms();
+
+    // Free streamed lightmaps that are no longer rendered
+    if (streamLightmaps_)
+        ReleaseUnusedLightmaps();
+
     // Note: using a float for elapsed time accumulation is inherently inaccurate. The purpose of this value is
     // primarily to update material animation effects, as it is available to shaders. It can be reset by calling
     // SetElapsedTime()
     elapsedTime_ += timeStep;
 }
 
+void Scene::AddAttributeAnimationTarget(Animatable* animatable)
+{
+    const unsigned index = animatable->attributeAnimationTargetIndex_;
+    if (index < attributeAnimationTargets_.size() && attributeAnimationTargets_[index] == animatable)
+        return;
+
+    animatable->attributeAnimationTargetIndex_ = attributeAnimationTargets_.size();
+    attributeAnimationTargets_.emplace_back(animatable);
+}
+
+void Scene::RemoveAttributeAnimationTarget(Animatable* animatable)
+{
+    const unsigned index = animatable->attributeAnimationTargetIndex_;
+    if (index < attributeAnimationTargets_.size() && attributeAnimationTargets_[index] == animatable)
+    {
+        // Keep indices stable, target may be removed while targets are being updated
+        attributeAnimationTargets_[index] = nullptr;
+        attributeAnimationTargetsDirty_ = true;
+    }
+    animatable->attributeAnimationTargetIndex_ = M_MAX_UNSIGNED;
+}
+
+void Scene::UpdateAttributeAnimationTargets(float timeStep)
+{
+    URHO3D_PROFILE("UpdateAttributeAnimations");
+
+    // Targets added during update are updated next frame
+    const unsigned numTargets = attributeAnimationTargets_.size();
+    for (unsigned i = 0; i < numTargets; ++i)
+    {
+        Animatable* animatable = attributeAnimationTargets_[i];
+        if (animatable)
+            animatable->UpdateAttributeAnimations(timeStep);
+        else
+            attributeAnimationTargetsDirty_ = true;
+    }
+
+    if (!attributeAnimationTargetsDirty_)
+        return;
+
+    unsigned count = 0;
+    for (unsigned i = 0; i < attributeAnimationTargets_.size(); ++i)
+    {
+        Animatable* animatable = attributeAnimationTargets_[i];
+        if (!animatable)
+            continue;
+
+        animatable->attributeAnimationTargetIndex_ = count;
+        if (count != i)
+            attributeAnimationTargets_[count] = ea::move(attributeAnimationTargets_[i]);
+        ++count;
+    }
+    attributeAnimationTargets_.resize(count);
+    attributeAnimationTargetsDirty_ = false;
+}
+
 void Scene::BeginThreadedUpdate()
 {
     // Check the work queue subsystem whether it actually has created worker threads. If not, do not enter threaded mode.
@@ -906,6 +1245,10 @@ void Scene::EndThreadedUpdate()
             (*i)->OnMarkedDirty((*i)->GetNode());
         delayedDirtyComponents_.clear();
     }
+
+    for (Node* node : delayedDirtyTransformRoots_)
+        dirtyTransformRoots_.emplace_back(node);
+    delayedDirtyTransformRoots_.clear();
 }
 
 void Scene::DelayedMarkedDirty(Component* component)
@@ -914,6 +1257,81 @@ void Scene::DelayedMarkedDirty(Component* component)
     delayedDirtyComponents_.push_back(component);
 }
 
+void Scene::MarkTransformDirty(Node* node)
+{
+    // Nothing drains the queue while updates are disabled, so leave the nodes to lazy update instead
+    if (!updateEnabled_)
+        return;
+
+    // Weak references can not be created from worker threads, so keep raw pointers until the threaded update ends.
+    // Nodes are not destroyed during the threaded update
+    if (threadedUpdate_)
+    {
+        MutexLock lock(sceneMutex_);
+        delayedDirtyTransformRoots_.push_back(node);
+    }
+    else
+        dirtyTransformRoots_.emplace_back(node);
+}
+
+void Scene::UpdateTransforms()
+{
+    if (dirtyTransformRoots_.empty())
+        return;
+
+    URHO3D_PROFILE("UpdateTransforms");
+
+    // Skip expired and already updated roots. Roots whose parent became dirty later are covered by the parent hierarchy
+    transformUpdateLevel_.clear();
+    for (const WeakPtr<Node>& root : dirtyTransformRoots_)
+    {
+        Node* node = root.Get();
+        if (node && node->dirty_ && node->scene_ == this && node->parent_
+            && (node->parent_ == this || !node->parent_->dirty_))
+            transformUpdateLevel_.push_back(node);
+    }
+    dirtyTransformRoots_.clear();
+
+    // A node may be queued again if its transform was queried and then dirtied again
+    ea::sort(transformUpdateLevel_.begin(), transformUpdateLevel_.end());
+    transformUpdateLevel_.erase(ea::unique(transformUpdateLevel_.begin(), transformUpdateLevel_.end()),
+        transformUpdateLevel_.end());
+
+    auto* queue = GetSubsystem<WorkQueue>();
+    const bool threaded = queue && queue->GetNumThreads() > 0;
+
+    // Parents are always updated before children, so each node only reads the cached transform of its parent
+    while (!transformUpdateLevel_.empty())
+    {
+        const unsigned numNodes = transformUpdateLevel_.size();
+        if (threaded && numNodes >= TRANSFORM_UPDATE_THREADED_THRESHOLD)
+        {
+            queue->ParallelFor(numNodes, TRANSFORM_UPDATE_GRAIN_SIZE, [this](unsigned begin, unsigned end, unsigned)
+            {
+                for (unsigned i = begin; i < end; ++i)
+                    transformUpdateLevel_[i]->UpdateWorldTransform();
+            });
+            queue->Complete(M_MAX_UNSIGNED);
+        }
+        else
+        {
+            for (Node* node : transformUpdateLevel_)
+                node->UpdateWorldTransform();
+        }
+
+        nextTransformUpdateLevel_.clear();
+        for (Node* node : transformUpdateLevel_)
+        {
+            for (const SharedPtr<Node>& child : node->children_)
+            {
+                if (child->dirty_)
+                    nextTransformUpdateLevel_.push_back(child);
+            }
+        }
+        ea::swap(transformUpdateLevel_, nextTransformUpdateLevel_);
+    }
+}
+
 unsigned Scene::GetFreeNodeID(CreateMode mode)
 {
     if (mode == REPLICATED)
@@ -1124,7 +1542,7 @@ void Scene::ComponentAdded(Component* component)
     component->OnSceneSet(this);
 
     if (auto index = GetMutableComponentIndex(component->GetType()))
-        index->insert(component);
+        index->Insert(component);
 }
 
 void Scene::ComponentRemoved(Component* component)
@@ -1133,7 +1551,7 @@ void Scene::ComponentRemoved(Component* component)
         return;
 
     if (auto index = GetMutableComponentIndex(component->GetType()))
-        index->erase(component);
+        index->Erase(component);
 
     unsigned id = component->GetID();
     if (Scene::IsReplicatedID(id))
@@ -1242,13 +1660,12 @@ void Scene::MarkReplicationDirty(Node* node)
     }
 }
 
-void Scene::HandleUpdate(StringHash eventType, VariantMap& eventData)
+void Scene::HandleUpdate(UpdateEventArgs& args)
 {
     if (!updateEnabled_)
         return;
 
-    using namespace Update;
-    Update(eventData[P_TIMESTEP].GetFloat());
+    Update(args.timeStep_);
 }
 
 void Scene::HandleResourceBackgroundLoaded(StringHash eventType, VariantMap& eventData)
@@ -1263,6 +1680,10 @@ void Scene::HandleResourceBackgroundLoaded(StringHash eventType, VariantMap& eve
             asyncProgress_.resources_.erase(resource->GetNameHash());
             ++asyncProgress_.loadedResources_;
         }
+
+        // Dependencies are reported too, so the manifest covers everything the load reads
+        if (recordPrefetchManifest_ && eventData[P_SUCCESS].GetBool())
+            asyncProgress_.loadOrder_.push_back(resource->GetTypeName() + ";" + resource->GetName());
     }
 }
 
@@ -1285,9 +1706,20 @@ void Scene::UpdateAsyncLoading()
         }
 
 
-        // Read one child node with its full sub-hierarchy either from binary, JSON, or XML
+        // Read one child node with its full sub-hierarchy either from decoded data, binary, JSON, or XML
         /// \todo Works poorly in scenes where one root-level child node contains all content
-        if (asyncProgress_.xmlFile_)
+        if (!asyncProgress_.decodeItems_.empty())
+        {
+            // Wait until the batch of the next node has been decoded
+            const WorkItem* decodeItem = asyncProgress_.decodeItems_[asyncProgress_.loadedNodes_ / ASYNC_DECODE_BATCH_SIZE];
+            if (!decodeItem->completed_)
+                break;
+
+            DecodedNode& decodedNode = asyncProgress_.decodedNodes_[asyncProgress_.loadedNodes_];
+            CreateDecodedNode(this, decodedNode);
+            decodedNode = {};
+        }
+        else if (asyncProgress_.xmlFile_)
         {
             unsigned nodeID = asyncProgress_.xmlElement_.GetUInt("id");
             Node* newNode = CreateChild(nodeID, IsReplicatedID(nodeID) ? REPLICATED : LOCAL);
@@ -1333,8 +1765,102 @@ void Scene::UpdateAsyncLoading()
     SendEvent(E_ASYNCLOADPROGRESS, eventData);
 }
 
+void Scene::StartAsyncDecoding(ea::vector<XMLElement> xmlElements, ea::vector<const JSONValue*> jsonValues)
+{
+    URHO3D_PROFILE("StartAsyncDecoding");
+
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    const unsigned numNodes = xmlElements.empty() ? jsonValues.size() : xmlElements.size();
+    if (!workQueue || !numNodes)
+        return;
+
+    // Store the source of each root-level node, so that work items only need their own range
+    asyncProgress_.decodedNodes_.resize(numNodes);
+    for (unsigned i = 0; i < numNodes; ++i)
+    {
+        if (!xmlElements.empty())
+            asyncProgress_.decodedNodes_[i].xmlSource_ = xmlElements[i];
+        else
+            asyncProgress_.decodedNodes_[i].jsonSource_ = jsonValues[i];
+    }
+
+    Context* context = context_;
+    DecodedNode* decodedNodes = asyncProgress_.decodedNodes_.data();
+    for (unsigned start = 0; start < numNodes; start += ASYNC_DECODE_BATCH_SIZE)
+    {
+        const unsigned end = Min(start + ASYNC_DECODE_BATCH_SIZE, numNodes);
+        asyncProgress_.decodeItems_.push_back(workQueue->AddWorkItem([context, decodedNodes, start, end]()
+        {
+            for (unsigned i = start; i < end; ++i)
+            {
+                DecodedNode& decodedNode = decodedNodes[i];
+                if (decodedNode.jsonSource_)
+                    Node::DecodeHierarchyJSON(context, *decodedNode.jsonSource_, decodedNode);
+                else
+                {
+                    const XMLElement source = decodedNode.xmlSource_;
+                    Node::DecodeHierarchyXML(context, source, decodedNode);
+                }
+            }
+        }));
+    }
+}
+
+void Scene::StopAsyncDecoding()
+{
+    if (asyncProgress_.decodeItems_.empty())
+        return;
+
+    // Work items that already started reference the decoded nodes and the source file, so wait for them
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    for (const SharedPtr<WorkItem>& item : asyncProgress_.decodeItems_)
+    {
+        if (workQueue && !workQueue->RemoveWorkItem(item))
+            workQueue->CompleteItem(item);
+    }
+
+    asyncProgress_.decodeItems_.clear();
+    asyncProgress_.decodedNodes_.clear();
+}
+
+void Scene::CreateDecodedNode(Node* parent, const DecodedNode& decoded)
+{
+    const unsigned nodeID = decoded.id_;
+    Node* newNode = parent->CreateChild(nodeID, IsReplicatedID(nodeID) ? REPLICATED : LOCAL);
+    resolver_.AddNode(nodeID, newNode);
+
+    if (decoded.loadSource_)
+    {
+        if (decoded.jsonSource_)
+            newNode->LoadJSON(*decoded.jsonSource_, resolver_);
+        else
+            newNode->LoadXML(decoded.xmlSource_, resolver_);
+        return;
+    }
+
+    newNode->LoadDecoded(decoded.attributes_);
+
+    for (const DecodedComponent& decodedComponent : decoded.components_)
+    {
+        const unsigned compID = decodedComponent.id_;
+        Component* newComponent = newNode->SafeCreateComponent(decodedComponent.typeName_, decodedComponent.type_,
+            IsReplicatedID(compID) ? REPLICATED : LOCAL, compID);
+        if (!newComponent)
+            continue;
+
+        resolver_.AddComponent(compID, newComponent);
+        LoadDecodedComponent(newComponent, decodedComponent);
+    }
+
+    for (const DecodedNode& decodedChild : decoded.children_)
+        CreateDecodedNode(newNode, decodedChild);
+}
+
 void Scene::FinishAsyncLoading()
 {
+    if (recordPrefetchManifest_ && asyncProgress_.file_)
+        SavePrefetchManifest(asyncProgress_.file_->GetName());
+
     if (asyncProgress_.mode_ > LOAD_RESOURCES_ONLY)
     {
         resolver_.Resolve();
@@ -1372,6 +1898,92 @@ void Scene::FinishSaving(Serializer* dest) const
     }
 }
 
+void Scene::PreloadManifestResources(const ea::string& fileName)
+{
+    // If not threaded, can not background load resources, so rather load synchronously later when needed
+#ifdef URHO3D_THREADING
+    auto* cache = GetSubsystem<ResourceCache>();
+    const ea::string manifestName = fileName + PREFETCH_MANIFEST_EXTENSION;
+    if (!cache->Exists(manifestName))
+        return;
+
+    URHO3D_PROFILE("PreloadManifestResources");
+
+    SharedPtr<File> manifestFile = cache->GetFile(manifestName);
+    if (!manifestFile)
+        return;
+
+    struct ManifestEntry
+    {
+        ea::string type_;
+        ea::string name_;
+        unsigned package_;
+        unsigned offset_;
+    };
+
+    // Locate the resources in packages, so that they can be queued in the order they are stored
+    const ea::vector<SharedPtr<PackageFile>>& packages = cache->GetPackageFiles();
+    ea::vector<ManifestEntry> entries;
+    while (!manifestFile->IsEof())
+    {
+        const ea::string line = manifestFile->ReadLine();
+        const unsigned separator = line.find(';');
+        if (separator == ea::string::npos)
+            continue;
+
+        ManifestEntry entry{line.substr(0, separator), line.substr(separator + 1), M_MAX_UNSIGNED, 0};
+        for (unsigned i = 0; i < packages.size(); ++i)
+        {
+            if (const PackageEntry* packageEntry = packages[i]->GetEntry(entry.name_))
+            {
+                entry.package_ = i;
+                entry.offset_ = packageEntry->offset_;
+                break;
+            }
+        }
+        entries.push_back(entry);
+    }
+
+    // Resources outside packages keep the recorded order
+    const auto compareEntries = [](const ManifestEntry& lhs, const ManifestEntry& rhs)
+    {
+        return lhs.package_ != rhs.package_ ? lhs.package_ < rhs.package_ : lhs.offset_ < rhs.offset_;
+    };
+    ea::stable_sort(entries.begin(), entries.end(), compareEntries);
+
+    for (const ManifestEntry& entry : entries)
+    {
+        if (cache->BackgroundLoadResource(StringHash(entry.type_), entry.name_))
+        {
+            ++asyncProgress_.totalResources_;
+            asyncProgress_.resources_.insert(StringHash(entry.name_));
+        }
+    }
+#endif
+}
+
+void Scene::SavePrefetchManifest(const ea::string& fileName)
+{
+    if (asyncProgress_.loadOrder_.empty())
+        return;
+
+    // The manifest can only be written for scenes loaded from resource directories
+    auto* cache = GetSubsystem<ResourceCache>();
+    const ea::string fullName = cache->GetResourceFileName(fileName);
+    if (fullName.empty())
+    {
+        URHO3D_LOGWARNING("Can not save prefetch manifest for " + fileName + ", it is not in a resource directory");
+        return;
+    }
+
+    File manifestFile(context_, fullName + PREFETCH_MANIFEST_EXTENSION, FILE_WRITE);
+    if (!manifestFile.IsOpen())
+        return;
+
+    for (const ea::string& line : asyncProgress_.loadOrder_)
+        manifestFile.WriteLine(line);
+}
+
 void Scene::PreloadResources(File* file, bool isSceneFile)
 {
     // If not threaded, can not background load resources, so rather load synchronously later when needed
@@ -1626,12 +2238,14 @@ void RegisterSceneLibrary(Context* context)
 {
     ValueAnimation::RegisterObject(context);
     ObjectAnimation::RegisterObject(context);
+    PrefabResource::RegisterObject(context);
     Node::RegisterObject(context);
     Scene::RegisterObject(context);
     SmoothedTransform::RegisterObject(context);
     UnknownComponent::RegisterObject(context);
     SplinePath::RegisterObject(context);
     SceneManager::RegisterObject(context);
+    SceneChunkIndex::RegisterObject(context);
     CameraViewport::RegisterObject(context);
 }
 
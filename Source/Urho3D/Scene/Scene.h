@@ -27,7 +27,9 @@
 #include <EASTL/span.h>
 #include <EASTL/unique_ptr.h>
 
+#include "../Core/CoreEvents.h"
 #include "../Core/Mutex.h"
+#include "../Core/Signal.h"
 #include "../Resource/XMLElement.h"
 #include "../Resource/JSONFile.h"
 #include "../Scene/Node.h"
@@ -37,8 +39,11 @@ namespace Urho3D
 {
 
 class File;
+class LogicComponentScheduler;
 class PackageFile;
+class PrefabResource;
 class Texture2D;
+struct WorkItem;
 
 static const unsigned FIRST_REPLICATED_ID = 0x1;
 static const unsigned LAST_REPLICATED_ID = 0xffffff;
@@ -76,6 +81,8 @@ struct AsyncProgress
     LoadMode mode_;
     /// Resource name hashes left to load.
     ea::hash_set<StringHash> resources_;
+    /// Background loaded resources in completion order, as "Type;Name". Filled only when recording the prefetch manifest.
+    ea::vector<ea::string> loadOrder_;
     /// Loaded resources.
     unsigned loadedResources_;
     /// Total resources.
@@ -84,10 +91,75 @@ struct AsyncProgress
     unsigned loadedNodes_;
     /// Total root-level nodes.
     unsigned totalNodes_;
+    /// Root-level nodes decoded on worker threads in parallel loading mode.
+    ea::vector<DecodedNode> decodedNodes_;
+    /// Work items decoding root-level nodes, each covering a batch of them.
+    ea::vector<SharedPtr<WorkItem> > decodeItems_;
 };
 
-/// Index of components in the Scene.
-using SceneComponentIndex = ea::hash_set<Component*>;
+/// Dense index of components of one type in the Scene. Components are referenced from a contiguous array, removal
+/// moves the last component into the freed position. Components are not moved in memory, so pointers stay valid.
+/// Optional change journal records components added, removed and marked modified since the journal was cleared,
+/// so systems may process deltas instead of scanning the index. Journal lists are unordered.
+/// Removed components are kept alive until the journal is cleared, so their addresses are not reused by added components.
+class URHO3D_API SceneComponentIndex
+{
+public:
+    /// Iterator.
+    using ConstIterator = ea::vector<Component*>::const_iterator;
+
+    /// Add component.
+    void Insert(Component* component);
+    /// Remove component.
+    void Erase(Component* component);
+    /// Sort components by address, so iteration follows their order in memory.
+    void SortByAddress();
+    /// Mark component modified in the change journal.
+    void MarkModified(Component* component);
+
+    /// Set whether the change journal is recorded.
+    void SetJournalEnabled(bool enable);
+    /// Clear the change journal.
+    void ClearJournal();
+    /// Return whether the change journal is recorded.
+    bool IsJournalEnabled() const { return journalEnabled_; }
+    /// Return components added since the journal was cleared and still present.
+    const ea::vector<Component*>& GetAdded() const { return added_; }
+    /// Return components modified since the journal was cleared, excluding added ones.
+    const ea::vector<Component*>& GetModified() const { return modified_; }
+    /// Return components removed since the journal was cleared, excluding ones added after that. They are detached from the scene.
+    const ea::vector<SharedPtr<Component>>& GetRemoved() const { return removed_; }
+
+    /// Return begin iterator.
+    ConstIterator begin() const { return components_.begin(); }
+    /// Return end iterator.
+    ConstIterator end() const { return components_.end(); }
+    /// Return number of components.
+    unsigned size() const { return components_.size(); }
+    /// Return whether the index is empty.
+    bool empty() const { return components_.empty(); }
+    /// Return component by position.
+    Component* operator[](unsigned index) const { return components_[index]; }
+    /// Return whether the component is in the index.
+    bool contains(const Component* component) const;
+
+private:
+    /// Components.
+    ea::vector<Component*> components_;
+    /// Whether the change journal is recorded.
+    bool journalEnabled_{};
+    /// Added components.
+    ea::vector<Component*> added_;
+    /// Modified components.
+    ea::vector<Component*> modified_;
+    /// Removed components.
+    ea::vector<SharedPtr<Component>> removed_;
+
+    /// Add component to journal list.
+    static void AddToJournal(ea::vector<Component*>& list, Component* component);
+    /// Remove component from journal list by moving the last component into its position.
+    static void RemoveFromJournal(ea::vector<Component*>& list, Component* component);
+};
 
 /// Root scene node, represents the whole scene.
 class URHO3D_API Scene : public Node
@@ -106,14 +178,26 @@ public:
     /// Register object factory. Node must be registered first.
     static void RegisterObject(Context* context);
 
-    /// Create component index. Scene must be empty.
-    bool CreateComponentIndex(StringHash componentType);
-    /// Create component index for template type. Scene must be empty.
-    template <class T> void CreateComponentIndex() { CreateComponentIndex(T::GetTypeStatic()); }
+    /// Create component index, optionally with change journal. Scene must be empty.
+    bool CreateComponentIndex(StringHash componentType, bool journal = false);
+    /// Create component index for template type, optionally with change journal. Scene must be empty.
+    template <class T> void CreateComponentIndex(bool journal = false) { CreateComponentIndex(T::GetTypeStatic(), journal); }
     /// Return component index. Iterable. Invalidated when indexed component is added or removed!
     const SceneComponentIndex& GetComponentIndex(StringHash componentType);
     /// Return component index for template type. Invalidated when indexed component is added or removed!
     template <class T> const SceneComponentIndex& GetComponentIndex() { return GetComponentIndex(T::GetTypeStatic()); }
+    /// Sort component index by component address, so iteration follows memory order. Invalidates iteration.
+    void SortComponentIndex(StringHash componentType);
+    /// Clear change journal of component index.
+    void ClearComponentIndexJournal(StringHash componentType);
+    /// Mark component modified in the change journal of its component index, if any.
+    void MarkComponentModified(Component* component);
+    /// Invoke function for each indexed component of template type, in index order. Components must not be added or removed by the function.
+    template <class T, class F> void ForEachComponent(F function)
+    {
+        for (Component* component : GetComponentIndex(T::GetTypeStatic()))
+            function(static_cast<T*>(component));
+    }
 
     /// Serialize from/to archive. Return true if successful.
     bool Serialize(Archive& archive) override;
@@ -137,7 +221,11 @@ public:
     void ResetLightmaps();
     /// Add lightmap texture.
     void AddLightmap(const ea::string& lightmapTextureName);
-    /// Return lightmap texture.
+    /// Set whether lightmap textures are loaded in background on first use and released when not rendered for a while.
+    void SetStreamLightmaps(bool enable);
+    /// Return whether lightmap textures are streamed.
+    bool GetStreamLightmaps() const { return streamLightmaps_; }
+    /// Return lightmap texture. May return null while a streamed lightmap is being loaded.
     Texture2D* GetLightmapTexture(unsigned index);
 
     /// Load from an XML file. Return true if successful.
@@ -158,6 +246,10 @@ public:
     void StopAsyncLoading();
     /// Instantiate scene content from binary data. Return root node if successful.
     Node* Instantiate(Deserializer& source, const Vector3& position, const Quaternion& rotation, CreateMode mode = REPLICATED);
+    /// Instantiate a copy of a prefab node, its components and child nodes. The prefab may be a detached node that is kept as a template. Return root node if successful.
+    Node* Instantiate(Node* prefab, const Vector3& position, const Quaternion& rotation, CreateMode mode = REPLICATED);
+    /// Instantiate a prefab resource from its pre-decoded template. Return root node if successful.
+    Node* Instantiate(PrefabResource* prefab, const Vector3& position, const Quaternion& rotation, CreateMode mode = REPLICATED);
     /// Instantiate scene content from XML data. Return root node if successful.
     Node* InstantiateXML
         (const XMLElement& source, const Vector3& position, const Quaternion& rotation, CreateMode mode = REPLICATED);
@@ -183,6 +275,10 @@ public:
     void SetSnapThreshold(float threshold);
     /// Set maximum milliseconds per frame to spend on async scene loading.
     void SetAsyncLoadingMs(int ms);
+    /// Set whether async XML and JSON loads decode node hierarchies on worker threads. Nodes and components are still created on the main thread within the async loading time budget.
+    void SetParallelAsyncLoading(bool enable) { parallelAsyncLoading_ = enable; }
+    /// Set whether async loads record the order of loaded resources into a prefetch manifest next to the scene file. Later async loads of the scene queue the manifest resources first, in package offset order.
+    void SetRecordPrefetchManifest(bool enable) { recordPrefetchManifest_ = enable; }
     /// Add a required package file for networking. To be called on the server.
     void AddRequiredPackageFile(PackageFile* package);
     /// Clear required package files.
@@ -238,6 +334,10 @@ public:
 
     /// Return maximum milliseconds per frame to spend on async loading.
     int GetAsyncLoadingMs() const { return asyncLoadingMs_; }
+    /// Return whether async loads record the prefetch manifest.
+    bool GetRecordPrefetchManifest() const { return recordPrefetchManifest_; }
+    /// Return whether async XML and JSON loads decode node hierarchies on worker threads.
+    bool GetParallelAsyncLoading() const { return parallelAsyncLoading_; }
 
     /// Return required package files.
     const ea::vector<SharedPtr<PackageFile> >& GetRequiredPackageFiles() const { return requiredPackageFiles_; }
@@ -247,12 +347,20 @@ public:
 
     /// Update scene. Called by HandleUpdate.
     void Update(float timeStep);
+    /// Add object whose attribute animations are updated by the scene.
+    void AddAttributeAnimationTarget(Animatable* animatable);
+    /// Remove object whose attribute animations are updated by the scene.
+    void RemoveAttributeAnimationTarget(Animatable* animatable);
     /// Begin a threaded update. During threaded update components can choose to delay dirty processing.
     void BeginThreadedUpdate();
     /// End a threaded update. Notify components that marked themselves for delayed dirty processing.
     void EndThreadedUpdate();
     /// Add a component to the delayed dirty notify queue. Is thread-safe.
     void DelayedMarkedDirty(Component* component);
+    /// Queue a node whose transform became dirty under a clean parent for the transform update pass. Ignored while updates are disabled. Is thread-safe during threaded update.
+    void MarkTransformDirty(Node* node);
+    /// Recalculate world transforms of all queued dirty hierarchies level by level, in worker threads if available. Called by Update.
+    void UpdateTransforms();
 
     /// Return threaded update flag.
     bool IsThreadedUpdate() const { return threadedUpdate_; }
@@ -292,19 +400,39 @@ public:
     /// Mark a node dirty in scene replication states. The node does not need to have own replication state yet.
     void MarkReplicationDirty(Node* node);
 
+    /// Return scheduler of logic component updates.
+    LogicComponentScheduler* GetLogicComponentScheduler() const { return logicComponentScheduler_; }
+
+    /// Typed scene update signal, invoked before E_SCENEUPDATE. Logic components are updated just before it, so both run before all E_SCENEUPDATE subscribers regardless of the subscription order.
+    Signal<UpdateEventArgs, Scene> onSceneUpdate_;
+    /// Typed scene post-update signal, invoked before E_SCENEPOSTUPDATE and all its subscribers.
+    Signal<UpdateEventArgs, Scene> onScenePostUpdate_;
+
 private:
-    /// Handle the logic update event to update the scene, if active.
-    void HandleUpdate(StringHash eventType, VariantMap& eventData);
+    /// Handle the logic update signal to update the scene, if active.
+    void HandleUpdate(UpdateEventArgs& args);
     /// Handle a background loaded resource completing.
     void HandleResourceBackgroundLoaded(StringHash eventType, VariantMap& eventData);
     /// Update asynchronous loading.
     void UpdateAsyncLoading();
+    /// Update attribute animations of all animated objects.
+    void UpdateAttributeAnimationTargets(float timeStep);
     /// Finish asynchronous loading.
     void FinishAsyncLoading();
+    /// Start decoding root-level child nodes of the async load on worker threads.
+    void StartAsyncDecoding(ea::vector<XMLElement> xmlElements, ea::vector<const JSONValue*> jsonValues);
+    /// Cancel or wait for the work items decoding the async load.
+    void StopAsyncDecoding();
+    /// Create child node from decoded data.
+    void CreateDecodedNode(Node* parent, const DecodedNode& decoded);
     /// Finish loading. Sets the scene filename and checksum.
     void FinishLoading(Deserializer* source);
     /// Finish saving. Sets the scene filename and checksum.
     void FinishSaving(Serializer* dest) const;
+    /// Preload resources listed in the prefetch manifest of the scene or object prefab file, if it exists.
+    void PreloadManifestResources(const ea::string& fileName);
+    /// Save the prefetch manifest recorded during async loading next to the scene or object prefab file.
+    void SavePrefetchManifest(const ea::string& fileName);
     /// Preload resources from a binary scene or object prefab file.
     void PreloadResources(File* file, bool isSceneFile);
     /// Preload resources from an XML scene or object prefab file.
@@ -315,6 +443,8 @@ private:
     SceneComponentIndex* GetMutableComponentIndex(StringHash componentType);
     /// Mark lightmap textures dirty.
     void MarkLightmapTexturesDirty() { lightmapTexturesDirty_ = true; }
+    /// Release streamed lightmap textures that were not rendered recently.
+    void ReleaseUnusedLightmaps();
 
     /// Types of components that should be indexed.
     ea::vector<StringHash> indexedComponentTypes_;
@@ -347,10 +477,24 @@ private:
     ea::hash_set<unsigned> networkUpdateComponents_;
     /// Delayed dirty notification queue for components.
     ea::vector<Component*> delayedDirtyComponents_;
+    /// Objects with attribute animations. Removed objects leave null entries which are compacted after update.
+    ea::vector<WeakPtr<Animatable>> attributeAnimationTargets_;
+    /// Whether attribute animation targets contain null entries.
+    bool attributeAnimationTargetsDirty_{};
     /// Mutex for the delayed dirty notification queue.
     Mutex sceneMutex_;
+    /// Roots of dirty node hierarchies queued for the transform update pass.
+    ea::vector<WeakPtr<Node> > dirtyTransformRoots_;
+    /// Roots of dirty node hierarchies queued during threaded update, guarded by the scene mutex.
+    ea::vector<Node*> delayedDirtyTransformRoots_;
+    /// Nodes of the hierarchy level currently processed by the transform update pass.
+    ea::vector<Node*> transformUpdateLevel_;
+    /// Nodes of the next hierarchy level in the transform update pass.
+    ea::vector<Node*> nextTransformUpdateLevel_;
     /// Preallocated event data map for smoothing update events.
     VariantMap smoothingData_;
+    /// Scheduler of logic component updates.
+    SharedPtr<LogicComponentScheduler> logicComponentScheduler_;
     /// Next free non-local node ID.
     unsigned replicatedNodeID_;
     /// Next free non-local component ID.
@@ -375,6 +519,10 @@ private:
     bool updateEnabled_;
     /// Asynchronous loading flag.
     bool asyncLoading_;
+    /// Prefetch manifest recording flag.
+    bool recordPrefetchManifest_{};
+    /// Parallel async loading flag.
+    bool parallelAsyncLoading_{};
     /// Threaded update flag.
     bool threadedUpdate_;
 
@@ -384,6 +532,10 @@ private:
     bool lightmapTexturesDirty_{ false };
     /// Loaded lightmap textures.
     ea::vector<SharedPtr<Texture2D>> lightmapTextures_;
+    /// Whether the lightmap textures are streamed.
+    bool streamLightmaps_{};
+    /// Frame numbers when the streamed lightmap textures were last used.
+    ea::vector<unsigned> lightmapLastUsedFrames_;
 };
 
 /// Register Scene library objects.
@@ -0,0 +1,174 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../IO/Deserializer.h"
+#include "../IO/File.h"
+#include "../IO/FileSystem.h"
+#include "../IO/Log.h"
+#include "../IO/Serializer.h"
+#include "../IO/VectorBuffer.h"
+#include "../Scene/Node.h"
+#include "../Scene/SceneChunkIndex.h"
+
+#include <EASTL/sort.h>
+#include <EASTL/unordered_map.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Save nodes as children of an empty root node in the binary format of Node::Save.
+bool SaveChunkNodes(Context* context, Serializer& dest, const ea::vector<Node*>& nodes)
+{
+    auto root = MakeShared<Node>(context);
+    if (!dest.WriteUInt(root->GetID()) || !root->Animatable::Save(dest))
+        return false;
+
+    dest.WriteVLE(0);
+    dest.WriteVLE(nodes.size());
+    for (Node* node : nodes)
+    {
+        if (!node->Save(dest))
+            return false;
+    }
+    return true;
+}
+
+}
+
+SceneChunkIndex::SceneChunkIndex(Context* context) :
+    Resource(context)
+{
+}
+
+SceneChunkIndex::~SceneChunkIndex() = default;
+
+void SceneChunkIndex::RegisterObject(Context* context)
+{
+    context->RegisterFactory<SceneChunkIndex>();
+}
+
+bool SceneChunkIndex::BeginLoad(Deserializer& source)
+{
+    chunks_.clear();
+
+    if (source.ReadFileID() != "UCHI")
+    {
+        URHO3D_LOGERROR(source.GetName() + " is not a valid scene chunk index");
+        return false;
+    }
+
+    chunkSize_ = source.ReadVector3();
+    chunks_.resize(source.ReadVLE());
+    for (SceneChunkDesc& chunk : chunks_)
+    {
+        chunk.coord_ = source.ReadIntVector3();
+        chunk.bounds_ = source.ReadBoundingBox();
+        chunk.numNodes_ = source.ReadVLE();
+        chunk.resourceName_ = source.ReadString();
+    }
+
+    SetMemoryUse(sizeof(SceneChunkIndex) + chunks_.size() * sizeof(SceneChunkDesc));
+    return true;
+}
+
+bool SceneChunkIndex::Save(Serializer& dest) const
+{
+    if (!dest.WriteFileID("UCHI"))
+    {
+        URHO3D_LOGERROR("Could not save scene chunk index, writing to stream failed");
+        return false;
+    }
+
+    dest.WriteVector3(chunkSize_);
+    dest.WriteVLE(chunks_.size());
+    for (const SceneChunkDesc& chunk : chunks_)
+    {
+        dest.WriteIntVector3(chunk.coord_);
+        dest.WriteBoundingBox(chunk.bounds_);
+        dest.WriteVLE(chunk.numNodes_);
+        dest.WriteString(chunk.resourceName_);
+    }
+    return true;
+}
+
+bool SceneChunkIndex::Build(const ea::vector<Node*>& nodes, const Vector3& chunkSize, const ea::string& outputDirectory,
+    const ea::string& resourceDirectory)
+{
+    if (chunkSize.x_ <= 0.0f || chunkSize.y_ <= 0.0f || chunkSize.z_ <= 0.0f)
+    {
+        URHO3D_LOGERROR("Scene chunk size must be positive");
+        return false;
+    }
+
+    chunkSize_ = chunkSize;
+    chunks_.clear();
+
+    ea::unordered_map<IntVector3, ea::vector<Node*>> cells;
+    for (Node* node : nodes)
+    {
+        if (node && !node->IsTemporary())
+            cells[VectorFloorToInt(node->GetWorldPosition() / chunkSize_)].push_back(node);
+    }
+
+    for (const auto& [coord, cellNodes] : cells)
+    {
+        SceneChunkDesc& chunk = chunks_.push_back();
+        chunk.coord_ = coord;
+        chunk.numNodes_ = cellNodes.size();
+        for (Node* node : cellNodes)
+            chunk.bounds_.Merge(node->GetWorldPosition());
+
+        const ea::string fileName = Format("Chunk_{}_{}_{}.bin", coord.x_, coord.y_, coord.z_);
+        chunk.resourceName_ = AddTrailingSlash(resourceDirectory) + fileName;
+
+        File file(context_, AddTrailingSlash(outputDirectory) + fileName, FILE_WRITE);
+        if (!file.IsOpen() || !SaveChunkNodes(context_, file, cellNodes))
+        {
+            URHO3D_LOGERROR("Could not save scene chunk " + file.GetName());
+            return false;
+        }
+    }
+
+    // Keep the index deterministic
+    ea::sort(chunks_.begin(), chunks_.end(), [](const SceneChunkDesc& lhs, const SceneChunkDesc& rhs)
+    {
+        return ea::tie(lhs.coord_.z_, lhs.coord_.y_, lhs.coord_.x_) < ea::tie(rhs.coord_.z_, rhs.coord_.y_, rhs.coord_.x_);
+    });
+    return true;
+}
+
+BoundingBox SceneChunkIndex::GetCellBounds(const IntVector3& coord) const
+{
+    const Vector3 min = Vector3(coord) * chunkSize_;
+    return { min, min + chunkSize_ };
+}
+
+}
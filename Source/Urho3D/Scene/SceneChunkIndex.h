@@ -0,0 +1,89 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+/// \file
+
+#pragma once
+
+#include "../Math/BoundingBox.h"
+#include "../Math/Vector3.h"
+#include "../Resource/Resource.h"
+
+namespace Urho3D
+{
+
+class Node;
+
+/// Description of scene chunk: nodes of one grid cell stored as separate prefab resource.
+struct SceneChunkDesc
+{
+    /// Grid cell coordinate.
+    IntVector3 coord_;
+    /// Bounding box of the node positions.
+    BoundingBox bounds_;
+    /// Number of nodes in the chunk.
+    unsigned numNodes_{};
+    /// Name of the prefab resource with chunk nodes.
+    ea::string resourceName_;
+};
+
+/// Index of chunked binary scene. Top-level nodes are partitioned by position into a grid. Each cell is saved
+/// as binary PrefabResource whose root holds the nodes of the cell with their children and components, so the cell
+/// may be loaded in background and instantiated as a unit. References between nodes of different chunks are not kept.
+class URHO3D_API SceneChunkIndex : public Resource
+{
+    URHO3D_OBJECT(SceneChunkIndex, Resource);
+
+public:
+    /// Construct.
+    explicit SceneChunkIndex(Context* context);
+    /// Destruct.
+    ~SceneChunkIndex() override;
+    /// Register object factory.
+    static void RegisterObject(Context* context);
+
+    /// Load resource from stream. May be called from a worker thread. Return true if successful.
+    bool BeginLoad(Deserializer& source) override;
+    /// Save resource. Return true if successful.
+    bool Save(Serializer& dest) const override;
+
+    /// Partition the nodes into grid cells and save each non-empty cell into the output directory.
+    /// Chunk resource names are the file names prefixed with resource directory. Return true if successful.
+    bool Build(const ea::vector<Node*>& nodes, const Vector3& chunkSize, const ea::string& outputDirectory,
+        const ea::string& resourceDirectory);
+
+    /// Return chunk size.
+    const Vector3& GetChunkSize() const { return chunkSize_; }
+    /// Return chunks.
+    const ea::vector<SceneChunkDesc>& GetChunks() const { return chunks_; }
+    /// Return bounding box of the grid cell.
+    BoundingBox GetCellBounds(const IntVector3& coord) const;
+
+private:
+    /// Size of grid cell.
+    Vector3 chunkSize_{ Vector3::ONE };
+    /// Chunks.
+    ea::vector<SceneChunkDesc> chunks_;
+};
+
+}
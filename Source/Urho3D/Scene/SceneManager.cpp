@@ -21,13 +21,19 @@
 //
 
 #include "../Core/Context.h"
+#include "../Core/CoreEvents.h"
+#include "../Core/Profiler.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Octree.h"
 #include "../Graphics/Renderer.h"
 #include "../Graphics/RenderSurface.h"
 #include "../IO/Log.h"
+#include "../Resource/ResourceCache.h"
+#include "../Resource/ResourceEvents.h"
 #include "../Scene/CameraViewport.h"
+#include "../Scene/PrefabResource.h"
 #include "../Scene/Scene.h"
+#include "../Scene/SceneChunkIndex.h"
 #include "../Scene/SceneEvents.h"
 #include "../Scene/SceneManager.h"
 
@@ -38,6 +44,32 @@ namespace Urho3D
 SceneManager::SceneManager(Context* context)
     : Object(context)
 {
+    SubscribeToEvent(E_UPDATE, [this](StringHash, VariantMap&)
+    {
+        UpdateStreaming();
+        UpdateViewportChanges();
+    });
+    SubscribeToEvent(E_RESOURCEBACKGROUNDLOADED, [this](StringHash, VariantMap& eventData)
+    {
+        using namespace ResourceBackgroundLoaded;
+        if (eventData[P_SUCCESS].GetBool())
+            return;
+
+        // Successfully loaded chunks are picked up on update
+        const ea::string& resourceName = eventData[P_RESOURCENAME].GetString();
+        for (SceneStreamingState& streaming : streaming_)
+        {
+            const ea::vector<SceneChunkDesc>& chunks = streaming.index_->GetChunks();
+            for (unsigned i = 0; i < chunks.size(); ++i)
+            {
+                if (streaming.chunks_[i].state_ == SceneChunkState::Loading && chunks[i].resourceName_ == resourceName)
+                {
+                    URHO3D_LOGERROR("Could not load scene chunk '{}'", resourceName);
+                    streaming.chunks_[i].state_ = SceneChunkState::Failed;
+                }
+            }
+        }
+    });
 }
 
 void SceneManager::RegisterObject(Context* context)
@@ -54,7 +86,7 @@ Scene* SceneManager::CreateScene(const ea::string& name)
     }
     SharedPtr<Scene> scene(context_->CreateObject<Scene>());
     scene->SetName(name);
-    scene->CreateComponentIndex<CameraViewport>();
+    scene->CreateComponentIndex<CameraViewport>(true);
     scene->GetOrCreateComponent<Octree>();
     scenes_.push_back(scene);
     return scene;
@@ -141,6 +173,173 @@ void SceneManager::SetRenderSurface(RenderSurface* surface)
     UpdateViewports();
 }
 
+void SceneManager::SetStreamingChunks(Scene* scene, SceneChunkIndex* index)
+{
+    if (!scene)
+        return;
+
+    auto iter = ea::find_if(streaming_.begin(), streaming_.end(),
+        [scene](const SceneStreamingState& streaming) { return streaming.scene_ == scene; });
+    if (iter != streaming_.end())
+    {
+        if (iter->index_ == index)
+            return;
+
+        StopStreaming(*iter);
+        streaming_.erase(iter);
+    }
+
+    if (!index)
+        return;
+
+    SceneStreamingState& streaming = streaming_.push_back();
+    streaming.scene_ = scene;
+    streaming.index_ = index;
+    streaming.chunks_.resize(index->GetChunks().size());
+}
+
+void SceneManager::AddStreamingAnchor(Node* anchor)
+{
+    if (anchor && !streamingAnchors_.contains(WeakPtr<Node>(anchor)))
+        streamingAnchors_.emplace_back(anchor);
+}
+
+void SceneManager::RemoveStreamingAnchor(Node* anchor)
+{
+    streamingAnchors_.erase_first(WeakPtr<Node>(anchor));
+}
+
+void SceneManager::SetStreamingDistance(float loadDistance, float unloadDistance)
+{
+    loadDistance_ = Max(loadDistance, 0.0f);
+    unloadDistance_ = Max(unloadDistance, loadDistance_);
+}
+
+void SceneManager::UpdateStreaming()
+{
+    if (streaming_.empty())
+        return;
+
+    URHO3D_PROFILE("UpdateSceneStreaming");
+
+    // Forget expired scenes and anchors
+    ea::erase_if(streaming_, [](const SceneStreamingState& streaming) { return !streaming.scene_; });
+    ea::erase_if(streamingAnchors_, [](const WeakPtr<Node>& anchor) { return !anchor; });
+
+    auto* cache = context_->GetSubsystem<ResourceCache>();
+    unsigned chunksBudget = maxChunksPerFrame_;
+    ea::vector<Vector3> anchorPositions;
+    for (SceneStreamingState& streaming : streaming_)
+    {
+        Scene* scene = streaming.scene_;
+        anchorPositions.clear();
+        for (Node* anchor : streamingAnchors_)
+        {
+            if (anchor->GetScene() == scene)
+                anchorPositions.push_back(anchor->GetWorldPosition());
+        }
+
+        const ea::vector<SceneChunkDesc>& chunks = streaming.index_->GetChunks();
+        for (unsigned i = 0; i < chunks.size(); ++i)
+        {
+            const SceneChunkDesc& desc = chunks[i];
+            SceneStreamingChunk& chunk = streaming.chunks_[i];
+
+            const BoundingBox cellBounds = streaming.index_->GetCellBounds(desc.coord_);
+            float distance = M_INFINITY;
+            for (const Vector3& position : anchorPositions)
+                distance = Min(distance, cellBounds.DistanceToPoint(position));
+
+            switch (chunk.state_)
+            {
+            case SceneChunkState::Unloaded:
+                if (distance <= loadDistance_)
+                {
+                    // Returns false if the resource is already loaded, it is picked up below
+                    cache->BackgroundLoadResource<PrefabResource>(desc.resourceName_, true, nullptr);
+                    chunk.state_ = SceneChunkState::Loading;
+                }
+                break;
+
+            case SceneChunkState::Loading:
+                if (PrefabResource* prefab = cache->GetExistingResource<PrefabResource>(desc.resourceName_))
+                {
+                    if (distance > unloadDistance_)
+                    {
+                        cache->ReleaseResource<PrefabResource>(desc.resourceName_);
+                        chunk.state_ = SceneChunkState::Unloaded;
+                    }
+                    else if (chunksBudget > 0)
+                    {
+                        --chunksBudget;
+                        chunk.node_ = scene->Instantiate(prefab, Vector3::ZERO, Quaternion::IDENTITY);
+                        if (chunk.node_)
+                        {
+                            chunk.node_->SetTemporary(true);
+                            chunk.state_ = SceneChunkState::Loaded;
+                        }
+                        else
+                            chunk.state_ = SceneChunkState::Failed;
+
+                        // The chunk is loaded again from the file next time
+                        cache->ReleaseResource<PrefabResource>(desc.resourceName_);
+                    }
+                }
+                break;
+
+            case SceneChunkState::Loaded:
+                if (distance > unloadDistance_ || !chunk.node_)
+                {
+                    if (chunk.node_)
+                        chunk.node_->Remove();
+                    chunk.node_ = nullptr;
+                    chunk.state_ = SceneChunkState::Unloaded;
+                }
+                break;
+
+            case SceneChunkState::Failed:
+                break;
+            }
+        }
+    }
+}
+
+unsigned SceneManager::GetNumLoadedChunks(Scene* scene) const
+{
+    for (const SceneStreamingState& streaming : streaming_)
+    {
+        if (streaming.scene_ == scene)
+        {
+            return ea::count_if(streaming.chunks_.begin(), streaming.chunks_.end(),
+                [](const SceneStreamingChunk& chunk) { return chunk.state_ == SceneChunkState::Loaded; });
+        }
+    }
+    return 0;
+}
+
+void SceneManager::StopStreaming(SceneStreamingState& streaming)
+{
+    for (SceneStreamingChunk& chunk : streaming.chunks_)
+    {
+        if (chunk.node_)
+            chunk.node_->Remove();
+    }
+    streaming.chunks_.clear();
+}
+
+void SceneManager::UpdateViewportChanges()
+{
+    // Viewports of the active scene are set up again when camera viewports are added or removed. Journals of the
+    // other scenes are cleared as well, as they are fully set up on activation anyway
+    for (Scene* scene : scenes_)
+    {
+        const SceneComponentIndex& viewportComponents = scene->GetComponentIndex<CameraViewport>();
+        if (scene == activeScene_ && (!viewportComponents.GetAdded().empty() || !viewportComponents.GetRemoved().empty()))
+            UpdateViewports();
+        scene->ClearComponentIndexJournal(CameraViewport::GetTypeStatic());
+    }
+}
+
 void SceneManager::UpdateViewports()
 {
     if (renderSurface_.Expired())
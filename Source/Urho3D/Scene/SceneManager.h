@@ -29,8 +29,40 @@
 namespace Urho3D
 {
 
+class Node;
+class PrefabResource;
 class RenderSurface;
 class Scene;
+class SceneChunkIndex;
+
+/// Streaming state of scene chunk.
+enum class SceneChunkState
+{
+    Unloaded,
+    Loading,
+    Loaded,
+    Failed
+};
+
+/// Scene chunk managed by SceneManager.
+struct SceneStreamingChunk
+{
+    /// State.
+    SceneChunkState state_{};
+    /// Root node of instantiated chunk.
+    WeakPtr<Node> node_;
+};
+
+/// Chunked scene streamed by SceneManager.
+struct SceneStreamingState
+{
+    /// Scene.
+    WeakPtr<Scene> scene_;
+    /// Chunk index.
+    SharedPtr<SceneChunkIndex> index_;
+    /// Chunks, in the order of the index.
+    ea::vector<SceneStreamingChunk> chunks_;
+};
 
 class URHO3D_API SceneManager : public Object
 {
@@ -64,9 +96,34 @@ class URHO3D_API SceneManager : public Object
     /// Set surface to which active scene should render. If surface is null then scene will render to main window.
     void SetRenderSurface(RenderSurface* surface);
 
+    /// Set chunk index streamed into the scene around streaming anchors. Null index unloads all chunks of the scene.
+    void SetStreamingChunks(Scene* scene, SceneChunkIndex* index);
+    /// Add streaming anchor. Chunks are streamed into the scene of the anchor node.
+    void AddStreamingAnchor(Node* anchor);
+    /// Remove streaming anchor.
+    void RemoveStreamingAnchor(Node* anchor);
+    /// Set distances from anchors to chunk cells at which chunks are loaded and unloaded.
+    void SetStreamingDistance(float loadDistance, float unloadDistance);
+    /// Set max number of chunks instantiated per frame.
+    void SetMaxChunksPerFrame(unsigned count) { maxChunksPerFrame_ = count; }
+    /// Update streamed chunks. Called automatically on update.
+    void UpdateStreaming();
+    /// Return number of chunks instantiated in the scene.
+    unsigned GetNumLoadedChunks(Scene* scene) const;
+    /// Return chunk load distance.
+    float GetLoadDistance() const { return loadDistance_; }
+    /// Return chunk unload distance.
+    float GetUnloadDistance() const { return unloadDistance_; }
+    /// Return max number of chunks instantiated per frame.
+    unsigned GetMaxChunksPerFrame() const { return maxChunksPerFrame_; }
+
 protected:
     /// Creates and sets up viewports for scene rendering.
     void UpdateViewports();
+    /// Set up viewports again if camera viewports were added to or removed from the active scene, and clear the journals.
+    void UpdateViewportChanges();
+    /// Unload instantiated chunks and stop streaming.
+    void StopStreaming(SceneStreamingState& streaming);
 
     /// Current loaded scenes.
     ea::vector<SharedPtr<Scene>> scenes_;
@@ -74,6 +131,16 @@ protected:
     WeakPtr<Scene> activeScene_;
     /// Surface for rendering active scene into.
     WeakPtr<RenderSurface> renderSurface_;
+    /// Streamed chunked scenes.
+    ea::vector<SceneStreamingState> streaming_;
+    /// Nodes around which chunks are streamed.
+    ea::vector<WeakPtr<Node>> streamingAnchors_;
+    /// Chunk load distance.
+    float loadDistance_{ 100.0f };
+    /// Chunk unload distance.
+    float unloadDistance_{ 150.0f };
+    /// Max number of chunks instantiated per frame.
+    unsigned maxChunksPerFrame_{ 1 };
 };
 
 }
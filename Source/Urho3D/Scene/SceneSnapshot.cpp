@@ -0,0 +1,347 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Core/Profiler.h"
+#include "../IO/BinaryArchive.h"
+#include "../IO/Log.h"
+#include "../IO/MemoryBuffer.h"
+#include "../IO/VectorBuffer.h"
+#include "../Scene/Component.h"
+#include "../Scene/Scene.h"
+#include "../Scene/SceneSnapshot.h"
+
+#include <EASTL/unordered_map.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Snapshot format version.
+static const unsigned SNAPSHOT_FORMAT_VERSION = 1;
+
+/// Location of attribute value in snapshot data.
+struct SnapshotValueRange
+{
+    /// Attribute index.
+    unsigned index_{};
+    /// Offset of value data.
+    unsigned offset_{};
+    /// Size of value data.
+    unsigned size_{};
+};
+
+/// Snapshot values by object key.
+using SnapshotValueIndex = ea::unordered_map<unsigned long long, ea::vector<SnapshotValueRange>>;
+
+/// Return object key in snapshot. Node and component IDs are allocated independently.
+unsigned long long GetObjectKey(bool isNode, unsigned id)
+{
+    return (static_cast<unsigned long long>(isNode) << 32u) | id;
+}
+
+/// Read snapshot header. Return true if valid.
+bool ReadHeader(Deserializer& source, unsigned& version, unsigned& baseVersion, unsigned& numObjects)
+{
+    if (source.ReadFileID() != "USSN" || source.ReadUInt() != SNAPSHOT_FORMAT_VERSION)
+        return false;
+
+    version = source.ReadUInt();
+    baseVersion = source.ReadUInt();
+    numObjects = source.ReadVLE();
+    return !source.IsEof() || numObjects == 0;
+}
+
+/// Index values of the snapshot data.
+void IndexValues(const ByteVector& data, SnapshotValueIndex& index)
+{
+    MemoryBuffer source(data);
+    unsigned version{};
+    unsigned baseVersion{};
+    unsigned numObjects{};
+    if (!ReadHeader(source, version, baseVersion, numObjects))
+        return;
+
+    for (unsigned i = 0; i < numObjects && !source.IsEof(); ++i)
+    {
+        const bool isNode = source.ReadBool();
+        const unsigned id = source.ReadUInt();
+        ea::vector<SnapshotValueRange>& values = index[GetObjectKey(isNode, id)];
+        values.resize(source.ReadVLE());
+        for (SnapshotValueRange& value : values)
+        {
+            value.index_ = source.ReadVLE();
+            value.size_ = source.ReadVLE();
+            value.offset_ = source.GetPosition();
+            source.Seek(value.offset_ + value.size_);
+        }
+    }
+}
+
+/// Capture values of the object. Return number of values written.
+unsigned CaptureObject(Serializable* object, AttributeModeFlags mask, BinaryOutputArchive& archive,
+    VectorBuffer& valueBuffer, const ea::vector<SnapshotValueRange>* baseValues, const ByteVector* baseData,
+    VectorBuffer& dest)
+{
+    const ea::vector<AttributeInfo>* attributes = object->GetAttributes();
+    if (!attributes)
+        return 0;
+
+    unsigned numValues = 0;
+    Variant value;
+    for (unsigned i = 0; i < attributes->size(); ++i)
+    {
+        const AttributeInfo& attr = attributes->at(i);
+        if (!(attr.mode_ & mask) || (attr.mode_ & AM_READONLY))
+            continue;
+
+        valueBuffer.Clear();
+        if (object->HasDirectAttributeAccess(attr))
+        {
+            if (!attr.accessor_->Serialize(object, archive, "value"))
+                continue;
+        }
+        else
+        {
+            object->OnGetAttribute(attr, value);
+            if (value.GetType() != attr.type_)
+                continue;
+            valueBuffer.WriteVariantData(value);
+        }
+
+        const unsigned size = valueBuffer.GetSize();
+        if (baseValues)
+        {
+            const auto iter = ea::find_if(baseValues->begin(), baseValues->end(),
+                [i](const SnapshotValueRange& range) { return range.index_ == i; });
+            if (iter != baseValues->end() && iter->size_ == size
+                && (size == 0 || memcmp(baseData->data() + iter->offset_, valueBuffer.GetData(), size) == 0))
+                continue;
+        }
+
+        dest.WriteVLE(i);
+        dest.WriteVLE(size);
+        dest.Write(valueBuffer.GetData(), size);
+        ++numValues;
+    }
+    return numValues;
+}
+
+}
+
+bool SceneSnapshot::Capture(Scene* scene, unsigned version, AttributeModeFlags mask)
+{
+    return CaptureInternal(scene, version, nullptr, mask);
+}
+
+bool SceneSnapshot::CaptureDelta(Scene* scene, unsigned version, const SceneSnapshot& base, AttributeModeFlags mask)
+{
+    if (base.IsDelta() || base.data_.empty())
+    {
+        URHO3D_LOGERROR("Base of delta scene snapshot must be full snapshot");
+        return false;
+    }
+
+    return CaptureInternal(scene, version, &base, mask);
+}
+
+bool SceneSnapshot::CaptureInternal(Scene* scene, unsigned version, const SceneSnapshot* base, AttributeModeFlags mask)
+{
+    if (!scene)
+        return false;
+
+    URHO3D_PROFILE("CaptureSceneSnapshot");
+
+    SnapshotValueIndex baseIndex;
+    if (base)
+        IndexValues(base->data_, baseIndex);
+
+    ea::vector<Node*> nodes;
+    nodes.push_back(scene);
+    scene->GetChildren(nodes, true);
+
+    // Values are serialized into the scratch buffer first to know their size
+    VectorBuffer body;
+    VectorBuffer objectBuffer;
+    VectorBuffer valueBuffer;
+    BinaryOutputArchive archive(scene->GetContext(), valueBuffer);
+    ArchiveBlock block = archive.OpenSequentialBlock("snapshot");
+
+    unsigned numObjects = 0;
+    const auto captureObject = [&](Serializable* object, bool isNode, unsigned id)
+    {
+        const ea::vector<SnapshotValueRange>* baseValues = nullptr;
+        if (base)
+        {
+            const auto iter = baseIndex.find(GetObjectKey(isNode, id));
+            if (iter != baseIndex.end())
+                baseValues = &iter->second;
+        }
+
+        objectBuffer.Clear();
+        const unsigned numValues = CaptureObject(object, mask, archive, valueBuffer, baseValues,
+            base ? &base->data_ : nullptr, objectBuffer);
+
+        // Full snapshot keeps all objects, so they are known to the delta snapshots
+        if (numValues == 0 && base)
+            return;
+
+        body.WriteBool(isNode);
+        body.WriteUInt(id);
+        body.WriteVLE(numValues);
+        body.Write(objectBuffer.GetData(), objectBuffer.GetSize());
+        ++numObjects;
+    };
+
+    for (Node* node : nodes)
+    {
+        if (node->IsTemporary())
+            continue;
+
+        captureObject(node, true, node->GetID());
+        for (Component* component : node->GetComponents())
+        {
+            if (!component->IsTemporary())
+                captureObject(component, false, component->GetID());
+        }
+    }
+
+    if (archive.HasError())
+    {
+        URHO3D_LOGERROR("Could not capture scene snapshot: {}", archive.GetErrorString());
+        return false;
+    }
+
+    VectorBuffer dest;
+    dest.WriteFileID("USSN");
+    dest.WriteUInt(SNAPSHOT_FORMAT_VERSION);
+    dest.WriteUInt(version);
+    dest.WriteUInt(base ? base->version_ : FULL_SNAPSHOT);
+    dest.WriteVLE(numObjects);
+    dest.Write(body.GetData(), body.GetSize());
+
+    data_ = dest.GetBuffer();
+    version_ = version;
+    baseVersion_ = base ? base->version_ : FULL_SNAPSHOT;
+    return true;
+}
+
+bool SceneSnapshot::Restore(Scene* scene) const
+{
+    if (!scene)
+        return false;
+
+    URHO3D_PROFILE("RestoreSceneSnapshot");
+
+    MemoryBuffer source(data_);
+    unsigned version{};
+    unsigned baseVersion{};
+    unsigned numObjects{};
+    if (!ReadHeader(source, version, baseVersion, numObjects))
+    {
+        URHO3D_LOGERROR("Invalid scene snapshot data");
+        return false;
+    }
+
+    BinaryInputArchive archive(scene->GetContext(), source);
+    ArchiveBlock block = archive.OpenSequentialBlock("snapshot");
+
+    Variant value;
+    for (unsigned i = 0; i < numObjects; ++i)
+    {
+        const bool isNode = source.ReadBool();
+        const unsigned id = source.ReadUInt();
+        const unsigned numValues = source.ReadVLE();
+
+        Serializable* object = nullptr;
+        if (isNode)
+            object = id == scene->GetID() ? scene : scene->GetNode(id);
+        else
+            object = scene->GetComponent(id);
+
+        const ea::vector<AttributeInfo>* attributes = object ? object->GetAttributes() : nullptr;
+        for (unsigned j = 0; j < numValues; ++j)
+        {
+            const unsigned index = source.ReadVLE();
+            const unsigned size = source.ReadVLE();
+            const unsigned offset = source.GetPosition();
+            if (source.IsEof() && size != 0)
+            {
+                URHO3D_LOGERROR("Unexpected end of scene snapshot data");
+                return false;
+            }
+
+            // Skip values of removed objects
+            if (attributes && index < attributes->size())
+            {
+                const AttributeInfo& attr = attributes->at(index);
+                if (object->HasDirectAttributeAccess(attr))
+                {
+                    if (!attr.accessor_->Serialize(object, archive, "value"))
+                    {
+                        URHO3D_LOGERROR("Could not restore attribute {} from scene snapshot: {}",
+                            attr.name_, archive.GetErrorString());
+                        return false;
+                    }
+                    object->OnDirectAttributeSet(attr);
+                }
+                else
+                {
+                    value = source.ReadVariant(attr.type_, scene->GetContext());
+                    object->OnSetAttribute(attr, value);
+                }
+            }
+
+            source.Seek(offset + size);
+        }
+
+        if (object && numValues > 0)
+            object->ApplyAttributes();
+    }
+
+    return true;
+}
+
+bool SceneSnapshot::SetData(ByteVector data)
+{
+    MemoryBuffer source(data);
+    unsigned numObjects{};
+    if (!ReadHeader(source, version_, baseVersion_, numObjects))
+    {
+        URHO3D_LOGERROR("Invalid scene snapshot data");
+        data_.clear();
+        version_ = 0;
+        baseVersion_ = FULL_SNAPSHOT;
+        return false;
+    }
+
+    data_ = ea::move(data);
+    return true;
+}
+
+}
@@ -0,0 +1,76 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+/// \file
+
+#pragma once
+
+#include "../Container/ByteVector.h"
+#include "../Core/Attribute.h"
+
+namespace Urho3D
+{
+
+class Scene;
+
+/// Flat, versioned snapshot of mutable attributes of scene nodes and components, for quick save and rollback.
+/// Only attributes matching the mode mask are captured. Typed attributes are written and restored in-place
+/// through their accessors without Variant conversion. Delta snapshot contains only values that differ from the base.
+/// Nodes and components are matched by ID: objects created after the capture are kept, removed objects are skipped.
+class URHO3D_API SceneSnapshot
+{
+public:
+    /// Base version of full snapshot.
+    static const unsigned FULL_SNAPSHOT = M_MAX_UNSIGNED;
+
+    /// Capture full snapshot of the scene. Return true if successful.
+    bool Capture(Scene* scene, unsigned version, AttributeModeFlags mask = AM_NET);
+    /// Capture values changed since the base full snapshot. Return true if successful.
+    bool CaptureDelta(Scene* scene, unsigned version, const SceneSnapshot& base, AttributeModeFlags mask = AM_NET);
+    /// Write captured values back to the scene. Delta snapshot should be restored after its base. Return true if successful.
+    bool Restore(Scene* scene) const;
+
+    /// Set snapshot data, e.g. received from network or loaded from file. Return true if the header is valid.
+    bool SetData(ByteVector data);
+    /// Return snapshot data.
+    const ByteVector& GetData() const { return data_; }
+    /// Return version.
+    unsigned GetVersion() const { return version_; }
+    /// Return version of the base snapshot, FULL_SNAPSHOT if the snapshot is not delta.
+    unsigned GetBaseVersion() const { return baseVersion_; }
+    /// Return whether the snapshot is delta.
+    bool IsDelta() const { return baseVersion_ != FULL_SNAPSHOT; }
+
+private:
+    /// Capture values, skipping ones equal to the base snapshot if present.
+    bool CaptureInternal(Scene* scene, unsigned version, const SceneSnapshot* base, AttributeModeFlags mask);
+
+    /// Snapshot data.
+    ByteVector data_;
+    /// Version.
+    unsigned version_{};
+    /// Base version.
+    unsigned baseVersion_{ FULL_SNAPSHOT };
+};
+
+}
@@ -63,6 +63,23 @@ static unsigned RemapAttributeIndex(const ea::vector<AttributeInfo>* attributes,
     return netAttrIndex; // Could not remap
 }
 
+/// Return enum attribute value by case-insensitive name, or empty if not found.
+static Variant ParseEnumValue(const AttributeInfo& attr, const ea::string& value)
+{
+    int enumValue = 0;
+    const char** enumPtr = attr.enumNames_;
+    while (*enumPtr)
+    {
+        if (!value.comparei(*enumPtr))
+            return enumValue;
+        ++enumPtr;
+        ++enumValue;
+    }
+
+    URHO3D_LOGWARNING("Unknown enum value " + value + " in attribute " + attr.name_);
+    return Variant::EMPTY;
+}
+
 static bool SaveAttributeWithName(Archive& archive, const AttributeInfo& attr, const Variant& value)
 {
     assert(!archive.IsInput());
@@ -83,6 +100,18 @@ static bool SaveAttributeWithName(Archive& archive, const AttributeInfo& attr, c
     }
 }
 
+static bool SaveAttributeDirectWithName(Archive& archive, Serializable* serializable, const AttributeInfo& attr)
+{
+    assert(!archive.IsInput());
+
+    // Save attribute name
+    if (!SerializeStringHashKey(archive, const_cast<StringHash&>(attr.nameHash_), attr.name_))
+        return false;
+
+    // Save attribute without conversion to Variant
+    return attr.accessor_->Serialize(serializable, archive, "attribute");
+}
+
 static bool LoadAttribute(Archive& archive, const AttributeInfo& attr, Variant& value)
 {
     assert(archive.IsInput());
@@ -107,6 +136,181 @@ static bool LoadAttribute(Archive& archive, const AttributeInfo& attr, Variant&
     }
 }
 
+/// Range of the three smallest components of a unit quaternion.
+static const float QUATERNION_COMPONENT_RANGE = 0.70710678f;
+
+/// Return number of quantized components of a network attribute type, or zero if the type can not be quantized.
+static unsigned GetNumQuantizedComponents(VariantType type)
+{
+    switch (type)
+    {
+    case VAR_FLOAT: return 1;
+    case VAR_VECTOR2: return 2;
+    case VAR_VECTOR3: return 3;
+    case VAR_VECTOR4: return 4;
+    case VAR_QUATERNION: return 3;
+    default: return 0;
+    }
+}
+
+/// Return number of bits per quantized component of a network attribute, or zero if not quantized.
+static unsigned GetQuantizationBits(const AttributeInfo& attr)
+{
+    const unsigned numComponents = GetNumQuantizedComponents(attr.type_);
+    if (!numComponents || attr.metadata_.empty())
+        return 0;
+
+    const int bits = attr.GetMetadata(AttributeMetadata::P_NETWORK_QUANTIZATION_BITS).GetInt();
+    if (bits <= 0)
+        return 0;
+
+    // All components, and the smallest three index for quaternions, must fit into 64 bits
+    const unsigned maxBits = attr.type_ == VAR_QUATERNION ? 20 : Min(64 / numComponents, 32u);
+    return Min(static_cast<unsigned>(bits), maxBits);
+}
+
+/// Quantize value in range into unsigned integer of given bits.
+static unsigned long long QuantizeFloat(float value, float minValue, float maxValue, unsigned bits)
+{
+    const unsigned long long maxQuantized = (1ULL << bits) - 1;
+    const double t = maxValue > minValue ? Clamp((value - minValue) / (maxValue - minValue), 0.0f, 1.0f) : 0.0;
+    return static_cast<unsigned long long>(t * maxQuantized + 0.5);
+}
+
+/// Restore value in range from unsigned integer of given bits.
+static float DequantizeFloat(unsigned long long quantized, float minValue, float maxValue, unsigned bits)
+{
+    const unsigned long long maxQuantized = (1ULL << bits) - 1;
+    return minValue + (maxValue - minValue) * static_cast<float>(static_cast<double>(quantized) / maxQuantized);
+}
+
+/// Write a network attribute value. Quantized attributes are bit-packed, others are written as variant data.
+static void WriteNetworkAttribute(Serializer& dest, const AttributeInfo& attr, const Variant& value)
+{
+    const unsigned bits = GetQuantizationBits(attr);
+    if (!bits)
+    {
+        dest.WriteVariantData(value);
+        return;
+    }
+
+    unsigned long long packed = 0;
+    unsigned numBits = 0;
+    const auto pack = [&](unsigned long long quantized, unsigned quantizedBits)
+    {
+        packed |= quantized << numBits;
+        numBits += quantizedBits;
+    };
+
+    float components[4]{};
+    switch (attr.type_)
+    {
+    case VAR_FLOAT:
+        components[0] = value.GetFloat();
+        break;
+
+    case VAR_VECTOR2:
+        components[0] = value.GetVector2().x_;
+        components[1] = value.GetVector2().y_;
+        break;
+
+    case VAR_VECTOR3:
+        components[0] = value.GetVector3().x_;
+        components[1] = value.GetVector3().y_;
+        components[2] = value.GetVector3().z_;
+        break;
+
+    case VAR_VECTOR4:
+        memcpy(components, value.GetVector4().Data(), sizeof components);
+        break;
+
+    default:
+        {
+            // Smallest three: drop the largest component, which is restored from the unit length
+            const Quaternion rotation = value.GetQuaternion().Normalized();
+            const float quatComponents[4] = { rotation.w_, rotation.x_, rotation.y_, rotation.z_ };
+            unsigned largest = 0;
+            for (unsigned i = 1; i < 4; ++i)
+            {
+                if (Abs(quatComponents[i]) > Abs(quatComponents[largest]))
+                    largest = i;
+            }
+
+            // Quaternion and its negation are the same rotation, so make the dropped component positive
+            const float sign = quatComponents[largest] < 0.0f ? -1.0f : 1.0f;
+            pack(largest, 2);
+            for (unsigned i = 0; i < 4; ++i)
+            {
+                if (i != largest)
+                    pack(QuantizeFloat(quatComponents[i] * sign, -QUATERNION_COMPONENT_RANGE, QUATERNION_COMPONENT_RANGE, bits), bits);
+            }
+        }
+        break;
+    }
+
+    if (attr.type_ != VAR_QUATERNION)
+    {
+        const Vector2 range = attr.GetMetadata(AttributeMetadata::P_NETWORK_QUANTIZATION_RANGE).GetVector2();
+        for (unsigned i = 0; i < GetNumQuantizedComponents(attr.type_); ++i)
+            pack(QuantizeFloat(components[i], range.x_, range.y_, bits), bits);
+    }
+
+    for (unsigned i = 0; i < numBits; i += 8)
+        dest.WriteUByte(static_cast<unsigned char>(packed >> i));
+}
+
+/// Read a network attribute value written by WriteNetworkAttribute.
+static Variant ReadNetworkAttribute(Deserializer& source, const AttributeInfo& attr)
+{
+    const unsigned bits = GetQuantizationBits(attr);
+    if (!bits)
+        return source.ReadVariant(attr.type_);
+
+    const unsigned numComponents = GetNumQuantizedComponents(attr.type_);
+    const unsigned totalBits = numComponents * bits + (attr.type_ == VAR_QUATERNION ? 2 : 0);
+    unsigned long long packed = 0;
+    for (unsigned i = 0; i < totalBits; i += 8)
+        packed |= static_cast<unsigned long long>(source.ReadUByte()) << i;
+
+    unsigned numBits = 0;
+    const auto unpack = [&](unsigned quantizedBits)
+    {
+        const unsigned long long quantized = (packed >> numBits) & ((1ULL << quantizedBits) - 1);
+        numBits += quantizedBits;
+        return quantized;
+    };
+
+    if (attr.type_ == VAR_QUATERNION)
+    {
+        const auto largest = static_cast<unsigned>(unpack(2));
+        float components[4];
+        float sumSquares = 0.0f;
+        for (unsigned i = 0; i < 4; ++i)
+        {
+            if (i != largest)
+            {
+                components[i] = DequantizeFloat(unpack(bits), -QUATERNION_COMPONENT_RANGE, QUATERNION_COMPONENT_RANGE, bits);
+                sumSquares += components[i] * components[i];
+            }
+        }
+        components[largest] = sqrtf(Max(1.0f - sumSquares, 0.0f));
+        return Quaternion(components[0], components[1], components[2], components[3]).Normalized();
+    }
+
+    const Vector2 range = attr.GetMetadata(AttributeMetadata::P_NETWORK_QUANTIZATION_RANGE).GetVector2();
+    float components[4]{};
+    for (unsigned i = 0; i < numComponents; ++i)
+        components[i] = DequantizeFloat(unpack(bits), range.x_, range.y_, bits);
+
+    switch (attr.type_)
+    {
+    case VAR_FLOAT: return components[0];
+    case VAR_VECTOR2: return Vector2(components);
+    case VAR_VECTOR3: return Vector3(components);
+    default: return Vector4(components);
+    }
+}
+
 Serializable::Serializable(Context* context) :
     Object(context),
     setInstanceDefault_(false),
@@ -334,14 +538,27 @@ void Serializable::OnGetAttribute(const AttributeInfo& attr, Variant& dest) cons
     }
 }
 
+bool Serializable::HasDirectAttributeAccess(const AttributeInfo& attr) const
+{
+    // Instance defaults are recorded by OnSetAttribute only
+    return attr.accessor_ && !attr.enumNames_ && !setInstanceDefault_ && attr.accessor_->IsTyped();
+}
+
+void Serializable::OnDirectAttributeSet(const AttributeInfo& attr)
+{
+    // Writes of file-only attributes must not queue the object for the network attribute comparison
+    if (attr.mode_ & AM_NET)
+        MarkNetworkUpdate();
+}
+
 const ea::vector<AttributeInfo>* Serializable::GetAttributes() const
 {
-    return context_->GetAttributes(GetType());
+    return context_->GetAttributes(GetTypeInfo());
 }
 
 const ea::vector<AttributeInfo>* Serializable::GetNetworkAttributes() const
 {
-    return networkState_ ? networkState_->attributes_ : context_->GetNetworkAttributes(GetType());
+    return networkState_ ? networkState_->attributes_ : context_->GetNetworkAttributes(GetTypeInfo());
 }
 
 bool Serializable::Load(Deserializer& source)
@@ -425,26 +642,7 @@ bool Serializable::LoadXML(const XMLElement& source)
 
                 // If enums specified, do enum lookup and int assignment. Otherwise assign the variant directly
                 if (attr.enumNames_ && attr.type_ == VAR_INT)
-                {
-                    ea::string value = attrElem.GetAttribute("value");
-                    bool enumFound = false;
-                    int enumValue = 0;
-                    const char** enumPtr = attr.enumNames_;
-                    while (*enumPtr)
-                    {
-                        if (!value.comparei(*enumPtr))
-                        {
-                            enumFound = true;
-                            break;
-                        }
-                        ++enumPtr;
-                        ++enumValue;
-                    }
-                    if (enumFound)
-                        varValue = enumValue;
-                    else
-                        URHO3D_LOGWARNING("Unknown enum value " + value + " in attribute " + attr.name_);
-                }
+                    varValue = ParseEnumValue(attr, attrElem.GetAttribute("value"));
                 else
                     varValue = attrElem.GetVariantValue(attr.type_, context_);
 
@@ -506,26 +704,7 @@ bool Serializable::LoadJSON(const JSONValue& source)
             Variant varValue;
             // If enums specified, do enum lookup ad int assignment. Otherwise assign variant directly
             if (attr.enumNames_ && attr.type_ == VAR_INT)
-            {
-                const ea::string& valueStr = value.GetString();
-                bool enumFound = false;
-                int enumValue = 0;
-                const char** enumPtr = attr.enumNames_;
-                while (*enumPtr)
-                {
-                    if (!valueStr.comparei(*enumPtr))
-                    {
-                        enumFound = true;
-                        break;
-                    }
-                    ++enumPtr;
-                    ++enumValue;
-                }
-                if (enumFound)
-                    varValue = enumValue;
-                else
-                    URHO3D_LOGWARNING("Unknown enum value " + valueStr + " in attribute " + attr.name_);
-            }
+                varValue = ParseEnumValue(attr, value.GetString());
             else
                 varValue = value.GetVariantValue(attr.type_, context_);
 
@@ -547,6 +726,141 @@ bool Serializable::LoadJSON(const JSONValue& source)
     return true;
 }
 
+bool Serializable::LoadDecoded(const DecodedAttributes& source)
+{
+    const ea::vector<AttributeInfo>* attributes = GetAttributes();
+    if (!attributes)
+        return true;
+
+    for (const auto& item : source)
+    {
+        if (item.first >= attributes->size())
+        {
+            URHO3D_LOGERROR("Decoded attribute index out of bounds in " + GetTypeName());
+            return false;
+        }
+        OnSetAttribute(attributes->at(item.first), item.second);
+    }
+
+    return true;
+}
+
+bool Serializable::DecodeBinary(Context* context, StringHash type, Deserializer& source, DecodedAttributes& dest)
+{
+    dest.clear();
+
+    // Unknown types are loaded through UnknownComponent, which keeps the raw data
+    const ea::vector<AttributeInfo>* attributes = context->GetAttributes(type);
+    if (!attributes)
+        return context->GetObjectFactories().contains(type);
+
+    for (unsigned i = 0; i < attributes->size(); ++i)
+    {
+        const AttributeInfo& attr = attributes->at(i);
+        if (!attr.ShouldLoad())
+            continue;
+
+        // Custom values create objects, which is not safe outside the main thread
+        if (attr.type_ == VAR_CUSTOM || source.IsEof())
+            return false;
+
+        dest.emplace_back(i, source.ReadVariant(attr.type_));
+    }
+
+    return true;
+}
+
+bool Serializable::DecodeXML(Context* context, StringHash type, const XMLElement& source, DecodedAttributes& dest)
+{
+    dest.clear();
+
+    const ea::vector<AttributeInfo>* attributes = context->GetAttributes(type);
+    if (!attributes)
+        return context->GetObjectFactories().contains(type);
+
+    XMLElement attrElem = source.GetChild("attribute");
+    unsigned startIndex = 0;
+
+    while (attrElem)
+    {
+        ea::string name = attrElem.GetAttribute("name");
+        unsigned i = startIndex;
+        unsigned attempts = attributes->size();
+
+        while (attempts)
+        {
+            const AttributeInfo& attr = attributes->at(i);
+            if (attr.ShouldLoad() && !attr.name_.compare(name))
+            {
+                if (attr.type_ == VAR_CUSTOM)
+                    return false;
+
+                Variant varValue;
+                if (attr.enumNames_ && attr.type_ == VAR_INT)
+                    varValue = ParseEnumValue(attr, attrElem.GetAttribute("value"));
+                else
+                    varValue = attrElem.GetVariantValue(attr.type_);
+
+                if (!varValue.IsEmpty())
+                    dest.emplace_back(i, ea::move(varValue));
+
+                startIndex = (i + 1) % attributes->size();
+                break;
+            }
+            else
+            {
+                i = (i + 1) % attributes->size();
+                --attempts;
+            }
+        }
+
+        if (!attempts)
+            URHO3D_LOGWARNING("Unknown attribute " + name + " in XML data");
+
+        attrElem = attrElem.GetNext("attribute");
+    }
+
+    return true;
+}
+
+bool Serializable::DecodeJSON(Context* context, StringHash type, const JSONValue& source, DecodedAttributes& dest)
+{
+    dest.clear();
+
+    const ea::vector<AttributeInfo>* attributes = context->GetAttributes(type);
+    if (!attributes)
+        return context->GetObjectFactories().contains(type);
+
+    const JSONValue& attributesValue = source.Get("attributes");
+    if (!attributesValue.IsObject())
+        return attributesValue.IsNull();
+
+    for (unsigned i = 0; i < attributes->size(); ++i)
+    {
+        const AttributeInfo& attr = attributes->at(i);
+        if (!attr.ShouldLoad())
+            continue;
+
+        const JSONValue& value = attributesValue[attr.name_];
+        if (value.GetValueType() == JSON_NULL)
+            continue;
+
+        if (attr.type_ == VAR_CUSTOM)
+            return false;
+
+        Variant varValue;
+        if (attr.enumNames_ && attr.type_ == VAR_INT)
+            varValue = ParseEnumValue(attr, value.GetString());
+        else
+            varValue = value.GetVariantValue(attr.type_);
+
+        if (!varValue.IsEmpty())
+            dest.emplace_back(i, ea::move(varValue));
+    }
+
+    return true;
+}
+
 bool Serializable::SaveXML(XMLElement& dest) const
 {
     if (dest.IsNull())
@@ -749,6 +1063,19 @@ bool Serializable::Serialize(Archive& archive, ArchiveBlock& block)
                 if (nextAttributeIndex < numAttributes && (*attributes)[nextAttributeIndex].nameHash_ == attrNameHash)
                 {
                     const AttributeInfo& attr = (*attributes)[nextAttributeIndex];
+                    if (HasDirectAttributeAccess(attr))
+                    {
+                        if (!attr.accessor_->Serialize(this, archive, "attribute"))
+                        {
+                            URHO3D_LOGERROR("Could not load " + GetTypeName() + ", failed to read attribute " + attr.name_);
+                            return false;
+                        }
+
+                        OnDirectAttributeSet(attr);
+                        ++nextAttributeIndex;
+                        continue;
+                    }
+
                     Variant value;
                     if (!LoadAttribute(archive, attr, value))
                     {
@@ -819,6 +1146,16 @@ bool Serializable::Serialize(Archive& archive, ArchiveBlock& block)
                     if (!attr.ShouldSave())
                         continue;
 
+                    if (HasDirectAttributeAccess(attr))
+                    {
+                        if (!SaveAttributeDirectWithName(archive, this, attr))
+                        {
+                            URHO3D_LOGERROR("Could not save " + GetTypeName() + ", failed to write attribute " + attr.name_);
+                            return false;
+                        }
+                        continue;
+                    }
+
                     OnGetAttribute(attr, value);
 
                     if (!SaveAttributeWithName(archive, attr, value))
@@ -995,9 +1332,73 @@ void Serializable::AllocateNetworkState()
         networkState_->currentValues_.resize(numAttributes);
         networkState_->previousValues_.resize(numAttributes);
 
-        // Copy the default attribute values to the previous state as a starting point
+        // Copy the default attribute values to the previous and current state as a starting point
         for (unsigned i = 0; i < numAttributes; ++i)
+        {
             networkState_->previousValues_[i] = networkAttributes->at(i).defaultValue_;
+            networkState_->currentValues_[i] = networkAttributes->at(i).defaultValue_;
+        }
+    }
+}
+
+void Serializable::PrepareSharedNetworkUpdates(const DirtyBits& changedAttributes)
+{
+    if (!networkState_ || !networkState_->attributes_ || !changedAttributes.Count())
+        return;
+
+    const ea::vector<AttributeInfo>* attributes = networkState_->attributes_;
+    unsigned numAttributes = attributes->size();
+
+    // Any change makes the initial state outdated
+    networkState_->sharedInitialUpdate_.Clear();
+
+    // Latest data attributes are never included in delta updates
+    DirtyBits deltaBits;
+    bool latestDataChanged = false;
+    for (unsigned i = 0; i < numAttributes; ++i)
+    {
+        if (!changedAttributes.IsSet(i))
+            continue;
+        if (attributes->at(i).mode_ & AM_LATESTDATA)
+            latestDataChanged = true;
+        else
+            deltaBits.Set(i);
+    }
+
+    // Encoding once only pays off with several connections. Otherwise just invalidate, as the values have changed
+    const bool shared = networkState_->replicationStates_.size() > 1;
+
+    if (deltaBits.Count())
+    {
+        VectorBuffer& dest = networkState_->sharedDeltaUpdate_;
+        dest.Clear();
+        networkState_->sharedDeltaBits_.ClearAll();
+
+        if (shared)
+        {
+            networkState_->sharedDeltaBits_ = deltaBits;
+            dest.Write(deltaBits.data_, (numAttributes + 7) >> 3u);
+            for (unsigned i = 0; i < numAttributes; ++i)
+            {
+                if (deltaBits.IsSet(i))
+                    WriteNetworkAttribute(dest, attributes->at(i), networkState_->currentValues_[i]);
+            }
+        }
+    }
+
+    if (latestDataChanged)
+    {
+        VectorBuffer& dest = networkState_->sharedLatestDataUpdate_;
+        dest.Clear();
+
+        if (shared)
+        {
+            for (unsigned i = 0; i < numAttributes; ++i)
+            {
+                if (attributes->at(i).mode_ & AM_LATESTDATA)
+                    WriteNetworkAttribute(dest, attributes->at(i), networkState_->currentValues_[i]);
+            }
+        }
     }
 }
 
@@ -1014,25 +1415,34 @@ void Serializable::WriteInitialDeltaUpdate(Serializer& dest, unsigned char timeS
         return;
 
     unsigned numAttributes = attributes->size();
-    DirtyBits attributeBits;
 
-    // Compare against defaults
-    for (unsigned i = 0; i < numAttributes; ++i)
+    // The initial state is encoded once and reused for all connections until the attributes change,
+    // so that many clients joining at once do not serialize the whole scene for each of them
+    VectorBuffer& sharedUpdate = networkState_->sharedInitialUpdate_;
+    if (!sharedUpdate.GetSize())
     {
-        const AttributeInfo& attr = attributes->at(i);
-        if (networkState_->currentValues_[i] != attr.defaultValue_)
-            attributeBits.Set(i);
-    }
+        DirtyBits attributeBits;
 
-    // First write the change bitfield, then attribute data for non-default attributes
-    dest.WriteUByte(timeStamp);
-    dest.Write(attributeBits.data_, (numAttributes + 7) >> 3u);
+        // Compare against defaults
+        for (unsigned i = 0; i < numAttributes; ++i)
+        {
+            const AttributeInfo& attr = attributes->at(i);
+            if (networkState_->currentValues_[i] != attr.defaultValue_)
+                attributeBits.Set(i);
+        }
 
-    for (unsigned i = 0; i < numAttributes; ++i)
-    {
-        if (attributeBits.IsSet(i))
-            dest.WriteVariantData(networkState_->currentValues_[i]);
+        // First write the change bitfield, then attribute data for non-default attributes
+        sharedUpdate.Write(attributeBits.data_, (numAttributes + 7) >> 3u);
+
+        for (unsigned i = 0; i < numAttributes; ++i)
+        {
+            if (attributeBits.IsSet(i))
+                WriteNetworkAttribute(sharedUpdate, attributes->at(i), networkState_->currentValues_[i]);
+        }
     }
+
+    dest.WriteUByte(timeStamp);
+    dest.Write(sharedUpdate.GetData(), sharedUpdate.GetSize());
 }
 
 void Serializable::WriteDeltaUpdate(Serializer& dest, const DirtyBits& attributeBits, unsigned char timeStamp)
@@ -1049,15 +1459,23 @@ void Serializable::WriteDeltaUpdate(Serializer& dest, const DirtyBits& attribute
 
     unsigned numAttributes = attributes->size();
 
+    // Most connections have the same dirty bits, which were encoded once in PrepareSharedNetworkUpdates
+    dest.WriteUByte(timeStamp);
+    if (attributeBits.Count() && attributeBits == networkState_->sharedDeltaBits_)
+    {
+        const VectorBuffer& sharedUpdate = networkState_->sharedDeltaUpdate_;
+        dest.Write(sharedUpdate.GetData(), sharedUpdate.GetSize());
+        return;
+    }
+
     // First write the change bitfield, then attribute data for changed attributes
     // Note: the attribute bits should not contain LATESTDATA attributes
-    dest.WriteUByte(timeStamp);
     dest.Write(attributeBits.data_, (numAttributes + 7) >> 3u);
 
     for (unsigned i = 0; i < numAttributes; ++i)
     {
         if (attributeBits.IsSet(i))
-            dest.WriteVariantData(networkState_->currentValues_[i]);
+            WriteNetworkAttribute(dest, attributes->at(i), networkState_->currentValues_[i]);
     }
 }
 
@@ -1077,10 +1495,17 @@ void Serializable::WriteLatestDataUpdate(Serializer& dest, unsigned char timeSta
 
     dest.WriteUByte(timeStamp);
 
+    const VectorBuffer& sharedUpdate = networkState_->sharedLatestDataUpdate_;
+    if (sharedUpdate.GetSize())
+    {
+        dest.Write(sharedUpdate.GetData(), sharedUpdate.GetSize());
+        return;
+    }
+
     for (unsigned i = 0; i < numAttributes; ++i)
     {
         if (attributes->at(i).mode_ & AM_LATESTDATA)
-            dest.WriteVariantData(networkState_->currentValues_[i]);
+            WriteNetworkAttribute(dest, attributes->at(i), networkState_->currentValues_[i]);
     }
 }
 
@@ -1105,7 +1530,7 @@ bool Serializable::ReadDeltaUpdate(Deserializer& source)
             const AttributeInfo& attr = attributes->at(i);
             if (!(interceptMask & (1ULL << i)))
             {
-                OnSetAttribute(attr, source.ReadVariant(attr.type_));
+                OnSetAttribute(attr, ReadNetworkAttribute(source, attr));
                 changed = true;
             }
             else
@@ -1117,7 +1542,7 @@ bool Serializable::ReadDeltaUpdate(Deserializer& source)
                 eventData[P_TIMESTAMP] = (unsigned)timeStamp;
                 eventData[P_INDEX] = RemapAttributeIndex(GetAttributes(), attr, i);
                 eventData[P_NAME] = attr.name_;
-                eventData[P_VALUE] = source.ReadVariant(attr.type_);
+                eventData[P_VALUE] = ReadNetworkAttribute(source, attr);
                 SendEvent(E_INTERCEPTNETWORKUPDATE, eventData);
             }
         }
@@ -1126,6 +1551,30 @@ bool Serializable::ReadDeltaUpdate(Deserializer& source)
     return changed;
 }
 
+bool Serializable::UpdateNetworkAttribute(unsigned index)
+{
+    const AttributeInfo& attr = networkState_->attributes_->at(index);
+    Variant& currentValue = networkState_->currentValues_[index];
+    Variant& previousValue = networkState_->previousValues_[index];
+
+    // Current value is kept equal to the previous one, so typed accessors only need to fetch it on change
+    if (HasDirectAttributeAccess(attr))
+    {
+        if (attr.accessor_->Equals(this, previousValue))
+            return false;
+        OnGetAttribute(attr, currentValue);
+    }
+    else
+    {
+        OnGetAttribute(attr, currentValue);
+        if (currentValue == previousValue)
+            return false;
+    }
+
+    previousValue = currentValue;
+    return true;
+}
+
 bool Serializable::ReadLatestDataUpdate(Deserializer& source)
 {
     const ea::vector<AttributeInfo>* attributes = GetNetworkAttributes();
@@ -1145,7 +1594,7 @@ bool Serializable::ReadLatestDataUpdate(Deserializer& source)
         {
             if (!(interceptMask & (1ULL << i)))
             {
-                OnSetAttribute(attr, source.ReadVariant(attr.type_));
+                OnSetAttribute(attr, ReadNetworkAttribute(source, attr));
                 changed = true;
             }
             else
@@ -1157,7 +1606,7 @@ bool Serializable::ReadLatestDataUpdate(Deserializer& source)
                 eventData[P_TIMESTAMP] = (unsigned)timeStamp;
                 eventData[P_INDEX] = RemapAttributeIndex(GetAttributes(), attr, i);
                 eventData[P_NAME] = attr.name_;
-                eventData[P_VALUE] = source.ReadVariant(attr.type_);
+                eventData[P_VALUE] = ReadNetworkAttribute(source, attr);
                 SendEvent(E_INTERCEPTNETWORKUPDATE, eventData);
             }
         }
@@ -1261,7 +1710,7 @@ unsigned Serializable::GetNumAttributes() const
 unsigned Serializable::GetNumNetworkAttributes() const
 {
     const ea::vector<AttributeInfo>* attributes = networkState_ ? networkState_->attributes_ :
-        context_->GetNetworkAttributes(GetType());
+        context_->GetNetworkAttributes(GetTypeInfo());
     return attributes ? attributes->size() : 0;
 }
 
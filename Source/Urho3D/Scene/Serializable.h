@@ -24,8 +24,10 @@
 
 #include "../Core/Attribute.h"
 #include "../Core/Object.h"
+#include "../IO/ArchiveSerialization.h"
 
 #include <cstddef>
+#include <type_traits>
 
 namespace Urho3D
 {
@@ -42,6 +44,9 @@ struct DirtyBits;
 struct NetworkState;
 struct ReplicationState;
 
+/// Attribute values decoded in advance, as pairs of attribute index and value.
+using DecodedAttributes = ea::vector<ea::pair<unsigned, Variant>>;
+
 /// Base class for objects with automatic serialization through attributes.
 class URHO3D_API Serializable : public Object
 {
@@ -57,6 +62,10 @@ public:
     virtual void OnSetAttribute(const AttributeInfo& attr, const Variant& src);
     /// Handle attribute read access. Default implementation reads the variable at offset, or invokes the get accessor.
     virtual void OnGetAttribute(const AttributeInfo& attr, Variant& dest) const;
+    /// Return whether the attribute may be serialized and compared through its typed accessor, bypassing OnGetAttribute and OnSetAttribute. Override to return false if attribute access is intercepted.
+    virtual bool HasDirectAttributeAccess(const AttributeInfo& attr) const;
+    /// Handle attribute write through the typed accessor. Default implementation marks the object for network update only if the attribute has AM_NET mode, the same as OnSetAttribute. Overrides must call it.
+    virtual void OnDirectAttributeSet(const AttributeInfo& attr);
     /// Return attribute descriptions, or null if none defined.
     virtual const ea::vector<AttributeInfo>* GetAttributes() const;
     /// Return network replication attribute descriptions, or null if none defined.
@@ -79,6 +88,8 @@ public:
     virtual bool LoadJSON(const JSONValue& source);
     /// Save as JSON data. Return true if successful.
     virtual bool SaveJSON(JSONValue& dest) const;
+    /// Load from attribute values decoded by DecodeXML() or DecodeJSON(). Return true if successful.
+    virtual bool LoadDecoded(const DecodedAttributes& source);
     /// Load from binary resource.
     virtual bool Load(const ea::string& resourceName);
     /// Load from XML resource.
@@ -91,6 +102,13 @@ public:
     /// Apply attribute changes that can not be applied immediately. Called after scene load or a network update.
     virtual void ApplyAttributes() { }
 
+    /// Decode attribute values of a type from binary data without creating an object. Safe to call from worker threads. Return false if the data must be loaded by Load() instead.
+    static bool DecodeBinary(Context* context, StringHash type, Deserializer& source, DecodedAttributes& dest);
+    /// Decode attribute values of a type from XML data without creating an object. Safe to call from worker threads. Return false if the data must be loaded by LoadXML() instead.
+    static bool DecodeXML(Context* context, StringHash type, const XMLElement& source, DecodedAttributes& dest);
+    /// Decode attribute values of a type from JSON data without creating an object. Safe to call from worker threads. Return false if the data must be loaded by LoadJSON() instead.
+    static bool DecodeJSON(Context* context, StringHash type, const JSONValue& source, DecodedAttributes& dest);
+
     /// Return whether should save default-valued attributes into XML. Default false.
     virtual bool SaveDefaultAttributes(const AttributeInfo& attr) const { return false; }
 
@@ -117,7 +135,9 @@ public:
     void SetInterceptNetworkUpdate(const ea::string& attributeName, bool enable);
     /// Allocate network attribute state.
     void AllocateNetworkState();
-    /// Write initial delta network update.
+    /// Encode the delta and latest data updates of attributes changed in the network update once for all connections. Called from PrepareNetworkUpdate.
+    void PrepareSharedNetworkUpdates(const DirtyBits& changedAttributes);
+    /// Write initial delta network update. Not thread-safe, connections updated in parallel serialize the calls through the Network subsystem.
     void WriteInitialDeltaUpdate(Serializer& dest, unsigned char timeStamp);
     /// Write a delta network update according to dirty attribute bits.
     void WriteDeltaUpdate(Serializer& dest, const DirtyBits& attributeBits, unsigned char timeStamp);
@@ -127,6 +147,8 @@ public:
     bool ReadDeltaUpdate(Deserializer& source);
     /// Read and apply a network latest data update. Return true if attributes were changed.
     bool ReadLatestDataUpdate(Deserializer& source);
+    /// Fetch the current value of a network attribute by index. Return true if it has changed since the previous update.
+    bool UpdateNetworkAttribute(unsigned index);
 
     /// Return attribute value by index. Return empty if illegal index.
     Variant GetAttribute(unsigned index) const;
@@ -203,15 +225,125 @@ SharedPtr<AttributeAccessor> MakeVariantAttributeAccessor(TGetFunction getFuncti
     return SharedPtr<AttributeAccessor>(new VariantAttributeAccessorImpl<TClassType, TGetFunction, TSetFunction>(getFunction, setFunction));
 }
 
+/// Return whether the attribute type can be serialized and compared by typed accessors.
+template <class T> struct IsTypedAttributeType : std::bool_constant<
+    std::is_same_v<T, int> || std::is_same_v<T, bool> || std::is_same_v<T, float> || std::is_same_v<T, double>
+    || std::is_same_v<T, long long> || std::is_same_v<T, Vector2> || std::is_same_v<T, Vector3> || std::is_same_v<T, Vector4>
+    || std::is_same_v<T, Quaternion> || std::is_same_v<T, Color> || std::is_same_v<T, ea::string> || std::is_same_v<T, Rect>
+    || std::is_same_v<T, IntRect> || std::is_same_v<T, IntVector2> || std::is_same_v<T, IntVector3> || std::is_same_v<T, Matrix3>
+    || std::is_same_v<T, Matrix3x4> || std::is_same_v<T, Matrix4> || std::is_same_v<T, ResourceRef> || std::is_same_v<T, ResourceRefList>> {};
+
+namespace Detail
+{
+
+/// Return value of typed attribute type stored in Variant, without copying if possible.
+template <class T> decltype(auto) GetTypedAttributeValue(const Variant& value)
+{
+    if constexpr (std::is_arithmetic_v<T>)
+        return value.Get<T>();
+    else if constexpr (std::is_same_v<T, ResourceRef>)
+        return value.GetResourceRef();
+    else if constexpr (std::is_same_v<T, ResourceRefList>)
+        return value.GetResourceRefList();
+    else
+        return value.Get<const T&>();
+}
+
+}
+
+/// Template implementation of the typed attribute accessor. Binary serialization and network change checks use the value directly, without conversion to Variant.
+template <class TClassType, class T, class TGetFunction, class TSetFunction>
+class TypedAttributeAccessorImpl : public AttributeAccessor
+{
+public:
+    /// Construct.
+    TypedAttributeAccessorImpl(TGetFunction getFunction, TSetFunction setFunction) : getFunction_(getFunction), setFunction_(setFunction) { }
+
+    /// Invoke getter function.
+    void Get(const Serializable* ptr, Variant& value) const override
+    {
+        assert(ptr);
+        const auto classPtr = static_cast<const TClassType*>(ptr);
+        value = getFunction_(*classPtr);
+    }
+
+    /// Invoke setter function.
+    void Set(Serializable* ptr, const Variant& value) override
+    {
+        assert(ptr);
+        auto classPtr = static_cast<TClassType*>(ptr);
+        setFunction_(*classPtr, value.Get<T>());
+    }
+
+    /// Return whether the attribute can be serialized and compared directly.
+    bool IsTyped() const override { return true; }
+
+    /// Serialize the attribute value directly from/to archive.
+    bool Serialize(Serializable* ptr, Archive& archive, const char* name) override
+    {
+        assert(ptr);
+        auto classPtr = static_cast<TClassType*>(ptr);
+        if (archive.IsInput())
+        {
+            T value{};
+            if (!SerializeValue(archive, name, value))
+                return false;
+            setFunction_(*classPtr, value);
+            return true;
+        }
+        else
+        {
+            const T& value = getFunction_(*classPtr);
+            return SerializeValue(archive, name, const_cast<T&>(value));
+        }
+    }
+
+    /// Compare the attribute value with the variant without conversion.
+    bool Equals(const Serializable* ptr, const Variant& value) const override
+    {
+        assert(ptr);
+        if (value.GetType() != GetVariantType<T>())
+            return false;
+
+        const auto classPtr = static_cast<const TClassType*>(ptr);
+        const T& attributeValue = getFunction_(*classPtr);
+        return attributeValue == Detail::GetTypedAttributeValue<T>(value);
+    }
+
+private:
+    /// Get functor.
+    TGetFunction getFunction_;
+    /// Set functor.
+    TSetFunction setFunction_;
+};
+
+/// Make typed attribute accessor implementation, or variant attribute accessor if the type is not supported by typed accessors.
+/// \tparam TClassType Serializable class type.
+/// \tparam T Attribute value type.
+/// \tparam TGetFunction Functional object with call signature `T getFunction(const TClassType& self)`, may return by reference.
+/// \tparam TSetFunction Functional object with call signature `void setFunction(TClassType& self, const T& value)`
+template <class TClassType, class T, class TGetFunction, class TSetFunction>
+SharedPtr<AttributeAccessor> MakeTypedAttributeAccessor(TGetFunction getFunction, TSetFunction setFunction)
+{
+    if constexpr (IsTypedAttributeType<T>::value)
+        return SharedPtr<AttributeAccessor>(new TypedAttributeAccessorImpl<TClassType, T, TGetFunction, TSetFunction>(getFunction, setFunction));
+    else
+    {
+        return MakeVariantAttributeAccessor<TClassType>(
+            [getFunction](const TClassType& self, Variant& value) { value = getFunction(self); },
+            [setFunction](TClassType& self, const Variant& value) { setFunction(self, value.Get<T>()); });
+    }
+}
+
 /// Make member attribute accessor.
-#define URHO3D_MAKE_MEMBER_ATTRIBUTE_ACCESSOR(typeName, variable) Urho3D::MakeVariantAttributeAccessor<ClassName>( \
-    [](const ClassName& self, Urho3D::Variant& value) { value = self.variable; }, \
-    [](ClassName& self, const Urho3D::Variant& value) { self.variable = value.Get<typeName>(); })
+#define URHO3D_MAKE_MEMBER_ATTRIBUTE_ACCESSOR(typeName, variable) Urho3D::MakeTypedAttributeAccessor<ClassName, typeName >( \
+    [](const ClassName& self) -> decltype(auto) { return (self.variable); }, \
+    [](ClassName& self, const typeName& value) { self.variable = value; })
 
 /// Make member attribute accessor with custom post-set callback.
-#define URHO3D_MAKE_MEMBER_ATTRIBUTE_ACCESSOR_EX(typeName, variable, postSetCallback) Urho3D::MakeVariantAttributeAccessor<ClassName>( \
-    [](const ClassName& self, Urho3D::Variant& value) { value = self.variable; }, \
-    [](ClassName& self, const Urho3D::Variant& value) { self.variable = value.Get<typeName>(); self.postSetCallback(); })
+#define URHO3D_MAKE_MEMBER_ATTRIBUTE_ACCESSOR_EX(typeName, variable, postSetCallback) Urho3D::MakeTypedAttributeAccessor<ClassName, typeName >( \
+    [](const ClassName& self) -> decltype(auto) { return (self.variable); }, \
+    [](ClassName& self, const typeName& value) { self.variable = value; self.postSetCallback(); })
 
 /// Make custom member attribute accessor.
 #define URHO3D_MAKE_CUSTOM_MEMBER_ATTRIBUTE_ACCESSOR(typeName, variable) Urho3D::MakeVariantAttributeAccessor<ClassName>( \
@@ -219,9 +351,9 @@ SharedPtr<AttributeAccessor> MakeVariantAttributeAccessor(TGetFunction getFuncti
     [](ClassName& self, const Urho3D::Variant& value) { self.variable = value.GetCustom<typeName>(); })
 
 /// Make get/set attribute accessor.
-#define URHO3D_MAKE_GET_SET_ATTRIBUTE_ACCESSOR(getFunction, setFunction, typeName) Urho3D::MakeVariantAttributeAccessor<ClassName>( \
-    [](const ClassName& self, Urho3D::Variant& value) { value = self.getFunction(); }, \
-    [](ClassName& self, const Urho3D::Variant& value) { self.setFunction(value.Get<typeName>()); })
+#define URHO3D_MAKE_GET_SET_ATTRIBUTE_ACCESSOR(getFunction, setFunction, typeName) Urho3D::MakeTypedAttributeAccessor<ClassName, typeName >( \
+    [](const ClassName& self) -> decltype(auto) { return self.getFunction(); }, \
+    [](ClassName& self, const typeName& value) { self.setFunction(value); })
 
 /// Make member enum attribute accessor.
 #define URHO3D_MAKE_MEMBER_ENUM_ATTRIBUTE_ACCESSOR(variable) Urho3D::MakeVariantAttributeAccessor<ClassName>( \
@@ -243,6 +375,10 @@ namespace AttributeMetadata
 {
     /// Names of vector struct elements. StringVector.
     static const StringHash P_VECTOR_STRUCT_ELEMENTS = "VectorStructElements";
+    /// Number of bits per component for quantized network replication of float, vector and quaternion attributes. int.
+    static const StringHash P_NETWORK_QUANTIZATION_BITS = "NetworkQuantizationBits";
+    /// Range of quantized float and vector components as minimum and maximum. Vector2. Quaternions always use smallest three encoding.
+    static const StringHash P_NETWORK_QUANTIZATION_RANGE = "NetworkQuantizationRange";
 }
 
 // The following macros need to be used within a class member function such as ClassName::RegisterObject().
@@ -32,6 +32,50 @@
 namespace Urho3D
 {
 
+/// Interpolate between two buffered positions.
+static Vector3 InterpolateSample(const Vector3& lhs, const Vector3& rhs, float t) { return lhs.Lerp(rhs, t); }
+
+/// Interpolate between two buffered rotations.
+static Quaternion InterpolateSample(const Quaternion& lhs, const Quaternion& rhs, float t) { return lhs.Slerp(rhs, t); }
+
+/// Add a received target to the interpolation buffer.
+template <class T> static void AddSample(ea::vector<ea::pair<float, T>>& samples, float time, float delay, const T& currentValue, const T& value)
+{
+    // Idle buffer restarts from the current value, so that motion does not resume with a jump
+    const float playbackTime = time - delay;
+    if (samples.empty())
+        samples.emplace_back(playbackTime, currentValue);
+    else if (samples.back().first < playbackTime)
+        samples.back().first = playbackTime;
+
+    samples.emplace_back(time, value);
+}
+
+/// Sample the interpolation buffer at given time and drop samples no longer needed. Return true if playback reached the last sample.
+/// Return false and leave the value unchanged if the buffer is empty.
+template <class T> static bool SampleBuffer(ea::vector<ea::pair<float, T>>& samples, float time, T& value)
+{
+    if (samples.empty())
+        return false;
+
+    unsigned numExpired = 0;
+    while (numExpired + 1 < samples.size() && samples[numExpired + 1].first <= time)
+        ++numExpired;
+    samples.erase(samples.begin(), samples.begin() + numExpired);
+
+    if (samples.size() == 1)
+    {
+        value = samples.front().second;
+        return true;
+    }
+
+    const ea::pair<float, T>& from = samples[0];
+    const ea::pair<float, T>& to = samples[1];
+    const float t = to.first > from.first ? Clamp((time - from.first) / (to.first - from.first), 0.0f, 1.0f) : 1.0f;
+    value = InterpolateSample(from.second, to.second, t);
+    return false;
+}
+
 SmoothedTransform::SmoothedTransform(Context* context) :
     Component(context),
     targetPosition_(Vector3::ZERO),
@@ -50,7 +94,9 @@ void SmoothedTransform::RegisterObject(Context* context)
 
 void SmoothedTransform::Update(float constant, float squaredSnapThreshold)
 {
-    if (smoothingMask_ && node_)
+    if (interpolationDelay_ > 0.0f)
+        UpdateInterpolation(squaredSnapThreshold);
+    else if (smoothingMask_ && node_)
     {
         Vector3 position = node_->GetPosition();
         Quaternion rotation = node_->GetRotation();
@@ -96,8 +142,72 @@ void SmoothedTransform::Update(float constant, float squaredSnapThreshold)
     }
 }
 
+void SmoothedTransform::UpdateInterpolation(float squaredSnapThreshold)
+{
+    if (!smoothingMask_ || !node_)
+        return;
+
+    const float playbackTime = GetSampleTime() - interpolationDelay_;
+
+    // Targets set while the node was not assigned have no samples, so there is nothing to interpolate: snap to them
+    if ((smoothingMask_ & SMOOTH_POSITION) && positionSamples_.empty())
+    {
+        node_->SetPosition(targetPosition_);
+        smoothingMask_ &= ~SMOOTH_POSITION;
+    }
+    if ((smoothingMask_ & SMOOTH_ROTATION) && rotationSamples_.empty())
+    {
+        node_->SetRotation(targetRotation_);
+        smoothingMask_ &= ~SMOOTH_ROTATION;
+    }
+
+    if (smoothingMask_ & SMOOTH_POSITION)
+    {
+        // If the buffered motion snaps, snap everything to the end
+        if (positionSamples_.size() > 1 &&
+            (positionSamples_.back().second - positionSamples_.front().second).LengthSquared() > squaredSnapThreshold)
+            positionSamples_.erase(positionSamples_.begin(), positionSamples_.end() - 1);
+
+        Vector3 position;
+        if (SampleBuffer(positionSamples_, playbackTime, position))
+        {
+            positionSamples_.clear();
+            smoothingMask_ &= ~SMOOTH_POSITION;
+        }
+        node_->SetPosition(position);
+    }
+
+    if (smoothingMask_ & SMOOTH_ROTATION)
+    {
+        Quaternion rotation;
+        if (SampleBuffer(rotationSamples_, playbackTime, rotation))
+        {
+            rotationSamples_.clear();
+            smoothingMask_ &= ~SMOOTH_ROTATION;
+        }
+        node_->SetRotation(rotation);
+    }
+}
+
+float SmoothedTransform::GetSampleTime() const
+{
+    Scene* scene = GetScene();
+    return scene ? scene->GetElapsedTime() : 0.0f;
+}
+
+void SmoothedTransform::SetInterpolationDelay(float delay)
+{
+    interpolationDelay_ = Max(delay, 0.0f);
+    positionSamples_.clear();
+    rotationSamples_.clear();
+    smoothingMask_ = SMOOTH_NONE;
+}
+
 void SmoothedTransform::SetTargetPosition(const Vector3& position)
 {
+    if (interpolationDelay_ > 0.0f && node_)
+        AddSample(positionSamples_, GetSampleTime(), interpolationDelay_, node_->GetPosition(), position);
+
     targetPosition_ = position;
     smoothingMask_ |= SMOOTH_POSITION;
 
@@ -113,6 +223,9 @@ void SmoothedTransform::SetTargetPosition(const Vector3& position)
 
 void SmoothedTransform::SetTargetRotation(const Quaternion& rotation)
 {
+    if (interpolationDelay_ > 0.0f && node_)
+        AddSample(rotationSamples_, GetSampleTime(), interpolationDelay_, node_->GetRotation(), rotation);
+
     targetRotation_ = rotation;
     smoothingMask_ |= SMOOTH_ROTATION;
 
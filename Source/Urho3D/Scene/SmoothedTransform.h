@@ -63,6 +63,8 @@ public:
     void SetTargetWorldPosition(const Vector3& position);
     /// Set target rotation in world space.
     void SetTargetWorldRotation(const Quaternion& rotation);
+    /// Set snapshot interpolation delay in seconds. When non-zero, received targets are buffered and played back this much later, interpolating between them, instead of exponential smoothing. Should be at least two network update intervals. Default 0.
+    void SetInterpolationDelay(float delay);
 
     /// Return target position in parent space.
     const Vector3& GetTargetPosition() const { return targetPosition_; }
@@ -75,6 +77,9 @@ public:
     /// Return target rotation in world space.
     Quaternion GetTargetWorldRotation() const;
 
+    /// Return snapshot interpolation delay.
+    float GetInterpolationDelay() const { return interpolationDelay_; }
+
     /// Return whether smoothing is in progress.
     bool IsInProgress() const { return smoothingMask_ != SMOOTH_NONE; }
 
@@ -85,11 +90,21 @@ protected:
 private:
     /// Handle smoothing update event.
     void HandleUpdateSmoothing(StringHash eventType, VariantMap& eventData);
+    /// Update snapshot interpolation.
+    void UpdateInterpolation(float squaredSnapThreshold);
+    /// Return current time for snapshot interpolation.
+    float GetSampleTime() const;
 
     /// Target position.
     Vector3 targetPosition_;
     /// Target rotation.
     Quaternion targetRotation_;
+    /// Snapshot interpolation delay.
+    float interpolationDelay_{};
+    /// Buffered target positions and their receive times for snapshot interpolation.
+    ea::vector<ea::pair<float, Vector3>> positionSamples_;
+    /// Buffered target rotations and their receive times for snapshot interpolation.
+    ea::vector<ea::pair<float, Quaternion>> rotationSamples_;
     /// Active smoothing operations bitmask.
     SmoothingTypeFlags smoothingMask_;
     /// Subscribed to smoothing update event flag.
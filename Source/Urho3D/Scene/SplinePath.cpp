@@ -33,6 +33,11 @@ namespace Urho3D
 extern const char* interpolationModeNames[];
 extern const char* LOGIC_CATEGORY;
 
+/// Arc length table samples per knot.
+static const unsigned ARC_LENGTH_SAMPLES_PER_KNOT = 32;
+/// Minimum arc length table samples.
+static const unsigned MIN_ARC_LENGTH_SAMPLES = 64;
+
 static const StringVector controlPointsStructureElementNames =
 {
     "Control Point Count",
@@ -219,9 +224,57 @@ Vector3 SplinePath::GetPoint(float factor) const
     return spline_.GetPoint(factor).GetVector3();
 }
 
+float SplinePath::GetFactorAtDistance(float distance) const
+{
+    unsigned segmentHint = 0;
+    return GetFactorAtDistance(distance, segmentHint);
+}
+
+Vector3 SplinePath::GetPointAtDistance(float distance) const
+{
+    return GetPoint(GetFactorAtDistance(distance));
+}
+
+void SplinePath::GetPointsAtDistances(const float* distances, Vector3* points, unsigned count) const
+{
+    unsigned segmentHint = 0;
+    for (unsigned i = 0; i < count; ++i)
+        points[i] = GetPoint(GetFactorAtDistance(distances[i], segmentHint));
+}
+
+float SplinePath::GetFactorAtDistance(float distance, unsigned& segmentHint) const
+{
+    UpdateArcLengths();
+
+    if (arcLengths_.size() < 2 || length_ <= 0.0f || distance <= 0.0f)
+        return 0.0f;
+    if (distance >= length_)
+        return 1.0f;
+
+    // Check the hinted segment and its successor first, then fall back to binary search
+    const unsigned numSegments = arcLengths_.size() - 1;
+    unsigned segment = segmentHint < numSegments ? segmentHint : 0;
+    if (!(arcLengths_[segment] <= distance && distance < arcLengths_[segment + 1]))
+    {
+        if (segment + 2 <= numSegments && arcLengths_[segment + 1] <= distance && distance < arcLengths_[segment + 2])
+            ++segment;
+        else
+        {
+            const auto upper = ea::upper_bound(arcLengths_.begin(), arcLengths_.end(), distance);
+            segment = Min(static_cast<unsigned>(upper - arcLengths_.begin()), numSegments) - 1;
+        }
+    }
+    segmentHint = segment;
+
+    const float segmentStart = arcLengths_[segment];
+    const float segmentLength = arcLengths_[segment + 1] - segmentStart;
+    const float fraction = segmentLength > M_EPSILON ? (distance - segmentStart) / segmentLength : 0.0f;
+    return (segment + fraction) / numSegments;
+}
+
 void SplinePath::Move(float timeStep)
 {
-    if (traveled_ >= 1.0f || length_ <= 0.0f || !controlledNode_)
+    if (traveled_ >= 1.0f || GetLength() <= 0.0f || !controlledNode_)
         return;
 
     elapsedTime_ += timeStep;
@@ -230,7 +283,7 @@ void SplinePath::Move(float timeStep)
     float distanceCovered = elapsedTime_ * speed_;
     traveled_ = distanceCovered / length_;
 
-    controlledNode_->SetWorldPosition(GetPoint(traveled_));
+    controlledNode_->SetWorldPosition(GetPointAtDistance(distanceCovered));
 }
 
 void SplinePath::Reset()
@@ -340,16 +393,33 @@ void SplinePath::UpdateNodeIds()
 
 void SplinePath::CalculateLength()
 {
-    if (spline_.GetKnots().size() <= 0)
+    // Control points may move several times per frame, so defer sampling until the length is actually needed
+    arcLengthsDirty_ = true;
+}
+
+void SplinePath::UpdateArcLengths() const
+{
+    if (!arcLengthsDirty_)
         return;
 
+    arcLengthsDirty_ = false;
+    arcLengths_.clear();
     length_ = 0.f;
 
-    Vector3 a = spline_.GetKnot(0).GetVector3();
-    for (auto i = 0; i <= 1000; ++i)
+    const unsigned numKnots = spline_.GetKnots().size();
+    if (numKnots < 2)
+        return;
+
+    const unsigned numSamples = Max(numKnots * ARC_LENGTH_SAMPLES_PER_KNOT, MIN_ARC_LENGTH_SAMPLES);
+    arcLengths_.reserve(numSamples + 1);
+    arcLengths_.push_back(0.f);
+
+    Vector3 a = GetPoint(0.f);
+    for (unsigned i = 1; i <= numSamples; ++i)
     {
-        Vector3 b = spline_.GetPoint(i / 1000.f).GetVector3();
-        length_ += Abs((a - b).Length());
+        Vector3 b = GetPoint(static_cast<float>(i) / numSamples);
+        length_ += (b - a).Length();
+        arcLengths_.push_back(length_);
         a = b;
     }
 }
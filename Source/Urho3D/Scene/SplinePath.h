@@ -80,16 +80,22 @@ public:
     float GetSpeed() const { return speed_; }
 
     /// Get the length of SplinePath.
-    float GetLength() const { return length_; }
+    float GetLength() const { UpdateArcLengths(); return length_; }
 
     /// Get the parent Node's last position on the spline.
-    Vector3 GetPosition() const { return GetPoint(traveled_); }
+    Vector3 GetPosition() const { return GetPointAtDistance(traveled_ * GetLength()); }
 
     /// Get the controlled Node.
     Node* GetControlledNode() const { return controlledNode_; }
 
     /// Get a point on the SplinePath from 0.f to 1.f where 0 is the start and 1 is the end.
     Vector3 GetPoint(float factor) const;
+    /// Get the spline factor at the given distance along the SplinePath.
+    float GetFactorAtDistance(float distance) const;
+    /// Get a point at the given distance along the SplinePath.
+    Vector3 GetPointAtDistance(float distance) const;
+    /// Get points at the given distances along the SplinePath. Distances in ascending order are resolved fastest.
+    void GetPointsAtDistances(const float* distances, Vector3* points, unsigned count) const;
 
     /// Move the controlled Node to the next position along the SplinePath based off the Speed value.
     void Move(float timeStep);
@@ -120,8 +126,12 @@ protected:
 private:
     /// Update the Node IDs of the Control Points.
     void UpdateNodeIds();
-    /// Calculate the length of the SplinePath. Used for movement calculations.
+    /// Mark the arc length table for rebuild. Used for movement calculations.
     void CalculateLength();
+    /// Rebuild the arc length table if dirty.
+    void UpdateArcLengths() const;
+    /// Map distance to spline factor, starting the search from the hinted table segment.
+    float GetFactorAtDistance(float distance, unsigned& segmentHint) const;
 
     /// The Control Points of the Spline.
     Spline spline_;
@@ -132,7 +142,11 @@ private:
     /// The fraction of the SplinePath covered.
     float traveled_;
     /// The length of the SplinePath.
-    float length_;
+    mutable float length_;
+    /// Cumulative arc length at evenly spaced spline factors.
+    mutable ea::vector<float> arcLengths_;
+    /// Whether the arc length table needs rebuilding.
+    mutable bool arcLengthsDirty_{};
     /// Whether the Control Point IDs are dirty.
     bool dirty_;
     /// Node to be moved along the SplinePath.
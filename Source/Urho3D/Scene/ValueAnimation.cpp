@@ -405,12 +405,19 @@ bool ValueAnimation::IsValid() const
 
 Variant ValueAnimation::GetAnimationValue(float scaledTime) const
 {
-    unsigned index = 1;
-    for (; index < keyFrames_.size(); ++index)
-    {
-        if (scaledTime < keyFrames_[index].time_)
-            break;
-    }
+    unsigned keyFrameHint = 1;
+    return GetAnimationValue(scaledTime, keyFrameHint);
+}
+
+Variant ValueAnimation::GetAnimationValue(float scaledTime, unsigned& keyFrameHint) const
+{
+    // Find first key frame after the time, key frames are sorted
+    unsigned index = Clamp(keyFrameHint, 1U, Max(static_cast<unsigned>(keyFrames_.size()), 1U));
+    while (index > 1 && scaledTime < keyFrames_[index - 1].time_)
+        --index;
+    while (index < keyFrames_.size() && scaledTime >= keyFrames_[index].time_)
+        ++index;
+    keyFrameHint = index;
 
     if (index >= keyFrames_.size() || !interpolatable_ || interpolationMethod_ == IM_NONE)
         return keyFrames_[index - 1].value_;
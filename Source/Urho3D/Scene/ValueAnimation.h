@@ -134,6 +134,9 @@ public:
 
     /// Return animation value.
     Variant GetAnimationValue(float scaledTime) const;
+    /// Return animation value. Key frame search starts from the hint, which is updated to the found key frame. Lets
+    /// animation instances which advance time continuously find the key frame in constant time.
+    Variant GetAnimationValue(float scaledTime, unsigned& keyFrameHint) const;
 
     /// Return all key frames.
     const ea::vector<VAnimKeyFrame>& GetKeyFrames() const { return keyFrames_; }
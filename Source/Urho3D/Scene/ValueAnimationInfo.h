@@ -94,6 +94,8 @@ protected:
     float currentTime_;
     /// Last scaled time.
     float lastScaledTime_;
+    /// Key frame found by the last update.
+    unsigned keyFrameHint_{1};
 };
 
 }
@@ -25,12 +25,20 @@
 
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
+#include "../Core/MemoryTracker.h"
 #include "../Core/Profiler.h"
 #include "../Engine/Engine.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Renderer.h"
 #include "../Graphics/GraphicsEvents.h"
+#include "../Graphics/GPUProfiler.h"
+#include "../Graphics/RenderStatistics.h"
 #include "../IO/Log.h"
+#ifdef URHO3D_NETWORK
+#include "../Network/Connection.h"
+#include "../Network/Network.h"
+#endif
+#include "../Resource/ResourceCache.h"
 #include "../UI/UI.h"
 #include "../SystemUI/SystemUI.h"
 #include "../SystemUI/DebugHud.h"
@@ -72,6 +80,18 @@ DebugHud::~DebugHud()
 void DebugHud::SetMode(DebugHudModeFlags mode)
 {
     mode_ = mode;
+
+    if (mode_ & DEBUGHUD_SHOW_GPU)
+    {
+        if (auto* renderer = GetSubsystem<Renderer>())
+            renderer->SetGPUProfiling(true);
+    }
+
+    if (mode_ & DEBUGHUD_SHOW_RENDER)
+    {
+        if (auto* renderer = GetSubsystem<Renderer>())
+            renderer->SetRenderStatistics(true);
+    }
 }
 
 void DebugHud::CycleMode()
@@ -182,6 +202,38 @@ void DebugHud::RenderUI(DebugHudModeFlags mode)
         }
     }
 
+    if (mode & DEBUGHUD_SHOW_MEMORY)
+    {
+        ResourceCache* cache = GetSubsystem<ResourceCache>();
+        ui::TextUnformatted(cache->PrintMemoryUsage().c_str());
+        ui::TextUnformatted(MemoryTracker::PrintStatistics().c_str());
+    }
+
+    if (mode & DEBUGHUD_SHOW_GPU)
+    {
+        if (GPUProfiler* gpuProfiler = renderer ? renderer->GetGPUProfiler() : nullptr)
+            ui::TextUnformatted(gpuProfiler->PrintData().c_str());
+    }
+
+    if (mode & DEBUGHUD_SHOW_RENDER)
+    {
+        if (RenderStatistics* statistics = renderer ? renderer->GetRenderStatistics() : nullptr)
+            ui::TextUnformatted(statistics->PrintData().c_str());
+    }
+
+#ifdef URHO3D_NETWORK
+    if (mode & DEBUGHUD_SHOW_NETWORK)
+    {
+        if (auto* network = GetSubsystem<Network>())
+        {
+            if (Connection* serverConnection = network->GetServerConnection())
+                ui::TextUnformatted(serverConnection->PrintStatistics().c_str());
+            for (const SharedPtr<Connection>& connection : network->GetClientConnections())
+                ui::TextUnformatted(connection->PrintStatistics().c_str());
+        }
+    }
+#endif
+
     if (mode & DEBUGHUD_SHOW_MODE)
     {
         const ImGuiStyle& style = ui::GetStyle();
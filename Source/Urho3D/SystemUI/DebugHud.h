@@ -38,7 +38,11 @@ enum DebugHudMode : unsigned
     DEBUGHUD_SHOW_NONE = 0x0,
     DEBUGHUD_SHOW_STATS = 0x1,
     DEBUGHUD_SHOW_MODE = 0x2,
-    DEBUGHUD_SHOW_ALL = 0x7,
+    DEBUGHUD_SHOW_MEMORY = 0x4,
+    DEBUGHUD_SHOW_NETWORK = 0x8,
+    DEBUGHUD_SHOW_GPU = 0x10,
+    DEBUGHUD_SHOW_RENDER = 0x20,
+    DEBUGHUD_SHOW_ALL = 0x3f,
 };
 URHO3D_FLAGSET(DebugHudMode, DebugHudModeFlags);
 
@@ -53,7 +57,7 @@ public:
     /// Destruct.
     ~DebugHud() override;
 
-    /// Set elements to show.
+    /// Set elements to show. Showing DEBUGHUD_SHOW_GPU enables GPU profiling and DEBUGHUD_SHOW_RENDER enables render statistics in the renderer.
     /// \param mode is a combination of DEBUGHUD_SHOW_* flags.
     void SetMode(DebugHudModeFlags mode);
     /// Cycle through elements
@@ -52,6 +52,17 @@ URHO3D_EVENT(E_ATTRIBUTEINSPECTVALUEMODIFIED, AttributeInspectorValueModified)
     URHO3D_PARAM(P_REASON, Reason);                              // unsigned
 }
 
+/// Attribute of multiple objects of the same type was modified at once.
+URHO3D_EVENT(E_ATTRIBUTEINSPECTVALUESMODIFIED, AttributeInspectorValuesModified)
+{
+    URHO3D_PARAM(P_SERIALIZABLES, Serializables);                // ea::vector<Serializable*> pointer
+    URHO3D_PARAM(P_ATTRIBUTEINFO, AttributeInfo);                // AttributeInfo pointer
+    URHO3D_PARAM(P_ATTRIBUTEINDEX, AttributeIndex);              // unsigned
+    URHO3D_PARAM(P_OLDVALUES, OldValues);                        // ea::vector<Variant> pointer, one value per object
+    URHO3D_PARAM(P_NEWVALUE, NewValue);                          // Variant
+    URHO3D_PARAM(P_REASON, Reason);                              // unsigned
+}
+
 URHO3D_EVENT(E_ATTRIBUTEINSPECTOATTRIBUTE, AttributeInspectorAttribute)
 {
     URHO3D_PARAM(P_SERIALIZABLE, Serializable);                  // Serializable pointer
@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Container/Hash.h"
 #include "../Core/Context.h"
 #include "../IO/Log.h"
 #include "../Graphics/Texture2D.h"
@@ -34,6 +35,22 @@
 namespace Urho3D
 {
 
+/// Maximum number of cached text layouts per font face.
+static const unsigned FONT_TEXT_LAYOUT_CACHE_SIZE = 1024;
+/// Maximum length of a cached text layout.
+static const unsigned FONT_TEXT_LAYOUT_MAX_LENGTH = 256;
+
+/// Return hash of a text layout cache key.
+static unsigned GetTextLayoutHash(const ea::vector<unsigned>& text, int maxWidth, int rowHeight)
+{
+    unsigned hash = text.size();
+    CombineHash(hash, (unsigned)maxWidth);
+    CombineHash(hash, (unsigned)rowHeight);
+    for (unsigned c : text)
+        CombineHash(hash, c);
+    return hash;
+}
+
 FontFace::FontFace(Font* font) :
     font_(font)
 {
@@ -84,6 +101,43 @@ float FontFace::GetKerning(unsigned c, unsigned d) const
     return 0;
 }
 
+const FontTextLayout* FontFace::GetTextLayout(const ea::vector<unsigned>& text, int maxWidth, int rowHeight)
+{
+    // Layouts made with placeholder glyphs are stale
+    if (textLayoutRevision_ != glyphRevision_)
+    {
+        textLayouts_.clear();
+        textLayoutRevision_ = glyphRevision_;
+        return nullptr;
+    }
+
+    if (text.size() > FONT_TEXT_LAYOUT_MAX_LENGTH)
+        return nullptr;
+
+    auto i = textLayouts_.find(GetTextLayoutHash(text, maxWidth, rowHeight));
+    if (i == textLayouts_.end())
+        return nullptr;
+
+    const FontTextLayout& layout = i->second;
+    if (layout.maxWidth_ != maxWidth || layout.rowHeight_ != rowHeight || layout.text_ != text)
+        return nullptr;
+
+    return &layout;
+}
+
+void FontFace::StoreTextLayout(FontTextLayout layout)
+{
+    if (layout.text_.size() > FONT_TEXT_LAYOUT_MAX_LENGTH || textLayoutRevision_ != glyphRevision_)
+        return;
+
+    // Texts that change every frame would grow the cache without bound, so start over when full
+    if (textLayouts_.size() >= FONT_TEXT_LAYOUT_CACHE_SIZE)
+        textLayouts_.clear();
+
+    const unsigned hash = GetTextLayoutHash(layout.text_, layout.maxWidth_, layout.rowHeight_);
+    textLayouts_[hash] = ea::move(layout);
+}
+
 bool FontFace::IsDataLost() const
 {
     for (unsigned i = 0; i < textures_.size(); ++i)
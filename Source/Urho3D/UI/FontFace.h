@@ -23,6 +23,7 @@
 #pragma once
 
 #include <EASTL/unordered_map.h>
+#include <EASTL/vector.h>
 
 #include <Urho3D/Urho3D.h>
 
@@ -63,6 +64,27 @@ struct URHO3D_API FontGlyph
     bool used_{};
 };
 
+/// Text layout cached by a font face, reused by texts with the same contents and layout parameters.
+struct URHO3D_API FontTextLayout
+{
+    /// Source text.
+    ea::vector<unsigned> text_;
+    /// Maximum row width for word wrap, M_MAX_INT when not wrapped.
+    int maxWidth_{};
+    /// Row height including row spacing.
+    int rowHeight_{};
+    /// Printed text with word wrap line breaks.
+    ea::vector<unsigned> printText_;
+    /// Source text index of each printed char.
+    ea::vector<unsigned> printToText_;
+    /// Row widths.
+    ea::vector<float> rowWidths_;
+    /// Text width.
+    int width_{};
+    /// Text height.
+    int height_{};
+};
+
 /// %Font face description.
 class URHO3D_API FontFace : public RefCounted
 {
@@ -81,9 +103,15 @@ public:
 
     /// Return if font face uses mutable glyphs.
     virtual bool HasMutableGlyphs() const { return false; }
+    /// Finish the glyphs rasterized in the background. Return true if there still is pending work. Called by UI.
+    virtual bool UpdateAsyncGlyphs() { return false; }
 
     /// Return the kerning for a character and the next character.
     float GetKerning(unsigned c, unsigned d) const;
+    /// Return cached layout of a text, or null if not cached or the glyphs have changed since.
+    const FontTextLayout* GetTextLayout(const ea::vector<unsigned>& text, int maxWidth, int rowHeight);
+    /// Store layout of a text for reuse. Long texts are not cached.
+    void StoreTextLayout(FontTextLayout layout);
     /// Return true when one of the texture has a data loss.
     bool IsDataLost() const;
 
@@ -93,6 +121,9 @@ public:
     /// Return row height.
     float GetRowHeight() const { return rowHeight_; }
 
+    /// Return glyph revision, incremented when glyphs finish background rasterization and text using the face needs to be laid out again.
+    unsigned GetGlyphRevision() const { return glyphRevision_; }
+
     /// Return textures.
     const ea::vector<SharedPtr<Texture2D> >& GetTextures() const { return textures_; }
 
@@ -115,6 +146,12 @@ protected:
     float pointSize_{};
     /// Row height.
     float rowHeight_{};
+    /// Glyph revision.
+    unsigned glyphRevision_{};
+    /// Cached text layouts by hash of the text and layout parameters.
+    ea::unordered_map<unsigned, FontTextLayout> textLayouts_;
+    /// Glyph revision the cached text layouts were made with.
+    unsigned textLayoutRevision_{};
 };
 
 }
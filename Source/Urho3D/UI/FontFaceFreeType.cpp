@@ -23,6 +23,8 @@
 #include "../Precompiled.h"
 
 #include "../Core/Context.h"
+#include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Texture2D.h"
 #include "../IO/FileSystem.h"
@@ -36,6 +38,7 @@
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
+#include FT_ADVANCES_H
 #include FT_TRUETYPE_TABLES_H
 
 #include "../DebugNew.h"
@@ -43,6 +46,11 @@
 namespace Urho3D
 {
 
+/// Maximum number of glyphs rasterized by one background work item.
+static const unsigned FONT_ASYNC_GLYPH_BATCH_SIZE = 32;
+/// Chars below this code are rasterized when the face is loaded in asynchronous mode.
+static const unsigned FONT_ASYNC_PRELOAD_CHARS = 256;
+
 inline float FixedToFloat(FT_Pos value)
 {
     return value / 64.0f;
@@ -84,6 +92,13 @@ FontFaceFreeType::FontFaceFreeType(Font* font) :
 
 FontFaceFreeType::~FontFaceFreeType()
 {
+    CancelAsyncGlyphs();
+    if (asyncFace_)
+    {
+        FT_Done_Face((FT_Face)asyncFace_);
+        asyncFace_ = nullptr;
+    }
+
     if (face_)
     {
         FT_Done_Face((FT_Face)face_);
@@ -143,6 +158,21 @@ bool FontFaceFreeType::Load(const unsigned char* fontData, unsigned fontDataSize
 
     face_ = face;
 
+    // FreeType faces are not thread safe, so background rasterization uses a face of its own
+    if (ui->GetAsyncGlyphRasterization())
+    {
+        FT_Face asyncFace;
+        if (!FT_New_Memory_Face(library, fontData, fontDataSize, 0, &asyncFace))
+        {
+            if (!FT_Set_Char_Size(asyncFace, 0, pointSize * 64, oversampling_ * FONT_DPI, FONT_DPI))
+                asyncFace_ = asyncFace;
+            else
+                FT_Done_Face(asyncFace);
+        }
+        if (!asyncFace_)
+            URHO3D_LOGWARNING("Could not create font face for background rasterization, glyphs are rasterized when first used");
+    }
+
     auto numGlyphs = (unsigned)face->num_glyphs;
     URHO3D_LOGDEBUGF("Font face %s (%fpt) has %d glyphs", GetFileName(font_->GetName()).c_str(), pointSize, numGlyphs);
 
@@ -210,6 +240,10 @@ bool FontFaceFreeType::Load(const unsigned char* fontData, unsigned fontDataSize
         if (charCode == 0)
             continue;
 
+        // Leave the rest to the background rasterization, which avoids the load time spike of large character sets
+        if (asyncFace_ && charCode >= FONT_ASYNC_PRELOAD_CHARS)
+            continue;
+
         if (!LoadCharGlyph(charCode, image))
         {
             hasMutableGlyph_ = true;
@@ -296,7 +330,7 @@ bool FontFaceFreeType::Load(const unsigned char* fontData, unsigned fontDataSize
             URHO3D_LOGWARNING("Can not read kerning information: not version 0");
     }
 
-    if (!hasMutableGlyph_)
+    if (!hasMutableGlyph_ && !asyncFace_)
     {
         FT_Done_Face(face);
         face_ = nullptr;
@@ -315,6 +349,9 @@ const FontGlyph* FontFaceFreeType::GetGlyph(unsigned c)
         return &glyph;
     }
 
+    if (asyncFace_)
+        return GetAsyncGlyph(c);
+
     if (LoadCharGlyph(c))
     {
         auto i = glyphMapping_.find(c);
@@ -348,7 +385,7 @@ bool FontFaceFreeType::SetupNextTexture(int textureWidth, int textureHeight)
     return true;
 }
 
-void FontFaceFreeType::BoxFilter(unsigned char* dest, size_t destSize, const unsigned char* src, size_t srcSize)
+void FontFaceFreeType::BoxFilter(unsigned char* dest, size_t destSize, const unsigned char* src, size_t srcSize) const
 {
     const int filterSize = oversampling_;
 
@@ -412,14 +449,21 @@ bool FontFaceFreeType::LoadCharGlyph(unsigned charCode, Image* image)
     if (!face_)
         return false;
 
-    auto face = (FT_Face)face_;
-    FT_GlyphSlot slot = face->glyph;
-
     FontGlyph fontGlyph;
-    FT_Error error = FT_Load_Char(face, charCode, loadMode_ | FT_LOAD_RENDER);
+    RasterizeGlyph(face_, charCode, fontGlyph, glyphPixels_);
+    return PlaceGlyph(charCode, fontGlyph, glyphPixels_.data(), image);
+}
+
+void FontFaceFreeType::RasterizeGlyph(void* face, unsigned charCode, FontGlyph& fontGlyph, ea::vector<unsigned char>& pixels) const
+{
+    auto ftFace = (FT_Face)face;
+    FT_GlyphSlot slot = ftFace->glyph;
+
+    pixels.clear();
+    FT_Error error = FT_Load_Char(ftFace, charCode, loadMode_ | FT_LOAD_RENDER);
     if (error)
     {
-        const char* family = face->family_name ? face->family_name : "NULL";
+        const char* family = ftFace->family_name ? ftFace->family_name : "NULL";
         URHO3D_LOGERRORF("FT_Load_Char failed (family: %s, char code: %u)", family, charCode);
         fontGlyph.texWidth_ = 0;
         fontGlyph.texHeight_ = 0;
@@ -429,33 +473,65 @@ bool FontFaceFreeType::LoadCharGlyph(unsigned charCode, Image* image)
         fontGlyph.offsetY_ = 0;
         fontGlyph.advanceX_ = 0;
         fontGlyph.page_ = 0;
+        return;
+    }
+
+    // Note: position within texture will be filled later
+    fontGlyph.texWidth_ = slot->bitmap.width + oversampling_ - 1;
+    fontGlyph.texHeight_ = slot->bitmap.rows;
+    fontGlyph.width_ = slot->bitmap.width + oversampling_ - 1;
+    fontGlyph.height_ = slot->bitmap.rows;
+    fontGlyph.offsetX_ = slot->bitmap_left - (oversampling_ - 1) / 2.0f;
+    fontGlyph.offsetY_ = floorf(ascender_ + 0.5f) - slot->bitmap_top;
+
+    if (subpixel_ && slot->linearHoriAdvance)
+    {
+        // linearHoriAdvance is stored in 16.16 fixed point, not the usual 26.6
+        fontGlyph.advanceX_ = slot->linearHoriAdvance / 65536.0;
     }
     else
     {
-        // Note: position within texture will be filled later
-        fontGlyph.texWidth_ = slot->bitmap.width + oversampling_ - 1;
-        fontGlyph.texHeight_ = slot->bitmap.rows;
-        fontGlyph.width_ = slot->bitmap.width + oversampling_ - 1;
-        fontGlyph.height_ = slot->bitmap.rows;
-        fontGlyph.offsetX_ = slot->bitmap_left - (oversampling_ - 1) / 2.0f;
-        fontGlyph.offsetY_ = floorf(ascender_ + 0.5f) - slot->bitmap_top;
+        // Round to nearest pixel (only necessary when hinting is disabled)
+        fontGlyph.advanceX_ = floorf(FixedToFloat(slot->metrics.horiAdvance) + 0.5f);
+    }
+
+    fontGlyph.width_ /= oversampling_;
+    fontGlyph.offsetX_ /= oversampling_;
+    fontGlyph.advanceX_ /= oversampling_;
+
+    if (fontGlyph.texWidth_ <= 0 || fontGlyph.texHeight_ <= 0)
+        return;
+
+    const auto pitch = (unsigned)fontGlyph.texWidth_;
+    pixels.resize(pitch * fontGlyph.texHeight_);
+    unsigned char* dest = pixels.data();
 
-        if (subpixel_ && slot->linearHoriAdvance)
+    if (slot->bitmap.pixel_mode == FT_PIXEL_MODE_MONO)
+    {
+        memset(dest, 0, pixels.size());
+        for (unsigned y = 0; y < (unsigned)slot->bitmap.rows; ++y)
         {
-            // linearHoriAdvance is stored in 16.16 fixed point, not the usual 26.6
-            fontGlyph.advanceX_ = slot->linearHoriAdvance / 65536.0;
+            unsigned char* src = slot->bitmap.buffer + slot->bitmap.pitch * y;
+            unsigned char* rowDest = dest + (oversampling_ - 1)/2 + y * pitch;
+
+            // Don't do any oversampling, just unpack the bits directly.
+            for (unsigned x = 0; x < (unsigned)slot->bitmap.width; ++x)
+                rowDest[x] = (unsigned char)((src[x >> 3u] & (0x80u >> (x & 7u))) ? 255 : 0);
         }
-        else
+    }
+    else
+    {
+        for (unsigned y = 0; y < (unsigned)slot->bitmap.rows; ++y)
         {
-            // Round to nearest pixel (only necessary when hinting is disabled)
-            fontGlyph.advanceX_ = floorf(FixedToFloat(slot->metrics.horiAdvance) + 0.5f);
+            unsigned char* src = slot->bitmap.buffer + slot->bitmap.pitch * y;
+            unsigned char* rowDest = dest + y * pitch;
+            BoxFilter(rowDest, fontGlyph.texWidth_, src, slot->bitmap.width);
         }
-
-        fontGlyph.width_ /= oversampling_;
-        fontGlyph.offsetX_ /= oversampling_;
-        fontGlyph.advanceX_ /= oversampling_;
     }
+}
 
+bool FontFaceFreeType::PlaceGlyph(unsigned charCode, FontGlyph fontGlyph, const unsigned char* pixels, Image* image)
+{
     int x = 0, y = 0;
     if (fontGlyph.texWidth_ > 0 && fontGlyph.texHeight_ > 0)
     {
@@ -485,47 +561,20 @@ bool FontFaceFreeType::LoadCharGlyph(unsigned charCode, Image* image)
         fontGlyph.x_ = (short)x;
         fontGlyph.y_ = (short)y;
 
-        unsigned char* dest = nullptr;
-        unsigned pitch = 0;
         if (image)
         {
             fontGlyph.page_ = 0;
-            dest = image->GetData() + fontGlyph.y_ * image->GetWidth() + fontGlyph.x_;
-            pitch = (unsigned)image->GetWidth();
-        }
-        else
-        {
-            fontGlyph.page_ = textures_.size() - 1;
-            dest = new unsigned char[fontGlyph.texWidth_ * fontGlyph.texHeight_];
-            pitch = (unsigned)fontGlyph.texWidth_;
-        }
-
-        if (slot->bitmap.pixel_mode == FT_PIXEL_MODE_MONO)
-        {
-            for (unsigned y = 0; y < (unsigned)slot->bitmap.rows; ++y)
+            const auto imageWidth = (unsigned)image->GetWidth();
+            for (unsigned row = 0; row < (unsigned)fontGlyph.texHeight_; ++row)
             {
-                unsigned char* src = slot->bitmap.buffer + slot->bitmap.pitch * y;
-                unsigned char* rowDest = dest + (oversampling_ - 1)/2 + y * pitch;
-
-                // Don't do any oversampling, just unpack the bits directly.
-                for (unsigned x = 0; x < (unsigned)slot->bitmap.width; ++x)
-                    rowDest[x] = (unsigned char)((src[x >> 3u] & (0x80u >> (x & 7u))) ? 255 : 0);
+                memcpy(image->GetData() + (fontGlyph.y_ + row) * imageWidth + fontGlyph.x_, pixels + row * fontGlyph.texWidth_,
+                    (size_t)fontGlyph.texWidth_);
             }
         }
         else
         {
-            for (unsigned y = 0; y < (unsigned)slot->bitmap.rows; ++y)
-            {
-                unsigned char* src = slot->bitmap.buffer + slot->bitmap.pitch * y;
-                unsigned char* rowDest = dest + y * pitch;
-                BoxFilter(rowDest, fontGlyph.texWidth_, src, slot->bitmap.width);
-            }
-        }
-
-        if (!image)
-        {
-            textures_.back()->SetData(0, fontGlyph.x_, fontGlyph.y_, fontGlyph.texWidth_, fontGlyph.texHeight_, dest);
-            delete[] dest;
+            fontGlyph.page_ = textures_.size() - 1;
+            textures_.back()->SetData(0, fontGlyph.x_, fontGlyph.y_, fontGlyph.texWidth_, fontGlyph.texHeight_, pixels);
         }
     }
     else
@@ -540,4 +589,112 @@ bool FontFaceFreeType::LoadCharGlyph(unsigned charCode, Image* image)
     return true;
 }
 
+/// Glyphs rasterized in the background by a worker thread.
+struct FontFaceFreeType::AsyncGlyphBatch
+{
+    /// Parent face.
+    FontFaceFreeType* face_{};
+    /// Char codes.
+    ea::vector<unsigned> charCodes_;
+    /// Rasterized glyphs.
+    ea::vector<FontGlyph> glyphs_;
+    /// Rasterized glyph pixels.
+    ea::vector<ea::vector<unsigned char> > pixels_;
+    /// Work item.
+    SharedPtr<WorkItem> item_;
+};
+
+const FontGlyph* FontFaceFreeType::GetAsyncGlyph(unsigned charCode)
+{
+    auto i = placeholderMapping_.find(charCode);
+    if (i != placeholderMapping_.end())
+        return &i->second;
+
+    // The placeholder has the final advance, so text does not shift much when the glyph arrives. Nothing is drawn for it
+    auto face = (FT_Face)face_;
+    const FT_Int32 advanceFlags = loadMode_ | (subpixel_ ? FT_LOAD_NO_HINTING : 0);
+    FT_Fixed advance = 0;
+    FontGlyph placeholder;
+    if (!FT_Get_Advance(face, FT_Get_Char_Index(face, charCode), advanceFlags, &advance))
+    {
+        // Advance is in 16.16 fixed point
+        placeholder.advanceX_ = subpixel_ ? advance / 65536.0f : floorf(advance / 65536.0f + 0.5f);
+        placeholder.advanceX_ /= oversampling_;
+    }
+    placeholder.used_ = true;
+
+    asyncQueue_.push_back(charCode);
+    StartAsyncGlyphBatch();
+
+    return &(placeholderMapping_[charCode] = placeholder);
+}
+
+void FontFaceFreeType::StartAsyncGlyphBatch()
+{
+    if (asyncBatch_ || asyncQueue_.empty())
+        return;
+
+    if (auto* ui = font_->GetSubsystem<UI>())
+        ui->AddAsyncFontFace(this);
+
+    asyncBatch_ = ea::make_unique<AsyncGlyphBatch>();
+    asyncBatch_->face_ = this;
+    const unsigned numGlyphs = Min(asyncQueue_.size(), FONT_ASYNC_GLYPH_BATCH_SIZE);
+    asyncBatch_->charCodes_.assign(asyncQueue_.begin(), asyncQueue_.begin() + numGlyphs);
+    asyncQueue_.erase(asyncQueue_.begin(), asyncQueue_.begin() + numGlyphs);
+
+    // Use a private item, so that a pooled item can not be recycled before the batch is waited for
+    asyncBatch_->item_ = MakeShared<WorkItem>();
+    asyncBatch_->item_->aux_ = asyncBatch_.get();
+    asyncBatch_->item_->priority_ = 0;
+    asyncBatch_->item_->workFunction_ = [](const WorkItem* item, unsigned)
+    {
+        auto* batch = static_cast<AsyncGlyphBatch*>(item->aux_);
+        const unsigned numGlyphs = batch->charCodes_.size();
+        batch->glyphs_.resize(numGlyphs);
+        batch->pixels_.resize(numGlyphs);
+        for (unsigned i = 0; i < numGlyphs; ++i)
+            batch->face_->RasterizeGlyph(batch->face_->asyncFace_, batch->charCodes_[i], batch->glyphs_[i], batch->pixels_[i]);
+    };
+
+    auto* workQueue = font_->GetSubsystem<WorkQueue>();
+    if (workQueue)
+        workQueue->AddWorkItem(asyncBatch_->item_);
+    else
+    {
+        asyncBatch_->item_->workFunction_(asyncBatch_->item_, 0);
+        asyncBatch_->item_->completed_ = true;
+    }
+}
+
+bool FontFaceFreeType::UpdateAsyncGlyphs()
+{
+    if (asyncBatch_ && asyncBatch_->item_->completed_)
+    {
+        URHO3D_PROFILE("FinishAsyncGlyphs");
+
+        for (unsigned i = 0; i < asyncBatch_->charCodes_.size(); ++i)
+            PlaceGlyph(asyncBatch_->charCodes_[i], asyncBatch_->glyphs_[i], asyncBatch_->pixels_[i].data(), nullptr);
+        asyncBatch_.reset();
+        ++glyphRevision_;
+
+        StartAsyncGlyphBatch();
+    }
+
+    return asyncBatch_ != nullptr;
+}
+
+void FontFaceFreeType::CancelAsyncGlyphs()
+{
+    asyncQueue_.clear();
+    if (!asyncBatch_)
+        return;
+
+    // A batch that already started references this face, so wait for it
+    auto* workQueue = font_->GetSubsystem<WorkQueue>();
+    if (workQueue && !workQueue->RemoveWorkItem(asyncBatch_->item_))
+        workQueue->CompleteItem(asyncBatch_->item_);
+    asyncBatch_.reset();
+}
+
 }
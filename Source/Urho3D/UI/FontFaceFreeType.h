@@ -24,6 +24,8 @@
 
 #include "../UI/FontFace.h"
 
+#include <EASTL/unique_ptr.h>
+
 namespace Urho3D
 {
 
@@ -46,14 +48,28 @@ public:
 
     /// Return if font face uses mutable glyphs.
     bool HasMutableGlyphs() const override { return hasMutableGlyph_; }
+    /// Finish the glyphs rasterized in the background. Return true if there still is pending work.
+    bool UpdateAsyncGlyphs() override;
 
 private:
+    struct AsyncGlyphBatch;
+
     /// Setup next texture.
     bool SetupNextTexture(int textureWidth, int textureHeight);
     /// Load char glyph.
     bool LoadCharGlyph(unsigned charCode, Image* image = nullptr);
+    /// Render char glyph with a FreeType face into a tightly packed image of the glyph texture size. Does not touch the face state otherwise, so may be called from a worker thread with a face of its own.
+    void RasterizeGlyph(void* face, unsigned charCode, FontGlyph& fontGlyph, ea::vector<unsigned char>& pixels) const;
+    /// Allocate the texture area for a rasterized glyph, copy the pixels and store the glyph. Return false if rendering into a fixed image that is full.
+    bool PlaceGlyph(unsigned charCode, FontGlyph fontGlyph, const unsigned char* pixels, Image* image);
+    /// Return placeholder glyph for a char while it is rasterized in the background, queueing the rasterization if not yet queued.
+    const FontGlyph* GetAsyncGlyph(unsigned charCode);
+    /// Start rasterizing the next batch of queued glyphs in the background, if not already running.
+    void StartAsyncGlyphBatch();
+    /// Wait for the background rasterization to finish, discarding the results.
+    void CancelAsyncGlyphs();
     /// Smooth one row of a horizontally oversampled glyph image.
-    void BoxFilter(unsigned char* dest, size_t destSize, const unsigned char* src, size_t srcSize);
+    void BoxFilter(unsigned char* dest, size_t destSize, const unsigned char* src, size_t srcSize) const;
 
     /// FreeType library.
     SharedPtr<FreeTypeLibrary> freeType_;
@@ -71,6 +87,16 @@ private:
     bool hasMutableGlyph_{};
     /// Glyph area allocator.
     AreaAllocator allocator_;
+    /// Glyph pixel buffer used on the main thread.
+    ea::vector<unsigned char> glyphPixels_;
+    /// Second FreeType face used exclusively by background rasterization. Non-null only in asynchronous mode.
+    void* asyncFace_{};
+    /// Placeholder glyphs of chars queued or finished in background rasterization.
+    ea::unordered_map<unsigned, FontGlyph> placeholderMapping_;
+    /// Char codes waiting for background rasterization.
+    ea::vector<unsigned> asyncQueue_;
+    /// Batch of glyphs being rasterized in the background.
+    ea::unique_ptr<AsyncGlyphBatch> asyncBatch_;
 };
 
 }
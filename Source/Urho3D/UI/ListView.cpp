@@ -192,6 +192,7 @@ ListView::ListView(Context* context) :
     SubscribeToEvent(E_FOCUSCHANGED, URHO3D_HANDLER(ListView, HandleItemFocusChanged));
     SubscribeToEvent(this, E_DEFOCUSED, URHO3D_HANDLER(ListView, HandleFocusChanged));
     SubscribeToEvent(this, E_FOCUSED, URHO3D_HANDLER(ListView, HandleFocusChanged));
+    SubscribeToEvent(this, E_VIEWCHANGED, URHO3D_HANDLER(ListView, HandleViewChanged));
 
     UpdateUIClickSubscription();
 }
@@ -211,6 +212,8 @@ void ListView::RegisterObject(Context* context)
     URHO3D_ACCESSOR_ATTRIBUTE("Base Indent", GetBaseIndent, SetBaseIndent, int, 0, AM_FILE);
     URHO3D_ACCESSOR_ATTRIBUTE("Clear Sel. On Defocus", GetClearSelectionOnDefocus, SetClearSelectionOnDefocus, bool, false, AM_FILE);
     URHO3D_ACCESSOR_ATTRIBUTE("Select On Click End", GetSelectOnClickEnd, SetSelectOnClickEnd, bool, false, AM_FILE);
+    URHO3D_ACCESSOR_ATTRIBUTE("Virtual Mode", GetVirtualMode, SetVirtualMode, bool, false, AM_FILE);
+    URHO3D_ACCESSOR_ATTRIBUTE("Virtual Item Height", GetVirtualItemHeight, SetVirtualItemHeight, int, 20, AM_FILE);
 }
 
 void ListView::OnKey(Key key, MouseButtonFlags buttons, QualifierFlags qualifiers)
@@ -270,6 +273,13 @@ void ListView::OnKey(Key key, MouseButtonFlags buttons, QualifierFlags qualifier
                 // Convert page step to pixels and see how many items have to be skipped to reach that many pixels
                 if (selection == M_MAX_UNSIGNED)
                     selection = 0;      // Assume as if first item is selected
+                if (virtualMode_)
+                {
+                    // All rows have the same height and are visible, so the step is a whole number of rows
+                    const int stepRows = Max((int)(pageStep_ * scrollPanel_->GetHeight()) / virtualItemHeight_ - 1, 1);
+                    delta = pageDirection * stepRows;
+                    break;
+                }
                 int stepPixels = ((int)(pageStep_ * scrollPanel_->GetHeight())) - contentElement_->GetChild(selection)->GetHeight();
                 unsigned newSelection = selection;
                 unsigned okSelection = selection;
@@ -329,6 +339,8 @@ void ListView::OnResize(const IntVector2& newSize, const IntVector2& delta)
     // When in hierarchy mode also need to resize the overlay container
     if (hierarchyMode_)
         overlayContainer_->SetSize(scrollPanel_->GetSize());
+
+    UpdateVirtualItems(false);
 }
 
 void ListView::UpdateInternalLayout()
@@ -362,6 +374,12 @@ void ListView::InsertItem(unsigned index, UIElement* item, UIElement* parentItem
     if (!item || item->GetParent() == contentElement_)
         return;
 
+    if (virtualMode_)
+    {
+        URHO3D_LOGWARNING("ListView items can not be inserted in virtual mode, set the number of virtual items instead");
+        return;
+    }
+
     // Enable input so that clicking the item can be detected
     item->SetEnabled(true);
     item->SetSelected(false);
@@ -427,6 +445,12 @@ void ListView::RemoveItem(UIElement* item, unsigned index)
     if (!item)
         return;
 
+    if (virtualMode_)
+    {
+        URHO3D_LOGWARNING("ListView items can not be removed in virtual mode, set the number of virtual items instead");
+        return;
+    }
+
     unsigned numItems = GetNumItems();
     for (unsigned i = index; i < numItems; ++i)
     {
@@ -505,6 +529,12 @@ void ListView::RemoveItem(unsigned index)
 
 void ListView::RemoveAllItems()
 {
+    if (virtualMode_)
+    {
+        SetNumVirtualItems(0);
+        return;
+    }
+
     contentElement_->DisableLayoutUpdate();
 
     ClearSelection();
@@ -689,8 +719,8 @@ void ListView::ChangeSelection(int delta, bool additive)
         if (newSelection >= numItems)
             break;
 
-        UIElement* item = GetItem(newSelection);
-        if (item->IsVisible())
+        // In virtual mode all items are visible, but only the ones in view are realized
+        if (virtualMode_ || GetItem(newSelection)->IsVisible())
         {
             indices.push_back(okSelection = newSelection);
             delta -= direction;
@@ -724,6 +754,9 @@ void ListView::SetHierarchyMode(bool enable)
     if (enable == hierarchyMode_)
         return;
 
+    if (enable && virtualMode_)
+        SetVirtualMode(false);
+
     hierarchyMode_ = enable;
     SharedPtr<UIElement> container;
     if (enable)
@@ -781,6 +814,90 @@ void ListView::SetSelectOnClickEnd(bool enable)
     }
 }
 
+void ListView::SetVirtualMode(bool enable)
+{
+    if (enable == virtualMode_)
+        return;
+
+    RemoveAllItems();
+    if (enable)
+    {
+        SetHierarchyMode(false);
+        prevLayoutMode_ = contentElement_->GetLayoutMode();
+        virtualMode_ = true;
+
+        // Rows are positioned manually, so that the content element is only as large as the whole list
+        contentElement_->SetLayoutMode(LM_FREE);
+        UpdateVirtualItems(true);
+    }
+    else
+    {
+        virtualMode_ = false;
+        numVirtualItems_ = 0;
+        contentElement_->RemoveAllChildren();
+        virtualItems_.clear();
+        virtualItemIndices_.clear();
+        contentElement_->SetLayoutMode(prevLayoutMode_);
+    }
+}
+
+void ListView::SetVirtualItemCallbacks(const ListViewItemFactory& factory, const ListViewItemBinder& binder)
+{
+    virtualItemFactory_ = factory;
+    virtualItemBinder_ = binder;
+
+    // Item elements created by a previous factory may not match the new binder
+    if (virtualMode_)
+    {
+        contentElement_->RemoveAllChildren();
+        virtualItems_.clear();
+        virtualItemIndices_.clear();
+        UpdateVirtualItems(true);
+    }
+}
+
+void ListView::SetNumVirtualItems(unsigned numItems)
+{
+    if (!virtualMode_)
+    {
+        URHO3D_LOGWARNING("ListView number of virtual items can only be set in virtual mode");
+        return;
+    }
+
+    if (numItems == numVirtualItems_)
+        return;
+
+    // Drop selections past the new end of the list
+    if (!selections_.empty() && selections_.back() >= numItems)
+    {
+        ea::vector<unsigned> indices;
+        for (unsigned index : selections_)
+        {
+            if (index < numItems)
+                indices.push_back(index);
+        }
+        SetSelections(indices);
+    }
+
+    numVirtualItems_ = numItems;
+    UpdateVirtualItems(false);
+}
+
+void ListView::SetVirtualItemHeight(int height)
+{
+    height = Max(height, 1);
+    if (height != virtualItemHeight_)
+    {
+        virtualItemHeight_ = height;
+        UpdateVirtualItems(false);
+    }
+}
+
+void ListView::RefreshVirtualItems()
+{
+    UpdateVirtualItems(true);
+}
+
 void ListView::Expand(unsigned index, bool enable, bool recursive)
 {
     if (!hierarchyMode_)
@@ -838,18 +955,38 @@ void ListView::ToggleExpand(unsigned index, bool recursive)
 
 unsigned ListView::GetNumItems() const
 {
-    return contentElement_->GetNumChildren();
+    return virtualMode_ ? numVirtualItems_ : contentElement_->GetNumChildren();
 }
 
 UIElement* ListView::GetItem(unsigned index) const
 {
+    if (virtualMode_)
+    {
+        // Only the item elements in view are realized
+        for (unsigned i = 0; i < virtualItemIndices_.size(); ++i)
+        {
+            if (virtualItemIndices_[i] == index && index != M_MAX_UNSIGNED)
+                return virtualItems_[i];
+        }
+        return nullptr;
+    }
+
     return contentElement_->GetChild(index);
 }
 
 ea::vector<UIElement*> ListView::GetItems() const
 {
     ea::vector<UIElement*> items;
-    contentElement_->GetChildren(items);
+    if (virtualMode_)
+    {
+        for (unsigned i = 0; i < virtualItems_.size(); ++i)
+        {
+            if (virtualItemIndices_[i] != M_MAX_UNSIGNED)
+                items.push_back(virtualItems_[i]);
+        }
+    }
+    else
+        contentElement_->GetChildren(items);
     return items;
 }
 
@@ -862,6 +999,16 @@ unsigned ListView::FindItem(UIElement* item) const
     if (item->GetParent() != contentElement_)
         return M_MAX_UNSIGNED;
 
+    if (virtualMode_)
+    {
+        for (unsigned i = 0; i < virtualItems_.size(); ++i)
+        {
+            if (virtualItems_[i] == item)
+                return virtualItemIndices_[i];
+        }
+        return M_MAX_UNSIGNED;
+    }
+
     const ea::vector<SharedPtr<UIElement> >& children = contentElement_->GetChildren();
 
     // Binary search for list item based on screen coordinate Y
@@ -902,7 +1049,7 @@ unsigned ListView::GetSelection() const
 
 UIElement* ListView::GetSelectedItem() const
 {
-    return contentElement_->GetChild(GetSelection());
+    return GetItem(GetSelection());
 }
 
 ea::vector<UIElement*> ListView::GetSelectedItems() const
@@ -941,7 +1088,7 @@ bool ListView::IsSelected(unsigned index) const
 
 bool ListView::IsExpanded(unsigned index) const
 {
-    return GetItemExpanded(contentElement_->GetChild(index));
+    return GetItemExpanded(GetItem(index));
 }
 
 bool ListView::FilterImplicitAttributes(XMLElement& dest) const
@@ -989,9 +1136,19 @@ bool ListView::FilterImplicitAttributes(XMLElement& dest) const
 
 void ListView::UpdateSelectionEffect()
 {
-    unsigned numItems = GetNumItems();
     bool highlighted = highlightMode_ == HM_ALWAYS || HasFocus();
 
+    if (virtualMode_)
+    {
+        for (unsigned i = 0; i < virtualItems_.size(); ++i)
+        {
+            const unsigned index = virtualItemIndices_[i];
+            virtualItems_[i]->SetSelected(index != M_MAX_UNSIGNED && highlightMode_ != HM_NEVER && selections_.contains(index) && highlighted);
+        }
+        return;
+    }
+
+    unsigned numItems = GetNumItems();
     for (unsigned i = 0; i < numItems; ++i)
     {
         UIElement* item = GetItem(i);
@@ -1004,7 +1161,27 @@ void ListView::UpdateSelectionEffect()
 
 void ListView::EnsureItemVisibility(unsigned index)
 {
-    EnsureItemVisibility(GetItem(index));
+    if (!virtualMode_)
+    {
+        EnsureItemVisibility(GetItem(index));
+        return;
+    }
+
+    // The item element may not be realized yet, so compute the row position from the index
+    if (index >= numVirtualItems_)
+        return;
+
+    IntVector2 newView = GetViewPosition();
+    const IntRect& clipBorder = scrollPanel_->GetClipBorder();
+    const int windowHeight = scrollPanel_->GetHeight() - clipBorder.top_ - clipBorder.bottom_;
+    const int itemTop = (int)index * virtualItemHeight_;
+
+    if (itemTop < newView.y_)
+        newView.y_ = itemTop;
+    else if (itemTop + virtualItemHeight_ > newView.y_ + windowHeight)
+        newView.y_ = itemTop + virtualItemHeight_ - windowHeight;
+
+    SetViewPosition(newView);
 }
 
 void ListView::EnsureItemVisibility(UIElement* item)
@@ -1165,6 +1342,94 @@ void ListView::HandleFocusChanged(StringHash eventType, VariantMap& eventData)
         UpdateSelectionEffect();
 }
 
+void ListView::HandleViewChanged(StringHash eventType, VariantMap& eventData)
+{
+    UpdateVirtualItems(false);
+}
+
+void ListView::UpdateVirtualItems(bool rebind)
+{
+    if (!virtualMode_ || !contentElement_)
+        return;
+
+    // Size of the content element drives the scroll bars. This may re-enter via the view changed event, which is harmless
+    const int contentHeight = (int)Min(numVirtualItems_ * (unsigned long long)virtualItemHeight_, (unsigned long long)M_MAX_INT);
+    if (contentElement_->GetHeight() != contentHeight)
+        contentElement_->SetHeight(contentHeight);
+
+    // Rows intersecting the view, including the partially visible ones
+    const IntRect& clipBorder = scrollPanel_->GetClipBorder();
+    const int windowHeight = Max(scrollPanel_->GetHeight() - clipBorder.top_ - clipBorder.bottom_, 0);
+    const int viewY = Max(GetViewPosition().y_, 0);
+    const unsigned first = Min((unsigned)(viewY / virtualItemHeight_), numVirtualItems_);
+    const unsigned last = Min((unsigned)((viewY + windowHeight) / virtualItemHeight_ + 1), numVirtualItems_);
+    const int itemWidth = contentElement_->GetWidth();
+
+    // Release item elements that went out of view, keep the others bound to their rows
+    ea::vector<bool> realized(last - first, false);
+    ea::vector<unsigned> freeItems;
+    for (unsigned i = 0; i < virtualItems_.size(); ++i)
+    {
+        const unsigned index = virtualItemIndices_[i];
+        if (!rebind && index >= first && index < last)
+            realized[index - first] = true;
+        else
+        {
+            virtualItemIndices_[i] = M_MAX_UNSIGNED;
+            freeItems.push_back(i);
+        }
+    }
+
+    // Bind the missing rows, creating new item elements only when the pool runs out
+    for (unsigned index = first; index < last; ++index)
+    {
+        if (realized[index - first])
+            continue;
+
+        unsigned slot;
+        if (!freeItems.empty())
+        {
+            slot = freeItems.back();
+            freeItems.pop_back();
+        }
+        else
+        {
+            SharedPtr<UIElement> item = virtualItemFactory_ ? virtualItemFactory_(this) : SharedPtr<UIElement>();
+            if (!item)
+                break;
+
+            // Enable input so that clicking the item can be detected. Pooled items are not serialized
+            item->SetEnabled(true);
+            item->SetTemporary(true);
+            contentElement_->AddChild(item);
+            slot = virtualItems_.size();
+            virtualItems_.push_back(item);
+            virtualItemIndices_.push_back(M_MAX_UNSIGNED);
+        }
+
+        virtualItemIndices_[slot] = index;
+        if (virtualItemBinder_)
+            virtualItemBinder_(this, index, virtualItems_[slot]);
+    }
+
+    for (unsigned i = 0; i < virtualItems_.size(); ++i)
+    {
+        UIElement* item = virtualItems_[i];
+        const unsigned index = virtualItemIndices_[i];
+        if (index == M_MAX_UNSIGNED)
+        {
+            item->SetVisible(false);
+            continue;
+        }
+
+        item->SetVisible(true);
+        item->SetPosition(0, (int)index * virtualItemHeight_);
+        item->SetSize(itemWidth, virtualItemHeight_);
+    }
+
+    UpdateSelectionEffect();
+}
+
 void ListView::UpdateUIClickSubscription()
 {
     UnsubscribeFromEvent(E_UIMOUSECLICK);
@@ -41,6 +41,13 @@ enum HighlightMode
     HM_ALWAYS
 };
 
+class ListView;
+
+/// Callback creating a new item element for the virtual mode of %ListView.
+using ListViewItemFactory = std::function<SharedPtr<UIElement>(ListView* listView)>;
+/// Callback assigning the data of the virtual item at index to a recycled item element of %ListView.
+using ListViewItemBinder = std::function<void(ListView* listView, unsigned index, UIElement* item)>;
+
 /// Scrollable list %UI element.
 class URHO3D_API ListView : public ScrollView
 {
@@ -106,6 +113,17 @@ public:
     void SetClearSelectionOnDefocus(bool enable);
     /// Enable reacting to click end instead of click start for item selection. Default false.
     void SetSelectOnClickEnd(bool enable);
+    /// \brief Enable virtual mode. Item elements are created by the factory callback only for the visible rows and are recycled and rebound by the binder callback when scrolled.
+    /// Rows have a fixed height which together with the item count drives the scroll bars. Hierarchy mode is disabled and all items in the list will be lost during mode change.
+    void SetVirtualMode(bool enable);
+    /// Set callbacks creating and binding item elements in virtual mode.
+    void SetVirtualItemCallbacks(const ListViewItemFactory& factory, const ListViewItemBinder& binder);
+    /// Set number of items in virtual mode.
+    void SetNumVirtualItems(unsigned numItems);
+    /// Set row height in virtual mode.
+    void SetVirtualItemHeight(int height);
+    /// Rebind all realized item elements in virtual mode, e.g. after the data source has changed.
+    void RefreshVirtualItems();
 
     /// Expand item at index. Only has effect in hierarchy mode.
     void Expand(unsigned index, bool enable, bool recursive = false);
@@ -155,6 +173,12 @@ public:
     /// Return base indent.
     int GetBaseIndent() const { return baseIndent_; }
 
+    /// Return whether virtual mode enabled.
+    bool GetVirtualMode() const { return virtualMode_; }
+
+    /// Return row height in virtual mode.
+    int GetVirtualItemHeight() const { return virtualItemHeight_; }
+
     /// Ensure full visibility of the item.
     void EnsureItemVisibility(unsigned index);
     /// Ensure full visibility of the item.
@@ -182,6 +206,22 @@ protected:
     bool clearSelectionOnDefocus_;
     /// React to click end instead of click start flag.
     bool selectOnClickEnd_;
+    /// Virtual mode flag.
+    bool virtualMode_{};
+    /// Number of items in virtual mode.
+    unsigned numVirtualItems_{};
+    /// Row height in virtual mode.
+    int virtualItemHeight_{20};
+    /// Layout mode of the item container before virtual mode was enabled.
+    LayoutMode prevLayoutMode_{LM_VERTICAL};
+    /// Callback creating item elements in virtual mode.
+    ListViewItemFactory virtualItemFactory_;
+    /// Callback binding item elements in virtual mode.
+    ListViewItemBinder virtualItemBinder_;
+    /// Pool of item elements in virtual mode.
+    ea::vector<SharedPtr<UIElement> > virtualItems_;
+    /// Item indices bound to the pooled item elements, M_MAX_UNSIGNED when unused.
+    ea::vector<unsigned> virtualItemIndices_;
 
 private:
     /// Handle global UI mouseclick to check for selection change.
@@ -194,6 +234,10 @@ private:
     void HandleFocusChanged(StringHash eventType, VariantMap& eventData);
     /// Update subscription to UI click events.
     void UpdateUIClickSubscription();
+    /// Handle view changed to realize the visible rows in virtual mode.
+    void HandleViewChanged(StringHash eventType, VariantMap& eventData);
+    /// Realize item elements for the visible rows in virtual mode. Optionally rebind all of them.
+    void UpdateVirtualItems(bool rebind);
 };
 
 }
@@ -117,6 +117,16 @@ void Text::ApplyAttributes()
     UpdateText();
 }
 
+void Text::Update(float timeStep)
+{
+    // Glyphs that were placeholders when laid out may now have their final size
+    if (IsGlyphDataOutdated())
+    {
+        UpdateText();
+        UpdateCharLocations();
+    }
+}
+
 void Text::GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData, const IntRect& currentScissor)
 {
     FontFace* face = font_ ? font_->GetFace(fontSize_) : nullptr;
@@ -127,6 +137,8 @@ void Text::GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexDat
     }
 
     // If face has changed or char locations are not valid anymore, update before rendering
+    if (IsGlyphDataOutdated())
+        UpdateText();
     if (charLocationsDirty_ || !fontFace_ || face != fontFace_)
         UpdateCharLocations();
     // If face uses mutable glyphs mechanism, reacquire glyphs before rendering to make sure they are in the texture
@@ -308,6 +320,43 @@ void Text::SetText(const ea::string& text)
     UpdateText();
 }
 
+void Text::SetTextInPlace(const ea::string& text)
+{
+    FontFace* face = font_ ? font_->GetFace(fontSize_) : nullptr;
+    if (autoLocalizable_ || wordWrap_ || !face || face != fontFace_ || printText_.size() != unicodeText_.size())
+    {
+        SetText(text);
+        return;
+    }
+
+    ea::vector<unsigned> unicodeText;
+    unicodeText.reserve(unicodeText_.size());
+    for (unsigned i = 0; i < text.length();)
+        unicodeText.push_back(NextUTF8Char(text, i));
+
+    if (unicodeText.size() != unicodeText_.size())
+    {
+        SetText(text);
+        return;
+    }
+
+    for (unsigned i = 0; i < unicodeText.size(); ++i)
+    {
+        if (unicodeText[i] != unicodeText_[i] && !CanReplaceCharInPlace(face, i, unicodeText))
+        {
+            SetText(text);
+            return;
+        }
+    }
+
+    // Row widths and the element size stay the same, only the glyphs need to be placed again
+    text_ = text;
+    unicodeText_ = ea::move(unicodeText);
+    printText_ = unicodeText_;
+    charLocationsDirty_ = true;
+    MarkBatchesDirty();
+}
+
 void Text::SetTextAlignment(HorizontalAlignment align)
 {
     if (align != textAlignment_)
@@ -315,6 +364,7 @@ void Text::SetTextAlignment(HorizontalAlignment align)
         textAlignment_ = align;
         charLocationsDirty_ = true;
     }
+    MarkBatchesDirty();
 }
 
 void Text::SetRowSpacing(float spacing)
@@ -373,42 +423,50 @@ void Text::SetSelection(unsigned start, unsigned length)
     selectionStart_ = start;
     selectionLength_ = length;
     ValidateSelection();
+    MarkBatchesDirty();
 }
 
 void Text::ClearSelection()
 {
     selectionStart_ = 0;
     selectionLength_ = 0;
+    MarkBatchesDirty();
 }
 
 void Text::SetTextEffect(TextEffect textEffect)
 {
     textEffect_ = textEffect;
+    MarkBatchesDirty();
 }
 
 void Text::SetEffectShadowOffset(const IntVector2& offset)
 {
     shadowOffset_ = offset;
+    MarkBatchesDirty();
 }
 
 void Text::SetEffectStrokeThickness(int thickness)
 {
     strokeThickness_ = Abs(thickness);
+    MarkBatchesDirty();
 }
 
 void Text::SetEffectRoundStroke(bool roundStroke)
 {
     roundStroke_ = roundStroke;
+    MarkBatchesDirty();
 }
 
 void Text::SetEffectColor(const Color& effectColor)
 {
     effectColor_ = effectColor;
+    MarkBatchesDirty();
 }
 
 void Text::SetEffectDepthBias(float bias)
 {
     effectDepthBias_ = bias;
+    MarkBatchesDirty();
 }
 
 float Text::GetRowWidth(unsigned index) const
@@ -484,166 +542,221 @@ bool Text::FilterImplicitAttributes(XMLElement& dest) const
     return true;
 }
 
-void Text::UpdateText(bool onResize)
+void Text::ShapeText(FontFace* face, int rowHeight, int& width, int& height)
 {
-    rowWidths_.clear();
-    printText_.clear();
+    width = 0;
+    height = 0;
+    int rowWidth = 0;
 
-    if (font_)
+    // First see if the text must be split up
+    if (!wordWrap_)
     {
-        FontFace* face = font_->GetFace(fontSize_);
-        if (!face)
-            return;
-
-        rowHeight_ = face->GetRowHeight();
-
-        int width = 0;
-        int height = 0;
-        int rowWidth = 0;
-        auto rowHeight = RoundToInt(rowSpacing_ * rowHeight_);
+        printText_ = unicodeText_;
+        printToText_.resize(printText_.size());
+        for (unsigned i = 0; i < printText_.size(); ++i)
+            printToText_[i] = i;
+    }
+    else
+    {
+        int maxWidth = GetWidth();
+        unsigned nextBreak = 0;
+        unsigned lineStart = 0;
+        printToText_.clear();
 
-        // First see if the text must be split up
-        if (!wordWrap_)
-        {
-            printText_ = unicodeText_;
-            printToText_.resize(printText_.size());
-            for (unsigned i = 0; i < printText_.size(); ++i)
-                printToText_[i] = i;
-        }
-        else
+        for (unsigned i = 0; i < unicodeText_.size(); ++i)
         {
-            int maxWidth = GetWidth();
-            unsigned nextBreak = 0;
-            unsigned lineStart = 0;
-            printToText_.clear();
+            unsigned j;
+            unsigned c = unicodeText_[i];
 
-            for (unsigned i = 0; i < unicodeText_.size(); ++i)
+            if (c != '\n')
             {
-                unsigned j;
-                unsigned c = unicodeText_[i];
+                bool ok = true;
 
-                if (c != '\n')
+                if (nextBreak <= i)
                 {
-                    bool ok = true;
-
-                    if (nextBreak <= i)
+                    int futureRowWidth = rowWidth;
+                    for (j = i; j < unicodeText_.size(); ++j)
                     {
-                        int futureRowWidth = rowWidth;
-                        for (j = i; j < unicodeText_.size(); ++j)
+                        unsigned d = unicodeText_[j];
+                        if (d == ' ' || d == '\n')
                         {
-                            unsigned d = unicodeText_[j];
-                            if (d == ' ' || d == '\n')
-                            {
-                                nextBreak = j;
-                                break;
-                            }
-                            const FontGlyph* glyph = face->GetGlyph(d);
-                            if (glyph)
-                            {
-                                futureRowWidth += glyph->advanceX_;
-                                if (j < unicodeText_.size() - 1)
-                                    futureRowWidth += face->GetKerning(d, unicodeText_[j + 1]);
-                            }
-                            if (d == '-' && futureRowWidth <= maxWidth)
-                            {
-                                nextBreak = j + 1;
-                                break;
-                            }
-                            if (futureRowWidth > maxWidth)
-                            {
-                                ok = false;
-                                break;
-                            }
+                            nextBreak = j;
+                            break;
                         }
-                    }
-
-                    if (!ok)
-                    {
-                        // If did not find any breaks on the line, copy until j, or at least 1 char, to prevent infinite loop
-                        if (nextBreak == lineStart)
+                        const FontGlyph* glyph = face->GetGlyph(d);
+                        if (glyph)
+                        {
+                            futureRowWidth += glyph->advanceX_;
+                            if (j < unicodeText_.size() - 1)
+                                futureRowWidth += face->GetKerning(d, unicodeText_[j + 1]);
+                        }
+                        if (d == '-' && futureRowWidth <= maxWidth)
                         {
-                            while (i < j)
-                            {
-                                printText_.push_back(unicodeText_[i]);
-                                printToText_.push_back(i);
-                                ++i;
-                            }
+                            nextBreak = j + 1;
+                            break;
                         }
-                        // Eliminate spaces that have been copied before the forced break
-                        while (printText_.size() && printText_.back() == ' ')
+                        if (futureRowWidth > maxWidth)
                         {
-                            printText_.pop_back();
-                            printToText_.pop_back();
+                            ok = false;
+                            break;
                         }
-                        printText_.push_back('\n');
-                        printToText_.push_back(Min(i, unicodeText_.size() - 1));
-                        rowWidth = 0;
-                        nextBreak = lineStart = i;
                     }
+                }
 
-                    if (i < unicodeText_.size())
+                if (!ok)
+                {
+                    // If did not find any breaks on the line, copy until j, or at least 1 char, to prevent infinite loop
+                    if (nextBreak == lineStart)
                     {
-                        // When copying a space, position is allowed to be over row width
-                        c = unicodeText_[i];
-                        const FontGlyph* glyph = face->GetGlyph(c);
-                        if (glyph)
+                        while (i < j)
                         {
-                            rowWidth += glyph->advanceX_;
-                            if (i < unicodeText_.size() - 1)
-                                rowWidth += face->GetKerning(c, unicodeText_[i + 1]);
-                        }
-                        if (rowWidth <= maxWidth)
-                        {
-                            printText_.push_back(c);
+                            printText_.push_back(unicodeText_[i]);
                             printToText_.push_back(i);
+                            ++i;
                         }
                     }
-                }
-                else
-                {
+                    // Eliminate spaces that have been copied before the forced break
+                    while (printText_.size() && printText_.back() == ' ')
+                    {
+                        printText_.pop_back();
+                        printToText_.pop_back();
+                    }
                     printText_.push_back('\n');
                     printToText_.push_back(Min(i, unicodeText_.size() - 1));
                     rowWidth = 0;
                     nextBreak = lineStart = i;
                 }
-            }
-        }
 
-        rowWidth = 0;
-
-        for (unsigned i = 0; i < printText_.size(); ++i)
-        {
-            unsigned c = printText_[i];
-
-            if (c != '\n')
-            {
-                const FontGlyph* glyph = face->GetGlyph(c);
-                if (glyph)
+                if (i < unicodeText_.size())
                 {
-                    rowWidth += glyph->advanceX_;
-                    if (i < printText_.size() - 1)
-                        rowWidth += face->GetKerning(c, printText_[i + 1]);
+                    // When copying a space, position is allowed to be over row width
+                    c = unicodeText_[i];
+                    const FontGlyph* glyph = face->GetGlyph(c);
+                    if (glyph)
+                    {
+                        rowWidth += glyph->advanceX_;
+                        if (i < unicodeText_.size() - 1)
+                            rowWidth += face->GetKerning(c, unicodeText_[i + 1]);
+                    }
+                    if (rowWidth <= maxWidth)
+                    {
+                        printText_.push_back(c);
+                        printToText_.push_back(i);
+                    }
                 }
             }
             else
             {
-                width = Max(width, rowWidth);
-                height += rowHeight;
-                rowWidths_.push_back(rowWidth);
+                printText_.push_back('\n');
+                printToText_.push_back(Min(i, unicodeText_.size() - 1));
                 rowWidth = 0;
+                nextBreak = lineStart = i;
             }
         }
+    }
+
+    rowWidth = 0;
+
+    for (unsigned i = 0; i < printText_.size(); ++i)
+    {
+        unsigned c = printText_[i];
 
-        if (rowWidth)
+        if (c != '\n')
+        {
+            const FontGlyph* glyph = face->GetGlyph(c);
+            if (glyph)
+            {
+                rowWidth += glyph->advanceX_;
+                if (i < printText_.size() - 1)
+                    rowWidth += face->GetKerning(c, printText_[i + 1]);
+            }
+        }
+        else
         {
             width = Max(width, rowWidth);
             height += rowHeight;
             rowWidths_.push_back(rowWidth);
+            rowWidth = 0;
         }
+    }
 
-        // Set at least one row height even if text is empty
-        if (!height)
-            height = rowHeight;
+    if (rowWidth)
+    {
+        width = Max(width, rowWidth);
+        height += rowHeight;
+        rowWidths_.push_back(rowWidth);
+    }
+
+    // Set at least one row height even if text is empty
+    if (!height)
+        height = rowHeight;
+}
+
+bool Text::CanReplaceCharInPlace(FontFace* face, unsigned index, const ea::vector<unsigned>& unicodeText) const
+{
+    const unsigned oldChar = unicodeText_[index];
+    const unsigned c = unicodeText[index];
+    if (c == '\n' || oldChar == '\n')
+        return false;
+
+    const FontGlyph* oldGlyph = face->GetGlyph(oldChar);
+    const FontGlyph* newGlyph = face->GetGlyph(c);
+    if (!oldGlyph || !newGlyph || oldGlyph->advanceX_ != newGlyph->advanceX_)
+        return false;
+
+    // Kerning with the neighbours of the new text must match the kerning with the neighbours of the old text,
+    // as adjacent chars may change as well
+    if (index > 0 && face->GetKerning(unicodeText_[index - 1], oldChar) != face->GetKerning(unicodeText[index - 1], c))
+        return false;
+    if (index + 1 < unicodeText_.size() && face->GetKerning(oldChar, unicodeText_[index + 1]) != face->GetKerning(c, unicodeText[index + 1]))
+        return false;
+
+    return true;
+}
+
+void Text::UpdateText(bool onResize)
+{
+    MarkBatchesDirty();
+    rowWidths_.clear();
+    printText_.clear();
+
+    if (font_)
+    {
+        FontFace* face = font_->GetFace(fontSize_);
+        if (!face)
+            return;
+
+        rowHeight_ = face->GetRowHeight();
+
+        int width = 0;
+        int height = 0;
+        auto rowHeight = RoundToInt(rowSpacing_ * rowHeight_);
+
+        // Reuse the layout of another text with the same contents and layout parameters if possible
+        const int maxWidth = wordWrap_ ? GetWidth() : M_MAX_INT;
+        if (const FontTextLayout* layout = face->GetTextLayout(unicodeText_, maxWidth, rowHeight))
+        {
+            printText_ = layout->printText_;
+            printToText_ = layout->printToText_;
+            rowWidths_ = layout->rowWidths_;
+            width = layout->width_;
+            height = layout->height_;
+        }
+        else
+        {
+            ShapeText(face, rowHeight, width, height);
+
+            FontTextLayout newLayout;
+            newLayout.text_ = unicodeText_;
+            newLayout.maxWidth_ = maxWidth;
+            newLayout.rowHeight_ = rowHeight;
+            newLayout.printText_ = printText_;
+            newLayout.printToText_ = printToText_;
+            newLayout.rowWidths_ = rowWidths_;
+            newLayout.width_ = width;
+            newLayout.height_ = height;
+            face->StoreTextLayout(ea::move(newLayout));
+        }
 
         // Set minimum and current size according to the text size, but respect fixed width if set
         if (!IsFixedWidth())
@@ -676,6 +789,11 @@ void Text::UpdateText(bool onResize)
     }
 }
 
+bool Text::IsGlyphDataOutdated() const
+{
+    return fontFace_ && fontFace_->GetGlyphRevision() != glyphRevision_;
+}
+
 void Text::UpdateCharLocations()
 {
     // Remember the font face to see if it's still valid when it's time to render
@@ -683,6 +801,7 @@ void Text::UpdateCharLocations()
     if (!face)
         return;
     fontFace_ = face;
+    glyphRevision_ = face->GetGlyphRevision();
 
     auto rowHeight = RoundToInt(rowSpacing_ * rowHeight_);
 
@@ -88,6 +88,8 @@ public:
 
     /// Apply attribute changes that can not be applied immediately.
     void ApplyAttributes() override;
+    /// Perform UI element update.
+    void Update(float timeStep) override;
     /// Return UI rendering batches.
     void GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData, const IntRect& currentScissor) override;
     /// React to resize.
@@ -103,6 +105,8 @@ public:
     bool SetFontSize(float size);
     /// Set text. Text is assumed to be either ASCII or UTF8-encoded.
     void SetText(const ea::string& text);
+    /// \brief Set text keeping the current layout when possible, e.g. for counters. The layout is kept when the text has the same length, is not word wrapped or localized, and every changed character has the same advance and kerning as the one it replaces, which is typical for digits. Otherwise same as SetText.
+    void SetTextInPlace(const ea::string& text);
     /// Set row alignment.
     void SetTextAlignment(HorizontalAlignment align);
     /// Set row spacing, 1.0 for original font spacing.
@@ -177,6 +181,9 @@ public:
     /// Return number of characters.
     unsigned GetNumChars() const { return unicodeText_.size(); }
 
+    /// Return whether the font face has finished glyphs in the background since the text was laid out.
+    bool IsGlyphDataOutdated() const;
+
     /// Return width of row by index.
     float GetRowWidth(unsigned index) const;
     /// Return position of character by index relative to the text element origin.
@@ -206,6 +213,10 @@ protected:
     void UpdateText(bool onResize = false);
     /// Update cached character locations after text update, or when text alignment or indent has changed.
     void UpdateCharLocations();
+    /// Split the text into rows with word wrap if enabled and measure them. Return the text size.
+    void ShapeText(FontFace* face, int rowHeight, int& width, int& height);
+    /// Return whether a char of the laid out text can be replaced by the char of the new text at the same index without changing the layout.
+    bool CanReplaceCharInPlace(FontFace* face, unsigned index, const ea::vector<unsigned>& unicodeText) const;
     /// Validate text selection to be within the text.
     void ValidateSelection();
     /// Return row start X position.
@@ -231,6 +242,8 @@ protected:
     bool wordWrap_;
     /// Char positions dirty flag.
     bool charLocationsDirty_;
+    /// Glyph revision of the font face when the char positions were updated.
+    unsigned glyphRevision_{};
     /// Selection start.
     unsigned selectionStart_;
     /// Selection length.
@@ -133,6 +133,10 @@ void Text3D::UpdateBatches(const FrameInfo& frame)
             break;
         }
     }
+
+    // Glyphs finished in the background need the text batches regenerated, same as lost font data
+    if (text_.IsGlyphDataOutdated())
+        fontDataLost_ = true;
 }
 
 void Text3D::UpdateGeometry(const FrameInfo& frame)
@@ -230,6 +234,15 @@ void Text3D::SetText(const ea::string& text)
     UpdateTextMaterials();
 }
 
+void Text3D::SetTextInPlace(const ea::string& text)
+{
+    text_.SetTextInPlace(text);
+
+    MarkTextDirty();
+    UpdateTextBatches();
+    UpdateTextMaterials();
+}
+
 void Text3D::SetAlignment(HorizontalAlignment hAlign, VerticalAlignment vAlign)
 {
     text_.SetAlignment(hAlign, vAlign);
@@ -754,7 +767,7 @@ void Text3D::CalculateFixedScreenSize(const FrameInfo& frame)
 
     customWorldTransform_ = Matrix3x4(worldPosition, frame.camera_->GetFaceCameraRotation(
         worldPosition, node_->GetWorldRotation(), faceCameraMode_, minAngle_), worldScale);
-    worldBoundingBoxDirty_ = true;
+    MarkWorldBoundingBoxDirty();
 }
 
 }
@@ -64,6 +64,8 @@ public:
     void SetMaterial(Material* material);
     /// Set text. Text is assumed to be either ASCII or UTF8-encoded.
     void SetText(const ea::string& text);
+    /// Set text keeping the current layout when possible, e.g. for counters. See Text::SetTextInPlace.
+    void SetTextInPlace(const ea::string& text);
     /// Set horizontal and vertical alignment.
     void SetAlignment(HorizontalAlignment hAlign, VerticalAlignment vAlign);
     /// Set horizontal alignment.
@@ -24,7 +24,9 @@
 
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
+#include "../Core/MemoryTracker.h"
 #include "../Core/Profiler.h"
+#include "../Engine/Engine.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/GraphicsEvents.h"
 #include "../Graphics/Shader.h"
@@ -46,6 +48,7 @@
 #include "../UI/DropDownList.h"
 #include "../UI/FileSelector.h"
 #include "../UI/Font.h"
+#include "../UI/FontFace.h"
 #include "../UI/LineEdit.h"
 #include "../UI/ListView.h"
 #include "../UI/MessageBox.h"
@@ -67,6 +70,7 @@
 
 #include <cassert>
 #include <SDL/SDL.h>
+#include <EASTL/sort.h>
 
 #include "../DebugNew.h"
 
@@ -88,6 +92,8 @@ const float DEFAULT_DRAGBEGIN_INTERVAL = 0.5f;
 const float DEFAULT_TOOLTIP_DELAY = 0.5f;
 const int DEFAULT_DRAGBEGIN_DISTANCE = 5;
 const int DEFAULT_FONT_TEXTURE_MAX_SIZE = 2048;
+/// Maximum number of deferred layout passes per update. Layouts still dirty after that are processed on the next update.
+const unsigned MAX_LAYOUT_PASSES = 8;
 
 const char* UI_CATEGORY = "UI";
 
@@ -324,6 +330,18 @@ void UI::Update(float timeStep)
     assert(rootElement_ && rootModalElement_);
 
     URHO3D_PROFILE("UpdateUI");
+    MemoryTagScope memoryTag(MEMORY_TAG_UI);
+
+    // Finish the glyphs rasterized in the background, so that text is laid out again before rendering
+    for (unsigned i = 0; i < asyncFontFaces_.size();)
+    {
+        if (asyncFontFaces_[i] && asyncFontFaces_[i]->UpdateAsyncGlyphs())
+            ++i;
+        else
+            asyncFontFaces_.erase_at(i);
+    }
+
+    UpdateLayouts();
 
     // Expire hovers
     for (auto i = hoveredElements_.begin(); i !=
@@ -413,6 +431,9 @@ void UI::Update(float timeStep)
             {
                 using namespace HoverEnd;
 
+                // Regenerate retained batches without the hover effect
+                element->MarkBatchesDirty();
+
                 VariantMap& eventData = GetEventDataMap();
                 eventData[P_ELEMENT] = element;
                 element->SendEvent(E_HOVEREND, eventData);
@@ -434,6 +455,10 @@ void UI::RenderUpdate()
     URHO3D_PROFILE("GetUIBatches");
 
     uiRendered_ = false;
+    dirtyTextureElements_.clear();
+
+    // Apply the layout changes made after the update
+    UpdateLayouts();
 
     // If the OS cursor is visible, do not render the UI's own cursor
     bool osCursorVisible = GetSubsystem<Input>()->IsMouseVisible();
@@ -475,12 +500,16 @@ void UI::RenderUpdate()
 void UI::Render()
 {
     URHO3D_PROFILE("RenderUI");
+    MemoryTagScope memoryTag(MEMORY_TAG_UI);
 
     // If the OS cursor is visible, apply its shape now if changed
     bool osCursorVisible = GetSubsystem<Input>()->IsMouseVisible();
     if (cursor_ && osCursorVisible)
         cursor_->ApplyOSCursorShape();
 
+    // Redraw changed element textures before they are composited
+    RenderElementTextures();
+
     SetVertexData(vertexBuffer_, vertexData_);
     SetVertexData(debugVertexBuffer_, debugVertexData_);
 
@@ -639,6 +668,15 @@ void UI::SetUseMutableGlyphs(bool enable)
     }
 }
 
+void UI::SetAsyncGlyphRasterization(bool enable)
+{
+    if (enable != asyncGlyphRasterization_)
+    {
+        asyncGlyphRasterization_ = enable;
+        ReleaseFontFaces();
+    }
+}
+
 void UI::SetForceAutoHint(bool enable)
 {
     if (enable != forceAutoHint_)
@@ -708,6 +746,77 @@ void UI::SetCustomSize(int width, int height)
     ResizeRootElement();
 }
 
+void UI::SetUseHitTestIndex(bool enable)
+{
+    useHitTestIndex_ = enable;
+    if (!enable)
+        hitTestIndices_.clear();
+}
+
+void UI::SetDeferredLayout(bool enable)
+{
+    if (enable != deferredLayout_)
+    {
+        // Apply the pending layouts before they would be lost
+        if (!enable)
+            UpdateLayouts();
+        deferredLayout_ = enable;
+    }
+}
+
+void UI::UpdateLayouts()
+{
+    if (layoutDirtyElements_.empty())
+        return;
+
+    URHO3D_PROFILE("UpdateUILayouts");
+
+    // A layout resizes children and the element itself, which may queue more layouts. Process in passes until settled
+    for (unsigned pass = 0; pass < MAX_LAYOUT_PASSES && !layoutDirtyElements_.empty(); ++pass)
+    {
+        layoutPassElements_.clear();
+        for (const WeakPtr<UIElement>& element : layoutDirtyElements_)
+        {
+            if (!element)
+                continue;
+
+            unsigned depth = 0;
+            for (UIElement* parent = element->GetParent(); parent; parent = parent->GetParent())
+                ++depth;
+            layoutPassElements_.emplace_back(depth, element);
+        }
+        layoutDirtyElements_.clear();
+
+        // Top-down, so that parents have resized the children before the children lay out their own contents
+        ea::stable_sort(layoutPassElements_.begin(), layoutPassElements_.end(),
+            [](const ea::pair<unsigned, WeakPtr<UIElement> >& lhs, const ea::pair<unsigned, WeakPtr<UIElement> >& rhs)
+        {
+            return lhs.first < rhs.first;
+        });
+
+        for (const auto& item : layoutPassElements_)
+        {
+            UIElement* element = item.second;
+            if (element && element->IsLayoutDirty())
+                element->ApplyLayout();
+        }
+    }
+
+    layoutPassElements_.clear();
+}
+
+void UI::QueueLayoutUpdate(UIElement* element)
+{
+    layoutDirtyElements_.emplace_back(element);
+}
+
+void UI::AddAsyncFontFace(FontFace* face)
+{
+    WeakPtr<FontFace> facePtr(face);
+    if (!asyncFontFaces_.contains(facePtr))
+        asyncFontFaces_.push_back(facePtr);
+}
+
 IntVector2 UI::GetCursorPosition() const
 {
     if (cursor_)
@@ -752,7 +861,16 @@ UIElement* UI::GetElementAt(UIElement* root, const IntVector2& position, bool en
     }
 
     UIElement* result = nullptr;
-    GetElementAt(result, root, positionCopy, enabledOnly);
+    if (useHitTestIndex_)
+    {
+        UIHitTestIndex& index = GetHitTestIndex(root);
+        const unsigned revision = root->GetHitTestRevision();
+        if (!index.IsValid(root, cursor_, revision))
+            index.Build(root, cursor_, revision);
+        result = index.Query(positionCopy, enabledOnly);
+    }
+    else
+        GetElementAt(result, root, positionCopy, enabledOnly);
     return result;
 }
 
@@ -869,8 +987,11 @@ void UI::Initialize()
     initialized_ = true;
 
     SubscribeToEvent(E_BEGINFRAME, URHO3D_HANDLER(UI, HandleBeginFrame));
-    SubscribeToEvent(E_POSTUPDATE, URHO3D_HANDLER(UI, HandlePostUpdate));
-    SubscribeToEvent(E_RENDERUPDATE, URHO3D_HANDLER(UI, HandleRenderUpdate));
+    if (auto* engine = GetSubsystem<Engine>())
+    {
+        engine->onPostUpdate_.Subscribe(this, &UI::HandlePostUpdate);
+        engine->onRenderUpdate_.Subscribe(this, &UI::HandleRenderUpdate);
+    }
 }
 
 void UI::Update(float timeStep, UIElement* element)
@@ -911,7 +1032,8 @@ void UI::SetVertexData(VertexBuffer* dest, const ea::vector<float>& vertexData)
     dest->SetData(&vertexData[0]);
 }
 
-void UI::Render(VertexBuffer* buffer, const ea::vector<UIBatch>& batches, unsigned batchStart, unsigned batchEnd)
+void UI::Render(VertexBuffer* buffer, const ea::vector<UIBatch>& batches, unsigned batchStart, unsigned batchEnd,
+    const IntVector2& origin)
 {
     // Engine does not render when window is closed or device is lost
     assert(graphics_ && graphics_->IsInitialized() && !graphics_->IsDeviceLost());
@@ -938,9 +1060,9 @@ void UI::Render(VertexBuffer* buffer, const ea::vector<UIBatch>& batches, unsign
 
     Matrix4 projection(Matrix4::IDENTITY);
     projection.m00_ = scale.x_ * uiScale_;
-    projection.m03_ = offset.x_;
+    projection.m03_ = offset.x_ - origin.x_ * scale.x_ * uiScale_;
     projection.m11_ = scale.y_ * uiScale_;
-    projection.m13_ = offset.y_;
+    projection.m13_ = offset.y_ - origin.y_ * scale.y_ * uiScale_;
     projection.m22_ = 1.0f;
     projection.m23_ = 0.0f;
     projection.m33_ = 1.0f;
@@ -1030,10 +1152,10 @@ void UI::Render(VertexBuffer* buffer, const ea::vector<UIBatch>& batches, unsign
         graphics_->SetShaderParameter(PSP_ELAPSEDTIME, elapsedTime);
 
         IntRect scissor = batch.scissor_;
-        scissor.left_ = (int)(scissor.left_ * uiScale_);
-        scissor.top_ = (int)(scissor.top_ * uiScale_);
-        scissor.right_ = (int)(scissor.right_ * uiScale_);
-        scissor.bottom_ = (int)(scissor.bottom_ * uiScale_);
+        scissor.left_ = (int)((scissor.left_ - origin.x_) * uiScale_);
+        scissor.top_ = (int)((scissor.top_ - origin.y_) * uiScale_);
+        scissor.right_ = (int)((scissor.right_ - origin.x_) * uiScale_);
+        scissor.bottom_ = (int)((scissor.bottom_ - origin.y_) * uiScale_);
 
         // Flip scissor vertically if using OpenGL texture rendering
 #ifdef URHO3D_OPENGL
@@ -1086,6 +1208,141 @@ void UI::Render(VertexBuffer* buffer, const ea::vector<UIBatch>& batches, unsign
 }
 
 void UI::GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData, UIElement* element, IntRect currentScissor)
+{
+    UIBatchCache* cache = element->GetBatchCache();
+    if (!cache)
+    {
+        GenerateBatches(batches, vertexData, element, currentScissor);
+        return;
+    }
+
+    if (cache->renderToTexture_)
+    {
+        GetRenderToTextureBatches(batches, vertexData, element, *cache, currentScissor);
+        return;
+    }
+
+    // Regenerate the retained batches only when the subtree has changed. Clear the dirty flag first so that changes
+    // made while generating are picked up on the next frame
+    if (cache->dirty_ || cache->scissor_ != currentScissor)
+    {
+        cache->dirty_ = false;
+        cache->scissor_ = currentScissor;
+        cache->batches_.clear();
+        cache->vertexData_.clear();
+        GenerateBatches(cache->batches_, cache->vertexData_, element, currentScissor);
+    }
+
+    // Append the retained vertices and rebase the batches onto them
+    const unsigned vertexOffset = vertexData.size();
+    vertexData.insert(vertexData.end(), cache->vertexData_.begin(), cache->vertexData_.end());
+    for (UIBatch batch : cache->batches_)
+    {
+        batch.vertexData_ = &vertexData;
+        batch.vertexStart_ += vertexOffset;
+        batch.vertexEnd_ += vertexOffset;
+        UIBatch::AddOrMerge(batch, batches);
+    }
+}
+
+void UI::GetRenderToTextureBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData, UIElement* element,
+    UIBatchCache& cache, const IntRect& currentScissor)
+{
+    const IntVector2& screenPos = element->GetScreenPosition();
+    const IntVector2& size = element->GetSize();
+    if (size.x_ <= 0 || size.y_ <= 0)
+        return;
+    const IntVector2 textureSize(Max(RoundToInt(size.x_ * uiScale_), 1), Max(RoundToInt(size.y_ * uiScale_), 1));
+
+    // Create or resize the texture. Contents are also lost on device loss
+    if (!cache.texture_)
+    {
+        cache.texture_ = context_->CreateObject<Texture2D>();
+        // Disable mipmaps since the texel ratio should be 1:1
+        cache.texture_->SetNumLevels(1);
+    }
+    if (cache.texture_->GetWidth() != textureSize.x_ || cache.texture_->GetHeight() != textureSize.y_)
+    {
+        if (!cache.texture_->SetSize(textureSize.x_, textureSize.y_, Graphics::GetRGBAFormat(), TEXTURE_RENDERTARGET))
+            return;
+        cache.texture_->GetRenderSurface()->SetUpdateMode(SURFACE_MANUALUPDATE);
+        cache.textureDirty_ = true;
+    }
+    if (cache.texture_->IsDataLost())
+    {
+        cache.texture_->ClearDataLost();
+        cache.textureDirty_ = true;
+    }
+
+    // Children are generated against the element's own rectangle, so the texture does not depend on the parent's clipping
+    const IntRect textureRect(screenPos, screenPos + size);
+    if (cache.dirty_ || cache.scissor_ != textureRect)
+    {
+        cache.dirty_ = false;
+        cache.scissor_ = textureRect;
+        cache.textureOrigin_ = screenPos;
+        cache.batches_.clear();
+        cache.vertexData_.clear();
+        GenerateBatches(cache.batches_, cache.vertexData_, element, textureRect);
+        cache.textureDirty_ = true;
+    }
+
+    if (cache.textureDirty_)
+        dirtyTextureElements_.push_back(WeakPtr<UIElement>(element));
+
+    // The children were blended onto a transparent texture, so composite it as premultiplied alpha
+    UIBatch batch(element, BLEND_PREMULALPHA, currentScissor, cache.texture_, &vertexData);
+    batch.SetColor(Color::WHITE, true);
+    batch.AddQuad(0, 0, size.x_, size.y_, 0, 0, textureSize.x_, textureSize.y_);
+    UIBatch::AddOrMerge(batch, batches);
+}
+
+void UI::RenderElementTextures()
+{
+    if (dirtyTextureElements_.empty())
+        return;
+
+    URHO3D_PROFILE("RenderUITextures");
+
+    // Remember the current rendertarget to restore it afterward
+    RenderSurface* previousTarget = graphics_->GetRenderTarget(0);
+    RenderSurface* previousDepthStencil = graphics_->GetDepthStencil();
+    const IntRect previousViewport = graphics_->GetViewport();
+
+    for (const WeakPtr<UIElement>& element : dirtyTextureElements_)
+    {
+        UIBatchCache* cache = element ? element->GetBatchCache() : nullptr;
+        if (!cache || !cache->texture_ || !cache->textureDirty_)
+            continue;
+
+        RenderSurface* surface = cache->texture_->GetRenderSurface();
+        if (!surface)
+            continue;
+
+        graphics_->ResetRenderTargets();
+        graphics_->SetRenderTarget(0, surface);
+        graphics_->SetViewport(IntRect(0, 0, surface->GetWidth(), surface->GetHeight()));
+        graphics_->Clear(CLEAR_COLOR, Color::TRANSPARENT_BLACK);
+
+        if (!cache->batches_.empty())
+        {
+            if (!cache->vertexBuffer_)
+                cache->vertexBuffer_ = context_->CreateObject<VertexBuffer>();
+            SetVertexData(cache->vertexBuffer_, cache->vertexData_);
+            Render(cache->vertexBuffer_, cache->batches_, 0, cache->batches_.size(), cache->textureOrigin_);
+        }
+
+        cache->textureDirty_ = false;
+    }
+    dirtyTextureElements_.clear();
+
+    graphics_->ResetRenderTargets();
+    graphics_->SetRenderTarget(0, previousTarget);
+    graphics_->SetDepthStencil(previousDepthStencil);
+    graphics_->SetViewport(previousViewport);
+}
+
+void UI::GenerateBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData, UIElement* element, IntRect currentScissor)
 {
     // Set clipping scissor for child elements. No need to draw if zero size
     element->AdjustScissor(currentScissor);
@@ -1138,6 +1395,23 @@ void UI::GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData,
     }
 }
 
+UIHitTestIndex& UI::GetHitTestIndex(UIElement* root)
+{
+    for (UIHitTestIndex& index : hitTestIndices_)
+    {
+        if (index.GetRoot() == root)
+            return index;
+    }
+
+    for (UIHitTestIndex& index : hitTestIndices_)
+    {
+        if (!index.GetRoot())
+            return index;
+    }
+
+    return hitTestIndices_.emplace_back();
+}
+
 void UI::GetElementAt(UIElement*& result, UIElement* current, const IntVector2& position, bool enabledOnly)
 {
     if (!current)
@@ -1306,6 +1580,8 @@ void UI::ProcessHover(const IntVector2& windowCursorPos, MouseButtonFlags button
             if (dragElement == element || dragDropTest)
             {
                 element->OnHover(element->ScreenToElement(cursorPos), cursorPos, buttons, qualifiers, cursor);
+                // Hover state is reset when batches are generated, so retained batches must be regenerated while hovering
+                element->MarkBatchesDirty();
 
                 // Begin hover event
                 if (!hoveredElements_.contains(element))
@@ -1351,6 +1627,7 @@ void UI::ProcessHover(const IntVector2& windowCursorPos, MouseButtonFlags button
         if (dragElementsCount_ == 0)
         {
             element->OnHover(element->ScreenToElement(cursorPos), cursorPos, buttons, qualifiers, cursor);
+            element->MarkBatchesDirty();
 
             // Begin hover event
             if (!hoveredElements_.contains(element))
@@ -1882,7 +2159,10 @@ void UI::HandleTouchEnd(StringHash eventType, VariantMap& eventData)
     }
 
     if (element && element->IsEnabled())
+    {
         element->OnHover(element->ScreenToElement(pos), pos, MOUSEB_NONE, QUAL_NONE, nullptr);
+        element->MarkBatchesDirty();
+    }
 
     ProcessClickEnd(pos, touchId, MOUSEB_NONE, QUAL_NONE, nullptr, true);
 }
@@ -2012,14 +2292,12 @@ void UI::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
         cursor_->SetShape(CS_NORMAL);
 }
 
-void UI::HandlePostUpdate(StringHash eventType, VariantMap& eventData)
+void UI::HandlePostUpdate(UpdateEventArgs& args)
 {
-    using namespace PostUpdate;
-
-    Update(eventData[P_TIMESTEP].GetFloat());
+    Update(args.timeStep_);
 }
 
-void UI::HandleRenderUpdate(StringHash eventType, VariantMap& eventData)
+void UI::HandleRenderUpdate(UpdateEventArgs& args)
 {
     RenderUpdate();
 }
@@ -28,6 +28,7 @@
 #include "../Graphics/VertexBuffer.h"
 #include "../UI/Cursor.h"
 #include "../UI/UIBatch.h"
+#include "../UI/UIHitTestIndex.h"
 
 namespace Urho3D
 {
@@ -46,6 +47,7 @@ enum FontHintLevel
 };
 
 class Cursor;
+class FontFace;
 class Graphics;
 class ResourceCache;
 class Timer;
@@ -55,6 +57,7 @@ class XMLElement;
 class XMLFile;
 class RenderSurface;
 class UIComponent;
+struct UpdateEventArgs;
 
 /// %UI subsystem. Manages the graphical user interface.
 class URHO3D_API UI : public Object
@@ -114,6 +117,8 @@ public:
     void SetUseMutableGlyphs(bool enable);
     /// Set whether to force font autohinting instead of using FreeType's TTF bytecode interpreter.
     void SetForceAutoHint(bool enable);
+    /// Set whether FreeType font glyphs beyond Latin-1 are rasterized on worker threads when first used. Until ready, they take space in the text but are not drawn. Default false.
+    void SetAsyncGlyphRasterization(bool enable);
     /// Set the hinting level used by FreeType fonts.
     void SetFontHintLevel(FontHintLevel level);
     /// Set the font subpixel threshold. Below this size, if the hint level is LIGHT or NONE, fonts will use subpixel positioning plus oversampling for higher-quality rendering. Has no effect at hint level NORMAL.
@@ -130,6 +135,16 @@ public:
     void SetCustomSize(const IntVector2& size);
     /// Set custom size of the root element.
     void SetCustomSize(int width, int height);
+    /// Set whether to accelerate element queries at a screen position with a grid of element rectangles, rebuilt when the element hierarchy moves or changes. Default true.
+    void SetUseHitTestIndex(bool enable);
+    /// Set whether element layout updates are deferred and processed once per frame top-down, instead of immediately on every change. Default false.
+    void SetDeferredLayout(bool enable);
+    /// Process the queued deferred layout updates now. Called automatically on update and before getting the batches.
+    void UpdateLayouts();
+    /// Queue an element for the deferred layout pass. Called by UIElement.
+    void QueueLayoutUpdate(UIElement* element);
+    /// Add a font face with glyphs being rasterized in the background, to be finished on update. Called by the font face.
+    void AddAsyncFontFace(FontFace* face);
 
     /// Return root UI element.
     UIElement* GetRoot() const { return rootElement_; }
@@ -206,6 +221,9 @@ public:
     /// Return whether is using forced autohinting.
     bool GetForceAutoHint() const { return forceAutoHint_; }
 
+    /// Return whether FreeType font glyphs are rasterized on worker threads.
+    bool GetAsyncGlyphRasterization() const { return asyncGlyphRasterization_; }
+
     /// Return the current FreeType font hinting level.
     FontHintLevel GetFontHintLevel() const { return fontHintLevel_; }
 
@@ -227,6 +245,12 @@ public:
     /// Return root element custom size. Returns 0,0 when custom size is not being used and automatic resizing according to window size is in use instead (default).
     const IntVector2& GetCustomSize() const { return customSize_; }
 
+    /// Return whether element layout updates are deferred.
+    bool GetDeferredLayout() const { return deferredLayout_; }
+
+    /// Return whether element queries at a screen position use the hit testing grid.
+    bool GetUseHitTestIndex() const { return useHitTestIndex_; }
+
     /// Set texture to which entire UI will be rendered.
     void SetRenderTarget(Texture2D* texture, Color clearColor = Color::TRANSPARENT_BLACK);
     /// Returns texture to which this UI is rendered.
@@ -264,12 +288,22 @@ private:
     void Update(float timeStep, UIElement* element);
     /// Upload UI geometry into a vertex buffer.
     void SetVertexData(VertexBuffer* dest, const ea::vector<float>& vertexData);
-    /// Render UI batches to the current rendertarget. Geometry must have been uploaded first.
-    void Render(VertexBuffer* buffer, const ea::vector<UIBatch>& batches, unsigned batchStart, unsigned batchEnd);
+    /// Render UI batches to the current rendertarget. Geometry must have been uploaded first. Origin is the UI position that maps to the top left corner of the rendertarget.
+    void Render(VertexBuffer* buffer, const ea::vector<UIBatch>& batches, unsigned batchStart, unsigned batchEnd,
+        const IntVector2& origin = IntVector2::ZERO);
+    /// Redraw the textures of render to texture elements that have changed.
+    void RenderElementTextures();
+    /// Return a batch drawing the texture of a render to texture element, regenerating its batches if necessary.
+    void GetRenderToTextureBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData, UIElement* element,
+        UIBatchCache& cache, const IntRect& currentScissor);
     /// Generate batches from an UI element recursively. Skip the cursor element.
     void GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData, UIElement* element, IntRect currentScissor);
+    /// Generate batches from an UI element recursively, ignoring its retained batches.
+    void GenerateBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData, UIElement* element, IntRect currentScissor);
     /// Return UI element at screen position recursively.
     void GetElementAt(UIElement*& result, UIElement* current, const IntVector2& position, bool enabledOnly);
+    /// Return the hit testing grid of a root element, reusing the grid of a destroyed root if possible.
+    UIHitTestIndex& GetHitTestIndex(UIElement* root);
     /// Return the first element in hierarchy that can alter focus.
     UIElement* GetFocusableElement(UIElement* element);
     /// Return the first element in hierarchy that can handle wheel.
@@ -323,10 +357,10 @@ private:
     void HandleTextInput(StringHash eventType, VariantMap& eventData);
     /// Handle frame begin event.
     void HandleBeginFrame(StringHash eventType, VariantMap& eventData);
-    /// Handle logic post-update event.
-    void HandlePostUpdate(StringHash eventType, VariantMap& eventData);
-    /// Handle render update event.
-    void HandleRenderUpdate(StringHash eventType, VariantMap& eventData);
+    /// Handle logic post-update signal.
+    void HandlePostUpdate(UpdateEventArgs& args);
+    /// Handle render update signal.
+    void HandleRenderUpdate(UpdateEventArgs& args);
     /// Handle a file being drag-dropped into the application window.
     void HandleDropFile(StringHash eventType, VariantMap& eventData);
     /// Handle off-screen UI subsystems gaining focus.
@@ -402,6 +436,10 @@ private:
     bool useMutableGlyphs_;
     /// Flag for forcing FreeType auto hinting.
     bool forceAutoHint_;
+    /// Flag for rasterizing FreeType glyphs on worker threads.
+    bool asyncGlyphRasterization_{};
+    /// Font faces with glyphs being rasterized in the background.
+    ea::vector<WeakPtr<FontFace> > asyncFontFaces_;
     /// FreeType hinting level (default is FONT_HINT_LEVEL_NORMAL).
     FontHintLevel fontHintLevel_;
     /// Maxmimum font size for subpixel glyph positioning and oversampling (default is 12).
@@ -412,6 +450,18 @@ private:
     bool uiRendered_;
     /// Non-modal batch size (used internally for rendering).
     unsigned nonModalBatchSize_;
+    /// Render to texture elements whose textures need to be redrawn this frame.
+    ea::vector<WeakPtr<UIElement> > dirtyTextureElements_;
+    /// Deferred layout flag.
+    bool deferredLayout_{};
+    /// Elements queued for the deferred layout pass.
+    ea::vector<WeakPtr<UIElement> > layoutDirtyElements_;
+    /// Hit testing grid flag.
+    bool useHitTestIndex_{true};
+    /// Hit testing grids of the root elements queried so far.
+    ea::vector<UIHitTestIndex> hitTestIndices_;
+    /// Elements of the current deferred layout pass, sorted by depth.
+    ea::vector<ea::pair<unsigned, WeakPtr<UIElement> > > layoutPassElements_;
     /// Timer used to trigger double click.
     Timer clickTimer_;
     /// UI element last clicked for tracking double clicks.
@@ -34,7 +34,9 @@ class PixelShader;
 class Graphics;
 class Matrix3x4;
 class Texture;
+class Texture2D;
 class UIElement;
+class VertexBuffer;
 
 static const unsigned UI_VERTEX_SIZE = 6;
 
@@ -100,4 +102,28 @@ public:
     static Vector3 posAdjust;
 };
 
+/// Retained rendering batches of an element subtree. Batches refer to the cache's own vertex data.
+struct UIBatchCache
+{
+    /// Cached batches.
+    ea::vector<UIBatch> batches_;
+    /// Cached vertex data.
+    ea::vector<float> vertexData_;
+    /// Scissor rectangle the batches were generated with.
+    IntRect scissor_;
+    /// Dirty flag. Set when anything in the subtree changes appearance.
+    bool dirty_{true};
+
+    /// Whether the batches are rendered into a texture, which is then drawn as a single quad.
+    bool renderToTexture_{};
+    /// Texture the batches are rendered into.
+    SharedPtr<Texture2D> texture_;
+    /// Vertex buffer for rendering the batches into the texture.
+    SharedPtr<VertexBuffer> vertexBuffer_;
+    /// Screen position that maps to the texture origin.
+    IntVector2 textureOrigin_;
+    /// Texture needs to be redrawn flag.
+    bool textureDirty_{};
+};
+
 }
@@ -26,6 +26,8 @@
 
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
+#include "../Graphics/Texture2D.h"
+#include "../Graphics/VertexBuffer.h"
 #include "../IO/Log.h"
 #include "../Resource/ResourceCache.h"
 #include "../Scene/ObjectAnimation.h"
@@ -144,6 +146,8 @@ void UIElement::RegisterObject(Context* context)
     URHO3D_ACCESSOR_ATTRIBUTE("Bring To Back", GetBringToBack, SetBringToBack, bool, true, AM_FILE);
     URHO3D_ACCESSOR_ATTRIBUTE("Clip Children", GetClipChildren, SetClipChildren, bool, false, AM_FILE);
     URHO3D_ACCESSOR_ATTRIBUTE("Use Derived Opacity", GetUseDerivedOpacity, SetUseDerivedOpacity, bool, true, AM_FILE);
+    URHO3D_ACCESSOR_ATTRIBUTE("Cache Batches", GetCacheBatches, SetCacheBatches, bool, false, AM_FILE);
+    URHO3D_ACCESSOR_ATTRIBUTE("Render To Texture", GetRenderToTexture, SetRenderToTexture, bool, false, AM_FILE);
     URHO3D_ENUM_ACCESSOR_ATTRIBUTE("Focus Mode", GetFocusMode, SetFocusMode, FocusMode, focusModes, FM_NOTFOCUSABLE, AM_FILE);
     URHO3D_ENUM_ACCESSOR_ATTRIBUTE("Drag And Drop Mode", GetDragDropMode, SetDragDropMode, DragAndDropModeFlags, dragDropModes, DD_DISABLED, AM_FILE);
     URHO3D_ENUM_ACCESSOR_ATTRIBUTE("Layout Mode", GetLayoutMode, SetLayoutMode, LayoutMode, layoutModes, LM_FREE, AM_FILE);
@@ -156,6 +160,19 @@ void UIElement::RegisterObject(Context* context)
     URHO3D_ATTRIBUTE("Tags", StringVector, tags_, Variant::emptyStringVector, AM_FILE);
 }
 
+void UIElement::OnSetAttribute(const AttributeInfo& attr, const Variant& src)
+{
+    Animatable::OnSetAttribute(attr, src);
+    // Style and animation write attributes such as colors directly to members
+    MarkBatchesDirty();
+}
+
+void UIElement::OnDirectAttributeSet(const AttributeInfo& attr)
+{
+    Animatable::OnDirectAttributeSet(attr);
+    MarkBatchesDirty();
+}
+
 void UIElement::ApplyAttributes()
 {
     colorGradient_ = false;
@@ -842,6 +859,7 @@ void UIElement::SetClipBorder(const IntRect& rect)
     clipBorder_.top_ = Max(rect.top_, 0);
     clipBorder_.right_ = Max(rect.right_, 0);
     clipBorder_.bottom_ = Max(rect.bottom_, 0);
+    MarkBatchesDirty();
 }
 
 void UIElement::SetColor(const Color& color)
@@ -850,6 +868,7 @@ void UIElement::SetColor(const Color& color)
         cornerColor = color;
     colorGradient_ = false;
     derivedColorDirty_ = true;
+    MarkBatchesDirty();
 }
 
 void UIElement::SetColor(Corner corner, const Color& color)
@@ -863,6 +882,7 @@ void UIElement::SetColor(Corner corner, const Color& color)
         if (i != corner && colors_[i] != colors_[corner])
             colorGradient_ = true;
     }
+    MarkBatchesDirty();
 }
 
 void UIElement::SetPriority(int priority)
@@ -873,6 +893,8 @@ void UIElement::SetPriority(int priority)
     priority_ = priority;
     if (parent_)
         parent_->sortOrderDirty_ = true;
+    MarkBatchesDirty();
+    MarkHitTestDirty();
 }
 
 void UIElement::SetOpacity(float opacity)
@@ -894,6 +916,8 @@ void UIElement::SetBringToBack(bool enable)
 void UIElement::SetClipChildren(bool enable)
 {
     clipChildren_ = enable;
+    MarkBatchesDirty();
+    MarkHitTestDirty();
 }
 
 void UIElement::SetSortChildren(bool enable)
@@ -902,22 +926,27 @@ void UIElement::SetSortChildren(bool enable)
         sortOrderDirty_ = true;
 
     sortChildren_ = enable;
+    MarkBatchesDirty();
+    MarkHitTestDirty();
 }
 
 void UIElement::SetUseDerivedOpacity(bool enable)
 {
     useDerivedOpacity_ = enable;
+    MarkDirty();
 }
 
 void UIElement::SetEnabled(bool enable)
 {
     enabled_ = enable;
     enabledPrev_ = enable;
+    MarkBatchesDirty();
 }
 
 void UIElement::SetDeepEnabled(bool enable)
 {
     enabled_ = enable;
+    MarkBatchesDirty();
 
     for (auto i = children_.begin(); i != children_.end(); ++i)
         (*i)->SetDeepEnabled(enable);
@@ -926,6 +955,7 @@ void UIElement::SetDeepEnabled(bool enable)
 void UIElement::ResetDeepEnabled()
 {
     enabled_ = enabledPrev_;
+    MarkBatchesDirty();
 
     for (auto i = children_.begin(); i != children_.end(); ++i)
         (*i)->ResetDeepEnabled();
@@ -935,6 +965,7 @@ void UIElement::SetEnabledRecursive(bool enable)
 {
     enabled_ = enable;
     enabledPrev_ = enable;
+    MarkBatchesDirty();
 
     for (auto i = children_.begin(); i != children_.end(); ++i)
         (*i)->SetEnabledRecursive(enable);
@@ -977,6 +1008,35 @@ void UIElement::SetFocus(bool enable)
 void UIElement::SetSelected(bool enable)
 {
     selected_ = enable;
+    MarkBatchesDirty();
+}
+
+void UIElement::SetCacheBatches(bool enable)
+{
+    if (enable == cacheBatches_)
+        return;
+
+    cacheBatches_ = enable;
+    UpdateBatchCache();
+}
+
+void UIElement::SetRenderToTexture(bool enable)
+{
+    if (enable == renderToTexture_)
+        return;
+
+    renderToTexture_ = enable;
+    UpdateBatchCache();
+}
+
+void UIElement::MarkBatchesDirty()
+{
+    // Caches of all parents contain this element, so walk up to the root
+    for (UIElement* element = this; element; element = element->parent_)
+    {
+        if (element->batchCache_)
+            element->batchCache_->dirty_ = true;
+    }
 }
 
 void UIElement::SetVisible(bool enable)
@@ -989,6 +1049,8 @@ void UIElement::SetVisible(bool enable)
     if (enable != visible_)
     {
         visible_ = enable;
+        MarkBatchesDirty();
+        MarkHitTestDirty();
 
         // Parent's layout may change as a result of visibility change
         if (parent_)
@@ -1119,6 +1181,25 @@ void UIElement::SetIndentSpacing(int indentSpacing)
 
 void UIElement::UpdateLayout()
 {
+    if (layoutNestingLevel_ || layoutDirty_)
+        return;
+
+    // Repeated updates within a frame collapse into one when deferred
+    auto* ui = GetSubsystem<UI>();
+    if (ui && ui->GetDeferredLayout())
+    {
+        layoutDirty_ = true;
+        ui->QueueLayoutUpdate(this);
+        return;
+    }
+
+    ApplyLayout();
+}
+
+void UIElement::ApplyLayout()
+{
+    // Same as an immediate update, a deferred one is dropped while layout update is disabled
+    layoutDirty_ = false;
     if (layoutNestingLevel_)
         return;
 
@@ -1388,6 +1469,8 @@ void UIElement::RemoveChild(UIElement* element, unsigned index)
 
             element->Detach();
             children_.erase_at(i);
+            MarkBatchesDirty();
+            MarkHitTestDirty();
             UpdateLayout();
             return;
         }
@@ -1415,6 +1498,8 @@ void UIElement::RemoveChildAtIndex(unsigned index)
 
     children_[index]->Detach();
     children_.erase_at(index);
+    MarkBatchesDirty();
+    MarkHitTestDirty();
     UpdateLayout();
 }
 
@@ -1441,6 +1526,8 @@ void UIElement::RemoveAllChildren()
         (*i++)->Detach();
     }
     children_.clear();
+    MarkBatchesDirty();
+    MarkHitTestDirty();
     UpdateLayout();
 }
 
@@ -1475,6 +1562,7 @@ void UIElement::SetInternal(bool enable)
 void UIElement::SetTraversalMode(TraversalMode traversalMode)
 {
     traversalMode_ = traversalMode;
+    MarkBatchesDirty();
 }
 
 void UIElement::SetElementEventSender(bool flag)
@@ -1833,6 +1921,8 @@ void UIElement::SetChildOffset(const IntVector2& offset)
 
 void UIElement::SetHovering(bool enable)
 {
+    if (enable != hovering_)
+        MarkBatchesDirty();
     hovering_ = enable;
 }
 
@@ -1957,13 +2047,59 @@ Animatable* UIElement::FindAttributeAnimationTarget(const ea::string& name, ea::
 }
 
 void UIElement::MarkDirty()
+{
+    MarkBatchesDirty();
+    MarkHitTestDirty();
+    MarkSubtreeDirty();
+}
+
+void UIElement::UpdateBatchCache()
+{
+    if (cacheBatches_ || renderToTexture_)
+    {
+        if (!batchCache_)
+            batchCache_ = ea::make_unique<UIBatchCache>();
+
+        batchCache_->renderToTexture_ = renderToTexture_;
+        if (!renderToTexture_)
+        {
+            batchCache_->texture_.Reset();
+            batchCache_->vertexBuffer_.Reset();
+            batchCache_->textureDirty_ = false;
+        }
+    }
+    else
+        batchCache_.reset();
+
+    MarkBatchesDirty();
+}
+
+void UIElement::MarkHitTestDirty()
+{
+    // A marked element has already incremented the revision of its root since the index was built
+    UIElement* element = this;
+    while (!element->hitTestDirty_)
+    {
+        element->hitTestDirty_ = true;
+        if (!element->parent_)
+        {
+            ++element->hitTestRevision_;
+            return;
+        }
+        element = element->parent_;
+    }
+}
+
+void UIElement::MarkSubtreeDirty()
 {
     positionDirty_ = true;
     opacityDirty_ = true;
     derivedColorDirty_ = true;
+    if (batchCache_)
+        batchCache_->dirty_ = true;
 
     for (auto i = children_.begin(); i != children_.end(); ++i)
-        (*i)->MarkDirty();
+        (*i)->MarkSubtreeDirty();
 }
 
 bool UIElement::RemoveChildXML(XMLElement& parent, const ea::string& name) const
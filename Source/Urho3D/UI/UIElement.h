@@ -24,6 +24,8 @@
 
 #pragma once
 
+#include <EASTL/unique_ptr.h>
+
 #include "../Math/Vector2.h"
 #include "../Input/InputConstants.h"
 #include "../Resource/XMLFile.h"
@@ -123,6 +125,8 @@ class URHO3D_API UIElement : public Animatable
 {
     URHO3D_OBJECT(UIElement, Animatable);
 
+    friend class UIHitTestIndex;
+
 public:
     /// Construct.
     explicit UIElement(Context* context);
@@ -131,6 +135,10 @@ public:
     /// Register object factory.
     static void RegisterObject(Context* context);
 
+    /// Handle attribute write access.
+    void OnSetAttribute(const AttributeInfo& attr, const Variant& src) override;
+    /// Handle attribute write through the typed accessor.
+    void OnDirectAttributeSet(const AttributeInfo& attr) override;
     /// Apply attribute changes that can not be applied immediately.
     void ApplyAttributes() override;
     /// Load from XML data. Return true if successful.
@@ -311,6 +319,12 @@ public:
     void SetFocus(bool enable);
     /// Set selected mode. Actual meaning is element dependent, for example constant hover or pressed effect.
     void SetSelected(bool enable);
+    /// Set whether to retain the rendering batches of child elements and regenerate them only when the subtree changes. Default false. Useful for large, mostly static subtrees.
+    void SetCacheBatches(bool enable);
+    /// Set whether to render child elements into a texture that is redrawn only when the subtree changes, and draw them as a single quad. Children are clipped to the element's rectangle. Best suited for panels with an opaque background. Default false.
+    void SetRenderToTexture(bool enable);
+    /// Mark the retained rendering batches of this element and its parents as needing regeneration. Custom elements should call this when their appearance changes without going through attributes or the position.
+    void MarkBatchesDirty();
     /// Set whether is visible. Visibility propagates to child elements.
     void SetVisible(bool enable);
     /// Set focus mode.
@@ -339,8 +353,10 @@ public:
     void SetIndent(int indent);
     /// Set indent spacing (number of pixels per indentation level).
     void SetIndentSpacing(int indentSpacing);
-    /// Manually update layout. Should not be necessary in most cases, but is provided for completeness.
+    /// Manually update layout. Should not be necessary in most cases, but is provided for completeness. When the %UI uses deferred layout, only queues the element for the layout pass.
     void UpdateLayout();
+    /// Recalculate layout immediately, bypassing the deferred layout pass.
+    void ApplyLayout();
     /// Disable automatic layout update. Should only be used if there are performance problems.
     void DisableLayoutUpdate();
     /// Enable automatic layout update.
@@ -531,6 +547,12 @@ public:
     /// Return whether is internally created.
     bool IsInternal() const { return internal_; }
 
+    /// Return whether the element is queued for the deferred layout pass.
+    bool IsLayoutDirty() const { return layoutDirty_; }
+
+    /// Return revision of the hit testing geometry of the subtree. Only maintained on the root element, incremented when any element of the subtree moves, resizes, changes visibility, order or parent.
+    unsigned GetHitTestRevision() const { return hitTestRevision_; }
+
     /// Return whether has different color in at least one corner.
     bool HasColorGradient() const { return colorGradient_; }
 
@@ -639,6 +661,15 @@ public:
     /// Return traversal mode for rendering.
     TraversalMode GetTraversalMode() const { return traversalMode_; }
 
+    /// Return whether retains the rendering batches of child elements.
+    bool GetCacheBatches() const { return cacheBatches_; }
+
+    /// Return whether renders child elements into a cached texture.
+    bool GetRenderToTexture() const { return renderToTexture_; }
+
+    /// Return retained rendering batches of child elements, or null if neither batch caching nor render to texture is enabled. Used internally by UI.
+    UIBatchCache* GetBatchCache() const { return batchCache_.get(); }
+
     /// Return whether element should send child added / removed events by itself. If false, defers to parent element.
     bool IsElementEventSender() const { return elementEventSender_; }
 
@@ -722,6 +753,12 @@ protected:
     unsigned resizeNestingLevel_{};
     /// Layout update nesting level to prevent endless loop.
     unsigned layoutNestingLevel_{};
+    /// Queued for the deferred layout pass flag.
+    bool layoutDirty_{};
+    /// Hit testing geometry revision, maintained on the root element.
+    unsigned hitTestRevision_{};
+    /// Marked dirty for hit testing since the hit test index was last built flag.
+    bool hitTestDirty_{};
     /// Layout element maximum size in layout direction.
     int layoutElementMaxSize_{};
     /// Horizontal indentation.
@@ -742,6 +779,12 @@ protected:
     unsigned dragButtonCount_{};
 
 private:
+    /// Mark screen position and retained batches as needing an update recursively, without touching parents.
+    void MarkSubtreeDirty();
+    /// Increment the hit testing revision of the root element, unless an ancestor has already been marked.
+    void MarkHitTestDirty();
+    /// Create or destroy the retained batches according to the batch caching and render to texture flags.
+    void UpdateBatchCache();
     /// Return child elements recursively.
     void GetChildrenRecursive(ea::vector<UIElement*>& dest) const;
     /// Return child elements with a specific tag recursively.
@@ -815,6 +858,12 @@ private:
     static XPathQuery styleXPathQuery_;
     /// Tag list.
     StringVector tags_;
+    /// Retain rendering batches flag.
+    bool cacheBatches_{};
+    /// Render to texture flag.
+    bool renderToTexture_{};
+    /// Retained rendering batches of child elements.
+    ea::unique_ptr<UIBatchCache> batchCache_;
 };
 
 template <class T> T* UIElement::CreateChild(const ea::string& name, unsigned index)
@@ -0,0 +1,152 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../UI/UIElement.h"
+#include "../UI/UIHitTestIndex.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+/// Preferred grid cell size in pixels.
+static const int HIT_TEST_CELL_SIZE = 64;
+/// Maximum number of grid cells in either direction.
+static const int HIT_TEST_MAX_CELLS = 128;
+
+void UIHitTestIndex::Build(UIElement* root, UIElement* excluded, unsigned revision)
+{
+    root_ = root;
+    excluded_ = excluded;
+    revision_ = revision;
+    entries_.clear();
+    cellStarts_.clear();
+    cellEntries_.clear();
+    bounds_ = IntRect::ZERO;
+    numCellsX_ = numCellsY_ = 0;
+
+    if (!root)
+        return;
+
+    // The recursive search does not clip by the root itself, it is checked by the caller
+    const int maxCoord = M_MAX_INT / 2;
+    Collect(root, excluded, IntRect(-maxCoord, -maxCoord, maxCoord, maxCoord));
+    if (entries_.empty())
+        return;
+
+    bounds_ = entries_.front().rect_;
+    for (const Entry& entry : entries_)
+        bounds_.Merge(entry.rect_);
+
+    // Grow the cells for very large or very spread out subtrees
+    const IntVector2 boundsSize = bounds_.Size();
+    cellSize_ = Max(HIT_TEST_CELL_SIZE, (Max(boundsSize.x_, boundsSize.y_) + HIT_TEST_MAX_CELLS - 1) / HIT_TEST_MAX_CELLS);
+    numCellsX_ = (boundsSize.x_ + cellSize_ - 1) / cellSize_;
+    numCellsY_ = (boundsSize.y_ + cellSize_ - 1) / cellSize_;
+
+    // Count, then fill the entries of each cell. Entries are visited in order, so the cells stay sorted
+    const auto forEachCell = [this](const IntRect& rect, const auto& callback)
+    {
+        const int x0 = (rect.left_ - bounds_.left_) / cellSize_;
+        const int y0 = (rect.top_ - bounds_.top_) / cellSize_;
+        const int x1 = (rect.right_ - 1 - bounds_.left_) / cellSize_;
+        const int y1 = (rect.bottom_ - 1 - bounds_.top_) / cellSize_;
+        for (int y = y0; y <= y1; ++y)
+        {
+            for (int x = x0; x <= x1; ++x)
+                callback(y * numCellsX_ + x);
+        }
+    };
+
+    cellStarts_.resize(numCellsX_ * numCellsY_ + 1, 0);
+    for (const Entry& entry : entries_)
+        forEachCell(entry.rect_, [this](int cell) { ++cellStarts_[cell + 1]; });
+    for (unsigned i = 1; i < cellStarts_.size(); ++i)
+        cellStarts_[i] += cellStarts_[i - 1];
+
+    ea::vector<unsigned> cellFill(cellStarts_.begin(), cellStarts_.end() - 1);
+    cellEntries_.resize(cellStarts_.back());
+    for (unsigned i = 0; i < entries_.size(); ++i)
+        forEachCell(entries_[i].rect_, [&](int cell) { cellEntries_[cellFill[cell]++] = i; });
+}
+
+UIElement* UIHitTestIndex::Query(const IntVector2& position, bool enabledOnly) const
+{
+    if (!numCellsX_ || !numCellsY_ || bounds_.IsInside(position) == OUTSIDE)
+        return nullptr;
+
+    const int x = (position.x_ - bounds_.left_) / cellSize_;
+    const int y = (position.y_ - bounds_.top_) / cellSize_;
+    if (x >= numCellsX_ || y >= numCellsY_)
+        return nullptr;
+
+    // Children come after their parents, so the last hit is the topmost one
+    const int cell = y * numCellsX_ + x;
+    for (unsigned i = cellStarts_[cell + 1]; i > cellStarts_[cell]; --i)
+    {
+        const Entry& entry = entries_[cellEntries_[i - 1]];
+        const IntRect& rect = entry.rect_;
+        if (position.x_ >= rect.left_ && position.y_ >= rect.top_ && position.x_ < rect.right_ && position.y_ < rect.bottom_ &&
+            (!enabledOnly || entry.element_->IsEnabled()) && entry.element_->IsInside(position, true))
+            return entry.element_;
+    }
+
+    return nullptr;
+}
+
+void UIHitTestIndex::Collect(UIElement* element, UIElement* excluded, const IntRect& clipRect)
+{
+    element->SortChildren();
+    element->hitTestDirty_ = false;
+
+    for (UIElement* child : element->GetChildren())
+    {
+        if (child == excluded || !child->IsVisible())
+        {
+            ClearDirty(child);
+            continue;
+        }
+
+        const IntVector2 screenPosition = child->GetScreenPosition();
+        IntRect rect(screenPosition, screenPosition + child->GetSize());
+        rect.Clip(clipRect);
+        if (rect.Width() > 0 && rect.Height() > 0)
+            entries_.push_back(Entry{child, rect});
+
+        // Children outside of a clipping element can not be hit
+        if (child->GetNumChildren())
+            Collect(child, excluded, child->GetClipChildren() ? rect : clipRect);
+        else
+            child->hitTestDirty_ = false;
+    }
+}
+
+void UIHitTestIndex::ClearDirty(UIElement* element)
+{
+    element->hitTestDirty_ = false;
+    for (UIElement* child : element->GetChildren())
+        ClearDirty(child);
+}
+
+}
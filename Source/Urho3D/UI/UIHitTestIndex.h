@@ -0,0 +1,90 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include "../Container/Ptr.h"
+#include "../Math/Rect.h"
+
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+class UIElement;
+
+/// Uniform grid of the screen rectangles of an UI element subtree, used to accelerate UI::GetElementAt.
+class URHO3D_API UIHitTestIndex
+{
+public:
+    /// Rebuild from the subtree of the root element, skipping the excluded element (the cursor). Sorts children as a side effect.
+    void Build(UIElement* root, UIElement* excluded, unsigned revision);
+    /// Return the topmost element at screen position, or null if none. Candidates found by their rectangles are confirmed with UIElement::IsInside(), so the result is the same as of the recursive search, without visiting the whole subtree.
+    UIElement* Query(const IntVector2& position, bool enabledOnly) const;
+    /// Return whether is built from the root element at the revision with the same excluded element.
+    bool IsValid(UIElement* root, UIElement* excluded, unsigned revision) const
+    {
+        return root_ && root_ == root && excluded_ == excluded && revision_ == revision;
+    }
+    /// Return root element, or null if not built or the root has been destroyed.
+    UIElement* GetRoot() const { return root_; }
+
+private:
+    /// Element with its screen rectangle, clipped by the parents.
+    struct Entry
+    {
+        /// Element.
+        UIElement* element_;
+        /// Clipped screen rectangle.
+        IntRect rect_;
+    };
+
+    /// Collect entries of the children of an element in the order of the recursive search.
+    void Collect(UIElement* element, UIElement* excluded, const IntRect& clipRect);
+    /// Clear the hit test dirty flags of a subtree that is not collected.
+    static void ClearDirty(UIElement* element);
+
+    /// Root element.
+    WeakPtr<UIElement> root_;
+    /// Excluded element.
+    WeakPtr<UIElement> excluded_;
+    /// Revision of the root element the index was built at.
+    unsigned revision_{};
+    /// Entries in search order, topmost last.
+    ea::vector<Entry> entries_;
+    /// Bounds of all entries.
+    IntRect bounds_;
+    /// Cell size in pixels.
+    int cellSize_{};
+    /// Number of cells in the horizontal direction.
+    int numCellsX_{};
+    /// Number of cells in the vertical direction.
+    int numCellsY_{};
+    /// Start of the entry index range of each cell, plus the end of the last one.
+    ea::vector<unsigned> cellStarts_;
+    /// Entry indices of all cells in ascending order per cell.
+    ea::vector<unsigned> cellEntries_;
+};
+
+}
@@ -303,7 +303,7 @@ void AnimatedSprite2D::UpdateSpineAnimation(float timeStep)
     spSkeleton_updateWorldTransform(skeleton_);
 
     sourceBatchesDirty_ = true;
-    worldBoundingBoxDirty_ = true;
+    MarkWorldBoundingBoxDirty();
 }
 
 // This enum used to be defined in spine/RegionAttachment.h but it got moved inside RegionAttachment.c so it's no longer accessible.
@@ -415,7 +415,7 @@ void AnimatedSprite2D::UpdateSpriterAnimation(float timeStep)
 {
     spriterInstance_->Update(timeStep * speed_);
     sourceBatchesDirty_ = true;
-    worldBoundingBoxDirty_ = true;
+    MarkWorldBoundingBoxDirty();
 }
 
 void AnimatedSprite2D::UpdateSourceBatchesSpriter()
@@ -22,6 +22,8 @@
 
 #include "../Precompiled.h"
 
+#include <atomic>
+
 #include "../Core/Context.h"
 #include "../Graphics/Camera.h"
 #include "../Graphics/Material.h"
@@ -37,6 +39,9 @@ namespace Urho3D
 
 const float PIXEL_SIZE = 0.01f;
 
+/// Source batches revision counter shared by all drawables, so that a revision never repeats for a reused allocation.
+static std::atomic<unsigned> sourceBatchesRevisionCounter{};
+
 SourceBatch2D::SourceBatch2D() :
     distance_(0.0f),
     drawOrder_(0)
@@ -99,7 +104,10 @@ void Drawable2D::SetOrderInLayer(int orderInLayer)
 const ea::vector<SourceBatch2D>& Drawable2D::GetSourceBatches()
 {
     if (sourceBatchesDirty_)
+    {
         UpdateSourceBatches();
+        sourceBatchesRevision_ = ++sourceBatchesRevisionCounter;
+    }
 
     return sourceBatches_;
 }
@@ -123,6 +123,8 @@ public:
 
     /// Return all source batches (called by Renderer2D).
     const ea::vector<SourceBatch2D>& GetSourceBatches();
+    /// Return revision of the source batches, which changes every time they are updated (called by Renderer2D).
+    unsigned GetSourceBatchesRevision() const { return sourceBatchesRevision_; }
 
 protected:
     /// Handle scene being assigned.
@@ -145,6 +147,8 @@ protected:
     ea::vector<SourceBatch2D> sourceBatches_;
     /// Source batches dirty flag.
     bool sourceBatchesDirty_;
+    /// Revision of the source batches.
+    unsigned sourceBatchesRevision_{};
     /// Renderer2D.
     WeakPtr<Renderer2D> renderer_;
 };
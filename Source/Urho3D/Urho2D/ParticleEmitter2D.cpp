@@ -23,6 +23,8 @@
 #include "../Precompiled.h"
 
 #include "../Core/Context.h"
+#include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/Camera.h"
 #include "../Graphics/Material.h"
 #include "../Graphics/Technique.h"
@@ -42,6 +44,9 @@ namespace Urho3D
 
 extern const char* URHO2D_CATEGORY;
 
+/// Number of particles updated by one ParallelFor chunk. Smaller emitters are updated on the calling thread.
+static const unsigned PARTICLE_UPDATE_GRAIN_SIZE = 2048;
+
 ParticleEmitter2D::ParticleEmitter2D(Context* context) :
     Drawable2D(context),
     blendMode_(BLEND_ADDALPHA),
@@ -221,6 +226,10 @@ void ParticleEmitter2D::UpdateSourceBatches()
     if (!sprite_->GetTextureRectangle(textureRect))
         return;
 
+    // Write vertices in place instead of growing the array quad by quad
+    vertices.resize(numParticles_ * 4);
+    Vertex2D* dest = vertices.data();
+
     /*
     V1---------V2
     |         / |
@@ -257,10 +266,11 @@ void ParticleEmitter2D::UpdateSourceBatches()
 
         vertex0.color_ = vertex1.color_ = vertex2.color_ = vertex3.color_ = p.color_.ToUInt();
 
-        vertices.push_back(vertex0);
-        vertices.push_back(vertex1);
-        vertices.push_back(vertex2);
-        vertices.push_back(vertex3);
+        dest[0] = vertex0;
+        dest[1] = vertex1;
+        dest[2] = vertex2;
+        dest[3] = vertex3;
+        dest += 4;
     }
 
     sourceBatchesDirty_ = false;
@@ -319,15 +329,12 @@ void ParticleEmitter2D::Update(float timeStep)
     boundingBoxMinPoint_ = Vector3(M_INFINITY, M_INFINITY, M_INFINITY);
     boundingBoxMaxPoint_ = Vector3(-M_INFINITY, -M_INFINITY, -M_INFINITY);
 
+    // Remove expired particles first so that the live ones can be updated as one contiguous range
     unsigned particleIndex = 0;
     while (particleIndex < numParticles_)
     {
-        Particle2D& particle = particles_[particleIndex];
-        if (particle.timeToLive_ > 0.0f)
-        {
-            UpdateParticle(particle, timeStep, worldPosition, worldScale);
+        if (particles_[particleIndex].timeToLive_ > 0.0f)
             ++particleIndex;
-        }
         else
         {
             if (particleIndex != numParticles_ - 1)
@@ -336,6 +343,30 @@ void ParticleEmitter2D::Update(float timeStep)
         }
     }
 
+    auto* queue = GetSubsystem<WorkQueue>();
+    if (queue && numParticles_ >= 2 * PARTICLE_UPDATE_GRAIN_SIZE)
+    {
+        URHO3D_PROFILE("UpdateParticles2D");
+
+        rangeBounds_.resize((numParticles_ + PARTICLE_UPDATE_GRAIN_SIZE - 1) / PARTICLE_UPDATE_GRAIN_SIZE);
+        queue->ParallelFor(numParticles_, PARTICLE_UPDATE_GRAIN_SIZE, [&](unsigned begin, unsigned end, unsigned)
+        {
+            ea::pair<Vector3, Vector3>& bounds = rangeBounds_[begin / PARTICLE_UPDATE_GRAIN_SIZE];
+            bounds.first = boundingBoxMinPoint_;
+            bounds.second = boundingBoxMaxPoint_;
+            UpdateParticles(begin, end, timeStep, worldScale, bounds.first, bounds.second);
+        });
+        queue->Complete(M_MAX_UNSIGNED);
+
+        for (const auto& bounds : rangeBounds_)
+        {
+            boundingBoxMinPoint_ = VectorMin(boundingBoxMinPoint_, bounds.first);
+            boundingBoxMaxPoint_ = VectorMax(boundingBoxMaxPoint_, bounds.second);
+        }
+    }
+    else
+        UpdateParticles(0, numParticles_, timeStep, worldScale, boundingBoxMinPoint_, boundingBoxMaxPoint_);
+
     if (emitting_ && emissionTime_ > 0.0f)
     {
         float worldAngle = GetNode()->GetWorldRotation().RollAngle();
@@ -346,7 +377,10 @@ void ParticleEmitter2D::Update(float timeStep)
         while (emitParticleTime_ > 0.0f)
         {
             if (EmitParticle(worldPosition, worldAngle, worldScale))
-                UpdateParticle(particles_[numParticles_ - 1], emitParticleTime_, worldPosition, worldScale);
+            {
+                UpdateParticles(numParticles_ - 1, numParticles_, emitParticleTime_, worldScale, boundingBoxMinPoint_,
+                    boundingBoxMaxPoint_);
+            }
 
             emitParticleTime_ -= timeBetweenParticles;
         }
@@ -414,60 +448,74 @@ bool ParticleEmitter2D::EmitParticle(const Vector3& worldPosition, float worldAn
     return true;
 }
 
-void ParticleEmitter2D::UpdateParticle(Particle2D& particle, float timeStep, const Vector3& worldPosition, float worldScale)
+void ParticleEmitter2D::UpdateParticles(unsigned begin, unsigned end, float timeStep, float worldScale, Vector3& boundsMin,
+    Vector3& boundsMax)
 {
-    if (timeStep > particle.timeToLive_)
-        timeStep = particle.timeToLive_;
+    // Effect parameters are the same for all particles, so read them once
+    const bool radial = effect_->GetEmitterType() == EMITTER_TYPE_RADIAL;
+    const Vector2 gravity = effect_->GetGravity() * worldScale;
+
+    Vector3 minPoint = boundsMin;
+    Vector3 maxPoint = boundsMax;
+    Particle2D* particles = particles_.data();
+    for (unsigned i = begin; i < end; ++i)
+    {
+        Particle2D& particle = particles[i];
+        const float particleTimeStep = Min(timeStep, particle.timeToLive_);
 
-    particle.timeToLive_ -= timeStep;
+        particle.timeToLive_ -= particleTimeStep;
 
-    if (effect_->GetEmitterType() == EMITTER_TYPE_RADIAL)
-    {
-        particle.emitRotation_ += particle.emitRotationDelta_ * timeStep;
-        particle.emitRadius_ += particle.emitRadiusDelta_ * timeStep;
+        if (radial)
+        {
+            particle.emitRotation_ += particle.emitRotationDelta_ * particleTimeStep;
+            particle.emitRadius_ += particle.emitRadiusDelta_ * particleTimeStep;
 
-        particle.position_.x_ = particle.startPos_.x_ - Cos(particle.emitRotation_) * particle.emitRadius_;
-        particle.position_.y_ = particle.startPos_.y_ + Sin(particle.emitRotation_) * particle.emitRadius_;
-    }
-    else
-    {
-        float distanceX = particle.position_.x_ - particle.startPos_.x_;
-        float distanceY = particle.position_.y_ - particle.startPos_.y_;
+            particle.position_.x_ = particle.startPos_.x_ - Cos(particle.emitRotation_) * particle.emitRadius_;
+            particle.position_.y_ = particle.startPos_.y_ + Sin(particle.emitRotation_) * particle.emitRadius_;
+        }
+        else
+        {
+            float distanceX = particle.position_.x_ - particle.startPos_.x_;
+            float distanceY = particle.position_.y_ - particle.startPos_.y_;
 
-        float distanceScalar = Vector2(distanceX, distanceY).Length();
-        if (distanceScalar < 0.0001f)
-            distanceScalar = 0.0001f;
+            float distanceScalar = Vector2(distanceX, distanceY).Length();
+            if (distanceScalar < 0.0001f)
+                distanceScalar = 0.0001f;
 
-        float radialX = distanceX / distanceScalar;
-        float radialY = distanceY / distanceScalar;
+            float radialX = distanceX / distanceScalar;
+            float radialY = distanceY / distanceScalar;
 
-        float tangentialX = radialX;
-        float tangentialY = radialY;
+            float tangentialX = radialX;
+            float tangentialY = radialY;
 
-        radialX *= particle.radialAcceleration_;
-        radialY *= particle.radialAcceleration_;
+            radialX *= particle.radialAcceleration_;
+            radialY *= particle.radialAcceleration_;
 
-        float newY = tangentialX;
-        tangentialX = -tangentialY * particle.tangentialAcceleration_;
-        tangentialY = newY * particle.tangentialAcceleration_;
+            float newY = tangentialX;
+            tangentialX = -tangentialY * particle.tangentialAcceleration_;
+            tangentialY = newY * particle.tangentialAcceleration_;
+
+            particle.velocity_.x_ += (gravity.x_ + radialX - tangentialX) * particleTimeStep;
+            particle.velocity_.y_ -= (gravity.y_ - radialY + tangentialY) * particleTimeStep;
+            particle.position_.x_ += particle.velocity_.x_ * particleTimeStep;
+            particle.position_.y_ += particle.velocity_.y_ * particleTimeStep;
+        }
 
-        particle.velocity_.x_ += (effect_->GetGravity().x_ * worldScale + radialX - tangentialX) * timeStep;
-        particle.velocity_.y_ -= (effect_->GetGravity().y_ * worldScale - radialY + tangentialY) * timeStep;
-        particle.position_.x_ += particle.velocity_.x_ * timeStep;
-        particle.position_.y_ += particle.velocity_.y_ * timeStep;
+        particle.size_ += particle.sizeDelta_ * particleTimeStep;
+        particle.rotation_ += particle.rotationDelta_ * particleTimeStep;
+        particle.color_ += particle.colorDelta_ * particleTimeStep;
+
+        float halfSize = particle.size_ * 0.5f;
+        minPoint.x_ = Min(minPoint.x_, particle.position_.x_ - halfSize);
+        minPoint.y_ = Min(minPoint.y_, particle.position_.y_ - halfSize);
+        minPoint.z_ = Min(minPoint.z_, particle.position_.z_);
+        maxPoint.x_ = Max(maxPoint.x_, particle.position_.x_ + halfSize);
+        maxPoint.y_ = Max(maxPoint.y_, particle.position_.y_ + halfSize);
+        maxPoint.z_ = Max(maxPoint.z_, particle.position_.z_);
     }
 
-    particle.size_ += particle.sizeDelta_ * timeStep;
-    particle.rotation_ += particle.rotationDelta_ * timeStep;
-    particle.color_ += particle.colorDelta_ * timeStep;
-
-    float halfSize = particle.size_ * 0.5f;
-    boundingBoxMinPoint_.x_ = Min(boundingBoxMinPoint_.x_, particle.position_.x_ - halfSize);
-    boundingBoxMinPoint_.y_ = Min(boundingBoxMinPoint_.y_, particle.position_.y_ - halfSize);
-    boundingBoxMinPoint_.z_ = Min(boundingBoxMinPoint_.z_, particle.position_.z_);
-    boundingBoxMaxPoint_.x_ = Max(boundingBoxMaxPoint_.x_, particle.position_.x_ + halfSize);
-    boundingBoxMaxPoint_.y_ = Max(boundingBoxMaxPoint_.y_, particle.position_.y_ + halfSize);
-    boundingBoxMaxPoint_.z_ = Max(boundingBoxMaxPoint_.z_, particle.position_.z_);
+    boundsMin = minPoint;
+    boundsMax = maxPoint;
 }
 
 }
@@ -138,8 +138,8 @@ private:
     void Update(float timeStep);
     /// Emit particle.
     bool EmitParticle(const Vector3& worldPosition, float worldAngle, float worldScale);
-    /// Update particle.
-    void UpdateParticle(Particle2D& particle, float timeStep, const Vector3& worldPosition, float worldScale);
+    /// Update particles in range [begin, end) and merge their bounds. May be called from worker threads for disjoint ranges.
+    void UpdateParticles(unsigned begin, unsigned end, float timeStep, float worldScale, Vector3& boundsMin, Vector3& boundsMax);
 
     /// Particle effect.
     SharedPtr<ParticleEffect2D> effect_;
@@ -161,6 +161,8 @@ private:
     Vector3 boundingBoxMinPoint_;
     /// Bounding box max point.
     Vector3 boundingBoxMaxPoint_;
+    /// Bounds of particle ranges updated in parallel.
+    ea::vector<ea::pair<Vector3, Vector3> > rangeBounds_;
 };
 
 }
@@ -71,6 +71,12 @@ URHO3D_EVENT(E_PHYSICSENDCONTACT2D, PhysicsEndContact2D)
     URHO3D_PARAM(P_SHAPEB, ShapeB);                // CollisionShape2D pointer
 }
 
+/// Physics contacts of a simulation step are available in the contact stream. Sent once per step by PhysicsWorld2D when contacts began or ended, regardless of whether per-pair contact events are enabled.
+URHO3D_EVENT(E_PHYSICSCONTACTS2D, PhysicsContacts2D)
+{
+    URHO3D_PARAM(P_WORLD, World);                  // PhysicsWorld2D pointer
+}
+
 /// Node update contact. Sent by scene nodes participating in a collision.
 URHO3D_EVENT(E_NODEUPDATECONTACT2D, NodeUpdateContact2D)
 {
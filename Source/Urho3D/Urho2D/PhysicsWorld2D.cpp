@@ -24,6 +24,8 @@
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../Core/Thread.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Renderer.h"
@@ -45,6 +47,10 @@ extern const char* SUBSYSTEM_CATEGORY;
 static const Vector2 DEFAULT_GRAVITY(0.0f, -9.81f);
 static const int DEFAULT_VELOCITY_ITERATIONS = 8;
 static const int DEFAULT_POSITION_ITERATIONS = 3;
+/// Minimum number of rigid bodies to gather world transforms in parallel.
+static const unsigned PARALLEL_TRANSFORMS_MIN_BODIES = 1024;
+/// Number of rigid bodies per parallel world transform gathering task.
+static const unsigned PARALLEL_TRANSFORMS_GRAIN_SIZE = 256;
 
 PhysicsWorld2D::PhysicsWorld2D(Context* context) :
     Component(context),
@@ -115,7 +121,9 @@ void PhysicsWorld2D::BeginContact(b2Contact* contact)
     if (!fixtureA || !fixtureB)
         return;
 
-    beginContactInfos_.push_back(ContactInfo(contact));
+    AddContactPair(beginContactPairs_, contact);
+    if (contactEventsEnabled_)
+        beginContactInfos_.push_back(ContactInfo(contact));
 }
 
 void PhysicsWorld2D::EndContact(b2Contact* contact)
@@ -128,11 +136,17 @@ void PhysicsWorld2D::EndContact(b2Contact* contact)
     if (!fixtureA || !fixtureB)
         return;
 
-    endContactInfos_.push_back(ContactInfo(contact));
+    AddContactPair(endContactPairs_, contact);
+    if (contactEventsEnabled_)
+        endContactInfos_.push_back(ContactInfo(contact));
 }
 
 void PhysicsWorld2D::PreSolve(b2Contact* contact, const b2Manifold* oldManifold)
 {
+    // Events can not be sent while the world is stepped concurrently, even if this part runs on the main thread
+    if (!contactEventsEnabled_ || steppingConcurrently_)
+        return;
+
     b2Fixture* fixtureA = contact->GetFixtureA();
     b2Fixture* fixtureB = contact->GetFixtureB();
     if (!fixtureA || !fixtureB)
@@ -280,6 +294,50 @@ void PhysicsWorld2D::Update(float timeStep)
 {
     URHO3D_PROFILE("UpdatePhysics2D");
 
+    PreStep(timeStep);
+    Step(timeStep);
+    PostStep(timeStep);
+}
+
+void PhysicsWorld2D::UpdateWorlds(ea::span<PhysicsWorld2D* const> worlds, float timeStep)
+{
+    if (worlds.empty())
+        return;
+
+    URHO3D_PROFILE("UpdatePhysics2DWorlds");
+
+    for (PhysicsWorld2D* world : worlds)
+        world->PreStep(timeStep);
+
+    // Box2D worlds share no state, so they can be stepped concurrently. Events are sent after all steps have completed
+    auto* workQueue = worlds[0]->GetSubsystem<WorkQueue>();
+    if (workQueue && workQueue->GetNumThreads() > 0 && worlds.size() > 1 && Thread::IsMainThread())
+    {
+        for (PhysicsWorld2D* world : worlds)
+            world->steppingConcurrently_ = true;
+
+        workQueue->ParallelFor(worlds.size(), 1, [worlds, timeStep](unsigned begin, unsigned end, unsigned /*threadIndex*/)
+        {
+            for (unsigned i = begin; i < end; ++i)
+                worlds[i]->Step(timeStep);
+        });
+        workQueue->Complete(M_MAX_UNSIGNED);
+
+        for (PhysicsWorld2D* world : worlds)
+            world->steppingConcurrently_ = false;
+    }
+    else
+    {
+        for (PhysicsWorld2D* world : worlds)
+            world->Step(timeStep);
+    }
+
+    for (PhysicsWorld2D* world : worlds)
+        world->PostStep(timeStep);
+}
+
+void PhysicsWorld2D::PreStep(float timeStep)
+{
     using namespace PhysicsPreStep;
 
     VariantMap& eventData = GetEventDataMap();
@@ -287,23 +345,89 @@ void PhysicsWorld2D::Update(float timeStep)
     eventData[P_TIMESTEP] = timeStep;
     SendEvent(E_PHYSICSPRESTEP, eventData);
 
+    beginContactPairs_.clear();
+    endContactPairs_.clear();
+    contactPoints_.clear();
+}
+
+void PhysicsWorld2D::Step(float timeStep)
+{
     physicsStepping_ = true;
     world_->Step(timeStep, velocityIterations_, positionIterations_);
     physicsStepping_ = false;
+}
+
+void PhysicsWorld2D::PostStep(float timeStep)
+{
+    ApplyWorldTransforms();
+
+    SendBeginContactEvents();
+    SendEndContactEvents();
+
+    if (!beginContactPairs_.empty() || !endContactPairs_.empty())
+    {
+        using namespace PhysicsContacts2D;
+        VariantMap& eventData = GetEventDataMap();
+        eventData[P_WORLD] = this;
+        SendEvent(E_PHYSICSCONTACTS2D, eventData);
+    }
+
+    using namespace PhysicsPostStep;
+    VariantMap& eventData = GetEventDataMap();
+    eventData[P_WORLD] = this;
+    eventData[P_TIMESTEP] = timeStep;
+    SendEvent(E_PHYSICSPOSTSTEP, eventData);
+}
+
+void PhysicsWorld2D::ApplyWorldTransforms()
+{
+    URHO3D_PROFILE("ApplyWorldTransforms2D");
 
-    // Apply world transforms. Unparented transforms first
+    // Erase possible stale weak pointers
     for (unsigned i = 0; i < rigidBodies_.size();)
     {
         if (rigidBodies_[i])
-        {
-            rigidBodies_[i]->ApplyWorldTransform();
             ++i;
-        }
         else
-        {
-            // Erase possible stale weak pointer
             rigidBodies_.erase_at(i);
+    }
+
+    // Applying a transform may destroy other bodies or change the body list, so work on a copy of it
+    pendingRigidBodies_ = rigidBodies_;
+
+    // Gather the transforms of moved bodies. This does not modify the nodes, so can be done in parallel
+    const unsigned numBodies = pendingRigidBodies_.size();
+    pendingWorldTransforms_.resize(numBodies);
+    const auto gatherTransforms = [this](unsigned begin, unsigned end, unsigned /*threadIndex*/)
+    {
+        for (unsigned i = begin; i < end; ++i)
+        {
+            if (!pendingRigidBodies_[i]->GetWorldTransformFromBody(pendingWorldTransforms_[i]))
+                pendingWorldTransforms_[i].rigidBody_ = nullptr;
         }
+    };
+
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    if (workQueue && workQueue->GetNumThreads() > 0 && numBodies >= PARALLEL_TRANSFORMS_MIN_BODIES && Thread::IsMainThread())
+    {
+        workQueue->ParallelFor(numBodies, PARALLEL_TRANSFORMS_GRAIN_SIZE, gatherTransforms);
+        workQueue->Complete(M_MAX_UNSIGNED);
+    }
+    else
+        gatherTransforms(0, numBodies, 0);
+
+    // Apply world transforms serially, as node dirtying is not thread-safe. Unparented transforms first
+    for (unsigned i = 0; i < numBodies; ++i)
+    {
+        DelayedWorldTransform2D& transform = pendingWorldTransforms_[i];
+        if (!transform.rigidBody_ || !pendingRigidBodies_[i] || !transform.rigidBody_->GetNode())
+            continue;
+
+        transform.worldPosition_.z_ = transform.rigidBody_->GetNode()->GetWorldPosition().z_;
+        if (transform.parentRigidBody_)
+            AddDelayedWorldTransform(transform);
+        else
+            transform.rigidBody_->ApplyWorldTransform(transform.worldPosition_, transform.worldRotation_);
     }
 
     // Apply delayed (parented) world transforms now, if any
@@ -312,24 +436,22 @@ void PhysicsWorld2D::Update(float timeStep)
         for (auto i = delayedWorldTransforms_.begin();
             i != delayedWorldTransforms_.end();)
         {
-            const DelayedWorldTransform2D& transform = i->second;
+            RigidBody2D* rigidBody = i->second.first;
+            const DelayedWorldTransform2D& transform = i->second.second;
 
-            // If parent's transform has already been assigned, can proceed
-            if (!delayedWorldTransforms_.contains(transform.parentRigidBody_))
+            // If parent's transform has already been assigned, can proceed. Skip bodies destroyed meanwhile
+            if (!rigidBody || !rigidBody->GetNode())
+                i = delayedWorldTransforms_.erase(i);
+            else if (!delayedWorldTransforms_.contains(transform.parentRigidBody_))
             {
-                transform.rigidBody_->ApplyWorldTransform(transform.worldPosition_, transform.worldRotation_);
+                const DelayedWorldTransform2D appliedTransform = transform;
                 i = delayedWorldTransforms_.erase(i);
+                rigidBody->ApplyWorldTransform(appliedTransform.worldPosition_, appliedTransform.worldRotation_);
             }
             else
                 ++i;
         }
     }
-
-    SendBeginContactEvents();
-    SendEndContactEvents();
-
-    using namespace PhysicsPostStep;
-    SendEvent(E_PHYSICSPOSTSTEP, eventData);
 }
 
 void PhysicsWorld2D::DrawDebugGeometry()
@@ -427,6 +549,11 @@ void PhysicsWorld2D::SetPositionIterations(int positionIterations)
     positionIterations_ = positionIterations;
 }
 
+void PhysicsWorld2D::SetContactEventsEnabled(bool enable)
+{
+    contactEventsEnabled_ = enable;
+}
+
 void PhysicsWorld2D::AddRigidBody(RigidBody2D* rigidBody)
 {
     if (!rigidBody)
@@ -446,11 +573,15 @@ void PhysicsWorld2D::RemoveRigidBody(RigidBody2D* rigidBody)
 
     WeakPtr<RigidBody2D> rigidBodyPtr(rigidBody);
     rigidBodies_.erase_first(rigidBodyPtr);
+
+    const auto involvesBody = [rigidBody](const PhysicsContactPair2D& pair) { return pair.bodyA_ == rigidBody || pair.bodyB_ == rigidBody; };
+    ea::erase_if(beginContactPairs_, involvesBody);
+    ea::erase_if(endContactPairs_, involvesBody);
 }
 
 void PhysicsWorld2D::AddDelayedWorldTransform(const DelayedWorldTransform2D& transform)
 {
-    delayedWorldTransforms_[transform.rigidBody_] = transform;
+    delayedWorldTransforms_[transform.rigidBody_] = ea::make_pair(WeakPtr<RigidBody2D>(transform.rigidBody_), transform);
 }
 
 // Ray cast call back class.
@@ -720,6 +851,33 @@ void PhysicsWorld2D::HandleSceneSubsystemUpdate(StringHash eventType, VariantMap
     Update(eventData[P_TIMESTEP].GetFloat());
 }
 
+void PhysicsWorld2D::AddContactPair(ea::vector<PhysicsContactPair2D>& pairs, b2Contact* contact)
+{
+    b2Fixture* fixtureA = contact->GetFixtureA();
+    b2Fixture* fixtureB = contact->GetFixtureB();
+
+    PhysicsContactPair2D pair;
+    pair.bodyA_ = static_cast<RigidBody2D*>(fixtureA->GetBody()->GetUserData());
+    pair.bodyB_ = static_cast<RigidBody2D*>(fixtureB->GetBody()->GetUserData());
+    pair.shapeA_ = static_cast<CollisionShape2D*>(fixtureA->GetUserData());
+    pair.shapeB_ = static_cast<CollisionShape2D*>(fixtureB->GetUserData());
+
+    b2WorldManifold worldManifold;
+    contact->GetWorldManifold(&worldManifold);
+    pair.normal_ = Vector2(worldManifold.normal.x, worldManifold.normal.y);
+    pair.firstContact_ = contactPoints_.size();
+    pair.numContacts_ = static_cast<unsigned>(contact->GetManifold()->pointCount);
+
+    for (unsigned i = 0; i < pair.numContacts_; ++i)
+    {
+        PhysicsContactPoint2D& point = contactPoints_.emplace_back();
+        point.position_ = Vector2(worldManifold.points[i].x, worldManifold.points[i].y);
+        point.separation_ = worldManifold.separations[i];
+    }
+
+    pairs.push_back(pair);
+}
+
 void PhysicsWorld2D::SendBeginContactEvents()
 {
     if (beginContactInfos_.empty())
@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include <EASTL/span.h>
+
 #include "../Scene/Component.h"
 #include "../IO/VectorBuffer.h"
 
@@ -66,6 +68,34 @@ struct DelayedWorldTransform2D
     Quaternion worldRotation_;
 };
 
+/// Contact point of the batched 2D contact stream.
+struct PhysicsContactPoint2D
+{
+    /// Contact worldspace position.
+    Vector2 position_;
+    /// Contact separation, negative on overlap.
+    float separation_{};
+};
+
+/// Contacting 2D body pair of the batched contact stream. Pointers are valid until the next simulation step, unless the bodies or shapes are destroyed.
+struct PhysicsContactPair2D
+{
+    /// First rigid body.
+    RigidBody2D* bodyA_{};
+    /// Second rigid body.
+    RigidBody2D* bodyB_{};
+    /// First collision shape.
+    CollisionShape2D* shapeA_{};
+    /// Second collision shape.
+    CollisionShape2D* shapeB_{};
+    /// Contact worldspace normal, shared by all points.
+    Vector2 normal_;
+    /// Index of the first contact point.
+    unsigned firstContact_{};
+    /// Number of contact points.
+    unsigned numContacts_{};
+};
+
 /// 2D physics simulation world component. Should be added only to the root scene node.
 class URHO3D_API PhysicsWorld2D : public Component, public b2ContactListener, public b2Draw
 {
@@ -108,6 +138,8 @@ public:
 
     /// Step the simulation forward.
     void Update(float timeStep);
+    /// Step several independent worlds forward, concurrently on the work queue. Transforms are applied and events are sent for each world on the calling thread afterwards. Worlds stepped this way should have automatic update disabled. Contact update events are not sent while worlds are stepped concurrently.
+    static void UpdateWorlds(ea::span<PhysicsWorld2D* const> worlds, float timeStep);
     /// Add debug geometry to the debug renderer.
     void DrawDebugGeometry();
     /// Enable or disable automatic physics simulation during scene update. Enabled by default.
@@ -138,6 +170,8 @@ public:
     void SetVelocityIterations(int velocityIterations);
     /// Set position iterations.
     void SetPositionIterations(int positionIterations);
+    /// Set whether to send per-pair contact update, begin and end events. When disabled, contacts are only available through the contact stream and the E_PHYSICSCONTACTS2D event. Enabled by default.
+    void SetContactEventsEnabled(bool enable);
     /// Add rigid body.
     void AddRigidBody(RigidBody2D* rigidBody);
     /// Remove rigid body.
@@ -196,6 +230,21 @@ public:
     /// Return position iterations.
     int GetPositionIterations() const { return positionIterations_; }
 
+    /// Return whether per-pair contact events are sent.
+    bool GetContactEventsEnabled() const { return contactEventsEnabled_; }
+
+    /// Return body pairs whose contact began on the last simulation step.
+    const ea::vector<PhysicsContactPair2D>& GetBeginContactPairs() const { return beginContactPairs_; }
+    /// Return body pairs whose contact ended on the last simulation step.
+    const ea::vector<PhysicsContactPair2D>& GetEndContactPairs() const { return endContactPairs_; }
+    /// Return contact points of the last simulation step, grouped by contact pair.
+    const ea::vector<PhysicsContactPoint2D>& GetContactPoints() const { return contactPoints_; }
+    /// Return contact points of a contact pair.
+    ea::span<const PhysicsContactPoint2D> GetContactPoints(const PhysicsContactPair2D& pair) const
+    {
+        return { contactPoints_.data() + pair.firstContact_, pair.numContacts_ };
+    }
+
     /// Return the Box2D physics world.
     b2World* GetWorld() { return world_.get(); }
 
@@ -211,6 +260,16 @@ protected:
 
     /// Handle the scene subsystem update event, step simulation here.
     void HandleSceneSubsystemUpdate(StringHash eventType, VariantMap& eventData);
+    /// Send the pre-step event and prepare for stepping.
+    void PreStep(float timeStep);
+    /// Step the Box2D world. Does not send events, except contact update events on the main thread.
+    void Step(float timeStep);
+    /// Apply transforms and send contact and post-step events.
+    void PostStep(float timeStep);
+    /// Apply world transforms of moved bodies to their nodes.
+    void ApplyWorldTransforms();
+    /// Add a contact to the contact stream.
+    void AddContactPair(ea::vector<PhysicsContactPair2D>& pairs, b2Contact* contact);
     /// Send begin contact events.
     void SendBeginContactEvents();
     /// Send end contact events.
@@ -234,14 +293,28 @@ protected:
 
     /// Automatic simulation update enabled flag.
     bool updateEnabled_{true};
+    /// Per-pair contact events enabled flag.
+    bool contactEventsEnabled_{true};
     /// Whether is currently stepping the world. Used internally.
     bool physicsStepping_{};
+    /// Whether the world is stepped concurrently with other worlds. Used internally.
+    bool steppingConcurrently_{};
     /// Applying transforms.
     bool applyingTransforms_{};
     /// Rigid bodies.
     ea::vector<WeakPtr<RigidBody2D> > rigidBodies_;
     /// Delayed (parented) world transform assignments.
-    ea::unordered_map<RigidBody2D*, DelayedWorldTransform2D> delayedWorldTransforms_;
+    ea::unordered_map<RigidBody2D*, ea::pair<WeakPtr<RigidBody2D>, DelayedWorldTransform2D> > delayedWorldTransforms_;
+    /// Rigid bodies of the pending world transforms. Detects bodies destroyed while the transforms are applied.
+    ea::vector<WeakPtr<RigidBody2D> > pendingRigidBodies_;
+    /// World transforms gathered from the bodies after a step, one per pending rigid body. Null body if no update is needed.
+    ea::vector<DelayedWorldTransform2D> pendingWorldTransforms_;
+    /// Contact stream body pairs whose contact began.
+    ea::vector<PhysicsContactPair2D> beginContactPairs_;
+    /// Contact stream body pairs whose contact ended.
+    ea::vector<PhysicsContactPair2D> endContactPairs_;
+    /// Contact stream points.
+    ea::vector<PhysicsContactPoint2D> contactPoints_;
 
     /// Contact info.
     struct ContactInfo
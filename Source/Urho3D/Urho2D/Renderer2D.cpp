@@ -189,7 +189,9 @@ void Renderer2D::UpdateGeometry(const FrameInfo& frame)
     Camera* camera = frame.camera_;
     ViewBatchInfo2D& viewBatchInfo = viewBatchInfos_[camera];
 
-    if (viewBatchInfo.vertexBufferUpdateFrameNumber_ != frame_.frameNumber_)
+    // Vertices are kept from earlier frames while the visible source batches stay the same
+    if (viewBatchInfo.vertexBufferUpdateFrameNumber_ != frame_.frameNumber_ &&
+        (viewBatchInfo.vertexBufferDirty_ || viewBatchInfo.vertexBuffer_->IsDataLost()))
     {
         unsigned vertexCount = viewBatchInfo.vertexCount_;
         VertexBuffer* vertexBuffer = viewBatchInfo.vertexBuffer_;
@@ -213,9 +215,13 @@ void Renderer2D::UpdateGeometry(const FrameInfo& frame)
                 vertexBuffer->Unlock();
             }
             else
+            {
                 URHO3D_LOGERROR("Failed to lock vertex buffer");
+                return;
+            }
         }
 
+        viewBatchInfo.vertexBufferDirty_ = false;
         viewBatchInfo.vertexBufferUpdateFrameNumber_ = frame_.frameNumber_;
     }
 }
@@ -305,21 +311,6 @@ SharedPtr<Material> Renderer2D::CreateMaterial(Texture2D* texture, BlendMode ble
     return newMaterial;
 }
 
-void CheckDrawableVisibilityWork(const WorkItem* item, unsigned threadIndex)
-{
-    URHO3D_PROFILE("CheckDrawableVisibilityWork");
-    auto* renderer = reinterpret_cast<Renderer2D*>(item->aux_);
-    auto** start = reinterpret_cast<Drawable2D**>(item->start_);
-    auto** end = reinterpret_cast<Drawable2D**>(item->end_);
-
-    while (start != end)
-    {
-        Drawable2D* drawable = *start++;
-        if (renderer->CheckVisibility(drawable))
-            drawable->MarkInView(renderer->frame_);
-    }
-}
-
 void Renderer2D::HandleBeginViewUpdate(StringHash eventType, VariantMap& eventData)
 {
     using namespace BeginViewUpdate;
@@ -341,27 +332,16 @@ void Renderer2D::HandleBeginViewUpdate(StringHash eventType, VariantMap& eventDa
         URHO3D_PROFILE("CheckDrawableVisibility");
 
         auto* queue = GetSubsystem<WorkQueue>();
-        int numWorkItems = queue->GetNumThreads() + 1; // Worker threads + main thread
-        int drawablesPerItem = drawables_.size() / numWorkItems;
-
-        auto start = drawables_.begin();
-        for (int i = 0; i < numWorkItems; ++i)
+        queue->ParallelFor(drawables_.size(), 64, [this](unsigned begin, unsigned end, unsigned)
         {
-            SharedPtr<WorkItem> item = queue->GetFreeItem();
-            item->priority_ = M_MAX_UNSIGNED;
-            item->workFunction_ = CheckDrawableVisibilityWork;
-            item->aux_ = this;
-
-            auto end = drawables_.end();
-            if (i < numWorkItems - 1 && end - start > drawablesPerItem)
-                end = start + drawablesPerItem;
-
-            item->start_ = &(*start);
-            item->end_ = &(*end);
-            queue->AddWorkItem(item);
-
-            start = end;
-        }
+            URHO3D_PROFILE("CheckDrawableVisibilityWork");
+            for (unsigned i = begin; i < end; ++i)
+            {
+                Drawable2D* drawable = drawables_[i];
+                if (CheckVisibility(drawable))
+                    drawable->MarkInView(frame_);
+            }
+        });
 
         queue->Complete(M_MAX_UNSIGNED);
     }
@@ -425,32 +405,51 @@ void Renderer2D::UpdateViewBatchInfo(ViewBatchInfo2D& viewBatchInfo, Camera* cam
     if (viewBatchInfo.batchUpdatedFrameNumber_ == frame_.frameNumber_)
         return;
 
-    ea::vector<const SourceBatch2D*>& sourceBatches = viewBatchInfo.sourceBatches_;
-    sourceBatches.clear();
+    ea::vector<const SourceBatch2D*>& visibleSourceBatches = viewBatchInfo.visibleSourceBatches_;
+    ea::vector<SourceBatchState2D>& batchStates = viewBatchInfo.batchStates_;
+    visibleSourceBatches.clear();
+    batchStates.clear();
     for (unsigned d = 0; d < drawables_.size(); ++d)
     {
         if (!drawables_[d]->IsInView(camera))
             continue;
 
         const ea::vector<SourceBatch2D>& batches = drawables_[d]->GetSourceBatches();
+        const unsigned revision = drawables_[d]->GetSourceBatchesRevision();
         for (unsigned b = 0; b < batches.size(); ++b)
         {
             if (batches[b].material_ && !batches[b].vertices_.empty())
-                sourceBatches.push_back(&batches[b]);
+            {
+                visibleSourceBatches.push_back(&batches[b]);
+                batchStates.push_back({ &batches[b], batches[b].material_, batches[b].drawOrder_, batches[b].vertices_.size(), revision });
+            }
         }
     }
 
-    for (unsigned i = 0; i < sourceBatches.size(); ++i)
+    for (unsigned i = 0; i < visibleSourceBatches.size(); ++i)
+    {
+        const SourceBatch2D* sourceBatch = visibleSourceBatches[i];
+        Vector3 worldPos = sourceBatch->owner_->GetNode()->GetWorldPosition();
+        sourceBatch->distance_ = camera->GetDistance(worldPos);
+    }
+
+    // When the same batches are visible with unchanged contents, keep the previous order unless distances reordered it
+    ea::vector<const SourceBatch2D*>& sourceBatches = viewBatchInfo.sourceBatches_;
+    if (batchStates == viewBatchInfo.prevBatchStates_)
     {
-        const SourceBatch2D* sourceBatch = sourceBatches[i];
-        // if (sourceBatch->owner_)
+        if (!ea::is_sorted(sourceBatches.begin(), sourceBatches.end(), CompareSourceBatch2Ds))
         {
-            Vector3 worldPos = sourceBatch->owner_->GetNode()->GetWorldPosition();
-            sourceBatch->distance_ = camera->GetDistance(worldPos);
+            ea::quick_sort(sourceBatches.begin(), sourceBatches.end(), CompareSourceBatch2Ds);
+            viewBatchInfo.vertexBufferDirty_ = true;
         }
     }
-
-    ea::quick_sort(sourceBatches.begin(), sourceBatches.end(), CompareSourceBatch2Ds);
+    else
+    {
+        sourceBatches = visibleSourceBatches;
+        ea::quick_sort(sourceBatches.begin(), sourceBatches.end(), CompareSourceBatch2Ds);
+        ea::swap(viewBatchInfo.prevBatchStates_, batchStates);
+        viewBatchInfo.vertexBufferDirty_ = true;
+    }
 
     viewBatchInfo.batchCount_ = 0;
     Material* currMaterial = nullptr;
@@ -37,6 +37,28 @@ class VertexBuffer;
 struct FrameInfo;
 struct SourceBatch2D;
 
+/// Source batch state that view batches were built from, used to detect changes between frames.
+struct SourceBatchState2D
+{
+    /// Source batch.
+    const SourceBatch2D* batch_;
+    /// Material.
+    Material* material_;
+    /// Draw order.
+    int drawOrder_;
+    /// Number of vertices.
+    unsigned numVertices_;
+    /// Source batches revision of the owner.
+    unsigned revision_;
+
+    /// Equality comparison operator.
+    bool operator==(const SourceBatchState2D& other) const
+    {
+        return batch_ == other.batch_ && material_ == other.material_ && drawOrder_ == other.drawOrder_ &&
+            numVertices_ == other.numVertices_ && revision_ == other.revision_;
+    }
+};
+
 /// 2D view batch info.
 struct ViewBatchInfo2D
 {
@@ -51,10 +73,18 @@ struct ViewBatchInfo2D
     unsigned vertexCount_;
     /// Vertex buffer.
     SharedPtr<VertexBuffer> vertexBuffer_;
+    /// Whether the vertex buffer contents are out of date.
+    bool vertexBufferDirty_{true};
     /// Batch updated frame number.
     unsigned batchUpdatedFrameNumber_;
-    /// Source batches.
+    /// Source batches sorted for rendering.
     ea::vector<const SourceBatch2D*> sourceBatches_;
+    /// Visible source batches of the current frame in drawable order.
+    ea::vector<const SourceBatch2D*> visibleSourceBatches_;
+    /// States of the visible source batches of the current frame.
+    ea::vector<SourceBatchState2D> batchStates_;
+    /// States of the visible source batches the sorted source batches were built from.
+    ea::vector<SourceBatchState2D> prevBatchStates_;
     /// Batch count.
     unsigned batchCount_;
     /// Distances.
@@ -70,8 +100,6 @@ class URHO3D_API Renderer2D : public Drawable
 {
     URHO3D_OBJECT(Renderer2D, Drawable);
 
-    friend void CheckDrawableVisibilityWork(const WorkItem* item, unsigned threadIndex);
-
 public:
     /// Construct.
     explicit Renderer2D(Context* context);
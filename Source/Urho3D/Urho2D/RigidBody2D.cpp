@@ -420,11 +420,25 @@ void RigidBody2D::ReleaseBody()
 
 void RigidBody2D::ApplyWorldTransform()
 {
-    if (!body_ || !node_)
+    DelayedWorldTransform2D transform;
+    if (!GetWorldTransformFromBody(transform))
         return;
 
+    transform.worldPosition_.z_ = node_->GetWorldPosition().z_;
+
     // If the rigid body is parented to another rigid body, can not set the transform immediately.
     // In that case store it to PhysicsWorld2D for delayed assignment
+    if (transform.parentRigidBody_)
+        physicsWorld_->AddDelayedWorldTransform(transform);
+    else
+        ApplyWorldTransform(transform.worldPosition_, transform.worldRotation_);
+}
+
+bool RigidBody2D::GetWorldTransformFromBody(DelayedWorldTransform2D& transform)
+{
+    if (!body_ || !node_)
+        return false;
+
     RigidBody2D* parentRigidBody = nullptr;
     Node* parent = node_->GetParent();
     if (parent != GetScene() && parent)
@@ -432,25 +446,14 @@ void RigidBody2D::ApplyWorldTransform()
 
     // If body is not parented and is static or sleeping, no need to update
     if (!parentRigidBody && (!body_->IsActive() || body_->GetType() == b2_staticBody || !body_->IsAwake()))
-        return;
-
-    const b2Transform& transform = body_->GetTransform();
-    Vector3 newWorldPosition = node_->GetWorldPosition();
-    newWorldPosition.x_ = transform.p.x;
-    newWorldPosition.y_ = transform.p.y;
-    Quaternion newWorldRotation(transform.q.GetAngle() * M_RADTODEG, Vector3::FORWARD);
-
-    if (parentRigidBody)
-    {
-        DelayedWorldTransform2D delayed;
-        delayed.rigidBody_ = this;
-        delayed.parentRigidBody_ = parentRigidBody;
-        delayed.worldPosition_ = newWorldPosition;
-        delayed.worldRotation_ = newWorldRotation;
-        physicsWorld_->AddDelayedWorldTransform(delayed);
-    }
-    else
-        ApplyWorldTransform(newWorldPosition, newWorldRotation);
+        return false;
+
+    const b2Transform& bodyTransform = body_->GetTransform();
+    transform.rigidBody_ = this;
+    transform.parentRigidBody_ = parentRigidBody;
+    transform.worldPosition_ = Vector3(bodyTransform.p.x, bodyTransform.p.y, 0.0f);
+    transform.worldRotation_ = Quaternion(bodyTransform.q.GetAngle() * M_RADTODEG, Vector3::FORWARD);
+    return true;
 }
 
 void RigidBody2D::ApplyWorldTransform(const Vector3& newWorldPosition, const Quaternion& newWorldRotation)
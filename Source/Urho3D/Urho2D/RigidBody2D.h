@@ -34,6 +34,7 @@ namespace Urho3D
 class CollisionShape2D;
 class Constraint2D;
 class PhysicsWorld2D;
+struct DelayedWorldTransform2D;
 
 /// Rigid body type.
 enum BodyType2D
@@ -111,6 +112,8 @@ public:
 
     /// Apply world transform from the Box2D body. Called by PhysicsWorld2D.
     void ApplyWorldTransform();
+    /// Return the world transform to apply from the Box2D body, with the Z coordinate left zero. Return false if the node needs no update. Does not modify the node, so may be called for several bodies in parallel. Called by PhysicsWorld2D.
+    bool GetWorldTransformFromBody(DelayedWorldTransform2D& transform);
     /// Apply specified world position & rotation. Called by PhysicsWorld2D.
     void ApplyWorldTransform(const Vector3& newWorldPosition, const Quaternion& newWorldRotation);
     /// Add collision shape.
@@ -53,6 +53,7 @@ void TileMap2D::RegisterObject(Context* context)
     URHO3D_ACCESSOR_ATTRIBUTE("Is Enabled", IsEnabled, SetEnabled, bool, true, AM_DEFAULT);
     URHO3D_MIXED_ACCESSOR_ATTRIBUTE("Tmx File", GetTmxFileAttr, SetTmxFileAttr, ResourceRef, ResourceRef(TmxFile2D::GetTypeStatic()),
         AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Tile Chunk Size", GetTileChunkSize, SetTileChunkSize, int, DEFAULT_TILE_CHUNK_SIZE, AM_DEFAULT);
 }
 
 // Transform vector from node-local space to global space
@@ -118,12 +119,27 @@ void TileMap2D::SetTmxFile(TmxFile2D* tmxFile)
     if (tmxFile == tmxFile_)
         return;
 
+    tmxFile_ = tmxFile;
+    CreateLayers();
+}
+
+void TileMap2D::SetTileChunkSize(int size)
+{
+    size = Max(size, 0);
+    if (size == tileChunkSize_)
+        return;
+
+    tileChunkSize_ = size;
+    CreateLayers();
+}
+
+void TileMap2D::CreateLayers()
+{
     if (rootNode_)
         rootNode_->RemoveAllChildren();
 
     layers_.clear();
 
-    tmxFile_ = tmxFile;
     if (!tmxFile_)
         return;
 
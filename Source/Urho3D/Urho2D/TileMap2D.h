@@ -31,6 +31,9 @@ namespace Urho3D
 class TileMapLayer2D;
 class TmxFile2D;
 
+/// Default number of tiles per side of a tile layer chunk.
+static const int DEFAULT_TILE_CHUNK_SIZE = 32;
+
 /// Tile map component.
 class URHO3D_API TileMap2D : public Component
 {
@@ -49,11 +52,15 @@ public:
 
     /// Set tmx file.
     void SetTmxFile(TmxFile2D* tmxFile);
+    /// Set number of tiles per side of the chunks tile layers are drawn with. Zero creates a node with a sprite for every tile instead. Non-orthogonal layers are drawn in row strips with the same number of tiles, as their tiles overlap in draw order.
+    void SetTileChunkSize(int size);
     /// Add debug geometry to the debug renderer.
     void DrawDebugGeometry();
 
     /// Return tmx file.
     TmxFile2D* GetTmxFile() const;
+    /// Return number of tiles per side of tile layer chunks.
+    int GetTileChunkSize() const { return tileChunkSize_; }
 
     /// Return information.
     const TileMapInfo2D& GetInfo() const { return info_; }
@@ -75,6 +82,9 @@ public:
     ///
     ea::vector<SharedPtr<TileMapObject2D> > GetTileCollisionShapes(unsigned gid) const;
 private:
+    /// Create layers from the tmx file.
+    void CreateLayers();
+
     /// Tmx file.
     SharedPtr<TmxFile2D> tmxFile_;
     /// Tile map information.
@@ -83,6 +93,8 @@ private:
     SharedPtr<Node> rootNode_;
     /// Tile map layers.
     ea::vector<WeakPtr<TileMapLayer2D> > layers_;
+    /// Number of tiles per side of tile layer chunks.
+    int tileChunkSize_{DEFAULT_TILE_CHUNK_SIZE};
 };
 
 }
@@ -0,0 +1,167 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Graphics/Material.h"
+#include "../Graphics/Texture2D.h"
+#include "../Scene/Node.h"
+#include "../Urho2D/Renderer2D.h"
+#include "../Urho2D/Sprite2D.h"
+#include "../Urho2D/TileMapChunk2D.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+TileMapChunk2D::TileMapChunk2D(Context* context) :
+    Drawable2D(context)
+{
+}
+
+TileMapChunk2D::~TileMapChunk2D() = default;
+
+void TileMapChunk2D::RegisterObject(Context* context)
+{
+    context->RegisterFactory<TileMapChunk2D>();
+}
+
+void TileMapChunk2D::SetTiles(ea::vector<TileMapChunkTile2D> tiles)
+{
+    tiles_ = ea::move(tiles);
+
+    sourceBatchesDirty_ = true;
+    MarkWorldBoundingBoxDirty();
+}
+
+void TileMapChunk2D::SetTileSprite(unsigned index, Sprite2D* sprite)
+{
+    if (index >= tiles_.size() || tiles_[index].sprite_ == sprite)
+        return;
+
+    tiles_[index].sprite_ = sprite;
+
+    sourceBatchesDirty_ = true;
+    MarkWorldBoundingBoxDirty();
+}
+
+void TileMapChunk2D::OnSceneSet(Scene* scene)
+{
+    Drawable2D::OnSceneSet(scene);
+
+    // Materials are owned by the renderer
+    sourceBatchesDirty_ = true;
+}
+
+void TileMapChunk2D::OnWorldBoundingBoxUpdate()
+{
+    boundingBox_.Clear();
+    worldBoundingBox_.Clear();
+
+    const ea::vector<SourceBatch2D>& sourceBatches = GetSourceBatches();
+    for (const SourceBatch2D& sourceBatch : sourceBatches)
+    {
+        for (const Vertex2D& vertex : sourceBatch.vertices_)
+            worldBoundingBox_.Merge(vertex.position_);
+    }
+
+    if (worldBoundingBox_.Defined())
+        boundingBox_ = worldBoundingBox_.Transformed(node_->GetWorldTransform().Inverse());
+}
+
+void TileMapChunk2D::OnDrawOrderChanged()
+{
+    const int drawOrder = GetDrawOrder();
+    for (unsigned i = 0; i < sourceBatches_.size(); ++i)
+        sourceBatches_[i].drawOrder_ = drawOrder + i;
+}
+
+void TileMapChunk2D::UpdateSourceBatches()
+{
+    if (!sourceBatchesDirty_)
+        return;
+
+    sourceBatches_.clear();
+    if (!renderer_ || !node_)
+        return;
+
+    const Matrix3x4& worldTransform = node_->GetWorldTransform();
+    const unsigned color = Color::WHITE.ToUInt();
+    const int drawOrder = GetDrawOrder();
+
+    for (const TileMapChunkTile2D& tile : tiles_)
+    {
+        Sprite2D* sprite = tile.sprite_;
+        if (!sprite || !sprite->GetTexture())
+            continue;
+
+        Rect drawRect;
+        Rect textureRect;
+        if (!sprite->GetDrawRectangle(drawRect, tile.flipX_, tile.flipY_) ||
+            !sprite->GetTextureRectangle(textureRect, tile.flipX_, tile.flipY_))
+            continue;
+
+        // Merging only adjacent tiles of the same material keeps the tile draw order. The renderer sorts batches of
+        // the same draw order by material, so every batch takes a draw order of its own
+        Material* material = renderer_->GetMaterial(sprite->GetTexture(), BLEND_ALPHA);
+        if (sourceBatches_.empty() || sourceBatches_.back().material_ != material)
+        {
+            SourceBatch2D& batch = sourceBatches_.push_back();
+            batch.owner_ = this;
+            batch.drawOrder_ = drawOrder + sourceBatches_.size() - 1;
+            batch.material_ = material;
+        }
+        SourceBatch2D* sourceBatch = &sourceBatches_.back();
+
+        // Same quad layout as StaticSprite2D
+        Vertex2D vertex0;
+        Vertex2D vertex1;
+        Vertex2D vertex2;
+        Vertex2D vertex3;
+
+        const Vector2 position = tile.position_;
+        vertex0.position_ = worldTransform * Vector3(position.x_ + drawRect.min_.x_, position.y_ + drawRect.min_.y_, 0.0f);
+        vertex1.position_ = worldTransform * Vector3(position.x_ + drawRect.min_.x_, position.y_ + drawRect.max_.y_, 0.0f);
+        vertex2.position_ = worldTransform * Vector3(position.x_ + drawRect.max_.x_, position.y_ + drawRect.max_.y_, 0.0f);
+        vertex3.position_ = worldTransform * Vector3(position.x_ + drawRect.max_.x_, position.y_ + drawRect.min_.y_, 0.0f);
+
+        vertex0.uv_ = textureRect.min_;
+        (tile.swapXY_ ? vertex3.uv_ : vertex1.uv_) = Vector2(textureRect.min_.x_, textureRect.max_.y_);
+        vertex2.uv_ = textureRect.max_;
+        (tile.swapXY_ ? vertex1.uv_ : vertex3.uv_) = Vector2(textureRect.max_.x_, textureRect.min_.y_);
+
+        vertex0.color_ = vertex1.color_ = vertex2.color_ = vertex3.color_ = color;
+
+        ea::vector<Vertex2D>& vertices = sourceBatch->vertices_;
+        vertices.push_back(vertex0);
+        vertices.push_back(vertex1);
+        vertices.push_back(vertex2);
+        vertices.push_back(vertex3);
+    }
+
+    sourceBatchesDirty_ = false;
+}
+
+}
@@ -0,0 +1,86 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Urho2D/Drawable2D.h"
+
+namespace Urho3D
+{
+
+class Sprite2D;
+
+/// Tile of a tile map chunk.
+struct TileMapChunkTile2D
+{
+    /// Sprite, null for an empty tile.
+    SharedPtr<Sprite2D> sprite_;
+    /// Position relative to the chunk node.
+    Vector2 position_;
+    /// Flip X.
+    bool flipX_{};
+    /// Flip Y.
+    bool flipY_{};
+    /// Swap X and Y.
+    bool swapXY_{};
+};
+
+/// Block of tiles of a tile layer drawn in tile order, with a new batch whenever the texture changes. Batches take consecutive draw orders starting from the draw order of the chunk. Vertices are built once and culled per chunk.
+class URHO3D_API TileMapChunk2D : public Drawable2D
+{
+    URHO3D_OBJECT(TileMapChunk2D, Drawable2D);
+
+public:
+    /// Construct.
+    explicit TileMapChunk2D(Context* context);
+    /// Destruct.
+    ~TileMapChunk2D() override;
+    /// Register object factory.
+    static void RegisterObject(Context* context);
+
+    /// Set tiles.
+    void SetTiles(ea::vector<TileMapChunkTile2D> tiles);
+    /// Set sprite of tile at index, null to clear the tile.
+    void SetTileSprite(unsigned index, Sprite2D* sprite);
+
+    /// Return number of tiles.
+    unsigned GetNumTiles() const { return tiles_.size(); }
+    /// Return tile at index.
+    const TileMapChunkTile2D* GetTile(unsigned index) const { return index < tiles_.size() ? &tiles_[index] : nullptr; }
+
+protected:
+    /// Handle scene being assigned.
+    void OnSceneSet(Scene* scene) override;
+    /// Recalculate the world-space bounding box.
+    void OnWorldBoundingBoxUpdate() override;
+    /// Handle draw order changed.
+    void OnDrawOrderChanged() override;
+    /// Update source batches.
+    void UpdateSourceBatches() override;
+
+private:
+    /// Tiles.
+    ea::vector<TileMapChunkTile2D> tiles_;
+};
+
+}
@@ -28,6 +28,7 @@
 #include "../Scene/Node.h"
 #include "../Urho2D/StaticSprite2D.h"
 #include "../Urho2D/TileMap2D.h"
+#include "../Urho2D/TileMapChunk2D.h"
 #include "../Urho2D/TileMapLayer2D.h"
 #include "../Urho2D/TmxFile2D.h"
 
@@ -186,6 +187,10 @@ void TileMapLayer2D::Initialize(TileMap2D* tileMap, const TmxLayer2D* tmxLayer)
     tileLayer_ = nullptr;
     objectGroup_ = nullptr;
     imageLayer_ = nullptr;
+    chunkSize_ = 0;
+    chunkWidth_ = 0;
+    chunkHeight_ = 0;
+    numChunksX_ = 0;
 
     tileMap_ = tileMap;
     tmxLayer_ = tmxLayer;
@@ -226,9 +231,9 @@ void TileMapLayer2D::SetDrawOrder(int drawOrder)
         if (!nodes_[i])
             continue;
 
-        auto* staticSprite = nodes_[i]->GetComponent<StaticSprite2D>();
-        if (staticSprite)
-            staticSprite->SetLayer(drawOrder_);
+        auto* drawable = nodes_[i]->GetDerivedComponent<Drawable2D>();
+        if (drawable)
+            drawable->SetLayer(drawOrder_);
     }
 }
 
@@ -291,7 +296,7 @@ Tile2D* TileMapLayer2D::GetTile(int x, int y) const
 
 Node* TileMapLayer2D::GetTileNode(int x, int y) const
 {
-    if (!tileLayer_)
+    if (!tileLayer_ || chunkSize_)
         return nullptr;
 
     if (x < 0 || x >= tileLayer_->GetWidth() || y < 0 || y >= tileLayer_->GetHeight())
@@ -300,6 +305,42 @@ Node* TileMapLayer2D::GetTileNode(int x, int y) const
     return nodes_[y * tileLayer_->GetWidth() + x];
 }
 
+void TileMapLayer2D::SetTileSprite(int x, int y, Sprite2D* sprite)
+{
+    if (!tileLayer_ || x < 0 || x >= tileLayer_->GetWidth() || y < 0 || y >= tileLayer_->GetHeight())
+        return;
+
+    if (chunkSize_)
+    {
+        unsigned index;
+        if (TileMapChunk2D* chunk = GetTileChunk(x, y, index))
+            chunk->SetTileSprite(index, sprite);
+        return;
+    }
+
+    Node* tileNode = nodes_[y * tileLayer_->GetWidth() + x];
+    if (tileNode)
+        tileNode->GetComponent<StaticSprite2D>()->SetSprite(sprite);
+    else if (sprite)
+        CreateTileNode(x, y, sprite, false, false, false);
+}
+
+Sprite2D* TileMapLayer2D::GetTileSprite(int x, int y) const
+{
+    if (!tileLayer_ || x < 0 || x >= tileLayer_->GetWidth() || y < 0 || y >= tileLayer_->GetHeight())
+        return nullptr;
+
+    if (chunkSize_)
+    {
+        unsigned index;
+        TileMapChunk2D* chunk = GetTileChunk(x, y, index);
+        return chunk ? chunk->GetTile(index)->sprite_.Get() : nullptr;
+    }
+
+    Node* tileNode = nodes_[y * tileLayer_->GetWidth() + x];
+    return tileNode ? tileNode->GetComponent<StaticSprite2D>()->GetSprite() : nullptr;
+}
+
 unsigned TileMapLayer2D::GetNumObjects() const
 {
     if (!objectGroup_)
@@ -339,33 +380,127 @@ void TileMapLayer2D::SetTileLayer(const TmxTileLayer2D* tileLayer)
 {
     tileLayer_ = tileLayer;
 
+    chunkSize_ = tileMap_->GetTileChunkSize();
+    if (chunkSize_)
+    {
+        CreateTileChunks();
+        return;
+    }
+
     int width = tileLayer->GetWidth();
     int height = tileLayer->GetHeight();
     nodes_.resize((unsigned) (width * height));
 
-    const TileMapInfo2D& info = tileMap_->GetInfo();
     for (int y = 0; y < height; ++y)
     {
         for (int x = 0; x < width; ++x)
         {
             const Tile2D* tile = tileLayer->GetTile(x, y);
-            if (!tile)
-                continue;
+            if (tile)
+                CreateTileNode(x, y, tile->GetSprite(), tile->GetFlipX(), tile->GetFlipY(), tile->GetSwapXY());
+        }
+    }
+}
 
-            SharedPtr<Node> tileNode(GetNode()->CreateTemporaryChild("Tile"));
-            tileNode->SetPosition(Vector3(info.TileIndexToPosition(x, y)));
+void TileMapLayer2D::CreateTileChunks()
+{
+    const int width = tileLayer_->GetWidth();
+    const int height = tileLayer_->GetHeight();
+    const TileMapInfo2D& info = tileMap_->GetInfo();
 
-            auto* staticSprite = tileNode->CreateComponent<StaticSprite2D>();
-            staticSprite->SetSprite(tile->GetSprite());
-            staticSprite->SetFlip(tile->GetFlipX(), tile->GetFlipY(), tile->GetSwapXY());
-            staticSprite->SetLayer(drawOrder_);
-            staticSprite->SetOrderInLayer(y * width + x);
+    // Tiles of non-orthogonal layers overlap, so a chunk must be drawn between the previous and the next tile in row
+    // order, which only holds for chunks that are a part of a single row
+    if (info.orientation_ == O_ORTHOGONAL)
+    {
+        chunkWidth_ = chunkSize_;
+        chunkHeight_ = chunkSize_;
+    }
+    else
+    {
+        chunkWidth_ = Min(chunkSize_ * chunkSize_, width);
+        chunkHeight_ = 1;
+    }
+
+    numChunksX_ = (width + chunkWidth_ - 1) / chunkWidth_;
+    const int numChunksY = (height + chunkHeight_ - 1) / chunkHeight_;
+    nodes_.resize((unsigned) (numChunksX_ * numChunksY));
+
+    for (int chunkY = 0; chunkY < numChunksY; ++chunkY)
+    {
+        for (int chunkX = 0; chunkX < numChunksX_; ++chunkX)
+        {
+            const int beginX = chunkX * chunkWidth_;
+            const int beginY = chunkY * chunkHeight_;
+            const int endX = Min(beginX + chunkWidth_, width);
+            const int endY = Min(beginY + chunkHeight_, height);
+            const Vector2 origin = info.TileIndexToPosition(beginX, beginY);
+
+            // Empty tiles are kept so that SetTileSprite can fill them later
+            ea::vector<TileMapChunkTile2D> tiles((unsigned) ((endX - beginX) * (endY - beginY)));
+            for (int y = beginY; y < endY; ++y)
+            {
+                for (int x = beginX; x < endX; ++x)
+                {
+                    TileMapChunkTile2D& chunkTile = tiles[(y - beginY) * (endX - beginX) + (x - beginX)];
+                    chunkTile.position_ = info.TileIndexToPosition(x, y) - origin;
+
+                    if (const Tile2D* tile = tileLayer_->GetTile(x, y))
+                    {
+                        chunkTile.sprite_ = tile->GetSprite();
+                        chunkTile.flipX_ = tile->GetFlipX();
+                        chunkTile.flipY_ = tile->GetFlipY();
+                        chunkTile.swapXY_ = tile->GetSwapXY();
+                    }
+                }
+            }
 
-            nodes_[y * width + x] = tileNode;
+            SharedPtr<Node> chunkNode(GetNode()->CreateTemporaryChild("TileChunk"));
+            chunkNode->SetPosition(Vector3(origin));
+
+            auto* chunk = chunkNode->CreateComponent<TileMapChunk2D>();
+            chunk->SetTiles(ea::move(tiles));
+            chunk->SetLayer(drawOrder_);
+            // Batches of a chunk take consecutive draw orders, at most one per tile
+            chunk->SetOrderInLayer((chunkY * numChunksX_ + chunkX) * chunkWidth_ * chunkHeight_);
+
+            nodes_[chunkY * numChunksX_ + chunkX] = chunkNode;
         }
     }
 }
 
+Node* TileMapLayer2D::CreateTileNode(int x, int y, Sprite2D* sprite, bool flipX, bool flipY, bool swapXY)
+{
+    const int width = tileLayer_->GetWidth();
+    const TileMapInfo2D& info = tileMap_->GetInfo();
+
+    SharedPtr<Node> tileNode(GetNode()->CreateTemporaryChild("Tile"));
+    tileNode->SetPosition(Vector3(info.TileIndexToPosition(x, y)));
+    tileNode->SetEnabled(visible_);
+
+    auto* staticSprite = tileNode->CreateComponent<StaticSprite2D>();
+    staticSprite->SetSprite(sprite);
+    staticSprite->SetFlip(flipX, flipY, swapXY);
+    staticSprite->SetLayer(drawOrder_);
+    staticSprite->SetOrderInLayer(y * width + x);
+
+    nodes_[y * width + x] = tileNode;
+    return tileNode;
+}
+
+TileMapChunk2D* TileMapLayer2D::GetTileChunk(int x, int y, unsigned& index) const
+{
+    const int chunkX = x / chunkWidth_;
+    const int chunkY = y / chunkHeight_;
+    Node* chunkNode = nodes_[chunkY * numChunksX_ + chunkX];
+    if (!chunkNode)
+        return nullptr;
+
+    const int beginX = chunkX * chunkWidth_;
+    const int chunkWidth = Min(beginX + chunkWidth_, tileLayer_->GetWidth()) - beginX;
+    index = (unsigned) ((y - chunkY * chunkHeight_) * chunkWidth + (x - beginX));
+    return chunkNode->GetComponent<TileMapChunk2D>();
+}
+
 void TileMapLayer2D::SetObjectGroup(const TmxObjectGroup2D* objectGroup)
 {
     objectGroup_ = objectGroup;
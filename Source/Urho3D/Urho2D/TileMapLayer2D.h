@@ -34,7 +34,9 @@ namespace Urho3D
 
 class DebugRenderer;
 class Node;
+class Sprite2D;
 class TileMap2D;
+class TileMapChunk2D;
 class TmxImageLayer2D;
 class TmxLayer2D;
 class TmxObjectGroup2D;
@@ -86,10 +88,16 @@ public:
     int GetWidth() const;
     /// Return height (for tile layer only).
     int GetHeight() const;
-    /// Return tile node (for tile layer only).
+    /// Return tile node (for tile layer only). Null when the layer is drawn in chunks.
     Node* GetTileNode(int x, int y) const;
     /// Return tile (for tile layer only).
     Tile2D* GetTile(int x, int y) const;
+    /// Set sprite drawn for tile, null to clear it (for tile layer only).
+    void SetTileSprite(int x, int y, Sprite2D* sprite);
+    /// Return sprite drawn for tile (for tile layer only).
+    Sprite2D* GetTileSprite(int x, int y) const;
+    /// Return number of tiles per side of the chunks the layer is drawn with, zero when every tile has a node (for tile layer only).
+    int GetChunkSize() const { return chunkSize_; }
 
     /// Return number of tile map objects (for object group only).
     unsigned GetNumObjects() const;
@@ -104,6 +112,12 @@ public:
 private:
     /// Set tile layer.
     void SetTileLayer(const TmxTileLayer2D* tileLayer);
+    /// Create chunks drawing the tile layer.
+    void CreateTileChunks();
+    /// Create node with a sprite for tile.
+    Node* CreateTileNode(int x, int y, Sprite2D* sprite, bool flipX, bool flipY, bool swapXY);
+    /// Return chunk containing tile and the tile index in the chunk.
+    TileMapChunk2D* GetTileChunk(int x, int y, unsigned& index) const;
     /// Set object group.
     void SetObjectGroup(const TmxObjectGroup2D* objectGroup);
     /// Set image layer.
@@ -123,7 +137,15 @@ private:
     int drawOrder_{};
     /// Visible.
     bool visible_{true};
-    /// Tile node or image nodes.
+    /// Number of tiles per side of tile layer chunks, zero when not drawn in chunks.
+    int chunkSize_{};
+    /// Number of tiles along X of tile layer chunks.
+    int chunkWidth_{};
+    /// Number of tiles along Y of tile layer chunks.
+    int chunkHeight_{};
+    /// Number of tile layer chunks along X.
+    int numChunksX_{};
+    /// Tile nodes, chunk nodes, object nodes or image node.
     ea::vector<SharedPtr<Node> > nodes_;
 };
 
@@ -5,6 +5,10 @@
 
 varying vec2 vScreenPos;
 
+#if defined(COMPILEPS) && defined(SHARPEN)
+uniform float cSharpness;
+#endif
+
 void VS()
 {
     mat4 modelMatrix = iModelMatrix;
@@ -15,6 +19,19 @@ void VS()
 
 void PS()
 {
+#ifdef SHARPEN
+    // Sharpen against the neighbor texels of the source, clamped to their range to avoid halos
+    vec4 center = texture2D(sDiffMap, vScreenPos);
+    vec3 left = texture2D(sDiffMap, vScreenPos - vec2(cGBufferInvSize.x, 0.0)).rgb;
+    vec3 right = texture2D(sDiffMap, vScreenPos + vec2(cGBufferInvSize.x, 0.0)).rgb;
+    vec3 up = texture2D(sDiffMap, vScreenPos - vec2(0.0, cGBufferInvSize.y)).rgb;
+    vec3 down = texture2D(sDiffMap, vScreenPos + vec2(0.0, cGBufferInvSize.y)).rgb;
+    vec3 minColor = min(center.rgb, min(min(left, right), min(up, down)));
+    vec3 maxColor = max(center.rgb, max(max(left, right), max(up, down)));
+    vec3 sharpened = center.rgb + (center.rgb - (left + right + up + down) * 0.25) * cSharpness;
+    gl_FragColor = vec4(clamp(sharpened, minColor, maxColor), center.a);
+#else
     gl_FragColor = texture2D(sDiffMap, vScreenPos);
+#endif
 }
 
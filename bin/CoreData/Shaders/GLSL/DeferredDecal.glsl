@@ -0,0 +1,75 @@
+#include "Uniforms.glsl"
+#include "Samplers.glsl"
+#include "Transform.glsl"
+#include "ScreenPos.glsl"
+
+// Projected decal box. Reconstructs the scene position from the depth buffer, clips it against the unit box
+// of the decal and projects the diffuse texture along the local Z axis
+
+varying vec4 vScreenPos;
+varying vec3 vFarRay;
+varying vec4 vDecalRow0;
+varying vec4 vDecalRow1;
+varying vec4 vDecalRow2;
+varying vec4 vUOffset;
+varying vec4 vVOffset;
+
+void VS()
+{
+    mat4 modelMatrix = iModelMatrix;
+    vec3 worldPos = GetWorldPos(modelMatrix);
+    gl_Position = GetClipPos(worldPos);
+    vScreenPos = GetScreenPos(gl_Position);
+    vFarRay = GetFarRay(gl_Position) * gl_Position.w;
+
+    // Invert the affine decal transform, each row holds the linear part and translation of one axis
+    vec3 row0 = modelMatrix[0].xyz;
+    vec3 row1 = modelMatrix[1].xyz;
+    vec3 row2 = modelMatrix[2].xyz;
+    vec3 translation = vec3(modelMatrix[0].w, modelMatrix[1].w, modelMatrix[2].w);
+    vec3 col0 = cross(row1, row2);
+    vec3 col1 = cross(row2, row0);
+    vec3 col2 = cross(row0, row1);
+    float invDet = 1.0 / dot(row0, col0);
+    vec3 invRow0 = vec3(col0.x, col1.x, col2.x) * invDet;
+    vec3 invRow1 = vec3(col0.y, col1.y, col2.y) * invDet;
+    vec3 invRow2 = vec3(col0.z, col1.z, col2.z) * invDet;
+    vDecalRow0 = vec4(invRow0, -dot(invRow0, translation));
+    vDecalRow1 = vec4(invRow1, -dot(invRow1, translation));
+    vDecalRow2 = vec4(invRow2, -dot(invRow2, translation));
+
+    // Material UV transform selects the decal atlas cell
+    vUOffset = cUOffset;
+    vVOffset = cVOffset;
+}
+
+void PS()
+{
+    #ifdef HWDEPTH
+        float depth = ReconstructDepth(texture2DProj(sDepthBuffer, vScreenPos).r);
+    #else
+        float depth = DecodeDepth(texture2DProj(sDepthBuffer, vScreenPos).rgb);
+    #endif
+
+    // Position acquired via far ray is relative to camera. Bring position to world space, then to decal space
+    vec3 worldPos = vFarRay * depth / vScreenPos.w + cCameraPosPS;
+    vec3 localPos = vec3(
+        dot(vDecalRow0.xyz, worldPos) + vDecalRow0.w,
+        dot(vDecalRow1.xyz, worldPos) + vDecalRow1.w,
+        dot(vDecalRow2.xyz, worldPos) + vDecalRow2.w);
+
+    if (any(greaterThan(abs(localPos), vec3(0.5))))
+        discard;
+
+    vec2 texCoord = vec2(localPos.x + 0.5, 0.5 - localPos.y);
+    texCoord = vec2(dot(texCoord, vUOffset.xy) + vUOffset.w, dot(texCoord, vVOffset.xy) + vVOffset.w);
+
+    vec4 diffColor = cMatDiffColor;
+    #ifdef DIFFMAP
+        diffColor *= texture2D(sDiffMap, texCoord);
+    #endif
+
+    // Fade out towards the ends of the projection depth to hide the cut
+    diffColor.a *= 1.0 - smoothstep(0.4, 0.5, abs(localPos.z));
+    gl_FragColor = diffColor;
+}
@@ -0,0 +1,114 @@
+#include "Uniforms.glsl"
+#include "Samplers.glsl"
+#include "Transform.glsl"
+#include "ScreenPos.glsl"
+
+// Vertex shader of GPU simulated particles, to be paired with the UnlitParticle pixel shader.
+// Each particle is evaluated from its spawn phase and random seed as a closed-form function of time
+
+varying vec2 vTexCoord;
+varying vec4 vWorldPos;
+varying vec4 vColor;
+#ifdef SOFTPARTICLES
+    varying vec4 vScreenPos;
+#endif
+
+#ifdef COMPILEVS
+uniform float cParticleTime;
+uniform vec2 cParticleEmitWindow;
+uniform vec2 cParticleLifetime;
+uniform vec2 cParticleVelocity;
+uniform vec3 cParticleDirMin;
+uniform vec3 cParticleDirMax;
+uniform vec4 cParticleEmitter;
+uniform vec4 cParticleForce;
+uniform vec4 cParticleSize;
+uniform vec2 cParticleSizeChange;
+uniform vec4 cParticleRotation;
+uniform vec4 cParticleColorStart;
+uniform vec4 cParticleColorEnd;
+
+float ParticleRandom(float seed, float cycle, float index)
+{
+    return fract(sin(seed * 91.3458 + cycle * 47.4091 + index * 12.9898) * 43758.5453);
+}
+#endif
+
+void VS()
+{
+    mat4 modelMatrix = iModelMatrix;
+
+    // Position holds the spawn phase, the random seed and the quad corner index of the particle
+    float seed = iPos.y;
+    float corner = iPos.z;
+    float lifetime = mix(cParticleLifetime.x, cParticleLifetime.y, ParticleRandom(seed, 0.0, 0.0));
+    float cycles = cParticleTime / lifetime + iPos.x;
+    float cycle = floor(cycles) + 1.0;
+    float age = fract(cycles) * lifetime;
+    float spawnTime = cParticleTime - age;
+
+    // Start position within the emitter volume
+    vec3 emitterSize = cParticleEmitter.xyz;
+    float emitterType = cParticleEmitter.w;
+    vec3 random = vec3(ParticleRandom(seed, cycle, 1.0), ParticleRandom(seed, cycle, 2.0), ParticleRandom(seed, cycle, 3.0));
+    vec3 startPos;
+    if (emitterType < 0.5 || (emitterType > 1.5 && emitterType < 2.5))
+    {
+        vec3 dir = normalize(random * 2.0 - 1.0 + vec3(0.0001, 0.0, 0.0));
+        float radius = emitterType < 0.5 ? 0.5 : pow(ParticleRandom(seed, cycle, 4.0), 1.0 / 3.0) * 0.5;
+        startPos = emitterSize * dir * radius;
+    }
+    else if (emitterType < 1.5)
+        startPos = (random - 0.5) * emitterSize;
+    else
+    {
+        float angle = random.x * 6.2831853;
+        float radius = emitterType < 3.5 ? sqrt(random.y) * 0.5 : 0.5;
+        float height = random.z - 0.5;
+        startPos = vec3(cos(angle) * radius, height, sin(angle) * radius) * emitterSize;
+    }
+
+    // Motion under constant force and velocity damping
+    vec3 direction = normalize(mix(cParticleDirMin, cParticleDirMax, vec3(ParticleRandom(seed, cycle, 5.0),
+        ParticleRandom(seed, cycle, 6.0), ParticleRandom(seed, cycle, 7.0))) + vec3(0.0, 0.0001, 0.0));
+    vec3 velocity = direction * mix(cParticleVelocity.x, cParticleVelocity.y, ParticleRandom(seed, cycle, 8.0));
+    vec3 force = cParticleForce.xyz;
+    float damping = cParticleForce.w;
+    vec3 position;
+    if (damping > 0.0)
+    {
+        vec3 terminalVelocity = force / damping;
+        position = startPos + terminalVelocity * age + (velocity - terminalVelocity) * (1.0 - exp(-damping * age)) / damping;
+    }
+    else
+        position = startPos + velocity * age + 0.5 * force * age * age;
+
+    // Size, hidden outside the emission window
+    vec2 size = mix(cParticleSize.xy, cParticleSize.zw, ParticleRandom(seed, cycle, 9.0));
+    float sizeAdd = cParticleSizeChange.x;
+    float sizeRate = cParticleSizeChange.y - 1.0;
+    float scale = abs(sizeRate) > 0.0001 ? (1.0 + sizeAdd / sizeRate) * exp(sizeRate * age) - sizeAdd / sizeRate :
+        1.0 + sizeAdd * age;
+    if (spawnTime < cParticleEmitWindow.x || spawnTime > cParticleEmitWindow.y)
+        scale = 0.0;
+    size *= max(scale, 0.0);
+
+    // Camera facing quad corner
+    vec2 uv = vec2(corner > 0.5 && corner < 2.5 ? 1.0 : 0.0, corner > 1.5 ? 1.0 : 0.0);
+    vec2 offset = vec2(uv.x * 2.0 - 1.0, 1.0 - uv.y * 2.0) * size;
+    float rotation = radians(mix(cParticleRotation.x, cParticleRotation.y, ParticleRandom(seed, cycle, 10.0)) +
+        mix(cParticleRotation.z, cParticleRotation.w, ParticleRandom(seed, cycle, 11.0)) * age);
+    float s = sin(rotation);
+    float c = cos(rotation);
+    offset = vec2(offset.x * c - offset.y * s, offset.x * s + offset.y * c);
+
+    vec3 worldPos = (vec4(position, 1.0) * modelMatrix).xyz + vec3(offset, 0.0) * cBillboardRot;
+    gl_Position = GetClipPos(worldPos);
+    vTexCoord = uv;
+    vWorldPos = vec4(worldPos, GetDepth(gl_Position));
+    vColor = mix(cParticleColorStart, cParticleColorEnd, age / lifetime);
+
+    #ifdef SOFTPARTICLES
+        vScreenPos = GetScreenPos(gl_Position);
+    #endif
+}
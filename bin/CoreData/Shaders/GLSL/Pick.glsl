@@ -0,0 +1,25 @@
+#include "Uniforms.glsl"
+#include "Transform.glsl"
+
+varying vec4 vPickId;
+
+void VS()
+{
+    mat4 modelMatrix = iModelMatrix;
+    vec3 worldPos = GetWorldPos(modelMatrix);
+    gl_Position = GetClipPos(worldPos);
+
+    // Object ID is passed in place of ambient
+    #ifdef INSTANCED
+        vPickId = iTexCoord7;
+    #elif defined(SPHERICALHARMONICS)
+        vPickId = cSHAr;
+    #else
+        vPickId = cAmbient;
+    #endif
+}
+
+void PS()
+{
+    gl_FragColor = vPickId;
+}
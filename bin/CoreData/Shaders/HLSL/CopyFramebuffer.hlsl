@@ -3,6 +3,23 @@
 #include "Transform.hlsl"
 #include "ScreenPos.hlsl"
 
+#if defined(COMPILEPS) && defined(SHARPEN)
+#ifndef D3D11
+
+// D3D9 uniforms
+uniform float cSharpness;
+
+#else
+
+// D3D11 constant buffers
+cbuffer CustomPS : register(b6)
+{
+    float cSharpness;
+}
+
+#endif
+#endif
+
 void VS(float4 iPos : POSITION,
     out float2 oScreenPos : TEXCOORD0,
     out float4 oPos : OUTPOSITION)
@@ -16,5 +33,18 @@ void VS(float4 iPos : POSITION,
 void PS(float2 iScreenPos : TEXCOORD0,
     out float4 oColor : OUTCOLOR0)
 {
+#ifdef SHARPEN
+    // Sharpen against the neighbor texels of the source, clamped to their range to avoid halos
+    float4 center = Sample2D(DiffMap, iScreenPos);
+    float3 left = Sample2D(DiffMap, iScreenPos - float2(cGBufferInvSize.x, 0.0)).rgb;
+    float3 right = Sample2D(DiffMap, iScreenPos + float2(cGBufferInvSize.x, 0.0)).rgb;
+    float3 up = Sample2D(DiffMap, iScreenPos - float2(0.0, cGBufferInvSize.y)).rgb;
+    float3 down = Sample2D(DiffMap, iScreenPos + float2(0.0, cGBufferInvSize.y)).rgb;
+    float3 minColor = min(center.rgb, min(min(left, right), min(up, down)));
+    float3 maxColor = max(center.rgb, max(max(left, right), max(up, down)));
+    float3 sharpened = center.rgb + (center.rgb - (left + right + up + down) * 0.25) * cSharpness;
+    oColor = float4(clamp(sharpened, minColor, maxColor), center.a);
+#else
     oColor = Sample2D(DiffMap, iScreenPos);
+#endif
 }
@@ -0,0 +1,83 @@
+#include "Uniforms.hlsl"
+#include "Samplers.hlsl"
+#include "Transform.hlsl"
+#include "ScreenPos.hlsl"
+
+// Projected decal box. Reconstructs the scene position from the depth buffer, clips it against the unit box
+// of the decal and projects the diffuse texture along the local Z axis
+
+void VS(float4 iPos : POSITION,
+    #ifdef INSTANCED
+        float4x3 iModelInstance : TEXCOORD4,
+    #endif
+    out float4 oScreenPos : TEXCOORD0,
+    out float3 oFarRay : TEXCOORD1,
+    out float4 oDecalRow0 : TEXCOORD2,
+    out float4 oDecalRow1 : TEXCOORD3,
+    out float4 oDecalRow2 : TEXCOORD4,
+    out float4 oUOffset : TEXCOORD5,
+    out float4 oVOffset : TEXCOORD6,
+    out float4 oPos : OUTPOSITION)
+{
+    float4x3 modelMatrix = iModelMatrix;
+    float3 worldPos = GetWorldPos(modelMatrix);
+    oPos = GetClipPos(worldPos);
+    oScreenPos = GetScreenPos(oPos);
+    oFarRay = GetFarRay(oPos) * oPos.w;
+
+    // Invert the affine decal transform, each row holds the linear part and translation of one axis
+    float3 row0 = float3(modelMatrix[0][0], modelMatrix[1][0], modelMatrix[2][0]);
+    float3 row1 = float3(modelMatrix[0][1], modelMatrix[1][1], modelMatrix[2][1]);
+    float3 row2 = float3(modelMatrix[0][2], modelMatrix[1][2], modelMatrix[2][2]);
+    float3 translation = modelMatrix[3];
+    float3 col0 = cross(row1, row2);
+    float3 col1 = cross(row2, row0);
+    float3 col2 = cross(row0, row1);
+    float invDet = 1.0 / dot(row0, col0);
+    float3 invRow0 = float3(col0.x, col1.x, col2.x) * invDet;
+    float3 invRow1 = float3(col0.y, col1.y, col2.y) * invDet;
+    float3 invRow2 = float3(col0.z, col1.z, col2.z) * invDet;
+    oDecalRow0 = float4(invRow0, -dot(invRow0, translation));
+    oDecalRow1 = float4(invRow1, -dot(invRow1, translation));
+    oDecalRow2 = float4(invRow2, -dot(invRow2, translation));
+
+    // Material UV transform selects the decal atlas cell
+    oUOffset = cUOffset;
+    oVOffset = cVOffset;
+}
+
+void PS(float4 iScreenPos : TEXCOORD0,
+    float3 iFarRay : TEXCOORD1,
+    float4 iDecalRow0 : TEXCOORD2,
+    float4 iDecalRow1 : TEXCOORD3,
+    float4 iDecalRow2 : TEXCOORD4,
+    float4 iUOffset : TEXCOORD5,
+    float4 iVOffset : TEXCOORD6,
+    out float4 oColor : OUTCOLOR0)
+{
+    float depth = Sample2DProj(DepthBuffer, iScreenPos).r;
+    #ifdef HWDEPTH
+        depth = ReconstructDepth(depth);
+    #endif
+
+    // Position acquired via far ray is relative to camera. Bring position to world space, then to decal space
+    float3 worldPos = iFarRay * depth / iScreenPos.w + cCameraPosPS;
+    float3 localPos = float3(
+        dot(iDecalRow0.xyz, worldPos) + iDecalRow0.w,
+        dot(iDecalRow1.xyz, worldPos) + iDecalRow1.w,
+        dot(iDecalRow2.xyz, worldPos) + iDecalRow2.w);
+
+    clip(0.5 - abs(localPos));
+
+    float2 texCoord = float2(localPos.x + 0.5, 0.5 - localPos.y);
+    texCoord = float2(dot(texCoord, iUOffset.xy) + iUOffset.w, dot(texCoord, iVOffset.xy) + iVOffset.w);
+
+    float4 diffColor = cMatDiffColor;
+    #ifdef DIFFMAP
+        diffColor *= Sample2D(DiffMap, texCoord);
+    #endif
+
+    // Fade out towards the ends of the projection depth to hide the cut
+    diffColor.a *= 1.0 - smoothstep(0.4, 0.5, abs(localPos.z));
+    oColor = diffColor;
+}
@@ -0,0 +1,145 @@
+#include "Uniforms.hlsl"
+#include "Samplers.hlsl"
+#include "Transform.hlsl"
+#include "ScreenPos.hlsl"
+
+// Vertex shader of GPU simulated particles, to be paired with the UnlitParticle pixel shader.
+// Each particle is evaluated from its spawn phase and random seed as a closed-form function of time
+
+#ifdef COMPILEVS
+#ifndef D3D11
+// D3D9 uniforms
+uniform float cParticleTime;
+uniform float2 cParticleEmitWindow;
+uniform float2 cParticleLifetime;
+uniform float2 cParticleVelocity;
+uniform float3 cParticleDirMin;
+uniform float3 cParticleDirMax;
+uniform float4 cParticleEmitter;
+uniform float4 cParticleForce;
+uniform float4 cParticleSize;
+uniform float2 cParticleSizeChange;
+uniform float4 cParticleRotation;
+uniform float4 cParticleColorStart;
+uniform float4 cParticleColorEnd;
+#else
+// D3D11 constant buffer
+cbuffer CustomVS : register(b6)
+{
+    float cParticleTime;
+    float2 cParticleEmitWindow;
+    float2 cParticleLifetime;
+    float2 cParticleVelocity;
+    float3 cParticleDirMin;
+    float3 cParticleDirMax;
+    float4 cParticleEmitter;
+    float4 cParticleForce;
+    float4 cParticleSize;
+    float2 cParticleSizeChange;
+    float4 cParticleRotation;
+    float4 cParticleColorStart;
+    float4 cParticleColorEnd;
+}
+#endif
+
+float ParticleRandom(float seed, float cycle, float index)
+{
+    return frac(sin(seed * 91.3458 + cycle * 47.4091 + index * 12.9898) * 43758.5453);
+}
+#endif
+
+void VS(float4 iPos : POSITION,
+    #ifdef INSTANCED
+        float4x3 iModelInstance : TEXCOORD4,
+    #endif
+    out float2 oTexCoord : TEXCOORD0,
+    #ifdef SOFTPARTICLES
+        out float4 oScreenPos : TEXCOORD1,
+    #endif
+    out float4 oWorldPos : TEXCOORD2,
+    out float4 oColor : COLOR0,
+    #if defined(D3D11) && defined(CLIPPLANE)
+        out float oClip : SV_CLIPDISTANCE0,
+    #endif
+    out float4 oPos : OUTPOSITION)
+{
+    float4x3 modelMatrix = iModelMatrix;
+
+    // Position holds the spawn phase, the random seed and the quad corner index of the particle
+    float seed = iPos.y;
+    float corner = iPos.z;
+    float lifetime = lerp(cParticleLifetime.x, cParticleLifetime.y, ParticleRandom(seed, 0.0, 0.0));
+    float cycles = cParticleTime / lifetime + iPos.x;
+    float cycle = floor(cycles) + 1.0;
+    float age = frac(cycles) * lifetime;
+    float spawnTime = cParticleTime - age;
+
+    // Start position within the emitter volume
+    float3 emitterSize = cParticleEmitter.xyz;
+    float emitterType = cParticleEmitter.w;
+    float3 random = float3(ParticleRandom(seed, cycle, 1.0), ParticleRandom(seed, cycle, 2.0), ParticleRandom(seed, cycle, 3.0));
+    float3 startPos;
+    if (emitterType < 0.5 || (emitterType > 1.5 && emitterType < 2.5))
+    {
+        float3 dir = normalize(random * 2.0 - 1.0 + float3(0.0001, 0.0, 0.0));
+        float radius = emitterType < 0.5 ? 0.5 : pow(ParticleRandom(seed, cycle, 4.0), 1.0 / 3.0) * 0.5;
+        startPos = emitterSize * dir * radius;
+    }
+    else if (emitterType < 1.5)
+        startPos = (random - 0.5) * emitterSize;
+    else
+    {
+        float angle = random.x * 6.2831853;
+        float radius = emitterType < 3.5 ? sqrt(random.y) * 0.5 : 0.5;
+        float height = random.z - 0.5;
+        startPos = float3(cos(angle) * radius, height, sin(angle) * radius) * emitterSize;
+    }
+
+    // Motion under constant force and velocity damping
+    float3 direction = normalize(lerp(cParticleDirMin, cParticleDirMax, float3(ParticleRandom(seed, cycle, 5.0),
+        ParticleRandom(seed, cycle, 6.0), ParticleRandom(seed, cycle, 7.0))) + float3(0.0, 0.0001, 0.0));
+    float3 velocity = direction * lerp(cParticleVelocity.x, cParticleVelocity.y, ParticleRandom(seed, cycle, 8.0));
+    float3 force = cParticleForce.xyz;
+    float damping = cParticleForce.w;
+    float3 position;
+    if (damping > 0.0)
+    {
+        float3 terminalVelocity = force / damping;
+        position = startPos + terminalVelocity * age + (velocity - terminalVelocity) * (1.0 - exp(-damping * age)) / damping;
+    }
+    else
+        position = startPos + velocity * age + 0.5 * force * age * age;
+
+    // Size, hidden outside the emission window
+    float2 size = lerp(cParticleSize.xy, cParticleSize.zw, ParticleRandom(seed, cycle, 9.0));
+    float sizeAdd = cParticleSizeChange.x;
+    float sizeRate = cParticleSizeChange.y - 1.0;
+    float scale = abs(sizeRate) > 0.0001 ? (1.0 + sizeAdd / sizeRate) * exp(sizeRate * age) - sizeAdd / sizeRate :
+        1.0 + sizeAdd * age;
+    if (spawnTime < cParticleEmitWindow.x || spawnTime > cParticleEmitWindow.y)
+        scale = 0.0;
+    size *= max(scale, 0.0);
+
+    // Camera facing quad corner
+    float2 uv = float2(corner > 0.5 && corner < 2.5 ? 1.0 : 0.0, corner > 1.5 ? 1.0 : 0.0);
+    float2 offset = float2(uv.x * 2.0 - 1.0, 1.0 - uv.y * 2.0) * size;
+    float rotation = radians(lerp(cParticleRotation.x, cParticleRotation.y, ParticleRandom(seed, cycle, 10.0)) +
+        lerp(cParticleRotation.z, cParticleRotation.w, ParticleRandom(seed, cycle, 11.0)) * age);
+    float s = sin(rotation);
+    float c = cos(rotation);
+    offset = float2(offset.x * c - offset.y * s, offset.x * s + offset.y * c);
+
+    float3 worldPos = mul(float4(position, 1.0), modelMatrix) + mul(float3(offset, 0.0), cBillboardRot);
+    oPos = GetClipPos(worldPos);
+    oTexCoord = uv;
+    oWorldPos = float4(worldPos, GetDepth(oPos));
+    oColor = lerp(cParticleColorStart, cParticleColorEnd, age / lifetime);
+
+    #if defined(D3D11) && defined(CLIPPLANE)
+        oClip = dot(oPos, cClipPlane);
+    #endif
+
+    #ifdef SOFTPARTICLES
+        oScreenPos = GetScreenPos(oPos);
+    #endif
+}
@@ -624,6 +624,40 @@ class CleanEnumValues(AstPass):
 class DefineEventsPass(AstPass):
     outputs = ['_events.i']
     re_param_name = re.compile(r'URHO3D_PARAM\(([^,]+),\s*([a-z0-9_]+)\);\s*', re.IGNORECASE)
+    re_param_type = re.compile(r'^\s*//\s*([A-Za-z0-9_]+)(\s+pointer)?\s*$')
+    # Parameter type noted in the comment after URHO3D_PARAM -> (C# type, EventData getter)
+    value_types = {
+        'int': ('int', 'GetInt'),
+        'unsigned': ('uint', 'GetUInt'),
+        'float': ('float', 'GetFloat'),
+        'Float': ('float', 'GetFloat'),
+        'bool': ('bool', 'GetBool'),
+        'String': ('string', 'GetString'),
+        'StringHash': ('StringHash', 'GetStringHash'),
+        'Vector3': ('Vector3', 'GetVector3'),
+        'IntVector2': ('IntVector2', 'GetIntVector2'),
+    }
+    # Pointer parameters of these types are exposed as wrapper objects
+    pointer_types = ['Node', 'Scene', 'Component', 'UIElement', 'Serializable', 'Camera', 'Resource']
+
+    @classmethod
+    def get_param_accessor(cls, param):
+        # Type of parameter is only documented in a comment following the declaration
+        with open(param.extent.end.file.name) as fp:
+            fp.seek(param.extent.end.offset, os.SEEK_SET)
+            comment = fp.readline()
+        match = cls.re_param_type.match(comment.lstrip(';'))
+        if match is None:
+            return None
+        type_name, is_pointer = match.groups()
+        if is_pointer:
+            if type_name in cls.pointer_types:
+                return type_name, f'{type_name}.wrap(_data.GetPtr({{key}}), false)'
+            return None
+        if type_name in cls.value_types:
+            cs_type, getter = cls.value_types[type_name]
+            return cs_type, f'_data.{getter}({{key}})'
+        return None
 
     def on_begin(self):
         self.fp = open(os.path.join(self.module.args.output, '_events.i'), 'w+')
@@ -652,18 +686,33 @@ class DefineEventsPass(AstPass):
                         f'    public class {next_node.spelling}Event {{\n' +
                         f'        private StringHash _event = new StringHash("{next_node.spelling}");\n\n')
 
+                    accessors = []
                     for param in next_node.children:
                         param_name = read_raw_code(param)
                         param_name = self.re_param_name.match(param_name).group(2)
                         var_name = camel_case(param_name)
                         self.fp.write(f'        public StringHash {var_name} = new StringHash("{param_name}");\n')
+                        accessor = self.get_param_accessor(param)
+                        if accessor is not None:
+                            accessors.append((var_name, ) + accessor)
 
                     self.fp.write(
                         f'        public {next_node.spelling}Event() {{ }}\n' +
                         f'        public static implicit operator StringHash({next_node.spelling}Event e) {{ return e._event; }}\n' +
                         '    }\n' +
-                        f'    public static {next_node.spelling}Event {next_node.spelling} = new {next_node.spelling}Event();\n\n'
+                        f'    public static {next_node.spelling}Event {next_node.spelling} = new {next_node.spelling}Event();\n'
                     )
+
+                    # Typed view of event data for EventDispatcher subscribers
+                    self.fp.write(
+                        f'    public struct {next_node.spelling}Args : IEventArgs {{\n' +
+                        '        private EventData _data;\n' +
+                        '        public void Bind(in EventData data) { _data = data; }\n' +
+                        '        public EventData Data => _data;\n')
+                    for var_name, cs_type, getter in accessors:
+                        key = f'E.{next_node.spelling}.{var_name}'
+                        self.fp.write(f'        public {cs_type} {var_name} => {getter.format(key=key)};\n')
+                    self.fp.write('    }\n\n')
         return True
 
 